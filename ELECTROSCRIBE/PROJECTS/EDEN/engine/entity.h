@@ -2,7 +2,8 @@
 // ENTITY - Core entity type for EDEN Level Editor
 // ============================================================================
 // Entities can be models (meshes with textures) or lights (point/directional).
-// Each entity has a unique ID, name, and transform properties.
+// Each entity has a unique ID, name, and transform properties; its model
+// matrix is cached until the transform changes.
 // ============================================================================
 
 #ifndef EDEN_ENTITY_H
@@ -30,9 +31,8 @@ enum class EntityType {
 // ============================================================================
 
 struct Entity {
-    // Identity
+    // Hot data first: what the per-frame transform and draw loops read
     uint32_t id = 0;
-    std::string name;
     EntityType type = EntityType::MODEL;
     
     // Transform (applies to all entity types)
@@ -43,7 +43,6 @@ struct Entity {
     // Model data (only used if type == MODEL)
     vkcore::MeshHandle mesh = vkcore::INVALID_MESH;
     vkcore::TextureHandle texture = vkcore::INVALID_TEXTURE;
-    std::string modelPath;
     glm::vec4 color = glm::vec4(1.0f);  // Tint color
     
     // Light data (only used if type == POINT_LIGHT or DIRECTIONAL_LIGHT)
@@ -51,31 +50,37 @@ struct Entity {
     float intensity = 1.0f;
     float range = 10.0f;  // Only for point lights
     
+    // Cold data last: only the UI and save/load touch it
+    std::string name;
+    std::string modelPath;
+    
     // ========================================================================
     // Helper Methods
     // ========================================================================
     
-    // Get the model matrix for this entity's transform
-    glm::mat4 getModelMatrix() const {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, position);
-        model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1, 0, 0));
-        model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0, 1, 0));
-        model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0, 0, 1));
-        model = glm::scale(model, scale);
-        return model;
+    // Get the model matrix for this entity's transform. Cached: rebuilt
+    // only when position, rotation or scale differ from the last call, so
+    // every editing path (including ImGui writing the fields directly)
+    // invalidates it.
+    const glm::mat4& getModelMatrix() const {
+        if (!m_matrixValid || position != m_cachedPosition || rotation != m_cachedRotation || scale != m_cachedScale) {
+            m_cachedMatrix = glm::scale(glm::translate(glm::mat4(1.0f), position) * getRotationMatrix(), scale);
+            m_cachedPosition = position;
+            m_cachedRotation = rotation;
+            m_cachedScale = scale;
+            m_matrixValid = true;
+        }
+        return m_cachedMatrix;
     }
     
     // Get light direction (for directional lights, uses rotation)
     glm::vec3 getLightDirection() const {
-        // Default direction is down (-Y)
-        glm::vec3 dir = glm::vec3(0.0f, -1.0f, 0.0f);
-        // Apply rotation
-        glm::mat4 rot = glm::mat4(1.0f);
-        rot = glm::rotate(rot, glm::radians(rotation.x), glm::vec3(1, 0, 0));
-        rot = glm::rotate(rot, glm::radians(rotation.y), glm::vec3(0, 1, 0));
-        rot = glm::rotate(rot, glm::radians(rotation.z), glm::vec3(0, 0, 1));
-        return glm::normalize(glm::vec3(rot * glm::vec4(dir, 0.0f)));
+        // Default direction is down (-Y): the rotation's negated Y axis,
+        // which the cached model matrix holds scaled by scale.y
+        if (scale.y != 0.0f) {
+            return glm::normalize(glm::vec3(getModelMatrix()[1]) * (scale.y > 0.0f ? -1.0f : 1.0f));
+        }
+        return glm::normalize(glm::vec3(getRotationMatrix() * glm::vec4(0.0f, -1.0f, 0.0f, 0.0f)));
     }
     
     // Check if this is a light entity
@@ -97,6 +102,20 @@ struct Entity {
             default: return "Unknown";
         }
     }
+    
+private:
+    // X, then Y, then Z (degrees)
+    glm::mat4 getRotationMatrix() const {
+        glm::mat4 rot = glm::rotate(glm::mat4(1.0f), glm::radians(rotation.x), glm::vec3(1, 0, 0));
+        rot = glm::rotate(rot, glm::radians(rotation.y), glm::vec3(0, 1, 0));
+        return glm::rotate(rot, glm::radians(rotation.z), glm::vec3(0, 0, 1));
+    }
+    
+    mutable glm::mat4 m_cachedMatrix = glm::mat4(1.0f);
+    mutable glm::vec3 m_cachedPosition = glm::vec3(0.0f);
+    mutable glm::vec3 m_cachedRotation = glm::vec3(0.0f);
+    mutable glm::vec3 m_cachedScale = glm::vec3(1.0f);
+    mutable bool m_matrixValid = false;
 };
 
 // ============================================================================
@@ -2,7 +2,8 @@
 // SCENE - Scene management for EDEN Level Editor
 // ============================================================================
 // Manages a collection of entities (models and lights).
-// Handles save/load to JSON format.
+// Handles save/load to JSON format. Lookups by ID go through an ID -> slot
+// index instead of scanning the entity array.
 // ============================================================================
 
 #ifndef EDEN_SCENE_H
@@ -11,10 +12,12 @@
 #include "entity.h"
 #include "../../../../vulkan/core/vulkan_core.h"
 #include "../../../../vulkan/utils/glb_loader.h"
+#include "../../../../vulkan/lighting/irradiance_probes.h"
 
 #include <vector>
 #include <string>
 #include <functional>
+#include <unordered_map>
 
 namespace eden {
 
@@ -46,12 +49,28 @@ public:
                                   const glm::vec3& color = glm::vec3(1.0f),
                                   float intensity = 1.0f);
     
-    // Remove an entity by ID
-    bool removeEntity(uint32_t id);
+    // Remove an entity by ID (keeps the others in order)
+    bool removeEntity(uint32_t id) {
+        int index = findEntityIndex(id);
+        if (index < 0) return false;
+        m_entities.erase(m_entities.begin() + index);
+        m_slotById.erase(id);
+        for (size_t i = size_t(index); i < m_entities.size(); i++) m_slotById[m_entities[i].id] = uint32_t(i);
+        m_indexedCount = m_entities.size();
+        if (m_selectedId == id) m_selectedId = 0;
+        m_dirty = true;
+        return true;
+    }
     
     // Get entity by ID (returns nullptr if not found)
-    Entity* getEntity(uint32_t id);
-    const Entity* getEntity(uint32_t id) const;
+    Entity* getEntity(uint32_t id) {
+        int index = findEntityIndex(id);
+        return index >= 0 ? &m_entities[index] : nullptr;
+    }
+    const Entity* getEntity(uint32_t id) const {
+        int index = findEntityIndex(id);
+        return index >= 0 ? &m_entities[index] : nullptr;
+    }
     
     // Get all entities
     std::vector<Entity>& getEntities() { return m_entities; }
@@ -61,11 +80,11 @@ public:
     // Selection
     // ========================================================================
     
-    void selectEntity(uint32_t id);
-    void clearSelection();
+    void selectEntity(uint32_t id) { m_selectedId = findEntityIndex(id) >= 0 ? id : 0; }
+    void clearSelection() { m_selectedId = 0; }
     uint32_t getSelectedId() const { return m_selectedId; }
-    Entity* getSelectedEntity();
-    const Entity* getSelectedEntity() const;
+    Entity* getSelectedEntity() { return m_selectedId ? getEntity(m_selectedId) : nullptr; }
+    const Entity* getSelectedEntity() const { return m_selectedId ? getEntity(m_selectedId) : nullptr; }
     bool hasSelection() const { return m_selectedId != 0; }
     
     // ========================================================================
@@ -92,14 +111,112 @@ public:
     bool saveToJSON(const std::string& path);
     bool loadFromJSON(vkcore::VulkanCore* core, const std::string& path);
     
+    // ========================================================================
+    // Frustum Culling
+    // ========================================================================
+    
+    // Indices into getEntities() of what the current camera can see, for
+    // the render loop to draw instead of every entity. Models are tested by
+    // their mesh's bounding sphere under the (cached) model matrix; lights
+    // and models without a loaded mesh always pass. Returns the visible /
+    // culled counts for the frame's stats.
+    vkcore::CullStats cullEntities(const vkcore::VulkanCore* core, std::vector<uint32_t>& visible) {
+        m_cullList.resize(m_entities.size());
+        for (size_t i = 0; i < m_entities.size(); i++) {
+            const Entity& entity = m_entities[i];
+            glm::vec3 center;
+            float radius;
+            if (entity.isModel() && core->getMeshBounds(entity.mesh, center, radius)) {
+                m_cullList.setTransformed(i, center, radius, entity.getModelMatrix());
+            } else {
+                m_cullList.set(i, entity.position, 0.0f);
+            }
+        }
+        m_cullStats = m_cullList.cull(core->getFrustum(), visible);
+        return m_cullStats;
+    }
+    
+    // Counts from the last cullEntities()
+    const vkcore::CullStats& getCullStats() const { return m_cullStats; }
+    
+    // ========================================================================
+    // Baked Lighting
+    // ========================================================================
+    
+    // Models (re-read from their files) and lights as irradiance probe bake
+    // input; the first directional light is the sun. Entities have no
+    // static flag, so every model counts as static geometry. Albedo is the
+    // tint times the mesh texture's average colour.
+    void collectProbeBakeInput(lighting::ProbeBakeInput& input) const {
+        bool haveSun = false;
+        for (const Entity& entity : m_entities) {
+            if (entity.type == EntityType::POINT_LIGHT) {
+                input.addPointLight(entity.position, entity.lightColor, entity.intensity, entity.range);
+            } else if (entity.type == EntityType::DIRECTIONAL_LIGHT && !haveSun) {
+                input.setSun(entity.getLightDirection(), entity.lightColor, entity.intensity);
+                haveSun = true;
+            } else if (entity.type == EntityType::MODEL && !entity.modelPath.empty()) {
+                GLBModel model;
+                if (!loadGLB(entity.modelPath, model, false)) continue;
+                glm::mat4 transform = entity.getModelMatrix();
+                for (const GLBMesh& mesh : model.meshes) {
+                    if (mesh.vertices.empty()) continue;
+                    glm::vec3 albedo = glm::vec3(entity.color);
+                    if (mesh.textureIndex >= 0 && size_t(mesh.textureIndex) < model.textures.size()) {
+                        const GLBTexture& texture = model.textures[mesh.textureIndex];
+                        glm::vec3 sum(0.0f);
+                        size_t texels = texture.pixels.size() / 4;
+                        for (size_t i = 0; i < texels; i++) {
+                            sum += glm::vec3(texture.pixels[i * 4], texture.pixels[i * 4 + 1], texture.pixels[i * 4 + 2]);
+                        }
+                        if (texels > 0) albedo *= sum / (255.0f * float(texels));
+                    }
+                    input.addMesh(&mesh.vertices[0].position, static_cast<uint32_t>(mesh.vertices.size()),
+                                  mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size()),
+                                  transform, albedo, sizeof(GLBVertex));
+                }
+            }
+        }
+    }
+    
 private:
     std::vector<Entity> m_entities;
     uint32_t m_selectedId = 0;
     std::string m_filePath;
     bool m_dirty = false;
     
-    // Helper to find entity index by ID
-    int findEntityIndex(uint32_t id) const;
+    // ID -> position in m_entities. Entities are appended by the add*()
+    // functions and load (and anyone holding getEntities()), so the index
+    // catches up on a miss: entries appended since the last lookup are
+    // added, and if the array changed any other way it is rebuilt.
+    mutable std::unordered_map<uint32_t, uint32_t> m_slotById;
+    mutable size_t m_indexedCount = 0;
+    
+    vkcore::CullList m_cullList;  // World bounding spheres, refreshed by cullEntities()
+    vkcore::CullStats m_cullStats;
+    
+    // Helper to find entity index by ID (-1 if not found)
+    int findEntityIndex(uint32_t id) const {
+        int index = indexedSlot(id);
+        if (index >= 0) return index;
+        bool appendedOnly = m_indexedCount <= m_entities.size() &&
+            (m_indexedCount == 0 || indexedSlot(m_entities[m_indexedCount - 1].id) == int(m_indexedCount - 1));
+        reindex(appendedOnly ? m_indexedCount : 0);
+        return indexedSlot(id);
+    }
+    
+    int indexedSlot(uint32_t id) const {
+        auto it = m_slotById.find(id);
+        if (it == m_slotById.end() || it->second >= m_entities.size() || m_entities[it->second].id != id) return -1;
+        return int(it->second);
+    }
+    
+    void reindex(size_t from) const {
+        if (from == 0) m_slotById.clear();
+        m_slotById.reserve(m_entities.size());
+        for (size_t i = from; i < m_entities.size(); i++) m_slotById[m_entities[i].id] = uint32_t(i);
+        m_indexedCount = m_entities.size();
+    }
 };
 
 } // namespace eden
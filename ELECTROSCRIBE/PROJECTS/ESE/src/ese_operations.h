@@ -20,19 +20,22 @@ public:
     // Extrusion
     // ========================================================================
     
-    // Extrude selected quad(s) - creates new geometry
+    // Extrude selected quad(s) - creates new geometry in the topology and
+    // regenerates indices from it
     // Returns indices of newly created vertices that should be moved
     static std::vector<uint32_t> extrudeQuads(
+        eden::HalfEdgeMesh& topology,
         std::vector<MeshVertex>& vertices,
         std::vector<uint32_t>& indices,
         const std::set<int>& selectedQuads,
-        const std::vector<std::array<uint32_t, 4>>& quads);
+        const std::vector<uint32_t>& quadFaces);
     
-    // Extrude single face (triangle)
+    // Extrude single topology face (triangle or quad)
     static std::vector<uint32_t> extrudeFace(
+        eden::HalfEdgeMesh& topology,
         std::vector<MeshVertex>& vertices,
         std::vector<uint32_t>& indices,
-        int faceIndex);
+        uint32_t face);
     
     // ========================================================================
     // Edge Loop
@@ -41,11 +44,10 @@ public:
     // Insert edge loop perpendicular to selected edge
     // Returns number of new vertices created
     static int insertEdgeLoop(
+        eden::HalfEdgeMesh& topology,
         std::vector<MeshVertex>& vertices,
         std::vector<uint32_t>& indices,
-        int selectedEdgeIndex,
-        const std::vector<QuadEdge>& edges,
-        const std::vector<std::array<uint32_t, 4>>& quads);
+        const QuadEdge& selectedEdge);
     
     // ========================================================================
     // Vertex Operations
@@ -74,30 +76,31 @@ public:
         GizmoAxis axis);
     
     // ========================================================================
-    // Quad Reconstruction
+    // Topology
     // ========================================================================
     
-    // Reconstruct quads from triangulated mesh
-    static std::vector<std::array<uint32_t, 4>> reconstructQuads(
-        const std::vector<MeshVertex>& vertices,
-        const std::vector<uint32_t>& indices);
-    
-    // Build quad edges (edges that form quad perimeters)
-    static std::vector<QuadEdge> buildQuadEdges(
+    // Rebuild the topology from a triangulated mesh (new model, undo);
+    // seam copies are welded through `positions`, built over `vertices`
+    static bool buildTopology(
+        eden::HalfEdgeMesh& topology,
         const std::vector<MeshVertex>& vertices,
         const std::vector<uint32_t>& indices,
-        const std::vector<std::array<uint32_t, 4>>& quads);
+        const eden::PositionHash& positions);
+    
+    // Derive the quad and quad-edge views from the topology: one pass, no
+    // searching, after every build or edit
+    static void refreshQuadViews(
+        const eden::HalfEdgeMesh& topology,
+        std::vector<std::array<uint32_t, 4>>& quads,
+        std::vector<uint32_t>& quadFaces,
+        std::vector<int>& faceQuads,
+        std::vector<int>& halfEdgeQuadEdges,
+        std::vector<QuadEdge>& edges);
     
     // ========================================================================
     // Utilities
     // ========================================================================
     
-    // Find shared edge between two quads
-    static bool findSharedEdge(
-        const std::array<uint32_t, 4>& quad1,
-        const std::array<uint32_t, 4>& quad2,
-        uint32_t& v1, uint32_t& v2);
-    
     // Calculate face normal
     static glm::vec3 calculateFaceNormal(
         const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2);
@@ -107,22 +110,18 @@ public:
         const MeshVertex& a, const MeshVertex& b,
         float epsilon = 0.0001f);
     
-    // Find all vertices at same position (for connected mesh operations)
-    static std::set<uint32_t> findCoincidentVertices(
-        const std::vector<MeshVertex>& vertices,
-        uint32_t sourceVertex,
-        float epsilon = 0.0001f);
+    // Vertices coincident with sourceVertex are topology.forEachCoincident(),
+    // or positions.forEachNear() when there is no topology yet
     
-    // Recalculate normals for affected triangles
+    // Recalculate normals for affected triangles; seam copies of an affected
+    // vertex (found through `positions`) share its averaged normal
     static void recalculateNormals(
         std::vector<MeshVertex>& vertices,
         const std::vector<uint32_t>& indices,
-        const std::set<uint32_t>& affectedVertices);
+        const std::set<uint32_t>& affectedVertices,
+        const eden::PositionHash& positions);
     
 private:
-    // Helper: Get position key string for edge matching
-    static std::string positionKey(float x, float y, float z);
-    
     // Helper: Add quad triangles to index buffer
     static void addQuadTriangles(
         std::vector<uint32_t>& indices,
@@ -33,29 +33,51 @@ public:
     const SelectionState& getState() const { return m_state; }
     SelectionState& getState() { return m_state; }
     
-    // Pick operations (returns true if something was selected)
-    bool pickVertex(const std::vector<MeshVertex>& vertices, 
+    // Pick operations (returns true if something was selected). Candidates
+    // come from the mesh's BVH (EditorState::bvh), not a scan of the mesh.
+    bool pickVertex(const eden::MeshBVH& bvh,
+                    const std::vector<MeshVertex>& vertices,
+                    const std::vector<uint32_t>& indices,
                     double mouseX, double mouseY,
                     const glm::mat4& view, const glm::mat4& proj,
                     int screenWidth, int screenHeight,
                     bool multiSelect);
     
-    bool pickEdge(const std::vector<QuadEdge>& edges,
+    bool pickEdge(const eden::MeshBVH& bvh,
+                  const eden::HalfEdgeMesh& topology,
+                  const std::vector<int>& halfEdgeQuadEdges,
+                  const std::vector<QuadEdge>& edges,
                   const std::vector<MeshVertex>& vertices,
                   double mouseX, double mouseY,
                   const glm::mat4& view, const glm::mat4& proj,
                   int screenWidth, int screenHeight,
                   bool multiSelect);
     
-    bool pickFace(const std::vector<MeshVertex>& vertices,
+    bool pickFace(const eden::MeshBVH& bvh,
+                  const std::vector<MeshVertex>& vertices,
                   const std::vector<uint32_t>& indices,
                   const glm::vec3& rayOrigin, const glm::vec3& rayDir);
     
-    bool pickQuad(const std::vector<std::array<uint32_t, 4>>& quads,
+    // Nearest front-facing triangle of a quad; faceQuads maps topology faces
+    // to quad indices (-1 for leftover triangles, which don't block the ray)
+    bool pickQuad(const eden::MeshBVH& bvh,
+                  const eden::HalfEdgeMesh& topology,
+                  const std::vector<int>& faceQuads,
                   const std::vector<MeshVertex>& vertices,
+                  const std::vector<uint32_t>& indices,
                   const glm::vec3& rayOrigin, const glm::vec3& rayDir,
                   bool multiSelect);
     
+    // Box select: vertices projecting inside the screen rectangle, from the
+    // triangles the BVH finds in its frustum (MeshBVH::rectPlanes)
+    bool pickVerticesInRect(const eden::MeshBVH& bvh,
+                            const std::vector<MeshVertex>& vertices,
+                            const std::vector<uint32_t>& indices,
+                            double x0, double y0, double x1, double y1,
+                            const glm::mat4& view, const glm::mat4& proj,
+                            int screenWidth, int screenHeight,
+                            bool addToSelection);
+    
     // Get selected center point (for gizmo positioning)
     glm::vec3 getSelectionCenter(const std::vector<MeshVertex>& vertices) const;
     
@@ -74,11 +96,6 @@ private:
                               const glm::mat4& view, const glm::mat4& proj,
                               int screenWidth, int screenHeight,
                               bool* inFront) const;
-    
-    // Ray-triangle intersection
-    bool rayTriangle(const glm::vec3& origin, const glm::vec3& dir,
-                     const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
-                     float& t) const;
 };
 
 } // namespace ese
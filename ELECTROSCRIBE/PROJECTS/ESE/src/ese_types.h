@@ -10,6 +10,9 @@
 #include <string>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "../../../../vulkan/utils/half_edge_mesh.h"
+#include "../../../../vulkan/utils/mesh_bvh.h"
+#include "../../../../vulkan/utils/position_hash.h"
 
 // Forward declarations
 struct MeshVertex;
@@ -53,11 +56,13 @@ enum class GizmoMode {
 
 struct QuadEdge {
     uint32_t v0, v1;                    // Vertex indices
-    std::vector<int> quadIndices;       // Which quads contain this edge
+    uint32_t halfEdge;                  // In EditorState::topology, running v0 -> v1
+    int quads[2];                       // Quads on either side (-1 = none)
     int edgeInQuad;                     // Edge index within the first quad (0-3)
     
-    QuadEdge() : v0(0), v1(0), edgeInQuad(0) {}
-    QuadEdge(uint32_t a, uint32_t b) : v0(a), v1(b), edgeInQuad(0) {}
+    QuadEdge() : v0(0), v1(0), halfEdge(eden::HalfEdgeMesh::INVALID), quads{-1, -1}, edgeInQuad(0) {}
+    QuadEdge(uint32_t a, uint32_t b)
+        : v0(a), v1(b), halfEdge(eden::HalfEdgeMesh::INVALID), quads{-1, -1}, edgeInQuad(0) {}
 };
 
 // ============================================================================
@@ -264,9 +269,22 @@ struct EditorState {
     std::vector<MeshState> undoStack;
     static const size_t MAX_UNDO_LEVELS = 20;
     
-    // Reconstructed quads for quad mode
+    // Mesh topology, edited in place by MeshOperations; the quads and quad
+    // edges below are views of it for selection and drawing
+    eden::HalfEdgeMesh topology;
     std::vector<std::array<uint32_t, 4>> reconstructedQuads;
+    std::vector<uint32_t> quadFaces;    // Topology face of each reconstructed quad
+    std::vector<int> faceQuads;         // Reconstructed quad of each topology face (-1 = triangle)
+    std::vector<int> halfEdgeQuadEdges; // Quad edge of each topology half-edge (-1 = none)
     std::vector<QuadEdge> quadEdges;
+    
+    // Triangle BVH for picking: refit() after a drag, build() after the
+    // triangles change
+    eden::MeshBVH bvh;
+    
+    // Coincident-vertex lookup, built once per operation and shared by the
+    // topology build, normal recalculation and gizmo drags
+    eden::PositionHash positions;
     size_t lastQuadIndexCount = 0;
     size_t lastQuadEdgeIndexCount = 0;
     
@@ -292,8 +310,14 @@ struct EditorState {
         gizmo.reset();
         extrude.reset();
         undoStack.clear();
+        topology.clear();
         reconstructedQuads.clear();
+        quadFaces.clear();
+        faceQuads.clear();
+        halfEdgeQuadEdges.clear();
         quadEdges.clear();
+        bvh.clear();
+        positions.clear();
         lastQuadIndexCount = 0;
         lastQuadEdgeIndexCount = 0;
         connectionPoints.clear();
@@ -20,6 +20,9 @@ layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec3 fragWorldPos;
 layout(location = 3) out vec4 fragColor;
 
+// Same depth in every pipeline variant (DrawPass::Shading tests EQUAL)
+invariant gl_Position;
+
 void main() {
     vec4 worldPos = ubo.model * vec4(inPosition, 1.0);
     gl_Position = ubo.proj * ubo.view * worldPos;
@@ -14,6 +14,7 @@
 
 // Use extracted modules
 #include "../../../vulkan/utils/raycast.h"
+#include "../../../vulkan/utils/object_grid.h"
 
 namespace sl {
 
@@ -261,6 +262,9 @@ private:
     // Game state
     Camera m_camera;
     std::vector<WorldObject> m_objects;
+    // Object boxes by index, for the raycasts and findBigBlockUnder();
+    // createObject/setObjectPosition/updateAttachedObjects keep it current
+    eden::ObjectGrid m_objectGrid;
     std::vector<UIElement> m_uiElements;
     std::vector<std::pair<glm::vec3, glm::vec3>> m_debugLines;
     std::vector<glm::vec3> m_debugLineColors;
@@ -13,9 +13,13 @@
 
 #include "../../../../vulkan/core/vulkan_core.h"
 #include "../../../../vulkan/utils/raycast.h"
+#include "../../../../vulkan/utils/object_grid.h"
+#include "../../../../vulkan/utils/world_streamer.h"
+#include "../../../../stdlib/fixed_timestep.h"
 
 #include <string>
 #include <vector>
+#include <algorithm>
 
 namespace sl {
 
@@ -48,6 +52,12 @@ struct GameObject {
     int attachedToVehicle = -1;
     glm::vec3 localOffset = glm::vec3(0.0f);
     
+    // State before the last simulation step, for render interpolation
+    // (GameEngine::simulate() stores it; false = render the current state)
+    glm::vec3 previousPosition = glm::vec3(0.0f);
+    float previousYawDegrees = 0.0f;
+    bool hasPreviousState = false;
+    
     // Rendering
     vkcore::MeshHandle mesh = vkcore::INVALID_MESH;
     
@@ -58,6 +68,16 @@ struct GameObject {
         t = glm::rotate(t, glm::radians(yawDegrees), glm::vec3(0, 1, 0));
         t = glm::scale(t, size);
         return t;
+    }    
+    // Transform between the last two simulation steps (alpha from
+    // GameEngine::getSimulationAlpha())
+    glm::mat4 getInterpolatedTransform(float alpha) const {
+        if (!hasPreviousState) return getTransform();
+        glm::mat4 t = glm::mat4(1.0f);
+        t = glm::translate(t, glm::mix(previousPosition, position, alpha));
+        t = glm::rotate(t, glm::radians(lerp_angle_degrees(previousYawDegrees, yawDegrees, alpha)), glm::vec3(0, 1, 0));
+        t = glm::scale(t, size);
+        return t;
     }
 };
 
@@ -143,6 +163,80 @@ public:
     FPSCamera& getCamera() { return m_camera; }
     void updateCamera(float deltaTime);
     
+    // ========================================================================
+    // Simulation (fixed timestep)
+    // ========================================================================
+    
+    // Runs step(dt) at the simulation rate for this frame's delta time and
+    // returns the steps run; every step sees the same dt, and before each
+    // one the objects' state is kept for getInterpolatedTransform(). Frames
+    // needing more than maxSubsteps steps drop the rest
+    template <typename Step>
+    int simulate(Step&& step) {
+        return m_simClock.advance(m_deltaTime, [&](float dt) {
+            storePreviousState();
+            step(dt);
+        });
+    }
+    
+    void setSimulationRate(double hz, int maxSubsteps = FixedTimestep::DEFAULT_MAX_SUBSTEPS) {
+        m_simClock.set_rate(hz);
+        m_simClock.set_max_substeps(maxSubsteps);
+    }
+    
+    float getSimulationAlpha() const { return m_simClock.alpha(); }
+    float getSimulationStep() const { return m_simClock.step_seconds(); }
+    const FixedTimestep& getSimulationClock() const { return m_simClock; }
+    
+    // A teleported object (or a new one) renders where it is, not blended
+    // from where it was
+    void resetInterpolation(int index) {
+        if (index >= 0 && index < getObjectCount()) m_objects[index].hasPreviousState = false;
+    }
+    
+    // ========================================================================
+    // World Streaming (chunks + floating origin)
+    // ========================================================================
+    
+    // Streams <config.directory>/chunk_<x>_<z>.hdm around the camera. Chunk
+    // meshes are created and destroyed through VulkanCore, so their buffers
+    // copy on the transfer queue; stop before shutdown()
+    void startWorldStreaming(const eden::WorldStreamer::Config& config = eden::WorldStreamer::Config()) {
+        m_world.start(config,
+            [this](eden::ChunkCoord, eden::ChunkGeometry& chunk) -> uint32_t {
+                vkcore::MeshData data;
+                data.format = vkcore::VertexFormat::POSITION_NORMAL_UV;
+                data.vertexCount = static_cast<uint32_t>(chunk.vertices.size());
+                data.indexCount = static_cast<uint32_t>(chunk.indices.size());
+                data.vertices.resize(chunk.vertices.size() * (sizeof(HDMVertex) / sizeof(float)));
+                memcpy(data.vertices.data(), chunk.vertices.data(), chunk.vertices.size() * sizeof(HDMVertex));
+                data.indices = std::move(chunk.indices);
+                return m_core.createMesh(data);
+            },
+            [this](eden::ChunkCoord, uint32_t mesh) { m_core.destroyMesh(mesh); });
+    }
+    
+    void stopWorldStreaming() { m_world.stop(); }
+    
+    // Once a frame after moving the camera: streams chunks and, when the
+    // camera is far from the origin, shifts the camera and every object
+    // back near zero (true if it did)
+    bool updateWorldStreaming() {
+        float shift[3];
+        if (!m_world.update(&m_camera.position.x, shift)) return false;
+        rebaseWorld(glm::vec3(shift[0], shift[1], shift[2]));
+        return true;
+    }
+    
+    // Draws the resident chunks with the bound pipeline (POSITION_NORMAL_UV)
+    void drawWorldChunks(const glm::vec4& color = glm::vec4(1.0f)) {
+        m_world.forEachResident([&](eden::ChunkCoord, uint32_t mesh, const float offset[3]) {
+            m_core.drawMesh(mesh, glm::translate(glm::mat4(1.0f), glm::vec3(offset[0], offset[1], offset[2])), color);
+        });
+    }
+    
+    eden::WorldStreamer& getWorld() { return m_world; }
+    
     // ========================================================================
     // Game Objects
     // ========================================================================
@@ -181,6 +275,29 @@ public:
     void snapSmallBlockToBigBlock(int smallIdx, int bigIdx);
     void dropSmallBlock(int smallIdx, const glm::vec3& dropPos);
     
+    // ========================================================================
+    // Frustum Culling
+    // ========================================================================
+    
+    // Indices of the visible objects the camera can see (m_core's frustum,
+    // so after the camera is set for the frame), ascending. An object's
+    // sphere circles its box: centre at position, radius half the diagonal.
+    vkcore::CullStats cullObjects(std::vector<uint32_t>& visible) {
+        m_cullList.resize(m_objects.size());
+        for (size_t i = 0; i < m_objects.size(); i++) {
+            const GameObject& obj = m_objects[i];
+            m_cullList.set(i, obj.position, 0.5f * glm::length(obj.size));
+        }
+        m_cullStats = m_cullList.cull(m_core.getFrustum(), visible);
+        visible.erase(std::remove_if(visible.begin(), visible.end(),
+                                     [&](uint32_t i) { return !m_objects[i].isVisible; }),
+                      visible.end());
+        return m_cullStats;
+    }
+    
+    // Counts from the last cullObjects()
+    const vkcore::CullStats& getCullStats() const { return m_cullStats; }
+    
     // ========================================================================
     // Accessors
     // ========================================================================
@@ -195,9 +312,33 @@ private:
     void initWorld();
     void processInput(float deltaTime);
     
+    // Moves the local origin by `shift`: everything positioned locally
+    // moves the other way, so nothing moves in the world
+    void rebaseWorld(const glm::vec3& shift) {
+        m_camera.position -= shift;
+        for (size_t i = 0; i < m_objects.size(); i++) {
+            GameObject& obj = m_objects[i];
+            obj.position -= shift;
+            obj.previousPosition -= shift;
+            glm::vec3 boxMin = obj.position - obj.size * 0.5f;
+            glm::vec3 boxMax = obj.position + obj.size * 0.5f;
+            m_objectGrid.update(static_cast<uint32_t>(i), &boxMin.x, &boxMax.x);
+        }
+    }
+    
+    void storePreviousState() {
+        for (auto& obj : m_objects) {
+            obj.previousPosition = obj.position;
+            obj.previousYawDegrees = obj.yawDegrees;
+            obj.hasPreviousState = true;
+        }
+    }
+    
     // VulkanCore - the foundation
     vkcore::VulkanCore m_core;
     vkcore::PipelineHandle m_pipeline = vkcore::INVALID_PIPELINE;
+    // After m_core, so its chunk meshes are released first
+    eden::WorldStreamer m_world;
     
     // Window
     GLFWwindow* m_window = nullptr;
@@ -205,6 +346,11 @@ private:
     // Game state
     FPSCamera m_camera;
     std::vector<GameObject> m_objects;
+    // Object boxes by index, for the raycasts and findBigBlockUnder();
+    // createObject/setObjectPosition/updateAttachedObjects keep it current
+    eden::ObjectGrid m_objectGrid;
+    vkcore::CullList m_cullList;  // Object spheres, refreshed by cullObjects()
+    vkcore::CullStats m_cullStats;
     
     // Shared mesh for cubes (all cubes use same geometry)
     vkcore::MeshHandle m_cubeMesh = vkcore::INVALID_MESH;
@@ -216,8 +362,9 @@ private:
     bool m_cursorHidden = false;
     
     // Timing
-    float m_deltaTime = 0.016f;
+    float m_deltaTime = 0.016f;  // Wall time of the last frame; simulate() spends it
     double m_lastFrameTime = 0.0;
+    FixedTimestep m_simClock;    // 60 Hz, at most 5 steps a frame
 };
 
 // ============================================================================
@@ -15,5 +15,12 @@ if %errorlevel% neq 0 (
     exit /b 1
 )
 
+glslangValidator -V cube_instanced.vert -o vert_cube_instanced.spv
+if %errorlevel% neq 0 (
+    echo Failed to compile instanced cube vertex shader!
+    pause
+    exit /b 1
+)
+
 echo Shaders compiled successfully!
 
@@ -21,6 +21,9 @@ layout(push_constant) uniform PushConstants {
 // Output to fragment shader
 layout(location = 0) out vec3 fragColor;
 
+// Same depth in every pipeline variant (DrawPass::Shading tests EQUAL)
+invariant gl_Position;
+
 void main() {
     gl_Position = ubo.proj * ubo.view * push.model * vec4(inPosition, 1.0);
     
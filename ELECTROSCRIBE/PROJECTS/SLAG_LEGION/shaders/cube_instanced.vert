@@ -0,0 +1,43 @@
+#version 450
+
+// Shared cube mesh (POSITION_COLOR format, white, -0.5..0.5)
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+
+// Uniform buffer (view, projection only - model comes per instance)
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+    mat4 model;   // Unused, but must be here for padding
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// One per colored cube (FpsCubeInstance in eden_vulkan_helpers.cpp)
+struct CubeInstance {
+    vec4 positionYaw;  // xyz = center, w = yaw around +Y in degrees
+    vec4 size;         // xyz = per-axis size
+    vec4 color;        // rgb
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer CubeInstances {
+    CubeInstance cubes[];
+};
+
+// Output to fragment shader
+layout(location = 0) out vec3 fragColor;
+
+// Same depth in every pipeline variant (DrawPass::Shading tests EQUAL)
+invariant gl_Position;
+
+void main() {
+    CubeInstance cube = cubes[gl_InstanceIndex];
+    
+    // Scale, then rotate around Y (same as glm::rotate), then translate
+    vec3 p = inPosition * cube.size.xyz;
+    float yaw = radians(cube.positionYaw.w);
+    float c = cos(yaw);
+    float s = sin(yaw);
+    vec3 world = vec3(p.x * c + p.z * s, p.y, -p.x * s + p.z * c) + cube.positionYaw.xyz;
+    
+    gl_Position = ubo.proj * ubo.view * vec4(world, 1.0);
+    fragColor = inColor * cube.color.rgb;
+}
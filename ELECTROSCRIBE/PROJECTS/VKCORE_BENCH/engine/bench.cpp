@@ -0,0 +1,324 @@
+// ============================================================================
+// VKCORE BENCH - Headless frame-time benchmark for VulkanCore
+// ============================================================================
+// Renders canned scenes offscreen (CoreConfig::headless) at a fixed size and
+// reports CPU frame-time percentiles per scene:
+//
+//   cubes   - a field of POSITION_COLOR cubes through shaders/simple.*.spv
+//   lit     - a GLB model through LightingManager (procedural spheres if
+//             VKCORE_BENCH_GLB is unset or fails to load), lit by
+//             VKCORE_BENCH_LIGHTS clustered point lights
+//   facial  - FacialSystem DMap blending with animated slider weights
+//
+// Run from a directory containing shaders/ (simple, lit_mesh, dmap_mesh).
+// Environment: VKCORE_BENCH_FRAMES (default 500), VKCORE_BENCH_GLB (path),
+// VKCORE_BENCH_LIGHTS (default 256), VKCORE_BENCH_CLUSTERED (default 1),
+// VKCORE_BENCH_PACKED (default 0; 1 draws the lit scene from 16-byte packed
+// vertices, needs shaders/lit_mesh*.packed.vert.spv).
+// ============================================================================
+
+#include "../../../../vulkan/core/vulkan_core.h"
+#include "../../../../vulkan/lighting/lighting_manager.h"
+#include "../../../../vulkan/facial/facial_system.h"
+#include "../../../../vulkan/utils/glb_loader.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace vkcore;
+
+namespace {
+
+constexpr int BENCH_WIDTH = 1280;
+constexpr int BENCH_HEIGHT = 720;
+constexpr int WARMUP_FRAMES = 30;
+constexpr int CUBE_GRID = 32;  // CUBE_GRID^2 cubes
+
+int envInt(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    int parsed = value ? std::atoi(value) : 0;
+    return parsed > 0 ? parsed : fallback;
+}
+
+float percentile(const std::vector<float>& sorted, float p) {
+    if (sorted.empty()) return 0.0f;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Runs warmup + measured frames; draw(frame) records inside the render pass
+bool runScene(VulkanCore& core, const char* name, int frames, const std::function<void(int)>& draw) {
+    core.waitForUploads();
+
+    std::vector<float> frameMs;
+    frameMs.reserve(frames);
+    uint64_t triangles = 0, trianglesFull = 0;
+
+    for (int frame = 0; frame < WARMUP_FRAMES + frames; frame++) {
+        if (!core.beginFrame()) continue;
+        // frameMs and the render stats cover the previous beginFrame -> this one
+        if (frame > WARMUP_FRAMES) {
+            frameMs.push_back(core.getFrameTimings().frameMs);
+            triangles += core.getRenderStats().triangles;
+            trianglesFull += core.getRenderStats().trianglesFullDetail;
+        }
+        draw(frame);
+        core.endFrame();
+    }
+    vkDeviceWaitIdle(core.getDevice());
+
+    if (frameMs.empty()) {
+        std::cerr << "[Bench] " << name << ": no frames rendered" << std::endl;
+        return false;
+    }
+
+    std::sort(frameMs.begin(), frameMs.end());
+    float total = 0.0f;
+    for (float ms : frameMs) total += ms;
+
+    printf("[Bench] %-8s %5zu frames  avg %7.3f ms  p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f\n",
+           name, frameMs.size(), total / frameMs.size(),
+           percentile(frameMs, 0.50f), percentile(frameMs, 0.90f), percentile(frameMs, 0.99f),
+           frameMs.back());
+    printf("[Bench] %-8s %9.0f tris/frame (%.0f%% of full detail)\n", name,
+           double(triangles) / frameMs.size(), trianglesFull ? 100.0 * triangles / trianglesFull : 100.0);
+    return true;
+}
+
+// UV sphere with UV1 = UV0, so it works as both a lit mesh and a DMap target
+eden::GLBMesh makeSphere(uint32_t rings, uint32_t segments) {
+    eden::GLBMesh mesh;
+    mesh.name = "bench_sphere";
+    for (uint32_t r = 0; r <= rings; r++) {
+        float v = static_cast<float>(r) / rings;
+        float phi = v * 3.14159265f;
+        for (uint32_t s = 0; s <= segments; s++) {
+            float u = static_cast<float>(s) / segments;
+            float theta = u * 6.28318531f;
+            eden::GLBVertex vert;
+            vert.normal = glm::vec3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+            vert.position = vert.normal * 0.5f;
+            vert.texCoord = glm::vec2(u, v);
+            vert.texCoord1 = vert.texCoord;
+            vert.color = glm::vec4(1.0f);
+            mesh.vertices.push_back(vert);
+        }
+    }
+    for (uint32_t r = 0; r < rings; r++) {
+        for (uint32_t s = 0; s < segments; s++) {
+            uint32_t a = r * (segments + 1) + s;
+            uint32_t b = a + segments + 1;
+            mesh.indices.insert(mesh.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+    mesh.hasNormals = true;
+    mesh.hasUV1 = true;
+    return mesh;
+}
+
+MeshHandle uploadMesh(VulkanCore& core, const eden::GLBMesh& src, VertexFormat format, bool packed = false) {
+    MeshData data;
+    data.format = format;
+    data.vertexCount = static_cast<uint32_t>(src.vertices.size());
+    data.indices = src.indices;
+    data.indices.insert(data.indices.end(), src.lodIndices.begin(), src.lodIndices.end());
+    data.indexCount = static_cast<uint32_t>(data.indices.size());
+    data.lods = src.lods;
+    for (const auto& v : src.vertices) {
+        data.vertices.insert(data.vertices.end(), {v.position.x, v.position.y, v.position.z,
+                                                   v.normal.x, v.normal.y, v.normal.z,
+                                                   v.texCoord.x, v.texCoord.y});
+        if (format == VertexFormat::POSITION_NORMAL_UV0_UV1) {
+            data.vertices.insert(data.vertices.end(), {v.texCoord1.x, v.texCoord1.y});
+        }
+    }
+    // Procedural meshes come without the loader's LOD chain
+    if (data.lods.empty()) generateMeshLods(data);
+    if (packed) packMeshVertices(data);
+    return core.createMesh(data);
+}
+
+bool benchCubes(VulkanCore& core, int frames) {
+    PipelineConfig config;
+    config.vertexShaderPath = "shaders/simple.vert.spv";
+    config.fragmentShaderPath = "shaders/simple.frag.spv";
+    config.vertexFormat = VertexFormat::POSITION_COLOR;
+    PipelineHandle pipeline = core.createPipeline(config);
+    MeshHandle cube = core.createCube(0.5f, glm::vec3(0.8f, 0.4f, 0.2f));
+    if (pipeline == INVALID_PIPELINE || cube == INVALID_MESH) return false;
+
+    core.setCamera(glm::vec3(0.0f, 20.0f, 30.0f), glm::vec3(0.0f));
+    bool ok = runScene(core, "cubes", frames, [&](int frame) {
+        core.bindPipeline(pipeline);
+        float spin = frame * 0.02f;
+        for (int z = 0; z < CUBE_GRID; z++) {
+            for (int x = 0; x < CUBE_GRID; x++) {
+                glm::vec3 pos(x - CUBE_GRID * 0.5f, 0.0f, z - CUBE_GRID * 0.5f);
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
+                model = glm::rotate(model, spin + (x + z) * 0.1f, glm::vec3(0, 1, 0));
+                core.drawMesh(cube, model);
+            }
+        }
+    });
+
+    core.destroyMesh(cube);
+    core.destroyPipeline(pipeline);
+    return ok;
+}
+
+bool benchLit(VulkanCore& core, int frames) {
+    lighting::LightingManager lighting;
+    bool packed = envInt("VKCORE_BENCH_PACKED", 0) != 0;
+    if (packed) lighting.setVertexFormat(VertexFormat::PACKED_POSITION_NORMAL_UV);
+    if (!lighting.init(&core)) return false;
+    lighting.setDirectionalLight(glm::vec3(-0.4f, -1.0f, -0.3f), glm::vec3(1.0f), 1.0f);
+    lighting.setAmbientLight(glm::vec3(0.15f));
+    lighting.setClusteredLighting(envInt("VKCORE_BENCH_CLUSTERED", 1) != 0);
+
+    // Small colored lights scattered over the grid, orbiting each frame
+    int lightCount = std::max(0, envInt("VKCORE_BENCH_LIGHTS", 256));
+    std::vector<lighting::PointLightHandle> lights;
+    for (int i = 0; i < lightCount; i++) {
+        glm::vec3 color(0.5f + 0.5f * std::sin(i * 1.3f), 0.5f + 0.5f * std::sin(i * 2.1f + 2.0f),
+                        0.5f + 0.5f * std::sin(i * 0.7f + 4.0f));
+        lights.push_back(lighting.addPointLight(glm::vec3(0.0f), color, 1.5f, 1.5f));
+    }
+
+    eden::GLBModel model;
+    const char* glbPath = std::getenv("VKCORE_BENCH_GLB");
+    if (!glbPath || !eden::loadGLB(glbPath, model)) {
+        model.clear();
+        model.meshes.push_back(makeSphere(48, 96));
+    }
+
+    std::vector<MeshHandle> meshes;
+    std::vector<TextureHandle> meshTextures;
+    std::vector<TextureHandle> textures;
+    core.beginUploadBatch();
+    for (const auto& tex : model.textures) {
+        textures.push_back(tex.valid ? core.createTexture(tex.pixels.data(), tex.width, tex.height, 4)
+                                     : INVALID_TEXTURE);
+    }
+    for (const auto& mesh : model.meshes) {
+        meshes.push_back(uploadMesh(core, mesh, VertexFormat::POSITION_NORMAL_UV, packed));
+        bool hasTexture = mesh.textureIndex >= 0 && mesh.textureIndex < static_cast<int>(textures.size());
+        meshTextures.push_back(hasTexture ? textures[mesh.textureIndex] : INVALID_TEXTURE);
+    }
+    core.endUploadBatch();
+
+    // A 5x5 grid of the model, so a single small GLB still loads the GPU
+    core.setCamera(glm::vec3(0.0f, 3.0f, 8.0f), glm::vec3(0.0f));
+    lighting.setCameraPosition(glm::vec3(0.0f, 3.0f, 8.0f));
+    bool ok = runScene(core, "lit", frames, [&](int frame) {
+        lighting.setViewMatrix(core.getViewMatrix());
+        lighting.setProjectionMatrix(core.getProjectionMatrix());
+        for (size_t i = 0; i < lights.size(); i++) {
+            float angle = frame * 0.02f + i * 2.39996f;  // Golden angle spiral
+            float radius = 4.0f * std::sqrt((i + 0.5f) / lights.size());
+            glm::vec3 pos(radius * std::cos(angle), 0.5f + 0.3f * std::sin(angle * 3.0f), radius * std::sin(angle));
+            lighting.setPointLight(lights[i], pos, lighting.getPointLight(lights[i]).color, 1.5f, 1.5f);
+        }
+        lighting.bind();
+        VKCORE_GPU_SCOPE_ON(&core, "lighting");  // One scope for the pass, not per draw
+        glm::mat4 spin = glm::rotate(glm::mat4(1.0f), frame * 0.01f, glm::vec3(0, 1, 0));
+        for (int i = 0; i < 25; i++) {
+            glm::vec3 pos((i % 5 - 2) * 1.5f, 0.0f, (i / 5 - 2) * 1.5f);
+            glm::mat4 world = glm::translate(glm::mat4(1.0f), pos) * spin;
+            for (size_t m = 0; m < meshes.size(); m++) {
+                lighting.bindTexture(meshTextures[m]);
+                lighting.drawLitMesh(meshes[m], world);
+            }
+        }
+    });
+
+    const lighting::LightClusters::Stats& clusterStats = lighting.getClusterStats();
+    printf("[Bench] %-8s %u/%u lights on screen, %u cluster entries, <= %u per cluster (%s)\n", "lit",
+           clusterStats.lightsBinned, clusterStats.lights, clusterStats.indexCount, clusterStats.maxPerCluster,
+           lighting.isClusteredLighting() ? "clustered" : "unclustered");
+
+    for (MeshHandle mesh : meshes) core.destroyMesh(mesh);
+    for (TextureHandle tex : textures) {
+        if (tex != INVALID_TEXTURE) core.destroyTexture(tex);
+    }
+    lighting.shutdown();
+    return ok;
+}
+
+bool benchFacial(VulkanCore& core, int frames) {
+    facial::FacialSystem facial;
+    if (!facial.init(&core)) return false;
+
+    // Procedural RGB displacement maps, one per slider (128 = no offset)
+    constexpr uint32_t DMAP_SIZE = 256;
+    constexpr int DMAP_COUNT = 4;
+    std::vector<uint8_t> pixels(DMAP_SIZE * DMAP_SIZE * 3);
+    for (int d = 0; d < DMAP_COUNT; d++) {
+        for (uint32_t y = 0; y < DMAP_SIZE; y++) {
+            for (uint32_t x = 0; x < DMAP_SIZE; x++) {
+                float wave = std::sin((x + d * 37) * 0.05f) * std::cos((y + d * 19) * 0.05f);
+                uint8_t* p = &pixels[(y * DMAP_SIZE + x) * 3];
+                p[0] = 128;
+                p[1] = static_cast<uint8_t>(128 + wave * 100.0f);
+                p[2] = 128;
+            }
+        }
+        if (facial.loadDMapFromMemory(pixels.data(), DMAP_SIZE, DMAP_SIZE,
+                                      "bench_" + std::to_string(d), d, 3, false) < 0) {
+            facial.shutdown();
+            return false;
+        }
+    }
+
+    MeshHandle head = uploadMesh(core, makeSphere(96, 192), VertexFormat::POSITION_NORMAL_UV0_UV1);
+
+    core.setCamera(glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(0.0f));
+    bool ok = runScene(core, "facial", frames, [&](int frame) {
+        for (int d = 0; d < DMAP_COUNT; d++) {
+            facial.setSliderWeight(d, 0.5f + 0.5f * std::sin(frame * 0.05f + d));
+        }
+        facial.bind();
+        VKCORE_GPU_SCOPE_ON(&core, "facial");
+        facial.drawMesh(head, glm::mat4(1.0f), core.getViewMatrix(), core.getProjectionMatrix());
+    });
+
+    core.destroyMesh(head);
+    facial.shutdown();
+    return ok;
+}
+
+} // namespace
+
+extern "C" int vkcore_bench_run() {
+    int frames = envInt("VKCORE_BENCH_FRAMES", 500);
+
+    CoreConfig config;
+    config.appName = "VulkanCore Bench";
+    config.width = BENCH_WIDTH;
+    config.height = BENCH_HEIGHT;
+    config.headless = true;
+
+    VulkanCore core;
+    if (!core.init(nullptr, config)) {
+        std::cerr << "[Bench] VulkanCore headless init failed" << std::endl;
+        return 0;
+    }
+    core.setPerspective(60.0f, 0.1f, 200.0f);
+
+    std::cout << "[Bench] " << BENCH_WIDTH << "x" << BENCH_HEIGHT << ", " << frames
+              << " frames per scene, " << core.getFramesInFlight() << " frames in flight" << std::endl;
+
+    bool ok = true;
+    ok &= benchCubes(core, frames);
+    ok &= benchLit(core, frames);
+    ok &= benchFacial(core, frames);
+
+    core.shutdown();
+    return ok ? 1 : 0;
+}
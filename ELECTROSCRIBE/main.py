@@ -195,6 +195,7 @@ class Editor:
         self._run_clicked = False  # Flag to track if run button was clicked
         self._run_process = None  # Store the running process to detect termination
         self._just_built = False  # Flag to prevent auto-hotload immediately after build
+        self._last_build_ok = False  # Result of the last _do_build link
         self._setup_file_watcher()
         self.keywords = {
             "fn",
@@ -1685,7 +1686,7 @@ class Editor:
 
             # Transpile timing
             transpile_start = time.time()
-            result = self._run_step("Compile", fmt_cmd(CMD_COMPILE))
+            result = self._run_step("Compile", self._compile_cmd(fmt_cmd(CMD_COMPILE), os.path.dirname(hd_path)))
             transpile_time = (time.time() - transpile_start) * 1000  # Convert to ms
             
             # Initialize variables to avoid UnboundLocalError
@@ -1694,7 +1695,10 @@ class Editor:
             if result:
                 # Build timing
                 build_start = time.time()
-                shader_compile_time = self._do_build(hd_path, cpp_path)
+                if self._project_build_profile(os.path.dirname(cpp_path)) == "pgo":
+                    shader_compile_time = self._pgo_cycle(hd_path, cpp_path)
+                else:
+                    shader_compile_time = self._do_build(hd_path, cpp_path)
                 build_time = time.time() - build_start
                 result = True  # Assume success for now (errors are in log)
             
@@ -2089,8 +2093,9 @@ class Editor:
                 except Exception as e:
                     self.log_lines.append(f"WARNING: Failed to copy NEUROSHELL shader {shader_file}: {e}")
     
-    def _do_build(self, hd_path, cpp_path):
-        """Build the C++ code with all necessary libraries and includes."""
+    def _do_build(self, hd_path, cpp_path, profile=None):
+        """Build the C++ code with all necessary libraries and includes.
+        profile overrides the project's build_profile (see _profile_flags)."""
         # Get project root (two levels up from ELECTROSCRIBE)
         script_dir = os.path.dirname(os.path.abspath(__file__))
         project_root = os.path.abspath(os.path.join(script_dir, ".."))
@@ -2105,6 +2110,9 @@ class Editor:
         imgui_glfw_enabled = False  # ImGui with GLFW/Vulkan (for ESE-style editors)
         use_modular_engine = False  # Use project-specific engine instead of eden_vulkan_helpers
         modular_engine_sources = []  # Custom source files for modular engine
+        build_profile = "default"  # default | release | pgo-gen | pgo-use
+        build_compiler = "g++"
+        build_march = "native"  # -march for release/pgo-use builds
         if os.path.exists(config_path):
             try:
                 with open(config_path, "r") as f:
@@ -2126,8 +2134,18 @@ class Editor:
                             # Comma-separated list of source files relative to project dir
                             value = line.split("=", 1)[1].strip()
                             modular_engine_sources = [s.strip() for s in value.split(",") if s.strip()]
+                        elif line.startswith("build_profile="):
+                            build_profile = line.split("=", 1)[1].strip().lower() or build_profile
+                        elif line.startswith("build_compiler="):
+                            build_compiler = line.split("=", 1)[1].strip() or build_compiler
+                        elif line.startswith("build_march="):
+                            build_march = line.split("=", 1)[1].strip()
             except Exception as e:
                 self.log_lines.append(f"WARNING: Could not read project config: {e}")
+        if profile:
+            build_profile = profile
+        profile_compile_flags, profile_link_flags, profile_unkeyed = self._profile_flags(
+            build_profile, build_compiler, build_march, project_dir)
         
         # Compile shaders first (if we have hot shaders)
         shader_compile_success, shader_compile_time = self._compile_shaders_for_build(project_dir)
@@ -2158,7 +2176,10 @@ class Editor:
                     self.log_lines.append(f"WARNING: Shader source not found: {source_shader}")
         
         # Start with base command
-        build_cmd = ["g++", "-std=c++17", "-O3"]
+        build_cmd = [build_compiler, "-std=c++17"] + profile_compile_flags
+        if self._profile_systems(project_dir):
+            # Engine sources time their vkcore_/lighting_/facial_ entry points too
+            build_cmd.append("-DEDEN_PROFILE_SYSTEMS=1")
         
         # Add include paths
         build_cmd.extend(["-I", project_root])  # For stdlib/vulkan.h
@@ -2166,9 +2187,15 @@ class Editor:
         
         # Add Vulkan SDK include if available
         vulkan_sdk = os.environ.get("VULKAN_SDK")
+        use_shaderc = False
         if vulkan_sdk:
             inc = os.path.join(vulkan_sdk, "Include")
             build_cmd.extend(["-I", inc])
+            # Shader hot-reload compiles GLSL in process when the SDK ships shaderc;
+            # otherwise vkcore::ShaderCompiler runs glslc
+            use_shaderc = os.path.exists(os.path.join(inc, "shaderc", "shaderc.h"))
+            if use_shaderc:
+                build_cmd.append("-DVKCORE_SHADERC")
         else:
             self.log_lines.append("WARNING: VULKAN_SDK not set; Vulkan headers may be missing")
         
@@ -2417,14 +2444,6 @@ class Editor:
         exe_name = os.path.splitext(os.path.basename(hd_path))[0] + ".exe"
         exe_path = os.path.join(project_dir, exe_name)
         
-        # DIAGNOSTIC: Force delete old exe to prevent stale binary issues
-        if os.path.exists(exe_path):
-            try:
-                os.remove(exe_path)
-                self.log_lines.append(f"[DEBUG] Deleted old {exe_name} to force rebuild")
-            except Exception as e:
-                self.log_lines.append(f"[DEBUG] Could not delete {exe_name}: {e}")
-        
         build_cmd.extend(["-o", exe_path])
         
         # Add library paths
@@ -2442,6 +2461,8 @@ class Editor:
         
         # Add libraries to link
         build_cmd.extend(["-lvulkan-1", "-lglfw3", "-lgdi32", "-lcomdlg32", "-lole32"])
+        if use_shaderc:
+            build_cmd.append("-lshaderc_shared")
         
         # Add SDL3/SDL2 library path and linking if UI windows are enabled OR if we have audio/video resources
         # (has_audio_resources was already checked above for DLL copy)
@@ -2503,6 +2524,9 @@ class Editor:
                 build_cmd.append("-DUSE_SDL2_UI")
                 self.log_lines.append("UI windows enabled - added USE_SDL2_UI and USE_IMGUI flags")
             build_cmd.append("-DUSE_IMGUI")
+            # The UI window draws on its own thread, so each thread gets its own ImGui context
+            thread_context_header = os.path.join(project_root, "vulkan", "imgui_thread_context.h").replace("\\", "/")
+            build_cmd.append(f'-DIMGUI_USER_CONFIG="{thread_context_header}"')
         
         # Add NEUROSHELL (lightweight in-game UI system) if enabled
         if neuroshell_enabled:
@@ -2523,7 +2547,8 @@ class Editor:
             build_cmd.append("-DUSE_NEUROSHELL")
             self.log_lines.append("NEUROSHELL enabled - added USE_NEUROSHELL flag")
         
-        self._run_step("Build", build_cmd)
+        self._last_build_ok = self._build_incremental(build_cmd, cpp_path, project_dir,
+                                                      profile_link_flags, profile_unkeyed)
         
         # DIAGNOSTIC: Verify build succeeded by checking timestamps
         if os.path.exists(exe_path) and os.path.exists(cpp_path):
@@ -2546,6 +2571,11 @@ class Editor:
                 dll_name = f"{system_name}.dll"
                 dll_path = os.path.join(project_dir, dll_name)
                 
+                # The compiler only rewrites the DLL source when it changes
+                if os.path.exists(dll_path) and os.path.getmtime(dll_path) >= os.path.getmtime(dll_cpp_path):
+                    self.log_lines.append(f"  DLL up to date: {dll_name}")
+                    continue
+                
                 # Compile DLL
                 dll_build_cmd = [
                     "g++",
@@ -2565,6 +2595,398 @@ class Editor:
         
         return shader_compile_time
     
+    # ---------- Build profiles ----------
+    # build_profile in .project_config picks the optimisation flags:
+    #   default  - -O3 (the old one-line build)
+    #   release  - -O3, -march=<build_march>, LTO (ThinLTO with clang)
+    #   pgo-gen  - instrumented build; running it writes profiles to .heidic_build/pgo
+    #   pgo-use  - release flags plus the recorded profiles
+    #   pgo      - the whole cycle on F5: release baseline run, instrumented
+    #              training run, pgo-use rebuild and run, frame-time report
+    # The training run is pgo_train (a command line, {exe} is the built
+    # executable; default: the executable itself, e.g. a headless benchmark
+    # or a gameplay session you play and quit).
+
+    def _read_project_setting(self, project_dir, key, default=None):
+        """One key=value setting from the project's .project_config."""
+        config_path = os.path.join(project_dir, ".project_config")
+        try:
+            with open(config_path, "r") as f:
+                for line in f:
+                    line = line.strip()
+                    if line.startswith(key + "="):
+                        return line.split("=", 1)[1].strip()
+        except OSError:
+            pass
+        return default
+
+    def _project_build_profile(self, project_dir):
+        return (self._read_project_setting(project_dir, "build_profile", "default") or "default").lower()
+
+    def _profile_systems(self, project_dir):
+        return (self._read_project_setting(project_dir, "profile_systems", "0") or "0").lower() in ("1", "true", "yes", "on")
+
+    def _compile_cmd(self, cmd, project_dir):
+        """CMD_COMPILE plus --profile when the project sets profile_systems=1 (per-system timers)."""
+        if self._profile_systems(project_dir):
+            return cmd + ["--profile"]
+        return cmd
+
+    def _pgo_dir(self, project_dir):
+        return os.path.join(project_dir, ".heidic_build", "pgo")
+
+    def _profile_flags(self, profile, compiler, march, project_dir):
+        """(compile flags, link flags, flags kept out of object names) for a build profile."""
+        clang = "clang" in os.path.basename(compiler)
+        lto = ["-flto=thin"] if clang else ["-flto=auto"]
+        tune = [f"-march={march}"] if march else []
+        pgo_dir = self._pgo_dir(project_dir)
+        if profile == "pgo":
+            # Builds outside the F5 cycle (hotload rebuilds) reuse what was recorded
+            profile = "pgo-use" if os.path.isdir(pgo_dir) else "release"
+        if profile == "release":
+            flags = ["-O3"] + tune + lto
+            return flags, flags, []
+        if profile == "pgo-gen":
+            os.makedirs(pgo_dir, exist_ok=True)
+            flags = ["-O3"] + tune + [f"-fprofile-generate={pgo_dir}"]
+            if not clang:
+                flags.append("-fprofile-update=prefer-atomic")  # JobSystem workers share counters
+            # Same object paths as pgo-use: gcc finds each .gcda by its object's path
+            return flags, flags, flags
+        if profile == "pgo-use":
+            if clang:
+                use = [f"-fprofile-use={os.path.join(pgo_dir, 'merged.profdata')}",
+                       "-Wno-profile-instr-unprofiled", "-Wno-profile-instr-out-of-date"]
+            else:
+                use = [f"-fprofile-use={pgo_dir}", "-fprofile-partial-training", "-Wno-missing-profile"]
+            flags = ["-O3"] + tune + lto + use
+            return flags, flags, flags
+        if profile != "default":
+            self.log_lines.append(f"WARNING: Unknown build_profile '{profile}', using default")
+        return ["-O3"], [], []
+
+    def _pgo_run(self, label, exe_path, project_dir):
+        """Run the training command once; returns (output, seconds) or None if it failed."""
+        import shlex
+        train = self._read_project_setting(project_dir, "pgo_train")
+        timeout = float(self._read_project_setting(project_dir, "pgo_train_timeout", "900") or 900)
+        if train:
+            cmd = [part.replace("{exe}", exe_path) for part in shlex.split(train, posix=(os.name != "nt"))]
+        else:
+            cmd = [exe_path]
+        self.status = f"PGO: {label} run..."
+        self._add_terminal_line(f"[PGO] {label} run: {' '.join(cmd)}")
+        start = time.time()
+        try:
+            proc = subprocess.run(
+                cmd,
+                cwd=project_dir,
+                capture_output=True,
+                text=True,
+                encoding='utf-8',
+                errors='replace',
+                timeout=timeout,
+            )
+        except (OSError, subprocess.TimeoutExpired) as e:
+            self.log_lines.append(f"ERROR: PGO {label} run failed: {e}")
+            return None
+        elapsed = time.time() - start
+        output = (proc.stdout or "") + (proc.stderr or "")
+        if proc.returncode != 0:
+            self.log_lines.extend(output.splitlines()[-20:])
+            self.log_lines.append(f"ERROR: PGO {label} run exited with {proc.returncode}")
+            return None
+        return output, elapsed
+
+    def _frame_times(self, output):
+        """{scene: (avg, p50, p90, p99)} from VKCORE_BENCH-style "[Bench] scene N frames avg ..." lines."""
+        times = {}
+        pattern = re.compile(r"\[Bench\]\s+(\S+)\s+\d+ frames\s+avg\s+([\d.]+) ms\s+p50\s+([\d.]+)\s+p90\s+([\d.]+)\s+p99\s+([\d.]+)")
+        for match in pattern.finditer(output):
+            times[match.group(1)] = tuple(float(v) for v in match.groups()[1:])
+        return times
+
+    def _log_frame_time_report(self, before, after):
+        """Terminal table of release vs pgo-use frame times (or run times without [Bench] output)."""
+        self._add_terminal_line("")
+        self._add_terminal_line("=== PGO Frame-Time Report (release -> pgo-use) ===")
+        before_times, after_times = self._frame_times(before[0]), self._frame_times(after[0])
+        scenes = [scene for scene in before_times if scene in after_times]
+
+        def change(old, new):
+            return f"{old:7.3f} -> {new:7.3f} ms ({(new - old) / old * 100.0 if old else 0.0:+.1f}%)"
+
+        for scene in scenes:
+            (b_avg, b_p50, b_p90, b_p99), (a_avg, a_p50, a_p90, a_p99) = before_times[scene], after_times[scene]
+            self._add_terminal_line(f"{scene:<8} avg {change(b_avg, a_avg)}  p99 {change(b_p99, a_p99)}")
+        if not scenes:
+            self._add_terminal_line(f"run time {before[1]:.2f} s -> {after[1]:.2f} s "
+                                    "(the training run printed no [Bench] frame times)")
+        self._add_terminal_line("")
+
+    def _pgo_cycle(self, hd_path, cpp_path):
+        """build_profile=pgo: release baseline, instrumented training run, pgo-use rebuild."""
+        project_dir = os.path.dirname(cpp_path)
+        exe_path = os.path.join(project_dir, os.path.splitext(os.path.basename(hd_path))[0] + ".exe")
+        compiler = self._read_project_setting(project_dir, "build_compiler", "g++") or "g++"
+
+        shader_compile_time = self._do_build(hd_path, cpp_path, profile="release")
+        before = self._pgo_run("baseline", exe_path, project_dir) if self._last_build_ok else None
+        if before is None:
+            self.log_lines.append("ERROR: PGO stopped: the release build or its baseline run failed")
+            return shader_compile_time
+
+        # Profiles from older code only produce mismatch warnings
+        pgo_dir = self._pgo_dir(project_dir)
+        if os.path.isdir(pgo_dir):
+            import shutil
+            shutil.rmtree(pgo_dir, ignore_errors=True)
+        self._do_build(hd_path, cpp_path, profile="pgo-gen")
+        if not self._last_build_ok or self._pgo_run("training", exe_path, project_dir) is None:
+            self.log_lines.append("ERROR: PGO stopped: the instrumented build or training run failed")
+            return shader_compile_time
+
+        if "clang" in os.path.basename(compiler):
+            import glob
+            profdata = os.environ.get("LLVM_PROFDATA", "llvm-profdata")
+            raw = glob.glob(os.path.join(pgo_dir, "*.profraw"))
+            if not raw or not self._run_step("Merge profiles", [profdata, "merge", "-output=" + os.path.join(pgo_dir, "merged.profdata")] + raw):
+                self.log_lines.append("ERROR: PGO stopped: no profiles to merge (set LLVM_PROFDATA?)")
+                return shader_compile_time
+
+        self._do_build(hd_path, cpp_path, profile="pgo-use")
+        after = self._pgo_run("optimized", exe_path, project_dir) if self._last_build_ok else None
+        if after is None:
+            self.log_lines.append("ERROR: PGO stopped: the pgo-use build or its run failed")
+            return shader_compile_time
+        self._log_frame_time_report(before, after)
+        return shader_compile_time
+
+    # ---------- Incremental build ----------
+    # Every translation unit is compiled to its own object in
+    # <project>/.heidic_build and relinked only when something changed, so
+    # an edit to the .hd file recompiles the generated .cpp alone; the engine
+    # runtime (eden_vulkan_helpers.cpp, ImGui, NEUROSHELL) is compiled once.
+    # The generated .cpp's leading #includes (Vulkan, GLFW, glm, ...) go into
+    # a precompiled header.
+
+    def _split_build_cmd(self, build_cmd):
+        """Split a one-shot g++ command into (compiler, compile flags, sources, link flags, output)."""
+        compiler = build_cmd[0]
+        compile_flags, sources, link_flags = [], [], []
+        output = None
+        i = 1
+        while i < len(build_cmd):
+            arg = build_cmd[i]
+            if arg in ("-I", "-L", "-o") and i + 1 < len(build_cmd):
+                value = build_cmd[i + 1]
+                if arg == "-I":
+                    compile_flags.extend([arg, value])
+                elif arg == "-L":
+                    link_flags.extend([arg, value])
+                else:
+                    output = value
+                i += 2
+                continue
+            if arg.endswith((".cpp", ".cc", ".c")):
+                sources.append(arg)
+            elif arg.startswith(("-l", "-L", "-Wl,")):
+                link_flags.append(arg)
+            else:
+                compile_flags.append(arg)
+            i += 1
+        return compiler, compile_flags, sources, link_flags, output
+
+    def _read_depfile(self, dep_path):
+        """Files listed in a gcc -MMD dependency file ([] if missing)."""
+        try:
+            with open(dep_path, "r", encoding="utf-8", errors="replace") as f:
+                text = f.read()
+        except OSError:
+            return []
+        text = text.replace("\\\n", " ")
+        if ":" not in text:
+            return []
+        # Drop the target: "obj.o: dep dep ..." (skip drive letters like C:\)
+        match = re.search(r":(\s|$)", text)
+        body = text[match.end():] if match else ""
+        deps = []
+        for token in re.findall(r"(?:\\ |[^\s])+", body):
+            deps.append(token.replace("\\ ", " "))
+        return deps
+
+    def _is_up_to_date(self, target, dep_path):
+        """True if target exists and is newer than every file in its depfile."""
+        if not os.path.exists(target):
+            return False
+        deps = self._read_depfile(dep_path)
+        if not deps:
+            return False
+        target_time = os.path.getmtime(target)
+        for dep in deps:
+            if not os.path.exists(dep) or os.path.getmtime(dep) > target_time:
+                return False
+        return True
+
+    def _run_compile(self, cmd):
+        """Run one compile job off the UI thread; returns (ok, output)."""
+        try:
+            proc = subprocess.run(
+                cmd,
+                cwd=os.path.abspath(os.path.join(os.path.dirname(__file__), "..")),
+                capture_output=True,
+                text=True,
+                encoding='utf-8',
+                errors='replace',
+                shell=False,
+            )
+        except FileNotFoundError:
+            return False, f"command not found: {cmd[0]}"
+        return proc.returncode == 0, (proc.stdout or "") + (proc.stderr or "")
+
+    def _write_pch_header(self, cpp_path, pch_header):
+        """Write the generated .cpp's leading #include block as a header; False if it has none."""
+        includes = []
+        try:
+            with open(cpp_path, "r", encoding="utf-8", errors="replace") as f:
+                for line in f:
+                    stripped = line.strip()
+                    if not stripped or stripped.startswith("//"):
+                        continue
+                    if not stripped.startswith("#include"):
+                        break
+                    # The header lives in .heidic_build: pin "local" includes to the .cpp's directory
+                    match = re.match(r'#include\s+"([^"]+)"', stripped)
+                    if match:
+                        local = os.path.join(os.path.dirname(os.path.abspath(cpp_path)), match.group(1))
+                        if os.path.exists(local):
+                            stripped = '#include "' + local.replace("\\", "/") + '"'
+                    includes.append(stripped)
+        except OSError:
+            return False
+        if not includes:
+            return False
+        content = "// Generated by ELECTROSCRIBE: precompiled prelude of " + os.path.basename(cpp_path) + "\n"
+        content += "\n".join(includes) + "\n"
+        existing = None
+        if os.path.exists(pch_header):
+            with open(pch_header, "r", encoding="utf-8", errors="replace") as f:
+                existing = f.read()
+        if existing != content:
+            with open(pch_header, "w", encoding="utf-8") as f:
+                f.write(content)
+        return True
+
+    def _build_incremental(self, build_cmd, cpp_path, project_dir, link_extra=(), unkeyed_flags=()):
+        """Compile changed translation units into cached objects, then link.
+        link_extra goes on the link line too (LTO, PGO); unkeyed_flags are
+        left out of the object names so pgo-gen and pgo-use builds write the
+        same object paths, which is how gcc matches .gcda files to objects."""
+        import hashlib
+        from concurrent.futures import ThreadPoolExecutor
+
+        compiler, compile_flags, sources, link_flags, output = self._split_build_cmd(build_cmd)
+        if not output or not sources:
+            return self._run_step("Build", build_cmd)
+
+        build_dir = os.path.join(project_dir, ".heidic_build")
+        os.makedirs(build_dir, exist_ok=True)
+        flags_key = "\0".join([compiler] + compile_flags)
+        object_key = "\0".join([compiler] + [f for f in compile_flags if f not in unkeyed_flags])
+
+        # Precompiled header for the generated translation unit
+        pch_flags = []
+        pch_header = os.path.join(build_dir, "heidic_prelude.h")
+        if os.path.abspath(cpp_path) in [os.path.abspath(s) for s in sources] and self._write_pch_header(cpp_path, pch_header):
+            gch_path = pch_header + ".gch"
+            gch_dep = pch_header + ".d"
+            gch_stamp = pch_header + ".flags"
+            stamp_ok = False
+            if os.path.exists(gch_stamp):
+                with open(gch_stamp, "r", encoding="utf-8") as f:
+                    stamp_ok = f.read() == flags_key
+            if stamp_ok and self._is_up_to_date(gch_path, gch_dep):
+                pch_flags = ["-include", pch_header]
+            else:
+                ok, out = self._run_compile([compiler] + compile_flags + ["-x", "c++-header", pch_header, "-o", gch_path, "-MMD", "-MF", gch_dep])
+                if ok:
+                    with open(gch_stamp, "w", encoding="utf-8") as f:
+                        f.write(flags_key)
+                    pch_flags = ["-include", pch_header]
+                    self.log_lines.append("Precompiled header rebuilt")
+                else:
+                    self.log_lines.append("WARNING: Precompiled header failed, compiling without it")
+                    if out:
+                        self.log_lines.extend(out.splitlines())
+
+        # One object per source; the name hashes path + flags so flag changes rebuild
+        jobs = []
+        objects = []
+        for source in sources:
+            extra = pch_flags if os.path.abspath(source) == os.path.abspath(cpp_path) else []
+            key = hashlib.sha1((os.path.abspath(source) + "\0" + object_key + "\0" + " ".join(extra)).encode("utf-8")).hexdigest()[:12]
+            stem = os.path.splitext(os.path.basename(source))[0]
+            obj = os.path.join(build_dir, f"{stem}-{key}.o")
+            dep = obj[:-2] + ".d"
+            objects.append(obj)
+            # A rebuilt precompiled header invalidates the object that uses it
+            pch_newer = bool(extra) and os.path.exists(obj) and os.path.getmtime(pch_header + ".gch") > os.path.getmtime(obj)
+            # Objects shared between profiles remember the flags they were built with
+            obj_flags = obj[:-2] + ".flags"
+            built_with = None
+            if os.path.exists(obj_flags):
+                with open(obj_flags, "r", encoding="utf-8") as f:
+                    built_with = f.read()
+            flags_changed = built_with != flags_key
+            if pch_newer or flags_changed or not self._is_up_to_date(obj, dep):
+                jobs.append((source, obj_flags, [compiler] + compile_flags + extra + ["-c", source, "-o", obj, "-MMD", "-MF", dep]))
+
+        if jobs:
+            self.log_lines.append(f"Compiling {len(jobs)} of {len(sources)} translation unit(s)...")
+            workers = max(1, min(len(jobs), os.cpu_count() or 1))
+            with ThreadPoolExecutor(max_workers=workers) as pool:
+                results = list(pool.map(lambda job: job[:2] + self._run_compile(job[2]), jobs))
+            failed = False
+            for source, obj_flags, ok, out in results:
+                if out:
+                    self.log_lines.extend(out.splitlines())
+                if not ok:
+                    failed = True
+                    self.log_lines.append(f"ERROR: Failed to compile {os.path.basename(source)}")
+                else:
+                    with open(obj_flags, "w", encoding="utf-8") as f:
+                        f.write(flags_key)
+            if failed:
+                self.status = "Build failed"
+                return False
+        else:
+            self.log_lines.append(f"All {len(sources)} translation unit(s) up to date")
+
+        # Relink only if an object is newer than the executable or it was
+        # linked from different objects (another profile)
+        link_cmd = [compiler] + list(link_extra) + objects + ["-o", output] + link_flags
+        link_stamp = os.path.join(build_dir, os.path.basename(output) + ".link")
+        linked_with = None
+        if os.path.exists(link_stamp):
+            with open(link_stamp, "r", encoding="utf-8") as f:
+                linked_with = f.read()
+        if not jobs and os.path.exists(output) and linked_with == "\0".join(link_cmd):
+            output_time = os.path.getmtime(output)
+            if all(os.path.getmtime(obj) <= output_time for obj in objects):
+                self.status = "Build ok (up to date)"
+                return True
+        if os.path.exists(output):
+            try:
+                os.remove(output)  # Never leave a stale binary behind a failed link
+            except OSError as e:
+                self.log_lines.append(f"WARNING: Could not remove old {os.path.basename(output)}: {e}")
+        if not self._run_step("Link", link_cmd):
+            return False
+        with open(link_stamp, "w", encoding="utf-8") as f:
+            f.write("\0".join(link_cmd))
+        return True
+
     def hotload_dll(self):
         """Rebuild hot-reloadable DLL(s) for @hot systems, compile hot shaders, or recompile resources."""
         if not self.has_hot_systems():
@@ -2646,7 +3068,8 @@ class Editor:
         if dll_files or has_resources:
             self.status = "Hotloading: Recompiling HEIDIC..."
             pygame.display.flip()
-            result = self._run_step("Hotload-Compile", [p.format(file=hd_path, cpp="") for p in CMD_COMPILE])
+            result = self._run_step("Hotload-Compile", self._compile_cmd([p.format(file=hd_path, cpp="") for p in CMD_COMPILE],
+                                                                         os.path.dirname(hd_path)))
             
             if not result:
                 self.status = "Hotload failed: Compilation error"
@@ -37,13 +37,20 @@ bool neuroshell_is_enabled();
 // ============================================================================
 
 // Update NEUROSHELL (call each frame before rendering)
-// Updates animations, effects, input state
+// Updates animations, effects, input state. Only elements with a playing
+// animation or running effect are visited; nothing else changes by itself
 void neuroshell_update(float delta_time);
 
 // Render all UI elements (call within render pass, after game rendering)
 // commandBuffer: Current Vulkan command buffer (must be in active render pass)
+// Element textures share atlas pages (neuroshell_batch.h), and every visible
+// quad of the frame is written to one mapped vertex buffer sorted by depth,
+// so the UI costs one pipeline bind and one draw per atlas page used
 void neuroshell_render(VkCommandBuffer commandBuffer);
 
+// Quads and draw calls of the last neuroshell_render (either may be NULL)
+void neuroshell_get_render_stats(int* quads, int* draw_calls);
+
 // ============================================================================
 // UI Elements
 // ============================================================================
@@ -93,6 +100,7 @@ typedef int32_t NeuroshellFontID;
 // Load a font from a sprite sheet image
 // font_path: path to font sprite sheet (PNG or DDS)
 // Auto-detects: assumes 16×16 grid (256 chars) in ASCII order (0-255)
+// Built once into a distance field atlas region, so any char size is sharp
 // Returns font ID or NEUROSHELL_INVALID_FONT_ID on failure
 NeuroshellFontID neuroshell_load_font(const char* font_path);
 
@@ -110,6 +118,8 @@ NeuroshellElementID neuroshell_create_text(
 );
 
 // Update text string for a text element
+// Layout is cached: the same string again is a compare and nothing else, so
+// HUD counters may call this every frame
 void neuroshell_set_text_string(NeuroshellElementID text_id, const char* text);
 
 // ============================================================================
@@ -174,7 +184,7 @@ typedef enum {
     NEUROSHELL_EFFECT_FADE,
     NEUROSHELL_EFFECT_SLIDE,
     NEUROSHELL_EFFECT_SCALE,
-    NEUROSHELL_EFFECT_PARTICLE
+    NEUROSHELL_EFFECT_PARTICLE  // Drawn by ElementTree::setParticleEffectHandler
 } NeuroshellEffectType;
 
 // Apply effect to element (placeholder for future implementation)
@@ -0,0 +1,404 @@
+// NEUROSHELL - Quad Batching
+// Texture atlas and per-frame quad batch behind neuroshell_render(): every
+// element texture lives in a few atlas pages, and every visible quad of a
+// frame goes into one vertex stream, sorted by depth, drawn once per page run.
+// Text is laid out into these quads by neuroshell_text.h
+
+#ifndef NEUROSHELL_BATCH_H
+#define NEUROSHELL_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+namespace neuroshell {
+
+// Texture coordinates of an atlas region (or part of one)
+struct UVRect {
+    float u0 = 0.0f, v0 = 0.0f;
+    float u1 = 1.0f, v1 = 1.0f;
+};
+
+// Where an added image landed, in texels of its page
+struct AtlasRegion {
+    uint32_t page = 0;
+    uint32_t x = 0, y = 0;
+    uint32_t width = 0, height = 0;
+};
+
+// One RGBA8 atlas image, uploaded to the GPU as a whole the first time and
+// by its dirty rectangle after that
+struct AtlasPage {
+    uint32_t width = 0, height = 0;
+    std::vector<uint8_t> pixels;  // width * height * 4
+
+    // Texels changed since the last takeDirty() (empty when x1 <= x0)
+    uint32_t dirtyX0 = 0, dirtyY0 = 0, dirtyX1 = 0, dirtyY1 = 0;
+};
+
+/**
+ * Shelf-packed texture atlas for element textures, fonts and sprite sheets.
+ * Images are packed in rows ("shelves") onto pages of page_size texels; one
+ * larger than a page gets a page of its own. Each image is padded by its
+ * own edge texels so linear filtering never reads a neighbour.
+ *
+ * Region 0 is a white block: untextured panels and buttons sample it, so
+ * solid and textured quads share one pipeline and one draw.
+ *
+ * Usage:
+ *   TextureAtlas atlas;
+ *   int icon = atlas.add(pixels, w, h);           // at element creation
+ *   UVRect uv = atlas.uv(icon);
+ *   uint32_t x, y, w, h;
+ *   if (atlas.takeDirty(page, x, y, w, h)) upload(page, x, y, w, h);
+ */
+class TextureAtlas {
+public:
+    static constexpr uint32_t DEFAULT_PAGE_SIZE = 2048;
+    static constexpr uint32_t PADDING = 1;     // Extruded edge texels around each image
+    static constexpr uint32_t WHITE_SIZE = 4;  // Region 0
+
+    explicit TextureAtlas(uint32_t pageSize = DEFAULT_PAGE_SIZE)
+        : m_pageSize(std::max<uint32_t>(pageSize, 64)) {
+        std::vector<uint8_t> white(WHITE_SIZE * WHITE_SIZE * 4, 255);
+        add(white.data(), WHITE_SIZE, WHITE_SIZE);
+    }
+
+    // Copies width x height RGBA8 texels in; returns the region id, or -1
+    // for an empty image
+    int add(const uint8_t* rgba, uint32_t width, uint32_t height) {
+        if (!rgba || width == 0 || height == 0) return -1;
+        uint32_t paddedW = width + 2 * PADDING;
+        uint32_t paddedH = height + 2 * PADDING;
+
+        uint32_t page = 0, x = 0, y = 0;
+        if (paddedW > m_pageSize || paddedH > m_pageSize) {
+            page = newPage(paddedW, paddedH);  // Oversized: a page of its own
+        } else if (!place(paddedW, paddedH, page, x, y)) {
+            page = newPage(m_pageSize, m_pageSize);
+            place(paddedW, paddedH, page, x, y);
+        }
+
+        AtlasRegion region;
+        region.page = page;
+        region.x = x + PADDING;
+        region.y = y + PADDING;
+        region.width = width;
+        region.height = height;
+        blit(region, rgba);
+        m_regions.push_back(region);
+        return static_cast<int>(m_regions.size()) - 1;
+    }
+
+    int whiteRegion() const { return 0; }
+    size_t regionCount() const { return m_regions.size(); }
+    const AtlasRegion& region(int id) const { return m_regions[size_t(id)]; }
+
+    // Whole region, or the texel rectangle [x0, x1) x [y0, y1) inside it
+    // (a sprite sheet frame, a font glyph)
+    UVRect uv(int id) const {
+        const AtlasRegion& r = region(id);
+        return uv(id, 0.0f, 0.0f, float(r.width), float(r.height));
+    }
+    UVRect uv(int id, float x0, float y0, float x1, float y1) const {
+        const AtlasRegion& r = region(id);
+        const AtlasPage& p = m_pages[r.page];
+        UVRect out;
+        out.u0 = (float(r.x) + x0) / float(p.width);
+        out.v0 = (float(r.y) + y0) / float(p.height);
+        out.u1 = (float(r.x) + x1) / float(p.width);
+        out.v1 = (float(r.y) + y1) / float(p.height);
+        return out;
+    }
+
+    size_t pageCount() const { return m_pages.size(); }
+    const AtlasPage& page(size_t index) const { return m_pages[index]; }
+
+    // The page's changed rectangle since the last call, then clears it
+    bool takeDirty(size_t index, uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) {
+        AtlasPage& p = m_pages[index];
+        if (p.dirtyX1 <= p.dirtyX0 || p.dirtyY1 <= p.dirtyY0) return false;
+        x = p.dirtyX0;
+        y = p.dirtyY0;
+        width = p.dirtyX1 - p.dirtyX0;
+        height = p.dirtyY1 - p.dirtyY0;
+        p.dirtyX0 = p.dirtyY0 = p.dirtyX1 = p.dirtyY1 = 0;
+        return true;
+    }
+
+private:
+    struct Shelf {
+        uint32_t y = 0;
+        uint32_t height = 0;
+        uint32_t used = 0;  // Width taken from the left
+    };
+
+    uint32_t newPage(uint32_t width, uint32_t height) {
+        AtlasPage p;
+        p.width = width;
+        p.height = height;
+        p.pixels.assign(size_t(width) * height * 4, 0);
+        m_pages.push_back(std::move(p));
+        m_shelves.emplace_back();
+        m_shelfTop.push_back(0);
+        return static_cast<uint32_t>(m_pages.size()) - 1;
+    }
+
+    // Best-fitting shelf on any regular page (least height wasted), else a
+    // new shelf on the first page with room
+    bool place(uint32_t width, uint32_t height, uint32_t& page, uint32_t& x, uint32_t& y) {
+        Shelf* best = nullptr;
+        uint32_t bestPage = 0;
+        for (uint32_t p = 0; p < m_pages.size(); p++) {
+            if (m_pages[p].width != m_pageSize || m_pages[p].height != m_pageSize) continue;
+            for (Shelf& shelf : m_shelves[p]) {
+                if (shelf.height >= height && m_pageSize - shelf.used >= width &&
+                    (!best || shelf.height < best->height)) {
+                    best = &shelf;
+                    bestPage = p;
+                }
+            }
+        }
+        // A much taller shelf would waste most of its row on this image
+        if (best && best->height <= height + height / 2 + 2) {
+            page = bestPage;
+            x = best->used;
+            y = best->y;
+            best->used += width;
+            return true;
+        }
+        for (uint32_t p = 0; p < m_pages.size(); p++) {
+            if (m_pages[p].width != m_pageSize || m_pages[p].height != m_pageSize) continue;
+            if (m_pageSize - m_shelfTop[p] < height) continue;
+            Shelf shelf;
+            shelf.y = m_shelfTop[p];
+            shelf.height = height;
+            shelf.used = width;
+            m_shelves[p].push_back(shelf);
+            m_shelfTop[p] += height;
+            page = p;
+            x = 0;
+            y = shelf.y;
+            return true;
+        }
+        if (best) {
+            page = bestPage;
+            x = best->used;
+            y = best->y;
+            best->used += width;
+            return true;
+        }
+        return false;
+    }
+
+    // Copies the image in and extrudes its edges into the padding
+    void blit(const AtlasRegion& r, const uint8_t* rgba) {
+        AtlasPage& p = m_pages[r.page];
+        uint32_t x0 = r.x - PADDING, y0 = r.y - PADDING;
+        uint32_t w = r.width + 2 * PADDING, h = r.height + 2 * PADDING;
+        for (uint32_t row = 0; row < h; row++) {
+            uint32_t srcY = std::min(std::max(row, PADDING) - PADDING, r.height - 1);
+            uint8_t* dst = &p.pixels[(size_t(y0 + row) * p.width + x0) * 4];
+            const uint8_t* src = rgba + size_t(srcY) * r.width * 4;
+            for (uint32_t i = 0; i < PADDING; i++) std::memcpy(dst + i * 4, src, 4);
+            std::memcpy(dst + PADDING * 4, src, size_t(r.width) * 4);
+            for (uint32_t i = 0; i < PADDING; i++) {
+                std::memcpy(dst + (PADDING + r.width + i) * 4, src + (r.width - 1) * 4, 4);
+            }
+        }
+        bool clean = p.dirtyX1 <= p.dirtyX0 || p.dirtyY1 <= p.dirtyY0;
+        p.dirtyX0 = clean ? x0 : std::min(p.dirtyX0, x0);
+        p.dirtyY0 = clean ? y0 : std::min(p.dirtyY0, y0);
+        p.dirtyX1 = clean ? x0 + w : std::max(p.dirtyX1, x0 + w);
+        p.dirtyY1 = clean ? y0 + h : std::max(p.dirtyY1, y0 + h);
+    }
+
+    uint32_t m_pageSize;
+    std::vector<AtlasPage> m_pages;
+    std::vector<std::vector<Shelf>> m_shelves;  // [page]
+    std::vector<uint32_t> m_shelfTop;           // [page] first free row
+    std::vector<AtlasRegion> m_regions;
+};
+
+// Vertex of shaders/ui.vert: NDC position, UV, RGBA tint, and for distance
+// field text the edge half-width in alpha units (0 = plain texture)
+struct QuadVertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+    float sdfEdge;
+};
+
+// What each quad slot of one vertex buffer region holds, so build() can
+// leave slots alone whose quad hasn't changed. Keep one per frame in flight
+// (each region was last written a few frames ago).
+struct QuadSlots {
+    std::vector<uint64_t> stamps;  // [slot]; 0 = unknown
+    float width = 0.0f, height = 0.0f;  // Screen size they were written at
+};
+
+// Non-zero identity of a quad's contents: an element's id, a version that
+// changes with anything the quad shows, and the quad's index in the element
+inline uint64_t quadStamp(uint32_t element, uint32_t version, uint32_t index) {
+    uint64_t h = (uint64_t(element) << 32 | version) ^ (uint64_t(index) * 0x9E3779B97F4A7C15ull);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h ? h : 1;
+}
+
+// Consecutive quads on one atlas page: one vkCmdDrawIndexed
+struct DrawRun {
+    uint32_t page = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+/**
+ * One frame's quads. Elements add() theirs in any order; build() sorts them
+ * by depth (higher on top, so drawn later; equal depths keep their add
+ * order), writes four vertices per quad to the mapped vertex buffer and
+ * returns the draw runs - one per change of atlas page, so a UI on a single
+ * page is a single draw.
+ *
+ * Indices never change: fill the index buffer once with writeIndices() for
+ * the largest batch. The vertex buffer is one persistently mapped host-
+ * coherent buffer with a region per frame in flight, so build() writes
+ * while the GPU still reads last frame's.
+ *
+ * Quads added with a stamp (quadStamp()) are only rewritten when the slot
+ * they sort into last held something else: a HUD whose text didn't change
+ * writes nothing. Stamp 0 always writes.
+ *
+ * Usage:
+ *   batch.begin(screenWidth, screenHeight);
+ *   batch.add(x, y, w, h, atlas.uv(icon), atlas.region(icon).page, r, g, b, a, depth);
+ *   size_t quads = batch.build(mapped + frame * MAX_QUADS * 4, MAX_QUADS);
+ *   for (const DrawRun& run : batch.runs()) {
+ *       bindPage(run.page);
+ *       vkCmdDrawIndexed(cmd, run.indexCount, 1, run.firstIndex, frame * MAX_QUADS * 4, 0);
+ *   }
+ */
+class QuadBatch {
+public:
+    void begin(float screenWidth, float screenHeight) {
+        m_quads.clear();
+        m_runs.clear();
+        m_invWidth = screenWidth > 0.0f ? 2.0f / screenWidth : 0.0f;
+        m_invHeight = screenHeight > 0.0f ? 2.0f / screenHeight : 0.0f;
+    }
+
+    // Pixel rectangle (top-left origin) with its atlas UVs and tint
+    void add(float x, float y, float width, float height, const UVRect& uv, uint32_t page,
+             float r, float g, float b, float a, float depth, uint64_t stamp = 0, float sdfEdge = 0.0f) {
+        if (width <= 0.0f || height <= 0.0f || a <= 0.0f) return;
+        Quad q;
+        q.stamp = stamp;
+        q.sdfEdge = sdfEdge;
+        q.x = x;
+        q.y = y;
+        q.width = width;
+        q.height = height;
+        q.uv = uv;
+        q.page = page;
+        q.color[0] = r;
+        q.color[1] = g;
+        q.color[2] = b;
+        q.color[3] = a;
+        q.depth = depth;
+        q.order = static_cast<uint32_t>(m_quads.size());
+        m_quads.push_back(q);
+    }
+
+    size_t size() const { return m_quads.size(); }
+
+    // Sorts and writes up to maxQuads quads (the rest are dropped); returns
+    // how many the region holds. With `slots`, unchanged slots are skipped.
+    size_t build(QuadVertex* out, size_t maxQuads, QuadSlots* slots = nullptr) {
+        m_runs.clear();
+        m_written = 0;
+        float width = m_invWidth > 0.0f ? 2.0f / m_invWidth : 0.0f;
+        float height = m_invHeight > 0.0f ? 2.0f / m_invHeight : 0.0f;
+        if (slots && (slots->width != width || slots->height != height)) {
+            std::fill(slots->stamps.begin(), slots->stamps.end(), 0);
+            slots->width = width;
+            slots->height = height;
+        }
+        std::sort(m_quads.begin(), m_quads.end(), [](const Quad& a, const Quad& b) {
+            return a.depth != b.depth ? a.depth < b.depth : a.order < b.order;
+        });
+        size_t count = std::min(m_quads.size(), maxQuads);
+        for (size_t i = 0; i < count; i++) {
+            const Quad& q = m_quads[i];
+            addToRun(q.page, i);
+            if (slots) {
+                if (slots->stamps.size() < count) slots->stamps.resize(count, 0);
+                if (q.stamp != 0 && slots->stamps[i] == q.stamp) continue;
+                slots->stamps[i] = q.stamp;
+            }
+            m_written++;
+            float x0 = q.x * m_invWidth - 1.0f, x1 = (q.x + q.width) * m_invWidth - 1.0f;
+            float y0 = q.y * m_invHeight - 1.0f, y1 = (q.y + q.height) * m_invHeight - 1.0f;
+            QuadVertex* v = out + i * 4;
+            v[0] = {x0, y0, q.uv.u0, q.uv.v0, q.color[0], q.color[1], q.color[2], q.color[3], q.sdfEdge};
+            v[1] = {x1, y0, q.uv.u1, q.uv.v0, q.color[0], q.color[1], q.color[2], q.color[3], q.sdfEdge};
+            v[2] = {x1, y1, q.uv.u1, q.uv.v1, q.color[0], q.color[1], q.color[2], q.color[3], q.sdfEdge};
+            v[3] = {x0, y1, q.uv.u0, q.uv.v1, q.color[0], q.color[1], q.color[2], q.color[3], q.sdfEdge};
+        }
+        return count;
+    }
+
+    const std::vector<DrawRun>& runs() const { return m_runs; }
+
+    // Quads whose vertices the last build() actually wrote
+    size_t written() const { return m_written; }
+
+    // Two triangles per quad, for quads [0, maxQuads)
+    static void writeIndices(uint32_t* out, size_t maxQuads) {
+        for (size_t i = 0; i < maxQuads; i++) {
+            uint32_t base = static_cast<uint32_t>(i * 4);
+            uint32_t* idx = out + i * 6;
+            idx[0] = base;
+            idx[1] = base + 1;
+            idx[2] = base + 2;
+            idx[3] = base + 2;
+            idx[4] = base + 3;
+            idx[5] = base;
+        }
+    }
+
+private:
+    struct Quad {
+        float x, y, width, height;
+        UVRect uv;
+        uint32_t page;
+        float color[4];
+        float depth;
+        uint32_t order;
+        uint64_t stamp;
+        float sdfEdge;
+    };
+
+    void addToRun(uint32_t page, size_t quad) {
+        if (m_runs.empty() || m_runs.back().page != page) {
+            DrawRun run;
+            run.page = page;
+            run.firstIndex = static_cast<uint32_t>(quad * 6);
+            m_runs.push_back(run);
+        }
+        m_runs.back().indexCount += 6;
+    }
+
+    std::vector<Quad> m_quads;
+    std::vector<DrawRun> m_runs;
+    size_t m_written = 0;
+    float m_invWidth = 0.0f;
+    float m_invHeight = 0.0f;
+};
+
+} // namespace neuroshell
+
+#endif // NEUROSHELL_BATCH_H
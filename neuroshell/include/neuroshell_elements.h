@@ -0,0 +1,468 @@
+// NEUROSHELL - Retained Elements
+// The element tree behind the neuroshell_* calls: setters record what
+// changed, update() only visits running animations and effects, and a frame
+// with nothing changed reuses the vertices it already wrote
+
+#ifndef NEUROSHELL_ELEMENTS_H
+#define NEUROSHELL_ELEMENTS_H
+
+#include "neuroshell.h"
+#include "neuroshell_batch.h"
+#include "neuroshell_text.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace neuroshell {
+
+// What a setter changed since the element was last emitted
+enum DirtyFlags : uint32_t {
+    DIRTY_NONE = 0,
+    DIRTY_POSITION = 1u << 0,  // Own or a parent's
+    DIRTY_SIZE = 1u << 1,
+    DIRTY_COLOR = 1u << 2,
+    DIRTY_VISIBLE = 1u << 3,
+    DIRTY_TEXT = 1u << 4,
+    DIRTY_DEPTH = 1u << 5,
+    DIRTY_FRAME = 1u << 6,     // Animation frame
+    DIRTY_EFFECT = 1u << 7,
+    DIRTY_STRUCTURE = 1u << 8  // Created, destroyed or re-parented
+};
+
+struct Element {
+    NeuroshellElementID id = NEUROSHELL_INVALID_ID;
+    NeuroshellElementType type = NEUROSHELL_PANEL;
+    NeuroshellElementID parent = NEUROSHELL_INVALID_ID;
+    std::vector<NeuroshellElementID> children;
+
+    // Set through ElementTree so changes are tracked; position is relative
+    // to the parent
+    float x = 0.0f, y = 0.0f;
+    float width = 0.0f, height = 0.0f;
+    float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float depth = 0.0f;
+    bool visible = true;
+    int textureRegion = 0;  // TextureAtlas region (0 = white)
+
+    // Sprite sheet animation (frameCount > 1)
+    int frameWidth = 0, frameHeight = 0, frameCount = 1;
+    float fps = 0.0f;
+    float frameTime = 0.0f;
+    int frame = 0;
+    bool playing = false, loop = true;
+
+    // Running effect
+    NeuroshellEffectType effect = NEUROSHELL_EFFECT_NONE;
+    float effectTime = 0.0f, effectDuration = 0.0f;
+
+    // Text elements
+    NeuroshellFontID font = NEUROSHELL_INVALID_FONT_ID;
+    float charWidth = 0.0f, charHeight = 0.0f;
+    TextRun text;
+
+    // Resolved by ElementTree
+    uint32_t dirty = DIRTY_NONE;
+    uint32_t version = 0;          // Bumped per emitted change; quad stamps use it
+    float worldX = 0.0f, worldY = 0.0f;
+    bool worldVisible = true;      // Own and every parent's visibility
+    bool active = false;           // In the animation / effect list
+};
+
+// One vertex buffer region (one per frame in flight) and what it holds
+struct RetainedRegion {
+    QuadSlots slots;
+    std::vector<DrawRun> runs;
+    uint64_t change = 0;  // ElementTree::changeCount() it was built at (0 = never)
+    size_t quads = 0;
+};
+
+/**
+ * Retained UI elements. Setters compare, store and mark the element dirty;
+ * a moved or hidden parent marks its subtree. update() advances only the
+ * elements with a playing animation or running effect, so a static menu
+ * costs nothing there. render() emits and builds only when something
+ * changed since the region was last built - a static HUD re-submits the
+ * region's cached draw runs - and even then only dirty elements' quads are
+ * rewritten (their stamps changed).
+ *
+ * Usage:
+ *   NeuroshellElementID hp = tree.create(NEUROSHELL_TEXT, 10, 10, 0, 0);
+ *   tree.setText(hp, "HP 100");          // every frame; a no-op when equal
+ *   tree.update(dt);
+ *   const auto& runs = tree.render(batch, regions[frame], mapped, MAX_QUADS, w, h);
+ */
+class ElementTree {
+public:
+    // ========================================================================
+    // Elements
+    // ========================================================================
+
+    NeuroshellElementID create(NeuroshellElementType type, float x, float y, float width, float height,
+                               NeuroshellElementID parent = NEUROSHELL_INVALID_ID) {
+        NeuroshellElementID id = ++m_lastId;
+        Element e;
+        e.id = id;
+        e.type = type;
+        e.x = x;
+        e.y = y;
+        e.width = width;
+        e.height = height;
+        m_slots[id] = m_elements.size();
+        m_elements.push_back(std::move(e));
+        if (!attach(id, parent)) m_roots.push_back(id);
+        markDirty(id, DIRTY_STRUCTURE);
+        return id;
+    }
+
+    // Destroys the element and its subtree
+    void destroy(NeuroshellElementID id) {
+        Element* e = get(id);
+        if (!e) return;
+        std::vector<NeuroshellElementID> children = e->children;
+        for (NeuroshellElementID child : children) destroy(child);
+        detach(id);
+        e = get(id);
+        if (e->active) m_active.erase(std::find(m_active.begin(), m_active.end(), id));
+        size_t slot = m_slots[id];
+        if (slot + 1 != m_elements.size()) {
+            m_elements[slot] = std::move(m_elements.back());
+            m_slots[m_elements[slot].id] = slot;
+        }
+        m_elements.pop_back();
+        m_slots.erase(id);
+        m_dirty.erase(std::remove(m_dirty.begin(), m_dirty.end(), id), m_dirty.end());
+        m_change++;
+    }
+
+    Element* get(NeuroshellElementID id) {
+        auto it = m_slots.find(id);
+        return it != m_slots.end() ? &m_elements[it->second] : nullptr;
+    }
+    const Element* get(NeuroshellElementID id) const {
+        auto it = m_slots.find(id);
+        return it != m_slots.end() ? &m_elements[it->second] : nullptr;
+    }
+
+    size_t size() const { return m_elements.size(); }
+    const std::vector<Element>& elements() const { return m_elements; }
+
+    void setParent(NeuroshellElementID id, NeuroshellElementID parent) {
+        if (!get(id) || id == parent || isAncestor(id, parent)) return;
+        detach(id);
+        if (!attach(id, parent)) m_roots.push_back(id);
+        markDirty(id, DIRTY_STRUCTURE | DIRTY_POSITION | DIRTY_VISIBLE);
+    }
+
+    // ========================================================================
+    // Properties (each a no-op when the value is unchanged)
+    // ========================================================================
+
+    void setPosition(NeuroshellElementID id, float x, float y) {
+        Element* e = get(id);
+        if (!e || (e->x == x && e->y == y)) return;
+        e->x = x;
+        e->y = y;
+        markDirty(id, DIRTY_POSITION);
+    }
+
+    void setSize(NeuroshellElementID id, float width, float height) {
+        Element* e = get(id);
+        if (!e || (e->width == width && e->height == height)) return;
+        e->width = width;
+        e->height = height;
+        markDirty(id, DIRTY_SIZE);
+    }
+
+    void setColor(NeuroshellElementID id, float r, float g, float b, float a) {
+        Element* e = get(id);
+        if (!e || (e->color[0] == r && e->color[1] == g && e->color[2] == b && e->color[3] == a)) return;
+        e->color[0] = r;
+        e->color[1] = g;
+        e->color[2] = b;
+        e->color[3] = a;
+        markDirty(id, DIRTY_COLOR);
+    }
+
+    void setVisible(NeuroshellElementID id, bool visible) {
+        Element* e = get(id);
+        if (!e || e->visible == visible) return;
+        e->visible = visible;
+        markDirty(id, DIRTY_VISIBLE);
+    }
+
+    void setDepth(NeuroshellElementID id, float depth) {
+        Element* e = get(id);
+        if (!e || e->depth == depth) return;
+        e->depth = depth;
+        markDirty(id, DIRTY_DEPTH);
+    }
+
+    void setTexture(NeuroshellElementID id, int atlasRegion) {
+        Element* e = get(id);
+        if (!e || e->textureRegion == atlasRegion) return;
+        e->textureRegion = atlasRegion;
+        markDirty(id, DIRTY_FRAME);
+    }
+
+    void setText(NeuroshellElementID id, const char* text) {
+        Element* e = get(id);
+        if (e && e->text.setText(text)) markDirty(id, DIRTY_TEXT);
+    }
+
+    void setFont(NeuroshellElementID id, NeuroshellFontID font, float charWidth, float charHeight) {
+        Element* e = get(id);
+        if (!e || (e->font == font && e->charWidth == charWidth && e->charHeight == charHeight)) return;
+        e->font = font;
+        e->charWidth = charWidth;
+        e->charHeight = charHeight;
+        markDirty(id, DIRTY_TEXT);
+    }
+
+    void setAnimation(NeuroshellElementID id, int frameWidth, int frameHeight, int frameCount, float fps) {
+        Element* e = get(id);
+        if (!e) return;
+        e->frameWidth = frameWidth;
+        e->frameHeight = frameHeight;
+        e->frameCount = std::max(1, frameCount);
+        e->fps = fps;
+        e->frame = 0;
+        e->frameTime = 0.0f;
+        markDirty(id, DIRTY_FRAME);
+        refreshActive(*e);
+    }
+
+    void setAnimationState(NeuroshellElementID id, bool playing, bool loop) {
+        Element* e = get(id);
+        if (!e) return;
+        e->playing = playing;
+        e->loop = loop;
+        refreshActive(*e);
+    }
+
+    void applyEffect(NeuroshellElementID id, NeuroshellEffectType effect, float duration) {
+        Element* e = get(id);
+        if (!e) return;
+        e->effect = effect;
+        e->effectTime = 0.0f;
+        e->effectDuration = std::max(duration, 0.0f);
+        markDirty(id, DIRTY_EFFECT);
+        refreshActive(*e);
+    }
+
+    // NEUROSHELL_EFFECT_PARTICLE: called every update() while the effect
+    // runs, with the element (worldX / worldY as of the last render) and the
+    // effect's progress 0..1 - e.g. to emit into a screen-space GpuParticles
+    using ParticleEffectHandler = std::function<void(const Element& e, float deltaTime, float progress)>;
+    void setParticleEffectHandler(ParticleEffectHandler handler) { m_particleHandler = std::move(handler); }
+
+    // Fonts referenced by text elements (ids from 1)
+    NeuroshellFontID addFont(const SdfFont& font) {
+        m_fonts.push_back(font);
+        return static_cast<NeuroshellFontID>(m_fonts.size());
+    }
+    const SdfFont* font(NeuroshellFontID id) const {
+        return id > 0 && size_t(id) <= m_fonts.size() ? &m_fonts[size_t(id) - 1] : nullptr;
+    }
+
+    // ========================================================================
+    // Frame
+    // ========================================================================
+
+    // Advances running animations and effects only
+    void update(float deltaTime) {
+        for (size_t i = 0; i < m_active.size();) {
+            Element& e = *get(m_active[i]);
+            bool running = false;
+            if (e.playing && e.frameCount > 1 && e.fps > 0.0f) {
+                e.frameTime += deltaTime;
+                int frame = static_cast<int>(e.frameTime * e.fps);
+                if (frame >= e.frameCount && !e.loop) {
+                    frame = e.frameCount - 1;
+                    e.playing = false;
+                } else {
+                    frame %= e.frameCount;
+                    running = true;
+                }
+                if (frame != e.frame) {
+                    e.frame = frame;
+                    markDirty(e.id, DIRTY_FRAME);
+                }
+            }
+            if (e.effect != NEUROSHELL_EFFECT_NONE) {
+                e.effectTime += deltaTime;
+                if (e.effect == NEUROSHELL_EFFECT_PARTICLE) {
+                    // Drawn by the handler; the element itself is unchanged
+                    if (m_particleHandler) m_particleHandler(e, deltaTime, effectProgress(e));
+                } else {
+                    markDirty(e.id, DIRTY_EFFECT);
+                }
+                if (e.effectTime >= e.effectDuration) e.effect = NEUROSHELL_EFFECT_NONE;
+                else running = true;
+            }
+            if (running) {
+                i++;
+            } else {
+                e.active = false;
+                m_active[i] = m_active.back();
+                m_active.pop_back();
+            }
+        }
+    }
+
+    // Elements with a playing animation or running effect
+    size_t activeCount() const { return m_active.size(); }
+
+    // Changes so far; a region built at the current count is up to date
+    uint64_t changeCount() const { return m_change; }
+
+    /**
+     * This frame's draw runs for `region` (last written a few frames ago).
+     * Unchanged since then: returns its runs as they are. Otherwise resolves
+     * dirty elements, emits every visible element's quads and builds into
+     * `out`, where only slots with changed quads are written.
+     */
+    const std::vector<DrawRun>& render(QuadBatch& batch, RetainedRegion& region, QuadVertex* out, size_t maxQuads,
+                                       const TextureAtlas& atlas, float screenWidth, float screenHeight) {
+        resolve();
+        if (region.change == m_change && region.slots.width == screenWidth && region.slots.height == screenHeight) {
+            return region.runs;
+        }
+        batch.begin(screenWidth, screenHeight);
+        for (NeuroshellElementID root : m_roots) emit(root, batch, atlas);
+        region.quads = batch.build(out, maxQuads, &region.slots);
+        region.runs = batch.runs();
+        region.change = m_change;
+        return region.runs;
+    }
+
+private:
+    void markDirty(NeuroshellElementID id, uint32_t flags) {
+        Element* e = get(id);
+        if (!e) return;
+        if (e->dirty == DIRTY_NONE) m_dirty.push_back(id);
+        e->dirty |= flags;
+        m_change++;
+    }
+
+    void refreshActive(Element& e) {
+        bool wanted = (e.playing && e.frameCount > 1 && e.fps > 0.0f) || e.effect != NEUROSHELL_EFFECT_NONE;
+        if (wanted && !e.active) m_active.push_back(e.id);
+        if (!wanted && e.active) m_active.erase(std::find(m_active.begin(), m_active.end(), e.id));
+        e.active = wanted;
+    }
+
+    bool attach(NeuroshellElementID id, NeuroshellElementID parent) {
+        Element* p = get(parent);
+        if (!p) {
+            get(id)->parent = NEUROSHELL_INVALID_ID;
+            return false;
+        }
+        p->children.push_back(id);
+        get(id)->parent = parent;
+        return true;
+    }
+
+    void detach(NeuroshellElementID id) {
+        Element* e = get(id);
+        std::vector<NeuroshellElementID>& list = get(e->parent) ? get(e->parent)->children : m_roots;
+        list.erase(std::remove(list.begin(), list.end(), id), list.end());
+        e->parent = NEUROSHELL_INVALID_ID;
+    }
+
+    bool isAncestor(NeuroshellElementID ancestor, NeuroshellElementID id) const {
+        for (const Element* e = get(id); e; e = get(e->parent)) {
+            if (e->id == ancestor) return true;
+        }
+        return false;
+    }
+
+    // World position and visibility of dirty elements and, where those
+    // moved or changed visibility, their subtrees
+    void resolve() {
+        for (NeuroshellElementID id : m_dirty) {
+            Element* e = get(id);
+            if (!e || e->dirty == DIRTY_NONE) continue;
+            const Element* p = get(e->parent);
+            resolveSubtree(*e, p ? p->worldX : 0.0f, p ? p->worldY : 0.0f, p ? p->worldVisible : true);
+        }
+        m_dirty.clear();
+    }
+
+    void resolveSubtree(Element& e, float parentX, float parentY, bool parentVisible) {
+        float worldX = parentX + e.x, worldY = parentY + e.y;
+        bool worldVisible = parentVisible && e.visible;
+        bool moved = worldX != e.worldX || worldY != e.worldY || worldVisible != e.worldVisible;
+        e.worldX = worldX;
+        e.worldY = worldY;
+        e.worldVisible = worldVisible;
+        e.dirty = DIRTY_NONE;
+        e.version++;
+        if (e.type == NEUROSHELL_TEXT) {
+            e.text.setLayout(worldX, worldY, e.charWidth, e.charHeight);
+            e.text.setColor(e.color[0], e.color[1], e.color[2], e.color[3] * effectAlpha(e));
+        }
+        if (!moved) return;
+        for (NeuroshellElementID child : e.children) {
+            Element* c = get(child);
+            if (c) resolveSubtree(*c, worldX, worldY, worldVisible);
+        }
+    }
+
+    static float effectProgress(const Element& e) {
+        return e.effectDuration > 0.0f ? std::min(1.0f, e.effectTime / e.effectDuration) : 1.0f;
+    }
+    static float effectAlpha(const Element& e) {
+        return e.effect == NEUROSHELL_EFFECT_FADE ? effectProgress(e) : 1.0f;
+    }
+
+    void emit(NeuroshellElementID id, QuadBatch& batch, const TextureAtlas& atlas) {
+        Element* e = get(id);
+        if (!e || !e->worldVisible) return;
+        float x = e->worldX, y = e->worldY, w = e->width, h = e->height;
+        float t = effectProgress(*e);
+        if (e->effect == NEUROSHELL_EFFECT_SLIDE) x -= (1.0f - t) * w;
+        if (e->effect == NEUROSHELL_EFFECT_SCALE) {
+            x += 0.5f * w * (1.0f - t);
+            y += 0.5f * h * (1.0f - t);
+            w *= t;
+            h *= t;
+        }
+
+        if (e->type == NEUROSHELL_TEXT) {
+            const SdfFont* f = font(e->font);
+            if (f) e->text.emit(batch, static_cast<uint32_t>(e->id), *f, e->depth);
+        } else if (e->textureRegion >= 0 && size_t(e->textureRegion) < atlas.regionCount()) {
+            UVRect uv = atlas.uv(e->textureRegion);
+            if (e->frameCount > 1 && e->frameWidth > 0 && e->frameHeight > 0) {
+                const AtlasRegion& r = atlas.region(e->textureRegion);
+                int columns = std::max(1, int(r.width) / e->frameWidth);
+                float fx = float((e->frame % columns) * e->frameWidth);
+                float fy = float((e->frame / columns) * e->frameHeight);
+                uv = atlas.uv(e->textureRegion, fx, fy, fx + float(e->frameWidth), fy + float(e->frameHeight));
+            }
+            batch.add(x, y, w, h, uv, atlas.region(e->textureRegion).page, e->color[0], e->color[1], e->color[2],
+                      e->color[3] * effectAlpha(*e), e->depth, quadStamp(static_cast<uint32_t>(e->id), e->version, 0));
+        }
+        for (NeuroshellElementID child : e->children) emit(child, batch, atlas);
+    }
+
+    std::vector<Element> m_elements;
+    std::unordered_map<NeuroshellElementID, size_t> m_slots;  // id -> index in m_elements
+    std::vector<NeuroshellElementID> m_roots;
+    std::vector<NeuroshellElementID> m_dirty;   // Marked since the last resolve()
+    std::vector<NeuroshellElementID> m_active;  // Playing animations, running effects
+    std::vector<SdfFont> m_fonts;
+    ParticleEffectHandler m_particleHandler;
+    NeuroshellElementID m_lastId = NEUROSHELL_INVALID_ID;
+    uint64_t m_change = 1;
+};
+
+} // namespace neuroshell
+
+#endif // NEUROSHELL_ELEMENTS_H
@@ -0,0 +1,294 @@
+// NEUROSHELL - Text
+// Distance field glyph atlas for sprite sheet fonts, built once per font,
+// and cached per-element text layout that is only redone when the string,
+// position, size or colour actually changes
+
+#ifndef NEUROSHELL_TEXT_H
+#define NEUROSHELL_TEXT_H
+
+#include "neuroshell_batch.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace neuroshell {
+
+namespace text_detail {
+
+// Felzenszwalb-Huttenlocher 1D squared distance transform of f[0, n) into d
+inline void distance1D(const float* f, float* d, int n, int* v, float* z) {
+    const float INF = 1e20f;
+    int k = 0;
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = INF;
+    for (int q = 1; q < n; q++) {
+        float s = ((f[q] + float(q) * q) - (f[v[k]] + float(v[k]) * v[k])) / float(2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + float(q) * q) - (f[v[k]] + float(v[k]) * v[k])) / float(2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INF;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < float(q)) k++;
+        float dq = float(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+// Squared distance of every texel to the nearest texel with seed[i] set
+inline void distance2D(const std::vector<uint8_t>& seed, int width, int height, std::vector<float>& out) {
+    const float INF = 1e20f;
+    int n = std::max(width, height);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+    out.resize(size_t(width) * height);
+    for (size_t i = 0; i < out.size(); i++) out[i] = seed[i] ? 0.0f : INF;
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) f[y] = out[size_t(y) * width + x];
+        distance1D(f.data(), d.data(), height, v.data(), z.data());
+        for (int y = 0; y < height; y++) out[size_t(y) * width + x] = d[y];
+    }
+    for (int y = 0; y < height; y++) {
+        distance1D(&out[size_t(y) * width], d.data(), width, v.data(), z.data());
+        std::memcpy(&out[size_t(y) * width], d.data(), sizeof(float) * width);
+    }
+}
+
+} // namespace text_detail
+
+/**
+ * A 16 x 16 ASCII sprite sheet font (see FONT_GUIDE.md) as a signed
+ * distance field in one atlas region. Each glyph cell gets `spread` texels
+ * of margin so its field isn't clipped; alpha is 0.5 on the outline and
+ * rises inward, so one build draws sharp text at every char size.
+ *
+ * Coverage is the sheet's alpha, or its luminance when the sheet is fully
+ * opaque (white glyphs on black).
+ *
+ * Usage:
+ *   SdfFont font;
+ *   font.build(atlas, pixels, width, height);   // neuroshell_load_font
+ */
+class SdfFont {
+public:
+    static constexpr uint32_t GRID = 16;
+
+    // False if the sheet isn't a 16 x 16 grid of at least 1 x 1 cells
+    bool build(TextureAtlas& atlas, const uint8_t* rgba, uint32_t width, uint32_t height) {
+        if (!rgba || width < GRID || height < GRID || width % GRID || height % GRID) return false;
+        m_cellWidth = width / GRID;
+        m_cellHeight = height / GRID;
+        m_spread = std::max<uint32_t>(2, std::min(m_cellWidth, m_cellHeight) / 8);
+
+        bool opaque = true;
+        for (size_t i = 0; i < size_t(width) * height && opaque; i++) opaque = rgba[i * 4 + 3] == 255;
+
+        uint32_t outCellW = m_cellWidth + 2 * m_spread;
+        uint32_t outCellH = m_cellHeight + 2 * m_spread;
+        uint32_t outW = outCellW * GRID, outH = outCellH * GRID;
+        std::vector<uint8_t> out(size_t(outW) * outH * 4, 255);
+
+        std::vector<uint8_t> inside(size_t(outCellW) * outCellH), outside(inside.size());
+        std::vector<float> toInside, toOutside;
+        for (uint32_t glyph = 0; glyph < GRID * GRID; glyph++) {
+            uint32_t cx = (glyph % GRID) * m_cellWidth, cy = (glyph / GRID) * m_cellHeight;
+            bool any = false;
+            for (uint32_t y = 0; y < outCellH; y++) {
+                for (uint32_t x = 0; x < outCellW; x++) {
+                    bool in = false;
+                    if (x >= m_spread && y >= m_spread && x - m_spread < m_cellWidth && y - m_spread < m_cellHeight) {
+                        const uint8_t* p = &rgba[(size_t(cy + y - m_spread) * width + cx + x - m_spread) * 4];
+                        uint32_t coverage = opaque ? (uint32_t(p[0]) * 54 + uint32_t(p[1]) * 183 + uint32_t(p[2]) * 19) >> 8
+                                                   : p[3];
+                        in = coverage >= 128;
+                    }
+                    inside[size_t(y) * outCellW + x] = in;
+                    outside[size_t(y) * outCellW + x] = !in;
+                    any = any || in;
+                }
+            }
+            m_hasGlyph[glyph] = any;
+
+            uint32_t ox = (glyph % GRID) * outCellW, oy = (glyph / GRID) * outCellH;
+            if (!any) {
+                for (uint32_t y = 0; y < outCellH; y++) {
+                    for (uint32_t x = 0; x < outCellW; x++) out[(size_t(oy + y) * outW + ox + x) * 4 + 3] = 0;
+                }
+                continue;
+            }
+            text_detail::distance2D(inside, int(outCellW), int(outCellH), toInside);
+            text_detail::distance2D(outside, int(outCellW), int(outCellH), toOutside);
+            for (uint32_t y = 0; y < outCellH; y++) {
+                for (uint32_t x = 0; x < outCellW; x++) {
+                    size_t i = size_t(y) * outCellW + x;
+                    // Texel centres: the outline sits half a texel past the last inside one
+                    float distance = inside[i] ? std::sqrt(toOutside[i]) - 0.5f : 0.5f - std::sqrt(toInside[i]);
+                    float alpha = 0.5f + distance / float(2 * m_spread);
+                    out[(size_t(oy + y) * outW + ox + x) * 4 + 3] =
+                        uint8_t(std::min(255.0f, std::max(0.0f, alpha * 255.0f + 0.5f)));
+                }
+            }
+        }
+
+        m_region = atlas.add(out.data(), outW, outH);
+        if (m_region < 0) return false;
+        const AtlasRegion& region = atlas.region(m_region);
+        m_page = region.page;
+        for (uint32_t glyph = 0; glyph < GRID * GRID; glyph++) {
+            float x0 = float((glyph % GRID) * outCellW), y0 = float((glyph / GRID) * outCellH);
+            m_uv[glyph] = atlas.uv(m_region, x0, y0, x0 + float(outCellW), y0 + float(outCellH));
+        }
+        return true;
+    }
+
+    bool isValid() const { return m_region >= 0; }
+    uint32_t page() const { return m_page; }
+    uint32_t cellWidth() const { return m_cellWidth; }
+    uint32_t cellHeight() const { return m_cellHeight; }
+    uint32_t spread() const { return m_spread; }
+
+    // Glyphs with no coverage (space, control codes) aren't drawn
+    bool hasGlyph(uint8_t c) const { return m_hasGlyph[c]; }
+
+    // The glyph's cell plus its spread margin
+    const UVRect& glyphUV(uint8_t c) const { return m_uv[c]; }
+
+private:
+    int m_region = -1;
+    uint32_t m_page = 0;
+    uint32_t m_cellWidth = 0, m_cellHeight = 0;
+    uint32_t m_spread = 0;
+    bool m_hasGlyph[GRID * GRID] = {};
+    UVRect m_uv[GRID * GRID];
+};
+
+/**
+ * One text element's laid-out glyphs. set*() compare against what is
+ * already laid out and only redo the layout (and bump version()) on a real
+ * change, so a HUD counter set every frame to the same value costs a string
+ * compare. emit() stamps each glyph quad with the element id and version:
+ * QuadBatch only rewrites the vertex slots of text that changed.
+ *
+ * Monospaced, like the sprite sheets: each character advances charWidth,
+ * '\n' starts a new line charHeight down.
+ *
+ * Usage:
+ *   run.setText(text);                          // neuroshell_set_text_string
+ *   run.emit(batch, elementId, font, depth);    // every frame
+ */
+class TextRun {
+public:
+    struct Glyph {
+        float x, y, width, height;  // Pixels, spread margin included
+        uint8_t c;
+    };
+
+    bool setText(const char* text) {
+        const char* s = text ? text : "";
+        if (m_text == s) return false;
+        m_text = s;
+        m_dirty = true;
+        return true;
+    }
+
+    bool setLayout(float x, float y, float charWidth, float charHeight) {
+        if (x == m_x && y == m_y && charWidth == m_charWidth && charHeight == m_charHeight) return false;
+        m_x = x;
+        m_y = y;
+        m_charWidth = charWidth;
+        m_charHeight = charHeight;
+        m_dirty = true;
+        return true;
+    }
+
+    bool setColor(float r, float g, float b, float a) {
+        if (r == m_color[0] && g == m_color[1] && b == m_color[2] && a == m_color[3]) return false;
+        m_color[0] = r;
+        m_color[1] = g;
+        m_color[2] = b;
+        m_color[3] = a;
+        m_version++;
+        return true;
+    }
+
+    const std::string& text() const { return m_text; }
+    uint32_t version() const { return m_version; }
+
+    // Lays out again if anything changed since the last call
+    const std::vector<Glyph>& glyphs(const SdfFont& font) {
+        if (m_dirty || m_font != &font) layout(font);
+        return m_glyphs;
+    }
+
+    // This frame's glyph quads; returns how many
+    size_t emit(QuadBatch& batch, uint32_t elementId, const SdfFont& font, float depth) {
+        if (!font.isValid()) return 0;
+        const std::vector<Glyph>& list = glyphs(font);
+        // Half a screen pixel of edge, in alpha units of the field
+        float texelsPerPixel = m_charWidth > 0.0f ? float(font.cellWidth()) / m_charWidth : 1.0f;
+        float edge = std::min(0.5f, std::max(0.001f, 0.5f * texelsPerPixel / float(2 * font.spread())));
+        for (size_t i = 0; i < list.size(); i++) {
+            const Glyph& g = list[i];
+            batch.add(g.x, g.y, g.width, g.height, font.glyphUV(g.c), font.page(),
+                      m_color[0], m_color[1], m_color[2], m_color[3], depth,
+                      quadStamp(elementId, m_version, static_cast<uint32_t>(i)), edge);
+        }
+        return list.size();
+    }
+
+private:
+    void layout(const SdfFont& font) {
+        m_glyphs.clear();
+        m_font = &font;
+        m_dirty = false;
+        m_version++;
+        if (!font.isValid() || m_charWidth <= 0.0f || m_charHeight <= 0.0f) return;
+
+        float marginX = float(font.spread()) * m_charWidth / float(font.cellWidth());
+        float marginY = float(font.spread()) * m_charHeight / float(font.cellHeight());
+        float penX = m_x, penY = m_y;
+        for (char ch : m_text) {
+            uint8_t c = static_cast<uint8_t>(ch);
+            if (c == '\n') {
+                penX = m_x;
+                penY += m_charHeight;
+                continue;
+            }
+            if (font.hasGlyph(c)) {
+                Glyph g;
+                g.x = penX - marginX;
+                g.y = penY - marginY;
+                g.width = m_charWidth + 2.0f * marginX;
+                g.height = m_charHeight + 2.0f * marginY;
+                g.c = c;
+                m_glyphs.push_back(g);
+            }
+            penX += m_charWidth;
+        }
+    }
+
+    std::string m_text;
+    float m_x = 0.0f, m_y = 0.0f;
+    float m_charWidth = 0.0f, m_charHeight = 0.0f;
+    float m_color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const SdfFont* m_font = nullptr;
+    std::vector<Glyph> m_glyphs;
+    uint32_t m_version = 0;
+    bool m_dirty = true;
+};
+
+} // namespace neuroshell
+
+#endif // NEUROSHELL_TEXT_H
@@ -1,27 +1,25 @@
 #version 450
 
 // UI fragment shader
-// Supports textured and solid-color quads
+// Every quad samples the atlas page of its draw run: untextured quads
+// point at the atlas's white region, so solid and textured quads batch
+// together in one draw. Text glyphs hold a signed distance in alpha
+// (0.5 = outline) and stay sharp at any size.
 
 layout(location = 0) in vec2 fragUV;
 layout(location = 1) in vec4 fragColor;
+layout(location = 2) in float fragSdfEdge;
 
 layout(location = 0) out vec4 outColor;
 
-layout(binding = 1) uniform sampler2D uiTexture;
-
-layout(push_constant) uniform UIPushConstants {
-    int hasTexture;  // 0 = solid color, 1 = textured
-} pc;
+layout(binding = 1) uniform sampler2D uiAtlas;
 
 void main() {
-    if (pc.hasTexture == 1) {
-        // Sample texture and apply color tint
-        vec4 texColor = texture(uiTexture, fragUV);
-        outColor = texColor * fragColor;
+    vec4 texColor = texture(uiAtlas, fragUV);
+    if (fragSdfEdge > 0.0) {
+        float coverage = smoothstep(0.5 - fragSdfEdge, 0.5 + fragSdfEdge, texColor.a);
+        outColor = vec4(fragColor.rgb, fragColor.a * coverage);
     } else {
-        // Solid color
-        outColor = fragColor;
+        outColor = texColor * fragColor;
     }
 }
-
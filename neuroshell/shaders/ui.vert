@@ -6,13 +6,15 @@
 layout(location = 0) in vec2 inPosNDC;   // Position in NDC (-1 to 1)
 layout(location = 1) in vec2 inUV;       // Texture coordinates (0-1)
 layout(location = 2) in vec4 inColor;    // Color tint (RGBA)
+layout(location = 3) in float inSdfEdge; // Distance field text: edge half-width (0 = plain texture)
 
 layout(location = 0) out vec2 fragUV;
 layout(location = 1) out vec4 fragColor;
+layout(location = 2) out float fragSdfEdge;
 
 void main() {
     gl_Position = vec4(inPosNDC, 0.0, 1.0);
     fragUV = inUV;
     fragColor = inColor;
+    fragSdfEdge = inSdfEdge;
 }
-
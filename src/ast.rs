@@ -77,6 +77,16 @@ pub struct ComponentDef {
     pub is_cuda: bool,  // true if marked with @[cuda]
 }
 
+// Component access of one system function, from its query parameters:
+// components assigned through a query loop's entity are writes, the rest
+// reads (computed by the type checker, emitted for SystemScheduler)
+#[derive(Debug, Clone)]
+pub struct SystemAccessInfo {
+    pub function: String,
+    pub reads: Vec<String>,
+    pub writes: Vec<String>,
+}
+
 #[derive(Debug, Clone)]
 pub struct SystemDef {
     pub name: String,
@@ -176,7 +186,7 @@ pub enum Statement {
     Assign { target: Expression, value: Expression, location: SourceLocation },
     If { condition: Expression, then_block: Vec<Statement>, else_block: Option<Vec<Statement>>, location: SourceLocation },
     While { condition: Expression, body: Vec<Statement>, location: SourceLocation },
-    For { iterator: String, collection: Expression, body: Vec<Statement>, location: SourceLocation },
+    For { iterator: String, collection: Expression, body: Vec<Statement>, parallel: bool, location: SourceLocation },  // parallel: @[parallel] query loop
     Loop { body: Vec<Statement>, location: SourceLocation },
     Return(Option<Expression>, SourceLocation),
     Break(SourceLocation),
@@ -196,6 +206,7 @@ pub enum Expression {
     Call { name: String, args: Vec<Expression>, location: SourceLocation },
     MemberAccess { object: Box<Expression>, member: String, location: SourceLocation },
     Index { array: Box<Expression>, index: Box<Expression>, location: SourceLocation },
+    FrameAlloc { arena: Box<Expression>, element_type: Type, count: Box<Expression>, location: SourceLocation },  // frame.alloc_array<T>(count)
     ArrayLiteral { elements: Vec<Expression>, location: SourceLocation },
     StringInterpolation { parts: Vec<StringInterpolationPart>, location: SourceLocation },
     Match { expr: Box<Expression>, arms: Vec<MatchArm>, location: SourceLocation },
@@ -285,6 +296,7 @@ impl Expression {
             Expression::Call { location, .. } => *location,
             Expression::MemberAccess { location, .. } => *location,
             Expression::Index { location, .. } => *location,
+            Expression::FrameAlloc { location, .. } => *location,
             Expression::ArrayLiteral { location, .. } => *location,
             Expression::StringInterpolation { location, .. } => *location,
             Expression::Match { location, .. } => *location,
@@ -1,6 +1,6 @@
 use crate::ast::*;
 use anyhow::Result;
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 
 pub struct CodeGenerator {
     components: HashMap<String, ComponentDef>,  // Store component metadata for SOA detection
@@ -13,6 +13,16 @@ pub struct CodeGenerator {
     cuda_functions: Vec<FunctionDef>,  // Store functions with @[launch] attribute
     cuda_components: Vec<ComponentDef>,  // Store components with @[cuda] attribute
     defer_counter: usize,  // Counter for generating unique defer variable names
+    system_access: Vec<SystemAccessInfo>,  // From the type checker, for SystemScheduler
+    soa_hoisted: Option<(String, Vec<(String, String)>)>,  // Query loop being generated: its iterator, and the SoA columns (plural, field) it touches
+    uses_frame_arena: bool,  // Program allocates from FrameArena (frame.alloc_array, frame_arena(), ECS render arrays)
+    in_main: bool,  // Generating HEIDIC main (its outermost loop is the frame loop)
+    loop_depth: usize,  // Nesting of while/loop statements being generated
+    cuda_launch_columns: HashMap<String, Vec<(String, String, String)>>,  // @[launch] function -> (query, plural, field) of each column its kernel takes
+    in_cuda_kernel: bool,  // Generating a kernel body (no host-side mirror bookkeeping)
+    profile_systems: bool,  // `compile --profile`: time system/hot/@[launch] calls with SystemProfiler
+    profiled_functions: HashSet<String>,  // Calls that get a timer when profiling
+    profiling_call: bool,  // Generating the call inside an EDEN_PROFILE_CALL
 }
 
 impl CodeGenerator {
@@ -28,9 +38,23 @@ impl CodeGenerator {
             cuda_functions: Vec::new(),
             cuda_components: Vec::new(),
             defer_counter: 0,
+            system_access: Vec::new(),
+            soa_hoisted: None,
+            uses_frame_arena: false,
+            in_main: false,
+            loop_depth: 0,
+            cuda_launch_columns: HashMap::new(),
+            in_cuda_kernel: false,
+            profile_systems: false,
+            profiled_functions: HashSet::new(),
+            profiling_call: false,
         }
     }
     
+    pub fn set_profile_systems(&mut self, enabled: bool) {
+        self.profile_systems = enabled;
+    }
+    
     pub fn generate(&mut self, program: &Program) -> Result<String> {
         let mut output = String::new();
         
@@ -49,6 +73,7 @@ impl CodeGenerator {
                 if s.is_hot {
                     self.hot_systems.push(s.clone());
                 }
+                self.profiled_functions.extend(s.functions.iter().map(|f| f.name.clone()));
             }
             if let Item::Shader(sh) = item {
                 if sh.is_hot {
@@ -62,9 +87,19 @@ impl CodeGenerator {
                 if f.cuda_kernel.is_some() {
                     self.cuda_functions.push(f.clone());
                 }
+                // Functions taking a query are systems too
+                if f.cuda_kernel.is_some() || f.params.iter().any(|p| matches!(p.ty, Type::Query(_))) {
+                    self.profiled_functions.insert(f.name.clone());
+                }
             }
         }
         
+        // Before any include, so stdlib/system_scheduler.h times its systems as well;
+        // this translation unit also hooks operator new for per-zone allocation counts
+        if self.profile_systems {
+            output.push_str("#define EDEN_PROFILE_SYSTEMS 1\n");
+            output.push_str("#define EDEN_PROFILE_ALLOCATIONS 1\n");
+        }
         // Generate includes and standard library (AFTER collecting hot items so we know what to include)
         output.push_str("#include <iostream>\n");
         output.push_str("#include <vector>\n");
@@ -89,6 +124,29 @@ impl CodeGenerator {
         // Include entity storage if we have hot components
         if !self.hot_components.is_empty() {
             output.push_str("#include \"stdlib/entity_storage.h\"\n");
+            // The ECS physics block steps at a fixed rate and interpolates for render
+            output.push_str("#include \"stdlib/fixed_timestep.h\"\n");
+        }
+        // Include SoA columns if any SOA component is stored in them
+        if self.components.values().any(|c| Self::uses_soa_columns(c)) {
+            output.push_str("#include \"stdlib/soa_storage.h\"\n");
+        }
+        // Device mirrors of @[cuda] components for @[launch] kernels
+        if !self.cuda_components.is_empty() || !self.cuda_functions.is_empty() {
+            output.push_str("#include \"stdlib/cuda_mirror.h\"\n");
+        }
+        // Per-system timers (compile --profile)
+        if self.profile_systems {
+            output.push_str("#include \"stdlib/system_profiler.h\"\n");
+        }
+        // Include the job system if any query loop is @[parallel]
+        if Self::program_has_parallel_loops(program) {
+            output.push_str("#include \"stdlib/job_system.h\"\n");
+        }
+        // Per-frame allocations (and the ECS render arrays) come from FrameArena
+        self.uses_frame_arena = !self.hot_components.is_empty() || Self::program_uses_frame_arena(program);
+        if self.uses_frame_arena {
+            output.push_str("#include \"stdlib/frame_arena.h\"\n");
         }
         output.push_str("\n");
         
@@ -124,11 +182,20 @@ impl CodeGenerator {
             }
         }
         
+        if !self.cuda_components.is_empty() || !self.cuda_functions.is_empty() {
+            output.push_str(&self.generate_cuda_mirrors());
+        }
+        
         // Generate ComponentRegistry if we have any components
         if !self.components.is_empty() {
             output.push_str(&self.generate_component_registry());
         }
         
+        // Component access of query systems, for the system scheduler
+        if !self.system_access.is_empty() {
+            output.push_str(&self.generate_system_access());
+        }
+        
         // Generate resources (need to include resource.h header)
         // Check if we have any resources (for includes) and @hot resources (for hot-reload)
         // Also collect Image resources for bindless integration
@@ -155,6 +222,9 @@ impl CodeGenerator {
             output.push_str("#include \"stdlib/mesh_resource.h\"\n");
             output.push_str("#include \"stdlib/audio_resource.h\"\n");
             output.push_str("#include \"stdlib/video_resource.h\"\n");
+            if !self.image_resources.is_empty() {
+                output.push_str("#include \"vulkan/core/bindless_heap.h\"\n");
+            }
             output.push_str("\n");
         }
         
@@ -455,6 +525,12 @@ impl CodeGenerator {
                         has_main = true;
                     }
                     functions.push(f.clone());
+                    if f.cuda_kernel.is_some() {
+                        // Calls to a @[launch] function launch its kernel
+                        output.push_str(&format!("void {}_launch({});\n", f.name, self.cuda_launch_params(f)));
+                        output.push_str(&format!("void {}_wait();\n", f.name));
+                        continue;
+                    }
                     // Generate forward declaration
                     let func_name = if f.name == "main" {
                         "heidic_main".to_string()
@@ -523,8 +599,9 @@ impl CodeGenerator {
         // Generate forward declarations for hot-reload functions if we have hot systems
         if !self.hot_systems.is_empty() {
             output.push_str("// Hot-reload function forward declarations\n");
+            output.push_str("#include \"stdlib/file_watcher.h\"\n");
             output.push_str("void check_and_reload_hot_system();\n");
-            output.push_str("void load_hot_system(const char* dll_path);\n");
+            output.push_str("void load_hot_system();\n");
             output.push_str("void unload_hot_system();\n");
             output.push_str("\n");
         }
@@ -532,6 +609,7 @@ impl CodeGenerator {
         // Generate forward declarations for shader hot-reload functions if we have hot shaders
         if !self.hot_shaders.is_empty() {
             output.push_str("// Shader hot-reload function forward declarations\n");
+            output.push_str("#include \"stdlib/file_watcher.h\"\n");
             output.push_str("void check_and_reload_hot_shaders();\n");
             output.push_str("extern \"C\" void heidic_reload_shader(const char* shader_path);\n");
             output.push_str("\n");
@@ -557,6 +635,10 @@ impl CodeGenerator {
             output.push_str("static std::vector<EntityId> g_entities;\n");
             output.push_str("static constexpr float BOUNDS = 3.0f;\n");
             output.push_str("static auto g_last_update_time = std::chrono::high_resolution_clock::now();\n");
+            output.push_str("static FixedTimestep g_sim_clock(60.0);  // Physics rate; max 5 steps a frame\n");
+            if self.hot_components.iter().any(|c| c.name == "Position") {
+                output.push_str("static InterpolatedStates<Position> g_prev_positions;  // Before the last step, for render\n");
+            }
             output.push_str("\n");
         }
         
@@ -584,15 +666,17 @@ impl CodeGenerator {
             for f in &self.cuda_functions {
                 output.push_str(&self.generate_cuda_launch_wrapper(f));
             }
+            output.push_str("void cuda_wait_all() {\n");
+            for f in &self.cuda_functions {
+                output.push_str(&format!("    {}_wait();\n", f.name));
+            }
+            output.push_str("}\n\n");
         }
         
         // Generate hot-reload runtime integration
         if !self.hot_systems.is_empty() {
             output.push_str("\n// Hot-Reload Runtime Integration\n");
-            output.push_str("#include <windows.h>\n");
-            output.push_str("#include <string>\n");
-            output.push_str("#include <thread>\n");
-            output.push_str("#include <chrono>\n");
+            output.push_str("#include \"stdlib/hot_module.h\"\n");
             output.push_str("\n");
             
             // Generate function pointer variables
@@ -603,79 +687,39 @@ impl CodeGenerator {
             }
             
             output.push_str("\n");
-            output.push_str("// Hot-reload helper functions\n");
-            output.push_str("HMODULE g_hot_dll = nullptr;\n");
+            output.push_str("// One shared library per hot system (.dll / .so / .dylib)\n");
+            for system in &self.hot_systems {
+                output.push_str(&format!("static HotModule g_hot_module_{}(\"{}\" EDEN_HOT_MODULE_EXT);\n",
+                    system.name.to_lowercase(), system.name.to_lowercase()));
+            }
             output.push_str("\n");
-            output.push_str("void load_hot_system(const char* dll_path) {\n");
-            output.push_str("    // Unload old DLL if loaded\n");
-            output.push_str("    if (g_hot_dll) {\n");
-            output.push_str("        FreeLibrary(g_hot_dll);\n");
-            output.push_str("        g_hot_dll = nullptr;\n");
-            output.push_str("    }\n");
-            output.push_str("    \n");
-            output.push_str("    // Load new DLL\n");
-            output.push_str("    g_hot_dll = LoadLibraryA(dll_path);\n");
-            output.push_str("    if (!g_hot_dll) {\n");
-            output.push_str("        std::cerr << \"Failed to load hot-reload DLL: \" << dll_path << std::endl;\n");
-            output.push_str("        return;\n");
-            output.push_str("    }\n");
-            output.push_str("    \n");
-            output.push_str("    // Load function pointers\n");
+            output.push_str("void load_hot_system() {\n");
             for system in &self.hot_systems {
+                let module = format!("g_hot_module_{}", system.name.to_lowercase());
                 for func in &system.functions {
-                    output.push_str(&format!("    g_{} = ({}_ptr)GetProcAddress(g_hot_dll, \"{}\");\n", 
-                        func.name, func.name, func.name));
-                    output.push_str(&format!("    if (!g_{}) {{\n", func.name));
-                    output.push_str(&format!("        std::cerr << \"Failed to load function: {}\" << std::endl;\n", func.name));
-                    output.push_str("    }\n");
+                    output.push_str(&format!("    {}.bind(\"{}\", &g_{});\n", module, func.name, func.name));
                 }
+                output.push_str(&format!("    {}.load();\n", module));
             }
             output.push_str("}\n");
             output.push_str("\n");
             output.push_str("void unload_hot_system() {\n");
-            output.push_str("    if (g_hot_dll) {\n");
-            output.push_str("        FreeLibrary(g_hot_dll);\n");
-            output.push_str("        g_hot_dll = nullptr;\n");
             for system in &self.hot_systems {
-                for func in &system.functions {
-                    output.push_str(&format!("        g_{} = nullptr;\n", func.name));
-                }
+                output.push_str(&format!("    g_hot_module_{}.unload();\n", system.name.to_lowercase()));
             }
-            output.push_str("    }\n");
             output.push_str("}\n");
             output.push_str("\n");
-            output.push_str("// File watching and auto-reload\n");
-            output.push_str("#include <sys/stat.h>\n");
-            output.push_str("#include <io.h>\n");
-            output.push_str("#include <chrono>\n");
-            output.push_str("\n");
-            output.push_str("static time_t g_last_dll_time = 0;\n");
-            output.push_str("static std::chrono::steady_clock::time_point g_startup_time = std::chrono::steady_clock::now();\n");
-            output.push_str("static const int STARTUP_GRACE_PERIOD_SECONDS = 3; // Ignore DLL changes for first 3 seconds after startup\n");
-            output.push_str("\n");
+            output.push_str("// Called at the top of each frame: kicks off background loads of new builds\n");
+            output.push_str("// and installs the ones that finished (never blocks the render thread)\n");
             output.push_str("void check_and_reload_hot_system() {\n");
-            output.push_str("    // Ignore DLL changes during startup grace period (to avoid reloading immediately after build)\n");
-            output.push_str("    auto now = std::chrono::steady_clock::now();\n");
-            output.push_str("    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - g_startup_time).count();\n");
-            output.push_str("    if (elapsed < STARTUP_GRACE_PERIOD_SECONDS) {\n");
-            output.push_str("        return; // Still in startup grace period\n");
-            output.push_str("    }\n");
-            for system in &self.hot_systems {
-                let dll_name = format!("{}.dll", system.name.to_lowercase());
-                output.push_str(&format!("    // Check {} DLL file modification time\n", system.name));
-                output.push_str(&format!("    struct stat dll_stat;\n"));
-                output.push_str(&format!("    if (stat(\"{}\", &dll_stat) == 0) {{\n", dll_name));
-                output.push_str(&format!("        if (dll_stat.st_mtime > g_last_dll_time) {{\n"));
-                output.push_str(&format!("            g_last_dll_time = dll_stat.st_mtime;\n"));
-                output.push_str(&format!("            std::cout << \"[Hot-Reload] Detected change in {}, reloading...\" << std::endl;\n", dll_name));
-                output.push_str(&format!("            // Unload old DLL first\n"));
-                output.push_str(&format!("            unload_hot_system();\n"));
-                output.push_str(&format!("            // Small delay to ensure DLL is fully unloaded on Windows\n"));
-                output.push_str(&format!("            std::this_thread::sleep_for(std::chrono::milliseconds(100));\n"));
-                output.push_str(&format!("            load_hot_system(\"{}\");\n", dll_name));
-                output.push_str(&format!("            std::cout << \"[Hot-Reload] {} reloaded successfully!\" << std::endl;\n", system.name));
-                output.push_str(&format!("        }}\n"));
-                output.push_str(&format!("    }}\n"));
+            for (idx, system) in self.hot_systems.iter().enumerate() {
+                let module = format!("g_hot_module_{}", system.name.to_lowercase());
+                output.push_str(&format!("    // {}: stat the library only after the watcher saw a change\n", system.name));
+                output.push_str(&format!("    static const int dll_watch_{} = FileWatcher::shared().watch({}.path());\n", idx, module));
+                output.push_str(&format!("    if (FileWatcher::shared().consume(dll_watch_{}) && {}.reload()) {{\n", idx, module));
+                output.push_str(&format!("        std::cout << \"[Hot-Reload] Detected change in \" << {}.path() << \", loading in the background...\" << std::endl;\n", module));
+                output.push_str("    }\n");
+                output.push_str(&format!("    {}.swap();\n", module));
             }
             output.push_str("}\n");
             output.push_str("\n");
@@ -685,7 +729,7 @@ impl CodeGenerator {
         if !self.hot_shaders.is_empty() {
             output.push_str("\n// Shader Hot-Reload Runtime Integration\n");
             output.push_str("#include <sys/stat.h>\n");
-            output.push_str("#include <io.h>\n");
+            output.push_str("#ifdef _WIN32\n#include <io.h>\n#endif\n");
             output.push_str("#include <map>\n");
             output.push_str("#include <string>\n");
             output.push_str("\n");
@@ -694,31 +738,25 @@ impl CodeGenerator {
             output.push_str("\n");
             output.push_str("void check_and_reload_hot_shaders() {\n");
             for (idx, shader) in self.hot_shaders.iter().enumerate() {
-                // Get the shader file path (could be .glsl or .spv)
+                // Watch the shader source itself: heidic_reload_shader compiles it
+                // (cached by content) in the background, so saving the GLSL is enough
                 let shader_path = &shader.path;
-                // Determine the .spv path - keep extension to avoid conflicts (e.g., my_shader.vert.spv)
-                let spv_path = if shader_path.ends_with(".glsl") {
-                    shader_path.replace(".glsl", ".spv")
-                } else if shader_path.ends_with(".vert") || shader_path.ends_with(".frag") || shader_path.ends_with(".comp") {
-                    format!("{}.spv", shader_path)  // my_shader.vert.spv, my_shader.frag.spv
-                } else {
-                    format!("{}.spv", shader_path)
-                };
+                let watch_path = shader_path;
                 
                 // Use unique variable name for each shader
                 let stat_var_name = format!("shader_stat_{}", idx);
                 
-                output.push_str(&format!("    // Check {} shader file modification time\n", shader_path));
+                output.push_str(&format!("    // Check {} shader file modification time (only after the watcher saw a change)\n", shader_path));
+                output.push_str(&format!("    static const int shader_watch_{} = FileWatcher::shared().watch(\"{}\");\n", idx, watch_path));
                 output.push_str(&format!("    struct stat {};\n", stat_var_name));
-                output.push_str(&format!("    if (stat(\"{}\", &{}) == 0) {{\n", spv_path, stat_var_name));
-                output.push_str(&format!("        auto it = g_shader_mtimes.find(\"{}\");\n", spv_path));
+                output.push_str(&format!("    if (FileWatcher::shared().consume(shader_watch_{}) && stat(\"{}\", &{}) == 0) {{\n", idx, watch_path, stat_var_name));
+                output.push_str(&format!("        auto it = g_shader_mtimes.find(\"{}\");\n", watch_path));
                 output.push_str(&format!("        time_t last_mtime = (it != g_shader_mtimes.end()) ? it->second : 0;\n"));
                 output.push_str(&format!("        if ({}.st_mtime > last_mtime) {{\n", stat_var_name));
-                output.push_str(&format!("            g_shader_mtimes[\"{}\"] = {}.st_mtime;\n", spv_path, stat_var_name));
-                output.push_str(&format!("            std::cout << \"[Shader Hot-Reload] Detected change in {}, reloading...\" << std::endl;\n", spv_path));
+                output.push_str(&format!("            g_shader_mtimes[\"{}\"] = {}.st_mtime;\n", watch_path, stat_var_name));
+                output.push_str(&format!("            std::cout << \"[Shader Hot-Reload] Detected change in {}, reloading...\" << std::endl;\n", watch_path));
                 // Pass the original source path so we can determine shader stage (vertex/fragment)
                 output.push_str(&format!("            heidic_reload_shader(\"{}\");\n", shader_path));
-                output.push_str(&format!("            std::cout << \"[Shader Hot-Reload] {} reloaded successfully!\" << std::endl;\n", spv_path));
                 output.push_str(&format!("        }}\n"));
                 output.push_str(&format!("    }}\n"));
             }
@@ -727,20 +765,13 @@ impl CodeGenerator {
             // Initialize shader modification times at startup
             output.push_str("static void init_shader_mtimes() {\n");
             for (idx, shader) in self.hot_shaders.iter().enumerate() {
-                let shader_path = &shader.path;
-                // Use same naming as check_and_reload_hot_shaders: keep extension for .vert/.frag/.comp
-                let spv_path = if shader_path.ends_with(".glsl") {
-                    shader_path.replace(".glsl", ".spv")
-                } else if shader_path.ends_with(".vert") || shader_path.ends_with(".frag") || shader_path.ends_with(".comp") {
-                    format!("{}.spv", shader_path)  // my_shader.vert.spv, my_shader.frag.spv
-                } else {
-                    format!("{}.spv", shader_path)
-                };
+                // Same file check_and_reload_hot_shaders watches: the source
+                let watch_path = &shader.path;
                 // Use unique variable name for each shader
                 let stat_var_name = format!("shader_stat_init_{}", idx);
                 output.push_str(&format!("    struct stat {};\n", stat_var_name));
-                output.push_str(&format!("    if (stat(\"{}\", &{}) == 0) {{\n", spv_path, stat_var_name));
-                output.push_str(&format!("        g_shader_mtimes[\"{}\"] = {}.st_mtime;\n", spv_path, stat_var_name));
+                output.push_str(&format!("    if (stat(\"{}\", &{}) == 0) {{\n", watch_path, stat_var_name));
+                output.push_str(&format!("        g_shader_mtimes[\"{}\"] = {}.st_mtime;\n", watch_path, stat_var_name));
                 output.push_str(&format!("    }}\n"));
             }
             output.push_str("}\n");
@@ -751,6 +782,12 @@ impl CodeGenerator {
         if self.has_resources {
             output.push_str("\n// Resource Hot-Reload Runtime Integration (CONTINUUM)\n");
             output.push_str("void check_and_reload_resources() {\n");
+            output.push_str("    // Finish async loads decoded by the worker pool (one upload batch)\n");
+            output.push_str("    vkcore::UploadBatch::shared().begin();\n");
+            output.push_str("    ResourceLoader::shared().pump();\n");
+            output.push_str("    vkcore::UploadBatch::shared().end();\n");
+            output.push_str("    // Destroy data replaced by reloads (or released) once its frames are done\n");
+            output.push_str("    ResourceCache::shared().collect();\n");
             for item in &program.items {
                 if let Item::Resource(res) = item {
                     let global_name = format!("g_resource_{}", res.name.to_lowercase());
@@ -768,7 +805,7 @@ impl CodeGenerator {
         if !self.hot_components.is_empty() {
             output.push_str("\n// Component Hot-Reload Runtime Integration\n");
             output.push_str("#include <sys/stat.h>\n");
-            output.push_str("#include <io.h>\n");
+            output.push_str("#ifdef _WIN32\n#include <io.h>\n#endif\n");
             output.push_str("#include <map>\n");
             output.push_str("#include <string>\n");
             output.push_str("#include <cstring>\n");
@@ -798,7 +835,7 @@ impl CodeGenerator {
                 for field in &component.fields {
                     field_sig.push_str(&field.name);
                     field_sig.push(':');
-                    field_sig.push_str(&self.type_to_cpp(&field.ty));
+                    field_sig.push_str(&self.component_field_to_cpp(component, &field.ty));
                     field_sig.push(';');
                 }
                 
@@ -927,16 +964,7 @@ impl CodeGenerator {
             output.push_str("int main(int argc, char* argv[]) {\n");
             // Load hot-reloadable systems at startup
             if !self.hot_systems.is_empty() {
-                for system in &self.hot_systems {
-                    let dll_name = format!("{}.dll", system.name.to_lowercase());
-                    let dll_cpp_name = format!("{}_hot.dll.cpp", system.name.to_lowercase());
-                    output.push_str(&format!("    // Initialize file watching\n"));
-                    output.push_str(&format!("    struct stat dll_stat;\n"));
-                    output.push_str(&format!("    if (stat(\"{}\", &dll_stat) == 0) {{\n", dll_cpp_name));
-                    output.push_str(&format!("        g_last_dll_time = dll_stat.st_mtime;\n"));
-                    output.push_str(&format!("    }}\n"));
-                    output.push_str(&format!("    load_hot_system(\"{}\");\n", dll_name));
-                }
+                output.push_str("    load_hot_system();\n");
             }
             // Initialize shader modification times at startup
             if !self.hot_shaders.is_empty() {
@@ -962,7 +990,15 @@ impl CodeGenerator {
                     output.push_str(&format!("    create_pipeline_{}();\n", pipeline_name_lower));
                 }
             }
+            if self.profile_systems {
+                output.push_str("    SystemProfiler::start_trace_from_env();\n");
+            }
             output.push_str("    heidic_main();\n");
+            if self.profile_systems {
+                output.push_str("    SystemProfiler::end_frame();\n");
+                output.push_str("    SystemProfiler::print(std::cout);\n");
+                output.push_str("    SystemProfiler::stop_trace();\n");
+            }
             // Only unload hot system if we have hot systems
             if !self.hot_systems.is_empty() {
                 output.push_str("    unload_hot_system();\n");
@@ -977,6 +1013,8 @@ impl CodeGenerator {
     // Generate DLL source file for a hot system
     pub fn generate_hot_system_dll(&mut self, system: &SystemDef) -> String {
         let mut output = String::new();
+        // The DLL has no profiler; its calls are timed from the host side
+        let profile_systems = std::mem::replace(&mut self.profile_systems, false);
         
         output.push_str("// Hot-reloadable system DLL\n");
         output.push_str("// Auto-generated from @hot system\n");
@@ -1026,10 +1064,20 @@ impl CodeGenerator {
             output.push_str("\n");
         }
         
+        self.profile_systems = profile_systems;
         output
     }
     
     // Get list of hot systems (for generating DLL files)
+    pub fn set_system_access(&mut self, access: Vec<SystemAccessInfo>) {
+        self.system_access = access;
+    }
+    
+    // Uses @[cuda]/@[launch]: the output has to be compiled as CUDA
+    pub fn uses_cuda(&self) -> bool {
+        !self.cuda_components.is_empty() || !self.cuda_functions.is_empty()
+    }
+    
     pub fn get_hot_systems(&self) -> &Vec<SystemDef> {
         &self.hot_systems
     }
@@ -1052,54 +1100,35 @@ impl CodeGenerator {
             return;
         }
         
-        // Parse old field signature to determine which fields existed in old version
-        output.push_str(&format!("    // Parse old field signature to determine which fields existed in old version\n"));
-        output.push_str(&format!("    std::string old_sig = g_prev_metadata_{}.field_signature;\n", comp_name_lower));
-        
-        // Generate field existence checks for each field
-        // Field signature format: "field_name:type;"
-        for field in &component.fields {
-            let type_name = self.type_to_cpp(&field.ty);
-            output.push_str(&format!("    bool has_{}_in_old = old_sig.find(\"{}:{}\") != std::string::npos;\n", 
-                field.name, field.name, type_name));
+        // Which fields the old layout had, decided once from the reflection
+        // table (an exact "name:type" match, not a substring search)
+        output.push_str("    // Which fields existed in the old version, from the reflection table\n");
+        output.push_str(&format!("    std::vector<bool> kept = fields_in_signature<{}>(g_prev_metadata_{}.field_signature);\n",
+            component.name, comp_name_lower));
+        let mut all_kept = Vec::new();
+        for (i, field) in component.fields.iter().enumerate() {
+            output.push_str(&format!("    bool has_{}_in_old = kept[{}];\n", field.name, i));
+            all_kept.push(format!("has_{}_in_old", field.name));
         }
+        output.push_str(&format!("    if ({}) {{\n", all_kept.join(" && ")));
+        output.push_str(&format!("        std::cout << \"[Component Migration] No new fields in {}, nothing to rewrite\" << std::endl;\n", component.name));
+        output.push_str("        return;\n");
+        output.push_str("    }\n");
         output.push_str("\n");
         
-        // Collect all entities with this component first (to avoid iterator invalidation)
-        output.push_str(&format!("    // Collect all entities with {} component (to avoid iterator invalidation during migration)\n", component.name));
-        output.push_str("    std::vector<EntityId> entities_to_migrate;\n");
-        output.push_str(&format!("    g_storage.for_each<{}>([&](EntityId e, {}&) {{\n", component.name, component.name));
-        output.push_str("        entities_to_migrate.push_back(e);\n");
-        output.push_str(&format!("    }});\n"));
-        output.push_str("\n");
-        output.push_str("    // Migrate each entity\n");
-        output.push_str("    int migrated_count = 0;\n");
-        output.push_str("    for (EntityId e : entities_to_migrate) {\n");
-        output.push_str(&format!("        {}* old_comp_ptr = g_storage.get_component<{}>(e);\n", component.name, component.name));
-        output.push_str("        if (!old_comp_ptr) continue;  // Entity no longer has component\n");
-        output.push_str(&format!("        {} old_comp = *old_comp_ptr;  // Copy old data before removing\n", component.name));
-        output.push_str("\n");
-        output.push_str(&format!("        // Create new component instance, zero-initialized\n"));
-        output.push_str(&format!("        {} new_comp{{}};\n", component.name));
-        output.push_str("\n");
-        
-        // Copy fields that existed in old version, use defaults for new fields
-        output.push_str("        // Copy fields that existed in old version\n");
+        // Rewrite the dense array in place: fields that existed keep their
+        // values, new ones get defaults. No remove/add, so entity order and
+        // the sparse sets are untouched.
+        output.push_str(&format!("    // One pass over the {} array, in place (entity order unchanged)\n", component.name));
+        output.push_str("    size_t migrated_count = 0;\n");
+        output.push_str(&format!("    g_storage.for_each<{}>([&](EntityId, {}& comp) {{\n", component.name, component.name));
         for field in &component.fields {
             let default_val = self.get_default_value_for_type(&field.ty);
-            output.push_str(&format!("        if (has_{}_in_old) {{\n", field.name));
-            output.push_str(&format!("            new_comp.{} = old_comp.{};  // Copy existing field\n", field.name, field.name));
-            output.push_str(&format!("        }} else {{\n"));
-            output.push_str(&format!("            new_comp.{} = {};  // New field, use default\n", field.name, default_val));
-            output.push_str(&format!("        }}\n"));
+            output.push_str(&format!("        if (!has_{}_in_old) comp.{} = {};  // New field, use default\n",
+                field.name, field.name, default_val));
         }
-        
-        output.push_str("\n");
-        output.push_str("        // Replace old component with new one\n");
-        output.push_str(&format!("        g_storage.remove_component<{}>(e);\n", component.name));
-        output.push_str(&format!("        g_storage.add_component<{}>(e, new_comp);\n", component.name));
         output.push_str("        migrated_count++;\n");
-        output.push_str("    }\n");
+        output.push_str("    });\n");
         
         output.push_str("\n");
         output.push_str(&format!("    std::cout << \"[Component Migration] Migrated \" << migrated_count << \" {} entities\" << std::endl;\n", 
@@ -1141,13 +1170,30 @@ impl CodeGenerator {
         for field in &c.fields {
             output.push_str(&format!("{}    {} {};\n", 
                 self.indent(indent + 1), 
-                self.type_to_cpp(&field.ty), 
+                self.component_field_to_cpp(c, &field.ty), 
                 field.name));
         }
         output.push_str("};\n\n");
         output
     }
     
+    // SOA components whose elements are plain data get aligned, padded
+    // columns (stdlib/soa_storage.h); anything else stays std::vector
+    fn component_field_to_cpp(&self, c: &ComponentDef, ty: &Type) -> String {
+        if Self::uses_soa_columns(c) {
+            if let Type::Array(element_type) = ty {
+                return format!("SoAColumn<{}>", self.type_to_cpp(element_type));
+            }
+        }
+        self.type_to_cpp(ty)
+    }
+    
+    fn uses_soa_columns(c: &ComponentDef) -> bool {
+        c.is_soa && !c.fields.is_empty() && c.fields.iter().all(|field| matches!(&field.ty, Type::Array(element_type)
+            if matches!(element_type.as_ref(), Type::I32 | Type::I64 | Type::F32 | Type::F64 | Type::Bool
+                | Type::Vec2 | Type::Vec3 | Type::Vec4 | Type::Mat4)))
+    }
+    
     fn generate_component_registry(&self) -> String {
         let mut output = String::new();
         
@@ -1156,33 +1202,73 @@ impl CodeGenerator {
         output.push_str("#include \"stdlib/component_registry.h\"\n");
         output.push_str("\n");
         
+        // Dense component indices in name order, so they don't depend on
+        // HashMap iteration order and are stable between builds
+        let mut comp_names: Vec<&String> = self.components.keys().collect();
+        comp_names.sort();
+        output.push_str(&format!("static_assert({} <= MAX_GENERATED_COMPONENTS, \"too many components for ComponentIndex\");\n\n", comp_names.len()));
+        
         // Generate component metadata and reflection data for each component
-        for (_comp_name, component) in &self.components {
-            output.push_str(&self.generate_component_metadata(component));
+        for (index, comp_name) in comp_names.iter().enumerate() {
+            output.push_str(&self.generate_component_metadata(&self.components[*comp_name], index));
+        }
+        
+        // One flat constexpr table, entry i for ComponentIndex i
+        output.push_str("// Component Registry: every component's metadata and fields, by index\n");
+        output.push_str("inline constexpr ComponentInfo GENERATED_COMPONENT_INFO[] = {\n");
+        for comp_name in &comp_names {
+            output.push_str(&format!("    component_info<{}>(),\n", comp_name));
         }
+        output.push_str("};\n\n");
         
         // Generate registration function
         output.push_str("// Component Registry Initialization\n");
         output.push_str("void register_all_components() {\n");
-        for (comp_name, _) in &self.components {
-            output.push_str(&format!("    ComponentRegistry::register_component<{}>();\n", comp_name));
-        }
+        output.push_str(&format!("    ComponentRegistry::set_generated(GENERATED_COMPONENT_INFO, {});\n", comp_names.len()));
         output.push_str("}\n\n");
         
         output
     }
     
-    fn generate_component_metadata(&self, component: &ComponentDef) -> String {
+    fn generate_system_access(&self) -> String {
+        let mut output = String::new();
+        output.push_str("// System Access (component reads/writes for SystemScheduler)\n");
+        output.push_str("#include \"stdlib/system_scheduler.h\"\n");
+        output.push_str("\n");
+        for access in &self.system_access {
+            output.push_str(&format!("// {}: reads [{}], writes [{}]\n",
+                access.function, access.reads.join(", "), access.writes.join(", ")));
+            output.push_str(&format!("inline SystemAccess system_access_{}() {{\n", access.function));
+            output.push_str("    return SystemAccess()");
+            for name in &access.reads {
+                output.push_str(&format!(".read<{}>(\"{}\")", name, name));
+            }
+            for name in &access.writes {
+                output.push_str(&format!(".write<{}>(\"{}\")", name, name));
+            }
+            output.push_str(";\n}\n\n");
+        }
+        output
+    }
+    
+    fn generate_component_metadata(&self, component: &ComponentDef, index: usize) -> String {
         let mut output = String::new();
         let comp_name = &component.name;
         let _comp_name_lower = comp_name.to_lowercase();
         
+        // Generate dense component index (flat storage arrays in EntityStorage)
+        output.push_str(&format!("// Component Index: {}\n", comp_name));
+        output.push_str(&format!("template<>\n"));
+        output.push_str(&format!("struct ComponentIndex<{}> {{\n", comp_name));
+        output.push_str(&format!("    static constexpr uint32_t value = {};\n", index));
+        output.push_str("};\n\n");
+        
         // Generate component metadata struct
         output.push_str(&format!("// Component Metadata: {}\n", comp_name));
         output.push_str(&format!("template<>\n"));
         output.push_str(&format!("struct ComponentMetadata<{}> {{\n", comp_name));
         output.push_str(&format!("    static constexpr const char* name() {{ return \"{}\"; }}\n", comp_name));
-        output.push_str(&format!("    static constexpr uint32_t id() {{ return component_id<{}>(); }}\n", comp_name));
+        output.push_str(&format!("    static constexpr uint32_t id() {{ return ComponentIndex<{}>::value; }}\n", comp_name));
         output.push_str(&format!("    static constexpr size_t size() {{ return sizeof({}); }}\n", comp_name));
         output.push_str(&format!("    static constexpr size_t alignment() {{ return alignof({}); }}\n", comp_name));
         output.push_str(&format!("    static constexpr bool is_soa() {{ return {}; }}\n", if component.is_soa { "true" } else { "false" }));
@@ -1192,52 +1278,29 @@ impl CodeGenerator {
         output.push_str(&format!("// Field Reflection Data: {}\n", comp_name));
         output.push_str(&format!("template<>\n"));
         output.push_str(&format!("struct ComponentFields<{}> {{\n", comp_name));
+        output.push_str(&format!("    using FieldInfo = ComponentFieldInfo;\n"));
         output.push_str(&format!("    static constexpr size_t field_count = {};\n", component.fields.len()));
-        output.push_str("    struct FieldInfo {\n");
-        output.push_str("        const char* name;\n");
-        output.push_str("        const char* type_name;\n");
-        output.push_str("        size_t offset;\n");
-        output.push_str("        size_t size;\n");
-        output.push_str("    };\n");
-        output.push_str("    static FieldInfo get_fields() {\n");
-        output.push_str("        static FieldInfo fields[] = {\n");
+        if component.fields.is_empty() {
+            output.push_str("    static constexpr const FieldInfo* get_fields() { return nullptr; }\n");
+            output.push_str("};\n\n");
+            return output;
+        }
+        output.push_str("    static constexpr FieldInfo fields[] = {\n");
         
-        // Generate field info using offsetof() for accurate offsets
+        // offsetof/sizeof of the real members, so copies by offset are exact
         for field in &component.fields {
-            let field_type_size = self.estimate_type_size(&field.ty);
-            let field_type_name = self.type_to_cpp(&field.ty);
-            
-            output.push_str(&format!("            {{ \"{}\", \"{}\", offsetof({}, {}), {} }},\n",
-                field.name, field_type_name, comp_name, field.name, field_type_size));
+            let field_type_name = self.component_field_to_cpp(component, &field.ty);
+            output.push_str(&format!("        {{ \"{}\", \"{}\", offsetof({}, {}), sizeof({}::{}), std::is_trivially_copyable<decltype({}::{})>::value }},\n",
+                field.name, field_type_name, comp_name, field.name, comp_name, field.name, comp_name, field.name));
         }
         
-        output.push_str("        };\n");
-        output.push_str("        return fields;\n");
-        output.push_str("    }\n");
+        output.push_str("    };\n");
+        output.push_str("    static constexpr const FieldInfo* get_fields() { return fields; }\n");
         output.push_str("};\n\n");
         
         output
     }
     
-    fn estimate_type_size(&self, ty: &Type) -> usize {
-        match ty {
-            Type::I32 => 4,
-            Type::I64 => 8,
-            Type::F32 => 4,
-            Type::F64 => 8,
-            Type::Bool => 1,
-            Type::String => 32, // std::string size (approximate)
-            Type::Array(_) => 24, // std::vector size (approximate)
-            Type::Vec2 => 8,
-            Type::Vec3 => 12,
-            Type::Vec4 => 16,
-            Type::Mat4 => 64,
-            Type::Struct(_name) => 16, // Default struct size (would need actual struct lookup)
-            Type::Component(_name) => 16, // Default component size
-            _ => 8, // Default pointer size
-        }
-    }
-    
     fn generate_resource(&self, res: &ResourceDef) -> String {
         // Map resource type to C++ class name
         let cpp_resource_type = match res.resource_type.as_str() {
@@ -1281,119 +1344,47 @@ impl CodeGenerator {
     fn generate_bindless_infrastructure(&self) -> String {
         let mut output = String::new();
         
-        // Generate index constants for each image resource
-        output.push_str("// Bindless texture index constants\n");
-        for (index, res) in self.image_resources.iter().enumerate() {
+        // Texture slots in the runtime-owned heap (vkcore::BindlessHeap::shared),
+        // assigned when the images are registered
+        output.push_str("// Bindless texture indices (set by register_bindless_textures)\n");
+        for res in &self.image_resources {
             let const_name = format!("{}_TEXTURE_INDEX", res.name.to_uppercase());
-            output.push_str(&format!("constexpr uint32_t {} = {};\n", const_name, index));
+            output.push_str(&format!("static uint32_t {} = vkcore::BindlessHeap::INVALID_INDEX;\n", const_name));
         }
         output.push_str("\n");
         
-        // Generate global bindless descriptor set layout and descriptor set
-        output.push_str("// Global bindless descriptor set\n");
+        // The heap's layout and set, for pipeline layouts and vkCmdBindDescriptorSets
+        output.push_str("// Global bindless descriptor set (owned by vkcore::BindlessHeap::shared)\n");
         output.push_str("static VkDescriptorSetLayout g_bindless_descriptor_set_layout = VK_NULL_HANDLE;\n");
         output.push_str("static VkDescriptorSet g_bindless_descriptor_set = VK_NULL_HANDLE;\n");
-        output.push_str("static VkDescriptorPool g_bindless_descriptor_pool = VK_NULL_HANDLE;\n");
-        output.push_str("static constexpr uint32_t MAX_BINDLESS_TEXTURES = 1024;\n");
-        output.push_str("\n");
-        
-        // Generate function to create bindless descriptor set layout
-        output.push_str("void create_bindless_descriptor_set_layout() {\n");
-        output.push_str("    VkDescriptorSetLayoutBinding binding = {};\n");
-        output.push_str("    binding.binding = 0;\n");
-        output.push_str("    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;\n");
-        output.push_str("    binding.descriptorCount = MAX_BINDLESS_TEXTURES;\n");
-        output.push_str("    binding.stageFlags = VK_SHADER_STAGE_ALL;\n");
-        output.push_str("    binding.pImmutableSamplers = nullptr;\n");
-        output.push_str("\n");
-        output.push_str("    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlags = {};\n");
-        output.push_str("    bindingFlags.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;\n");
-        output.push_str("    bindingFlags.bindingCount = 1;\n");
-        output.push_str("    VkDescriptorBindingFlagsEXT flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;\n");
-        output.push_str("    bindingFlags.pBindingFlags = &flags;\n");
-        output.push_str("\n");
-        output.push_str("    VkDescriptorSetLayoutCreateInfo layoutInfo = {};\n");
-        output.push_str("    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;\n");
-        output.push_str("    layoutInfo.pNext = &bindingFlags;\n");
-        output.push_str("    layoutInfo.bindingCount = 1;\n");
-        output.push_str("    layoutInfo.pBindings = &binding;\n");
-        output.push_str("    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;\n");
-        output.push_str("\n");
-        output.push_str("    if (vkCreateDescriptorSetLayout(g_device, &layoutInfo, nullptr, &g_bindless_descriptor_set_layout) != VK_SUCCESS) {\n");
-        output.push_str("        throw std::runtime_error(\"Failed to create bindless descriptor set layout\");\n");
-        output.push_str("    }\n");
-        output.push_str("}\n");
-        output.push_str("\n");
-        
-        // Generate function to allocate bindless descriptor set
-        output.push_str("void allocate_bindless_descriptor_set() {\n");
-        output.push_str("    VkDescriptorPoolSize poolSize = {};\n");
-        output.push_str("    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;\n");
-        output.push_str("    poolSize.descriptorCount = MAX_BINDLESS_TEXTURES;\n");
-        output.push_str("\n");
-        output.push_str("    VkDescriptorPoolCreateInfo poolInfo = {};\n");
-        output.push_str("    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;\n");
-        output.push_str("    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;\n");
-        output.push_str("    poolInfo.poolSizeCount = 1;\n");
-        output.push_str("    poolInfo.pPoolSizes = &poolSize;\n");
-        output.push_str("    poolInfo.maxSets = 1;\n");
-        output.push_str("\n");
-        output.push_str("    if (vkCreateDescriptorPool(g_device, &poolInfo, nullptr, &g_bindless_descriptor_pool) != VK_SUCCESS) {\n");
-        output.push_str("        throw std::runtime_error(\"Failed to create bindless descriptor pool\");\n");
-        output.push_str("    }\n");
-        output.push_str("\n");
-        output.push_str("    VkDescriptorSetAllocateInfo allocInfo = {};\n");
-        output.push_str("    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;\n");
-        output.push_str("    allocInfo.descriptorPool = g_bindless_descriptor_pool;\n");
-        output.push_str("    allocInfo.descriptorSetCount = 1;\n");
-        output.push_str("    allocInfo.pSetLayouts = &g_bindless_descriptor_set_layout;\n");
-        output.push_str("\n");
-        output.push_str("    if (vkAllocateDescriptorSets(g_device, &allocInfo, &g_bindless_descriptor_set) != VK_SUCCESS) {\n");
-        output.push_str("        throw std::runtime_error(\"Failed to allocate bindless descriptor set\");\n");
-        output.push_str("    }\n");
-        output.push_str("}\n");
         output.push_str("\n");
         
         // Generate function to register images in bindless heap
         output.push_str("void register_bindless_textures() {\n");
-        output.push_str("    std::vector<VkDescriptorImageInfo> imageInfos;\n");
-        output.push_str("    std::vector<VkWriteDescriptorSet> descriptorWrites;\n");
+        output.push_str("    vkcore::BindlessHeap& heap = vkcore::BindlessHeap::shared(g_device);\n");
         output.push_str("\n");
         
-        for (index, res) in self.image_resources.iter().enumerate() {
+        for res in &self.image_resources {
             let global_name = format!("g_resource_{}", res.name.to_lowercase());
+            let const_name = format!("{}_TEXTURE_INDEX", res.name.to_uppercase());
             output.push_str(&format!("    // Register {}\n", res.name));
-            output.push_str(&format!("    VkDescriptorImageInfo imageInfo_{} = {};\n", index, res.name.to_lowercase()));
-            output.push_str(&format!("    imageInfo_{}.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;\n", res.name.to_lowercase()));
-            output.push_str(&format!("    if ({}.get() != nullptr) {{\n", global_name));
-            output.push_str(&format!("        imageInfo_{}.imageView = {}.get()->imageView;\n", res.name.to_lowercase(), global_name));
-            output.push_str(&format!("        imageInfo_{}.sampler = {}.get()->sampler;\n", res.name.to_lowercase(), global_name));
-            output.push_str(&format!("    }} else {{\n"));
-            output.push_str(&format!("        imageInfo_{}.imageView = VK_NULL_HANDLE;\n", res.name.to_lowercase()));
-            output.push_str(&format!("        imageInfo_{}.sampler = VK_NULL_HANDLE;\n", res.name.to_lowercase()));
-            output.push_str(&format!("    }}\n"));
-            output.push_str(&format!("    imageInfos.push_back(imageInfo_{});\n", res.name.to_lowercase()));
-            output.push_str("\n");
-            output.push_str(&format!("    VkWriteDescriptorSet write_{} = {};\n", index, res.name.to_lowercase()));
-            output.push_str(&format!("    write_{}.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;\n", res.name.to_lowercase()));
-            output.push_str(&format!("    write_{}.dstSet = g_bindless_descriptor_set;\n", res.name.to_lowercase()));
-            output.push_str(&format!("    write_{}.dstBinding = 0;\n", res.name.to_lowercase()));
-            output.push_str(&format!("    write_{}.dstArrayElement = {};\n", res.name.to_lowercase(), index));
-            output.push_str(&format!("    write_{}.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;\n", res.name.to_lowercase()));
-            output.push_str(&format!("    write_{}.descriptorCount = 1;\n", res.name.to_lowercase()));
-            output.push_str(&format!("    write_{}.pImageInfo = &imageInfos[{}];\n", res.name.to_lowercase(), index));
-            output.push_str(&format!("    descriptorWrites.push_back(write_{});\n", res.name.to_lowercase()));
+            output.push_str(&format!("    if ({}.get() != nullptr && {} == vkcore::BindlessHeap::INVALID_INDEX) {{\n", global_name, const_name));
+            output.push_str(&format!("        {} = heap.add({}.get()->imageView, {}.get()->sampler);\n", const_name, global_name, global_name));
+            output.push_str("    }\n");
             output.push_str("\n");
         }
         
-        output.push_str("    vkUpdateDescriptorSets(g_device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);\n");
         output.push_str("}\n");
         output.push_str("\n");
         
         // Generate initialization function
         output.push_str("void init_bindless_system() {\n");
-        output.push_str("    create_bindless_descriptor_set_layout();\n");
-        output.push_str("    allocate_bindless_descriptor_set();\n");
+        output.push_str("    vkcore::BindlessHeap& heap = vkcore::BindlessHeap::shared(g_device);\n");
+        output.push_str("    if (!heap.isInitialized()) {\n");
+        output.push_str("        throw std::runtime_error(\"Bindless texture heap unavailable (VK_EXT_descriptor_indexing)\");\n");
+        output.push_str("    }\n");
+        output.push_str("    g_bindless_descriptor_set_layout = heap.getLayout();\n");
+        output.push_str("    g_bindless_descriptor_set = heap.getSet();\n");
         output.push_str("    register_bindless_textures();\n");
         output.push_str("}\n");
         output.push_str("\n");
@@ -1684,123 +1675,207 @@ impl CodeGenerator {
             .unwrap_or(false)
     }
     
+    fn cuda_mirror_name(component_name: &str) -> String {
+        format!("g_cuda_{}", component_name.to_lowercase())
+    }
+    
+    // The @[cuda] component a query array name (positions) belongs to
+    fn cuda_component_for_plural(&self, plural: &str) -> Option<&ComponentDef> {
+        self.cuda_components.iter().find(|c| Self::uses_soa_columns(c) && Self::component_plural(&c.name) == plural)
+    }
+    
+    // Launch wrapper parameters: queries by reference, so results land in the real storage
+    fn cuda_launch_params(&self, f: &FunctionDef) -> String {
+        f.params.iter().map(|param| match param.ty {
+            Type::Query(_) => format!("{}& {}", self.type_to_cpp(&param.ty), param.name),
+            _ => format!("{} {}", self.type_to_cpp(&param.ty), param.name),
+        }).collect::<Vec<_>>().join(", ")
+    }
+    
+    // One CudaColumnMirror per field of each @[cuda] component, kept for the
+    // whole run so launches only move the rows that changed
+    fn generate_cuda_mirrors(&self) -> String {
+        let mut output = String::new();
+        output.push_str("// Device mirrors of @[cuda] components (stdlib/cuda_mirror.h)\n");
+        for comp in &self.cuda_components {
+            if !Self::uses_soa_columns(comp) {
+                continue;
+            }
+            output.push_str(&format!("struct CudaMirror_{} {{\n", comp.name));
+            for field in &comp.fields {
+                if let Type::Array(element_type) = &field.ty {
+                    output.push_str(&format!("    CudaColumnMirror<{}> {};\n", self.type_to_cpp(element_type), field.name));
+                }
+            }
+            output.push_str("};\n");
+            output.push_str(&format!("static CudaMirror_{} {};\n\n", comp.name, Self::cuda_mirror_name(&comp.name)));
+        }
+        if !self.cuda_functions.is_empty() {
+            output.push_str("// Waits for every running @[launch] kernel and commits its results\n");
+            output.push_str("void cuda_wait_all();\n\n");
+        }
+        output
+    }
+    
     fn generate_cuda_kernel(&mut self, f: &FunctionDef) -> String {
         let mut output = String::new();
         let kernel_name = f.cuda_kernel.as_ref().unwrap();
+        let query_params: Vec<String> = f.params.iter()
+            .filter(|p| matches!(p.ty, Type::Query(_)))
+            .map(|p| p.name.clone())
+            .collect();
+        
+        // Body first: the SoA columns its query loops touch become the
+        // kernel's parameters. Each loop over a query is one thread per entity
+        self.in_cuda_kernel = true;
+        let mut body = String::new();
+        let mut columns: Vec<(String, String, String)> = Vec::new();
+        for stmt in &f.body {
+            if let Statement::For { iterator, collection: Expression::Variable(query, _), body: loop_body, .. } = stmt {
+                if query_params.contains(query) {
+                    let outer_hoisted = self.soa_hoisted.replace((iterator.clone(), Vec::new()));
+                    let mut loop_output = String::new();
+                    for inner in loop_body {
+                        loop_output.push_str(&self.generate_statement_with_entity(inner, 1, iterator, query));
+                    }
+                    let hoisted = std::mem::replace(&mut self.soa_hoisted, outer_hoisted).map(|(_, columns)| columns).unwrap_or_default();
+                    
+                    body.push_str(&format!("    // Query iteration: for {} in {} (one thread per entity)\n", iterator, query));
+                    body.push_str(&format!("    if (thread_index < {}_count) {{\n", query));
+                    body.push_str(&format!("        size_t {}_index = thread_index;\n", iterator));
+                    for (plural, field) in &hoisted {
+                        body.push_str(&format!("        auto* EDEN_RESTRICT {}_{}_{} = {}_{}_{};\n",
+                            iterator, plural, field, query, plural, field));
+                        let column = (query.clone(), plural.clone(), field.clone());
+                        if !columns.contains(&column) {
+                            columns.push(column);
+                        }
+                    }
+                    body.push_str(&loop_output);
+                    body.push_str("    }\n");
+                    continue;
+                }
+            }
+            body.push_str(&self.generate_statement(stmt, 0));
+        }
+        self.in_cuda_kernel = false;
         
         // Generate CUDA kernel function
-        output.push_str(&format!("__global__ void {}_kernel(", kernel_name));
-        
-        // Parameters (convert query types to device pointers)
-        for (i, param) in f.params.iter().enumerate() {
-            if i > 0 {
-                output.push_str(", ");
-            }
-            // Convert query types to device pointers
+        let mut params = Vec::new();
+        for param in &f.params {
             if let Type::Query(_) = param.ty {
-                // For queries, generate device pointer parameters
-                output.push_str(&format!("{}* d_{}", self.type_to_cpp(&param.ty), param.name));
+                for (query, plural, field) in columns.iter().filter(|(query, _, _)| *query == param.name) {
+                    let element_type = self.cuda_component_for_plural(plural)
+                        .and_then(|c| c.fields.iter().find(|fd| fd.name == *field))
+                        .and_then(|fd| match &fd.ty { Type::Array(element_type) => Some(self.type_to_cpp(element_type)), _ => None })
+                        .unwrap_or_else(|| "float".to_string());
+                    params.push(format!("{}* EDEN_RESTRICT {}_{}_{}", element_type, query, plural, field));
+                }
+                params.push(format!("size_t {}_count", param.name));
             } else {
-                output.push_str(&format!("{} {}", self.type_to_cpp(&param.ty), param.name));
+                params.push(format!("{} {}", self.type_to_cpp(&param.ty), param.name));
             }
         }
-        output.push_str(") {\n");
-        
-        // Get thread index
-        output.push_str("    int idx = blockIdx.x * blockDim.x + threadIdx.x;\n");
-        output.push_str("    if (idx >= /* size */) return;  // TODO: Add size parameter\n");
-        output.push_str("\n");
-        
-        // Generate kernel body (simplified - just generate statements)
-        for stmt in &f.body {
-            output.push_str(&self.generate_statement(stmt, 1));
-        }
-        
+        output.push_str(&format!("__global__ void {}_kernel({}) {{\n", kernel_name, params.join(", ")));
+        output.push_str("    size_t thread_index = blockIdx.x * size_t(blockDim.x) + threadIdx.x;\n");
+        output.push_str(&body);
         output.push_str("}\n\n");
+        
+        self.cuda_launch_columns.insert(f.name.clone(), columns);
         output
     }
     
     fn generate_cuda_launch_wrapper(&self, f: &FunctionDef) -> String {
         let mut output = String::new();
         let kernel_name = f.cuda_kernel.as_ref().unwrap();
+        let columns = self.cuda_launch_columns.get(&f.name).cloned().unwrap_or_default();
+        let query_params: Vec<&Param> = f.params.iter().filter(|p| matches!(p.ty, Type::Query(_))).collect();
+        
+        // Host column, its mirror, and whether the kernel writes it
+        let column_info = |query: &str, plural: &str, field: &str| {
+            let component = self.cuda_component_for_plural(plural).map(|c| c.name.clone()).unwrap_or_default();
+            let host = format!("{}.{}.{}", query, plural, field);
+            let mirror = format!("{}.{}", Self::cuda_mirror_name(&component), field);
+            let mut writes = Vec::new();
+            for stmt in &f.body {
+                if let Statement::For { iterator, collection: Expression::Variable(name, _), body, .. } = stmt {
+                    if name == query {
+                        Self::entity_field_writes(body, iterator, &mut writes);
+                    }
+                }
+            }
+            let written = writes.iter().any(|(c, fd)| *c == component && fd == field);
+            (host, mirror, written)
+        };
         
-        // Generate CPU-side launch wrapper
-        output.push_str(&format!("void {}_launch(", f.name));
+        output.push_str(&format!("// {} on the GPU: its own stream, device columns kept between launches\n", f.name));
+        output.push_str(&format!("static CudaStream g_cuda_stream_{};\n", f.name));
+        output.push_str(&format!("static bool g_cuda_in_flight_{} = false;\n\n", f.name));
         
-        // Parameters
-        for (i, param) in f.params.iter().enumerate() {
-            if i > 0 {
-                output.push_str(", ");
+        // Wait: finish the last launch and commit the columns it wrote
+        output.push_str(&format!("void {}_wait() {{\n", f.name));
+        output.push_str(&format!("    if (!g_cuda_in_flight_{}) return;\n", f.name));
+        output.push_str(&format!("    g_cuda_in_flight_{} = false;\n", f.name));
+        output.push_str(&format!("    if (!g_cuda_stream_{}.synchronize()) return;\n", f.name));
+        for (query, plural, field) in &columns {
+            let (_, mirror, written) = column_info(query, plural, field);
+            if written {
+                output.push_str(&format!("    {}.commit();\n", mirror));
             }
-            output.push_str(&format!("{} {}", self.type_to_cpp(&param.ty), param.name));
         }
-        output.push_str(") {\n");
+        output.push_str("}\n\n");
         
-        // Allocate device memory for CUDA components
-        for comp in &self.cuda_components {
-            output.push_str(&format!("    // Allocate device memory for {}\n", comp.name));
-            for field in &comp.fields {
-                if let Type::Array(_) = field.ty {
-                    output.push_str(&format!("    {}* d_{}_{};\n", 
-                        self.type_to_cpp(&field.ty), comp.name.to_lowercase(), field.name));
-                    output.push_str(&format!("    cudaMalloc(&d_{}_{}, sizeof({}) * /* size */);\n",
-                        comp.name.to_lowercase(), field.name, self.type_to_cpp(&field.ty)));
-                }
-            }
+        // Generate CPU-side launch wrapper: returns as soon as the work is
+        // queued, so the kernel runs while the frame renders
+        output.push_str(&format!("void {}_launch({}) {{\n", f.name, self.cuda_launch_params(f)));
+        output.push_str(&format!("    {}_wait();\n", f.name));
+        output.push_str(&format!("    cudaStream_t stream = g_cuda_stream_{}.get();\n", f.name));
+        for query in &query_params {
+            output.push_str(&format!("    size_t {}_count = {}.size();\n", query.name, query.name));
         }
         
-        // Copy data to device
-        output.push_str("    // Copy data to device\n");
-        for comp in &self.cuda_components {
-            for field in &comp.fields {
-                if let Type::Array(_) = field.ty {
-                    output.push_str(&format!("    cudaMemcpy(d_{}_{}, /* host_ptr */, sizeof({}) * /* size */, cudaMemcpyHostToDevice);\n",
-                        comp.name.to_lowercase(), field.name, self.type_to_cpp(&field.ty)));
-                }
-            }
+        // Upload only the rows the CPU changed since the last launch
+        output.push_str("    // Copy dirty rows to the device\n");
+        for (query, plural, field) in &columns {
+            let (host, mirror, _) = column_info(query, plural, field);
+            output.push_str(&format!("    if (!{}.upload({}.data(), {}_count, stream)) return;\n", mirror, host, query));
         }
         
         // Launch kernel
+        let thread_count = match query_params.len() {
+            0 => "1".to_string(),
+            1 => format!("{}_count", query_params[0].name),
+            _ => format!("std::max({{{}}})", query_params.iter().map(|q| format!("{}_count", q.name)).collect::<Vec<_>>().join(", ")),
+        };
+        output.push_str(&format!("    size_t threads = {};\n", thread_count));
+        output.push_str("    if (threads == 0) return;\n");
         output.push_str(&format!("    // Launch {} kernel\n", kernel_name));
         output.push_str("    int blockSize = 256;\n");
-        output.push_str("    int numBlocks = (/* size */ + blockSize - 1) / blockSize;\n");
-        output.push_str(&format!("    {}_kernel<<<numBlocks, blockSize>>>(", kernel_name));
-        
-        // Kernel arguments
-        for (i, param) in f.params.iter().enumerate() {
-            if i > 0 {
-                output.push_str(", ");
-            }
+        output.push_str("    int numBlocks = int((threads + blockSize - 1) / blockSize);\n");
+        let mut args = Vec::new();
+        for param in &f.params {
             if let Type::Query(_) = param.ty {
-                output.push_str(&format!("d_{}", param.name));
-            } else {
-                output.push_str(&param.name);
-            }
-        }
-        output.push_str(");\n");
-        
-        // Copy data back from device
-        output.push_str("    // Copy data back from device\n");
-        for comp in &self.cuda_components {
-            for field in &comp.fields {
-                if let Type::Array(_) = field.ty {
-                    output.push_str(&format!("    cudaMemcpy(/* host_ptr */, d_{}_{}, sizeof({}) * /* size */, cudaMemcpyDeviceToHost);\n",
-                        comp.name.to_lowercase(), field.name, self.type_to_cpp(&field.ty)));
+                for (query, plural, field) in columns.iter().filter(|(query, _, _)| *query == param.name) {
+                    let (_, mirror, _) = column_info(query, plural, field);
+                    args.push(format!("{}.device()", mirror));
                 }
+                args.push(format!("{}_count", param.name));
+            } else {
+                args.push(param.name.clone());
             }
         }
+        output.push_str(&format!("    {}_kernel<<<numBlocks, blockSize, 0, stream>>>({});\n", kernel_name, args.join(", ")));
+        output.push_str(&format!("    if (!cuda_mirror_detail::check(cudaGetLastError(), \"{}_kernel\")) return;\n", kernel_name));
         
-        // Free device memory
-        output.push_str("    // Free device memory\n");
-        for comp in &self.cuda_components {
-            for field in &comp.fields {
-                if let Type::Array(_) = field.ty {
-                    output.push_str(&format!("    cudaFree(d_{}_{});\n",
-                        comp.name.to_lowercase(), field.name));
-                }
+        // Start copying results back; {name}_wait() commits them
+        output.push_str("    // Copy written columns back asynchronously\n");
+        for (query, plural, field) in &columns {
+            let (host, mirror, written) = column_info(query, plural, field);
+            if written {
+                output.push_str(&format!("    {}.download({}.data(), {}_count, stream);\n", mirror, host, query));
             }
         }
-        
+        output.push_str(&format!("    g_cuda_in_flight_{} = true;\n", f.name));
         output.push_str("}\n\n");
         output
     }
@@ -1823,6 +1898,7 @@ impl CodeGenerator {
         };
         
         output.push_str(&format!("{} {}(", return_type, func_name));
+        self.in_main = f.name == "main";
         
         // Parameters
         for (i, param) in f.params.iter().enumerate() {
@@ -1901,8 +1977,8 @@ impl CodeGenerator {
                             output.push_str(&format!("{}        std::cout.flush();\n", ecs_indent));
                             output.push_str(&format!("{}        std::cout << \"[ECS Init] g_entities.size()=\" << g_entities.size() << std::endl;\n", ecs_indent));
                             output.push_str(&format!("{}        if (!g_entities.empty()) {{\n", ecs_indent));
-                            output.push_str(&format!("{}            auto* p = g_storage.get_component<Position>(g_entities[0]);\n", ecs_indent));
-                            output.push_str(&format!("{}            auto* v = g_storage.get_component<Velocity>(g_entities[0]);\n", ecs_indent));
+                            output.push_str(&format!("{}            const Position* p = g_storage.read_component<Position>(g_entities[0]);\n", ecs_indent));
+                            output.push_str(&format!("{}            const Velocity* v = g_storage.read_component<Velocity>(g_entities[0]);\n", ecs_indent));
                             output.push_str(&format!("{}            if (p && v) {{\n", ecs_indent));
                             output.push_str(&format!("{}                std::cout << \"[ECS Init] Entity 0: pos=(\" << p->x << \",\" << p->y << \",\" << p->z << \") vel=(\" << v->x << \",\" << v->y << \",\" << v->z << \")\" << std::endl;\n", ecs_indent));
                             output.push_str(&format!("{}            }} else {{\n", ecs_indent));
@@ -1930,11 +2006,146 @@ impl CodeGenerator {
         if f.name == "main" && matches!(f.return_type, Type::Void) {
             output.push_str(&format!("{}    return 0;\n", self.indent(indent + 1)));
         }
+        self.in_main = false;
         
         output.push_str("}\n\n");
         output
     }
     
+    // Query loop with an index variable: serial, or for @[parallel] split
+    // into ranges on the job system (stdlib/job_system.h). SoA columns the
+    // body touches are hoisted into restrict pointers first, and a body that
+    // only writes its own entity's fields is marked for vectorization.
+    fn generate_query_loop(&mut self, iterator: &str, collection_expr: &str, body: &[Statement], parallel: bool, indent: usize, label: &str) -> String {
+        let body_indent = if parallel { indent + 2 } else { indent + 1 };
+        let loop_indent = if parallel { indent + 1 } else { indent };
+        
+        // Generate body - entity access will be handled in expression generation
+        let outer_hoisted = self.soa_hoisted.replace((iterator.to_string(), Vec::new()));
+        let mut body_output = String::new();
+        for stmt in body {
+            // Replace entity.Component.field with query.component_arrays[entity_index].field
+            body_output.push_str(&self.generate_statement_with_entity(stmt, body_indent, iterator, collection_expr));
+        }
+        let columns = std::mem::replace(&mut self.soa_hoisted, outer_hoisted).map(|(_, columns)| columns).unwrap_or_default();
+        
+        let mut loop_header = String::new();
+        for (plural, field) in &columns {
+            loop_header.push_str(&format!("{}    auto* EDEN_RESTRICT {}_{}_{} = {}.{}.{}.data();\n",
+                self.indent(loop_indent), iterator, plural, field, collection_expr, plural, field));
+        }
+        if !columns.is_empty() && body.iter().all(|stmt| Self::writes_only_entity_fields(stmt, iterator)) {
+            loop_header.push_str(&format!("{}    EDEN_VECTORIZE\n", self.indent(loop_indent)));
+        }
+        
+        // @[cuda] columns: the CPU waits for running kernels before touching
+        // them, and marks the rows it wrote for the next upload
+        let mut cuda_dirty = Vec::new();
+        let mut touches_cuda = false;
+        if !self.in_cuda_kernel && !self.cuda_components.is_empty() {
+            touches_cuda = columns.iter().any(|(plural, _)| self.cuda_component_for_plural(plural).is_some());
+            let mut writes = Vec::new();
+            Self::entity_field_writes(body, iterator, &mut writes);
+            for (component, field) in writes {
+                let mirrored = self.cuda_components.iter().any(|c| c.name == component && Self::uses_soa_columns(c));
+                if mirrored && !cuda_dirty.contains(&(component.clone(), field.clone())) {
+                    cuda_dirty.push((component, field));
+                }
+            }
+        }
+        
+        let mut output = String::new();
+        if touches_cuda && !self.cuda_functions.is_empty() {
+            output.push_str(&format!("{}    cuda_wait_all();\n", self.indent(indent)));
+        }
+        if parallel {
+            output.push_str(&format!("{}    // Parallel {}: for {} in {}\n",
+                self.indent(indent), label.to_lowercase(), iterator, collection_expr));
+            output.push_str(&format!("{}    parallel_for({}.size(), [&](size_t {}_begin, size_t {}_end) {{\n",
+                self.indent(indent), collection_expr, iterator, iterator));
+            output.push_str(&loop_header);
+            output.push_str(&format!("{}    for (size_t {}_index = {}_begin; {}_index < {}_end; ++{}_index) {{\n",
+                self.indent(indent + 1), iterator, iterator, iterator, iterator, iterator));
+        } else {
+            output.push_str(&format!("{}    // {}: for {} in {}\n",
+                self.indent(indent), label, iterator, collection_expr));
+            output.push_str(&loop_header);
+            output.push_str(&format!("{}    for (size_t {}_index = 0; {}_index < {}.size(); ++{}_index) {{\n",
+                self.indent(indent), iterator, iterator, collection_expr, iterator));
+        }
+        output.push_str(&body_output);
+        if parallel {
+            output.push_str(&format!("{}    }}\n", self.indent(indent + 1)));
+            output.push_str(&format!("{}    }});\n", self.indent(indent)));
+        } else {
+            output.push_str(&format!("{}    }}\n", self.indent(indent)));
+        }
+        for (component, field) in &cuda_dirty {
+            output.push_str(&format!("{}    {}.{}.mark_dirty(0, {}.size());\n",
+                self.indent(indent), Self::cuda_mirror_name(component), field, collection_expr));
+        }
+        output
+    }
+    
+    // (component, field) of every entity.Component.field assigned in the
+    // loop body, nested loops over other iterators excluded
+    fn entity_field_writes(stmts: &[Statement], entity_name: &str, writes: &mut Vec<(String, String)>) {
+        for stmt in stmts {
+            match stmt {
+                Statement::Assign { target: Expression::MemberAccess { object, member, .. }, .. } => {
+                    if let Expression::MemberAccess { object: inner_obj, member: component, .. } = object.as_ref() {
+                        if matches!(inner_obj.as_ref(), Expression::Variable(name, ..) if name == entity_name) {
+                            writes.push((component.clone(), member.clone()));
+                        }
+                    }
+                }
+                Statement::If { then_block, else_block, .. } => {
+                    Self::entity_field_writes(then_block, entity_name, writes);
+                    if let Some(else_block) = else_block {
+                        Self::entity_field_writes(else_block, entity_name, writes);
+                    }
+                }
+                Statement::While { body, .. } | Statement::Loop { body, .. } | Statement::Block(body, _) => {
+                    Self::entity_field_writes(body, entity_name, writes);
+                }
+                Statement::For { iterator, body, .. } if iterator != entity_name => {
+                    Self::entity_field_writes(body, entity_name, writes);
+                }
+                _ => {}
+            }
+        }
+    }
+    
+    // Lets, and assignments to entity.Component.field: no iteration can see
+    // another's writes
+    fn writes_only_entity_fields(stmt: &Statement, entity_name: &str) -> bool {
+        match stmt {
+            Statement::Let { .. } => true,
+            Statement::Assign { target, .. } => {
+                if let Expression::MemberAccess { object, .. } = target {
+                    if let Expression::MemberAccess { object: inner_obj, .. } = object.as_ref() {
+                        return matches!(inner_obj.as_ref(), Expression::Variable(name, ..) if name == entity_name);
+                    }
+                }
+                false
+            }
+            _ => false,
+        }
+    }
+    
+    // Position -> positions, Velocity -> velocities: a query's array for the component
+    fn component_plural(component_name: &str) -> String {
+        let component_lower = component_name.to_lowercase();
+        if component_lower.ends_with('y') {
+            // Velocity -> velocities (y -> ies)
+            format!("{}ies", &component_lower[..component_lower.len()-1])
+        } else if component_lower.ends_with('s') || component_lower.ends_with('x') || component_lower.ends_with('z') || component_lower.ends_with('h') {
+            format!("{}es", component_lower)
+        } else {
+            format!("{}s", component_lower)
+        }
+    }
+    
     fn generate_statement_with_entity(&mut self, stmt: &Statement, indent: usize, entity_name: &str, query_name: &str) -> String {
         // Generate statement but replace entity.Component.field with query.component_arrays[entity_index].field
         match stmt {
@@ -1996,19 +2207,10 @@ impl CodeGenerator {
                 output.push_str(&format!("{}    }}\n", self.indent(indent)));
                 output
             }
-            Statement::For { iterator, collection, body, .. } => {
-                // Nested for loop - generate with entity context
+            Statement::For { iterator, collection, body, parallel, .. } => {
+                // Nested for loop - generate with entity context (its own)
                 let collection_expr = self.generate_expression_with_entity(collection, entity_name, query_name);
-                let mut output = format!("{}    // Nested query iteration: for {} in {}\n", 
-                    self.indent(indent), iterator, collection_expr);
-                output.push_str(&format!("{}    for (size_t {}_index = 0; {}_index < {}.size(); ++{}_index) {{\n",
-                    self.indent(indent), iterator, iterator, collection_expr, iterator));
-                for stmt in body {
-                    // Nested for loop gets its own entity context
-                    output.push_str(&self.generate_statement_with_entity(stmt, indent + 1, iterator, &collection_expr));
-                }
-                output.push_str(&format!("{}    }}\n", self.indent(indent)));
-                output
+                self.generate_query_loop(iterator, &collection_expr, body, *parallel, indent, "Nested query iteration")
             }
             Statement::Return(expr, ..) => {
                 if let Some(expr) = expr {
@@ -2073,19 +2275,20 @@ impl CodeGenerator {
                             // This is entity.Component.field - generate query access
                             // Check if component is SOA
                             let is_soa = self.is_component_soa(component_name);
-                            
-                            // Convert to lowercase and pluralize (Position -> positions, Velocity -> velocities)
-                            let component_lower = component_name.to_lowercase();
-                            let component_plural = if component_lower.ends_with('y') {
-                                // Velocity -> velocities (y -> ies)
-                                format!("{}ies", &component_lower[..component_lower.len()-1])
-                            } else if component_lower.ends_with('s') || component_lower.ends_with('x') || component_lower.ends_with('z') || component_lower.ends_with('h') {
-                                format!("{}es", component_lower)
-                            } else {
-                                format!("{}s", component_lower)
-                            };
+                            let component_plural = Self::component_plural(component_name);
                             
                             // Generate access pattern based on SOA vs AoS
+                            let columns = self.components.get(component_name).map(Self::uses_soa_columns).unwrap_or(false);
+                            if let (true, Some((iterator, hoisted))) = (columns, self.soa_hoisted.as_mut()) {
+                                if iterator == entity_name {
+                                    // SoA column hoisted by the enclosing loop: entity_velocities_x[entity_index]
+                                    let column = (component_plural.clone(), member.clone());
+                                    if !hoisted.contains(&column) {
+                                        hoisted.push(column);
+                                    }
+                                    return format!("{}_{}_{}[{}_index]", entity_name, component_plural, member, entity_name);
+                                }
+                            }
                             if is_soa {
                                 // SOA: query.velocities.x[entity_index] (field is array, index at end)
                                 format!("{}.{}.{}[{}_index]", query_name, component_plural, member, entity_name)
@@ -2232,7 +2435,12 @@ impl CodeGenerator {
     fn generate_statement(&mut self, stmt: &Statement, indent: usize) -> String {
         match stmt {
             Statement::Let { name, ty, value, .. } => {
-                let type_str = if let Some(ty) = ty {
+                let type_str = if matches!(value, Expression::FrameAlloc { .. }) {
+                    // FrameArray<T> view into the arena, not a std::vector
+                    "auto".to_string()
+                } else if matches!(value, Expression::Call { name, .. } if name == "frame_arena") {
+                    "FrameArena&".to_string()
+                } else if let Some(ty) = ty {
                     self.type_to_cpp(ty)
                 } else {
                     "auto".to_string()
@@ -2293,7 +2501,12 @@ impl CodeGenerator {
                 let mut output = format!("{}    while ({}) {{\n", 
                     self.indent(indent),
                     self.generate_expression(condition));
+                output.push_str(&self.generate_frame_start(indent + 1));
                 // Add hot-reload check at the start of while loop if we have hot systems or hot shaders
+                if !self.hot_systems.is_empty() || !self.hot_shaders.is_empty() || self.has_resources {
+                    // Collect file watcher events once per iteration (the checks below only stat changed files)
+                    output.push_str(&format!("{}        FileWatcher::shared().poll();\n", self.indent(indent + 1)));
+                }
                 if !self.hot_systems.is_empty() {
                     // Add check at the start of each while loop iteration
                     output.push_str(&format!("{}        check_and_reload_hot_system();\n", self.indent(indent + 1)));
@@ -2310,36 +2523,27 @@ impl CodeGenerator {
                     // Add resource hot-reload check at the start of each while loop iteration
                     output.push_str(&format!("{}        check_and_reload_resources();\n", self.indent(indent + 1)));
                 }
+                self.loop_depth += 1;
                 for stmt in body {
                     output.push_str(&self.generate_statement(stmt, indent + 1));
                 }
+                self.loop_depth -= 1;
                 output.push_str(&format!("{}    }}\n", self.indent(indent)));
                 output
             }
-            Statement::For { iterator, collection, body, .. } => {
+            Statement::For { iterator, collection, body, parallel, .. } => {
                 // Generate query iteration: for entity in q { ... }
                 let collection_expr = self.generate_expression(collection);
-                
-                // Generate iteration loop with index variable
-                let mut output = format!("{}    // Query iteration: for {} in {}\n", 
-                    self.indent(indent), iterator, collection_expr);
-                output.push_str(&format!("{}    for (size_t {}_index = 0; {}_index < {}.size(); ++{}_index) {{\n",
-                    self.indent(indent), iterator, iterator, collection_expr, iterator));
-                
-                // Generate body - entity access will be handled in expression generation
-                // We need to track that we're in a query loop for entity access
-                for stmt in body {
-                    // Replace entity.Component.field with query.component_arrays[entity_index].field
-                    output.push_str(&self.generate_statement_with_entity(stmt, indent + 1, iterator, &collection_expr));
-                }
-                output.push_str(&format!("{}    }}\n", self.indent(indent)));
-                output
+                self.generate_query_loop(iterator, &collection_expr, body, *parallel, indent, "Query iteration")
             }
             Statement::Loop { body, .. } => {
                 let mut output = format!("{}    while (true) {{\n", self.indent(indent));
+                output.push_str(&self.generate_frame_start(indent + 1));
+                self.loop_depth += 1;
                 for stmt in body {
                     output.push_str(&self.generate_statement(stmt, indent + 1));
                 }
+                self.loop_depth -= 1;
                 output.push_str(&format!("{}    }}\n", self.indent(indent)));
                 output
             }
@@ -2362,9 +2566,9 @@ impl CodeGenerator {
                     output.push_str(&format!("{}            // Update physics using ECS (integrate positions with velocities)\n", self.indent(indent)));
                     output.push_str(&format!("{}            auto now = std::chrono::high_resolution_clock::now();\n", self.indent(indent)));
                     output.push_str(&format!("{}            auto dt_us = std::chrono::duration_cast<std::chrono::microseconds>(now - g_last_update_time);\n", self.indent(indent)));
-                    output.push_str(&format!("{}            float dt = dt_us.count() / 1'000'000.0f;\n", self.indent(indent)));
-                    output.push_str(&format!("{}            if (dt > 0.1f) dt = 0.016f; // clamp\n", self.indent(indent)));
                     output.push_str(&format!("{}            g_last_update_time = now;\n", self.indent(indent)));
+                    output.push_str(&format!("{}            int sim_steps = g_sim_clock.advance(dt_us.count() / 1'000'000.0);\n", self.indent(indent)));
+                    output.push_str(&format!("{}            float dt = g_sim_clock.step_seconds();\n", self.indent(indent)));
                     output.push_str(&format!("{}            \n", self.indent(indent)));
                     output.push_str(&format!("{}            float speed_scale = 1.0f;\n", self.indent(indent)));
                     // Check if we have get_movement_speed hot function
@@ -2377,50 +2581,61 @@ impl CodeGenerator {
                         output.push_str(&format!("{}            }}\n", self.indent(indent)));
                     }
                     output.push_str(&format!("{}            \n", self.indent(indent)));
-                    output.push_str(&format!("{}            // Update positions using velocities from ECS\n", self.indent(indent)));
-                    output.push_str(&format!("{}            for (EntityId e : g_entities) {{\n", self.indent(indent)));
                     // Generate component access based on hot components
                     let has_position = self.hot_components.iter().any(|c| c.name == "Position");
                     let has_velocity = self.hot_components.iter().any(|c| c.name == "Velocity");
+                    output.push_str(&format!("{}            // Update positions using velocities from ECS, one fixed step at a time\n", self.indent(indent)));
+                    output.push_str(&format!("{}            for (int sim_step = 0; sim_step < sim_steps; sim_step++) {{\n", self.indent(indent)));
+                    if has_position {
+                        output.push_str(&format!("{}                g_prev_positions.store([](size_t i) {{\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    const Position* p = g_storage.read_component<Position>(g_entities[i]);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    return p ? *p : Position{{}};\n", self.indent(indent)));
+                        output.push_str(&format!("{}                }}, g_entities.size());\n", self.indent(indent)));
+                    }
+                    output.push_str(&format!("{}                for (EntityId e : g_entities) {{\n", self.indent(indent)));
                     if has_position && has_velocity {
-                        output.push_str(&format!("{}                auto* p = g_storage.get_component<Position>(e);\n", self.indent(indent)));
-                        output.push_str(&format!("{}                auto* v = g_storage.get_component<Velocity>(e);\n", self.indent(indent)));
-                        output.push_str(&format!("{}                if (!p || !v) continue;\n", self.indent(indent)));
-                        output.push_str(&format!("{}                \n", self.indent(indent)));
-                        output.push_str(&format!("{}                // Integrate: pos += vel * dt * speed_scale\n", self.indent(indent)));
-                        output.push_str(&format!("{}                p->x += v->x * dt * speed_scale;\n", self.indent(indent)));
-                        output.push_str(&format!("{}                p->y += v->y * dt * speed_scale;\n", self.indent(indent)));
-                        output.push_str(&format!("{}                p->z += v->z * dt * speed_scale;\n", self.indent(indent)));
-                        output.push_str(&format!("{}                \n", self.indent(indent)));
-                        output.push_str(&format!("{}                // Bounce off walls\n", self.indent(indent)));
-                        output.push_str(&format!("{}                auto bounce_axis = [&](float& pos, float& vel) {{\n", self.indent(indent)));
-                        output.push_str(&format!("{}                    if (pos > BOUNDS || pos < -BOUNDS) {{\n", self.indent(indent)));
-                        output.push_str(&format!("{}                        vel = -vel;\n", self.indent(indent)));
-                        output.push_str(&format!("{}                        pos = (pos > BOUNDS) ? BOUNDS : -BOUNDS;\n", self.indent(indent)));
-                        output.push_str(&format!("{}                    }}\n", self.indent(indent)));
-                        output.push_str(&format!("{}                }};\n", self.indent(indent)));
-                        output.push_str(&format!("{}                bounce_axis(p->x, v->x);\n", self.indent(indent)));
-                        output.push_str(&format!("{}                bounce_axis(p->y, v->y);\n", self.indent(indent)));
-                        output.push_str(&format!("{}                bounce_axis(p->z, v->z);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    auto* p = g_storage.get_component<Position>(e);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    auto* v = g_storage.get_component<Velocity>(e);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    if (!p || !v) continue;\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    \n", self.indent(indent)));
+                        output.push_str(&format!("{}                    // Integrate: pos += vel * dt * speed_scale\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    p->x += v->x * dt * speed_scale;\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    p->y += v->y * dt * speed_scale;\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    p->z += v->z * dt * speed_scale;\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    \n", self.indent(indent)));
+                        output.push_str(&format!("{}                    // Bounce off walls\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    auto bounce_axis = [&](float& pos, float& vel) {{\n", self.indent(indent)));
+                        output.push_str(&format!("{}                        if (pos > BOUNDS || pos < -BOUNDS) {{\n", self.indent(indent)));
+                        output.push_str(&format!("{}                            vel = -vel;\n", self.indent(indent)));
+                        output.push_str(&format!("{}                            pos = (pos > BOUNDS) ? BOUNDS : -BOUNDS;\n", self.indent(indent)));
+                        output.push_str(&format!("{}                        }}\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    }};\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    bounce_axis(p->x, v->x);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    bounce_axis(p->y, v->y);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    bounce_axis(p->z, v->z);\n", self.indent(indent)));
                     }
+                    output.push_str(&format!("{}                }}\n", self.indent(indent)));
                     output.push_str(&format!("{}            }}\n", self.indent(indent)));
                     output.push_str(&format!("{}            \n", self.indent(indent)));
-                    output.push_str(&format!("{}            // Build arrays for renderer from ECS data\n", self.indent(indent)));
-                    output.push_str(&format!("{}            std::vector<float> positions;\n", self.indent(indent)));
-                    output.push_str(&format!("{}            positions.reserve(ball_count * 3);\n", self.indent(indent)));
-                    output.push_str(&format!("{}            std::vector<float> sizes;\n", self.indent(indent)));
-                    output.push_str(&format!("{}            sizes.reserve(ball_count);\n", self.indent(indent)));
-                    output.push_str(&format!("{}            for (EntityId e : g_entities) {{\n", self.indent(indent)));
+                    output.push_str(&format!("{}            // Build arrays for renderer from ECS data (frame arena, no heap allocation)\n", self.indent(indent)));
+                    output.push_str(&format!("{}            FrameVector<float> positions(FrameArena::local(), g_entities.size() * 3);\n", self.indent(indent)));
+                    output.push_str(&format!("{}            FrameVector<float> sizes(FrameArena::local(), g_entities.size());\n", self.indent(indent)));
+                    output.push_str(&format!("{}            float sim_alpha = g_sim_clock.alpha();\n", self.indent(indent)));
+                    output.push_str(&format!("{}            for (size_t i = 0; i < g_entities.size(); i++) {{\n", self.indent(indent)));
                     if has_position {
-                        output.push_str(&format!("{}                auto* p = g_storage.get_component<Position>(e);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                const Position* p = g_storage.read_component<Position>(g_entities[i]);\n", self.indent(indent)));
                         output.push_str(&format!("{}                if (!p) {{\n", self.indent(indent)));
-                        output.push_str(&format!("{}                    positions.insert(positions.end(), {{0.0f, 0.0f, 0.0f}});\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    positions.push_back(0.0f);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    positions.push_back(0.0f);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                    positions.push_back(0.0f);\n", self.indent(indent)));
                         output.push_str(&format!("{}                    sizes.push_back(0.2f);\n", self.indent(indent)));
                         output.push_str(&format!("{}                    continue;\n", self.indent(indent)));
                         output.push_str(&format!("{}                }}\n", self.indent(indent)));
-                        output.push_str(&format!("{}                positions.push_back(p->x);\n", self.indent(indent)));
-                        output.push_str(&format!("{}                positions.push_back(p->y);\n", self.indent(indent)));
-                        output.push_str(&format!("{}                positions.push_back(p->z);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                // Between the last two steps, by the time left over\n", self.indent(indent)));
+                        output.push_str(&format!("{}                const Position& prev = g_prev_positions.has_previous(i) ? g_prev_positions.previous(i) : *p;\n", self.indent(indent)));
+                        output.push_str(&format!("{}                positions.push_back(prev.x + (p->x - prev.x) * sim_alpha);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                positions.push_back(prev.y + (p->y - prev.y) * sim_alpha);\n", self.indent(indent)));
+                        output.push_str(&format!("{}                positions.push_back(prev.z + (p->z - prev.z) * sim_alpha);\n", self.indent(indent)));
                         // Check if Position has a size field
                         let pos_has_size = self.hot_components.iter()
                             .find(|c| c.name == "Position")
@@ -2471,6 +2686,15 @@ impl CodeGenerator {
     }
     
     fn generate_expression(&mut self, expr: &Expression) -> String {
+        // compile --profile: time each system, hot-function and @[launch] call
+        if let Expression::Call { name, .. } = expr {
+            let timed = !std::mem::take(&mut self.profiling_call);
+            if timed && self.profile_systems && !self.in_cuda_kernel && self.profiled_functions.contains(name) {
+                self.profiling_call = true;  // The call itself, once; its arguments get their own timers
+                let call = self.generate_expression(expr);
+                return format!("EDEN_PROFILE_CALL(\"{}\", {})", name, call);
+            }
+        }
         match expr {
             Expression::Literal(lit, _) => {
                 match lit {
@@ -2539,6 +2763,15 @@ impl CodeGenerator {
                     return output;
                 }
                 
+                if name == "frame_arena" {
+                    return "FrameArena::local()".to_string();
+                }
+                
+                if self.cuda_functions.iter().any(|f| f.name == *name) {
+                    let args: Vec<String> = args.iter().map(|arg| self.generate_expression(arg)).collect();
+                    return format!("{}_launch({})", name, args.join(", "));
+                }
+                
                 // Handle ImGui function calls (convert to ImGui:: namespace)
                 if name.starts_with("ImGui_") || name.starts_with("ImGui::") {
                     let imgui_name = if name.starts_with("ImGui_") {
@@ -2601,6 +2834,12 @@ impl CodeGenerator {
                     self.generate_expression(array),
                     self.generate_expression(index))
             }
+            Expression::FrameAlloc { arena, element_type, count, .. } => {
+                format!("{}.alloc_array<{}>({})",
+                    self.generate_expression(arena),
+                    self.type_to_cpp(element_type),
+                    self.generate_expression(count))
+            }
             Expression::ArrayLiteral { elements, .. } => {
                 let mut output = String::from("{");
                 for (i, elem) in elements.iter().enumerate() {
@@ -2755,6 +2994,7 @@ impl CodeGenerator {
             Type::Optional(inner_type) => {
                 format!("std::optional<{}>", self.type_to_cpp(inner_type))
             }
+            Type::Struct(name) if name == "FrameArena" => "FrameArena&".to_string(),  // Arenas are never copied
             Type::Struct(name) => name.clone(),
             Type::Component(name) => name.clone(),
             Type::Query(component_types) => {
@@ -2807,6 +3047,103 @@ impl CodeGenerator {
         }
     }
     
+    fn program_has_parallel_loops(program: &Program) -> bool {
+        program.items.iter().any(|item| match item {
+            Item::Function(f) => Self::statements_have_parallel_loops(&f.body),
+            Item::System(s) => s.functions.iter().any(|f| Self::statements_have_parallel_loops(&f.body)),
+            _ => false,
+        })
+    }
+    
+    fn statements_have_parallel_loops(stmts: &[Statement]) -> bool {
+        stmts.iter().any(|stmt| match stmt {
+            Statement::For { parallel, body, .. } => *parallel || Self::statements_have_parallel_loops(body),
+            Statement::If { then_block, else_block, .. } => {
+                Self::statements_have_parallel_loops(then_block)
+                    || else_block.as_ref().map_or(false, |b| Self::statements_have_parallel_loops(b))
+            }
+            Statement::While { body, .. } | Statement::Loop { body, .. } | Statement::Block(body, _) => {
+                Self::statements_have_parallel_loops(body)
+            }
+            _ => false,
+        })
+    }
+    
+    // First statement of a loop body: the outermost loop in main is the
+    // frame loop, so each iteration starts a new frame for every arena
+    fn generate_frame_start(&self, indent: usize) -> String {
+        let mut output = String::new();
+        if !self.in_main || self.loop_depth != 0 {
+            return output;
+        }
+        if self.uses_frame_arena {
+            output.push_str(&format!("{}    FrameArena::next_frame();\n", self.indent(indent)));
+        }
+        if self.profile_systems {
+            output.push_str(&format!("{}    SystemProfiler::end_frame();\n", self.indent(indent)));
+        }
+        // Kernels launched last frame ran alongside its rendering
+        if !self.cuda_functions.is_empty() {
+            output.push_str(&format!("{}    cuda_wait_all();\n", self.indent(indent)));
+        }
+        output
+    }
+    
+    fn program_uses_frame_arena(program: &Program) -> bool {
+        program.items.iter().any(|item| match item {
+            Item::Function(f) => Self::function_uses_frame_arena(f),
+            Item::System(s) => s.functions.iter().any(|f| Self::function_uses_frame_arena(f)),
+            _ => false,
+        })
+    }
+    
+    fn function_uses_frame_arena(f: &FunctionDef) -> bool {
+        f.params.iter().any(|p| matches!(&p.ty, Type::Struct(name) if name == "FrameArena"))
+            || Self::statements_use_frame_arena(&f.body)
+    }
+    
+    fn statements_use_frame_arena(stmts: &[Statement]) -> bool {
+        stmts.iter().any(|stmt| match stmt {
+            Statement::Let { value, .. } | Statement::Expression(value, _) => Self::expression_uses_frame_arena(value),
+            Statement::Assign { target, value, .. } => {
+                Self::expression_uses_frame_arena(target) || Self::expression_uses_frame_arena(value)
+            }
+            Statement::Return(value, _) => value.as_ref().map_or(false, |v| Self::expression_uses_frame_arena(v)),
+            Statement::Defer(value, _) => Self::expression_uses_frame_arena(value),
+            Statement::If { condition, then_block, else_block, .. } => {
+                Self::expression_uses_frame_arena(condition)
+                    || Self::statements_use_frame_arena(then_block)
+                    || else_block.as_ref().map_or(false, |b| Self::statements_use_frame_arena(b))
+            }
+            Statement::While { condition, body, .. } => {
+                Self::expression_uses_frame_arena(condition) || Self::statements_use_frame_arena(body)
+            }
+            Statement::For { body, .. } | Statement::Loop { body, .. } | Statement::Block(body, _) => {
+                Self::statements_use_frame_arena(body)
+            }
+            _ => false,
+        })
+    }
+    
+    fn expression_uses_frame_arena(expr: &Expression) -> bool {
+        match expr {
+            Expression::FrameAlloc { .. } => true,
+            Expression::Call { name, args, .. } => {
+                name == "frame_arena" || args.iter().any(Self::expression_uses_frame_arena)
+            }
+            Expression::BinaryOp { left, right, .. } => {
+                Self::expression_uses_frame_arena(left) || Self::expression_uses_frame_arena(right)
+            }
+            Expression::UnaryOp { expr, .. } => Self::expression_uses_frame_arena(expr),
+            Expression::MemberAccess { object, .. } => Self::expression_uses_frame_arena(object),
+            Expression::Index { array, index, .. } => {
+                Self::expression_uses_frame_arena(array) || Self::expression_uses_frame_arena(index)
+            }
+            Expression::ArrayLiteral { elements, .. } => elements.iter().any(Self::expression_uses_frame_arena),
+            _ => false,
+        }
+    }
+    
     fn indent(&self, level: usize) -> String {
         "    ".repeat(level)
     }
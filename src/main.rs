@@ -16,13 +16,18 @@ use codegen::CodeGenerator;
 use error::ErrorReporter;
 
 fn main() -> Result<()> {
-    let args: Vec<String> = std::env::args().collect();
+    let all_args: Vec<String> = std::env::args().collect();
+    // --profile: time every system/hot-function call (stdlib/system_profiler.h)
+    let profile = all_args.iter().any(|a| a == "--profile");
+    let args: Vec<String> = all_args.into_iter().filter(|a| a != "--profile").collect();
     
     if args.len() < 2 {
         eprintln!("Usage: heidic_v2 <command> [args...]");
         eprintln!("Commands:");
         eprintln!("  compile <file>  - Compile a HEIDIC v2 source file");
         eprintln!("  run <file>      - Compile and run a HEIDIC v2 source file");
+        eprintln!("Options:");
+        eprintln!("  --profile       - Time each system and hot-function call, count allocations (ImGui overlay, EDEN_PROFILE_TRACE=<file>)");
         return Ok(());
     }
     
@@ -34,14 +39,14 @@ fn main() -> Result<()> {
                 anyhow::bail!("Usage: heidic_v2 compile <file>");
             }
             let file_path = &args[2];
-            compile_file(file_path)?;
+            compile_file(file_path, profile)?;
         }
         "run" => {
             if args.len() < 3 {
                 anyhow::bail!("Usage: heidic_v2 run <file>");
             }
             let file_path = &args[2];
-            compile_and_run(file_path)?;
+            compile_and_run(file_path, profile)?;
         }
         _ => {
             anyhow::bail!("Unknown command: {}. Use 'compile' or 'run'", command);
@@ -51,7 +56,7 @@ fn main() -> Result<()> {
     Ok(())
 }
 
-fn compile_file(file_path: &str) -> Result<()> {
+fn compile_file(file_path: &str, profile: bool) -> Result<()> {
     let source = fs::read_to_string(file_path)
         .with_context(|| format!("Failed to read file: {}", file_path))?;
     
@@ -75,6 +80,8 @@ fn compile_file(file_path: &str) -> Result<()> {
     
     // Code generation
     let mut codegen = CodeGenerator::new();
+    codegen.set_system_access(type_checker.get_system_access().clone());
+    codegen.set_profile_systems(profile);
     let cpp_code = codegen.generate(&ast)?;
     
     // Write output in the same directory as the source file
@@ -88,14 +95,19 @@ fn compile_file(file_path: &str) -> Result<()> {
             .unwrap_or_else(|| "output.cpp".to_string())
     );
     
-    fs::write(&output_path, cpp_code)
+    let changed = write_if_changed(&output_path, &cpp_code)
         .with_context(|| format!("Failed to write output file: {}", output_path.display()))?;
     
-    println!("Compiled {} to {}", file_path, output_path.display());
+    if changed {
+        println!("Compiled {} to {}", file_path, output_path.display());
+    } else {
+        println!("Compiled {} ({} unchanged, not rewritten)", file_path, output_path.display());
+    }
     
     // Generate DLL files for hot-reloadable systems
     let hot_systems = codegen.get_hot_systems();
-    if !hot_systems.is_empty() {
+    let has_hot_systems = !hot_systems.is_empty();
+    if has_hot_systems {
         println!("\nGenerating hot-reloadable system DLLs...");
         let hot_systems_clone = hot_systems.clone();
         for system in hot_systems_clone {
@@ -103,24 +115,47 @@ fn compile_file(file_path: &str) -> Result<()> {
             let dll_name = format!("{}_hot.dll.cpp", system.name.to_lowercase());
             let dll_path = source_dir.join(&dll_name);
             
-            fs::write(&dll_path, dll_cpp)
+            write_if_changed(&dll_path, &dll_cpp)
                 .with_context(|| format!("Failed to write DLL file: {}", dll_path.display()))?;
             
             println!("  Generated: {}", dll_path.display());
             println!("  Compile DLL with: g++ -std=c++17 -shared -o {}.dll {} -Wl,--out-implib,{}.a", 
                      system.name.to_lowercase(), dll_path.display(), system.name.to_lowercase());
+            println!("  (Linux/macOS: g++ -std=c++17 -shared -fPIC -o {}.so {}, or {}.dylib on macOS)",
+                     system.name.to_lowercase(), dll_path.display(), system.name.to_lowercase());
         }
     }
     
     let exe_name = source_path.file_stem().unwrap().to_str().unwrap();
     println!("\nCompile main with: g++ -std=c++17 -O3 {} -o {}", 
              output_path.display(), exe_name);
+    if has_hot_systems {
+        println!("  (add -ldl -pthread on Linux for the hot-reload loader)");
+    }
+    if codegen.uses_cuda() {
+        println!("  (@[cuda]/@[launch] code: nvcc -std=c++17 -O3 -x cu {} -o {}, plus -DEDEN_CUDA_VULKAN_INTEROP for Vulkan buffer sharing)",
+                 output_path.display(), exe_name);
+    }
+    println!("  (release: add -march=native -flto=auto; PGO: build with -fprofile-generate, run, rebuild with -fprofile-use)");
     
     Ok(())
 }
 
-fn compile_and_run(file_path: &str) -> Result<()> {
-    compile_file(file_path)?;
+// Leave the file (and its mtime) alone when the generated code is identical,
+// so incremental builds skip recompiling translation units whose HEIDIC
+// source didn't change. Returns whether the file was written.
+fn write_if_changed(path: &Path, content: &str) -> Result<bool> {
+    if let Ok(existing) = fs::read(path) {
+        if existing == content.as_bytes() {
+            return Ok(false);
+        }
+    }
+    fs::write(path, content)?;
+    Ok(true)
+}
+
+fn compile_and_run(file_path: &str, profile: bool) -> Result<()> {
+    compile_file(file_path, profile)?;
     
     let exe_name = Path::new(file_path)
         .file_stem()
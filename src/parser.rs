@@ -232,6 +232,16 @@ impl Parser {
         attrs
     }
     
+    // Parse: for <iterator> in <collection> { ... }
+    fn parse_for(&mut self, parallel: bool, stmt_location: SourceLocation) -> Result<Statement> {
+        self.expect(&Token::For)?;
+        let iterator = self.expect_ident()?;
+        self.expect(&Token::In)?;
+        let collection = self.parse_expression()?;
+        let body = self.parse_block()?;
+        Ok(Statement::For { iterator, collection, body, parallel, location: stmt_location })
+    }
+    
     fn parse_component(&mut self, is_soa: bool, is_hot: bool) -> Result<ComponentDef> {
         let name = self.expect_ident()?;
         self.expect(&Token::LBrace)?;
@@ -829,6 +839,29 @@ impl Parser {
     
     fn parse_statement(&mut self) -> Result<Statement> {
         let stmt_location = self.current_token_location();
+        
+        // Statement attributes: only @[parallel] on query loops for now
+        if self.check(&Token::At) {
+            let attrs = self.parse_attributes();
+            if !attrs.is_empty() {
+                if !self.check(&Token::For) {
+                    self.report_parse_error(
+                        format!("Attributes {:?} are not allowed on this statement", attrs),
+                        Some("@[parallel] goes before a query loop: @[parallel] for e in q { ... }".to_string()),
+                    );
+                    bail!("Unexpected statement attribute");
+                }
+                if let Some(attr) = attrs.iter().find(|a| a.as_str() != "parallel") {
+                    self.report_parse_error(
+                        format!("Unknown loop attribute '{}'", attr),
+                        Some("Query loops accept @[parallel]".to_string()),
+                    );
+                    bail!("Unknown loop attribute");
+                }
+                return self.parse_for(true, stmt_location);
+            }
+        }
+        
         match self.peek() {
             Token::Let => {
                 self.advance();
@@ -883,15 +916,7 @@ impl Parser {
                 let body = self.parse_block()?;
                 Ok(Statement::While { condition, body, location: stmt_location })
             }
-            Token::For => {
-                // Parse: for <iterator> in <collection> { ... }
-                self.advance();
-                let iterator = self.expect_ident()?;
-                self.expect(&Token::In)?;
-                let collection = self.parse_expression()?;
-                let body = self.parse_block()?;
-                Ok(Statement::For { iterator, collection, body, location: stmt_location })
-            }
+            Token::For => self.parse_for(false, stmt_location),
             Token::Loop => {
                 self.advance();
                 let body = self.parse_block()?;
@@ -1201,11 +1226,27 @@ impl Parser {
                 let dot_location = self.current_token_location();
                 self.advance();
                 let member = self.expect_ident()?;
-                expr = Expression::MemberAccess {
-                    object: Box::new(expr),
-                    member,
-                    location: dot_location,
-                };
+                if member == "alloc_array" && self.check(&Token::Lt) {
+                    // arena.alloc_array<T>(count)
+                    self.advance();
+                    let element_type = self.parse_type()?;
+                    self.expect(&Token::Gt)?;
+                    self.expect(&Token::LParen)?;
+                    let count = self.parse_expression()?;
+                    self.expect(&Token::RParen)?;
+                    expr = Expression::FrameAlloc {
+                        arena: Box::new(expr),
+                        element_type,
+                        count: Box::new(count),
+                        location: dot_location,
+                    };
+                } else {
+                    expr = Expression::MemberAccess {
+                        object: Box::new(expr),
+                        member,
+                        location: dot_location,
+                    };
+                }
             } else if self.check(&Token::LBracket) {
                 let bracket_location = self.current_token_location();
                 self.advance();
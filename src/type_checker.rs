@@ -61,6 +61,7 @@ pub struct TypeChecker {
     // Track ALL variable declarations for better scope error messages
     all_declared_vars: HashMap<String, SourceLocation>,  // Variable name -> declaration location
     current_scope_depth: usize,  // Track nesting level for scope-aware errors
+    system_access: Vec<SystemAccessInfo>,  // Per system function with query parameters
 }
 
 impl TypeChecker {
@@ -75,9 +76,14 @@ impl TypeChecker {
             frame_scoped_vars: std::collections::HashSet::new(),
             all_declared_vars: HashMap::new(),
             current_scope_depth: 0,
+            system_access: Vec::new(),
         }
     }
     
+    pub fn get_system_access(&self) -> &Vec<SystemAccessInfo> {
+        &self.system_access
+    }
+    
     pub fn set_error_reporter(&mut self, reporter: ErrorReporter) {
         self.error_reporter = Some(reporter);
     }
@@ -327,10 +333,16 @@ impl TypeChecker {
             match item {
                 Item::Function(f) => {
                     self.check_function(f)?;
+                    if f.cuda_kernel.is_some() {
+                        self.check_cuda_kernel(f);
+                    }
                 }
                 Item::System(s) => {
                     for func in &s.functions {
                         self.check_function(func)?;
+                        if let Some(access) = Self::system_access_of(func) {
+                            self.system_access.push(access);
+                        }
                     }
                 }
                 Item::Resource(_) => {
@@ -587,7 +599,7 @@ impl TypeChecker {
                     }
                 }
             }
-            Statement::For { iterator, collection, body, location } => {
+            Statement::For { iterator, collection, body, parallel, location } => {
                 // Check that collection is a query type
                 let collection_type = match self.check_expression(collection) {
                     Ok(ty) => ty,
@@ -610,6 +622,11 @@ impl TypeChecker {
                     
                     // Remove iterator from scope after loop
                     self.symbols.remove(iterator);
+                    
+                    if *parallel {
+                        let mut locals = std::collections::HashSet::new();
+                        self.check_parallel_body(iterator, body, &mut locals, false);
+                    }
                 } else if !matches!(collection_type, Type::Error) {
                     // Only report error if collection type is not Error (Error already reported)
                     self.report_error(
@@ -674,6 +691,180 @@ impl TypeChecker {
         Ok(())
     }
     
+    // @[parallel] loop bodies run concurrently for different entities, so
+    // they may only write the loop entity's components and their own locals.
+    // Calls are not followed: a function that writes globals still races.
+    fn check_parallel_body(&mut self, iterator: &str, body: &[Statement], locals: &mut std::collections::HashSet<String>, in_inner_loop: bool) {
+        for stmt in body {
+            match stmt {
+                Statement::Let { name, .. } => {
+                    locals.insert(name.clone());
+                }
+                Statement::Assign { target, location, .. } => {
+                    if let Some(root) = Self::assignment_root(target) {
+                        if root != iterator && !locals.contains(root) {
+                            self.report_error(
+                                *location,
+                                format!("@[parallel] query loop writes shared variable '{}': iterations run concurrently", root),
+                                Some(format!("Only '{}.<Component>.<field>' and variables declared inside the loop can be assigned; accumulate into a component or drop @[parallel]", iterator)),
+                            );
+                        }
+                    }
+                }
+                Statement::If { then_block, else_block, .. } => {
+                    self.check_parallel_body(iterator, then_block, &mut locals.clone(), in_inner_loop);
+                    if let Some(else_block) = else_block {
+                        self.check_parallel_body(iterator, else_block, &mut locals.clone(), in_inner_loop);
+                    }
+                }
+                Statement::Block(stmts, _) => {
+                    self.check_parallel_body(iterator, stmts, &mut locals.clone(), in_inner_loop);
+                }
+                Statement::While { body, .. } | Statement::Loop { body, .. } | Statement::For { body, .. } => {
+                    // A nested query's entities are shared between iterations, so
+                    // its iterator is not added to the locals
+                    self.check_parallel_body(iterator, body, &mut locals.clone(), true);
+                }
+                Statement::Return(_, location) => {
+                    self.report_error(
+                        *location,
+                        "Cannot return from inside a @[parallel] query loop".to_string(),
+                        Some("Compute the result after the loop, or drop @[parallel]".to_string()),
+                    );
+                }
+                Statement::Break(location) if !in_inner_loop => {
+                    self.report_error(
+                        *location,
+                        "Cannot break out of a @[parallel] query loop: other iterations may already be running".to_string(),
+                        Some("Use 'continue' to skip an entity, or drop @[parallel]".to_string()),
+                    );
+                }
+                _ => {}
+            }
+        }
+    }
+    
+    // A @[launch] kernel gets raw device columns, so every component it
+    // queries must be a @[cuda] component_soa of plain-data arrays
+    fn check_cuda_kernel(&mut self, func: &FunctionDef) {
+        for param in &func.params {
+            let Type::Query(types) = &param.ty else { continue };
+            // Point at the loop over this query when there is one
+            let location = func.body.iter().find_map(|stmt| match stmt {
+                Statement::For { collection: Expression::Variable(name, _), location, .. } if *name == param.name => Some(*location),
+                _ => None,
+            }).unwrap_or_else(SourceLocation::unknown);
+            for ty in types {
+                let (Type::Struct(name) | Type::Component(name)) = ty else { continue };
+                let Some(component) = self.components.get(name).cloned() else { continue };
+                let plain = component.fields.iter().all(|field| matches!(&field.ty, Type::Array(element)
+                    if matches!(element.as_ref(), Type::I32 | Type::I64 | Type::F32 | Type::F64 | Type::Bool
+                        | Type::Vec2 | Type::Vec3 | Type::Vec4 | Type::Mat4)));
+                if !component.is_cuda || !component.is_soa || !plain {
+                    self.report_error(
+                        location,
+                        format!("@[launch] function '{}' queries '{}', which is not a @[cuda] component_soa of number/vector arrays",
+                                func.name, name),
+                        Some(format!("Declare it as '@[cuda] component_soa {} {{ ... }}' with [f32]-style fields", name)),
+                    );
+                }
+            }
+        }
+    }
+    
+    // Reads/writes of a system function's query components, or None if it
+    // takes no query
+    fn system_access_of(func: &FunctionDef) -> Option<SystemAccessInfo> {
+        let mut queries: HashMap<String, Vec<String>> = HashMap::new();
+        for param in &func.params {
+            if let Type::Query(types) = &param.ty {
+                let names = types.iter().filter_map(|ty| match ty {
+                    Type::Struct(name) | Type::Component(name) => Some(name.clone()),
+                    _ => None,
+                }).collect();
+                queries.insert(param.name.clone(), names);
+            }
+        }
+        if queries.is_empty() {
+            return None;
+        }
+        
+        let mut writes = Vec::new();
+        Self::collect_query_writes(&func.body, &queries, &mut HashMap::new(), &mut writes);
+        let mut reads = Vec::new();
+        for names in queries.values() {
+            for name in names {
+                if !writes.contains(name) && !reads.contains(name) {
+                    reads.push(name.clone());
+                }
+            }
+        }
+        reads.sort();
+        writes.sort();
+        Some(SystemAccessInfo { function: func.name.clone(), reads, writes })
+    }
+    
+    // iterators: loop variable -> its query's components
+    fn collect_query_writes(stmts: &[Statement], queries: &HashMap<String, Vec<String>>,
+                            iterators: &mut HashMap<String, Vec<String>>, writes: &mut Vec<String>) {
+        for stmt in stmts {
+            match stmt {
+                Statement::Assign { target, .. } => {
+                    if let Some(component) = Self::written_component(target, iterators) {
+                        if !writes.contains(&component) {
+                            writes.push(component);
+                        }
+                    }
+                }
+                Statement::For { iterator, collection, body, .. } => {
+                    let mut inner = iterators.clone();
+                    if let Expression::Variable(name, _) = collection {
+                        if let Some(components) = queries.get(name) {
+                            inner.insert(iterator.clone(), components.clone());
+                        }
+                    }
+                    Self::collect_query_writes(body, queries, &mut inner, writes);
+                }
+                Statement::If { then_block, else_block, .. } => {
+                    Self::collect_query_writes(then_block, queries, iterators, writes);
+                    if let Some(else_block) = else_block {
+                        Self::collect_query_writes(else_block, queries, iterators, writes);
+                    }
+                }
+                Statement::While { body, .. } | Statement::Loop { body, .. } | Statement::Block(body, _) => {
+                    Self::collect_query_writes(body, queries, iterators, writes);
+                }
+                _ => {}
+            }
+        }
+    }
+    
+    // entity.Component.field (maybe indexed) -> Component, for query iterators
+    fn written_component(target: &Expression, iterators: &HashMap<String, Vec<String>>) -> Option<String> {
+        match target {
+            Expression::MemberAccess { object, member, .. } => {
+                if let Expression::Variable(name, _) = object.as_ref() {
+                    if let Some(components) = iterators.get(name) {
+                        return components.iter().find(|c| *c == member).cloned();
+                    }
+                }
+                Self::written_component(object, iterators)
+            }
+            Expression::Index { array, .. } => Self::written_component(array, iterators),
+            _ => None,
+        }
+    }
+    
+    // Variable an assignment target writes through: a.b[i].c -> a
+    fn assignment_root(target: &Expression) -> Option<&str> {
+        match target {
+            Expression::Variable(name, _) => Some(name.as_str()),
+            Expression::MemberAccess { object, .. } => Self::assignment_root(object),
+            Expression::Index { array, .. } => Self::assignment_root(array),
+            _ => None,
+        }
+    }
+    
     fn validate_shader_stage(&mut self, shader: &ShaderDef) -> Result<()> {
         use crate::ast::ShaderStage;
         
@@ -951,6 +1142,19 @@ impl TypeChecker {
                     return Ok(Type::Void);
                 }
                 
+                // This thread's FrameArena (reset at the top of every frame)
+                if name == "frame_arena" {
+                    if !args.is_empty() {
+                        self.report_error(
+                            *location,
+                            format!("frame_arena() takes no arguments, got {}", args.len()),
+                            Some("Use: let frame = frame_arena();".to_string()),
+                        );
+                        return Ok(Type::Error);
+                    }
+                    return Ok(Type::Struct("FrameArena".to_string()));
+                }
+                
                 // Handle GLFW built-in functions
                 let glfw_result = match name.as_str() {
                     "glfwInit" => {
@@ -1185,6 +1389,27 @@ impl TypeChecker {
                     }
                 }
             }
+            Expression::FrameAlloc { arena, element_type, count, location } => {
+                let arena_type = self.check_expression(arena)?;
+                let count_type = self.check_expression(count)?;
+                if !matches!(arena_type, Type::Error) && !matches!(&arena_type, Type::Struct(name) if name == "FrameArena") {
+                    self.report_error(
+                        *location,
+                        format!("alloc_array requires a FrameArena, got '{}'", self.type_to_string(&arena_type)),
+                        Some("Take the arena as a parameter (frame: FrameArena) or use frame_arena()".to_string()),
+                    );
+                    return Ok(Type::Error);
+                }
+                if !matches!(count_type, Type::I32 | Type::I64 | Type::Error) {
+                    self.report_error(
+                        count.location(),
+                        format!("alloc_array count must be an integer, got '{}'", self.type_to_string(&count_type)),
+                        Some("Use an i32 or i64 element count: frame.alloc_array<T>(n)".to_string()),
+                    );
+                    return Ok(Type::Error);
+                }
+                Ok(Type::Array(Box::new(element_type.clone())))
+            }
             Expression::ArrayLiteral { elements, location } => {
                 if elements.is_empty() {
                     // Empty array - cannot infer type, require explicit type annotation
@@ -1334,6 +1559,7 @@ impl TypeChecker {
     /// Check if an expression is a frame-scoped allocation (frame.alloc_array call)
     fn is_frame_alloc_expression(&self, expr: &Expression) -> bool {
         match expr {
+            Expression::FrameAlloc { .. } => true,
             Expression::MemberAccess { object, member, .. } => {
                 // Check if this is frame.alloc_array
                 if member == "alloc_array" {
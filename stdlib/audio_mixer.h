@@ -0,0 +1,605 @@
+// EDEN ENGINE - AudioMixer
+// One shared output stream for every AudioResource: a voice pool mixed in
+// float on SDL's audio thread, and a decoder thread that keeps streamed
+// (long OGG) voices' ring buffers full
+
+#ifndef EDEN_AUDIO_MIXER_H
+#define EDEN_AUDIO_MIXER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Declarations only; audio_resource.h compiles the implementation
+#define STB_VORBIS_HEADER_ONLY
+#include "stb_vorbis.h"
+#include "vfs.h"
+#undef STB_VORBIS_HEADER_ONLY
+
+#ifdef __has_include
+    #if __has_include(<SDL3/SDL.h>)
+        #include <SDL3/SDL.h>
+        #include <SDL3/SDL_audio.h>
+        #define SDL3_AUDIO_AVAILABLE
+    #endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EDEN_AUDIO_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EDEN_AUDIO_NEON 1
+#endif
+
+/**
+ * AudioClip - Fully decoded PCM (interleaved 16-bit, mono or stereo)
+ */
+struct AudioClip {
+    std::vector<int16_t> samples;
+    uint32_t channels = 0;
+    uint32_t sampleRate = 0;
+
+    size_t frameCount() const { return channels ? samples.size() / channels : 0; }
+};
+
+namespace audio_detail {
+
+// out[i] += in[i] * gain, gain ramping linearly from g0 to g1 across the
+// block (per frame, so both channels of a frame share one gain).
+// Interleaved stereo, `frames` frames.
+inline void mixAddRamp(float* out, const float* in, size_t frames, float g0, float g1) {
+    float step = frames ? (g1 - g0) / static_cast<float>(frames) : 0.0f;
+    size_t frame = 0;
+#if defined(EDEN_AUDIO_SSE2)
+    // Two stereo frames per vector: gains {g, g, g + step, g + step}
+    __m128 gain = _mm_setr_ps(g0, g0, g0 + step, g0 + step);
+    const __m128 advance = _mm_set1_ps(2.0f * step);
+    for (; frame + 2 <= frames; frame += 2) {
+        __m128 acc = _mm_loadu_ps(out + frame * 2);
+        __m128 src = _mm_loadu_ps(in + frame * 2);
+        _mm_storeu_ps(out + frame * 2, _mm_add_ps(acc, _mm_mul_ps(src, gain)));
+        gain = _mm_add_ps(gain, advance);
+    }
+#elif defined(EDEN_AUDIO_NEON)
+    float start[4] = {g0, g0, g0 + step, g0 + step};
+    float32x4_t gain = vld1q_f32(start);
+    const float32x4_t advance = vdupq_n_f32(2.0f * step);
+    for (; frame + 2 <= frames; frame += 2) {
+        float32x4_t acc = vld1q_f32(out + frame * 2);
+        float32x4_t src = vld1q_f32(in + frame * 2);
+        vst1q_f32(out + frame * 2, vmlaq_f32(acc, src, gain));
+        gain = vaddq_f32(gain, advance);
+    }
+#endif
+    for (; frame < frames; frame++) {
+        float g = g0 + step * static_cast<float>(frame);
+        out[frame * 2] += in[frame * 2] * g;
+        out[frame * 2 + 1] += in[frame * 2 + 1] * g;
+    }
+}
+
+// buffer[i] = clamp(buffer[i] * gain, -1, 1)
+inline void scaleClamp(float* buffer, size_t count, float gain) {
+    size_t i = 0;
+#if defined(EDEN_AUDIO_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(buffer + i), g);
+        _mm_storeu_ps(buffer + i, _mm_min_ps(_mm_max_ps(v, lo), hi));
+    }
+#elif defined(EDEN_AUDIO_NEON)
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vmulq_n_f32(vld1q_f32(buffer + i), gain);
+        vst1q_f32(buffer + i, vminq_f32(vmaxq_f32(v, lo), hi));
+    }
+#endif
+    for (; i < count; i++) buffer[i] = std::min(1.0f, std::max(-1.0f, buffer[i] * gain));
+}
+
+/**
+ * Streamed OGG decode for one voice: the decoder thread writes float frames
+ * into a single-producer/single-consumer ring, the mixer reads them
+ */
+class StreamDecoder {
+public:
+    static constexpr size_t RING_FRAMES = 32768;    // ~0.7 s at 48 kHz
+    static constexpr size_t DECODE_FRAMES = 4096;   // Per decoder pass
+
+    ~StreamDecoder() {
+        if (m_vorbis) stb_vorbis_close(m_vorbis);
+    }
+
+    bool open(const std::string& path, bool loop) {
+        if (!Vfs::shared().open(path, m_file)) return false;
+        int error = 0;
+        m_vorbis = stb_vorbis_open_memory(m_file.bytes(), static_cast<int>(m_file.size()), &error, nullptr);
+        if (!m_vorbis) return false;
+        stb_vorbis_info info = stb_vorbis_get_info(m_vorbis);
+        m_channels = info.channels >= 2 ? 2u : 1u;
+        m_sampleRate = info.sample_rate;
+        m_loop = loop;
+        m_ring.assign(RING_FRAMES * m_channels, 0.0f);
+        decode();   // Prime the ring so the first mix doesn't underrun
+        return true;
+    }
+
+    // Decoder thread: top the ring up by at most DECODE_FRAMES
+    // @return true if anything was decoded
+    bool decode() {
+        if (m_ended.load(std::memory_order_relaxed)) return false;
+        size_t read = m_readFrame.load(std::memory_order_acquire);
+        size_t write = m_writeFrame.load(std::memory_order_relaxed);
+        size_t space = RING_FRAMES - (write - read);
+        if (space < DECODE_FRAMES / 4) return false;
+        size_t wanted = std::min(space, DECODE_FRAMES);
+        m_scratch.resize(wanted * m_channels);
+
+        size_t got = 0;
+        bool rewound = false;
+        bool ended = false;
+        while (got < wanted) {
+            int frames = stb_vorbis_get_samples_float_interleaved(
+                m_vorbis, static_cast<int>(m_channels), m_scratch.data() + got * m_channels,
+                static_cast<int>((wanted - got) * m_channels));
+            if (frames > 0) {
+                got += static_cast<size_t>(frames);
+                rewound = false;
+                continue;
+            }
+            // End of stream (a second empty read right after a rewind means
+            // the file has no audio at all)
+            if (!m_loop || rewound || !stb_vorbis_seek_start(m_vorbis)) {
+                ended = true;
+                break;
+            }
+            rewound = true;
+        }
+
+        for (size_t i = 0; i < got; i++) {
+            float* dst = &m_ring[((write + i) % RING_FRAMES) * m_channels];
+            std::memcpy(dst, &m_scratch[i * m_channels], m_channels * sizeof(float));
+        }
+        m_writeFrame.store(write + got, std::memory_order_release);
+        if (ended) m_ended.store(true, std::memory_order_release);
+        return got > 0;
+    }
+
+    // Mixer thread: next frame, false on underrun or end
+    bool pop(float& left, float& right) {
+        size_t read = m_readFrame.load(std::memory_order_relaxed);
+        if (read == m_writeFrame.load(std::memory_order_acquire)) return false;
+        const float* src = &m_ring[(read % RING_FRAMES) * m_channels];
+        left = src[0];
+        right = m_channels == 2 ? src[1] : src[0];
+        m_readFrame.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Decoder hit the end and the mixer drained everything it wrote
+    bool finished() const {
+        return m_ended.load(std::memory_order_acquire) &&
+               m_readFrame.load(std::memory_order_relaxed) == m_writeFrame.load(std::memory_order_acquire);
+    }
+
+    uint32_t sampleRate() const { return m_sampleRate; }
+
+private:
+    VfsFile m_file;     // The compressed stream m_vorbis pulls from
+    stb_vorbis* m_vorbis = nullptr;
+    uint32_t m_channels = 1;
+    uint32_t m_sampleRate = 0;
+    bool m_loop = false;
+    std::vector<float> m_ring;              // RING_FRAMES * channels
+    std::vector<float> m_scratch;           // Decoder thread only
+    std::atomic<size_t> m_readFrame{0};     // Monotonic; mixer writes
+    std::atomic<size_t> m_writeFrame{0};    // Monotonic; decoder writes
+    std::atomic<bool> m_ended{false};
+};
+
+} // namespace audio_detail
+
+/**
+ * AudioMixer - Shared voice pool and output stream
+ *
+ * Every voice plays either an AudioClip (fully decoded, shared between
+ * voices) or a streamed OGG file (each voice gets its own decoder and ring
+ * buffer). Voices are resampled with linear interpolation by
+ * pitch * sourceRate / OUTPUT_RATE, scaled by their gain (ramped over a
+ * block, so changes don't click) and summed into one float stereo buffer,
+ * which SDL converts to the device format. Accumulation and the final
+ * clamp are SSE2 / NEON, scalar elsewhere.
+ *
+ * Voice state is only touched with the output stream locked
+ * (SDL_LockAudioStream), which is also held while SDL runs the mix
+ * callback. Finished voices are reclaimed on the calling thread, so the
+ * audio thread never frees memory. When the pool is full, play() takes
+ * over the oldest non-looping voice.
+ *
+ * The device opens on the first play(); without SDL3 play() returns 0.
+ *
+ * Usage:
+ *   auto clip = std::make_shared<AudioClip>(...);
+ *   AudioMixer::VoiceId voice = AudioMixer::shared().play(clip, false, 0.8f);
+ *   AudioMixer::shared().setPitch(voice, 1.2f);
+ *   AudioMixer::shared().stop(voice);
+ */
+class AudioMixer {
+public:
+    using VoiceId = uint32_t;                   // 0 = no voice
+    static constexpr uint32_t MAX_VOICES = 32;
+    static constexpr uint32_t OUTPUT_RATE = 48000;
+    static constexpr size_t MIX_BLOCK_FRAMES = 512;
+
+    /**
+     * Never destroyed: AudioResources live in static storage and may be
+     * torn down after any function-local static. Call shutdown() to close
+     * the device early.
+     */
+    static AudioMixer& shared() {
+        static AudioMixer* mixer = new AudioMixer();
+        return *mixer;
+    }
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    /**
+     * Start a voice playing a decoded clip
+     * @return Voice handle, 0 on failure
+     */
+    VoiceId play(const std::shared_ptr<const AudioClip>& clip, bool loop = false,
+                 float gain = 1.0f, float pitch = 1.0f) {
+        if (!clip || clip->frameCount() == 0 || clip->sampleRate == 0) return 0;
+        return startVoice(clip, nullptr, loop, gain, pitch);
+    }
+
+    /**
+     * Start a voice streaming an OGG file from disk
+     * @return Voice handle, 0 on failure
+     */
+    VoiceId playStream(const std::string& path, bool loop = false, float gain = 1.0f, float pitch = 1.0f) {
+        auto stream = std::make_shared<audio_detail::StreamDecoder>();
+        if (!stream->open(path, loop)) {
+            std::cerr << "[Audio] Failed to open OGG stream: " << path << std::endl;
+            return 0;
+        }
+        VoiceId id = startVoice(nullptr, stream, loop, gain, pitch);
+        if (id) startDecoder(stream);
+        return id;
+    }
+
+    void stop(VoiceId id) {
+        StreamLock lock(*this);
+        if (Voice* voice = find(id)) voice->stopping = true;
+    }
+
+    void setGain(VoiceId id, float gain) {
+        StreamLock lock(*this);
+        if (Voice* voice = find(id)) voice->gain = std::max(0.0f, gain);
+    }
+
+    void setPitch(VoiceId id, float pitch) {
+        StreamLock lock(*this);
+        if (Voice* voice = find(id)) voice->pitch = std::max(0.01f, pitch);
+    }
+
+    bool isPlaying(VoiceId id) {
+        StreamLock lock(*this);
+        Voice* voice = find(id);
+        return voice && !voice->finished && !voice->stopping;
+    }
+
+    void setMasterGain(float gain) {
+        StreamLock lock(*this);
+        m_masterGain = std::max(0.0f, gain);
+    }
+
+    /**
+     * Close the device and stop the decoder thread; later play() calls
+     * reopen them
+     */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(m_decoderMutex);
+            m_decoderStopping = true;
+        }
+        m_decoderWake.notify_all();
+        if (m_decoderThread.joinable()) m_decoderThread.join();
+        {
+            std::lock_guard<std::mutex> lock(m_decoderMutex);
+            m_streams.clear();
+            m_decoderStopping = false;
+        }
+#ifdef SDL3_AUDIO_AVAILABLE
+        if (m_stream) {
+            SDL_DestroyAudioStream(m_stream);
+            m_stream = nullptr;
+        }
+#endif
+        for (Voice& voice : m_voices) release(voice);
+    }
+
+private:
+    struct Voice {
+        uint32_t generation = 0;
+        bool active = false;                        // Slot in use (until reclaimed)
+        bool finished = false;                      // Mixer is done with it
+        bool stopping = false;                      // stop() asked; mixer finishes it
+        bool loop = false;
+        float gain = 1.0f;
+        float pitch = 1.0f;
+        float appliedGain = 0.0f;                   // Gain at the end of the last block
+        uint64_t started = 0;
+        std::shared_ptr<const AudioClip> clip;
+        std::shared_ptr<audio_detail::StreamDecoder> stream;
+        // Mixer-side playback position
+        double position = 0.0;                      // Clip: frame index
+        double fraction = 2.0;                      // Stream: 0..1 between prev and next (2 = two frames to pull)
+        float prev[2] = {0.0f, 0.0f};
+        float next[2] = {0.0f, 0.0f};
+    };
+
+    // Scoped SDL_LockAudioStream (no-op before the device opens)
+    struct StreamLock {
+        explicit StreamLock(AudioMixer& mixer) : m_mixer(mixer) {
+#ifdef SDL3_AUDIO_AVAILABLE
+            if (m_mixer.m_stream) SDL_LockAudioStream(m_mixer.m_stream);
+#endif
+        }
+        ~StreamLock() {
+#ifdef SDL3_AUDIO_AVAILABLE
+            if (m_mixer.m_stream) SDL_UnlockAudioStream(m_mixer.m_stream);
+#endif
+        }
+        AudioMixer& m_mixer;
+    };
+
+    AudioMixer() : m_voices(MAX_VOICES) {}
+
+    bool openDevice() {
+#ifdef SDL3_AUDIO_AVAILABLE
+        if (m_stream) return true;
+        // SDL3 returns false on failure
+        if (!SDL_Init(SDL_INIT_AUDIO)) {
+            std::cerr << "[Audio] SDL_Init failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_AudioSpec spec;
+        spec.freq = static_cast<int>(OUTPUT_RATE);
+        spec.format = SDL_AUDIO_F32;
+        spec.channels = 2;
+        m_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, &AudioMixer::feed, this);
+        if (!m_stream) {
+            std::cerr << "[Audio] SDL_OpenAudioDeviceStream failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_ResumeAudioStreamDevice(m_stream);
+        return true;
+#else
+        std::cerr << "[Audio] SDL3_AUDIO_AVAILABLE not defined - SDL3 headers not found" << std::endl;
+        return false;
+#endif
+    }
+
+    VoiceId startVoice(std::shared_ptr<const AudioClip> clip, std::shared_ptr<audio_detail::StreamDecoder> stream,
+                       bool loop, float gain, float pitch) {
+        if (!openDevice()) return 0;
+        // Reclaimed clips and decoders are released after the lock drops
+        std::vector<Voice> reclaimed;
+        VoiceId id = 0;
+        {
+            StreamLock lock(*this);
+            Voice* slot = nullptr;
+            Voice* oldest = nullptr;
+            for (Voice& voice : m_voices) {
+                if (voice.active && voice.finished) {
+                    reclaimed.push_back(std::move(voice));
+                    release(voice);
+                }
+                if (!voice.active && !slot) slot = &voice;
+                if (voice.active && !voice.loop && (!oldest || voice.started < oldest->started)) oldest = &voice;
+            }
+            if (!slot && oldest) {
+                reclaimed.push_back(std::move(*oldest));
+                release(*oldest);
+                slot = oldest;
+            }
+            if (!slot) {
+                std::cerr << "[Audio] All " << MAX_VOICES << " voices are looping; not starting another" << std::endl;
+                return 0;
+            }
+
+            slot->generation = (slot->generation + 1) & 0xFFFFFFu;
+            if (slot->generation == 0) slot->generation = 1;
+            slot->active = true;
+            slot->loop = loop;
+            slot->gain = std::max(0.0f, gain);
+            slot->pitch = std::max(0.01f, pitch);
+            slot->appliedGain = slot->gain;
+            slot->started = ++m_sequence;
+            slot->clip = std::move(clip);
+            slot->stream = std::move(stream);
+            uint32_t index = static_cast<uint32_t>(slot - m_voices.data());
+            id = (slot->generation << 8) | index;
+        }
+        for (Voice& voice : reclaimed) dropStream(voice.stream);
+        return id;
+    }
+
+    // Back to a free slot; generation is kept so old handles stay invalid
+    static void release(Voice& voice) {
+        uint32_t generation = voice.generation;
+        voice = Voice();
+        voice.generation = generation;
+    }
+
+    Voice* find(VoiceId id) {
+        uint32_t index = id & 0xFFu;
+        if (id == 0 || index >= MAX_VOICES) return nullptr;
+        Voice& voice = m_voices[index];
+        return voice.active && voice.generation == (id >> 8) ? &voice : nullptr;
+    }
+
+    // ------------------------------------------------------------------------
+    // Decoder thread
+    // ------------------------------------------------------------------------
+
+    void startDecoder(const std::shared_ptr<audio_detail::StreamDecoder>& stream) {
+        {
+            std::lock_guard<std::mutex> lock(m_decoderMutex);
+            m_streams.push_back(stream);
+            if (!m_decoderThread.joinable()) m_decoderThread = std::thread([this]() { decoderLoop(); });
+        }
+        m_decoderWake.notify_one();
+    }
+
+    void dropStream(const std::shared_ptr<audio_detail::StreamDecoder>& stream) {
+        if (!stream) return;
+        std::lock_guard<std::mutex> lock(m_decoderMutex);
+        m_streams.erase(std::remove(m_streams.begin(), m_streams.end(), stream), m_streams.end());
+    }
+
+    void decoderLoop() {
+        std::vector<std::shared_ptr<audio_detail::StreamDecoder>> streams;
+        std::unique_lock<std::mutex> lock(m_decoderMutex);
+        while (!m_decoderStopping) {
+            streams = m_streams;
+            lock.unlock();
+            bool busy = false;
+            for (const auto& stream : streams) busy |= stream->decode();
+            streams.clear();    // Last reference to a dropped stream may go here
+            lock.lock();
+            // Rings hold ~0.7 s; a short nap keeps them topped up without spinning
+            if (!busy) m_decoderWake.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Mix (audio thread, stream locked)
+    // ------------------------------------------------------------------------
+
+#ifdef SDL3_AUDIO_AVAILABLE
+    static void SDLCALL feed(void* userdata, SDL_AudioStream* stream, int additionalAmount, int /*totalAmount*/) {
+        AudioMixer* mixer = static_cast<AudioMixer*>(userdata);
+        size_t frames = static_cast<size_t>(std::max(additionalAmount, 0)) / (2 * sizeof(float));
+        while (frames > 0) {
+            size_t block = std::min(frames, MIX_BLOCK_FRAMES);
+            mixer->mix(block);
+            SDL_PutAudioStreamData(stream, mixer->m_mixBuffer, static_cast<int>(block * 2 * sizeof(float)));
+            frames -= block;
+        }
+    }
+#endif
+
+    void mix(size_t frames) {
+        std::fill(m_mixBuffer, m_mixBuffer + frames * 2, 0.0f);
+        for (Voice& voice : m_voices) {
+            if (!voice.active || voice.finished) continue;
+            size_t rendered = voice.clip ? renderClip(voice, frames) : renderStream(voice, frames);
+            std::fill(m_voiceBuffer + rendered * 2, m_voiceBuffer + frames * 2, 0.0f);
+            // A stopped voice fades out over this block instead of clicking
+            float target = voice.stopping ? 0.0f : voice.gain;
+            audio_detail::mixAddRamp(m_mixBuffer, m_voiceBuffer, frames, voice.appliedGain, target);
+            voice.appliedGain = target;
+            if (voice.stopping) voice.finished = true;
+        }
+        audio_detail::scaleClamp(m_mixBuffer, frames * 2, m_masterGain);
+    }
+
+    // Resample a clip into m_voiceBuffer; returns frames written
+    size_t renderClip(Voice& voice, size_t frames) {
+        const AudioClip& clip = *voice.clip;
+        const int16_t* samples = clip.samples.data();
+        const size_t count = clip.frameCount();
+        const uint32_t channels = clip.channels;
+        const double step = voice.pitch * clip.sampleRate / static_cast<double>(OUTPUT_RATE);
+        const float scale = 1.0f / 32768.0f;
+        double position = voice.position;
+        size_t out = 0;
+        for (; out < frames; out++) {
+            if (position >= static_cast<double>(count)) {
+                if (!voice.loop) {
+                    voice.finished = true;
+                    break;
+                }
+                position = std::fmod(position, static_cast<double>(count));
+            }
+            size_t i0 = static_cast<size_t>(position);
+            size_t i1 = i0 + 1 < count ? i0 + 1 : (voice.loop ? 0 : i0);
+            float t = static_cast<float>(position - static_cast<double>(i0));
+            const int16_t* a = samples + i0 * channels;
+            const int16_t* b = samples + i1 * channels;
+            float left = (a[0] + (b[0] - a[0]) * t) * scale;
+            float right = channels == 2 ? (a[1] + (b[1] - a[1]) * t) * scale : left;
+            m_voiceBuffer[out * 2] = left;
+            m_voiceBuffer[out * 2 + 1] = right;
+            position += step;
+        }
+        voice.position = position;
+        return out;
+    }
+
+    // Resample a stream's ring into m_voiceBuffer; an underrun renders
+    // silence for the rest of the block but keeps the voice alive
+    size_t renderStream(Voice& voice, size_t frames) {
+        audio_detail::StreamDecoder& stream = *voice.stream;
+        const double step = voice.pitch * stream.sampleRate() / static_cast<double>(OUTPUT_RATE);
+        size_t out = 0;
+        for (; out < frames; out++) {
+            bool starved = false;
+            while (voice.fraction >= 1.0) {
+                voice.prev[0] = voice.next[0];
+                voice.prev[1] = voice.next[1];
+                if (!stream.pop(voice.next[0], voice.next[1])) {
+                    starved = true;
+                    break;
+                }
+                voice.fraction -= 1.0;
+            }
+            if (starved) {
+                if (stream.finished()) voice.finished = true;
+                break;
+            }
+            float t = static_cast<float>(voice.fraction);
+            m_voiceBuffer[out * 2] = voice.prev[0] + (voice.next[0] - voice.prev[0]) * t;
+            m_voiceBuffer[out * 2 + 1] = voice.prev[1] + (voice.next[1] - voice.prev[1]) * t;
+            voice.fraction += step;
+        }
+        return out;
+    }
+
+    std::vector<Voice> m_voices;
+    uint64_t m_sequence = 0;
+    float m_masterGain = 1.0f;
+    float m_mixBuffer[MIX_BLOCK_FRAMES * 2] = {};
+    float m_voiceBuffer[MIX_BLOCK_FRAMES * 2] = {};
+
+#ifdef SDL3_AUDIO_AVAILABLE
+    SDL_AudioStream* m_stream = nullptr;
+#else
+    void* m_stream = nullptr;
+#endif
+
+    std::mutex m_decoderMutex;
+    std::condition_variable m_decoderWake;
+    std::vector<std::shared_ptr<audio_detail::StreamDecoder>> m_streams;
+    std::thread m_decoderThread;
+    bool m_decoderStopping = false;
+};
+
+#endif // EDEN_AUDIO_MIXER_H
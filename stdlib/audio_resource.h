@@ -1,6 +1,6 @@
 // EDEN ENGINE - AudioResource Class
 // Unified audio loading: handles WAV (uncompressed) and OGG (compressed) audio files
-// Uses SDL3 audio for cross-platform audio playback
+// Plays through AudioMixer (one shared SDL3 output stream and voice pool)
 //
 // Supports two types:
 // - Sound: Short audio clips (effects, UI sounds) - loaded into memory
@@ -29,6 +29,9 @@
 // (don't define STB_VORBIS_NO_STDIO or STB_VORBIS_NO_INTEGER_CONVERSION)
 #include "stb_vorbis.h"
 
+#include "audio_mixer.h"
+#include "vfs.h"
+
 // SDL3 audio - check if SDL3 is available
 // Note: We check for SDL3 by trying to include it
 // The build system should add -I path for SDL3 if available
@@ -58,8 +61,14 @@ struct SDL_AudioSpec {
  * AudioResource - Unified audio loading and playback
  * 
  * Automatically detects format (WAV vs OGG) and loads appropriately.
- * - WAV: Loaded into memory (fast playback, good for short sounds)
- * - OGG: Streamed from disk (memory efficient, good for long music)
+ * - WAV: Decoded into memory (fast playback, good for short sounds)
+ * - OGG: Streamed from disk when longer than STREAM_MIN_SECONDS (each
+ *   playing voice decodes ahead into a small ring buffer); shorter OGG
+ *   clips are decoded into memory like WAV
+ * 
+ * Decoded clips are 16-bit mono or stereo and shared by every voice
+ * playing them. All resources play through AudioMixer::shared(), so
+ * simultaneous sounds cost mixer voices, not device streams.
  * 
  * Supports hot-reload: audio files can be reloaded at runtime.
  */
@@ -69,22 +78,25 @@ public:
         Sound,  // Short clips (effects) - loaded into memory
         Music   // Long tracks (background) - streamed
     };
+    
+    // Music shorter than this is decoded up front instead of streamed
+    static constexpr double STREAM_MIN_SECONDS = 10.0;
 
 private:
     std::string m_path;
     AudioType m_type;
     bool m_loaded = false;
     
-    // SDL3 audio data
-    SDL_AudioStream* m_audioStream = nullptr;
-    SDL_AudioDeviceID m_audioDevice = 0;
-    
-    // For Sound type (loaded into memory)
-    std::vector<uint8_t> m_audioData;
-    SDL_AudioSpec m_spec;
+    // Sound (and short Music): decoded PCM, shared with playing voices
+    std::shared_ptr<const AudioClip> m_clip;
+    // Music longer than STREAM_MIN_SECONDS: voices stream m_path
+    bool m_streamed = false;
+    SDL_AudioSpec m_spec{};
     
-    // For Music type (streamed)
-    // SDL3 handles streaming internally
+    // Voices started by this resource (finished ones are pruned lazily)
+    std::vector<AudioMixer::VoiceId> m_voices;
+    float m_gain = 1.0f;
+    float m_pitch = 1.0f;
     
     /**
      * Detect audio type from file extension
@@ -105,8 +117,25 @@ private:
         return AudioType::Sound;
     }
     
+    void setSpec(uint32_t sampleRate, uint32_t channels) {
+        m_spec.freq = static_cast<int>(sampleRate);
+        m_spec.channels = static_cast<decltype(m_spec.channels)>(channels);
+        
+        // Set format - SDL3 uses SDL_AudioFormat (typically uint16_t)
+        // Try to use SDL3 format constants, fallback to numeric value
+        #ifdef SDL_AUDIO_S16SYS
+            m_spec.format = SDL_AUDIO_S16SYS;
+        #elif defined(SDL_AUDIO_S16)
+            m_spec.format = SDL_AUDIO_S16;
+        #else
+            // Fallback: cast to SDL_AudioFormat type (0x8010 = AUDIO_S16SYS)
+            typedef decltype(m_spec.format) AudioFormatType;
+            m_spec.format = static_cast<AudioFormatType>(0x8010);
+        #endif
+    }
+    
     /**
-     * Load WAV file into memory
+     * Load WAV file into memory, converted to 16-bit mono/stereo
      * @param filepath Path to WAV file
      */
     void loadWAV(const std::string& filepath) {
@@ -115,17 +144,39 @@ private:
         uint8_t* audioBuffer = nullptr;
         uint32_t audioLength = 0;
         
-        if (!SDL_LoadWAV(filepath.c_str(), &spec, &audioBuffer, &audioLength)) {
+        VfsFile file;
+        if (!Vfs::shared().open(filepath, file)) {
+            throw std::runtime_error("Failed to load WAV file: " + filepath + " - cannot open file");
+        }
+        SDL_IOStream* io = SDL_IOFromConstMem(file.data(), file.size());
+        if (!io || !SDL_LoadWAV_IO(io, true, &spec, &audioBuffer, &audioLength)) {
             throw std::runtime_error("Failed to load WAV file: " + filepath + " - " + SDL_GetError());
         }
         
-        // Store audio data
-        m_audioData.assign(audioBuffer, audioBuffer + audioLength);
-        m_spec = spec;
-        
-        // Free SDL's buffer (we've copied the data)
+        // Convert to what the mixer reads (rate is kept; it resamples per voice)
+        SDL_AudioSpec target;
+        target.format = SDL_AUDIO_S16;
+        target.channels = spec.channels >= 2 ? 2 : 1;
+        target.freq = spec.freq;
+        uint8_t* converted = nullptr;
+        int convertedLength = 0;
+        bool ok = SDL_ConvertAudioSamples(&spec, audioBuffer, static_cast<int>(audioLength), &target,
+                                          &converted, &convertedLength);
+        // Free SDL's buffer (we've converted the data)
         SDL_free(audioBuffer);
+        if (!ok) {
+            throw std::runtime_error("Failed to convert WAV file: " + filepath + " - " + SDL_GetError());
+        }
+        
+        auto clip = std::make_shared<AudioClip>();
+        clip->channels = static_cast<uint32_t>(target.channels);
+        clip->sampleRate = static_cast<uint32_t>(target.freq);
+        clip->samples.resize(static_cast<size_t>(convertedLength) / sizeof(int16_t));
+        std::memcpy(clip->samples.data(), converted, clip->samples.size() * sizeof(int16_t));
+        SDL_free(converted);
         
+        setSpec(clip->sampleRate, clip->channels);
+        m_clip = std::move(clip);
         m_loaded = true;
 #else
         // Stub implementation when SDL3 is not available
@@ -136,70 +187,78 @@ private:
     }
     
     /**
-     * Load OGG file using stb_vorbis decoder
+     * Load OGG file using stb_vorbis: long Music is only probed here (voices
+     * stream it), anything else is decoded into memory
      * @param filepath Path to OGG file
      */
     void loadOGG(const std::string& filepath) {
-#ifdef SDL3_AUDIO_AVAILABLE
-        // Use stb_vorbis to decode OGG file
-        // Read file into memory first, then decode (more reliable than decode_filename)
-        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open OGG file: " + filepath);
+        VfsFile file;
+        if (!Vfs::shared().open(filepath, file)) {
+            throw std::runtime_error("Failed to open OGG file: " + filepath + " - cannot open file");
+        }
+        int error = 0;
+        stb_vorbis* vorbis = stb_vorbis_open_memory(file.bytes(), static_cast<int>(file.size()), &error, nullptr);
+        if (!vorbis) {
+            throw std::runtime_error("Failed to open OGG file: " + filepath + " (stb_vorbis error " +
+                                     std::to_string(error) + ")");
         }
         
-        std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
+        stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+        uint32_t channels = info.channels >= 2 ? 2u : 1u;
+        unsigned int frames = stb_vorbis_stream_length_in_samples(vorbis);
+        double seconds = info.sample_rate ? frames / static_cast<double>(info.sample_rate) : 0.0;
+        setSpec(info.sample_rate, channels);
         
-        std::vector<unsigned char> buffer(size);
-        if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) {
-            throw std::runtime_error("Failed to read OGG file: " + filepath);
+        if (m_type == AudioType::Music && seconds >= STREAM_MIN_SECONDS) {
+            stb_vorbis_close(vorbis);
+            m_streamed = true;
+            m_loaded = true;
+            return;
         }
-        file.close();
         
-        // Decode OGG from memory
-        int channels = 0;
-        int sample_rate = 0;
-        short* output = nullptr;
-        
-        int samples = stb_vorbis_decode_memory(buffer.data(), static_cast<int>(size), &channels, &sample_rate, &output);
+        // Decode everything, folded to mono/stereo - stb_vorbis returns
+        // interleaved samples: [L, R, L, R, ...] for stereo
+        auto clip = std::make_shared<AudioClip>();
+        clip->channels = channels;
+        clip->sampleRate = info.sample_rate;
+        clip->samples.resize(static_cast<size_t>(frames) * channels);
+        size_t decoded = 0;
+        while (decoded < frames) {
+            int got = stb_vorbis_get_samples_short_interleaved(
+                vorbis, static_cast<int>(channels), clip->samples.data() + decoded * channels,
+                static_cast<int>((frames - decoded) * channels));
+            if (got <= 0) break;
+            decoded += static_cast<size_t>(got);
+        }
+        stb_vorbis_close(vorbis);
+        clip->samples.resize(decoded * channels);
         
-        if (samples < 0 || !output) {
+        if (decoded == 0) {
             throw std::runtime_error("Failed to decode OGG file: " + filepath);
         }
-        
-        // Convert 16-bit shorts to bytes for SDL3
-        // stb_vorbis returns interleaved samples: [L, R, L, R, ...] for stereo
-        int total_samples = samples * channels;
-        m_audioData.resize(total_samples * sizeof(int16_t));
-        std::memcpy(m_audioData.data(), output, total_samples * sizeof(int16_t));
-        
-        // Free stb_vorbis's buffer
-        free(output);
-        
-        // Set up SDL audio spec
-        // SDL3's AudioSpec only has: freq, format, channels (no silence, samples, size)
-        m_spec.freq = sample_rate;
-        m_spec.channels = static_cast<uint8_t>(channels);
-        
-        // Set format - SDL3 uses SDL_AudioFormat (typically uint16_t)
-        // Try to use SDL3 format constants, fallback to numeric value
-        #ifdef SDL_AUDIO_S16SYS
-            m_spec.format = SDL_AUDIO_S16SYS;
-        #elif defined(SDL_AUDIO_S16)
-            m_spec.format = SDL_AUDIO_S16;
-        #else
-            // Fallback: cast to SDL_AudioFormat type (0x8010 = AUDIO_S16SYS)
-            typedef decltype(m_spec.format) AudioFormatType;
-            m_spec.format = static_cast<AudioFormatType>(0x8010);
-        #endif
-        
-        m_loaded = true;
-#else
-        // Stub implementation when SDL3 is not available
+        m_clip = std::move(clip);
         m_loaded = true;
-        m_spec = SDL_AudioSpec{};
-#endif
+    }
+    
+    void load() {
+        std::string ext = m_path.substr(m_path.find_last_of(".") + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        
+        if (ext == "wav") {
+            loadWAV(m_path);
+        } else if (ext == "ogg" || ext == "mp3") {
+            loadOGG(m_path);
+        } else {
+            throw std::runtime_error("Unsupported audio format: " + ext);
+        }
+    }
+    
+    // Drop handles of voices that have finished
+    void pruneVoices() {
+        AudioMixer& mixer = AudioMixer::shared();
+        m_voices.erase(std::remove_if(m_voices.begin(), m_voices.end(),
+                                      [&](AudioMixer::VoiceId id) { return !mixer.isPlaying(id); }),
+                       m_voices.end());
     }
 
 public:
@@ -210,18 +269,7 @@ public:
     explicit AudioResource(const std::string& filepath) 
         : m_path(filepath) {
         m_type = detectAudioType(filepath);
-        
-        // Load based on type
-        std::string ext = filepath.substr(filepath.find_last_of(".") + 1);
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-        
-        if (ext == "wav") {
-            loadWAV(filepath);
-        } else if (ext == "ogg" || ext == "mp3") {
-            loadOGG(filepath);
-        } else {
-            throw std::runtime_error("Unsupported audio format: " + ext);
-        }
+        load();
     }
     
     // Delete copy constructor and assignment
@@ -233,12 +281,14 @@ public:
         : m_path(std::move(other.m_path)),
           m_type(other.m_type),
           m_loaded(other.m_loaded),
-          m_audioStream(other.m_audioStream),
-          m_audioDevice(other.m_audioDevice),
-          m_audioData(std::move(other.m_audioData)),
-          m_spec(other.m_spec) {
-        other.m_audioStream = nullptr;
-        other.m_audioDevice = 0;
+          m_clip(std::move(other.m_clip)),
+          m_streamed(other.m_streamed),
+          m_spec(other.m_spec),
+          m_voices(std::move(other.m_voices)),
+          m_gain(other.m_gain),
+          m_pitch(other.m_pitch) {
+        other.m_voices.clear();
+        other.m_streamed = false;
         other.m_loaded = false;
     }
     
@@ -250,13 +300,15 @@ public:
             m_path = std::move(other.m_path);
             m_type = other.m_type;
             m_loaded = other.m_loaded;
-            m_audioStream = other.m_audioStream;
-            m_audioDevice = other.m_audioDevice;
-            m_audioData = std::move(other.m_audioData);
+            m_clip = std::move(other.m_clip);
+            m_streamed = other.m_streamed;
             m_spec = other.m_spec;
+            m_voices = std::move(other.m_voices);
+            m_gain = other.m_gain;
+            m_pitch = other.m_pitch;
             
-            other.m_audioStream = nullptr;
-            other.m_audioDevice = 0;
+            other.m_voices.clear();
+            other.m_streamed = false;
             other.m_loaded = false;
         }
         return *this;
@@ -270,99 +322,90 @@ public:
     }
     
     /**
-     * Cleanup audio resources
+     * Cleanup audio resources (stops this resource's voices; the mixer keeps
+     * the clip alive until they have faded out)
      */
     void cleanup() {
-#ifdef SDL3_AUDIO_AVAILABLE
-        if (m_audioStream) {
-            SDL_DestroyAudioStream(m_audioStream);
-            m_audioStream = nullptr;
-        }
-        if (m_audioDevice) {
-            SDL_CloseAudioDevice(m_audioDevice);
-            m_audioDevice = 0;
-        }
-#endif
-        m_audioData.clear();
+        stop();
+        m_clip.reset();
+        m_streamed = false;
         m_loaded = false;
     }
     
     /**
-     * Play the audio
+     * Play the audio, stopping any playback this resource started
      * @param loop Whether to loop the audio (default: false)
      * @return true if playback started successfully
      */
     bool play(bool loop = false) {
-#ifdef SDL3_AUDIO_AVAILABLE
-        if (!m_loaded || m_audioData.empty()) {
-            std::cerr << "[Audio] Not loaded or empty data" << std::endl;
-            return false;
-        }
-        
-        // Stop any existing playback
         stop();
-        
-        // Ensure SDL3 is initialized (SDL3 requires SDL_Init() before subsystems)
-        // SDL3 returns 0 on failure, non-zero on success (opposite of SDL2!)
-        // Note: SDL_Init can be called multiple times safely
-        if (SDL_Init(SDL_INIT_AUDIO) == 0) {
-            // Failed to initialize - SDL_GetError() will have details
-            std::cerr << "[Audio] SDL_Init failed: " << SDL_GetError() << std::endl;
-            return false;
-        }
-        
-        // SDL3 audio API: Use SDL_OpenAudioDeviceStream which combines device and stream creation
-        // This is the recommended way in SDL3
-        SDL_AudioStream* stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &m_spec, nullptr, nullptr);
-        if (!stream) {
-            // Stream creation failed
-            std::cerr << "[Audio] SDL_OpenAudioDeviceStream failed: " << SDL_GetError() << std::endl;
-            return false;
-        }
-        
-        // Queue the audio data
-        int result = SDL_PutAudioStreamData(stream, m_audioData.data(), static_cast<int>(m_audioData.size()));
-        if (result < 0) {
-            std::cerr << "[Audio] SDL_PutAudioStreamData failed: " << SDL_GetError() << std::endl;
-            SDL_DestroyAudioStream(stream);
-            return false;
+        return playOneShot(loop) != 0;
+    }
+    
+    /**
+     * Start another voice without stopping the ones already playing
+     * (overlapping sound effects)
+     * @param loop Whether to loop the audio
+     * @param gain Voice gain (multiplied by setGain())
+     * @param pitch Playback rate (multiplied by setPitch(); 2.0 = octave up)
+     * @return Mixer voice handle, 0 if nothing started
+     */
+    AudioMixer::VoiceId playOneShot(bool loop = false, float gain = 1.0f, float pitch = 1.0f) {
+        if (!m_loaded || (!m_clip && !m_streamed)) {
+            std::cerr << "[Audio] Not loaded or empty data" << std::endl;
+            return 0;
         }
-        
-        // Start playback - SDL3 uses SDL_ResumeAudioStreamDevice which takes the stream
-        SDL_ResumeAudioStreamDevice(stream);
-        
-        // Store references for cleanup
-        m_audioStream = stream;
-        m_audioDevice = 0;  // Device is managed by the stream
-        
-        return true;
-#else
-        // Stub: return false when SDL3 is not available
-        // This means SDL3 headers weren't found at compile time
-        std::cerr << "[Audio] SDL3_AUDIO_AVAILABLE not defined - SDL3 headers not found" << std::endl;
-        return false;
-#endif
+        pruneVoices();
+        AudioMixer& mixer = AudioMixer::shared();
+        AudioMixer::VoiceId voice = m_streamed
+            ? mixer.playStream(m_path, loop, m_gain * gain, m_pitch * pitch)
+            : mixer.play(m_clip, loop, m_gain * gain, m_pitch * pitch);
+        if (voice) m_voices.push_back(voice);
+        return voice;
     }
     
     /**
-     * Stop playback
+     * Stop playback (every voice this resource started)
      */
     void stop() {
-#ifdef SDL3_AUDIO_AVAILABLE
-        if (m_audioStream) {
-            // Pause the stream device
-            SDL_PauseAudioStreamDevice(m_audioStream);
-            // Destroy the stream (this also closes the associated device)
-            SDL_DestroyAudioStream(m_audioStream);
-            m_audioStream = nullptr;
-            m_audioDevice = 0;
-        }
-        // Also close device if we have it separately
-        if (m_audioDevice) {
-            SDL_CloseAudioDevice(m_audioDevice);
-            m_audioDevice = 0;
-        }
-#endif
+        if (m_voices.empty()) return;
+        AudioMixer& mixer = AudioMixer::shared();
+        for (AudioMixer::VoiceId voice : m_voices) mixer.stop(voice);
+        m_voices.clear();
+    }
+    
+    /**
+     * Check if any voice started by this resource is still playing
+     */
+    bool isPlaying() {
+        pruneVoices();
+        return !m_voices.empty();
+    }
+    
+    /**
+     * Gain for this resource's voices, applied to the ones playing now
+     */
+    void setGain(float gain) {
+        m_gain = std::max(0.0f, gain);
+        pruneVoices();
+        for (AudioMixer::VoiceId voice : m_voices) AudioMixer::shared().setGain(voice, m_gain);
+    }
+    
+    /**
+     * Playback rate for this resource's voices, applied to the ones playing now
+     */
+    void setPitch(float pitch) {
+        m_pitch = std::max(0.01f, pitch);
+        pruneVoices();
+        for (AudioMixer::VoiceId voice : m_voices) AudioMixer::shared().setPitch(voice, m_pitch);
+    }
+    
+    float getGain() const {
+        return m_gain;
+    }
+    
+    float getPitch() const {
+        return m_pitch;
     }
     
     /**
@@ -373,6 +416,13 @@ public:
         return m_loaded;
     }
     
+    /**
+     * Check if voices stream from disk instead of playing a decoded clip
+     */
+    bool isStreamed() const {
+        return m_streamed;
+    }
+    
     /**
      * Get audio file path
      * @return File path
@@ -390,15 +440,16 @@ public:
     }
     
     /**
-     * Get audio data (for direct access)
-     * @return Reference to audio data vector
+     * Get decoded PCM (for direct access); null when streamed
+     * @return Shared clip (16-bit interleaved)
      */
-    const std::vector<uint8_t>& getAudioData() const {
-        return m_audioData;
+    const std::shared_ptr<const AudioClip>& getClip() const {
+        return m_clip;
     }
     
     /**
-     * Get audio spec (format, sample rate, etc.)
+     * Get audio spec (format, sample rate, etc.) of the decoded or
+     * streamed data
      * @return SDL_AudioSpec
      */
     const SDL_AudioSpec& getSpec() const {
@@ -410,17 +461,8 @@ public:
      */
     void reload() {
         cleanup();
-        
-        std::string ext = m_path.substr(m_path.find_last_of(".") + 1);
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-        
-        if (ext == "wav") {
-            loadWAV(m_path);
-        } else if (ext == "ogg" || ext == "mp3") {
-            loadOGG(m_path);
-        }
+        load();
     }
 };
 
 #endif // EDEN_AUDIO_RESOURCE_H
-
@@ -0,0 +1,506 @@
+// EDEN ENGINE - BC Encoder
+// BC1 / BC3 / BC7 block compression and box-filtered mip chains, with the
+// blocks of each level spread over the job system's workers. Used by the
+// texture cooker and by HDM saving; the output uploads as stored.
+
+#ifndef EDEN_BC_ENCODER_H
+#define EDEN_BC_ENCODER_H
+
+#include "job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+enum class BCFormat : uint32_t {
+    BC1,  // RGB, 8 bytes per 4x4 block
+    BC3,  // RGBA (BC1 color + interpolated alpha), 16 bytes
+    BC7   // RGBA, 16 bytes; mode 6 only (one subset, 16 weights)
+};
+
+// Fast: endpoints from the colors' principal axis. Normal: plus one
+// least-squares refit of the endpoints to the chosen indices. High: three
+// refits, exhaustive index search and every BC7 p-bit pair.
+enum class BCQuality : uint32_t { Fast, Normal, High };
+
+namespace bc_encoder_detail {
+
+inline const float* srgb_to_linear_table() {
+    static const std::vector<float> table = [] {
+        std::vector<float> t(256);
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            t[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+inline uint8_t linear_to_srgb(float c) {
+    c = std::clamp(c, 0.0f, 1.0f);
+    float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(s * 255.0f + 0.5f);
+}
+
+inline int refits(BCQuality quality) {
+    return quality == BCQuality::Fast ? 0 : quality == BCQuality::Normal ? 1 : 3;
+}
+
+// Mean and dominant eigenvector (power iteration) of the first `channels`
+// channels of a block
+inline void principal_axis(const uint8_t block[16][4], int channels, float mean[4], float axis[4]) {
+    for (int c = 0; c < 4; c++) {
+        mean[c] = 0.0f;
+        axis[c] = c < channels ? 1.0f : 0.0f;
+    }
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < channels; c++) mean[c] += block[i][c] / 16.0f;
+    }
+
+    float cov[4][4] = {};
+    for (int i = 0; i < 16; i++) {
+        float d[4];
+        for (int c = 0; c < channels; c++) d[c] = block[i][c] - mean[c];
+        for (int a = 0; a < channels; a++) {
+            for (int b = 0; b < channels; b++) cov[a][b] += d[a] * d[b];
+        }
+    }
+
+    for (int it = 0; it < 8; it++) {
+        float n[4] = {0, 0, 0, 0};
+        for (int a = 0; a < channels; a++) {
+            for (int b = 0; b < channels; b++) n[a] += cov[a][b] * axis[b];
+        }
+        float len = 0.0f;
+        for (int c = 0; c < channels; c++) len += n[c] * n[c];
+        len = std::sqrt(len);
+        if (len < 1e-6f) break;  // Flat block
+        for (int c = 0; c < channels; c++) axis[c] = n[c] / len;
+    }
+}
+
+// Endpoints at the extremes of the block along the axis, inset by 1/16 of
+// the range
+inline void axis_endpoints(const uint8_t block[16][4], int channels, const float mean[4], const float axis[4],
+                           float hi[4], float lo[4]) {
+    float minT = 1e30f, maxT = -1e30f;
+    for (int i = 0; i < 16; i++) {
+        float t = 0.0f;
+        for (int c = 0; c < channels; c++) t += (block[i][c] - mean[c]) * axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    float inset = (maxT - minT) / 16.0f;
+    minT += inset;
+    maxT -= inset;
+    for (int c = 0; c < 4; c++) {
+        hi[c] = mean[c] + axis[c] * maxT;
+        lo[c] = mean[c] + axis[c] * minT;
+    }
+}
+
+// Least-squares endpoints for fixed interpolation weights t[i] (0 = e0,
+// 1 = e1); false when every texel uses the same weight
+inline bool refit_endpoints(const uint8_t block[16][4], int channels, const float t[16], float e0[4], float e1[4]) {
+    float a = 0, b = 0, c = 0;
+    float r0[4] = {0, 0, 0, 0}, r1[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 16; i++) {
+        float s = 1.0f - t[i];
+        a += s * s;
+        b += s * t[i];
+        c += t[i] * t[i];
+        for (int ch = 0; ch < channels; ch++) {
+            r0[ch] += s * block[i][ch];
+            r1[ch] += t[i] * block[i][ch];
+        }
+    }
+    float det = a * c - b * b;
+    if (std::fabs(det) < 1e-6f) return false;
+    for (int ch = 0; ch < channels; ch++) {
+        e0[ch] = std::clamp((c * r0[ch] - b * r1[ch]) / det, 0.0f, 255.0f);
+        e1[ch] = std::clamp((a * r1[ch] - b * r0[ch]) / det, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// BC1 color / BC3 alpha
+// ----------------------------------------------------------------------------
+
+inline uint16_t to565(const float c[3]) {
+    int r = static_cast<int>(std::clamp(c[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+    int g = static_cast<int>(std::clamp(c[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+    int b = static_cast<int>(std::clamp(c[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+inline void from565(uint16_t v, int out[3]) {
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// Indices and squared error of one 4-color BC1 candidate
+inline int bc1_indices(const uint8_t block[16][4], uint16_t& c0, uint16_t& c1, uint32_t& indices) {
+    if (c0 < c1) std::swap(c0, c1);  // c0 <= c1 would be the 3-color + transparent mode
+    int palette[4][3];
+    from565(c0, palette[0]);
+    from565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    indices = 0;
+    int error = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestDist = INT32_MAX;
+        for (int p = 0; p < (c0 == c1 ? 1 : 4); p++) {
+            int dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+            int dist = dr * dr + dg * dg + db * db;
+            if (dist < bestDist) {
+                bestDist = dist;
+                best = p;
+            }
+        }
+        indices |= static_cast<uint32_t>(best) << (i * 2);
+        error += bestDist;
+    }
+    return error;
+}
+
+// Always 4-color mode, so BC1 blocks never punch holes
+inline void encode_color_block(const uint8_t block[16][4], BCQuality quality, uint8_t out[8]) {
+    float mean[4], axis[4], hi[4], lo[4];
+    principal_axis(block, 3, mean, axis);
+    axis_endpoints(block, 3, mean, axis, hi, lo);
+
+    uint16_t c0 = to565(hi), c1 = to565(lo);
+    uint32_t indices;
+    int error = bc1_indices(block, c0, c1, indices);
+
+    static const float weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    for (int pass = 0; pass < refits(quality) && error > 0; pass++) {
+        float t[16];
+        for (int i = 0; i < 16; i++) t[i] = weights[(indices >> (i * 2)) & 3];
+        if (!refit_endpoints(block, 3, t, hi, lo)) break;
+        uint16_t r0 = to565(hi), r1 = to565(lo);
+        uint32_t refitIndices;
+        int refitError = bc1_indices(block, r0, r1, refitIndices);
+        if (refitError >= error) break;
+        c0 = r0;
+        c1 = r1;
+        indices = refitIndices;
+        error = refitError;
+    }
+
+    out[0] = c0 & 0xFF; out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF; out[3] = c1 >> 8;
+    for (int i = 0; i < 4; i++) out[4 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+// 8-value alpha mode (a0 > a1), 3-bit indices
+inline void encode_alpha_block(const uint8_t block[16][4], uint8_t out[8]) {
+    uint8_t a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++) {
+        a0 = std::max(a0, block[i][3]);
+        a1 = std::min(a1, block[i][3]);
+    }
+
+    int palette[8] = {a0, a1};
+    for (int k = 1; k < 7; k++) palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestDist = INT32_MAX;
+            for (int p = 0; p < 8; p++) {
+                int dist = std::abs(block[i][3] - palette[p]);
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+
+    out[0] = a0;
+    out[1] = a1;
+    for (int i = 0; i < 6; i++) out[2 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+// ----------------------------------------------------------------------------
+// BC7 mode 6: RGBA 7.7.7.7 endpoints + one p-bit each, 4-bit indices
+// ----------------------------------------------------------------------------
+
+static const int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BC7Candidate {
+    int e[2][4];       // 7-bit endpoints
+    int p[2];          // p-bits
+    uint8_t index[16];
+    int error = INT32_MAX;
+};
+
+inline int bc7_quantize(float value, int pbit) {
+    return std::clamp(static_cast<int>(std::lround((value - pbit) / 2.0f)), 0, 127);
+}
+
+// Indices and squared error for the candidate's endpoints
+inline void bc7_indices(const uint8_t block[16][4], BC7Candidate& cand, bool exhaustive) {
+    int palette[16][4];
+    int e0[4], e1[4];
+    for (int c = 0; c < 4; c++) {
+        e0[c] = (cand.e[0][c] << 1) | cand.p[0];
+        e1[c] = (cand.e[1][c] << 1) | cand.p[1];
+    }
+    for (int w = 0; w < 16; w++) {
+        for (int c = 0; c < 4; c++) {
+            palette[w][c] = ((64 - BC7_WEIGHTS[w]) * e0[c] + BC7_WEIGHTS[w] * e1[c] + 32) >> 6;
+        }
+    }
+
+    // Project onto the endpoint line, then check the neighbouring weights
+    float dir[4], len2 = 0.0f;
+    for (int c = 0; c < 4; c++) {
+        dir[c] = float(e1[c] - e0[c]);
+        len2 += dir[c] * dir[c];
+    }
+    cand.error = 0;
+    for (int i = 0; i < 16; i++) {
+        int lo = 0, hi = 15;
+        if (!exhaustive && len2 > 0.0f) {
+            float t = 0.0f;
+            for (int c = 0; c < 4; c++) t += (block[i][c] - e0[c]) * dir[c];
+            int guess = std::clamp(static_cast<int>(t / len2 * 15.0f + 0.5f), 0, 15);
+            lo = std::max(guess - 1, 0);
+            hi = std::min(guess + 1, 15);
+        }
+        int best = 0, bestDist = INT32_MAX;
+        for (int w = lo; w <= hi; w++) {
+            int dist = 0;
+            for (int c = 0; c < 4; c++) {
+                int d = block[i][c] - palette[w][c];
+                dist += d * d;
+            }
+            if (dist < bestDist) {
+                bestDist = dist;
+                best = w;
+            }
+        }
+        cand.index[i] = static_cast<uint8_t>(best);
+        cand.error += bestDist;
+    }
+}
+
+// Best p-bits for float endpoints: each endpoint's own rounding error, or
+// (High) the block error of all four pairs
+inline BC7Candidate bc7_candidate(const uint8_t block[16][4], const float hi[4], const float lo[4], BCQuality quality) {
+    bool exhaustive = quality == BCQuality::High;
+    BC7Candidate best;
+    if (exhaustive) {
+        for (int pair = 0; pair < 4; pair++) {
+            BC7Candidate cand;
+            cand.p[0] = pair & 1;
+            cand.p[1] = pair >> 1;
+            for (int c = 0; c < 4; c++) {
+                cand.e[0][c] = bc7_quantize(lo[c], cand.p[0]);
+                cand.e[1][c] = bc7_quantize(hi[c], cand.p[1]);
+            }
+            bc7_indices(block, cand, true);
+            if (cand.error < best.error) best = cand;
+        }
+        return best;
+    }
+
+    const float* ends[2] = {lo, hi};
+    for (int e = 0; e < 2; e++) {
+        float bestError = 1e30f;
+        for (int p = 0; p < 2; p++) {
+            float error = 0.0f;
+            int q[4];
+            for (int c = 0; c < 4; c++) {
+                q[c] = bc7_quantize(ends[e][c], p);
+                float d = ends[e][c] - float((q[c] << 1) | p);
+                error += d * d;
+            }
+            if (error < bestError) {
+                bestError = error;
+                best.p[e] = p;
+                std::memcpy(best.e[e], q, sizeof(q));
+            }
+        }
+    }
+    bc7_indices(block, best, false);
+    return best;
+}
+
+struct BitWriter {
+    uint8_t* out;
+    int bit = 0;
+
+    void put(uint32_t value, int count) {
+        for (int i = 0; i < count; i++, bit++) {
+            if ((value >> i) & 1u) out[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+        }
+    }
+};
+
+inline void encode_bc7_block(const uint8_t block[16][4], BCQuality quality, uint8_t out[16]) {
+    float mean[4], axis[4], hi[4], lo[4];
+    principal_axis(block, 4, mean, axis);
+    axis_endpoints(block, 4, mean, axis, hi, lo);
+    BC7Candidate best = bc7_candidate(block, hi, lo, quality);
+
+    for (int pass = 0; pass < refits(quality) && best.error > 0; pass++) {
+        float t[16];
+        for (int i = 0; i < 16; i++) t[i] = BC7_WEIGHTS[best.index[i]] / 64.0f;
+        if (!refit_endpoints(block, 4, t, lo, hi)) break;
+        BC7Candidate refit = bc7_candidate(block, hi, lo, quality);
+        if (refit.error >= best.error) break;
+        best = refit;
+    }
+
+    // The first index's top bit is implicit 0: swap the endpoints if it is set
+    if (best.index[0] & 8) {
+        std::swap(best.e[0], best.e[1]);
+        std::swap(best.p[0], best.p[1]);
+        for (int i = 0; i < 16; i++) best.index[i] = static_cast<uint8_t>(15 - best.index[i]);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter bits{out};
+    bits.put(1u << 6, 7);  // Mode 6
+    for (int c = 0; c < 4; c++) {
+        bits.put(static_cast<uint32_t>(best.e[0][c]), 7);
+        bits.put(static_cast<uint32_t>(best.e[1][c]), 7);
+    }
+    bits.put(static_cast<uint32_t>(best.p[0]), 1);
+    bits.put(static_cast<uint32_t>(best.p[1]), 1);
+    bits.put(best.index[0], 3);
+    for (int i = 1; i < 16; i++) bits.put(best.index[i], 4);
+}
+
+} // namespace bc_encoder_detail
+
+inline uint32_t bc_block_bytes(BCFormat format) {
+    return format == BCFormat::BC1 ? 8 : 16;
+}
+
+// Bytes of one level: whole 4x4 blocks, partial blocks padded
+inline size_t bc_level_size(BCFormat format, uint32_t width, uint32_t height) {
+    return size_t((width + 3) / 4) * ((height + 3) / 4) * bc_block_bytes(format);
+}
+
+inline uint32_t bc_mip_count(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size >>= 1) levels++;
+    return levels;
+}
+
+// One 4x4 RGBA8 block into bc_block_bytes(format) bytes
+inline void bc_encode_block(BCFormat format, const uint8_t block[16][4], BCQuality quality, uint8_t* out) {
+    using namespace bc_encoder_detail;
+    switch (format) {
+        case BCFormat::BC1: encode_color_block(block, quality, out); break;
+        case BCFormat::BC3:
+            encode_alpha_block(block, out);
+            encode_color_block(block, quality, out + 8);
+            break;
+        case BCFormat::BC7: encode_bc7_block(block, quality, out); break;
+    }
+}
+
+/**
+ * Compress one RGBA8 level. Blocks are split across JobSystem::shared();
+ * the calling thread encodes its share too, so run whole saves on a task
+ * (or a thread of their own) to keep a UI thread responsive.
+ */
+inline std::vector<uint8_t> bc_encode_image(const uint8_t* rgba, uint32_t width, uint32_t height,
+                                            BCFormat format, BCQuality quality) {
+    uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    uint32_t blockSize = bc_block_bytes(format);
+    std::vector<uint8_t> out(size_t(blocksX) * blocksY * blockSize);
+
+    parallel_for(size_t(blocksX) * blocksY, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            uint32_t bx = static_cast<uint32_t>(b % blocksX), by = static_cast<uint32_t>(b / blocksX);
+            uint8_t block[16][4];
+            for (uint32_t i = 0; i < 16; i++) {
+                uint32_t x = std::min(bx * 4 + i % 4, width - 1);   // Clamp partial blocks
+                uint32_t y = std::min(by * 4 + i / 4, height - 1);
+                std::memcpy(block[i], &rgba[(size_t(y) * width + x) * 4], 4);
+            }
+            bc_encode_block(format, block, quality, &out[b * blockSize]);
+        }
+    });
+    return out;
+}
+
+/**
+ * Half-size RGBA8 level by a 2x2 box filter (edge texels repeat for odd
+ * sizes). With `srgb` the color channels are averaged in linear light;
+ * alpha always is linear.
+ */
+inline std::vector<uint8_t> bc_downsample(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb,
+                                          uint32_t& outWidth, uint32_t& outHeight) {
+    const float* toLinear = bc_encoder_detail::srgb_to_linear_table();
+    outWidth = std::max(width / 2, 1u);
+    outHeight = std::max(height / 2, 1u);
+    std::vector<uint8_t> dst(size_t(outWidth) * outHeight * 4);
+
+    for (uint32_t y = 0; y < outHeight; y++) {
+        for (uint32_t x = 0; x < outWidth; x++) {
+            uint32_t x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+            uint32_t y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+            const uint8_t* p[4] = {
+                &rgba[(size_t(y0) * width + x0) * 4], &rgba[(size_t(y0) * width + x1) * 4],
+                &rgba[(size_t(y1) * width + x0) * 4], &rgba[(size_t(y1) * width + x1) * 4],
+            };
+            uint8_t* out = &dst[(size_t(y) * outWidth + x) * 4];
+            for (int c = 0; c < 4; c++) {
+                if (srgb && c < 3) {
+                    float sum = toLinear[p[0][c]] + toLinear[p[1][c]] + toLinear[p[2][c]] + toLinear[p[3][c]];
+                    out[c] = bc_encoder_detail::linear_to_srgb(sum * 0.25f);
+                } else {
+                    out[c] = static_cast<uint8_t>((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) / 4);
+                }
+            }
+        }
+    }
+    return dst;
+}
+
+/**
+ * A compressed mip chain, level 0 first, levels back to back (the layout
+ * of KTX2 and HDM texture sections).
+ *
+ * Usage:
+ *   std::vector<uint8_t> chain = bc_encode_mips(rgba, w, h, BCFormat::BC7, BCQuality::Normal, true);
+ *   // level L starts at the sum of bc_level_size() of the levels before it
+ */
+inline std::vector<uint8_t> bc_encode_mips(const uint8_t* rgba, uint32_t width, uint32_t height, BCFormat format,
+                                           BCQuality quality, bool srgb, uint32_t mipCount = 0) {
+    uint32_t levels = mipCount ? std::min(mipCount, bc_mip_count(width, height)) : bc_mip_count(width, height);
+    std::vector<uint8_t> chain;
+    chain.reserve(bc_level_size(format, width, height) * 4 / 3 + 64);
+
+    std::vector<uint8_t> level;
+    const uint8_t* pixels = rgba;
+    for (uint32_t l = 0; l < levels; l++) {
+        std::vector<uint8_t> encoded = bc_encode_image(pixels, width, height, format, quality);
+        chain.insert(chain.end(), encoded.begin(), encoded.end());
+        if (l + 1 < levels) {
+            level = bc_downsample(pixels, width, height, srgb, width, height);
+            pixels = level.data();
+        }
+    }
+    return chain;
+}
+
+#endif // EDEN_BC_ENCODER_H
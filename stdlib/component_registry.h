@@ -6,71 +6,143 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <unordered_map>
 #include <string>
+#include <vector>
+#include <cstring>
 #include <type_traits>
 #include <typeinfo>
 #include <cstddef> // for offsetof
+#include <atomic>
 
 // Component ID type
 using ComponentId = uint32_t;
 
-// Template function to get component ID
-// Each component type gets a unique ID based on its type hash
+// Dense component index, for flat per-type arrays (see EntityStorage).
+// The codegen specializes ComponentIndex for every component (0, 1, 2, ...
+// in name order), so component_index<T>() folds to a constant. Types it
+// doesn't know take the next index from MAX_GENERATED_COMPONENTS up on
+// first use, which then costs one guarded static load.
 template<typename T>
-ComponentId component_id() {
-    // Use type hash to generate unique ID
-    // This ensures each component type gets a consistent ID
-    static ComponentId id = 0;
-    if (id == 0) {
-        // Generate ID from type name hash (simplified - in production use better hashing)
-        const char* type_name = typeid(T).name();
-        ComponentId hash = 0;
-        for (const char* p = type_name; *p; ++p) {
-            hash = hash * 31 + *p;
-        }
-        id = hash ? hash : 1; // Ensure non-zero
+struct ComponentIndex {};
+
+static constexpr uint32_t MAX_GENERATED_COMPONENTS = 256;
+
+namespace component_index_detail {
+
+template<typename T, typename = void>
+struct is_generated : std::false_type {};
+
+template<typename T>
+struct is_generated<T, std::void_t<decltype(ComponentIndex<T>::value)>> : std::true_type {};
+
+inline uint32_t next_runtime_index() {
+    static std::atomic<uint32_t> next{MAX_GENERATED_COMPONENTS};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T>
+uint32_t runtime_index() {
+    static const uint32_t index = next_runtime_index();
+    return index;
+}
+
+} // namespace component_index_detail
+
+template<typename T>
+inline uint32_t component_index() {
+    if constexpr (component_index_detail::is_generated<T>::value) {
+        return ComponentIndex<T>::value;
+    } else {
+        return component_index_detail::runtime_index<T>();
     }
-    return id;
+}
+
+// Component ID used by the registry: the dense index. Only meaningful
+// within one process - don't persist it.
+template<typename T>
+ComponentId component_id() {
+    return component_index<T>();
 }
 
 // Component Metadata Template
 template<typename T>
 struct ComponentMetadata {
     static constexpr const char* name() { return "Unknown"; }
-    static constexpr ComponentId id() { return component_id<T>(); }
+    static ComponentId id() { return component_id<T>(); }
     static constexpr size_t size() { return sizeof(T); }
     static constexpr size_t alignment() { return alignof(T); }
     static constexpr bool is_soa() { return false; }
 };
 
-// Component Fields Reflection Template
+// One field of a component: where it lives, so serialization, migration
+// and the inspector can copy it by offset instead of going through names
+struct ComponentFieldInfo {
+    const char* name;
+    const char* type_name;
+    size_t offset;
+    size_t size;
+    bool trivially_copyable;  // memcpy of [offset, offset + size) is a valid copy
+};
+
+// Component Fields Reflection Template. The codegen specializes it for every
+// component with a constexpr fields[] table.
 template<typename T>
 struct ComponentFields {
+    using FieldInfo = ComponentFieldInfo;
     static constexpr size_t field_count = 0;
-    struct FieldInfo {
-        const char* name;
-        const char* type_name;
-        size_t offset;
-        size_t size;
-    };
-    static constexpr FieldInfo fields[] = {};
+    static constexpr const FieldInfo* get_fields() { return nullptr; }
+};
+
+// Field `field` of the component at `component`
+inline void* field_address(void* component, const ComponentFieldInfo& field) {
+    return static_cast<unsigned char*>(component) + field.offset;
+}
+
+inline const void* field_address(const void* component, const ComponentFieldInfo& field) {
+    return static_cast<const unsigned char*>(component) + field.offset;
+}
+
+// Copy one trivially copyable field between two components of the same type
+inline void copy_field(void* dst, const void* src, const ComponentFieldInfo& field) {
+    std::memcpy(field_address(dst, field), field_address(src, field), field.size);
+}
+
+// Everything the registry knows about a component, as one flat entry
+struct ComponentInfo {
+    const char* name;
+    size_t size;
+    size_t alignment;
+    bool is_soa;
+    const ComponentFieldInfo* fields;
+    size_t field_count;
 };
 
-// Component Registry
+template<typename T>
+constexpr ComponentInfo component_info() {
+    return ComponentInfo{ComponentMetadata<T>::name(), ComponentMetadata<T>::size(), ComponentMetadata<T>::alignment(),
+                         ComponentMetadata<T>::is_soa(), ComponentFields<T>::get_fields(), ComponentFields<T>::field_count};
+}
+
+// Component Registry. Generated components live in a constexpr table indexed
+// by their dense ComponentIndex (GENERATED_COMPONENT_INFO, handed over by
+// register_all_components()); types registered by hand go in a second flat
+// array indexed the same way.
 class ComponentRegistry {
 public:
-    // Register a component type
+    // The codegen's table: entry i describes the component with index i
+    static void set_generated(const ComponentInfo* table, size_t count) {
+        get_instance().generated_table = table;
+        get_instance().generated_size = count;
+    }
+    
+    // Register a component type (not needed for generated components)
     template<typename T>
     static void register_component() {
         ComponentId id = ComponentMetadata<T>::id();
-        const char* name = ComponentMetadata<T>::name();
-        
-        // Store metadata in registry
-        get_instance().component_names[id] = name;
-        get_instance().component_sizes[id] = ComponentMetadata<T>::size();
-        get_instance().component_alignments[id] = ComponentMetadata<T>::alignment();
-        get_instance().component_soa_flags[id] = ComponentMetadata<T>::is_soa();
+        auto& registry = get_instance();
+        if (id < registry.generated_size) return;
+        if (registry.registered.size() <= id) registry.registered.resize(id + 1, ComponentInfo{});
+        registry.registered[id] = component_info<T>();
     }
     
     // Convenience function: register<T>() is shorter than register_component<T>()
@@ -79,51 +151,51 @@ public:
         register_component<T>();
     }
     
+    // Everything known about a component ID, or nullptr
+    static const ComponentInfo* info(ComponentId id) {
+        const auto& registry = get_instance();
+        if (id < registry.generated_size) return &registry.generated_table[id];
+        if (id < registry.registered.size() && registry.registered[id].name) return &registry.registered[id];
+        return nullptr;
+    }
+    
+    // Generated components, in index order (for the inspector)
+    static const ComponentInfo* generated_components() { return get_instance().generated_table; }
+    static size_t generated_count() { return get_instance().generated_size; }
+    
     // Get component name by ID
     static const char* get_name(ComponentId id) {
-        auto it = get_instance().component_names.find(id);
-        if (it != get_instance().component_names.end()) {
-            return it->second;
-        }
-        return "Unknown";
+        const ComponentInfo* component = info(id);
+        return component ? component->name : "Unknown";
     }
     
     // Get component size by ID
     static size_t get_size(ComponentId id) {
-        auto it = get_instance().component_sizes.find(id);
-        if (it != get_instance().component_sizes.end()) {
-            return it->second;
-        }
-        return 0;
+        const ComponentInfo* component = info(id);
+        return component ? component->size : 0;
     }
     
     // Get component alignment by ID
     static size_t get_alignment(ComponentId id) {
-        auto it = get_instance().component_alignments.find(id);
-        if (it != get_instance().component_alignments.end()) {
-            return it->second;
-        }
-        return 0;
+        const ComponentInfo* component = info(id);
+        return component ? component->alignment : 0;
     }
     
     // Check if component is SOA
     static bool is_soa(ComponentId id) {
-        auto it = get_instance().component_soa_flags.find(id);
-        if (it != get_instance().component_soa_flags.end()) {
-            return it->second;
-        }
-        return false;
+        const ComponentInfo* component = info(id);
+        return component && component->is_soa;
     }
     
     // Get field count for a component
     template<typename T>
-    static size_t get_field_count() {
+    static constexpr size_t get_field_count() {
         return ComponentFields<T>::field_count;
     }
     
     // Get field info for a component
     template<typename T>
-    static const typename ComponentFields<T>::FieldInfo* get_fields() {
+    static constexpr const ComponentFieldInfo* get_fields() {
         return ComponentFields<T>::get_fields();
     }
     
@@ -133,12 +205,39 @@ private:
         return instance;
     }
     
-    std::unordered_map<ComponentId, const char*> component_names;
-    std::unordered_map<ComponentId, size_t> component_sizes;
-    std::unordered_map<ComponentId, size_t> component_alignments;
-    std::unordered_map<ComponentId, bool> component_soa_flags;
+    const ComponentInfo* generated_table = nullptr;
+    size_t generated_size = 0;
+    std::vector<ComponentInfo> registered;  // By ID; name == nullptr for unused IDs
 };
 
+// For hot-reload migration: kept[i] is whether field i of T (in
+// ComponentFields<T> order) was in an older layout, given that layout's
+// "name:type;" field signature with the same name and type. Parsed once per
+// migration rather than searched per field and entity.
+template<typename T>
+std::vector<bool> fields_in_signature(const char* signature) {
+    std::vector<std::string> entries;
+    for (const char* entry = signature; entry && *entry;) {
+        const char* end = std::strchr(entry, ';');
+        size_t length = end ? size_t(end - entry) : std::strlen(entry);
+        entries.emplace_back(entry, length);
+        entry += length + (end ? 1 : 0);
+    }
+
+    std::vector<bool> kept(ComponentFields<T>::field_count, false);
+    const auto* fields = ComponentFields<T>::get_fields();
+    for (size_t i = 0; fields && i < kept.size(); i++) {
+        std::string entry = std::string(fields[i].name) + ":" + fields[i].type_name;
+        for (const std::string& old : entries) {
+            if (old == entry) {
+                kept[i] = true;
+                break;
+            }
+        }
+    }
+    return kept;
+}
+
 // Helper macros for easier registration
 #define REGISTER_COMPONENT(T) ComponentRegistry::register_component<T>()
 
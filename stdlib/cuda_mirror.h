@@ -0,0 +1,277 @@
+// EDEN ENGINE - CUDA Mirror
+// Persistent device copies of @[cuda] component columns: only rows the host
+// changed are uploaded (through pinned staging), launches run on their own
+// stream, and results come back asynchronously - or stay on the GPU when a
+// column is a Vulkan buffer imported as CUDA external memory
+
+#ifndef EDEN_CUDA_MIRROR_H
+#define EDEN_CUDA_MIRROR_H
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+// Define EDEN_CUDA_VULKAN_INTEROP to get CudaColumnMirror::import_vulkan_memory()
+#if defined(EDEN_CUDA_VULKAN_INTEROP)
+#if defined(_WIN32)
+#include <windows.h>
+using CudaExternalHandle = HANDLE;  // vkGetMemoryWin32HandleKHR
+#else
+using CudaExternalHandle = int;     // vkGetMemoryFdKHR
+#endif
+#endif
+
+namespace cuda_mirror_detail {
+
+static constexpr size_t MIN_ROWS = 256;
+
+inline bool check(cudaError_t result, const char* what) {
+    if (result == cudaSuccess) return true;
+    std::cerr << "[CUDA] " << what << " failed: " << cudaGetErrorString(result) << std::endl;
+    return false;
+}
+
+} // namespace cuda_mirror_detail
+
+/**
+ * A non-blocking CUDA stream, created on first use (there is no CUDA
+ * context yet while statics are constructed). Work on it does not wait for
+ * the legacy default stream, so kernels overlap with other GPU work.
+ */
+class CudaStream {
+public:
+    CudaStream() = default;
+    ~CudaStream() {
+        if (stream) cudaStreamDestroy(stream);
+    }
+
+    CudaStream(const CudaStream&) = delete;
+    CudaStream& operator=(const CudaStream&) = delete;
+
+    cudaStream_t get() {
+        if (!stream) cuda_mirror_detail::check(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking), "cudaStreamCreate");
+        return stream;
+    }
+
+    bool synchronize() {
+        return !stream || cuda_mirror_detail::check(cudaStreamSynchronize(stream), "cudaStreamSynchronize");
+    }
+
+private:
+    cudaStream_t stream = nullptr;
+};
+
+/**
+ * Device copy of one SoAColumn, kept between launches.
+ *
+ * upload() sends only the rows marked dirty since the last upload: rows
+ * appended since then are dirty automatically, a shrink (a swap-remove
+ * moved rows) makes everything dirty, and host code that writes the column
+ * outside a generated query loop calls mark_dirty() itself. Copies go
+ * through a pinned staging buffer, so cudaMemcpyAsync really is async.
+ *
+ * download() queues the kernel's results back into the staging buffer;
+ * commit(), once the stream has finished, copies them into the host column.
+ * Until then the host must not touch the column.
+ *
+ * With EDEN_CUDA_VULKAN_INTEROP, import_vulkan_memory() makes the column
+ * live in a Vulkan buffer: kernels write straight into it, download() does
+ * nothing and the renderer reads the results without a round trip through
+ * the host. The host copy is then stale; rows marked dirty still upload
+ * (host values win).
+ *
+ * Usage:
+ *   static CudaColumnMirror<float> g_px;
+ *   g_px.upload(px.data(), px.size(), stream);   // dirty rows only
+ *   kernel<<<blocks, 256, 0, stream>>>(g_px.device(), px.size());
+ *   g_px.download(px.data(), px.size(), stream);
+ *   ...render...
+ *   cudaStreamSynchronize(stream);
+ *   g_px.commit();
+ */
+template <typename F>
+class CudaColumnMirror {
+    static_assert(std::is_trivially_copyable<F>::value, "CUDA mirrors copy rows as bytes");
+
+public:
+    CudaColumnMirror() = default;
+    ~CudaColumnMirror() { release(); }
+
+    CudaColumnMirror(const CudaColumnMirror&) = delete;
+    CudaColumnMirror& operator=(const CudaColumnMirror&) = delete;
+
+    // Rows [begin, end) changed on the host since the last upload
+    void mark_dirty(size_t begin, size_t end) {
+        if (begin >= end) return;
+        dirty_begin = std::min(dirty_begin, begin);
+        dirty_end = std::max(dirty_end, end);
+    }
+
+    void mark_all_dirty() { mark_dirty(0, SIZE_MAX); }
+
+    // Make device rows [0, count) match the host's dirty rows
+    bool upload(const F* host, size_t count, cudaStream_t stream) {
+        if (count < rows) {
+            mark_all_dirty();
+        } else if (count > rows) {
+            mark_dirty(rows, count);
+        }
+        if (!reserve(count)) return false;
+        rows = count;
+
+        size_t begin = dirty_begin, end = std::min(dirty_end, count);
+        if (begin < end) {
+            size_t bytes = (end - begin) * sizeof(F);
+            std::memcpy(staging + begin, host + begin, bytes);
+            if (!cuda_mirror_detail::check(cudaMemcpyAsync(device_rows + begin, staging + begin, bytes,
+                                                           cudaMemcpyHostToDevice, stream), "upload")) {
+                return false;
+            }
+            uploaded += bytes;
+        }
+        dirty_begin = SIZE_MAX;
+        dirty_end = 0;
+        return true;
+    }
+
+    // Queue rows [0, count) back towards `host`; commit() finishes it
+    bool download(F* host, size_t count, cudaStream_t stream) {
+        if (external || count == 0) return true;  // Results stay on the GPU
+        size_t bytes = count * sizeof(F);
+        if (!cuda_mirror_detail::check(cudaMemcpyAsync(staging, device_rows, bytes, cudaMemcpyDeviceToHost, stream), "download")) {
+            return false;
+        }
+        pending_host = host;
+        pending_rows = count;
+        downloaded += bytes;
+        return true;
+    }
+
+    // After the download's stream has finished: results into the host column
+    void commit() {
+        if (pending_host) std::memcpy(pending_host, staging, pending_rows * sizeof(F));
+        pending_host = nullptr;
+        pending_rows = 0;
+    }
+
+    F* device() { return device_rows; }
+    size_t size() const { return rows; }
+    bool vulkan_resident() const { return external != nullptr; }
+
+    // Bytes sent each way so far
+    uint64_t bytes_uploaded() const { return uploaded; }
+    uint64_t bytes_downloaded() const { return downloaded; }
+
+#if defined(EDEN_CUDA_VULKAN_INTEROP)
+    /**
+     * Back this column with Vulkan memory allocated with
+     * VkExportMemoryAllocateInfo (opaque fd / Win32 handle). `capacity` rows
+     * start at `offset`; the column can't grow past them. On success CUDA
+     * owns the handle. The caller orders Vulkan reads after the launch
+     * (e.g. the kernel's wait function before submitting the frame)
+     */
+    bool import_vulkan_memory(CudaExternalHandle handle, size_t memory_size, size_t offset, size_t capacity) {
+        cudaExternalMemoryHandleDesc memory_desc = {};
+#if defined(_WIN32)
+        memory_desc.type = cudaExternalMemoryHandleTypeOpaqueWin32;
+        memory_desc.handle.win32.handle = handle;
+#else
+        memory_desc.type = cudaExternalMemoryHandleTypeOpaqueFd;
+        memory_desc.handle.fd = handle;
+#endif
+        memory_desc.size = memory_size;
+        cudaExternalMemory_t memory = nullptr;
+        if (!cuda_mirror_detail::check(cudaImportExternalMemory(&memory, &memory_desc), "cudaImportExternalMemory")) return false;
+
+        cudaExternalMemoryBufferDesc buffer_desc = {};
+        buffer_desc.offset = offset;
+        buffer_desc.size = capacity * sizeof(F);
+        void* mapped = nullptr;
+        if (!cuda_mirror_detail::check(cudaExternalMemoryGetMappedBuffer(&mapped, memory, &buffer_desc), "cudaExternalMemoryGetMappedBuffer")) {
+            cudaDestroyExternalMemory(memory);
+            return false;
+        }
+
+        F* old_staging = staging;
+        staging = nullptr;
+        release();
+        if (!cuda_mirror_detail::check(cudaMallocHost(reinterpret_cast<void**>(&staging), capacity * sizeof(F)), "cudaMallocHost")) {
+            staging = old_staging;
+            cudaFree(mapped);
+            cudaDestroyExternalMemory(memory);
+            return false;
+        }
+        if (old_staging) cudaFreeHost(old_staging);
+        device_rows = static_cast<F*>(mapped);
+        external = memory;
+        row_capacity = capacity;
+        rows = 0;
+        mark_all_dirty();
+        return true;
+    }
+#endif
+
+private:
+    F* device_rows = nullptr;
+    F* staging = nullptr;  // Pinned; row_capacity rows
+    size_t rows = 0;
+    size_t row_capacity = 0;
+    size_t dirty_begin = SIZE_MAX;
+    size_t dirty_end = 0;
+    F* pending_host = nullptr;
+    size_t pending_rows = 0;
+    uint64_t uploaded = 0;
+    uint64_t downloaded = 0;
+#if defined(EDEN_CUDA_VULKAN_INTEROP)
+    cudaExternalMemory_t external = nullptr;
+#else
+    void* external = nullptr;
+#endif
+
+    // Growing keeps the device rows (a device-to-device copy), so nothing
+    // has to be uploaded again
+    bool reserve(size_t count) {
+        if (count <= row_capacity) return true;
+        if (external) {
+            std::cerr << "[CUDA] Column outgrew its Vulkan buffer (" << row_capacity << " rows)" << std::endl;
+            return false;
+        }
+        size_t capacity = std::max({count, row_capacity * 2, cuda_mirror_detail::MIN_ROWS});
+        F* grown = nullptr;
+        F* grown_staging = nullptr;
+        if (!cuda_mirror_detail::check(cudaMalloc(reinterpret_cast<void**>(&grown), capacity * sizeof(F)), "cudaMalloc")) return false;
+        if (!cuda_mirror_detail::check(cudaMallocHost(reinterpret_cast<void**>(&grown_staging), capacity * sizeof(F)), "cudaMallocHost")) {
+            cudaFree(grown);
+            return false;
+        }
+        if (device_rows && rows) cudaMemcpy(grown, device_rows, rows * sizeof(F), cudaMemcpyDeviceToDevice);
+        if (device_rows) cudaFree(device_rows);
+        if (staging) cudaFreeHost(staging);
+        device_rows = grown;
+        staging = grown_staging;
+        row_capacity = capacity;
+        return true;
+    }
+
+    // Errors are ignored: at exit the CUDA runtime may already be gone
+    void release() {
+        if (device_rows) cudaFree(device_rows);
+#if defined(EDEN_CUDA_VULKAN_INTEROP)
+        if (external) cudaDestroyExternalMemory(external);
+#endif
+        if (staging) cudaFreeHost(staging);
+        device_rows = nullptr;
+        staging = nullptr;
+        external = nullptr;
+        rows = row_capacity = 0;
+        pending_host = nullptr;
+        pending_rows = 0;
+    }
+};
+
+#endif // EDEN_CUDA_MIRROR_H
@@ -8,9 +8,10 @@
 #include "vulkan.h"
 #include <vector>
 #include <string>
-#include <fstream>
 #include <cstring>
 
+#include "vfs.h"
+
 // DDS constants
 #define DDS_MAGIC 0x20534444  // "DDS " in little-endian
 
@@ -91,6 +92,8 @@ struct DDSData {
     uint32_t mipmapCount;
     uint32_t arraySize;                 // Usually 1 for 2D textures
     std::vector<uint8_t> compressedData; // Compressed texture data (ready for GPU)
+    std::vector<uint32_t> mipOffsets;   // Byte offset of each mip level in compressedData (layer 0)
+    std::vector<uint32_t> mipSizes;     // Byte size of each mip level
     bool hasAlpha;
 };
 
@@ -196,7 +199,7 @@ inline DDSData load_dds(const std::string& path) {
     result.arraySize = 1;
     result.hasAlpha = false;
     
-    std::ifstream file(path, std::ios::binary);
+    VfsInputStream file(path, std::ios::binary);
     if (!file.is_open()) {
         // Return empty result - caller should check format != VK_FORMAT_UNDEFINED
         // Note: File not found or cannot open - check path/permissions
@@ -271,7 +274,10 @@ inline DDSData load_dds(const std::string& path) {
     uint32_t currentHeight = result.height;
     
     for (uint32_t i = 0; i < result.mipmapCount; i++) {
-        totalSize += calculateMipmapSize(currentWidth, currentHeight, result.format);
+        uint32_t mipSize = calculateMipmapSize(currentWidth, currentHeight, result.format);
+        result.mipOffsets.push_back(totalSize);
+        result.mipSizes.push_back(mipSize);
+        totalSize += mipSize;
         currentWidth = currentWidth > 1 ? currentWidth / 2 : 1;
         currentHeight = currentHeight > 1 ? currentHeight / 2 : 1;
     }
@@ -296,5 +302,31 @@ inline DDSData load_dds(const std::string& path) {
     return result;
 }
 
+// One VkBufferImageCopy per mip level of layer 0, for a staging buffer
+// holding compressedData as-is
+inline std::vector<VkBufferImageCopy> dds_copy_regions(const DDSData& dds) {
+    std::vector<VkBufferImageCopy> regions;
+    uint32_t width = dds.width;
+    uint32_t height = dds.height;
+    
+    for (uint32_t level = 0; level < dds.mipmapCount && level < dds.mipOffsets.size(); level++) {
+        VkBufferImageCopy region = {};
+        region.bufferOffset = dds.mipOffsets[level];
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {width, height, 1};
+        regions.push_back(region);
+        
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return regions;
+}
+
 #endif // EDEN_DDS_LOADER_H
 
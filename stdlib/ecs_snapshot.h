@@ -0,0 +1,474 @@
+// EDEN ENGINE - ECS Snapshots
+// Binary save/load of an EntityStorage: each component's dense arrays written
+// as-is behind a schema header, memory-mapped on load, optionally as a delta
+// against an earlier snapshot
+
+#ifndef EDEN_ECS_SNAPSHOT_H
+#define EDEN_ECS_SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <type_traits>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#include "entity_storage.h"
+#include "component_registry.h"
+#include "vfs.h"
+
+/**
+ * File layout (native byte order and struct layout: a snapshot is for the
+ * same build on the same platform, not an interchange format)
+ *
+ *   FileHeader
+ *   uint32_t generations[slot_count]   EntityStorage's slot table
+ *   uint32_t free_list[free_count]
+ *   sections[section_count], each:
+ *     SectionHeader
+ *     name                              component_name<T>(), not NUL-terminated
+ *     FieldRecord[field_count] + names  from ComponentFields<T>
+ *     EntityId removed[removed_count]   deltas: base entities that lost T
+ *     EntityId entities[count]
+ *     T components[count]               at a multiple of 64 in the file
+ *
+ * A delta snapshot has the same layout; its sections hold only the
+ * components added or changed since the base, plus the removals. The slot
+ * table is always whole.
+ */
+namespace snapshot_detail {
+
+constexpr char MAGIC[8] = {'E', 'D', 'E', 'N', 'S', 'N', 'P', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t FLAG_DELTA = 1;
+constexpr size_t ARRAY_ALIGN = 64;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t id;       // This snapshot
+    uint64_t base_id;  // Deltas: the snapshot they apply to
+    uint64_t bytes;    // Whole file
+    uint32_t slot_count;
+    uint32_t free_count;
+    uint32_t section_count;
+    uint32_t reserved;
+};
+
+struct SectionHeader {
+    uint64_t bytes;  // Whole section, this header included
+    uint64_t count;
+    uint64_t removed_count;
+    uint64_t entities_offset;    // From the section's start
+    uint64_t components_offset;  // From the section's start
+    uint32_t component_size;
+    uint32_t component_align;
+    uint32_t field_count;
+    uint32_t name_length;
+};
+
+struct FieldRecord {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t name_length;
+    uint32_t type_length;
+};
+
+// A parsed section: pointers into the snapshot's bytes
+struct Section {
+    const SectionHeader* header;
+    std::string name;
+    const unsigned char* fields;  // First FieldRecord
+    const EntityId* removed;
+    const EntityId* entities;
+    const unsigned char* components;
+};
+
+inline uint64_t next_id() {
+    static std::atomic<uint64_t> counter{0};
+    uint64_t x = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) + counter++ * 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;  // splitmix64
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+class Writer {
+public:
+    explicit Writer(std::vector<unsigned char>& out) : out(out) {}
+
+    size_t put(const void* data, size_t bytes) {
+        size_t at = out.size();
+        out.resize(at + bytes);
+        if (bytes) std::memcpy(out.data() + at, data, bytes);
+        return at;
+    }
+
+    void pad(size_t align) { out.resize((out.size() + align - 1) / align * align, 0); }
+
+    template <typename S>
+    void patch(size_t at, const S& value) { std::memcpy(out.data() + at, &value, sizeof(S)); }
+
+    size_t size() const { return out.size(); }
+
+private:
+    std::vector<unsigned char>& out;
+};
+
+} // namespace snapshot_detail
+
+/**
+ * One captured (or opened) state of an EntityStorage, for the component
+ * types listed at capture. Components must be trivially copyable - they are
+ * copied as bytes - and restoring checks each against the schema it was
+ * saved with, refusing a layout that changed.
+ *
+ * Usage:
+ *   EcsSnapshot full = EcsSnapshot::capture<Position, Velocity>(world);
+ *   full.save("world.snap");
+ *   EcsSnapshot frame = EcsSnapshot::capture_delta<Position, Velocity>(world, full);  // Only what changed
+ *
+ *   EcsSnapshot loaded;
+ *   if (loaded.open("world.snap")) loaded.restore<Position, Velocity>(world);
+ *   frame.restore<Position, Velocity>(world, loaded);  // Base, then the delta
+ *
+ * Restoring replaces the world's entities (and every component of them,
+ * listed or not) with the snapshot's, handles and free list included, so
+ * EntityIds kept from the time of the capture work again afterwards.
+ */
+class EcsSnapshot {
+public:
+    EcsSnapshot() = default;
+    EcsSnapshot(EcsSnapshot&&) = default;
+    EcsSnapshot& operator=(EcsSnapshot&&) = default;
+
+    template <typename... Ts>
+    static EcsSnapshot capture(EntityStorage& world) {
+        EcsSnapshot snapshot;
+        snapshot.write<Ts...>(world, nullptr);
+        return snapshot;
+    }
+
+    // Only the components that differ from base (which must be a full
+    // snapshot of the same types); invalid if base is unusable
+    template <typename... Ts>
+    static EcsSnapshot capture_delta(EntityStorage& world, const EcsSnapshot& base) {
+        EcsSnapshot snapshot;
+        if (!base.valid() || base.is_delta()) {
+            snapshot.last_error = "delta base must be a valid full snapshot";
+            return snapshot;
+        }
+        snapshot.write<Ts...>(world, &base);
+        return snapshot;
+    }
+
+    bool save(const std::string& path) const {
+        if (!valid()) return fail("nothing to save");
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return fail("cannot open " + path + " for writing");
+        size_t written = std::fwrite(bytes, 1, length, file);
+        bool closed = std::fclose(file) == 0;
+        if (written != length || !closed) return fail("short write to " + path);
+        return true;
+    }
+
+    // Maps the file; the snapshot reads straight from the mapping
+    bool open(const std::string& path) {
+        *this = EcsSnapshot();
+        file = std::make_unique<vfs_detail::MappedFile>();
+        if (!file->open(path)) {
+            file.reset();
+            return fail("cannot open " + path);
+        }
+        return attach(reinterpret_cast<const unsigned char*>(file->data()), file->size());
+    }
+
+    // A full snapshot into world
+    template <typename... Ts>
+    bool restore(EntityStorage& world) const {
+        if (!valid()) return fail("invalid snapshot");
+        if (is_delta()) return fail("delta snapshot needs its base");
+        if (!(true && ... && check<Ts>())) return false;
+        reset_entities(world);
+        (add_section<Ts>(world), ...);
+        return true;
+    }
+
+    // A delta into world: base (the snapshot it was captured against) first
+    template <typename... Ts>
+    bool restore(EntityStorage& world, const EcsSnapshot& base) const {
+        if (!valid()) return fail("invalid snapshot");
+        if (!is_delta()) return restore<Ts...>(world);
+        if (!base.valid() || base.id() != header()->base_id) return fail("delta does not apply to this base");
+        if (!(true && ... && check<Ts>())) return false;
+        if (!base.restore<Ts...>(world)) return fail(base.error());
+        (remove_section<Ts>(world), ...);
+        set_slots(world);
+        (add_section<Ts>(world), ...);
+        return true;
+    }
+
+    bool valid() const { return bytes != nullptr; }
+    bool is_delta() const { return valid() && (header()->flags & snapshot_detail::FLAG_DELTA) != 0; }
+    uint64_t id() const { return valid() ? header()->id : 0; }
+    size_t size_bytes() const { return length; }
+    const unsigned char* data() const { return bytes; }
+
+    // Entities holding T in the snapshot (in a delta: added or changed)
+    template <typename T>
+    size_t count() const {
+        const auto* section = find(component_name<T>());
+        return section ? section->header->count : 0;
+    }
+
+    // Why the last call failed
+    const std::string& error() const { return last_error; }
+
+private:
+    std::vector<unsigned char> buffer;               // Captured
+    std::unique_ptr<vfs_detail::MappedFile> file;    // Opened
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+    std::vector<snapshot_detail::Section> sections;
+    mutable std::string last_error;
+
+    const snapshot_detail::FileHeader* header() const {
+        return reinterpret_cast<const snapshot_detail::FileHeader*>(bytes);
+    }
+
+    const uint32_t* generations() const {
+        return reinterpret_cast<const uint32_t*>(bytes + sizeof(snapshot_detail::FileHeader));
+    }
+
+    const uint32_t* free_list() const { return generations() + header()->slot_count; }
+
+    bool fail(const std::string& message) const {
+        last_error = message;
+        return false;
+    }
+
+    const snapshot_detail::Section* find(const char* name) const {
+        for (const auto& section : sections) {
+            if (section.name == name) return &section;
+        }
+        return nullptr;
+    }
+
+    // -------------------------------------------------------------------------
+    // Writing
+    // -------------------------------------------------------------------------
+
+    template <typename... Ts>
+    void write(EntityStorage& world, const EcsSnapshot* base) {
+        using namespace snapshot_detail;
+        Writer out(buffer);
+        FileHeader file_header{};
+        std::memcpy(file_header.magic, MAGIC, sizeof(MAGIC));
+        file_header.version = VERSION;
+        file_header.flags = base ? FLAG_DELTA : 0;
+        file_header.id = next_id();
+        file_header.base_id = base ? base->id() : 0;
+        file_header.slot_count = static_cast<uint32_t>(world.generations.size());
+        file_header.free_count = static_cast<uint32_t>(world.free_list.size());
+        file_header.section_count = sizeof...(Ts);
+        out.put(&file_header, sizeof(file_header));
+        out.put(world.generations.data(), world.generations.size() * sizeof(uint32_t));
+        out.put(world.free_list.data(), world.free_list.size() * sizeof(uint32_t));
+        out.pad(8);
+        (write_section<Ts>(out, world, base ? base->find(component_name<Ts>()) : nullptr, base != nullptr), ...);
+        file_header.bytes = out.size();
+        out.patch(0, file_header);
+        attach(buffer.data(), buffer.size());
+    }
+
+    template <typename T>
+    static void write_section(snapshot_detail::Writer& out, EntityStorage& world, const snapshot_detail::Section* base,
+                              bool delta) {
+        using namespace snapshot_detail;
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot components are copied as bytes");
+        size_t start = out.size();
+        SectionHeader section{};
+        out.put(&section, sizeof(section));
+        const char* name = component_name<T>();
+        section.name_length = static_cast<uint32_t>(std::strlen(name));
+        out.put(name, section.name_length);
+        const auto* fields = ComponentFields<T>::get_fields();
+        section.field_count = fields ? static_cast<uint32_t>(ComponentFields<T>::field_count) : 0;
+        for (uint32_t f = 0; f < section.field_count; f++) {
+            FieldRecord record{static_cast<uint32_t>(fields[f].offset), static_cast<uint32_t>(fields[f].size),
+                               static_cast<uint32_t>(std::strlen(fields[f].name)),
+                               static_cast<uint32_t>(std::strlen(fields[f].type_name))};
+            out.put(&record, sizeof(record));
+            out.put(fields[f].name, record.name_length);
+            out.put(fields[f].type_name, record.type_length);
+        }
+        section.component_size = sizeof(T);
+        section.component_align = alignof(T);
+        out.pad(8);
+
+        // The dense arrays as they are, when there's nothing to filter
+        const EntityId* ids = nullptr;
+        const T* components = nullptr;
+        auto* wrap = world.find<T>();
+        if (!delta && world.mode == StorageMode::SparseSet) {
+            section.count = wrap ? wrap->storage.size() : 0;
+            ids = wrap ? wrap->storage.entity_data() : nullptr;
+            components = wrap ? wrap->storage.data() : nullptr;
+        }
+
+        std::vector<EntityId> gathered_ids, removed;
+        std::vector<T> gathered;
+        if (delta || world.mode == StorageMode::Archetype) {
+            std::unordered_map<EntityId, const unsigned char*> before;
+            bool comparable = base && base->header->component_size == sizeof(T);
+            if (comparable) {
+                before.reserve(base->header->count);
+                for (uint64_t i = 0; i < base->header->count; i++) {
+                    before.emplace(base->entities[i], base->components + i * sizeof(T));
+                }
+                for (uint64_t i = 0; i < base->header->count; i++) {
+                    if (!world.has_component<T>(base->entities[i])) removed.push_back(base->entities[i]);
+                }
+            } else if (base) {
+                removed.assign(base->entities, base->entities + base->header->count);
+            }
+            world.for_each_read<T>([&](EntityId entity, const T& component) {
+                if (delta) {
+                    auto it = before.find(entity);
+                    if (it != before.end() && std::memcmp(it->second, &component, sizeof(T)) == 0) return;
+                }
+                gathered_ids.push_back(entity);
+                gathered.push_back(component);
+            });
+            section.count = gathered.size();
+            ids = gathered_ids.data();
+            components = gathered.data();
+        }
+
+        section.removed_count = removed.size();
+        out.put(removed.data(), removed.size() * sizeof(EntityId));
+        section.entities_offset = out.size() - start;
+        out.put(ids, section.count * sizeof(EntityId));
+        out.pad(ARRAY_ALIGN);
+        section.components_offset = out.size() - start;
+        out.put(components, section.count * sizeof(T));
+        out.pad(8);
+        section.bytes = out.size() - start;
+        out.patch(start, section);
+    }
+
+    // -------------------------------------------------------------------------
+    // Reading
+    // -------------------------------------------------------------------------
+
+    // Validates the layout and indexes the sections
+    bool attach(const unsigned char* data, size_t size) {
+        using namespace snapshot_detail;
+        sections.clear();
+        bytes = nullptr;
+        length = 0;
+        if (size < sizeof(FileHeader)) return fail("truncated snapshot");
+        const auto* file_header = reinterpret_cast<const FileHeader*>(data);
+        if (std::memcmp(file_header->magic, MAGIC, sizeof(MAGIC)) != 0) return fail("not an ECS snapshot");
+        if (file_header->version != VERSION) return fail("unsupported snapshot version");
+        if (file_header->bytes != size) return fail("truncated snapshot");
+        size_t at = sizeof(FileHeader) + (size_t(file_header->slot_count) + file_header->free_count) * sizeof(uint32_t);
+        at = (at + 7) / 8 * 8;
+        if (file_header->slot_count == 0 || at > size) return fail("corrupt slot table");
+
+        for (uint32_t s = 0; s < file_header->section_count; s++) {
+            if (at + sizeof(SectionHeader) > size) return fail("truncated section");
+            const auto* section_header = reinterpret_cast<const SectionHeader*>(data + at);
+            uint64_t end = section_header->bytes;
+            uint64_t components_end = section_header->components_offset + section_header->count * section_header->component_size;
+            if (end > size - at || section_header->components_offset > end || components_end > end ||
+                section_header->entities_offset + section_header->count * sizeof(EntityId) > section_header->components_offset ||
+                sizeof(SectionHeader) + section_header->name_length > end) {
+                return fail("corrupt section");
+            }
+            Section section;
+            section.header = section_header;
+            section.name.assign(reinterpret_cast<const char*>(data + at + sizeof(SectionHeader)), section_header->name_length);
+            section.fields = data + at + sizeof(SectionHeader) + section_header->name_length;
+            section.entities = reinterpret_cast<const EntityId*>(data + at + section_header->entities_offset);
+            section.removed = section.entities - section_header->removed_count;
+            section.components = data + at + section_header->components_offset;
+            if (reinterpret_cast<const unsigned char*>(section.removed) < section.fields) return fail("corrupt section");
+            sections.push_back(std::move(section));
+            at += end;
+        }
+        bytes = data;
+        length = size;
+        return true;
+    }
+
+    // T's section, if any, was saved with T's current layout
+    template <typename T>
+    bool check() const {
+        using namespace snapshot_detail;
+        const Section* section = find(component_name<T>());
+        if (!section) return true;
+        std::string name = component_name<T>();
+        if (section->header->component_size != sizeof(T) || section->header->component_align != alignof(T)) {
+            return fail(name + ": size or alignment differs from the snapshot");
+        }
+        const auto* fields = ComponentFields<T>::get_fields();
+        uint32_t field_count = fields ? static_cast<uint32_t>(ComponentFields<T>::field_count) : 0;
+        if (section->header->field_count != field_count) return fail(name + ": fields differ from the snapshot");
+        const unsigned char* at = section->fields;
+        for (uint32_t f = 0; f < field_count; f++) {
+            FieldRecord record;
+            std::memcpy(&record, at, sizeof(record));
+            const char* field_name = reinterpret_cast<const char*>(at + sizeof(record));
+            const char* type_name = field_name + record.name_length;
+            if (record.offset != fields[f].offset || record.size != fields[f].size ||
+                record.name_length != std::strlen(fields[f].name) || std::memcmp(field_name, fields[f].name, record.name_length) != 0 ||
+                record.type_length != std::strlen(fields[f].type_name) || std::memcmp(type_name, fields[f].type_name, record.type_length) != 0) {
+                return fail(name + ": field " + fields[f].name + " differs from the snapshot");
+            }
+            at += sizeof(record) + record.name_length + record.type_length;
+        }
+        return true;
+    }
+
+    // Destroys every live entity, then takes the snapshot's slot table
+    void reset_entities(EntityStorage& world) const {
+        for (uint32_t index = 1; index < world.generations.size(); index++) {
+            world.destroy_entity(make_entity(index, world.generations[index]));
+        }
+        set_slots(world);
+    }
+
+    void set_slots(EntityStorage& world) const {
+        const auto* file_header = header();
+        world.generations.assign(generations(), generations() + file_header->slot_count);
+        world.masks.resize(file_header->slot_count);
+        world.free_list.assign(free_list(), free_list() + file_header->free_count);
+    }
+
+    template <typename T>
+    void add_section(EntityStorage& world) const {
+        const snapshot_detail::Section* section = find(component_name<T>());
+        if (!section) return;
+        world.reserve_components<T>(section->header->count);
+        alignas(T) unsigned char component[sizeof(T)];  // In-memory snapshots aren't aligned for T
+        for (uint64_t i = 0; i < section->header->count; i++) {
+            std::memcpy(component, section->components + i * sizeof(T), sizeof(T));
+            world.add_component<T>(section->entities[i], *reinterpret_cast<const T*>(component));
+        }
+    }
+
+    template <typename T>
+    void remove_section(EntityStorage& world) const {
+        const snapshot_detail::Section* section = find(component_name<T>());
+        if (!section) return;
+        for (uint64_t i = 0; i < section->header->removed_count; i++) world.remove_component<T>(section->removed[i]);
+    }
+};
+
+#endif // EDEN_ECS_SNAPSHOT_H
@@ -0,0 +1,259 @@
+// EDEN ENGINE - Entity Command Buffers
+// Records structural ECS changes (create/destroy/add/remove) while systems
+// iterate, and applies them later in one sorted batch at a sync point
+
+#ifndef EDEN_ENTITY_COMMANDS_H
+#define EDEN_ENTITY_COMMANDS_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+#include "entity_storage.h"
+#include "job_system.h"
+
+namespace entity_commands_detail {
+
+static constexpr size_t BLOCK_SIZE = 16 * 1024;
+static constexpr size_t BLOCK_ALIGN = 64;
+
+// What playback needs to apply a recorded component it cannot name
+struct ComponentOps {
+    void (*add)(EntityStorage& world, EntityId entity, void* component);
+    void (*remove)(EntityStorage& world, EntityId entity);
+    void (*reserve)(EntityStorage& world, size_t count);
+    void (*destroy)(void* component);
+};
+
+template <typename T>
+const ComponentOps& ops_for() {
+    static const ComponentOps ops{
+        [](EntityStorage& world, EntityId entity, void* component) {
+            world.add_component<T>(entity, *static_cast<T*>(component));
+        },
+        [](EntityStorage& world, EntityId entity) { world.remove_component<T>(entity); },
+        [](EntityStorage& world, size_t count) { world.reserve_components<T>(count); },
+        [](void* component) { static_cast<T*>(component)->~T(); }
+    };
+    return ops;
+}
+
+enum class CommandKind : uint32_t { Add, Remove };
+
+struct Command {
+    EntityId entity;
+    uint32_t component;  // component_index<T>()
+    CommandKind kind;
+    void* data;          // Add: the component, in the buffer's arena
+    const ComponentOps* ops;
+};
+
+} // namespace entity_commands_detail
+
+/**
+ * One thread's recorded changes. Nothing touches the EntityStorage until
+ * playback(), so recording is safe inside for_each and parallel systems
+ * (one buffer per thread - see ThreadCommandBuffers).
+ *
+ * Playback creates the new entities first, then applies adds and removes
+ * grouped by component and sorted by entity (so each storage grows once and
+ * is appended in order), then destroys. Commands on the same entity and
+ * component keep their recorded order.
+ *
+ * Usage:
+ *   EntityCommandBuffer commands;
+ *   world.for_each<Health>([&](EntityId e, Health& h) {
+ *       if (h.value <= 0) commands.destroy_entity(e);
+ *   });
+ *   commands.playback(world);
+ */
+class EntityCommandBuffer {
+public:
+    EntityCommandBuffer() = default;
+    ~EntityCommandBuffer() { shrink(); }
+
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+    // A placeholder handle, usable in this buffer's commands; it becomes a
+    // real entity at playback
+    EntityId create_entity() {
+        return make_entity(pending_creates++, PENDING_GENERATION);
+    }
+
+    void destroy_entity(EntityId entity) { destroys.push_back(entity); }
+
+    template <typename T>
+    void add_component(EntityId entity, const T& component) {
+        static_assert(alignof(T) <= entity_commands_detail::BLOCK_ALIGN, "component alignment too large for the arena");
+        void* data = allocate(sizeof(T), alignof(T));
+        new (data) T(component);
+        commands.push_back({entity, component_index<T>(), entity_commands_detail::CommandKind::Add, data,
+                            &entity_commands_detail::ops_for<T>()});
+    }
+
+    template <typename T>
+    void remove_component(EntityId entity) {
+        commands.push_back({entity, component_index<T>(), entity_commands_detail::CommandKind::Remove, nullptr,
+                            &entity_commands_detail::ops_for<T>()});
+    }
+
+    bool empty() const { return pending_creates == 0 && commands.empty() && destroys.empty(); }
+    size_t size() const { return pending_creates + commands.size() + destroys.size(); }
+
+    // Applies everything and clears the buffer. Returns the entities
+    // create_entity() stood for, in the order it was called.
+    std::vector<EntityId> playback(EntityStorage& world) {
+        EntityCommandBuffer* self = this;
+        playback(world, &self, 1);
+        return std::move(created);
+    }
+
+    // Several buffers as one batch (e.g. one per thread)
+    static void playback(EntityStorage& world, EntityCommandBuffer* const* buffers, size_t count) {
+        using namespace entity_commands_detail;
+
+        size_t creates = 0, total = 0;
+        for (size_t b = 0; b < count; b++) {
+            creates += buffers[b]->pending_creates;
+            total += buffers[b]->commands.size();
+        }
+        world.reserve_entities(creates);
+        for (size_t b = 0; b < count; b++) {
+            EntityCommandBuffer& buffer = *buffers[b];
+            buffer.created.clear();
+            buffer.created.reserve(buffer.pending_creates);
+            for (uint32_t i = 0; i < buffer.pending_creates; i++) buffer.created.push_back(world.create_entity());
+        }
+
+        // Resolved handles, so sorting groups a created entity with itself
+        std::vector<Command> batch;
+        batch.reserve(total);
+        for (size_t b = 0; b < count; b++) {
+            for (Command command : buffers[b]->commands) {
+                command.entity = buffers[b]->resolve(command.entity);
+                batch.push_back(command);
+            }
+        }
+        std::stable_sort(batch.begin(), batch.end(), [](const Command& a, const Command& b) {
+            if (a.component != b.component) return a.component < b.component;
+            return entity_index(a.entity) < entity_index(b.entity);
+        });
+
+        for (size_t begin = 0; begin < batch.size();) {
+            size_t end = begin, adds = 0;
+            while (end < batch.size() && batch[end].component == batch[begin].component) {
+                if (batch[end].kind == CommandKind::Add) adds++;
+                end++;
+            }
+            if (adds > 1) batch[begin].ops->reserve(world, adds);
+            for (size_t i = begin; i < end; i++) {
+                if (batch[i].kind == CommandKind::Add) {
+                    batch[i].ops->add(world, batch[i].entity, batch[i].data);
+                } else {
+                    batch[i].ops->remove(world, batch[i].entity);
+                }
+            }
+            begin = end;
+        }
+
+        for (size_t b = 0; b < count; b++) {
+            for (EntityId entity : buffers[b]->destroys) world.destroy_entity(buffers[b]->resolve(entity));
+        }
+        for (size_t b = 0; b < count; b++) buffers[b]->clear_commands();
+    }
+
+    // Drops everything recorded, without applying it
+    void clear() {
+        clear_commands();
+        created.clear();
+    }
+
+    // clear(), and frees the arena block it keeps for reuse
+    void shrink() {
+        clear();
+        for (const auto& block : blocks) ::operator delete(block.data, std::align_val_t(entity_commands_detail::BLOCK_ALIGN));
+        blocks.clear();
+    }
+
+private:
+    struct Block {
+        unsigned char* data;
+        size_t used;
+        size_t capacity;
+    };
+
+    uint32_t pending_creates = 0;
+    std::vector<entity_commands_detail::Command> commands;
+    std::vector<EntityId> destroys;
+    std::vector<EntityId> created;  // Last playback: pending index -> entity
+    std::vector<Block> blocks;      // Recorded components; never move once written
+
+    EntityId resolve(EntityId entity) const {
+        if (entity_generation(entity) != PENDING_GENERATION) return entity;
+        return entity_index(entity) < created.size() ? created[entity_index(entity)] : INVALID_ENTITY;
+    }
+
+    void* allocate(size_t size, size_t align) {
+        if (blocks.empty() || (blocks.back().used + align - 1) / align * align + size > blocks.back().capacity) {
+            size_t capacity = std::max(size, entity_commands_detail::BLOCK_SIZE);
+            Block block{static_cast<unsigned char*>(::operator new(capacity, std::align_val_t(entity_commands_detail::BLOCK_ALIGN))),
+                        0, capacity};
+            blocks.push_back(block);
+        }
+        Block& block = blocks.back();
+        size_t offset = (block.used + align - 1) / align * align;
+        block.used = offset + size;
+        return block.data + offset;
+    }
+
+    // Keeps the first block for the next frame's commands
+    void clear_commands() {
+        for (const auto& command : commands) {
+            if (command.data) command.ops->destroy(command.data);
+        }
+        commands.clear();
+        destroys.clear();
+        pending_creates = 0;
+        for (size_t i = 1; i < blocks.size(); i++) {
+            ::operator delete(blocks[i].data, std::align_val_t(entity_commands_detail::BLOCK_ALIGN));
+        }
+        if (!blocks.empty()) {
+            blocks.resize(1);
+            blocks[0].used = 0;
+        }
+    }
+};
+
+/**
+ * One EntityCommandBuffer per job system thread, so parallel systems record
+ * without locks: local() picks the calling thread's. Threads that aren't
+ * workers share buffer 0, so only one of them may record at a time.
+ */
+class ThreadCommandBuffers {
+public:
+    explicit ThreadCommandBuffers(JobSystem& jobs = JobSystem::shared()) : jobs(jobs) {
+        for (uint32_t i = 0; i < jobs.thread_count(); i++) buffers.push_back(std::make_unique<EntityCommandBuffer>());
+    }
+
+    EntityCommandBuffer& local() { return *buffers[jobs.thread_index()]; }
+
+    // At a sync point, with no system running: all threads' commands as
+    // one batch
+    void playback(EntityStorage& world) {
+        std::vector<EntityCommandBuffer*> all;
+        for (auto& buffer : buffers) all.push_back(buffer.get());
+        EntityCommandBuffer::playback(world, all.data(), all.size());
+    }
+
+private:
+    JobSystem& jobs;
+    std::vector<std::unique_ptr<EntityCommandBuffer>> buffers;
+};
+
+#endif // EDEN_ENTITY_COMMANDS_H
@@ -6,11 +6,119 @@
 #include <memory>
 #include <typeinfo>
 #include <typeindex>
+#include <tuple>
+#include <map>
+#include <stdexcept>
+#include <new>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
 
-// Basic entity identifier
-using EntityId = uint32_t;
+#include "component_registry.h"
+#include "job_system.h"
+
+// Entity handle: slot index in the low 32 bits, generation in the high 32.
+// Destroying an entity bumps its slot's generation, so handles kept past the
+// destroy stop matching instead of reaching whatever reuses the slot.
+using EntityId = uint64_t;
 static constexpr EntityId INVALID_ENTITY = 0;
 
+inline uint32_t entity_index(EntityId entity) { return static_cast<uint32_t>(entity); }
+inline uint32_t entity_generation(EntityId entity) { return static_cast<uint32_t>(entity >> 32); }
+inline EntityId make_entity(uint32_t index, uint32_t generation) {
+    return (EntityId(generation) << 32) | index;
+}
+
+// Never issued by EntityStorage: marks handles of entities an
+// EntityCommandBuffer will create at playback
+static constexpr uint32_t PENDING_GENERATION = UINT32_MAX;
+
+// Dense arrays start on a cache line, so parallel_for's element ranges never
+// share one between jobs
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(job_system_detail::CACHE_LINE)));
+    }
+    void deallocate(T* ptr, size_t) { ::operator delete(ptr, std::align_val_t(job_system_detail::CACHE_LINE)); }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+// -----------------------------------------------------------------------------
+// Paged arrays: entity index -> value in 4096-entry pages, allocated when an
+// entry is first set and freed when its last one is cleared. One high entity
+// index costs a page, not an array reaching up to it.
+// -----------------------------------------------------------------------------
+template <typename V, V Empty>
+class PagedArray {
+public:
+    static constexpr uint32_t PAGE_SIZE = 4096;
+
+    V get(uint32_t index) const {
+        uint32_t page = index / PAGE_SIZE;
+        if (page >= pages.size() || !pages[page].entries) return Empty;
+        return pages[page].entries[index % PAGE_SIZE];
+    }
+
+    void set(uint32_t index, V value) {
+        uint32_t page = index / PAGE_SIZE;
+        if (value == Empty) {
+            if (page >= pages.size() || !pages[page].entries) return;
+            Page& cleared = pages[page];
+            V& entry = cleared.entries[index % PAGE_SIZE];
+            if (entry == Empty) return;
+            entry = Empty;
+            if (--cleared.live == 0) {
+                cleared.entries.reset();
+                allocated--;
+            }
+            return;
+        }
+        if (page >= pages.size()) pages.resize(page + 1);
+        Page& target = pages[page];
+        if (!target.entries) {
+            target.entries.reset(new V[PAGE_SIZE]);
+            std::fill_n(target.entries.get(), PAGE_SIZE, Empty);
+            allocated++;
+        }
+        V& entry = target.entries[index % PAGE_SIZE];
+        if (entry == Empty) target.live++;
+        entry = value;
+    }
+
+    size_t page_count() const { return allocated; }
+    size_t memory_bytes() const { return pages.capacity() * sizeof(Page) + allocated * PAGE_SIZE * sizeof(V); }
+
+private:
+    struct Page {
+        std::unique_ptr<V[]> entries;  // nullptr = every entry Empty
+        uint32_t live = 0;             // Entries that aren't Empty
+    };
+
+    std::vector<Page> pages;
+    size_t allocated = 0;
+};
+
+// Bytes held by one storage, for the memory budget views
+struct StorageMemory {
+    size_t count = 0;         // Components stored
+    size_t dense_bytes = 0;   // Components and their entity ids (capacity, not size)
+    size_t sparse_bytes = 0;  // Index pages and page table
+    size_t sparse_pages = 0;
+
+    size_t total_bytes() const { return dense_bytes + sparse_bytes; }
+};
+
 // -----------------------------------------------------------------------------
 // Sparse-set storage for a single component type
 // -----------------------------------------------------------------------------
@@ -18,45 +126,56 @@ template <typename T>
 class ComponentStorage {
 public:
     void add(EntityId entity, const T& component) {
-        if (entity >= sparse.size()) {
-            sparse.resize(entity + 1, invalid_marker);
-        }
-        if (sparse[entity] != invalid_marker) {
-            // Already has this component; overwrite
-            dense[sparse[entity]] = component;
+        uint32_t index = entity_index(entity);
+        uint32_t slot = sparse.get(index);
+        if (slot != invalid_marker) {
+            // Already has this component (or a stale generation does); overwrite
+            dense[slot] = component;
+            entities[slot] = entity;
             return;
         }
-        sparse[entity] = static_cast<uint32_t>(dense.size());
+        sparse.set(index, static_cast<uint32_t>(dense.size()));
         dense.emplace_back(component);
         entities.emplace_back(entity);
     }
 
-    void remove(EntityId entity) {
-        if (entity >= sparse.size() || sparse[entity] == invalid_marker) {
-            return;
+    // Returns whether the entity had the component
+    bool remove(EntityId entity) {
+        if (!has(entity)) {
+            return false;
         }
-        uint32_t idx = sparse[entity];
+        uint32_t idx = sparse.get(entity_index(entity));
         uint32_t last = static_cast<uint32_t>(dense.size() - 1);
 
         // Swap-remove to keep dense packed
         dense[idx] = std::move(dense[last]);
         entities[idx] = entities[last];
-        sparse[entities[idx]] = idx;
+        sparse.set(entity_index(entities[idx]), idx);
 
         dense.pop_back();
         entities.pop_back();
-        sparse[entity] = invalid_marker;
+        sparse.set(entity_index(entity), invalid_marker);
+        return true;
     }
 
     T* get(EntityId entity) {
-        if (entity >= sparse.size() || sparse[entity] == invalid_marker) {
+        if (!has(entity)) {
             return nullptr;
         }
-        return &dense[sparse[entity]];
+        return &dense[sparse.get(entity_index(entity))];
     }
 
+    const T* get(EntityId entity) const {
+        if (!has(entity)) {
+            return nullptr;
+        }
+        return &dense[sparse.get(entity_index(entity))];
+    }
+
+    // Only this exact handle: a stale generation of the same slot misses
     bool has(EntityId entity) const {
-        return entity < sparse.size() && sparse[entity] != invalid_marker;
+        uint32_t slot = sparse.get(entity_index(entity));
+        return slot != invalid_marker && entities[slot] == entity;
     }
 
     template <typename Func>
@@ -66,12 +185,53 @@ public:
         }
     }
 
+    // for_each across the job system; func must only touch the component it
+    // is given (and read others), and not add or remove components
+    template <typename Func>
+    void parallel_for_each(Func&& func) {
+        T* components = dense.data();
+        const EntityId* ids = entities.data();
+        parallel_for(dense.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                func(ids[i], components[i]);
+            }
+        });
+    }
+
     size_t size() const { return dense.size(); }
+    void reserve(size_t additional) {
+        dense.reserve(dense.size() + additional);
+        entities.reserve(entities.size() + additional);
+    }
+    T* data() { return dense.data(); }
+    const EntityId* entity_data() const { return entities.data(); }
+
+    StorageMemory memory_usage() const {
+        StorageMemory memory;
+        memory.count = dense.size();
+        memory.dense_bytes = dense.capacity() * sizeof(T) + entities.capacity() * sizeof(EntityId);
+        memory.sparse_bytes = sparse.memory_bytes();
+        memory.sparse_pages = sparse.page_count();
+        return memory;
+    }
+
+    // Dense position of entity's component; the entity must have one
+    uint32_t index_of(EntityId entity) const { return sparse.get(entity_index(entity)); }
+
+    // Exchanges two dense slots (used by owning queries to keep their
+    // members packed at the front)
+    void swap_entries(uint32_t a, uint32_t b) {
+        if (a == b) return;
+        std::swap(dense[a], dense[b]);
+        std::swap(entities[a], entities[b]);
+        sparse.set(entity_index(entities[a]), a);
+        sparse.set(entity_index(entities[b]), b);
+    }
 
 private:
     static constexpr uint32_t invalid_marker = UINT32_MAX;
-    std::vector<uint32_t> sparse;      // entity -> dense index
-    std::vector<T> dense;              // packed components
+    PagedArray<uint32_t, invalid_marker> sparse;     // entity index -> dense index
+    std::vector<T, CacheAlignedAllocator<T>> dense;  // packed components
     std::vector<EntityId> entities;    // packed entity ids
 };
 
@@ -81,94 +241,1096 @@ private:
 // -----------------------------------------------------------------------------
 struct IComponentStorage {
     virtual ~IComponentStorage() = default;
-    virtual void remove(EntityId entity) = 0;
+    virtual bool remove(EntityId entity) = 0;
+    virtual bool has(EntityId entity) const = 0;
+    virtual StorageMemory memory_usage() const = 0;
+    virtual const char* name() const = 0;
 };
 
+// The generated name for codegen components, the typeid name otherwise
+template <typename T>
+const char* component_name() {
+    if constexpr (component_index_detail::is_generated<T>::value) return ComponentMetadata<T>::name();
+    return typeid(T).name();
+}
+
 template <typename T>
 struct StorageWrapper final : IComponentStorage {
     ComponentStorage<T> storage;
-    void remove(EntityId entity) override { storage.remove(entity); }
+    bool remove(EntityId entity) override { return storage.remove(entity); }
+    bool has(EntityId entity) const override { return storage.has(entity); }
+    StorageMemory memory_usage() const override { return storage.memory_usage(); }
+    const char* name() const override { return component_name<T>(); }
 };
 
+// -----------------------------------------------------------------------------
+// Archetype storage: entities with the same component set share 16 KB chunks,
+// one SoA column per component, so multi-component queries walk memory
+// linearly instead of doing a sparse lookup per entity and component
+// -----------------------------------------------------------------------------
+enum class StorageMode {
+    SparseSet,  // One ComponentStorage<T> per type; cheapest to add/remove
+    Archetype   // Chunked by component set; fastest to iterate
+};
+
+namespace archetype_detail {
+
+static constexpr size_t CHUNK_SIZE = 16 * 1024;
+static constexpr size_t CHUNK_ALIGN = 64;  // Cache line; columns start aligned to their type
+
+// What a chunk needs to know to move and destroy a component it cannot name
+struct TypeInfo {
+    uint32_t key;  // component_index<T>()
+    size_t size;
+    size_t align;
+    void (*relocate)(void* dst, void* src);  // Move-construct into dst, destroy src
+    void (*destroy)(void* ptr);
+};
+
+template <typename T>
+const TypeInfo& type_info() {
+    static const TypeInfo info{
+        component_index<T>(), sizeof(T), alignof(T),
+        [](void* dst, void* src) {
+            T* from = static_cast<T*>(src);
+            new (dst) T(std::move(*from));
+            from->~T();
+        },
+        [](void* ptr) { static_cast<T*>(ptr)->~T(); }
+    };
+    return info;
+}
+
+struct Chunk {
+    unsigned char* data = nullptr;
+    uint32_t count = 0;  // Live rows; every chunk but an archetype's last is full
+};
+
+class Archetype {
+public:
+    // types: sorted by key, no duplicates
+    explicit Archetype(std::vector<const TypeInfo*> types) : types(std::move(types)) {
+        size_t align = CHUNK_ALIGN;
+        size_t row = sizeof(EntityId);
+        for (const TypeInfo* type : this->types) {
+            align = std::max(align, type->align);
+            row += type->size;
+        }
+        chunk_align = align;
+        for (size_t c = 0; c < this->types.size(); c++) {
+            uint32_t key = this->types[c]->key;
+            if (key >= column_of.size()) column_of.resize(key + 1, -1);
+            column_of[key] = static_cast<int>(c);
+        }
+        
+        // Largest row count whose aligned columns still fit; a row bigger
+        // than a chunk gets a chunk of its own
+        capacity = static_cast<uint32_t>(std::max<size_t>(CHUNK_SIZE / row, 1));
+        while (layout(capacity) > CHUNK_SIZE && capacity > 1) capacity--;
+        chunk_bytes = std::max(layout(capacity), CHUNK_SIZE);
+    }
+    
+    ~Archetype() {
+        for (Chunk& chunk : chunks) {
+            for (size_t c = 0; c < types.size(); c++) {
+                for (uint32_t row = 0; row < chunk.count; row++) types[c]->destroy(at(chunk, c, row));
+            }
+            ::operator delete(chunk.data, std::align_val_t(chunk_align));
+        }
+    }
+    
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+    
+    // Column index of a component index, or -1
+    int column(uint32_t key) const { return key < column_of.size() ? column_of[key] : -1; }
+    
+    EntityId* entities(Chunk& chunk) const { return reinterpret_cast<EntityId*>(chunk.data); }
+    void* column_data(Chunk& chunk, size_t c) const { return chunk.data + offsets[c]; }
+    void* at(Chunk& chunk, size_t c, uint32_t row) const {
+        return chunk.data + offsets[c] + size_t(row) * types[c]->size;
+    }
+    
+    // Appends an uninitialized row for entity; returns {chunk, row}
+    std::pair<uint32_t, uint32_t> push(EntityId entity) {
+        if (chunks.empty() || chunks.back().count == capacity) {
+            Chunk chunk;
+            chunk.data = static_cast<unsigned char*>(::operator new(chunk_bytes, std::align_val_t(chunk_align)));
+            chunks.push_back(chunk);
+        }
+        Chunk& chunk = chunks.back();
+        entities(chunk)[chunk.count] = entity;
+        return {static_cast<uint32_t>(chunks.size() - 1), chunk.count++};
+    }
+    
+    // Fills (chunk, row) with the archetype's last row, whose (moved) entity
+    // id is returned - INVALID_ENTITY if the last row was this one. The
+    // row's own components must already be destroyed or moved out.
+    EntityId swap_remove(uint32_t chunk_index, uint32_t row) {
+        Chunk& last = chunks.back();
+        uint32_t last_row = last.count - 1;
+        EntityId moved = INVALID_ENTITY;
+        if (chunk_index != chunks.size() - 1 || row != last_row) {
+            Chunk& chunk = chunks[chunk_index];
+            for (size_t c = 0; c < types.size(); c++) {
+                types[c]->relocate(at(chunk, c, row), at(last, c, last_row));
+            }
+            moved = entities(last)[last_row];
+            entities(chunk)[row] = moved;
+        }
+        if (--last.count == 0) {
+            ::operator delete(last.data, std::align_val_t(chunk_align));
+            chunks.pop_back();
+        }
+        return moved;
+    }
+    
+    std::vector<const TypeInfo*> types;
+    std::vector<size_t> offsets;   // Column byte offsets in a chunk (set by layout())
+    std::vector<Chunk> chunks;
+    uint32_t capacity = 0;          // Rows per chunk
+    size_t chunk_bytes = 0;
+    size_t chunk_align = CHUNK_ALIGN;
+    
+    // Neighbouring archetypes one component away (nullptr = no components)
+    std::unordered_map<uint32_t, Archetype*> add_edges;
+    std::unordered_map<uint32_t, Archetype*> remove_edges;
+    
+private:
+    std::vector<int> column_of;     // Component index -> column, -1 = absent
+    
+    // Entity ids, then each column aligned to its type; returns the bytes used
+    size_t layout(uint32_t rows) {
+        offsets.resize(types.size());
+        size_t offset = sizeof(EntityId) * size_t(rows);
+        for (size_t c = 0; c < types.size(); c++) {
+            offset = (offset + types[c]->align - 1) / types[c]->align * types[c]->align;
+            offsets[c] = offset;
+            offset += types[c]->size * size_t(rows);
+        }
+        return offset;
+    }
+};
+
+} // namespace archetype_detail
+
+/**
+ * Entities grouped by their exact component set. Adding or removing a
+ * component moves the entity to the neighbouring archetype (cached as an
+ * edge, so only the first move between two sets searches); entities with no
+ * components live in no chunk at all.
+ *
+ * Component pointers stay valid until the next add/remove/destroy, like
+ * ComponentStorage's dense array. Don't change an entity's components from
+ * inside for_each - collect the ids first.
+ */
+class ArchetypeStorage {
+public:
+    template <typename T>
+    void add(EntityId entity, const T& component) {
+        if (T* existing = get<T>(entity)) {
+            *existing = component;
+            return;
+        }
+        Record& record = record_for(entity);
+        archetype_detail::Archetype* target = record.archetype
+            ? add_edge(record.archetype, archetype_detail::type_info<T>())
+            : find_or_create({&archetype_detail::type_info<T>()});
+        move_entity(entity, target);
+        
+        Record& moved = records[entity_index(entity)];
+        int c = target->column(component_index<T>());
+        new (target->at(target->chunks[moved.chunk], c, moved.row)) T(component);
+    }
+    
+    template <typename T>
+    void remove(EntityId entity) {
+        if (!has<T>(entity)) return;
+        Record& record = records[entity_index(entity)];
+        move_entity(entity, remove_edge(record.archetype, component_index<T>()));
+    }
+    
+    void destroy(EntityId entity) {
+        if (entity_index(entity) >= records.size() || !records[entity_index(entity)].archetype) return;
+        Record& record = records[entity_index(entity)];
+        archetype_detail::Archetype* archetype = record.archetype;
+        archetype_detail::Chunk& chunk = archetype->chunks[record.chunk];
+        for (size_t c = 0; c < archetype->types.size(); c++) {
+            archetype->types[c]->destroy(archetype->at(chunk, c, record.row));
+        }
+        release_row(record);
+        record = Record();
+    }
+    
+    template <typename T>
+    T* get(EntityId entity) {
+        if (entity_index(entity) >= records.size() || !records[entity_index(entity)].archetype) return nullptr;
+        const Record& record = records[entity_index(entity)];
+        int c = record.archetype->column(component_index<T>());
+        if (c < 0) return nullptr;
+        return static_cast<T*>(record.archetype->at(record.archetype->chunks[record.chunk], c, record.row));
+    }
+    
+    template <typename T>
+    const T* get(EntityId entity) const { return const_cast<ArchetypeStorage*>(this)->get<T>(entity); }
+    
+    // func(component_index) for each component the entity holds
+    template <typename Func>
+    void for_each_component(EntityId entity, Func&& func) const {
+        if (entity_index(entity) >= records.size() || !records[entity_index(entity)].archetype) return;
+        for (const archetype_detail::TypeInfo* type : records[entity_index(entity)].archetype->types) func(type->key);
+    }
+    
+    template <typename T>
+    bool has(EntityId entity) const {
+        return entity_index(entity) < records.size() && records[entity_index(entity)].archetype &&
+               records[entity_index(entity)].archetype->column(component_index<T>()) >= 0;
+    }
+    
+    // func(const EntityId* ids, Ts* columns..., size_t count) once per
+    // chunk holding all of Ts
+    template <typename... Ts, typename Func>
+    void for_each_chunk(Func&& func) {
+        for_each_match<Ts...>([&](archetype_detail::Archetype& archetype, const int* columns) {
+            for (archetype_detail::Chunk& chunk : archetype.chunks) {
+                call_chunk<Ts...>(func, archetype, chunk, columns, std::index_sequence_for<Ts...>());
+            }
+        });
+    }
+    
+    // for_each_chunk with one job per chunk (16 KB, cache-line aligned)
+    template <typename... Ts, typename Func>
+    void parallel_for_each_chunk(Func&& func) {
+        struct Work {
+            archetype_detail::Archetype* archetype;
+            archetype_detail::Chunk* chunk;
+            int columns[sizeof...(Ts)];
+        };
+        std::vector<Work> work;
+        for_each_match<Ts...>([&](archetype_detail::Archetype& archetype, const int* columns) {
+            for (archetype_detail::Chunk& chunk : archetype.chunks) {
+                Work item{&archetype, &chunk, {}};
+                std::copy(columns, columns + sizeof...(Ts), item.columns);
+                work.push_back(item);
+            }
+        });
+        parallel_for(work.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                call_chunk<Ts...>(func, *work[i].archetype, *work[i].chunk, work[i].columns,
+                                  std::index_sequence_for<Ts...>());
+            }
+        }, 1);
+    }
+    
+    // func(EntityId, Ts&...) for every entity holding all of Ts
+    template <typename... Ts, typename Func>
+    void for_each(Func&& func) {
+        for_each_chunk<Ts...>([&](const EntityId* ids, Ts*... columns, size_t count) {
+            for (size_t i = 0; i < count; i++) func(ids[i], columns[i]...);
+        });
+    }
+    
+    template <typename... Ts, typename Func>
+    void parallel_for_each(Func&& func) {
+        parallel_for_each_chunk<Ts...>([&](const EntityId* ids, Ts*... columns, size_t count) {
+            for (size_t i = 0; i < count; i++) func(ids[i], columns[i]...);
+        });
+    }
+    
+    size_t archetype_count() const { return archetypes.size(); }
+    
+    // Chunks count as dense, entity records as sparse
+    StorageMemory memory_usage() const {
+        StorageMemory memory;
+        for (const auto& archetype : archetypes) {
+            for (const archetype_detail::Chunk& chunk : archetype->chunks) memory.count += chunk.count;
+            memory.dense_bytes += archetype->chunks.size() * archetype->chunk_bytes;
+        }
+        memory.sparse_bytes = records.capacity() * sizeof(Record);
+        return memory;
+    }
+    
+private:
+    struct Record {
+        archetype_detail::Archetype* archetype = nullptr;  // nullptr = no components
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+    };
+    
+    std::vector<Record> records;  // Indexed by entity_index()
+    std::vector<std::unique_ptr<archetype_detail::Archetype>> archetypes;
+    std::map<std::vector<uint32_t>, archetype_detail::Archetype*> by_signature;
+    
+    Record& record_for(EntityId entity) {
+        if (entity_index(entity) >= records.size()) records.resize(entity_index(entity) + 1);
+        return records[entity_index(entity)];
+    }
+    
+    // match(archetype, columns) for each non-empty archetype holding all of
+    // Ts; columns[i] is Ts[i]'s column
+    template <typename... Ts, typename Func>
+    void for_each_match(Func&& match) {
+        const uint32_t keys[] = {component_index<Ts>()...};
+        for (auto& owned : archetypes) {
+            archetype_detail::Archetype& archetype = *owned;
+            if (archetype.chunks.empty()) continue;
+            int columns[sizeof...(Ts)];
+            bool found = true;
+            for (size_t i = 0; i < sizeof...(Ts) && found; i++) {
+                columns[i] = archetype.column(keys[i]);
+                found = columns[i] >= 0;
+            }
+            if (found) match(archetype, static_cast<const int*>(columns));
+        }
+    }
+    
+    template <typename... Ts, typename Func, size_t... I>
+    static void call_chunk(Func& func, archetype_detail::Archetype& archetype, archetype_detail::Chunk& chunk,
+                           const int* columns, std::index_sequence<I...>) {
+        func(static_cast<const EntityId*>(archetype.entities(chunk)),
+             static_cast<Ts*>(archetype.column_data(chunk, columns[I]))..., size_t(chunk.count));
+    }
+    
+    archetype_detail::Archetype* find_or_create(std::vector<const archetype_detail::TypeInfo*> types) {
+        std::sort(types.begin(), types.end(), [](const archetype_detail::TypeInfo* a, const archetype_detail::TypeInfo* b) {
+            return a->key < b->key;
+        });
+        std::vector<uint32_t> signature;
+        signature.reserve(types.size());
+        for (const auto* type : types) signature.push_back(type->key);
+        
+        auto it = by_signature.find(signature);
+        if (it != by_signature.end()) return it->second;
+        archetypes.push_back(std::make_unique<archetype_detail::Archetype>(std::move(types)));
+        archetype_detail::Archetype* archetype = archetypes.back().get();
+        by_signature.emplace(std::move(signature), archetype);
+        return archetype;
+    }
+    
+    archetype_detail::Archetype* add_edge(archetype_detail::Archetype* from, const archetype_detail::TypeInfo& type) {
+        auto it = from->add_edges.find(type.key);
+        if (it != from->add_edges.end()) return it->second;
+        std::vector<const archetype_detail::TypeInfo*> types = from->types;
+        types.push_back(&type);
+        archetype_detail::Archetype* to = find_or_create(std::move(types));
+        from->add_edges[type.key] = to;
+        to->remove_edges[type.key] = from;
+        return to;
+    }
+    
+    archetype_detail::Archetype* remove_edge(archetype_detail::Archetype* from, uint32_t key) {
+        auto it = from->remove_edges.find(key);
+        if (it != from->remove_edges.end()) return it->second;
+        std::vector<const archetype_detail::TypeInfo*> types;
+        for (const auto* type : from->types) {
+            if (type->key != key) types.push_back(type);
+        }
+        archetype_detail::Archetype* to = types.empty() ? nullptr : find_or_create(std::move(types));
+        from->remove_edges[key] = to;
+        if (to) to->add_edges[key] = from;
+        return to;
+    }
+    
+    // Moves the components both archetypes share, destroys the rest, and
+    // leaves target columns the source lacks uninitialized for the caller
+    void move_entity(EntityId entity, archetype_detail::Archetype* target) {
+        Record& record = record_for(entity);
+        Record next;
+        next.archetype = target;
+        if (target) std::tie(next.chunk, next.row) = target->push(entity);
+        
+        if (archetype_detail::Archetype* source = record.archetype) {
+            archetype_detail::Chunk& chunk = source->chunks[record.chunk];
+            for (size_t c = 0; c < source->types.size(); c++) {
+                void* src = source->at(chunk, c, record.row);
+                int to = target ? target->column(source->types[c]->key) : -1;
+                if (to >= 0) {
+                    source->types[c]->relocate(target->at(target->chunks[next.chunk], to, next.row), src);
+                } else {
+                    source->types[c]->destroy(src);
+                }
+            }
+            release_row(record);
+        }
+        records[entity_index(entity)] = next;
+    }
+    
+    // Frees a row whose components are gone, patching the entity moved into it
+    void release_row(const Record& record) {
+        EntityId moved = record.archetype->swap_remove(record.chunk, record.row);
+        if (moved != INVALID_ENTITY) {
+            records[entity_index(moved)].chunk = record.chunk;
+            records[entity_index(moved)].row = record.row;
+        }
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Change tracking: every write through EntityStorage stamps the component
+// with the current tick, so a system can visit only what changed since its
+// last run, and adds/removes land in event buffers
+// -----------------------------------------------------------------------------
+using ChangeTick = uint64_t;
+
+struct ChangeEvent {
+    EntityId entity;
+    ChangeTick tick;
+};
+
+namespace change_detail {
+
+// One component type's history, kept by EntityStorage in either mode
+struct ComponentChanges {
+    PagedArray<ChangeTick, 0> changed_tick;  // By entity_index(); 0 = never written
+    ChangeTick all_changed = 0;            // Last mutable pass over every entity
+    std::vector<ChangeEvent> changed;      // First write per entity per tick, in tick order
+    std::vector<ChangeEvent> added;
+    std::vector<ChangeEvent> removed;
+};
+
+// Events after `since`; the buffers are in tick order
+inline std::pair<const ChangeEvent*, const ChangeEvent*> events_after(const std::vector<ChangeEvent>& events,
+                                                                      ChangeTick since) {
+    auto first = std::partition_point(events.begin(), events.end(),
+                                      [since](const ChangeEvent& e) { return e.tick <= since; });
+    return {events.data() + (first - events.begin()), events.data() + events.size()};
+}
+
+inline void drop_through(std::vector<ChangeEvent>& events, ChangeTick tick) {
+    auto last = std::partition_point(events.begin(), events.end(),
+                                     [tick](const ChangeEvent& e) { return e.tick <= tick; });
+    events.erase(events.begin(), last);
+}
+
+} // namespace change_detail
+
+// -----------------------------------------------------------------------------
+// Component masks: one bit per component index, so has_component is a bit
+// test and destroy_entity visits only the storages an entity uses
+// -----------------------------------------------------------------------------
+
+// Hand-written and runtime-registered types, on top of the generated ones
+static constexpr uint32_t MAX_RUNTIME_COMPONENTS = 64;
+static constexpr uint32_t MAX_COMPONENT_TYPES = MAX_GENERATED_COMPONENTS + MAX_RUNTIME_COMPONENTS;
+
+struct ComponentMask {
+    static constexpr uint32_t WORDS = (MAX_COMPONENT_TYPES + 63) / 64;
+    uint64_t words[WORDS] = {};
+
+    bool test(uint32_t index) const { return (words[index / 64] >> (index % 64)) & 1; }
+    void set(uint32_t index) { words[index / 64] |= uint64_t(1) << (index % 64); }
+    void reset(uint32_t index) { words[index / 64] &= ~(uint64_t(1) << (index % 64)); }
+
+    // func(component_index) for each set bit, lowest first
+    template <typename Func>
+    void for_each(Func&& func) const {
+        for (uint32_t w = 0; w < WORDS; w++) {
+            for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) func(w * 64 + lowest_bit(bits));
+        }
+    }
+
+private:
+    static uint32_t lowest_bit(uint64_t bits) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+    }
+};
+
+namespace query_detail {
+
+// What EntityStorage needs to keep a cached query's matches current
+struct QueryBase {
+    virtual ~QueryBase() = default;
+    virtual void on_added(EntityId entity) = 0;     // Gained one of the query's types
+    virtual void on_removing(EntityId entity) = 0;  // About to lose one
+};
+
+} // namespace query_detail
+
+template <typename... Ts>
+class Query;
+
 // -----------------------------------------------------------------------------
 // EntityStorage: manages entities + per-component storages
 // -----------------------------------------------------------------------------
 class EntityStorage {
 public:
+    explicit EntityStorage(StorageMode mode = StorageMode::SparseSet) : mode(mode) {}
+    
+    StorageMode storage_mode() const { return mode; }
+    
     EntityId create_entity() {
+        uint32_t index;
         if (!free_list.empty()) {
-            EntityId id = free_list.back();
+            index = free_list.back();
             free_list.pop_back();
-            return id;
+        } else {
+            index = static_cast<uint32_t>(generations.size());  // Slot 0 stays unused: INVALID_ENTITY
+            generations.push_back(0);
+            masks.emplace_back();
         }
-        return ++next_id;
+        return make_entity(index, generations[index]);
+    }
+
+    // Room for `count` more entities without growing
+    void reserve_entities(size_t count) {
+        size_t slots = generations.size() + (count > free_list.size() ? count - free_list.size() : 0);
+        generations.reserve(slots);
+        masks.reserve(slots);
     }
 
+    // Room for `count` more T without growing (sparse-set mode; archetype
+    // chunks are fixed-size anyway)
+    template <typename T>
+    void reserve_components(size_t count) {
+        if (mode == StorageMode::SparseSet) get_or_create<T>().storage.reserve(count);
+    }
+
+    // False once destroyed, even after its slot is reused
+    bool is_alive(EntityId entity) const {
+        uint32_t index = entity_index(entity);
+        return index != 0 && index < generations.size() && generations[index] == entity_generation(entity);
+    }
+
+    // Touches only the storages the entity's mask names; stale handles are
+    // ignored
     void destroy_entity(EntityId entity) {
-        // Remove entity from all component storages
-        for (auto& kv : storages) {
-            kv.second->remove(entity);
-        }
-        free_list.push_back(entity);
+        if (!is_alive(entity)) return;
+        uint32_t slot = entity_index(entity);
+        masks[slot].for_each([&](uint32_t index) {
+            if (mode == StorageMode::SparseSet) {
+                notify_removing(index, entity);
+                storages[index]->remove(entity);
+            }
+            record_removed(index, entity);
+        });
+        if (mode == StorageMode::Archetype) archetypes.destroy(entity);
+        masks[slot] = ComponentMask();
+        if (++generations[slot] == PENDING_GENERATION) generations[slot] = 0;  // Wraps after 2^32 reuses
+        free_list.push_back(slot);
     }
 
+    // Ignored for a destroyed entity
     template <typename T>
     void add_component(EntityId entity, const T& component) {
+        if (!is_alive(entity)) return;
+        uint32_t index = component_index<T>();
+        if (index >= MAX_COMPONENT_TYPES) throw std::length_error("too many component types for ComponentMask");
+        change_detail::ComponentChanges& changes = changes_for(index);
+        bool added = !masks[entity_index(entity)].test(index);
+        if (added) {
+            changes.added.push_back({entity, tick});
+            masks[entity_index(entity)].set(index);
+        }
+        mark_changed(component_index<T>(), entity);
+        if (mode == StorageMode::Archetype) {
+            archetypes.add(entity, component);
+            return;
+        }
         auto& wrap = get_or_create<T>();
         wrap.storage.add(entity, component);
+        if (added) notify_added(component_index<T>(), entity);
     }
 
+    // Non-const access counts as a write: the component is marked changed
+    // at the current tick. Use read_component() to look without marking.
     template <typename T>
     T* get_component(EntityId entity) {
+        if (!has_component<T>(entity)) return nullptr;
+        T* component = lookup<T>(entity);
+        if (component) mark_changed(component_index<T>(), entity);
+        return component;
+    }
+
+    template <typename T>
+    const T* read_component(EntityId entity) const {
+        if (!has_component<T>(entity)) return nullptr;
+        if (mode == StorageMode::Archetype) return archetypes.get<T>(entity);
         auto* wrap = find<T>();
         if (!wrap) return nullptr;
-        return wrap->storage.get(entity);
+        return static_cast<const ComponentStorage<T>&>(wrap->storage).get(entity);
     }
 
     template <typename T>
     bool has_component(EntityId entity) const {
-        auto* wrap = find<T>();
-        return wrap && wrap->storage.has(entity);
+        uint32_t index = component_index<T>();
+        return is_alive(entity) && index < MAX_COMPONENT_TYPES && masks[entity_index(entity)].test(index);
     }
 
     template <typename T>
     void remove_component(EntityId entity) {
-        auto* wrap = find<T>();
-        if (wrap) wrap->storage.remove(entity);
+        if (!has_component<T>(entity)) return;
+        record_removed(component_index<T>(), entity);
+        masks[entity_index(entity)].reset(component_index<T>());
+        if (mode == StorageMode::Archetype) {
+            archetypes.remove<T>(entity);
+            return;
+        }
+        notify_removing(component_index<T>(), entity);
+        find<T>()->storage.remove(entity);
     }
 
-    template <typename T, typename Func>
+    /**
+     * The cached query over Ts, created on first use and kept up to date by
+     * every add/remove/destroy from then on, so iterating it never
+     * intersects storages. In sparse-set mode the first query over a set of
+     * types none of which another query owns becomes owning: its members
+     * sit at the front of each of its storages in the same order, and it
+     * iterates them as aligned dense arrays. The reference stays valid as
+     * long as this storage lives (and doesn't move).
+     */
+    template <typename... Ts>
+    Query<Ts...>& query();
+
+    struct StorageReport {
+        const char* name;  // Component name (archetype mode: one "archetypes" entry)
+        StorageMemory memory;
+    };
+
+    // What each storage holds, for budget views and leak hunting
+    std::vector<StorageReport> memory_report() const {
+        std::vector<StorageReport> report;
+        if (mode == StorageMode::Archetype) {
+            report.push_back({"archetypes", archetypes.memory_usage()});
+            return report;
+        }
+        for (const auto& storage : storages) {
+            if (storage) report.push_back({storage->name(), storage->memory_usage()});
+        }
+        return report;
+    }
+
+    // func(EntityId, First&, Rest&...) for every entity holding all the
+    // types, all of which count as changed. Sparse-set mode walks First's
+    // storage and looks the rest up.
+    template <typename First, typename... Rest, typename Func>
     void for_each(Func&& func) {
-        auto* wrap = find<T>();
+        visit<First, Rest...>(func);
+        mark_all_changed<First, Rest...>();
+    }
+
+    // for_each with const references; marks nothing
+    template <typename First, typename... Rest, typename Func>
+    void for_each_read(Func&& func) {
+        visit<First, Rest...>(func);
+    }
+
+    // for_each spread over the job system (JobSystem::shared()). func may
+    // write the components it is given and read anything else (through
+    // read_component(), which is safe to call concurrently); it must not
+    // add or remove components or entities, or write shared state.
+    template <typename First, typename... Rest, typename Func>
+    void parallel_for_each(Func&& func) {
+        mark_all_changed<First, Rest...>();
+        if (mode == StorageMode::Archetype) {
+            archetypes.parallel_for_each<First, Rest...>(func);
+            return;
+        }
+        auto* wrap = find<First>();
         if (!wrap) return;
-        wrap->storage.for_each(std::forward<Func>(func));
+        std::tuple<StorageWrapper<Rest>*...> rest{find<Rest>()...};
+        if (!std::apply([](auto*... w) { return (true && ... && (w != nullptr)); }, rest)) return;
+        wrap->storage.parallel_for_each([&](EntityId entity, First& first) {
+            std::apply([&](auto*... w) {
+                call_if_all(func, entity, first, w->storage.get(entity)...);
+            }, rest);
+        });
+    }
+
+    // func(const EntityId* ids, First* columns, Rest*..., size_t count):
+    // whole chunks in archetype mode, one entity at a time in sparse-set mode
+    template <typename First, typename... Rest, typename Func>
+    void for_each_chunk(Func&& func) {
+        if (mode == StorageMode::Archetype) {
+            archetypes.for_each_chunk<First, Rest...>(func);
+            mark_all_changed<First, Rest...>();
+            return;
+        }
+        for_each<First, Rest...>([&](EntityId entity, First& first, Rest&... rest) {
+            func(static_cast<const EntityId*>(&entity), &first, &rest..., size_t(1));
+        });
+    }
+
+    // -------------------------------------------------------------------------
+    // Change detection
+    //
+    // A system keeps the tick returned by its last advance_tick() and passes
+    // it as `since`:
+    //
+    //   ChangeTick last_run = 0;
+    //   void sync_transforms(EntityStorage& world) {
+    //       world.for_each_changed<Transform>(last_run, [&](EntityId e, const Transform& t) { ... });
+    //       last_run = world.advance_tick();
+    //   }
+    //
+    // Events are kept until the end of the frame after the one they happened
+    // in (end_frame() twice), so systems running every frame see all of them.
+    // -------------------------------------------------------------------------
+
+    ChangeTick current_tick() const { return tick; }
+
+    // Closes the current tick and returns it: writes from here on are
+    // "changed since" the returned value
+    ChangeTick advance_tick() { return tick++; }
+
+    // Once per frame: drops events older than the previous frame and starts
+    // a new tick
+    void end_frame() {
+        for (auto& changes : change_log) {
+            change_detail::drop_through(changes.changed, kept_after);
+            change_detail::drop_through(changes.added, kept_after);
+            change_detail::drop_through(changes.removed, kept_after);
+        }
+        kept_after = tick++;
+    }
+
+    // Whether entity's T was written after `since`
+    template <typename T>
+    bool changed_since(EntityId entity, ChangeTick since) const {
+        const change_detail::ComponentChanges* changes = find_changes(component_index<T>());
+        if (!changes || !has_component<T>(entity)) return false;
+        if (changes->all_changed > since) return true;
+        return changes->changed_tick.get(entity_index(entity)) > since;
+    }
+
+    // func(EntityId, const T&) once per entity whose T was written after
+    // `since`. Costs the number of writes, unless a for_each over T ran
+    // since then (everything changed; every entity with T is visited).
+    template <typename T, typename Func>
+    void for_each_changed(ChangeTick since, Func&& func) {
+        const change_detail::ComponentChanges* changes = find_changes(component_index<T>());
+        if (!changes) return;
+        if (changes->all_changed > since) {
+            visit<T>(func);
+            return;
+        }
+        auto [first, last] = change_detail::events_after(changes->changed, since);
+        for (const ChangeEvent* event = first; event != last; ++event) {
+            // An entity written at several ticks is visited at its latest
+            if (changes->changed_tick.get(entity_index(event->entity)) != event->tick) continue;
+            if (const T* component = read_component<T>(event->entity)) func(event->entity, *component);
+        }
+    }
+
+    // func(EntityId) for each T added after `since`. The entity may have
+    // lost it again; check has_component() if that matters.
+    template <typename T, typename Func>
+    void for_each_added(ChangeTick since, Func&& func) const {
+        for_each_event(added_events<T>(since), func);
+    }
+
+    // func(EntityId) for each T removed (or destroyed with its entity)
+    // after `since`
+    template <typename T, typename Func>
+    void for_each_removed(ChangeTick since, Func&& func) const {
+        for_each_event(removed_events<T>(since), func);
+    }
+
+    template <typename T>
+    std::pair<const ChangeEvent*, const ChangeEvent*> added_events(ChangeTick since) const {
+        const change_detail::ComponentChanges* changes = find_changes(component_index<T>());
+        if (!changes) return {nullptr, nullptr};
+        return change_detail::events_after(changes->added, since);
+    }
+
+    template <typename T>
+    std::pair<const ChangeEvent*, const ChangeEvent*> removed_events(ChangeTick since) const {
+        const change_detail::ComponentChanges* changes = find_changes(component_index<T>());
+        if (!changes) return {nullptr, nullptr};
+        return change_detail::events_after(changes->removed, since);
     }
 
 private:
-    EntityId next_id {0};
-    std::vector<EntityId> free_list;
-    std::unordered_map<size_t, std::unique_ptr<IComponentStorage>> storages;
+    StorageMode mode;
+    std::vector<uint32_t> generations = std::vector<uint32_t>(1);    // By entity_index(): live (or next) generation
+    std::vector<ComponentMask> masks = std::vector<ComponentMask>(1);  // By entity_index()
+    std::vector<uint32_t> free_list;   // Slot indices
+    std::vector<std::unique_ptr<IComponentStorage>> storages;  // Indexed by component_index<T>()
+    ArchetypeStorage archetypes;
+
+    ChangeTick tick = 1;        // 0 is "before anything happened"
+    ChangeTick kept_after = 0;  // Events up to here are gone
+    std::vector<change_detail::ComponentChanges> change_log;  // Indexed by component_index<T>()
+
+    template <typename... Ts>
+    friend class Query;
+    friend class EcsSnapshot;
+
+    std::unordered_map<std::type_index, std::unique_ptr<query_detail::QueryBase>> queries;
+    std::vector<std::vector<query_detail::QueryBase*>> queries_by_component;  // Sparse-set mode only
+    std::vector<bool> owned;  // By component index: an owning query orders that storage
+
+    void notify_added(uint32_t index, EntityId entity) {
+        if (index >= queries_by_component.size()) return;
+        for (auto* query : queries_by_component[index]) query->on_added(entity);
+    }
+
+    void notify_removing(uint32_t index, EntityId entity) {
+        if (index >= queries_by_component.size()) return;
+        for (auto* query : queries_by_component[index]) query->on_removing(entity);
+    }
+
+    template <typename Func, typename First, typename... Rest>
+    static void call_if_all(Func& func, EntityId entity, First& first, Rest*... rest) {
+        if ((true && ... && (rest != nullptr))) func(entity, first, *rest...);
+    }
+
+    template <typename Func, typename... Ts>
+    static void call_if_found(Func& func, EntityId entity, Ts*... components) {
+        if ((true && ... && (components != nullptr))) func(entity, *components...);
+    }
+
+    template <typename Func>
+    static void for_each_event(std::pair<const ChangeEvent*, const ChangeEvent*> events, Func& func) {
+        for (const ChangeEvent* event = events.first; event != events.second; ++event) func(event->entity);
+    }
+
+    template <typename First, typename... Rest, typename Func>
+    void visit(Func& func) {
+        if (mode == StorageMode::Archetype) {
+            archetypes.for_each<First, Rest...>(func);
+            return;
+        }
+        auto* wrap = find<First>();
+        if (!wrap) return;
+        if constexpr (sizeof...(Rest) == 0) {
+            wrap->storage.for_each(func);
+        } else {
+            std::tuple<StorageWrapper<First>*, StorageWrapper<Rest>*...> all{wrap, find<Rest>()...};
+            if (!std::apply([](auto*... w) { return (true && ... && (w != nullptr)); }, all)) return;
+            visit_smallest(func, all, std::index_sequence_for<First, Rest...>());
+        }
+    }
+
+    // The smallest storage drives; every entity it holds is looked up in
+    // the others
+    template <typename Func, typename... Ws, size_t... I>
+    static void visit_smallest(Func& func, std::tuple<Ws*...>& all, std::index_sequence<I...>) {
+        size_t sizes[] = {std::get<I>(all)->storage.size()...};
+        const EntityId* ids[] = {std::get<I>(all)->storage.entity_data()...};
+        size_t driver = std::min_element(std::begin(sizes), std::end(sizes)) - std::begin(sizes);
+        for (size_t i = 0; i < sizes[driver]; i++) {
+            EntityId entity = ids[driver][i];
+            call_if_found(func, entity, std::get<I>(all)->storage.get(entity)...);
+        }
+    }
+
+    template <typename T>
+    T* lookup(EntityId entity) {
+        if (mode == StorageMode::Archetype) return archetypes.get<T>(entity);
+        auto* wrap = find<T>();
+        if (!wrap) return nullptr;
+        return wrap->storage.get(entity);
+    }
+
+    change_detail::ComponentChanges& changes_for(uint32_t index) {
+        if (index >= change_log.size()) change_log.resize(index + 1);
+        return change_log[index];
+    }
+
+    const change_detail::ComponentChanges* find_changes(uint32_t index) const {
+        return index < change_log.size() ? &change_log[index] : nullptr;
+    }
+
+    // Only add_component() grows the log, so systems writing different
+    // components can mark concurrently (the scheduler never runs two
+    // writers of one component at once)
+    void mark_changed(uint32_t index, EntityId entity) {
+        change_detail::ComponentChanges& changes = change_log[index];
+        if (changes.changed_tick.get(entity_index(entity)) == tick) return;
+        changes.changed_tick.set(entity_index(entity), tick);
+        changes.changed.push_back({entity, tick});
+    }
+
+    template <typename... Ts>
+    void mark_all_changed() {
+        (void(component_index<Ts>() < change_log.size() ? change_log[component_index<Ts>()].all_changed = tick : 0), ...);
+    }
+
+    void record_removed(uint32_t index, EntityId entity) {
+        change_detail::ComponentChanges& changes = changes_for(index);
+        changes.removed.push_back({entity, tick});
+        changes.changed_tick.set(entity_index(entity), 0);  // The slot may be reused
+    }
 
     template <typename T>
     StorageWrapper<T>& get_or_create() {
-        size_t key = typeid(T).hash_code();
-        auto it = storages.find(key);
-        if (it == storages.end()) {
-            auto wrapper = std::make_unique<StorageWrapper<T>>();
-            auto* ptr = wrapper.get();
-            storages.emplace(key, std::move(wrapper));
-            return *ptr;
-        }
-        return *static_cast<StorageWrapper<T>*>(it->second.get());
+        uint32_t index = component_index<T>();
+        if (index >= storages.size()) storages.resize(index + 1);
+        if (!storages[index]) storages[index] = std::make_unique<StorageWrapper<T>>();
+        return *static_cast<StorageWrapper<T>*>(storages[index].get());
     }
 
     template <typename T>
     StorageWrapper<T>* find() const {
-        size_t key = typeid(T).hash_code();
-        auto it = storages.find(key);
-        if (it == storages.end()) return nullptr;
-        return static_cast<StorageWrapper<T>*>(it->second.get());
+        uint32_t index = component_index<T>();
+        if (index >= storages.size()) return nullptr;
+        return static_cast<StorageWrapper<T>*>(storages[index].get());
     }
 };
 
+// -----------------------------------------------------------------------------
+// Cached queries (EntityStorage::query<Ts...>())
+// -----------------------------------------------------------------------------
+template <typename... Ts>
+class Query final : public query_detail::QueryBase {
+public:
+    static_assert(sizeof...(Ts) > 0, "a query needs at least one component");
+
+    Query(EntityStorage& world, bool owning) : world(world), owning(owning) {
+        if (world.mode == StorageMode::SparseSet) sets = std::make_tuple(&world.get_or_create<Ts>().storage...);
+    }
 
+    bool is_owning() const { return owning; }
+
+    size_t size() const {
+        if (world.mode == StorageMode::Archetype) {
+            size_t count = 0;
+            world.archetypes.for_each_chunk<Ts...>([&](const EntityId*, Ts*..., size_t n) { count += n; });
+            return count;
+        }
+        return owning ? grouped : matched.size();
+    }
+
+    // func(EntityId, Ts&...) for every match; all of Ts count as changed
+    template <typename Func>
+    void for_each(Func&& func) {
+        world.mark_all_changed<Ts...>();
+        for_each_read(func);
+    }
+
+    // func(EntityId, const Ts&...); marks nothing
+    template <typename Func>
+    void for_each_read(Func&& func) {
+        if (world.mode == StorageMode::Archetype) {
+            world.archetypes.for_each<Ts...>(func);
+        } else if (owning) {
+            visit_grouped(func, 0, grouped, std::index_sequence_for<Ts...>());
+        } else {
+            for (EntityId entity : matched) func(entity, *std::get<ComponentStorage<Ts>*>(sets)->get(entity)...);
+        }
+    }
+
+    // for_each on the job system, with EntityStorage::parallel_for_each's rules
+    template <typename Func>
+    void parallel_for_each(Func&& func) {
+        world.mark_all_changed<Ts...>();
+        if (world.mode == StorageMode::Archetype) {
+            world.archetypes.parallel_for_each<Ts...>(func);
+        } else if (owning) {
+            parallel_for(grouped, [&](size_t begin, size_t end) {
+                visit_grouped(func, begin, end, std::index_sequence_for<Ts...>());
+            });
+        } else {
+            const EntityId* ids = matched.data();
+            parallel_for(matched.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    func(ids[i], *std::get<ComponentStorage<Ts>*>(sets)->get(ids[i])...);
+                }
+            });
+        }
+    }
+
+private:
+    static constexpr uint32_t not_matched = UINT32_MAX;
+
+    EntityStorage& world;
+    bool owning;
+    std::tuple<ComponentStorage<Ts>*...> sets{};
+
+    size_t grouped = 0;              // Owning: members are dense [0, grouped) of every set
+    std::vector<EntityId> matched;   // Otherwise: the members
+    PagedArray<uint32_t, not_matched> slot;  // Entity index -> position in matched
+
+    bool matches(EntityId entity) const {
+        return std::apply([&](auto*... set) { return (true && ... && set->has(entity)); }, sets);
+    }
+
+    void on_added(EntityId entity) override {
+        if (!matches(entity)) return;
+        if (owning) {
+            if (std::get<0>(sets)->index_of(entity) < grouped) return;
+            std::apply([&](auto*... set) { (set->swap_entries(set->index_of(entity), uint32_t(grouped)), ...); }, sets);
+            grouped++;
+            return;
+        }
+        if (slot.get(entity_index(entity)) != not_matched) return;
+        slot.set(entity_index(entity), static_cast<uint32_t>(matched.size()));
+        matched.push_back(entity);
+    }
+
+    void on_removing(EntityId entity) override {
+        if (owning) {
+            if (!matches(entity) || std::get<0>(sets)->index_of(entity) >= grouped) return;
+            grouped--;
+            std::apply([&](auto*... set) { (set->swap_entries(set->index_of(entity), uint32_t(grouped)), ...); }, sets);
+            return;
+        }
+        uint32_t index = slot.get(entity_index(entity));
+        if (index == not_matched) return;
+        matched[index] = matched.back();
+        slot.set(entity_index(matched[index]), index);
+        matched.pop_back();
+        slot.set(entity_index(entity), not_matched);
+    }
+
+    // Members share dense positions, so this is a straight walk of each array
+    template <typename Func, size_t... I>
+    void visit_grouped(Func& func, size_t begin, size_t end, std::index_sequence<I...>) {
+        const EntityId* ids = std::get<0>(sets)->entity_data();
+        auto columns = std::make_tuple(std::get<I>(sets)->data()...);
+        for (size_t i = begin; i < end; i++) func(ids[i], std::get<I>(columns)[i]...);
+    }
+
+    friend class EntityStorage;
+
+    // Existing matches, when the query is created
+    void populate() {
+        if (world.mode == StorageMode::Archetype) return;
+        size_t sizes[] = {std::get<ComponentStorage<Ts>*>(sets)->size()...};
+        const EntityId* ids[] = {std::get<ComponentStorage<Ts>*>(sets)->entity_data()...};
+        size_t driver = std::min_element(std::begin(sizes), std::end(sizes)) - std::begin(sizes);
+        std::vector<EntityId> candidates(ids[driver], ids[driver] + sizes[driver]);  // Owning swaps reorder them
+        for (EntityId entity : candidates) on_added(entity);
+    }
+};
+
+template <typename... Ts>
+Query<Ts...>& EntityStorage::query() {
+    std::type_index key(typeid(Query<Ts...>));
+    auto it = queries.find(key);
+    if (it != queries.end()) return *static_cast<Query<Ts...>*>(it->second.get());
+
+    uint32_t indices[] = {component_index<Ts>()...};
+    bool owning = mode == StorageMode::SparseSet;
+    for (uint32_t index : indices) {
+        if (index < owned.size() && owned[index]) owning = false;
+    }
+    for (size_t i = 0; i < sizeof...(Ts); i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (indices[i] == indices[j]) owning = false;  // Query<A, A> can't own A twice
+        }
+    }
+
+    auto created = std::make_unique<Query<Ts...>>(*this, owning);
+    Query<Ts...>* query = created.get();
+    queries.emplace(key, std::move(created));
+    if (mode == StorageMode::SparseSet) {
+        for (uint32_t index : indices) {
+            if (index >= queries_by_component.size()) queries_by_component.resize(index + 1);
+            auto& list = queries_by_component[index];
+            if (std::find(list.begin(), list.end(), query) == list.end()) list.push_back(query);
+            if (owning) {
+                if (index >= owned.size()) owned.resize(index + 1, false);
+                owned[index] = true;
+            }
+        }
+        query->populate();
+    }
+    return *query;
+}
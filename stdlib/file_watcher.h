@@ -0,0 +1,477 @@
+// EDEN ENGINE - FileWatcher
+// Event-driven change detection for hot-reload: one watcher thread (inotify
+// on Linux, ReadDirectoryChangesW on Windows) instead of a stat() per file
+// per frame
+
+#ifndef EDEN_FILE_WATCHER_H
+#define EDEN_FILE_WATCHER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#define EDEN_FILE_WATCHER_INOTIFY 1
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define EDEN_FILE_WATCHER_WIN32 1
+#include <windows.h>
+#endif
+
+/**
+ * FileWatcher - Debounced file change events for the hot-reload checks
+ *
+ * watch() subscribes to one file (its directory is watched, so editors that
+ * save by writing a temp file and renaming it are seen too) and returns an
+ * id. The watcher thread collects the directory events, waits until a file
+ * has been quiet for the debounce interval (one event per save, not one per
+ * write() call) and pushes the id into a lock-free single-producer ring.
+ * poll() drains the ring once per frame on the render thread; consume(id)
+ * then says whether that subscriber's file changed since it last asked.
+ *
+ * A new subscription starts changed, so the first check does the same
+ * stat() as before. Callers keep their mtime comparison and only skip it
+ * while consume() is false - an event never reloads anything by itself.
+ * Ring or kernel queue overflow marks every subscription changed.
+ *
+ * Each watch() is its own subscription, even for the same path, so two
+ * Resources on one file don't consume each other's events. On platforms
+ * without a backend (or when the kernel refuses the watch) watch() returns
+ * NOT_WATCHED and callers fall back to polling.
+ *
+ * watch(), unwatch(), poll() and consume() are render-thread calls.
+ *
+ * Usage:
+ *   int id = FileWatcher::shared().watch("shaders/lit.frag.spv");
+ *   // once per frame (generated main loops do this before the checks):
+ *   FileWatcher::shared().poll();
+ *   if (id == FileWatcher::NOT_WATCHED || FileWatcher::shared().consume(id)) {
+ *       // stat() and reload as before
+ *   }
+ */
+class FileWatcher {
+public:
+    static constexpr int NOT_WATCHED = -1;
+    static constexpr uint32_t DEFAULT_DEBOUNCE_MS = 50;
+
+    FileWatcher() = default;
+    ~FileWatcher() { shutdown(); }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * Never destroyed: resources in static storage unwatch from their
+     * destructors, which may run after any function-local static. Call
+     * shutdown() to stop the watch thread early.
+     */
+    static FileWatcher& shared() {
+        static FileWatcher* watcher = new FileWatcher();
+        return *watcher;
+    }
+
+    /**
+     * Quiet time before a change is reported (editors often write a file
+     * in several steps)
+     */
+    void setDebounce(uint32_t milliseconds) {
+        m_debounceMs.store(milliseconds);
+    }
+
+    /**
+     * Subscribe to changes of `path`
+     * @return Subscription id, or NOT_WATCHED (poll the file instead)
+     */
+    int watch(const std::string& path) {
+#if defined(EDEN_FILE_WATCHER_INOTIFY) || defined(EDEN_FILE_WATCHER_WIN32)
+        if (path.empty()) return NOT_WATCHED;
+        std::string directory, name;
+        splitPath(path, directory, name);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping || !startLocked()) return NOT_WATCHED;
+        Directory* dir = findOrAddDirectoryLocked(directory);
+        if (!dir) return NOT_WATCHED;
+
+        int id = static_cast<int>(m_changed.size());
+        m_changed.push_back(1);  // First check stats once, like polling
+        dir->files.push_back({normalizeName(name), static_cast<uint32_t>(id)});
+        return id;
+#else
+        (void)path;
+        return NOT_WATCHED;
+#endif
+    }
+
+    /**
+     * Drop a subscription (its id is not reused)
+     */
+    void unwatch(int id) {
+        if (id < 0) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::unique_ptr<Directory>& dir : m_directories) {
+            dir->files.erase(std::remove_if(dir->files.begin(), dir->files.end(),
+                                            [id](const File& file) { return file.id == static_cast<uint32_t>(id); }),
+                             dir->files.end());
+        }
+    }
+
+    /**
+     * Move reported changes into the subscriptions' flags. Call once per
+     * frame; costs two atomic loads when nothing changed.
+     */
+    void poll() {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t tail = m_tail.load(std::memory_order_acquire);
+        for (; head != tail; head++) {
+            uint32_t id = m_ring[head & (RING_CAPACITY - 1)];
+            if (id < m_changed.size()) m_changed[id] = 1;
+        }
+        m_head.store(head, std::memory_order_release);
+        if (m_overflow.exchange(false, std::memory_order_acquire)) {
+            std::fill(m_changed.begin(), m_changed.end(), 1);
+        }
+    }
+
+    /**
+     * Whether subscription `id`'s file changed since the last call (clears
+     * the flag). NOT_WATCHED always reports true, so callers can use it
+     * unconditionally as "should I stat?".
+     */
+    bool consume(int id) {
+        if (id < 0 || static_cast<size_t>(id) >= m_changed.size()) return true;
+        bool changed = m_changed[id] != 0;
+        m_changed[id] = 0;
+        return changed;
+    }
+
+    /**
+     * Stop the watcher thread and release the kernel handles
+     */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        wakeThread();
+        if (m_thread.joinable()) m_thread.join();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        closeHandlesLocked();
+    }
+
+private:
+    static constexpr uint32_t RING_CAPACITY = 1024;  // Power of two
+
+    struct File {
+        std::string name;   // Normalized (see normalizeName)
+        uint32_t id;
+    };
+
+    struct Directory {
+        std::string path;
+        std::vector<File> files;
+#if defined(EDEN_FILE_WATCHER_INOTIFY)
+        int wd = -1;
+#elif defined(EDEN_FILE_WATCHER_WIN32)
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        bool armed = false;
+        alignas(DWORD) uint8_t buffer[16 * 1024];
+#endif
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    static void splitPath(const std::string& path, std::string& directory, std::string& name) {
+        size_t slash = path.find_last_of("/\\");
+        if (slash == std::string::npos) {
+            directory = ".";
+            name = path;
+        } else {
+            directory = slash == 0 ? path.substr(0, 1) : path.substr(0, slash);
+            name = path.substr(slash + 1);
+        }
+    }
+
+    // Windows file names compare case-insensitively
+    static std::string normalizeName(std::string name) {
+#if defined(EDEN_FILE_WATCHER_WIN32)
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(::tolower(c)); });
+#endif
+        return name;
+    }
+
+    // Watcher thread: remember the change, report it once the file is quiet
+    void noteChangeLocked(Directory& dir, const std::string& name, Clock::time_point now) {
+        std::string normalized = normalizeName(name);
+        auto due = now + std::chrono::milliseconds(m_debounceMs.load());
+        for (const File& file : dir.files) {
+            if (file.name == normalized) m_pending[file.id] = due;
+        }
+    }
+
+    // Watcher thread: push debounced ids whose quiet time has passed
+    // @return Milliseconds until the next one is due, or -1 if none pending
+    int flushPending(Clock::time_point now) {
+        int wait = -1;
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            if (it->second <= now) {
+                push(it->first);
+                it = m_pending.erase(it);
+            } else {
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(it->second - now).count() + 1;
+                wait = wait < 0 ? static_cast<int>(ms) : std::min(wait, static_cast<int>(ms));
+                ++it;
+            }
+        }
+        return wait;
+    }
+
+    // Single producer (watcher thread); a full ring degrades to "everything changed"
+    void push(uint32_t id) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        if (tail - head >= RING_CAPACITY) {
+            m_overflow.store(true, std::memory_order_release);
+            return;
+        }
+        m_ring[tail & (RING_CAPACITY - 1)] = id;
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+
+#if defined(EDEN_FILE_WATCHER_INOTIFY)
+    bool startLocked() {
+        if (m_thread.joinable()) return true;
+        if (m_inotify < 0) m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_wakeFd < 0) m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_inotify < 0 || m_wakeFd < 0) return false;
+        m_thread = std::thread([this]() { threadLoop(); });
+        return true;
+    }
+
+    Directory* findOrAddDirectoryLocked(const std::string& path) {
+        const uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE;
+        int wd = inotify_add_watch(m_inotify, path.c_str(), mask);
+        if (wd < 0) return nullptr;
+        // The kernel hands out one wd per directory inode, whatever the spelling
+        for (std::unique_ptr<Directory>& dir : m_directories) {
+            if (dir->wd == wd) return dir.get();
+        }
+        m_directories.push_back(std::make_unique<Directory>());
+        m_directories.back()->path = path;
+        m_directories.back()->wd = wd;
+        return m_directories.back().get();
+    }
+
+    void wakeThread() {
+        if (m_wakeFd >= 0) {
+            uint64_t one = 1;
+            ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+            (void)written;
+        }
+    }
+
+    void closeHandlesLocked() {
+        if (m_inotify >= 0) ::close(m_inotify);
+        if (m_wakeFd >= 0) ::close(m_wakeFd);
+        m_inotify = m_wakeFd = -1;
+        m_directories.clear();
+    }
+
+    void threadLoop() {
+        alignas(struct inotify_event) char buffer[16 * 1024];
+        int wait = -1;
+        for (;;) {
+            pollfd fds[2] = {{m_inotify, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+            ::poll(fds, 2, wait);
+            if (fds[1].revents & POLLIN) {
+                uint64_t count;
+                ssize_t got = ::read(m_wakeFd, &count, sizeof(count));
+                (void)got;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping) return;
+            Clock::time_point now = Clock::now();
+            if (fds[0].revents & POLLIN) {
+                ssize_t length;
+                while ((length = ::read(m_inotify, buffer, sizeof(buffer))) > 0) {
+                    for (char* p = buffer; p < buffer + length;) {
+                        const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                        p += sizeof(inotify_event) + event->len;
+                        if (event->mask & IN_Q_OVERFLOW) {
+                            m_overflow.store(true, std::memory_order_release);
+                            continue;
+                        }
+                        if (event->len == 0) continue;
+                        for (std::unique_ptr<Directory>& dir : m_directories) {
+                            if (dir->wd == event->wd) noteChangeLocked(*dir, event->name, now);
+                        }
+                    }
+                }
+            }
+            wait = flushPending(now);
+        }
+    }
+
+    int m_inotify = -1;
+    int m_wakeFd = -1;
+#elif defined(EDEN_FILE_WATCHER_WIN32)
+    // One wait slot is the wake event
+    static constexpr size_t MAX_DIRECTORIES = MAXIMUM_WAIT_OBJECTS - 1;
+
+    static std::wstring widen(const std::string& text) {
+        int length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+        std::wstring wide(length > 0 ? length - 1 : 0, L'\0');
+        if (length > 1) MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, &wide[0], length);
+        return wide;
+    }
+
+    static std::string narrow(const WCHAR* text, int length) {
+        int bytes = WideCharToMultiByte(CP_UTF8, 0, text, length, nullptr, 0, nullptr, nullptr);
+        std::string out(bytes > 0 ? bytes : 0, '\0');
+        if (bytes > 0) WideCharToMultiByte(CP_UTF8, 0, text, length, &out[0], bytes, nullptr, nullptr);
+        return out;
+    }
+
+    static bool arm(Directory& dir) {
+        const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+        dir.armed = ReadDirectoryChangesW(dir.handle, dir.buffer, sizeof(dir.buffer), FALSE, filter,
+                                          nullptr, &dir.overlapped, nullptr) != FALSE;
+        return dir.armed;
+    }
+
+    bool startLocked() {
+        if (m_thread.joinable()) return true;
+        if (!m_wakeEvent) m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!m_wakeEvent) return false;
+        m_thread = std::thread([this]() { threadLoop(); });
+        return true;
+    }
+
+    Directory* findOrAddDirectoryLocked(const std::string& path) {
+        std::string normalized = normalizeName(path);
+        std::replace(normalized.begin(), normalized.end(), '/', '\\');
+        for (std::unique_ptr<Directory>& dir : m_directories) {
+            if (dir->path == normalized) return dir.get();
+        }
+        if (m_directories.size() >= MAX_DIRECTORIES) return nullptr;
+
+        auto dir = std::make_unique<Directory>();
+        dir->path = normalized;
+        dir->handle = CreateFileW(widen(path).c_str(), FILE_LIST_DIRECTORY,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (dir->handle == INVALID_HANDLE_VALUE) return nullptr;
+        dir->overlapped.hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!dir->overlapped.hEvent || !arm(*dir)) {
+            if (dir->overlapped.hEvent) CloseHandle(dir->overlapped.hEvent);
+            CloseHandle(dir->handle);
+            return nullptr;
+        }
+        m_directories.push_back(std::move(dir));
+        wakeThread();  // Rebuild the wait set
+        return m_directories.back().get();
+    }
+
+    void wakeThread() {
+        if (m_wakeEvent) SetEvent(m_wakeEvent);
+    }
+
+    void closeHandlesLocked() {
+        for (std::unique_ptr<Directory>& dir : m_directories) {
+            if (dir->armed) {
+                CancelIoEx(dir->handle, &dir->overlapped);
+                DWORD bytes = 0;
+                GetOverlappedResult(dir->handle, &dir->overlapped, &bytes, TRUE);
+            }
+            CloseHandle(dir->overlapped.hEvent);
+            CloseHandle(dir->handle);
+        }
+        m_directories.clear();
+        if (m_wakeEvent) CloseHandle(m_wakeEvent);
+        m_wakeEvent = nullptr;
+    }
+
+    void threadLoop() {
+        int wait = -1;
+        std::vector<HANDLE> handles;
+        std::vector<Directory*> owners;
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_stopping) return;
+                handles.assign(1, m_wakeEvent);
+                owners.assign(1, nullptr);
+                for (std::unique_ptr<Directory>& dir : m_directories) {
+                    if (!dir->armed) continue;
+                    handles.push_back(dir->overlapped.hEvent);
+                    owners.push_back(dir.get());
+                }
+            }
+
+            DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE,
+                                                  wait < 0 ? INFINITE : static_cast<DWORD>(wait));
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping) return;
+            Clock::time_point now = Clock::now();
+            if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + handles.size()) {
+                Directory& dir = *owners[result - WAIT_OBJECT_0];
+                DWORD bytes = 0;
+                if (GetOverlappedResult(dir.handle, &dir.overlapped, &bytes, FALSE) && bytes == 0) {
+                    // Notification buffer overflowed
+                    m_overflow.store(true, std::memory_order_release);
+                }
+                for (DWORD offset = 0; bytes > 0;) {
+                    const FILE_NOTIFY_INFORMATION* info =
+                        reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(dir.buffer + offset);
+                    noteChangeLocked(dir, narrow(info->FileName, static_cast<int>(info->FileNameLength / sizeof(WCHAR))), now);
+                    if (info->NextEntryOffset == 0) break;
+                    offset += info->NextEntryOffset;
+                }
+                arm(dir);
+            }
+            wait = flushPending(now);
+        }
+    }
+
+    HANDLE m_wakeEvent = nullptr;
+#else
+    bool startLocked() { return false; }
+    Directory* findOrAddDirectoryLocked(const std::string&) { return nullptr; }
+    void wakeThread() {}
+    void closeHandlesLocked() {}
+#endif
+
+    // Render thread only
+    std::vector<uint8_t> m_changed;                      // Per subscription id
+
+    // Watcher thread -> render thread (single producer, single consumer)
+    uint32_t m_ring[RING_CAPACITY] = {};
+    std::atomic<uint32_t> m_head{0};
+    std::atomic<uint32_t> m_tail{0};
+    std::atomic<bool> m_overflow{false};
+    std::atomic<uint32_t> m_debounceMs{DEFAULT_DEBOUNCE_MS};
+
+    // Guarded by m_mutex
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Directory>> m_directories;
+    std::unordered_map<uint32_t, Clock::time_point> m_pending;   // Id -> report time
+    std::thread m_thread;
+    bool m_stopping = false;
+};
+
+#endif // EDEN_FILE_WATCHER_H
@@ -0,0 +1,159 @@
+// EDEN ENGINE - Fixed Timestep
+// Runs simulation at a fixed rate whatever the frame rate: frame time
+// accumulates and is spent in whole steps, and render interpolates between
+// the last two simulated states by what is left over
+
+#ifndef EDEN_FIXED_TIMESTEP_H
+#define EDEN_FIXED_TIMESTEP_H
+
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Fixed-rate step driver. Each frame, advance() takes the frame's wall time
+ * and returns how many steps of step_seconds() to run; alpha() is then how
+ * far render time is past the last step, in [0, 1), for blending the state
+ * before it with the state after it.
+ *
+ * A frame that needs more than max_substeps steps runs max_substeps and
+ * drops the rest (dropped_seconds()): a slow step can't make the next frame
+ * slower still, the simulation just runs behind wall time while it lasts.
+ * Frame times are also capped at max_frame_seconds, so a breakpoint or a
+ * window drag doesn't turn into a burst of catch-up steps.
+ *
+ * Steps always see the same dt, so a replay of the same inputs reaches the
+ * same state however the frames were timed.
+ *
+ * Usage:
+ *   static FixedTimestep sim(60.0);
+ *   sim.advance(frame_seconds, [&](float dt) {
+ *       previous = current;
+ *       step_physics(current, dt);
+ *   });
+ *   render(lerp(previous, current, sim.alpha()));
+ */
+class FixedTimestep {
+public:
+    static constexpr double DEFAULT_HZ = 60.0;
+    static constexpr int DEFAULT_MAX_SUBSTEPS = 5;
+    static constexpr double DEFAULT_MAX_FRAME_SECONDS = 0.25;
+
+    explicit FixedTimestep(double hz = DEFAULT_HZ, int max_substeps = DEFAULT_MAX_SUBSTEPS) {
+        set_rate(hz);
+        set_max_substeps(max_substeps);
+    }
+
+    void set_rate(double hz) {
+        step_ = 1.0 / (hz > 0.0 ? hz : DEFAULT_HZ);
+        accumulator_ = 0.0;
+    }
+
+    void set_max_substeps(int max_substeps) { max_substeps_ = std::max(1, max_substeps); }
+    void set_max_frame_seconds(double seconds) { max_frame_ = std::max(0.0, seconds); }
+
+    double rate() const { return 1.0 / step_; }
+    float step_seconds() const { return static_cast<float>(step_); }
+    int max_substeps() const { return max_substeps_; }
+
+    // Render blend between the state before the last step (0) and after it (1)
+    float alpha() const { return static_cast<float>(accumulator_ / step_); }
+
+    // Steps run since construction or reset()
+    uint64_t step_count() const { return steps_; }
+
+    // Wall time given up to the substep cap
+    double dropped_seconds() const { return dropped_; }
+
+    // Adds a frame's time; returns the steps to run now
+    int advance(double frame_seconds) {
+        accumulator_ += std::min(std::max(frame_seconds, 0.0), max_frame_);
+        // The epsilon keeps rounding from leaving a whole step for next frame
+        int steps = static_cast<int>(accumulator_ / step_ + 1e-6);
+        accumulator_ = std::max(0.0, accumulator_ - steps * step_);
+        if (steps > max_substeps_) {
+            dropped_ += (steps - max_substeps_) * step_;
+            steps = max_substeps_;
+        }
+        steps_ += steps;
+        return steps;
+    }
+
+    // advance(), then step(dt) for each step to run
+    template <typename Step>
+    int advance(double frame_seconds, Step&& step) {
+        int steps = advance(frame_seconds);
+        float dt = step_seconds();
+        for (int i = 0; i < steps; i++) step(dt);
+        return steps;
+    }
+
+    // advance() by the wall time since the last tick() (none the first time)
+    template <typename Step>
+    int tick(Step&& step) {
+        auto now = std::chrono::steady_clock::now();
+        double frame_seconds = started_ ? std::chrono::duration<double>(now - last_tick_).count() : 0.0;
+        last_tick_ = now;
+        started_ = true;
+        return advance(frame_seconds, step);
+    }
+
+    void reset() {
+        accumulator_ = 0.0;
+        dropped_ = 0.0;
+        steps_ = 0;
+        started_ = false;
+    }
+
+private:
+    double step_ = 1.0 / DEFAULT_HZ;
+    double accumulator_ = 0.0;
+    double max_frame_ = DEFAULT_MAX_FRAME_SECONDS;
+    double dropped_ = 0.0;
+    int max_substeps_ = DEFAULT_MAX_SUBSTEPS;
+    uint64_t steps_ = 0;
+    std::chrono::steady_clock::time_point last_tick_;
+    bool started_ = false;
+};
+
+/**
+ * The last two simulated states of an array of T, for render interpolation.
+ * store() copies the current state before a step writes it; blend() reads
+ * between the two with the caller's blend function.
+ */
+template <typename T>
+class InterpolatedStates {
+public:
+    // Before each step: previous[i] = current(i) for i < count
+    template <typename Current>
+    void store(const Current& current, size_t count) {
+        previous_.resize(count);
+        for (size_t i = 0; i < count; i++) previous_[i] = current(i);
+    }
+
+    void clear() { previous_.clear(); }
+    size_t size() const { return previous_.size(); }
+    bool has_previous(size_t i) const { return i < previous_.size(); }
+    const T& previous(size_t i) const { return previous_[i]; }
+
+    // Blend of previous and `current` at alpha; `current` if none was stored for i
+    template <typename Blend>
+    T blend(size_t i, const T& current, float alpha, Blend&& blend_fn) const {
+        return has_previous(i) ? blend_fn(previous_[i], current, alpha) : current;
+    }
+
+private:
+    std::vector<T> previous_;
+};
+
+// Angle lerp the short way around, in degrees
+inline float lerp_angle_degrees(float from, float to, float alpha) {
+    float delta = to - from;
+    while (delta > 180.0f) delta -= 360.0f;
+    while (delta < -180.0f) delta += 360.0f;
+    return from + delta * alpha;
+}
+
+#endif // EDEN_FIXED_TIMESTEP_H
@@ -0,0 +1,369 @@
+// EDEN ENGINE - Frame Arena
+// Per-thread bump allocator for data that lives for one frame: allocation
+// is a pointer bump, the whole arena resets at frame end, and after the
+// first frames it never touches the heap again
+
+#ifndef EDEN_FRAME_ARENA_H
+#define EDEN_FRAME_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace frame_arena_detail {
+
+static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+static constexpr size_t BLOCK_ALIGN = 64;  // Cache line; also covers SIMD types
+
+struct Block {
+    unsigned char* data = nullptr;
+    size_t size = 0;
+};
+
+inline unsigned char* allocate_block(size_t size) {
+    return static_cast<unsigned char*>(::operator new(size, std::align_val_t(BLOCK_ALIGN)));
+}
+
+inline void free_block(Block& block) {
+    ::operator delete(block.data, std::align_val_t(BLOCK_ALIGN));
+    block.data = nullptr;
+}
+
+inline size_t round_up_pow2(size_t value) {
+    size_t result = DEFAULT_BLOCK_SIZE;
+    while (result < value) result *= 2;
+    return result;
+}
+
+// Bumped once per frame by FrameArena::next_frame()
+inline std::atomic<uint64_t>& frame_counter() {
+    static std::atomic<uint64_t> counter{0};
+    return counter;
+}
+
+// Counters written only by the arena's own thread, read by totals()
+inline void add_relaxed(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace frame_arena_detail
+
+// All arenas summed (SystemProfiler turns these into per-frame stats)
+struct FrameArenaTotals {
+    size_t arenas = 0;
+    uint64_t allocations = 0;  // allocate() calls, ever (destroyed arenas included)
+    uint64_t bytes = 0;        // Bytes asked for, ever
+    uint64_t capacity = 0;     // Block bytes held now
+};
+
+/**
+ * Fixed-size array in a FrameArena (what frame.alloc_array<T>(n) returns).
+ * Only a view: the memory goes away when the arena resets.
+ */
+template <typename T>
+class FrameArray {
+public:
+    FrameArray() = default;
+    FrameArray(T* data, size_t count) : ptr(data), count(count) {}
+
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+
+    T* begin() { return ptr; }
+    T* end() { return ptr + count; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+
+private:
+    T* ptr = nullptr;
+    size_t count = 0;
+};
+
+class FrameArena;
+
+/**
+ * Growable array in a FrameArena, for per-frame lists that used to be a
+ * std::vector. reserve() up front to avoid leaving outgrown copies in the
+ * arena (they are only reclaimed at reset).
+ */
+template <typename T>
+class FrameVector {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "FrameVector elements are moved with memcpy and never destroyed");
+
+public:
+    explicit FrameVector(FrameArena& arena, size_t capacity = 0) : arena(&arena) { reserve(capacity); }
+
+    void reserve(size_t capacity);
+
+    void push_back(const T& value) {
+        if (count == cap) reserve(cap ? cap * 2 : 16);
+        ptr[count++] = value;
+    }
+
+    void clear() { count = 0; }
+
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+
+    T* begin() { return ptr; }
+    T* end() { return ptr + count; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+
+private:
+    FrameArena* arena;
+    T* ptr = nullptr;
+    size_t count = 0;
+    size_t cap = 0;
+};
+
+/**
+ * Bump allocator reset once per frame. Each thread has its own (local()),
+ * so allocating needs no lock; next_frame() at the top of the frame loop
+ * starts a new frame for every thread, and each arena resets itself the
+ * next time its thread asks for it.
+ *
+ * A frame that outgrows the current block chains more blocks; the next
+ * reset() replaces them with one block the size of the high-water mark,
+ * so steady-state frames allocate nothing from the heap.
+ *
+ * Nothing in the arena is destroyed: alloc_array() takes trivially
+ * destructible types only. Scope rewinds to where it started, for scratch
+ * space inside a frame. totals() sums the counters of every arena so far,
+ * which SystemProfiler reports per frame.
+ *
+ * Usage:
+ *   FrameArena::next_frame();                       // once per frame
+ *   FrameArena& frame = FrameArena::local();
+ *   FrameArray<Vec3> points = frame.alloc_array<Vec3>(count);
+ *   {
+ *       FrameArena::Scope scratch(frame);
+ *       float* tmp = frame.alloc_array<float>(count).data();
+ *   }                                               // tmp is gone
+ */
+class FrameArena {
+public:
+    struct Marker {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+
+    // Rewinds the arena to where it was when the scope began
+    class Scope {
+    public:
+        explicit Scope(FrameArena& arena) : arena(arena), marker(arena.mark()) {}
+        ~Scope() { arena.rewind(marker); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena& arena;
+        Marker marker;
+    };
+
+    // The first block is allocated on first use
+    explicit FrameArena(size_t initial_size = frame_arena_detail::DEFAULT_BLOCK_SIZE)
+        : next_block_size(std::max<size_t>(initial_size, frame_arena_detail::BLOCK_ALIGN)) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.arenas.push_back(this);
+    }
+
+    ~FrameArena() {
+        {
+            // Totals stay monotonic after the arena (and its thread) is gone
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.arenas.erase(std::find(r.arenas.begin(), r.arenas.end(), this));
+            r.retired_allocations += allocation_count.load(std::memory_order_relaxed);
+            r.retired_bytes += allocated_bytes.load(std::memory_order_relaxed);
+        }
+        for (auto& block : blocks) frame_arena_detail::free_block(block);
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // This thread's arena, reset if a frame has started since it was last used
+    static FrameArena& local() {
+        static thread_local FrameArena arena;
+        uint64_t frame = frame_arena_detail::frame_counter().load(std::memory_order_acquire);
+        if (arena.frame_index != frame) {
+            arena.reset();
+            arena.frame_index = frame;
+        }
+        return arena;
+    }
+
+    // Ends the frame for every thread's arena; the caller's resets now
+    static void next_frame() {
+        frame_arena_detail::frame_counter().fetch_add(1, std::memory_order_release);
+        local();
+    }
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        frame_arena_detail::add_relaxed(allocation_count, 1);
+        frame_arena_detail::add_relaxed(allocated_bytes, bytes);
+        return bump(bytes, align);
+    }
+
+    // Sum over every arena on every thread; takes a lock, meant for once a frame
+    static FrameArenaTotals totals() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        FrameArenaTotals result;
+        result.arenas = r.arenas.size();
+        result.allocations = r.retired_allocations;
+        result.bytes = r.retired_bytes;
+        for (const FrameArena* arena : r.arenas) {
+            result.allocations += arena->allocation_count.load(std::memory_order_relaxed);
+            result.bytes += arena->allocated_bytes.load(std::memory_order_relaxed);
+            result.capacity += arena->held_bytes.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // `count` value-initialised elements
+    template <typename T>
+    FrameArray<T> alloc_array(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        if (count == 0) return FrameArray<T>();
+        T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        std::uninitialized_value_construct_n(data, count);
+        return FrameArray<T>(data, count);
+    }
+
+    Marker mark() const { return {current, offset}; }
+
+    void rewind(Marker marker) {
+        current = marker.block;
+        offset = marker.offset;
+        block_base = 0;
+        for (size_t i = 0; i < current; i++) block_base += blocks[i].size;
+    }
+
+    // Start over; called by local() at frame boundaries
+    void reset() {
+        last_frame_bytes = frame_peak;
+        high_water_bytes = std::max(high_water_bytes, frame_peak);
+        if (blocks.size() > 1) {
+            // This frame needed several blocks: next time one will do
+            for (auto& block : blocks) frame_arena_detail::free_block(block);
+            blocks.clear();
+            size_t size = frame_arena_detail::round_up_pow2(high_water_bytes);
+            blocks.push_back({frame_arena_detail::allocate_block(size), size});
+            held_bytes.store(size, std::memory_order_relaxed);
+            heap_allocations++;
+            next_block_size = size * 2;
+        }
+        current = 0;
+        offset = 0;
+        block_base = 0;
+        frame_peak = 0;
+    }
+
+    // Bytes handed out this frame (the furthest the bump pointer got)
+    size_t used() const { return frame_peak; }
+
+    // Largest used() any frame reached, and what the last frame reached
+    size_t high_water() const { return std::max(high_water_bytes, frame_peak); }
+    size_t last_frame_used() const { return last_frame_bytes; }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const auto& block : blocks) total += block.size;
+        return total;
+    }
+
+    // Blocks taken from the heap so far (flat once frames are steady)
+    uint64_t block_allocations() const { return heap_allocations; }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<const FrameArena*> arenas;
+        uint64_t retired_allocations = 0;  // Counters of destroyed arenas
+        uint64_t retired_bytes = 0;
+    };
+
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    std::vector<frame_arena_detail::Block> blocks;
+    size_t current = 0;     // Block being bumped
+    size_t offset = 0;      // Bump offset in blocks[current]
+    size_t block_base = 0;  // Total size of the blocks before current
+    size_t frame_peak = 0;
+    size_t last_frame_bytes = 0;
+    size_t high_water_bytes = 0;
+    size_t next_block_size;
+    uint64_t heap_allocations = 0;
+    uint64_t frame_index = 0;
+    std::atomic<uint64_t> allocation_count{0};
+    std::atomic<uint64_t> allocated_bytes{0};
+    std::atomic<uint64_t> held_bytes{0};
+
+    void* bump(size_t bytes, size_t align) {
+        if (!blocks.empty()) {
+            uintptr_t base = reinterpret_cast<uintptr_t>(blocks[current].data);
+            size_t aligned = size_t(((base + offset + align - 1) & ~uintptr_t(align - 1)) - base);
+            if (aligned + bytes <= blocks[current].size) {
+                offset = aligned + bytes;
+                frame_peak = std::max(frame_peak, block_base + offset);
+                return blocks[current].data + aligned;
+            }
+        }
+        return allocate_slow(bytes, align);
+    }
+
+    void* allocate_slow(size_t bytes, size_t align) {
+        // Blocks past current are left over from before a rewind
+        while (!blocks.empty() && current + 1 < blocks.size()) {
+            block_base += blocks[current].size;
+            current++;
+            offset = 0;
+            if (bytes + align <= blocks[current].size) return bump(bytes, align);
+        }
+        size_t size = std::max(next_block_size, frame_arena_detail::round_up_pow2(bytes + align));
+        if (!blocks.empty()) block_base += blocks[current].size;
+        blocks.push_back({frame_arena_detail::allocate_block(size), size});
+        frame_arena_detail::add_relaxed(held_bytes, size);
+        heap_allocations++;
+        next_block_size = size * 2;
+        current = blocks.size() - 1;
+        offset = 0;
+        return bump(bytes, align);
+    }
+};
+
+template <typename T>
+void FrameVector<T>::reserve(size_t capacity) {
+    if (capacity <= cap) return;
+    T* grown = static_cast<T*>(arena->allocate(sizeof(T) * capacity, alignof(T)));
+    if (count) std::memcpy(grown, ptr, sizeof(T) * count);
+    ptr = grown;
+    cap = capacity;
+}
+
+#endif // EDEN_FRAME_ARENA_H
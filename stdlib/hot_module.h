@@ -0,0 +1,338 @@
+// EDEN ENGINE - HotModule
+// Hot-reloadable shared library for @hot systems: LoadLibrary on Windows,
+// dlopen on Linux/macOS. Reloads load a shadow copy on a background thread
+// and swap the function pointers at a frame boundary
+
+#ifndef EDEN_HOT_MODULE_H
+#define EDEN_HOT_MODULE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#define EDEN_HOT_MODULE_EXT ".dll"
+#include <windows.h>
+#else
+#if defined(__APPLE__)
+#define EDEN_HOT_MODULE_EXT ".dylib"
+#else
+#define EDEN_HOT_MODULE_EXT ".so"
+#endif
+#include <dlfcn.h>
+#endif
+
+namespace hot_module_detail {
+
+#if defined(_WIN32)
+using Library = HMODULE;
+inline Library openLibrary(const std::string& path) { return LoadLibraryA(path.c_str()); }
+inline void* findSymbol(Library lib, const char* name) {
+    return reinterpret_cast<void*>(GetProcAddress(lib, name));
+}
+inline void closeLibrary(Library lib) { FreeLibrary(lib); }
+inline std::string lastError() { return "error " + std::to_string(GetLastError()); }
+#else
+using Library = void*;
+// A bare file name would make dlopen search the library path instead of
+// the working directory
+inline Library openLibrary(const std::string& path) {
+    std::string local = path.find('/') == std::string::npos ? "./" + path : path;
+    return dlopen(local.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+inline void* findSymbol(Library lib, const char* name) { return dlsym(lib, name); }
+inline void closeLibrary(Library lib) { dlclose(lib); }
+inline std::string lastError() {
+    const char* message = dlerror();
+    return message ? message : "unknown error";
+}
+#endif
+
+// Size + mtime of a file; any difference counts as a new build
+struct Stamp {
+    int64_t size = -1;
+    int64_t mtimeNs = 0;
+
+    bool valid() const { return size >= 0; }
+    bool operator==(const Stamp& other) const { return size == other.size && mtimeNs == other.mtimeNs; }
+    bool operator!=(const Stamp& other) const { return !(*this == other); }
+};
+
+inline Stamp stampOf(const std::string& path) {
+    Stamp stamp;
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return stamp;
+    stamp.size = static_cast<int64_t>(info.st_size);
+    stamp.mtimeNs = static_cast<int64_t>(info.st_mtime) * 1000000000;
+#if defined(__APPLE__)
+    stamp.mtimeNs += info.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    stamp.mtimeNs += info.st_mtim.tv_nsec;
+#endif
+    return stamp;
+}
+
+inline bool copyFile(const std::string& from, const std::string& to) {
+    FILE* in = std::fopen(from.c_str(), "rb");
+    if (!in) return false;
+    FILE* out = std::fopen(to.c_str(), "wb");
+    if (!out) {
+        std::fclose(in);
+        return false;
+    }
+    char buffer[64 * 1024];
+    bool ok = true;
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        if (std::fwrite(buffer, 1, n, out) != n) {
+            ok = false;
+            break;
+        }
+    }
+    ok = ok && !std::ferror(in);
+    std::fclose(in);
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) std::remove(to.c_str());
+    return ok;
+}
+
+inline double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace hot_module_detail
+
+/**
+ * HotModule - One @hot system library and the function pointers bound to it
+ *
+ * The library is never loaded from its build path. Every load copies it to
+ * a fresh shadow file next to it (movement.dll -> movement.hot3.dll) and
+ * loads that, so the compiler can overwrite the original while the game
+ * holds the copy (Windows locks loaded DLLs), and dlopen never hands back
+ * a cached handle for a path it has seen before.
+ *
+ * reload() starts the copy + load + symbol lookup on a background thread
+ * and returns at once. swap(), called at the top of the frame, installs the
+ * finished load: every bound pointer is written in one go on the render
+ * thread, so a frame sees either the old functions or the new ones, never
+ * a mix. Only then is the old library closed. Host state (globals, ECS
+ * storage) lives outside the library and survives the reload; a build that
+ * fails to load or lacks a bound symbol is rejected and the old code keeps
+ * running.
+ *
+ * Usage:
+ *   static HotModule g_movement("movement" EDEN_HOT_MODULE_EXT);
+ *   g_movement.bind("update_speed", &g_update_speed);
+ *   g_movement.load();                 // startup, synchronous
+ *   // each frame:
+ *   if (fileChanged) g_movement.reload();
+ *   g_movement.swap();
+ */
+class HotModule {
+public:
+    explicit HotModule(std::string path) : m_path(std::move(path)) {}
+    ~HotModule() { unload(); }
+
+    HotModule(const HotModule&) = delete;
+    HotModule& operator=(const HotModule&) = delete;
+
+    /**
+     * Bind an exported function to a function pointer; the pointer is set
+     * by load() and by every swap()
+     */
+    template<typename F>
+    void bind(const char* symbol, F* slot) {
+        static_assert(std::is_pointer<F>::value && std::is_function<typename std::remove_pointer<F>::type>::value,
+                      "HotModule::bind needs a function pointer");
+        m_bindings.push_back({symbol, reinterpret_cast<void**>(slot)});
+    }
+
+    /**
+     * Load the library now (startup). Missing symbols leave their pointer
+     * null with a warning
+     * @return true if the library was loaded
+     */
+    bool load() {
+        wait();
+        Pending pending;
+        pending.shadowPath = nextShadowPath();
+        loadInto(pending);
+        if (!pending.library) {
+            std::cerr << "[Hot-Reload] Failed to load " << m_path << ": " << pending.error << std::endl;
+            return false;
+        }
+        for (const std::string& missing : pending.missing) {
+            std::cerr << "[Hot-Reload] Failed to load function: " << missing << std::endl;
+        }
+        install(pending);
+        return true;
+    }
+
+    /**
+     * Start loading the current build on a background thread, unless it is
+     * the build already loaded or a load is in flight
+     * @return true if a load was started
+     */
+    bool reload() {
+        if (m_loading.load(std::memory_order_relaxed)) return false;
+        hot_module_detail::Stamp stamp = hot_module_detail::stampOf(m_path);
+        if (!stamp.valid() || stamp == m_stamp || stamp == m_rejected) return false;
+        if (m_worker.joinable()) m_worker.join();
+
+        m_pending = Pending();
+        m_pending.shadowPath = nextShadowPath();
+        m_requested = std::chrono::steady_clock::now();
+        m_loading.store(true, std::memory_order_relaxed);
+        m_worker = std::thread([this] {
+            loadInto(m_pending);
+            m_ready.store(true, std::memory_order_release);
+        });
+        return true;
+    }
+
+    /**
+     * Install a finished background load. Call at a frame boundary, when
+     * no code from the old library is on the stack
+     * @return true if the function pointers now point into a new build
+     */
+    bool swap() {
+        if (!m_ready.load(std::memory_order_acquire)) return false;
+        m_worker.join();
+        m_ready.store(false, std::memory_order_relaxed);
+        m_loading.store(false, std::memory_order_relaxed);
+
+        if (!m_pending.library || !m_pending.missing.empty()) {
+            std::cerr << "[Hot-Reload] Keeping the running " << m_path << ": ";
+            if (!m_pending.library) {
+                std::cerr << m_pending.error;
+            } else {
+                std::cerr << "missing function " << m_pending.missing.front();
+            }
+            std::cerr << std::endl;
+            discard(m_pending);
+            m_rejected = m_pending.stamp;
+            return false;
+        }
+
+        double loadMs = m_pending.loadMs;
+        install(m_pending);
+        std::cout << "[Hot-Reload] " << m_path << " reloaded in "
+                  << hot_module_detail::millisecondsSince(m_requested) << " ms (load "
+                  << loadMs << " ms)" << std::endl;
+        return true;
+    }
+
+    /** Wait for an in-flight load and drop it */
+    void wait() {
+        if (m_worker.joinable()) m_worker.join();
+        if (m_ready.exchange(false, std::memory_order_acquire)) discard(m_pending);
+        m_loading.store(false, std::memory_order_relaxed);
+    }
+
+    /** Null every bound pointer and close the library */
+    void unload() {
+        wait();
+        for (const Binding& binding : m_bindings) *binding.slot = nullptr;
+        close(m_library, m_shadowPath);
+        m_stamp = hot_module_detail::Stamp();
+    }
+
+    bool loaded() const { return m_library != nullptr; }
+    bool loading() const { return m_loading.load(std::memory_order_relaxed); }
+    const std::string& path() const { return m_path; }
+
+private:
+    struct Binding {
+        const char* symbol;
+        void** slot;
+    };
+
+    // Result of one load, filled by whichever thread runs loadInto()
+    struct Pending {
+        hot_module_detail::Library library = nullptr;
+        std::string shadowPath;
+        hot_module_detail::Stamp stamp;
+        std::vector<void*> symbols;
+        std::vector<std::string> missing;
+        std::string error;
+        double loadMs = 0.0;
+    };
+
+    std::string m_path;
+    std::vector<Binding> m_bindings;
+    uint32_t m_generation = 0;
+
+    hot_module_detail::Library m_library = nullptr;
+    std::string m_shadowPath;
+    hot_module_detail::Stamp m_stamp;
+    hot_module_detail::Stamp m_rejected;
+
+    std::thread m_worker;
+    Pending m_pending;
+    std::atomic<bool> m_loading{false};
+    std::atomic<bool> m_ready{false};
+    std::chrono::steady_clock::time_point m_requested;
+
+    std::string nextShadowPath() {
+        std::string ext = EDEN_HOT_MODULE_EXT;
+        std::string stem = m_path;
+        if (stem.size() > ext.size() && stem.compare(stem.size() - ext.size(), ext.size(), ext) == 0) {
+            stem.resize(stem.size() - ext.size());
+        }
+        return stem + ".hot" + std::to_string(++m_generation) + ext;
+    }
+
+    // Touches only `pending` and the bindings' names, so it can run off the
+    // render thread
+    void loadInto(Pending& pending) {
+        auto start = std::chrono::steady_clock::now();
+        pending.stamp = hot_module_detail::stampOf(m_path);
+        if (!hot_module_detail::copyFile(m_path, pending.shadowPath)) {
+            pending.error = "could not copy it to " + pending.shadowPath;
+            return;
+        }
+        pending.library = hot_module_detail::openLibrary(pending.shadowPath);
+        if (!pending.library) {
+            pending.error = hot_module_detail::lastError();
+            std::remove(pending.shadowPath.c_str());
+            return;
+        }
+        pending.symbols.reserve(m_bindings.size());
+        for (const Binding& binding : m_bindings) {
+            void* symbol = hot_module_detail::findSymbol(pending.library, binding.symbol);
+            if (!symbol) pending.missing.push_back(binding.symbol);
+            pending.symbols.push_back(symbol);
+        }
+        pending.loadMs = hot_module_detail::millisecondsSince(start);
+    }
+
+    void install(Pending& pending) {
+        for (size_t i = 0; i < m_bindings.size(); i++) *m_bindings[i].slot = pending.symbols[i];
+        close(m_library, m_shadowPath);
+        m_library = pending.library;
+        m_shadowPath = pending.shadowPath;
+        m_stamp = pending.stamp;
+        pending = Pending();
+    }
+
+    void discard(Pending& pending) {
+        close(pending.library, pending.shadowPath);
+    }
+
+    static void close(hot_module_detail::Library& library, std::string& shadowPath) {
+        if (library) hot_module_detail::closeLibrary(library);
+        library = nullptr;
+        if (!shadowPath.empty()) std::remove(shadowPath.c_str());
+        shadowPath.clear();
+    }
+};
+
+#endif // EDEN_HOT_MODULE_H
@@ -0,0 +1,199 @@
+// EDEN ENGINE - Parallel Image Decode
+// Fans stb_image decoding of many images across worker threads and hands
+// each result back on the calling thread, so GPU uploads overlap decoding
+
+#ifndef EDEN_IMAGE_DECODE_H
+#define EDEN_IMAGE_DECODE_H
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include "vfs.h"
+
+// Declarations only; STB_IMAGE_IMPLEMENTATION lives in one .cpp (see png_loader.h).
+// Skipped when already included so that .cpp doesn't compile the implementation twice.
+// stb_image keeps no shared state except the failure reason, which is thread-local.
+#ifndef STBI_INCLUDE_STB_IMAGE_H
+#include "stb_image.h"
+#endif
+
+namespace image_decode_detail {
+
+struct StbiFree {
+    void operator()(stbi_uc* pixels) const { stbi_image_free(pixels); }
+};
+
+} // namespace image_decode_detail
+
+/**
+ * One decoded image, RGBA8. pixels is null (and error says why) when the
+ * source could not be read or decoded. Freed when the DecodedImage goes
+ * away - consumers copy or upload the pixels before returning.
+ */
+struct DecodedImage {
+    size_t index = 0;  // Position in the source list
+    uint32_t width = 0, height = 0;
+    std::unique_ptr<stbi_uc, image_decode_detail::StbiFree> pixels;
+    std::string error;
+
+    size_t byteSize() const { return size_t(width) * height * 4; }
+};
+
+/** Encoded bytes of one image (PNG/JPG/...), e.g. a glTF buffer view */
+struct EncodedImage {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+namespace image_decode_detail {
+
+inline DecodedImage decode(size_t index, const uint8_t* data, size_t size) {
+    DecodedImage image;
+    image.index = index;
+    if (!data || size == 0) {
+        image.error = "no data";
+        return image;
+    }
+    int width = 0, height = 0, channels = 0;
+    image.pixels.reset(stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha));
+    if (!image.pixels) {
+        const char* reason = stbi_failure_reason();
+        image.error = reason ? reason : "decode failed";
+        return image;
+    }
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    return image;
+}
+
+/**
+ * Runs decodeOne(i) for i in [0, count) on up to `threads` workers and
+ * consume(DecodedImage&) on the calling thread in completion order.
+ * At most two images per worker are decoded ahead of the consumer, which
+ * bounds peak memory on big batches. If consume throws, workers stop
+ * claiming new images and the exception propagates once they have joined.
+ */
+template <typename DecodeFn, typename ConsumeFn>
+void run(size_t count, uint32_t threads, DecodeFn&& decodeOne, ConsumeFn&& consume) {
+    if (count == 0) return;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<uint32_t>(std::min<size_t>(threads, count));
+
+    if (threads == 1) {
+        for (size_t i = 0; i < count; i++) {
+            DecodedImage image = decodeOne(i);
+            consume(image);
+        }
+        return;
+    }
+
+    const size_t maxAhead = size_t(threads) * 2;
+    std::mutex mutex;
+    std::condition_variable decodedCv, spaceCv;
+    std::deque<DecodedImage> decoded;
+    size_t next = 0;        // Next index to claim
+    size_t outstanding = 0; // Claimed but not yet consumed
+    bool stop = false;
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                spaceCv.wait(lock, [&] { return stop || next >= count || outstanding < maxAhead; });
+                if (stop || next >= count) return;
+                index = next++;
+                outstanding++;
+            }
+            DecodedImage image = decodeOne(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                decoded.push_back(std::move(image));
+            }
+            decodedCv.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (uint32_t t = 0; t < threads; t++) workers.emplace_back(worker);
+
+    auto finish = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        spaceCv.notify_all();
+        for (auto& w : workers) w.join();
+    };
+
+    try {
+        for (size_t consumed = 0; consumed < count; consumed++) {
+            DecodedImage image;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                decodedCv.wait(lock, [&] { return !decoded.empty(); });
+                image = std::move(decoded.front());
+                decoded.pop_front();
+            }
+            consume(image);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                outstanding--;
+            }
+            spaceCv.notify_one();
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+}
+
+} // namespace image_decode_detail
+
+/**
+ * Decode in-memory images in parallel
+ *
+ * @param images Encoded bytes; must stay valid until this returns
+ * @param consume Called on this thread as each image finishes (any order;
+ *                DecodedImage::index says which)
+ * @param threads Worker count, 0 = hardware concurrency
+ */
+template <typename ConsumeFn>
+inline void decode_images(const std::vector<EncodedImage>& images, ConsumeFn&& consume, uint32_t threads = 0) {
+    image_decode_detail::run(images.size(), threads, [&](size_t i) {
+        return image_decode_detail::decode(i, images[i].data, images[i].size);
+    }, consume);
+}
+
+/**
+ * Read (through the Vfs) and decode image files in parallel
+ *
+ * @param paths Image files (anything stb_image reads)
+ * @param consume Called on this thread as each image finishes
+ * @param threads Worker count, 0 = hardware concurrency
+ */
+template <typename ConsumeFn>
+inline void decode_image_files(const std::vector<std::string>& paths, ConsumeFn&& consume, uint32_t threads = 0) {
+    image_decode_detail::run(paths.size(), threads, [&](size_t i) {
+        VfsFile file;
+        if (!Vfs::shared().open(paths[i], file)) {
+            DecodedImage image;
+            image.index = i;
+            image.error = "cannot open file";
+            return image;
+        }
+        return image_decode_detail::decode(i, file.bytes(), file.size());
+    }, consume);
+}
+
+#endif // EDEN_IMAGE_DECODE_H
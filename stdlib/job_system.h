@@ -0,0 +1,325 @@
+// EDEN ENGINE - Job System
+// Work-stealing thread pool for data-parallel loops: every thread owns a
+// queue, runs its own jobs newest-first and steals others' oldest-first
+
+#ifndef EDEN_JOB_SYSTEM_H
+#define EDEN_JOB_SYSTEM_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace job_system_detail {
+
+static constexpr size_t CACHE_LINE = 64;
+
+// Automatic ranges start on multiples of this many elements: a whole number
+// of cache lines for any element size, so jobs over a cache-line-aligned
+// array never write the same line
+static constexpr size_t RANGE_ALIGN = 64;
+
+// Jobs of one parallel_for; lives on the caller's stack until they finish
+struct JobGroup {
+    std::atomic<size_t> pending{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;  // First exception a job threw
+
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = e;
+    }
+};
+
+struct Job {
+    void (*run)(void* context, size_t begin, size_t end) = nullptr;
+    void* context = nullptr;
+    size_t begin = 0, end = 0;
+    JobGroup* group = nullptr;
+};
+
+struct alignas(CACHE_LINE) WorkQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+};
+
+template <typename Func>
+void invoke_range(void* context, size_t begin, size_t end) {
+    (*static_cast<Func*>(context))(begin, end);
+}
+
+} // namespace job_system_detail
+
+/**
+ * Fixed pool of worker threads. The thread calling parallel_for() works on
+ * its own ranges too, so nested parallel loops (a job that runs one) keep
+ * every thread busy instead of blocking. Queue 0 is shared by all threads
+ * that are not workers.
+ */
+class TaskGroup;
+
+class JobSystem {
+public:
+    // workers: 0 = one per hardware thread, minus the calling thread
+    explicit JobSystem(uint32_t workers = 0) {
+        if (workers == 0) {
+            uint32_t hardware = std::thread::hardware_concurrency();
+            workers = hardware > 1 ? hardware - 1 : 0;
+        }
+        queues.reserve(workers + 1);
+        for (uint32_t i = 0; i <= workers; i++) queues.push_back(std::make_unique<job_system_detail::WorkQueue>());
+        threads.reserve(workers);
+        for (uint32_t i = 1; i <= workers; i++) threads.emplace_back([this, i]() { worker_loop(i); });
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Process-wide pool, started on first use
+    static JobSystem& shared() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    // Workers plus the calling thread
+    uint32_t thread_count() const { return static_cast<uint32_t>(threads.size()) + 1; }
+
+    // This thread's slot in [0, thread_count()): workers have their own,
+    // every other thread shares 0
+    uint32_t thread_index() const { return current_queue(); }
+
+    /**
+     * Calls func(begin, end) over disjoint ranges covering [0, count), in
+     * parallel, and returns once all have run. The first exception a range
+     * throws is rethrown here after the rest finish.
+     *
+     * @param grain Elements per range; 0 picks about four ranges per thread,
+     *              rounded up to a multiple of RANGE_ALIGN elements
+     */
+    template <typename Func>
+    void parallel_for(size_t count, Func&& func, size_t grain = 0) {
+        using namespace job_system_detail;
+        if (count == 0) return;
+        if (grain == 0) {
+            grain = count / (size_t(thread_count()) * 4);
+            grain = std::max<size_t>((grain + RANGE_ALIGN - 1) / RANGE_ALIGN * RANGE_ALIGN, RANGE_ALIGN);
+        }
+        if (threads.empty() || count <= grain) {
+            func(size_t(0), count);
+            return;
+        }
+
+        using FuncType = std::remove_reference_t<Func>;
+        JobGroup group;
+        size_t ranges = (count + grain - 1) / grain;
+        group.pending.store(ranges - 1, std::memory_order_relaxed);
+
+        // This thread keeps the first range; the rest go to its queue where
+        // idle workers steal them from the far end
+        uint32_t self = current_queue();
+        queued.fetch_add(ranges - 1, std::memory_order_relaxed);  // Before the jobs, so it never wraps
+        {
+            WorkQueue& queue = *queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            for (size_t r = ranges - 1; r >= 1; r--) {
+                Job job;
+                job.run = &invoke_range<FuncType>;
+                job.context = const_cast<void*>(static_cast<const void*>(&func));
+                job.begin = r * grain;
+                job.end = std::min(count, job.begin + grain);
+                job.group = &group;
+                queue.jobs.push_back(job);
+            }
+        }
+        wake_workers();
+
+        try {
+            func(size_t(0), std::min(count, grain));
+        } catch (...) {
+            group.fail(std::current_exception());
+        }
+
+        // Jobs reference func and group, so never leave early
+        help_until_done(group, self);
+        if (group.error) std::rethrow_exception(group.error);
+    }
+
+private:
+    friend class TaskGroup;
+
+    std::vector<std::unique_ptr<job_system_detail::WorkQueue>> queues;  // [0] = non-worker threads
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queued{0};  // Jobs in all queues
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    static const JobSystem*& tls_owner() {
+        static thread_local const JobSystem* owner = nullptr;
+        return owner;
+    }
+
+    static uint32_t& tls_index() {
+        static thread_local uint32_t index = 0;
+        return index;
+    }
+
+    uint32_t current_queue() const { return tls_owner() == this ? tls_index() : 0; }
+
+    void push(const job_system_detail::Job& job) {
+        queued.fetch_add(1, std::memory_order_relaxed);
+        {
+            job_system_detail::WorkQueue& queue = *queues[current_queue()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(job);
+        }
+        wake_workers();
+    }
+
+    void wake_workers() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);  // No worker is between its check and wait()
+        }
+        wake.notify_all();
+    }
+
+    // Runs anything queued (the group's jobs or not) until the group is done
+    void help_until_done(job_system_detail::JobGroup& group, uint32_t self) {
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            if (!run_one(self)) std::this_thread::yield();
+        }
+    }
+
+    // Own queue newest-first (still warm in cache), then steal oldest-first
+    bool run_one(uint32_t self) {
+        using namespace job_system_detail;
+        if (queued.load(std::memory_order_acquire) == 0) return false;
+        Job job;
+        bool found = false;
+        {
+            WorkQueue& queue = *queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                job = queue.jobs.back();
+                queue.jobs.pop_back();
+                found = true;
+            }
+        }
+        for (size_t i = 1; !found && i < queues.size(); i++) {
+            WorkQueue& victim = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = victim.jobs.front();
+                victim.jobs.pop_front();
+                found = true;
+            }
+        }
+        if (!found) return false;
+        queued.fetch_sub(1, std::memory_order_relaxed);
+
+        try {
+            job.run(job.context, job.begin, job.end);
+        } catch (...) {
+            job.group->fail(std::current_exception());
+        }
+        job.group->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void worker_loop(uint32_t index) {
+        tls_owner() = this;
+        tls_index() = index;
+        for (;;) {
+            if (run_one(index)) continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake.wait(lock, [&] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+            if (stopping) return;
+        }
+    }
+};
+
+/**
+ * Independent tasks on the pool, for work that isn't a loop (e.g. a graph
+ * of systems). Tasks may run() more tasks into the same group; wait()
+ * returns once every one has finished and rethrows the first exception.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(JobSystem& jobs = JobSystem::shared()) : jobs(jobs) {}
+
+    ~TaskGroup() {
+        // Tasks reference this group; an exception here would be lost anyway
+        jobs.help_until_done(group, jobs.current_queue());
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task) {
+        std::function<void()>* stored;
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            tasks.push_back(std::move(task));
+            stored = &tasks.back();  // deque: stays put as more are added
+        }
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+
+        job_system_detail::Job job;
+        job.run = [](void* context, size_t, size_t) { (*static_cast<std::function<void()>*>(context))(); };
+        job.context = stored;
+        job.group = &group;
+        if (jobs.threads.empty()) {
+            // No workers: run inline, still reporting through the group
+            try {
+                job.run(job.context, 0, 0);
+            } catch (...) {
+                group.fail(std::current_exception());
+            }
+            group.pending.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        jobs.push(job);
+    }
+
+    void wait() {
+        jobs.help_until_done(group, jobs.current_queue());
+        if (group.error) {
+            std::exception_ptr error = group.error;
+            group.error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    JobSystem& jobs;
+    job_system_detail::JobGroup group;
+    std::mutex tasks_mutex;
+    std::deque<std::function<void()>> tasks;
+};
+
+/** parallel_for on the shared pool */
+template <typename Func>
+inline void parallel_for(size_t count, Func&& func, size_t grain = 0) {
+    JobSystem::shared().parallel_for(count, std::forward<Func>(func), grain);
+}
+
+#endif // EDEN_JOB_SYSTEM_H
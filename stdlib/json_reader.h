@@ -0,0 +1,547 @@
+// EDEN ENGINE - JSON Reader
+// One pass over a JSON document (HDM .hdma / properties files, scenes) into
+// a flat node array, so reading many keys no longer re-scans the text
+//
+// Strings are views of the text unless they hold escapes, so there is no
+// allocation per value: the nodes, and the text when parse() copies it.
+// Lenient about what the engine's older writers produced: unknown escapes
+// (unescaped Windows paths) keep their backslash, control characters in
+// strings are accepted, nan / inf read as numbers, trailing commas are
+// skipped.
+
+#ifndef EDEN_JSON_READER_H
+#define EDEN_JSON_READER_H
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "vfs.h"
+
+enum class JsonType : uint8_t { Null, Bool, Number, String, Array, Object };
+
+namespace json_reader_detail {
+
+struct Node {
+    JsonType type = JsonType::Null;
+    bool boolean = false;
+    uint32_t count = 0;        // Elements / members of arrays and objects
+    uint32_t first = 0;        // First child; 0 = none (node 0 is the root)
+    uint32_t next = 0;         // Next sibling; 0 = last
+    uint32_t keyLength = 0;
+    uint32_t textLength = 0;
+    const char* key = nullptr; // Member name, for object members
+    union {
+        const char* text = nullptr;  // String value, unescaped
+        double number;
+    };
+
+    std::string_view keyView() const { return std::string_view(key, keyLength); }
+};
+
+constexpr int MAX_DEPTH = 256;
+
+inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+inline char* encode_utf8(uint32_t cp, char* out) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+} // namespace json_reader_detail
+
+/**
+ * A value in a parsed JsonDocument. Lookups that miss return an invalid
+ * value whose accessors all return their fallback, so chains need no checks
+ * in between. Valid while its document is alive and unchanged.
+ *
+ * operator[](key) scans one object's members; find(key) searches the whole
+ * subtree in document order, for files whose writers nested the same keys
+ * differently. Both walk nodes, never the text.
+ *
+ * Usage:
+ *   JsonValue model = doc.root()["properties"]["model"];
+ *   float scale[3] = {1.0f, 1.0f, 1.0f};
+ *   model["scale"].readFloats(scale, 3);
+ *   for (JsonValue point : doc.root()["control_points"]) { ... point["name"].asString() ... }
+ */
+class JsonValue {
+public:
+    using Node = json_reader_detail::Node;
+
+    JsonValue() = default;
+    JsonValue(const Node* nodes, const Node* node) : m_nodes(nodes), m_node(node) {}
+
+    bool valid() const { return m_node != nullptr; }
+    explicit operator bool() const { return valid(); }
+    JsonType type() const { return m_node ? m_node->type : JsonType::Null; }
+    bool isNull() const { return type() == JsonType::Null; }
+    bool isBool() const { return type() == JsonType::Bool; }
+    bool isNumber() const { return type() == JsonType::Number; }
+    bool isString() const { return type() == JsonType::String; }
+    bool isArray() const { return type() == JsonType::Array; }
+    bool isObject() const { return type() == JsonType::Object; }
+
+    // Elements of an array / members of an object
+    size_t size() const { return isArray() || isObject() ? m_node->count : 0; }
+    // Member name, when this value is an object member
+    std::string_view key() const { return m_node ? m_node->keyView() : std::string_view(); }
+
+    JsonValue operator[](std::string_view key) const {
+        if (!isObject()) return JsonValue();
+        for (JsonValue member : *this) {
+            if (member.m_node->keyView() == key) return member;
+        }
+        return JsonValue();
+    }
+
+    // O(index): iterate to visit a whole array
+    JsonValue operator[](size_t index) const {
+        if (!isArray() || index >= m_node->count) return JsonValue();
+        const Node* node = m_nodes + m_node->first;
+        for (size_t i = 0; i < index; i++) node = m_nodes + node->next;
+        return JsonValue(m_nodes, node);
+    }
+
+    JsonValue find(std::string_view key) const {
+        for (JsonValue child : *this) {
+            if (isObject() && child.m_node->keyView() == key) return child;
+            if (JsonValue found = child.find(key)) return found;
+        }
+        return JsonValue();
+    }
+
+    std::string_view asString(std::string_view fallback = {}) const {
+        return isString() ? std::string_view(m_node->text, m_node->textLength) : fallback;
+    }
+    double asDouble(double fallback = 0.0) const { return isNumber() ? m_node->number : fallback; }
+    float asFloat(float fallback = 0.0f) const { return isNumber() ? static_cast<float>(m_node->number) : fallback; }
+    // Truncates; out-of-range and nan give the fallback
+    int asInt(int fallback = 0) const {
+        if (!isNumber()) return fallback;
+        double value = m_node->number;
+        if (!(value > std::numeric_limits<int>::min() - 1.0 && value < std::numeric_limits<int>::max() + 1.0)) {
+            return fallback;
+        }
+        return static_cast<int>(value);
+    }
+    bool asBool(bool fallback = false) const {
+        if (isBool()) return m_node->boolean;
+        if (isNumber()) return m_node->number != 0.0;
+        return fallback;
+    }
+
+    // The first up to `count` numbers of an array into `out`; returns how
+    // many were written. Non-numbers leave their slot untouched.
+    size_t readFloats(float* out, size_t count) const {
+        size_t written = 0;
+        for (JsonValue element : *this) {
+            if (written == count) break;
+            if (element.isNumber()) out[written] = element.asFloat();
+            written++;
+        }
+        return written;
+    }
+
+    class Iterator {
+    public:
+        Iterator(const Node* nodes, const Node* node) : m_nodes(nodes), m_node(node) {}
+        JsonValue operator*() const { return JsonValue(m_nodes, m_node); }
+        Iterator& operator++() {
+            m_node = m_node->next ? m_nodes + m_node->next : nullptr;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return m_node != other.m_node; }
+
+    private:
+        const Node* m_nodes;
+        const Node* m_node;
+    };
+
+    // Array elements / object members in document order
+    Iterator begin() const {
+        return Iterator(m_nodes, size() ? m_nodes + m_node->first : nullptr);
+    }
+    Iterator end() const { return Iterator(m_nodes, nullptr); }
+
+private:
+    const Node* m_nodes = nullptr;
+    const Node* m_node = nullptr;
+};
+
+/**
+ * A parsed JSON document. parse() walks the text once into nodes; strings
+ * without escapes stay views of the text, so the document keeps it alive:
+ * parseFile() holds the VFS mapping, parse() a copy (or the moved-in string),
+ * parseView() borrows text the caller keeps alive. Not copyable; moving
+ * keeps existing JsonValues valid.
+ *
+ * Usage:
+ *   JsonDocument doc;
+ *   if (!doc.parseFile("items/wrench.hdma")) {
+ *       std::cerr << "[HDM] " << doc.error() << std::endl;
+ *   }
+ *   int id = doc.root()["properties"]["item"]["item_type_id"].asInt();
+ */
+class JsonDocument {
+public:
+    using Node = json_reader_detail::Node;
+
+    JsonDocument() = default;
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+    JsonDocument(JsonDocument&&) = default;
+    JsonDocument& operator=(JsonDocument&&) = default;
+
+    bool parse(std::string text) {
+        m_file.reset();
+        m_owned = std::make_unique<std::string>(std::move(text));
+        return parseText(m_owned->data(), m_owned->size());
+    }
+
+    // No copy: `text` must outlive the document
+    bool parseView(std::string_view text) {
+        m_file.reset();
+        m_owned.reset();
+        return parseText(text.data(), text.size());
+    }
+
+    // Parses the VFS bytes (archive entry or loose file) where they are
+    bool parseFile(const std::string& path) {
+        m_owned.reset();
+        m_file.reset();
+        if (!Vfs::shared().open(path, m_file)) {
+            m_nodes.clear();
+            m_error = "cannot open " + path;
+            return false;
+        }
+        if (!parseText(m_file.data(), m_file.size())) {
+            m_error = path + ": " + m_error;
+            return false;
+        }
+        return true;
+    }
+
+    // Invalid after a failed parse
+    JsonValue root() const { return m_nodes.empty() ? JsonValue() : JsonValue(m_nodes.data(), m_nodes.data()); }
+    // "line L, column C: reason" for the last failed parse
+    const std::string& error() const { return m_error; }
+    size_t nodeCount() const { return m_nodes.size(); }
+
+private:
+    bool parseText(const char* text, size_t size) {
+        m_nodes.clear();
+        m_nodes.reserve(size / 8 + 1);  // Address space only until touched
+        m_unescaped.clear();
+        m_error.clear();
+
+        m_begin = m_cur = text;
+        m_end = text + size;
+        bool ok = parseValue(0);
+        if (ok) {
+            skipWhitespace();
+            if (m_cur != m_end) ok = fail("unexpected characters after the document");
+        }
+        if (!ok) m_nodes.clear();
+        return ok;
+    }
+
+    bool fail(const char* reason) {
+        size_t line = 1, column = 1;
+        for (const char* p = m_begin; p < m_cur && p < m_end; p++) {
+            if (*p == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+        }
+        m_error = "line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + reason;
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (m_cur < m_end && (*m_cur == ' ' || *m_cur == '\n' || *m_cur == '\r' || *m_cur == '\t')) m_cur++;
+    }
+
+    bool literal(const char* word, size_t length) {
+        if (static_cast<size_t>(m_end - m_cur) < length || std::memcmp(m_cur, word, length) != 0) return false;
+        m_cur += length;
+        return true;
+    }
+
+    // The value at m_cur as a new node, appended ahead of its children
+    bool parseValue(int depth) {
+        skipWhitespace();
+        if (m_cur == m_end) return fail("unexpected end of document");
+        if (depth > json_reader_detail::MAX_DEPTH) return fail("nested too deeply");
+
+        uint32_t index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        char c = *m_cur;
+        switch (c) {
+            case '{': return parseContainer(index, depth, '}', JsonType::Object);
+            case '[': return parseContainer(index, depth, ']', JsonType::Array);
+            case '"': {
+                const char* text = nullptr;
+                uint32_t length = 0;
+                if (!parseString(text, length)) return false;
+                m_nodes[index].type = JsonType::String;
+                m_nodes[index].text = text;
+                m_nodes[index].textLength = length;
+                return true;
+            }
+            case 't':
+            case 'f':
+                if (literal("true", 4) || literal("false", 5)) {
+                    m_nodes[index].type = JsonType::Bool;
+                    m_nodes[index].boolean = c == 't';
+                    return true;
+                }
+                return fail("invalid literal");
+            case 'n':
+                if (literal("null", 4)) return true;
+                return parseNumber(index);  // nan
+            default: return parseNumber(index);
+        }
+    }
+
+    bool parseContainer(uint32_t index, int depth, char close, JsonType type) {
+        m_nodes[index].type = type;
+        m_cur++;
+        uint32_t last = 0;
+        for (;;) {
+            skipWhitespace();
+            if (m_cur == m_end) return fail(type == JsonType::Object ? "unterminated object" : "unterminated array");
+            if (*m_cur == close) {
+                m_cur++;
+                return true;
+            }
+            if (m_nodes[index].count > 0) {
+                if (*m_cur != ',') return fail(type == JsonType::Object ? "expected ',' or '}'" : "expected ',' or ']'");
+                m_cur++;
+                skipWhitespace();
+                if (m_cur < m_end && *m_cur == close) continue;  // Trailing comma
+            }
+
+            const char* key = nullptr;
+            uint32_t keyLength = 0;
+            if (type == JsonType::Object) {
+                skipWhitespace();
+                if (m_cur == m_end || *m_cur != '"') return fail("expected a member name");
+                if (!parseString(key, keyLength)) return false;
+                skipWhitespace();
+                if (m_cur == m_end || *m_cur != ':') return fail("expected ':'");
+                m_cur++;
+            }
+
+            uint32_t child = static_cast<uint32_t>(m_nodes.size());
+            if (!parseValue(depth + 1)) return false;
+            m_nodes[child].key = key;
+            m_nodes[child].keyLength = keyLength;
+            if (last) {
+                m_nodes[last].next = child;
+            } else {
+                m_nodes[index].first = child;
+            }
+            last = child;
+            m_nodes[index].count++;
+        }
+    }
+
+    // A view of the text when there are no escapes (nearly always);
+    // otherwise unescaped into m_unescaped
+    bool parseString(const char*& out, uint32_t& length) {
+        const char* start = ++m_cur;
+        const char* quote = nullptr;
+        m_cur = findQuoteOrBackslash(m_cur, quote);
+        if (m_cur == m_end) return fail("unterminated string");
+        if (*m_cur == '"') {
+            out = start;
+            length = static_cast<uint32_t>(m_cur - start);
+            m_cur++;
+            return true;
+        }
+
+        // Unescaped strings never outgrow the text, so one reservation
+        // keeps every earlier string where it is
+        if (m_unescaped.empty() && m_unescaped.capacity() < static_cast<size_t>(m_end - m_begin)) {
+            m_unescaped.reserve(static_cast<size_t>(m_end - m_begin));
+        }
+        size_t begin = m_unescaped.size();
+        m_unescaped.insert(m_unescaped.end(), start, m_cur);
+        for (;;) {
+            // At a backslash
+            if (m_cur + 1 == m_end) return fail("unterminated string");
+            char e = m_cur[1];
+            m_cur += 2;
+            switch (e) {
+                case '"': m_unescaped.push_back('"'); break;
+                case '\\': m_unescaped.push_back('\\'); break;
+                case '/': m_unescaped.push_back('/'); break;
+                case 'b': m_unescaped.push_back('\b'); break;
+                case 'f': m_unescaped.push_back('\f'); break;
+                case 'n': m_unescaped.push_back('\n'); break;
+                case 'r': m_unescaped.push_back('\r'); break;
+                case 't': m_unescaped.push_back('\t'); break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!parseHex4(m_cur, cp)) return fail("invalid \\u escape");
+                    m_cur += 4;
+                    if (cp >= 0xD800 && cp < 0xDC00 && m_end - m_cur >= 6 && m_cur[0] == '\\' && m_cur[1] == 'u') {
+                        uint32_t low = 0;
+                        if (parseHex4(m_cur + 2, low) && low >= 0xDC00 && low < 0xE000) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            m_cur += 6;
+                        }
+                    }
+                    char utf8[4];
+                    m_unescaped.insert(m_unescaped.end(), utf8, json_reader_detail::encode_utf8(cp, utf8));
+                    break;
+                }
+                default:  // Not an escape: a backslash written as-is
+                    m_unescaped.push_back('\\');
+                    m_cur--;
+                    break;
+            }
+
+            const char* run = m_cur;
+            m_cur = findQuoteOrBackslash(m_cur, quote);
+            m_unescaped.insert(m_unescaped.end(), run, m_cur);
+            if (m_cur == m_end) return fail("unterminated string");
+            if (*m_cur == '"') {
+                out = m_unescaped.data() + begin;
+                length = static_cast<uint32_t>(m_unescaped.size() - begin);
+                m_cur++;
+                return true;
+            }
+        }
+    }
+
+    // Keys and names end within a few bytes; long values (base64 payloads,
+    // most of an .hdma) are skipped with memchr. `quote` caches the next
+    // quote across the escapes of one string.
+    const char* findQuoteOrBackslash(const char* p, const char*& quote) const {
+        for (int i = 0; i < 32 && p < m_end; i++, p++) {
+            if (*p == '"' || *p == '\\') return p;
+        }
+        if (p == m_end) return p;
+        if (!quote || quote < p) {
+            quote = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(m_end - p)));
+            if (!quote) quote = m_end;
+        }
+        const char* slash = static_cast<const char*>(std::memchr(p, '\\', static_cast<size_t>(quote - p)));
+        return slash ? slash : quote;
+    }
+
+    bool parseHex4(const char* p, uint32_t& out) const {
+        if (m_end - p < 4) return false;
+        out = 0;
+        for (int i = 0; i < 4; i++) {
+            int digit = json_reader_detail::hex_digit(p[i]);
+            if (digit < 0) return false;
+            out = out * 16 + static_cast<uint32_t>(digit);
+        }
+        return true;
+    }
+
+    bool parseNumber(uint32_t index) {
+        // Plain integers are most of what the engine writes; skip strtod for them
+        const char* p = m_cur;
+        bool negative = *p == '-';
+        if (negative) p++;
+        uint64_t integer = 0;
+        int digits = 0;
+        while (p < m_end && *p >= '0' && *p <= '9' && digits < 18) {
+            integer = integer * 10 + static_cast<uint64_t>(*p++ - '0');
+            digits++;
+        }
+        if (digits > 0 && (p == m_end || (*p != '.' && *p != 'e' && *p != 'E' && !(*p >= '0' && *p <= '9')))) {
+            m_nodes[index].number = negative ? -static_cast<double>(integer) : static_cast<double>(integer);
+            m_nodes[index].type = JsonType::Number;
+            m_cur = p;
+            return true;
+        }
+
+        // strtod wants a terminated string and the text may be a mapping
+        p = m_cur;
+        while (p < m_end && (std::isalnum(static_cast<unsigned char>(*p)) || *p == '+' || *p == '-' || *p == '.')) p++;
+        char token[64];
+        size_t length = static_cast<size_t>(p - m_cur);
+        if (length == 0 || length >= sizeof(token)) return fail("invalid value");
+        std::memcpy(token, m_cur, length);
+        token[length] = '\0';
+        char* parsed = nullptr;
+        double value = std::strtod(token, &parsed);
+        if (parsed != token + length) return fail("invalid value");
+        m_nodes[index].number = value;
+        m_nodes[index].type = JsonType::Number;
+        m_cur = p;
+        return true;
+    }
+
+    VfsFile m_file;
+    std::unique_ptr<std::string> m_owned;
+    std::vector<char> m_unescaped;
+    std::vector<Node> m_nodes;
+    std::string m_error;
+    const char* m_begin = nullptr;
+    const char* m_cur = nullptr;
+    const char* m_end = nullptr;
+};
+
+// `text` as a JSON string literal, quotes included, for the writers that
+// pair with JsonDocument
+inline std::string json_quote(std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(text.size() + 2);
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += hex[(c >> 4) & 0xF];
+                    out += hex[c & 0xF];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+#endif // EDEN_JSON_READER_H
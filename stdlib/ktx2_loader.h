@@ -0,0 +1,457 @@
+// EDEN ENGINE - KTX2 Texture Loader
+// GPU-ready textures from KTX2 containers (written by vulkan/tools/texture_cook)
+//
+//   - Block-compressed (BC1-BC7) and plain formats upload as stored, with
+//     every mip level the file carries.
+//   - Basis Universal payloads (ETC1S/BasisLZ or UASTC) are transcoded at
+//     load time to the best BC format the device samples (BC7, else BC3/BC1,
+//     else RGBA8). Needs the basisu transcoder: build with EDEN_USE_BASISU
+//     and third_party/basisu/transcoder/basisu_transcoder.cpp.
+//   - Zstd supercompression is only handled through the basisu path.
+//
+// Uses <vulkan/vulkan.h> directly (not "vulkan.h") so VulkanCore can share it.
+
+#ifndef EDEN_KTX2_LOADER_H
+#define EDEN_KTX2_LOADER_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#include "vfs.h"
+
+#ifdef EDEN_USE_BASISU
+#include "../third_party/basisu/transcoder/basisu_transcoder.h"
+#endif
+
+// KTX2 file identifier: «KTX 20»\r\n\x1A\n
+static const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+// Supercompression schemes
+#define KTX2_SUPERCOMPRESSION_NONE 0
+#define KTX2_SUPERCOMPRESSION_BASISLZ 1
+#define KTX2_SUPERCOMPRESSION_ZSTD 2
+
+// Data Format Descriptor values we read/write
+#define KTX2_DF_MODEL_RGBSDA 1
+#define KTX2_DF_MODEL_BC1A 128
+#define KTX2_DF_MODEL_BC3 130
+#define KTX2_DF_MODEL_BC7 134
+#define KTX2_DF_MODEL_UASTC 166
+#define KTX2_DF_TRANSFER_LINEAR 1
+#define KTX2_DF_TRANSFER_SRGB 2
+
+// KTX2 header (after the 12-byte identifier). Packed: the 64-bit fields
+// sit at a 4-byte offset in the file.
+#pragma pack(push, 1)
+struct KTX2Header {
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;            // 0 = no mips stored (load as 1 level)
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+#pragma pack(pop)
+
+struct KTX2LevelIndex {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+// Loaded KTX2 data (same shape as DDSData, level 0 first)
+struct KTX2Data {
+    VkFormat format = VK_FORMAT_UNDEFINED;  // UNDEFINED = failed (see error)
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipmapCount = 1;
+    std::vector<uint8_t> data;              // All levels, packed, level 0 first
+    std::vector<uint32_t> mipOffsets;       // Byte offset of each level in data
+    std::vector<uint32_t> mipSizes;         // Byte size of each level
+    bool srgb = false;
+    bool hasAlpha = false;
+    bool transcoded = false;                // Came from a Basis Universal payload
+    std::string error;
+};
+
+// 4x4 block size in bytes (0 = not a BC format)
+inline uint32_t ktx2_block_size(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            return 8;
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+// Bytes per texel for the uncompressed formats we accept (0 = unsupported)
+inline uint32_t ktx2_texel_size(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_R8_UNORM:
+            return 1;
+        case VK_FORMAT_R8G8_UNORM:
+            return 2;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+inline uint32_t ktx2_level_size(VkFormat format, uint32_t width, uint32_t height) {
+    uint32_t blockSize = ktx2_block_size(format);
+    if (blockSize > 0) return ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+    return width * height * ktx2_texel_size(format);
+}
+
+inline bool ktx2_is_srgb(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Sampled with linear filtering in optimal tiling
+inline bool ktx2_format_usable(VkPhysicalDevice physicalDevice, VkFormat format) {
+    if (physicalDevice == VK_NULL_HANDLE) return true;  // Caller checks later
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+    const VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (props.optimalTilingFeatures & needed) == needed;
+}
+
+// Best transcode target for a Basis payload: BC7 > BC3 (alpha) / BC1 > RGBA8
+inline VkFormat ktx2_pick_transcode_format(VkPhysicalDevice physicalDevice, bool hasAlpha, bool srgb) {
+    VkFormat bc7 = srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    VkFormat bc3 = srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+    VkFormat bc1 = srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+    if (ktx2_format_usable(physicalDevice, bc7)) return bc7;
+    if (hasAlpha && ktx2_format_usable(physicalDevice, bc3)) return bc3;
+    if (!hasAlpha && ktx2_format_usable(physicalDevice, bc1)) return bc1;
+    return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+// Levels in a full mip chain: floor(log2(max(width, height))) + 1
+inline uint32_t ktx2_max_levels(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = width > height ? width : height; size > 1; size >>= 1) levels++;
+    return levels;
+}
+
+// False for a zero extent, more levels than the chain has, or levels that
+// don't fit in 4 GB (sizes come from the file, so they're checked before
+// anything is allocated)
+inline bool ktx2_pack_levels(KTX2Data& result) {
+    result.mipOffsets.clear();
+    result.mipSizes.clear();
+    if (result.width == 0 || result.height == 0 ||
+        result.mipmapCount > ktx2_max_levels(result.width, result.height)) {
+        return false;
+    }
+
+    uint32_t blockSize = ktx2_block_size(result.format);
+    uint32_t unitBytes = blockSize > 0 ? blockSize : ktx2_texel_size(result.format);
+    uint64_t offset = 0;
+    uint32_t width = result.width;
+    uint32_t height = result.height;
+    for (uint32_t level = 0; level < result.mipmapCount; level++) {
+        uint64_t units = blockSize > 0 ? uint64_t((width + 3ull) / 4) * ((height + 3ull) / 4)
+                                       : uint64_t(width) * height;
+        if (unitBytes > 0 && units > UINT32_MAX / unitBytes) return false;
+        uint64_t size = units * unitBytes;
+        if (size > UINT32_MAX - offset) return false;
+        result.mipOffsets.push_back(static_cast<uint32_t>(offset));
+        result.mipSizes.push_back(static_cast<uint32_t>(size));
+        offset += size;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return true;
+}
+
+#ifdef EDEN_USE_BASISU
+inline bool ktx2_transcode_basis(const uint8_t* file, size_t fileSize, VkPhysicalDevice physicalDevice, KTX2Data& result) {
+    // Once per process; load_ktx2 may run on ResourceLoader workers
+    static const bool initialized = (basist::basisu_transcoder_init(), true);
+    (void)initialized;
+
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(file, static_cast<uint32_t>(fileSize)) || !transcoder.start_transcoding()) {
+        result.error = "basisu could not start transcoding";
+        return false;
+    }
+
+    result.width = transcoder.get_width();
+    result.height = transcoder.get_height();
+    result.mipmapCount = transcoder.get_levels() > 0 ? transcoder.get_levels() : 1;
+    result.hasAlpha = transcoder.get_has_alpha();
+    result.format = ktx2_pick_transcode_format(physicalDevice, result.hasAlpha, result.srgb);
+
+    basist::transcoder_texture_format target = basist::transcoder_texture_format::cTFRGBA32;
+    if (ktx2_block_size(result.format) == 16) {
+        target = (result.format == VK_FORMAT_BC7_SRGB_BLOCK || result.format == VK_FORMAT_BC7_UNORM_BLOCK)
+            ? basist::transcoder_texture_format::cTFBC7_RGBA : basist::transcoder_texture_format::cTFBC3_RGBA;
+    } else if (ktx2_block_size(result.format) == 8) {
+        target = basist::transcoder_texture_format::cTFBC1_RGB;
+    }
+
+    if (!ktx2_pack_levels(result)) {
+        result.error = "invalid size or level count";
+        return false;
+    }
+    result.data.resize(size_t(result.mipOffsets.back()) + result.mipSizes.back());
+
+    uint32_t width = result.width;
+    uint32_t height = result.height;
+    for (uint32_t level = 0; level < result.mipmapCount; level++) {
+        // Output size is in blocks for BC targets, pixels for RGBA32
+        uint32_t units = ktx2_block_size(result.format) > 0 ? ((width + 3) / 4) * ((height + 3) / 4) : width * height;
+        if (!transcoder.transcode_image_level(level, 0, 0, result.data.data() + result.mipOffsets[level], units, target)) {
+            result.error = "basisu failed on level " + std::to_string(level);
+            return false;
+        }
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    result.transcoded = true;
+    return true;
+}
+#endif
+
+/**
+ * Load a KTX2 file (2D, one layer, one face)
+ *
+ * @param path Path to the .ktx2 file
+ * @param physicalDevice Picks the transcode target for Basis payloads (may be null: BC7)
+ * @return KTX2Data; format == VK_FORMAT_UNDEFINED on failure with `error` set
+ */
+inline KTX2Data load_ktx2(const std::string& path, VkPhysicalDevice physicalDevice = VK_NULL_HANDLE) {
+    KTX2Data result;
+
+    VfsFile in;
+    if (!Vfs::shared().open(path, in)) {
+        result.error = "cannot open file";
+        return result;
+    }
+    // Parsed in place: a view into the mapped archive or file, not a copy
+    const uint8_t* file = in.bytes();
+    size_t fileSize = in.size();
+
+    if (fileSize < sizeof(KTX2_IDENTIFIER) + sizeof(KTX2Header) ||
+        memcmp(file, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        result.error = "not a KTX2 file";
+        return result;
+    }
+
+    KTX2Header header;
+    memcpy(&header, file + sizeof(KTX2_IDENTIFIER), sizeof(KTX2Header));
+    if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1) {
+        result.error = "only single 2D images are supported (no arrays, cubemaps or 3D)";
+        return result;
+    }
+
+    // Color model and transfer function from the first DFD block
+    uint32_t colorModel = 0;
+    if (header.dfdByteLength >= 16 && header.dfdByteOffset <= fileSize && 16 <= fileSize - header.dfdByteOffset) {
+        const uint8_t* dfd = file + header.dfdByteOffset;
+        colorModel = dfd[12];
+        result.srgb = dfd[14] == KTX2_DF_TRANSFER_SRGB;
+    }
+
+    bool basis = header.vkFormat == VK_FORMAT_UNDEFINED &&
+                 (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_BASISLZ || colorModel == KTX2_DF_MODEL_UASTC);
+    if (basis) {
+#ifdef EDEN_USE_BASISU
+        if (!ktx2_transcode_basis(file, fileSize, physicalDevice, result)) result.format = VK_FORMAT_UNDEFINED;
+#else
+        (void)physicalDevice;
+        result.error = "Basis Universal payload - rebuild with EDEN_USE_BASISU to transcode";
+#endif
+        return result;
+    }
+
+    result.format = static_cast<VkFormat>(header.vkFormat);
+    if (header.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE) {
+        result.format = VK_FORMAT_UNDEFINED;
+        result.error = "supercompressed payload (zstd) is not supported without basisu";
+        return result;
+    }
+    if (ktx2_block_size(result.format) == 0 && ktx2_texel_size(result.format) == 0) {
+        result.format = VK_FORMAT_UNDEFINED;
+        result.error = "unsupported vkFormat " + std::to_string(header.vkFormat);
+        return result;
+    }
+
+    result.width = header.pixelWidth;
+    result.height = header.pixelHeight;
+    result.mipmapCount = header.levelCount > 0 ? header.levelCount : 1;
+    result.srgb = ktx2_is_srgb(result.format);
+    result.hasAlpha = result.format != VK_FORMAT_BC1_RGB_UNORM_BLOCK && result.format != VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+
+    // Level index follows the header; levels are stored smallest-first
+    // in the file but indexed from level 0
+    size_t indexOffset = sizeof(KTX2_IDENTIFIER) + sizeof(KTX2Header);
+    if (!ktx2_pack_levels(result)) {
+        result.format = VK_FORMAT_UNDEFINED;
+        result.error = "invalid size " + std::to_string(header.pixelWidth) + "x" + std::to_string(header.pixelHeight) +
+                       " with " + std::to_string(header.levelCount) + " levels";
+        return result;
+    }
+    if (result.mipmapCount * sizeof(KTX2LevelIndex) > fileSize - indexOffset) {
+        result.format = VK_FORMAT_UNDEFINED;
+        result.error = "truncated level index";
+        return result;
+    }
+
+    result.data.resize(size_t(result.mipOffsets.back()) + result.mipSizes.back());
+    for (uint32_t level = 0; level < result.mipmapCount; level++) {
+        KTX2LevelIndex entry;
+        memcpy(&entry, file + indexOffset + level * sizeof(KTX2LevelIndex), sizeof(KTX2LevelIndex));
+        if (entry.byteLength < result.mipSizes[level] || entry.byteOffset > fileSize ||
+            result.mipSizes[level] > fileSize - entry.byteOffset) {
+            result.format = VK_FORMAT_UNDEFINED;
+            result.error = "level " + std::to_string(level) + " is truncated";
+            result.data.clear();
+            return result;
+        }
+        memcpy(result.data.data() + result.mipOffsets[level], file + entry.byteOffset, result.mipSizes[level]);
+    }
+
+    return result;
+}
+
+// One VkBufferImageCopy per mip level, for a staging buffer holding data as-is
+inline std::vector<VkBufferImageCopy> ktx2_copy_regions(const KTX2Data& ktx) {
+    std::vector<VkBufferImageCopy> regions;
+    uint32_t width = ktx.width;
+    uint32_t height = ktx.height;
+
+    for (uint32_t level = 0; level < ktx.mipmapCount && level < ktx.mipOffsets.size(); level++) {
+        VkBufferImageCopy region = {};
+        region.bufferOffset = ktx.mipOffsets[level];
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {width, height, 1};
+        regions.push_back(region);
+
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return regions;
+}
+
+/**
+ * Write a 2D KTX2 file (no supercompression) - used by the texture cooker
+ *
+ * @param levels One buffer per mip level, level 0 first, each ktx2_level_size() bytes
+ * @return false if the file can't be written
+ */
+inline bool write_ktx2(const std::string& path, VkFormat format, uint32_t width, uint32_t height,
+                       const std::vector<std::vector<uint8_t>>& levels) {
+    const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+    const bool srgb = ktx2_is_srgb(format);
+    const uint32_t blockSize = ktx2_block_size(format);
+
+    // Basic Data Format Descriptor: one block, one sample covering the texel block
+    uint32_t colorModel = KTX2_DF_MODEL_RGBSDA;
+    if (blockSize == 8) colorModel = KTX2_DF_MODEL_BC1A;
+    if (format == VK_FORMAT_BC3_UNORM_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK) colorModel = KTX2_DF_MODEL_BC3;
+    if (format == VK_FORMAT_BC7_UNORM_BLOCK || format == VK_FORMAT_BC7_SRGB_BLOCK) colorModel = KTX2_DF_MODEL_BC7;
+    uint32_t texelBytes = blockSize > 0 ? blockSize : ktx2_texel_size(format);
+
+    std::vector<uint32_t> dfd(11, 0);
+    dfd[0] = static_cast<uint32_t>(dfd.size() * 4);        // Total size
+    dfd[1] = 0;                                            // Khronos vendor, basic descriptor
+    dfd[2] = 2u | ((static_cast<uint32_t>(dfd.size() * 4) - 4) << 16);  // Version 2, block size
+    dfd[3] = colorModel | (1u << 8) /* BT.709 */ |
+             ((srgb ? KTX2_DF_TRANSFER_SRGB : KTX2_DF_TRANSFER_LINEAR) << 16);
+    dfd[4] = blockSize > 0 ? 0x00000303u : 0u;             // Texel block 4x4 (dimensions - 1)
+    dfd[5] = texelBytes;                                   // bytesPlane0
+    dfd[7] = (texelBytes * 8 - 1) << 16;                  // Sample: offset 0, all bits, channel 0
+    dfd[10] = 0xFFFFFFFFu;                                 // sampleUpper
+
+    const size_t headerEnd = sizeof(KTX2_IDENTIFIER) + sizeof(KTX2Header) + levelCount * sizeof(KTX2LevelIndex);
+    const size_t dfdOffset = headerEnd;
+    const size_t dataStart = dfdOffset + dfd.size() * 4;
+    const size_t alignment = blockSize > 0 ? blockSize : 4;  // lcm(texel block size, 4)
+
+    // Smallest level first, each aligned
+    std::vector<KTX2LevelIndex> index(levelCount);
+    size_t offset = dataStart;
+    for (int level = static_cast<int>(levelCount) - 1; level >= 0; level--) {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        index[level].byteOffset = offset;
+        index[level].byteLength = levels[level].size();
+        index[level].uncompressedByteLength = levels[level].size();
+        offset += levels[level].size();
+    }
+
+    KTX2Header header = {};
+    header.vkFormat = static_cast<uint32_t>(format);
+    header.typeSize = 1;
+    header.pixelWidth = width;
+    header.pixelHeight = height;
+    header.faceCount = 1;
+    header.levelCount = levelCount;
+    header.dfdByteOffset = static_cast<uint32_t>(dfdOffset);
+    header.dfdByteLength = static_cast<uint32_t>(dfd.size() * 4);
+
+    std::vector<uint8_t> file(offset, 0);
+    memcpy(file.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    memcpy(file.data() + sizeof(KTX2_IDENTIFIER), &header, sizeof(header));
+    memcpy(file.data() + sizeof(KTX2_IDENTIFIER) + sizeof(header), index.data(), index.size() * sizeof(KTX2LevelIndex));
+    memcpy(file.data() + dfdOffset, dfd.data(), dfd.size() * 4);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        memcpy(file.data() + index[level].byteOffset, levels[level].data(), levels[level].size());
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+    out.write(reinterpret_cast<const char*>(file.data()), file.size());
+    return out.good();
+}
+
+#endif // EDEN_KTX2_LOADER_H
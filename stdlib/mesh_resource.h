@@ -7,9 +7,14 @@
 
 #include "vulkan.h"
 #include "obj_loader.h"
+#include "../vulkan/core/gpu_allocator.h"
+#include "../vulkan/core/upload_batch.h"
+#include "../vulkan/utils/mesh_cache.h"
 #include <vector>
 #include <string>
 #include <cstring>
+#include <algorithm>
+#include <utility>
 
 // Forward declarations for Vulkan globals (same as TextureResource)
 extern VkDevice g_device;
@@ -31,81 +36,124 @@ struct MeshVertex {
  * - Basic geometry (vertices, normals)
  * - Textured OBJs (UV coordinates)
  * - Automatic GPU buffer creation
+ * 
+ * Like TextureResource, loading is two-phase for Resource<T>'s async mode:
+ * decode() parses the OBJ (and builds its LODs) on any thread, the Decoded
+ * constructor creates the buffers on the render thread.
+ * 
+ * decode() results are kept in the binary mesh cache (see
+ * vulkan/utils/mesh_cache.h): an unchanged OBJ is not parsed again, its
+ * interleaved vertices and indices are read back as they are uploaded.
+ * 
+ * Editors change the data in place: markVerticesDirty() /
+ * markIndicesDirty() after an edit, uploadDirty() once per frame copies
+ * only those ranges into the existing buffers. rebuildBuffers() leaves
+ * headroom, so an extrude or edge loop usually fits without reallocating.
  */
 class MeshResource {
+public:
+    // CPU-side result of decode(), in the GPU layout
+    struct Decoded {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices;      // LOD 0
+        std::vector<uint32_t> lodIndices;   // Simplified levels, appended after indices
+        std::vector<vkcore::MeshLod> lods;
+        bool hasNormals = false;
+        bool hasTexcoords = false;
+    };
+    
 private:
     VkBuffer m_vertexBuffer = VK_NULL_HANDLE;
     VkBuffer m_indexBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory m_vertexBufferMemory = VK_NULL_HANDLE;
-    VkDeviceMemory m_indexBufferMemory = VK_NULL_HANDLE;
+    vkcore::GpuAllocation m_vertexBufferAlloc;
+    vkcore::GpuAllocation m_indexBufferAlloc;
     
     uint32_t m_indexCount = 0;
+    uint32_t m_vertexCapacity = 0;  // Elements the buffers hold (rebuildBuffers() leaves headroom)
+    uint32_t m_indexCapacity = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> m_dirtyVertices;  // {first, count}, for uploadDirty()
+    uint32_t m_dirtyIndicesFrom = UINT32_MAX;
+    std::vector<vkcore::MeshLod> m_lods;  // LOD ranges in the index buffer; empty = LOD 0 only
     bool m_loaded = false;
     bool m_hasNormals = false;
     bool m_hasTexcoords = false;
+    vkcore::UploadBatch::Ticket m_uploadTicket = vkcore::UploadBatch::NO_UPLOAD;
     
-    // Helper function to find memory type (same as TextureResource)
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(g_physicalDevice, &memProperties);
-        
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-            if ((typeFilter & (1 << i)) && 
-                (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-                return i;
-            }
-        }
-        
-        return UINT32_MAX;
+    // Shared sub-allocator (same as TextureResource)
+    static vkcore::GpuAllocator& gpuAllocator() {
+        return vkcore::GpuAllocator::shared(g_device, g_physicalDevice);
     }
     
     // Create buffer helper
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, 
                      VkMemoryPropertyFlags properties, VkBuffer& buffer, 
-                     VkDeviceMemory& bufferMemory) {
-        VkBufferCreateInfo bufferInfo = {};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = size;
-        bufferInfo.usage = usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        
-        if (vkCreateBuffer(g_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+                     vkcore::GpuAllocation& alloc) {
+        if (!gpuAllocator().createBuffer(size, usage, properties, buffer, alloc)) {
             throw std::runtime_error("Failed to create buffer");
         }
-        
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(g_device, buffer, &memRequirements);
-        
-        VkMemoryAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-        
-        if (allocInfo.memoryTypeIndex == UINT32_MAX) {
-            vkDestroyBuffer(g_device, buffer, nullptr);
-            throw std::runtime_error("Failed to find suitable memory type for buffer");
+    }
+    
+    // Shared upload batch (same as TextureResource)
+    static vkcore::UploadBatch& uploads() {
+        return vkcore::UploadBatch::shared();
+    }
+    
+    // Device-local buffer filled through the upload batch - no queue wait;
+    // the batch's closing barrier orders the copy before later draws.
+    // capacity > size leaves room for uploadDirty() to grow into.
+    void createUploadedBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+                              VkBuffer& buffer, vkcore::GpuAllocation& alloc, VkDeviceSize capacity = 0) {
+        createBuffer(std::max(size, capacity), usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, alloc);
+        vkcore::UploadBatch::Ticket ticket = uploads().uploadBuffer(buffer, data, size);
+        if (ticket == vkcore::UploadBatch::NO_UPLOAD) {
+            throw std::runtime_error("Failed to upload buffer");
         }
-        
-        if (vkAllocateMemory(g_device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-            vkDestroyBuffer(g_device, buffer, nullptr);
-            throw std::runtime_error("Failed to allocate buffer memory");
+        m_uploadTicket = std::max(m_uploadTicket, ticket);
+    }
+    
+    // Bump when the Decoded layout or the OBJ import changes (cache key)
+    static constexpr uint64_t OBJ_CACHE_VERSION = 1;
+    
+    // Cache sections of a Decoded
+    struct CacheMeta {
+        uint32_t vertexStride;
+        uint32_t hasNormals;
+        uint32_t hasTexcoords;
+    };
+    enum CacheSection : uint32_t { CACHE_META, CACHE_VERTICES, CACHE_INDICES, CACHE_LOD_INDICES, CACHE_LODS };
+    
+    static bool readCache(const std::string& path, uint64_t key, Decoded& decoded) {
+        eden::MeshCacheReader reader;
+        CacheMeta meta = {};
+        if (!reader.open(path, key, eden::MESH_CACHE_KIND_OBJ) || !reader.read(CACHE_META, meta) ||
+            meta.vertexStride != sizeof(MeshVertex) ||
+            !reader.read(CACHE_VERTICES, decoded.vertices) || !reader.read(CACHE_INDICES, decoded.indices) ||
+            !reader.read(CACHE_LOD_INDICES, decoded.lodIndices) || !reader.read(CACHE_LODS, decoded.lods)) {
+            return false;
         }
-        
-        vkBindBufferMemory(g_device, buffer, bufferMemory, 0);
+        decoded.hasNormals = meta.hasNormals != 0;
+        decoded.hasTexcoords = meta.hasTexcoords != 0;
+        return !decoded.vertices.empty();
     }
     
-    // Load OBJ and create Vulkan buffers
-    void loadOBJ(const std::string& filepath) {
-        // Parse OBJ file
-        MeshData meshData = load_obj(filepath);
-        
-        m_hasNormals = meshData.hasNormals;
-        m_hasTexcoords = meshData.hasTexcoords;
-        m_indexCount = meshData.indexCount;
-        
-        // Convert MeshData to interleaved vertex format
-        m_vertices.clear();
-        m_vertices.reserve(meshData.vertexCount);
+    static void writeCache(const std::string& path, uint64_t key, const Decoded& decoded) {
+        CacheMeta meta = {sizeof(MeshVertex), decoded.hasNormals, decoded.hasTexcoords};
+        eden::MeshCacheWriter writer;
+        writer.add(&meta, sizeof(meta));
+        writer.add(decoded.vertices);
+        writer.add(decoded.indices);
+        writer.add(decoded.lodIndices);
+        writer.add(decoded.lods);
+        writer.write(path, key, eden::MESH_CACHE_KIND_OBJ);  // A failed write only costs the next start a parse
+    }
+    
+    // Convert MeshData to interleaved vertex format
+    static Decoded interleave(MeshData& meshData) {
+        Decoded decoded;
+        decoded.hasNormals = meshData.hasNormals;
+        decoded.hasTexcoords = meshData.hasTexcoords;
+        decoded.vertices.reserve(meshData.vertexCount);
         
         for (size_t i = 0; i < meshData.vertexCount; i++) {
             MeshVertex vertex = {};
@@ -116,7 +164,7 @@ private:
             vertex.pos[2] = meshData.positions[i * 3 + 2];
             
             // Normal
-            if (m_hasNormals && i * 3 + 2 < meshData.normals.size()) {
+            if (decoded.hasNormals && i * 3 + 2 < meshData.normals.size()) {
                 vertex.normal[0] = meshData.normals[i * 3 + 0];
                 vertex.normal[1] = meshData.normals[i * 3 + 1];
                 vertex.normal[2] = meshData.normals[i * 3 + 2];
@@ -127,7 +175,7 @@ private:
             }
             
             // UV coordinates (for textured OBJs)
-            if (m_hasTexcoords && i * 2 + 1 < meshData.texcoords.size()) {
+            if (decoded.hasTexcoords && i * 2 + 1 < meshData.texcoords.size()) {
                 vertex.uv[0] = meshData.texcoords[i * 2 + 0];
                 vertex.uv[1] = meshData.texcoords[i * 2 + 1];
             } else {
@@ -135,104 +183,42 @@ private:
                 vertex.uv[1] = 0.0f; // Default UV
             }
             
-            m_vertices.push_back(vertex);
+            decoded.vertices.push_back(vertex);
         }
         
-        // Store indices
-        m_indices = meshData.indices;
-        
-        // Create vertex buffer
-        VkDeviceSize vertexBufferSize = sizeof(MeshVertex) * m_vertices.size();
-        createBuffer(vertexBufferSize, 
-                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                    m_vertexBuffer, m_vertexBufferMemory);
-        
-        // Create staging buffer for vertex data
-        VkBuffer stagingVertexBuffer;
-        VkDeviceMemory stagingVertexBufferMemory;
-        createBuffer(vertexBufferSize,
-                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                    stagingVertexBuffer, stagingVertexBufferMemory);
-        
-        // Copy vertex data to staging buffer
-        void* data;
-        vkMapMemory(g_device, stagingVertexBufferMemory, 0, vertexBufferSize, 0, &data);
-        memcpy(data, m_vertices.data(), (size_t)vertexBufferSize);
-        vkUnmapMemory(g_device, stagingVertexBufferMemory);
-        
-        // Copy staging buffer to vertex buffer (using command buffer)
-        VkCommandBufferAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = g_commandPool;
-        allocInfo.commandBufferCount = 1;
-        
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(g_device, &allocInfo, &commandBuffer);
-        
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
-        
-        VkBufferCopy copyRegion = {};
-        copyRegion.size = vertexBufferSize;
-        vkCmdCopyBuffer(commandBuffer, stagingVertexBuffer, m_vertexBuffer, 1, &copyRegion);
-        
-        vkEndCommandBuffer(commandBuffer);
-        
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
-        
-        vkQueueSubmit(g_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(g_graphicsQueue);
-        
-        vkFreeCommandBuffers(g_device, g_commandPool, 1, &commandBuffer);
-        vkDestroyBuffer(g_device, stagingVertexBuffer, nullptr);
-        vkFreeMemory(g_device, stagingVertexBufferMemory, nullptr);
-        
-        // Create index buffer
-        VkDeviceSize indexBufferSize = sizeof(uint32_t) * m_indices.size();
-        createBuffer(indexBufferSize,
-                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                    m_indexBuffer, m_indexBufferMemory);
-        
-        // Create staging buffer for index data
-        VkBuffer stagingIndexBuffer;
-        VkDeviceMemory stagingIndexBufferMemory;
-        createBuffer(indexBufferSize,
-                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                    stagingIndexBuffer, stagingIndexBufferMemory);
-        
-        // Copy index data to staging buffer
-        vkMapMemory(g_device, stagingIndexBufferMemory, 0, indexBufferSize, 0, &data);
-        memcpy(data, m_indices.data(), (size_t)indexBufferSize);
-        vkUnmapMemory(g_device, stagingIndexBufferMemory);
-        
-        // Copy staging buffer to index buffer
-        vkAllocateCommandBuffers(g_device, &allocInfo, &commandBuffer);
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
-        
-        copyRegion.size = indexBufferSize;
-        vkCmdCopyBuffer(commandBuffer, stagingIndexBuffer, m_indexBuffer, 1, &copyRegion);
-        
-        vkEndCommandBuffer(commandBuffer);
-        
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
-        
-        vkQueueSubmit(g_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(g_graphicsQueue);
-        
-        vkFreeCommandBuffers(g_device, g_commandPool, 1, &commandBuffer);
-        vkDestroyBuffer(g_device, stagingIndexBuffer, nullptr);
-        vkFreeMemory(g_device, stagingIndexBufferMemory, nullptr);
+        decoded.indices = std::move(meshData.indices);
+        decoded.lodIndices = std::move(meshData.lodIndices);
+        decoded.lods = std::move(meshData.lods);
+        return decoded;
+    }
+    
+    // Create Vulkan buffers for a decoded OBJ
+    void uploadOBJ(Decoded& decoded) {
+        m_hasNormals = decoded.hasNormals;
+        m_hasTexcoords = decoded.hasTexcoords;
+        m_indexCount = static_cast<uint32_t>(decoded.indices.size());
+        m_lods = std::move(decoded.lods);
+        m_vertices = std::move(decoded.vertices);
+        
+        // Store indices (LOD 0 only; the simplified levels live in the GPU buffer)
+        m_indices = decoded.indices;
+        std::vector<uint32_t>& gpuIndices = decoded.indices;
+        gpuIndices.insert(gpuIndices.end(), decoded.lodIndices.begin(), decoded.lodIndices.end());
+        
+        // Vertex and index buffers (one upload batch unless the caller opened one)
+        uploads().begin();
+        try {
+            createUploadedBuffer(m_vertices.data(), sizeof(MeshVertex) * m_vertices.size(),
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_vertexBuffer, m_vertexBufferAlloc);
+            createUploadedBuffer(gpuIndices.data(), sizeof(uint32_t) * gpuIndices.size(),
+                                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer, m_indexBufferAlloc);
+        } catch (...) {
+            uploads().end();
+            throw;
+        }
+        uploads().end();
+        m_vertexCapacity = static_cast<uint32_t>(m_vertices.size());
+        m_indexCapacity = static_cast<uint32_t>(gpuIndices.size());
     }
 
 public:
@@ -251,9 +237,34 @@ public:
      * @param filepath Path to OBJ file
      * @throws std::runtime_error if loading or buffer creation fails
      */
-    MeshResource(const std::string& filepath) {
+    MeshResource(const std::string& filepath)
+        : MeshResource(decode(filepath)) {}
+    
+    /**
+     * Parse an OBJ file (or read it back from the mesh cache); touches no
+     * Vulkan objects, so it may run on a worker thread
+     */
+    static Decoded decode(const std::string& filepath) {
+        uint64_t key = 0;
+        std::string cachePath;
+        if (eden::meshCacheKey(filepath, OBJ_CACHE_VERSION * 1000003u + sizeof(MeshVertex), key)) {
+            cachePath = eden::meshCachePath(key, "obj");
+            Decoded cached;
+            if (readCache(cachePath, key, cached)) return cached;
+        }
+        MeshData meshData = load_obj(filepath, true);
+        Decoded decoded = interleave(meshData);
+        if (!cachePath.empty()) writeCache(cachePath, key, decoded);
+        return decoded;
+    }
+    
+    /**
+     * Constructor - Creates Vulkan buffers for a decode() result (render thread)
+     * @throws std::runtime_error if buffer creation fails
+     */
+    explicit MeshResource(Decoded&& decoded) {
         try {
-            loadOBJ(filepath);
+            uploadOBJ(decoded);
             m_loaded = true;
         } catch (const std::exception& e) {
             cleanup();
@@ -277,6 +288,7 @@ public:
         
         m_indices = indices;
         m_indexCount = indices.size();
+        m_lods.clear();
         m_hasNormals = true;
         m_hasTexcoords = true;
         
@@ -285,100 +297,19 @@ public:
         if (vertexBufferSize == 0) return false;
         
         try {
-            createBuffer(vertexBufferSize, 
-                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                        m_vertexBuffer, m_vertexBufferMemory);
-            
-            // Create staging buffer for vertex data
-            VkBuffer stagingVertexBuffer;
-            VkDeviceMemory stagingVertexBufferMemory;
-            createBuffer(vertexBufferSize,
-                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingVertexBuffer, stagingVertexBufferMemory);
-            
-            // Copy vertex data to staging buffer
-            void* data;
-            vkMapMemory(g_device, stagingVertexBufferMemory, 0, vertexBufferSize, 0, &data);
-            memcpy(data, m_vertices.data(), (size_t)vertexBufferSize);
-            vkUnmapMemory(g_device, stagingVertexBufferMemory);
-            
-            // Copy staging buffer to vertex buffer
-            VkCommandBufferAllocateInfo allocInfo = {};
-            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            allocInfo.commandPool = g_commandPool;
-            allocInfo.commandBufferCount = 1;
-            
-            VkCommandBuffer commandBuffer;
-            vkAllocateCommandBuffers(g_device, &allocInfo, &commandBuffer);
-            
-            VkCommandBufferBeginInfo beginInfo = {};
-            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            vkBeginCommandBuffer(commandBuffer, &beginInfo);
-            
-            VkBufferCopy copyRegion = {};
-            copyRegion.size = vertexBufferSize;
-            vkCmdCopyBuffer(commandBuffer, stagingVertexBuffer, m_vertexBuffer, 1, &copyRegion);
-            
-            vkEndCommandBuffer(commandBuffer);
-            
-            VkSubmitInfo submitInfo = {};
-            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffer;
-            
-            vkQueueSubmit(g_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-            vkQueueWaitIdle(g_graphicsQueue);
-            
-            vkFreeCommandBuffers(g_device, g_commandPool, 1, &commandBuffer);
-            vkDestroyBuffer(g_device, stagingVertexBuffer, nullptr);
-            vkFreeMemory(g_device, stagingVertexBufferMemory, nullptr);
-            
-            // Create index buffer
-            VkDeviceSize indexBufferSize = sizeof(uint32_t) * m_indices.size();
-            createBuffer(indexBufferSize,
-                        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                        m_indexBuffer, m_indexBufferMemory);
-            
-            // Create staging buffer for index data
-            VkBuffer stagingIndexBuffer;
-            VkDeviceMemory stagingIndexBufferMemory;
-            createBuffer(indexBufferSize,
-                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingIndexBuffer, stagingIndexBufferMemory);
-            
-            // Copy index data to staging buffer
-            vkMapMemory(g_device, stagingIndexBufferMemory, 0, indexBufferSize, 0, &data);
-            memcpy(data, m_indices.data(), (size_t)indexBufferSize);
-            vkUnmapMemory(g_device, stagingIndexBufferMemory);
-            
-            // Copy staging buffer to index buffer
-            vkAllocateCommandBuffers(g_device, &allocInfo, &commandBuffer);
-            vkBeginCommandBuffer(commandBuffer, &beginInfo);
-            
-            copyRegion.size = indexBufferSize;
-            vkCmdCopyBuffer(commandBuffer, stagingIndexBuffer, m_indexBuffer, 1, &copyRegion);
-            
-            vkEndCommandBuffer(commandBuffer);
-            
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffer;
-            
-            vkQueueSubmit(g_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-            vkQueueWaitIdle(g_graphicsQueue);
-            
-            vkFreeCommandBuffers(g_device, g_commandPool, 1, &commandBuffer);
-            vkDestroyBuffer(g_device, stagingIndexBuffer, nullptr);
-            vkFreeMemory(g_device, stagingIndexBufferMemory, nullptr);
+            uploads().begin();
+            createUploadedBuffer(m_vertices.data(), vertexBufferSize,
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_vertexBuffer, m_vertexBufferAlloc);
+            createUploadedBuffer(m_indices.data(), sizeof(uint32_t) * m_indices.size(),
+                                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer, m_indexBufferAlloc);
+            uploads().end();
+            m_vertexCapacity = static_cast<uint32_t>(m_vertices.size());
+            m_indexCapacity = static_cast<uint32_t>(m_indices.size());
             
             m_loaded = true;
             return true;
         } catch (const std::exception& e) {
+            uploads().end();
             cleanup();
             return false;
         }
@@ -387,13 +318,16 @@ public:
     // Move constructor
     MeshResource(MeshResource&& other) noexcept 
         : m_vertexBuffer(other.m_vertexBuffer), m_indexBuffer(other.m_indexBuffer),
-          m_vertexBufferMemory(other.m_vertexBufferMemory), m_indexBufferMemory(other.m_indexBufferMemory),
-          m_indexCount(other.m_indexCount), m_loaded(other.m_loaded),
-          m_hasNormals(other.m_hasNormals), m_hasTexcoords(other.m_hasTexcoords) {
+          m_vertexBufferAlloc(other.m_vertexBufferAlloc), m_indexBufferAlloc(other.m_indexBufferAlloc),
+          m_indexCount(other.m_indexCount), m_vertexCapacity(other.m_vertexCapacity),
+          m_indexCapacity(other.m_indexCapacity), m_dirtyVertices(std::move(other.m_dirtyVertices)),
+          m_dirtyIndicesFrom(other.m_dirtyIndicesFrom), m_lods(std::move(other.m_lods)), m_loaded(other.m_loaded),
+          m_hasNormals(other.m_hasNormals), m_hasTexcoords(other.m_hasTexcoords),
+          m_uploadTicket(other.m_uploadTicket) {
         other.m_vertexBuffer = VK_NULL_HANDLE;
         other.m_indexBuffer = VK_NULL_HANDLE;
-        other.m_vertexBufferMemory = VK_NULL_HANDLE;
-        other.m_indexBufferMemory = VK_NULL_HANDLE;
+        other.m_vertexBufferAlloc = vkcore::GpuAllocation{};
+        other.m_indexBufferAlloc = vkcore::GpuAllocation{};
         other.m_loaded = false;
     }
     
@@ -408,29 +342,29 @@ public:
     
     // Cleanup helper
     void cleanup() {
-        if (m_indexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(g_device, m_indexBuffer, nullptr);
-            m_indexBuffer = VK_NULL_HANDLE;
-        }
-        if (m_indexBufferMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(g_device, m_indexBufferMemory, nullptr);
-            m_indexBufferMemory = VK_NULL_HANDLE;
-        }
-        if (m_vertexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(g_device, m_vertexBuffer, nullptr);
-            m_vertexBuffer = VK_NULL_HANDLE;
-        }
-        if (m_vertexBufferMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(g_device, m_vertexBufferMemory, nullptr);
-            m_vertexBufferMemory = VK_NULL_HANDLE;
-        }
+        // The buffers may still be the target of an unfinished batch
+        if (m_vertexBuffer != VK_NULL_HANDLE || m_indexBuffer != VK_NULL_HANDLE) uploads().wait(m_uploadTicket);
+        gpuAllocator().destroyBuffer(m_indexBuffer, m_indexBufferAlloc);
+        gpuAllocator().destroyBuffer(m_vertexBuffer, m_vertexBufferAlloc);
+        m_vertexCapacity = m_indexCapacity = 0;
         m_loaded = false;
     }
     
     // Getters for Vulkan resources
     VkBuffer getVertexBuffer() const { return m_vertexBuffer; }
     VkBuffer getIndexBuffer() const { return m_indexBuffer; }
-    uint32_t getIndexCount() const { return m_indexCount; }
+    uint32_t getIndexCount() const { return m_indexCount; }  // LOD 0
+    
+    // Simplified levels share the vertex buffer, so drawing one only changes
+    // the index range (pick with vkcore::selectLod())
+    uint32_t getLodCount() const { return m_lods.empty() ? 1u : static_cast<uint32_t>(m_lods.size()); }
+    const std::vector<vkcore::MeshLod>& getLods() const { return m_lods; }
+    bool getLod(uint32_t lod, uint32_t& firstIndex, uint32_t& indexCount) const {
+        if (lod >= getLodCount()) return false;
+        firstIndex = m_lods.empty() ? 0 : m_lods[lod].firstIndex;
+        indexCount = m_lods.empty() ? m_indexCount : m_lods[lod].indexCount;
+        return true;
+    }
     bool hasNormals() const { return m_hasNormals; }
     bool hasTexcoords() const { return m_hasTexcoords; }
     bool isLoaded() const { return m_loaded; }
@@ -444,128 +378,114 @@ public:
     /**
      * Rebuild GPU buffers after modifying vertex/index data
      * Call this after changing vertices via getVerticesMutable() or indices via getIndicesMutable()
+     * Drops the LOD chain - the edited data no longer matches it
      */
     void rebuildBuffers() {
         if (m_vertices.empty()) return;
+        m_lods.clear();
+        m_dirtyVertices.clear();
+        m_dirtyIndicesFrom = UINT32_MAX;
         
         // CRITICAL: Wait for GPU to finish using the old buffers before destroying them
         vkDeviceWaitIdle(g_device);
+        uploads().wait(m_uploadTicket);  // Their upload may not have been submitted yet
         
         // Destroy old buffers
-        if (m_vertexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(g_device, m_vertexBuffer, nullptr);
-            m_vertexBuffer = VK_NULL_HANDLE;
-        }
-        if (m_vertexBufferMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(g_device, m_vertexBufferMemory, nullptr);
-            m_vertexBufferMemory = VK_NULL_HANDLE;
-        }
-        if (m_indexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(g_device, m_indexBuffer, nullptr);
-            m_indexBuffer = VK_NULL_HANDLE;
-        }
-        if (m_indexBufferMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(g_device, m_indexBufferMemory, nullptr);
-            m_indexBufferMemory = VK_NULL_HANDLE;
-        }
+        gpuAllocator().destroyBuffer(m_vertexBuffer, m_vertexBufferAlloc);
+        gpuAllocator().destroyBuffer(m_indexBuffer, m_indexBufferAlloc);
         
+        // Edited meshes tend to keep growing: half again as much room
+        m_vertexCapacity = m_indexCapacity = 0;
+        uint32_t vertexCapacity = static_cast<uint32_t>(m_vertices.size() + m_vertices.size() / 2);
+        uint32_t indexCapacity = static_cast<uint32_t>(m_indices.size() + m_indices.size() / 2);
         try {
-            // Create new vertex buffer
-            VkDeviceSize vertexBufferSize = sizeof(MeshVertex) * m_vertices.size();
-            createBuffer(vertexBufferSize, 
-                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                        m_vertexBuffer, m_vertexBufferMemory);
-            
-            // Staging buffer for vertices
-            VkBuffer stagingBuffer;
-            VkDeviceMemory stagingBufferMemory;
-            createBuffer(vertexBufferSize,
-                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingBuffer, stagingBufferMemory);
-            
-            void* data;
-            vkMapMemory(g_device, stagingBufferMemory, 0, vertexBufferSize, 0, &data);
-            memcpy(data, m_vertices.data(), (size_t)vertexBufferSize);
-            vkUnmapMemory(g_device, stagingBufferMemory);
-            
-            // Copy to GPU
-            VkCommandBufferAllocateInfo allocInfo = {};
-            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            allocInfo.commandPool = g_commandPool;
-            allocInfo.commandBufferCount = 1;
-            
-            VkCommandBuffer commandBuffer;
-            vkAllocateCommandBuffers(g_device, &allocInfo, &commandBuffer);
-            
-            VkCommandBufferBeginInfo beginInfo = {};
-            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            vkBeginCommandBuffer(commandBuffer, &beginInfo);
-            
-            VkBufferCopy copyRegion = {};
-            copyRegion.size = vertexBufferSize;
-            vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_vertexBuffer, 1, &copyRegion);
+            uploads().begin();
+            createUploadedBuffer(m_vertices.data(), sizeof(MeshVertex) * m_vertices.size(),
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_vertexBuffer, m_vertexBufferAlloc,
+                                 sizeof(MeshVertex) * VkDeviceSize(vertexCapacity));
+            m_vertexCapacity = vertexCapacity;
             
-            vkEndCommandBuffer(commandBuffer);
-            
-            VkSubmitInfo submitInfo = {};
-            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffer;
-            
-            vkQueueSubmit(g_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-            vkQueueWaitIdle(g_graphicsQueue);
-            
-            vkFreeCommandBuffers(g_device, g_commandPool, 1, &commandBuffer);
-            vkDestroyBuffer(g_device, stagingBuffer, nullptr);
-            vkFreeMemory(g_device, stagingBufferMemory, nullptr);
-            
-            // Create new index buffer
             if (!m_indices.empty()) {
                 m_indexCount = m_indices.size();
-                VkDeviceSize indexBufferSize = sizeof(uint32_t) * m_indices.size();
-                
-                createBuffer(indexBufferSize,
-                            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                            m_indexBuffer, m_indexBufferMemory);
-                
-                VkBuffer stagingIndexBuffer;
-                VkDeviceMemory stagingIndexBufferMemory;
-                createBuffer(indexBufferSize,
-                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                            stagingIndexBuffer, stagingIndexBufferMemory);
-                
-                vkMapMemory(g_device, stagingIndexBufferMemory, 0, indexBufferSize, 0, &data);
-                memcpy(data, m_indices.data(), (size_t)indexBufferSize);
-                vkUnmapMemory(g_device, stagingIndexBufferMemory);
-                
-                vkAllocateCommandBuffers(g_device, &allocInfo, &commandBuffer);
-                vkBeginCommandBuffer(commandBuffer, &beginInfo);
-                
-                copyRegion.size = indexBufferSize;
-                vkCmdCopyBuffer(commandBuffer, stagingIndexBuffer, m_indexBuffer, 1, &copyRegion);
-                
-                vkEndCommandBuffer(commandBuffer);
-                
-                submitInfo.pCommandBuffers = &commandBuffer;
-                vkQueueSubmit(g_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-                vkQueueWaitIdle(g_graphicsQueue);
-                
-                vkFreeCommandBuffers(g_device, g_commandPool, 1, &commandBuffer);
-                vkDestroyBuffer(g_device, stagingIndexBuffer, nullptr);
-                vkFreeMemory(g_device, stagingIndexBufferMemory, nullptr);
+                createUploadedBuffer(m_indices.data(), sizeof(uint32_t) * m_indices.size(),
+                                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer, m_indexBufferAlloc,
+                                     sizeof(uint32_t) * VkDeviceSize(indexCapacity));
+                m_indexCapacity = indexCapacity;
             }
-            
+            uploads().end();
         } catch (const std::exception& e) {
+            uploads().end();
             std::cerr << "[MeshResource] Failed to rebuild buffers: " << e.what() << std::endl;
         }
     }
     
+    // Vertices [first, first + count) of getVerticesMutable() changed (or
+    // were appended); uploadDirty() copies them
+    void markVerticesDirty(uint32_t first, uint32_t count) {
+        if (count > 0) m_dirtyVertices.push_back({first, count});
+    }
+    
+    // Indices from `first` on changed; the index count follows m_indices
+    void markIndicesDirty(uint32_t first) {
+        m_dirtyIndicesFrom = std::min(m_dirtyIndicesFrom, first);
+    }
+    
+    bool hasDirtyRanges() const { return !m_dirtyVertices.empty() || m_dirtyIndicesFrom != UINT32_MAX; }
+    
+    /**
+     * Copy the dirty ranges into the existing buffers through the upload
+     * batch - no device wait, no reallocation. Call only while no submitted
+     * frame still reads the buffers (after the frame's fence wait); the
+     * batch's closing barrier orders the copies before the next draw.
+     * Falls back to rebuildBuffers() when the data outgrew the buffers.
+     * Index edits drop the LOD chain, like rebuildBuffers().
+     */
+    void uploadDirty() {
+        if (!hasDirtyRanges()) return;
+        if (m_vertexBuffer == VK_NULL_HANDLE || m_vertices.size() > m_vertexCapacity ||
+            (m_dirtyIndicesFrom != UINT32_MAX && (m_indexBuffer == VK_NULL_HANDLE || m_indices.size() > m_indexCapacity))) {
+            rebuildBuffers();
+            return;
+        }
+        
+        // Coalesce: a drag marks the same ranges every frame
+        std::sort(m_dirtyVertices.begin(), m_dirtyVertices.end());
+        bool ok = true;
+        uploads().begin();
+        uint32_t vertexCount = static_cast<uint32_t>(m_vertices.size());
+        for (size_t i = 0; i < m_dirtyVertices.size();) {
+            uint32_t first = m_dirtyVertices[i].first;
+            uint32_t end = first + m_dirtyVertices[i].second;
+            for (i++; i < m_dirtyVertices.size() && m_dirtyVertices[i].first <= end; i++) {
+                end = std::max(end, m_dirtyVertices[i].first + m_dirtyVertices[i].second);
+            }
+            end = std::min(end, vertexCount);
+            if (first >= end) continue;
+            vkcore::UploadBatch::Ticket ticket = uploads().uploadBuffer(
+                m_vertexBuffer, &m_vertices[first], sizeof(MeshVertex) * VkDeviceSize(end - first),
+                sizeof(MeshVertex) * VkDeviceSize(first));
+            ok = ok && ticket != vkcore::UploadBatch::NO_UPLOAD;
+            m_uploadTicket = std::max(m_uploadTicket, ticket);
+        }
+        if (m_dirtyIndicesFrom < m_indices.size()) {
+            vkcore::UploadBatch::Ticket ticket = uploads().uploadBuffer(
+                m_indexBuffer, &m_indices[m_dirtyIndicesFrom],
+                sizeof(uint32_t) * VkDeviceSize(m_indices.size() - m_dirtyIndicesFrom),
+                sizeof(uint32_t) * VkDeviceSize(m_dirtyIndicesFrom));
+            ok = ok && ticket != vkcore::UploadBatch::NO_UPLOAD;
+            m_uploadTicket = std::max(m_uploadTicket, ticket);
+        }
+        if (m_dirtyIndicesFrom != UINT32_MAX) {
+            m_indexCount = static_cast<uint32_t>(m_indices.size());
+            m_lods.clear();
+        }
+        uploads().end();
+        
+        m_dirtyVertices.clear();
+        m_dirtyIndicesFrom = UINT32_MAX;
+        if (!ok) rebuildBuffers();  // Staging failed: the whole buffers instead
+    }
+    
     // Get vertex input binding description (for pipeline creation)
     VkVertexInputBindingDescription getVertexInputBinding() const {
         VkVertexInputBindingDescription binding = {};
@@ -7,19 +7,24 @@
 
 #include <vector>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <charconv>
 #include <cstring>
 #include <stdexcept>
 #include <cstdlib>
+#include <thread>
+
+#include "vfs.h"
+#include "../vulkan/core/mesh_lod.h"
 
 // Mesh data structure - stores parsed OBJ data
 struct MeshData {
     std::vector<float> positions;   // Vec3 per vertex (x, y, z)
     std::vector<float> normals;     // Vec3 per vertex (nx, ny, nz) - optional
     std::vector<float> texcoords;   // Vec2 per vertex (u, v) - optional (for textured OBJs)
-    std::vector<uint32_t> indices;  // Index buffer (triangles)
+    std::vector<uint32_t> indices;  // Index buffer (triangles) - LOD 0
+    std::vector<uint32_t> lodIndices;       // Simplified levels, to append after indices
+    std::vector<vkcore::MeshLod> lods;      // Ranges into indices + lodIndices (empty unless requested)
     
     // Metadata
     bool hasNormals = false;
@@ -28,9 +33,231 @@ struct MeshData {
     uint32_t indexCount = 0;
 };
 
+namespace obj_detail {
+
+// Files at least this large are scanned in parallel when threads = 0
+constexpr size_t PARALLEL_MIN_BYTES = 8u << 20;
+// Smallest slice handed to one scanning thread
+constexpr size_t PARALLEL_CHUNK_BYTES = 2u << 20;
+
+constexpr int32_t NO_INDEX = -1;
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+}
+
+inline bool parseFloat(const char*& p, const char* end, float& out) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '+') p++;  // from_chars takes no sign but '-'
+#if defined(__cpp_lib_to_chars)
+    std::from_chars_result result = std::from_chars(p, end, out);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+#else
+    // No floating-point from_chars: strtof on a terminated copy of the token
+    char token[64];
+    size_t length = 0;
+    while (p + length < end && length + 1 < sizeof(token) &&
+           p[length] != ' ' && p[length] != '\t' && p[length] != '\r' && p[length] != '\n') {
+        token[length] = p[length];
+        length++;
+    }
+    token[length] = '\0';
+    char* parsed = nullptr;
+    out = std::strtof(token, &parsed);
+    if (parsed == token) return false;
+    p += parsed - token;
+    return true;
+#endif
+}
+
+inline bool parseInt(const char*& p, const char* end, int32_t& out) {
+    if (p < end && *p == '+') p++;
+    std::from_chars_result result = std::from_chars(p, end, out);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+// One face corner, 0-based. Negative OBJ indices count back from the
+// elements seen so far; a scanning thread only knows its own chunk's
+// counts, so those are stored chunk-relative and flagged for the merge.
+struct Corner {
+    int32_t pos = NO_INDEX;
+    int32_t tex = NO_INDEX;
+    int32_t norm = NO_INDEX;
+    uint8_t relative = 0;   // RELATIVE_* bits
+};
+
+constexpr uint8_t RELATIVE_POS = 1;
+constexpr uint8_t RELATIVE_TEX = 2;
+constexpr uint8_t RELATIVE_NORM = 4;
+
+// Scan result of one slice of the file (whole lines)
+struct Chunk {
+    std::vector<float> positions;   // Vec3
+    std::vector<float> normals;     // Vec3
+    std::vector<float> texcoords;   // Vec2, V already flipped
+    std::vector<Corner> corners;
+    std::vector<uint32_t> faceSizes;
+};
+
+// One index of an `f` token; `count` is the elements of that kind seen so far in the chunk
+inline bool parseCornerIndex(const char*& p, const char* end, uint32_t count, uint8_t relativeBit,
+                             int32_t& index, uint8_t& relative) {
+    int32_t value = 0;
+    if (!parseInt(p, end, value) || value == 0) return false;
+    if (value > 0) {
+        index = value - 1;
+    } else {
+        index = static_cast<int32_t>(count) + value;
+        relative |= relativeBit;
+    }
+    return true;
+}
+
+// Face: f v1[/vt1][/vn1] v2[/vt2][/vn2] v3[/vt3][/vn3] [v4...]
+// A corner that doesn't parse drops the whole face.
+inline void parseFace(const char* p, const char* end, Chunk& chunk) {
+    const size_t firstCorner = chunk.corners.size();
+    const uint32_t positions = static_cast<uint32_t>(chunk.positions.size() / 3);
+    const uint32_t texcoords = static_cast<uint32_t>(chunk.texcoords.size() / 2);
+    const uint32_t normals = static_cast<uint32_t>(chunk.normals.size() / 3);
+    for (;;) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p == '#') break;
+        Corner corner;
+        bool valid = parseCornerIndex(p, end, positions, RELATIVE_POS, corner.pos, corner.relative);
+        if (valid && p < end && *p == '/') {
+            p++;
+            if (p < end && *p != '/' && *p != ' ' && *p != '\t' && *p != '\r') {
+                valid = parseCornerIndex(p, end, texcoords, RELATIVE_TEX, corner.tex, corner.relative);
+            }
+            if (valid && p < end && *p == '/') {
+                p++;
+                valid = parseCornerIndex(p, end, normals, RELATIVE_NORM, corner.norm, corner.relative);
+            }
+        }
+        if (!valid || (p < end && *p != ' ' && *p != '\t' && *p != '\r')) {
+            chunk.corners.resize(firstCorner);
+            return;
+        }
+        chunk.corners.push_back(corner);
+    }
+    size_t count = chunk.corners.size() - firstCorner;
+    if (count < 3) {
+        chunk.corners.resize(firstCorner);  // Need at least 3 vertices
+        return;
+    }
+    chunk.faceSizes.push_back(static_cast<uint32_t>(count));
+}
+
+// Scan [begin, end), which starts at a line start and ends after a newline (or at EOF)
+inline void parseChunk(const char* begin, const char* end, Chunk& chunk) {
+    for (const char* line = begin; line < end;) {
+        const char* lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!lineEnd) lineEnd = end;
+        const char* p = skipSpaces(line, lineEnd);
+        line = lineEnd + 1;
+        
+        // Skip empty lines and comments
+        if (p + 1 >= lineEnd || *p == '#') continue;
+        
+        if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            // Vertex position: v x y z [w] (w ignored)
+            float x, y, z;
+            p += 1;
+            if (parseFloat(p, lineEnd, x) && parseFloat(p, lineEnd, y) && parseFloat(p, lineEnd, z)) {
+                chunk.positions.insert(chunk.positions.end(), {x, y, z});
+            }
+        } else if (p[0] == 'v' && p[1] == 'n') {
+            // Vertex normal: vn nx ny nz
+            float x, y, z;
+            p += 2;
+            if (parseFloat(p, lineEnd, x) && parseFloat(p, lineEnd, y) && parseFloat(p, lineEnd, z)) {
+                chunk.normals.insert(chunk.normals.end(), {x, y, z});
+            }
+        } else if (p[0] == 'v' && p[1] == 't') {
+            // Texture coordinate: vt u [v] [w]
+            // OBJ format uses bottom-left origin (0,0 at bottom-left)
+            // Vulkan/OpenGL use top-left origin (0,0 at top-left)
+            // So we need to flip V coordinate: v_flipped = 1.0 - v
+            float u, v = 0.0f;
+            p += 2;
+            if (parseFloat(p, lineEnd, u)) {
+                parseFloat(p, lineEnd, v);
+                chunk.texcoords.insert(chunk.texcoords.end(), {u, 1.0f - v});
+            }
+        } else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            parseFace(p + 1, lineEnd, chunk);
+        }
+        // Ignore other OBJ commands (mtllib, usemtl, o, g, s, etc.) for now
+    }
+}
+
+/**
+ * Open-addressing map from (position, texcoord, normal) index triples to
+ * output vertices; sized up front for the corner count, so it never rehashes
+ */
+class VertexMap {
+public:
+    explicit VertexMap(size_t maxVertices) {
+        size_t capacity = 16;
+        while (capacity < maxVertices * 2) capacity <<= 1;
+        m_slots.assign(capacity, 0);
+        m_keys.reserve(maxVertices * 3);
+    }
+    
+    // @return Vertex index; `inserted` is set when the triple is new
+    uint32_t findOrInsert(int32_t pos, int32_t tex, int32_t norm, bool& inserted) {
+        const size_t mask = m_slots.size() - 1;
+        uint32_t hash = static_cast<uint32_t>(pos) * 0x9E3779B1u;
+        hash ^= (static_cast<uint32_t>(tex) + 0x7F4A7C15u) * 0x85EBCA77u;
+        hash ^= (static_cast<uint32_t>(norm) + 0x165667B1u) * 0xC2B2AE3Du;
+        hash ^= hash >> 15;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            uint32_t entry = m_slots[slot];
+            if (entry == 0) {
+                uint32_t index = static_cast<uint32_t>(m_keys.size() / 3);
+                m_slots[slot] = index + 1;
+                m_keys.insert(m_keys.end(), {pos, tex, norm});
+                inserted = true;
+                return index;
+            }
+            const int32_t* key = &m_keys[size_t(entry - 1) * 3];
+            if (key[0] == pos && key[1] == tex && key[2] == norm) {
+                inserted = false;
+                return entry - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint32_t> m_slots;   // Vertex index + 1, 0 = empty
+    std::vector<int32_t> m_keys;     // Triple per vertex
+};
+
+// Split [0, size) into up to `count` slices ending after a newline
+inline std::vector<size_t> chunkBounds(const char* data, size_t size, uint32_t count) {
+    std::vector<size_t> bounds(1, 0);
+    for (uint32_t i = 1; i < count; i++) {
+        size_t at = std::max(bounds.back(), size * i / count);
+        const void* newline = at < size ? memchr(data + at, '\n', size - at) : nullptr;
+        if (!newline) break;
+        at = static_cast<const char*>(newline) - data + 1;
+        if (at > bounds.back()) bounds.push_back(at);
+    }
+    bounds.push_back(size);
+    return bounds;
+}
+
+} // namespace obj_detail
+
 /**
  * Load OBJ file and parse into MeshData structure
- * 
+ *
  * Supports:
  * - `v` lines (vertices)
  * - `vn` lines (normals)
@@ -39,295 +266,122 @@ struct MeshData {
  *   - `f 1 2 3` (position only)
  *   - `f 1/1 2/2 3/3` (position + UV)
  *   - `f 1/1/1 2/2/2 3/3/3` (position + UV + normal)
- * 
+ *   - `f 1//1 2//2 3//3` (position + normal)
+ *   - negative (relative) indices, and any number of corners (fan-triangulated)
+ *
+ * The file is mapped (or read in one go) and scanned with std::from_chars;
+ * files of PARALLEL_MIN_BYTES and up are scanned in parallel slices of
+ * whole lines. Corners are deduplicated on their position/UV/normal index
+ * triple, so shared vertices come out once. Corners without a (valid) UV
+ * get (0, 0), without a normal (0, 0, 1). Faces referencing missing
+ * positions are skipped.
+ *
  * @param filepath Path to OBJ file
+ * @param generateLods Also build a quadric-simplified LOD chain (see mesh_lod.h)
+ * @param threads Scanning threads (0 = one for small files, hardware
+ *                concurrency for large ones)
  * @return MeshData structure with parsed mesh data
  * @throws std::runtime_error if file cannot be opened or parsing fails
  */
-inline MeshData load_obj(const std::string& filepath) {
+inline MeshData load_obj(const std::string& filepath, bool generateLods = false, uint32_t threads = 0) {
+    using namespace obj_detail;
     MeshData result;
     
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    VfsFile file;  // One read-only byte range, mapped from the archive or the loose file
+    if (!Vfs::shared().open(filepath, file)) {
         throw std::runtime_error("Failed to open OBJ file: " + filepath);
     }
     
-    // Temporary storage for OBJ data (1-indexed, as OBJ format uses)
+    // Scan: one chunk per thread (whole lines each)
+    if (threads == 0) {
+        threads = file.size() >= PARALLEL_MIN_BYTES ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+    }
+    threads = static_cast<uint32_t>(std::min<size_t>(threads, std::max<size_t>(1, file.size() / PARALLEL_CHUNK_BYTES)));
+    std::vector<size_t> bounds = chunkBounds(file.data(), file.size(), threads);
+    std::vector<Chunk> chunks(bounds.size() - 1);
+    if (chunks.size() == 1) {
+        parseChunk(file.data(), file.data() + file.size(), chunks[0]);
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunks.size(); i++) {
+            workers.emplace_back([&, i]() {
+                parseChunk(file.data() + bounds[i], file.data() + bounds[i + 1], chunks[i]);
+            });
+        }
+        parseChunk(file.data() + bounds[0], file.data() + bounds[1], chunks[0]);
+        for (std::thread& worker : workers) worker.join();
+    }
+    
+    // Merge the element arrays (1-indexed in the file, 0-based here)
     std::vector<float> tempPositions;   // Vec3
     std::vector<float> tempNormals;     // Vec3
     std::vector<float> tempTexcoords;   // Vec2
+    size_t cornerCount = 0;
+    for (const Chunk& chunk : chunks) {
+        tempPositions.insert(tempPositions.end(), chunk.positions.begin(), chunk.positions.end());
+        tempNormals.insert(tempNormals.end(), chunk.normals.begin(), chunk.normals.end());
+        tempTexcoords.insert(tempTexcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+        cornerCount += chunk.corners.size();
+    }
+    const int32_t maxPos = static_cast<int32_t>(tempPositions.size() / 3);
+    const int32_t maxTex = static_cast<int32_t>(tempTexcoords.size() / 2);
+    const int32_t maxNorm = static_cast<int32_t>(tempNormals.size() / 3);
+    result.hasNormals = maxNorm > 0;
+    result.hasTexcoords = maxTex > 0;
     
-    std::string line;
-    uint32_t lineNumber = 0;
-    
-    while (std::getline(file, line)) {
-        lineNumber++;
-        
-        // Trim whitespace
-        line.erase(0, line.find_first_not_of(" \t\r\n"));
-        line.erase(line.find_last_not_of(" \t\r\n") + 1);
-        
-        // Skip empty lines and comments
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-        
-        // Parse line type
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
-        
-        if (type == "v") {
-            // Vertex position: v x y z [w]
-            float x, y, z, w = 1.0f;
-            if (iss >> x >> y >> z) {
-                tempPositions.push_back(x);
-                tempPositions.push_back(y);
-                tempPositions.push_back(z);
-                // Optional w component (homogeneous coordinate) - we ignore it
-            }
-        } else if (type == "vn") {
-            // Vertex normal: vn nx ny nz
-            float nx, ny, nz;
-            if (iss >> nx >> ny >> nz) {
-                tempNormals.push_back(nx);
-                tempNormals.push_back(ny);
-                tempNormals.push_back(nz);
-                result.hasNormals = true;
-            }
-        } else if (type == "vt") {
-            // Texture coordinate: vt u v [w]
-            // OBJ format uses bottom-left origin (0,0 at bottom-left)
-            // Vulkan/OpenGL use top-left origin (0,0 at top-left)
-            // So we need to flip V coordinate: v_flipped = 1.0 - v
-            float u, v, w = 0.0f;
-            if (iss >> u >> v) {
-                tempTexcoords.push_back(u);
-                tempTexcoords.push_back(1.0f - v); // Flip V for Vulkan coordinate system
-                result.hasTexcoords = true;
-                // Optional w component - we ignore it
-            }
-        } else if (type == "f") {
-            // Face: f v1[/vt1][/vn1] v2[/vt2][/vn2] v3[/vt3][/vn3] [v4...]
-            // OBJ uses 1-based indexing, we need to convert to 0-based
-            
-            std::vector<std::string> faceTokens;
-            std::string token;
-            while (iss >> token) {
-                faceTokens.push_back(token);
-            }
-            
-            if (faceTokens.size() < 3) {
-                continue; // Invalid face (need at least 3 vertices)
-            }
-            
-            // Parse face indices (handle different formats)
-            auto parseFaceIndex = [](const std::string& token, int32_t& posIdx, int32_t& texIdx, int32_t& normIdx) -> bool {
-                posIdx = -1;
-                texIdx = -1;
-                normIdx = -1;
-                
-                try {
-                    // Count slashes to determine format
-                    size_t slash1 = token.find('/');
-                    if (slash1 == std::string::npos) {
-                        // Format: f 1 2 3 (position only)
-                        posIdx = std::stoi(token) - 1; // Convert to 0-based
-                    } else {
-                        // Has at least one slash
-                        posIdx = std::stoi(token.substr(0, slash1)) - 1;
-                        
-                        size_t slash2 = token.find('/', slash1 + 1);
-                        if (slash2 == std::string::npos) {
-                            // Format: f 1/1 2/2 3/3 (position + UV)
-                            if (slash1 + 1 < token.length()) {
-                                std::string texStr = token.substr(slash1 + 1);
-                                if (!texStr.empty()) {
-                                    texIdx = std::stoi(texStr) - 1;
-                                }
-                            }
-                        } else {
-                            // Format: f 1/1/1 2/2/2 3/3/3 (position + UV + normal)
-                            // OR: f 1//3 (position + normal, no UV)
-                            std::string texStr = token.substr(slash1 + 1, slash2 - slash1 - 1);
-                            if (!texStr.empty()) {
-                                texIdx = std::stoi(texStr) - 1;
-                            }
-                            // If texStr is empty, texIdx stays -1 (no UV)
-                            if (slash2 + 1 < token.length()) {
-                                std::string normStr = token.substr(slash2 + 1);
-                                if (!normStr.empty()) {
-                                    normIdx = std::stoi(normStr) - 1;
-                                }
-                            }
-                        }
-                    }
-                    return true;
-                } catch (...) {
-                    // Failed to parse - invalid format
-                    return false;
-                }
-            };
-            
-            // Triangulate face (if quad or higher, split into triangles)
-            // For now, we'll just use the first 3 vertices (simple triangulation)
-            // TODO: Proper fan triangulation for n-gons
-            
-            // Parse first 3 vertices
-            int32_t v1_pos, v1_tex, v1_norm;
-            int32_t v2_pos, v2_tex, v2_norm;
-            int32_t v3_pos, v3_tex, v3_norm;
-            
-            if (!parseFaceIndex(faceTokens[0], v1_pos, v1_tex, v1_norm) ||
-                !parseFaceIndex(faceTokens[1], v2_pos, v2_tex, v2_norm) ||
-                !parseFaceIndex(faceTokens[2], v3_pos, v3_tex, v3_norm)) {
-                continue; // Failed to parse face indices
-            }
-            
-            // Validate indices
-            uint32_t maxPos = tempPositions.size() / 3;
-            if (v1_pos < 0 || v1_pos >= (int32_t)maxPos ||
-                v2_pos < 0 || v2_pos >= (int32_t)maxPos ||
-                v3_pos < 0 || v3_pos >= (int32_t)maxPos) {
-                continue; // Invalid indices
-            }
-            
-            // Create vertices (interleaved: pos, normal, texcoord)
-            // We'll create a unique vertex for each face vertex (no index sharing for now)
-            // This is simpler but uses more memory - can optimize later with vertex deduplication
-            
-            uint32_t baseIndex = result.positions.size() / 3;
-            
-            // Vertex 1
-            result.positions.push_back(tempPositions[v1_pos * 3 + 0]);
-            result.positions.push_back(tempPositions[v1_pos * 3 + 1]);
-            result.positions.push_back(tempPositions[v1_pos * 3 + 2]);
-            
-            if (result.hasNormals && v1_norm >= 0 && v1_norm < (int32_t)(tempNormals.size() / 3)) {
-                result.normals.push_back(tempNormals[v1_norm * 3 + 0]);
-                result.normals.push_back(tempNormals[v1_norm * 3 + 1]);
-                result.normals.push_back(tempNormals[v1_norm * 3 + 2]);
-            } else {
-                result.normals.push_back(0.0f);
-                result.normals.push_back(0.0f);
-                result.normals.push_back(1.0f); // Default normal (pointing up)
-            }
-            
-            // Check if this face vertex has a valid UV index
-            if (v1_tex >= 0 && v1_tex < (int32_t)(tempTexcoords.size() / 2)) {
-                result.texcoords.push_back(tempTexcoords[v1_tex * 2 + 0]);
-                result.texcoords.push_back(tempTexcoords[v1_tex * 2 + 1]);
-                result.hasTexcoords = true; // Mark that we're using UVs
-            } else {
-                // No UV specified for this vertex, use default
-                result.texcoords.push_back(0.0f);
-                result.texcoords.push_back(0.0f);
-            }
-            
-            // Vertex 2
-            result.positions.push_back(tempPositions[v2_pos * 3 + 0]);
-            result.positions.push_back(tempPositions[v2_pos * 3 + 1]);
-            result.positions.push_back(tempPositions[v2_pos * 3 + 2]);
-            
-            if (result.hasNormals && v2_norm >= 0 && v2_norm < (int32_t)(tempNormals.size() / 3)) {
-                result.normals.push_back(tempNormals[v2_norm * 3 + 0]);
-                result.normals.push_back(tempNormals[v2_norm * 3 + 1]);
-                result.normals.push_back(tempNormals[v2_norm * 3 + 2]);
-            } else {
-                result.normals.push_back(0.0f);
-                result.normals.push_back(0.0f);
-                result.normals.push_back(1.0f);
-            }
-            
-            // Check if this face vertex has a valid UV index
-            if (v2_tex >= 0 && v2_tex < (int32_t)(tempTexcoords.size() / 2)) {
-                result.texcoords.push_back(tempTexcoords[v2_tex * 2 + 0]);
-                result.texcoords.push_back(tempTexcoords[v2_tex * 2 + 1]);
-                result.hasTexcoords = true; // Mark that we're using UVs
-            } else {
-                // No UV specified for this vertex, use default
-                result.texcoords.push_back(1.0f);
-                result.texcoords.push_back(0.0f);
-            }
+    // Dedup corners into vertices and fan-triangulate each face
+    VertexMap vertexMap(cornerCount);
+    std::vector<uint32_t> faceVertices;
+    result.positions.reserve(cornerCount * 3);
+    result.normals.reserve(cornerCount * 3);
+    result.texcoords.reserve(cornerCount * 2);
+    int32_t posBase = 0, texBase = 0, normBase = 0;   // Elements before this chunk
+    for (const Chunk& chunk : chunks) {
+        const Corner* corner = chunk.corners.data();
+        for (uint32_t faceSize : chunk.faceSizes) {
+            const Corner* face = corner;
+            corner += faceSize;
             
-            // Vertex 3
-            result.positions.push_back(tempPositions[v3_pos * 3 + 0]);
-            result.positions.push_back(tempPositions[v3_pos * 3 + 1]);
-            result.positions.push_back(tempPositions[v3_pos * 3 + 2]);
-            
-            if (result.hasNormals && v3_norm >= 0 && v3_norm < (int32_t)(tempNormals.size() / 3)) {
-                result.normals.push_back(tempNormals[v3_norm * 3 + 0]);
-                result.normals.push_back(tempNormals[v3_norm * 3 + 1]);
-                result.normals.push_back(tempNormals[v3_norm * 3 + 2]);
-            } else {
-                result.normals.push_back(0.0f);
-                result.normals.push_back(0.0f);
-                result.normals.push_back(1.0f);
-            }
-            
-            // Check if this face vertex has a valid UV index
-            if (v3_tex >= 0 && v3_tex < (int32_t)(tempTexcoords.size() / 2)) {
-                result.texcoords.push_back(tempTexcoords[v3_tex * 2 + 0]);
-                result.texcoords.push_back(tempTexcoords[v3_tex * 2 + 1]);
-                result.hasTexcoords = true; // Mark that we're using UVs
-            } else {
-                // No UV specified for this vertex, use default
-                result.texcoords.push_back(0.5f);
-                result.texcoords.push_back(1.0f);
-            }
-            
-            // Add indices (simple sequential indexing for now)
-            result.indices.push_back(baseIndex);
-            result.indices.push_back(baseIndex + 1);
-            result.indices.push_back(baseIndex + 2);
-            
-            // Handle quads (triangulate into 2 triangles)
-            if (faceTokens.size() >= 4) {
-                int32_t v4_pos, v4_tex, v4_norm;
-                if (!parseFaceIndex(faceTokens[3], v4_pos, v4_tex, v4_norm) ||
-                    v4_pos < 0 || v4_pos >= (int32_t)maxPos) {
-                    continue; // Failed to parse 4th vertex or invalid index
-                }
+            faceVertices.clear();
+            for (const Corner* c = face; c < corner; c++) {
+                int32_t pos = c->pos + ((c->relative & RELATIVE_POS) ? posBase : 0);
+                int32_t tex = c->tex + ((c->relative & RELATIVE_TEX) ? texBase : 0);
+                int32_t norm = c->norm + ((c->relative & RELATIVE_NORM) ? normBase : 0);
+                if (pos < 0 || pos >= maxPos) break;   // Invalid indices: skip the face
+                if (tex < 0 || tex >= maxTex) tex = NO_INDEX;
+                if (norm < 0 || norm >= maxNorm) norm = NO_INDEX;
                 
-                {
-                    // Add vertex 4
-                    result.positions.push_back(tempPositions[v4_pos * 3 + 0]);
-                    result.positions.push_back(tempPositions[v4_pos * 3 + 1]);
-                    result.positions.push_back(tempPositions[v4_pos * 3 + 2]);
-                    
-                    if (result.hasNormals && v4_norm >= 0 && v4_norm < (int32_t)(tempNormals.size() / 3)) {
-                        result.normals.push_back(tempNormals[v4_norm * 3 + 0]);
-                        result.normals.push_back(tempNormals[v4_norm * 3 + 1]);
-                        result.normals.push_back(tempNormals[v4_norm * 3 + 2]);
+                bool inserted = false;
+                uint32_t vertex = vertexMap.findOrInsert(pos, tex, norm, inserted);
+                if (inserted) {
+                    const float* p = &tempPositions[size_t(pos) * 3];
+                    result.positions.insert(result.positions.end(), {p[0], p[1], p[2]});
+                    if (norm != NO_INDEX) {
+                        const float* n = &tempNormals[size_t(norm) * 3];
+                        result.normals.insert(result.normals.end(), {n[0], n[1], n[2]});
                     } else {
-                        result.normals.push_back(0.0f);
-                        result.normals.push_back(0.0f);
-                        result.normals.push_back(1.0f);
+                        result.normals.insert(result.normals.end(), {0.0f, 0.0f, 1.0f}); // Default normal (pointing up)
                     }
-                    
-                    // Check if this face vertex has a valid UV index
-                    if (v4_tex >= 0 && v4_tex < (int32_t)(tempTexcoords.size() / 2)) {
-                        result.texcoords.push_back(tempTexcoords[v4_tex * 2 + 0]);
-                        result.texcoords.push_back(tempTexcoords[v4_tex * 2 + 1]);
-                        result.hasTexcoords = true; // Mark that we're using UVs
+                    if (tex != NO_INDEX) {
+                        const float* t = &tempTexcoords[size_t(tex) * 2];
+                        result.texcoords.insert(result.texcoords.end(), {t[0], t[1]});
                     } else {
-                        // No UV specified for this vertex, use default
-                        result.texcoords.push_back(1.0f);
-                        result.texcoords.push_back(1.0f);
+                        result.texcoords.insert(result.texcoords.end(), {0.0f, 0.0f});
                     }
-                    
-                    // Second triangle: v1, v3, v4
-                    result.indices.push_back(baseIndex);
-                    result.indices.push_back(baseIndex + 2);
-                    result.indices.push_back(baseIndex + 3);
                 }
+                faceVertices.push_back(vertex);
+            }
+            if (faceVertices.size() != faceSize) continue;
+            
+            for (uint32_t i = 1; i + 1 < faceSize; i++) {
+                result.indices.insert(result.indices.end(), {faceVertices[0], faceVertices[i], faceVertices[i + 1]});
             }
         }
-        // Ignore other OBJ commands (mtllib, usemtl, o, g, s, etc.) for now
+        posBase += static_cast<int32_t>(chunk.positions.size() / 3);
+        texBase += static_cast<int32_t>(chunk.texcoords.size() / 2);
+        normBase += static_cast<int32_t>(chunk.normals.size() / 3);
     }
     
-    file.close();
-    
     // Set metadata
     result.vertexCount = result.positions.size() / 3;
     result.indexCount = result.indices.size();
@@ -336,26 +390,13 @@ inline MeshData load_obj(const std::string& filepath) {
         throw std::runtime_error("OBJ file contains no vertices: " + filepath);
     }
     
-    // Ensure normals array matches vertex count
-    if (result.normals.size() != result.positions.size()) {
-        result.normals.resize(result.positions.size(), 0.0f);
-        result.hasNormals = false;
+    if (generateLods) {
+        std::vector<uint32_t> all = vkcore::buildLodChain(result.positions.data(), 3, result.vertexCount,
+                                                          result.indices, result.lods);
+        result.lodIndices.assign(all.begin() + result.indices.size(), all.end());
     }
     
-    // Ensure texcoords array matches vertex count (don't destroy UV data!)
-    // Only resize if we're missing UVs, but preserve what we have
-    uint32_t expectedTexcoordCount = (result.positions.size() / 3) * 2;
-    if (result.texcoords.size() < expectedTexcoordCount) {
-        // Pad with zeros only if we're short
-        result.texcoords.resize(expectedTexcoordCount, 0.0f);
-    } else if (result.texcoords.size() > expectedTexcoordCount) {
-        // Shouldn't happen, but trim if somehow we have too many
-        result.texcoords.resize(expectedTexcoordCount);
-    }
-    // If sizes match, we keep the parsed UV coordinates as-is
-    
     return result;
 }
 
 #endif // EDEN_OBJ_LOADER_H
-
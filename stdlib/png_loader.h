@@ -1,6 +1,6 @@
 // EDEN ENGINE - PNG Texture Loader
 // Source asset loader (PNG → uncompressed RGBA for GPU upload)
-// For production assets, convert PNG → DDS at build time for better performance
+// For production assets, cook PNG → KTX2 at build time (vulkan/tools/texture_cook.cpp)
 
 #ifndef EDEN_PNG_LOADER_H
 #define EDEN_PNG_LOADER_H
@@ -8,9 +8,10 @@
 #include "vulkan.h"
 #include <vector>
 #include <string>
-#include <fstream>
 #include <cstring>
 
+#include "vfs.h"
+
 // Use stb_image for PNG loading (single-header library)
 // Always include the header for declarations and constants
 // STB_IMAGE_IMPLEMENTATION should be defined in exactly ONE .cpp file before including this header
@@ -35,9 +36,15 @@ struct PNGData {
 inline PNGData load_png(const std::string& filepath) {
     PNGData result;
     
-    // stb_image loads PNG and converts to RGBA8
+    VfsFile file;
+    if (!Vfs::shared().open(filepath, file)) {
+        throw std::runtime_error("Failed to load PNG: " + filepath + " - cannot open file");
+    }
+    
+    // stb_image decodes from memory (the mapped archive or file) and converts to RGBA8
     int width, height, channels;
-    unsigned char* pixels = stbi_load(filepath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    unsigned char* pixels = stbi_load_from_memory(file.bytes(), static_cast<int>(file.size()),
+                                                  &width, &height, &channels, STBI_rgb_alpha);
     
     if (!pixels) {
         throw std::runtime_error("Failed to load PNG: " + filepath + " - " + stbi_failure_reason());
@@ -5,10 +5,18 @@
 #ifndef EDEN_RESOURCE_H
 #define EDEN_RESOURCE_H
 
+#include "file_watcher.h"
+#include "resource_loader.h"
+#include "resource_cache.h"
+#include "vfs.h"
+
 #include <memory>
 #include <string>
 #include <ctime>
 #include <stdexcept>
+#include <atomic>
+#include <type_traits>
+#include <utility>
 
 #ifdef _WIN32
 #include <sys/stat.h>
@@ -18,33 +26,177 @@
 #include <unistd.h>
 #endif
 
+namespace resource_detail {
+
+// Types with a two-phase load for async mode: `static Decoded decode(path)`
+// (any thread - file I/O and decoding) and a constructor taking the
+// Decoded (render thread - GPU objects and uploads)
+template<typename T, typename = void>
+struct HasDecode : std::false_type {};
+
+template<typename T>
+struct HasDecode<T, std::void_t<decltype(T::decode(std::declval<const std::string&>()))>>
+    : std::is_constructible<T, decltype(T::decode(std::declval<const std::string&>()))&&> {};
+
+template<typename T, bool = HasDecode<T>::value>
+struct DecodedOf {
+    struct type {};
+};
+
+template<typename T>
+struct DecodedOf<T, true> {
+    using type = decltype(T::decode(std::declval<const std::string&>()));
+};
+
+} // namespace resource_detail
+
 /**
  * Resource<T> - Generic resource wrapper with hot-reload support
  * 
  * Provides:
  * - RAII lifecycle management
  * - File modification time tracking
- * - Hot-reload capability (check and reload on file change)
+ * - Hot-reload capability (check and reload on file change); reload() only
+ *   stat()s after FileWatcher reports a change, where the platform has a
+ *   watcher (call FileWatcher::shared().poll() once per frame - generated
+ *   main loops do)
  * - Convenient accessors (get(), operator*, operator->)
+ * - Async mode: loads go to ResourceLoader's worker pool instead of
+ *   stalling the frame that first touches the resource
+ * - Sharing: every Resource<T> naming the same file (after path
+ *   canonicalization, see ResourceCache) uses one T, loaded once
+ * 
+ * Shared data: the loaded T, its modification time, the file watch and any
+ * background load live in a state object from ResourceCache, so two
+ * Resource<TextureResource> globals for one file hold one image. A hot
+ * reload through any holder replaces the data for all of them, and each
+ * holder's reload() reports it once. The T goes away when its last holder
+ * does (or is reset()), and a replaced or released T is retired to
+ * ResourceCache rather than destroyed, so frames still in flight can
+ * finish with it. Pointers from get() stay valid for those frames only.
+ * 
+ * Async mode (setAsync()): get() queues a background load and returns the
+ * placeholder (setPlaceholder(), or nullptr) until isReady(). Types with a
+ * two-phase load (see resource_detail::HasDecode - TextureResource and
+ * MeshResource) read and decode on a worker; only the GPU half runs in
+ * ResourceLoader::pump() on the render thread. Other types are constructed
+ * in pump(), after a worker has read their file once to warm the OS cache.
+ * Hot reloads keep the old data on screen until the new load is ready.
+ * A failed async load is retried only when the file changes (reload()) or
+ * on forceReload().
  * 
  * Usage:
  *   Resource<TextureResource> texture("textures/brick.dds");
  *   auto* tex = texture.get();
  *   texture.reload(); // Check for file changes and reload if needed
+ * 
+ *   Resource<TextureResource> streamed("textures/far_hills.ktx2");
+ *   streamed.setAsync(true, 10);          // Priority 10 (higher loads first)
+ *   streamed.setPlaceholder(&greyTexture);
+ *   TextureResource* t = streamed.get();  // Placeholder until ready
  */
 template<typename T>
 class Resource {
 private:
-    std::unique_ptr<T> m_data;
+    using Decoded = typename resource_detail::DecodedOf<T>::type;
+    
+    /**
+     * One background load. work() runs on a ResourceLoader worker,
+     * finish() in pump() on the render thread; the Resource picks the
+     * result up on its next access.
+     */
+    class AsyncLoad : public ResourceLoader::Task {
+    public:
+        explicit AsyncLoad(const std::string& path) : m_path(path) {}
+        
+        void work() override {
+            m_modified = getFileModificationTime(m_path);
+            try {
+                if constexpr (resource_detail::HasDecode<T>::value) {
+                    m_decoded = std::make_unique<Decoded>(T::decode(m_path));
+                } else {
+                    // No CPU/GPU split: at least take the disk read off the frame
+                    VfsFile file;
+                    if (Vfs::shared().open(m_path, file)) {
+                        volatile char sink = 0;  // Fault every page in here
+                        for (size_t i = 0; i < file.size(); i += 4096) sink = sink ^ file.data()[i];
+                    }
+                }
+            } catch (const std::exception& e) {
+                m_error = e.what();
+            }
+        }
+        
+        void finish() override {
+            if (m_error.empty()) {
+                try {
+                    if constexpr (resource_detail::HasDecode<T>::value) {
+                        m_result = std::make_unique<T>(std::move(*m_decoded));
+                    } else {
+                        m_result = std::make_unique<T>(m_path);
+                    }
+                } catch (const std::exception& e) {
+                    m_error = e.what();
+                }
+            }
+            m_decoded.reset();
+            m_finished = true;
+        }
+        
+        bool isCancelled() const override { return m_cancelled.load(); }
+        
+        std::string m_path;
+        std::time_t m_modified = 0;
+        std::unique_ptr<Decoded> m_decoded;   // work() -> finish()
+        std::unique_ptr<T> m_result;          // Render thread only from here on
+        std::string m_error;
+        bool m_finished = false;
+        std::atomic<bool> m_cancelled{false};
+    };
+    
+    /**
+     * Everything that belongs to the file rather than to one holder;
+     * shared through ResourceCache (render thread)
+     */
+    struct Shared {
+        explicit Shared(const std::string& filepath) : path(filepath) {}
+        
+        ~Shared() {
+            if (async) {
+                async->m_cancelled.store(true);
+            }
+            FileWatcher::shared().unwatch(watchId);
+            ResourceCache::shared().retire(std::shared_ptr<T>(std::move(data)));
+        }
+        
+        std::string path;
+        std::unique_ptr<T> data;
+        std::time_t lastModified = 0;
+        bool loaded = false;
+        uint64_t version = 0;                 // Bumped whenever data is replaced
+        
+        std::shared_ptr<AsyncLoad> async;     // In-flight background load
+        bool asyncFailed = false;             // Last background load failed
+        
+        // FileWatcher subscription (taken on the first reload())
+        int watchId = FileWatcher::NOT_WATCHED;
+        bool watchRequested = false;
+    };
+    
+    std::shared_ptr<Shared> m_shared;         // Taken on first use
     std::string m_path;
-    std::time_t m_lastModified;
-    bool m_loaded;
+    uint64_t m_seenVersion = 0;               // Data version reload() last reported
+    
+    // Async mode (per holder)
+    T* m_placeholder = nullptr;               // Not owned
+    int m_priority = 0;
+    bool m_asyncMode = false;
     
     /**
      * Get file modification time
      * @return Modification time, or 0 if file doesn't exist
      */
-    std::time_t getFileModificationTime(const std::string& filepath) {
+    static std::time_t getFileModificationTime(const std::string& filepath) {
 #ifdef _WIN32
         struct _stat fileStat;
         if (_stat(filepath.c_str(), &fileStat) == 0) {
@@ -60,18 +212,110 @@ private:
     }
     
     /**
-     * Load the resource from file
+     * The shared state for this path (nullptr without a path)
+     */
+    Shared* state() {
+        if (!m_shared && !m_path.empty()) {
+            m_shared = ResourceCache::shared().acquire<Shared>(m_path, "", [this]() {
+                return std::make_shared<Shared>(m_path);
+            });
+        }
+        if (m_shared && m_seenVersion == 0) {
+            m_seenVersion = m_shared->version;
+        }
+        return m_shared.get();
+    }
+    
+    /**
+     * Swap in new data for every holder; the old version is retired
+     */
+    static void replaceData(Shared& shared, std::unique_ptr<T> data, std::time_t modified) {
+        ResourceCache::shared().retire(std::shared_ptr<T>(std::move(shared.data)));
+        shared.data = std::move(data);
+        shared.lastModified = modified;
+        shared.loaded = true;
+        shared.version++;
+    }
+    
+    /**
+     * Load the resource from file; the current data (if any) stays on failure
      * @throws std::runtime_error if loading fails
      */
-    void loadResource() {
+    void loadResource(Shared& shared) {
+        std::unique_ptr<T> data;
         try {
-            m_data = std::make_unique<T>(m_path);
-            m_lastModified = getFileModificationTime(m_path);
-            m_loaded = true;
+            data = std::make_unique<T>(m_path);
         } catch (const std::exception& e) {
-            m_loaded = false;
             throw std::runtime_error("Failed to load resource '" + m_path + "': " + e.what());
         }
+        replaceData(shared, std::move(data), getFileModificationTime(m_path));
+    }
+    
+    /**
+     * Take over a finished background load (render thread). A failed load
+     * keeps whatever was there before.
+     * @return true if new data was adopted
+     */
+    static bool adoptAsync(Shared& shared) {
+        if (!shared.async || !shared.async->m_finished) {
+            return false;
+        }
+        std::shared_ptr<AsyncLoad> load = std::move(shared.async);
+        if (!load->m_result) {
+            shared.lastModified = load->m_modified;  // A broken file isn't retried until it changes
+            shared.asyncFailed = true;
+            return false;
+        }
+        replaceData(shared, std::move(load->m_result), load->m_modified);
+        shared.asyncFailed = false;
+        return true;
+    }
+    
+    static void cancelAsync(Shared& shared) {
+        if (shared.async) {
+            shared.async->m_cancelled.store(true);
+            shared.async.reset();
+        }
+    }
+    
+    /**
+     * Whether another version replaced the one this holder last saw (each
+     * replacement is reported once per holder)
+     */
+    bool takeReloaded() {
+        if (!m_shared) {
+            return false;
+        }
+        bool reloaded = m_seenVersion != 0 && m_seenVersion != m_shared->version && m_shared->loaded;
+        m_seenVersion = m_shared->version;
+        return reloaded;
+    }
+    
+    // Sync access: load inline if nobody has yet
+    T* getSync() {
+        Shared* shared = state();
+        if (!shared) {
+            return nullptr;
+        }
+        adoptAsync(*shared);
+        if (!shared->loaded) {
+            cancelAsync(*shared);
+            loadResource(*shared);
+        }
+        return shared->data.get();
+    }
+    
+    // Async-mode access: queue the load if needed, never block
+    T* getAsync() {
+        Shared* shared = state();
+        if (!shared) {
+            return m_placeholder;
+        }
+        adoptAsync(*shared);
+        if (!shared->loaded && !shared->async && !shared->asyncFailed) {
+            requestAsync(m_priority);
+        }
+        return shared->loaded ? shared->data.get() : m_placeholder;
     }
 
 public:
@@ -82,55 +326,118 @@ public:
      * @param filepath Path to resource file
      */
     explicit Resource(const std::string& filepath) 
-        : m_path(filepath), m_lastModified(0), m_loaded(false) {
+        : m_path(filepath) {
         // Don't load yet - lazy load on first access
         // This allows resources to be declared before Vulkan is initialized
     }
     
-    // Delete copy constructor and assignment (resources are unique)
+    // Delete copy constructor and assignment (share by naming the same file)
     Resource(const Resource&) = delete;
     Resource& operator=(const Resource&) = delete;
     
     // Move constructor
     Resource(Resource&& other) noexcept
-        : m_data(std::move(other.m_data)),
+        : m_shared(std::move(other.m_shared)),
           m_path(std::move(other.m_path)),
-          m_lastModified(other.m_lastModified),
-          m_loaded(other.m_loaded) {
-        other.m_loaded = false;
-        other.m_lastModified = 0;
+          m_seenVersion(other.m_seenVersion),
+          m_placeholder(other.m_placeholder),
+          m_priority(other.m_priority),
+          m_asyncMode(other.m_asyncMode) {
+        other.m_seenVersion = 0;
     }
     
     // Move assignment
     Resource& operator=(Resource&& other) noexcept {
         if (this != &other) {
-            m_data = std::move(other.m_data);
+            m_shared = std::move(other.m_shared);
             m_path = std::move(other.m_path);
-            m_lastModified = other.m_lastModified;
-            m_loaded = other.m_loaded;
-            other.m_loaded = false;
-            other.m_lastModified = 0;
+            m_seenVersion = other.m_seenVersion;
+            m_placeholder = other.m_placeholder;
+            m_priority = other.m_priority;
+            m_asyncMode = other.m_asyncMode;
+            other.m_seenVersion = 0;
         }
         return *this;
     }
     
-    // Destructor - RAII cleanup (unique_ptr handles destruction)
+    // Destructor - releases this holder's share; the last one retires the
+    // data and drops a pending background load
     ~Resource() = default;
     
+    /**
+     * Async mode: get()/operator* queue a background load instead of
+     * loading inline (see class comment)
+     * @param priority Loads with higher priority are decoded and finished first
+     */
+    void setAsync(bool enabled, int priority = 0) {
+        m_asyncMode = enabled;
+        m_priority = priority;
+    }
+    
+    bool isAsync() const {
+        return m_asyncMode;
+    }
+    
+    /**
+     * Returned by get() in async mode until the resource is ready (not owned)
+     */
+    void setPlaceholder(T* placeholder) {
+        m_placeholder = placeholder;
+    }
+    
+    /**
+     * Queue a background load now (prefetch), whatever the mode. Calling it
+     * again while the load is still queued raises its priority. Holders of
+     * the same file share one load.
+     */
+    void requestAsync(int priority = 0) {
+        Shared* shared = state();
+        if (!shared) {
+            return;
+        }
+        if (shared->async) {
+            ResourceLoader::shared().submit(shared->async, priority);
+            return;
+        }
+        shared->async = std::make_shared<AsyncLoad>(m_path);
+        shared->asyncFailed = false;
+        if (!ResourceLoader::shared().submit(shared->async, priority)) {
+            shared->async.reset();  // Loader shut down
+        }
+    }
+    
+    /**
+     * Loaded and usable (picks up a finished background load)
+     */
+    bool isReady() {
+        if (Shared* shared = state()) {
+            adoptAsync(*shared);
+        }
+        return isLoaded();
+    }
+    
+    /**
+     * A background load is queued or running
+     */
+    bool isPending() const {
+        return m_shared && m_shared->async != nullptr;
+    }
+    
     /**
      * Get raw pointer to resource (lazy loads if not already loaded)
+     * In async mode never blocks: returns the placeholder until ready.
      * @return Pointer to resource, or nullptr if loading failed
      */
     T* get() {
-        if (!m_loaded && !m_path.empty()) {
-            try {
-                loadResource();
-            } catch (const std::exception& e) {
-                // Loading failed - return nullptr
-                return nullptr;
-            }
+        if (m_asyncMode) {
+            return getAsync();
+        }
+        try {
+            return getSync();
+        } catch (const std::exception& e) {
+            // Loading failed - return nullptr
+            return nullptr;
         }
-        return m_data.get();
     }
     
     /**
@@ -138,7 +445,7 @@ public:
      * @return Const pointer to resource, or nullptr if not loaded
      */
     const T* get() const {
-        return m_data.get();
+        return isLoaded() ? m_shared->data.get() : nullptr;
     }
     
     /**
@@ -147,23 +454,22 @@ public:
      * @throws std::runtime_error if resource is not loaded or loading fails
      */
     T& operator*() {
-        if (!m_loaded && !m_path.empty()) {
-            loadResource();
+        if (m_asyncMode) {
+            if (T* data = getAsync()) return *data;
+            throw std::runtime_error("Resource '" + m_path + "' is not loaded yet");
         }
-        if (!m_loaded || !m_data) {
-            throw std::runtime_error("Resource '" + m_path + "' is not loaded");
-        }
-        return *m_data;
+        if (T* data = getSync()) return *data;
+        throw std::runtime_error("Resource '" + m_path + "' is not loaded");
     }
     
     /**
      * Const dereference operator
      */
     const T& operator*() const {
-        if (!m_loaded || !m_data) {
+        if (!isLoaded()) {
             throw std::runtime_error("Resource '" + m_path + "' is not loaded");
         }
-        return *m_data;
+        return *m_shared->data;
     }
     
     /**
@@ -172,23 +478,14 @@ public:
      * @throws std::runtime_error if resource is not loaded or loading fails
      */
     T* operator->() {
-        if (!m_loaded && !m_path.empty()) {
-            loadResource();
-        }
-        if (!m_loaded || !m_data) {
-            throw std::runtime_error("Resource '" + m_path + "' is not loaded");
-        }
-        return m_data.get();
+        return &**this;
     }
     
     /**
      * Const member access operator
      */
     const T* operator->() const {
-        if (!m_loaded || !m_data) {
-            throw std::runtime_error("Resource '" + m_path + "' is not loaded");
-        }
-        return m_data.get();
+        return &**this;
     }
     
     /**
@@ -196,7 +493,15 @@ public:
      * @return true if loaded, false otherwise
      */
     bool isLoaded() const {
-        return m_loaded && m_data != nullptr;
+        return m_shared && m_shared->loaded && m_shared->data != nullptr;
+    }
+    
+    /**
+     * Resource<T>s holding this file's data, this one included (0 before
+     * first use)
+     */
+    long getHolderCount() const {
+        return m_shared ? m_shared.use_count() : 0;
     }
     
     /**
@@ -212,76 +517,92 @@ public:
      * @return Last modification time
      */
     std::time_t getLastModified() const {
-        return m_lastModified;
+        return m_shared ? m_shared->lastModified : 0;
     }
     
     /**
      * Check if file has been modified and reload if needed
      * This is the hot-reload method for CONTINUUM integration
+     * In async mode the new version loads in the background and replaces
+     * the old one once ready (that later call returns true). The file is
+     * checked and loaded once for all holders; each of them gets true once
+     * per new version, whichever one did the loading.
      * @return true if resource was reloaded, false otherwise
      */
     bool reload() {
-        if (m_path.empty()) {
+        Shared* shared = state();
+        if (!shared) {
             return false;
         }
         
+        if (shared->async) {
+            adoptAsync(*shared);
+            return takeReloaded();
+        }
+        
+        // Skip the stat() until the watcher reports a change (a new
+        // subscription starts changed; unwatchable files always stat)
+        if (!shared->watchRequested) {
+            shared->watchId = FileWatcher::shared().watch(m_path);
+            shared->watchRequested = true;
+        }
+        if (!FileWatcher::shared().consume(shared->watchId)) {
+            return takeReloaded();
+        }
+        
         std::time_t currentModified = getFileModificationTime(m_path);
         
         // Check if file has been modified
-        if (currentModified > m_lastModified && currentModified > 0) {
-            try {
-                // Destroy old resource
-                m_data.reset();
-                m_loaded = false;
-                
-                // Load new resource
-                loadResource();
-                
-                return true; // Reloaded successfully
-            } catch (const std::exception& e) {
-                // Reload failed - log error but don't throw
-                // (allows game to continue running even if reload fails)
-                m_loaded = false;
-                return false;
+        if (currentModified > shared->lastModified && currentModified > 0) {
+            if (m_asyncMode) {
+                if (shared->loaded || shared->asyncFailed) {
+                    requestAsync(m_priority);
+                }
+            } else {
+                try {
+                    // The old version stays until the new one has loaded
+                    loadResource(*shared);
+                } catch (const std::exception& e) {
+                    // Reload failed - keep the old data, don't throw
+                    // (allows game to continue running even if reload fails)
+                    shared->lastModified = currentModified;
+                }
             }
         }
         
-        return false; // No reload needed
+        return takeReloaded();
     }
     
     /**
-     * Force reload resource (even if file hasn't changed)
-     * @return true if reloaded successfully, false otherwise
+     * Force reload resource (even if file hasn't changed), for every holder
+     * @return true if reloaded successfully, false otherwise (the old data
+     *         stays)
      */
     bool forceReload() {
-        if (m_path.empty()) {
+        Shared* shared = state();
+        if (!shared) {
             return false;
         }
         
+        cancelAsync(*shared);
+        shared->asyncFailed = false;
         try {
-            // Destroy old resource
-            m_data.reset();
-            m_loaded = false;
-            
-            // Load new resource
-            loadResource();
-            
+            loadResource(*shared);
+            m_seenVersion = shared->version;
             return true;
         } catch (const std::exception& e) {
-            m_loaded = false;
             return false;
         }
     }
     
     /**
-     * Reset resource (unload)
+     * Release this holder's share (the data goes once no other holder has
+     * it); the next access acquires and, if needed, loads it again
      */
     void reset() {
-        m_data.reset();
-        m_loaded = false;
-        m_lastModified = 0;
+        m_shared.reset();
+        m_seenVersion = 0;
     }
 };
 
 #endif // EDEN_RESOURCE_H
-
@@ -0,0 +1,251 @@
+// EDEN ENGINE - ResourceCache
+// Path-deduplicating registry behind Resource<T>: one live object per type,
+// canonical path and load parameters, shared by every holder, with
+// destruction deferred until the GPU can no longer be using it
+
+#ifndef EDEN_RESOURCE_CACHE_H
+#define EDEN_RESOURCE_CACHE_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>  // realpath / _fullpath
+
+/**
+ * ResourceCache - Shared, reference-counted resources keyed by file
+ *
+ * acquire<T>() returns the live T for (type, canonical path, params) if
+ * any holder still has one, and only calls the factory otherwise. The
+ * cache keeps weak references: an entry goes away with its last
+ * shared_ptr, so it never extends a resource's lifetime by itself.
+ *
+ * Objects that may still be read by frames in flight (a hot-reloaded
+ * texture's old image, a resource whose last holder just went away) are
+ * retire()d instead of destroyed, and destroyed RETIRE_FRAMES collect()
+ * calls later. Generated main loops call collect() once per frame; until
+ * something does, retire() destroys immediately, as before the cache.
+ *
+ * Leaked on purpose: Resource<T> globals release their entries during
+ * static destruction, in no particular order relative to a function-local
+ * static.
+ *
+ * Usage:
+ *   std::shared_ptr<Mesh> mesh = ResourceCache::shared().acquire<Mesh>(
+ *       "models/rock.obj", "lod=4", [&]() { return std::make_shared<Mesh>(...); });
+ *   ResourceCache::shared().retire(std::move(oldMesh));   // instead of reset()
+ *   ResourceCache::shared().collect();                    // once per frame
+ */
+class ResourceCache {
+public:
+    // Frames a retired object survives (the engine's frames in flight)
+    static constexpr uint32_t RETIRE_FRAMES = 3;
+
+    static ResourceCache& shared() {
+        static ResourceCache* cache = new ResourceCache();
+        return *cache;
+    }
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    /**
+     * The live T for this file and parameters, or a new one from make()
+     * (called without the cache lock held; may throw, nothing is cached
+     * then). Two threads racing on the same key may both build one; the
+     * first to finish is kept and the other is dropped.
+     */
+    template<typename T, typename Make>
+    std::shared_ptr<T> acquire(const std::string& path, const std::string& params, Make&& make) {
+        std::string key = makeKey(typeid(T).name(), path, params);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            if (it != m_entries.end()) {
+                if (std::shared_ptr<void> live = it->second.lock()) {
+                    m_hits++;
+                    return std::static_pointer_cast<T>(live);
+                }
+                m_entries.erase(it);
+            }
+        }
+
+        std::shared_ptr<T> created = make();
+        if (!created) {
+            return created;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::weak_ptr<void>& slot = m_entries[key];
+        if (std::shared_ptr<void> live = slot.lock()) {
+            m_hits++;
+            return std::static_pointer_cast<T>(live);
+        }
+        slot = created;
+        m_misses++;
+        return created;
+    }
+
+    /**
+     * Destroy `garbage` once the frames in flight now have retired (its
+     * last reference, that is; other owners keep it alive as usual)
+     */
+    void retire(std::shared_ptr<void> garbage) {
+        if (!garbage) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_collecting) {
+            lock.unlock();
+            garbage.reset();  // No frame loop: nothing can still be in flight that we know of
+            return;
+        }
+        m_retired.push_back({m_frame, std::move(garbage)});
+    }
+
+    /**
+     * Advance one frame: destroy what was retired RETIRE_FRAMES calls ago
+     * and forget dead entries. Call once per frame on the render thread.
+     */
+    void collect() {
+        std::vector<std::shared_ptr<void>> expired;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_collecting = true;
+            m_frame++;
+            while (!m_retired.empty() && m_frame - m_retired.front().frame >= RETIRE_FRAMES) {
+                expired.push_back(std::move(m_retired.front().garbage));
+                m_retired.pop_front();
+            }
+            if (m_frame % 64 == 0) {
+                for (auto it = m_entries.begin(); it != m_entries.end();) {
+                    it = it->second.expired() ? m_entries.erase(it) : std::next(it);
+                }
+            }
+        }
+        // Destructors run outside the lock (they may retire() in turn)
+        expired.clear();
+    }
+
+    /**
+     * Destroy everything retired now (after vkDeviceWaitIdle, at shutdown)
+     */
+    void flush() {
+        std::deque<Retired> retired;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            retired.swap(m_retired);
+        }
+        retired.clear();
+    }
+
+    struct Stats {
+        size_t entries = 0;     // Keys with a live object
+        size_t retired = 0;     // Waiting for their frames to retire
+        uint64_t hits = 0;      // acquire() calls that shared an existing object
+        uint64_t misses = 0;    // acquire() calls that created one
+    };
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats;
+        for (const auto& entry : m_entries) {
+            if (!entry.second.expired()) stats.entries++;
+        }
+        stats.retired = m_retired.size();
+        stats.hits = m_hits;
+        stats.misses = m_misses;
+        return stats;
+    }
+
+    /**
+     * Absolute path with symlinks, "." and ".." resolved (the file must
+     * exist for that; otherwise the path is only cleaned up lexically).
+     * Case-folded on Windows, where file names compare case-insensitively.
+     */
+    static std::string canonicalPath(const std::string& path) {
+        std::string result;
+#ifdef _WIN32
+        char buffer[_MAX_PATH];
+        result = _fullpath(buffer, path.c_str(), _MAX_PATH) ? std::string(buffer) : lexicalNormalize(path);
+        std::replace(result.begin(), result.end(), '\\', '/');
+        std::transform(result.begin(), result.end(), result.begin(),
+                       [](unsigned char c) { return static_cast<char>(::tolower(c)); });
+#else
+        if (char* resolved = realpath(path.c_str(), nullptr)) {
+            result = resolved;
+            free(resolved);
+        } else {
+            result = lexicalNormalize(path);
+        }
+#endif
+        return result;
+    }
+
+private:
+    ResourceCache() = default;
+
+    struct Retired {
+        uint64_t frame;
+        std::shared_ptr<void> garbage;
+    };
+
+    static std::string makeKey(const char* type, const std::string& path, const std::string& params) {
+        std::string key = type;
+        key += '\n';
+        key += canonicalPath(path);
+        key += '\n';
+        key += params;
+        return key;
+    }
+
+    // "a/./b/../c" -> "a/c", backslashes as slashes
+    static std::string lexicalNormalize(const std::string& path) {
+        std::string unified = path;
+        std::replace(unified.begin(), unified.end(), '\\', '/');
+        bool absolute = !unified.empty() && unified[0] == '/';
+
+        std::vector<std::string> parts;
+        size_t start = 0;
+        while (start <= unified.size()) {
+            size_t slash = unified.find('/', start);
+            if (slash == std::string::npos) slash = unified.size();
+            std::string part = unified.substr(start, slash - start);
+            if (part == "..") {
+                if (!parts.empty() && parts.back() != "..") {
+                    parts.pop_back();
+                } else if (!absolute) {
+                    parts.push_back(part);
+                }
+            } else if (!part.empty() && part != ".") {
+                parts.push_back(part);
+            }
+            start = slash + 1;
+        }
+
+        std::string result = absolute ? "/" : "";
+        for (size_t i = 0; i < parts.size(); i++) {
+            if (i > 0) result += '/';
+            result += parts[i];
+        }
+        return result.empty() ? "." : result;
+    }
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::weak_ptr<void>> m_entries;
+    std::deque<Retired> m_retired;
+    uint64_t m_frame = 0;
+    bool m_collecting = false;    // collect() has been called: retire() defers
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+#endif // EDEN_RESOURCE_CACHE_H
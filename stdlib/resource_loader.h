@@ -0,0 +1,215 @@
+// EDEN ENGINE - ResourceLoader
+// Worker pool behind Resource<T>'s async mode: file I/O and decoding run on
+// background threads, the GPU half of each load on the render thread
+
+#ifndef EDEN_RESOURCE_LOADER_H
+#define EDEN_RESOURCE_LOADER_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ResourceLoader - Prioritized background loading for Resource<T>
+ *
+ * Each load is a Task split in two:
+ * - work() runs on a worker thread (read the file, decode it)
+ * - finish() runs on the render thread inside pump() (create and upload
+ *   the GPU objects), a bounded number per frame
+ *
+ * Higher priorities are picked first, both by the workers and by pump();
+ * equal priorities keep submission order. Tasks are single-use: submitting
+ * one that is still queued again with a higher priority moves it up (the
+ * stale entry is skipped), anything else is ignored. Workers start on the
+ * first submit.
+ *
+ * Usage:
+ *   ResourceLoader::shared().submit(task, priority);
+ *   // once per frame, on the render thread (generated
+ *   // check_and_reload_resources() does this inside an upload batch):
+ *   ResourceLoader::shared().pump();
+ */
+class ResourceLoader {
+public:
+    // Finished tasks taken per pump() by default
+    static constexpr size_t DEFAULT_FINISH_PER_PUMP = 8;
+
+    class Task {
+    public:
+        virtual ~Task() = default;
+        virtual void work() = 0;            // Worker thread
+        virtual void finish() = 0;          // Render thread, from pump()
+        virtual bool isCancelled() const { return false; }  // Skips work() and finish()
+
+    private:
+        friend class ResourceLoader;
+        // Loader-side state, guarded by its mutex
+        bool m_claimed = false;              // A worker took it
+        int m_priority = 0;
+        uint64_t m_generation = 0;           // 0 = never submitted
+    };
+
+    ResourceLoader() = default;
+    ~ResourceLoader() { shutdown(); }
+
+    ResourceLoader(const ResourceLoader&) = delete;
+    ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+    static ResourceLoader& shared() {
+        static ResourceLoader loader;
+        return loader;
+    }
+
+    /**
+     * Worker threads to start (0 = hardware concurrency - 1, at least 1).
+     * Only affects a loader whose workers haven't started yet.
+     */
+    void setThreadCount(uint32_t threads) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threadCount = threads;
+    }
+
+    /**
+     * Queue `task` for loading, or raise the priority of a task still
+     * waiting for a worker
+     * @return false if the task was already taken (or the loader stopped)
+     */
+    bool submit(const std::shared_ptr<Task>& task, int priority = 0) {
+        if (!task) return false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping || task->m_claimed) return false;
+            bool queued = task->m_generation != 0;
+            if (queued && priority <= task->m_priority) return true;
+            if (!queued) m_queued++;
+            startWorkersLocked();
+            task->m_priority = priority;
+            task->m_generation = ++m_sequence;
+            m_queue.push_back({task, priority, task->m_generation});
+            std::push_heap(m_queue.begin(), m_queue.end(), Entry::less);
+        }
+        m_wake.notify_one();
+        return true;
+    }
+
+    /**
+     * Run finish() for up to `maxFinish` decoded tasks, highest priority
+     * first. Call once per frame on the render thread.
+     * @return Number of tasks finished
+     */
+    size_t pump(size_t maxFinish = DEFAULT_FINISH_PER_PUMP) {
+        std::vector<std::shared_ptr<Task>> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_done.empty()) return 0;
+            std::stable_sort(m_done.begin(), m_done.end(),
+                             [](const std::shared_ptr<Task>& a, const std::shared_ptr<Task>& b) {
+                                 return a->m_priority > b->m_priority;
+                             });
+            size_t count = std::min(maxFinish, m_done.size());
+            ready.assign(m_done.begin(), m_done.begin() + count);
+            m_done.erase(m_done.begin(), m_done.begin() + count);
+        }
+        size_t finished = 0;
+        for (const std::shared_ptr<Task>& task : ready) {
+            if (task->isCancelled()) continue;
+            task->finish();
+            finished++;
+        }
+        return finished;
+    }
+
+    /**
+     * Tasks queued, being decoded or waiting for pump()
+     */
+    size_t pendingCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queued + m_busy + m_done.size();
+    }
+
+    /**
+     * Stop and join the workers; queued tasks are dropped
+     */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) {
+            if (worker.joinable()) worker.join();
+        }
+        m_workers.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.clear();
+        m_done.clear();
+        m_queued = 0;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<Task> task;
+        int priority;
+        uint64_t generation;
+
+        // Max-heap on priority, then oldest first
+        static bool less(const Entry& a, const Entry& b) {
+            if (a.priority != b.priority) return a.priority < b.priority;
+            return a.generation > b.generation;
+        }
+    };
+
+    void startWorkersLocked() {
+        if (!m_workers.empty()) return;
+        uint32_t threads = m_threadCount;
+        if (threads == 0) {
+            uint32_t hardware = std::thread::hardware_concurrency();
+            threads = hardware > 1 ? hardware - 1 : 1;
+        }
+        for (uint32_t i = 0; i < threads; i++) {
+            m_workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) return;
+
+            std::pop_heap(m_queue.begin(), m_queue.end(), Entry::less);
+            Entry entry = std::move(m_queue.back());
+            m_queue.pop_back();
+
+            // Superseded by a higher-priority submit of the same task
+            if (entry.generation != entry.task->m_generation) continue;
+            entry.task->m_claimed = true;
+            m_queued--;
+            if (entry.task->isCancelled()) continue;
+
+            m_busy++;
+            lock.unlock();
+            entry.task->work();
+            lock.lock();
+            m_busy--;
+            m_done.push_back(std::move(entry.task));
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<Entry> m_queue;                  // Heap (Entry::less)
+    std::vector<std::shared_ptr<Task>> m_done;   // Decoded, waiting for pump()
+    std::vector<std::thread> m_workers;
+    uint64_t m_sequence = 0;
+    size_t m_queued = 0;                         // Live (not superseded) queue entries
+    size_t m_busy = 0;
+    uint32_t m_threadCount = 0;
+    bool m_stopping = false;
+};
+
+#endif // EDEN_RESOURCE_LOADER_H
@@ -0,0 +1,319 @@
+// EDEN ENGINE - SoA Storage
+// Aligned, tail-padded field columns for component_soa components, and the
+// sparse set that keeps a component's columns in step with its entities
+
+#ifndef EDEN_SOA_STORAGE_H
+#define EDEN_SOA_STORAGE_H
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#include "entity_storage.h"
+#include "component_registry.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Pointers the compiler may assume don't alias (generated query loops hoist
+// every SoA column they touch into one of these)
+#define EDEN_RESTRICT __restrict
+
+// Before a loop whose iterations don't depend on each other through memory
+#if defined(__clang__)
+#define EDEN_VECTORIZE _Pragma("clang loop vectorize(enable)")
+#elif defined(__GNUC__)
+#define EDEN_VECTORIZE _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define EDEN_VECTORIZE __pragma(loop(ivdep))
+#else
+#define EDEN_VECTORIZE
+#endif
+
+namespace soa_detail {
+
+static constexpr size_t COLUMN_ALIGN = 64;  // Cache line; one AVX-512 register
+static constexpr size_t PAD_BYTES = 64;     // Column capacity is a multiple of this
+
+} // namespace soa_detail
+
+/**
+ * A column's bytes, without its element type: what SoAStorage works with to
+ * move whole rows. Always holds a multiple of PAD_BYTES, 64-byte aligned,
+ * and everything past size() is zero - so a vector loop may run its last
+ * lanes into the padding instead of needing a scalar tail.
+ */
+class SoAColumnBase {
+public:
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    // Elements that may be read and written: size() rounded up to whole lanes
+    size_t padded_size() const { return element_size ? capacity / element_size : 0; }
+
+    void reserve(size_t elements) {
+        if (elements * element_size > capacity) grow(elements);
+    }
+
+    void clear() {
+        std::memset(bytes, 0, count * element_size);
+        count = 0;
+    }
+
+    // A zeroed element at the end
+    void push_zero() {
+        if ((count + 1) * element_size > capacity) grow(count ? count * 2 : 1);
+        count++;
+    }
+
+    // Moves the last element into i (the sparse-set removal)
+    void swap_remove(size_t i) {
+        size_t last = count - 1;
+        if (i != last) std::memcpy(bytes + i * element_size, bytes + last * element_size, element_size);
+        std::memset(bytes + last * element_size, 0, element_size);  // Padding stays zero
+        count = last;
+    }
+
+protected:
+    unsigned char* bytes = nullptr;
+    size_t count = 0;
+    size_t capacity = 0;  // Bytes
+    size_t element_size;
+
+    explicit SoAColumnBase(size_t element_size) : element_size(element_size) {}
+
+    SoAColumnBase(const SoAColumnBase& other) : element_size(other.element_size) {
+        if (other.count) {
+            grow(other.count);
+            std::memcpy(bytes, other.bytes, other.count * element_size);
+            count = other.count;
+        }
+    }
+
+    SoAColumnBase(SoAColumnBase&& other) noexcept
+        : bytes(other.bytes), count(other.count), capacity(other.capacity), element_size(other.element_size) {
+        other.bytes = nullptr;
+        other.count = other.capacity = 0;
+    }
+
+    SoAColumnBase& operator=(SoAColumnBase other) noexcept {
+        std::swap(bytes, other.bytes);
+        std::swap(count, other.count);
+        std::swap(capacity, other.capacity);
+        return *this;
+    }
+
+    ~SoAColumnBase() {
+        if (bytes) ::operator delete(bytes, std::align_val_t(soa_detail::COLUMN_ALIGN));
+    }
+
+    void grow(size_t elements) {
+        size_t needed = elements * element_size;
+        size_t new_capacity = (needed + soa_detail::PAD_BYTES - 1) / soa_detail::PAD_BYTES * soa_detail::PAD_BYTES;
+        auto* data = static_cast<unsigned char*>(::operator new(new_capacity, std::align_val_t(soa_detail::COLUMN_ALIGN)));
+        std::memset(data, 0, new_capacity);
+        if (bytes) {
+            std::memcpy(data, bytes, count * element_size);
+            ::operator delete(bytes, std::align_val_t(soa_detail::COLUMN_ALIGN));
+        }
+        bytes = data;
+        capacity = new_capacity;
+    }
+};
+
+/**
+ * One field of a component_soa component (the codegen emits `[f32]` fields
+ * as SoAColumn<float>). Indexes like the std::vector it replaces; data() is
+ * 64-byte aligned.
+ */
+template <typename F>
+class SoAColumn : public SoAColumnBase {
+    static_assert(std::is_trivially_copyable<F>::value, "SoA fields are moved as bytes");
+    static_assert(alignof(F) <= soa_detail::COLUMN_ALIGN, "SoA field alignment too large");
+
+public:
+    SoAColumn() : SoAColumnBase(sizeof(F)) {}
+
+    F* data() { return reinterpret_cast<F*>(bytes); }
+    const F* data() const { return reinterpret_cast<const F*>(bytes); }
+    F& operator[](size_t i) { return data()[i]; }
+    const F& operator[](size_t i) const { return data()[i]; }
+    F* begin() { return data(); }
+    F* end() { return data() + count; }
+    const F* begin() const { return data(); }
+    const F* end() const { return data() + count; }
+
+    void push_back(const F& value) {
+        push_zero();
+        data()[count - 1] = value;
+    }
+
+    void pop_back() { swap_remove(count - 1); }
+
+    void resize(size_t elements) {
+        reserve(elements);
+        if (elements < count) std::memset(bytes + elements * sizeof(F), 0, (count - elements) * sizeof(F));
+        count = elements;
+    }
+};
+
+/**
+ * Entities for a component_soa component T whose fields are all SoAColumns:
+ * row i of every column belongs to entities()[i]. add() appends a zeroed
+ * row and returns its index; remove() swap-removes the row from every column
+ * at once, so the columns never drift apart. Columns are found through
+ * ComponentFields<T>.
+ *
+ * Usage:
+ *   SoAStorage<Velocity> velocities;
+ *   size_t row = velocities.add(e);
+ *   velocities.columns().x[row] = 1.0f;
+ *   float* EDEN_RESTRICT vx = velocities.columns().x.data();
+ *   EDEN_VECTORIZE
+ *   for (size_t i = 0; i < velocities.size(); i++) vx[i] *= 0.99f;
+ */
+template <typename T>
+class SoAStorage {
+public:
+    SoAStorage() {
+        const auto* fields = ComponentFields<T>::get_fields();
+        for (size_t f = 0; fields && f < ComponentFields<T>::field_count; f++) offsets.push_back(fields[f].offset);
+    }
+
+    SoAStorage(const SoAStorage&) = delete;
+    SoAStorage& operator=(const SoAStorage&) = delete;
+
+    // The entity's row, added zeroed if it had none
+    size_t add(EntityId entity) {
+        uint32_t row = sparse.get(entity_index(entity));
+        if (row != invalid_marker) {
+            entities_[row] = entity;
+            return row;
+        }
+        row = static_cast<uint32_t>(entities_.size());
+        sparse.set(entity_index(entity), row);
+        entities_.push_back(entity);
+        for (size_t offset : offsets) column_at(offset).push_zero();
+        return row;
+    }
+
+    bool remove(EntityId entity) {
+        if (!has(entity)) return false;
+        uint32_t row = sparse.get(entity_index(entity));
+        for (size_t offset : offsets) column_at(offset).swap_remove(row);
+        entities_[row] = entities_.back();
+        sparse.set(entity_index(entities_[row]), row);
+        entities_.pop_back();
+        sparse.set(entity_index(entity), invalid_marker);  // After, in case it was the last row
+        return true;
+    }
+
+    bool has(EntityId entity) const {
+        uint32_t row = sparse.get(entity_index(entity));
+        return row != invalid_marker && entities_[row] == entity;
+    }
+
+    // Row of the entity, or SIZE_MAX
+    size_t index_of(EntityId entity) const {
+        return has(entity) ? sparse.get(entity_index(entity)) : SIZE_MAX;
+    }
+
+    size_t size() const { return entities_.size(); }
+    const std::vector<EntityId>& entities() const { return entities_; }
+
+    T& columns() { return data; }
+    const T& columns() const { return data; }
+
+    void reserve(size_t rows) {
+        entities_.reserve(rows);
+        for (size_t offset : offsets) column_at(offset).reserve(rows);
+    }
+
+private:
+    static constexpr uint32_t invalid_marker = UINT32_MAX;
+
+    T data;
+    std::vector<size_t> offsets;  // Of each SoAColumn in T
+    std::vector<EntityId> entities_;
+    PagedArray<uint32_t, invalid_marker> sparse;
+
+    SoAColumnBase& column_at(size_t offset) {
+        return *reinterpret_cast<SoAColumnBase*>(reinterpret_cast<unsigned char*>(&data) + offset);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Kernels for the common Vec3-as-three-columns patterns. Any count works;
+// passing an SoAColumn's padded_size() lets them skip the scalar tail.
+// -----------------------------------------------------------------------------
+
+// p += v * dt
+inline void soa_integrate_vec3(float* EDEN_RESTRICT px, float* EDEN_RESTRICT py, float* EDEN_RESTRICT pz,
+                               const float* EDEN_RESTRICT vx, const float* EDEN_RESTRICT vy,
+                               const float* EDEN_RESTRICT vz, float dt, size_t count) {
+    size_t i = 0;
+#if defined(__AVX__)
+    __m256 step = _mm256_set1_ps(dt);
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), step)));
+        _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), step)));
+        _mm256_storeu_ps(pz + i, _mm256_add_ps(_mm256_loadu_ps(pz + i), _mm256_mul_ps(_mm256_loadu_ps(vz + i), step)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 step = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), step)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), step)));
+        _mm_storeu_ps(pz + i, _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(_mm_loadu_ps(vz + i), step)));
+    }
+#endif
+    for (; i < count; i++) {
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        pz[i] += vz[i] * dt;
+    }
+}
+
+// (x, y, z, 1) through a column-major 4x4 matrix (glm's layout), in place
+inline void soa_transform_points(const float* m, float* EDEN_RESTRICT x, float* EDEN_RESTRICT y,
+                                 float* EDEN_RESTRICT z, size_t count) {
+    size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i), pz = _mm256_loadu_ps(z + i);
+        __m256 out[3];
+        for (int r = 0; r < 3; r++) {
+            out[r] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m[r]), px),
+                                                 _mm256_mul_ps(_mm256_set1_ps(m[4 + r]), py)),
+                                   _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m[8 + r]), pz), _mm256_set1_ps(m[12 + r])));
+        }
+        _mm256_storeu_ps(x + i, out[0]);
+        _mm256_storeu_ps(y + i, out[1]);
+        _mm256_storeu_ps(z + i, out[2]);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i), pz = _mm_loadu_ps(z + i);
+        __m128 out[3];
+        for (int r = 0; r < 3; r++) {
+            out[r] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[r]), px), _mm_mul_ps(_mm_set1_ps(m[4 + r]), py)),
+                                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[8 + r]), pz), _mm_set1_ps(m[12 + r])));
+        }
+        _mm_storeu_ps(x + i, out[0]);
+        _mm_storeu_ps(y + i, out[1]);
+        _mm_storeu_ps(z + i, out[2]);
+    }
+#endif
+    for (; i < count; i++) {
+        float px = x[i], py = y[i], pz = z[i];
+        x[i] = m[0] * px + m[4] * py + m[8] * pz + m[12];
+        y[i] = m[1] * px + m[5] * py + m[9] * pz + m[13];
+        z[i] = m[2] * px + m[6] * py + m[10] * pz + m[14];
+    }
+}
+
+#endif // EDEN_SOA_STORAGE_H
@@ -0,0 +1,894 @@
+// EDEN ENGINE - System Profiler
+// Scoped timers around system and hot-function calls (emitted by
+// `heidic_v2 compile --profile`) and engine C API entry points: each thread
+// records into its own lock-free ring, and once per frame the rings drain
+// into rolling per-system stats, an ImGui table and flame view, and Chrome
+// trace files (which Tracy's import-chrome reads). Heap allocations are
+// counted per zone when operator new is hooked (EDEN_PROFILE_ALLOCATIONS).
+
+#ifndef EDEN_SYSTEM_PROFILER_H
+#define EDEN_SYSTEM_PROFILER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+#include "frame_arena.h"
+
+#ifdef USE_IMGUI
+#include <imgui.h>  // Not "imgui.h": that would find stdlib/imgui.h
+#endif
+
+// Heap and frame-arena traffic of the last frame, all threads
+struct AllocationStats {
+    bool tracking = false;             // operator new is hooked (EDEN_PROFILE_ALLOCATIONS)
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t untagged_allocations = 0; // Made outside every zone
+    uint64_t untagged_bytes = 0;
+    uint64_t arena_allocations = 0;    // FrameArena::allocate() calls
+    uint64_t arena_bytes = 0;
+    uint64_t arena_capacity = 0;       // Block bytes the arenas hold
+    size_t arenas = 0;
+};
+
+namespace system_profiler_detail {
+
+static constexpr size_t RING_EVENTS = 8192;               // Per thread, power of two
+static constexpr size_t WINDOW = 256;                     // Calls per zone behind average/p99
+static constexpr size_t MAX_TRACE_EVENTS = 1u << 21;      // ~64 MB of trace per capture
+static constexpr double FRAME_SMOOTHING = 0.1;
+static constexpr size_t MAX_ALLOC_ZONES = 1024;           // Zones past this count as untagged
+static constexpr size_t MAX_FLAME_EVENTS = 1u << 16;      // Kept from the last frame
+static constexpr uint32_t NO_ZONE = UINT32_MAX;
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct Event {
+    uint32_t zone;
+    uint32_t thread;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+};
+
+// Owner-thread-only counters read by end_frame(): a plain store, no RMW
+inline void add_relaxed(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// One producer (the owning thread), one consumer (SystemProfiler::end_frame).
+// A full ring drops events instead of blocking the thread being measured.
+struct ThreadRing {
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> in_use{false};  // A live thread owns it
+    uint32_t thread = 0;
+    Event events[RING_EVENTS];
+    // Heap allocations by innermost open zone (the last slot: no zone, or
+    // one past MAX_ALLOC_ZONES). Running totals, never reset.
+    std::atomic<uint64_t> alloc_count[MAX_ALLOC_ZONES + 1];
+    std::atomic<uint64_t> alloc_bytes[MAX_ALLOC_ZONES + 1];
+
+    ThreadRing() {
+        for (size_t i = 0; i <= MAX_ALLOC_ZONES; i++) {
+            alloc_count[i].store(0, std::memory_order_relaxed);
+            alloc_bytes[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void push(const Event& event) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= RING_EVENTS) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[h & (RING_EVENTS - 1)] = event;
+        head.store(h + 1, std::memory_order_release);
+    }
+};
+
+struct Zone {
+    std::string name;
+    double window_ms[WINDOW] = {};
+    size_t samples = 0;        // min(calls, WINDOW)
+    size_t next = 0;
+    uint64_t calls = 0;
+    double frame_ms = 0.0;     // This frame so far
+    uint32_t frame_calls = 0;
+    double last_frame_ms = 0.0;
+    uint32_t last_frame_calls = 0;
+    double smoothed_frame_ms = 0.0;
+    double max_ms = 0.0;
+    uint64_t allocations = 0;             // Heap allocations while innermost, ever
+    uint64_t last_frame_allocations = 0;
+    uint64_t last_frame_alloc_bytes = 0;
+};
+
+// Per-frame counter values written into traces
+struct CounterSample {
+    uint64_t ns;
+    uint64_t allocations;
+    uint64_t bytes;
+    uint64_t arena_bytes;
+};
+
+struct State {
+    std::mutex mutex;  // Zone and ring registration, draining; never taken by record()
+    std::vector<Zone> zones;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    bool tracing = false;
+    std::string trace_path;
+    uint64_t trace_start_ns = 0;
+    std::vector<Event> trace;
+    std::vector<CounterSample> trace_counters;
+    uint64_t trace_dropped = 0;
+
+    // Events drained this frame and the finished frame before it (flame view)
+    std::vector<Event> frame_events;
+    std::vector<Event> last_frame_events;
+    uint64_t frame_begin_ns = now_ns();
+    uint64_t last_frame_begin_ns = 0;
+    uint64_t last_frame_end_ns = 0;
+
+    // Allocation totals at the last end_frame(), to turn them into deltas
+    std::vector<uint64_t> alloc_seen_count;
+    std::vector<uint64_t> alloc_seen_bytes;
+    std::vector<uint64_t> alloc_sum_count;
+    std::vector<uint64_t> alloc_sum_bytes;
+    uint64_t unowned_seen_count = 0;
+    uint64_t unowned_seen_bytes = 0;
+    uint64_t arena_seen_allocations = 0;
+    uint64_t arena_seen_bytes = 0;
+    AllocationStats last_allocations;
+};
+
+inline State& state() {
+    static State instance;
+    return instance;
+}
+
+// Trivial, so the allocation hook can read it at any point of a thread's
+// life (before main, during thread exit)
+struct ThreadState {
+    ThreadRing* ring;
+    uint32_t zone;  // Innermost open ScopedSystemTimer
+};
+
+inline ThreadState& thread_state() {
+    static thread_local ThreadState instance{nullptr, NO_ZONE};
+    return instance;
+}
+
+// Allocations on threads without a ring (or while one is being leased)
+struct UnownedAllocations {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+inline UnownedAllocations& unowned_allocations() {
+    static UnownedAllocations instance;
+    return instance;
+}
+
+// Set by the EDEN_PROFILE_ALLOCATIONS translation unit
+inline std::atomic<bool>& allocation_hooks() {
+    static std::atomic<bool> installed{false};
+    return installed;
+}
+
+// Called from operator new: never locks and never allocates
+inline void count_allocation(size_t bytes) {
+    ThreadState& t = thread_state();
+    if (t.ring) {
+        size_t slot = t.zone < MAX_ALLOC_ZONES ? t.zone : MAX_ALLOC_ZONES;
+        add_relaxed(t.ring->alloc_count[slot], 1);
+        add_relaxed(t.ring->alloc_bytes[slot], bytes);
+    } else {
+        unowned_allocations().count.fetch_add(1, std::memory_order_relaxed);
+        unowned_allocations().bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+// Rings outlive their threads (undrained events stay readable); a thread
+// that exits hands its ring to the next new one
+struct RingLease {
+    ThreadRing* ring = nullptr;
+    ~RingLease() {
+        if (ring) {
+            thread_state().ring = nullptr;
+            ring->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+inline ThreadRing& local_ring() {
+    thread_local RingLease lease;
+    if (!lease.ring) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        for (auto& ring : s.rings) {
+            if (!ring->in_use.load(std::memory_order_acquire)) {
+                lease.ring = ring.get();
+                break;
+            }
+        }
+        if (!lease.ring) {
+            s.rings.push_back(std::unique_ptr<ThreadRing>(new ThreadRing()));
+            lease.ring = s.rings.back().get();
+            lease.ring->thread = static_cast<uint32_t>(s.rings.size() - 1);
+        }
+        lease.ring->in_use.store(true, std::memory_order_relaxed);
+        thread_state().ring = lease.ring;
+    }
+    return *lease.ring;
+}
+
+inline void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out << c;
+    }
+    out << '"';
+}
+
+} // namespace system_profiler_detail
+
+// Rolling timings of one zone (a system, hot function or kernel launch)
+struct SystemTiming {
+    std::string name;
+    double average_ms = 0.0;   // Per call, last WINDOW calls
+    double p99_ms = 0.0;       // Per call, last WINDOW calls
+    double max_ms = 0.0;       // Per call, ever
+    double frame_ms = 0.0;     // All calls in the last frame
+    double smoothed_frame_ms = 0.0;
+    uint32_t frame_calls = 0;
+    uint64_t calls = 0;
+    uint64_t frame_allocations = 0;   // Heap allocations in the last frame while
+    uint64_t frame_alloc_bytes = 0;   // this was the innermost zone
+    uint64_t allocations = 0;         // The same, ever
+};
+
+// The last finished frame's zones, for flame views
+struct ProfiledFrame {
+    uint64_t begin_ns = 0;
+    uint64_t end_ns = 0;
+    std::vector<std::string> zone_names;  // Indexed by Event::zone
+    std::vector<system_profiler_detail::Event> events;
+};
+
+/**
+ * Per-call timings for code built with `--profile`. Every call site gets a
+ * zone (registered once, behind a function-local static); a call costs two
+ * clock reads and a push into the calling thread's ring. end_frame() drains
+ * all rings on the frame thread - the generated frame loop calls it.
+ *
+ * Tracing: start_trace() (or EDEN_PROFILE_TRACE=<file> in the environment,
+ * which generated main() checks) keeps every drained event until
+ * stop_trace() writes them as Chrome trace JSON. Open it in
+ * chrome://tracing or Perfetto, or convert it with Tracy's import-chrome.
+ * Per-frame heap and frame-arena counters go into the trace too.
+ *
+ * Allocations: the one translation unit that defines EDEN_PROFILE_ALLOCATIONS
+ * before including this header (the generated main with --profile) replaces
+ * operator new/delete. Every allocation is then counted, with its size,
+ * against the thread's innermost open zone; end_frame() turns the counts
+ * into per-zone figures and allocations() adds FrameArena::totals().
+ *
+ * Usage:
+ *   void update(Query_Position& q) {
+ *       EDEN_PROFILE_SCOPE("update");
+ *       ...
+ *   }
+ *   float dt = EDEN_PROFILE_CALL("physics", step_physics(q, 0.016f));
+ *   int vkcore_begin_frame() { EDEN_PROFILE_API(); ... }  // zone named after the function
+ *   SystemProfiler::end_frame();          // once per frame
+ *   heidic_imgui_render_profiler_overlay();
+ */
+class SystemProfiler {
+public:
+    // Zone for a call site; names are copied
+    static uint32_t zone(const char* name) {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        for (size_t i = 0; i < s.zones.size(); i++) {
+            if (s.zones[i].name == name) return static_cast<uint32_t>(i);
+        }
+        s.zones.emplace_back();
+        s.zones.back().name = name;
+        return static_cast<uint32_t>(s.zones.size() - 1);
+    }
+
+    static void record(uint32_t zone, uint64_t begin_ns, uint64_t end_ns) {
+        auto& ring = system_profiler_detail::local_ring();
+        ring.push(system_profiler_detail::Event{zone, ring.thread, begin_ns, end_ns});
+    }
+
+    // Drain every thread's ring and close the frame's per-zone totals
+    static void end_frame() {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        drain(s);
+        for (auto& zone : s.zones) {
+            zone.last_frame_ms = zone.frame_ms;
+            zone.last_frame_calls = zone.frame_calls;
+            zone.smoothed_frame_ms += (zone.frame_ms - zone.smoothed_frame_ms) * system_profiler_detail::FRAME_SMOOTHING;
+            zone.frame_ms = 0.0;
+            zone.frame_calls = 0;
+        }
+        close_allocations(s);
+
+        uint64_t now = system_profiler_detail::now_ns();
+        s.last_frame_events.swap(s.frame_events);
+        s.frame_events.clear();
+        s.last_frame_begin_ns = s.frame_begin_ns;
+        s.last_frame_end_ns = now;
+        s.frame_begin_ns = now;
+        if (s.tracing) {
+            const AllocationStats& a = s.last_allocations;
+            s.trace_counters.push_back(system_profiler_detail::CounterSample{now, a.allocations, a.bytes, a.arena_bytes});
+        }
+    }
+
+    // Zones as of the last end_frame(), most expensive frame share first
+    static std::vector<SystemTiming> timings() {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        std::vector<SystemTiming> result;
+        result.reserve(s.zones.size());
+        std::vector<double> sorted;
+        for (const auto& zone : s.zones) {
+            SystemTiming timing;
+            timing.name = zone.name;
+            timing.calls = zone.calls;
+            timing.frame_ms = zone.last_frame_ms;
+            timing.frame_calls = zone.last_frame_calls;
+            timing.smoothed_frame_ms = zone.smoothed_frame_ms;
+            timing.max_ms = zone.max_ms;
+            timing.frame_allocations = zone.last_frame_allocations;
+            timing.frame_alloc_bytes = zone.last_frame_alloc_bytes;
+            timing.allocations = zone.allocations;
+            if (zone.samples > 0) {
+                sorted.assign(zone.window_ms, zone.window_ms + zone.samples);
+                double total = 0.0;
+                for (double ms : sorted) total += ms;
+                timing.average_ms = total / static_cast<double>(sorted.size());
+                size_t rank = (sorted.size() * 99 + 99) / 100 - 1;  // ceil(0.99 n) - 1
+                std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+                timing.p99_ms = sorted[rank];
+            }
+            result.push_back(timing);
+        }
+        std::sort(result.begin(), result.end(), [](const SystemTiming& a, const SystemTiming& b) {
+            return a.smoothed_frame_ms > b.smoothed_frame_ms;
+        });
+        return result;
+    }
+
+    // The last frame's allocation counters
+    static AllocationStats allocations() {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.last_allocations;
+    }
+
+    // A copy of the last finished frame's events (frame thread, after end_frame())
+    static ProfiledFrame last_frame() {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        ProfiledFrame frame;
+        frame.begin_ns = s.last_frame_begin_ns;
+        frame.end_ns = s.last_frame_end_ns;
+        frame.events = s.last_frame_events;
+        frame.zone_names.reserve(s.zones.size());
+        for (const auto& zone : s.zones) frame.zone_names.push_back(zone.name);
+        return frame;
+    }
+
+    // timings() as a text table (generated main() prints it at exit)
+    static void print(std::ostream& out) {
+        std::vector<SystemTiming> rows = timings();
+        if (rows.empty()) return;
+        bool allocs = system_profiler_detail::allocation_hooks().load(std::memory_order_relaxed);
+        out << "[Profiler] system                        calls   avg ms   p99 ms   max ms" << (allocs ? "     allocs\n" : "\n");
+        char line[192];
+        for (const auto& row : rows) {
+            int n = std::snprintf(line, sizeof(line), "[Profiler] %-28s %7llu %8.3f %8.3f %8.3f", row.name.c_str(),
+                                  static_cast<unsigned long long>(row.calls), row.average_ms, row.p99_ms, row.max_ms);
+            if (allocs && n > 0 && static_cast<size_t>(n) < sizeof(line)) {
+                std::snprintf(line + n, sizeof(line) - n, " %10llu", static_cast<unsigned long long>(row.allocations));
+            }
+            out << line << '\n';
+        }
+        out.flush();
+    }
+
+    // Events lost to full rings (a frame recorded more than RING_EVENTS)
+    static uint64_t dropped_events() {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        uint64_t dropped = s.trace_dropped;
+        for (const auto& ring : s.rings) dropped += ring->dropped.load(std::memory_order_relaxed);
+        return dropped;
+    }
+
+    // Keep every event from now until stop_trace() writes `path`
+    static void start_trace(const std::string& path) {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        drain(s);  // Earlier events are not part of the capture
+        s.tracing = true;
+        s.trace_path = path;
+        s.trace_start_ns = system_profiler_detail::now_ns();
+        s.trace.clear();
+        s.trace_counters.clear();
+        s.trace_dropped = 0;
+    }
+
+    // start_trace($EDEN_PROFILE_TRACE) if it is set
+    static void start_trace_from_env() {
+        const char* path = std::getenv("EDEN_PROFILE_TRACE");
+        if (path && *path) start_trace(path);
+    }
+
+    static bool tracing() {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.tracing;
+    }
+
+    // Write the capture (no-op without one); false if the file can't be written
+    static bool stop_trace() {
+        auto& s = system_profiler_detail::state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.tracing) return true;
+        drain(s);
+        s.tracing = false;
+
+        std::ofstream out(s.trace_path, std::ios::binary);
+        if (!out) {
+            std::cerr << "[Profiler] Could not write trace " << s.trace_path << std::endl;
+            return false;
+        }
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        const char* separator = "";
+        for (size_t t = 0; t < s.rings.size(); t++) {
+            out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+            separator = ",\n";
+        }
+        out.setf(std::ios::fixed);
+        out.precision(3);
+        for (const auto& event : s.trace) {
+            out << separator << "{\"name\":";
+            system_profiler_detail::write_json_string(out, s.zones[event.zone].name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                << ",\"ts\":" << static_cast<double>(event.begin_ns - s.trace_start_ns) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.end_ns - event.begin_ns) / 1000.0 << "}";
+            separator = ",\n";
+        }
+        // Counter tracks (Tracy imports them as plots)
+        bool allocs = system_profiler_detail::allocation_hooks().load(std::memory_order_relaxed);
+        for (const auto& sample : s.trace_counters) {
+            double ts = static_cast<double>(sample.ns - s.trace_start_ns) / 1000.0;
+            if (allocs) {
+                out << separator << "{\"name\":\"heap\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts
+                    << ",\"args\":{\"allocations\":" << sample.allocations
+                    << ",\"KB\":" << static_cast<double>(sample.bytes) / 1024.0 << "}}";
+                separator = ",\n";
+            }
+            out << separator << "{\"name\":\"frame arena KB\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts
+                << ",\"args\":{\"KB\":" << static_cast<double>(sample.arena_bytes) / 1024.0 << "}}";
+            separator = ",\n";
+        }
+        out << "\n]}\n";
+        std::cout << "[Profiler] Wrote " << s.trace.size() << " events to " << s.trace_path;
+        if (s.trace_dropped > 0) std::cout << " (" << s.trace_dropped << " over the capture limit dropped)";
+        std::cout << std::endl;
+        s.trace.clear();
+        s.trace.shrink_to_fit();
+        s.trace_counters.clear();
+        s.trace_counters.shrink_to_fit();
+        return static_cast<bool>(out);
+    }
+
+#ifdef USE_IMGUI
+    // Per-zone table: calls and time this frame, rolling average and p99 per
+    // call, and the frame's allocations while the zone was innermost
+    static void draw_imgui(bool* open = nullptr) {
+        ImGui::SetNextWindowPos(ImVec2(10, 170), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("System Timings", open, ImGuiWindowFlags_AlwaysAutoResize)) {
+            ImGui::End();
+            return;
+        }
+        std::vector<SystemTiming> rows = timings();
+        AllocationStats allocs = allocations();
+        uint64_t dropped = dropped_events();
+        if (dropped > 0) ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%llu events dropped", static_cast<unsigned long long>(dropped));
+        if (allocs.tracking) {
+            ImGui::Text("Heap: %llu allocations, %.1f KB (%llu outside zones)", static_cast<unsigned long long>(allocs.allocations),
+                        static_cast<double>(allocs.bytes) / 1024.0, static_cast<unsigned long long>(allocs.untagged_allocations));
+        } else {
+            ImGui::TextDisabled("Heap: not tracked (EDEN_PROFILE_ALLOCATIONS)");
+        }
+        ImGui::Text("Frame arenas: %llu allocations, %.1f KB; %.2f MB held by %zu", static_cast<unsigned long long>(allocs.arena_allocations),
+                    static_cast<double>(allocs.arena_bytes) / 1024.0, static_cast<double>(allocs.arena_capacity) / (1024.0 * 1024.0), allocs.arenas);
+        int columns = allocs.tracking ? 8 : 6;
+        if (ImGui::BeginTable("timings", columns, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+            ImGui::TableSetupColumn("System");
+            ImGui::TableSetupColumn("Calls");
+            ImGui::TableSetupColumn("Frame ms");
+            ImGui::TableSetupColumn("Avg ms");
+            ImGui::TableSetupColumn("p99 ms");
+            ImGui::TableSetupColumn("Max ms");
+            if (allocs.tracking) {
+                ImGui::TableSetupColumn("Allocs");
+                ImGui::TableSetupColumn("KB");
+            }
+            ImGui::TableHeadersRow();
+            for (const auto& row : rows) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(row.name.c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%u", row.frame_calls);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", row.smoothed_frame_ms);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", row.average_ms);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", row.p99_ms);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", row.max_ms);
+                if (allocs.tracking) {
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(row.frame_allocations));
+                    ImGui::TableNextColumn(); ImGui::Text("%.1f", static_cast<double>(row.frame_alloc_bytes) / 1024.0);
+                }
+            }
+            ImGui::EndTable();
+        }
+        bool capturing = tracing();
+        if (ImGui::Button(capturing ? "Stop trace" : "Start trace")) {
+            if (capturing) {
+                stop_trace();
+            } else {
+                start_trace("heidic_trace.json");
+            }
+        }
+        ImGui::End();
+    }
+
+    // The last frame as a flame graph: one lane per thread, nested zones
+    // stacked below their parents, hover for the duration
+    static void draw_flame_imgui(bool* open = nullptr) {
+        ImGui::SetNextWindowPos(ImVec2(10, 520), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowSize(ImVec2(760, 220), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Frame Flame", open)) {
+            ImGui::End();
+            return;
+        }
+        ProfiledFrame frame = last_frame();
+        if (frame.end_ns <= frame.begin_ns) {
+            ImGui::TextDisabled("No finished frame yet");
+            ImGui::End();
+            return;
+        }
+        ImGui::Text("Last frame: %.3f ms, %zu zones", static_cast<double>(frame.end_ns - frame.begin_ns) / 1e6, frame.events.size());
+
+        // Per thread, parents before their children
+        auto& events = frame.events;
+        std::sort(events.begin(), events.end(), [](const system_profiler_detail::Event& a, const system_profiler_detail::Event& b) {
+            if (a.thread != b.thread) return a.thread < b.thread;
+            if (a.begin_ns != b.begin_ns) return a.begin_ns < b.begin_ns;
+            return a.end_ns > b.end_ns;
+        });
+
+        ImDrawList* draw = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+        float row = ImGui::GetTextLineHeightWithSpacing();
+        double scale = width / static_cast<double>(frame.end_ns - frame.begin_ns);
+        float y = origin.y;
+        std::vector<uint64_t> open_ends;
+        char label[32];
+        for (size_t i = 0; i < events.size();) {
+            uint32_t thread = events[i].thread;
+            std::snprintf(label, sizeof(label), "thread %u", thread);
+            draw->AddText(ImVec2(origin.x, y), ImGui::GetColorU32(ImGuiCol_TextDisabled), label);
+            y += row;
+            open_ends.clear();
+            size_t depth_count = 0;
+            for (; i < events.size() && events[i].thread == thread; i++) {
+                const auto& event = events[i];
+                while (!open_ends.empty() && open_ends.back() <= event.begin_ns) open_ends.pop_back();
+                size_t depth = open_ends.size();
+                open_ends.push_back(event.end_ns);
+                depth_count = std::max(depth_count, depth + 1);
+
+                uint64_t begin = std::max(event.begin_ns, frame.begin_ns);
+                uint64_t end = std::min(event.end_ns, frame.end_ns);
+                if (end <= begin) continue;
+                ImVec2 min(origin.x + static_cast<float>((begin - frame.begin_ns) * scale), y + depth * row);
+                ImVec2 max(origin.x + static_cast<float>((end - frame.begin_ns) * scale), min.y + row - 1.0f);
+                max.x = std::max(max.x, min.x + 1.0f);
+                float hue = static_cast<float>(std::fmod(event.zone * 0.618034, 1.0));  // Golden-ratio spread
+                draw->AddRectFilled(min, max, ImColor::HSV(hue, 0.45f, 0.85f));
+                const char* name = frame.zone_names[event.zone].c_str();
+                if (max.x - min.x > 8.0f) {
+                    draw->PushClipRect(min, max, true);
+                    draw->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), name);
+                    draw->PopClipRect();
+                }
+                if (ImGui::IsMouseHoveringRect(min, max)) {
+                    ImGui::SetTooltip("%s\n%.3f ms", name, static_cast<double>(event.end_ns - event.begin_ns) / 1e6);
+                }
+            }
+            y += depth_count * row + row * 0.5f;
+        }
+        ImGui::Dummy(ImVec2(width, y - origin.y));
+        ImGui::End();
+    }
+#endif
+
+private:
+    // Caller holds the mutex
+    static void drain(system_profiler_detail::State& s) {
+        for (auto& ring : s.rings) {
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; tail++) {
+                const auto& event = ring->events[tail & (system_profiler_detail::RING_EVENTS - 1)];
+                add_sample(s.zones[event.zone], static_cast<double>(event.end_ns - event.begin_ns) / 1e6);
+                if (s.frame_events.size() < system_profiler_detail::MAX_FLAME_EVENTS) s.frame_events.push_back(event);
+                if (s.tracing && event.begin_ns >= s.trace_start_ns) {
+                    if (s.trace.size() < system_profiler_detail::MAX_TRACE_EVENTS) {
+                        s.trace.push_back(event);
+                    } else {
+                        s.trace_dropped++;
+                    }
+                }
+            }
+            ring->tail.store(tail, std::memory_order_release);
+        }
+    }
+
+    // Caller holds the mutex. Sums every ring's running allocation totals and
+    // keeps this frame's share; scratch vectors are reused so the profiler
+    // itself allocates nothing here once running.
+    static void close_allocations(system_profiler_detail::State& s) {
+        using system_profiler_detail::MAX_ALLOC_ZONES;
+        if (s.alloc_seen_count.empty()) {
+            s.alloc_seen_count.assign(MAX_ALLOC_ZONES + 1, 0);
+            s.alloc_seen_bytes.assign(MAX_ALLOC_ZONES + 1, 0);
+            s.alloc_sum_count.assign(MAX_ALLOC_ZONES + 1, 0);
+            s.alloc_sum_bytes.assign(MAX_ALLOC_ZONES + 1, 0);
+        }
+        std::fill(s.alloc_sum_count.begin(), s.alloc_sum_count.end(), 0);
+        std::fill(s.alloc_sum_bytes.begin(), s.alloc_sum_bytes.end(), 0);
+        for (const auto& ring : s.rings) {
+            for (size_t slot = 0; slot <= MAX_ALLOC_ZONES; slot++) {
+                s.alloc_sum_count[slot] += ring->alloc_count[slot].load(std::memory_order_relaxed);
+                s.alloc_sum_bytes[slot] += ring->alloc_bytes[slot].load(std::memory_order_relaxed);
+            }
+        }
+
+        AllocationStats stats;
+        stats.tracking = system_profiler_detail::allocation_hooks().load(std::memory_order_relaxed);
+        for (auto& zone : s.zones) {
+            zone.last_frame_allocations = 0;
+            zone.last_frame_alloc_bytes = 0;
+        }
+        for (size_t slot = 0; slot <= MAX_ALLOC_ZONES; slot++) {
+            uint64_t count = s.alloc_sum_count[slot] - s.alloc_seen_count[slot];
+            uint64_t bytes = s.alloc_sum_bytes[slot] - s.alloc_seen_bytes[slot];
+            s.alloc_seen_count[slot] = s.alloc_sum_count[slot];
+            s.alloc_seen_bytes[slot] = s.alloc_sum_bytes[slot];
+            stats.allocations += count;
+            stats.bytes += bytes;
+            if (slot < MAX_ALLOC_ZONES && slot < s.zones.size()) {
+                s.zones[slot].last_frame_allocations = count;
+                s.zones[slot].last_frame_alloc_bytes = bytes;
+                s.zones[slot].allocations += count;
+            } else {
+                stats.untagged_allocations += count;
+                stats.untagged_bytes += bytes;
+            }
+        }
+        auto& unowned = system_profiler_detail::unowned_allocations();
+        uint64_t unowned_count = unowned.count.load(std::memory_order_relaxed);
+        uint64_t unowned_bytes = unowned.bytes.load(std::memory_order_relaxed);
+        stats.allocations += unowned_count - s.unowned_seen_count;
+        stats.bytes += unowned_bytes - s.unowned_seen_bytes;
+        stats.untagged_allocations += unowned_count - s.unowned_seen_count;
+        stats.untagged_bytes += unowned_bytes - s.unowned_seen_bytes;
+        s.unowned_seen_count = unowned_count;
+        s.unowned_seen_bytes = unowned_bytes;
+
+        FrameArenaTotals arenas = FrameArena::totals();
+        stats.arena_allocations = arenas.allocations - s.arena_seen_allocations;
+        stats.arena_bytes = arenas.bytes - s.arena_seen_bytes;
+        stats.arena_capacity = arenas.capacity;
+        stats.arenas = arenas.arenas;
+        s.arena_seen_allocations = arenas.allocations;
+        s.arena_seen_bytes = arenas.bytes;
+        s.last_allocations = stats;
+    }
+
+    static void add_sample(system_profiler_detail::Zone& zone, double ms) {
+        zone.window_ms[zone.next] = ms;
+        zone.next = (zone.next + 1) % system_profiler_detail::WINDOW;
+        zone.samples = std::min(zone.samples + 1, system_profiler_detail::WINDOW);
+        zone.calls++;
+        zone.frame_ms += ms;
+        zone.frame_calls++;
+        zone.max_ms = std::max(zone.max_ms, ms);
+    }
+};
+
+// Records [construction, destruction) into the thread's ring; allocations
+// in between count against the zone unless a nested timer is open
+class ScopedSystemTimer {
+public:
+    explicit ScopedSystemTimer(uint32_t zone)
+        : ring(system_profiler_detail::local_ring()), zone(zone), outer(system_profiler_detail::thread_state().zone) {
+        system_profiler_detail::thread_state().zone = zone;
+        begin_ns = system_profiler_detail::now_ns();
+    }
+
+    ~ScopedSystemTimer() {
+        uint64_t end_ns = system_profiler_detail::now_ns();
+        system_profiler_detail::thread_state().zone = outer;
+        ring.push(system_profiler_detail::Event{zone, ring.thread, begin_ns, end_ns});
+    }
+
+    ScopedSystemTimer(const ScopedSystemTimer&) = delete;
+    ScopedSystemTimer& operator=(const ScopedSystemTimer&) = delete;
+
+private:
+    system_profiler_detail::ThreadRing& ring;
+    uint32_t zone;
+    uint32_t outer;
+    uint64_t begin_ns = 0;
+};
+
+#define EDEN_PROFILE_CONCAT_(a, b) a##b
+#define EDEN_PROFILE_CONCAT(a, b) EDEN_PROFILE_CONCAT_(a, b)
+
+// Times the rest of the enclosing scope
+#define EDEN_PROFILE_SCOPE(name)                                                                       \
+    static const uint32_t EDEN_PROFILE_CONCAT(eden_profile_zone_, __LINE__) = SystemProfiler::zone(name); \
+    ScopedSystemTimer EDEN_PROFILE_CONCAT(eden_profile_timer_, __LINE__)(EDEN_PROFILE_CONCAT(eden_profile_zone_, __LINE__))
+
+// Times one call inside an expression and yields its result (or void)
+#define EDEN_PROFILE_CALL(name, ...) ([&]() -> decltype(auto) { EDEN_PROFILE_SCOPE(name); return __VA_ARGS__; }())
+
+// Times an engine C API entry point (vkcore_*, lighting_*, facial_*) under
+// its function name. Compiles to nothing unless EDEN_PROFILE_SYSTEMS is
+// defined for that translation unit (ELECTROSCRIBE passes it with profile_systems=1).
+#ifdef EDEN_PROFILE_SYSTEMS
+#define EDEN_PROFILE_API() EDEN_PROFILE_SCOPE(__func__)
+#else
+#define EDEN_PROFILE_API() ((void)0)
+#endif
+
+#endif // EDEN_SYSTEM_PROFILER_H
+
+// ----------------------------------------------------------------------------
+// Allocation hooks: replacement operator new/delete, compiled into the one
+// translation unit that defines EDEN_PROFILE_ALLOCATIONS (before including
+// this header). Outside the include guard so a later include still works.
+// ----------------------------------------------------------------------------
+#if defined(EDEN_PROFILE_ALLOCATIONS) && !defined(EDEN_PROFILE_ALLOCATION_HOOKS_DEFINED)
+#define EDEN_PROFILE_ALLOCATION_HOOKS_DEFINED
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Keeps GCC from pairing an inlined `new` with free() (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+#define EDEN_PROFILE_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define EDEN_PROFILE_NOINLINE __declspec(noinline)
+#else
+#define EDEN_PROFILE_NOINLINE
+#endif
+
+namespace system_profiler_detail {
+
+static const bool allocation_hooks_registered = (allocation_hooks().store(true, std::memory_order_relaxed), true);
+
+EDEN_PROFILE_NOINLINE void* hooked_malloc(std::size_t size, std::size_t align) {
+    if (size == 0) size = 1;
+    for (;;) {
+        void* ptr = nullptr;
+        if (align <= alignof(std::max_align_t)) {
+            ptr = std::malloc(size);
+        } else {
+#ifdef _WIN32
+            ptr = _aligned_malloc(size, align);
+#else
+            if (posix_memalign(&ptr, align, size) != 0) ptr = nullptr;
+#endif
+        }
+        if (ptr) {
+            count_allocation(size);
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+EDEN_PROFILE_NOINLINE void hooked_free(void* ptr, std::size_t align) {
+#ifdef _WIN32
+    if (align > alignof(std::max_align_t)) {
+        _aligned_free(ptr);
+        return;
+    }
+#else
+    (void)align;
+#endif
+    std::free(ptr);
+}
+
+} // namespace system_profiler_detail
+
+void* operator new(std::size_t size) { return system_profiler_detail::hooked_malloc(size, 0); }
+void* operator new[](std::size_t size) { return system_profiler_detail::hooked_malloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    return system_profiler_detail::hooked_malloc(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return system_profiler_detail::hooked_malloc(size, static_cast<std::size_t>(align));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return system_profiler_detail::hooked_malloc(size, 0); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return system_profiler_detail::hooked_malloc(size, 0); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return system_profiler_detail::hooked_malloc(size, static_cast<std::size_t>(align)); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return system_profiler_detail::hooked_malloc(size, static_cast<std::size_t>(align)); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { system_profiler_detail::hooked_free(ptr, 0); }
+void operator delete[](void* ptr) noexcept { system_profiler_detail::hooked_free(ptr, 0); }
+void operator delete(void* ptr, std::size_t) noexcept { system_profiler_detail::hooked_free(ptr, 0); }
+void operator delete[](void* ptr, std::size_t) noexcept { system_profiler_detail::hooked_free(ptr, 0); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { system_profiler_detail::hooked_free(ptr, 0); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { system_profiler_detail::hooked_free(ptr, 0); }
+void operator delete(void* ptr, std::align_val_t align) noexcept {
+    system_profiler_detail::hooked_free(ptr, static_cast<std::size_t>(align));
+}
+void operator delete[](void* ptr, std::align_val_t align) noexcept {
+    system_profiler_detail::hooked_free(ptr, static_cast<std::size_t>(align));
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept {
+    system_profiler_detail::hooked_free(ptr, static_cast<std::size_t>(align));
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t align) noexcept {
+    system_profiler_detail::hooked_free(ptr, static_cast<std::size_t>(align));
+}
+void operator delete(void* ptr, std::align_val_t align, const std::nothrow_t&) noexcept {
+    system_profiler_detail::hooked_free(ptr, static_cast<std::size_t>(align));
+}
+void operator delete[](void* ptr, std::align_val_t align, const std::nothrow_t&) noexcept {
+    system_profiler_detail::hooked_free(ptr, static_cast<std::size_t>(align));
+}
+
+#endif // EDEN_PROFILE_ALLOCATIONS
@@ -0,0 +1,292 @@
+// EDEN ENGINE - System Scheduler
+// Runs ECS systems concurrently on the job system, ordered by a dependency
+// graph built every frame from each system's component reads and writes
+
+#ifndef EDEN_SYSTEM_SCHEDULER_H
+#define EDEN_SYSTEM_SCHEDULER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <typeinfo>
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <cstdint>
+#include <cstddef>
+
+#include "component_registry.h"
+#include "job_system.h"
+
+// Built with `heidic_v2 compile --profile`: systems also show up in SystemProfiler
+#ifdef EDEN_PROFILE_SYSTEMS
+#include "system_profiler.h"
+#endif
+
+#ifdef USE_IMGUI
+#include "imgui.h"
+#endif
+
+/**
+ * Components a system reads and writes. The codegen emits one per system
+ * function from its query parameters (system_access_<name>()); systems that
+ * touch state outside the ECS are exclusive and run alone.
+ */
+struct SystemAccess {
+    std::vector<uint32_t> reads;   // component_index<T>(), sorted
+    std::vector<uint32_t> writes;  // Doubles as a read
+    std::vector<const char*> read_names, write_names;  // For the debug view
+    bool exclusive = false;
+
+    template <typename T>
+    SystemAccess& read(const char* name = typeid(T).name()) {
+        add(reads, component_index<T>());
+        read_names.push_back(name);
+        return *this;
+    }
+
+    template <typename T>
+    SystemAccess& write(const char* name = typeid(T).name()) {
+        add(writes, component_index<T>());
+        write_names.push_back(name);
+        return *this;
+    }
+
+    static SystemAccess exclusive_access() {
+        SystemAccess access;
+        access.exclusive = true;
+        return access;
+    }
+
+    // Two systems may overlap unless one writes what the other touches
+    bool conflicts(const SystemAccess& other) const {
+        if (exclusive || other.exclusive) return true;
+        return overlaps(writes, other.writes) || overlaps(writes, other.reads) || overlaps(reads, other.writes);
+    }
+
+private:
+    static void add(std::vector<uint32_t>& set, uint32_t index) {
+        auto it = std::lower_bound(set.begin(), set.end(), index);
+        if (it == set.end() || *it != index) set.insert(it, index);
+    }
+
+    static bool overlaps(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+        size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (a[i] == b[j]) return true;
+            if (a[i] < b[j]) i++; else j++;
+        }
+        return false;
+    }
+};
+
+/** Last frame's numbers for one system */
+struct SystemStats {
+    double last_ms = 0.0;     // Wall time of its last run
+    double average_ms = 0.0;  // Exponential moving average
+    double start_ms = 0.0;    // When it started, from the frame's start
+    uint64_t runs = 0;
+};
+
+/**
+ * Systems are added once, in program order. Each run() orders every
+ * conflicting pair the way they were added and dispatches the rest as soon
+ * as their predecessors finish, so independent systems overlap across cores.
+ *
+ * Usage:
+ *   SystemScheduler scheduler;
+ *   scheduler.add("update_physics", system_access_update_physics(), [&] { update_physics(q); });
+ *   scheduler.add("render", SystemAccess::exclusive_access(), [&] { render(); });
+ *   scheduler.run();                 // once per frame
+ *   scheduler.print_graph(std::cout);
+ */
+class SystemScheduler {
+public:
+    explicit SystemScheduler(JobSystem& jobs = JobSystem::shared()) : jobs(jobs) {}
+
+    // Returns the system's index (for set_enabled() and stats())
+    size_t add(std::string name, SystemAccess access, std::function<void()> run) {
+        systems.push_back(System{std::move(name), std::move(access), std::move(run), true, {}, {}, SystemStats()});
+#ifdef EDEN_PROFILE_SYSTEMS
+        systems.back().profile_zone = SystemProfiler::zone(systems.back().name.c_str());
+#endif
+        return systems.size() - 1;
+    }
+
+    // Disabled systems drop out of the next frame's graph
+    void set_enabled(size_t index, bool enabled) { systems[index].enabled = enabled; }
+
+    // One frame: rebuild the graph, run it, return when everything finished.
+    // The first exception a system throws is rethrown here; systems that
+    // depend on it are skipped for the frame.
+    void run() {
+        build_graph();
+        frame_start = std::chrono::steady_clock::now();
+        remaining.reset(new std::atomic<uint32_t>[systems.size()]);
+        for (size_t i = 0; i < systems.size(); i++) remaining[i].store(static_cast<uint32_t>(systems[i].deps.size()), std::memory_order_relaxed);
+
+        {
+            TaskGroup group(jobs);
+            for (size_t i = 0; i < systems.size(); i++) {
+                if (systems[i].enabled && systems[i].deps.empty()) launch(group, i);
+            }
+            group.wait();
+        }
+        frame_ms = ms_since(frame_start);
+    }
+
+    const SystemStats& stats(size_t index) const { return systems[index].stats; }
+    size_t system_count() const { return systems.size(); }
+    double last_frame_ms() const { return frame_ms; }
+
+    // Sum of system times over the frame's wall time: about how many
+    // cores the graph kept busy
+    double parallelism() const {
+        double total = 0.0;
+        for (const auto& system : systems) {
+            if (system.enabled) total += system.stats.last_ms;
+        }
+        return frame_ms > 0.0 ? total / frame_ms : 0.0;
+    }
+
+    // Last graph as text: each system, what it touches, what it waits for
+    void print_graph(std::ostream& out) const {
+        out << "[SystemScheduler] " << systems.size() << " systems, " << frame_ms << " ms, x"
+            << parallelism() << " parallel\n";
+        for (const auto& system : systems) {
+            out << "  " << system.name << (system.enabled ? "" : " (disabled)") << "  " << system.stats.last_ms
+                << " ms @" << system.stats.start_ms << "\n    " << describe(system.access) << "\n";
+            if (!system.deps.empty()) {
+                out << "    after:";
+                for (size_t dep : system.deps) out << " " << systems[dep].name;
+                out << "\n";
+            }
+        }
+    }
+
+    // Last graph in Graphviz dot
+    std::string graph_dot() const {
+        std::ostringstream out;
+        out << "digraph systems {\n  node [shape=box];\n";
+        for (size_t i = 0; i < systems.size(); i++) {
+            out << "  s" << i << " [label=\"" << systems[i].name << "\\n" << systems[i].stats.last_ms << " ms\"];\n";
+            for (size_t dep : systems[i].deps) out << "  s" << dep << " -> s" << i << ";\n";
+        }
+        out << "}\n";
+        return out.str();
+    }
+
+#ifdef USE_IMGUI
+    // Per-system bars on the frame's timeline, and their dependencies
+    void draw_imgui(bool* open = nullptr) const {
+        if (!ImGui::Begin("Systems", open)) {
+            ImGui::End();
+            return;
+        }
+        ImGui::Text("Frame: %.3f ms, %.2fx parallel, %u threads", frame_ms, parallelism(), jobs.thread_count());
+        ImGui::Separator();
+        float width = ImGui::GetContentRegionAvail().x * 0.5f;
+        double scale = frame_ms > 0.0 ? width / frame_ms : 0.0;
+        for (const auto& system : systems) {
+            ImGui::PushID(&system);
+            ImGui::Text("%-24s %7.3f ms (avg %.3f)", system.name.c_str(), system.stats.last_ms, system.stats.average_ms);
+            ImGui::SameLine();
+            ImGui::Dummy(ImVec2(static_cast<float>(system.stats.start_ms * scale), 1.0f));
+            ImGui::SameLine(0.0f, 0.0f);
+            ImGui::Button("##bar", ImVec2(std::max(2.0f, static_cast<float>(system.stats.last_ms * scale)), 0.0f));
+            if (ImGui::IsItemHovered()) {
+                std::string tip = describe(system.access);
+                if (!system.deps.empty()) {
+                    tip += "\nafter:";
+                    for (size_t dep : system.deps) tip += " " + systems[dep].name;
+                }
+                ImGui::SetTooltip("%s", tip.c_str());
+            }
+            ImGui::PopID();
+        }
+        ImGui::End();
+    }
+#endif
+
+private:
+    struct System {
+        std::string name;
+        SystemAccess access;
+        std::function<void()> run;
+        bool enabled;
+        std::vector<size_t> deps;        // Direct predecessors this frame
+        std::vector<size_t> dependents;
+        SystemStats stats;
+        uint32_t profile_zone = 0;       // SystemProfiler zone, with EDEN_PROFILE_SYSTEMS
+    };
+
+    JobSystem& jobs;
+    std::vector<System> systems;
+    std::unique_ptr<std::atomic<uint32_t>[]> remaining;  // Unfinished predecessors, per system
+    std::chrono::steady_clock::time_point frame_start;
+    double frame_ms = 0.0;
+
+    static double ms_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static std::string describe(const SystemAccess& access) {
+        if (access.exclusive) return "exclusive";
+        std::string text = "reads:";
+        for (const char* name : access.read_names) text += std::string(" ") + name;
+        text += "  writes:";
+        for (const char* name : access.write_names) text += std::string(" ") + name;
+        return text;
+    }
+
+    // j waits for i < j when they conflict, unless that order already
+    // follows from j's other predecessors (keeps the graph readable)
+    void build_graph() {
+        for (auto& system : systems) {
+            system.deps.clear();
+            system.dependents.clear();
+        }
+        std::vector<std::vector<bool>> reaches(systems.size());  // reaches[j][i]: i runs before j
+        for (size_t j = 0; j < systems.size(); j++) {
+            reaches[j].assign(systems.size(), false);
+            if (!systems[j].enabled) continue;
+            for (size_t i = j; i-- > 0;) {
+                if (!systems[i].enabled || reaches[j][i]) continue;
+                if (!systems[i].access.conflicts(systems[j].access)) continue;
+                systems[j].deps.push_back(i);
+                systems[i].dependents.push_back(j);
+                reaches[j][i] = true;
+                for (size_t k = 0; k < i; k++) {
+                    if (reaches[i][k]) reaches[j][k] = true;
+                }
+            }
+            std::reverse(systems[j].deps.begin(), systems[j].deps.end());
+        }
+    }
+
+    void launch(TaskGroup& group, size_t index) {
+        group.run([this, &group, index]() {
+            System& system = systems[index];
+            auto start = std::chrono::steady_clock::now();
+            {
+#ifdef EDEN_PROFILE_SYSTEMS
+                ScopedSystemTimer timer(system.profile_zone);
+#endif
+                system.run();
+            }
+            double elapsed = ms_since(start);
+            system.stats.start_ms = std::chrono::duration<double, std::milli>(start - frame_start).count();
+            system.stats.last_ms = elapsed;
+            system.stats.average_ms = system.stats.runs == 0 ? elapsed : system.stats.average_ms * 0.9 + elapsed * 0.1;
+            system.stats.runs++;
+            for (size_t next : system.dependents) {
+                if (remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1) launch(group, next);
+            }
+        });
+    }
+};
+
+#endif // EDEN_SYSTEM_SCHEDULER_H
@@ -1,5 +1,5 @@
 // EDEN ENGINE - TextureResource Class
-// Unified texture loading: automatically handles DDS (compressed) and PNG (uncompressed)
+// Unified texture loading: automatically handles DDS/KTX2 (compressed) and PNG (uncompressed)
 // Creates Vulkan resources (image, view, sampler) ready for use in shaders
 
 #ifndef EDEN_TEXTURE_RESOURCE_H
@@ -7,12 +7,16 @@
 
 #include "vulkan.h"
 #include "dds_loader.h"
+#include "ktx2_loader.h"
 #include "png_loader.h"
+#include "vfs.h"
+#include "../vulkan/core/gpu_allocator.h"
+#include "../vulkan/core/mip_chain.h"
+#include "../vulkan/core/upload_batch.h"
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <cstring>
-#include <fstream>
 
 // Forward declarations (these will be provided by Vulkan helpers or passed as parameters)
 // For now, we'll assume they're globally accessible or we'll add parameters later
@@ -24,15 +28,31 @@ extern VkQueue g_graphicsQueue;
 /**
  * TextureResource - Unified texture loading and Vulkan resource management
  * 
- * Automatically detects format (DDS vs PNG) and creates appropriate Vulkan resources.
- * Handles both compressed (DDS) and uncompressed (PNG) textures seamlessly.
+ * Automatically detects format (DDS, KTX2 or PNG) and creates appropriate Vulkan resources.
+ * Handles both compressed (DDS, KTX2 from vulkan/tools/texture_cook) and uncompressed
+ * (PNG) textures seamlessly.
+ * 
+ * Loading is two-phase for Resource<T>'s async mode: decode() reads and
+ * decodes the file and may run on any thread; the Decoded constructor
+ * creates and uploads the Vulkan objects on the render thread.
  */
 class TextureResource {
+public:
+    // CPU-side result of decode()
+    struct Decoded {
+        enum class Kind { DDS, KTX2, PNG };
+        Kind kind = Kind::PNG;
+        DDSData dds;
+        KTX2Data ktx2;
+        PNGData png;
+        bool generateMips = true;
+    };
+    
 private:
     VkImage m_image = VK_NULL_HANDLE;
     VkImageView m_imageView = VK_NULL_HANDLE;
     VkSampler m_sampler = VK_NULL_HANDLE;
-    VkDeviceMemory m_imageMemory = VK_NULL_HANDLE;
+    vkcore::GpuAllocation m_imageAlloc;
     
     VkFormat m_format = VK_FORMAT_UNDEFINED;
     uint32_t m_width = 0;
@@ -40,93 +60,31 @@ private:
     uint32_t m_mipmapCount = 1;
     
     bool m_loaded = false;
+    vkcore::UploadBatch::Ticket m_uploadTicket = vkcore::UploadBatch::NO_UPLOAD;
     
-    // Helper function to find memory type (same as in vulkan helpers)
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(g_physicalDevice, &memProperties);
-        
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-            if ((typeFilter & (1 << i)) && 
-                (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-                return i;
-            }
-        }
-        
-        return UINT32_MAX;
-    }
-    
-    // Helper to begin single-time command buffer
-    VkCommandBuffer beginSingleTimeCommands() {
-        VkCommandBufferAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = g_commandPool;
-        allocInfo.commandBufferCount = 1;
-        
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(g_device, &allocInfo, &commandBuffer);
-        
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-        
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
-        return commandBuffer;
+    // Shared sub-allocator (same as in vulkan helpers)
+    static vkcore::GpuAllocator& gpuAllocator() {
+        return vkcore::GpuAllocator::shared(g_device, g_physicalDevice);
     }
     
-    // Helper to end single-time command buffer
-    void endSingleTimeCommands(VkCommandBuffer commandBuffer) {
-        vkEndCommandBuffer(commandBuffer);
-        
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
-        
-        vkQueueSubmit(g_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(g_graphicsQueue);
-        
-        vkFreeCommandBuffers(g_device, g_commandPool, 1, &commandBuffer);
+    // Shared upload batch (bound by the vulkan helpers). Textures loaded
+    // between vkcore::UploadBatch::shared().begin()/end() go out in one
+    // submission.
+    static vkcore::UploadBatch& uploads() {
+        return vkcore::UploadBatch::shared();
     }
     
     // Create buffer helper (for staging)
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, 
                      VkMemoryPropertyFlags properties, VkBuffer& buffer, 
-                     VkDeviceMemory& bufferMemory) {
-        VkBufferCreateInfo bufferInfo = {};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = size;
-        bufferInfo.usage = usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        
-        if (vkCreateBuffer(g_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+                     vkcore::GpuAllocation& alloc) {
+        if (!gpuAllocator().createBuffer(size, usage, properties, buffer, alloc)) {
             throw std::runtime_error("Failed to create buffer");
         }
-        
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(g_device, buffer, &memRequirements);
-        
-        VkMemoryAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-        
-        if (allocInfo.memoryTypeIndex == UINT32_MAX) {
-            vkDestroyBuffer(g_device, buffer, nullptr);
-            throw std::runtime_error("Failed to find suitable memory type for buffer");
-        }
-        
-        if (vkAllocateMemory(g_device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-            vkDestroyBuffer(g_device, buffer, nullptr);
-            throw std::runtime_error("Failed to allocate buffer memory");
-        }
-        
-        vkBindBufferMemory(g_device, buffer, bufferMemory, 0);
     }
     
     // Detect file format from extension or magic number
-    bool isDDS(const std::string& filepath) {
+    static bool isDDS(const std::string& filepath) {
         // Check extension first (fast)
         std::string lowerPath = filepath;
         std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ::tolower);
@@ -140,29 +98,14 @@ private:
         return false;
     }
     
-    // Load DDS texture and create Vulkan resources
-    void loadDDS(const std::string& filepath) {
-        // Check if file exists first for better error message
-        std::ifstream testFile(filepath, std::ios::binary);
-        if (!testFile.is_open()) {
-            throw std::runtime_error("DDS file not found or cannot open: " + filepath + 
-                                    " (check path is relative to executable or use absolute path)");
-        }
-        testFile.close();
-        
-        DDSData ddsData = load_dds(filepath);
-        
-        if (ddsData.format == VK_FORMAT_UNDEFINED) {
-            throw std::runtime_error("Failed to load DDS file: " + filepath + 
-                                    " (file exists but is invalid or unsupported format)");
-        }
-        
-        m_format = ddsData.format;
-        m_width = ddsData.width;
-        m_height = ddsData.height;
-        m_mipmapCount = ddsData.mipmapCount;
-        
-        // Create Vulkan image
+    static bool isKTX2(const std::string& filepath) {
+        std::string lowerPath = filepath;
+        std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ::tolower);
+        return lowerPath.length() >= 5 && lowerPath.substr(lowerPath.length() - 5) == ".ktx2";
+    }
+    
+    // Image for pre-encoded levels (DDS/KTX2): copied as-is, no blits
+    void createCompressedImage() {
         VkImageCreateInfo imageInfo = {};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -178,107 +121,89 @@ private:
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         
-        if (vkCreateImage(g_device, &imageInfo, nullptr, &m_image) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create DDS image");
-        }
-        
-        // Allocate image memory
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(g_device, m_image, &memRequirements);
-        
-        VkMemoryAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, 
-                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        
-        if (allocInfo.memoryTypeIndex == UINT32_MAX) {
-            vkDestroyImage(g_device, m_image, nullptr);
-            throw std::runtime_error("Failed to find suitable memory type for DDS image");
+        if (!gpuAllocator().createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageAlloc)) {
+            throw std::runtime_error("Failed to create compressed image");
         }
-        
-        if (vkAllocateMemory(g_device, &allocInfo, nullptr, &m_imageMemory) != VK_SUCCESS) {
-            vkDestroyImage(g_device, m_image, nullptr);
-            throw std::runtime_error("Failed to allocate DDS image memory");
+    }
+    
+    // Read and validate a DDS texture (any thread)
+    static DDSData decodeDDS(const std::string& filepath) {
+        // Check if file exists first for better error message
+        if (!Vfs::shared().exists(filepath)) {
+            throw std::runtime_error("DDS file not found or cannot open: " + filepath + 
+                                    " (check path is relative to executable or use absolute path)");
         }
         
-        vkBindImageMemory(g_device, m_image, m_imageMemory, 0);
-        
-        // Create staging buffer for compressed data
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
-        createBuffer(ddsData.compressedData.size(), 
-                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                    stagingBuffer, stagingBufferMemory);
-        
-        // Copy compressed data to staging buffer
-        void* data;
-        vkMapMemory(g_device, stagingBufferMemory, 0, ddsData.compressedData.size(), 0, &data);
-        memcpy(data, ddsData.compressedData.data(), ddsData.compressedData.size());
-        vkUnmapMemory(g_device, stagingBufferMemory);
-        
-        // Upload to GPU
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-        
-        // Transition to transfer destination
-        VkImageMemoryBarrier barrier = {};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = m_image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = m_mipmapCount;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 
-                            VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-        
-        // Copy buffer to image (compressed blocks)
-        VkBufferImageCopy region = {};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {m_width, m_height, 1};
-        
-        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, m_image, 
-                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-        
-        // Transition to shader-readable
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        DDSData ddsData = load_dds(filepath);
         
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, 
-                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        if (ddsData.format == VK_FORMAT_UNDEFINED) {
+            throw std::runtime_error("Failed to load DDS file: " + filepath + 
+                                    " (file exists but is invalid or unsupported format)");
+        }
+        return ddsData;
+    }
+    
+    // Create Vulkan resources for a decoded DDS texture
+    void uploadDDS(const DDSData& ddsData) {
+        m_format = ddsData.format;
+        m_width = ddsData.width;
+        m_height = ddsData.height;
+        m_mipmapCount = ddsData.mipmapCount;
         
-        endSingleTimeCommands(commandBuffer);
+        createCompressedImage();
         
-        // Cleanup staging buffer
-        vkDestroyBuffer(g_device, stagingBuffer, nullptr);
-        vkFreeMemory(g_device, stagingBufferMemory, nullptr);
+        // One copy region per mip level (compressed blocks); every level
+        // ends shader-readable
+        std::vector<VkBufferImageCopy> regions = dds_copy_regions(ddsData);
+        m_uploadTicket = uploads().uploadImageMips(m_image, ddsData.compressedData.data(),
+                                                   ddsData.compressedData.size(), regions.data(),
+                                                   static_cast<uint32_t>(regions.size()), m_mipmapCount);
+        if (m_uploadTicket == vkcore::UploadBatch::NO_UPLOAD) {
+            throw std::runtime_error("Failed to upload DDS image");
+        }
     }
     
-    // Load PNG texture and create Vulkan resources
-    void loadPNG(const std::string& filepath) {
-        PNGData pngData = load_png(filepath);
-        
+    // Read a KTX2 texture (cooked BCn, or Basis Universal transcoded for
+    // this device; any thread)
+    static KTX2Data decodeKTX2(const std::string& filepath) {
+        KTX2Data ktxData = load_ktx2(filepath, g_physicalDevice);
+        if (ktxData.format == VK_FORMAT_UNDEFINED) {
+            throw std::runtime_error("Failed to load KTX2 file: " + filepath + " (" + ktxData.error + ")");
+        }
+        if (!ktx2_format_usable(g_physicalDevice, ktxData.format)) {
+            throw std::runtime_error("KTX2 format not supported by this device: " + filepath);
+        }
+        return ktxData;
+    }
+    
+    // Create Vulkan resources for a decoded KTX2 texture
+    void uploadKTX2(const KTX2Data& ktxData) {
+        m_format = ktxData.format;
+        m_width = ktxData.width;
+        m_height = ktxData.height;
+        m_mipmapCount = ktxData.mipmapCount;
+        
+        createCompressedImage();
+        
+        std::vector<VkBufferImageCopy> regions = ktx2_copy_regions(ktxData);
+        m_uploadTicket = uploads().uploadImageMips(m_image, ktxData.data.data(), ktxData.data.size(),
+                                                   regions.data(), static_cast<uint32_t>(regions.size()),
+                                                   m_mipmapCount);
+        if (m_uploadTicket == vkcore::UploadBatch::NO_UPLOAD) {
+            throw std::runtime_error("Failed to upload KTX2 image");
+        }
+    }
+    
+    // Create Vulkan resources for a decoded PNG texture
+    // generateMips: blit a full mip chain from level 0 (PNG files carry none)
+    void uploadPNG(const PNGData& pngData, bool generateMips) {
         m_format = pngData.format;
         m_width = pngData.width;
         m_height = pngData.height;
-        m_mipmapCount = 1;  // PNG has no mipmaps
+        m_mipmapCount = 1;
+        if (generateMips && vkcore::canBlitMips(g_physicalDevice, m_format)) {
+            m_mipmapCount = vkcore::mipLevelsFor(m_width, m_height);
+        }
         
         // Create Vulkan image
         VkImageCreateInfo imageInfo = {};
@@ -287,106 +212,27 @@ private:
         imageInfo.extent.width = m_width;
         imageInfo.extent.height = m_height;
         imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = 1;
+        imageInfo.mipLevels = m_mipmapCount;
         imageInfo.arrayLayers = 1;
         imageInfo.format = m_format;
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (m_mipmapCount > 1) imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;  // Blit source
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         
-        if (vkCreateImage(g_device, &imageInfo, nullptr, &m_image) != VK_SUCCESS) {
+        if (!gpuAllocator().createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageAlloc)) {
             throw std::runtime_error("Failed to create PNG image");
         }
         
-        // Allocate image memory
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(g_device, m_image, &memRequirements);
-        
-        VkMemoryAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, 
-                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        
-        if (allocInfo.memoryTypeIndex == UINT32_MAX) {
-            vkDestroyImage(g_device, m_image, nullptr);
-            throw std::runtime_error("Failed to find suitable memory type for PNG image");
+        // Copy level 0 (uncompressed RGBA8), fill the remaining levels and
+        // transition everything to shader-readable
+        m_uploadTicket = uploads().uploadImage(m_image, pngData.pixelData.data(), pngData.pixelData.size(),
+                                               m_width, m_height, m_mipmapCount, true);
+        if (m_uploadTicket == vkcore::UploadBatch::NO_UPLOAD) {
+            throw std::runtime_error("Failed to upload PNG image");
         }
-        
-        if (vkAllocateMemory(g_device, &allocInfo, nullptr, &m_imageMemory) != VK_SUCCESS) {
-            vkDestroyImage(g_device, m_image, nullptr);
-            throw std::runtime_error("Failed to allocate PNG image memory");
-        }
-        
-        vkBindImageMemory(g_device, m_image, m_imageMemory, 0);
-        
-        // Create staging buffer for uncompressed RGBA8 data
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
-        createBuffer(pngData.pixelData.size(), 
-                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                    stagingBuffer, stagingBufferMemory);
-        
-        // Copy pixel data to staging buffer
-        void* data;
-        vkMapMemory(g_device, stagingBufferMemory, 0, pngData.pixelData.size(), 0, &data);
-        memcpy(data, pngData.pixelData.data(), pngData.pixelData.size());
-        vkUnmapMemory(g_device, stagingBufferMemory);
-        
-        // Upload to GPU
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-        
-        // Transition to transfer destination
-        VkImageMemoryBarrier barrier = {};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = m_image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 
-                            VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-        
-        // Copy buffer to image (uncompressed RGBA8)
-        VkBufferImageCopy region = {};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {m_width, m_height, 1};
-        
-        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, m_image, 
-                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-        
-        // Transition to shader-readable
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, 
-                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-        
-        endSingleTimeCommands(commandBuffer);
-        
-        // Cleanup staging buffer
-        vkDestroyBuffer(g_device, stagingBuffer, nullptr);
-        vkFreeMemory(g_device, stagingBufferMemory, nullptr);
     }
     
     // Create image view and sampler
@@ -435,17 +281,46 @@ private:
 public:
     /**
      * Constructor - Loads texture from file and creates Vulkan resources
-     * @param filepath Path to texture file (DDS or PNG)
+     * @param filepath Path to texture file (DDS, KTX2 or PNG)
+     * @param generateMips Build a mip chain for PNGs (DDS/KTX2 files use their own)
      * @throws std::runtime_error if loading or resource creation fails
      */
-    TextureResource(const std::string& filepath) {
+    TextureResource(const std::string& filepath, bool generateMips = true)
+        : TextureResource(decode(filepath, generateMips)) {}
+    
+    /**
+     * Read and decode a texture file; touches no Vulkan objects, so it may
+     * run on a worker thread
+     * @throws std::runtime_error if the file is missing or invalid
+     */
+    static Decoded decode(const std::string& filepath, bool generateMips = true) {
+        Decoded decoded;
+        decoded.generateMips = generateMips;
+        // Auto-detect format and load
+        if (isDDS(filepath)) {
+            decoded.kind = Decoded::Kind::DDS;
+            decoded.dds = decodeDDS(filepath);
+        } else if (isKTX2(filepath)) {
+            decoded.kind = Decoded::Kind::KTX2;
+            decoded.ktx2 = decodeKTX2(filepath);
+        } else {
+            // Assume PNG (could add more format detection later)
+            decoded.png = load_png(filepath);
+        }
+        return decoded;
+    }
+    
+    /**
+     * Constructor - Creates Vulkan resources for a decode() result
+     * (render thread)
+     * @throws std::runtime_error if resource creation fails
+     */
+    explicit TextureResource(Decoded&& decoded) {
         try {
-            // Auto-detect format and load
-            if (isDDS(filepath)) {
-                loadDDS(filepath);
-            } else {
-                // Assume PNG (could add more format detection later)
-                loadPNG(filepath);
+            switch (decoded.kind) {
+                case Decoded::Kind::DDS:  uploadDDS(decoded.dds); break;
+                case Decoded::Kind::KTX2: uploadKTX2(decoded.ktx2); break;
+                case Decoded::Kind::PNG:  uploadPNG(decoded.png, decoded.generateMips); break;
             }
             
             // Create image view and sampler
@@ -461,14 +336,14 @@ public:
     // Move constructor
     TextureResource(TextureResource&& other) noexcept 
         : m_image(other.m_image), m_imageView(other.m_imageView), 
-          m_sampler(other.m_sampler), m_imageMemory(other.m_imageMemory),
+          m_sampler(other.m_sampler), m_imageAlloc(other.m_imageAlloc),
           m_format(other.m_format), m_width(other.m_width), 
           m_height(other.m_height), m_mipmapCount(other.m_mipmapCount),
-          m_loaded(other.m_loaded) {
+          m_loaded(other.m_loaded), m_uploadTicket(other.m_uploadTicket) {
         other.m_image = VK_NULL_HANDLE;
         other.m_imageView = VK_NULL_HANDLE;
         other.m_sampler = VK_NULL_HANDLE;
-        other.m_imageMemory = VK_NULL_HANDLE;
+        other.m_imageAlloc = vkcore::GpuAllocation{};
         other.m_loaded = false;
     }
     
@@ -483,6 +358,8 @@ public:
     
     // Cleanup helper
     void cleanup() {
+        // The image may still be the target of an unfinished batch
+        if (m_image != VK_NULL_HANDLE) uploads().wait(m_uploadTicket);
         if (m_sampler != VK_NULL_HANDLE) {
             vkDestroySampler(g_device, m_sampler, nullptr);
             m_sampler = VK_NULL_HANDLE;
@@ -491,14 +368,7 @@ public:
             vkDestroyImageView(g_device, m_imageView, nullptr);
             m_imageView = VK_NULL_HANDLE;
         }
-        if (m_image != VK_NULL_HANDLE) {
-            vkDestroyImage(g_device, m_image, nullptr);
-            m_image = VK_NULL_HANDLE;
-        }
-        if (m_imageMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(g_device, m_imageMemory, nullptr);
-            m_imageMemory = VK_NULL_HANDLE;
-        }
+        gpuAllocator().destroyImage(m_image, m_imageAlloc);
         m_loaded = false;
     }
     
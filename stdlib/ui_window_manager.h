@@ -19,12 +19,24 @@ bool ui_manager_init();
 // Check if UI manager is enabled (reads from project config or compile-time flag)
 bool ui_manager_is_enabled();
 
-// Update UI windows (process input, update state) - call each frame
+// Update UI windows (publish this frame's values to the UI window) - call each frame
 void ui_manager_update();
 
 // Render UI windows - call each frame after game rendering
+// (the window draws on its own thread where supported; this is then a no-op)
 void ui_manager_render();
 
+// Set a value shown in the UI window; published by the next ui_manager_update()
+void ui_manager_set_text(const char* key, const char* text);
+void ui_manager_set_float(const char* key, float value);
+
+// Cap the UI window's own frame rate (default 30, 0 = uncapped)
+void ui_manager_set_frame_rate(int fps);
+
+// Take the oldest message from the UI window (e.g. "close") into buffer
+// Returns false if there is none
+bool ui_manager_poll_message(char* buffer, int bufferSize);
+
 // Shutdown UI window manager (call once at cleanup)
 void ui_manager_shutdown();
 
@@ -0,0 +1,664 @@
+// EDEN ENGINE - Virtual File System
+// Every asset read goes through here: packed .edenpak archives, memory-mapped
+// once at startup, with loose files on disk as the development fallback
+
+#ifndef EDEN_VFS_H
+#define EDEN_VFS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#define EDEN_VFS_WIN32 1
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#define EDEN_VFS_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Optional per-entry compression; the build links the library when enabled
+#ifdef EDEN_USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef EDEN_USE_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * Archive layout (.edenpak, little-endian, written by vulkan/tools/asset_pack)
+ *
+ *   PakHeader
+ *   entry data      each entry starts on a multiple of header.alignment
+ *   PakEntry[]      at tocOffset, sorted by (hash, name)
+ *   names           at namesOffset, normalized paths, not NUL-terminated
+ *
+ * Entries are stored raw (zero-copy: VfsFile points into the mapping) or
+ * compressed with LZ4 / Zstd, which VfsFile inflates into its own buffer.
+ */
+namespace vfs_detail {
+
+constexpr char PAK_MAGIC[8] = {'E', 'D', 'E', 'N', 'P', 'A', 'K', '1'};
+constexpr uint32_t PAK_VERSION = 1;
+constexpr uint32_t PAK_DEFAULT_ALIGNMENT = 64;
+
+enum PakCompression : uint32_t {
+    PAK_STORED = 0,
+    PAK_LZ4 = 1,
+    PAK_ZSTD = 2,
+};
+
+struct PakHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t alignment;
+    uint64_t entryCount;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+static_assert(sizeof(PakHeader) == 48, "PakHeader layout is part of the file format");
+
+struct PakEntry {
+    uint64_t hash;          // fnv1a(normalized path)
+    uint64_t offset;        // From the start of the archive
+    uint64_t storedSize;    // Bytes in the archive
+    uint64_t size;          // Bytes after decompression
+    uint32_t nameOffset;    // Into the names block
+    uint32_t nameLength;
+    uint32_t compression;   // PakCompression
+    uint32_t reserved;
+};
+static_assert(sizeof(PakEntry) == 48, "PakEntry layout is part of the file format");
+
+inline uint64_t fnv1a(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// "./textures//a/../b.png" -> "textures/b.png"; the key archives are built and searched with
+inline std::string normalizePath(const std::string& path) {
+    std::string unified = path;
+    std::replace(unified.begin(), unified.end(), '\\', '/');
+
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= unified.size()) {
+        size_t slash = unified.find('/', start);
+        if (slash == std::string::npos) slash = unified.size();
+        std::string part = unified.substr(start, slash - start);
+        if (part == "..") {
+            if (!parts.empty() && parts.back() != "..") {
+                parts.pop_back();
+            } else {
+                parts.push_back(part);
+            }
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = slash + 1;
+    }
+
+    std::string result;
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (i > 0) result += '/';
+        result += parts[i];
+    }
+    return result;
+}
+
+/**
+ * Read-only view of a whole file: mmap / MapViewOfFile, or one buffered
+ * read where mapping is refused (pipes, some network filesystems)
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#if defined(EDEN_VFS_POSIX)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size > 0) {
+            void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                m_data = static_cast<const char*>(mapped);
+                m_mapped = true;
+            }
+        }
+        ::close(fd);
+#elif defined(EDEN_VFS_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            return false;
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+        if (m_size > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                m_mapped = m_data != nullptr;
+                CloseHandle(mapping);  // The view keeps the mapping alive
+            }
+        }
+        CloseHandle(file);
+#endif
+        if (m_size > 0 && !m_mapped && !readWhole(path)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (m_mapped && m_data) {
+#if defined(EDEN_VFS_POSIX)
+            munmap(const_cast<char*>(m_data), m_size);
+#elif defined(EDEN_VFS_WIN32)
+            UnmapViewOfFile(m_data);
+#endif
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_mapped = false;
+        m_buffer.clear();
+        m_buffer.shrink_to_fit();
+    }
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    bool readWhole(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        m_buffer.resize(m_size);
+        size_t got = std::fread(m_buffer.data(), 1, m_size, file);
+        std::fclose(file);
+        if (got != m_size) {
+            return false;
+        }
+        m_data = m_buffer.data();
+        return true;
+    }
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<char> m_buffer;
+};
+
+/**
+ * One mounted .edenpak: the mapping plus a validated view of its TOC
+ */
+class Archive {
+public:
+    bool open(const std::string& path) {
+        m_file = std::make_shared<MappedFile>();
+        if (!m_file->open(path)) {
+            return false;
+        }
+        const char* base = m_file->data();
+        size_t size = m_file->size();
+        if (size < sizeof(PakHeader)) {
+            return false;
+        }
+        std::memcpy(&m_header, base, sizeof(PakHeader));
+        if (std::memcmp(m_header.magic, PAK_MAGIC, sizeof(PAK_MAGIC)) != 0 ||
+            m_header.version != PAK_VERSION) {
+            return false;
+        }
+        uint64_t tocBytes = m_header.entryCount * sizeof(PakEntry);
+        if (m_header.entryCount > size / sizeof(PakEntry) ||
+            m_header.tocOffset > size || tocBytes > size - m_header.tocOffset ||
+            m_header.namesOffset > size || m_header.namesSize > size - m_header.namesOffset) {
+            return false;
+        }
+        // Copied out rather than cast in place: the TOC need not be aligned in the mapping
+        m_entries.resize(static_cast<size_t>(m_header.entryCount));
+        if (!m_entries.empty()) {
+            std::memcpy(m_entries.data(), base + m_header.tocOffset, static_cast<size_t>(tocBytes));
+        }
+        for (const PakEntry& entry : m_entries) {
+            if (entry.offset > size || entry.storedSize > size - entry.offset ||
+                uint64_t(entry.nameOffset) + entry.nameLength > m_header.namesSize ||
+                (entry.compression == PAK_STORED && entry.storedSize != entry.size)) {
+                return false;
+            }
+        }
+        m_path = path;
+        return true;
+    }
+
+    const PakEntry* find(const std::string& normalized) const {
+        uint64_t hash = fnv1a(normalized.data(), normalized.size());
+        auto it = std::lower_bound(m_entries.begin(), m_entries.end(), hash,
+                                   [](const PakEntry& entry, uint64_t h) { return entry.hash < h; });
+        for (; it != m_entries.end() && it->hash == hash; ++it) {
+            if (it->nameLength == normalized.size() &&
+                std::memcmp(name(*it), normalized.data(), normalized.size()) == 0) {
+                return &*it;
+            }
+        }
+        return nullptr;
+    }
+
+    const char* name(const PakEntry& entry) const {
+        return m_file->data() + m_header.namesOffset + entry.nameOffset;
+    }
+
+    const char* data(const PakEntry& entry) const { return m_file->data() + entry.offset; }
+    const std::shared_ptr<MappedFile>& file() const { return m_file; }
+    const std::vector<PakEntry>& entries() const { return m_entries; }
+    const std::string& path() const { return m_path; }
+
+private:
+    std::shared_ptr<MappedFile> m_file;
+    PakHeader m_header{};
+    std::vector<PakEntry> m_entries;
+    std::string m_path;
+};
+
+inline bool compressionSupported(uint32_t compression) {
+    switch (compression) {
+        case PAK_STORED: return true;
+#ifdef EDEN_USE_LZ4
+        case PAK_LZ4: return true;
+#endif
+#ifdef EDEN_USE_ZSTD
+        case PAK_ZSTD: return true;
+#endif
+        default: return false;
+    }
+}
+
+inline bool decompress(uint32_t compression, const char* src, size_t srcSize, char* dst, size_t dstSize) {
+    switch (compression) {
+#ifdef EDEN_USE_LZ4
+        case PAK_LZ4:
+            return srcSize <= size_t(LZ4_MAX_INPUT_SIZE) && dstSize <= size_t(LZ4_MAX_INPUT_SIZE) &&
+                   LZ4_decompress_safe(src, dst, static_cast<int>(srcSize),
+                                       static_cast<int>(dstSize)) == static_cast<int>(dstSize);
+#endif
+#ifdef EDEN_USE_ZSTD
+        case PAK_ZSTD: {
+            size_t got = ZSTD_decompress(dst, dstSize, src, srcSize);
+            return !ZSTD_isError(got) && got == dstSize;
+        }
+#endif
+        default:
+            (void)src; (void)srcSize; (void)dst; (void)dstSize;
+            return false;
+    }
+}
+
+} // namespace vfs_detail
+
+/**
+ * VfsFile - The bytes of one asset, wherever they came from
+ *
+ * For stored archive entries and loose files this is a view into the
+ * mapping, kept alive by the VfsFile itself, so it outlives an unmount.
+ * Compressed entries are inflated into a buffer the VfsFile owns. Movable,
+ * not copyable; data() stays valid until the VfsFile is reset or destroyed.
+ */
+class VfsFile {
+public:
+    VfsFile() = default;
+    VfsFile(VfsFile&&) = default;
+    VfsFile& operator=(VfsFile&&) = default;
+    VfsFile(const VfsFile&) = delete;
+    VfsFile& operator=(const VfsFile&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const unsigned char* bytes() const { return reinterpret_cast<const unsigned char*>(m_data); }
+
+    // True when the bytes came from a mounted archive rather than the disk
+    bool isArchived() const { return m_archived; }
+
+    void reset() { *this = VfsFile(); }
+
+private:
+    friend class Vfs;
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_archived = false;
+    std::shared_ptr<vfs_detail::MappedFile> m_mapping;
+    std::vector<char> m_owned;
+};
+
+/**
+ * VfsStreamBuf / VfsInputStream - std::istream over a VfsFile
+ *
+ * For the loaders written against std::ifstream: swap the type and keep
+ * the read/seekg/tellg/getline code. Construction with std::ios::ate
+ * starts at the end, as ifstream does. There is no CRLF translation - the
+ * bytes are the file's on every platform.
+ */
+class VfsStreamBuf : public std::streambuf {
+public:
+    explicit VfsStreamBuf(VfsFile file) : m_file(std::move(file)) {
+        char* begin = const_cast<char*>(m_file.data());  // Read-only: the get area is never written
+        setg(begin, begin, begin + m_file.size());
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in)) {
+            return pos_type(off_type(-1));
+        }
+        off_type base = dir == std::ios_base::beg ? 0
+                      : dir == std::ios_base::cur ? off_type(gptr() - eback())
+                      : off_type(egptr() - eback());
+        off_type target = base + off;
+        if (target < 0 || target > off_type(egptr() - eback())) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + target, egptr());
+        return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+private:
+    VfsFile m_file;
+};
+
+class VfsInputStream : public std::istream {
+public:
+    explicit VfsInputStream(const std::string& path, std::ios_base::openmode mode = std::ios_base::in);
+
+    bool is_open() const { return m_open; }
+    void close() {
+        m_open = false;
+        setstate(std::ios_base::eofbit);
+    }
+
+private:
+    std::unique_ptr<VfsStreamBuf> m_buf;
+    bool m_open = false;
+};
+
+/**
+ * Vfs - Archive mounts and loose-file fallback
+ *
+ * shared() mounts DEFAULT_ARCHIVE from the working directory if there is
+ * one; mount() adds more (the last mounted is searched first, so patch
+ * archives shadow the base one). A path is looked up in the archives
+ * first and then read from disk, so shipping builds only need the
+ * archive and development builds only need the loose tree.
+ *
+ * Loose-first mode (setLooseFirst(true), or EDEN_VFS_LOOSE_FIRST=1 in the
+ * environment) flips that order, so edited files win over a stale archive
+ * and hot reload sees the change. setLooseFallback(false) makes archived
+ * builds fail on files the packer missed instead of quietly reading them.
+ *
+ * Thread-safe: loaders on worker threads and mount() may run concurrently.
+ *
+ * Usage:
+ *   VfsFile file;
+ *   if (Vfs::shared().open("textures/rock.png", file)) {
+ *       stbi_load_from_memory(file.bytes(), (int)file.size(), ...);
+ *   }
+ *   VfsInputStream in("shaders/mesh.vert.spv", std::ios::binary | std::ios::ate);
+ */
+class Vfs {
+public:
+    static constexpr const char* DEFAULT_ARCHIVE = "assets.edenpak";
+
+    static Vfs& shared() {
+        static Vfs vfs;
+        return vfs;
+    }
+
+    Vfs(const Vfs&) = delete;
+    Vfs& operator=(const Vfs&) = delete;
+
+    /**
+     * Map an archive and search it ahead of the ones already mounted.
+     * False (and nothing mounted) if it is missing, truncated, from another
+     * format version, or uses a compression this build was made without.
+     */
+    bool mount(const std::string& archivePath) {
+        auto archive = std::make_shared<vfs_detail::Archive>();
+        if (!archive->open(archivePath)) {
+            fprintf(stderr, "[Vfs] Cannot mount '%s': not a valid archive\n", archivePath.c_str());
+            return false;
+        }
+        for (const vfs_detail::PakEntry& entry : archive->entries()) {
+            if (!vfs_detail::compressionSupported(entry.compression)) {
+                fprintf(stderr, "[Vfs] Cannot mount '%s': built without %s support\n",
+                        archivePath.c_str(), entry.compression == vfs_detail::PAK_LZ4 ? "LZ4" : "Zstd");
+                return false;
+            }
+        }
+        printf("[Vfs] Mounted '%s' (%zu entries)\n", archivePath.c_str(), archive->entries().size());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_archives.insert(m_archives.begin(), std::move(archive));
+        return true;
+    }
+
+    // Open files keep their bytes; only later lookups stop seeing the archives
+    void unmountAll() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_archives.clear();
+    }
+
+    void setLooseFirst(bool looseFirst) { m_looseFirst.store(looseFirst, std::memory_order_relaxed); }
+    void setLooseFallback(bool fallback) { m_looseFallback.store(fallback, std::memory_order_relaxed); }
+
+    /**
+     * The whole of `path`. False if no mounted archive has it and (when the
+     * fallback is on) it cannot be read from disk either.
+     */
+    bool open(const std::string& path, VfsFile& out) {
+        out.reset();
+        bool looseFirst = m_looseFirst.load(std::memory_order_relaxed);
+        if (looseFirst && openLoose(path, out)) {
+            return true;
+        }
+        if (openArchived(path, out)) {
+            return true;
+        }
+        return !looseFirst && m_looseFallback.load(std::memory_order_relaxed) && openLoose(path, out);
+    }
+
+    bool readAll(const std::string& path, std::vector<char>& out) {
+        VfsFile file;
+        if (!open(path, file)) {
+            return false;
+        }
+        out.assign(file.data(), file.data() + file.size());
+        return true;
+    }
+
+    bool exists(const std::string& path) {
+        if (isArchived(path)) {
+            return true;
+        }
+        if (!m_looseFallback.load(std::memory_order_relaxed) && !m_looseFirst.load(std::memory_order_relaxed)) {
+            return false;
+        }
+#if defined(EDEN_VFS_POSIX)
+        struct stat st;
+        return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+#else
+        DWORD attributes = GetFileAttributesA(path.c_str());
+        return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+#endif
+    }
+
+    /**
+     * True if open() would read `path` from an archive. Loaders that hand a
+     * path to a library with its own I/O (FFmpeg) only need the VFS then.
+     */
+    bool isArchived(const std::string& path) {
+        if (m_looseFirst.load(std::memory_order_relaxed) && looseExists(path)) {
+            return false;
+        }
+        std::string key = vfs_detail::normalizePath(path);
+        for (const auto& archive : snapshot()) {
+            if (archive->find(key)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct Stats {
+        size_t archives = 0;
+        uint64_t archiveReads = 0;     // open() calls served from an archive
+        uint64_t looseReads = 0;       // ... and from the disk
+        uint64_t bytesInflated = 0;    // Decompressed for compressed entries
+    };
+
+    Stats getStats() const {
+        Stats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stats.archives = m_archives.size();
+        }
+        stats.archiveReads = m_archiveReads.load(std::memory_order_relaxed);
+        stats.looseReads = m_looseReads.load(std::memory_order_relaxed);
+        stats.bytesInflated = m_bytesInflated.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    Vfs() {
+        const char* looseFirst = std::getenv("EDEN_VFS_LOOSE_FIRST");
+        m_looseFirst.store(looseFirst && looseFirst[0] == '1', std::memory_order_relaxed);
+        if (looseExists(DEFAULT_ARCHIVE)) {
+            mount(DEFAULT_ARCHIVE);
+        }
+    }
+
+    std::vector<std::shared_ptr<vfs_detail::Archive>> snapshot() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_archives;
+    }
+
+    bool openArchived(const std::string& path, VfsFile& out) {
+        std::string key = vfs_detail::normalizePath(path);
+        for (const auto& archive : snapshot()) {
+            const vfs_detail::PakEntry* entry = archive->find(key);
+            if (!entry) {
+                continue;
+            }
+            const char* stored = archive->data(*entry);
+            if (entry->compression == vfs_detail::PAK_STORED) {
+                out.m_mapping = archive->file();
+                out.m_data = stored;
+            } else {
+                out.m_owned.resize(static_cast<size_t>(entry->size));
+                if (!vfs_detail::decompress(entry->compression, stored, static_cast<size_t>(entry->storedSize),
+                                            out.m_owned.data(), out.m_owned.size())) {
+                    fprintf(stderr, "[Vfs] Corrupt entry '%s' in '%s'\n", key.c_str(), archive->path().c_str());
+                    out.reset();
+                    return false;
+                }
+                out.m_data = out.m_owned.data();
+                m_bytesInflated.fetch_add(entry->size, std::memory_order_relaxed);
+            }
+            out.m_size = static_cast<size_t>(entry->size);
+            out.m_archived = true;
+            m_archiveReads.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool openLoose(const std::string& path, VfsFile& out) {
+        auto mapping = std::make_shared<vfs_detail::MappedFile>();
+        if (!mapping->open(path)) {
+            return false;
+        }
+        out.m_data = mapping->data();
+        out.m_size = mapping->size();
+        out.m_mapping = std::move(mapping);
+        m_looseReads.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    static bool looseExists(const std::string& path) {
+#if defined(EDEN_VFS_POSIX)
+        struct stat st;
+        return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+#else
+        DWORD attributes = GetFileAttributesA(path.c_str());
+        return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+#endif
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<vfs_detail::Archive>> m_archives;    // Search order
+    std::atomic<bool> m_looseFirst{false};
+    std::atomic<bool> m_looseFallback{true};
+    std::atomic<uint64_t> m_archiveReads{0};
+    std::atomic<uint64_t> m_looseReads{0};
+    std::atomic<uint64_t> m_bytesInflated{0};
+};
+
+inline VfsInputStream::VfsInputStream(const std::string& path, std::ios_base::openmode mode)
+    : std::istream(nullptr) {
+    VfsFile file;
+    m_open = Vfs::shared().open(path, file);
+    m_buf = std::make_unique<VfsStreamBuf>(std::move(file));
+    rdbuf(m_buf.get());
+    if (!m_open) {
+        setstate(std::ios_base::failbit);
+    } else if (mode & std::ios_base::ate) {
+        seekg(0, std::ios_base::end);
+    }
+}
+
+#endif // EDEN_VFS_H
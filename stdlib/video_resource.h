@@ -23,8 +23,13 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
-#include <queue>
+#include <condition_variable>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cerrno>
+
+#include "vfs.h"
 
 // FFmpeg headers (C API)
 extern "C" {
@@ -35,6 +40,8 @@ extern "C" {
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
 #include <libavutil/time.h>
+#include <libavutil/hwcontext.h>
+#include <libavutil/pixdesc.h>
 }
 
 // SDL3 for rendering and audio
@@ -58,6 +65,110 @@ struct SDL_AudioSpec {
 };
 #endif
 
+namespace video_detail {
+
+/**
+ * Bounded single-producer / single-consumer ring of frame pool slot
+ * indices. One thread push()es, one other thread peek()s and pop()s; no
+ * locks. Capacity must be a power of two.
+ */
+template <uint32_t Capacity>
+class SlotRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SlotRing capacity must be a power of two");
+    
+public:
+    // Producer side
+    bool push(uint32_t slot) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        m_slots[tail & (Capacity - 1)] = slot;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool full() const {
+        return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire) >= Capacity;
+    }
+    
+    // Consumer side
+    bool peek(uint32_t& slot) const {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slot = m_slots[head & (Capacity - 1)];
+        return true;
+    }
+    
+    bool pop(uint32_t& slot) {
+        if (!peek(slot)) {
+            return false;
+        }
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool empty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+    
+    // Only while neither side is running
+    void clear() {
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+    }
+    
+private:
+    alignas(64) std::atomic<uint32_t> m_head{0};
+    alignas(64) std::atomic<uint32_t> m_tail{0};
+    uint32_t m_slots[Capacity] = {};
+};
+
+/**
+ * AVIOContext source for files inside a mounted archive, which FFmpeg
+ * cannot open by path. Heap-allocated so the opaque pointer survives a
+ * VideoResource move.
+ */
+struct MemoryInput {
+    static constexpr int BUFFER_SIZE = 64 * 1024;
+
+    VfsFile file;
+    size_t pos = 0;
+
+    static int read(void* opaque, uint8_t* buffer, int size) {
+        MemoryInput* input = static_cast<MemoryInput*>(opaque);
+        size_t count = std::min(static_cast<size_t>(size), input->file.size() - input->pos);
+        if (count == 0) {
+            return AVERROR_EOF;
+        }
+        std::memcpy(buffer, input->file.data() + input->pos, count);
+        input->pos += count;
+        return static_cast<int>(count);
+    }
+
+    static int64_t seek(void* opaque, int64_t offset, int whence) {
+        MemoryInput* input = static_cast<MemoryInput*>(opaque);
+        int64_t size = static_cast<int64_t>(input->file.size());
+        if (whence & AVSEEK_SIZE) {
+            return size;
+        }
+        whence &= ~AVSEEK_FORCE;
+        int64_t target = whence == SEEK_SET ? offset
+                       : whence == SEEK_CUR ? static_cast<int64_t>(input->pos) + offset
+                       : whence == SEEK_END ? size + offset
+                       : -1;
+        if (target < 0 || target > size) {
+            return AVERROR(EINVAL);
+        }
+        input->pos = static_cast<size_t>(target);
+        return target;
+    }
+};
+
+} // namespace video_detail
+
 /**
  * VideoResource - Unified video loading and playback with audio
  * 
@@ -70,6 +181,37 @@ struct SDL_AudioSpec {
  * - Frame-by-frame access for texture rendering
  * - Seeking to specific timestamps
  * - Loop playback support
+ * 
+ * Decoded frames live in a fixed pool allocated at load (a dozen slots of
+ * getFrameStride() bytes). sws_scale writes RGBA straight into a
+ * free slot; the queue and the current frame pass slot indices, so no
+ * pixels are copied between decode and getFrameData(). A renderer that
+ * uploads asynchronously can retainCurrentFrame() to keep a slot from
+ * being reused until its copy has finished, and can hand the pool
+ * persistently mapped staging memory with setFrameStorage() so frames are
+ * decoded directly into the buffer it copies from.
+ * 
+ * setFrameFormat(FrameFormat::NV12) skips the CPU colour conversion: slots
+ * hold a full-resolution Y plane and a half-resolution interleaved UV
+ * plane (getPlaneOffset() / getPlanePitch()), 3/8 the size of RGBA, and
+ * the shader converts (VideoTexture, video_nv12.frag).
+ * 
+ * Decoding uses the platform's hardware decoder when FFmpeg has one for
+ * the codec (D3D11VA, VAAPI, VideoToolbox; setHardwareDecode(false) or
+ * EDEN_VIDEO_HWDECODE=0 to opt out). Decoded surfaces are transferred
+ * back to system memory, so the rest of the path is the same; without
+ * hardware decode the software decoder runs frame- and slice-threaded.
+ * 
+ * The decode thread and the render thread share no locks: decoded slots
+ * go through a single-producer / single-consumer ring one way and freed
+ * slots come back through another. The decoder sleeps on a condition
+ * variable while the queue is full, no slot is free or playback is
+ * paused, and is woken by whatever changed that. Video is slaved to the
+ * audio clock (what has actually left SDL's queue); update() shows the
+ * newest frame that is due and drops older ones, and the decoder skips
+ * converting frames that are already late. Without audio the clock is
+ * the wall clock. update(), seek(), retainCurrentFrame() and
+ * releaseFrame() belong to one (render) thread.
  */
 class VideoResource {
 public:
@@ -79,8 +221,14 @@ public:
         Paused
     };
 
+    // Pixel layout of pool slots
+    enum class FrameFormat {
+        RGBA,   // One plane, 4 bytes per pixel, converted on the CPU
+        NV12    // Y plane + interleaved half-resolution UV plane
+    };
+    
     struct VideoFrame {
-        std::vector<uint8_t> data;  // RGBA pixel data
+        std::vector<uint8_t> data;  // RGBA pixel data (NV12 planes in NV12 mode)
         int width = 0;
         int height = 0;
         double pts = 0.0;  // Presentation timestamp in seconds
@@ -92,10 +240,14 @@ private:
     
     // FFmpeg state
     AVFormatContext* m_formatCtx = nullptr;
+    AVIOContext* m_avio = nullptr;           // Only for archived files (custom I/O)
+    std::unique_ptr<video_detail::MemoryInput> m_memoryInput;
     AVCodecContext* m_videoCodecCtx = nullptr;
     AVCodecContext* m_audioCodecCtx = nullptr;
-    SwsContext* m_swsCtx = nullptr;
+    SwsContext* m_swsCtx = nullptr;          // Created on the first frame (source format known)
     SwrContext* m_swrCtx = nullptr;
+    AVBufferRef* m_hwDeviceCtx = nullptr;
+    AVPixelFormat m_hwPixFmt = AV_PIX_FMT_NONE;
     
     int m_videoStreamIdx = -1;
     int m_audioStreamIdx = -1;
@@ -118,31 +270,112 @@ private:
     // Threading
     std::thread m_decodeThread;
     std::atomic<bool> m_stopThread{false};
-    std::mutex m_frameMutex;
-    std::mutex m_audioMutex;
     
-    // Frame buffer (circular buffer for decoded frames)
-    std::queue<VideoFrame> m_frameQueue;
-    static constexpr size_t MAX_FRAME_QUEUE = 8;
+    // Decoder wakeups. The decoder waits on m_wakeCond; the render thread
+    // only takes m_wakeMutex to notify when m_decoderWaiting is set.
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCond;
+    std::atomic<bool> m_decoderWaiting{false};
     
-    // Audio buffer
-    std::queue<std::vector<uint8_t>> m_audioQueue;
-    static constexpr size_t MAX_AUDIO_QUEUE = 32;
+    // Decoded slots, oldest first (decoder -> render thread)
+    static constexpr uint32_t MAX_FRAME_QUEUE = 8;
+    video_detail::SlotRing<MAX_FRAME_QUEUE> m_frameQueue;
+    // Queue depth, plus the current frame and three retained for uploads
+    // still in flight
+    static constexpr uint32_t FRAME_POOL_SIZE = MAX_FRAME_QUEUE + 4;
+    // Slots whose last reference went away (render thread -> decoder)
+    video_detail::SlotRing<16> m_freeSlots;
+    static_assert(FRAME_POOL_SIZE <= 16, "Free ring must hold the whole pool");
     
-    // Current frame for rendering
-    VideoFrame m_currentFrame;
+    // Frame pool. pts/due/epoch are written by the decoder before the slot
+    // is queued; refs belong to the render thread. A queued slot has no
+    // references; the current frame and each retainCurrentFrame() hold one,
+    // and the slot goes back to m_freeSlots when they are all released.
+    struct FrameSlot {
+        double pts = 0.0;       // Media time
+        double due = 0.0;       // Clock time (media time plus loops played)
+        uint32_t epoch = 0;     // Seek generation it was decoded in
+        int refs = 0;
+    };
+    FrameSlot m_frameSlots[FRAME_POOL_SIZE];
+    std::unique_ptr<uint8_t[]> m_ownedFrameStorage;
+    uint8_t* m_frameStorage = nullptr;        // Owned or setFrameStorage() memory
+    uint8_t* m_externalFrameStorage = nullptr;
+    size_t m_externalFrameStorageSize = 0;
+    FrameFormat m_frameFormat = FrameFormat::RGBA;
+    size_t m_frameBytes = 0;                  // All planes of one frame
+    size_t m_frameStride = 0;                 // m_frameBytes rounded up to 64
+    size_t m_planeOffset[2] = {0, 0};         // From the slot start (64-byte aligned)
+    int m_planePitch[2] = {0, 0};             // Bytes per row
+    
+    // Current frame for rendering (-1 = none yet)
+    int m_currentSlot = -1;
+    uint64_t m_frameSerial = 0;               // Bumped each time the current frame changes
+    std::atomic<uint64_t> m_droppedFrames{0};
     
-    // SDL3 audio
+    // SDL3 audio (S16 stereo)
     SDL_AudioStream* m_audioStream = nullptr;
+    static constexpr int AUDIO_OUTPUT_RATE = 44100;
+    static constexpr int AUDIO_BYTES_PER_SECOND = AUDIO_OUTPUT_RATE * 2 * 2;
+    
+    // Seeks during playback are requests to the decoder: seek() bumps
+    // m_seekEpoch and the decoder seeks, flushes and stamps later frames
+    // and audio with the new epoch, so anything older can be told apart.
+    std::atomic<uint32_t> m_seekEpoch{0};
+    std::atomic<double> m_seekTarget{0.0};
+    std::atomic<uint32_t> m_endedEpoch{0};       // Epoch + 1 the decoder hit the end in, 0 = not ended
     
-    // Timing
-    std::chrono::steady_clock::time_point m_playStartTime;
-    double m_playStartPts = 0.0;
+    // Audio clock: clock time at the end of the audio handed to SDL, from
+    // the decoder (m_audioClockEpoch = epoch + 1, 0 = no audio yet)
+    std::atomic<double> m_audioClockEnd{0.0};
+    std::atomic<uint32_t> m_audioClockEpoch{0};
+    
+    // Master clock (render thread): wall clock since m_clockStart, pulled
+    // onto the audio clock while audio is playing
+    std::chrono::steady_clock::time_point m_clockStart;
+    double m_clockStartTime = 0.0;
+    std::atomic<double> m_masterClock{0.0};      // Last update()'s clock, for the decoder
+    static constexpr double SYNC_SNAP_THRESHOLD = 0.04;  // Snap to audio past this drift
+    static constexpr uint32_t MAX_LATE_DROPS = 8;      // Convert at least one frame in this many
+    
+    /**
+     * Point a fresh format context at the archive entry through m_avio
+     */
+    bool openArchivedInput() {
+        auto input = std::make_unique<video_detail::MemoryInput>();
+        if (!Vfs::shared().open(m_path, input->file)) {
+            return false;
+        }
+        unsigned char* buffer = static_cast<unsigned char*>(av_malloc(video_detail::MemoryInput::BUFFER_SIZE));
+        if (!buffer) {
+            return false;
+        }
+        m_avio = avio_alloc_context(buffer, video_detail::MemoryInput::BUFFER_SIZE, 0, input.get(),
+                                    &video_detail::MemoryInput::read, nullptr, &video_detail::MemoryInput::seek);
+        if (!m_avio) {
+            av_free(buffer);
+            return false;
+        }
+        m_memoryInput = std::move(input);
+        m_formatCtx = avformat_alloc_context();
+        if (!m_formatCtx) {
+            return false;
+        }
+        m_formatCtx->pb = m_avio;
+        m_formatCtx->flags |= AVFMT_FLAG_CUSTOM_IO;
+        return true;
+    }
     
     /**
      * Initialize FFmpeg decoder for both video and audio streams
      */
     bool initFFmpeg() {
+        // Archived files are read from memory; loose ones FFmpeg opens itself
+        if (Vfs::shared().isArchived(m_path) && !openArchivedInput()) {
+            std::cerr << "[Video] Failed to open file: " << m_path << std::endl;
+            return false;
+        }
+        
         // Open input file
         if (avformat_open_input(&m_formatCtx, m_path.c_str(), nullptr, nullptr) < 0) {
             std::cerr << "[Video] Failed to open file: " << m_path << std::endl;
@@ -198,19 +431,179 @@ private:
         }
         m_duration = (double)m_formatCtx->duration / AV_TIME_BASE;
         
-        // Initialize SWS context for pixel format conversion (to RGBA)
-        m_swsCtx = sws_getContext(
-            m_width, m_height, m_videoCodecCtx->pix_fmt,
-            m_width, m_height, AV_PIX_FMT_RGBA,
-            SWS_BILINEAR, nullptr, nullptr, nullptr
-        );
+        // The SWS context (pixel format conversion) is created on the first
+        // frame: with hardware decode the source format is only known once
+        // a surface has been transferred
+        initFramePool();
+        return true;
+    }
+    
+    /**
+     * Size the frame pool for the current resolution; uses the
+     * setFrameStorage() memory when it is large enough
+     */
+    void initFramePool() {
+        if (m_frameFormat == FrameFormat::NV12) {
+            // Planes start 64-byte aligned (copy offsets must be multiples of 4)
+            int chromaWidth = (m_width + 1) / 2;
+            int chromaHeight = (m_height + 1) / 2;
+            m_planePitch[0] = m_width;
+            m_planePitch[1] = chromaWidth * 2;
+            m_planeOffset[0] = 0;
+            m_planeOffset[1] = (static_cast<size_t>(m_width) * m_height + 63) & ~size_t(63);
+            m_frameBytes = m_planeOffset[1] + static_cast<size_t>(m_planePitch[1]) * chromaHeight;
+        } else {
+            m_planePitch[0] = m_width * 4;
+            m_planePitch[1] = 0;
+            m_planeOffset[0] = m_planeOffset[1] = 0;
+            m_frameBytes = static_cast<size_t>(m_planePitch[0]) * m_height;
+        }
+        m_frameStride = (m_frameBytes + 63) & ~size_t(63);
+        size_t required = m_frameStride * FRAME_POOL_SIZE;
+        
+        if (m_externalFrameStorage && m_externalFrameStorageSize >= required) {
+            m_ownedFrameStorage.reset();
+            m_frameStorage = m_externalFrameStorage;
+        } else {
+            if (m_externalFrameStorage) {
+                std::cerr << "[Video] Frame storage too small (" << m_externalFrameStorageSize << " < " << required
+                          << " bytes), using an internal pool" << std::endl;
+            }
+            // Uninitialized on purpose: pages are only touched as frames decode
+            m_ownedFrameStorage.reset(new uint8_t[required + 63]);
+            uintptr_t base = reinterpret_cast<uintptr_t>(m_ownedFrameStorage.get());
+            m_frameStorage = reinterpret_cast<uint8_t*>((base + 63) & ~uintptr_t(63));
+        }
         
-        if (!m_swsCtx) {
-            std::cerr << "[Video] Failed to create SWS context" << std::endl;
+        for (uint32_t i = 0; i < FRAME_POOL_SIZE; i++) {
+            m_frameSlots[i] = FrameSlot();
+        }
+        m_currentSlot = -1;
+        resetFrameRings();
+    }
+    
+    /**
+     * Empty the queue and return every unreferenced slot to the free ring
+     * (decoder not running)
+     */
+    void resetFrameRings() {
+        m_frameQueue.clear();
+        m_freeSlots.clear();
+        for (uint32_t i = 0; i < FRAME_POOL_SIZE; i++) {
+            if (m_frameSlots[i].refs == 0) {
+                m_freeSlots.push(i);
+            }
+        }
+    }
+    
+    void releaseSlot(uint32_t slot) {
+        if (--m_frameSlots[slot].refs == 0) {
+            m_freeSlots.push(slot);
+            wakeDecoder();
+        }
+    }
+    
+    /**
+     * Drop everything queued (render thread)
+     */
+    void drainFrameQueue() {
+        uint32_t slot = 0;
+        bool freed = false;
+        while (m_frameQueue.pop(slot)) {
+            m_freeSlots.push(slot);
+            freed = true;
+        }
+        if (freed) {
+            wakeDecoder();
+        }
+    }
+    
+    /**
+     * Wake the decoder if it is waiting. Called after changing anything its
+     * wait condition reads; the fence pairs with the one in waitForDecoder()
+     * so either the decoder sees the change or we see it waiting.
+     */
+    void wakeDecoder() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_decoderWaiting.load(std::memory_order_relaxed)) {
+            { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+            m_wakeCond.notify_one();
+        }
+    }
+    
+    /**
+     * Decoder side: sleep until ready() holds (or the thread is stopping)
+     */
+    template <typename Ready>
+    void waitForDecoder(Ready ready) {
+        if (m_stopThread.load() || ready()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_decoderWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_wakeCond.wait(lock, [&]() { return m_stopThread.load() || ready(); });
+        m_decoderWaiting.store(false, std::memory_order_relaxed);
+    }
+    
+    bool seekRequested(uint32_t epoch) const {
+        return m_seekEpoch.load(std::memory_order_acquire) != epoch;
+    }
+    
+    /**
+     * Take a free slot for the decoder (waits while every slot is queued,
+     * displayed or retained)
+     * @return false if the thread is stopping or a seek is pending
+     */
+    bool acquireFrameSlot(uint32_t epoch, uint32_t& slot) {
+        waitForDecoder([&]() { return !m_freeSlots.empty() || seekRequested(epoch); });
+        if (m_stopThread.load() || seekRequested(epoch)) {
             return false;
         }
-        
-        return true;
+        return m_freeSlots.pop(slot);
+    }
+    
+    /**
+     * Master clock (render thread): the wall clock, pulled onto the audio
+     * clock while there is audio queued. Small drift is slewed out so the
+     * chunky progress of the audio device doesn't jitter frame timing.
+     */
+    double masterClock() {
+        auto now = std::chrono::steady_clock::now();
+        double clock = m_clockStartTime + std::chrono::duration<double>(now - m_clockStart).count();
+#ifdef SDL3_VIDEO_AVAILABLE
+        uint32_t epoch = m_seekEpoch.load(std::memory_order_relaxed);
+        if (m_audioStream && m_audioClockEpoch.load(std::memory_order_acquire) == epoch + 1) {
+            int queued = SDL_GetAudioStreamQueued(m_audioStream);
+            if (queued > 0) {
+                double audio = m_audioClockEnd.load(std::memory_order_relaxed) -
+                               static_cast<double>(queued) / AUDIO_BYTES_PER_SECOND;
+                double drift = audio - clock;
+                clock += std::abs(drift) > SYNC_SNAP_THRESHOLD ? drift : drift * 0.1;
+                m_clockStart = now;
+                m_clockStartTime = clock;
+            }
+        }
+#endif
+        return clock;
+    }
+    
+    int audioQueuedBytes() const {
+#ifdef SDL3_VIDEO_AVAILABLE
+        return m_audioStream ? SDL_GetAudioStreamQueued(m_audioStream) : 0;
+#else
+        return 0;
+#endif
+    }
+    
+    /**
+     * Restart the master clock at `time` (stopped, or a seek)
+     */
+    void resetClock(double time) {
+        m_clockStart = std::chrono::steady_clock::now();
+        m_clockStartTime = time;
+        m_masterClock.store(time);
+        m_currentTime.store(time);
     }
     
     bool initVideoDecoder() {
@@ -222,6 +615,26 @@ private:
             return false;
         }
         
+        if (hardwareDecodeEnabled() && openVideoCodec(codec, stream, true)) {
+            return true;
+        }
+        return openVideoCodec(codec, stream, false);
+    }
+    
+    /**
+     * Open the video decoder, either on a hardware device (the first
+     * preferred device type FFmpeg can create for this codec) or in
+     * software with frame + slice threading
+     */
+    bool openVideoCodec(const AVCodec* codec, AVStream* stream, bool hardware) {
+        if (m_videoCodecCtx) {
+            avcodec_free_context(&m_videoCodecCtx);
+        }
+        if (m_hwDeviceCtx) {
+            av_buffer_unref(&m_hwDeviceCtx);
+        }
+        m_hwPixFmt = AV_PIX_FMT_NONE;
+        
         m_videoCodecCtx = avcodec_alloc_context3(codec);
         if (!m_videoCodecCtx) {
             std::cerr << "[Video] Failed to allocate video codec context" << std::endl;
@@ -233,6 +646,30 @@ private:
             return false;
         }
         
+        if (hardware) {
+            AVHWDeviceType deviceType = AV_HWDEVICE_TYPE_NONE;
+            if (!createHardwareDevice(codec, deviceType)) {
+                return false;
+            }
+            m_videoCodecCtx->hw_device_ctx = av_buffer_ref(m_hwDeviceCtx);
+            m_videoCodecCtx->opaque = this;
+            m_videoCodecCtx->get_format = &VideoResource::selectHardwareFormat;
+            // Surfaces are decoded one at a time on the device
+            m_videoCodecCtx->thread_count = 1;
+            
+            if (avcodec_open2(m_videoCodecCtx, codec, nullptr) < 0) {
+                std::cerr << "[Video] Hardware decoder failed to open, falling back to software" << std::endl;
+                return false;
+            }
+            std::cout << "[Video] Hardware decode: " << av_hwdevice_get_type_name(deviceType) << std::endl;
+            return true;
+        }
+        
+        // 0 = one thread per core; frame threading is where most of the
+        // software decode speedup comes from
+        m_videoCodecCtx->thread_count = 0;
+        m_videoCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+        
         if (avcodec_open2(m_videoCodecCtx, codec, nullptr) < 0) {
             std::cerr << "[Video] Failed to open video codec" << std::endl;
             return false;
@@ -241,6 +678,96 @@ private:
         return true;
     }
     
+    bool createHardwareDevice(const AVCodec* codec, AVHWDeviceType& deviceType) {
+        static const AVHWDeviceType preferred[] = {
+#if defined(_WIN32)
+            AV_HWDEVICE_TYPE_D3D11VA,
+            AV_HWDEVICE_TYPE_DXVA2,
+#elif defined(__APPLE__)
+            AV_HWDEVICE_TYPE_VIDEOTOOLBOX,
+#else
+            AV_HWDEVICE_TYPE_VAAPI,
+            AV_HWDEVICE_TYPE_VDPAU,
+#endif
+        };
+        for (AVHWDeviceType type : preferred) {
+            for (int i = 0;; i++) {
+                const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i);
+                if (!config) {
+                    break;
+                }
+                if (config->device_type != type ||
+                    !(config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX)) {
+                    continue;
+                }
+                if (av_hwdevice_ctx_create(&m_hwDeviceCtx, type, nullptr, nullptr, 0) < 0) {
+                    break;  // No such device here; try the next type
+                }
+                m_hwPixFmt = config->pix_fmt;
+                deviceType = type;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // get_format callback: take the device's surface format when the
+    // decoder offers it, otherwise FFmpeg's software fallback
+    static AVPixelFormat selectHardwareFormat(AVCodecContext* ctx, const AVPixelFormat* formats) {
+        const VideoResource* self = static_cast<const VideoResource*>(ctx->opaque);
+        for (const AVPixelFormat* format = formats; *format != AV_PIX_FMT_NONE; format++) {
+            if (*format == self->m_hwPixFmt) {
+                return *format;
+            }
+        }
+        std::cerr << "[Video] Hardware surface format not offered, decoding in software" << std::endl;
+        return avcodec_default_get_format(ctx, formats);
+    }
+    
+    static std::atomic<bool>& hardwareDecodeSetting() {
+        static std::atomic<bool> enabled{[]() {
+            const char* env = std::getenv("EDEN_VIDEO_HWDECODE");
+            return !(env && (std::strcmp(env, "0") == 0 || std::strcmp(env, "off") == 0));
+        }()};
+        return enabled;
+    }
+    
+    static bool hardwareDecodeEnabled() {
+        return hardwareDecodeSetting().load();
+    }
+    
+    /**
+     * Convert (or, for NV12 sources in NV12 mode, copy) a decoded frame
+     * into a pool slot
+     */
+    bool writeFrame(const AVFrame* source, uint8_t* slot) {
+        AVPixelFormat srcFormat = static_cast<AVPixelFormat>(source->format);
+        AVPixelFormat dstFormat = m_frameFormat == FrameFormat::NV12 ? AV_PIX_FMT_NV12 : AV_PIX_FMT_RGBA;
+        uint8_t* dstData[4] = {slot + m_planeOffset[0], m_planePitch[1] ? slot + m_planeOffset[1] : nullptr,
+                               nullptr, nullptr};
+        int dstLinesize[4] = {m_planePitch[0], m_planePitch[1], 0, 0};
+        
+        if (srcFormat == dstFormat && dstFormat == AV_PIX_FMT_NV12) {
+            av_image_copy_plane(dstData[0], dstLinesize[0], source->data[0], source->linesize[0],
+                                m_width, m_height);
+            av_image_copy_plane(dstData[1], dstLinesize[1], source->data[1], source->linesize[1],
+                                m_planePitch[1], (m_height + 1) / 2);
+            return true;
+        }
+        
+        m_swsCtx = sws_getCachedContext(m_swsCtx, m_width, m_height, srcFormat, m_width, m_height, dstFormat,
+                                        SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!m_swsCtx) {
+            std::cerr << "[Video] Failed to create SWS context for " << av_get_pix_fmt_name(srcFormat)
+                      << std::endl;
+            return false;
+        }
+        sws_scale(m_swsCtx,
+                 source->data, source->linesize, 0, m_height,
+                 dstData, dstLinesize);
+        return true;
+    }
+    
     bool initAudioDecoder() {
         AVStream* stream = m_formatCtx->streams[m_audioStreamIdx];
         const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
@@ -279,7 +806,7 @@ private:
         av_opt_set_chlayout(m_swrCtx, "in_chlayout", &m_audioCodecCtx->ch_layout, 0);
         av_opt_set_chlayout(m_swrCtx, "out_chlayout", &outLayout, 0);
         av_opt_set_int(m_swrCtx, "in_sample_rate", m_sampleRate, 0);
-        av_opt_set_int(m_swrCtx, "out_sample_rate", 44100, 0);  // Standard output rate
+        av_opt_set_int(m_swrCtx, "out_sample_rate", AUDIO_OUTPUT_RATE, 0);  // Standard output rate
         av_opt_set_sample_fmt(m_swrCtx, "in_sample_fmt", m_audioCodecCtx->sample_fmt, 0);
         av_opt_set_sample_fmt(m_swrCtx, "out_sample_fmt", AV_SAMPLE_FMT_S16, 0);
         
@@ -307,7 +834,7 @@ private:
         }
         
         SDL_AudioSpec spec;
-        spec.freq = 44100;
+        spec.freq = AUDIO_OUTPUT_RATE;
         spec.channels = 2;
         
         #ifdef SDL_AUDIO_S16SYS
@@ -337,27 +864,48 @@ private:
     void decodeThreadFunc() {
         AVPacket* packet = av_packet_alloc();
         AVFrame* frame = av_frame_alloc();
-        AVFrame* rgbaFrame = av_frame_alloc();
+        AVFrame* transferFrame = av_frame_alloc();  // Hardware surfaces, copied to system memory
+        std::vector<uint8_t> audioBuffer;
+        
+        AVStream* videoStream = m_formatCtx->streams[m_videoStreamIdx];
+        AVStream* audioStream = m_audioStreamIdx >= 0 ? m_formatCtx->streams[m_audioStreamIdx] : nullptr;
+        double frameDuration = m_fps > 0.0 ? 1.0 / m_fps : 1.0 / 30.0;
+        double lateThreshold = std::max(2.0 * frameDuration, 0.05);
         
-        // Allocate RGBA frame buffer
-        int rgbaSize = av_image_get_buffer_size(AV_PIX_FMT_RGBA, m_width, m_height, 1);
-        std::vector<uint8_t> rgbaBuffer(rgbaSize);
-        av_image_fill_arrays(rgbaFrame->data, rgbaFrame->linesize, rgbaBuffer.data(),
-                            AV_PIX_FMT_RGBA, m_width, m_height, 1);
+        uint32_t epoch = m_seekEpoch.load(std::memory_order_acquire);
+        double loopOffset = 0.0;     // Clock time at the start of this pass through the file
+        double videoEnd = 0.0;       // Media time reached by each stream this pass
+        double audioEnd = 0.0;
+        uint32_t lateDrops = 0;
         
         while (!m_stopThread.load()) {
-            if (m_playState.load() != PlayState::Playing) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Seek requested by the render thread
+            if (seekRequested(epoch)) {
+                epoch = m_seekEpoch.load(std::memory_order_acquire);
+                double target = m_seekTarget.load();
+                av_seek_frame(m_formatCtx, -1, static_cast<int64_t>(target * AV_TIME_BASE), AVSEEK_FLAG_BACKWARD);
+                avcodec_flush_buffers(m_videoCodecCtx);
+                if (m_audioCodecCtx) {
+                    avcodec_flush_buffers(m_audioCodecCtx);
+                }
+#ifdef SDL3_VIDEO_AVAILABLE
+                if (m_audioStream) {
+                    SDL_ClearAudioStream(m_audioStream);
+                }
+#endif
+                loopOffset = 0.0;
+                videoEnd = audioEnd = target;
+                lateDrops = 0;
                 continue;
             }
             
-            // Check if queues are full
-            {
-                std::lock_guard<std::mutex> lock(m_frameMutex);
-                if (m_frameQueue.size() >= MAX_FRAME_QUEUE) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
-                    continue;
-                }
+            // Sleep while paused or the queue is full
+            waitForDecoder([&]() {
+                return seekRequested(epoch) ||
+                       (m_playState.load() == PlayState::Playing && !m_frameQueue.full());
+            });
+            if (m_stopThread.load() || seekRequested(epoch)) {
+                continue;
             }
             
             // Read next packet
@@ -365,19 +913,22 @@ private:
             if (ret < 0) {
                 if (ret == AVERROR_EOF) {
                     if (m_looping.load()) {
-                        // Seek to beginning and continue
+                        // Seek to beginning and continue; the clock keeps running
                         av_seek_frame(m_formatCtx, -1, 0, AVSEEK_FLAG_BACKWARD);
                         avcodec_flush_buffers(m_videoCodecCtx);
                         if (m_audioCodecCtx) {
                             avcodec_flush_buffers(m_audioCodecCtx);
                         }
-                        m_playStartTime = std::chrono::steady_clock::now();
-                        m_playStartPts = 0.0;
+                        double length = std::max(videoEnd, audioEnd);
+                        loopOffset += length > 0.0 ? length : m_duration;
+                        videoEnd = audioEnd = 0.0;
                         continue;
-                    } else {
-                        m_playState.store(PlayState::Stopped);
-                        break;
                     }
+                    // update() stops once the queue has played out; stay
+                    // around in case of a seek
+                    m_endedEpoch.store(epoch + 1, std::memory_order_release);
+                    waitForDecoder([&]() { return seekRequested(epoch); });
+                    continue;
                 }
                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
                 continue;
@@ -396,26 +947,46 @@ private:
                             break;
                         }
                         
-                        // Convert to RGBA
-                        sws_scale(m_swsCtx,
-                                 frame->data, frame->linesize, 0, m_height,
-                                 rgbaFrame->data, rgbaFrame->linesize);
+                        // Calculate PTS
+                        double pts = frame->pts != AV_NOPTS_VALUE ? frame->pts * av_q2d(videoStream->time_base)
+                                                                  : videoEnd;
+                        videoEnd = pts + frameDuration;
+                        double due = pts + loopOffset;
                         
-                        // Create frame
-                        VideoFrame vf;
-                        vf.width = m_width;
-                        vf.height = m_height;
-                        vf.data.assign(rgbaBuffer.begin(), rgbaBuffer.end());
+                        // Already late: skip the transfer and conversion
+                        // (but let one through now and then so the picture
+                        // still moves when decoding can't keep up)
+                        if (due < m_masterClock.load(std::memory_order_relaxed) - lateThreshold &&
+                            lateDrops < MAX_LATE_DROPS) {
+                            lateDrops++;
+                            m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                            continue;
+                        }
+                        lateDrops = 0;
                         
-                        // Calculate PTS
-                        AVStream* stream = m_formatCtx->streams[m_videoStreamIdx];
-                        vf.pts = frame->pts * av_q2d(stream->time_base);
+                        const AVFrame* source = frame;
+                        if (frame->format == m_hwPixFmt && m_hwPixFmt != AV_PIX_FMT_NONE) {
+                            av_frame_unref(transferFrame);
+                            if (av_hwframe_transfer_data(transferFrame, frame, 0) < 0) {
+                                std::cerr << "[Video] Failed to transfer hardware frame" << std::endl;
+                                continue;
+                            }
+                            source = transferFrame;
+                        }
                         
-                        // Add to queue
-                        {
-                            std::lock_guard<std::mutex> lock(m_frameMutex);
-                            m_frameQueue.push(std::move(vf));
+                        uint32_t slot = 0;
+                        if (!acquireFrameSlot(epoch, slot)) {
+                            break;
                         }
+                        
+                        // Convert straight into the pool slot. A slot that
+                        // fails goes back through the queue with a stale
+                        // epoch, so the render thread frees it.
+                        FrameSlot& info = m_frameSlots[slot];
+                        info.pts = pts;
+                        info.due = due;
+                        info.epoch = writeFrame(source, m_frameStorage + slot * m_frameStride) ? epoch : ~epoch;
+                        m_frameQueue.push(slot);
                     }
                 }
             }
@@ -434,32 +1005,28 @@ private:
                         
                         // Resample audio
                         int outSamples = swr_get_out_samples(m_swrCtx, frame->nb_samples);
-                        std::vector<uint8_t> audioData(outSamples * 2 * 2);  // Stereo S16
-                        uint8_t* outBuf = audioData.data();
+                        if (outSamples <= 0) {
+                            continue;
+                        }
+                        audioBuffer.resize(static_cast<size_t>(outSamples) * 2 * 2);  // Stereo S16
+                        uint8_t* outBuf = audioBuffer.data();
                         
                         int converted = swr_convert(m_swrCtx, &outBuf, outSamples,
                                                    (const uint8_t**)frame->data, frame->nb_samples);
                         
                         if (converted > 0) {
-                            audioData.resize(converted * 2 * 2);
-                            
-                            // Add to audio queue
-                            {
-                                std::lock_guard<std::mutex> lock(m_audioMutex);
-                                if (m_audioQueue.size() < MAX_AUDIO_QUEUE) {
-                                    m_audioQueue.push(std::move(audioData));
-                                }
+                            if (frame->pts != AV_NOPTS_VALUE) {
+                                audioEnd = frame->pts * av_q2d(audioStream->time_base);
                             }
+                            audioEnd += static_cast<double>(converted) / AUDIO_OUTPUT_RATE;
                             
-                            // Feed audio to SDL
+                            // SDL's stream is the audio queue: the device
+                            // pulls from it and its fill level is the clock
 #ifdef SDL3_VIDEO_AVAILABLE
                             if (m_audioStream) {
-                                std::lock_guard<std::mutex> lock(m_audioMutex);
-                                if (!m_audioQueue.empty()) {
-                                    auto& data = m_audioQueue.front();
-                                    SDL_PutAudioStreamData(m_audioStream, data.data(), static_cast<int>(data.size()));
-                                    m_audioQueue.pop();
-                                }
+                                SDL_PutAudioStreamData(m_audioStream, audioBuffer.data(), converted * 2 * 2);
+                                m_audioClockEnd.store(audioEnd + loopOffset, std::memory_order_relaxed);
+                                m_audioClockEpoch.store(epoch + 1, std::memory_order_release);
                             }
 #endif
                         }
@@ -470,8 +1037,8 @@ private:
             av_packet_unref(packet);
         }
         
+        av_frame_free(&transferFrame);
         av_frame_free(&frame);
-        av_frame_free(&rgbaFrame);
         av_packet_free(&packet);
     }
 
@@ -511,10 +1078,14 @@ public:
         : m_path(std::move(other.m_path)),
           m_loaded(other.m_loaded),
           m_formatCtx(other.m_formatCtx),
+          m_avio(other.m_avio),
+          m_memoryInput(std::move(other.m_memoryInput)),
           m_videoCodecCtx(other.m_videoCodecCtx),
           m_audioCodecCtx(other.m_audioCodecCtx),
           m_swsCtx(other.m_swsCtx),
           m_swrCtx(other.m_swrCtx),
+          m_hwDeviceCtx(other.m_hwDeviceCtx),
+          m_hwPixFmt(other.m_hwPixFmt),
           m_videoStreamIdx(other.m_videoStreamIdx),
           m_audioStreamIdx(other.m_audioStreamIdx),
           m_width(other.m_width),
@@ -523,9 +1094,27 @@ public:
           m_duration(other.m_duration),
           m_sampleRate(other.m_sampleRate),
           m_audioChannels(other.m_audioChannels),
+          m_ownedFrameStorage(std::move(other.m_ownedFrameStorage)),
+          m_frameStorage(other.m_frameStorage),
+          m_externalFrameStorage(other.m_externalFrameStorage),
+          m_externalFrameStorageSize(other.m_externalFrameStorageSize),
+          m_frameFormat(other.m_frameFormat),
+          m_frameBytes(other.m_frameBytes),
+          m_frameStride(other.m_frameStride),
+          m_currentSlot(other.m_currentSlot),
           m_audioStream(other.m_audioStream) {
         
+        std::copy(std::begin(other.m_frameSlots), std::end(other.m_frameSlots), std::begin(m_frameSlots));
+        resetFrameRings();  // Whatever was queued is dropped
+        std::copy(std::begin(other.m_planeOffset), std::end(other.m_planeOffset), std::begin(m_planeOffset));
+        std::copy(std::begin(other.m_planePitch), std::end(other.m_planePitch), std::begin(m_planePitch));
+        other.m_hwDeviceCtx = nullptr;
+        other.m_frameStorage = nullptr;
+        other.m_externalFrameStorage = nullptr;
+        other.m_externalFrameStorageSize = 0;
+        other.m_currentSlot = -1;
         other.m_formatCtx = nullptr;
+        other.m_avio = nullptr;
         other.m_videoCodecCtx = nullptr;
         other.m_audioCodecCtx = nullptr;
         other.m_swsCtx = nullptr;
@@ -548,6 +1137,7 @@ public:
     void cleanup() {
         // Stop decode thread
         m_stopThread.store(true);
+        wakeDecoder();
         if (m_decodeThread.joinable()) {
             m_decodeThread.join();
         }
@@ -580,20 +1170,24 @@ public:
             m_videoCodecCtx = nullptr;
         }
         
+        if (m_hwDeviceCtx) {
+            av_buffer_unref(&m_hwDeviceCtx);
+            m_hwDeviceCtx = nullptr;
+        }
+        m_hwPixFmt = AV_PIX_FMT_NONE;
+        
         if (m_formatCtx) {
             avformat_close_input(&m_formatCtx);
             m_formatCtx = nullptr;
         }
-        
-        // Clear queues
-        {
-            std::lock_guard<std::mutex> lock(m_frameMutex);
-            while (!m_frameQueue.empty()) m_frameQueue.pop();
-        }
-        {
-            std::lock_guard<std::mutex> lock(m_audioMutex);
-            while (!m_audioQueue.empty()) m_audioQueue.pop();
+        if (m_avio) {
+            // Custom I/O: avformat_close_input leaves the context (and its buffer) to us
+            av_freep(&m_avio->buffer);
+            avio_context_free(&m_avio);
         }
+        m_memoryInput.reset();
+        
+        drainFrameQueue();
         
         m_loaded = false;
     }
@@ -616,7 +1210,7 @@ public:
         
         // If paused, resume
         if (m_playState.load() == PlayState::Paused) {
-            m_playStartTime = std::chrono::steady_clock::now();
+            m_clockStart = std::chrono::steady_clock::now();
             m_playState.store(PlayState::Playing);
             
 #ifdef SDL3_VIDEO_AVAILABLE
@@ -624,15 +1218,21 @@ public:
                 SDL_ResumeAudioStreamDevice(m_audioStream);
             }
 #endif
+            wakeDecoder();
             return true;
         }
         
-        // Start from beginning
+        // Played to the end: rewind
+        if (m_decodeThread.joinable()) {
+            stop();
+        }
+        
+        // Start from the beginning (or where a seek while stopped left off)
         m_stopThread.store(false);
+        m_endedEpoch.store(0);
+        m_audioClockEpoch.store(0);
+        resetClock(m_clockStartTime);
         m_playState.store(PlayState::Playing);
-        m_playStartTime = std::chrono::steady_clock::now();
-        m_playStartPts = 0.0;
-        m_currentTime.store(0.0);
         
 #ifdef SDL3_VIDEO_AVAILABLE
         if (m_audioStream) {
@@ -641,9 +1241,7 @@ public:
 #endif
         
         // Start decode thread
-        if (!m_decodeThread.joinable()) {
-            m_decodeThread = std::thread(&VideoResource::decodeThreadFunc, this);
-        }
+        m_decodeThread = std::thread(&VideoResource::decodeThreadFunc, this);
         
         return true;
     }
@@ -653,6 +1251,7 @@ public:
      */
     void pause() {
         if (m_playState.load() == PlayState::Playing) {
+            m_clockStartTime = masterClock();
             m_playState.store(PlayState::Paused);
             
 #ifdef SDL3_VIDEO_AVAILABLE
@@ -671,6 +1270,7 @@ public:
         
         // Stop decode thread
         m_stopThread.store(true);
+        wakeDecoder();
         if (m_decodeThread.joinable()) {
             m_decodeThread.join();
         }
@@ -682,11 +1282,7 @@ public:
         }
 #endif
         
-        // Clear queues
-        {
-            std::lock_guard<std::mutex> lock(m_frameMutex);
-            while (!m_frameQueue.empty()) m_frameQueue.pop();
-        }
+        drainFrameQueue();
         
         // Reset to beginning
         if (m_formatCtx) {
@@ -697,12 +1293,13 @@ public:
             }
         }
         
-        m_currentTime.store(0.0);
+        resetClock(0.0);
         m_stopThread.store(false);
     }
     
     /**
-     * Seek to a specific position
+     * Seek to a specific position. While playing or paused the decoder
+     * does the seek; frames decoded before it are dropped.
      * @param seconds Position in seconds
      */
     void seek(double seconds) {
@@ -712,28 +1309,28 @@ public:
         
         seconds = std::max(0.0, std::min(seconds, m_duration));
         
-        int64_t timestamp = static_cast<int64_t>(seconds * AV_TIME_BASE);
-        av_seek_frame(m_formatCtx, -1, timestamp, AVSEEK_FLAG_BACKWARD);
-        
-        avcodec_flush_buffers(m_videoCodecCtx);
-        if (m_audioCodecCtx) {
-            avcodec_flush_buffers(m_audioCodecCtx);
-        }
-        
-        // Clear queues
-        {
-            std::lock_guard<std::mutex> lock(m_frameMutex);
-            while (!m_frameQueue.empty()) m_frameQueue.pop();
+        if (m_decodeThread.joinable()) {
+            m_seekTarget.store(seconds);
+            m_seekEpoch.fetch_add(1, std::memory_order_release);
+            wakeDecoder();
+        } else {
+            int64_t timestamp = static_cast<int64_t>(seconds * AV_TIME_BASE);
+            av_seek_frame(m_formatCtx, -1, timestamp, AVSEEK_FLAG_BACKWARD);
+            
+            avcodec_flush_buffers(m_videoCodecCtx);
+            if (m_audioCodecCtx) {
+                avcodec_flush_buffers(m_audioCodecCtx);
+            }
         }
         
-        m_playStartPts = seconds;
-        m_playStartTime = std::chrono::steady_clock::now();
-        m_currentTime.store(seconds);
+        drainFrameQueue();
+        resetClock(seconds);
     }
     
     /**
      * Update video playback - call this every frame
-     * Updates current time and gets next frame if needed
+     * Advances the clock and moves to the newest frame that is due,
+     * dropping any older ones. Never blocks on the decoder.
      * @return true if a new frame is available
      */
     bool update() {
@@ -741,52 +1338,224 @@ public:
             return false;
         }
         
-        // Calculate current playback time
-        auto now = std::chrono::steady_clock::now();
-        double elapsed = std::chrono::duration<double>(now - m_playStartTime).count();
-        double currentTime = m_playStartPts + elapsed;
-        m_currentTime.store(currentTime);
-        
-        // Get next frame that should be displayed
-        std::lock_guard<std::mutex> lock(m_frameMutex);
+        double clock = masterClock();
+        m_masterClock.store(clock, std::memory_order_relaxed);
+        uint32_t epoch = m_seekEpoch.load(std::memory_order_relaxed);
         
-        while (!m_frameQueue.empty()) {
-            VideoFrame& front = m_frameQueue.front();
-            
-            // If frame is ready to display (or we need to catch up)
-            if (front.pts <= currentTime) {
-                m_currentFrame = std::move(front);
-                m_frameQueue.pop();
-                
-                // Keep getting frames until we find one that's in the future
-                if (m_frameQueue.empty() || m_frameQueue.front().pts > currentTime) {
-                    return true;
-                }
-            } else {
+        bool changed = false;
+        uint32_t slot = 0;
+        while (m_frameQueue.peek(slot)) {
+            FrameSlot& info = m_frameSlots[slot];
+            if (info.epoch == epoch && info.due > clock) {
                 break;  // Frame is in the future, wait
             }
+            m_frameQueue.pop(slot);
+            
+            // Decoded before a seek (or failed to convert)
+            if (info.epoch != epoch) {
+                m_freeSlots.push(slot);
+                wakeDecoder();
+                continue;
+            }
+            
+            // A due frame superseded by a newer one before it was shown
+            if (changed) {
+                m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            }
+            
+            // Becomes the current frame
+            if (m_currentSlot >= 0) {
+                releaseSlot(static_cast<uint32_t>(m_currentSlot));
+            }
+            info.refs = 1;
+            m_currentSlot = static_cast<int>(slot);
+            changed = true;
         }
         
-        return false;
+        if (changed) {
+            m_frameSerial++;
+            wakeDecoder();
+        }
+        
+        // Media time of what is on screen (the clock keeps counting across loops)
+        double current = clock;
+        if (m_currentSlot >= 0 && m_frameSlots[m_currentSlot].epoch == epoch) {
+            const FrameSlot& info = m_frameSlots[m_currentSlot];
+            current = info.pts + std::max(0.0, clock - info.due);
+        }
+        m_currentTime.store(current);
+        
+        // Played out
+        if (m_endedEpoch.load(std::memory_order_acquire) == epoch + 1 && m_frameQueue.empty() &&
+            audioQueuedBytes() == 0) {
+            m_playState.store(PlayState::Stopped);
+#ifdef SDL3_VIDEO_AVAILABLE
+            if (m_audioStream) {
+                SDL_PauseAudioStreamDevice(m_audioStream);
+            }
+#endif
+        }
+        
+        return changed;
     }
     
     /**
-     * Get current frame pixel data (RGBA format)
+     * Get current frame pixel data (RGBA format, getWidth() * 4 bytes per row)
+     * Valid until the next update(); retainCurrentFrame() to keep it longer
      * @return Pointer to RGBA pixel data, or nullptr if no frame
      */
     const uint8_t* getFrameData() const {
-        if (m_currentFrame.data.empty()) {
+        if (m_currentSlot < 0 || !m_frameStorage) {
             return nullptr;
         }
-        return m_currentFrame.data.data();
+        return m_frameStorage + static_cast<size_t>(m_currentSlot) * m_frameStride;
     }
     
     /**
-     * Get current frame as a copy
+     * Get current frame as a copy (allocates and copies the whole frame;
+     * prefer getFrameData() or retainCurrentFrame())
      * @return VideoFrame struct with pixel data
      */
     VideoFrame getCurrentFrame() const {
-        return m_currentFrame;
+        VideoFrame vf;
+        const uint8_t* data = getFrameData();
+        if (data) {
+            vf.data.assign(data, data + m_frameBytes);
+            vf.width = m_width;
+            vf.height = m_height;
+            vf.pts = m_frameSlots[m_currentSlot].pts;
+        }
+        return vf;
+    }
+    
+    /**
+     * Keep the current frame's slot from being reused (e.g. until a GPU
+     * copy from it has completed); pair with releaseFrame(). reload()
+     * rebuilds the pool, so don't release slots retained before it.
+     * @return Slot index, or -1 if there is no frame
+     */
+    int retainCurrentFrame() {
+        if (m_currentSlot < 0) {
+            return -1;
+        }
+        m_frameSlots[m_currentSlot].refs++;
+        return m_currentSlot;
+    }
+    
+    /**
+     * Return a slot taken with retainCurrentFrame() to the pool
+     */
+    void releaseFrame(int slot) {
+        if (slot >= 0 && slot < static_cast<int>(FRAME_POOL_SIZE) && m_frameSlots[slot].refs > 0) {
+            releaseSlot(static_cast<uint32_t>(slot));
+        }
+    }
+    
+    /**
+     * Pixel data of a retained slot
+     */
+    const uint8_t* getFrameData(int slot) const {
+        if (slot < 0 || slot >= static_cast<int>(FRAME_POOL_SIZE) || !m_frameStorage) {
+            return nullptr;
+        }
+        return m_frameStorage + static_cast<size_t>(slot) * m_frameStride;
+    }
+    
+    /**
+     * Byte offset of a slot from the start of the frame storage (the
+     * bufferOffset for a copy out of setFrameStorage() memory)
+     */
+    size_t getFrameOffset(int slot) const {
+        return slot < 0 ? 0 : static_cast<size_t>(slot) * m_frameStride;
+    }
+    
+    size_t getFrameStride() const { return m_frameStride; }
+    
+    /**
+     * Changes whenever update() moves to a new frame (for uploaders that
+     * don't see update()'s return value)
+     */
+    uint64_t getFrameSerial() const { return m_frameSerial; }
+    
+    /**
+     * Bytes setFrameStorage() needs for this video's resolution
+     */
+    size_t getFrameStorageSize() const { return m_frameStride * FRAME_POOL_SIZE; }
+    
+    /**
+     * Decode into caller-owned memory, e.g. a persistently mapped staging
+     * buffer of at least getFrameStorageSize() bytes (64-byte aligned).
+     * nullptr goes back to the internal pool. Only while stopped; the
+     * memory must outlive this resource or the next setFrameStorage().
+     * Reloads keep using it if it is still large enough.
+     * @return false if playing or paused
+     */
+    bool setFrameStorage(void* memory, size_t size) {
+        if (m_playState.load() != PlayState::Stopped || m_decodeThread.joinable()) {
+            return false;
+        }
+        m_externalFrameStorage = static_cast<uint8_t*>(memory);
+        m_externalFrameStorageSize = memory ? size : 0;
+        initFramePool();
+        return true;
+    }
+    
+    /**
+     * Choose the slot layout (RGBA, or NV12 for conversion in the shader).
+     * Only while stopped; rebuilds the pool.
+     * @return false if playing or paused
+     */
+    bool setFrameFormat(FrameFormat format) {
+        if (m_playState.load() != PlayState::Stopped || m_decodeThread.joinable()) {
+            return false;
+        }
+        m_frameFormat = format;
+        initFramePool();
+        return true;
+    }
+    
+    FrameFormat getFrameFormat() const { return m_frameFormat; }
+    
+    /**
+     * Plane layout inside each slot: plane 0 is RGBA or Y, plane 1 the
+     * interleaved UV plane (NV12 only; pitch 0 otherwise)
+     */
+    size_t getPlaneOffset(int plane) const { return plane == 1 ? m_planeOffset[1] : m_planeOffset[0]; }
+    int getPlanePitch(int plane) const { return plane == 1 ? m_planePitch[1] : m_planePitch[0]; }
+    
+    /**
+     * Colour encoding of the stream's YUV, for the NV12 shader:
+     * true for BT.709 (HD and up), false for BT.601
+     */
+    bool isBT709() const {
+        if (!m_videoCodecCtx) {
+            return true;
+        }
+        if (m_videoCodecCtx->colorspace == AVCOL_SPC_BT470BG || m_videoCodecCtx->colorspace == AVCOL_SPC_SMPTE170M) {
+            return false;
+        }
+        if (m_videoCodecCtx->colorspace == AVCOL_SPC_UNSPECIFIED) {
+            return m_height >= 720;
+        }
+        return true;
+    }
+    
+    /**
+     * Whether Y/UV use the full 0-255 range (JPEG) instead of 16-235/240
+     */
+    bool isFullRange() const {
+        return m_videoCodecCtx && m_videoCodecCtx->color_range == AVCOL_RANGE_JPEG;
+    }
+    
+    bool isHardwareDecoded() const { return m_hwDeviceCtx != nullptr; }
+    
+    /**
+     * Use hardware decode for videos loaded (or reloaded) from now on, when
+     * the platform has a decoder for the codec. Default on, unless
+     * EDEN_VIDEO_HWDECODE is "0" or "off".
+     */
+    static void setHardwareDecode(bool enabled) {
+        hardwareDecodeSetting().store(enabled);
     }
     
     // Getters
@@ -802,6 +1571,12 @@ public:
     double getDuration() const { return m_duration; }
     double getCurrentTime() const { return m_currentTime.load(); }
     
+    /**
+     * Frames skipped to keep up with the clock (late at decode, or
+     * superseded before update() showed them)
+     */
+    uint64_t getDroppedFrames() const { return m_droppedFrames.load(); }
+    
     const std::string& getPath() const { return m_path; }
     
     /**
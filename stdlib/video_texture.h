@@ -0,0 +1,326 @@
+// EDEN ENGINE - VideoTexture Class
+// Sampled Vulkan images fed by a playing VideoResource: frames are decoded
+// straight into persistently mapped staging memory and copied into the
+// images on the GPU - no CPU copies between the decoder and the texture
+
+#ifndef EDEN_VIDEO_TEXTURE_H
+#define EDEN_VIDEO_TEXTURE_H
+
+#include "vulkan.h"
+#include "video_resource.h"
+#include "../vulkan/core/gpu_allocator.h"
+#include "../vulkan/core/upload_batch.h"
+#include <vector>
+#include <stdexcept>
+
+extern VkDevice g_device;
+extern VkPhysicalDevice g_physicalDevice;
+
+/**
+ * VideoTexture - GPU surface for a VideoResource
+ *
+ * Takes over the video's frame pool: the pool lives in one host-visible
+ * staging buffer (VideoResource::setFrameStorage()), so sws_scale or the
+ * hardware decoder's transfer writes each frame where the GPU copies it
+ * from. update() copies the newest frame's planes into the images through
+ * UploadBatch::copyBufferToImage() and keeps the slot retained until that
+ * copy has completed.
+ *
+ * NV12 mode (default) uploads a full-size R8 Y image and a half-size R8G8
+ * UV image; bind them at 0/1 for vulkan/core/shaders/video_nv12.frag, with
+ * specialization constants from isBT709()/isFullRange(). RGBA mode
+ * uploads one R8G8B8A8 image converted on the CPU, for existing quad
+ * shaders. NV12 frames are 3/8 the size of RGBA and skip the CPU
+ * conversion, which is what lets several 4K videos play at once.
+ *
+ * The images are undefined until isReady(). Constructing stops the video
+ * (the pool can only move while stopped); destroying stops it again and
+ * hands it back its internal pool. The VideoResource must outlive this.
+ *
+ * Usage:
+ *   VideoTexture surface(*video);      // NV12
+ *   video->play(true);
+ *   // once per frame, on the render thread:
+ *   surface.update();
+ *   if (surface.isReady()) { bind surface.getDescriptorImageInfo(0) and (1) }
+ */
+class VideoTexture {
+public:
+    // Frames whose GPU copies can be in flight at once (the pool keeps
+    // spare slots for this many)
+    static constexpr size_t MAX_IN_FLIGHT = 3;
+
+private:
+    struct Plane {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        vkcore::GpuAllocation alloc;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t texelSize = 1;
+    };
+
+    struct InFlight {
+        int slot = -1;
+        vkcore::UploadBatch::Ticket ticket = vkcore::UploadBatch::NO_UPLOAD;
+    };
+
+    VideoResource* m_video = nullptr;
+    VideoResource::FrameFormat m_format = VideoResource::FrameFormat::NV12;
+    Plane m_planes[2];
+    uint32_t m_planeCount = 0;
+    VkSampler m_sampler = VK_NULL_HANDLE;
+
+    VkBuffer m_staging = VK_NULL_HANDLE;
+    vkcore::GpuAllocation m_stagingAlloc;
+
+    std::vector<InFlight> m_inFlight;
+    uint64_t m_uploadedSerial = 0;
+    vkcore::UploadBatch::Ticket m_lastTicket = vkcore::UploadBatch::NO_UPLOAD;
+    bool m_ready = false;
+
+    static vkcore::GpuAllocator& gpuAllocator() {
+        return vkcore::GpuAllocator::shared(g_device, g_physicalDevice);
+    }
+
+    static vkcore::UploadBatch& uploads() {
+        return vkcore::UploadBatch::shared();
+    }
+
+    void createPlane(Plane& plane, VkFormat format, uint32_t texelSize, uint32_t width, uint32_t height) {
+        plane.format = format;
+        plane.texelSize = texelSize;
+        plane.width = width;
+        plane.height = height;
+
+        VkImageCreateInfo imageInfo = {};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = width;
+        imageInfo.extent.height = height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (!gpuAllocator().createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, plane.image, plane.alloc)) {
+            throw std::runtime_error("Failed to create video plane image");
+        }
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = plane.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = format;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(g_device, &viewInfo, nullptr, &plane.view) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create video plane view");
+        }
+    }
+
+    void createSampler() {
+        VkSamplerCreateInfo samplerInfo = {};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = 0.0f;
+
+        if (vkCreateSampler(g_device, &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create video sampler");
+        }
+    }
+
+    // Hand retained slots back once the copies reading them have landed
+    void retireUploads(bool wait) {
+        for (size_t i = 0; i < m_inFlight.size();) {
+            if (wait) uploads().wait(m_inFlight[i].ticket);
+            if (uploads().isComplete(m_inFlight[i].ticket)) {
+                m_video->releaseFrame(m_inFlight[i].slot);
+                m_inFlight.erase(m_inFlight.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    void cleanup() {
+        if (m_video) {
+            retireUploads(true);
+            uploads().wait(m_lastTicket);
+            m_video->stop();
+            m_video->setFrameStorage(nullptr, 0);
+        }
+        if (m_sampler != VK_NULL_HANDLE) {
+            vkDestroySampler(g_device, m_sampler, nullptr);
+            m_sampler = VK_NULL_HANDLE;
+        }
+        for (Plane& plane : m_planes) {
+            if (plane.view != VK_NULL_HANDLE) {
+                vkDestroyImageView(g_device, plane.view, nullptr);
+                plane.view = VK_NULL_HANDLE;
+            }
+            gpuAllocator().destroyImage(plane.image, plane.alloc);
+        }
+        gpuAllocator().destroyBuffer(m_staging, m_stagingAlloc);
+        m_planeCount = 0;
+        m_ready = false;
+    }
+
+public:
+    /**
+     * Constructor - Creates images and staging memory for `video`'s
+     * resolution and moves its frame pool into the staging buffer
+     * @param video Video to display (stopped if playing)
+     * @param format NV12 (shader converts) or RGBA (CPU converts)
+     * @throws std::runtime_error if resource creation fails
+     */
+    explicit VideoTexture(VideoResource& video,
+                          VideoResource::FrameFormat format = VideoResource::FrameFormat::NV12)
+        : m_format(format) {
+        if (!video.isLoaded()) {
+            throw std::runtime_error("VideoTexture needs a loaded video");
+        }
+        try {
+            video.stop();
+            video.setFrameFormat(format);
+
+            uint32_t width = static_cast<uint32_t>(video.getWidth());
+            uint32_t height = static_cast<uint32_t>(video.getHeight());
+            if (format == VideoResource::FrameFormat::NV12) {
+                createPlane(m_planes[0], VK_FORMAT_R8_UNORM, 1, width, height);
+                createPlane(m_planes[1], VK_FORMAT_R8G8_UNORM, 2, (width + 1) / 2, (height + 1) / 2);
+                m_planeCount = 2;
+            } else {
+                createPlane(m_planes[0], VK_FORMAT_R8G8B8A8_UNORM, 4, width, height);
+                m_planeCount = 1;
+            }
+            createSampler();
+
+            VkDeviceSize storageSize = video.getFrameStorageSize();
+            if (!gpuAllocator().createBuffer(storageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                             m_staging, m_stagingAlloc) ||
+                !m_stagingAlloc.mapped) {
+                throw std::runtime_error("Failed to create video staging buffer");
+            }
+            video.setFrameStorage(m_stagingAlloc.mapped, static_cast<size_t>(storageSize));
+            m_video = &video;
+            m_uploadedSerial = video.getFrameSerial();
+        } catch (const std::exception&) {
+            cleanup();
+            throw;
+        }
+    }
+
+    VideoTexture(const VideoTexture&) = delete;
+    VideoTexture& operator=(const VideoTexture&) = delete;
+
+    ~VideoTexture() {
+        cleanup();
+    }
+
+    /**
+     * Advance the video and copy a new frame into the images (render
+     * thread, once per frame; inside an UploadBatch begin()/end() the copy
+     * joins that batch)
+     * @return true if a new frame was uploaded
+     */
+    bool update() {
+        uploads().poll();
+        retireUploads(false);
+
+        m_video->update();
+        if (m_video->getFrameSerial() == m_uploadedSerial) {
+            return false;
+        }
+        // Every retained slot is still being copied: skip this frame rather
+        // than starve the decoder
+        if (m_inFlight.size() >= MAX_IN_FLIGHT) {
+            return false;
+        }
+        int slot = m_video->retainCurrentFrame();
+        if (slot < 0) {
+            return false;
+        }
+
+        VkDeviceSize base = m_video->getFrameOffset(slot);
+        vkcore::UploadBatch::Ticket ticket = vkcore::UploadBatch::NO_UPLOAD;
+        uploads().begin();
+        for (uint32_t i = 0; i < m_planeCount; i++) {
+            const Plane& plane = m_planes[i];
+            VkBufferImageCopy region = {};
+            region.bufferOffset = base + m_video->getPlaneOffset(static_cast<int>(i));
+            region.bufferRowLength = static_cast<uint32_t>(m_video->getPlanePitch(static_cast<int>(i))) /
+                                     plane.texelSize;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = 0;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageExtent = {plane.width, plane.height, 1};
+            ticket = uploads().copyBufferToImage(plane.image, m_staging, &region, 1);
+        }
+        uploads().end();
+
+        if (ticket == vkcore::UploadBatch::NO_UPLOAD) {
+            m_video->releaseFrame(slot);
+            return false;
+        }
+        m_inFlight.push_back({slot, ticket});
+        m_lastTicket = ticket;
+        m_uploadedSerial = m_video->getFrameSerial();
+        m_ready = true;
+        return true;
+    }
+
+    /**
+     * True once a frame has been copied (images hold valid data)
+     */
+    bool isReady() const { return m_ready; }
+
+    VideoResource::FrameFormat getFormat() const { return m_format; }
+    uint32_t getPlaneCount() const { return m_planeCount; }
+    VkImage getImage(uint32_t plane = 0) const { return plane < m_planeCount ? m_planes[plane].image : VK_NULL_HANDLE; }
+    VkImageView getImageView(uint32_t plane = 0) const {
+        return plane < m_planeCount ? m_planes[plane].view : VK_NULL_HANDLE;
+    }
+    VkSampler getSampler() const { return m_sampler; }
+
+    // Specialization constants for video_nv12.frag
+    bool isBT709() const { return m_video->isBT709(); }
+    bool isFullRange() const { return m_video->isFullRange(); }
+
+    // Get descriptor image info for a plane (Y = 0, UV = 1; RGBA = 0)
+    VkDescriptorImageInfo getDescriptorImageInfo(uint32_t plane = 0) const {
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = getImageView(plane);
+        imageInfo.sampler = m_sampler;
+        return imageInfo;
+    }
+};
+
+#endif // EDEN_VIDEO_TEXTURE_H
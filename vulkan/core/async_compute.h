@@ -0,0 +1,315 @@
+// ============================================================================
+// ASYNC COMPUTE - Compute batches on a dedicated queue, ordered by timelines
+// ============================================================================
+// Most desktop GPUs expose a compute-only queue family next to graphics.
+// Work submitted there overlaps rendering instead of queueing behind it.
+// Two timeline semaphores (VK_KHR_timeline_semaphore) order the queues:
+//
+//   - Compute timeline: every submit() signals the next value. A graphics
+//     batch using the results waits for it only at the stages that read
+//     them, so its earlier work runs alongside.
+//   - Graphics timeline: VulkanCore's frame batch signals its frame number.
+//     submit(record, afterGraphics) waits for that frame first - for work
+//     that overwrites what the frame still reads.
+//
+// Command buffers are recycled once the compute timeline passes them; no
+// fences. Resources both queues touch must be VK_SHARING_MODE_CONCURRENT
+// (VulkanCore::createSharedBuffer / createSharedImage) - nothing here
+// transfers queue ownership. Barriers recorded for the compute queue may
+// only name stages it has (compute, transfer, draw-indirect); the semaphore
+// wait stands in for the graphics-side half.
+//
+// Header-only, like upload_manager.h. Not thread-safe: call from the render
+// thread.
+//
+// Usage:
+//   AsyncComputeSupport support = AsyncCompute::querySupport(instance, physicalDevice, deviceExtensions);
+//   if (support.supported) { support.features.pNext = (void*)deviceInfo.pNext; deviceInfo.pNext = &support.features; }
+//   ... vkCreateDevice ...
+//   compute.init(device, computeQueue, computeFamily);
+//   uint64_t done = compute.submit([&](VkCommandBuffer cmd) { ... }, frameNumber - 1);
+//   // frame submit: wait getComputeSemaphore() >= done at the consuming
+//   //               stages, signal getGraphicsSemaphore() = frameNumber
+//   compute.shutdown();                      // before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_ASYNC_COMPUTE_H
+#define VKCORE_ASYNC_COMPUTE_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+struct AsyncComputeSupport {
+    bool supported = false;
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR features{};  // Chain into VkDeviceCreateInfo::pNext
+};
+
+class AsyncCompute {
+public:
+    static constexpr uint64_t NO_WORK = 0;  // Timeline value that is always reached
+
+    AsyncCompute() = default;
+    ~AsyncCompute() { shutdown(); }
+
+    AsyncCompute(const AsyncCompute&) = delete;
+    AsyncCompute& operator=(const AsyncCompute&) = delete;
+
+    // ========================================================================
+    // Device Setup
+    // ========================================================================
+
+    // When supported, appends the device extension to enable and fills
+    // support.features (keep it alive until vkCreateDevice returns). Needs
+    // VK_KHR_get_physical_device_properties2 on the instance.
+    static AsyncComputeSupport querySupport(VkInstance instance, VkPhysicalDevice physicalDevice,
+                                            std::vector<const char*>& deviceExtensions) {
+        AsyncComputeSupport support;
+
+        uint32_t extCount = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extCount);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, extensions.data());
+        bool hasTimeline = false;
+        for (const auto& ext : extensions) {
+            if (strcmp(ext.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0) hasTimeline = true;
+        }
+        if (!hasTimeline) return support;
+
+        auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+            vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+        if (!getFeatures2) return support;
+
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline{};
+        timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+        VkPhysicalDeviceFeatures2KHR features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features.pNext = &timeline;
+        getFeatures2(physicalDevice, &features);
+        if (!timeline.timelineSemaphore) return support;
+
+        support.supported = true;
+        support.features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+        support.features.timelineSemaphore = VK_TRUE;
+        deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        return support;
+    }
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    // queue: of `family`, on a device created with querySupport()'s features
+    bool init(VkDevice device, VkQueue queue, uint32_t family) {
+        if (m_device != VK_NULL_HANDLE) return true;
+
+        m_waitSemaphores = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(
+            vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+        m_getCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+            vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+        m_signalSemaphore = reinterpret_cast<PFN_vkSignalSemaphoreKHR>(
+            vkGetDeviceProcAddr(device, "vkSignalSemaphoreKHR"));
+        if (!m_waitSemaphores || !m_getCounterValue || !m_signalSemaphore) {
+            std::cerr << "[AsyncCompute] Timeline semaphore entry points missing" << std::endl;
+            return false;
+        }
+
+        m_device = device;
+        m_queue = queue;
+        m_family = family;
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = family;
+
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_pool) != VK_SUCCESS ||
+            !createTimeline(m_computeTimeline) || !createTimeline(m_graphicsTimeline)) {
+            std::cerr << "[AsyncCompute] Failed to create the command pool or timelines" << std::endl;
+            shutdown();
+            return false;
+        }
+        return true;
+    }
+
+    // Waits for submitted work, then frees everything
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        if (m_computeTimeline != VK_NULL_HANDLE) wait(m_submitted);
+        if (m_pool != VK_NULL_HANDLE) vkDestroyCommandPool(m_device, m_pool, nullptr);  // Frees the buffers
+        if (m_computeTimeline != VK_NULL_HANDLE) vkDestroySemaphore(m_device, m_computeTimeline, nullptr);
+        if (m_graphicsTimeline != VK_NULL_HANDLE) vkDestroySemaphore(m_device, m_graphicsTimeline, nullptr);
+        m_pool = VK_NULL_HANDLE;
+        m_computeTimeline = VK_NULL_HANDLE;
+        m_graphicsTimeline = VK_NULL_HANDLE;
+        m_batches.clear();
+        m_submitted = 0;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isEnabled() const { return m_device != VK_NULL_HANDLE; }
+
+    // ========================================================================
+    // Submission
+    // ========================================================================
+
+    // Records one batch and submits it. afterGraphics: graphics frame
+    // number that must have finished first (NO_WORK = none). Returns the
+    // compute timeline value that signals when the batch is done, or
+    // NO_WORK if it could not be submitted.
+    uint64_t submit(const std::function<void(VkCommandBuffer cmd)>& record, uint64_t afterGraphics = NO_WORK) {
+        if (m_device == VK_NULL_HANDLE) return NO_WORK;
+
+        Batch* found = acquireBatch();
+        if (!found) return NO_WORK;
+        Batch& batch = *found;
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(batch.cmd, &beginInfo);
+        record(batch.cmd);
+        vkEndCommandBuffer(batch.cmd);
+
+        uint64_t value = m_submitted + 1;
+        VkTimelineSemaphoreSubmitInfoKHR timeline{};
+        timeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timeline.waitSemaphoreValueCount = afterGraphics != NO_WORK ? 1 : 0;
+        timeline.pWaitSemaphoreValues = &afterGraphics;
+        timeline.signalSemaphoreValueCount = 1;
+        timeline.pSignalSemaphoreValues = &value;
+
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timeline;
+        submitInfo.waitSemaphoreCount = timeline.waitSemaphoreValueCount;
+        submitInfo.pWaitSemaphores = &m_graphicsTimeline;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.cmd;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &m_computeTimeline;
+
+        if (vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            std::cerr << "[AsyncCompute] vkQueueSubmit failed - batch dropped" << std::endl;
+            batch.value = NO_WORK;  // Never submitted: free again
+            return NO_WORK;
+        }
+        batch.value = value;
+        m_submitted = value;
+        return value;
+    }
+
+    // ========================================================================
+    // Completion
+    // ========================================================================
+
+    uint64_t getCompletedValue() const {
+        uint64_t value = 0;
+        if (m_device != VK_NULL_HANDLE) m_getCounterValue(m_device, m_computeTimeline, &value);
+        return value;
+    }
+    bool isComplete(uint64_t value) const { return value == NO_WORK || value <= getCompletedValue(); }
+
+    // Blocks until the compute timeline reaches value
+    void wait(uint64_t value) const {
+        if (m_device == VK_NULL_HANDLE || value == NO_WORK) return;
+        VkSemaphoreWaitInfoKHR waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_computeTimeline;
+        waitInfo.pValues = &value;
+        m_waitSemaphores(m_device, &waitInfo, UINT64_MAX);
+    }
+
+    // Moves the graphics timeline to `frame` from the host, for a frame whose
+    // submit failed - compute batches waiting on it would never run. Only
+    // once the graphics queue is idle: a lower value still pending on the
+    // GPU can't be signalled after this one.
+    void signalGraphics(uint64_t frame) const {
+        if (m_device == VK_NULL_HANDLE) return;
+        uint64_t current = 0;
+        m_getCounterValue(m_device, m_graphicsTimeline, &current);
+        if (frame <= current) return;
+        VkSemaphoreSignalInfoKHR signalInfo{};
+        signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+        signalInfo.semaphore = m_graphicsTimeline;
+        signalInfo.value = frame;
+        m_signalSemaphore(m_device, &signalInfo);
+    }
+
+    // For the graphics side of the handshake (see the header comment)
+    VkSemaphore getComputeSemaphore() const { return m_computeTimeline; }
+    VkSemaphore getGraphicsSemaphore() const { return m_graphicsTimeline; }
+    uint64_t getSubmittedValue() const { return m_submitted; }
+    VkQueue getQueue() const { return m_queue; }
+    uint32_t getFamily() const { return m_family; }
+
+private:
+    struct Batch {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        uint64_t value = NO_WORK;  // Compute timeline value it signals
+    };
+
+    bool createTimeline(VkSemaphore& semaphore) {
+        VkSemaphoreTypeCreateInfoKHR typeInfo{};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+        return vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &semaphore) == VK_SUCCESS;
+    }
+
+    // A buffer the compute timeline has passed, or a new one
+    Batch* acquireBatch() {
+        uint64_t completed = getCompletedValue();
+        for (Batch& batch : m_batches) {
+            if (batch.value <= completed) {
+                vkResetCommandBuffer(batch.cmd, 0);
+                return &batch;
+            }
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        Batch batch;
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &batch.cmd) != VK_SUCCESS) {
+            std::cerr << "[AsyncCompute] Failed to allocate a command buffer" << std::endl;
+            return nullptr;
+        }
+        m_batches.push_back(batch);
+        return &m_batches.back();
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    uint32_t m_family = 0;
+    VkCommandPool m_pool = VK_NULL_HANDLE;
+    VkSemaphore m_computeTimeline = VK_NULL_HANDLE;
+    VkSemaphore m_graphicsTimeline = VK_NULL_HANDLE;
+    PFN_vkWaitSemaphoresKHR m_waitSemaphores = nullptr;
+    PFN_vkGetSemaphoreCounterValueKHR m_getCounterValue = nullptr;
+    PFN_vkSignalSemaphoreKHR m_signalSemaphore = nullptr;
+
+    std::vector<Batch> m_batches;  // Recycled by timeline value (a handful: one per frame in flight)
+    uint64_t m_submitted = 0;      // Last value signalled by a submitted batch
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_ASYNC_COMPUTE_H
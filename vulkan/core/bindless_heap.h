@@ -0,0 +1,464 @@
+// ============================================================================
+// BINDLESS HEAP - One update-after-bind sampler2D[] for every texture
+// ============================================================================
+// Instead of a descriptor set per texture, each texture takes a slot in one
+// big COMBINED_IMAGE_SAMPLER array (VK_EXT_descriptor_indexing). The set is
+// bound once per pipeline bind; draws select their texture by passing the
+// slot index in push constants, so changing textures costs no descriptor
+// set binds at all.
+//
+//   - Slots come from a free list. remove() retires a slot for
+//     framesInFlight frames (beginFrame() recycles it) so a frame still in
+//     flight never samples a reused slot.
+//   - A slot is only written while no frame can use it: add() writes a free
+//     slot, beginFrame() points retired slots at the fallback texture as it
+//     frees them, and replace() moves a texture to a fresh slot rather than
+//     rewriting its live one. Never-used and recycled slots read white.
+//   - The heap never grows or reallocates: a recycled slot is rewritten in
+//     place, so texture churn costs one descriptor write per add(), and
+//     getStats() shows how much of it is reuse.
+//   - UPDATE_AFTER_BIND + UPDATE_UNUSED_WHILE_PENDING + PARTIALLY_BOUND:
+//     slots other frames don't use may be written while command buffers
+//     that use the set are recording or in flight.
+//   - Binding TEXEL_DENSITY_BINDING is one uint per slot for streaming
+//     feedback (texture_streamer.h); shaders that don't report ignore it
+//     and it may stay unbound.
+//
+// The device must be created with the features querySupport() reports;
+// chain BindlessSupport::features into VkDeviceCreateInfo::pNext.
+//
+// Header-only, like gpu_allocator.h.
+//
+// Usage:
+//   BindlessHeap::addInstanceExtensions(instanceExtensions);   // before vkCreateInstance
+//   BindlessSupport support = BindlessHeap::querySupport(instance, physicalDevice, deviceExtensions);
+//   if (support.supported) deviceInfo.pNext = &support.features;
+//   heap.init(device, std::min(4096u, support.maxTextures), framesInFlight);
+//   uint32_t index = heap.add(view, sampler);                  // per texture
+//   heap.bind(cmd, pipelineLayout, 1);                         // after vkCmdBindPipeline
+//   vkCmdPushConstants(cmd, pipelineLayout, ..., &index);      // per draw
+//
+// GLSL:
+//   #extension GL_EXT_nonuniform_qualifier : require
+//   layout(set = 1, binding = 0) uniform sampler2D textures[];
+//   texture(textures[push.textureIndex], uv)
+//   layout(std430, set = 1, binding = 1) buffer TexelDensity { uint texelDensity[]; };  // Optional
+// ============================================================================
+
+#ifndef VKCORE_BINDLESS_HEAP_H
+#define VKCORE_BINDLESS_HEAP_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+namespace vkcore {
+
+// Streaming feedback: one uint per slot (see TextureStreamer)
+static constexpr uint32_t TEXEL_DENSITY_BINDING = 1;
+
+struct BindlessSupport {
+    bool supported = false;
+    uint32_t maxTextures = 0;  // Device limit for one update-after-bind sampler array
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT features{};  // Exactly the features the heap needs
+};
+
+class BindlessHeap {
+public:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+    static constexpr uint32_t DEFAULT_CAPACITY = 4096;
+
+    BindlessHeap() = default;
+    ~BindlessHeap() { shutdown(); }
+
+    BindlessHeap(const BindlessHeap&) = delete;
+    BindlessHeap& operator=(const BindlessHeap&) = delete;
+
+    // Process-wide heap for code paths without a VulkanCore (the EDEN
+    // helpers, generated HEIDIC code). First call with a valid device
+    // initializes it; those paths don't call beginFrame(), so removed slots
+    // are only recycled if their owner does.
+    static BindlessHeap& shared(VkDevice device = VK_NULL_HANDLE, uint32_t capacity = DEFAULT_CAPACITY) {
+        static BindlessHeap s_shared;
+        if (!s_shared.isInitialized() && device != VK_NULL_HANDLE) {
+            s_shared.init(device, capacity, 3);
+        }
+        return s_shared;
+    }
+
+    // ========================================================================
+    // Device setup
+    // ========================================================================
+
+    // Adds VK_KHR_get_physical_device_properties2 if the loader has it - on a
+    // Vulkan 1.0 instance querySupport() needs it to see the features
+    static void addInstanceExtensions(std::vector<const char*>& extensions) {
+        uint32_t count = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> available(count);
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, available.data());
+        for (const auto& ext : available) {
+            if (strcmp(ext.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0) {
+                extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+                return;
+            }
+        }
+    }
+
+    // When supported, appends the device extensions to enable and fills
+    // support.features for VkDeviceCreateInfo::pNext (keep it alive until
+    // vkCreateDevice returns)
+    static BindlessSupport querySupport(VkInstance instance, VkPhysicalDevice physicalDevice,
+                                        std::vector<const char*>& deviceExtensions) {
+        BindlessSupport support;
+
+        uint32_t extCount = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extCount);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, extensions.data());
+        auto hasExtension = [&](const char* name) {
+            for (const auto& ext : extensions) {
+                if (strcmp(ext.extensionName, name) == 0) return true;
+            }
+            return false;
+        };
+        if (!hasExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) ||
+            !hasExtension(VK_KHR_MAINTENANCE3_EXTENSION_NAME)) {
+            return support;
+        }
+
+        auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+            vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+        auto getProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2KHR>(
+            vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceProperties2KHR"));
+        if (!getFeatures2 || !getProperties2) return support;
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing{};
+        indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        VkPhysicalDeviceFeatures2KHR features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features.pNext = &indexing;
+        getFeatures2(physicalDevice, &features);
+
+        if (!indexing.runtimeDescriptorArray || !indexing.descriptorBindingPartiallyBound ||
+            !indexing.descriptorBindingSampledImageUpdateAfterBind ||
+            !indexing.descriptorBindingUpdateUnusedWhilePending) {
+            return support;
+        }
+
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT limits{};
+        limits.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2KHR props{};
+        props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+        props.pNext = &limits;
+        getProperties2(physicalDevice, &props);
+
+        support.supported = true;
+        support.maxTextures = std::min({limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                        limits.maxDescriptorSetUpdateAfterBindSamplers,
+                                        limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                        limits.maxPerStageDescriptorUpdateAfterBindSamplers});
+        support.features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        support.features.runtimeDescriptorArray = VK_TRUE;
+        support.features.descriptorBindingPartiallyBound = VK_TRUE;
+        support.features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        support.features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        support.features.shaderSampledImageArrayNonUniformIndexing = indexing.shaderSampledImageArrayNonUniformIndexing;
+
+        deviceExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+        deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        return support;
+    }
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    // capacity: slots in the array (clamp to BindlessSupport::maxTextures)
+    bool init(VkDevice device, uint32_t capacity, uint32_t framesInFlight) {
+        if (m_device != VK_NULL_HANDLE) return true;
+        if (capacity == 0) return false;
+
+        VkDescriptorSetLayoutBinding bindings[2]{};
+        bindings[0].binding = 0;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount = capacity;
+        bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+        bindings[1].binding = TEXEL_DENSITY_BINDING;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+        // The density buffer is written once, before the set is first bound,
+        // so it doesn't need (or count against) the update-after-bind limits
+        VkDescriptorBindingFlagsEXT flags[2] = {
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT,
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT};
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlags{};
+        bindingFlags.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        bindingFlags.bindingCount = 2;
+        bindingFlags.pBindingFlags = flags;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = &bindingFlags;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        layoutInfo.bindingCount = 2;
+        layoutInfo.pBindings = bindings;
+
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_layout) != VK_SUCCESS) {
+            std::cerr << "[BindlessHeap] Failed to create descriptor set layout" << std::endl;
+            return false;
+        }
+
+        VkDescriptorPoolSize poolSizes[2]{};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[0].descriptorCount = capacity;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[1].descriptorCount = 1;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = 2;
+        poolInfo.pPoolSizes = poolSizes;
+
+        if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
+            std::cerr << "[BindlessHeap] Failed to create descriptor pool" << std::endl;
+            vkDestroyDescriptorSetLayout(device, m_layout, nullptr);
+            m_layout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_pool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_layout;
+
+        if (vkAllocateDescriptorSets(device, &allocInfo, &m_set) != VK_SUCCESS) {
+            std::cerr << "[BindlessHeap] Failed to allocate descriptor set" << std::endl;
+            vkDestroyDescriptorPool(device, m_pool, nullptr);
+            vkDestroyDescriptorSetLayout(device, m_layout, nullptr);
+            m_pool = VK_NULL_HANDLE;
+            m_layout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        m_device = device;
+        m_capacity = capacity;
+        m_framesInFlight = std::max(framesInFlight, 1u);
+        m_frame = 0;
+        m_used = 0;
+        m_fresh = 0;
+        m_stats = Stats{};
+        m_freeList.clear();
+        m_retired.clear();
+        m_freeList.reserve(capacity);
+        for (uint32_t i = capacity; i > 0; i--) m_freeList.push_back(i - 1);  // Hand out 0 first
+
+        std::cout << "[BindlessHeap] " << capacity << " texture slots" << std::endl;
+        return true;
+    }
+
+    // Before vkDestroyDevice; the set itself is freed with the pool
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+        vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+        vkDestroyDescriptorSetLayout(m_device, m_layout, nullptr);
+        m_pool = VK_NULL_HANDLE;
+        m_layout = VK_NULL_HANDLE;
+        m_set = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+        m_freeList.clear();
+        m_retired.clear();
+        m_used = 0;
+    }
+
+    bool isInitialized() const { return m_device != VK_NULL_HANDLE; }
+
+    // Once per frame, after the frame's fence wait: slots removed
+    // framesInFlight frames ago - no frame in flight can sample them any
+    // more - are pointed at the fallback and go back on the free list
+    void beginFrame() {
+        if (m_device == VK_NULL_HANDLE) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frame++;
+        auto ready = [&](const Retired& r) { return m_frame - r.frame > m_framesInFlight; };
+        for (const Retired& r : m_retired) {
+            if (!ready(r)) continue;
+            if (m_fallbackView != VK_NULL_HANDLE) write(r.index, m_fallbackView, m_fallbackSampler);
+            m_freeList.push_back(r.index);
+        }
+        m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), ready), m_retired.end());
+    }
+
+    // ========================================================================
+    // Slots
+    // ========================================================================
+
+    // Written into every free slot now and every retired slot as
+    // beginFrame() frees it (typically a 1x1 white texture)
+    void setFallback(VkImageView view, VkSampler sampler) {
+        if (m_device == VK_NULL_HANDLE) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fallbackView = view;
+        m_fallbackSampler = sampler;
+        for (uint32_t index : m_freeList) write(index, view, sampler);
+    }
+
+    // Points TEXEL_DENSITY_BINDING at `buffer` (TextureStreamer's feedback,
+    // capacity uints). Not update-after-bind: call before the set is first
+    // bound, and only once.
+    void setTexelDensityBuffer(VkBuffer buffer, VkDeviceSize size) {
+        if (m_device == VK_NULL_HANDLE || buffer == VK_NULL_HANDLE) return;
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = buffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = size;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_set;
+        write.dstBinding = TEXEL_DENSITY_BINDING;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    }
+
+    // INVALID_INDEX when the heap is full or not initialized
+    uint32_t add(VkImageView view, VkSampler sampler) {
+        if (m_device == VK_NULL_HANDLE || view == VK_NULL_HANDLE || sampler == VK_NULL_HANDLE) return INVALID_INDEX;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeList.empty()) {
+            m_stats.rejected++;
+            if (!m_fullWarned) {
+                m_fullWarned = true;
+                std::cerr << "[BindlessHeap] All " << m_capacity << " slots in use - texture not registered" << std::endl;
+            }
+            return INVALID_INDEX;
+        }
+        uint32_t index = m_freeList.back();
+        m_freeList.pop_back();
+        m_used++;
+        
+        // Untouched slots come off the list in ascending order, below every
+        // recycled one, so anything under m_fresh has been used before
+        if (index < m_fresh) {
+            m_stats.recycled++;
+        } else {
+            m_fresh = index + 1;
+        }
+        m_stats.added++;
+        m_stats.peakUsed = std::max(m_stats.peakUsed, m_used);
+        
+        write(index, view, sampler);
+        return index;
+    }
+
+    // A new image for a texture (hot-reload, streaming): frames in flight
+    // may still sample `index`, so the image takes a fresh slot and `index`
+    // retires. Returns the new slot - INVALID_INDEX if the heap is full.
+    uint32_t replace(uint32_t index, VkImageView view, VkSampler sampler) {
+        uint32_t fresh = add(view, sampler);
+        remove(index);
+        return fresh;
+    }
+
+    // The caller may destroy the view/sampler once the frames using them
+    // are done; the slot keeps pointing at them until it's recycled
+    // framesInFlight frames later, so it must not be sampled after this
+    void remove(uint32_t index) {
+        if (m_device == VK_NULL_HANDLE || index >= m_capacity) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retired.push_back({index, m_frame});
+        m_used--;
+        m_stats.removed++;
+    }
+
+    // ========================================================================
+    // Binding
+    // ========================================================================
+
+    // Binds the heap at `setIndex` of `layout` (which must have been created
+    // with getLayout() at that index)
+    void bind(VkCommandBuffer cmd, VkPipelineLayout layout, uint32_t setIndex,
+              VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS) const {
+        if (m_set == VK_NULL_HANDLE) return;
+        vkCmdBindDescriptorSets(cmd, bindPoint, layout, setIndex, 1, &m_set, 0, nullptr);
+    }
+
+    VkDescriptorSetLayout getLayout() const { return m_layout; }
+    VkDescriptorSet getSet() const { return m_set; }
+    uint32_t getCapacity() const { return m_capacity; }
+    uint32_t getUsedCount() const { return m_used; }
+
+    // Since init(); `recycled` counts adds served by a slot freed earlier,
+    // `rejected` adds that found the heap full
+    struct Stats {
+        uint64_t added = 0;
+        uint64_t recycled = 0;
+        uint64_t removed = 0;
+        uint64_t rejected = 0;
+        uint32_t peakUsed = 0;
+    };
+    Stats getStats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    struct Retired {
+        uint32_t index;
+        uint64_t frame;
+    };
+
+    void write(uint32_t index, VkImageView view, VkSampler sampler) {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageView = view;
+        imageInfo.sampler = sampler;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_set;
+        write.dstBinding = 0;
+        write.dstArrayElement = index;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    VkDescriptorSet m_set = VK_NULL_HANDLE;
+    uint32_t m_capacity = 0;
+    uint32_t m_framesInFlight = 1;
+    uint32_t m_used = 0;
+    uint32_t m_fresh = 0;  // Slots below this have been handed out before
+    uint64_t m_frame = 0;
+    Stats m_stats;
+    bool m_fullWarned = false;
+
+    VkImageView m_fallbackView = VK_NULL_HANDLE;
+    VkSampler m_fallbackSampler = VK_NULL_HANDLE;
+
+    std::vector<uint32_t> m_freeList;
+    std::vector<Retired> m_retired;
+    std::mutex m_mutex;  // add/remove may come from loader or recording threads
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_BINDLESS_HEAP_H
@@ -0,0 +1,299 @@
+// ============================================================================
+// DESCRIPTOR ALLOCATOR - Growable descriptor pools
+// ============================================================================
+// Replaces a single fixed-size VkDescriptorPool with chains of pools:
+//
+//   - allocate(): long-lived sets. When every pool in the chain runs out
+//     (VK_ERROR_OUT_OF_POOL_MEMORY / VK_ERROR_FRAGMENTED_POOL) a new pool,
+//     twice the size of the last, is added and the allocation retried.
+//   - free(): returns a long-lived set. The vkFreeDescriptorSets is deferred
+//     framesInFlight frames so a frame still in flight never loses its set.
+//   - allocateTransient(): sets valid for the current frame only. Each frame
+//     slot has its own pool chain, reset in bulk by beginFrame() once that
+//     slot's fence has signalled - no per-set frees at all.
+//
+// Pools hold a fixed mix of descriptor types per set (poolRatios()), which
+// covers VulkanCore, LightingManager, FacialSystem and GpuScene.
+//
+// Header-only, like gpu_allocator.h.
+//
+// Usage:
+//   DescriptorAllocator descriptors;
+//   descriptors.init(device, framesInFlight);
+//   VkDescriptorSet set = descriptors.allocate(layout);            // until free(set)
+//   descriptors.beginFrame(frameIndex);                            // after the fence wait
+//   VkDescriptorSet tmp = descriptors.allocateTransient(layout);   // this frame only
+//   descriptors.free(set);
+//   descriptors.shutdown();                                        // before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_DESCRIPTOR_ALLOCATOR_H
+#define VKCORE_DESCRIPTOR_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+namespace vkcore {
+
+struct DescriptorAllocatorStats {
+    uint32_t liveSets = 0;          // allocate() minus free()
+    uint32_t pendingFrees = 0;      // free()d, waiting on in-flight frames
+    uint32_t transientSets = 0;     // allocateTransient() in the current frame
+    uint32_t persistentPools = 0;
+    uint32_t transientPools = 0;    // Across all frame slots
+};
+
+class DescriptorAllocator {
+public:
+    static constexpr uint32_t INITIAL_SETS_PER_POOL = 64;
+    static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+    DescriptorAllocator() = default;
+    ~DescriptorAllocator() { shutdown(); }
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VkDevice device, uint32_t framesInFlight) {
+        if (m_device != VK_NULL_HANDLE) return true;
+        if (device == VK_NULL_HANDLE || framesInFlight == 0) return false;
+        m_device = device;
+        m_framesInFlight = framesInFlight;
+        m_frames.assign(framesInFlight, FrameChain{});
+        m_nextPoolSets = INITIAL_SETS_PER_POOL;
+        return true;
+    }
+
+    // Destroying a pool frees every set allocated from it
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+        for (VkDescriptorPool pool : m_pools) vkDestroyDescriptorPool(m_device, pool, nullptr);
+        for (FrameChain& frame : m_frames) {
+            for (VkDescriptorPool pool : frame.pools) vkDestroyDescriptorPool(m_device, pool, nullptr);
+        }
+        m_pools.clear();
+        m_frames.clear();
+        m_owners.clear();
+        m_pendingFrees.clear();
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isInitialized() const { return m_device != VK_NULL_HANDLE; }
+
+    // Once per frame, after frameIndex's fence wait: resets that slot's
+    // transient pools and performs frees old enough to be safe
+    void beginFrame(uint32_t frameIndex) {
+        if (m_device == VK_NULL_HANDLE) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frame++;
+        m_currentSlot = frameIndex % m_framesInFlight;
+
+        FrameChain& frame = m_frames[m_currentSlot];
+        for (VkDescriptorPool pool : frame.pools) vkResetDescriptorPool(m_device, pool, 0);
+        frame.active = 0;
+        frame.setCount = 0;
+
+        auto ready = [&](const PendingFree& f) { return m_frame - f.frame > m_framesInFlight; };
+        for (const PendingFree& f : m_pendingFrees) {
+            if (ready(f)) vkFreeDescriptorSets(m_device, f.pool, 1, &f.set);
+        }
+        m_pendingFrees.erase(std::remove_if(m_pendingFrees.begin(), m_pendingFrees.end(), ready),
+                             m_pendingFrees.end());
+    }
+
+    // ========================================================================
+    // Allocation
+    // ========================================================================
+
+    // VK_NULL_HANDLE on failure (layout invalid, device out of memory)
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout) {
+        if (m_device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Newest pool first; older ones only have room again after frees
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        for (auto it = m_pools.rbegin(); it != m_pools.rend(); ++it) {
+            VkResult result = allocateFrom(*it, layout, set);
+            if (result == VK_SUCCESS) {
+                m_owners[set] = *it;
+                return set;
+            }
+            if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+                std::cerr << "[DescriptorAllocator] vkAllocateDescriptorSets failed (" << result << ")" << std::endl;
+                return VK_NULL_HANDLE;
+            }
+        }
+
+        // Every pool is full - grow: each new pool is twice the last, up to MAX_SETS_PER_POOL
+        VkDescriptorPool pool = createPool(m_nextPoolSets, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+        if (pool == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+        m_pools.push_back(pool);
+        if (m_pools.size() > 1) {
+            std::cout << "[DescriptorAllocator] Pool " << m_pools.size() << " added ("
+                      << m_nextPoolSets << " sets)" << std::endl;
+        }
+        m_nextPoolSets = std::min(m_nextPoolSets * 2, MAX_SETS_PER_POOL);
+
+        VkResult result = allocateFrom(pool, layout, set);
+        if (result != VK_SUCCESS) {
+            std::cerr << "[DescriptorAllocator] vkAllocateDescriptorSets failed (" << result << ")" << std::endl;
+            return VK_NULL_HANDLE;
+        }
+        m_owners[set] = pool;
+        return set;
+    }
+
+    // Safe to call while frames that use the set are in flight
+    void free(VkDescriptorSet set) {
+        if (m_device == VK_NULL_HANDLE || set == VK_NULL_HANDLE) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_owners.find(set);
+        if (it == m_owners.end()) return;
+        m_pendingFrees.push_back({set, it->second, m_frame});
+        m_owners.erase(it);
+    }
+
+    // Valid until beginFrame() comes back around to this frame slot
+    VkDescriptorSet allocateTransient(VkDescriptorSetLayout layout) {
+        if (m_device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FrameChain& frame = m_frames[m_currentSlot];
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        while (true) {
+            if (frame.active == frame.pools.size()) {
+                uint32_t sets = std::min(INITIAL_SETS_PER_POOL << frame.pools.size(), MAX_SETS_PER_POOL);
+                VkDescriptorPool pool = createPool(sets, 0);
+                if (pool == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+                frame.pools.push_back(pool);
+            }
+
+            VkResult result = allocateFrom(frame.pools[frame.active], layout, set);
+            if (result == VK_SUCCESS) break;
+            if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+                std::cerr << "[DescriptorAllocator] Transient allocation failed (" << result << ")" << std::endl;
+                return VK_NULL_HANDLE;
+            }
+            // This pool is full for the rest of the frame - move to the next
+            frame.active++;
+        }
+
+        frame.setCount++;
+        return set;
+    }
+
+    // ========================================================================
+    // Stats
+    // ========================================================================
+
+    DescriptorAllocatorStats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DescriptorAllocatorStats stats;
+        stats.liveSets = static_cast<uint32_t>(m_owners.size());
+        stats.pendingFrees = static_cast<uint32_t>(m_pendingFrees.size());
+        stats.persistentPools = static_cast<uint32_t>(m_pools.size());
+        if (!m_frames.empty()) stats.transientSets = m_frames[m_currentSlot].setCount;
+        for (const FrameChain& frame : m_frames) {
+            stats.transientPools += static_cast<uint32_t>(frame.pools.size());
+        }
+        return stats;
+    }
+
+    void printStats() const {
+        DescriptorAllocatorStats stats = getStats();
+        std::cout << "[DescriptorAllocator] " << stats.liveSets << " live sets in "
+                  << stats.persistentPools << " pools, " << stats.transientPools
+                  << " transient pools" << std::endl;
+    }
+
+private:
+    static constexpr uint32_t RATIO_COUNT = 5;
+
+    struct PoolRatio {
+        VkDescriptorType type;
+        uint32_t perSet;
+    };
+
+    struct PendingFree {
+        VkDescriptorSet set;
+        VkDescriptorPool pool;
+        uint64_t frame;
+    };
+
+    struct FrameChain {
+        std::vector<VkDescriptorPool> pools;
+        size_t active = 0;          // First pool that may still have room
+        uint32_t setCount = 0;
+    };
+
+    // Descriptors reserved per set in every pool
+    static const PoolRatio* poolRatios() {
+        static const PoolRatio ratios[RATIO_COUNT] = {
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4},
+            {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
+        };
+        return ratios;
+    }
+
+    VkDescriptorPool createPool(uint32_t maxSets, VkDescriptorPoolCreateFlags flags) {
+        VkDescriptorPoolSize sizes[RATIO_COUNT];
+        const PoolRatio* ratios = poolRatios();
+        for (uint32_t i = 0; i < RATIO_COUNT; i++) {
+            sizes[i].type = ratios[i].type;
+            sizes[i].descriptorCount = ratios[i].perSet * maxSets;
+        }
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = flags;
+        poolInfo.maxSets = maxSets;
+        poolInfo.poolSizeCount = RATIO_COUNT;
+        poolInfo.pPoolSizes = sizes;
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+            std::cerr << "[DescriptorAllocator] Failed to create descriptor pool (" << maxSets << " sets)" << std::endl;
+            return VK_NULL_HANDLE;
+        }
+        return pool;
+    }
+
+    VkResult allocateFrom(VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet& set) {
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = pool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+        return vkAllocateDescriptorSets(m_device, &allocInfo, &set);
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    uint32_t m_framesInFlight = 1;
+    uint32_t m_currentSlot = 0;
+    uint64_t m_frame = 0;
+    uint32_t m_nextPoolSets = INITIAL_SETS_PER_POOL;
+
+    std::vector<VkDescriptorPool> m_pools;                          // Persistent chain, newest last
+    std::unordered_map<VkDescriptorSet, VkDescriptorPool> m_owners; // Live set -> its pool
+    std::vector<PendingFree> m_pendingFrees;
+    std::vector<FrameChain> m_frames;
+
+    mutable std::mutex m_mutex;  // allocate*/free may run on recordParallel workers
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_DESCRIPTOR_ALLOCATOR_H
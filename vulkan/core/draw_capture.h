@@ -0,0 +1,689 @@
+// ============================================================================
+// DRAW CAPTURE - Record a few frames of draws, replay them for benchmarks
+// ============================================================================
+// A/B timing a renderer change against a live app is noisy: the camera,
+// the animation and the window all differ between runs. A capture freezes
+// the work instead:
+//
+//   - With CoreConfig::captureResources, VulkanCore keeps a CPU copy of
+//     what every createPipeline/createTexture*/createMesh call was given
+//     (the texture's pixels or pre-encoded levels, the MeshData) until the
+//     resource is destroyed. Modules retain their own resources the same
+//     way (retainResource(), e.g. FacialSystem's DMaps).
+//   - VulkanCore::beginCapture() records the next N frames' high-level
+//     command stream: the camera, bindPipeline, the bound texture and
+//     draw pass, drawMesh* calls (and everything built on drawBoundMesh*,
+//     like RenderQueue). Modules add tagged extension commands for their
+//     own state and draws (LightingManager, FacialSystem).
+//   - After the last frame the live resources and the stream go to one
+//     file, that vulkan/tools/draw_replay re-creates headless and draws in
+//     a loop, timing CPU submission and the GPU scopes.
+//
+// What a capture does not hold: shaders (replay loads the same paths, so
+// compile the build under test first), indirect draws (GpuScene), compute
+// prologues (GpuSkinning: skinned meshes replay in their bind pose, as
+// their source mesh) and anything drawn with raw Vulkan calls outside the
+// modules above. recordParallel draws are captured in the order they
+// reached the capture and replay on one thread.
+//
+// File: a small header, then pipelines, textures, meshes and module
+// resources, each in creation order, then the command stream. Values are
+// in native (little-endian) byte order; DRAW_CAPTURE_VERSION changes with
+// any layout change and older files are refused.
+//
+// Header-only, like pick_buffer.h. Every method locks, so draws may be
+// captured from recordParallel tasks.
+//
+// Usage:
+//   config.captureResources = true;               // before init()
+//   core.beginCapture("scene.vkdc", 10);          // next 10 frames
+//   // modules, per captured call:
+//   if (DrawCapture* cap = core.getDrawCapture(); cap && cap->isRecording()) {
+//       std::vector<uint8_t> payload;
+//       CaptureWriter out(payload);
+//       out.u32(cap->meshId(mesh)); out.mat4(model);
+//       cap->extension(MY_TAG, payload);
+//   }
+//   // replay (see draw_replay.cpp):
+//   DrawCapture capture;
+//   capture.load("scene.vkdc");
+//   capture.forEachMesh([&](uint32_t id, const MeshData& data) {
+//       remap.meshes[id] = core.createMesh(data);
+//   });
+// ============================================================================
+
+#ifndef VKCORE_DRAW_CAPTURE_H
+#define VKCORE_DRAW_CAPTURE_H
+
+#include "vulkan_core.h"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+
+namespace vkcore {
+
+constexpr uint32_t DRAW_CAPTURE_MAGIC = 0x43444B56;  // "VKDC"
+constexpr uint32_t DRAW_CAPTURE_VERSION = 1;
+
+// Four-character tag of a module's extension commands and resources
+constexpr uint32_t captureTag(const char (&name)[5]) {
+    return uint32_t(uint8_t(name[0])) | uint32_t(uint8_t(name[1])) << 8 |
+           uint32_t(uint8_t(name[2])) << 16 | uint32_t(uint8_t(name[3])) << 24;
+}
+
+// ============================================================================
+// Byte Streams
+// ============================================================================
+
+// Appends to a byte vector
+class CaptureWriter {
+public:
+    explicit CaptureWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void bytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        m_out.insert(m_out.end(), p, p + size);
+    }
+    void u8(uint8_t v) { m_out.push_back(v); }
+    void u32(uint32_t v) { bytes(&v, sizeof(v)); }
+    void u64(uint64_t v) { bytes(&v, sizeof(v)); }
+    void f32(float v) { bytes(&v, sizeof(v)); }
+    void vec3(const glm::vec3& v) { bytes(&v.x, sizeof(float) * 3); }
+    void vec4(const glm::vec4& v) { bytes(&v.x, sizeof(float) * 4); }
+    void mat4(const glm::mat4& m) { bytes(&m[0].x, sizeof(float) * 16); }
+    void str(const std::string& s) { u32(static_cast<uint32_t>(s.size())); bytes(s.data(), s.size()); }
+    // Count, then the elements
+    template <typename T>
+    void array(const std::vector<T>& values) {
+        u32(static_cast<uint32_t>(values.size()));
+        bytes(values.data(), values.size() * sizeof(T));
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+};
+
+// Reads what CaptureWriter wrote. Reading past the end returns zeros and
+// clears ok(), so callers check once after a record.
+class CaptureReader {
+public:
+    CaptureReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+    explicit CaptureReader(const std::vector<uint8_t>& data) : m_data(data.data()), m_size(data.size()) {}
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos >= m_size; }
+    size_t remaining() const { return m_size - m_pos; }
+
+    // Pointer to the next `size` bytes (nullptr past the end)
+    const uint8_t* view(size_t size) {
+        if (!m_ok || size > m_size - m_pos) { m_ok = false; return nullptr; }
+        const uint8_t* p = m_data + m_pos;
+        m_pos += size;
+        return p;
+    }
+    bool bytes(void* out, size_t size) {
+        const uint8_t* p = view(size);
+        if (p) std::memcpy(out, p, size);
+        else std::memset(out, 0, size);
+        return p != nullptr;
+    }
+    uint8_t u8() { uint8_t v; bytes(&v, sizeof(v)); return v; }
+    uint32_t u32() { uint32_t v; bytes(&v, sizeof(v)); return v; }
+    uint64_t u64() { uint64_t v; bytes(&v, sizeof(v)); return v; }
+    float f32() { float v; bytes(&v, sizeof(v)); return v; }
+    glm::vec3 vec3() { glm::vec3 v; bytes(&v.x, sizeof(float) * 3); return v; }
+    glm::vec4 vec4() { glm::vec4 v; bytes(&v.x, sizeof(float) * 4); return v; }
+    glm::mat4 mat4() { glm::mat4 m; bytes(&m[0].x, sizeof(float) * 16); return m; }
+    std::string str() {
+        uint32_t size = u32();
+        const uint8_t* p = view(size);
+        return p ? std::string(reinterpret_cast<const char*>(p), size) : std::string();
+    }
+    template <typename T>
+    bool array(std::vector<T>& values) {
+        uint32_t count = u32();
+        if (!m_ok || count > remaining() / sizeof(T)) { m_ok = false; values.clear(); return false; }
+        values.resize(count);
+        return bytes(values.data(), count * sizeof(T));
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+    bool m_ok = true;
+};
+
+// ============================================================================
+// Captured Data
+// ============================================================================
+
+// createTexture/createTextureLinear (RGBA8 pixels, format SRGB or UNORM)
+// or createCompressedTexture (levels as given, regions into data)
+struct CapturedTexture {
+    bool compressed = false;
+    VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+    bool generateMips = false;
+    std::vector<uint8_t> data;
+    std::vector<VkBufferImageCopy> regions;
+};
+
+// A module's own resource: tag says whose, data is its own encoding
+struct CapturedResource {
+    uint32_t tag = 0;
+    std::vector<uint8_t> data;
+};
+
+// Command stream opcodes (one byte each, operands follow)
+enum class CaptureOp : uint8_t {
+    FrameBegin = 1,     // mat4 view, mat4 projection (the camera beginFrame() culls with)
+    FrameEnd,
+    SetCamera,          // mat4 view, mat4 projection
+    BindPipeline,       // u32 pipeline
+    BindTexture,        // u32 texture
+    SetDrawPass,        // u8 DrawPass
+    DrawMesh,           // u32 mesh, mat4 transform, vec4 color
+    DrawMeshInstanced,  // u32 mesh, u32 count, u8 hasColors, count mat4 [, count vec4]
+    Extension           // u32 tag, u32 size, size bytes
+};
+
+// Captured ids -> the handles replay created for them. Unknown ids map
+// to INVALID_* (textures: VulkanCore's default texture when bound).
+struct CaptureRemap {
+    std::unordered_map<uint32_t, PipelineHandle> pipelines;
+    std::unordered_map<uint32_t, TextureHandle> textures;
+    std::unordered_map<uint32_t, MeshHandle> meshes;
+    // Modules' own objects (lights, instances ...), keyed by (tag, captured id)
+    std::unordered_map<uint64_t, uint32_t> objects;
+
+    PipelineHandle pipeline(uint32_t id) const { return find(pipelines, id, INVALID_PIPELINE); }
+    TextureHandle texture(uint32_t id) const { return find(textures, id, INVALID_TEXTURE); }
+    MeshHandle mesh(uint32_t id) const { return find(meshes, id, INVALID_MESH); }
+
+    static uint64_t objectKey(uint32_t tag, uint32_t id) { return uint64_t(tag) << 32 | id; }
+    uint32_t object(uint32_t tag, uint32_t id, uint32_t missing = UINT32_MAX) const {
+        auto it = objects.find(objectKey(tag, id));
+        return it != objects.end() ? it->second : missing;
+    }
+
+private:
+    template <typename Map>
+    static uint32_t find(const Map& map, uint32_t id, uint32_t missing) {
+        auto it = map.find(id);
+        return it != map.end() ? it->second : missing;
+    }
+};
+
+// ============================================================================
+// Draw Capture
+// ============================================================================
+
+class DrawCapture {
+public:
+    // ------------------------------------------------------------------------
+    // Retention (while CoreConfig::captureResources)
+    // ------------------------------------------------------------------------
+
+    void retainPipeline(PipelineHandle id, const PipelineConfig& config) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pipelines[id] = {m_nextOrder++, config};
+    }
+    void retainTexture(TextureHandle id, CapturedTexture texture) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_textures[id] = {m_nextOrder++, std::move(texture)};
+    }
+    void retainMesh(MeshHandle id, const MeshData& data) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_meshes[id] = {m_nextOrder++, data};
+    }
+    // Views draw as their (retained) source
+    void retainMeshView(MeshHandle view, MeshHandle source) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_meshViews[view] = source;
+    }
+    // Returns the id modules refer to the resource by in their commands
+    uint32_t retainResource(uint32_t tag, std::vector<uint8_t> data) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint32_t id = m_nextResource++;
+        m_resources[id] = {m_nextOrder++, CapturedResource{tag, std::move(data)}};
+        return id;
+    }
+
+    void releasePipeline(PipelineHandle id) { std::lock_guard<std::mutex> lock(m_mutex); m_pipelines.erase(id); }
+    void releaseTexture(TextureHandle id) { std::lock_guard<std::mutex> lock(m_mutex); m_textures.erase(id); }
+    void releaseMesh(MeshHandle id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_meshes.erase(id);
+        m_meshViews.erase(id);
+    }
+    void releaseResource(uint32_t id) { std::lock_guard<std::mutex> lock(m_mutex); m_resources.erase(id); }
+
+    // The id a draw of `mesh` is captured as
+    uint32_t meshId(MeshHandle mesh) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto view = m_meshViews.find(mesh);
+        return view != m_meshViews.end() ? view->second : mesh;
+    }
+
+    // ------------------------------------------------------------------------
+    // Recording
+    // ------------------------------------------------------------------------
+
+    // Arms a capture of the next `frames` frames, written to `path`
+    bool start(const std::string& path, uint32_t frames, uint32_t width, uint32_t height) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_armed || frames == 0 || path.empty()) return false;
+        m_path = path;
+        m_frameCount = frames;
+        m_framesRecorded = 0;
+        m_width = width;
+        m_height = height;
+        m_stream.clear();
+        m_armed = true;
+        return true;
+    }
+
+    // Between the FrameBegin and FrameEnd of a captured frame
+    bool isRecording() const { return m_recording; }
+    bool isArmed() const { return m_armed; }
+
+    void frameBegin(const glm::mat4& view, const glm::mat4& projection) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_armed) return;
+        m_recording = true;
+        m_last = BindState();
+        CaptureWriter out(m_stream);
+        out.u8(uint8_t(CaptureOp::FrameBegin));
+        out.mat4(view);
+        out.mat4(projection);
+    }
+
+    // True after the last captured frame: call save() next
+    bool frameEnd() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_recording) return false;
+        m_stream.push_back(uint8_t(CaptureOp::FrameEnd));
+        m_recording = false;
+        return ++m_framesRecorded >= m_frameCount;
+    }
+
+    void setCamera(const glm::mat4& view, const glm::mat4& projection) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_recording) return;
+        CaptureWriter out(m_stream);
+        out.u8(uint8_t(CaptureOp::SetCamera));
+        out.mat4(view);
+        out.mat4(projection);
+    }
+
+    void bindPipeline(PipelineHandle pipeline) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_recording) return;
+        emitPipeline(pipeline);
+    }
+
+    // Binds are emitted as the draw's recording context needs them, so
+    // draws from several recordParallel tasks replay with their own state
+    void drawMesh(PipelineHandle pipeline, TextureHandle texture, DrawPass pass,
+                  MeshHandle mesh, const glm::mat4& transform, const glm::vec4& color) {
+        uint32_t id = meshId(mesh);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_recording) return;
+        emitState(pipeline, texture, pass);
+        CaptureWriter out(m_stream);
+        out.u8(uint8_t(CaptureOp::DrawMesh));
+        out.u32(id);
+        out.mat4(transform);
+        out.vec4(color);
+    }
+
+    void drawMeshInstanced(PipelineHandle pipeline, TextureHandle texture, DrawPass pass, MeshHandle mesh,
+                           const glm::mat4* transforms, const glm::vec4* colors, uint32_t count) {
+        uint32_t id = meshId(mesh);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_recording) return;
+        emitState(pipeline, texture, pass);
+        CaptureWriter out(m_stream);
+        out.u8(uint8_t(CaptureOp::DrawMeshInstanced));
+        out.u32(id);
+        out.u32(count);
+        out.u8(colors ? 1 : 0);
+        out.bytes(transforms, sizeof(glm::mat4) * count);
+        if (colors) out.bytes(colors, sizeof(glm::vec4) * count);
+    }
+
+    // Per-thread buffer, cleared, to build one extension() payload in
+    static std::vector<uint8_t>& scratch() {
+        static thread_local std::vector<uint8_t> bytes;
+        bytes.clear();
+        return bytes;
+    }
+
+    // A module's command. Modules bind their own pipelines, so the next
+    // core draw re-emits its bind.
+    void extension(uint32_t tag, const std::vector<uint8_t>& payload) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_recording) return;
+        m_last.pipeline = INVALID_PIPELINE;
+        CaptureWriter out(m_stream);
+        out.u8(uint8_t(CaptureOp::Extension));
+        out.u32(tag);
+        out.u32(static_cast<uint32_t>(payload.size()));
+        out.bytes(payload.data(), payload.size());
+    }
+
+    // Writes every retained resource and the stream, then disarms
+    bool save() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_armed = false;
+        m_recording = false;
+
+        std::vector<uint8_t> file;
+        CaptureWriter out(file);
+        out.u32(DRAW_CAPTURE_MAGIC);
+        out.u32(DRAW_CAPTURE_VERSION);
+        out.u32(m_width);
+        out.u32(m_height);
+        out.u32(m_framesRecorded);
+
+        auto pipelines = ordered(m_pipelines);
+        out.u32(static_cast<uint32_t>(pipelines.size()));
+        for (const auto& entry : pipelines) { out.u32(entry.first); writePipeline(out, *entry.second); }
+        auto textures = ordered(m_textures);
+        out.u32(static_cast<uint32_t>(textures.size()));
+        for (const auto& entry : textures) { out.u32(entry.first); writeTexture(out, *entry.second); }
+        auto meshes = ordered(m_meshes);
+        out.u32(static_cast<uint32_t>(meshes.size()));
+        for (const auto& entry : meshes) { out.u32(entry.first); writeMesh(out, *entry.second); }
+        auto resources = ordered(m_resources);
+        out.u32(static_cast<uint32_t>(resources.size()));
+        for (const auto& entry : resources) {
+            out.u32(entry.first);
+            out.u32(entry.second->tag);
+            out.array(entry.second->data);
+        }
+        out.array(m_stream);
+
+        std::ofstream stream(m_path, std::ios::binary);
+        stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        bool written = static_cast<bool>(stream);
+        m_stream.clear();
+        m_stream.shrink_to_fit();
+        if (!written) {
+            std::cerr << "[DrawCapture] Failed to write " << m_path << std::endl;
+            return false;
+        }
+        std::cout << "[DrawCapture] Wrote " << m_framesRecorded << " frames to " << m_path << " ("
+                  << pipelines.size() << " pipelines, " << textures.size() << " textures, "
+                  << meshes.size() << " meshes, " << (file.size() + 1023) / 1024 << " KB)" << std::endl;
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // Loading (replay)
+    // ------------------------------------------------------------------------
+
+    bool load(const std::string& path) {
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream) {
+            std::cerr << "[DrawCapture] Cannot open " << path << std::endl;
+            return false;
+        }
+        std::vector<uint8_t> file(static_cast<size_t>(stream.tellg()));
+        stream.seekg(0);
+        stream.read(reinterpret_cast<char*>(file.data()), static_cast<std::streamsize>(file.size()));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pipelines.clear();
+        m_textures.clear();
+        m_meshes.clear();
+        m_meshViews.clear();
+        m_resources.clear();
+        m_nextOrder = 0;
+
+        CaptureReader in(file);
+        if (in.u32() != DRAW_CAPTURE_MAGIC) {
+            std::cerr << "[DrawCapture] " << path << " is not a draw capture" << std::endl;
+            return false;
+        }
+        uint32_t version = in.u32();
+        if (version != DRAW_CAPTURE_VERSION) {
+            std::cerr << "[DrawCapture] " << path << ": version " << version << ", expected "
+                      << DRAW_CAPTURE_VERSION << std::endl;
+            return false;
+        }
+        m_width = in.u32();
+        m_height = in.u32();
+        m_framesRecorded = in.u32();
+
+        for (uint32_t i = 0, n = in.u32(); i < n && in.ok(); i++) {
+            uint32_t id = in.u32();
+            m_pipelines[id] = {m_nextOrder++, readPipeline(in)};
+        }
+        for (uint32_t i = 0, n = in.u32(); i < n && in.ok(); i++) {
+            uint32_t id = in.u32();
+            m_textures[id] = {m_nextOrder++, readTexture(in)};
+        }
+        for (uint32_t i = 0, n = in.u32(); i < n && in.ok(); i++) {
+            uint32_t id = in.u32();
+            m_meshes[id] = {m_nextOrder++, readMesh(in)};
+        }
+        for (uint32_t i = 0, n = in.u32(); i < n && in.ok(); i++) {
+            uint32_t id = in.u32();
+            CapturedResource resource;
+            resource.tag = in.u32();
+            in.array(resource.data);
+            m_resources[id] = {m_nextOrder++, std::move(resource)};
+        }
+        in.array(m_stream);
+
+        if (!in.ok()) {
+            std::cerr << "[DrawCapture] " << path << " is truncated" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    uint32_t getWidth() const { return m_width; }
+    uint32_t getHeight() const { return m_height; }
+    uint32_t getFrameCount() const { return m_framesRecorded; }
+    const std::vector<uint8_t>& getStream() const { return m_stream; }
+
+    // fn(id, value) in creation order
+    template <typename Fn> void forEachPipeline(Fn&& fn) const { forEachOrdered(m_pipelines, fn); }
+    template <typename Fn> void forEachTexture(Fn&& fn) const { forEachOrdered(m_textures, fn); }
+    template <typename Fn> void forEachMesh(Fn&& fn) const { forEachOrdered(m_meshes, fn); }
+    template <typename Fn> void forEachResource(Fn&& fn) const { forEachOrdered(m_resources, fn); }
+
+private:
+    template <typename T>
+    struct Retained {
+        uint64_t order = 0;
+        T value;
+    };
+
+    template <typename T>
+    using RetainedMap = std::unordered_map<uint32_t, Retained<T>>;
+
+    struct BindState {
+        PipelineHandle pipeline = INVALID_PIPELINE;
+        TextureHandle texture = INVALID_TEXTURE;
+        DrawPass pass = DrawPass::Default;
+        bool textureSet = false;
+    };
+
+    template <typename T>
+    static std::vector<std::pair<uint32_t, const T*>> ordered(const RetainedMap<T>& map) {
+        std::vector<std::pair<uint64_t, std::pair<uint32_t, const T*>>> sorted;
+        sorted.reserve(map.size());
+        for (const auto& entry : map) sorted.push_back({entry.second.order, {entry.first, &entry.second.value}});
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<std::pair<uint32_t, const T*>> result;
+        result.reserve(sorted.size());
+        for (const auto& entry : sorted) result.push_back(entry.second);
+        return result;
+    }
+
+    template <typename T, typename Fn>
+    void forEachOrdered(const RetainedMap<T>& map, Fn& fn) const {
+        for (const auto& entry : ordered(map)) fn(entry.first, *entry.second);
+    }
+
+    void emitPipeline(PipelineHandle pipeline) {
+        CaptureWriter out(m_stream);
+        out.u8(uint8_t(CaptureOp::BindPipeline));
+        out.u32(pipeline);
+        m_last.pipeline = pipeline;
+    }
+
+    // Pass first: replaying setDrawPass() rebinds the current pipeline
+    void emitState(PipelineHandle pipeline, TextureHandle texture, DrawPass pass) {
+        CaptureWriter out(m_stream);
+        if (pass != m_last.pass) {
+            out.u8(uint8_t(CaptureOp::SetDrawPass));
+            out.u8(uint8_t(pass));
+            m_last.pass = pass;
+        }
+        if (pipeline != m_last.pipeline) emitPipeline(pipeline);
+        if (texture != m_last.texture || !m_last.textureSet) {
+            out.u8(uint8_t(CaptureOp::BindTexture));
+            out.u32(texture);
+            m_last.texture = texture;
+            m_last.textureSet = true;
+        }
+    }
+
+    static void writePipeline(CaptureWriter& out, const PipelineConfig& config) {
+        out.str(config.vertexShaderPath);
+        out.str(config.fragmentShaderPath);
+        out.u32(uint32_t(config.vertexFormat));
+        out.u32(config.customLayout.stride);
+        out.array(config.customLayout.attributes);
+        out.u32(uint32_t(config.topology));
+        out.u32(uint32_t(config.polygonMode));
+        out.u32(uint32_t(config.cullMode));
+        out.u8(uint8_t(config.depthTest) | uint8_t(config.depthWrite) << 1 | uint8_t(config.alphaBlend) << 2 |
+               uint8_t(config.instanced) << 3 | uint8_t(config.bindless) << 4 | uint8_t(config.pickable) << 5);
+    }
+
+    static PipelineConfig readPipeline(CaptureReader& in) {
+        PipelineConfig config;
+        config.vertexShaderPath = in.str();
+        config.fragmentShaderPath = in.str();
+        config.vertexFormat = VertexFormat(in.u32());
+        config.customLayout.stride = in.u32();
+        in.array(config.customLayout.attributes);
+        config.topology = VkPrimitiveTopology(in.u32());
+        config.polygonMode = VkPolygonMode(in.u32());
+        config.cullMode = VkCullModeFlags(in.u32());
+        uint8_t flags = in.u8();
+        config.depthTest = flags & 1;
+        config.depthWrite = flags & 2;
+        config.alphaBlend = flags & 4;
+        config.instanced = flags & 8;
+        config.bindless = flags & 16;
+        config.pickable = flags & 32;
+        return config;
+    }
+
+    static void writeTexture(CaptureWriter& out, const CapturedTexture& texture) {
+        out.u8(texture.compressed ? 1 : 0);
+        out.u32(uint32_t(texture.format));
+        out.u32(texture.width);
+        out.u32(texture.height);
+        out.u32(texture.mipLevels);
+        out.u8(texture.generateMips ? 1 : 0);
+        out.array(texture.data);
+        out.array(texture.regions);
+    }
+
+    static CapturedTexture readTexture(CaptureReader& in) {
+        CapturedTexture texture;
+        texture.compressed = in.u8() != 0;
+        texture.format = VkFormat(in.u32());
+        texture.width = in.u32();
+        texture.height = in.u32();
+        texture.mipLevels = in.u32();
+        texture.generateMips = in.u8() != 0;
+        in.array(texture.data);
+        in.array(texture.regions);
+        return texture;
+    }
+
+    static void writeMesh(CaptureWriter& out, const MeshData& data) {
+        out.array(data.vertices);
+        out.array(data.indices);
+        out.u32(uint32_t(data.format));
+        out.u32(data.vertexCount);
+        out.u32(data.indexCount);
+        out.array(data.lods);
+        out.vec3(data.quantization.offset);
+        out.f32(data.quantization.scale);
+    }
+
+    static MeshData readMesh(CaptureReader& in) {
+        MeshData data;
+        in.array(data.vertices);
+        in.array(data.indices);
+        data.format = VertexFormat(in.u32());
+        data.vertexCount = in.u32();
+        data.indexCount = in.u32();
+        in.array(data.lods);
+        data.quantization.offset = in.vec3();
+        data.quantization.scale = in.f32();
+        return data;
+    }
+
+    mutable std::mutex m_mutex;
+    uint64_t m_nextOrder = 0;
+    uint32_t m_nextResource = 0;
+    RetainedMap<PipelineConfig> m_pipelines;
+    RetainedMap<CapturedTexture> m_textures;
+    RetainedMap<MeshData> m_meshes;
+    RetainedMap<CapturedResource> m_resources;
+    std::unordered_map<MeshHandle, MeshHandle> m_meshViews;
+
+    std::string m_path;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_frameCount = 0;
+    uint32_t m_framesRecorded = 0;
+    std::atomic<bool> m_armed{false};
+    std::atomic<bool> m_recording{false};
+    BindState m_last;
+    std::vector<uint8_t> m_stream;
+};
+
+// Marks a captured call for its duration, so the calls it falls back to
+// (instanced -> per-object draws) aren't captured a second time
+class CaptureCall {
+public:
+    CaptureCall() { depth()++; }
+    ~CaptureCall() { depth()--; }
+    CaptureCall(const CaptureCall&) = delete;
+    CaptureCall& operator=(const CaptureCall&) = delete;
+
+    bool outermost() const { return depth() == 1; }
+
+private:
+    static uint32_t& depth() {
+        static thread_local uint32_t value = 0;
+        return value;
+    }
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_DRAW_CAPTURE_H
@@ -0,0 +1,463 @@
+// ============================================================================
+// DYNAMIC RESOLUTION - Scene at a GPU-time-driven scale, sharpened upscale
+// ============================================================================
+// Fill-rate-bound scenes (lit and facial meshes at window size) drop frames
+// on small GPUs when every pixel is shaded. With CoreConfig::
+// dynamicResolution, VulkanCore renders its scene pass into an offscreen
+// target and this steers how much of it is used:
+//
+//   - The target is allocated once at maxScale x the window (again on
+//     resize). Each frame the scene renders into its top-left
+//     renderExtent, so a scale change is a viewport change, never a new
+//     image or pipeline.
+//   - ResolutionController turns the scene's GPU time (its "scene"
+//     profiler scope, one sample per frame slot, framesInFlight frames
+//     late) into the next scale. Cost is taken as proportional to pixels:
+//     each sample moves the scale part of the way to the one that would
+//     have hit targetMs - quickly when over budget, slowly when under.
+//   - upscale.frag stretches the region over the window with
+//     contrast-adaptive sharpening, at the start of a second render pass
+//     on the swapchain image. UI is drawn there at native resolution.
+//
+// The second pass matches VulkanCore's render pass (attachments, subpass),
+// so every pipeline built for getRenderPass() - ImGui, NEUROSHELL,
+// external renderers - draws in either. It clears depth: native-resolution
+// draws don't see the scene's.
+//
+// Header-only, like pick_buffer.h. VulkanCore owns one and builds
+// beginUiPass() / getRenderScale() on top; render thread only.
+//
+// Usage:
+//   DynamicResolution dynamic;
+//   dynamic.init(device, settings, vertModule, fragModule);
+//   dynamic.createPipeline(uiPass, pipelineCache, descriptors);
+//   dynamic.createTarget(allocator, scenePass, format, depthView, window);  // again after a resize
+//   dynamic.beginFrame(frameIndex, sceneGpuMs);    // renderExtent for this frame
+//   dynamic.recordSceneBarrier(cmd);               // before the scene pass
+//   dynamic.recordSceneRead(cmd);                  // after it, before the UI pass
+//   dynamic.recordUpscale(cmd);                    // first thing in the UI pass
+//   dynamic.shutdown(allocator, descriptors);      // before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_DYNAMIC_RESOLUTION_H
+#define VKCORE_DYNAMIC_RESOLUTION_H
+
+#include <vulkan/vulkan.h>
+
+#include "gpu_allocator.h"
+#include "descriptor_allocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+// Scale from measured GPU time; CPU only
+class ResolutionController {
+public:
+    struct Settings {
+        float targetMs = 12.0f;
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+        float gainDown = 0.6f;  // Fraction of the way to the ideal scale per sample, over budget
+        float gainUp = 0.15f;   // ... and under it (slower: no oscillation after a spike)
+    };
+
+    static constexpr float DEADBAND = 0.03f;  // Within 3 % of the target: hold, no shimmer from noise
+    static constexpr float SCALE_STEP = 1.0f / 64.0f;
+
+    void configure(const Settings& settings) {
+        m_settings = settings;
+        m_settings.minScale = std::min(std::max(settings.minScale, 0.1f), 2.0f);
+        m_settings.maxScale = std::min(std::max(settings.maxScale, m_settings.minScale), 2.0f);
+        m_settings.targetMs = std::max(settings.targetMs, 0.1f);
+        m_settings.gainDown = std::min(std::max(settings.gainDown, 0.0f), 1.0f);
+        m_settings.gainUp = std::min(std::max(settings.gainUp, 0.0f), 1.0f);
+        m_scale = m_settings.maxScale;
+    }
+
+    // gpuMs: scene time of a frame rendered at sampleScale
+    void addSample(float sampleScale, float gpuMs) {
+        if (gpuMs <= 0.0f || sampleScale <= 0.0f) return;
+        if (std::fabs(gpuMs - m_settings.targetMs) < m_settings.targetMs * DEADBAND) return;
+
+        float ideal = sampleScale * std::sqrt(m_settings.targetMs / gpuMs);
+        float error = ideal - m_scale;
+        m_scale += error * (gpuMs > m_settings.targetMs ? m_settings.gainDown : m_settings.gainUp);
+        m_scale = std::min(std::max(m_scale, m_settings.minScale), m_settings.maxScale);
+    }
+
+    // Quantized, so sub-percent corrections don't resize the viewport
+    float getScale() const {
+        float stepped = std::round(m_scale / SCALE_STEP) * SCALE_STEP;
+        return std::min(std::max(stepped, m_settings.minScale), m_settings.maxScale);
+    }
+    const Settings& getSettings() const { return m_settings; }
+
+private:
+    Settings m_settings;
+    float m_scale = 1.0f;
+};
+
+class DynamicResolution {
+public:
+    static constexpr uint32_t MAX_FRAMES = 4;
+
+    struct Settings {
+        ResolutionController::Settings controller;
+        float sharpness = 0.5f;
+    };
+
+    DynamicResolution() = default;
+    ~DynamicResolution() = default;  // shutdown() needs the allocators
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    // Takes ownership of the two shader modules (fullscreen.vert, upscale.frag)
+    bool init(VkDevice device, const Settings& settings, VkShaderModule vertModule, VkShaderModule fragModule) {
+        if (m_device != VK_NULL_HANDLE) return true;
+        m_device = device;
+        m_sharpness = std::min(std::max(settings.sharpness, 0.0f), 1.0f);
+        m_controller.configure(settings.controller);
+        m_vertModule = vertModule;
+        m_fragModule = fragModule;
+        for (SlotSample& slot : m_slots) slot = SlotSample{};
+        return true;
+    }
+
+    bool isEnabled() const { return m_device != VK_NULL_HANDLE; }
+
+    // `pass` is the UI render pass the upscale draws in
+    bool createPipeline(VkRenderPass pass, VkPipelineCache cache, DescriptorAllocator& descriptors) {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) return false;
+
+        m_set = descriptors.allocate(m_setLayout);
+        if (m_set == VK_NULL_HANDLE) return false;
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.maxLod = 0.0f;
+        if (vkCreateSampler(m_device, &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) return false;
+
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushRange.size = sizeof(UpscaleParams);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_setLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+        if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_layout) != VK_SUCCESS) return false;
+
+        VkPipelineShaderStageCreateInfo stages[2] = {};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = m_vertModule;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = m_fragModule;
+        stages[1].pName = "main";
+
+        VkPipelineVertexInputStateCreateInfo vertexInput{};
+        vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizer.lineWidth = 1.0f;
+        rasterizer.cullMode = VK_CULL_MODE_NONE;
+        rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+        VkPipelineColorBlendAttachmentState blend{};
+        blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &blend;
+
+        VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = 2;
+        dynamicState.pDynamicStates = dynamicStates;
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = stages;
+        pipelineInfo.pVertexInputState = &vertexInput;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = &depthStencil;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = m_layout;
+        pipelineInfo.renderPass = pass;
+        pipelineInfo.subpass = 0;
+
+        VkResult result = vkCreateGraphicsPipelines(m_device, cache, 1, &pipelineInfo, nullptr, &m_pipeline);
+        destroyModules();
+        if (result != VK_SUCCESS) {
+            std::cerr << "[DynamicResolution] Failed to create upscale pipeline" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void shutdown(GpuAllocator& allocator, DescriptorAllocator& descriptors) {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        destroyTarget(allocator);
+        destroyModules();
+        if (m_set != VK_NULL_HANDLE) descriptors.free(m_set);
+        if (m_pipeline) vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        if (m_layout) vkDestroyPipelineLayout(m_device, m_layout, nullptr);
+        if (m_setLayout) vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+        if (m_sampler) vkDestroySampler(m_device, m_sampler, nullptr);
+        m_set = VK_NULL_HANDLE;
+        m_pipeline = VK_NULL_HANDLE;
+        m_layout = VK_NULL_HANDLE;
+        m_setLayout = VK_NULL_HANDLE;
+        m_sampler = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    // ========================================================================
+    // Target (recreated with the swapchain)
+    // ========================================================================
+
+    // Size the target (and anything sharing its framebuffer, e.g. depth)
+    // needs for `window`
+    VkExtent2D targetExtent(VkExtent2D window) const {
+        float scale = m_controller.getSettings().maxScale;
+        return {std::max(1u, static_cast<uint32_t>(std::ceil(window.width * scale))),
+                std::max(1u, static_cast<uint32_t>(std::ceil(window.height * scale)))};
+    }
+
+    // depthView must be at least targetExtent(window)
+    bool createTarget(GpuAllocator& allocator, VkRenderPass scenePass, VkFormat format, VkImageView depthView,
+                      VkExtent2D window) {
+        m_window = window;
+        m_targetExtent = targetExtent(window);
+        updateRenderExtent();
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent = {m_targetExtent.width, m_targetExtent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        if (!allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageAlloc)) {
+            std::cerr << "[DynamicResolution] Failed to create the scene target" << std::endl;
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = format;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &m_view) != VK_SUCCESS) return false;
+
+        VkImageView attachments[2] = {m_view, depthView};
+        VkFramebufferCreateInfo fbInfo{};
+        fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        fbInfo.renderPass = scenePass;
+        fbInfo.attachmentCount = 2;
+        fbInfo.pAttachments = attachments;
+        fbInfo.width = m_targetExtent.width;
+        fbInfo.height = m_targetExtent.height;
+        fbInfo.layers = 1;
+        if (vkCreateFramebuffer(m_device, &fbInfo, nullptr, &m_framebuffer) != VK_SUCCESS) return false;
+
+        // The set is only read by frames recorded from now on (resizes wait idle)
+        VkDescriptorImageInfo imageDesc{m_sampler, m_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_set;
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageDesc;
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        return true;
+    }
+
+    void destroyTarget(GpuAllocator& allocator) {
+        if (m_device == VK_NULL_HANDLE) return;
+        if (m_framebuffer) vkDestroyFramebuffer(m_device, m_framebuffer, nullptr);
+        if (m_view) vkDestroyImageView(m_device, m_view, nullptr);
+        if (m_image) allocator.destroyImage(m_image, m_imageAlloc);
+        m_framebuffer = VK_NULL_HANDLE;
+        m_view = VK_NULL_HANDLE;
+        m_image = VK_NULL_HANDLE;
+    }
+
+    // ========================================================================
+    // Per frame
+    // ========================================================================
+
+    // After frameIndex's fence signalled and its timings resolved:
+    // sceneMs is the scene time that slot's last frame took (0 = none)
+    void beginFrame(uint32_t frameIndex, float sceneMs) {
+        SlotSample& slot = m_slots[frameIndex % MAX_FRAMES];
+        if (slot.scale > 0.0f) m_controller.addSample(slot.scale, sceneMs);
+        updateRenderExtent();
+        slot.scale = m_scale;
+    }
+
+    // Last frame's upscale read the target this frame's scene pass overwrites
+    void recordSceneBarrier(VkCommandBuffer cmd) const {
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             0, 0, nullptr, 0, nullptr, 0, nullptr);
+    }
+
+    // After the scene pass (which left the target SHADER_READ_ONLY_OPTIMAL)
+    void recordSceneRead(VkCommandBuffer cmd) const {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    // Inside the UI pass, viewport = the window
+    void recordUpscale(VkCommandBuffer cmd) const {
+        UpscaleParams params{};
+        params.uvScale[0] = float(m_renderExtent.width) / m_targetExtent.width;
+        params.uvScale[1] = float(m_renderExtent.height) / m_targetExtent.height;
+        params.uvMax[0] = (m_renderExtent.width - 0.5f) / m_targetExtent.width;
+        params.uvMax[1] = (m_renderExtent.height - 0.5f) / m_targetExtent.height;
+        params.texel[0] = 1.0f / m_targetExtent.width;
+        params.texel[1] = 1.0f / m_targetExtent.height;
+        // Nothing to recover at (or above) native resolution
+        params.sharpness = m_scale < 1.0f ? m_sharpness : 0.0f;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_layout, 0, 1, &m_set, 0, nullptr);
+        vkCmdPushConstants(cmd, m_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(params), &params);
+        vkCmdDraw(cmd, 3, 1, 0, 0);
+    }
+
+    VkFramebuffer getFramebuffer() const { return m_framebuffer; }
+    VkExtent2D getRenderExtent() const { return m_renderExtent; }
+    float getScale() const { return m_scale; }
+    const ResolutionController& getController() const { return m_controller; }
+
+private:
+    // Must match upscale.frag
+    struct UpscaleParams {
+        float uvScale[2];
+        float uvMax[2];
+        float texel[2];
+        float sharpness;
+        float pad;
+    };
+
+    // Scale of the frame a slot last recorded (0 = none yet)
+    struct SlotSample {
+        float scale = 0.0f;
+    };
+
+    void updateRenderExtent() {
+        m_scale = m_controller.getScale();
+        m_renderExtent.width = std::min(m_targetExtent.width,
+                                        std::max(1u, static_cast<uint32_t>(std::lround(m_window.width * m_scale))));
+        m_renderExtent.height = std::min(m_targetExtent.height,
+                                         std::max(1u, static_cast<uint32_t>(std::lround(m_window.height * m_scale))));
+    }
+
+    void destroyModules() {
+        if (m_vertModule) vkDestroyShaderModule(m_device, m_vertModule, nullptr);
+        if (m_fragModule) vkDestroyShaderModule(m_device, m_fragModule, nullptr);
+        m_vertModule = VK_NULL_HANDLE;
+        m_fragModule = VK_NULL_HANDLE;
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    ResolutionController m_controller;
+    SlotSample m_slots[MAX_FRAMES];
+    float m_sharpness = 0.5f;
+    float m_scale = 1.0f;
+
+    VkExtent2D m_window{1, 1};
+    VkExtent2D m_targetExtent{1, 1};
+    VkExtent2D m_renderExtent{1, 1};
+
+    VkImage m_image = VK_NULL_HANDLE;
+    GpuAllocation m_imageAlloc;
+    VkImageView m_view = VK_NULL_HANDLE;
+    VkFramebuffer m_framebuffer = VK_NULL_HANDLE;
+
+    VkShaderModule m_vertModule = VK_NULL_HANDLE;
+    VkShaderModule m_fragModule = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkDescriptorSet m_set = VK_NULL_HANDLE;
+    VkSampler m_sampler = VK_NULL_HANDLE;
+    VkPipelineLayout m_layout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_DYNAMIC_RESOLUTION_H
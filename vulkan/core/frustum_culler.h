@@ -0,0 +1,254 @@
+// ============================================================================
+// FRUSTUM CULLER - Bounding spheres against the view frustum, on the CPU
+// ============================================================================
+// Every mesh already has an object-space bounding sphere (computed in
+// createMesh, so GLB and OBJ imports get one too). This tests those against
+// the camera before anything is recorded:
+//
+//   - Frustum: the six Gribb-Hartmann planes of a Vulkan view-projection,
+//     normalized, with a scalar sphere test. VulkanCore keeps one for its
+//     current camera and skips drawMesh* calls outside it.
+//   - CullList: world spheres of many objects as SoA columns (x, y, z,
+//     radius). set() / setTransformed() update one when its transform
+//     changes; cull() tests the whole list 8 (AVX) or 4 (SSE2 / NEON)
+//     spheres at a time and writes the visible indices, in order. Lists
+//     past PARALLEL_MIN split across the job system.
+//
+// A radius <= 0 means "no bounds" and always passes (meshes created with
+// no vertexCount).
+//
+// Header-only, like occlusion_queries.h.
+//
+// Usage:
+//   Frustum frustum = Frustum::fromViewProjection(proj * view);
+//   CullList list;
+//   list.resize(objects.size());
+//   list.setTransformed(i, meshCenter, meshRadius, model);   // when i moves
+//   list.cull(frustum, visible);
+//   for (uint32_t i : visible) draw(i);
+// ============================================================================
+
+#ifndef VKCORE_FRUSTUM_CULLER_H
+#define VKCORE_FRUSTUM_CULLER_H
+
+#include "../../stdlib/job_system.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VKCORE_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKCORE_CULL_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VKCORE_CULL_NEON 1
+#endif
+
+namespace vkcore {
+
+struct Frustum {
+    glm::vec4 planes[6];  // xyz = inward normal, w = distance; dot(n, p) + w >= 0 inside
+
+    // Gribb-Hartmann planes of a Vulkan (0..1 depth) view-projection
+    static Frustum fromViewProjection(const glm::mat4& m) {
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        Frustum f;
+        f.planes[0] = row3 + row0;  // Left
+        f.planes[1] = row3 - row0;  // Right
+        f.planes[2] = row3 + row1;  // Bottom
+        f.planes[3] = row3 - row1;  // Top
+        f.planes[4] = row2;         // Near
+        f.planes[5] = row3 - row2;  // Far
+        for (int i = 0; i < 6; i++) {
+            float len = glm::length(glm::vec3(f.planes[i]));
+            if (len > 0.0f) f.planes[i] /= len;
+        }
+        return f;
+    }
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const {
+        if (radius <= 0.0f) return true;
+        for (int i = 0; i < 6; i++) {
+            if (glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius) return false;
+        }
+        return true;
+    }
+
+    // An object-space sphere under `model`: the radius scales by the
+    // largest axis scale, so it stays conservative for any transform
+    bool intersectsSphere(const glm::vec3& center, float radius, const glm::mat4& model) const {
+        if (radius <= 0.0f) return true;
+        glm::vec3 worldCenter;
+        float worldRadius;
+        transformSphere(center, radius, model, worldCenter, worldRadius);
+        return intersectsSphere(worldCenter, worldRadius);
+    }
+
+    static void transformSphere(const glm::vec3& center, float radius, const glm::mat4& model,
+                                glm::vec3& worldCenter, float& worldRadius) {
+        worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+        float scale2 = std::max(glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                std::max(glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                                         glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))));
+        worldRadius = radius * std::sqrt(scale2);
+    }
+};
+
+// Visible / culled counts of a frame (VulkanCore: RenderStats)
+struct CullStats {
+    uint32_t visible = 0;
+    uint32_t culled = 0;
+};
+
+class CullList {
+public:
+    static constexpr size_t PARALLEL_MIN = 16384;  // Below this one thread is faster
+    static constexpr size_t LANES = 8;             // Columns are padded to a multiple of this
+
+    void resize(size_t count) {
+        size_t padded = (count + LANES - 1) / LANES * LANES;
+        m_x.resize(padded, 0.0f);
+        m_y.resize(padded, 0.0f);
+        m_z.resize(padded, 0.0f);
+        m_r.resize(padded, 0.0f);
+        m_count = count;
+    }
+
+    void clear() {
+        m_x.clear();
+        m_y.clear();
+        m_z.clear();
+        m_r.clear();
+        m_count = 0;
+    }
+
+    size_t size() const { return m_count; }
+
+    // World-space sphere of object i (radius <= 0: always visible)
+    void set(size_t i, const glm::vec3& center, float radius) {
+        m_x[i] = center.x;
+        m_y[i] = center.y;
+        m_z[i] = center.z;
+        m_r[i] = radius > 0.0f ? radius : -1.0f;
+    }
+
+    // Object-space sphere under `model`
+    void setTransformed(size_t i, const glm::vec3& center, float radius, const glm::mat4& model) {
+        if (radius <= 0.0f) {
+            set(i, glm::vec3(model[3]), -1.0f);
+            return;
+        }
+        glm::vec3 worldCenter;
+        float worldRadius;
+        Frustum::transformSphere(center, radius, model, worldCenter, worldRadius);
+        set(i, worldCenter, worldRadius);
+    }
+
+    /**
+     * Indices of the objects intersecting `frustum`, ascending, into
+     * `visible` (replaced). `parallel` splits lists past PARALLEL_MIN
+     * across the job system.
+     */
+    CullStats cull(const Frustum& frustum, std::vector<uint32_t>& visible, bool parallel = true) {
+        visible.clear();
+        CullStats stats;
+        if (m_count == 0) return stats;
+
+        m_mask.resize(m_x.size());
+        if (parallel && m_count >= PARALLEL_MIN) {
+            size_t blocks = m_x.size() / LANES;
+            parallel_for(blocks, [&](size_t begin, size_t end) {
+                testRange(frustum, begin * LANES, end * LANES);
+            });
+        } else {
+            testRange(frustum, 0, m_x.size());
+        }
+
+        visible.reserve(m_count);
+        for (size_t i = 0; i < m_count; i++) {
+            if (m_mask[i]) visible.push_back(static_cast<uint32_t>(i));
+        }
+        stats.visible = static_cast<uint32_t>(visible.size());
+        stats.culled = static_cast<uint32_t>(m_count) - stats.visible;
+        return stats;
+    }
+
+private:
+    // m_mask[i] = sphere i is not fully outside any plane; [begin, end) in whole lanes
+    void testRange(const Frustum& f, size_t begin, size_t end) {
+        size_t i = begin;
+#if defined(VKCORE_CULL_AVX)
+        for (; i + 8 <= end; i += 8) {
+            __m256 x = _mm256_loadu_ps(&m_x[i]), y = _mm256_loadu_ps(&m_y[i]);
+            __m256 z = _mm256_loadu_ps(&m_z[i]), r = _mm256_loadu_ps(&m_r[i]);
+            __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), r);
+            __m256 pass = _mm256_cmp_ps(r, _mm256_setzero_ps(), _CMP_LE_OQ);  // No bounds
+            __m256 inFront = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < 6; p++) {
+                const glm::vec4& pl = f.planes[p];
+                __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(pl.x)),
+                                                       _mm256_mul_ps(y, _mm256_set1_ps(pl.y))),
+                                         _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(pl.z)), _mm256_set1_ps(pl.w)));
+                inFront = _mm256_and_ps(inFront, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+            }
+            int bits = _mm256_movemask_ps(_mm256_or_ps(pass, inFront));
+            for (int k = 0; k < 8; k++) m_mask[i + k] = uint8_t((bits >> k) & 1);
+        }
+#elif defined(VKCORE_CULL_SSE2)
+        for (; i + 4 <= end; i += 4) {
+            __m128 x = _mm_loadu_ps(&m_x[i]), y = _mm_loadu_ps(&m_y[i]);
+            __m128 z = _mm_loadu_ps(&m_z[i]), r = _mm_loadu_ps(&m_r[i]);
+            __m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+            __m128 pass = _mm_cmple_ps(r, _mm_setzero_ps());  // No bounds
+            __m128 inFront = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; p++) {
+                const glm::vec4& pl = f.planes[p];
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(pl.x)), _mm_mul_ps(y, _mm_set1_ps(pl.y))),
+                                      _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(pl.z)), _mm_set1_ps(pl.w)));
+                inFront = _mm_and_ps(inFront, _mm_cmpge_ps(d, negR));
+            }
+            int bits = _mm_movemask_ps(_mm_or_ps(pass, inFront));
+            for (int k = 0; k < 4; k++) m_mask[i + k] = uint8_t((bits >> k) & 1);
+        }
+#elif defined(VKCORE_CULL_NEON)
+        for (; i + 4 <= end; i += 4) {
+            float32x4_t x = vld1q_f32(&m_x[i]), y = vld1q_f32(&m_y[i]);
+            float32x4_t z = vld1q_f32(&m_z[i]), r = vld1q_f32(&m_r[i]);
+            float32x4_t negR = vnegq_f32(r);
+            uint32x4_t inFront = vdupq_n_u32(0xFFFFFFFFu);
+            for (int p = 0; p < 6; p++) {
+                const glm::vec4& pl = f.planes[p];
+                float32x4_t d = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(pl.w), x, pl.x), y, pl.y), z, pl.z);
+                inFront = vandq_u32(inFront, vcgeq_f32(d, negR));
+            }
+            uint32x4_t pass = vorrq_u32(inFront, vcleq_f32(r, vdupq_n_f32(0.0f)));
+            uint32_t lanes[4];
+            vst1q_u32(lanes, pass);
+            for (int k = 0; k < 4; k++) m_mask[i + k] = uint8_t(lanes[k] != 0);
+        }
+#endif
+        for (; i < end; i++) {
+            m_mask[i] = uint8_t(f.intersectsSphere(glm::vec3(m_x[i], m_y[i], m_z[i]), m_r[i]));
+        }
+    }
+
+    std::vector<float> m_x, m_y, m_z, m_r;  // Padded to LANES; padding has radius 0
+    std::vector<uint8_t> m_mask;
+    size_t m_count = 0;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_FRUSTUM_CULLER_H
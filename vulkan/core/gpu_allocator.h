@@ -0,0 +1,551 @@
+// ============================================================================
+// GPU ALLOCATOR - Sub-allocating VkDeviceMemory manager
+// ============================================================================
+// One vkAllocateMemory per *block*, not per resource. Keeps us far away from
+// the driver's maxMemoryAllocationCount and stops VRAM fragmenting into
+// thousands of tiny allocations.
+//
+//   - Size-class pools: power-of-two slots (256 B .. 4 MB) carved out of
+//     large blocks, one pool per (memory type, buffer/image, size class).
+//     Buffers and images never share a block (bufferImageGranularity).
+//   - Linear staging pages: bump-allocated, rewound when every allocation
+//     in the page has been freed (staging lives for one upload).
+//   - Dedicated allocations for anything bigger than the largest class.
+//   - Host-visible blocks are persistently mapped; use GpuAllocation::mapped
+//     instead of vkMapMemory (the same VkDeviceMemory can't be mapped twice).
+//
+// Header-only so stdlib/*_resource.h can use it without extra sources.
+//
+// Usage:
+//   GpuAllocator alloc;
+//   alloc.init(device, physicalDevice);
+//   VkBuffer buf; GpuAllocation mem;
+//   alloc.createBuffer(size, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buf, mem);
+//   ...
+//   alloc.destroyBuffer(buf, mem);
+//   alloc.shutdown();  // before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_GPU_ALLOCATOR_H
+#define VKCORE_GPU_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <mutex>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+
+namespace vkcore {
+
+// ============================================================================
+// Allocation / Stats Types
+// ============================================================================
+
+enum class GpuAllocKind : uint32_t {
+    BUFFER = 0,   // Linear resources (vertex/index/uniform buffers)
+    IMAGE,        // Optimal-tiling images
+    STAGING       // Short-lived upload buffers (linear pages)
+};
+
+struct GpuAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;        // Requested size
+    void* mapped = nullptr;       // Already offset; null unless host-visible
+    uint32_t memoryType = UINT32_MAX;
+
+    // Internal bookkeeping
+    uint32_t pool = UINT32_MAX;
+    uint32_t block = UINT32_MAX;
+    uint32_t slot = UINT32_MAX;
+
+    bool isValid() const { return memory != VK_NULL_HANDLE; }
+};
+
+struct GpuHeapStats {
+    uint32_t memoryType = 0;
+    VkMemoryPropertyFlags flags = 0;
+    uint32_t blockCount = 0;           // vkAllocateMemory calls alive
+    uint32_t allocationCount = 0;      // Sub-allocations alive
+    VkDeviceSize bytesReserved = 0;    // Device memory held
+    VkDeviceSize bytesUsed = 0;        // Bytes actually requested
+    float fragmentation = 0.0f;        // 1 - used/reserved
+};
+
+struct GpuAllocatorStats {
+    std::vector<GpuHeapStats> heaps;   // One entry per memory type in use
+    uint32_t deviceAllocations = 0;
+    VkDeviceSize bytesReserved = 0;
+    VkDeviceSize bytesUsed = 0;
+};
+
+// ============================================================================
+// GPU ALLOCATOR CLASS
+// ============================================================================
+
+class GpuAllocator {
+public:
+    static constexpr uint32_t MIN_SLOT_SHIFT = 8;                       // 256 B
+    static constexpr uint32_t MAX_SLOT_SHIFT = 22;                      // 4 MB
+    static constexpr VkDeviceSize MIN_BLOCK_SIZE = 4ull * 1024 * 1024;  // 4 MB
+    static constexpr VkDeviceSize MAX_BLOCK_SIZE = 32ull * 1024 * 1024; // 32 MB
+    static constexpr VkDeviceSize STAGING_PAGE_SIZE = 16ull * 1024 * 1024;
+
+    GpuAllocator() = default;
+    ~GpuAllocator() { shutdown(); }
+
+    GpuAllocator(const GpuAllocator&) = delete;
+    GpuAllocator& operator=(const GpuAllocator&) = delete;
+
+    // Process-wide instance for code that works off the legacy g_device
+    // globals (stdlib/*_resource.h). Lazily bound on first use.
+    static GpuAllocator& shared(VkDevice device, VkPhysicalDevice physicalDevice) {
+        static GpuAllocator s_shared;
+        if (!s_shared.isInitialized() && device != VK_NULL_HANDLE) {
+            s_shared.init(device, physicalDevice);
+        }
+        return s_shared;
+    }
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VkDevice device, VkPhysicalDevice physicalDevice) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_device != VK_NULL_HANDLE) return true;
+        m_device = device;
+        m_physicalDevice = physicalDevice;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memProps);
+        return true;
+    }
+
+    // Frees every block. Call after all resources are destroyed and before
+    // vkDestroyDevice. Outstanding GpuAllocations become dangling.
+    void shutdown() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_device == VK_NULL_HANDLE) return;
+
+        for (auto& pool : m_pools) {
+            for (auto& block : pool.blocks) {
+                releaseBlock(block);
+            }
+        }
+        m_pools.clear();
+        m_device = VK_NULL_HANDLE;
+        m_physicalDevice = VK_NULL_HANDLE;
+    }
+
+    bool isInitialized() const { return m_device != VK_NULL_HANDLE; }
+
+    // First type with all of `properties`, preferring one with none of
+    // `avoid` (e.g. host memory that is not DEVICE_LOCAL); falls back to
+    // ignoring `avoid` when no such type exists
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties,
+                            VkMemoryPropertyFlags avoid = 0) const {
+        uint32_t fallback = UINT32_MAX;
+        for (uint32_t i = 0; i < m_memProps.memoryTypeCount; i++) {
+            if ((typeFilter & (1u << i)) &&
+                (m_memProps.memoryTypes[i].propertyFlags & properties) == properties) {
+                if ((m_memProps.memoryTypes[i].propertyFlags & avoid) == 0) return i;
+                if (fallback == UINT32_MAX) fallback = i;
+            }
+        }
+        return fallback;
+    }
+
+    VkMemoryPropertyFlags getMemoryTypeFlags(uint32_t memoryType) const {
+        return memoryType < m_memProps.memoryTypeCount ? m_memProps.memoryTypes[memoryType].propertyFlags : 0;
+    }
+
+    // ========================================================================
+    // Raw Allocation
+    // ========================================================================
+
+    GpuAllocation allocate(const VkMemoryRequirements& reqs, VkMemoryPropertyFlags properties,
+                           GpuAllocKind kind, VkMemoryPropertyFlags avoid = 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        GpuAllocation alloc;
+        if (m_device == VK_NULL_HANDLE) return alloc;
+
+        uint32_t memoryType = findMemoryType(reqs.memoryTypeBits, properties, avoid);
+        if (memoryType == UINT32_MAX) {
+            std::cerr << "[GpuAllocator] No memory type for flags 0x" << std::hex << properties
+                      << std::dec << std::endl;
+            return alloc;
+        }
+
+        VkDeviceSize alignment = std::max<VkDeviceSize>(reqs.alignment, 1);
+
+        if (kind == GpuAllocKind::STAGING) {
+            allocateLinear(reqs.size, alignment, memoryType, alloc);
+        } else {
+            uint32_t shift = sizeClassShift(std::max(reqs.size, alignment));
+            if (shift > MAX_SLOT_SHIFT) {
+                allocateDedicated(reqs.size, memoryType, kind, alloc);
+            } else {
+                allocateSlot(reqs.size, shift, memoryType, kind, alloc);
+            }
+        }
+        return alloc;
+    }
+
+    void free(GpuAllocation& alloc) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!alloc.isValid() || m_device == VK_NULL_HANDLE) {
+            alloc = GpuAllocation();
+            return;
+        }
+        if (alloc.pool >= m_pools.size() || alloc.block >= m_pools[alloc.pool].blocks.size()) {
+            alloc = GpuAllocation();
+            return;
+        }
+
+        Pool& pool = m_pools[alloc.pool];
+        Block& block = pool.blocks[alloc.block];
+        block.bytesUsed -= alloc.size;
+        block.liveCount--;
+
+        switch (pool.mode) {
+            case PoolMode::SLOTS:
+                block.freeSlots.push_back(alloc.slot);
+                // Keep one empty block per pool around to avoid alloc/free churn
+                if (block.liveCount == 0 && countEmptyBlocks(pool) > 1) {
+                    releaseBlock(block);
+                }
+                break;
+            case PoolMode::LINEAR:
+                if (block.liveCount == 0) {
+                    block.head = 0;
+                    // Oversized or surplus pages aren't worth hoarding
+                    if (block.size > STAGING_PAGE_SIZE || countEmptyBlocks(pool) > 1) {
+                        releaseBlock(block);
+                    }
+                }
+                break;
+            case PoolMode::DEDICATED:
+                releaseBlock(block);
+                break;
+        }
+        alloc = GpuAllocation();
+    }
+
+    // ========================================================================
+    // Buffer / Image Helpers
+    // ========================================================================
+
+    bool createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                      VkBuffer& buffer, GpuAllocation& alloc,
+                      GpuAllocKind kind = GpuAllocKind::BUFFER, VkMemoryPropertyFlags avoid = 0) {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        return createBuffer(bufferInfo, properties, buffer, alloc, kind, avoid);
+    }
+
+    // Full create-info variant (e.g. CONCURRENT sharing across queue families);
+    // `avoid` as in findMemoryType()
+    bool createBuffer(const VkBufferCreateInfo& bufferInfo, VkMemoryPropertyFlags properties,
+                      VkBuffer& buffer, GpuAllocation& alloc,
+                      GpuAllocKind kind = GpuAllocKind::BUFFER, VkMemoryPropertyFlags avoid = 0) {
+        if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+            buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements memReqs;
+        vkGetBufferMemoryRequirements(m_device, buffer, &memReqs);
+
+        alloc = allocate(memReqs, properties, kind, avoid);
+        if (!alloc.isValid()) {
+            vkDestroyBuffer(m_device, buffer, nullptr);
+            buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        vkBindBufferMemory(m_device, buffer, alloc.memory, alloc.offset);
+        return true;
+    }
+
+    // Host-visible, coherent TRANSFER_SRC buffer from the linear staging pages
+    bool createStagingBuffer(VkDeviceSize size, VkBuffer& buffer, GpuAllocation& alloc) {
+        return createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            buffer, alloc, GpuAllocKind::STAGING);
+    }
+
+    bool createImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+                     VkImage& image, GpuAllocation& alloc) {
+        if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+            image = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements memReqs;
+        vkGetImageMemoryRequirements(m_device, image, &memReqs);
+
+        GpuAllocKind kind = (imageInfo.tiling == VK_IMAGE_TILING_LINEAR) ? GpuAllocKind::BUFFER
+                                                                         : GpuAllocKind::IMAGE;
+        alloc = allocate(memReqs, properties, kind);
+        if (!alloc.isValid()) {
+            vkDestroyImage(m_device, image, nullptr);
+            image = VK_NULL_HANDLE;
+            return false;
+        }
+
+        vkBindImageMemory(m_device, image, alloc.memory, alloc.offset);
+        return true;
+    }
+
+    void destroyBuffer(VkBuffer& buffer, GpuAllocation& alloc) {
+        if (buffer != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_device, buffer, nullptr);
+        }
+        buffer = VK_NULL_HANDLE;
+        free(alloc);
+    }
+
+    void destroyImage(VkImage& image, GpuAllocation& alloc) {
+        if (image != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
+            vkDestroyImage(m_device, image, nullptr);
+        }
+        image = VK_NULL_HANDLE;
+        free(alloc);
+    }
+
+    // ========================================================================
+    // Stats
+    // ========================================================================
+
+    GpuAllocatorStats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        GpuAllocatorStats stats;
+        std::vector<int32_t> heapIndex(VK_MAX_MEMORY_TYPES, -1);
+
+        for (const auto& pool : m_pools) {
+            for (const auto& block : pool.blocks) {
+                if (block.memory == VK_NULL_HANDLE) continue;
+
+                int32_t& idx = heapIndex[pool.memoryType];
+                if (idx < 0) {
+                    idx = static_cast<int32_t>(stats.heaps.size());
+                    GpuHeapStats heap;
+                    heap.memoryType = pool.memoryType;
+                    heap.flags = m_memProps.memoryTypes[pool.memoryType].propertyFlags;
+                    stats.heaps.push_back(heap);
+                }
+                GpuHeapStats& heap = stats.heaps[idx];
+                heap.blockCount++;
+                heap.allocationCount += block.liveCount;
+                heap.bytesReserved += block.size;
+                heap.bytesUsed += block.bytesUsed;
+            }
+        }
+
+        for (auto& heap : stats.heaps) {
+            heap.fragmentation = heap.bytesReserved > 0
+                ? 1.0f - static_cast<float>(heap.bytesUsed) / static_cast<float>(heap.bytesReserved)
+                : 0.0f;
+            stats.deviceAllocations += heap.blockCount;
+            stats.bytesReserved += heap.bytesReserved;
+            stats.bytesUsed += heap.bytesUsed;
+        }
+        return stats;
+    }
+
+    void printStats() const {
+        GpuAllocatorStats stats = getStats();
+        std::cout << "[GpuAllocator] " << stats.deviceAllocations << " device allocations, "
+                  << (stats.bytesUsed / 1024) << " KB used / "
+                  << (stats.bytesReserved / 1024) << " KB reserved" << std::endl;
+        for (const auto& heap : stats.heaps) {
+            std::cout << "  type " << heap.memoryType
+                      << ((heap.flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ? " [device]" : "")
+                      << ((heap.flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ? " [host]" : "")
+                      << ": " << heap.blockCount << " blocks, " << heap.allocationCount << " allocs, "
+                      << (heap.bytesUsed / 1024) << "/" << (heap.bytesReserved / 1024) << " KB, "
+                      << static_cast<int>(heap.fragmentation * 100.0f) << "% fragmented" << std::endl;
+        }
+    }
+
+private:
+    enum class PoolMode : uint32_t { SLOTS, LINEAR, DEDICATED };
+
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        uint8_t* mapped = nullptr;
+        uint32_t liveCount = 0;
+        VkDeviceSize bytesUsed = 0;
+        std::vector<uint32_t> freeSlots;  // SLOTS mode
+        VkDeviceSize head = 0;            // LINEAR mode
+    };
+
+    struct Pool {
+        PoolMode mode = PoolMode::SLOTS;
+        GpuAllocKind kind = GpuAllocKind::BUFFER;
+        uint32_t memoryType = 0;
+        uint32_t slotShift = 0;
+        std::vector<Block> blocks;
+    };
+
+    static uint32_t sizeClassShift(VkDeviceSize size) {
+        uint32_t shift = MIN_SLOT_SHIFT;
+        while (shift < 63 && (VkDeviceSize(1) << shift) < size) shift++;
+        return shift;
+    }
+
+    static uint32_t countEmptyBlocks(const Pool& pool) {
+        uint32_t count = 0;
+        for (const auto& b : pool.blocks) {
+            if (b.memory != VK_NULL_HANDLE && b.liveCount == 0) count++;
+        }
+        return count;
+    }
+
+    uint32_t findOrCreatePool(PoolMode mode, GpuAllocKind kind, uint32_t memoryType, uint32_t slotShift) {
+        for (uint32_t i = 0; i < m_pools.size(); i++) {
+            const Pool& p = m_pools[i];
+            if (p.mode == mode && p.kind == kind && p.memoryType == memoryType && p.slotShift == slotShift) {
+                return i;
+            }
+        }
+        Pool pool;
+        pool.mode = mode;
+        pool.kind = kind;
+        pool.memoryType = memoryType;
+        pool.slotShift = slotShift;
+        m_pools.push_back(std::move(pool));
+        return static_cast<uint32_t>(m_pools.size() - 1);
+    }
+
+    // Allocates device memory for a block, reusing a released entry if any
+    uint32_t createBlock(Pool& pool, VkDeviceSize size) {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = pool.memoryType;
+
+        VkDeviceMemory memory;
+        if (vkAllocateMemory(m_device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+            std::cerr << "[GpuAllocator] vkAllocateMemory failed (" << (size / 1024) << " KB)" << std::endl;
+            return UINT32_MAX;
+        }
+
+        uint32_t index = UINT32_MAX;
+        for (uint32_t i = 0; i < pool.blocks.size(); i++) {
+            if (pool.blocks[i].memory == VK_NULL_HANDLE) { index = i; break; }
+        }
+        if (index == UINT32_MAX) {
+            index = static_cast<uint32_t>(pool.blocks.size());
+            pool.blocks.emplace_back();
+        }
+
+        Block& block = pool.blocks[index];
+        block = Block();
+        block.memory = memory;
+        block.size = size;
+
+        if (m_memProps.memoryTypes[pool.memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            void* mapped = nullptr;
+            vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+            block.mapped = static_cast<uint8_t*>(mapped);
+        }
+
+        if (pool.mode == PoolMode::SLOTS) {
+            uint32_t slotCount = static_cast<uint32_t>(size >> pool.slotShift);
+            block.freeSlots.reserve(slotCount);
+            for (uint32_t s = slotCount; s > 0; s--) block.freeSlots.push_back(s - 1);
+        }
+        return index;
+    }
+
+    void releaseBlock(Block& block) {
+        if (block.memory == VK_NULL_HANDLE) return;
+        if (block.mapped) vkUnmapMemory(m_device, block.memory);
+        vkFreeMemory(m_device, block.memory, nullptr);
+        block = Block();
+    }
+
+    void fillAllocation(GpuAllocation& alloc, uint32_t poolIndex, uint32_t blockIndex, uint32_t slot,
+                        VkDeviceSize offset, VkDeviceSize size) {
+        Block& block = m_pools[poolIndex].blocks[blockIndex];
+        alloc.memory = block.memory;
+        alloc.offset = offset;
+        alloc.size = size;
+        alloc.mapped = block.mapped ? block.mapped + offset : nullptr;
+        alloc.memoryType = m_pools[poolIndex].memoryType;
+        alloc.pool = poolIndex;
+        alloc.block = blockIndex;
+        alloc.slot = slot;
+        block.liveCount++;
+        block.bytesUsed += size;
+    }
+
+    void allocateSlot(VkDeviceSize size, uint32_t shift, uint32_t memoryType, GpuAllocKind kind,
+                      GpuAllocation& alloc) {
+        uint32_t poolIndex = findOrCreatePool(PoolMode::SLOTS, kind, memoryType, shift);
+        Pool& pool = m_pools[poolIndex];
+
+        uint32_t blockIndex = UINT32_MAX;
+        for (uint32_t i = 0; i < pool.blocks.size(); i++) {
+            if (pool.blocks[i].memory != VK_NULL_HANDLE && !pool.blocks[i].freeSlots.empty()) {
+                blockIndex = i;
+                break;
+            }
+        }
+        if (blockIndex == UINT32_MAX) {
+            VkDeviceSize slotSize = VkDeviceSize(1) << shift;
+            VkDeviceSize blockSize = std::clamp(slotSize * 256, MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+            blockIndex = createBlock(pool, blockSize);
+            if (blockIndex == UINT32_MAX) return;
+        }
+
+        Block& block = pool.blocks[blockIndex];
+        uint32_t slot = block.freeSlots.back();
+        block.freeSlots.pop_back();
+        fillAllocation(alloc, poolIndex, blockIndex, slot, VkDeviceSize(slot) << shift, size);
+    }
+
+    void allocateLinear(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryType, GpuAllocation& alloc) {
+        uint32_t poolIndex = findOrCreatePool(PoolMode::LINEAR, GpuAllocKind::STAGING, memoryType, 0);
+        Pool& pool = m_pools[poolIndex];
+
+        for (uint32_t i = 0; i < pool.blocks.size(); i++) {
+            Block& block = pool.blocks[i];
+            if (block.memory == VK_NULL_HANDLE) continue;
+            VkDeviceSize offset = (block.head + alignment - 1) / alignment * alignment;
+            if (offset + size <= block.size) {
+                block.head = offset + size;
+                fillAllocation(alloc, poolIndex, i, 0, offset, size);
+                return;
+            }
+        }
+
+        uint32_t blockIndex = createBlock(pool, std::max(size, STAGING_PAGE_SIZE));
+        if (blockIndex == UINT32_MAX) return;
+        pool.blocks[blockIndex].head = size;
+        fillAllocation(alloc, poolIndex, blockIndex, 0, 0, size);
+    }
+
+    void allocateDedicated(VkDeviceSize size, uint32_t memoryType, GpuAllocKind kind, GpuAllocation& alloc) {
+        uint32_t poolIndex = findOrCreatePool(PoolMode::DEDICATED, kind, memoryType, 0);
+        uint32_t blockIndex = createBlock(m_pools[poolIndex], size);
+        if (blockIndex == UINT32_MAX) return;
+        fillAllocation(alloc, poolIndex, blockIndex, 0, 0, size);
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties m_memProps{};
+    std::vector<Pool> m_pools;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_GPU_ALLOCATOR_H
@@ -0,0 +1,867 @@
+// ============================================================================
+// GPU PARTICLES - Compute-simulated particle systems on top of VulkanCore
+// ============================================================================
+// For effects with far more particles than a CPU loop pushing positions
+// every frame (the old bouncing-balls path) can keep up with - up to a
+// million per system, at a CPU cost that depends only on the emitters:
+//
+//   - Particles live in one device-local pool with a dead list of free
+//     slots and two alive lists that swap roles every frame. The CPU never
+//     reads them back.
+//   - Emitters are CPU objects (rate, bursts, spawn box, cone, ranges of
+//     speed / lifetime / size / color). Each frame turns into a few dozen
+//     bytes per emitting emitter in a host-visible buffer.
+//   - A compute prologue (async compute queue when there is one) runs
+//     shaders/particle_update.comp: emits from the
+//     dead list, integrates every alive particle and compacts the
+//     survivors into the other alive list (indirect dispatch, sized on the
+//     GPU). With maxSortedParticles, shaders/particle_sort.comp bitonic
+//     sorts the first that many back to front for alpha blending.
+//   - draw() is one vkCmdDrawIndirect of camera-facing quads (no vertex
+//     buffers; instance count written by the GPU).
+//
+// A system with screenSpace set works in pixels (top-left origin, y down)
+// and draws without depth, over the UI - NEUROSHELL's particle effect runs
+// on one (ElementTree::setParticleEffectHandler). Units are the system's:
+// metres and m/s^2 in the world, pixels and px/s^2 on screen.
+//
+// Needs the bindless heap (textured particles sample it). Particles do not
+// collide and are not lit. The pipeline is VulkanCore's render pass,
+// subpass 0; draw() binds its own pipeline, so rebind yours afterwards.
+//
+// Header-only, like gpu_scene.h. Not thread-safe: call everything on the
+// render thread.
+//
+// Usage:
+//   GpuParticles sparks;
+//   sparks.init(&core);
+//   ParticleEmitterDesc desc;
+//   desc.rate = 20000.0f;
+//   ParticleEmitterHandle fountain = sparks.createEmitter(desc);
+//   sparks.burst(fountain, 5000);
+//   // per frame, before beginFrame():
+//   sparks.update(deltaTime);
+//   // inside the render pass, after opaque geometry:
+//   sparks.draw();
+//   sparks.shutdown();                  // before core.shutdown()
+// ============================================================================
+
+#ifndef VKCORE_GPU_PARTICLES_H
+#define VKCORE_GPU_PARTICLES_H
+
+#include "vulkan_core.h"
+#include "handle_pool.h"
+#include "../../stdlib/vfs.h"
+
+#include <vector>
+#include <array>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace vkcore {
+
+using ParticleEmitterHandle = uint32_t;
+constexpr ParticleEmitterHandle INVALID_PARTICLE_EMITTER = UINT32_MAX;
+
+enum class ParticleBlend {
+    ADDITIVE,  // Order-independent: no sorting needed (sparks, fire, magic)
+    ALPHA      // Premultiplied "over": set maxSortedParticles (smoke, dust)
+};
+
+struct ParticleSystemConfig {
+    uint32_t maxParticles = 1u << 20;  // Pool size; 64 bytes + 12 bytes of lists each
+    uint32_t maxEmitters = 1024;       // Emitting per frame (emitters + emitOnce() calls)
+    ParticleBlend blend = ParticleBlend::ADDITIVE;
+    uint32_t maxSortedParticles = 0;   // >0: sort this many back to front (rounded up to a power of
+                                       // two >= 1024); the rest draw unsorted after them
+    bool screenSpace = false;          // Pixels, top-left origin, no depth test (UI effects)
+    glm::vec3 gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+    std::string updateShaderPath = "shaders/particle_update.comp.spv";
+    std::string sortShaderPath = "shaders/particle_sort.comp.spv";
+    std::string vertexShaderPath = "shaders/particle.vert.spv";
+    std::string fragmentShaderPath = "shaders/particle.frag.spv";
+};
+
+// Every particle picks its values uniformly between min and max at spawn
+struct ParticleEmitterDesc {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 extents = glm::vec3(0.0f);         // Spawn box half size around position
+    glm::vec3 direction = glm::vec3(0.0f, 1.0f, 0.0f);
+    float spread = 0.3f;                         // Cone half-angle around direction, radians
+    float rate = 100.0f;                         // Particles per second (0 = bursts only)
+    float speedMin = 1.0f, speedMax = 2.0f;
+    float lifetimeMin = 1.0f, lifetimeMax = 2.0f;
+    float sizeStart = 0.1f, sizeEnd = 0.0f;      // Quad half size over the lifetime
+    glm::vec4 colorStart = glm::vec4(1.0f);
+    glm::vec4 colorEnd = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+    float drag = 0.0f;                           // Velocity lost per second (fraction)
+    float spin = 0.0f;                           // Max rotation speed, radians per second
+    uint32_t texture = BindlessHeap::INVALID_INDEX;  // Bindless slot; INVALID = soft round sprite
+};
+
+class GpuParticles {
+public:
+    GpuParticles() = default;
+    ~GpuParticles() { shutdown(); }
+
+    GpuParticles(const GpuParticles&) = delete;
+    GpuParticles& operator=(const GpuParticles&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VulkanCore* core, const ParticleSystemConfig& config = ParticleSystemConfig()) {
+        if (m_core) return true;
+        if (!core || !core->isInitialized() || config.maxParticles == 0 || config.maxEmitters == 0) return false;
+        if (!core->hasBindlessHeap()) {
+            // The fragment shader declares the heap as set 1
+            std::cerr << "[GpuParticles] Needs the bindless heap (CoreConfig::bindlessTextures)" << std::endl;
+            return false;
+        }
+
+        m_core = core;
+        m_device = core->getDevice();
+        m_config = config;
+        m_sortCapacity = 0;
+        if (config.maxSortedParticles > 0) {
+            m_sortCapacity = 1024;
+            while (m_sortCapacity < config.maxSortedParticles && m_sortCapacity < (1u << 30)) m_sortCapacity <<= 1;
+        }
+
+        if (!createBuffers() || !createComputePipelines() || !createDrawPipeline() || !createDescriptorSets()) {
+            shutdown();
+            return false;
+        }
+
+        // The pool carries over between frames: with async compute the
+        // simulation waits for the previous frame's draw
+        m_prologueId = core->addComputePrologue([this](VkCommandBuffer cmd) { simulate(cmd); },
+                                                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                                false);
+
+        std::cout << "[GpuParticles] Ready (" << config.maxParticles << " particles, "
+                  << (m_sortCapacity ? "sorted" : "unsorted") << ", "
+                  << (config.screenSpace ? "screen space" : "world space") << ")" << std::endl;
+        return true;
+    }
+
+    // Before VulkanCore::shutdown()
+    void shutdown() {
+        if (!m_core) return;
+
+        vkDeviceWaitIdle(m_device);
+        if (m_prologueId) m_core->removeFramePrologue(m_prologueId);
+        m_prologueId = 0;
+
+        for (VkDescriptorSet& set : m_sets) {
+            if (set != VK_NULL_HANDLE) m_core->getDescriptorAllocator().free(set);
+            set = VK_NULL_HANDLE;
+        }
+
+        if (m_updatePipeline) vkDestroyPipeline(m_device, m_updatePipeline, nullptr);
+        if (m_sortPipeline) vkDestroyPipeline(m_device, m_sortPipeline, nullptr);
+        if (m_drawPipeline) vkDestroyPipeline(m_device, m_drawPipeline, nullptr);
+        if (m_computeLayout) vkDestroyPipelineLayout(m_device, m_computeLayout, nullptr);
+        if (m_drawLayout) vkDestroyPipelineLayout(m_device, m_drawLayout, nullptr);
+        if (m_setLayout) vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+        m_updatePipeline = VK_NULL_HANDLE;
+        m_sortPipeline = VK_NULL_HANDLE;
+        m_drawPipeline = VK_NULL_HANDLE;
+        m_computeLayout = VK_NULL_HANDLE;
+        m_drawLayout = VK_NULL_HANDLE;
+        m_setLayout = VK_NULL_HANDLE;
+
+        GpuAllocator& allocator = m_core->getAllocator();
+        allocator.destroyBuffer(m_particles, m_particlesAlloc);
+        allocator.destroyBuffer(m_deadList, m_deadListAlloc);
+        allocator.destroyBuffer(m_alive[0], m_aliveAlloc[0]);
+        allocator.destroyBuffer(m_alive[1], m_aliveAlloc[1]);
+        allocator.destroyBuffer(m_counters, m_countersAlloc);
+        allocator.destroyBuffer(m_emitterBuffer, m_emitterAlloc);
+        allocator.destroyBuffer(m_sortKeys, m_sortKeysAlloc);
+
+        m_emitters.clear();
+        m_oneShots.clear();
+        m_poolReady = false;
+        m_drawReady = false;
+        m_pendingDt = 0.0f;
+        m_idleTime = 0.0f;
+        m_core = nullptr;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isInitialized() const { return m_core != nullptr; }
+
+    // ========================================================================
+    // Emitters
+    // ========================================================================
+
+    ParticleEmitterHandle createEmitter(const ParticleEmitterDesc& desc) {
+        if (!m_core) return INVALID_PARTICLE_EMITTER;
+        Emitter emitter;
+        emitter.desc = desc;
+        return m_emitters.insert(emitter);
+    }
+
+    // Its particles live out their lifetime
+    void destroyEmitter(ParticleEmitterHandle handle) { m_emitters.remove(handle); }
+
+    void setEmitter(ParticleEmitterHandle handle, const ParticleEmitterDesc& desc) {
+        if (Emitter* emitter = m_emitters.get(handle)) emitter->desc = desc;
+    }
+
+    const ParticleEmitterDesc* getEmitter(ParticleEmitterHandle handle) const {
+        const Emitter* emitter = m_emitters.get(handle);
+        return emitter ? &emitter->desc : nullptr;
+    }
+
+    void setEmitterPosition(ParticleEmitterHandle handle, const glm::vec3& position) {
+        if (Emitter* emitter = m_emitters.get(handle)) emitter->desc.position = position;
+    }
+
+    // Paused emitters keep their pending bursts
+    void setEmitterActive(ParticleEmitterHandle handle, bool active) {
+        if (Emitter* emitter = m_emitters.get(handle)) emitter->active = active;
+    }
+
+    // `count` extra particles with the next frame
+    void burst(ParticleEmitterHandle handle, uint32_t count) {
+        if (Emitter* emitter = m_emitters.get(handle)) emitter->burst += count;
+    }
+
+    // One-off emission without an emitter (impacts, UI effects)
+    void emitOnce(const ParticleEmitterDesc& desc, uint32_t count) {
+        if (!m_core || count == 0) return;
+        m_oneShots.push_back({desc, count});
+    }
+
+    uint32_t getEmitterCount() const { return m_emitters.size(); }
+    uint32_t getCapacity() const { return m_config.maxParticles; }
+    uint32_t getEmittedLastFrame() const { return m_emittedLastFrame; }  // Requested; the GPU drops any
+                                                                         // beyond the free slots
+
+    // ========================================================================
+    // Per frame
+    // ========================================================================
+
+    // Advances the emitters by dt seconds; the prologue simulates by the
+    // time passed since the last prologue. Call before VulkanCore::beginFrame().
+    void update(float dt) {
+        if (!m_core || dt <= 0.0f) return;
+        m_pendingDt += dt;
+        m_emitters.forEach([&](ParticleEmitterHandle, Emitter& emitter) {
+            if (emitter.active) emitter.accumulated += emitter.desc.rate * dt;
+        });
+    }
+
+    // Every alive particle in one indirect draw. Call inside the render
+    // pass: world-space systems after opaque geometry, screen-space ones
+    // with the UI.
+    void draw() {
+        if (!m_core || !m_drawReady) return;
+
+        VKCORE_GPU_SCOPE_ON(m_core, "particles_draw");
+        VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
+
+        DrawParams params{};
+        if (m_config.screenSpace) {
+            // Pixels -> NDC (Vulkan NDC already has y down)
+            const float w = static_cast<float>(m_core->getWidth());
+            const float h = static_cast<float>(m_core->getHeight());
+            params.viewProj = glm::mat4(1.0f);
+            params.viewProj[0][0] = 2.0f / w;
+            params.viewProj[1][1] = 2.0f / h;
+            params.viewProj[3][0] = -1.0f;
+            params.viewProj[3][1] = -1.0f;
+            params.right = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+            params.up = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+        } else {
+            const glm::mat4& view = m_core->getViewMatrix();
+            params.viewProj = m_core->getProjectionMatrix() * view;
+            params.right = glm::vec4(view[0][0], view[1][0], view[2][0], 0.0f);
+            params.up = glm::vec4(view[0][1], view[1][1], view[2][1], 0.0f);
+        }
+        params.sortCount = m_sortCapacity;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_drawPipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_drawLayout, 0, 1,
+                                &m_sets[m_drawParity], 0, nullptr);
+        m_core->getBindlessHeap().bind(cmd, m_drawLayout, BINDLESS_SET);
+        vkCmdPushConstants(cmd, m_drawLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(params), &params);
+        vkCmdDrawIndirect(cmd, m_counters, offsetof(Counters, vertexCount), 1, sizeof(VkDrawIndirectCommand));
+    }
+
+private:
+    // Must match particle_update.comp
+    struct Particle {
+        glm::vec4 positionAge;
+        glm::vec4 velocityLifetime;
+        uint32_t colorStart;
+        uint32_t colorEnd;
+        float sizeStart;
+        float sizeEnd;
+        float rotation;
+        float spin;
+        uint32_t texture;
+        float drag;
+    };
+
+    struct EmitterData {
+        glm::vec4 position;       // w = spread
+        glm::vec4 direction;      // w = drag
+        glm::vec4 extents;        // w = spin
+        glm::vec4 speedLifetime;
+        glm::vec4 size;
+        uint32_t colorStart;
+        uint32_t colorEnd;
+        uint32_t texture;
+        uint32_t first;
+    };
+
+    struct Counters {
+        uint32_t aliveCount;
+        uint32_t deadCount;
+        uint32_t emitCount;
+        uint32_t nextAliveCount;
+        uint32_t dispatchX, dispatchY, dispatchZ;                        // VkDispatchIndirectCommand
+        uint32_t vertexCount, instanceCount, firstVertex, firstInstance;  // VkDrawIndirectCommand
+        uint32_t pad;
+    };
+
+    enum UpdatePass : uint32_t { PASS_INIT, PASS_PREPARE, PASS_EMIT, PASS_SIMULATE, PASS_FINISH };
+
+    struct UpdateParams {
+        uint32_t pass;
+        uint32_t capacity;
+        uint32_t emitterBase;
+        uint32_t emitterCount;
+        uint32_t emitTotal;
+        uint32_t seed;
+        uint32_t sortCount;
+        float deltaTime;
+        glm::vec4 gravity;
+        glm::vec4 cameraPosition;
+    };
+
+    // Must match particle_sort.comp
+    enum SortMode : uint32_t { SORT_LOCAL, SORT_GLOBAL_STEP, SORT_LOCAL_MERGE };
+    static constexpr uint32_t SORT_BLOCK = 1024;
+
+    struct SortParams {
+        uint32_t mode;
+        uint32_t k;
+        uint32_t j;
+    };
+
+    // Must match particle.vert
+    struct DrawParams {
+        glm::mat4 viewProj;
+        glm::vec4 right;
+        glm::vec4 up;
+        uint32_t sortCount;
+    };
+
+    struct Emitter {
+        ParticleEmitterDesc desc;
+        float accumulated = 0.0f;  // Fractional particles owed by the rate
+        uint32_t burst = 0;
+        bool active = true;
+    };
+
+    struct OneShot {
+        ParticleEmitterDesc desc;
+        uint32_t count;
+    };
+
+    static uint32_t packColor(const glm::vec4& color) {
+        auto channel = [](float v) { return static_cast<uint32_t>(std::lround(std::min(std::max(v, 0.0f), 1.0f) * 255.0f)); };
+        return channel(color.r) | channel(color.g) << 8 | channel(color.b) << 16 | channel(color.a) << 24;
+    }
+
+    static EmitterData packEmitter(const ParticleEmitterDesc& desc, uint32_t first) {
+        EmitterData data;
+        float length = std::sqrt(glm::dot(desc.direction, desc.direction));
+        glm::vec3 direction = length > 0.0f ? desc.direction / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        data.position = glm::vec4(desc.position, desc.spread);
+        data.direction = glm::vec4(direction, desc.drag);
+        data.extents = glm::vec4(desc.extents, desc.spin);
+        data.speedLifetime = glm::vec4(desc.speedMin, desc.speedMax,
+                                       std::max(desc.lifetimeMin, 1e-3f), std::max(desc.lifetimeMax, 1e-3f));
+        data.size = glm::vec4(desc.sizeStart, desc.sizeEnd, 0.0f, 0.0f);
+        data.colorStart = packColor(desc.colorStart);
+        data.colorEnd = packColor(desc.colorEnd);
+        data.texture = desc.texture;
+        data.first = first;
+        return data;
+    }
+
+    // ========================================================================
+    // Setup
+    // ========================================================================
+
+    bool createBuffers() {
+        GpuAllocator& allocator = m_core->getAllocator();
+        VulkanCore& core = *m_core;
+        const VkDeviceSize capacity = m_config.maxParticles;
+        const VkMemoryPropertyFlags local = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        const VkMemoryPropertyFlags host = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        const VkBufferUsageFlags storage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        // Without sorting the key buffer is a placeholder the shaders never
+        // touch. What the draw reads is shared with the compute queue
+        const VkDeviceSize sortEntries = m_sortCapacity ? m_sortCapacity : 1;
+        bool ok = core.createSharedBuffer(capacity * sizeof(Particle), storage, local, m_particles, m_particlesAlloc) &&
+                  allocator.createBuffer(capacity * sizeof(uint32_t), storage, local, m_deadList, m_deadListAlloc) &&
+                  core.createSharedBuffer(capacity * sizeof(uint32_t), storage, local, m_alive[0], m_aliveAlloc[0]) &&
+                  core.createSharedBuffer(capacity * sizeof(uint32_t), storage, local, m_alive[1], m_aliveAlloc[1]) &&
+                  core.createSharedBuffer(sizeof(Counters), storage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, local,
+                                          m_counters, m_countersAlloc) &&
+                  allocator.createBuffer(VkDeviceSize(m_config.maxEmitters) * m_core->getFramesInFlight() * sizeof(EmitterData),
+                                         storage, host, m_emitterBuffer, m_emitterAlloc) &&
+                  core.createSharedBuffer(sortEntries * sizeof(uint32_t) * 2, storage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                          local, m_sortKeys, m_sortKeysAlloc);
+        if (!ok) {
+            std::cerr << "[GpuParticles] Failed to allocate particle buffers" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool loadShader(const std::string& path, const char* source, VkShaderModule& module) {
+        VfsInputStream file(path, std::ios::ate | std::ios::binary);
+        if (!file) {
+            std::cerr << "[GpuParticles] Shader not found: " << path << " (glslc vulkan/core/shaders/" << source
+                      << " -o " << source << ".spv)" << std::endl;
+            return false;
+        }
+        std::vector<char> code(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(code.data(), static_cast<std::streamsize>(code.size()));
+
+        VkShaderModuleCreateInfo moduleInfo{};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = code.size();
+        moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+        return vkCreateShaderModule(m_device, &moduleInfo, nullptr, &module) == VK_SUCCESS;
+    }
+
+    bool createComputePipeline(const std::string& path, const char* source, VkPipeline& pipeline) {
+        VkShaderModule module;
+        if (!loadShader(path, source, module)) return false;
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = module;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = m_computeLayout;
+
+        VkResult result = vkCreateComputePipelines(m_device, m_core->getPipelineCache(), 1, &pipelineInfo,
+                                                   nullptr, &pipeline);
+        vkDestroyShaderModule(m_device, module, nullptr);
+        if (result != VK_SUCCESS) {
+            std::cerr << "[GpuParticles] Failed to create " << source << " pipeline" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // One set layout for every pass: particles, dead list, alive in, alive
+    // out, counters, emitters, sort keys
+    bool createComputePipelines() {
+        std::array<VkDescriptorSetLayoutBinding, 7> bindings{};
+        for (uint32_t i = 0; i < bindings.size(); i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+        if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) return false;
+
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushRange.size = sizeof(UpdateParams);  // SortParams fits too
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_setLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+        if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_computeLayout) != VK_SUCCESS) return false;
+
+        if (!createComputePipeline(m_config.updateShaderPath, "particle_update.comp", m_updatePipeline)) return false;
+        return !m_sortCapacity || createComputePipeline(m_config.sortShaderPath, "particle_sort.comp", m_sortPipeline);
+    }
+
+    bool createDrawPipeline() {
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushRange.size = sizeof(DrawParams);
+
+        // Set 1 = the bindless heap, for particle textures
+        VkDescriptorSetLayout setLayouts[2] = {m_setLayout, m_core->getBindlessSetLayout()};
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 2;
+        pipelineLayoutInfo.pSetLayouts = setLayouts;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+        if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_drawLayout) != VK_SUCCESS) return false;
+
+        VkShaderModule vertModule, fragModule;
+        if (!loadShader(m_config.vertexShaderPath, "particle.vert", vertModule)) return false;
+        if (!loadShader(m_config.fragmentShaderPath, "particle.frag", fragModule)) {
+            vkDestroyShaderModule(m_device, vertModule, nullptr);
+            return false;
+        }
+
+        VkPipelineShaderStageCreateInfo stages[2] = {};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vertModule;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = fragModule;
+        stages[1].pName = "main";
+
+        // Quads are built from gl_VertexIndex / gl_InstanceIndex
+        VkPipelineVertexInputStateCreateInfo vertexInput{};
+        vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizer.lineWidth = 1.0f;
+        rasterizer.cullMode = VK_CULL_MODE_NONE;
+        rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        // Tested against the scene, never written: particles don't occlude each other
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = m_config.screenSpace ? VK_FALSE : VK_TRUE;
+        depthStencil.depthWriteEnable = VK_FALSE;
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+        // The fragment shader writes premultiplied color
+        VkPipelineColorBlendAttachmentState blend{};
+        blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        blend.blendEnable = VK_TRUE;
+        blend.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        blend.dstColorBlendFactor = m_config.blend == ParticleBlend::ADDITIVE
+                                        ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blend.colorBlendOp = VK_BLEND_OP_ADD;
+        blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blend.alphaBlendOp = VK_BLEND_OP_ADD;
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &blend;
+
+        VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = 2;
+        dynamicState.pDynamicStates = dynamicStates;
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = stages;
+        pipelineInfo.pVertexInputState = &vertexInput;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = &depthStencil;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = m_drawLayout;
+        pipelineInfo.renderPass = m_core->getRenderPass();
+        pipelineInfo.subpass = 0;
+
+        VkResult result = vkCreateGraphicsPipelines(m_device, m_core->getPipelineCache(), 1, &pipelineInfo,
+                                                    nullptr, &m_drawPipeline);
+        vkDestroyShaderModule(m_device, vertModule, nullptr);
+        vkDestroyShaderModule(m_device, fragModule, nullptr);
+        if (result != VK_SUCCESS) {
+            std::cerr << "[GpuParticles] Failed to create draw pipeline" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Set p reads alive list p and appends to the other; the draw uses the
+    // set the last prologue ran with (its output list)
+    bool createDescriptorSets() {
+        for (uint32_t p = 0; p < 2; p++) {
+            m_sets[p] = m_core->getDescriptorAllocator().allocate(m_setLayout);
+            if (m_sets[p] == VK_NULL_HANDLE) {
+                std::cerr << "[GpuParticles] Failed to allocate descriptor sets" << std::endl;
+                return false;
+            }
+
+            VkDescriptorBufferInfo infos[7] = {
+                {m_particles, 0, VK_WHOLE_SIZE},
+                {m_deadList, 0, VK_WHOLE_SIZE},
+                {m_alive[p], 0, VK_WHOLE_SIZE},
+                {m_alive[1 - p], 0, VK_WHOLE_SIZE},
+                {m_counters, 0, VK_WHOLE_SIZE},
+                {m_emitterBuffer, 0, VK_WHOLE_SIZE},
+                {m_sortKeys, 0, VK_WHOLE_SIZE},
+            };
+            std::array<VkWriteDescriptorSet, 7> writes{};
+            for (uint32_t i = 0; i < writes.size(); i++) {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = m_sets[p];
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].pBufferInfo = &infos[i];
+            }
+            vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Simulation (frame prologue, outside the render pass)
+    // ========================================================================
+
+    static void computeBarrier(VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                               VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    static void computeToCompute(VkCommandBuffer cmd) {
+        computeBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
+    void dispatchPass(VkCommandBuffer cmd, UpdateParams& params, UpdatePass pass, uint32_t invocations) {
+        params.pass = pass;
+        vkCmdPushConstants(cmd, m_computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        vkCmdDispatch(cmd, (invocations + 63) / 64, 1, 1);
+    }
+
+    void simulate(VkCommandBuffer cmd) {
+        const float dt = m_pendingDt;
+        m_pendingDt = 0.0f;
+
+        // This frame's emitter slice is idle (its fence was waited on)
+        const uint32_t emitterBase = m_core->getCurrentFrame() * m_config.maxEmitters;
+        EmitterData* out = static_cast<EmitterData*>(m_emitterAlloc.mapped) + emitterBase;
+        uint32_t emitterCount = 0;
+        uint32_t total = 0;
+        bool full = false;
+        auto add = [&](const ParticleEmitterDesc& desc, uint32_t count) {
+            if (count == 0) return true;
+            if (emitterCount >= m_config.maxEmitters) {
+                full = true;
+                return false;
+            }
+            out[emitterCount++] = packEmitter(desc, total);
+            total += count;
+            m_maxLifetime = std::max(m_maxLifetime, std::max(desc.lifetimeMin, desc.lifetimeMax));
+            return true;
+        };
+        m_emitters.forEach([&](ParticleEmitterHandle, Emitter& emitter) {
+            uint32_t count = emitter.burst;
+            if (emitter.active) count += static_cast<uint32_t>(emitter.accumulated);
+            if (!add(emitter.desc, count)) return;  // Kept for next frame
+            if (emitter.active) emitter.accumulated -= std::floor(emitter.accumulated);
+            emitter.burst = 0;
+        });
+        size_t shots = 0;
+        while (shots < m_oneShots.size() && add(m_oneShots[shots].desc, m_oneShots[shots].count)) shots++;
+        m_oneShots.erase(m_oneShots.begin(), m_oneShots.begin() + shots);
+        m_emittedLastFrame = total;
+
+        if (full && !m_warnedFull) {
+            std::cerr << "[GpuParticles] maxEmitters (" << m_config.maxEmitters
+                      << ") emitting in one frame - the rest emit next frame" << std::endl;
+            m_warnedFull = true;
+        }
+
+        // Nothing emitted for longer than anything lives: no GPU work at all
+        m_idleTime = total > 0 ? 0.0f : m_idleTime + dt;
+        if (m_poolReady && m_idleTime > m_maxLifetime) {
+            m_drawReady = false;
+            return;
+        }
+        if (!m_poolReady && total == 0) return;
+
+        VKCORE_GPU_SCOPE_ON(m_core, "particles");
+
+        UpdateParams params{};
+        params.capacity = m_config.maxParticles;
+        params.emitterBase = emitterBase;
+        params.emitterCount = emitterCount;
+        params.emitTotal = total;
+        params.seed = static_cast<uint32_t>(m_core->getFrameNumber());
+        params.sortCount = m_sortCapacity;
+        params.deltaTime = dt;
+        params.gravity = glm::vec4(m_config.gravity, 0.0f);
+        if (!m_config.screenSpace) {
+            // Camera position = -R^T t of the view matrix
+            const glm::mat4& view = m_core->getViewMatrix();
+            glm::vec3 t(view[3]);
+            params.cameraPosition = glm::vec4(-(t.x * glm::vec3(view[0][0], view[1][0], view[2][0]) +
+                                                t.y * glm::vec3(view[0][1], view[1][1], view[2][1]) +
+                                                t.z * glm::vec3(view[0][2], view[1][2], view[2][2])), 1.0f);
+        }
+
+        // Last frame's draw reads what this frame rewrites. On the compute
+        // queue the batch already waited for that frame, and only
+        // compute-queue stages may appear here
+        const bool async = m_core->hasAsyncCompute();
+        computeBarrier(cmd, async ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                                  : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+        if (m_sortCapacity) {
+            // Padding keys sort behind every particle
+            vkCmdFillBuffer(cmd, m_sortKeys, 0, VK_WHOLE_SIZE, 0xFFFFFFFFu);
+        }
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_updatePipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_computeLayout, 0, 1,
+                                &m_sets[m_parity], 0, nullptr);
+        if (!m_poolReady) {
+            dispatchPass(cmd, params, PASS_INIT, m_config.maxParticles);
+            computeToCompute(cmd);
+            m_poolReady = true;
+        }
+
+        dispatchPass(cmd, params, PASS_PREPARE, 1);
+        computeToCompute(cmd);
+        if (total > 0) {
+            dispatchPass(cmd, params, PASS_EMIT, total);
+            computeToCompute(cmd);
+        }
+
+        // Sized by PREPARE; the key fill must have landed too
+        computeBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+        params.pass = PASS_SIMULATE;
+        vkCmdPushConstants(cmd, m_computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        vkCmdDispatchIndirect(cmd, m_counters, offsetof(Counters, dispatchX));
+        computeToCompute(cmd);
+        dispatchPass(cmd, params, PASS_FINISH, 1);
+
+        if (m_sortCapacity) {
+            computeToCompute(cmd);
+            sort(cmd);
+        }
+
+        // With async compute the frame's semaphore wait makes the results visible
+        if (!async) {
+            computeBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                           VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+        }
+
+        // The draw reads the list just written; next frame's update reads it too
+        m_drawParity = m_parity;
+        m_parity = 1 - m_parity;
+        m_drawReady = true;
+    }
+
+    // Bitonic sort of the whole key buffer: stages up to SORT_BLOCK in
+    // shared memory, then per larger stage global steps down to SORT_BLOCK
+    // and one shared-memory merge for the rest
+    void sort(VkCommandBuffer cmd) {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_sortPipeline);
+        const uint32_t blocks = m_sortCapacity / SORT_BLOCK;
+        const uint32_t pairGroups = m_sortCapacity / 2 / (SORT_BLOCK / 2);
+
+        auto run = [&](SortMode mode, uint32_t k, uint32_t j, uint32_t groups) {
+            SortParams params{mode, k, j};
+            vkCmdPushConstants(cmd, m_computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+            vkCmdDispatch(cmd, groups, 1, 1);
+        };
+
+        run(SORT_LOCAL, 0, 0, blocks);
+        for (uint32_t k = SORT_BLOCK * 2; k <= m_sortCapacity; k <<= 1) {
+            for (uint32_t j = k / 2; j >= SORT_BLOCK; j >>= 1) {
+                computeToCompute(cmd);
+                run(SORT_GLOBAL_STEP, k, j, pairGroups);
+            }
+            computeToCompute(cmd);
+            run(SORT_LOCAL_MERGE, k, 0, blocks);
+        }
+    }
+
+    VulkanCore* m_core = nullptr;
+    VkDevice m_device = VK_NULL_HANDLE;
+    ParticleSystemConfig m_config;
+    uint32_t m_sortCapacity = 0;  // Power of two, 0 = unsorted
+    uint32_t m_prologueId = 0;
+    bool m_warnedFull = false;
+
+    HandlePool<Emitter> m_emitters;
+    std::vector<OneShot> m_oneShots;
+    float m_pendingDt = 0.0f;
+    float m_idleTime = 0.0f;      // Since anything was last emitted
+    float m_maxLifetime = 0.0f;   // Longest lifetime ever emitted
+    uint32_t m_emittedLastFrame = 0;
+
+    bool m_poolReady = false;     // INIT pass recorded
+    bool m_drawReady = false;     // The last prologue simulated
+    uint32_t m_parity = 0;        // Set (alive list) the next prologue reads
+    uint32_t m_drawParity = 0;
+
+    VkBuffer m_particles = VK_NULL_HANDLE;      GpuAllocation m_particlesAlloc;
+    VkBuffer m_deadList = VK_NULL_HANDLE;       GpuAllocation m_deadListAlloc;
+    VkBuffer m_alive[2] = {};                   GpuAllocation m_aliveAlloc[2];
+    VkBuffer m_counters = VK_NULL_HANDLE;       GpuAllocation m_countersAlloc;  // Also the indirect args
+    VkBuffer m_emitterBuffer = VK_NULL_HANDLE;  GpuAllocation m_emitterAlloc;   // Host-visible, per-frame slices
+    VkBuffer m_sortKeys = VK_NULL_HANDLE;       GpuAllocation m_sortKeysAlloc;
+
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 2> m_sets = {};
+    VkPipelineLayout m_computeLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_drawLayout = VK_NULL_HANDLE;
+    VkPipeline m_updatePipeline = VK_NULL_HANDLE;
+    VkPipeline m_sortPipeline = VK_NULL_HANDLE;
+    VkPipeline m_drawPipeline = VK_NULL_HANDLE;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_GPU_PARTICLES_H
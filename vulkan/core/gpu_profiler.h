@@ -0,0 +1,328 @@
+// ============================================================================
+// GPU PROFILER - Timestamp queries with named scopes
+// ============================================================================
+// Measures how long the GPU spends on each named scope of a frame:
+//
+//   - beginScope()/endScope() write a TOP_OF_PIPE / BOTTOM_OF_PIPE timestamp
+//     pair into the given command buffer.
+//   - Every frame in flight owns its own range of one VkQueryPool, so results
+//     are read back only after that frame's fence signalled - no stalls.
+//   - beginFrame() resolves the range from the slot's previous use (named
+//     timings, summed per name) and resets it for this frame.
+//   - The last TRACE_FRAMES frames are kept for exportChromeTrace()
+//     (open the file in chrome://tracing or ui.perfetto.dev).
+//
+// Scope names must outlive the frame (string literals). beginScope() is
+// thread-safe, so scopes work inside VulkanCore::recordParallel() tasks.
+// Devices without timestamp support (timestampValidBits == 0) leave the
+// profiler disabled and every call a no-op.
+//
+// Header-only, like gpu_allocator.h. VulkanCore owns one and adds the
+// VKCORE_GPU_SCOPE() macro on top.
+//
+// Usage:
+//   GpuProfiler profiler;
+//   profiler.init(device, physicalDevice, timestampValidBits, framesInFlight);
+//   profiler.beginFrame(cmd, frameIndex);             // outside a render pass
+//   uint32_t s = profiler.beginScope(cmd, "shadows");
+//   ... record ...
+//   profiler.endScope(cmd, s);
+//   for (auto& t : profiler.getTimings()) printf("%s %.3f ms\n", t.name.c_str(), t.ms);
+//   profiler.shutdown();                              // before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_GPU_PROFILER_H
+#define VKCORE_GPU_PROFILER_H
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+class GpuProfiler {
+public:
+    static constexpr uint32_t MAX_FRAMES = 4;
+    static constexpr uint32_t MAX_SCOPES_PER_FRAME = 2048;
+    static constexpr uint32_t NO_SCOPE = UINT32_MAX;
+    static constexpr size_t TRACE_FRAMES = 240;  // ~4 s at 60 fps
+
+    // One entry per scope name in the last resolved frame (first-use order)
+    struct Timing {
+        std::string name;
+        float ms = 0.0f;
+        uint32_t count = 0;  // Scopes with this name, summed into ms
+    };
+
+    GpuProfiler() = default;
+    ~GpuProfiler() { shutdown(); }
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    // timestampValidBits: of the queue family the scopes are recorded on
+    bool init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t timestampValidBits, uint32_t framesInFlight) {
+        if (m_device != VK_NULL_HANDLE) return true;
+
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+        if (timestampValidBits == 0 || props.limits.timestampPeriod <= 0.0f) {
+            std::cout << "[GpuProfiler] Timestamps not supported on this queue - GPU timings disabled" << std::endl;
+            return false;
+        }
+
+        m_frameCount = framesInFlight < 1 ? 1 : (framesInFlight > MAX_FRAMES ? MAX_FRAMES : framesInFlight);
+
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = m_frameCount * MAX_SCOPES_PER_FRAME * 2;
+
+        if (vkCreateQueryPool(device, &poolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+            std::cerr << "[GpuProfiler] Failed to create timestamp query pool" << std::endl;
+            return false;
+        }
+
+        m_device = device;
+        m_timestampMask = timestampValidBits >= 64 ? ~0ull : ((1ull << timestampValidBits) - 1);
+        m_nsPerTick = props.limits.timestampPeriod;
+        m_results.resize(MAX_SCOPES_PER_FRAME * 2 * 2);  // value + availability per query
+        for (auto& frame : m_frames) {
+            frame.used = 0;
+            frame.names.assign(MAX_SCOPES_PER_FRAME, nullptr);
+            frame.pending = false;
+        }
+        return true;
+    }
+
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+        m_queryPool = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+        m_timings.clear();
+        m_trace.clear();
+    }
+
+    bool isEnabled() const { return m_device != VK_NULL_HANDLE; }
+
+    // ========================================================================
+    // Recording
+    // ========================================================================
+
+    // Call once per frame, outside a render pass, after frameIndex's fence
+    // has signalled. Resolves that slot's previous frame and resets it.
+    void beginFrame(VkCommandBuffer cmd, uint32_t frameIndex) {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        m_recordFrame = frameIndex % m_frameCount;
+        FrameSlot& frame = m_frames[m_recordFrame];
+        if (frame.pending) resolve(frame, m_recordFrame);
+
+        vkCmdResetQueryPool(cmd, m_queryPool, queryBase(m_recordFrame), MAX_SCOPES_PER_FRAME * 2);
+        frame.used = 0;
+        frame.overflowWarned = false;
+        frame.pending = true;
+    }
+
+    // Writes the scope's start timestamp; returns NO_SCOPE when disabled or
+    // when the frame ran out of queries. BOTTOM_OF_PIPE starts the scope only
+    // once earlier work finished, so it covers just this scope's commands
+    uint32_t beginScope(VkCommandBuffer cmd, const char* name,
+                        VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT) {
+        if (m_device == VK_NULL_HANDLE || cmd == VK_NULL_HANDLE || m_suspended) return NO_SCOPE;
+
+        FrameSlot& frame = m_frames[m_recordFrame];
+        uint32_t scope = frame.used.fetch_add(1, std::memory_order_relaxed);
+        if (scope >= MAX_SCOPES_PER_FRAME) {
+            frame.used.store(MAX_SCOPES_PER_FRAME, std::memory_order_relaxed);
+            if (!frame.overflowWarned.exchange(true)) {
+                std::cerr << "[GpuProfiler] More than " << MAX_SCOPES_PER_FRAME
+                          << " scopes this frame - extra scopes are not timed" << std::endl;
+            }
+            return NO_SCOPE;
+        }
+
+        frame.names[scope] = name;
+        vkCmdWriteTimestamp(cmd, stage, m_queryPool, queryBase(m_recordFrame) + scope * 2);
+        return scope;
+    }
+
+    // While suspended beginScope() returns NO_SCOPE - for command buffers
+    // submitted to another queue ahead of the one that resets the queries
+    // (VulkanCore's async compute batch)
+    void setSuspended(bool suspended) { m_suspended = suspended; }
+
+    // cmd may differ from the begin buffer (e.g. across parallel segments)
+    // as long as it executes after it
+    void endScope(VkCommandBuffer cmd, uint32_t scope) {
+        if (m_device == VK_NULL_HANDLE || cmd == VK_NULL_HANDLE || scope == NO_SCOPE) return;
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool,
+                            queryBase(m_recordFrame) + scope * 2 + 1);
+    }
+
+    // ========================================================================
+    // Results
+    // ========================================================================
+
+    // Last resolved frame (framesInFlight frames behind the one recording)
+    const std::vector<Timing>& getTimings() const { return m_timings; }
+
+    // The entry for `name` in getTimings(), nullptr when it wasn't recorded
+    const Timing* findTiming(const char* name) const {
+        for (const Timing& timing : m_timings) {
+            if (timing.name == name) return &timing;
+        }
+        return nullptr;
+    }
+
+    // First scope start to last scope end of the last resolved frame
+    float getFrameMs() const { return m_frameMs; }
+
+    // Writes the kept frames as Chrome trace JSON ("X" complete events)
+    bool exportChromeTrace(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            std::cerr << "[GpuProfiler] Cannot write " << path << std::endl;
+            return false;
+        }
+
+        file << "{\"traceEvents\":[\n";
+        bool first = true;
+        for (const auto& frame : m_trace) {
+            for (const auto& event : frame) {
+                file << (first ? "" : ",\n") << "{\"name\":\"" << jsonEscape(event.name)
+                     << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << event.startUs
+                     << ",\"dur\":" << event.durationUs << "}";
+                first = false;
+            }
+        }
+        file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        std::cout << "[GpuProfiler] Wrote " << m_trace.size() << " frames to " << path << std::endl;
+        return static_cast<bool>(file);
+    }
+
+private:
+    struct FrameSlot {
+        std::atomic<uint32_t> used{0};
+        std::atomic<bool> overflowWarned{false};
+        std::vector<const char*> names;
+        bool pending = false;  // Recorded, not yet resolved
+    };
+
+    struct TraceEvent {
+        const char* name;
+        double startUs;
+        double durationUs;
+    };
+
+    uint32_t queryBase(uint32_t frameIndex) const { return frameIndex * MAX_SCOPES_PER_FRAME * 2; }
+
+    void resolve(FrameSlot& frame, uint32_t frameIndex) {
+        frame.pending = false;
+        m_timings.clear();
+        m_frameMs = 0.0f;
+
+        uint32_t used = frame.used.load(std::memory_order_relaxed);
+        if (used > MAX_SCOPES_PER_FRAME) used = MAX_SCOPES_PER_FRAME;
+        if (used == 0) return;
+
+        // Never WAIT: the frame's fence already signalled, and a scope that
+        // was begun but never ended must not hang the CPU
+        VkResult result = vkGetQueryPoolResults(m_device, m_queryPool, queryBase(frameIndex), used * 2,
+                                                used * 2 * 2 * sizeof(uint64_t), m_results.data(),
+                                                2 * sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result != VK_SUCCESS && result != VK_NOT_READY) return;
+
+        std::vector<TraceEvent> events;
+        events.reserve(used);
+        uint64_t frameStart = UINT64_MAX;
+        uint64_t frameEnd = 0;
+
+        for (uint32_t i = 0; i < used; i++) {
+            const uint64_t* begin = &m_results[i * 4];
+            const uint64_t* end = &m_results[i * 4 + 2];
+            if (!begin[1] || !end[1] || !frame.names[i]) continue;  // Not written
+
+            uint64_t start = begin[0] & m_timestampMask;
+            uint64_t ticks = ((end[0] & m_timestampMask) - start) & m_timestampMask;
+            float ms = static_cast<float>(ticks * static_cast<double>(m_nsPerTick) / 1e6);
+
+            addTiming(frame.names[i], ms);
+
+            if (m_traceOrigin == UINT64_MAX) m_traceOrigin = start;
+            uint64_t sinceOrigin = (start - m_traceOrigin) & m_timestampMask;
+            events.push_back({frame.names[i], sinceOrigin * static_cast<double>(m_nsPerTick) / 1e3,
+                              ticks * static_cast<double>(m_nsPerTick) / 1e3});
+
+            if (start < frameStart) frameStart = start;
+            if (start + ticks > frameEnd) frameEnd = start + ticks;
+        }
+
+        if (frameEnd > frameStart) {
+            m_frameMs = static_cast<float>((frameEnd - frameStart) * static_cast<double>(m_nsPerTick) / 1e6);
+        }
+
+        m_trace.push_back(std::move(events));
+        if (m_trace.size() > TRACE_FRAMES) m_trace.pop_front();
+    }
+
+    void addTiming(const char* name, float ms) {
+        for (auto& timing : m_timings) {
+            if (timing.name == name) {
+                timing.ms += ms;
+                timing.count++;
+                return;
+            }
+        }
+        Timing timing;
+        timing.name = name;
+        timing.ms = ms;
+        timing.count = 1;
+        m_timings.push_back(std::move(timing));
+    }
+
+    static std::string jsonEscape(const char* text) {
+        std::string out;
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') out += '\\';
+            if (static_cast<unsigned char>(*c) >= 0x20) out += *c;
+        }
+        return out;
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    uint32_t m_frameCount = 1;
+    uint32_t m_recordFrame = 0;
+    bool m_suspended = false;
+    uint64_t m_timestampMask = ~0ull;
+    float m_nsPerTick = 1.0f;
+
+    FrameSlot m_frames[MAX_FRAMES];
+    std::vector<uint64_t> m_results;
+
+    std::vector<Timing> m_timings;
+    float m_frameMs = 0.0f;
+
+    std::deque<std::vector<TraceEvent>> m_trace;
+    uint64_t m_traceOrigin = UINT64_MAX;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_GPU_PROFILER_H
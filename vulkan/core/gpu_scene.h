@@ -0,0 +1,585 @@
+// ============================================================================
+// GPU SCENE - GPU-driven culling and indirect drawing on top of VulkanCore
+// ============================================================================
+// For scenes with thousands of objects, where one drawMesh() per object
+// makes CPU submission the bottleneck:
+//
+//   - addMesh() packs geometry into ONE vertex and ONE index megabuffer
+//     (device-local, uploaded on the transfer queue), so every object draws
+//     from the same bindings.
+//   - Objects (InstanceData + local bounding sphere) live in per-frame
+//     storage buffers, rewritten only when something changed.
+//   - A compute prologue runs shaders/gpu_cull.comp (on the async compute
+//     queue when there is one, overlapping the previous frame): frustum
+//     test per object, writing one VkDrawIndexedIndirectCommand each
+//     (firstInstance = object index).
+//   - draw() is a single VulkanCore::drawIndexedIndirect(): with
+//     VK_KHR_draw_indirect_count the culled list is compacted and drawn
+//     with vkCmdDrawIndexedIndirectCountKHR, otherwise culled objects stay
+//     in the list with instanceCount 0.
+//
+// Draw with an instanced pipeline (PipelineConfig::instanced) whose vertex
+// format matches GpuSceneConfig::vertexFormat - the instanced_*.vert
+// shaders work unchanged. Needs drawIndirectFirstInstance. Culling uses the
+// camera set before VulkanCore::beginFrame().
+//
+// Header-only, like render_queue.h. Not thread-safe: modify the scene on
+// the render thread; draw() may be called from a recordParallel task.
+//
+// Usage:
+//   GpuScene scene;
+//   scene.init(&core);
+//   GpuScene::MeshId rock = scene.addMesh(rockData);
+//   GpuScene::ObjectId id = scene.addObject(rock, transform);
+//   // per frame, inside the render pass:
+//   core.bindPipeline(instancedPipeline);
+//   scene.draw();
+//   scene.shutdown();                  // before core.shutdown()
+// ============================================================================
+
+#ifndef VKCORE_GPU_SCENE_H
+#define VKCORE_GPU_SCENE_H
+
+#include "vulkan_core.h"
+#include "../../stdlib/vfs.h"
+
+#include <vector>
+#include <array>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+namespace vkcore {
+
+struct GpuSceneConfig {
+    VertexFormat vertexFormat = VertexFormat::POSITION_NORMAL_UV;  // All meshes share it (float formats only)
+    VkDeviceSize vertexCapacity = 64ull * 1024 * 1024;  // Vertex megabuffer bytes
+    uint32_t indexCapacity = 8u * 1024 * 1024;          // Index megabuffer indices
+    uint32_t maxObjects = 65536;
+    uint32_t maxMeshes = 4096;
+    std::string cullShaderPath = "shaders/gpu_cull.comp.spv";
+};
+
+class GpuScene {
+public:
+    using MeshId = uint32_t;
+    using ObjectId = uint32_t;
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    GpuScene() = default;
+    ~GpuScene() { shutdown(); }
+
+    GpuScene(const GpuScene&) = delete;
+    GpuScene& operator=(const GpuScene&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VulkanCore* core, const GpuSceneConfig& config = GpuSceneConfig()) {
+        if (m_core) return true;
+        if (!core || !core->isInitialized() || config.vertexFormat == VertexFormat::CUSTOM) return false;
+        if (isPackedVertexFormat(config.vertexFormat)) {
+            // Instances carry one model matrix; each packed mesh needs its own dequantization
+            std::cerr << "[GpuScene] Packed vertex formats are not supported - use drawMesh/RenderQueue" << std::endl;
+            return false;
+        }
+
+        if (!core->supportsIndirectFirstInstance()) {
+            std::cerr << "[GpuScene] Device lacks drawIndirectFirstInstance - use drawMesh/RenderQueue instead" << std::endl;
+            return false;
+        }
+
+        m_core = core;
+        m_device = core->getDevice();
+        m_config = config;
+        m_stride = core->getVertexStride(config.vertexFormat);
+        m_compact = core->supportsDrawIndirectCount();
+
+        if (!createBuffers() || !createCullPipeline()) {
+            shutdown();
+            return false;
+        }
+
+        // Outputs are per frame in flight, so with async compute culling
+        // overlaps the previous frame; only the indirect draws wait for it
+        m_prologueId = core->addComputePrologue([this](VkCommandBuffer cmd) { cull(cmd); },
+                                                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, true);
+
+        std::cout << "[GpuScene] Ready (" << config.maxObjects << " objects, "
+                  << (config.vertexCapacity / (1024 * 1024)) << " MB vertices, "
+                  << (m_compact ? "compacted draw-count" : "fixed-count") << " indirect)" << std::endl;
+        return true;
+    }
+
+    // Before VulkanCore::shutdown()
+    void shutdown() {
+        if (!m_core) return;
+
+        vkDeviceWaitIdle(m_device);
+        if (m_prologueId) m_core->removeFramePrologue(m_prologueId);
+        m_prologueId = 0;
+
+        if (m_pipeline) vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        if (m_pipelineLayout) vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+        if (m_descriptorPool) vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+        if (m_setLayout) vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+        m_pipeline = VK_NULL_HANDLE;
+        m_pipelineLayout = VK_NULL_HANDLE;
+        m_descriptorPool = VK_NULL_HANDLE;
+        m_setLayout = VK_NULL_HANDLE;
+
+        GpuAllocator& allocator = m_core->getAllocator();
+        for (auto& frame : m_frames) {
+            allocator.destroyBuffer(frame.instances, frame.instancesAlloc);
+            allocator.destroyBuffer(frame.cullInfos, frame.cullInfosAlloc);
+            allocator.destroyBuffer(frame.meshInfos, frame.meshInfosAlloc);
+            allocator.destroyBuffer(frame.draws, frame.drawsAlloc);
+            allocator.destroyBuffer(frame.drawCount, frame.drawCountAlloc);
+        }
+        m_frames.clear();
+
+        if (m_vertexBuffer != INVALID_BUFFER) m_core->destroyBuffer(m_vertexBuffer);
+        if (m_indexBuffer != INVALID_BUFFER) m_core->destroyBuffer(m_indexBuffer);
+        m_vertexBuffer = INVALID_BUFFER;
+        m_indexBuffer = INVALID_BUFFER;
+
+        m_meshes.clear();
+        m_meshInfos.clear();
+        m_pendingMeshes.clear();
+        m_instances.clear();
+        m_cullInfos.clear();
+        m_freeObjects.clear();
+        m_vertexHead = 0;
+        m_indexHead = 0;
+        m_core = nullptr;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isInitialized() const { return m_core != nullptr; }
+
+    // ========================================================================
+    // Meshes
+    // ========================================================================
+
+    // Appends the mesh to the megabuffers (data.format must match the
+    // scene's). Objects using it are culled until its upload has landed.
+    MeshId addMesh(const MeshData& data) {
+        if (!m_core || data.format != m_config.vertexFormat || data.indices.empty()) return INVALID_ID;
+
+        const uint32_t floatsPerVertex = m_stride / sizeof(float);
+        const uint32_t vertexCount = static_cast<uint32_t>(data.vertices.size() / floatsPerVertex);
+        const VkDeviceSize vertexBytes = static_cast<VkDeviceSize>(vertexCount) * m_stride;
+        const uint32_t indexCount = static_cast<uint32_t>(data.indices.size());
+
+        if (m_meshes.size() >= m_config.maxMeshes ||
+            static_cast<VkDeviceSize>(m_vertexHead) * m_stride + vertexBytes > m_config.vertexCapacity ||
+            m_indexHead + indexCount > m_config.indexCapacity) {
+            std::cerr << "[GpuScene] Megabuffers full - mesh not added (raise GpuSceneConfig capacities)" << std::endl;
+            return INVALID_ID;
+        }
+
+        MeshEntry entry;
+        entry.info.indexCount = indexCount;
+        entry.info.firstIndex = m_indexHead;
+        entry.info.vertexOffset = static_cast<int32_t>(m_vertexHead);
+
+        UploadManager::Ticket vt = m_core->uploadToBuffer(m_vertexBuffer, data.vertices.data(), vertexBytes,
+                                                          static_cast<VkDeviceSize>(m_vertexHead) * m_stride);
+        UploadManager::Ticket it = m_core->uploadToBuffer(m_indexBuffer, data.indices.data(),
+                                                          indexCount * sizeof(uint32_t),
+                                                          static_cast<VkDeviceSize>(m_indexHead) * sizeof(uint32_t));
+        if (vt == UploadManager::NO_UPLOAD || it == UploadManager::NO_UPLOAD) return INVALID_ID;
+        entry.ticket = vt > it ? vt : it;
+        entry.sphere = boundingSphere(data.vertices.data(), vertexCount, floatsPerVertex);
+
+        m_vertexHead += vertexCount;
+        m_indexHead += indexCount;
+
+        MeshId id = static_cast<MeshId>(m_meshes.size());
+        m_meshes.push_back(entry);
+        m_meshInfos.push_back(MeshInfo{});  // indexCount 0 until the upload lands
+        m_pendingMeshes.push_back(id);
+        markDirty();
+        return id;
+    }
+
+    // ========================================================================
+    // Objects
+    // ========================================================================
+
+    ObjectId addObject(MeshId mesh, const glm::mat4& transform, const glm::vec4& color = glm::vec4(1.0f)) {
+        if (!m_core || mesh >= m_meshes.size()) return INVALID_ID;
+
+        ObjectId id;
+        if (!m_freeObjects.empty()) {
+            id = m_freeObjects.back();
+            m_freeObjects.pop_back();
+        } else {
+            if (m_instances.size() >= m_config.maxObjects) {
+                std::cerr << "[GpuScene] maxObjects (" << m_config.maxObjects << ") reached" << std::endl;
+                return INVALID_ID;
+            }
+            id = static_cast<ObjectId>(m_instances.size());
+            m_instances.emplace_back();
+            m_cullInfos.emplace_back();
+        }
+
+        m_instances[id].model = transform;
+        m_instances[id].color = color;
+        m_cullInfos[id] = CullInfo{};  // A recycled id still carries removed = 1
+        m_cullInfos[id].sphere = m_meshes[mesh].sphere;
+        m_cullInfos[id].mesh = mesh;
+        m_cullInfos[id].enabled = 1;
+        markDirty();
+        return id;
+    }
+
+    void removeObject(ObjectId id) {
+        if (!isObject(id)) return;
+        m_cullInfos[id] = CullInfo{};  // mesh 0, disabled
+        m_cullInfos[id].removed = 1;
+        m_freeObjects.push_back(id);
+        markDirty();
+    }
+
+    void setTransform(ObjectId id, const glm::mat4& transform) {
+        if (!isObject(id)) return;
+        m_instances[id].model = transform;
+        markDirty();
+    }
+
+    void setColor(ObjectId id, const glm::vec4& color) {
+        if (!isObject(id)) return;
+        m_instances[id].color = color;
+        markDirty();
+    }
+
+    void setEnabled(ObjectId id, bool enabled) {
+        if (!isObject(id)) return;
+        m_cullInfos[id].enabled = enabled ? 1 : 0;
+        markDirty();
+    }
+
+    uint32_t getObjectCount() const { return static_cast<uint32_t>(m_instances.size() - m_freeObjects.size()); }
+    uint32_t getMeshCount() const { return static_cast<uint32_t>(m_meshes.size()); }
+
+    // ========================================================================
+    // Drawing
+    // ========================================================================
+
+    // One indirect draw for every object culled this frame. Call inside the
+    // render pass with an instanced pipeline bound.
+    void draw() {
+        if (!m_core || m_instances.empty() || !m_culledThisFrame) return;
+        if (!m_core->isBufferReady(m_vertexBuffer) || !m_core->isBufferReady(m_indexBuffer)) return;
+
+        VKCORE_GPU_SCOPE_ON(m_core, "gpu_scene");
+        const FrameResources& frame = m_frames[m_core->getCurrentFrame()];
+        m_core->drawIndexedIndirect(m_core->getBuffer(m_vertexBuffer), m_core->getBuffer(m_indexBuffer),
+                                    frame.instances, frame.draws, static_cast<uint32_t>(m_instances.size()),
+                                    m_compact ? frame.drawCount : VK_NULL_HANDLE);
+    }
+
+private:
+    // Must match gpu_cull.comp
+    struct CullInfo {
+        glm::vec4 sphere = glm::vec4(0.0f);
+        uint32_t mesh = 0;
+        uint32_t enabled = 0;
+        uint32_t removed = 0;  // Shader padding; CPU bookkeeping only
+        uint32_t pad = 0;
+    };
+
+    struct MeshInfo {
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t pad = 0;
+    };
+
+    struct CullParams {
+        glm::vec4 planes[6];
+        uint32_t objectCount;
+        uint32_t compact;
+    };
+
+    struct MeshEntry {
+        MeshInfo info;
+        glm::vec4 sphere;
+        UploadManager::Ticket ticket = UploadManager::NO_UPLOAD;
+    };
+
+    struct FrameResources {
+        VkBuffer instances = VK_NULL_HANDLE;  GpuAllocation instancesAlloc;   // Host-visible
+        VkBuffer cullInfos = VK_NULL_HANDLE;  GpuAllocation cullInfosAlloc;   // Host-visible
+        VkBuffer meshInfos = VK_NULL_HANDLE;  GpuAllocation meshInfosAlloc;   // Host-visible
+        VkBuffer draws = VK_NULL_HANDLE;      GpuAllocation drawsAlloc;       // Device-local, indirect
+        VkBuffer drawCount = VK_NULL_HANDLE;  GpuAllocation drawCountAlloc;   // Device-local, indirect
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        uint64_t uploadedVersion = 0;
+    };
+
+    bool isObject(ObjectId id) const { return id < m_cullInfos.size() && !m_cullInfos[id].removed; }
+
+    void markDirty() { m_version++; }
+
+    static glm::vec4 boundingSphere(const float* vertices, uint32_t vertexCount, uint32_t floatsPerVertex) {
+        glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            glm::vec3 p(vertices[i * floatsPerVertex], vertices[i * floatsPerVertex + 1], vertices[i * floatsPerVertex + 2]);
+            lo = glm::min(lo, p);
+            hi = glm::max(hi, p);
+        }
+        glm::vec3 center = (lo + hi) * 0.5f;
+        float radiusSq = 0.0f;
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            glm::vec3 p(vertices[i * floatsPerVertex], vertices[i * floatsPerVertex + 1], vertices[i * floatsPerVertex + 2]);
+            glm::vec3 d = p - center;
+            radiusSq = glm::max(radiusSq, glm::dot(d, d));
+        }
+        return glm::vec4(center, std::sqrt(radiusSq));
+    }
+
+    // ========================================================================
+    // Setup
+    // ========================================================================
+
+    bool createBuffers() {
+        m_vertexBuffer = m_core->createDeviceLocalBuffer(nullptr, m_config.vertexCapacity,
+                                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        m_indexBuffer = m_core->createDeviceLocalBuffer(nullptr, static_cast<VkDeviceSize>(m_config.indexCapacity) * sizeof(uint32_t),
+                                                        VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+        if (m_vertexBuffer == INVALID_BUFFER || m_indexBuffer == INVALID_BUFFER) {
+            std::cerr << "[GpuScene] Failed to allocate megabuffers" << std::endl;
+            return false;
+        }
+
+        GpuAllocator& allocator = m_core->getAllocator();
+        const VkMemoryPropertyFlags host = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        const VkBufferUsageFlags indirect = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        const VkDeviceSize objects = m_config.maxObjects;
+
+        m_frames.resize(m_core->getFramesInFlight());
+        // Culling may run on the compute queue: what the draws read is shared
+        for (auto& frame : m_frames) {
+            bool ok = m_core->createSharedBuffer(objects * sizeof(InstanceData),
+                                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                                 host, frame.instances, frame.instancesAlloc) &&
+                      allocator.createBuffer(objects * sizeof(CullInfo), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                             host, frame.cullInfos, frame.cullInfosAlloc) &&
+                      allocator.createBuffer(m_config.maxMeshes * sizeof(MeshInfo), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                             host, frame.meshInfos, frame.meshInfosAlloc) &&
+                      m_core->createSharedBuffer(objects * sizeof(VkDrawIndexedIndirectCommand), indirect,
+                                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.draws, frame.drawsAlloc) &&
+                      m_core->createSharedBuffer(sizeof(uint32_t), indirect | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.drawCount,
+                                                 frame.drawCountAlloc);
+            if (!ok) {
+                std::cerr << "[GpuScene] Failed to allocate per-frame object buffers" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool createCullPipeline() {
+        VfsInputStream file(m_config.cullShaderPath, std::ios::ate | std::ios::binary);
+        if (!file) {
+            std::cerr << "[GpuScene] Cull shader not found: " << m_config.cullShaderPath
+                      << " (glslc vulkan/core/shaders/gpu_cull.comp -o gpu_cull.comp.spv)" << std::endl;
+            return false;
+        }
+        std::vector<char> code(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(code.data(), static_cast<std::streamsize>(code.size()));
+
+        std::array<VkDescriptorSetLayoutBinding, 5> bindings{};
+        for (uint32_t i = 0; i < bindings.size(); i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+        if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) return false;
+
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushRange.size = sizeof(CullParams);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_setLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+        if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) return false;
+
+        VkShaderModuleCreateInfo moduleInfo{};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = code.size();
+        moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+        VkShaderModule module;
+        if (vkCreateShaderModule(m_device, &moduleInfo, nullptr, &module) != VK_SUCCESS) return false;
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = module;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = m_pipelineLayout;
+
+        VkResult result = vkCreateComputePipelines(m_device, m_core->getPipelineCache(), 1, &pipelineInfo,
+                                                   nullptr, &m_pipeline);
+        vkDestroyShaderModule(m_device, module, nullptr);
+        if (result != VK_SUCCESS) {
+            std::cerr << "[GpuScene] Failed to create cull pipeline" << std::endl;
+            return false;
+        }
+
+        // One set per frame in flight over that frame's buffers
+        const uint32_t frameCount = static_cast<uint32_t>(m_frames.size());
+        VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, frameCount * 5};
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = frameCount;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) return false;
+
+        for (auto& frame : m_frames) {
+            VkDescriptorSetAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.descriptorPool = m_descriptorPool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &m_setLayout;
+            if (vkAllocateDescriptorSets(m_device, &allocInfo, &frame.descriptorSet) != VK_SUCCESS) return false;
+
+            VkDescriptorBufferInfo infos[5] = {
+                {frame.instances, 0, VK_WHOLE_SIZE},
+                {frame.cullInfos, 0, VK_WHOLE_SIZE},
+                {frame.meshInfos, 0, VK_WHOLE_SIZE},
+                {frame.draws, 0, VK_WHOLE_SIZE},
+                {frame.drawCount, 0, VK_WHOLE_SIZE},
+            };
+            std::array<VkWriteDescriptorSet, 5> writes{};
+            for (uint32_t i = 0; i < writes.size(); i++) {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = frame.descriptorSet;
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].pBufferInfo = &infos[i];
+            }
+            vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Culling (compute prologue, outside the render pass)
+    // ========================================================================
+
+    void cull(VkCommandBuffer cmd) {
+        m_culledThisFrame = false;
+        if (m_instances.empty()) return;
+
+        // Meshes whose upload landed become drawable
+        for (size_t i = 0; i < m_pendingMeshes.size();) {
+            MeshId id = m_pendingMeshes[i];
+            if (m_core->isUploadComplete(m_meshes[id].ticket)) {
+                m_meshInfos[id] = m_meshes[id].info;
+                m_pendingMeshes[i] = m_pendingMeshes.back();
+                m_pendingMeshes.pop_back();
+                markDirty();
+            } else {
+                i++;
+            }
+        }
+
+        FrameResources& frame = m_frames[m_core->getCurrentFrame()];
+        if (frame.uploadedVersion != m_version) {
+            // This frame's buffers are idle (its fence was waited on)
+            memcpy(frame.instancesAlloc.mapped, m_instances.data(), m_instances.size() * sizeof(InstanceData));
+            memcpy(frame.cullInfosAlloc.mapped, m_cullInfos.data(), m_cullInfos.size() * sizeof(CullInfo));
+            memcpy(frame.meshInfosAlloc.mapped, m_meshInfos.data(), m_meshInfos.size() * sizeof(MeshInfo));
+            frame.uploadedVersion = m_version;
+        }
+
+        if (m_compact) {
+            vkCmdFillBuffer(cmd, frame.drawCount, 0, sizeof(uint32_t), 0);
+            VkMemoryBarrier clear{};
+            clear.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            clear.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            clear.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0, 1, &clear, 0, nullptr, 0, nullptr);
+        }
+
+        CullParams params;
+        extractFrustum(m_core->getProjectionMatrix() * m_core->getViewMatrix(), params.planes);
+        params.objectCount = static_cast<uint32_t>(m_instances.size());
+        params.compact = m_compact ? 1 : 0;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                                &frame.descriptorSet, 0, nullptr);
+        vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        vkCmdDispatch(cmd, (params.objectCount + 63) / 64, 1, 1);
+
+        VkMemoryBarrier written{};
+        written.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        written.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        written.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                             0, 1, &written, 0, nullptr, 0, nullptr);
+        m_culledThisFrame = true;
+    }
+
+    // Gribb-Hartmann planes of a Vulkan (0..1 depth) view-projection
+    static void extractFrustum(const glm::mat4& m, glm::vec4 planes[6]) {
+        Frustum frustum = Frustum::fromViewProjection(m);
+        for (int i = 0; i < 6; i++) planes[i] = frustum.planes[i];
+    }
+
+    VulkanCore* m_core = nullptr;
+    VkDevice m_device = VK_NULL_HANDLE;
+    GpuSceneConfig m_config;
+    uint32_t m_stride = 0;
+    bool m_compact = false;
+    uint32_t m_prologueId = 0;
+    bool m_culledThisFrame = false;
+
+    BufferHandle m_vertexBuffer = INVALID_BUFFER;
+    BufferHandle m_indexBuffer = INVALID_BUFFER;
+    uint32_t m_vertexHead = 0;  // Vertices used
+    uint32_t m_indexHead = 0;   // Indices used
+
+    std::vector<MeshEntry> m_meshes;
+    std::vector<MeshInfo> m_meshInfos;      // GPU copy source; zeroed until uploaded
+    std::vector<MeshId> m_pendingMeshes;
+
+    std::vector<InstanceData> m_instances;  // Indexed by ObjectId
+    std::vector<CullInfo> m_cullInfos;
+    std::vector<ObjectId> m_freeObjects;
+    uint64_t m_version = 1;
+
+    std::vector<FrameResources> m_frames;
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_GPU_SCENE_H
@@ -0,0 +1,726 @@
+// ============================================================================
+// GPU SKINNING - Animated meshes skinned in a compute pass on top of VulkanCore
+// ============================================================================
+// Moves skinned characters off the CPU vertex-rewrite-and-reupload path:
+//
+//   - createSkinnedMesh() uploads the bind pose and the per-vertex
+//     influences (4 joints + weights, as one uvec4) once, device-local.
+//   - Every instance owns an output vertex buffer in the mesh's format and
+//     a mesh view over it (VulkanCore::createMeshView) - getMesh() is an
+//     ordinary MeshHandle for drawMesh, LightingManager::drawLitMesh or
+//     FacialSystem::drawMesh, sharing the source's indices and LODs.
+//   - update() advances the clips and samples every playing instance's
+//     pose on the job system (skeleton.h, 4 channels / nodes per SIMD op),
+//     overlapping the rest of the frame's CPU work.
+//   - A frame prologue (PROLOGUE_ORDER_SKINNING, before shadow maps) waits
+//     for the sampling, copies the palettes into this frame's slice of a
+//     host-visible buffer and runs shaders/skinning.comp once per instance
+//     whose pose or displacement changed. Idle instances keep last frame's
+//     output and cost nothing.
+//
+// DMap facial displacement composes: setInstanceDisplacement() (what
+// FacialSystem::attachSkinnedMesh() calls) names a bindless texture the
+// shader samples at UV1 and adds in bind space, before skinning - the
+// offsets were authored on the bind pose. Draw such meshes undisplaced
+// (attachSkinnedMesh() takes care of FacialSystem::drawMesh).
+//
+// Needs the bindless heap. Float formats with normals only
+// (POSITION_NORMAL_UV, POSITION_NORMAL_UV0_UV1), up to 4 influences per
+// vertex. Normals take the blended matrix's linear part (no inverse
+// transpose), exact for rotation and uniform scale. Clips index the nodes
+// of the skeleton they were imported with; play them on meshes of that
+// skeleton.
+//
+// Header-only, like gpu_scene.h. Not thread-safe: call everything on the
+// render thread.
+//
+// Usage:
+//   GpuSkinning skinning;
+//   skinning.init(&core);
+//   auto mesh = skinning.createSkinnedMesh(data, weights, model.skeleton, glbMesh.skin);
+//   uint32_t walk = skinning.loadAnimation(model.animations[0]);
+//   SkinInstanceHandle hero = skinning.createInstance(mesh);
+//   skinning.play(hero, walk);
+//   // per frame, before beginFrame():
+//   skinning.update(deltaTime);
+//   lighting.drawLitMesh(skinning.getMesh(hero), transform);
+//   skinning.shutdown();                  // before core.shutdown()
+// ============================================================================
+
+#ifndef VKCORE_GPU_SKINNING_H
+#define VKCORE_GPU_SKINNING_H
+
+#include "vulkan_core.h"
+#include "skeleton.h"
+#include "handle_pool.h"
+#include "../../stdlib/vfs.h"
+#include "../../stdlib/job_system.h"
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <functional>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <iostream>
+
+namespace vkcore {
+
+using SkinInstanceHandle = uint32_t;
+constexpr SkinInstanceHandle INVALID_SKIN_INSTANCE = UINT32_MAX;
+
+struct GpuSkinningConfig {
+    uint32_t maxPaletteJoints = 16384;  // Joints of all instances skinned in one frame
+    std::string shaderPath = "shaders/skinning.comp.spv";
+};
+
+// What the skinning shader adds in bind space before skinning: a bindless
+// texture sampled at UV1 (RGB = offset). version changes whenever its
+// contents do; maxOffset grows the instance's bounds.
+struct SkinDisplacement {
+    uint32_t heapIndex = BindlessHeap::INVALID_INDEX;  // INVALID = none
+    uint64_t version = 0;
+    float maxOffset = 0.0f;
+};
+
+class GpuSkinning {
+public:
+    using MeshId = uint32_t;
+    using ClipId = uint32_t;
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    GpuSkinning() = default;
+    ~GpuSkinning() { shutdown(); }
+
+    GpuSkinning(const GpuSkinning&) = delete;
+    GpuSkinning& operator=(const GpuSkinning&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VulkanCore* core, const GpuSkinningConfig& config = GpuSkinningConfig()) {
+        if (m_core) return true;
+        if (!core || !core->isInitialized() || config.maxPaletteJoints == 0) return false;
+        if (!core->hasBindlessHeap()) {
+            // The shader's displacement fetch declares the heap as set 1
+            std::cerr << "[GpuSkinning] Needs the bindless heap (CoreConfig::bindlessTextures)" << std::endl;
+            return false;
+        }
+
+        m_core = core;
+        m_device = core->getDevice();
+        m_config = config;
+
+        if (!createPaletteBuffer() || !createPipeline()) {
+            shutdown();
+            return false;
+        }
+
+        m_prologueId = core->addFramePrologue([this](VkCommandBuffer cmd) { skin(cmd); }, PROLOGUE_ORDER_SKINNING);
+
+        std::cout << "[GpuSkinning] Ready (" << config.maxPaletteJoints << " joints per frame)" << std::endl;
+        return true;
+    }
+
+    // Before VulkanCore::shutdown()
+    void shutdown() {
+        if (!m_core) return;
+
+        finishSampling();
+        vkDeviceWaitIdle(m_device);
+        if (m_prologueId) m_core->removeFramePrologue(m_prologueId);
+        m_prologueId = 0;
+
+        m_instances.forEach([&](SkinInstanceHandle, Instance& instance) { releaseInstance(instance); });
+        m_instances.clear();
+        for (SkinnedMesh& mesh : m_meshes) {
+            m_core->destroyMesh(mesh.source);
+            m_core->destroyBuffer(mesh.bindPose);
+            m_core->destroyBuffer(mesh.influences);
+        }
+        m_meshes.clear();
+        m_clips.clear();
+
+        if (m_pipeline) vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        if (m_pipelineLayout) vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+        if (m_setLayout) vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+        m_pipeline = VK_NULL_HANDLE;
+        m_pipelineLayout = VK_NULL_HANDLE;
+        m_setLayout = VK_NULL_HANDLE;
+
+        m_core->getAllocator().destroyBuffer(m_palette, m_paletteAlloc);
+        m_palette = VK_NULL_HANDLE;
+        m_core = nullptr;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isInitialized() const { return m_core != nullptr; }
+
+    // ========================================================================
+    // Meshes and clips
+    // ========================================================================
+
+    // `weights` parallel to the vertices, bound to skeleton.skins[skin]. The
+    // skeleton is copied. Meshes live until shutdown().
+    MeshId createSkinnedMesh(const MeshData& data, const std::vector<SkinWeights>& weights,
+                             const Skeleton& skeleton, uint32_t skin) {
+        if (!m_core) return INVALID_ID;
+        if (data.format != VertexFormat::POSITION_NORMAL_UV && data.format != VertexFormat::POSITION_NORMAL_UV0_UV1) {
+            std::cerr << "[GpuSkinning] Skinned meshes need POSITION_NORMAL_UV or POSITION_NORMAL_UV0_UV1 vertices"
+                      << std::endl;
+            return INVALID_ID;
+        }
+        const uint32_t floatsPerVertex = m_core->getVertexStride(data.format) / sizeof(float);
+        const uint32_t vertexCount = static_cast<uint32_t>(data.vertices.size() / floatsPerVertex);
+        if (vertexCount == 0 || weights.size() != vertexCount || skin >= skeleton.skins.size() ||
+            skeleton.skins[skin].joints.empty()) {
+            std::cerr << "[GpuSkinning] Mesh needs one SkinWeights per vertex and a skin with joints" << std::endl;
+            return INVALID_ID;
+        }
+        const uint32_t jointCount = static_cast<uint32_t>(skeleton.skins[skin].joints.size());
+        if (jointCount > m_config.maxPaletteJoints) {
+            std::cerr << "[GpuSkinning] Skin has " << jointCount << " joints, more than maxPaletteJoints" << std::endl;
+            return INVALID_ID;
+        }
+
+        // joints 0|1 and 2|3 as u16 pairs, weights as unorm16 pairs
+        std::vector<uint32_t> influences(size_t(vertexCount) * 4);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            SkinWeights w = weights[v];
+            normalizeSkinWeights(w);
+            uint16_t unorm[MAX_SKIN_INFLUENCES];
+            for (uint32_t k = 0; k < MAX_SKIN_INFLUENCES; k++) {
+                if (w.joints[k] >= jointCount) w.weights[k] = 0.0f;
+                unorm[k] = static_cast<uint16_t>(std::lround(w.weights[k] * 65535.0f));
+            }
+            uint32_t* out = &influences[size_t(v) * 4];
+            out[0] = uint32_t(w.joints[0]) | uint32_t(w.joints[1]) << 16;
+            out[1] = uint32_t(w.joints[2]) | uint32_t(w.joints[3]) << 16;
+            out[2] = uint32_t(unorm[0]) | uint32_t(unorm[1]) << 16;
+            out[3] = uint32_t(unorm[2]) | uint32_t(unorm[3]) << 16;
+        }
+
+        SkinnedMesh mesh;
+        mesh.source = m_core->createMesh(data);
+        mesh.bindPose = m_core->createDeviceLocalBuffer(data.vertices.data(), data.vertices.size() * sizeof(float),
+                                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        mesh.influences = m_core->createDeviceLocalBuffer(influences.data(), influences.size() * sizeof(uint32_t),
+                                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        if (mesh.source == INVALID_MESH || mesh.bindPose == INVALID_BUFFER || mesh.influences == INVALID_BUFFER) {
+            std::cerr << "[GpuSkinning] Failed to create skinned mesh buffers" << std::endl;
+            if (mesh.source != INVALID_MESH) m_core->destroyMesh(mesh.source);
+            if (mesh.bindPose != INVALID_BUFFER) m_core->destroyBuffer(mesh.bindPose);
+            if (mesh.influences != INVALID_BUFFER) m_core->destroyBuffer(mesh.influences);
+            return INVALID_ID;
+        }
+        mesh.format = data.format;
+        mesh.vertexCount = vertexCount;
+        mesh.floatsPerVertex = floatsPerVertex;
+        mesh.bindVertices = data.vertices;
+        mesh.skeleton = skeleton;
+        mesh.skin = skin;
+        mesh.jointBounds = computeJointBounds(data.vertices.data(), floatsPerVertex, vertexCount,
+                                              weights.data(), jointCount);
+        resetPose(mesh.skeleton, mesh.restPose);
+
+        m_meshes.push_back(std::move(mesh));
+        return static_cast<MeshId>(m_meshes.size() - 1);
+    }
+
+    // Copied; the id stays valid until shutdown()
+    ClipId loadAnimation(const AnimationClip& clip) {
+        if (!m_core) return INVALID_ID;
+        finishSampling();
+        m_clips.push_back(clip);
+        return static_cast<ClipId>(m_clips.size() - 1);
+    }
+
+    uint32_t getClipCount() const { return static_cast<uint32_t>(m_clips.size()); }
+    float getClipDuration(ClipId clip) const { return clip < m_clips.size() ? m_clips[clip].duration : 0.0f; }
+
+    // ========================================================================
+    // Instances
+    // ========================================================================
+
+    // In the rest pose until something plays. INVALID once the output
+    // buffer can't be allocated.
+    SkinInstanceHandle createInstance(MeshId mesh) {
+        if (!m_core || mesh >= m_meshes.size()) return INVALID_SKIN_INSTANCE;
+        finishSampling();
+        SkinnedMesh& source = m_meshes[mesh];
+
+        Instance instance;
+        instance.mesh = mesh;
+        instance.output = m_core->createDeviceLocalBuffer(source.bindVertices.data(),
+                                                          source.bindVertices.size() * sizeof(float),
+                                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        if (instance.output != INVALID_BUFFER) instance.view = m_core->createMeshView(source.source, instance.output);
+        if (instance.view != INVALID_MESH) {
+            instance.set = m_core->getDescriptorAllocator().allocate(m_setLayout);
+        }
+        if (instance.set == VK_NULL_HANDLE) {
+            std::cerr << "[GpuSkinning] Failed to create instance output" << std::endl;
+            releaseInstance(instance);
+            return INVALID_SKIN_INSTANCE;
+        }
+        writeDescriptors(source, instance);
+        // Skinned at the skeleton's rest pose, which needn't be the bind pose
+        instance.pose = source.restPose;
+        instance.palette.resize(source.skeleton.skins[source.skin].joints.size() * 3);
+        computeWorldMatrices(source.skeleton, instance.pose);
+        computeSkinMatrices(source.skeleton.skins[source.skin], instance.pose, instance.palette.data());
+        instance.bounds = skinnedBounds(source.jointBounds, instance.palette.data());
+        instance.dirty = true;
+
+        SkinInstanceHandle handle = m_instances.insert(std::move(instance));
+        if (handle == INVALID_SKIN_INSTANCE) releaseInstance(instance);
+        return handle;
+    }
+
+    void destroyInstance(SkinInstanceHandle handle) {
+        finishSampling();
+        Instance instance;
+        if (!m_instances.remove(handle, &instance)) return;
+        releaseInstance(instance);
+    }
+
+    // Draw this (valid until destroyInstance())
+    MeshHandle getMesh(SkinInstanceHandle handle) const {
+        const Instance* instance = m_instances.get(handle);
+        return instance ? instance->view : INVALID_MESH;
+    }
+
+    // Crossfades from whatever plays over `fadeSeconds` (0 = cut). Non-looping
+    // clips hold their last frame.
+    void play(SkinInstanceHandle handle, ClipId clip, bool loop = true, float fadeSeconds = 0.2f) {
+        finishSampling();
+        Instance* instance = m_instances.get(handle);
+        if (!instance || clip >= m_clips.size()) return;
+        if (instance->current.clip != INVALID_ID && fadeSeconds > 0.0f) {
+            instance->previous = instance->current;
+            instance->fade = 0.0f;
+            instance->fadeRate = 1.0f / fadeSeconds;
+        } else {
+            instance->previous = Layer{};
+            instance->fade = 1.0f;
+        }
+        instance->current = Layer{};
+        instance->current.clip = clip;
+        instance->current.loop = loop;
+        instance->playing = true;
+    }
+
+    // Holds the current pose (setTime() still moves it)
+    void stop(SkinInstanceHandle handle) {
+        finishSampling();
+        if (Instance* instance = m_instances.get(handle)) instance->playing = false;
+    }
+
+    // Back to the rest pose
+    void reset(SkinInstanceHandle handle) {
+        finishSampling();
+        if (Instance* instance = m_instances.get(handle)) {
+            instance->current = Layer{};
+            instance->previous = Layer{};
+            instance->playing = false;
+            instance->resample = true;
+        }
+    }
+
+    void setSpeed(SkinInstanceHandle handle, float speed) {
+        finishSampling();
+        if (Instance* instance = m_instances.get(handle)) instance->speed = speed;
+    }
+
+    void setTime(SkinInstanceHandle handle, float seconds) {
+        finishSampling();
+        if (Instance* instance = m_instances.get(handle)) {
+            instance->current.time = seconds;
+            instance->resample = true;
+        }
+    }
+
+    float getTime(SkinInstanceHandle handle) const {
+        const Instance* instance = m_instances.get(handle);
+        return instance ? instance->current.time : 0.0f;
+    }
+
+    bool isPlaying(SkinInstanceHandle handle) const {
+        const Instance* instance = m_instances.get(handle);
+        return instance && instance->playing;
+    }
+
+    // Called every frame (render thread, before the dispatch); null = none
+    void setInstanceDisplacement(SkinInstanceHandle handle, std::function<SkinDisplacement()> source) {
+        finishSampling();
+        if (Instance* instance = m_instances.get(handle)) {
+            instance->displacement = std::move(source);
+            instance->applied = SkinDisplacement{};
+            instance->dirty = true;
+        }
+    }
+
+    uint32_t getInstanceCount() const { return m_instances.size(); }
+    uint32_t getSkinnedLastFrame() const { return m_skinnedLastFrame; }  // Dispatches in the last prologue
+
+    // ========================================================================
+    // Per frame
+    // ========================================================================
+
+    // Advances every playing instance by dt seconds and starts sampling
+    // their poses on the job system. Call early in the frame, before
+    // VulkanCore::beginFrame(); the prologue waits for it.
+    void update(float dt) {
+        if (!m_core) return;
+        finishSampling();
+
+        m_sampleList.clear();
+        m_instances.forEach([&](SkinInstanceHandle, Instance& instance) {
+            if (instance.playing) advance(instance, dt);
+            else if (!instance.resample) return;
+            instance.resample = false;
+            m_sampleList.push_back(&instance);
+        });
+        if (m_sampleList.empty()) return;
+
+        // One instance per range: each samples a whole skeleton
+        m_sampling = std::make_unique<TaskGroup>();
+        m_sampling->run([this]() {
+            parallel_for(m_sampleList.size(), [this](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) samplePose(*m_sampleList[i]);
+            }, 1);
+        });
+    }
+
+private:
+    // Must match skinning.comp
+    struct SkinParams {
+        uint32_t vertexCount;
+        uint32_t floatsPerVertex;
+        uint32_t paletteOffset;      // vec4s into the palette buffer
+        uint32_t jointCount;
+        uint32_t displacementIndex;  // Bindless slot, UINT32_MAX = none
+    };
+
+    struct SkinnedMesh {
+        MeshHandle source = INVALID_MESH;  // Index buffer, LODs, bind-pose bounds
+        BufferHandle bindPose = INVALID_BUFFER;
+        BufferHandle influences = INVALID_BUFFER;
+        VertexFormat format = VertexFormat::POSITION_NORMAL_UV;
+        uint32_t vertexCount = 0;
+        uint32_t floatsPerVertex = 0;
+        std::vector<float> bindVertices;  // Initial contents of instance outputs
+        Skeleton skeleton;
+        uint32_t skin = 0;
+        std::vector<glm::vec4> jointBounds;
+        Pose restPose;
+    };
+
+    struct Layer {
+        ClipId clip = INVALID_ID;
+        float time = 0.0f;
+        bool loop = true;
+        ClipCursor cursor;
+    };
+
+    struct Instance {
+        MeshId mesh = 0;
+        BufferHandle output = INVALID_BUFFER;
+        MeshHandle view = INVALID_MESH;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+
+        Layer current;
+        Layer previous;            // Fading out while fade < 1
+        float fade = 1.0f;
+        float fadeRate = 0.0f;
+        float speed = 1.0f;
+        bool playing = false;
+        bool resample = false;     // Sample once although not playing
+
+        Pose pose;
+        std::vector<glm::vec4> palette;  // 3 rows per joint, from the last sample
+        LodBounds bounds;
+        bool dirty = false;        // Palette not yet skinned with
+
+        std::function<SkinDisplacement()> displacement;
+        SkinDisplacement applied;  // What the output was last skinned with
+    };
+
+    void finishSampling() {
+        if (!m_sampling) return;
+        m_sampling->wait();
+        m_sampling.reset();
+    }
+
+    void releaseInstance(Instance& instance) {
+        if (instance.view != INVALID_MESH) m_core->destroyMesh(instance.view);
+        if (instance.output != INVALID_BUFFER) m_core->destroyBuffer(instance.output);  // Deferred
+        if (instance.set != VK_NULL_HANDLE) m_core->getDescriptorAllocator().free(instance.set);
+        instance.view = INVALID_MESH;
+        instance.output = INVALID_BUFFER;
+        instance.set = VK_NULL_HANDLE;
+    }
+
+    void advance(Instance& instance, float dt) {
+        float step = dt * instance.speed;
+        auto move = [&](Layer& layer) {
+            if (layer.clip == INVALID_ID) return;
+            float duration = m_clips[layer.clip].duration;
+            layer.time += step;
+            if (duration <= 0.0f) {
+                layer.time = 0.0f;
+            } else if (layer.loop) {
+                layer.time = std::fmod(layer.time, duration);
+                if (layer.time < 0.0f) layer.time += duration;
+            } else {
+                layer.time = std::min(std::max(layer.time, 0.0f), duration);
+            }
+        };
+        move(instance.current);
+        if (instance.fade < 1.0f) {
+            move(instance.previous);
+            instance.fade = std::min(1.0f, instance.fade + dt * instance.fadeRate);
+            if (instance.fade >= 1.0f) instance.previous = Layer{};
+        }
+        // A finished one-shot is sampled once more at its end, then holds
+        const Layer& layer = instance.current;
+        if (!layer.loop && layer.clip != INVALID_ID && instance.fade >= 1.0f &&
+            (step >= 0.0f ? layer.time >= m_clips[layer.clip].duration : layer.time <= 0.0f)) {
+            instance.playing = false;
+        }
+    }
+
+    // Job thread: touches only this instance and read-only mesh / clip data
+    void samplePose(Instance& instance) {
+        const SkinnedMesh& mesh = m_meshes[instance.mesh];
+        std::memcpy(instance.pose.trs.data(), mesh.restPose.trs.data(), mesh.restPose.trs.size() * sizeof(float));
+        if (instance.previous.clip != INVALID_ID && instance.fade < 1.0f) {
+            sampleClip(m_clips[instance.previous.clip], instance.previous.time, instance.previous.cursor, instance.pose);
+        }
+        if (instance.current.clip != INVALID_ID) {
+            sampleClip(m_clips[instance.current.clip], instance.current.time, instance.current.cursor, instance.pose,
+                       instance.previous.clip != INVALID_ID ? instance.fade : 1.0f);
+        }
+        computeWorldMatrices(mesh.skeleton, instance.pose);
+        computeSkinMatrices(mesh.skeleton.skins[mesh.skin], instance.pose, instance.palette.data());
+        instance.bounds = skinnedBounds(mesh.jointBounds, instance.palette.data());
+        instance.dirty = true;
+    }
+
+    // ========================================================================
+    // Setup
+    // ========================================================================
+
+    // One slice of maxPaletteJoints per frame in flight
+    bool createPaletteBuffer() {
+        m_sliceRows = m_config.maxPaletteJoints * 3;
+        VkDeviceSize bytes = VkDeviceSize(m_sliceRows) * m_core->getFramesInFlight() * sizeof(glm::vec4);
+        const VkMemoryPropertyFlags host = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        if (!m_core->getAllocator().createBuffer(bytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, host,
+                                                 m_palette, m_paletteAlloc)) {
+            std::cerr << "[GpuSkinning] Failed to allocate the palette buffer" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool createPipeline() {
+        VfsInputStream file(m_config.shaderPath, std::ios::ate | std::ios::binary);
+        if (!file) {
+            std::cerr << "[GpuSkinning] Skinning shader not found: " << m_config.shaderPath
+                      << " (glslc vulkan/core/shaders/skinning.comp -o skinning.comp.spv)" << std::endl;
+            return false;
+        }
+        std::vector<char> code(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(code.data(), static_cast<std::streamsize>(code.size()));
+
+        // bind pose, influences, palette, output
+        std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+        for (uint32_t i = 0; i < bindings.size(); i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+        if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) return false;
+
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushRange.size = sizeof(SkinParams);
+
+        // Set 1 = the bindless heap, for displacement textures
+        VkDescriptorSetLayout setLayouts[2] = {m_setLayout, m_core->getBindlessSetLayout()};
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 2;
+        pipelineLayoutInfo.pSetLayouts = setLayouts;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+        if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) return false;
+
+        VkShaderModuleCreateInfo moduleInfo{};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = code.size();
+        moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+        VkShaderModule module;
+        if (vkCreateShaderModule(m_device, &moduleInfo, nullptr, &module) != VK_SUCCESS) return false;
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = module;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = m_pipelineLayout;
+
+        VkResult result = vkCreateComputePipelines(m_device, m_core->getPipelineCache(), 1, &pipelineInfo,
+                                                   nullptr, &m_pipeline);
+        vkDestroyShaderModule(m_device, module, nullptr);
+        if (result != VK_SUCCESS) {
+            std::cerr << "[GpuSkinning] Failed to create skinning pipeline" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void writeDescriptors(const SkinnedMesh& mesh, const Instance& instance) {
+        VkDescriptorBufferInfo infos[4] = {
+            {m_core->getBuffer(mesh.bindPose), 0, VK_WHOLE_SIZE},
+            {m_core->getBuffer(mesh.influences), 0, VK_WHOLE_SIZE},
+            {m_palette, 0, VK_WHOLE_SIZE},
+            {m_core->getBuffer(instance.output), 0, VK_WHOLE_SIZE},
+        };
+        std::array<VkWriteDescriptorSet, 4> writes{};
+        for (uint32_t i = 0; i < writes.size(); i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = instance.set;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &infos[i];
+        }
+        vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    // ========================================================================
+    // Skinning (frame prologue, outside the render pass)
+    // ========================================================================
+
+    void skin(VkCommandBuffer cmd) {
+        m_skinnedLastFrame = 0;
+        finishSampling();
+        if (m_instances.size() == 0) return;
+
+        // This frame's slice is idle (its fence was waited on)
+        const uint32_t sliceBase = m_core->getCurrentFrame() * m_sliceRows;
+        glm::vec4* rows = static_cast<glm::vec4*>(m_paletteAlloc.mapped) + sliceBase;
+        uint32_t used = 0;
+        bool began = false;
+        bool full = false;
+
+        m_instances.forEach([&](SkinInstanceHandle, Instance& instance) {
+            SkinDisplacement displacement;
+            if (instance.displacement) displacement = instance.displacement();
+            bool displaced = displacement.heapIndex != instance.applied.heapIndex ||
+                             displacement.version != instance.applied.version;
+            if (!instance.dirty && !displaced) return;
+
+            const SkinnedMesh& mesh = m_meshes[instance.mesh];
+            if (!m_core->isBufferReady(mesh.bindPose) || !m_core->isBufferReady(mesh.influences) ||
+                !m_core->isBufferReady(instance.output)) {
+                return;  // Retried next frame
+            }
+            const uint32_t paletteRows = static_cast<uint32_t>(instance.palette.size());
+            if (used + paletteRows > m_sliceRows) {
+                full = true;
+                return;
+            }
+            std::memcpy(rows + used, instance.palette.data(), paletteRows * sizeof(glm::vec4));
+
+            if (!began) {
+                // Earlier frames' vertex fetches of the outputs come first
+                VkMemoryBarrier before{};
+                before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                before.srcAccessMask = 0;
+                before.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+                vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     0, 1, &before, 0, nullptr, 0, nullptr);
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+                m_core->getBindlessHeap().bind(cmd, m_pipelineLayout, BINDLESS_SET, VK_PIPELINE_BIND_POINT_COMPUTE);
+                began = true;
+            }
+
+            SkinParams params;
+            params.vertexCount = mesh.vertexCount;
+            params.floatsPerVertex = mesh.floatsPerVertex;
+            params.paletteOffset = sliceBase + used;
+            params.jointCount = paletteRows / 3;
+            params.displacementIndex = mesh.format == VertexFormat::POSITION_NORMAL_UV0_UV1
+                                           ? displacement.heapIndex : BindlessHeap::INVALID_INDEX;
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                                    &instance.set, 0, nullptr);
+            vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+            vkCmdDispatch(cmd, (mesh.vertexCount + 63) / 64, 1, 1);
+            used += paletteRows;
+            m_skinnedLastFrame++;
+
+            // Culling and LOD selection see the posed mesh
+            if (instance.bounds.radius > 0.0f) {
+                m_core->setMeshBounds(instance.view, instance.bounds.center,
+                                      instance.bounds.radius + displacement.maxOffset);
+            }
+            instance.dirty = false;
+            instance.applied = displacement;
+        });
+
+        if (full && !m_warnedFull) {
+            std::cerr << "[GpuSkinning] maxPaletteJoints (" << m_config.maxPaletteJoints
+                      << ") reached - remaining instances skinned next frame" << std::endl;
+            m_warnedFull = true;
+        }
+        if (!began) return;
+
+        VkMemoryBarrier written{};
+        written.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        written.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        written.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                             0, 1, &written, 0, nullptr, 0, nullptr);
+    }
+
+    VulkanCore* m_core = nullptr;
+    VkDevice m_device = VK_NULL_HANDLE;
+    GpuSkinningConfig m_config;
+    uint32_t m_prologueId = 0;
+    uint32_t m_skinnedLastFrame = 0;
+    bool m_warnedFull = false;
+
+    std::vector<SkinnedMesh> m_meshes;
+    std::vector<AnimationClip> m_clips;
+    HandlePool<Instance> m_instances;
+
+    std::unique_ptr<TaskGroup> m_sampling;  // Fresh per update(): its task list only grows
+    std::vector<Instance*> m_sampleList;
+
+    VkBuffer m_palette = VK_NULL_HANDLE;    // Host-visible, framesInFlight slices
+    GpuAllocation m_paletteAlloc;
+    uint32_t m_sliceRows = 0;
+
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_GPU_SKINNING_H
@@ -0,0 +1,198 @@
+// ============================================================================
+// HANDLE POOL - Generational handles with slot reuse
+// ============================================================================
+// Backing store for VulkanCore's pipelines, buffers, meshes and textures:
+//
+//   - A handle is (generation << INDEX_BITS) | slot index. remove() bumps the
+//     slot's generation and puts it on a free list, so the next insert()
+//     reuses it and every handle to the old resource stops resolving.
+//   - The slot index sits in the low bits, so a fresh pool hands out 0, 1,
+//     2, ... exactly like the old vector indices, and RenderQueue's sort key
+//     (which keeps the low bits) still groups by resource.
+//   - UINT32_MAX (the INVALID_* constants) is never issued. Pools whose
+//     handles cross into signed code can take fewer GENERATION_BITS: with
+//     11, every handle stays below 2^31.
+//
+// DeletionQueue defers the Vulkan destruction of a removed resource until
+// every frame that could still reference it has retired, so destroy*() calls
+// need no vkDeviceWaitIdle.
+//
+// Header-only, like gpu_allocator.h.
+//
+// Usage:
+//   HandlePool<MeshResource> meshes;
+//   uint32_t handle = meshes.insert(mesh);
+//   if (MeshResource* m = meshes.get(handle)) { ... }     // nullptr once stale
+//   meshes[handle].indexCount;                            // after contains(handle)
+//   MeshResource old;
+//   meshes.remove(handle, &old);
+//   deletions.push(frameNumber, [=] { destroy(old); });
+//   deletions.flush(completedFrameNumber);                // after the fence wait
+// ============================================================================
+
+#ifndef VKCORE_HANDLE_POOL_H
+#define VKCORE_HANDLE_POOL_H
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdint>
+
+namespace vkcore {
+
+template <typename T, uint32_t GENERATION_BITS = 12>
+class HandlePool {
+public:
+    static constexpr uint32_t INDEX_BITS = 20;
+    static_assert(GENERATION_BITS >= 1 && GENERATION_BITS <= 32 - INDEX_BITS, "generation bits must fit beside the index");
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+    static constexpr uint32_t MAX_SLOTS = INDEX_MASK;  // Slot INDEX_MASK unused so UINT32_MAX stays invalid
+    static constexpr uint32_t INVALID_HANDLE = UINT32_MAX;
+
+    static uint32_t indexOf(uint32_t handle) { return handle & INDEX_MASK; }
+    static uint32_t generationOf(uint32_t handle) { return handle >> INDEX_BITS; }
+
+    // INVALID_HANDLE once MAX_SLOTS resources are alive
+    uint32_t insert(T value) {
+        uint32_t index;
+        if (!m_freeList.empty()) {
+            index = m_freeList.back();
+            m_freeList.pop_back();
+        } else {
+            if (m_slots.size() >= MAX_SLOTS) return INVALID_HANDLE;
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+        Slot& slot = m_slots[index];
+        slot.value = std::move(value);
+        slot.live = true;
+        m_liveCount++;
+        return makeHandle(index, slot.generation);
+    }
+
+    T* get(uint32_t handle) {
+        Slot* slot = resolve(handle);
+        return slot ? &slot->value : nullptr;
+    }
+
+    const T* get(uint32_t handle) const {
+        const Slot* slot = const_cast<HandlePool*>(this)->resolve(handle);
+        return slot ? &slot->value : nullptr;
+    }
+
+    bool contains(uint32_t handle) const { return get(handle) != nullptr; }
+
+    // Unchecked - only for handles already validated with contains()/get()
+    T& operator[](uint32_t handle) { return m_slots[indexOf(handle)].value; }
+    const T& operator[](uint32_t handle) const { return m_slots[indexOf(handle)].value; }
+
+    // Moves the resource out to *removed (if given); false for a stale handle
+    bool remove(uint32_t handle, T* removed = nullptr) {
+        Slot* slot = resolve(handle);
+        if (!slot) return false;
+        if (removed) *removed = std::move(slot->value);
+        slot->value = T{};
+        slot->live = false;
+        slot->generation = (slot->generation + 1) & GENERATION_MASK;
+        m_freeList.push_back(indexOf(handle));
+        m_liveCount--;
+        return true;
+    }
+
+    // fn(handle, T&) for every live resource
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (uint32_t i = 0; i < m_slots.size(); i++) {
+            if (m_slots[i].live) fn(makeHandle(i, m_slots[i].generation), m_slots[i].value);
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (uint32_t i = 0; i < m_slots.size(); i++) {
+            if (m_slots[i].live) fn(makeHandle(i, m_slots[i].generation), m_slots[i].value);
+        }
+    }
+
+    // Removes everything but keeps the slots, so handles from before stay
+    // stale instead of aliasing what is inserted next
+    void removeAll() {
+        for (uint32_t i = 0; i < m_slots.size(); i++) {
+            if (m_slots[i].live) remove(makeHandle(i, m_slots[i].generation));
+        }
+    }
+
+    void clear() {
+        m_slots.clear();
+        m_freeList.clear();
+        m_liveCount = 0;
+    }
+
+    uint32_t size() const { return m_liveCount; }
+    uint32_t capacity() const { return static_cast<uint32_t>(m_slots.size()); }
+
+private:
+    struct Slot {
+        T value{};
+        uint32_t generation = 0;
+        bool live = false;
+    };
+
+    static uint32_t makeHandle(uint32_t index, uint32_t generation) {
+        return (generation << INDEX_BITS) | index;
+    }
+
+    Slot* resolve(uint32_t handle) {
+        if (handle == INVALID_HANDLE) return nullptr;
+        uint32_t index = indexOf(handle);
+        if (index >= m_slots.size()) return nullptr;
+        Slot& slot = m_slots[index];
+        if (!slot.live || slot.generation != generationOf(handle)) return nullptr;
+        return &slot;
+    }
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeList;
+    uint32_t m_liveCount = 0;
+};
+
+// Destruction callbacks tagged with the last frame that may use the resource
+class DeletionQueue {
+public:
+    void push(uint64_t frame, std::function<void()> destroy) {
+        m_entries.push_back({frame, std::move(destroy)});
+    }
+
+    // Runs everything tagged with a frame <= completedFrame, in push order
+    void flush(uint64_t completedFrame) {
+        size_t kept = 0;
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            if (m_entries[i].frame <= completedFrame) {
+                m_entries[i].destroy();
+            } else {
+                m_entries[kept++] = std::move(m_entries[i]);
+            }
+        }
+        m_entries.resize(kept);
+    }
+
+    // Device must be idle
+    void flushAll() {
+        for (auto& entry : m_entries) entry.destroy();
+        m_entries.clear();
+    }
+
+    size_t pending() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t frame;
+        std::function<void()> destroy;
+    };
+    std::vector<Entry> m_entries;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_HANDLE_POOL_H
@@ -0,0 +1,174 @@
+// ============================================================================
+// MEMORY BUDGET - How much device memory we may use, and how much we do
+// ============================================================================
+// Vulkan never says "you are about to run out": allocations past what the
+// OS will keep resident either fail or silently page to system memory and
+// crater the frame rate. MemoryBudget answers the question once per frame:
+//
+//   - With VK_EXT_memory_budget, update() reads the driver's per-heap budget
+//     (what this process may use right now, given everyone else on the GPU)
+//     and usage (what it does use, swapchain and driver internals included).
+//   - Without it, the budget is FALLBACK_BUDGET_FRACTION of each heap and
+//     usage is what GpuAllocator holds in it - blind to other processes,
+//     but enough to keep one big session from filling the card.
+//
+// Only DEVICE_LOCAL heaps count towards getDeviceBudget()/getDeviceUsage();
+// those are the ones eviction can relieve.
+//
+// Header-only, like gpu_allocator.h. VulkanCore owns one and evicts idle
+// textures and meshes when usage crosses CoreConfig::memoryBudgetFraction.
+//
+// Usage:
+//   bool enabled = MemoryBudget::addDeviceExtensions(physicalDevice, deviceExtensions);
+//   ... vkCreateDevice ...
+//   MemoryBudget budget;
+//   budget.init(instance, physicalDevice, enabled);
+//   budget.update(allocator);                          // once per frame
+//   if (budget.getDeviceUsage() > budget.getDeviceBudget()) { ... }
+// ============================================================================
+
+#ifndef VKCORE_MEMORY_BUDGET_H
+#define VKCORE_MEMORY_BUDGET_H
+
+#include "gpu_allocator.h"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+struct HeapBudget {
+    VkDeviceSize size = 0;      // Heap size
+    VkDeviceSize budget = 0;    // What this process may use before paging starts
+    VkDeviceSize usage = 0;     // What this process uses now
+    bool deviceLocal = false;
+};
+
+class MemoryBudget {
+public:
+    static constexpr float FALLBACK_BUDGET_FRACTION = 0.8f;
+
+    // Appends VK_EXT_memory_budget when the device has it; pass the result
+    // to init(). The instance needs VK_KHR_get_physical_device_properties2
+    // (BindlessHeap::addInstanceExtensions enables it).
+    static bool addDeviceExtensions(VkPhysicalDevice physicalDevice, std::vector<const char*>& deviceExtensions) {
+        uint32_t extCount = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extCount);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extCount, extensions.data());
+        for (const auto& ext : extensions) {
+            if (strcmp(ext.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+                deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    void init(VkInstance instance, VkPhysicalDevice physicalDevice, bool extensionEnabled) {
+        m_physicalDevice = physicalDevice;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memProps);
+        if (extensionEnabled) {
+            m_getMemoryProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(
+                vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+        }
+
+        m_heaps.assign(m_memProps.memoryHeapCount, HeapBudget());
+        for (uint32_t i = 0; i < m_memProps.memoryHeapCount; i++) {
+            m_heaps[i].size = m_memProps.memoryHeaps[i].size;
+            m_heaps[i].budget = static_cast<VkDeviceSize>(m_heaps[i].size * FALLBACK_BUDGET_FRACTION);
+            m_heaps[i].deviceLocal = (m_memProps.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+
+        std::cout << "[MemoryBudget] " << (getDeviceBudget() / (1024 * 1024)) << " MB device-local "
+                  << (hasExtension() ? "(VK_EXT_memory_budget)" : "(estimated: no VK_EXT_memory_budget)") << std::endl;
+    }
+
+    // Refreshes every heap's budget and usage. `allocator` supplies usage
+    // when the extension is missing.
+    void update(const GpuAllocator& allocator) {
+        if (m_physicalDevice == VK_NULL_HANDLE) return;
+
+        if (m_getMemoryProperties2) {
+            VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+            budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+            VkPhysicalDeviceMemoryProperties2KHR props{};
+            props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR;
+            props.pNext = &budget;
+            m_getMemoryProperties2(m_physicalDevice, &props);
+
+            for (uint32_t i = 0; i < m_heaps.size(); i++) {
+                // Some drivers report 0 for heaps they don't track
+                m_heaps[i].budget = budget.heapBudget[i] > 0 ? budget.heapBudget[i] : m_heaps[i].budget;
+                m_heaps[i].usage = budget.heapUsage[i];
+            }
+            return;
+        }
+
+        for (auto& heap : m_heaps) heap.usage = 0;
+        for (const auto& type : allocator.getStats().heaps) {
+            m_heaps[m_memProps.memoryTypes[type.memoryType].heapIndex].usage += type.bytesReserved;
+        }
+    }
+
+    bool hasExtension() const { return m_getMemoryProperties2 != nullptr; }
+    const std::vector<HeapBudget>& getHeaps() const { return m_heaps; }
+
+    // Sums over the DEVICE_LOCAL heaps
+    VkDeviceSize getDeviceBudget() const {
+        VkDeviceSize total = 0;
+        for (const auto& heap : m_heaps) {
+            if (heap.deviceLocal) total += heap.budget;
+        }
+        return total;
+    }
+
+    VkDeviceSize getDeviceUsage() const {
+        VkDeviceSize total = 0;
+        for (const auto& heap : m_heaps) {
+            if (heap.deviceLocal) total += heap.usage;
+        }
+        return total;
+    }
+
+private:
+    VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties m_memProps{};
+    PFN_vkGetPhysicalDeviceMemoryProperties2KHR m_getMemoryProperties2 = nullptr;
+    std::vector<HeapBudget> m_heaps;
+};
+
+// ============================================================================
+// Use Stamp
+// ============================================================================
+
+// Frame a resource was last used in, for least-recently-used eviction.
+// Touched from recordParallel tasks, so it is atomic; copies (HandlePool
+// moves values around) carry the current value.
+struct UseStamp {
+    UseStamp() = default;
+    UseStamp(const UseStamp& other) : m_frame(other.get()) {}
+    UseStamp& operator=(const UseStamp& other) {
+        m_frame.store(other.get(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void touch(uint64_t frame) const { m_frame.store(frame, std::memory_order_relaxed); }
+    uint64_t get() const { return m_frame.load(std::memory_order_relaxed); }
+
+private:
+    mutable std::atomic<uint64_t> m_frame{0};
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_MEMORY_BUDGET_H
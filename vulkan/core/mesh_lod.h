@@ -0,0 +1,361 @@
+// ============================================================================
+// MESH LOD - Quadric simplification and screen-space LOD selection
+// ============================================================================
+// Import-time LOD chains for MeshData, the GLB loader and the stdlib OBJ
+// MeshResource:
+//
+//   - simplifyIndices() collapses edges by quadric error (Garland-Heckbert),
+//     always onto an existing vertex, so LODs share the original vertex
+//     buffer and only add index ranges. Open edges (mesh borders and UV /
+//     DMap seams, where vertices are split) get constraint planes so
+//     they survive.
+//   - buildLodChain() halves the triangle count per level until a level
+//     stops shrinking, recording each level's error in model units.
+//   - selectLod() projects each level's error to pixels and takes the
+//     coarsest level under the budget, with a hysteresis band around the
+//     current level so objects near a threshold don't flicker.
+//
+// Header-only, like gpu_allocator.h.
+//
+// Usage:
+//   std::vector<MeshLod> lods;
+//   std::vector<uint32_t> indices = buildLodChain(positions, strideFloats, vertexCount,
+//                                                 lod0Indices, lods);  // LOD 0 first
+//   LodBounds bounds = computeLodBounds(positions, strideFloats, vertexCount);
+//   uint32_t lod = selectLod(lods.data(), lodCount, bounds, model, view,
+//                            lodProjectionScale(proj, viewportHeight), 1.0f, 0.2f, lastLod);
+//   vkCmdDrawIndexed(cmd, lods[lod].indexCount, 1, lods[lod].firstIndex, 0, 0);
+// ============================================================================
+
+#ifndef VKCORE_MESH_LOD_H
+#define VKCORE_MESH_LOD_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace vkcore {
+
+constexpr uint32_t MAX_MESH_LODS = 8;
+constexpr uint32_t DEFAULT_MESH_LODS = 4;  // LOD 0 + 3 simplified levels
+
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;  // Max geometric deviation from LOD 0, model units
+};
+
+struct LodBounds {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
+// ----------------------------------------------------------------------------
+// Simplification
+// ----------------------------------------------------------------------------
+
+namespace lod_detail {
+
+// Symmetric 4x4 plane quadric, area weighted; w is the total weight
+struct Quadric {
+    double a2 = 0, b2 = 0, c2 = 0, ab = 0, ac = 0, bc = 0, ad = 0, bd = 0, cd = 0, d2 = 0, w = 0;
+
+    void addPlane(double a, double b, double c, double d, double weight) {
+        a2 += weight * a * a; b2 += weight * b * b; c2 += weight * c * c;
+        ab += weight * a * b; ac += weight * a * c; bc += weight * b * c;
+        ad += weight * a * d; bd += weight * b * d; cd += weight * c * d;
+        d2 += weight * d * d; w += weight;
+    }
+
+    void add(const Quadric& q) {
+        a2 += q.a2; b2 += q.b2; c2 += q.c2; ab += q.ab; ac += q.ac; bc += q.bc;
+        ad += q.ad; bd += q.bd; cd += q.cd; d2 += q.d2; w += q.w;
+    }
+
+    // Weighted mean squared distance of p to the planes
+    double error(const float* p) const {
+        double x = p[0], y = p[1], z = p[2];
+        double e = a2 * x * x + b2 * y * y + c2 * z * z +
+                   2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z) + d2;
+        return w > 0.0 ? std::max(e, 0.0) / w : 0.0;
+    }
+};
+
+inline void sub3(const float* a, const float* b, float* out) {
+    out[0] = a[0] - b[0]; out[1] = a[1] - b[1]; out[2] = a[2] - b[2];
+}
+
+inline void cross3(const float* a, const float* b, float* out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+inline float dot3(const float* a, const float* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+inline void triangleNormal(const float* p0, const float* p1, const float* p2, float* n) {
+    float e1[3], e2[3];
+    sub3(p1, p0, e1);
+    sub3(p2, p0, e2);
+    cross3(e1, e2, n);
+}
+
+inline uint64_t edgeKey(uint32_t a, uint32_t b) {
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+constexpr double BOUNDARY_WEIGHT = 10.0;  // Open edges resist collapsing away from the border
+
+} // namespace lod_detail
+
+// Returns a reduced index list (same vertices) aiming for targetIndexCount;
+// collapses stop early once a collapse would exceed maxError (model units).
+// *outError receives the largest error actually introduced.
+inline std::vector<uint32_t> simplifyIndices(const float* positions, uint32_t strideFloats, uint32_t vertexCount,
+                                             const std::vector<uint32_t>& indices, uint32_t targetIndexCount,
+                                             float maxError, float* outError = nullptr) {
+    using namespace lod_detail;
+    auto pos = [&](uint32_t v) { return positions + size_t(v) * strideFloats; };
+
+    std::vector<uint32_t> result = indices;
+    float achieved = 0.0f;
+    if (result.size() <= targetIndexCount || vertexCount == 0) {
+        if (outError) *outError = 0.0f;
+        return result;
+    }
+
+    // Face and border quadrics per vertex
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<uint64_t> edges;
+    edges.reserve(result.size());
+    for (size_t t = 0; t + 2 < result.size(); t += 3) {
+        for (int e = 0; e < 3; e++) edges.push_back(edgeKey(result[t + e], result[t + (e + 1) % 3]));
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t t = 0; t + 2 < result.size(); t += 3) {
+        const uint32_t tri[3] = {result[t], result[t + 1], result[t + 2]};
+        float n[3];
+        triangleNormal(pos(tri[0]), pos(tri[1]), pos(tri[2]), n);
+        float len = std::sqrt(dot3(n, n));
+        if (len <= 0.0f) continue;
+        double area = 0.5 * len;
+        for (int c = 0; c < 3; c++) n[c] /= len;
+        double d = -dot3(n, pos(tri[0]));
+        for (int c = 0; c < 3; c++) quadrics[tri[c]].addPlane(n[0], n[1], n[2], d, area);
+
+        for (int e = 0; e < 3; e++) {
+            uint32_t a = tri[e], b = tri[(e + 1) % 3];
+            uint64_t key = edgeKey(a, b);
+            auto range = std::equal_range(edges.begin(), edges.end(), key);
+            if (range.second - range.first != 1) continue;  // Shared edge
+
+            // Plane through the edge, perpendicular to the face
+            float edge[3], bn[3];
+            sub3(pos(b), pos(a), edge);
+            cross3(edge, n, bn);
+            float blen = std::sqrt(dot3(bn, bn));
+            if (blen <= 0.0f) continue;
+            for (int c = 0; c < 3; c++) bn[c] /= blen;
+            double bd = -dot3(bn, pos(a));
+            double weight = BOUNDARY_WEIGHT * dot3(edge, edge);
+            quadrics[a].addPlane(bn[0], bn[1], bn[2], bd, weight);
+            quadrics[b].addPlane(bn[0], bn[1], bn[2], bd, weight);
+        }
+    }
+
+    const double maxErrorSq = double(maxError) * maxError;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint8_t> locked(vertexCount);
+    std::vector<uint32_t> adjacencyStart(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+
+    struct Collapse {
+        uint32_t from, to;
+        double cost;
+    };
+    std::vector<Collapse> collapses;
+
+    // Passes of independent collapses until the target is met or nothing moves
+    while (result.size() > targetIndexCount) {
+        // Vertex -> triangle adjacency for flip checks
+        std::fill(adjacencyStart.begin(), adjacencyStart.end(), 0);
+        for (uint32_t v : result) adjacencyStart[v + 1]++;
+        for (uint32_t v = 0; v < vertexCount; v++) adjacencyStart[v + 1] += adjacencyStart[v];
+        adjacency.resize(result.size());
+        std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (size_t i = 0; i < result.size(); i++) adjacency[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+
+        // Cheapest direction per unique edge
+        edges.clear();
+        for (size_t t = 0; t + 2 < result.size(); t += 3) {
+            for (int e = 0; e < 3; e++) edges.push_back(edgeKey(result[t + e], result[t + (e + 1) % 3]));
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        collapses.clear();
+        for (uint64_t key : edges) {
+            uint32_t a = uint32_t(key >> 32), b = uint32_t(key & 0xFFFFFFFFu);
+            Quadric q = quadrics[a];
+            q.add(quadrics[b]);
+            double toB = q.error(pos(b)), toA = q.error(pos(a));
+            collapses.push_back(toB <= toA ? Collapse{a, b, toB} : Collapse{b, a, toA});
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        for (uint32_t v = 0; v < vertexCount; v++) remap[v] = v;
+        std::fill(locked.begin(), locked.end(), 0);
+
+        // Each collapse removes about two triangles
+        size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+        size_t budget = std::max<size_t>(trianglesToRemove / 2, 1);
+        size_t applied = 0;
+
+        for (const Collapse& c : collapses) {
+            if (applied >= budget || c.cost > maxErrorSq) break;
+            if (locked[c.from] || locked[c.to]) continue;
+
+            // Reject collapses that flip a surviving triangle around `from`
+            bool flips = false;
+            for (uint32_t i = adjacencyStart[c.from]; i < adjacencyStart[c.from + 1] && !flips; i++) {
+                const uint32_t* tri = &result[adjacency[i] * 3];
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) continue;  // Collapses away
+                const float* p[3] = {pos(tri[0]), pos(tri[1]), pos(tri[2])};
+                float before[3], after[3];
+                triangleNormal(p[0], p[1], p[2], before);
+                for (int k = 0; k < 3; k++) {
+                    if (tri[k] == c.from) p[k] = pos(c.to);
+                }
+                triangleNormal(p[0], p[1], p[2], after);
+                flips = dot3(before, after) <= 0.25f * std::sqrt(dot3(before, before) * dot3(after, after));
+            }
+            if (flips) continue;
+
+            remap[c.from] = c.to;
+            quadrics[c.to].add(quadrics[c.from]);
+            achieved = std::max(achieved, float(std::sqrt(c.cost)));
+            applied++;
+
+            // Keep this pass's collapses independent: lock both one-rings
+            for (uint32_t v : {c.from, c.to}) {
+                for (uint32_t i = adjacencyStart[v]; i < adjacencyStart[v + 1]; i++) {
+                    const uint32_t* tri = &result[adjacency[i] * 3];
+                    locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+                }
+            }
+        }
+        if (applied == 0) break;
+
+        // Apply and drop triangles that became degenerate
+        size_t write = 0;
+        for (size_t t = 0; t + 2 < result.size(); t += 3) {
+            uint32_t a = remap[result[t]], b = remap[result[t + 1]], c = remap[result[t + 2]];
+            if (a == b || b == c || a == c) continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (outError) *outError = achieved;
+    return result;
+}
+
+// LOD 0 followed by simplified levels (each aiming for half the previous
+// triangle count) in one index list; lods receives the ranges. Stops once
+// a level saves under 10% or maxRelativeError (of the bounding radius)
+// would be exceeded.
+inline std::vector<uint32_t> buildLodChain(const float* positions, uint32_t strideFloats, uint32_t vertexCount,
+                                           const std::vector<uint32_t>& indices, std::vector<MeshLod>& lods,
+                                           uint32_t maxLods = DEFAULT_MESH_LODS, float maxRelativeError = 0.1f) {
+    std::vector<uint32_t> all = indices;
+    lods.clear();
+    lods.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+    // Bounding radius for the error limit
+    float lo[3] = {1e30f, 1e30f, 1e30f}, hi[3] = {-1e30f, -1e30f, -1e30f};
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        const float* p = positions + size_t(v) * strideFloats;
+        for (int c = 0; c < 3; c++) {
+            lo[c] = std::min(lo[c], p[c]);
+            hi[c] = std::max(hi[c], p[c]);
+        }
+    }
+    float extent[3] = {hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]};
+    float maxError = 0.5f * std::sqrt(lod_detail::dot3(extent, extent)) * maxRelativeError;
+
+    std::vector<uint32_t> current = indices;
+    float error = 0.0f;
+    maxLods = std::min(maxLods, MAX_MESH_LODS);
+    while (lods.size() < maxLods) {
+        uint32_t target = static_cast<uint32_t>(current.size() / 2 / 3 * 3);
+        if (target < 36) break;  // Not worth a level
+
+        float levelError = 0.0f;
+        std::vector<uint32_t> next = simplifyIndices(positions, strideFloats, vertexCount, current, target,
+                                                     maxError, &levelError);
+        if (next.empty() || next.size() > current.size() * 9 / 10) break;
+
+        error = std::max(error, levelError);
+        lods.push_back({static_cast<uint32_t>(all.size()), static_cast<uint32_t>(next.size()), error});
+        all.insert(all.end(), next.begin(), next.end());
+        current.swap(next);
+    }
+    return all;
+}
+
+inline LodBounds computeLodBounds(const float* positions, uint32_t strideFloats, uint32_t vertexCount) {
+    LodBounds bounds;
+    if (vertexCount == 0) return bounds;
+    glm::vec3 lo(1e30f), hi(-1e30f);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        glm::vec3 p(positions[size_t(v) * strideFloats], positions[size_t(v) * strideFloats + 1],
+                    positions[size_t(v) * strideFloats + 2]);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    bounds.center = (lo + hi) * 0.5f;
+    bounds.radius = glm::length(hi - lo) * 0.5f;
+    return bounds;
+}
+
+// ----------------------------------------------------------------------------
+// Selection
+// ----------------------------------------------------------------------------
+
+// Pixels per model unit at distance 1: proj[1][1] * viewportHeight / 2
+inline float lodProjectionScale(const glm::mat4& proj, float viewportHeight) {
+    return std::abs(proj[1][1]) * viewportHeight * 0.5f;
+}
+
+// Coarsest LOD whose error projects under pixelError pixels. Levels coarser
+// than `current` must beat the budget by `hysteresis` (0.2 = 20%); the
+// current and finer levels may exceed it by as much before switching back.
+inline uint32_t selectLod(const MeshLod* lods, uint32_t lodCount, const LodBounds& bounds,
+                          const glm::mat4& model, const glm::mat4& view, float projectionScale,
+                          float pixelError, float hysteresis, uint32_t current) {
+    if (lodCount <= 1 || pixelError <= 0.0f) return 0;
+
+    glm::vec3 viewCenter = glm::vec3(view * model * glm::vec4(bounds.center, 1.0f));
+    float scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                            glm::length(glm::vec3(model[2]))});
+    float distance = glm::length(viewCenter) - bounds.radius * scale;  // Nearest point of the bounds
+    if (distance <= 1e-4f) return 0;
+
+    float pixelsPerUnit = scale * projectionScale / distance;
+    for (uint32_t lod = lodCount - 1; lod > 0; lod--) {
+        float budget = pixelError * (lod > current ? 1.0f - hysteresis : 1.0f + hysteresis);
+        if (lods[lod].error * pixelsPerUnit <= budget) return lod;
+    }
+    return 0;
+}
+
+} // namespace vkcore
+
+#endif // VKCORE_MESH_LOD_H
@@ -0,0 +1,222 @@
+// ============================================================================
+// OCCLUSION QUERIES - Per-object visibility from last frame's depth buffer
+// ============================================================================
+// Lets callers skip drawing objects that were hidden behind others:
+//
+//   - begin()/end() wrap the draw (or a cheap proxy of it) in an occlusion
+//     query tagged with a caller-chosen id in [0, capacity).
+//   - Every frame in flight owns its own range of one VkQueryPool, so results
+//     are read back only after that frame's fence signalled - no stalls.
+//   - beginFrame() resolves the range from the slot's previous use and resets
+//     it for this frame. An id is visible if any of its queries passed a
+//     sample; ids that were never queried (or whose result isn't available)
+//     count as visible, so culling only ever errs towards drawing.
+//
+// Results are framesInFlight frames old: objects that come into view pop in
+// that many frames late, so only use this for large occluders' victims, not
+// for fast-moving or small objects. begin() is thread-safe, so queries work
+// inside VulkanCore::recordParallel() tasks as long as begin and end go into
+// the same command buffer.
+//
+// Header-only, like gpu_allocator.h. VulkanCore owns one when
+// CoreConfig::maxOcclusionQueries > 0 and builds drawMeshOcclusionCulled()
+// on top.
+//
+// Usage:
+//   OcclusionQueries queries;
+//   queries.init(device, 1024, framesInFlight);
+//   queries.beginFrame(cmd, frameIndex);              // outside a render pass
+//   if (queries.isVisible(id)) {
+//       uint32_t q = queries.begin(cmd, id);          // inside the render pass
+//       ... draw ...
+//       queries.end(cmd, q);
+//   }
+//   queries.shutdown();                               // before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_OCCLUSION_QUERIES_H
+#define VKCORE_OCCLUSION_QUERIES_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+class OcclusionQueries {
+public:
+    static constexpr uint32_t MAX_FRAMES = 4;
+    static constexpr uint32_t NO_QUERY = UINT32_MAX;
+
+    OcclusionQueries() = default;
+    ~OcclusionQueries() { shutdown(); }
+
+    OcclusionQueries(const OcclusionQueries&) = delete;
+    OcclusionQueries& operator=(const OcclusionQueries&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    // capacity: distinct ids, and queries per frame
+    bool init(VkDevice device, uint32_t capacity, uint32_t framesInFlight) {
+        if (m_device != VK_NULL_HANDLE) return true;
+        if (capacity == 0) return false;
+
+        m_frameCount = framesInFlight < 1 ? 1 : (framesInFlight > MAX_FRAMES ? MAX_FRAMES : framesInFlight);
+        m_capacity = capacity;
+
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+        poolInfo.queryCount = m_frameCount * m_capacity;
+
+        if (vkCreateQueryPool(device, &poolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+            std::cerr << "[OcclusionQueries] Failed to create occlusion query pool" << std::endl;
+            return false;
+        }
+
+        m_device = device;
+        m_results.resize(m_capacity * 2);  // value + availability per query
+        m_visible.assign(m_capacity, 1);
+        for (auto& frame : m_frames) {
+            frame.used = 0;
+            frame.ids.assign(m_capacity, 0);
+            frame.pending = false;
+        }
+        return true;
+    }
+
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+        m_queryPool = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+        m_visible.clear();
+    }
+
+    bool isEnabled() const { return m_device != VK_NULL_HANDLE; }
+    uint32_t getCapacity() const { return m_capacity; }
+
+    // ========================================================================
+    // Recording
+    // ========================================================================
+
+    // Call once per frame, outside a render pass, after frameIndex's fence
+    // has signalled. Resolves that slot's previous frame and resets it.
+    void beginFrame(VkCommandBuffer cmd, uint32_t frameIndex) {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        m_recordFrame = frameIndex % m_frameCount;
+        FrameSlot& frame = m_frames[m_recordFrame];
+        if (frame.pending) resolve(frame, m_recordFrame);
+
+        vkCmdResetQueryPool(cmd, m_queryPool, queryBase(m_recordFrame), m_capacity);
+        frame.used = 0;
+        frame.overflowWarned = false;
+        frame.pending = true;
+    }
+
+    // Starts a query for id; returns NO_QUERY when disabled, when id is out
+    // of range or when the frame ran out of queries (draw without one)
+    uint32_t begin(VkCommandBuffer cmd, uint32_t id) {
+        if (m_device == VK_NULL_HANDLE || cmd == VK_NULL_HANDLE || id >= m_capacity) return NO_QUERY;
+
+        FrameSlot& frame = m_frames[m_recordFrame];
+        uint32_t query = frame.used.fetch_add(1, std::memory_order_relaxed);
+        if (query >= m_capacity) {
+            frame.used.store(m_capacity, std::memory_order_relaxed);
+            if (!frame.overflowWarned.exchange(true)) {
+                std::cerr << "[OcclusionQueries] More than " << m_capacity
+                          << " queries this frame - extra draws are not tested" << std::endl;
+            }
+            return NO_QUERY;
+        }
+
+        frame.ids[query] = id;
+        vkCmdBeginQuery(cmd, m_queryPool, queryBase(m_recordFrame) + query, 0);
+        return query;
+    }
+
+    void end(VkCommandBuffer cmd, uint32_t query) {
+        if (m_device == VK_NULL_HANDLE || cmd == VK_NULL_HANDLE || query == NO_QUERY) return;
+        vkCmdEndQuery(cmd, m_queryPool, queryBase(m_recordFrame) + query);
+    }
+
+    // ========================================================================
+    // Results
+    // ========================================================================
+
+    // From the last resolved frame (framesInFlight frames behind)
+    bool isVisible(uint32_t id) const {
+        return id >= m_visible.size() || m_visible[id] != 0;
+    }
+
+    // Ids found occluded in the last resolved frame
+    uint32_t getOccludedCount() const { return m_occludedCount; }
+
+private:
+    struct FrameSlot {
+        std::atomic<uint32_t> used{0};
+        std::atomic<bool> overflowWarned{false};
+        std::vector<uint32_t> ids;  // Caller id per query
+        bool pending = false;       // Recorded, not yet resolved
+    };
+
+    uint32_t queryBase(uint32_t frameIndex) const { return frameIndex * m_capacity; }
+
+    void resolve(FrameSlot& frame, uint32_t frameIndex) {
+        frame.pending = false;
+
+        uint32_t used = frame.used.load(std::memory_order_relaxed);
+        if (used > m_capacity) used = m_capacity;
+        if (used == 0) return;
+
+        // Never WAIT: the frame's fence already signalled, and a query that
+        // was begun but never ended must not hang the CPU
+        VkResult result = vkGetQueryPoolResults(m_device, m_queryPool, queryBase(frameIndex), used,
+                                                used * 2 * sizeof(uint64_t), m_results.data(),
+                                                2 * sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result != VK_SUCCESS && result != VK_NOT_READY) return;
+
+        // Ids queried this frame start hidden; any passing query shows them
+        for (uint32_t i = 0; i < used; i++) {
+            if (m_results[i * 2 + 1]) m_visible[frame.ids[i]] = 0;
+        }
+        for (uint32_t i = 0; i < used; i++) {
+            if (!m_results[i * 2 + 1] || m_results[i * 2] > 0) m_visible[frame.ids[i]] = 1;
+        }
+
+        m_occludedCount = 0;
+        for (uint32_t i = 0; i < used; i++) {
+            if (m_visible[frame.ids[i]] == 0) {
+                m_occludedCount++;
+                m_visible[frame.ids[i]] = 2;  // Count each id once
+            }
+        }
+        for (uint32_t i = 0; i < used; i++) {
+            if (m_visible[frame.ids[i]] == 2) m_visible[frame.ids[i]] = 0;
+        }
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    uint32_t m_frameCount = 1;
+    uint32_t m_recordFrame = 0;
+    uint32_t m_capacity = 0;
+
+    FrameSlot m_frames[MAX_FRAMES];
+    std::vector<uint64_t> m_results;
+
+    std::vector<uint8_t> m_visible;  // Per id: 0 = occluded
+    uint32_t m_occludedCount = 0;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_OCCLUSION_QUERIES_H
@@ -0,0 +1,434 @@
+// ============================================================================
+// PICK BUFFER - GPU triangle ids under the cursor, read back asynchronously
+// ============================================================================
+// Editors used to pick by ray-casting CPU copies of their meshes, which had
+// to be kept in step with GPU-side edits. With CoreConfig::pickBuffer,
+// VulkanCore's render pass gets a second subpass that draws the pickable
+// meshes' triangle ids into an R32_UINT attachment, and this reads a small
+// rect of it back:
+//
+//   - Every pickable draw gets a range of ids, one per triangle
+//     (addDraw()); the pick fragment shader writes idBase + gl_PrimitiveID,
+//     0 = background. The ranges map an id back to the draw's object id
+//     and mesh triangle.
+//   - Draws are collected as the frame records and replayed into the pick
+//     subpass only in frames with a request, depth-tested LESS_OR_EQUAL
+//     against the scene, so anything drawn in front occludes them.
+//   - The requested rect (at most MAX_RECT pixels square) is copied after
+//     the render pass into the frame slot's host-visible staging buffer.
+//     Once that slot's fence signalled, resolve() takes the hit nearest the
+//     rect centre. CPU cost is per draw and per rect pixel, never per
+//     triangle.
+//
+// Results arrive when the GPU has finished the frame - normally the next
+// one - so the scene may have moved meanwhile; fine for clicks.
+//
+// Header-only, like occlusion_queries.h. VulkanCore owns one when
+// CoreConfig::pickBuffer is set and builds requestPick() on top.
+//
+// Usage:
+//   PickBuffer pick;
+//   pick.init(device, allocator, framesInFlight);
+//   pick.createTarget(allocator, width, height);   // again after a resize
+//   pick.beginFrame(frameIndex, frameNumber);      // slot's fence signalled
+//   pick.request(x, y, 2);
+//   pick.addDraw(draw, firstTriangle, objectId, mesh); // per pickable draw
+//   pick.replay(cmd);                              // in the pick subpass
+//   pick.recordCopy(cmd);                          // after the render pass
+//   pick.resolve(slot);                            // once slot's fence signalled
+//   if (pick.takeResult(result) && result.hit) ...
+//   pick.shutdown(allocator);                      // before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_PICK_BUFFER_H
+#define VKCORE_PICK_BUFFER_H
+
+#include <vulkan/vulkan.h>
+
+#include "gpu_allocator.h"
+
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+// Push constants of pickable pipelines: BindlessPushConstants, then the
+// draw's first id (pick_id.frag reads it at offset 4)
+struct PickPushConstants {
+    uint32_t textureIndex;
+    uint32_t idBase;
+};
+
+struct PickResult {
+    bool hit = false;            // false: background (or outside the window)
+    uint32_t objectId = 0;       // VulkanCore::setPickObject() at the draw
+    uint32_t mesh = UINT32_MAX;  // MeshHandle drawn
+    uint32_t triangle = 0;       // In the mesh's index buffer (of the LOD it was drawn at)
+    int32_t x = 0;               // Pixel the hit came from
+    int32_t y = 0;
+    uint64_t frame = 0;          // Frame the ids were drawn in
+};
+
+class PickBuffer {
+public:
+    static constexpr VkFormat FORMAT = VK_FORMAT_R32_UINT;
+    static constexpr uint32_t MAX_FRAMES = 4;
+    static constexpr uint32_t MAX_RECT = 31;  // Largest rect side read back
+    static constexpr uint32_t NO_ID = 0;
+
+    // What replay() needs to draw one pickable draw again
+    struct Draw {
+        VkPipeline pipeline = VK_NULL_HANDLE;  // The pipeline's pick variant
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        uint32_t dynamicOffset = 0;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        uint32_t idBase = NO_ID;  // Set by addDraw()
+    };
+
+    PickBuffer() = default;
+    ~PickBuffer() = default;  // shutdown() needs the allocator
+
+    PickBuffer(const PickBuffer&) = delete;
+    PickBuffer& operator=(const PickBuffer&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VkDevice device, GpuAllocator& allocator, uint32_t framesInFlight) {
+        if (m_device != VK_NULL_HANDLE) return true;
+
+        m_frameCount = framesInFlight < 1 ? 1 : (framesInFlight > MAX_FRAMES ? MAX_FRAMES : framesInFlight);
+        for (uint32_t i = 0; i < m_frameCount; i++) {
+            FrameSlot& slot = m_frames[i];
+            if (!allocator.createBuffer(VkDeviceSize(MAX_RECT) * MAX_RECT * sizeof(uint32_t),
+                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                        slot.staging, slot.stagingAlloc)) {
+                std::cerr << "[PickBuffer] Failed to create readback staging" << std::endl;
+                m_device = device;
+                shutdown(allocator);
+                return false;
+            }
+            slot.pending = false;
+        }
+        m_device = device;
+        return true;
+    }
+
+    void shutdown(GpuAllocator& allocator) {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        destroyTarget(allocator);
+        for (FrameSlot& slot : m_frames) {
+            if (slot.staging != VK_NULL_HANDLE) allocator.destroyBuffer(slot.staging, slot.stagingAlloc);
+            slot.ranges.clear();
+            slot.pending = false;
+        }
+        m_draws.clear();
+        m_ranges.clear();
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isEnabled() const { return m_device != VK_NULL_HANDLE; }
+
+    // The id attachment, window-sized (recreate with the swapchain)
+    bool createTarget(GpuAllocator& allocator, uint32_t width, uint32_t height) {
+        if (m_device == VK_NULL_HANDLE) return false;
+        destroyTarget(allocator);
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent = {width, height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = FORMAT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        if (!allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageAlloc)) {
+            std::cerr << "[PickBuffer] Failed to create the id attachment" << std::endl;
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = FORMAT;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &m_view) != VK_SUCCESS) {
+            allocator.destroyImage(m_image, m_imageAlloc);
+            return false;
+        }
+        m_width = width;
+        m_height = height;
+        return true;
+    }
+
+    void destroyTarget(GpuAllocator& allocator) {
+        if (m_view != VK_NULL_HANDLE) vkDestroyImageView(m_device, m_view, nullptr);
+        if (m_image != VK_NULL_HANDLE) allocator.destroyImage(m_image, m_imageAlloc);
+        m_view = VK_NULL_HANDLE;
+        m_image = VK_NULL_HANDLE;
+        m_width = m_height = 0;
+    }
+
+    VkImageView getView() const { return m_view; }
+
+    // ========================================================================
+    // Requests
+    // ========================================================================
+
+    // Reads the (2 * radius + 1)-pixel square around (x, y) from the frame
+    // being recorded (or the next one, between frames); a newer request
+    // replaces one that has not been drawn yet
+    void request(int32_t x, int32_t y, uint32_t radius = 0) {
+        uint32_t maxRadius = (MAX_RECT - 1) / 2;
+        m_request.active = true;
+        m_request.x = x;
+        m_request.y = y;
+        m_request.radius = radius > maxRadius ? maxRadius : radius;
+    }
+
+    // Whether the frame being recorded draws ids at all
+    bool hasRequest() const { return m_device != VK_NULL_HANDLE && m_request.active; }
+
+    // Newest resolved request since the last call; false if none arrived
+    bool takeResult(PickResult& result) {
+        if (!m_resultReady) return false;
+        result = m_result;
+        m_resultReady = false;
+        return true;
+    }
+
+    // ========================================================================
+    // Recording
+    // ========================================================================
+
+    // Call once per frame after frameIndex's fence signalled (and after
+    // resolve() for it)
+    void beginFrame(uint32_t frameIndex, uint64_t frameNumber) {
+        m_recordFrame = frameIndex % m_frameCount;
+        m_frameNumber = frameNumber;
+        m_draws.clear();
+        m_ranges.clear();
+        m_nextId = NO_ID + 1;
+    }
+
+    // Gives the draw its id range (one id per triangle) and keeps it for
+    // replay(). Thread-safe (recordParallel tasks)
+    void addDraw(Draw draw, uint32_t firstTriangle, uint32_t objectId, uint32_t mesh) {
+        if (m_device == VK_NULL_HANDLE) return;
+        uint32_t triangles = draw.indexCount / 3;
+        if (triangles == 0) return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_nextId > UINT32_MAX - triangles) return;  // Out of ids this frame
+        draw.idBase = m_nextId;
+        m_nextId += triangles;
+        m_draws.push_back(draw);
+        m_ranges.push_back({draw.idBase, triangles, firstTriangle, objectId, mesh});
+    }
+
+    // Inside the pick subpass, viewport and scissor set: draws the frame's
+    // pickable draws with their pick variants (only when hasRequest())
+    void replay(VkCommandBuffer cmd) {
+        if (!hasRequest()) return;
+
+        VkPipeline bound = VK_NULL_HANDLE;
+        VkBuffer boundVertices = VK_NULL_HANDLE, boundIndices = VK_NULL_HANDLE;
+        for (const Draw& draw : m_draws) {
+            if (draw.pipeline != bound) {
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+                bound = draw.pipeline;
+            }
+            if (draw.vertexBuffer != boundVertices) {
+                VkDeviceSize offset = 0;
+                vkCmdBindVertexBuffers(cmd, 0, 1, &draw.vertexBuffer, &offset);
+                boundVertices = draw.vertexBuffer;
+            }
+            if (draw.indexBuffer != boundIndices) {
+                vkCmdBindIndexBuffer(cmd, draw.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                boundIndices = draw.indexBuffer;
+            }
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.layout, 0, 1,
+                                    &draw.descriptorSet, 1, &draw.dynamicOffset);
+            vkCmdPushConstants(cmd, draw.layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                               offsetof(PickPushConstants, idBase), sizeof(uint32_t), &draw.idBase);
+            vkCmdDrawIndexed(cmd, draw.indexCount, 1, draw.firstIndex, 0, 0);
+        }
+    }
+
+    // After the render pass (the attachment ends in TRANSFER_SRC_OPTIMAL):
+    // copies the requested rect into this slot's staging and hands the
+    // frame's id ranges to the slot
+    void recordCopy(VkCommandBuffer cmd) {
+        if (!hasRequest() || m_image == VK_NULL_HANDLE) return;
+        m_request.active = false;
+
+        int32_t r = static_cast<int32_t>(m_request.radius);
+        int32_t x0 = std::max(m_request.x - r, 0), y0 = std::max(m_request.y - r, 0);
+        int32_t x1 = std::min(m_request.x + r + 1, static_cast<int32_t>(m_width));
+        int32_t y1 = std::min(m_request.y + r + 1, static_cast<int32_t>(m_height));
+
+        FrameSlot& slot = m_frames[m_recordFrame];
+        slot.pending = true;
+        slot.frameNumber = m_frameNumber;
+        slot.centerX = m_request.x;
+        slot.centerY = m_request.y;
+        slot.x = x0;
+        slot.y = y0;
+        slot.width = x1 > x0 ? static_cast<uint32_t>(x1 - x0) : 0;
+        slot.height = y1 > y0 ? static_cast<uint32_t>(y1 - y0) : 0;
+        slot.ranges.swap(m_ranges);
+        if (slot.width == 0 || slot.height == 0) return;  // Outside the window: resolves as a miss
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageOffset = {x0, y0, 0};
+        region.imageExtent = {slot.width, slot.height, 1};
+        vkCmdCopyImageToBuffer(cmd, m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.staging, 1, &region);
+
+        VkMemoryBarrier hostRead{};
+        hostRead.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        hostRead.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostRead.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                             0, 1, &hostRead, 0, nullptr, 0, nullptr);
+    }
+
+    // ========================================================================
+    // Results
+    // ========================================================================
+
+    bool isPending(uint32_t frameIndex) const { return frameIndex < m_frameCount && m_frames[frameIndex].pending; }
+
+    // Only once frameIndex's fence signalled: reads its rect and maps the
+    // hit nearest the centre back to its draw
+    void resolve(uint32_t frameIndex) {
+        if (!isPending(frameIndex)) return;
+        FrameSlot& slot = m_frames[frameIndex];
+        slot.pending = false;
+
+        PickResult result;
+        result.frame = slot.frameNumber;
+        result.x = slot.centerX;
+        result.y = slot.centerY;
+
+        const uint32_t* ids = static_cast<const uint32_t*>(slot.stagingAlloc.mapped);
+        uint32_t bestId = NO_ID;
+        int64_t bestDistance = INT64_MAX;
+        for (uint32_t row = 0; ids && row < slot.height; row++) {
+            for (uint32_t col = 0; col < slot.width; col++) {
+                uint32_t id = ids[row * slot.width + col];
+                if (id == NO_ID) continue;
+                int64_t dx = slot.x + int32_t(col) - slot.centerX, dy = slot.y + int32_t(row) - slot.centerY;
+                if (dx * dx + dy * dy < bestDistance) {
+                    bestDistance = dx * dx + dy * dy;
+                    bestId = id;
+                    result.x = slot.x + int32_t(col);
+                    result.y = slot.y + int32_t(row);
+                }
+            }
+        }
+
+        // Ranges are in id order: the last one starting at or below the id
+        auto range = std::upper_bound(slot.ranges.begin(), slot.ranges.end(), bestId,
+                                      [](uint32_t id, const IdRange& r) { return id < r.base; });
+        if (bestId != NO_ID && range != slot.ranges.begin()) {
+            --range;
+            if (bestId - range->base < range->count) {
+                result.hit = true;
+                result.objectId = range->objectId;
+                result.mesh = range->mesh;
+                result.triangle = range->firstTriangle + (bestId - range->base);
+            }
+        }
+        if (!result.hit) {
+            result.x = slot.centerX;
+            result.y = slot.centerY;
+        }
+
+        // An older frame finishing late never replaces a newer result
+        if (!m_resultReady || result.frame >= m_result.frame) {
+            m_result = result;
+            m_resultReady = true;
+        }
+    }
+
+private:
+    struct IdRange {
+        uint32_t base;
+        uint32_t count;          // Triangles
+        uint32_t firstTriangle;  // Of the draw, in the mesh's index buffer
+        uint32_t objectId;
+        uint32_t mesh;
+    };
+
+    struct FrameSlot {
+        VkBuffer staging = VK_NULL_HANDLE;
+        GpuAllocation stagingAlloc;
+        std::vector<IdRange> ranges;  // Of the frame the rect was read from
+        uint64_t frameNumber = 0;
+        int32_t centerX = 0, centerY = 0;
+        int32_t x = 0, y = 0;         // Rect read, clamped to the attachment
+        uint32_t width = 0, height = 0;
+        bool pending = false;         // Copy recorded, not yet resolved
+    };
+
+    struct Request {
+        bool active = false;
+        int32_t x = 0, y = 0;
+        uint32_t radius = 0;
+    };
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkImage m_image = VK_NULL_HANDLE;
+    GpuAllocation m_imageAlloc;
+    VkImageView m_view = VK_NULL_HANDLE;
+    uint32_t m_width = 0, m_height = 0;
+
+    uint32_t m_frameCount = 1;
+    uint32_t m_recordFrame = 0;
+    uint64_t m_frameNumber = 0;
+    FrameSlot m_frames[MAX_FRAMES];
+
+    // This frame's pickable draws and their ids (guarded by m_mutex)
+    std::mutex m_mutex;
+    std::vector<Draw> m_draws;
+    std::vector<IdRange> m_ranges;
+    uint32_t m_nextId = NO_ID + 1;
+
+    Request m_request;
+    PickResult m_result;
+    bool m_resultReady = false;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_PICK_BUFFER_H
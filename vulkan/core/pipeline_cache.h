@@ -0,0 +1,207 @@
+// ============================================================================
+// PIPELINE CACHE - Persistent VkPipelineCache shared by every module
+// ============================================================================
+// Pipelines built through the same VkPipelineCache skip driver compilation
+// when the driver has seen the shader/state combination before - on the next
+// launch (via the on-disk copy) and on every shader hot-reload of an
+// unchanged variant.
+//
+//   - The file name carries the device's pipelineCacheUUID, so switching
+//     GPUs or drivers starts a fresh cache instead of feeding the driver a
+//     stale blob.
+//   - The blob header is checked against the device before use; a mismatch
+//     or a truncated file falls back to an empty cache.
+//   - save() writes to a temp file and renames it, so a crash mid-write
+//     never leaves a corrupt cache behind.
+//
+// VkPipelineCache is internally synchronized, so get() can be passed to
+// vkCreateGraphicsPipelines from any thread.
+//
+// Header-only, like gpu_allocator.h.
+//
+// Usage:
+//   PipelineCache cache;
+//   cache.init(device, physicalDevice);          // loads from disk
+//   vkCreateGraphicsPipelines(device, cache.get(), 1, &info, nullptr, &pipe);
+//   cache.shutdown();                            // saves, before vkDestroyDevice
+// ============================================================================
+
+#ifndef VKCORE_PIPELINE_CACHE_H
+#define VKCORE_PIPELINE_CACHE_H
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+class PipelineCache {
+public:
+    PipelineCache() = default;
+    ~PipelineCache() { shutdown(); }
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    // Process-wide cache for code paths without a VulkanCore (the EDEN
+    // helpers, MeshRenderer). First call with a valid device initializes it;
+    // if that fails, get() stays VK_NULL_HANDLE rather than retrying per build.
+    static PipelineCache& shared(VkDevice device, VkPhysicalDevice physicalDevice) {
+        static PipelineCache s_shared;
+        static bool s_attempted = false;
+        if (!s_attempted && device != VK_NULL_HANDLE) {
+            s_attempted = true;
+            s_shared.init(device, physicalDevice);
+        }
+        return s_shared;
+    }
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    // directory: where cache files live ("" = working directory)
+    bool init(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& directory = "") {
+        if (m_device != VK_NULL_HANDLE) return true;
+
+        vkGetPhysicalDeviceProperties(physicalDevice, &m_props);
+        m_path = directory.empty() ? cacheFileName() : directory + "/" + cacheFileName();
+
+        std::vector<char> blob = readFile(m_path);
+        bool loaded = !blob.empty() && headerMatches(blob);
+        if (!blob.empty() && !loaded) {
+            std::cout << "[PipelineCache] " << m_path << " is from another device/driver - starting fresh" << std::endl;
+        }
+
+        VkPipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheInfo.initialDataSize = loaded ? blob.size() : 0;
+        cacheInfo.pInitialData = loaded ? blob.data() : nullptr;
+
+        VkResult result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &m_cache);
+        if (result != VK_SUCCESS && loaded) {
+            // Driver rejected the blob - retry empty
+            cacheInfo.initialDataSize = 0;
+            cacheInfo.pInitialData = nullptr;
+            loaded = false;
+            result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &m_cache);
+        }
+        if (result != VK_SUCCESS) {
+            std::cerr << "[PipelineCache] Failed to create pipeline cache - pipelines compile uncached" << std::endl;
+            m_cache = VK_NULL_HANDLE;
+            return false;
+        }
+
+        m_device = device;
+        m_savedSize = loaded ? blob.size() : 0;
+        std::cout << "[PipelineCache] " << (loaded ? "Loaded " : "Created empty ") << m_path;
+        if (loaded) std::cout << " (" << (blob.size() / 1024) << " KB)";
+        std::cout << std::endl;
+        return true;
+    }
+
+    // Saves, then destroys the cache (before vkDestroyDevice)
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        save();
+        vkDestroyPipelineCache(m_device, m_cache, nullptr);
+        m_cache = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isInitialized() const { return m_device != VK_NULL_HANDLE; }
+
+    // VK_NULL_HANDLE if init failed - still valid to pass to vkCreate*Pipelines
+    VkPipelineCache get() const { return m_cache; }
+    const std::string& getPath() const { return m_path; }
+
+    // ========================================================================
+    // Persistence
+    // ========================================================================
+
+    // Writes the cache to disk if it grew since the last load/save
+    bool save() {
+        if (m_device == VK_NULL_HANDLE || m_cache == VK_NULL_HANDLE) return false;
+
+        size_t size = 0;
+        if (vkGetPipelineCacheData(m_device, m_cache, &size, nullptr) != VK_SUCCESS || size == 0) return false;
+        if (size == m_savedSize) return true;  // Nothing new compiled
+
+        std::vector<char> blob(size);
+        if (vkGetPipelineCacheData(m_device, m_cache, &size, blob.data()) != VK_SUCCESS) return false;
+
+        std::string tmpPath = m_path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cerr << "[PipelineCache] Cannot write " << tmpPath << std::endl;
+                return false;
+            }
+            file.write(blob.data(), static_cast<std::streamsize>(size));
+            if (!file) return false;
+        }
+        std::remove(m_path.c_str());  // rename() won't replace on Windows
+        if (std::rename(tmpPath.c_str(), m_path.c_str()) != 0) {
+            std::cerr << "[PipelineCache] Cannot replace " << m_path << std::endl;
+            return false;
+        }
+
+        m_savedSize = size;
+        std::cout << "[PipelineCache] Saved " << m_path << " (" << (size / 1024) << " KB)" << std::endl;
+        return true;
+    }
+
+private:
+    // VkPipelineCacheHeaderVersionOne: size, version, vendorID, deviceID, UUID
+    static constexpr size_t HEADER_SIZE = 16 + VK_UUID_SIZE;
+
+    std::string cacheFileName() const {
+        static const char* hex = "0123456789abcdef";
+        std::string name = "pipeline_cache_";
+        for (uint32_t i = 0; i < VK_UUID_SIZE; i++) {
+            name += hex[m_props.pipelineCacheUUID[i] >> 4];
+            name += hex[m_props.pipelineCacheUUID[i] & 0xF];
+        }
+        return name + ".bin";
+    }
+
+    bool headerMatches(const std::vector<char>& blob) const {
+        if (blob.size() < HEADER_SIZE) return false;
+
+        uint32_t header[4];
+        memcpy(header, blob.data(), sizeof(header));
+        return header[0] >= HEADER_SIZE &&
+               header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               header[2] == m_props.vendorID &&
+               header[3] == m_props.deviceID &&
+               memcmp(blob.data() + 16, m_props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    static std::vector<char> readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return {};
+        std::streamsize size = file.tellg();
+        if (size <= 0) return {};
+        std::vector<char> data(static_cast<size_t>(size));
+        file.seekg(0);
+        file.read(data.data(), size);
+        return file ? data : std::vector<char>{};
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties m_props{};
+    std::string m_path;
+    size_t m_savedSize = 0;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_PIPELINE_CACHE_H
@@ -0,0 +1,1072 @@
+// ============================================================================
+// RENDER GRAPH - Declared passes, derived barriers, aliased transients
+// ============================================================================
+// Offscreen passes (shadows, post-processing) declare which resources they
+// read and write; the graph works out everything that is usually written
+// by hand:
+//
+//   - Barriers: compile() replays the live passes in order and records, per
+//     pass, the layout transitions and memory dependencies its accesses
+//     need - read-after-read needs none, stages are exactly the ones
+//     involved (never ALL_COMMANDS) - and execute() issues them as ONE
+//     vkCmdPipelineBarrier per pass.
+//   - Culling: passes whose writes no live pass reads (and that don't write
+//     an imported resource, a markOutput() resource or have side effects)
+//     are dropped, along with transients only they touched.
+//   - Aliasing: transient images whose lifetimes (first to last live pass)
+//     don't overlap share one device memory block.
+//   - Render passes: a pass that writes color/depth attachments gets its own
+//     VkRenderPass + VkFramebuffer, begun and ended around its callback.
+//
+// Transients start every frame with undefined contents (unless a pass
+// clears them). Hazards with the previous frame - still in flight on the
+// same queue - are covered by each pass's first barrier, whose source is the
+// previous user of that memory. Resources are tracked as a whole, so passes
+// writing different layers of one image still get a barrier between them.
+//
+// Run it outside VulkanCore's render pass, typically as a frame prologue.
+// compile() once after declaring (or after reset() + re-declaring, e.g. on
+// resize); execute() every frame.
+//
+// Header-only, like gpu_allocator.h. Not thread-safe.
+//
+// Usage:
+//   RenderGraph graph(&core);
+//   RGResource shadow = graph.createImage("shadow", {2048, 2048, VK_FORMAT_D32_SFLOAT});
+//   graph.addPass("shadow",
+//       [&](RenderGraph::PassBuilder& b) { b.write(shadow, RGAccess::DepthAttachment); b.clearDepth(shadow); },
+//       [&](const RenderGraph::PassContext& ctx) { /* draw casters into ctx.cmd */ });
+//   graph.markOutput(shadow, RGAccess::SampledFragment);  // read by the main pass
+//   graph.compile();
+//   core.addFramePrologue([&](VkCommandBuffer cmd) { graph.execute(cmd); });
+// ============================================================================
+
+#ifndef VKCORE_RENDER_GRAPH_H
+#define VKCORE_RENDER_GRAPH_H
+
+#include "vulkan_core.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+using RGResource = uint32_t;
+constexpr RGResource RG_INVALID = UINT32_MAX;
+constexpr uint32_t RG_ALL_LAYERS = UINT32_MAX;
+
+// How a pass touches a resource. Attachment accesses make the pass a render
+// pass; the rest only drive barriers.
+enum class RGAccess {
+    ColorAttachment,   // Image, write
+    DepthAttachment,   // Image, depth test + write
+    DepthRead,         // Image, depth test only (read-only attachment)
+    SampledFragment,   // Image, read
+    SampledCompute,    // Image, read
+    StorageRead,       // Image or buffer, compute shader
+    StorageWrite,      // Image or buffer, compute shader
+    TransferSrc,
+    TransferDst,
+    VertexBuffer,
+    IndexBuffer,
+    IndirectBuffer,
+    UniformBuffer
+};
+
+struct RGImageDesc {
+    uint32_t width = 0;   // 0 = VulkanCore's current extent
+    uint32_t height = 0;
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    uint32_t layers = 1;  // > 1: 2D array (e.g. shadow cascades), attach one layer per pass
+    VkImageUsageFlags extraUsage = 0;  // Added to what the declared accesses need
+};
+
+class RenderGraph {
+private:
+    struct Pass;
+
+public:
+    struct Stats {
+        uint32_t passes = 0;            // Declared
+        uint32_t passesCulled = 0;
+        uint32_t barrierBatches = 0;    // vkCmdPipelineBarrier calls per execute()
+        uint32_t imageBarriers = 0;
+        uint32_t memoryBarriers = 0;    // Buffer dependencies, merged
+        VkDeviceSize transientBytes = 0;  // Device memory actually allocated
+        VkDeviceSize unaliasedBytes = 0;  // What one allocation per image would take
+    };
+
+    class PassBuilder {
+    public:
+        // layer: which array layer to attach (attachments of array images)
+        void read(RGResource res, RGAccess access) { add(res, access, false, RG_ALL_LAYERS); }
+        void write(RGResource res, RGAccess access, uint32_t layer = RG_ALL_LAYERS) { add(res, access, true, layer); }
+
+        // Attachments are loaded unless cleared (or discarded on first use)
+        void clearColor(RGResource res, float r = 0.0f, float g = 0.0f, float b = 0.0f, float a = 0.0f) {
+            VkClearValue value{};
+            value.color = {{r, g, b, a}};
+            setClear(res, value);
+        }
+        void clearDepth(RGResource res, float depth = 1.0f) {
+            VkClearValue value{};
+            value.depthStencil = {depth, 0};
+            setClear(res, value);
+        }
+
+        // Never culled (e.g. writes results the graph can't see)
+        void sideEffects() { m_pass.sideEffects = true; }
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, Pass& pass) : m_graph(graph), m_pass(pass) {}
+        void add(RGResource res, RGAccess access, bool write, uint32_t layer);
+        void setClear(RGResource res, const VkClearValue& value);
+
+        RenderGraph& m_graph;
+        Pass& m_pass;
+    };
+
+    struct PassContext {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        VkRenderPass renderPass = VK_NULL_HANDLE;  // Active, if the pass has attachments
+        VkExtent2D extent = {0, 0};                // Attachment size (viewport/scissor are set)
+        const RenderGraph* graph = nullptr;
+
+        VkImage image(RGResource res) const { return graph->getImage(res); }
+        VkImageView view(RGResource res) const { return graph->getImageView(res); }
+        VkBuffer buffer(RGResource res) const { return graph->getBuffer(res); }
+    };
+
+    using SetupFn = std::function<void(PassBuilder&)>;
+    using ExecuteFn = std::function<void(const PassContext&)>;
+
+    explicit RenderGraph(VulkanCore* core) : m_core(core) {}
+    ~RenderGraph() { reset(); }
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // ========================================================================
+    // Declaration
+    // ========================================================================
+
+    RGResource createImage(const std::string& name, const RGImageDesc& desc) {
+        Resource res;
+        res.name = name;
+        res.isImage = true;
+        res.desc = desc;
+        return addResource(res);
+    }
+
+    // An image owned elsewhere. The graph transitions it from `layout`
+    // (written at srcStage/srcAccess) and leaves it in finalLayout.
+    RGResource importImage(const std::string& name, VkImage image, VkImageView view, VkFormat format,
+                           VkExtent2D extent, VkImageLayout layout, VkImageLayout finalLayout,
+                           VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                           VkAccessFlags srcAccess = 0, uint32_t layers = 1) {
+        Resource res;
+        res.name = name;
+        res.isImage = true;
+        res.imported = true;
+        res.desc.width = extent.width;
+        res.desc.height = extent.height;
+        res.desc.format = format;
+        res.desc.layers = layers;
+        res.image = image;
+        res.view = view;
+        res.importLayout = layout;
+        res.finalLayout = finalLayout;
+        res.importStage = srcStage;
+        res.importAccess = srcAccess;
+        return addResource(res);
+    }
+
+    // Transient buffers get their own allocation (not aliased)
+    RGResource createBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage = 0) {
+        Resource res;
+        res.name = name;
+        res.size = size;
+        res.bufferUsage = usage;
+        return addResource(res);
+    }
+
+    RGResource importBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size,
+                            VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            VkAccessFlags srcAccess = 0) {
+        Resource res;
+        res.name = name;
+        res.imported = true;
+        res.buffer = buffer;
+        res.size = size;
+        res.importStage = srcStage;
+        res.importAccess = srcAccess;
+        return addResource(res);
+    }
+
+    // Keeps the passes producing res alive, and leaves it ready for `access`
+    // after the graph (e.g. SampledFragment for VulkanCore's main pass). Not
+    // aliased, since it lives past the graph.
+    void markOutput(RGResource res, RGAccess access) {
+        if (res >= m_resources.size()) return;
+        m_resources[res].output = true;
+        m_resources[res].outputAccess = access;
+    }
+
+    // Passes run in declaration order
+    void addPass(const std::string& name, const SetupFn& setup, ExecuteFn execute) {
+        if (m_compiled) {
+            std::cerr << "[RenderGraph] Pass " << name << " added after compile() - reset() first" << std::endl;
+            return;
+        }
+        Pass pass;
+        pass.name = name;
+        pass.execute = std::move(execute);
+        m_passes.push_back(std::move(pass));
+        PassBuilder builder(*this, m_passes.back());
+        if (setup) setup(builder);
+    }
+
+    // ========================================================================
+    // Compile / Execute
+    // ========================================================================
+
+    bool compile() {
+        if (!m_core || m_core->getDevice() == VK_NULL_HANDLE) return false;
+        destroyCompiled();
+
+        cullPasses();
+        computeLifetimes();
+        if (!createTransients() || !createRenderPasses()) {
+            destroyCompiled();
+            return false;
+        }
+        planBarriers();
+
+        m_compiled = true;
+        std::cout << "[RenderGraph] " << (m_stats.passes - m_stats.passesCulled) << "/" << m_stats.passes
+                  << " passes, " << m_stats.barrierBatches << " barrier batches, transients "
+                  << m_stats.transientBytes / 1024 << " KB (" << m_stats.unaliasedBytes / 1024
+                  << " KB unaliased)" << std::endl;
+        return true;
+    }
+
+    void execute(VkCommandBuffer cmd) {
+        if (!m_compiled || cmd == VK_NULL_HANDLE) return;
+
+        for (const Pass& pass : m_passes) {
+            if (pass.culled) continue;
+            recordBarriers(cmd, pass.barrier);
+
+            PassContext ctx;
+            ctx.cmd = cmd;
+            ctx.graph = this;
+            if (pass.renderPass != VK_NULL_HANDLE) {
+                VkRenderPassBeginInfo rpInfo{};
+                rpInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                rpInfo.renderPass = pass.renderPass;
+                rpInfo.framebuffer = pass.framebuffer;
+                rpInfo.renderArea.extent = pass.extent;
+                rpInfo.clearValueCount = static_cast<uint32_t>(pass.clearValues.size());
+                rpInfo.pClearValues = pass.clearValues.data();
+                vkCmdBeginRenderPass(cmd, &rpInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+                VkViewport viewport{0, 0, (float)pass.extent.width, (float)pass.extent.height, 0, 1};
+                VkRect2D scissor{{0, 0}, pass.extent};
+                vkCmdSetViewport(cmd, 0, 1, &viewport);
+                vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+                ctx.renderPass = pass.renderPass;
+                ctx.extent = pass.extent;
+            }
+
+            if (pass.execute) pass.execute(ctx);
+
+            if (pass.renderPass != VK_NULL_HANDLE) vkCmdEndRenderPass(cmd);
+        }
+        recordBarriers(cmd, m_finalBarrier);
+    }
+
+    // Drops every pass and resource. Compiled objects are destroyed once the
+    // frames in flight that may use them have finished.
+    void reset() {
+        destroyCompiled();
+        m_passes.clear();
+        m_resources.clear();
+    }
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    VkImage getImage(RGResource res) const { return res < m_resources.size() ? m_resources[res].image : VK_NULL_HANDLE; }
+    VkImageView getImageView(RGResource res) const {
+        return res < m_resources.size() ? m_resources[res].view : VK_NULL_HANDLE;
+    }
+    VkBuffer getBuffer(RGResource res) const { return res < m_resources.size() ? m_resources[res].buffer : VK_NULL_HANDLE; }
+
+    // For creating the pipelines a pass draws with (valid after compile())
+    VkRenderPass getRenderPass(const std::string& passName) const {
+        for (const Pass& pass : m_passes) {
+            if (pass.name == passName) return pass.renderPass;
+        }
+        return VK_NULL_HANDLE;
+    }
+
+    bool isCompiled() const { return m_compiled; }
+    bool isPassCulled(const std::string& passName) const {
+        for (const Pass& pass : m_passes) {
+            if (pass.name == passName) return pass.culled;
+        }
+        return true;
+    }
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    struct Use {
+        RGResource res;
+        RGAccess access;
+        bool write;
+        uint32_t layer;
+    };
+
+    struct Barrier {
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        VkAccessFlags memorySrc = 0;  // Buffers, merged into one VkMemoryBarrier
+        VkAccessFlags memoryDst = 0;
+        std::vector<VkImageMemoryBarrier> images;
+        bool empty() const { return srcStages == 0; }
+    };
+
+    struct Pass {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<Use> uses;
+        std::vector<std::pair<RGResource, VkClearValue>> clears;
+        bool sideEffects = false;
+        bool culled = false;
+
+        // Compiled
+        Barrier barrier;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        VkExtent2D extent = {0, 0};
+        std::vector<VkClearValue> clearValues;
+        std::vector<VkImageView> layerViews;  // Owned per-layer attachment views
+    };
+
+    struct Resource {
+        std::string name;
+        bool isImage = false;
+        bool imported = false;
+        bool output = false;
+        RGAccess outputAccess = RGAccess::SampledFragment;
+        RGImageDesc desc;
+        VkDeviceSize size = 0;
+        VkBufferUsageFlags bufferUsage = 0;
+
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        GpuAllocation bufferAlloc;
+        VkImageLayout importLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags importStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags importAccess = 0;
+
+        // Compiled
+        bool live = false;
+        int32_t firstPass = -1;
+        int32_t lastPass = -1;
+        uint32_t block = UINT32_MAX;        // Alias block of a transient image
+        RGResource aliasPrev = RG_INVALID;  // Previous user of that memory (cyclic)
+        VkMemoryRequirements reqs{};
+    };
+
+    struct AliasBlock {
+        GpuAllocation alloc;
+        std::vector<RGResource> users;  // In lifetime order
+    };
+
+    // Synchronization state while replaying the passes
+    struct State {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStages = 0;  // Last write, or a later layout transition
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;   // Reads since then
+        VkPipelineStageFlags visibleStages = 0;  // Already ordered after the write
+        VkAccessFlags visibleAccess = 0;
+    };
+
+    struct AccessInfo {
+        VkPipelineStageFlags stages;
+        VkAccessFlags access;
+        VkImageLayout layout;
+        VkImageUsageFlags imageUsage;
+        VkBufferUsageFlags bufferUsage;
+    };
+
+    static AccessInfo accessInfo(RGAccess access, bool write, bool depthFormat) {
+        switch (access) {
+            case RGAccess::ColorAttachment:
+                return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0};
+            case RGAccess::DepthAttachment:
+                return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0};
+            case RGAccess::DepthRead:
+                return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0};
+            case RGAccess::SampledFragment:
+                return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                        depthFormat ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                                    : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_USAGE_SAMPLED_BIT, 0};
+            case RGAccess::SampledCompute:
+                return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                        depthFormat ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                                    : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_USAGE_SAMPLED_BIT, 0};
+            case RGAccess::StorageRead:
+            case RGAccess::StorageWrite:
+                return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        write ? VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT : VK_ACCESS_SHADER_READ_BIT,
+                        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT};
+            case RGAccess::TransferSrc:
+                return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT};
+            case RGAccess::TransferDst:
+                return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                        VK_BUFFER_USAGE_TRANSFER_DST_BIT};
+            case RGAccess::VertexBuffer:
+                return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+                        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT};
+            case RGAccess::IndexBuffer:
+                return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT,
+                        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDEX_BUFFER_BIT};
+            case RGAccess::IndirectBuffer:
+                return {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT};
+            case RGAccess::UniformBuffer:
+                return {VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_ACCESS_UNIFORM_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT};
+        }
+        return {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, VK_IMAGE_LAYOUT_GENERAL, 0, 0};
+    }
+
+    static bool isDepthFormat(VkFormat format) {
+        return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_D32_SFLOAT ||
+               format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT ||
+               format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D16_UNORM_S8_UINT;
+    }
+
+    static bool isAttachment(RGAccess access) {
+        return access == RGAccess::ColorAttachment || access == RGAccess::DepthAttachment ||
+               access == RGAccess::DepthRead;
+    }
+
+    RGResource addResource(const Resource& res) {
+        if (m_compiled) {
+            std::cerr << "[RenderGraph] " << res.name << " declared after compile() - reset() first" << std::endl;
+            return RG_INVALID;
+        }
+        m_resources.push_back(res);
+        return static_cast<RGResource>(m_resources.size() - 1);
+    }
+
+    AccessInfo accessOf(const Use& use) const {
+        const Resource& res = m_resources[use.res];
+        return accessInfo(use.access, use.write, res.isImage && isDepthFormat(res.desc.format));
+    }
+
+    VkExtent2D extentOf(const Resource& res) const {
+        VkExtent2D extent = {res.desc.width, res.desc.height};
+        if (extent.width == 0) extent.width = m_core->getWidth();
+        if (extent.height == 0) extent.height = m_core->getHeight();
+        return extent;
+    }
+
+    // ------------------------------------------------------------------------
+    // Culling and lifetimes
+    // ------------------------------------------------------------------------
+
+    void cullPasses() {
+        m_stats = Stats{};
+        m_stats.passes = static_cast<uint32_t>(m_passes.size());
+
+        for (Resource& res : m_resources) res.live = res.imported || res.output;
+
+        // Backwards: a pass lives if it writes something live, and then
+        // everything it reads is live too
+        for (size_t p = m_passes.size(); p-- > 0;) {
+            Pass& pass = m_passes[p];
+            bool live = pass.sideEffects;
+            for (const Use& use : pass.uses) {
+                if (use.write && m_resources[use.res].live) live = true;
+            }
+            pass.culled = !live;
+            if (!live) {
+                m_stats.passesCulled++;
+                continue;
+            }
+            for (const Use& use : pass.uses) {
+                m_resources[use.res].live = true;
+            }
+        }
+    }
+
+    void computeLifetimes() {
+        for (Resource& res : m_resources) {
+            res.firstPass = -1;
+            res.lastPass = -1;
+        }
+        for (size_t p = 0; p < m_passes.size(); p++) {
+            if (m_passes[p].culled) continue;
+            for (const Use& use : m_passes[p].uses) {
+                Resource& res = m_resources[use.res];
+                if (res.firstPass < 0) res.firstPass = static_cast<int32_t>(p);
+                res.lastPass = static_cast<int32_t>(p);
+            }
+        }
+        for (Resource& res : m_resources) {
+            if (res.output) res.lastPass = static_cast<int32_t>(m_passes.size());  // Lives past the graph
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Transient resources
+    // ------------------------------------------------------------------------
+
+    bool createTransients() {
+        VkDevice device = m_core->getDevice();
+        GpuAllocator& allocator = m_core->getAllocator();
+
+        // Usage is the union of every declared access
+        std::vector<VkImageUsageFlags> imageUsage(m_resources.size(), 0);
+        std::vector<VkBufferUsageFlags> bufferUsage(m_resources.size(), 0);
+        for (const Pass& pass : m_passes) {
+            if (pass.culled) continue;
+            for (const Use& use : pass.uses) {
+                AccessInfo info = accessOf(use);
+                imageUsage[use.res] |= info.imageUsage;
+                bufferUsage[use.res] |= info.bufferUsage;
+            }
+        }
+        for (RGResource r = 0; r < m_resources.size(); r++) {
+            if (m_resources[r].output) {
+                imageUsage[r] |= accessInfo(m_resources[r].outputAccess, false, false).imageUsage;
+                bufferUsage[r] |= accessInfo(m_resources[r].outputAccess, false, false).bufferUsage;
+            }
+        }
+
+        std::vector<RGResource> aliasable;
+        for (RGResource r = 0; r < m_resources.size(); r++) {
+            Resource& res = m_resources[r];
+            if (res.imported || res.firstPass < 0) continue;
+
+            if (!res.isImage) {
+                if (!allocator.createBuffer(res.size, bufferUsage[r] | res.bufferUsage,
+                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, res.buffer, res.bufferAlloc)) {
+                    std::cerr << "[RenderGraph] Failed to create buffer " << res.name << std::endl;
+                    return false;
+                }
+                m_stats.transientBytes += res.size;
+                m_stats.unaliasedBytes += res.size;
+                continue;
+            }
+
+            VkExtent2D extent = extentOf(res);
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = res.desc.format;
+            imageInfo.extent = {extent.width, extent.height, 1};
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = std::max(res.desc.layers, 1u);
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = imageUsage[r] | res.desc.extraUsage;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            if (vkCreateImage(device, &imageInfo, nullptr, &res.image) != VK_SUCCESS) {
+                std::cerr << "[RenderGraph] Failed to create image " << res.name << std::endl;
+                return false;
+            }
+            vkGetImageMemoryRequirements(device, res.image, &res.reqs);
+            m_stats.unaliasedBytes += res.reqs.size;
+            aliasable.push_back(r);
+        }
+
+        // Largest first into the first block whose users are all done (or
+        // not yet started) and whose memory types fit
+        std::sort(aliasable.begin(), aliasable.end(), [&](RGResource a, RGResource b) {
+            return m_resources[a].reqs.size > m_resources[b].reqs.size;
+        });
+        std::vector<VkMemoryRequirements> blockReqs;
+        for (RGResource r : aliasable) {
+            Resource& res = m_resources[r];
+            uint32_t chosen = UINT32_MAX;
+            for (uint32_t b = 0; b < m_blocks.size() && chosen == UINT32_MAX; b++) {
+                if (res.output || (blockReqs[b].memoryTypeBits & res.reqs.memoryTypeBits) == 0) continue;
+                bool overlaps = false;
+                for (RGResource other : m_blocks[b].users) {
+                    const Resource& o = m_resources[other];
+                    if (o.output || !(res.lastPass < o.firstPass || o.lastPass < res.firstPass)) overlaps = true;
+                }
+                if (!overlaps) chosen = b;
+            }
+            if (chosen == UINT32_MAX) {
+                chosen = static_cast<uint32_t>(m_blocks.size());
+                m_blocks.emplace_back();
+                blockReqs.push_back(res.reqs);
+            }
+            VkMemoryRequirements& reqs = blockReqs[chosen];
+            reqs.size = std::max(reqs.size, res.reqs.size);
+            reqs.alignment = std::max(reqs.alignment, res.reqs.alignment);
+            reqs.memoryTypeBits &= res.reqs.memoryTypeBits;
+            m_blocks[chosen].users.push_back(r);
+            res.block = chosen;
+        }
+
+        for (uint32_t b = 0; b < m_blocks.size(); b++) {
+            AliasBlock& block = m_blocks[b];
+            block.alloc = allocator.allocate(blockReqs[b], VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, GpuAllocKind::IMAGE);
+            if (!block.alloc.isValid()) {
+                std::cerr << "[RenderGraph] Failed to allocate " << blockReqs[b].size << " bytes of transients"
+                          << std::endl;
+                return false;
+            }
+            m_stats.transientBytes += blockReqs[b].size;
+
+            std::sort(block.users.begin(), block.users.end(), [&](RGResource a, RGResource c) {
+                return m_resources[a].firstPass < m_resources[c].firstPass;
+            });
+            for (size_t i = 0; i < block.users.size(); i++) {
+                Resource& res = m_resources[block.users[i]];
+                res.aliasPrev = block.users[(i + block.users.size() - 1) % block.users.size()];
+                vkBindImageMemory(device, res.image, block.alloc.memory, block.alloc.offset);
+                res.view = createView(res, RG_ALL_LAYERS);
+                if (res.view == VK_NULL_HANDLE) return false;
+            }
+        }
+        return true;
+    }
+
+    VkImageView createView(const Resource& res, uint32_t layer) {
+        bool depth = isDepthFormat(res.desc.format);
+        bool array = layer == RG_ALL_LAYERS && res.desc.layers > 1;
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = res.image;
+        viewInfo.viewType = array ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = res.desc.format;
+        viewInfo.subresourceRange.aspectMask = depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = layer == RG_ALL_LAYERS ? 0 : layer;
+        viewInfo.subresourceRange.layerCount = array ? res.desc.layers : 1;
+
+        VkImageView view = VK_NULL_HANDLE;
+        if (vkCreateImageView(m_core->getDevice(), &viewInfo, nullptr, &view) != VK_SUCCESS) {
+            std::cerr << "[RenderGraph] Failed to create view of " << res.name << std::endl;
+            return VK_NULL_HANDLE;
+        }
+        return view;
+    }
+
+    // ------------------------------------------------------------------------
+    // Render passes
+    // ------------------------------------------------------------------------
+
+    // Layouts are handled by the graph's barriers, so every attachment
+    // starts and ends in its attachment layout and needs no subpass
+    // dependencies
+    bool createRenderPasses() {
+        VkDevice device = m_core->getDevice();
+
+        for (size_t p = 0; p < m_passes.size(); p++) {
+            Pass& pass = m_passes[p];
+            if (pass.culled) continue;
+
+            std::vector<VkAttachmentDescription> attachments;
+            std::vector<VkAttachmentReference> colorRefs;
+            VkAttachmentReference depthRef{VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED};
+            std::vector<VkImageView> views;
+            pass.extent = {UINT32_MAX, UINT32_MAX};
+
+            for (const Use& use : pass.uses) {
+                if (!isAttachment(use.access)) continue;
+                Resource& res = m_resources[use.res];
+                if (!res.isImage) continue;
+                AccessInfo info = accessOf(use);
+
+                const VkClearValue* clear = nullptr;
+                for (const auto& c : pass.clears) {
+                    if (c.first == use.res) clear = &c.second;
+                }
+                // Nothing to keep on a transient's first use
+                bool discard = !res.imported && res.firstPass == static_cast<int32_t>(p);
+                bool keep = res.imported || res.output || res.lastPass > static_cast<int32_t>(p);
+
+                VkAttachmentDescription desc{};
+                desc.format = res.desc.format;
+                desc.samples = VK_SAMPLE_COUNT_1_BIT;
+                desc.loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR
+                                    : (discard ? VK_ATTACHMENT_LOAD_OP_DONT_CARE : VK_ATTACHMENT_LOAD_OP_LOAD);
+                // Read-only attachments keep their contents either way
+                desc.storeOp = (keep || !use.write) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                desc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                desc.initialLayout = info.layout;
+                desc.finalLayout = info.layout;
+
+                VkAttachmentReference ref{static_cast<uint32_t>(attachments.size()), info.layout};
+                if (use.access == RGAccess::ColorAttachment) {
+                    colorRefs.push_back(ref);
+                } else {
+                    depthRef = ref;
+                }
+                attachments.push_back(desc);
+
+                VkClearValue clearValue = clear ? *clear : VkClearValue{};
+                pass.clearValues.push_back(clearValue);
+
+                VkImageView view = res.view;
+                if (res.desc.layers > 1) {
+                    view = createView(res, use.layer == RG_ALL_LAYERS ? 0 : use.layer);
+                    if (view == VK_NULL_HANDLE) return false;
+                    pass.layerViews.push_back(view);
+                }
+                views.push_back(view);
+
+                VkExtent2D extent = extentOf(res);
+                pass.extent.width = std::min(pass.extent.width, extent.width);
+                pass.extent.height = std::min(pass.extent.height, extent.height);
+            }
+            if (attachments.empty()) {
+                pass.extent = {0, 0};
+                pass.clearValues.clear();
+                continue;
+            }
+
+            VkSubpassDescription subpass{};
+            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.colorAttachmentCount = static_cast<uint32_t>(colorRefs.size());
+            subpass.pColorAttachments = colorRefs.data();
+            subpass.pDepthStencilAttachment = depthRef.attachment != VK_ATTACHMENT_UNUSED ? &depthRef : nullptr;
+
+            VkRenderPassCreateInfo rpInfo{};
+            rpInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            rpInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+            rpInfo.pAttachments = attachments.data();
+            rpInfo.subpassCount = 1;
+            rpInfo.pSubpasses = &subpass;
+            if (vkCreateRenderPass(device, &rpInfo, nullptr, &pass.renderPass) != VK_SUCCESS) {
+                std::cerr << "[RenderGraph] Failed to create render pass for " << pass.name << std::endl;
+                return false;
+            }
+
+            VkFramebufferCreateInfo fbInfo{};
+            fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            fbInfo.renderPass = pass.renderPass;
+            fbInfo.attachmentCount = static_cast<uint32_t>(views.size());
+            fbInfo.pAttachments = views.data();
+            fbInfo.width = pass.extent.width;
+            fbInfo.height = pass.extent.height;
+            fbInfo.layers = 1;
+            if (vkCreateFramebuffer(device, &fbInfo, nullptr, &pass.framebuffer) != VK_SUCCESS) {
+                std::cerr << "[RenderGraph] Failed to create framebuffer for " << pass.name << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // Barrier planning
+    // ------------------------------------------------------------------------
+
+    // Adds what `info` needs after `state` to `barrier`, then advances state
+    void transition(Barrier& barrier, const Resource& res, State& state, const AccessInfo& info, bool write,
+                    bool discard) {
+        VkImageLayout layout = res.isImage ? info.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+        bool layoutChange = res.isImage && layout != state.layout;
+
+        bool needed;
+        VkPipelineStageFlags src;
+        VkAccessFlags srcAccess = state.writeAccess;
+        if (write || layoutChange) {
+            // Execution dependency on every earlier access (WAR + WAW)
+            src = state.writeStages | state.readStages;
+            needed = src != 0 || layoutChange;
+        } else {
+            // Read: only if the last write isn't visible to this stage yet
+            src = state.writeStages;
+            needed = src != 0 && ((state.visibleStages & info.stages) != info.stages ||
+                                  (state.visibleAccess & info.access) != info.access);
+        }
+
+        if (needed) {
+            if (src == 0) src = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            barrier.srcStages |= src;
+            barrier.dstStages |= info.stages;
+            if (res.isImage) {
+                VkImageMemoryBarrier imageBarrier{};
+                imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                imageBarrier.srcAccessMask = srcAccess;
+                imageBarrier.dstAccessMask = info.access;
+                imageBarrier.oldLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+                imageBarrier.newLayout = layout;
+                imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.image = res.image;
+                imageBarrier.subresourceRange.aspectMask =
+                    isDepthFormat(res.desc.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+                imageBarrier.subresourceRange.levelCount = 1;
+                imageBarrier.subresourceRange.layerCount = std::max(res.desc.layers, 1u);
+                barrier.images.push_back(imageBarrier);
+            } else {
+                barrier.memorySrc |= srcAccess;
+                barrier.memoryDst |= info.access;
+            }
+        }
+
+        if (write) {
+            state.writeStages = info.stages;
+            state.writeAccess = info.access;
+            state.readStages = 0;
+            state.visibleStages = 0;
+            state.visibleAccess = 0;
+        } else if (layoutChange) {
+            // The transition is a write, visible to this access only
+            state.writeStages = info.stages;
+            state.writeAccess = 0;
+            state.readStages = info.stages;
+            state.visibleStages = info.stages;
+            state.visibleAccess = info.access;
+        } else {
+            state.readStages |= info.stages;
+            if (needed) {
+                state.visibleStages |= info.stages;
+                state.visibleAccess |= info.access;
+            }
+        }
+        if (res.isImage) state.layout = layout;
+    }
+
+    // A read plus the same-layout reads up to the next write: one barrier
+    // then serves them all and later passes' reads need none
+    AccessInfo readRun(size_t passIndex, const Use& use) const {
+        AccessInfo info = accessOf(use);
+        for (size_t p = passIndex + 1; p < m_passes.size(); p++) {
+            if (m_passes[p].culled) continue;
+            for (const Use& later : m_passes[p].uses) {
+                if (later.res != use.res) continue;
+                AccessInfo next = accessOf(later);
+                if (later.write || next.layout != info.layout) return info;
+                info.stages |= next.stages;
+                info.access |= next.access;
+            }
+        }
+        return info;
+    }
+
+    State initialState(RGResource r, const std::vector<State>& finalStates) const {
+        const Resource& res = m_resources[r];
+        State state;
+        if (res.imported) {
+            state.layout = res.importLayout;
+            state.writeStages = res.importStage;
+            state.writeAccess = res.importAccess;
+            return state;
+        }
+        // Transients: wait for the previous user of the memory - an earlier
+        // alias this frame, or the last one of the previous frame
+        RGResource prev = res.isImage && res.aliasPrev != RG_INVALID ? res.aliasPrev : r;
+        state.writeStages = finalStates[prev].writeStages | finalStates[prev].readStages;
+        state.writeAccess = finalStates[prev].writeAccess;
+        state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        return state;
+    }
+
+    // Replays the frame twice: the first run yields every resource's final
+    // state, which seeds the transients' state for the real run
+    void planBarriers() {
+        std::vector<State> finalStates(m_resources.size());
+        for (int run = 0; run < 2; run++) {
+            std::vector<State> states(m_resources.size());
+            std::vector<bool> started(m_resources.size(), false);
+            m_finalBarrier = Barrier{};
+
+            for (size_t p = 0; p < m_passes.size(); p++) {
+                Pass& pass = m_passes[p];
+                if (pass.culled) continue;
+                pass.barrier = Barrier{};
+                for (const Use& use : pass.uses) {
+                    const Resource& res = m_resources[use.res];
+                    bool first = !started[use.res];
+                    if (first) {
+                        states[use.res] = initialState(use.res, finalStates);
+                        started[use.res] = true;
+                    }
+                    AccessInfo info = use.write ? accessOf(use) : readRun(p, use);
+                    transition(pass.barrier, res, states[use.res], info, use.write, first && !res.imported);
+                }
+            }
+
+            // Outputs and imports end where the rest of the frame expects them
+            for (RGResource r = 0; r < m_resources.size(); r++) {
+                const Resource& res = m_resources[r];
+                if (!started[r]) continue;
+                if (res.output) {
+                    transition(m_finalBarrier, res, states[r],
+                               accessInfo(res.outputAccess, false, res.isImage && isDepthFormat(res.desc.format)),
+                               false, false);
+                } else if (res.imported && res.isImage && res.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                           res.finalLayout != states[r].layout) {
+                    AccessInfo info{VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, res.finalLayout, 0, 0};
+                    transition(m_finalBarrier, res, states[r], info, false, false);
+                }
+            }
+            finalStates = states;
+        }
+
+        for (const Pass& pass : m_passes) {
+            if (pass.culled || pass.barrier.empty()) continue;
+            m_stats.barrierBatches++;
+            m_stats.imageBarriers += static_cast<uint32_t>(pass.barrier.images.size());
+            if (pass.barrier.memoryDst) m_stats.memoryBarriers++;
+        }
+        if (!m_finalBarrier.empty()) m_stats.barrierBatches++;
+    }
+
+    static void recordBarriers(VkCommandBuffer cmd, const Barrier& barrier) {
+        if (barrier.empty()) return;
+        VkMemoryBarrier memory{};
+        memory.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory.srcAccessMask = barrier.memorySrc;
+        memory.dstAccessMask = barrier.memoryDst;
+        bool hasMemory = barrier.memoryDst != 0 || barrier.memorySrc != 0;
+        vkCmdPipelineBarrier(cmd, barrier.srcStages, barrier.dstStages, 0,
+                             hasMemory ? 1 : 0, hasMemory ? &memory : nullptr, 0, nullptr,
+                             static_cast<uint32_t>(barrier.images.size()), barrier.images.data());
+    }
+
+    // ------------------------------------------------------------------------
+    // Teardown
+    // ------------------------------------------------------------------------
+
+    void destroyCompiled() {
+        if (!m_core) return;
+
+        // Collect the Vulkan objects, then hand them to the core's deletion
+        // queue: the last frames that recorded this graph may be in flight
+        struct Garbage {
+            std::vector<VkRenderPass> renderPasses;
+            std::vector<VkFramebuffer> framebuffers;
+            std::vector<VkImageView> views;
+            std::vector<VkImage> images;
+            std::vector<std::pair<VkBuffer, GpuAllocation>> buffers;
+            std::vector<GpuAllocation> memory;
+        };
+        Garbage garbage;
+
+        for (Pass& pass : m_passes) {
+            if (pass.framebuffer) garbage.framebuffers.push_back(pass.framebuffer);
+            if (pass.renderPass) garbage.renderPasses.push_back(pass.renderPass);
+            garbage.views.insert(garbage.views.end(), pass.layerViews.begin(), pass.layerViews.end());
+            pass.framebuffer = VK_NULL_HANDLE;
+            pass.renderPass = VK_NULL_HANDLE;
+            pass.layerViews.clear();
+            pass.clearValues.clear();
+            pass.barrier = Barrier{};
+        }
+        for (Resource& res : m_resources) {
+            if (res.imported) continue;
+            if (res.view) garbage.views.push_back(res.view);
+            if (res.image) garbage.images.push_back(res.image);
+            if (res.buffer) garbage.buffers.push_back({res.buffer, res.bufferAlloc});
+            res.view = VK_NULL_HANDLE;
+            res.image = VK_NULL_HANDLE;
+            res.buffer = VK_NULL_HANDLE;
+            res.bufferAlloc = GpuAllocation{};
+            res.block = UINT32_MAX;
+            res.aliasPrev = RG_INVALID;
+        }
+        for (AliasBlock& block : m_blocks) garbage.memory.push_back(block.alloc);
+        m_blocks.clear();
+        m_finalBarrier = Barrier{};
+        m_compiled = false;
+
+        if (garbage.renderPasses.empty() && garbage.views.empty() && garbage.images.empty() &&
+            garbage.buffers.empty() && garbage.memory.empty()) {
+            return;
+        }
+        VulkanCore* core = m_core;
+        core->deferDestroy([core, garbage]() mutable {
+            VkDevice device = core->getDevice();
+            for (VkFramebuffer fb : garbage.framebuffers) vkDestroyFramebuffer(device, fb, nullptr);
+            for (VkRenderPass rp : garbage.renderPasses) vkDestroyRenderPass(device, rp, nullptr);
+            for (VkImageView view : garbage.views) vkDestroyImageView(device, view, nullptr);
+            for (VkImage image : garbage.images) vkDestroyImage(device, image, nullptr);
+            for (auto& buffer : garbage.buffers) core->getAllocator().destroyBuffer(buffer.first, buffer.second);
+            for (GpuAllocation& alloc : garbage.memory) core->getAllocator().free(alloc);
+        });
+    }
+
+    VulkanCore* m_core = nullptr;
+    std::vector<Pass> m_passes;
+    std::vector<Resource> m_resources;
+    std::vector<AliasBlock> m_blocks;
+    Barrier m_finalBarrier;
+    bool m_compiled = false;
+    Stats m_stats;
+};
+
+// ============================================================================
+// PassBuilder
+// ============================================================================
+
+inline void RenderGraph::PassBuilder::add(RGResource res, RGAccess access, bool write, uint32_t layer) {
+    if (res >= m_graph.m_resources.size()) return;
+    // Attachment writes load the old contents unless cleared, and read-only
+    // depth counts as a read
+    if (access == RGAccess::DepthRead) write = false;
+    if (access == RGAccess::StorageWrite || access == RGAccess::TransferDst ||
+        access == RGAccess::ColorAttachment || access == RGAccess::DepthAttachment) {
+        write = true;
+    }
+    for (const Use& use : m_pass.uses) {
+        if (use.res == res) {
+            std::cerr << "[RenderGraph] " << m_pass.name << " uses " << m_graph.m_resources[res].name
+                      << " twice - declare one access" << std::endl;
+            return;
+        }
+    }
+    m_pass.uses.push_back({res, access, write, layer});
+}
+
+inline void RenderGraph::PassBuilder::setClear(RGResource res, const VkClearValue& value) {
+    for (auto& clear : m_pass.clears) {
+        if (clear.first == res) {
+            clear.second = value;
+            return;
+        }
+    }
+    m_pass.clears.push_back({res, value});
+}
+
+} // namespace vkcore
+
+#endif // VKCORE_RENDER_GRAPH_H
@@ -0,0 +1,523 @@
+// ============================================================================
+// SHADER COMPILER - GLSL -> SPIR-V at runtime, cached by content
+// ============================================================================
+// Shader hot-reload used to read whatever .spv an external glslc run left
+// behind and rebuild pipelines on the render thread. ShaderCompiler compiles
+// the GLSL source itself and keeps the results:
+//
+//   - In process through shaderc when built with VKCORE_SHADERC (link
+//     shaderc_shared from the Vulkan SDK); otherwise it runs glslc from
+//     VULKAN_SDK/bin or PATH. Either way on the calling thread - use
+//     compileAsync() to keep it off the frame.
+//   - The cache key hashes the source, every file it #includes (quoted
+//     includes, resolved next to the including file), the stage and the
+//     defines. A hit in memory or in the cache directory skips the
+//     compiler, so reverting an edit or reloading an unchanged variant
+//     costs a file read.
+//   - Cache files are raw SPIR-V named by the key, written to a temp file
+//     and renamed, so a crash mid-write never leaves a corrupt entry.
+//
+// compileAsync() queues compiles on one worker thread. The job's onWorker
+// callback runs on that thread once every source compiled - the place to
+// create shader modules and build pipelines through the shared
+// PipelineCache, so the render thread only swaps handles when ready().
+//
+// Header-only, like pipeline_cache.h.
+//
+// Usage:
+//   std::vector<uint32_t> spirv;
+//   std::string error;
+//   if (ShaderCompiler::shared().compile({"shaders/mesh.frag"}, spirv, &error)) { ... }
+//
+//   auto job = ShaderCompiler::shared().compileAsync({{"mesh.vert"}, {"mesh.frag"}},
+//       [&](ShaderCompiler::Job& job) { buildPipeline(job.spirv[0], job.spirv[1]); });
+//   // each frame:
+//   if (job && job->ready()) { swapPipeline(); job.reset(); }
+// ============================================================================
+
+#ifndef VKCORE_SHADER_COMPILER_H
+#define VKCORE_SHADER_COMPILER_H
+
+#include <vulkan/vulkan.h>
+
+#ifdef VKCORE_SHADERC
+#include <shaderc/shaderc.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace vkcore {
+
+// One GLSL file to compile
+struct ShaderSource {
+    std::string path;
+    VkShaderStageFlagBits stage = VkShaderStageFlagBits(0);  // 0 = from the extension
+    std::vector<std::string> defines;                        // "NAME" or "NAME=VALUE"
+
+    ShaderSource() = default;
+    ShaderSource(const char* path) : path(path) {}
+    ShaderSource(std::string path, VkShaderStageFlagBits stage = VkShaderStageFlagBits(0),
+                 std::vector<std::string> defines = {})
+        : path(std::move(path)), stage(stage), defines(std::move(defines)) {}
+};
+
+class ShaderCompiler {
+public:
+    // An asynchronous compile. Fields are written by the worker and may be
+    // read once ready() returns true.
+    struct Job {
+        std::vector<ShaderSource> sources;
+        std::vector<std::vector<uint32_t>> spirv;  // One per source, if ok
+        bool ok = false;
+        std::string error;                         // First failure
+        double milliseconds = 0.0;                 // Compile + onWorker
+        std::function<void(Job&)> onWorker;        // Runs on the worker if all compiled
+
+        bool ready() const { return m_done.load(std::memory_order_acquire); }
+
+    private:
+        friend class ShaderCompiler;
+        std::atomic<bool> m_done{false};
+    };
+
+    struct Stats {
+        uint32_t memoryHits = 0;
+        uint32_t diskHits = 0;
+        uint32_t compiled = 0;
+        uint32_t failed = 0;
+    };
+
+    ShaderCompiler() = default;
+    ~ShaderCompiler() { stopWorker(); }
+
+    ShaderCompiler(const ShaderCompiler&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+    // Process-wide compiler (hot-reload in the EDEN helpers, MeshRenderer)
+    static ShaderCompiler& shared() {
+        static ShaderCompiler s_shared;
+        return s_shared;
+    }
+
+    // Where cache files live (default "shader_cache"; created on first write)
+    void setCacheDirectory(const std::string& directory) {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_cacheDirectory = directory;
+    }
+
+    // Stage from a .vert/.frag/.comp/.geom extension (also name.vert.glsl), 0 if unknown
+    static VkShaderStageFlagBits stageFromPath(const std::string& path) {
+        std::string name = path;
+        if (endsWith(name, ".glsl")) name.resize(name.size() - 5);
+        if (endsWith(name, ".vert")) return VK_SHADER_STAGE_VERTEX_BIT;
+        if (endsWith(name, ".frag")) return VK_SHADER_STAGE_FRAGMENT_BIT;
+        if (endsWith(name, ".comp")) return VK_SHADER_STAGE_COMPUTE_BIT;
+        if (endsWith(name, ".geom")) return VK_SHADER_STAGE_GEOMETRY_BIT;
+        return VkShaderStageFlagBits(0);
+    }
+
+    // ========================================================================
+    // Compiling
+    // ========================================================================
+
+    // Compile (or fetch from the cache) one source. Thread-safe.
+    bool compile(const ShaderSource& source, std::vector<uint32_t>& spirv, std::string* error = nullptr) {
+        VkShaderStageFlagBits stage = source.stage ? source.stage : stageFromPath(source.path);
+        if (!stage) return fail(error, source.path + ": unknown shader stage");
+
+        SourceFiles files;
+        if (!gatherFiles(source.path, files, 0)) return fail(error, "Cannot read " + source.path);
+        uint64_t key = cacheKey(files, stage, source.defines);
+
+        std::string cachePath;
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            auto it = m_memory.find(key);
+            if (it != m_memory.end()) {
+                spirv = it->second;
+                m_stats.memoryHits++;
+                return true;
+            }
+            cachePath = cacheFilePath(key);
+        }
+
+        if (readSpirv(cachePath, spirv)) {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_memory[key] = spirv;
+            m_stats.diskHits++;
+            return true;
+        }
+
+        std::string message;
+        if (!compileSource(source.path, stage, source.defines, files, cachePath, spirv, message)) {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_stats.failed++;
+            return fail(error, message);
+        }
+
+        writeSpirv(cachePath, spirv);
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_memory[key] = spirv;
+        m_stats.compiled++;
+        return true;
+    }
+
+    // Queue sources for the worker thread. onWorker runs there after all of
+    // them compiled (not on failure); ready() turns true after it returns.
+    std::shared_ptr<Job> compileAsync(std::vector<ShaderSource> sources,
+                                      std::function<void(Job&)> onWorker = nullptr) {
+        auto job = std::make_shared<Job>();
+        job->sources = std::move(sources);
+        job->onWorker = std::move(onWorker);
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            if (!m_worker.joinable()) {
+                m_stopWorker = false;
+                m_worker = std::thread([this]() { workerLoop(); });
+            }
+            m_queue.push_back(job);
+        }
+        m_queueCv.notify_one();
+        return job;
+    }
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        return m_stats;
+    }
+
+private:
+    static constexpr uint32_t CACHE_VERSION = 1;
+    static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+    static constexpr uint32_t MAX_INCLUDE_DEPTH = 16;
+
+    // Source text of a shader and of everything it includes, main file first
+    struct SourceFiles {
+        std::vector<std::pair<std::string, std::string>> files;  // path, text
+        std::unordered_set<std::string> seen;
+
+        const std::string* find(const std::string& path) const {
+            for (const auto& file : files) {
+                if (file.first == path) return &file.second;
+            }
+            return nullptr;
+        }
+    };
+
+    static bool endsWith(const std::string& str, const char* suffix) {
+        size_t length = strlen(suffix);
+        return str.size() >= length && str.compare(str.size() - length, length, suffix) == 0;
+    }
+
+    static bool fail(std::string* error, const std::string& message) {
+        if (error) *error = message;
+        return false;
+    }
+
+    static bool readText(const std::string& path, std::string& text) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        text = contents.str();
+        return true;
+    }
+
+    // Directory part of a path, with its trailing separator ("" if none)
+    static std::string directoryOf(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    // Include path a source line names with #include "name", or ""
+    static std::string includeName(const std::string& line) {
+        size_t at = line.find_first_not_of(" \t");
+        if (at == std::string::npos || line.compare(at, 8, "#include") != 0) return {};
+        size_t open = line.find('"', at + 8);
+        size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos) return {};
+        return line.substr(open + 1, close - open - 1);
+    }
+
+    // Read path and, recursively, its quoted includes. Missing includes are
+    // left for the compiler to report.
+    static bool gatherFiles(const std::string& path, SourceFiles& files, uint32_t depth) {
+        if (depth > MAX_INCLUDE_DEPTH || !files.seen.insert(path).second) return true;
+        std::string text;
+        if (!readText(path, text)) return depth > 0;
+        files.files.emplace_back(path, text);
+
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::string name = includeName(line);
+            if (!name.empty()) gatherFiles(directoryOf(path) + name, files, depth + 1);
+        }
+        return true;
+    }
+
+    static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;  // FNV-1a
+        }
+        return hash;
+    }
+
+    static uint64_t hashString(uint64_t hash, const std::string& str) {
+        uint64_t length = str.size();
+        hash = hashBytes(hash, &length, sizeof(length));
+        return hashBytes(hash, str.data(), str.size());
+    }
+
+    static uint64_t cacheKey(const SourceFiles& files, VkShaderStageFlagBits stage,
+                             const std::vector<std::string>& defines) {
+        uint64_t hash = 14695981039346656037ull;
+        uint32_t header[2] = {CACHE_VERSION, uint32_t(stage)};
+        hash = hashBytes(hash, header, sizeof(header));
+        for (const std::string& define : defines) hash = hashString(hash, define);
+        // Include paths are hashed relative to the main file, so a moved
+        // project keeps its cache
+        std::string root = directoryOf(files.files.front().first);
+        for (size_t i = 0; i < files.files.size(); i++) {
+            const std::string& path = files.files[i].first;
+            if (i > 0) hash = hashString(hash, path.compare(0, root.size(), root) == 0 ? path.substr(root.size()) : path);
+            hash = hashString(hash, files.files[i].second);
+        }
+        return hash;
+    }
+
+    std::string cacheFilePath(uint64_t key) const {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(key));
+        return m_cacheDirectory.empty() ? std::string(name) : m_cacheDirectory + "/" + name;
+    }
+
+    static bool readSpirv(const std::string& path, std::vector<uint32_t>& spirv) {
+        std::string bytes;
+        if (!readText(path, bytes) || bytes.size() < 20 || bytes.size() % 4 != 0) return false;
+        uint32_t magic = 0;
+        memcpy(&magic, bytes.data(), sizeof(magic));
+        if (magic != SPIRV_MAGIC) return false;
+        spirv.resize(bytes.size() / 4);
+        memcpy(spirv.data(), bytes.data(), bytes.size());
+        return true;
+    }
+
+    // Create the directory a cache file goes in (one level, like the default)
+    static void makeDirectoryFor(const std::string& path) {
+        std::string directory = directoryOf(path);
+        if (directory.empty()) return;
+#ifdef _WIN32
+        _mkdir(directory.c_str());
+#else
+        mkdir(directory.c_str(), 0755);
+#endif
+    }
+
+    static void writeSpirv(const std::string& path, const std::vector<uint32_t>& spirv) {
+        makeDirectoryFor(path);
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file) return;  // Cache is an optimization - stay quiet
+            file.write(reinterpret_cast<const char*>(spirv.data()),
+                       static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+            if (!file) return;
+        }
+        std::remove(path.c_str());  // rename() won't replace on Windows
+        std::rename(tmpPath.c_str(), path.c_str());
+    }
+
+#ifdef VKCORE_SHADERC
+    // Include results point into the SourceFiles gathered for hashing, so
+    // the compiler sees exactly the text the key was made from
+    struct IncludeContext {
+        const SourceFiles* files;
+    };
+
+    struct IncludeResult {
+        shaderc_include_result result{};
+        std::string name;
+        std::string text;
+    };
+
+    static shaderc_include_result* resolveInclude(void* user, const char* requested, int type,
+                                                  const char* requesting, size_t /*depth*/) {
+        IncludeContext* context = static_cast<IncludeContext*>(user);
+        IncludeResult* include = new IncludeResult();
+        include->name = type == shaderc_include_type_relative ? directoryOf(requesting) + requested : requested;
+        const std::string* text = context->files->find(include->name);
+        if (text) {
+            include->text = *text;
+        } else if (!readText(include->name, include->text)) {
+            // An empty name tells shaderc the include failed; content is the message
+            include->text = "Cannot open " + include->name;
+            include->name.clear();
+        }
+        include->result.source_name = include->name.c_str();
+        include->result.source_name_length = include->name.size();
+        include->result.content = include->text.c_str();
+        include->result.content_length = include->text.size();
+        include->result.user_data = include;
+        return &include->result;
+    }
+
+    static void releaseInclude(void* /*user*/, shaderc_include_result* result) {
+        delete static_cast<IncludeResult*>(result->user_data);
+    }
+
+    static bool compileSource(const std::string& path, VkShaderStageFlagBits stage,
+                              const std::vector<std::string>& defines, const SourceFiles& files,
+                              const std::string& /*cachePath*/, std::vector<uint32_t>& spirv,
+                              std::string& error) {
+        shaderc_shader_kind kind = stage == VK_SHADER_STAGE_VERTEX_BIT   ? shaderc_vertex_shader
+                                 : stage == VK_SHADER_STAGE_FRAGMENT_BIT ? shaderc_fragment_shader
+                                 : stage == VK_SHADER_STAGE_COMPUTE_BIT  ? shaderc_compute_shader
+                                                                         : shaderc_geometry_shader;
+
+        shaderc_compiler_t compiler = shaderc_compiler_initialize();
+        shaderc_compile_options_t options = shaderc_compile_options_initialize();
+        for (const std::string& define : defines) {
+            size_t equals = define.find('=');
+            size_t nameLength = equals == std::string::npos ? define.size() : equals;
+            const char* value = equals == std::string::npos ? "" : define.c_str() + equals + 1;
+            shaderc_compile_options_add_macro_definition(options, define.c_str(), nameLength, value, strlen(value));
+        }
+        IncludeContext context{&files};
+        shaderc_compile_options_set_include_callbacks(options, resolveInclude, releaseInclude, &context);
+
+        const std::string& text = files.files.front().second;
+        shaderc_compilation_result_t result =
+            shaderc_compile_into_spv(compiler, text.data(), text.size(), kind, path.c_str(), "main", options);
+
+        bool ok = shaderc_result_get_compilation_status(result) == shaderc_compilation_status_success;
+        if (ok) {
+            size_t size = shaderc_result_get_length(result);
+            spirv.resize(size / 4);
+            memcpy(spirv.data(), shaderc_result_get_bytes(result), size);
+        } else {
+            error = shaderc_result_get_error_message(result);
+        }
+
+        shaderc_result_release(result);
+        shaderc_compile_options_release(options);
+        shaderc_compiler_release(compiler);
+        return ok;
+    }
+#else
+    // glslc from the Vulkan SDK or PATH, writing next to the cache entry
+    static bool compileSource(const std::string& path, VkShaderStageFlagBits stage,
+                              const std::vector<std::string>& defines, const SourceFiles& /*files*/,
+                              const std::string& cachePath, std::vector<uint32_t>& spirv,
+                              std::string& error) {
+        const char* stageName = stage == VK_SHADER_STAGE_VERTEX_BIT   ? "vert"
+                              : stage == VK_SHADER_STAGE_FRAGMENT_BIT ? "frag"
+                              : stage == VK_SHADER_STAGE_COMPUTE_BIT  ? "comp"
+                                                                      : "geom";
+        std::string glslc = "glslc";
+        if (const char* sdk = std::getenv("VULKAN_SDK")) {
+#ifdef _WIN32
+            glslc = "\"" + std::string(sdk) + "\\Bin\\glslc.exe\"";
+#else
+            glslc = "\"" + std::string(sdk) + "/bin/glslc\"";
+#endif
+        }
+
+        std::string outPath = cachePath + ".out";
+        std::string logPath = cachePath + ".log";
+        makeDirectoryFor(cachePath);
+
+        std::string command = glslc + " -fshader-stage=" + stageName;
+        for (const std::string& define : defines) command += " \"-D" + define + "\"";
+        command += " \"" + path + "\" -o \"" + outPath + "\" 2> \"" + logPath + "\"";
+#ifdef _WIN32
+        command = "\"" + command + "\"";  // cmd /c strips one pair of outer quotes
+#endif
+        int status = std::system(command.c_str());
+
+        bool ok = status == 0 && readSpirv(outPath, spirv);
+        if (!ok) {
+            readText(logPath, error);
+            if (error.empty()) error = "glslc failed for " + path + " (exit " + std::to_string(status) + ")";
+        }
+        std::remove(outPath.c_str());
+        std::remove(logPath.c_str());
+        return ok;
+    }
+#endif
+
+    void workerLoop() {
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(m_queueMutex);
+                m_queueCv.wait(lock, [this]() { return m_stopWorker || !m_queue.empty(); });
+                if (m_queue.empty()) return;
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            job->spirv.resize(job->sources.size());
+            job->ok = true;
+            for (size_t i = 0; i < job->sources.size() && job->ok; i++) {
+                job->ok = compile(job->sources[i], job->spirv[i], &job->error);
+            }
+            if (job->ok && job->onWorker) job->onWorker(*job);
+            job->milliseconds =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            job->m_done.store(true, std::memory_order_release);
+        }
+    }
+
+    // Finishes what is queued, then joins
+    void stopWorker() {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stopWorker = true;
+        }
+        m_queueCv.notify_one();
+        if (m_worker.joinable()) m_worker.join();
+    }
+
+    mutable std::mutex m_cacheMutex;
+    std::string m_cacheDirectory = "shader_cache";
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_memory;
+    Stats m_stats;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCv;
+    std::deque<std::shared_ptr<Job>> m_queue;
+    std::thread m_worker;
+    bool m_stopWorker = false;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_SHADER_COMPILER_H
@@ -0,0 +1,18 @@
+#version 450
+
+// ============================================================================
+// FULLSCREEN VERTEX SHADER - One triangle covering the viewport
+// ============================================================================
+// For full-screen passes drawn with vkCmdDraw(cmd, 3, 1, 0, 0) and no vertex
+// buffers (DynamicResolution's upscale, dynamic_resolution.h). fragUV runs
+// 0..1 across the viewport, top-left origin.
+//
+// Compile: glslc fullscreen.vert -o fullscreen.vert.spv
+// ============================================================================
+
+layout(location = 0) out vec2 fragUV;
+
+void main() {
+    fragUV = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(fragUV * 2.0 - 1.0, 0.0, 1.0);
+}
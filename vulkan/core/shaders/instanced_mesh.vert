@@ -0,0 +1,60 @@
+#version 450
+
+// ============================================================================
+// INSTANCED MESH VERTEX SHADER
+// ============================================================================
+// For VulkanCore pipelines created with PipelineConfig::instanced = true.
+// Model matrix and color come per instance (InstanceData, binding 1);
+// StandardUBO still supplies view/projection.
+// ============================================================================
+
+// Per-vertex input (POSITION_NORMAL_UV format, binding 0)
+layout(location = 0) in vec3 inPosition;
+#ifdef VERTEX_PACKED
+// PACKED_POSITION_NORMAL_UV (glslc -DVERTEX_PACKED, vertex_packing.h): the
+// position arrives in [0, 1] and the model matrix dequantizes it; the
+// normal is octahedral
+layout(location = 1) in vec2 inNormalOct;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+#define inNormal octDecode(inNormalOct)
+#else
+layout(location = 1) in vec3 inNormal;
+#endif
+layout(location = 2) in vec2 inTexCoord;
+
+// Per-instance input (must match INSTANCE_LOCATION in vulkan_core.h)
+layout(location = 8) in mat4 inInstanceModel;   // Uses locations 8-11
+layout(location = 12) in vec4 inInstanceColor;
+
+// VulkanCore StandardUBO (set 0, binding 0) - model is identity for instanced draws
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+    vec4 color;
+} ubo;
+
+// Output to fragment shader
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragWorldPos;
+layout(location = 3) out vec4 fragColor;
+
+// Same depth in every pipeline variant (DrawPass::Shading tests EQUAL)
+invariant gl_Position;
+
+void main() {
+    vec4 worldPos = inInstanceModel * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * worldPos;
+    
+    fragNormal = mat3(transpose(inverse(inInstanceModel))) * inNormal;
+    fragTexCoord = inTexCoord;
+    fragWorldPos = worldPos.xyz;
+    fragColor = inInstanceColor;
+}
@@ -0,0 +1,34 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// ============================================================================
+// PARTICLE FRAGMENT SHADER
+// ============================================================================
+// For GpuParticles (gpu_particles.h). Samples the particle's bindless
+// texture, or draws a soft round sprite when it has none. Writes
+// premultiplied color: the pipeline blends ONE / ONE_MINUS_SRC_ALPHA
+// (ParticleBlend::ALPHA) or ONE / ONE (ParticleBlend::ADDITIVE).
+//
+// Compile: glslc particle.frag -o particle.frag.spv
+// ============================================================================
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTexture;
+
+// VulkanCore bindless texture heap
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec4 color = fragColor;
+    if (fragTexture != 0xFFFFFFFFu) {
+        color *= texture(textures[nonuniformEXT(fragTexture)], fragTexCoord);
+    } else {
+        float r = length(fragTexCoord * 2.0 - 1.0);
+        color.a *= 1.0 - smoothstep(0.5, 1.0, r);
+    }
+    if (color.a <= 0.0) discard;
+    outColor = vec4(color.rgb * color.a, color.a);
+}
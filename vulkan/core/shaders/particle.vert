@@ -0,0 +1,67 @@
+#version 450
+
+// ============================================================================
+// PARTICLE VERTEX SHADER
+// ============================================================================
+// For GpuParticles (gpu_particles.h). No vertex buffers: one instance per
+// alive particle (vkCmdDrawIndirect, instanceCount from the FINISH pass),
+// six vertices forming a camera-facing quad. Instances below sortCount
+// take the back-to-front order of the sort keys, the rest the alive list.
+//
+// Compile: glslc particle.vert -o particle.vert.spv
+// ============================================================================
+
+// Must match GpuParticles::Particle (64 bytes)
+struct Particle {
+    vec4 positionAge;
+    vec4 velocityLifetime;
+    uint colorStart;
+    uint colorEnd;
+    float sizeStart;
+    float sizeEnd;
+    float rotation;
+    float spin;
+    uint texture;
+    float drag;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Particles { Particle particles[]; };
+layout(std430, set = 0, binding = 3) readonly buffer Alive { uint alive[]; };
+layout(std430, set = 0, binding = 6) readonly buffer SortKeys { uvec2 sortKeys[]; };
+
+// Must match GpuParticles::DrawParams
+layout(push_constant) uniform Params {
+    mat4 viewProj;
+    vec4 right;             // Camera axes in world space (screen space: x, y)
+    vec4 up;
+    uint sortCount;
+} params;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTexture;
+
+const vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+);
+
+void main() {
+    uint instance = uint(gl_InstanceIndex);
+    uint slot = instance < params.sortCount ? sortKeys[instance].y : alive[instance];
+    Particle p = particles[slot];
+
+    float t = clamp(p.positionAge.w / p.velocityLifetime.w, 0.0, 1.0);
+    float size = mix(p.sizeStart, p.sizeEnd, t);
+    vec2 corner = corners[gl_VertexIndex];
+    float c = cos(p.rotation);
+    float s = sin(p.rotation);
+    vec2 rotated = vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c) * size;
+
+    vec3 position = p.positionAge.xyz + params.right.xyz * rotated.x + params.up.xyz * rotated.y;
+    gl_Position = params.viewProj * vec4(position, 1.0);
+
+    fragColor = mix(unpackUnorm4x8(p.colorStart), unpackUnorm4x8(p.colorEnd), t);
+    fragTexCoord = corner * 0.5 + 0.5;
+    fragTexture = p.texture;
+}
@@ -0,0 +1,24 @@
+#version 450
+
+// ============================================================================
+// PICK ID FRAGMENT SHADER - triangle ids for VulkanCore's pick buffer
+// ============================================================================
+// Fragment stage of every PipelineConfig::pickable pipeline's pick variant
+// (CoreConfig::pickBuffer), paired with the pipeline's own vertex shader.
+// Writes the draw's first id plus the triangle index into the R32_UINT
+// attachment; PickBuffer maps it back to object and triangle. Needs the
+// geometryShader feature for gl_PrimitiveID, which VulkanCore enables.
+//
+//   glslc vulkan/core/shaders/pick_id.frag -o shaders/pick_id.frag.spv
+// ============================================================================
+
+// PickPushConstants: textureIndex (bindless) at 0, idBase at 4
+layout(push_constant) uniform PickPush {
+    layout(offset = 4) uint idBase;
+} push;
+
+layout(location = 0) out uint outId;
+
+void main() {
+    outId = push.idBase + uint(gl_PrimitiveID);
+}
@@ -0,0 +1,59 @@
+#version 450
+
+// ============================================================================
+// UPSCALE FRAGMENT SHADER - Sharpening upscale of the dynamic-resolution scene
+// ============================================================================
+// For DynamicResolution (dynamic_resolution.h). The scene was rendered into
+// the top-left renderExtent of a larger target; this stretches that region
+// over the window with a bilinear fetch, then sharpens it with a
+// contrast-adaptive filter over the 4 neighbours (after AMD's CAS): strong
+// on flat, soft gradients, backing off near high-contrast edges so they
+// don't ring. The result stays within the neighbourhood's min / max.
+//
+// Compile: glslc upscale.frag -o upscale.frag.spv
+// ============================================================================
+
+layout(location = 0) in vec2 fragUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D scene;
+
+// Must match DynamicResolution::UpscaleParams
+layout(push_constant) uniform Params {
+    vec2 uvScale;       // renderExtent / target size
+    vec2 uvMax;         // Last rendered texel centre (no bleed from outside the region)
+    vec2 texel;         // 1 / target size
+    float sharpness;    // 0 = bilinear only, 1 = strongest
+    float pad;
+} params;
+
+vec3 fetch(vec2 uv) {
+    return texture(scene, clamp(uv, params.texel * 0.5, params.uvMax)).rgb;
+}
+
+void main() {
+    vec2 uv = fragUV * params.uvScale;
+    vec4 centre = texture(scene, clamp(uv, params.texel * 0.5, params.uvMax));
+    vec3 c = centre.rgb;
+    if (params.sharpness <= 0.0) {
+        outColor = centre;
+        return;
+    }
+
+    vec3 n = fetch(uv - vec2(0.0, params.texel.y));
+    vec3 s = fetch(uv + vec2(0.0, params.texel.y));
+    vec3 w = fetch(uv - vec2(params.texel.x, 0.0));
+    vec3 e = fetch(uv + vec2(params.texel.x, 0.0));
+
+    vec3 lo = min(c, min(min(n, s), min(w, e)));
+    vec3 hi = max(c, max(max(n, s), max(w, e)));
+
+    // Room to the nearer clip (0 or 1) relative to the peak: ~1 on flat
+    // areas, ~0 at hard edges
+    vec3 amount = sqrt(clamp(min(lo, 1.0 - hi) / max(hi, vec3(1e-4)), 0.0, 1.0));
+    float peak = -1.0 / mix(8.0, 5.0, clamp(params.sharpness, 0.0, 1.0));
+    vec3 weight = amount * peak;
+
+    vec3 sharpened = (c + (n + s + w + e) * weight) / (1.0 + 4.0 * weight);
+    outColor = vec4(clamp(sharpened, lo, hi), centre.a);
+}
@@ -0,0 +1,45 @@
+#version 450
+
+// ============================================================================
+// VIDEO NV12 FRAGMENT SHADER - YUV to RGB for VideoTexture
+// ============================================================================
+// Part of the EDEN Engine video path. VideoResource decodes NV12 (full-size
+// Y plane, half-size interleaved UV plane) and VideoTexture uploads the two
+// planes as R8 / R8G8 images; the colour conversion that used to run in
+// sws_scale on the CPU happens here, per fragment.
+//
+// Specialization constants come from VideoResource::isBT709() and
+// isFullRange(). Output is the video's gamma-encoded RGB; render to a UNORM
+// target, or linearise first when writing an sRGB one.
+// ============================================================================
+
+layout(location = 0) in vec2 fragUV;
+layout(location = 0) out vec4 outColor;
+
+layout(binding = 0) uniform sampler2D texY;
+layout(binding = 1) uniform sampler2D texUV;
+
+layout(constant_id = 0) const bool BT709 = true;        // false = BT.601
+layout(constant_id = 1) const bool FULL_RANGE = false;  // false = 16-235 / 16-240
+
+void main() {
+    float y = texture(texY, fragUV).r;
+    vec2 c = texture(texUV, fragUV).rg - vec2(0.5);
+
+    if (!FULL_RANGE) {
+        y = (y - 16.0 / 255.0) * (255.0 / 219.0);
+        c *= 255.0 / 224.0;
+    }
+
+    vec3 rgb;
+    if (BT709) {
+        rgb = vec3(y + 1.5748 * c.y,
+                   y - 0.1873 * c.x - 0.4681 * c.y,
+                   y + 1.8556 * c.x);
+    } else {
+        rgb = vec3(y + 1.402 * c.y,
+                   y - 0.344136 * c.x - 0.714136 * c.y,
+                   y + 1.772 * c.x);
+    }
+    outColor = vec4(clamp(rgb, 0.0, 1.0), 1.0);
+}
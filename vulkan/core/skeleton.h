@@ -0,0 +1,500 @@
+// ============================================================================
+// SKELETON - Joint hierarchies, animation clips and pose sampling
+// ============================================================================
+// The CPU half of skinned animation (GpuSkinning is the GPU half); the GLB
+// loader imports into these types:
+//
+//   - Skeleton: every node joints or clips refer to, parents before
+//     children, with its rest TRS, plus the skins (joint list + inverse
+//     bind matrices) meshes are bound to.
+//   - AnimationClip: per-node translation / rotation / scale channels of
+//     keyframes, linear or step.
+//   - Pose: local TRS of every node as SoA planes. sampleClip() finds each
+//     channel's keys (ClipCursor keeps last frame's key, so playing
+//     forward is O(1) per channel) and blends 4 channels at a time (lerp,
+//     or shortest-arc nlerp for rotations; `weight` < 1 crossfades onto
+//     what the pose already holds). computeWorldMatrices() builds 4 local
+//     matrices at a time from TRS and concatenates down the hierarchy.
+//   - computeSkinMatrices() writes a skin's palette as 3 rows per joint
+//     (affine, transposed), what shaders/skinning.comp reads; the joint
+//     spheres from computeJointBounds() turn it into a posed bounding
+//     sphere without touching vertices.
+//
+// SSE2 or NEON (AArch64) for the 4-wide math, scalar otherwise. Header-only,
+// like mesh_lod.h.
+//
+// Usage:
+//   Pose pose;
+//   ClipCursor cursor;
+//   resetPose(skeleton, pose);
+//   sampleClip(clip, time, cursor, pose);
+//   computeWorldMatrices(skeleton, pose);
+//   computeSkinMatrices(skeleton.skins[0], pose, palette.data());
+// ============================================================================
+
+#ifndef VKCORE_SKELETON_H
+#define VKCORE_SKELETON_H
+
+#include "mesh_lod.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKCORE_SKELETON_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define VKCORE_SKELETON_NEON 1
+#endif
+
+namespace vkcore {
+
+constexpr uint32_t MAX_SKIN_INFLUENCES = 4;
+
+// Per-vertex influences, parallel to a mesh's vertices
+struct SkinWeights {
+    uint16_t joints[MAX_SKIN_INFLUENCES] = {0, 0, 0, 0};  // Indices into Skin::joints
+    float weights[MAX_SKIN_INFLUENCES] = {1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+struct SkeletonNode {
+    std::string name;
+    int32_t parent = -1;                                // Always below this node's index
+    glm::vec3 translation = glm::vec3(0.0f);
+    glm::vec4 rotation = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);  // Quaternion xyzw
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+struct Skin {
+    std::string name;
+    std::vector<uint32_t> joints;        // Skeleton node per joint
+    std::vector<glm::mat4> inverseBind;  // Mesh space to joint space, per joint
+};
+
+struct Skeleton {
+    std::vector<SkeletonNode> nodes;
+    std::vector<Skin> skins;
+
+    int findNode(const std::string& name) const {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
+enum class AnimationPath : uint32_t {
+    TRANSLATION = 0,
+    ROTATION = 1,
+    SCALE = 2,
+};
+
+struct AnimationChannel {
+    uint32_t node = 0;
+    AnimationPath path = AnimationPath::TRANSLATION;
+    bool step = false;              // Hold each key, else linear
+    std::vector<float> times;       // Seconds, ascending
+    std::vector<glm::vec4> values;  // One per time: xyz, or a quaternion
+};
+
+struct AnimationClip {
+    std::string name;
+    float duration = 0.0f;  // Last key of any channel
+    std::vector<AnimationChannel> channels;
+};
+
+// Animated state: local TRS of every node as 10 planes (translation xyz,
+// rotation xyzw, scale xyz), each `stride` floats
+struct Pose {
+    enum Plane { TX, TY, TZ, RX, RY, RZ, RW, SX, SY, SZ, PLANES };
+
+    std::vector<float> trs;
+    uint32_t stride = 0;            // Node count rounded up to 4
+    std::vector<glm::mat4> world;   // Node to skeleton root, after computeWorldMatrices()
+
+    float* plane(int p) { return trs.data() + size_t(p) * stride; }
+    const float* plane(int p) const { return trs.data() + size_t(p) * stride; }
+};
+
+// Last key used per channel of one clip
+struct ClipCursor {
+    std::vector<uint32_t> keys;
+};
+
+namespace skeleton_detail {
+
+// ----------------------------------------------------------------------------
+// 4-wide float math
+// ----------------------------------------------------------------------------
+
+#if defined(VKCORE_SKELETON_SSE2)
+struct F4 { __m128 v; };
+inline F4 load4(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store4(float* p, F4 a) { _mm_storeu_ps(p, a.v); }
+inline F4 set4(float s) { return {_mm_set1_ps(s)}; }
+inline F4 operator+(F4 a, F4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline F4 operator-(F4 a, F4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline F4 operator*(F4 a, F4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline F4 operator/(F4 a, F4 b) { return {_mm_div_ps(a.v, b.v)}; }
+inline F4 sqrt4(F4 a) { return {_mm_sqrt_ps(a.v)}; }
+inline F4 max4(F4 a, F4 b) { return {_mm_max_ps(a.v, b.v)}; }
+// a with its sign flipped in the lanes where s is negative
+inline F4 flipSign(F4 a, F4 s) { return {_mm_xor_ps(a.v, _mm_and_ps(s.v, _mm_set1_ps(-0.0f)))}; }
+#elif defined(VKCORE_SKELETON_NEON)
+struct F4 { float32x4_t v; };
+inline F4 load4(const float* p) { return {vld1q_f32(p)}; }
+inline void store4(float* p, F4 a) { vst1q_f32(p, a.v); }
+inline F4 set4(float s) { return {vdupq_n_f32(s)}; }
+inline F4 operator+(F4 a, F4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline F4 operator-(F4 a, F4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline F4 operator*(F4 a, F4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline F4 operator/(F4 a, F4 b) { return {vdivq_f32(a.v, b.v)}; }
+inline F4 sqrt4(F4 a) { return {vsqrtq_f32(a.v)}; }
+inline F4 max4(F4 a, F4 b) { return {vmaxq_f32(a.v, b.v)}; }
+inline F4 flipSign(F4 a, F4 s) {
+    uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(s.v), vdupq_n_u32(0x80000000u));
+    return {vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a.v), sign))};
+}
+#else
+struct F4 { float v[4]; };
+inline F4 load4(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float* p, F4 a) { std::memcpy(p, a.v, sizeof(a.v)); }
+inline F4 set4(float s) { return {{s, s, s, s}}; }
+#define VKCORE_SKELETON_LANES(expr) F4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+inline F4 operator+(F4 a, F4 b) { VKCORE_SKELETON_LANES(a.v[i] + b.v[i]); }
+inline F4 operator-(F4 a, F4 b) { VKCORE_SKELETON_LANES(a.v[i] - b.v[i]); }
+inline F4 operator*(F4 a, F4 b) { VKCORE_SKELETON_LANES(a.v[i] * b.v[i]); }
+inline F4 operator/(F4 a, F4 b) { VKCORE_SKELETON_LANES(a.v[i] / b.v[i]); }
+inline F4 sqrt4(F4 a) { VKCORE_SKELETON_LANES(std::sqrt(a.v[i])); }
+inline F4 max4(F4 a, F4 b) { VKCORE_SKELETON_LANES(std::max(a.v[i], b.v[i])); }
+inline F4 flipSign(F4 a, F4 s) { VKCORE_SKELETON_LANES(std::signbit(s.v[i]) ? -a.v[i] : a.v[i]); }
+#undef VKCORE_SKELETON_LANES
+#endif
+
+// out = a * b, column-major; out may alias either
+inline void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+    const float* pa = &a[0].x;
+    const float* pb = &b[0].x;
+    F4 a0 = load4(pa), a1 = load4(pa + 4), a2 = load4(pa + 8), a3 = load4(pa + 12);
+    F4 columns[4];
+    for (int c = 0; c < 4; c++) {
+        const float* bc = pb + c * 4;
+        columns[c] = a0 * set4(bc[0]) + a1 * set4(bc[1]) + a2 * set4(bc[2]) + a3 * set4(bc[3]);
+    }
+    float* po = &out[0].x;
+    for (int c = 0; c < 4; c++) store4(po + c * 4, columns[c]);
+}
+
+// Up to 4 channels of one kind waiting to be blended: component c of lane
+// i is a[c * 4 + i]; out[c * 4 + i] is where it goes in the pose
+struct ChannelBatch {
+    float a[16] = {}, b[16] = {}, t[4] = {};
+    float* out[16] = {};
+    float unused[4] = {};
+    uint32_t count = 0;
+};
+
+// lerp(a, b, t), then toward that from the pose's value by `weight`
+inline void flushVectors(ChannelBatch& batch, float weight) {
+    if (batch.count == 0) return;
+    for (uint32_t i = batch.count; i < 4; i++) {
+        for (int c = 0; c < 4; c++) batch.out[c * 4 + i] = &batch.unused[c];
+        batch.t[i] = 0.0f;
+    }
+    F4 t = load4(batch.t), w = set4(weight);
+    for (int c = 0; c < 3; c++) {
+        float current[4];
+        for (int i = 0; i < 4; i++) current[i] = *batch.out[c * 4 + i];
+        F4 a = load4(&batch.a[c * 4]), b = load4(&batch.b[c * 4]), cur = load4(current);
+        F4 sampled = a + (b - a) * t;
+        float result[4];
+        store4(result, cur + (sampled - cur) * w);
+        for (int i = 0; i < 4; i++) *batch.out[c * 4 + i] = result[i];
+    }
+    batch.count = 0;
+}
+
+// Shortest-arc nlerp(a, b, t), then the same toward the pose's value
+inline void flushRotations(ChannelBatch& batch, float weight) {
+    if (batch.count == 0) return;
+    for (uint32_t i = batch.count; i < 4; i++) {
+        for (int c = 0; c < 4; c++) batch.out[c * 4 + i] = &batch.unused[c];
+        batch.t[i] = 0.0f;
+    }
+    F4 a[4], b[4], cur[4];
+    for (int c = 0; c < 4; c++) {
+        float current[4];
+        for (int i = 0; i < 4; i++) current[i] = *batch.out[c * 4 + i];
+        a[c] = load4(&batch.a[c * 4]);
+        b[c] = load4(&batch.b[c * 4]);
+        cur[c] = load4(current);
+    }
+    F4 t = load4(batch.t), w = set4(weight), tiny = set4(1e-12f);
+    F4 dotAB = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    F4 q[4];
+    for (int c = 0; c < 4; c++) q[c] = a[c] + (flipSign(b[c], dotAB) - a[c]) * t;
+    F4 dotCQ = cur[0] * q[0] + cur[1] * q[1] + cur[2] * q[2] + cur[3] * q[3];
+    for (int c = 0; c < 4; c++) q[c] = cur[c] + (flipSign(q[c], dotCQ) - cur[c]) * w;
+    F4 length = sqrt4(max4(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3], tiny));
+    for (int c = 0; c < 4; c++) {
+        float result[4];
+        store4(result, q[c] / length);
+        for (int i = 0; i < 4; i++) *batch.out[c * 4 + i] = result[i];
+    }
+    batch.count = 0;
+}
+
+// Keys around `time` (clamped to the first / last) and how far between
+inline void findKeys(const AnimationChannel& channel, float time, uint32_t& cursor,
+                     uint32_t& k0, uint32_t& k1, float& t) {
+    const std::vector<float>& times = channel.times;
+    uint32_t last = static_cast<uint32_t>(times.size() - 1);
+    if (time <= times[0] || last == 0) {
+        k0 = k1 = cursor = 0;
+        t = 0.0f;
+        return;
+    }
+    if (time >= times[last]) {
+        k0 = k1 = cursor = last;
+        t = 0.0f;
+        return;
+    }
+    uint32_t k = std::min(cursor, last - 1);
+    if (times[k] > time) {
+        k = static_cast<uint32_t>(std::upper_bound(times.begin(), times.end(), time) - times.begin()) - 1;
+    } else {
+        while (times[k + 1] <= time) k++;  // Usually zero or one step per frame
+    }
+    cursor = k;
+    k0 = k;
+    k1 = k + 1;
+    float span = times[k1] - times[k0];
+    t = channel.step || span <= 0.0f ? 0.0f : (time - times[k0]) / span;
+}
+
+} // namespace skeleton_detail
+
+// ----------------------------------------------------------------------------
+// Pose sampling
+// ----------------------------------------------------------------------------
+
+// Every node at its rest TRS
+inline void resetPose(const Skeleton& skeleton, Pose& pose) {
+    uint32_t count = static_cast<uint32_t>(skeleton.nodes.size());
+    pose.stride = (count + 3) & ~3u;
+    pose.trs.assign(size_t(pose.stride) * Pose::PLANES, 0.0f);
+    pose.world.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const SkeletonNode& node = skeleton.nodes[i];
+        float values[Pose::PLANES] = {node.translation.x, node.translation.y, node.translation.z,
+                                      node.rotation.x, node.rotation.y, node.rotation.z, node.rotation.w,
+                                      node.scale.x, node.scale.y, node.scale.z};
+        for (int p = 0; p < Pose::PLANES; p++) pose.plane(p)[i] = values[p];
+    }
+}
+
+// Overwrites (weight 1) or blends toward (weight < 1) the nodes `clip`
+// animates at `time` seconds; others keep what the pose holds. Channels
+// naming nodes the pose doesn't have are skipped.
+inline void sampleClip(const AnimationClip& clip, float time, ClipCursor& cursor, Pose& pose, float weight = 1.0f) {
+    using namespace skeleton_detail;
+    if (weight <= 0.0f) return;
+    weight = std::min(weight, 1.0f);
+    cursor.keys.resize(clip.channels.size(), 0);
+    uint32_t nodeCount = static_cast<uint32_t>(pose.world.size());
+
+    ChannelBatch vectors, rotations;
+    for (size_t c = 0; c < clip.channels.size(); c++) {
+        const AnimationChannel& channel = clip.channels[c];
+        if (channel.node >= nodeCount || channel.times.empty() || channel.values.size() < channel.times.size()) continue;
+        uint32_t k0, k1;
+        float t;
+        findKeys(channel, time, cursor.keys[c], k0, k1, t);
+        const glm::vec4& a = channel.values[k0];
+        const glm::vec4& b = channel.values[k1];
+
+        bool rotation = channel.path == AnimationPath::ROTATION;
+        ChannelBatch& batch = rotation ? rotations : vectors;
+        int first = rotation ? Pose::RX : channel.path == AnimationPath::SCALE ? Pose::SX : Pose::TX;
+        uint32_t lane = batch.count++;
+        for (int i = 0; i < 4; i++) {
+            batch.a[i * 4 + lane] = a[i];
+            batch.b[i * 4 + lane] = b[i];
+            batch.out[i * 4 + lane] = rotation || i < 3 ? &pose.plane(first + i)[channel.node] : &batch.unused[i];
+        }
+        batch.t[lane] = t;
+        if (batch.count == 4) {
+            if (rotation) flushRotations(batch, weight);
+            else flushVectors(batch, weight);
+        }
+    }
+    flushVectors(vectors, weight);
+    flushRotations(rotations, weight);
+}
+
+// Local matrices from TRS, 4 nodes at a time, then parent * local down the
+// hierarchy
+inline void computeWorldMatrices(const Skeleton& skeleton, Pose& pose) {
+    using namespace skeleton_detail;
+    uint32_t count = static_cast<uint32_t>(std::min(skeleton.nodes.size(), pose.world.size()));
+    F4 one = set4(1.0f), two = set4(2.0f);
+    for (uint32_t base = 0; base < count; base += 4) {
+        F4 x = load4(pose.plane(Pose::RX) + base), y = load4(pose.plane(Pose::RY) + base);
+        F4 z = load4(pose.plane(Pose::RZ) + base), w = load4(pose.plane(Pose::RW) + base);
+        F4 sx = load4(pose.plane(Pose::SX) + base), sy = load4(pose.plane(Pose::SY) + base);
+        F4 sz = load4(pose.plane(Pose::SZ) + base);
+        F4 xx = x * x, yy = y * y, zz = z * z;
+        F4 xy = x * y, xz = x * z, yz = y * z, wx = w * x, wy = w * y, wz = w * z;
+
+        // Column-major 3x3 (rotation * scale), then the translation column
+        F4 m[12] = {
+            (one - two * (yy + zz)) * sx, two * (xy + wz) * sx, two * (xz - wy) * sx,
+            two * (xy - wz) * sy, (one - two * (xx + zz)) * sy, two * (yz + wx) * sy,
+            two * (xz + wy) * sz, two * (yz - wx) * sz, (one - two * (xx + yy)) * sz,
+            load4(pose.plane(Pose::TX) + base), load4(pose.plane(Pose::TY) + base), load4(pose.plane(Pose::TZ) + base),
+        };
+        float lanes[12][4];
+        for (int e = 0; e < 12; e++) store4(lanes[e], m[e]);
+        for (uint32_t i = 0; i < 4 && base + i < count; i++) {
+            glm::mat4& local = pose.world[base + i];
+            for (int c = 0; c < 4; c++) {
+                local[c] = glm::vec4(lanes[c * 3][i], lanes[c * 3 + 1][i], lanes[c * 3 + 2][i], c == 3 ? 1.0f : 0.0f);
+            }
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t parent = skeleton.nodes[i].parent;
+        if (parent >= 0 && static_cast<uint32_t>(parent) < i) multiply(pose.world[parent], pose.world[i], pose.world[i]);
+    }
+}
+
+// Palette of `skin`: world[joint] * inverseBind as rows[j * 3 + r] = row r
+// of the affine part. Missing joints get the identity.
+inline void computeSkinMatrices(const Skin& skin, const Pose& pose, glm::vec4* rows) {
+    for (size_t j = 0; j < skin.joints.size(); j++) {
+        glm::mat4 m(1.0f);
+        if (skin.joints[j] < pose.world.size()) {
+            const glm::mat4 inverseBind = j < skin.inverseBind.size() ? skin.inverseBind[j] : glm::mat4(1.0f);
+            skeleton_detail::multiply(pose.world[skin.joints[j]], inverseBind, m);
+        }
+        for (int r = 0; r < 3; r++) rows[j * 3 + r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Weights and bounds
+// ----------------------------------------------------------------------------
+
+// Weights summing to 1 (all-zero: fully on the first joint)
+inline void normalizeSkinWeights(SkinWeights& weights) {
+    float sum = 0.0f;
+    for (float w : weights.weights) sum += std::max(w, 0.0f);
+    for (float& w : weights.weights) w = sum > 0.0f ? std::max(w, 0.0f) / sum : 0.0f;
+    if (sum <= 0.0f) weights.weights[0] = 1.0f;
+}
+
+// Bind-space sphere (xyz, w = radius) around the vertices each joint
+// influences; joints influencing nothing get radius -1. Positions are the
+// first 3 floats of each vertex.
+inline std::vector<glm::vec4> computeJointBounds(const float* vertices, uint32_t strideFloats, uint32_t count,
+                                                 const SkinWeights* weights, uint32_t jointCount) {
+    std::vector<glm::vec3> lo(jointCount, glm::vec3(1e30f)), hi(jointCount, glm::vec3(-1e30f));
+    auto forInfluences = [&](auto&& fn) {
+        for (uint32_t v = 0; v < count; v++) {
+            const float* p = vertices + size_t(v) * strideFloats;
+            for (uint32_t k = 0; k < MAX_SKIN_INFLUENCES; k++) {
+                if (weights[v].weights[k] > 0.0f && weights[v].joints[k] < jointCount) {
+                    fn(weights[v].joints[k], glm::vec3(p[0], p[1], p[2]));
+                }
+            }
+        }
+    };
+    forInfluences([&](uint32_t j, const glm::vec3& p) {
+        lo[j] = glm::min(lo[j], p);
+        hi[j] = glm::max(hi[j], p);
+    });
+    std::vector<glm::vec4> spheres(jointCount, glm::vec4(0.0f, 0.0f, 0.0f, -1.0f));
+    for (uint32_t j = 0; j < jointCount; j++) {
+        if (lo[j].x <= hi[j].x) spheres[j] = glm::vec4((lo[j] + hi[j]) * 0.5f, 0.0f);
+    }
+    forInfluences([&](uint32_t j, const glm::vec3& p) {
+        glm::vec3 d = p - glm::vec3(spheres[j]);
+        spheres[j].w = std::max(spheres[j].w, std::sqrt(glm::dot(d, d)));
+    });
+    return spheres;
+}
+
+// A sphere around every joint's sphere moved by its palette entry, grown by
+// `margin` (e.g. the largest displacement applied before skinning)
+inline LodBounds skinnedBounds(const std::vector<glm::vec4>& jointBounds, const glm::vec4* rows, float margin = 0.0f) {
+    LodBounds bounds;
+    glm::vec3 lo(1e30f), hi(-1e30f);
+    std::vector<glm::vec4> posed;
+    posed.reserve(jointBounds.size());
+    for (size_t j = 0; j < jointBounds.size(); j++) {
+        const glm::vec4& s = jointBounds[j];
+        if (s.w < 0.0f) continue;
+        const glm::vec4* m = rows + j * 3;
+        glm::vec4 p(s.x, s.y, s.z, 1.0f);
+        glm::vec3 center(glm::dot(m[0], p), glm::dot(m[1], p), glm::dot(m[2], p));
+        // Largest axis scale of the 3x3 part
+        float scale = 0.0f;
+        for (int c = 0; c < 3; c++) {
+            glm::vec3 axis(m[0][c], m[1][c], m[2][c]);
+            scale = std::max(scale, glm::dot(axis, axis));
+        }
+        float radius = s.w * std::sqrt(scale) + margin;
+        posed.push_back(glm::vec4(center, radius));
+        lo = glm::min(lo, center - glm::vec3(radius));
+        hi = glm::max(hi, center + glm::vec3(radius));
+    }
+    if (posed.empty()) return bounds;
+    bounds.center = (lo + hi) * 0.5f;
+    for (const glm::vec4& s : posed) {
+        glm::vec3 d = glm::vec3(s) - bounds.center;
+        bounds.radius = std::max(bounds.radius, std::sqrt(glm::dot(d, d)) + s.w);
+    }
+    return bounds;
+}
+
+// Translation, rotation and scale of an affine matrix without shear (node
+// matrices in files that only give one)
+inline void decomposeTransform(const glm::mat4& m, glm::vec3& translation, glm::vec4& rotation, glm::vec3& scale) {
+    translation = glm::vec3(m[3]);
+    glm::vec3 axes[3] = {glm::vec3(m[0]), glm::vec3(m[1]), glm::vec3(m[2])};
+    for (int c = 0; c < 3; c++) {
+        scale[c] = std::sqrt(glm::dot(axes[c], axes[c]));
+        if (scale[c] > 0.0f) axes[c] = axes[c] / scale[c];
+    }
+    if (glm::dot(glm::cross(axes[0], axes[1]), axes[2]) < 0.0f) {  // Mirrored: fold it into one axis
+        scale.x = -scale.x;
+        axes[0] = -axes[0];
+    }
+    // Shepperd: pivot on the largest of trace and diagonal
+    float r00 = axes[0].x, r11 = axes[1].y, r22 = axes[2].z;
+    float trace = r00 + r11 + r22;
+    if (trace > 0.0f) {
+        float s = std::sqrt(trace + 1.0f) * 2.0f;
+        rotation = glm::vec4((axes[1].z - axes[2].y) / s, (axes[2].x - axes[0].z) / s, (axes[0].y - axes[1].x) / s, 0.25f * s);
+    } else if (r00 > r11 && r00 > r22) {
+        float s = std::sqrt(1.0f + r00 - r11 - r22) * 2.0f;
+        rotation = glm::vec4(0.25f * s, (axes[1].x + axes[0].y) / s, (axes[2].x + axes[0].z) / s, (axes[1].z - axes[2].y) / s);
+    } else if (r11 > r22) {
+        float s = std::sqrt(1.0f + r11 - r00 - r22) * 2.0f;
+        rotation = glm::vec4((axes[1].x + axes[0].y) / s, 0.25f * s, (axes[2].y + axes[1].z) / s, (axes[2].x - axes[0].z) / s);
+    } else {
+        float s = std::sqrt(1.0f + r22 - r00 - r11) * 2.0f;
+        rotation = glm::vec4((axes[2].x + axes[0].z) / s, (axes[2].y + axes[1].z) / s, 0.25f * s, (axes[0].y - axes[1].x) / s);
+    }
+}
+
+} // namespace vkcore
+
+#endif // VKCORE_SKELETON_H
@@ -0,0 +1,218 @@
+// ============================================================================
+// TEXTURE STREAMER - Texel density feedback for mip streaming
+// ============================================================================
+// Streamed textures start with only their small mips resident; which finer
+// mips each one needs is measured on the GPU, where the texture is drawn:
+//
+//   - Fragment shaders that sample the bindless heap report the finest
+//     screen-space texel density each slot was sampled at, atomicMax into
+//     one uint per slot (bindless set, binding TEXEL_DENSITY_BINDING).
+//   - recordResolve() copies that buffer into this frame slot's host
+//     readback and clears it, after the frame's render pass.
+//   - readFeedback() hands the values back once the slot's fence has
+//     signalled (framesInFlight frames later - no stalls).
+//
+// A density is log2(screen pixels per UV unit) on the minor axis, in
+// 1/DENSITY_STEPS steps, plus one (0 = not sampled). It is independent of
+// how many mips are resident, so desiredBaseMip() can turn it into the mip
+// a texture of any size needs. VulkanCore owns one when
+// CoreConfig::textureStreaming is set and does the streaming itself.
+//
+// Header-only, like gpu_allocator.h.
+//
+// Usage:
+//   streamer.init(device, allocator, heap.getCapacity(), framesInFlight);
+//   heap.setTexelDensityBuffer(streamer.getFeedbackBuffer(), streamer.getFeedbackSize());
+//   streamer.recordResolve(cmd, frameIndex);           // after the render pass
+//   ... next use of frameIndex, after its fence ...
+//   if (const uint32_t* density = streamer.readFeedback(frameIndex)) {
+//       uint32_t mip = TextureStreamer::desiredBaseMip(density[slot], width, height, mipLevels);
+//   }
+//
+// GLSL (one fragment in 16 reports; the maximum survives, so little is lost).
+// A fragment shader that writes this needs fragmentStoresAndAtomics even if
+// the write never runs, so keep it in a variant only loaded while
+// VulkanCore::isTextureStreaming() (lit_mesh.frag uses -DTEXEL_DENSITY):
+//   layout(std430, set = 1, binding = 1) buffer TexelDensity { uint texelDensity[]; };
+//   vec2 dx = dFdx(uv), dy = dFdy(uv);                // In uniform control flow
+//   if (((uint(gl_FragCoord.x) | uint(gl_FragCoord.y)) & 3u) == 0u) {
+//       float density = -0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-12));
+//       atomicMax(texelDensity[index], uint(clamp(density, 0.0, 15.9) * 16.0) + 1u);
+//   }
+// ============================================================================
+
+#ifndef VKCORE_TEXTURE_STREAMER_H
+#define VKCORE_TEXTURE_STREAMER_H
+
+#include "gpu_allocator.h"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+namespace vkcore {
+
+class TextureStreamer {
+public:
+    static constexpr uint32_t MAX_FRAMES = 4;
+    static constexpr float DENSITY_STEPS = 16.0f;  // Must match the GLSL encoding
+
+    TextureStreamer() = default;
+    ~TextureStreamer() = default;  // shutdown() needs the allocator
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    // slots: bindless heap capacity (one density per slot)
+    bool init(VkDevice device, GpuAllocator& allocator, uint32_t slots, uint32_t framesInFlight) {
+        if (m_device != VK_NULL_HANDLE) return true;
+        if (slots == 0) return false;
+        m_size = VkDeviceSize(slots) * sizeof(uint32_t);
+        m_framesInFlight = std::min(std::max(framesInFlight, 1u), MAX_FRAMES);
+
+        if (!allocator.createBuffer(m_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_feedback, m_feedbackAlloc)) {
+            std::cerr << "[TextureStreamer] Failed to create the feedback buffer" << std::endl;
+            return false;
+        }
+        for (uint32_t i = 0; i < m_framesInFlight; i++) {
+            if (!allocator.createBuffer(m_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                        m_readback[i].buffer, m_readback[i].alloc) ||
+                !m_readback[i].alloc.mapped) {
+                std::cerr << "[TextureStreamer] Failed to create readback buffers" << std::endl;
+                m_device = device;
+                shutdown(allocator);
+                return false;
+            }
+            m_readback[i].valid = false;
+        }
+
+        m_device = device;
+        m_cleared = false;
+        std::cout << "[TextureStreamer] Texel density feedback for " << slots << " slots" << std::endl;
+        return true;
+    }
+
+    // Before the allocator shuts down; the GPU must be idle
+    void shutdown(GpuAllocator& allocator) {
+        if (m_device == VK_NULL_HANDLE) return;
+        allocator.destroyBuffer(m_feedback, m_feedbackAlloc);
+        for (uint32_t i = 0; i < MAX_FRAMES; i++) {
+            if (m_readback[i].buffer != VK_NULL_HANDLE) {
+                allocator.destroyBuffer(m_readback[i].buffer, m_readback[i].alloc);
+            }
+            m_readback[i] = Readback();
+        }
+        m_feedback = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    bool isInitialized() const { return m_device != VK_NULL_HANDLE; }
+    VkBuffer getFeedbackBuffer() const { return m_feedback; }
+    VkDeviceSize getFeedbackSize() const { return m_size; }
+
+    // ========================================================================
+    // Per frame
+    // ========================================================================
+
+    // Outside a render pass, after the frame's draws: this frame's
+    // densities go to the slot's readback and the buffer starts over
+    void recordResolve(VkCommandBuffer cmd, uint32_t frameIndex) {
+        if (m_device == VK_NULL_HANDLE || frameIndex >= m_framesInFlight) return;
+
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = m_feedback;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr, 1, &barrier, 0, nullptr);
+
+        // The first frame's values are on top of uninitialized memory
+        Readback& readback = m_readback[frameIndex];
+        if (m_cleared) {
+            VkBufferCopy region{0, 0, m_size};
+            vkCmdCopyBuffer(cmd, m_feedback, readback.buffer, 1, &region);
+
+            VkBufferMemoryBarrier hostBarrier = barrier;
+            hostBarrier.buffer = readback.buffer;
+            hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                                 0, nullptr, 1, &hostBarrier, 0, nullptr);
+
+            // Ordered after the copy's read of the same buffer
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                                 0, nullptr, 1, &barrier, 0, nullptr);
+        }
+        readback.valid = m_cleared;
+        vkCmdFillBuffer(cmd, m_feedback, 0, m_size, 0);
+        m_cleared = true;
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                             0, nullptr, 1, &barrier, 0, nullptr);
+    }
+
+    // After frameIndex's fence: one density per slot from that frame, or
+    // null if it has none (first use, or already read)
+    const uint32_t* readFeedback(uint32_t frameIndex) {
+        if (m_device == VK_NULL_HANDLE || frameIndex >= m_framesInFlight) return nullptr;
+        Readback& readback = m_readback[frameIndex];
+        if (!readback.valid) return nullptr;
+        readback.valid = false;
+        return static_cast<const uint32_t*>(readback.alloc.mapped);
+    }
+
+    // ========================================================================
+    // Policy
+    // ========================================================================
+
+    // Finest mip a width x height, mipLevels texture needs at `density`
+    // (a feedback value; 0 = not sampled -> coarsest level)
+    static uint32_t desiredBaseMip(uint32_t density, uint32_t width, uint32_t height, uint32_t mipLevels) {
+        if (mipLevels <= 1) return 0;
+        if (density == 0) return mipLevels - 1;
+        float pixelsPerUv = float(density - 1) / DENSITY_STEPS;  // log2
+        float lod = std::log2(float(std::max(std::max(width, height), 1u))) - pixelsPerUv;
+        if (lod <= 0.0f) return 0;
+        return std::min(static_cast<uint32_t>(lod), mipLevels - 1);
+    }
+
+private:
+    struct Readback {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        GpuAllocation alloc;
+        bool valid = false;  // Holds a resolved frame not yet read
+    };
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkDeviceSize m_size = 0;
+    uint32_t m_framesInFlight = 1;
+    bool m_cleared = false;
+
+    VkBuffer m_feedback = VK_NULL_HANDLE;
+    GpuAllocation m_feedbackAlloc;
+    Readback m_readback[MAX_FRAMES];
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_TEXTURE_STREAMER_H
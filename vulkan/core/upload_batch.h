@@ -0,0 +1,621 @@
+// ============================================================================
+// UPLOAD BATCH - Many texture/buffer uploads, one submission
+// ============================================================================
+// Loading a model with dozens of textures used to cost one vkQueueSubmit +
+// vkQueueWaitIdle per resource. UploadBatch records the copies and layout
+// transitions of every upload between begin() and end() into ONE command
+// buffer on the graphics queue, submitted with ONE fence:
+//
+//   - Source bytes go into a persistently mapped staging ring that is reused
+//     across batches. A region is only overwritten after the fence of the
+//     batch that read it has signalled; a request that doesn't fit waits for
+//     the oldest batch, submits the open one early, or (with nothing in
+//     flight) grows the ring.
+//   - Images end in SHADER_READ_ONLY_OPTIMAL (recordMipChain() when asked to
+//     generate mips). The batch ends with a barrier from transfer writes to
+//     vertex/index/uniform/shader reads, so anything submitted to the same
+//     queue afterwards sees the data without a CPU wait.
+//   - end() does not block; flush() submits an open batch early (VulkanCore
+//     does so before each frame's submit). wait(ticket) blocks, for code
+//     that must (e.g. before destroying a destination still being written).
+//   - Uploads outside begin()/end() are a batch of one - still no
+//     vkQueueWaitIdle.
+//
+// Runs on the graphics queue (mip blits need it). UploadManager stays the
+// transfer-queue path for VulkanCore's mesh buffers.
+//
+// Header-only, like gpu_allocator.h. Not thread-safe: call from the render
+// thread.
+//
+// Usage:
+//   UploadBatch uploads;
+//   uploads.init(device, &allocator, graphicsQueue, graphicsFamily);
+//   uploads.begin();
+//   uploads.uploadImage(image, pixels, size, w, h, mipLevels, true);
+//   uploads.uploadBuffer(vertexBuffer, vertices, vertexBytes);
+//   UploadBatch::Ticket t = uploads.end();   // one vkQueueSubmit
+//   uploads.poll();                          // once per frame
+//   uploads.shutdown();                      // before allocator.shutdown()
+// ============================================================================
+
+#ifndef VKCORE_UPLOAD_BATCH_H
+#define VKCORE_UPLOAD_BATCH_H
+
+#include "gpu_allocator.h"
+#include "mip_chain.h"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+class UploadBatch {
+public:
+    using Ticket = uint64_t;               // 0 = nothing to wait for
+    static constexpr Ticket NO_UPLOAD = 0;
+
+    static constexpr VkDeviceSize DEFAULT_RING_SIZE = 32ull * 1024 * 1024;
+    // Satisfies bufferOffset rules for every uncompressed and BC format
+    static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    UploadBatch() = default;
+    ~UploadBatch() { shutdown(); }
+
+    UploadBatch(const UploadBatch&) = delete;
+    UploadBatch& operator=(const UploadBatch&) = delete;
+
+    // Process-wide instance for code that works off the legacy g_device
+    // globals (stdlib/*_resource.h), staging from GpuAllocator::shared().
+    // The EDEN helpers bind it after device creation; later calls can omit
+    // the arguments.
+    static UploadBatch& shared(VkDevice device = VK_NULL_HANDLE, VkPhysicalDevice physicalDevice = VK_NULL_HANDLE,
+                               VkQueue queue = VK_NULL_HANDLE, uint32_t queueFamily = 0) {
+        static UploadBatch s_shared;
+        if (!s_shared.isInitialized() && device != VK_NULL_HANDLE) {
+            s_shared.init(device, &GpuAllocator::shared(device, physicalDevice), queue, queueFamily);
+        }
+        return s_shared;
+    }
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VkDevice device, GpuAllocator* allocator, VkQueue queue, uint32_t queueFamily,
+              VkDeviceSize ringSize = DEFAULT_RING_SIZE) {
+        if (m_device != VK_NULL_HANDLE) return true;
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = queueFamily;
+
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+            std::cerr << "[UploadBatch] Failed to create command pool" << std::endl;
+            return false;
+        }
+
+        m_device = device;
+        m_allocator = allocator;
+        m_queue = queue;
+
+        if (!createRing(ringSize)) {
+            std::cerr << "[UploadBatch] Failed to allocate " << (ringSize / (1024 * 1024))
+                      << " MB staging ring" << std::endl;
+            vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+            m_commandPool = VK_NULL_HANDLE;
+            m_device = VK_NULL_HANDLE;
+            m_allocator = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    // Submits anything still open and waits for every batch
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        if (m_recording) submit();
+        waitIdle();
+
+        for (VkFence fence : m_freeFences) {
+            vkDestroyFence(m_device, fence, nullptr);
+        }
+        m_freeFences.clear();
+        m_freeCommandBuffers.clear();  // Freed with the pool
+
+        m_allocator->destroyBuffer(m_ring, m_ringAlloc);
+        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+        m_commandPool = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+        m_allocator = nullptr;
+        m_depth = 0;
+    }
+
+    bool isInitialized() const { return m_device != VK_NULL_HANDLE; }
+
+    // ========================================================================
+    // Batches
+    // ========================================================================
+
+    // Nests: only the outermost end() submits
+    void begin() { m_depth++; }
+
+    // Submits everything recorded since the outermost begin(); returns the
+    // ticket covering it (NO_UPLOAD if nothing was recorded)
+    Ticket end() {
+        if (m_depth == 0) return NO_UPLOAD;
+        if (--m_depth > 0) return m_recording ? m_recordingTicket : m_lastTicket;
+        Ticket ticket = m_lastTicket;
+        if (m_recording) ticket = submit();
+        return ticket;
+    }
+
+    bool isOpen() const { return m_depth > 0; }
+
+    // Submits what has been recorded so far without closing the batch -
+    // for work that must reach the queue before a frame that uses it
+    Ticket flush() { return m_recording ? submit() : m_lastTicket; }
+
+    // ========================================================================
+    // Uploads
+    // ========================================================================
+
+    // dstBuffer needs TRANSFER_DST usage. Returns the ticket of the batch
+    // carrying the copy, or NO_UPLOAD on failure.
+    Ticket uploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0) {
+        if (m_device == VK_NULL_HANDLE || size == 0) return NO_UPLOAD;
+
+        VkDeviceSize srcOffset;
+        if (!stage(data, size, srcOffset)) return NO_UPLOAD;
+
+        VkBufferCopy region{};
+        region.srcOffset = srcOffset;
+        region.dstOffset = dstOffset;
+        region.size = size;
+        vkCmdCopyBuffer(m_cmd, m_ring, dstBuffer, 1, &region);
+        m_writesBuffers = true;
+        return finishUpload();
+    }
+
+    // Level 0 from tightly packed `data`. generateMips blits the other
+    // mipLevels - 1 levels (the image needs TRANSFER_SRC usage); otherwise
+    // only level 0 is written. Every level ends SHADER_READ_ONLY_OPTIMAL.
+    Ticket uploadImage(VkImage image, const void* data, VkDeviceSize size,
+                       uint32_t width, uint32_t height, uint32_t mipLevels, bool generateMips) {
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {width, height, 1};
+        return uploadImageRegions(image, data, size, &region, 1, generateMips ? mipLevels : 1,
+                                  generateMips ? width : 0, height);
+    }
+
+    // Pre-built chains (DDS): each region's bufferOffset is relative to
+    // `data`. All `mipLevels` levels end SHADER_READ_ONLY_OPTIMAL.
+    Ticket uploadImageMips(VkImage image, const void* data, VkDeviceSize size,
+                           const VkBufferImageCopy* regions, uint32_t regionCount, uint32_t mipLevels) {
+        return uploadImageRegions(image, data, size, regions, regionCount, mipLevels, 0, 0);
+    }
+
+    // Level 0 of one array layer from tightly packed (or block-compressed)
+    // `data`; only that layer is transitioned, ending SHADER_READ_ONLY_OPTIMAL
+    Ticket uploadImageLayer(VkImage image, const void* data, VkDeviceSize size,
+                            uint32_t width, uint32_t height, uint32_t layer) {
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = layer;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {width, height, 1};
+        return uploadImageRegions(image, data, size, &region, 1, 1, 0, 0, layer);
+    }
+
+    // Level 0 of `image` from a caller-owned buffer (TRANSFER_SRC usage)
+    // instead of the staging ring - e.g. persistently mapped memory the CPU
+    // writes frames into in place, so nothing is memcpy'd. Region offsets
+    // are relative to srcBuffer, whose bytes must stay put until the ticket
+    // completes. The old contents are discarded, and the copy waits for
+    // earlier fragment/compute reads of the image on this queue, so
+    // streamed images (video) can be rewritten every frame. Ends
+    // SHADER_READ_ONLY_OPTIMAL.
+    Ticket copyBufferToImage(VkImage image, VkBuffer srcBuffer,
+                             const VkBufferImageCopy* regions, uint32_t regionCount) {
+        if (m_device == VK_NULL_HANDLE || regionCount == 0) return NO_UPLOAD;
+        if (!m_recording && !beginRecording()) return NO_UPLOAD;
+
+        recordImageCopy(image, srcBuffer, 0, regions, regionCount, 1, 0, 0, 0,
+                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        return finishUpload();
+    }
+
+    // ========================================================================
+    // Device Copies (no staging)
+    // ========================================================================
+
+    // GPU-side buffer copy, e.g. moving a buffer between memory heaps. src
+    // needs TRANSFER_SRC usage, dst TRANSFER_DST; like uploadBuffer(), later
+    // vertex/index/shader reads on this queue see the result.
+    Ticket copyBuffer(VkBuffer src, VkBuffer dst, VkDeviceSize size) {
+        if (m_device == VK_NULL_HANDLE || size == 0) return NO_UPLOAD;
+        if (!m_recording && !beginRecording()) return NO_UPLOAD;
+
+        VkBufferCopy region{};
+        region.size = size;
+        vkCmdCopyBuffer(m_cmd, src, dst, 1, &region);
+        m_writesBuffers = true;
+        return finishUpload();
+    }
+
+    // Levels [srcBaseMip, srcBaseMip + levels) of shader-readable `src` into
+    // levels [0, levels) of `dst` (same format; width x height is dst level
+    // 0) - a smaller copy of a texture without re-reading its file. src
+    // needs TRANSFER_SRC usage and stays SHADER_READ_ONLY_OPTIMAL; dst's
+    // old contents are discarded and it ends SHADER_READ_ONLY_OPTIMAL.
+    Ticket copyImageMips(VkImage src, VkImage dst, uint32_t srcBaseMip, uint32_t levels,
+                         uint32_t width, uint32_t height) {
+        if (m_device == VK_NULL_HANDLE || levels == 0) return NO_UPLOAD;
+        if (!m_recording && !beginRecording()) return NO_UPLOAD;
+
+        VkImageMemoryBarrier barriers[2]{};
+        for (VkImageMemoryBarrier& barrier : barriers) {
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.levelCount = levels;
+            barrier.subresourceRange.layerCount = 1;
+        }
+        barriers[0].image = src;
+        barriers[0].subresourceRange.baseMipLevel = srcBaseMip;
+        barriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barriers[1].image = dst;
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(m_cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 2, barriers);
+
+        std::vector<VkImageCopy> regions(levels);
+        for (uint32_t level = 0; level < levels; level++) {
+            VkImageCopy& region = regions[level];
+            region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.srcSubresource.mipLevel = srcBaseMip + level;
+            region.srcSubresource.layerCount = 1;
+            region.dstSubresource = region.srcSubresource;
+            region.dstSubresource.mipLevel = level;
+            region.extent = {std::max(width >> level, 1u), std::max(height >> level, 1u), 1};
+        }
+        vkCmdCopyImage(m_cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       levels, regions.data());
+
+        barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(m_cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 2, barriers);
+        return finishUpload();
+    }
+
+    // Retires finished batches (oldest first - one queue, in-order fences)
+    void poll() {
+        while (!m_inFlight.empty() &&
+               vkGetFenceStatus(m_device, m_inFlight.front().fence) == VK_SUCCESS) {
+            retireFront();
+        }
+    }
+
+    bool isComplete(Ticket ticket) const { return ticket <= m_completedTicket; }
+
+    // Blocks until `ticket` has landed, submitting the open batch if it is
+    // the one carrying it
+    void wait(Ticket ticket) {
+        if (m_device == VK_NULL_HANDLE || isComplete(ticket)) return;
+        if (m_recording && ticket >= m_recordingTicket) submit();
+
+        while (!m_inFlight.empty() && !isComplete(ticket)) {
+            vkWaitForFences(m_device, 1, &m_inFlight.front().fence, VK_TRUE, UINT64_MAX);
+            retireFront();
+        }
+    }
+
+    void waitIdle() {
+        while (!m_inFlight.empty()) {
+            vkWaitForFences(m_device, 1, &m_inFlight.front().fence, VK_TRUE, UINT64_MAX);
+            retireFront();
+        }
+    }
+
+    VkDeviceSize getRingSize() const { return m_ringSize; }
+    size_t getInFlightCount() const { return m_inFlight.size(); }
+    uint64_t getSubmitCount() const { return m_submitCount; }
+
+private:
+    struct Batch {
+        Ticket ticket = NO_UPLOAD;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        VkDeviceSize ringEnd = 0;          // Ring bytes before this are free once retired
+        bool usesRing = false;             // Copy-only batches leave m_tail alone
+    };
+
+    static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    Ticket uploadImageRegions(VkImage image, const void* data, VkDeviceSize size,
+                              const VkBufferImageCopy* regions, uint32_t regionCount,
+                              uint32_t mipLevels, uint32_t blitWidth, uint32_t blitHeight,
+                              uint32_t layer = 0) {
+        if (m_device == VK_NULL_HANDLE || size == 0 || regionCount == 0) return NO_UPLOAD;
+
+        VkDeviceSize srcOffset;
+        if (!stage(data, size, srcOffset)) return NO_UPLOAD;
+
+        recordImageCopy(image, m_ring, srcOffset, regions, regionCount, mipLevels, blitWidth, blitHeight, layer,
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        return finishUpload();
+    }
+
+    // Layout transitions around one vkCmdCopyBufferToImage into `image`;
+    // `waitStages` are the earlier reads of the image the copy must follow
+    void recordImageCopy(VkImage image, VkBuffer src, VkDeviceSize srcOffset,
+                         const VkBufferImageCopy* regions, uint32_t regionCount,
+                         uint32_t mipLevels, uint32_t blitWidth, uint32_t blitHeight,
+                         uint32_t layer, VkPipelineStageFlags waitStages) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = mipLevels;
+        barrier.subresourceRange.baseArrayLayer = layer;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(m_cmd, waitStages, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        m_regions.assign(regions, regions + regionCount);
+        for (auto& region : m_regions) region.bufferOffset += srcOffset;
+        vkCmdCopyBufferToImage(m_cmd, src, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               regionCount, m_regions.data());
+
+        if (blitWidth != 0) {
+            recordMipChain(m_cmd, image, blitWidth, blitHeight, mipLevels);
+        } else {
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(m_cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+    }
+
+    // Batches of one for uploads made outside begin()/end()
+    Ticket finishUpload() {
+        m_uploadCount++;
+        return m_depth > 0 ? m_recordingTicket : submit();
+    }
+
+    // Copies `size` bytes into the ring and makes sure a command buffer is
+    // recording. srcOffset is where they landed.
+    bool stage(const void* data, VkDeviceSize size, VkDeviceSize& srcOffset) {
+        if (!reserve(size, srcOffset)) {
+            std::cerr << "[UploadBatch] Failed to stage " << (size / 1024) << " KB" << std::endl;
+            return false;
+        }
+        if (!m_recording && !beginRecording()) return false;
+
+        memcpy(static_cast<uint8_t*>(m_ringAlloc.mapped) + srcOffset, data, static_cast<size_t>(size));
+        m_head = srcOffset + size;
+        m_recordingUsesRing = true;
+        return true;
+    }
+
+    // Live ring bytes are [m_tail, m_head), wrapping at m_ringSize. m_tail
+    // is where the oldest unretired batch (or the open one) starts. Only
+    // batches that staged bytes count: with none left the ring is empty even
+    // if copy-only batches are still in flight, and head == tail means full.
+    bool reserve(VkDeviceSize size, VkDeviceSize& offset) {
+        for (;;) {
+            bool empty = m_ringBatches == 0 && !m_recordingUsesRing;
+            if (empty) {
+                m_head = m_tail = 0;
+            }
+
+            VkDeviceSize start = alignUp(m_head, STAGING_ALIGNMENT);
+            if (empty || m_head > m_tail) {
+                if (empty && size > m_ringSize) {
+                    if (!createRing(alignUp(size, DEFAULT_RING_SIZE))) return false;
+                    continue;
+                }
+                if (start + size <= m_ringSize) { offset = start; return true; }
+                if (size < m_tail) { offset = 0; return true; }      // Wrap
+            } else if (start + size < m_tail) {
+                offset = start;
+                return true;
+            }
+
+            // No room: free the oldest batch holding bytes, or flush the open one
+            if (m_ringBatches > 0) {
+                vkWaitForFences(m_device, 1, &m_inFlight.front().fence, VK_TRUE, UINT64_MAX);
+                retireFront();
+            } else if (m_recording) {
+                submit();
+            } else {
+                return false;
+            }
+        }
+    }
+
+    bool createRing(VkDeviceSize size) {
+        if (m_ring != VK_NULL_HANDLE) {
+            m_allocator->destroyBuffer(m_ring, m_ringAlloc);
+            std::cout << "[UploadBatch] Growing staging ring to " << (size / (1024 * 1024)) << " MB" << std::endl;
+        }
+        if (!m_allocator->createStagingBuffer(size, m_ring, m_ringAlloc)) {
+            m_ringSize = 0;
+            return false;
+        }
+        m_ringSize = size;
+        m_head = m_tail = 0;
+        return true;
+    }
+
+    bool beginRecording() {
+        if (!m_freeCommandBuffers.empty()) {
+            m_cmd = m_freeCommandBuffers.back();
+            m_freeCommandBuffers.pop_back();
+        } else {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = m_commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(m_device, &allocInfo, &m_cmd) != VK_SUCCESS) {
+                std::cerr << "[UploadBatch] Failed to allocate a command buffer" << std::endl;
+                m_cmd = VK_NULL_HANDLE;
+                return false;
+            }
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(m_cmd, &beginInfo);
+
+        m_recording = true;
+        m_recordingUsesRing = false;
+        m_writesBuffers = false;
+        return true;
+    }
+
+    // One vkQueueSubmit + fence for everything recorded
+    Ticket submit() {
+        if (!m_recording) return m_lastTicket;
+
+        if (m_writesBuffers) {
+            // Later submissions on this queue read the data without a CPU wait
+            VkMemoryBarrier release{};
+            release.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            release.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                    VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(m_cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0, 1, &release, 0, nullptr, 0, nullptr);
+        }
+        vkEndCommandBuffer(m_cmd);
+
+        Batch batch;
+        batch.ticket = m_recordingTicket;
+        batch.cmd = m_cmd;
+        batch.ringEnd = m_head;
+        batch.usesRing = m_recordingUsesRing;
+        if (!m_freeFences.empty()) {
+            batch.fence = m_freeFences.back();
+            m_freeFences.pop_back();
+        } else {
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            vkCreateFence(m_device, &fenceInfo, nullptr, &batch.fence);
+        }
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.cmd;
+
+        m_recording = false;
+        m_recordingUsesRing = false;
+        m_cmd = VK_NULL_HANDLE;
+
+        if (vkQueueSubmit(m_queue, 1, &submitInfo, batch.fence) != VK_SUCCESS) {
+            // Nothing landed; the ring bytes are reclaimed once the ring drains
+            std::cerr << "[UploadBatch] vkQueueSubmit failed - dropping " << m_uploadCount << " uploads" << std::endl;
+            vkResetCommandBuffer(batch.cmd, 0);
+            m_freeCommandBuffers.push_back(batch.cmd);
+            m_freeFences.push_back(batch.fence);
+            m_uploadCount = 0;
+            return NO_UPLOAD;
+        }
+
+        m_inFlight.push_back(batch);
+        if (batch.usesRing) m_ringBatches++;
+        m_lastTicket = m_recordingTicket++;
+        m_uploadCount = 0;
+        m_submitCount++;
+        return m_lastTicket;
+    }
+
+    void retireFront() {
+        Batch& batch = m_inFlight.front();
+        vkResetCommandBuffer(batch.cmd, 0);
+        vkResetFences(m_device, 1, &batch.fence);
+        m_freeCommandBuffers.push_back(batch.cmd);
+        m_freeFences.push_back(batch.fence);
+        m_completedTicket = batch.ticket;
+        if (batch.usesRing) {
+            m_tail = batch.ringEnd;
+            m_ringBatches--;
+        }
+        m_inFlight.pop_front();
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    GpuAllocator* m_allocator = nullptr;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+
+    // Persistent staging ring
+    VkBuffer m_ring = VK_NULL_HANDLE;
+    GpuAllocation m_ringAlloc;
+    VkDeviceSize m_ringSize = 0;
+    VkDeviceSize m_head = 0;
+    VkDeviceSize m_tail = 0;
+    uint32_t m_ringBatches = 0;      // In-flight batches holding ring bytes
+
+    // Open batch
+    VkCommandBuffer m_cmd = VK_NULL_HANDLE;
+    bool m_recording = false;
+    bool m_recordingUsesRing = false;
+    bool m_writesBuffers = false;
+    uint32_t m_depth = 0;
+    uint32_t m_uploadCount = 0;
+    std::vector<VkBufferImageCopy> m_regions;
+
+    std::deque<Batch> m_inFlight;
+    std::vector<VkCommandBuffer> m_freeCommandBuffers;
+    std::vector<VkFence> m_freeFences;
+
+    Ticket m_recordingTicket = 1;   // Ticket of the batch being recorded
+    Ticket m_lastTicket = NO_UPLOAD;
+    Ticket m_completedTicket = 0;   // Every batch <= this has landed
+    uint64_t m_submitCount = 0;
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_UPLOAD_BATCH_H
@@ -0,0 +1,297 @@
+// ============================================================================
+// UPLOAD MANAGER - Batched staging copies on the transfer queue
+// ============================================================================
+// Gets geometry into DEVICE_LOCAL memory without stalling the graphics queue.
+//
+//   - uploadBuffer() copies into a staging sub-allocation and queues a
+//     vkCmdCopyBuffer; nothing is submitted yet.
+//   - flush() records every queued copy into ONE command buffer and submits
+//     it to the transfer queue with a fence (VK 1.0 - no timeline semaphores).
+//   - poll() retires finished batches (oldest first) and frees their staging.
+//   - Each upload returns a Ticket; isComplete(ticket) says the data landed.
+//
+// Runs on a dedicated transfer queue family when the device has one. The
+// destination buffers must then be created VK_SHARING_MODE_CONCURRENT across
+// the graphics and transfer families (VulkanCore does this), so no queue
+// ownership transfer barriers are needed.
+//
+// Header-only, like gpu_allocator.h. Not thread-safe: call from the render
+// thread.
+//
+// Usage:
+//   UploadManager uploads;
+//   uploads.init(device, &allocator, transferQueue, transferFamily);
+//   Ticket t = uploads.uploadBuffer(dstBuffer, data, size);
+//   uploads.flush();                   // once per frame
+//   uploads.poll();                    // once per frame
+//   if (uploads.isComplete(t)) draw();
+//   uploads.shutdown();                // before allocator.shutdown()
+// ============================================================================
+
+#ifndef VKCORE_UPLOAD_MANAGER_H
+#define VKCORE_UPLOAD_MANAGER_H
+
+#include "gpu_allocator.h"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <deque>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+namespace vkcore {
+
+class UploadManager {
+public:
+    using Ticket = uint64_t;               // 0 = nothing to wait for
+    static constexpr Ticket NO_UPLOAD = 0;
+
+    // Queued staging bytes that force an early flush (bounds staging memory)
+    static constexpr VkDeviceSize MAX_BATCH_BYTES = 32ull * 1024 * 1024;
+
+    UploadManager() = default;
+    ~UploadManager() { shutdown(); }
+
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    bool init(VkDevice device, GpuAllocator* allocator, VkQueue queue, uint32_t queueFamily) {
+        if (m_device != VK_NULL_HANDLE) return true;
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = queueFamily;
+
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+            std::cerr << "[UploadManager] Failed to create transfer command pool" << std::endl;
+            return false;
+        }
+
+        m_device = device;
+        m_allocator = allocator;
+        m_queue = queue;
+        m_queueFamily = queueFamily;
+        return true;
+    }
+
+    // Waits for in-flight batches, drops anything never flushed
+    void shutdown() {
+        if (m_device == VK_NULL_HANDLE) return;
+
+        waitIdle();
+        for (auto& copy : m_pending) {
+            m_allocator->destroyBuffer(copy.staging, copy.stagingAlloc);
+        }
+        m_pending.clear();
+
+        for (VkFence fence : m_freeFences) {
+            vkDestroyFence(m_device, fence, nullptr);
+        }
+        m_freeFences.clear();
+        m_freeCommandBuffers.clear();  // Freed with the pool
+
+        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+        m_commandPool = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+        m_allocator = nullptr;
+    }
+
+    bool isInitialized() const { return m_device != VK_NULL_HANDLE; }
+    uint32_t getQueueFamily() const { return m_queueFamily; }
+
+    // ========================================================================
+    // Uploads
+    // ========================================================================
+
+    // Stages `size` bytes for dstBuffer (which needs TRANSFER_DST usage).
+    // Returns the ticket of the batch that will carry the copy, or
+    // NO_UPLOAD if staging memory could not be allocated.
+    Ticket uploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0) {
+        if (m_device == VK_NULL_HANDLE || size == 0) return NO_UPLOAD;
+
+        if (m_pendingBytes + size > MAX_BATCH_BYTES && !m_pending.empty()) {
+            flush();
+        }
+
+        PendingCopy copy;
+        if (!m_allocator->createStagingBuffer(size, copy.staging, copy.stagingAlloc)) {
+            std::cerr << "[UploadManager] Failed to allocate " << (size / 1024) << " KB of staging" << std::endl;
+            return NO_UPLOAD;
+        }
+        memcpy(copy.stagingAlloc.mapped, data, static_cast<size_t>(size));
+        copy.dst = dstBuffer;
+        copy.size = size;
+        copy.dstOffset = dstOffset;
+
+        m_pending.push_back(copy);
+        m_pendingBytes += size;
+        return m_recordingTicket;
+    }
+
+    // Submits every queued copy as one batch. Cheap no-op when idle.
+    void flush() {
+        if (m_pending.empty()) return;
+
+        Batch batch;
+        batch.ticket = m_recordingTicket;
+        if (!acquireBatchObjects(batch)) {
+            std::cerr << "[UploadManager] Failed to get a command buffer/fence - keeping "
+                      << m_pending.size() << " copies queued" << std::endl;
+            return;
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(batch.cmd, &beginInfo);
+
+        for (const auto& copy : m_pending) {
+            VkBufferCopy region{};
+            region.srcOffset = 0;
+            region.dstOffset = copy.dstOffset;
+            region.size = copy.size;
+            vkCmdCopyBuffer(batch.cmd, copy.staging, copy.dst, 1, &region);
+        }
+
+        vkEndCommandBuffer(batch.cmd);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.cmd;
+
+        if (vkQueueSubmit(m_queue, 1, &submitInfo, batch.fence) != VK_SUCCESS) {
+            std::cerr << "[UploadManager] vkQueueSubmit failed - keeping copies queued" << std::endl;
+            releaseBatchObjects(batch);
+            return;
+        }
+
+        batch.staging.swap(m_pending);
+        m_pendingBytes = 0;
+        m_inFlight.push_back(std::move(batch));
+        m_recordingTicket++;
+    }
+
+    // Retires finished batches. Batches on one queue finish in submission
+    // order, so only the front is checked.
+    void poll() {
+        while (!m_inFlight.empty() &&
+               vkGetFenceStatus(m_device, m_inFlight.front().fence) == VK_SUCCESS) {
+            retireFront();
+        }
+    }
+
+    bool isComplete(Ticket ticket) const { return ticket <= m_completedTicket; }
+
+    // Blocks until `ticket` has landed (flushing it first if still queued)
+    void wait(Ticket ticket) {
+        if (m_device == VK_NULL_HANDLE || isComplete(ticket)) return;
+        if (ticket >= m_recordingTicket) flush();
+
+        while (!m_inFlight.empty() && !isComplete(ticket)) {
+            vkWaitForFences(m_device, 1, &m_inFlight.front().fence, VK_TRUE, UINT64_MAX);
+            retireFront();
+        }
+    }
+
+    void waitIdle() {
+        while (!m_inFlight.empty()) {
+            vkWaitForFences(m_device, 1, &m_inFlight.front().fence, VK_TRUE, UINT64_MAX);
+            retireFront();
+        }
+    }
+
+    size_t getPendingCount() const { return m_pending.size(); }
+    size_t getInFlightCount() const { return m_inFlight.size(); }
+
+private:
+    struct PendingCopy {
+        VkBuffer staging = VK_NULL_HANDLE;
+        GpuAllocation stagingAlloc;
+        VkBuffer dst = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        VkDeviceSize dstOffset = 0;
+    };
+
+    struct Batch {
+        Ticket ticket = NO_UPLOAD;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        std::vector<PendingCopy> staging;  // Freed when the fence signals
+    };
+
+    bool acquireBatchObjects(Batch& batch) {
+        if (!m_freeCommandBuffers.empty()) {
+            batch.cmd = m_freeCommandBuffers.back();
+            m_freeCommandBuffers.pop_back();
+        } else {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = m_commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(m_device, &allocInfo, &batch.cmd) != VK_SUCCESS) {
+                return false;
+            }
+        }
+
+        if (!m_freeFences.empty()) {
+            batch.fence = m_freeFences.back();
+            m_freeFences.pop_back();
+        } else {
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            if (vkCreateFence(m_device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS) {
+                m_freeCommandBuffers.push_back(batch.cmd);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void releaseBatchObjects(Batch& batch) {
+        vkResetCommandBuffer(batch.cmd, 0);
+        vkResetFences(m_device, 1, &batch.fence);
+        m_freeCommandBuffers.push_back(batch.cmd);
+        m_freeFences.push_back(batch.fence);
+        batch.cmd = VK_NULL_HANDLE;
+        batch.fence = VK_NULL_HANDLE;
+    }
+
+    void retireFront() {
+        Batch& batch = m_inFlight.front();
+        for (auto& copy : batch.staging) {
+            m_allocator->destroyBuffer(copy.staging, copy.stagingAlloc);
+        }
+        releaseBatchObjects(batch);
+        m_completedTicket = batch.ticket;
+        m_inFlight.pop_front();
+    }
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    GpuAllocator* m_allocator = nullptr;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    uint32_t m_queueFamily = 0;
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+
+    std::vector<PendingCopy> m_pending;
+    VkDeviceSize m_pendingBytes = 0;
+    std::deque<Batch> m_inFlight;
+
+    std::vector<VkCommandBuffer> m_freeCommandBuffers;
+    std::vector<VkFence> m_freeFences;
+
+    Ticket m_recordingTicket = 1;   // Ticket handed to copies queued right now
+    Ticket m_completedTicket = 0;   // Every batch <= this has landed
+};
+
+} // namespace vkcore
+
+#endif // VKCORE_UPLOAD_MANAGER_H
@@ -0,0 +1,239 @@
+// ============================================================================
+// VERTEX PACKING - Compact vertex encodings for the PACKED_* VertexFormats
+// ============================================================================
+// The float formats spend 32 (POSITION_NORMAL_UV) or 40 bytes
+// (POSITION_NORMAL_UV0_UV1) per vertex. The packed ones hold the same
+// attributes in 16 / 20:
+//
+//   position  R16G16B16A16_UNORM  xyz quantized to the mesh's bounding cube
+//   normal    R16G16_SNORM        octahedral (Meyer et al.); the shader
+//                                 variant unfolds it (octDecode below)
+//   uv0, uv1  R16G16_SFLOAT       half floats: exact to 1/2048 in [0.5, 1),
+//                                 a texel at 2048 pixels
+//
+// Positions come out of the vertex fetch in [0, 1]. VertexQuantization is
+// the per-mesh matrix back to model space; VulkanCore keeps it with the mesh
+// and folds it into the model matrix of every draw, so shaders transform the
+// fetched position as before. Its scale is the same on all three axes (the
+// longest side of the bounds), so normal matrices are unaffected.
+//
+// Shader variants are the same sources built with -DVERTEX_PACKED
+// (vertexShaderVariant() names the output), which only changes how the
+// normal is read:
+//
+//   #ifdef VERTEX_PACKED
+//   layout(location = 1) in vec2 inNormalOct;
+//   vec3 octDecode(vec2 e) {
+//       vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+//       float t = max(-n.z, 0.0);
+//       n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+//       return normalize(n);
+//   }
+//   #endif
+//
+// Header-only, like mesh_lod.h.
+//
+// Usage:
+//   VertexQuantization q = computeVertexQuantization(floats, 8, vertexCount);
+//   std::vector<PackedVertex> packed(vertexCount);
+//   packVertices(floats, 8, vertexCount, q, packed.data());
+//   glm::mat4 model = world * q.matrix();
+// ============================================================================
+
+#ifndef VKCORE_VERTEX_PACKING_H
+#define VKCORE_VERTEX_PACKING_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace vkcore {
+
+// PACKED_POSITION_NORMAL_UV
+struct PackedVertex {
+    uint16_t position[4];  // xyz unorm, w unused
+    int16_t normal[2];     // Octahedral snorm
+    uint16_t uv[2];        // Half floats
+};
+
+// PACKED_POSITION_NORMAL_UV0_UV1
+struct PackedVertexUV1 {
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+    uint16_t uv1[2];
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+static_assert(sizeof(PackedVertexUV1) == 20, "PackedVertexUV1 must stay 20 bytes");
+
+// Model-space position = offset + scale * fetched position (each in [0, 1])
+struct VertexQuantization {
+    glm::vec3 offset = glm::vec3(0.0f);
+    float scale = 1.0f;
+
+    glm::mat4 matrix() const {
+        glm::mat4 m(scale);
+        m[3] = glm::vec4(offset, 1.0f);
+        return m;
+    }
+
+    glm::vec3 decode(const uint16_t position[3]) const {
+        return offset + scale * glm::vec3(position[0], position[1], position[2]) / 65535.0f;
+    }
+};
+
+// Round-to-nearest-even; overflow goes to infinity, tiny values to subnormals
+inline uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {  // Inf / NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477FF000u) return static_cast<uint16_t>(sign | 0x7C00u);  // Rounds past 65504
+    if (magnitude < 0x38800000u) {
+        // Subnormal half: shift the implicit-one mantissa into place
+        if (magnitude < 0x33000000u) return static_cast<uint16_t>(sign);
+        uint32_t exponent = magnitude >> 23;
+        uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        uint32_t shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = ((magnitude - 0x38000000u) >> 13);
+    uint32_t rest = magnitude & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;
+    return static_cast<uint16_t>(sign | half);
+}
+
+inline float halfToFloat(uint16_t half) {
+    uint32_t sign = uint32_t(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // Subnormal: normalize into a float exponent
+        exponent = 113;
+        while (!(mantissa & 0x400u)) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline int16_t floatToSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::min(1.0f, std::max(-1.0f, value)) * 32767.0f));
+}
+
+// Unit vector onto the octahedron, folded into [-1, 1]^2
+inline void packOctahedral(const glm::vec3& n, int16_t out[2]) {
+    float sum = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+    if (sum <= 0.0f) {
+        out[0] = out[1] = 0;  // Decodes to +Z
+        return;
+    }
+    float x = n.x / sum, y = n.y / sum;
+    if (n.z < 0.0f) {
+        float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    out[0] = floatToSnorm16(x);
+    out[1] = floatToSnorm16(y);
+}
+
+// CPU mirror of the shader's octDecode
+inline glm::vec3 unpackOctahedral(const int16_t in[2]) {
+    glm::vec3 n(std::max(-1.0f, in[0] / 32767.0f), std::max(-1.0f, in[1] / 32767.0f), 0.0f);
+    n.z = 1.0f - std::fabs(n.x) - std::fabs(n.y);
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+// Bounding cube of the positions (first 3 floats of each vertex)
+inline VertexQuantization computeVertexQuantization(const float* vertices, uint32_t strideFloats, uint32_t count) {
+    VertexQuantization q;
+    if (!vertices || count == 0) return q;
+    glm::vec3 lo(vertices[0], vertices[1], vertices[2]), hi = lo;
+    for (uint32_t i = 1; i < count; i++) {
+        const float* p = vertices + size_t(i) * strideFloats;
+        lo = glm::min(lo, glm::vec3(p[0], p[1], p[2]));
+        hi = glm::max(hi, glm::vec3(p[0], p[1], p[2]));
+    }
+    glm::vec3 extent = hi - lo;
+    float side = std::max(extent.x, std::max(extent.y, extent.z));
+    q.offset = lo;
+    q.scale = side > 0.0f ? side : 1.0f;
+    return q;
+}
+
+namespace packing_detail {
+
+inline void packCommon(const float* v, const VertexQuantization& q, uint16_t position[4], int16_t normal[2],
+                       uint16_t uv[2]) {
+    for (int c = 0; c < 3; c++) {
+        float unit = (v[c] - q.offset[c]) / q.scale;
+        position[c] = static_cast<uint16_t>(std::lround(std::min(1.0f, std::max(0.0f, unit)) * 65535.0f));
+    }
+    position[3] = 0;
+    packOctahedral(glm::vec3(v[3], v[4], v[5]), normal);
+    uv[0] = floatToHalf(v[6]);
+    uv[1] = floatToHalf(v[7]);
+}
+
+} // namespace packing_detail
+
+// POSITION_NORMAL_UV floats (stride >= 8) to PACKED_POSITION_NORMAL_UV
+inline void packVertices(const float* vertices, uint32_t strideFloats, uint32_t count, const VertexQuantization& q,
+                         PackedVertex* out) {
+    for (uint32_t i = 0; i < count; i++) {
+        packing_detail::packCommon(vertices + size_t(i) * strideFloats, q, out[i].position, out[i].normal, out[i].uv);
+    }
+}
+
+// POSITION_NORMAL_UV0_UV1 floats (stride >= 10) to PACKED_POSITION_NORMAL_UV0_UV1
+inline void packVertices(const float* vertices, uint32_t strideFloats, uint32_t count, const VertexQuantization& q,
+                         PackedVertexUV1* out) {
+    for (uint32_t i = 0; i < count; i++) {
+        const float* v = vertices + size_t(i) * strideFloats;
+        packing_detail::packCommon(v, q, out[i].position, out[i].normal, out[i].uv);
+        out[i].uv1[0] = floatToHalf(v[8]);
+        out[i].uv1[1] = floatToHalf(v[9]);
+    }
+}
+
+// "shaders/lit_mesh.vert.spv" -> "shaders/lit_mesh.packed.vert.spv": what
+// glslc -DVERTEX_PACKED writes the packed variant of a vertex shader as
+inline std::string packedShaderPath(const std::string& path) {
+    if (path.find(".packed.") != std::string::npos) return path;
+    size_t slash = path.find_last_of("/\\");
+    size_t dot = path.find('.', slash == std::string::npos ? 0 : slash + 1);
+    if (dot == std::string::npos) return path + ".packed";
+    return path.substr(0, dot) + ".packed" + path.substr(dot);
+}
+
+} // namespace vkcore
+
+#endif // VKCORE_VERTEX_PACKING_H
@@ -5,6 +5,7 @@
 // ============================================================================
 
 #include "vulkan_core.h"
+#include "draw_capture.h"
 
 #include <iostream>
 #include <fstream>
@@ -17,6 +18,19 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "../../stdlib/stb_image.h"
 
+// KTX2 containers (block-compressed, pre-mipped textures)
+#include "../../stdlib/ktx2_loader.h"
+
+// Path canonicalization for the loadTexture() cache
+#include "../../stdlib/resource_cache.h"
+#include "../../stdlib/vfs.h"
+
+// Parallel stb_image decoding for loadTextures()
+#include "../../stdlib/image_decode.h"
+
+// EDEN_PROFILE_API() zones on the C API (with EDEN_PROFILE_SYSTEMS)
+#include "../../stdlib/system_profiler.h"
+
 // ImGui includes (must be before namespace)
 #ifdef VKCORE_ENABLE_IMGUI
 #include <imgui.h>
@@ -77,10 +91,13 @@ static const uint32_t CUBE_INDICES[] = {
 // Constructor / Destructor
 // ============================================================================
 
+VulkanCore* VulkanCore::s_active = nullptr;
+
 VulkanCore::VulkanCore() {
     m_viewMatrix = glm::lookAt(glm::vec3(0, 2, 5), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
     m_projMatrix = glm::perspective(glm::radians(60.0f), 16.0f/9.0f, 0.1f, 1000.0f);
     m_projMatrix[1][1] *= -1;  // Vulkan Y flip
+    updateFrustum();
 }
 
 VulkanCore::~VulkanCore() {
@@ -96,26 +113,55 @@ bool VulkanCore::init(GLFWwindow* window, const CoreConfig& config) {
     
     m_window = window;
     m_config = config;
+    m_framesInFlight = std::clamp<uint32_t>(config.framesInFlight, 1, MAX_FRAMES_IN_FLIGHT);
+    
+    std::cout << "[VulkanCore] Initializing..." << (m_config.headless ? " (headless)" : "") << std::endl;
     
-    std::cout << "[VulkanCore] Initializing..." << std::endl;
+    if (!window && !m_config.headless) {
+        std::cerr << "[VulkanCore] FAILED: no window (set CoreConfig::headless to render offscreen)" << std::endl;
+        return false;
+    }
     
     if (!createInstance()) { std::cerr << "[VulkanCore] FAILED: createInstance" << std::endl; return false; }
-    if (!createSurface(window)) { std::cerr << "[VulkanCore] FAILED: createSurface" << std::endl; return false; }
+    if (!m_config.headless && !createSurface(window)) { std::cerr << "[VulkanCore] FAILED: createSurface" << std::endl; return false; }
     if (!selectPhysicalDevice()) { std::cerr << "[VulkanCore] FAILED: selectPhysicalDevice" << std::endl; return false; }
     if (!createLogicalDevice()) { std::cerr << "[VulkanCore] FAILED: createLogicalDevice" << std::endl; return false; }
-    if (!createSwapchain()) { std::cerr << "[VulkanCore] FAILED: createSwapchain" << std::endl; return false; }
+    m_pipelineCache.init(m_device, m_physicalDevice);  // Non-fatal: pipelines just compile uncached
+    if (m_config.headless ? !createOffscreenTargets() : !createSwapchain()) { std::cerr << "[VulkanCore] FAILED: createSwapchain" << std::endl; return false; }
     if (!createDepthResources()) { std::cerr << "[VulkanCore] FAILED: createDepthResources" << std::endl; return false; }
     if (!createRenderPass()) { std::cerr << "[VulkanCore] FAILED: createRenderPass" << std::endl; return false; }
     if (!createDescriptorSetLayout()) { std::cerr << "[VulkanCore] FAILED: createDescriptorSetLayout" << std::endl; return false; }
     if (!createDescriptorPool()) { std::cerr << "[VulkanCore] FAILED: createDescriptorPool" << std::endl; return false; }
+    if (m_dynamicRes.isEnabled() && !m_dynamicRes.createPipeline(m_uiRenderPass, m_pipelineCache.get(), m_descriptors)) {
+        std::cerr << "[VulkanCore] FAILED: dynamic resolution upscale pipeline" << std::endl;
+        return false;
+    }
     if (!createFramebuffers()) { std::cerr << "[VulkanCore] FAILED: createFramebuffers" << std::endl; return false; }
     if (!createCommandPool()) { std::cerr << "[VulkanCore] FAILED: createCommandPool" << std::endl; return false; }
     if (!createCommandBuffers()) { std::cerr << "[VulkanCore] FAILED: createCommandBuffers" << std::endl; return false; }
     if (!createSyncObjects()) { std::cerr << "[VulkanCore] FAILED: createSyncObjects" << std::endl; return false; }
+    if (!createRecordWorkers()) { std::cerr << "[VulkanCore] FAILED: createRecordWorkers" << std::endl; return false; }
     if (!createDefaultResources()) { std::cerr << "[VulkanCore] FAILED: createDefaultResources" << std::endl; return false; }
     
+    if (m_config.gpuProfiling) {
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, families.data());
+        m_gpuProfiler.init(m_device, m_physicalDevice, families[m_graphicsFamily].timestampValidBits,
+                           m_framesInFlight);  // Non-fatal: scopes become no-ops
+    }
+    if (m_config.maxOcclusionQueries > 0) {
+        m_occlusion.init(m_device, m_config.maxOcclusionQueries, m_framesInFlight);  // Non-fatal: all visible
+    }
+    
+    // After the default resources: replay has its own
+    if (m_config.captureResources) m_drawCapture = std::make_unique<DrawCapture>();
+    
     m_initialized = true;
-    std::cout << "[VulkanCore] Ready! (" << m_swapchainExtent.width << "x" << m_swapchainExtent.height << ")" << std::endl;
+    s_active = this;
+    std::cout << "[VulkanCore] Ready! (" << m_swapchainExtent.width << "x" << m_swapchainExtent.height
+              << (m_config.headless ? ", headless" : "") << ")" << std::endl;
     return true;
 }
 
@@ -127,50 +173,82 @@ void VulkanCore::shutdown() {
     // Shutdown ImGui if initialized
     shutdownImGui();
     
-    // Destroy resources
-    for (auto& mesh : m_meshes) {
-        if (mesh.valid) {
-            destroyBuffer(mesh.vertexBuffer);
-            destroyBuffer(mesh.indexBuffer);
-        }
-    }
+    m_framePrologues.clear();
+    
+    // Retire in-flight uploads and release their staging
+    m_uploads.shutdown();
+    m_uploadBatch.shutdown();
+    
+    // Destroys still waiting on frames in flight - the device is idle now
+    m_deletions.flushAll();
+    
+    // Destroy resources (mesh vertex/index buffers live in m_buffers)
     m_meshes.clear();
     
-    for (auto& buf : m_buffers) {
-        if (buf.valid) {
-            vkDestroyBuffer(m_device, buf.buffer, nullptr);
-            vkFreeMemory(m_device, buf.memory, nullptr);
-        }
-    }
+    destroyUniformRings();
+    destroyInstanceRings();
+    
+    m_buffers.forEach([&](BufferHandle, BufferResource& buf) {
+        m_allocator.destroyBuffer(buf.buffer, buf.alloc);
+    });
     m_buffers.clear();
     
-    for (auto& pipe : m_pipelines) {
-        if (pipe.valid) {
-            vkDestroyPipeline(m_device, pipe.pipeline, nullptr);
-            vkDestroyPipelineLayout(m_device, pipe.layout, nullptr);
-        }
-    }
+    m_textures.forEach([&](TextureHandle, TextureResource& tex) {
+        if (tex.sampler) vkDestroySampler(m_device, tex.sampler, nullptr);
+        if (tex.view) vkDestroyImageView(m_device, tex.view, nullptr);
+        m_allocator.destroyImage(tex.image, tex.alloc);
+    });
+    m_textures.clear();
+    m_textureCache.clear();
+    m_textureCachePaths.clear();
+    m_bindless.shutdown();
+    m_streamer.shutdown(m_allocator);
+    
+    m_pipelines.forEach([&](PipelineHandle, PipelineResource& pipe) {
+        destroyPipelineVariants(pipe);
+        vkDestroyPipeline(m_device, pipe.pipeline, nullptr);
+        vkDestroyPipelineLayout(m_device, pipe.layout, nullptr);
+    });
     m_pipelines.clear();
     
+    // Persist everything compiled this session for the next launch
+    m_pipelineCache.shutdown();
+    
+    m_asyncCompute.shutdown();
+    m_gpuProfiler.shutdown();
+    m_occlusion.shutdown();
+    m_pick.shutdown(m_allocator);
+    if (m_pickShader) vkDestroyShaderModule(m_device, m_pickShader, nullptr);
+    m_dynamicRes.shutdown(m_allocator, m_descriptors);
+    
     // Destroy Vulkan objects
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < m_framesInFlight; i++) {
         vkDestroySemaphore(m_device, m_imageAvailableSemaphores[i], nullptr);
         vkDestroySemaphore(m_device, m_renderFinishedSemaphores[i], nullptr);
         vkDestroyFence(m_device, m_inFlightFences[i], nullptr);
     }
     
+    destroyRecordWorkers();
     vkDestroyCommandPool(m_device, m_commandPool, nullptr);
     
     cleanupSwapchain();
     
-    vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    m_descriptors.printStats();
+    m_descriptors.shutdown();
     vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
     vkDestroyRenderPass(m_device, m_renderPass, nullptr);
+    if (m_uiRenderPass) vkDestroyRenderPass(m_device, m_uiRenderPass, nullptr);
+    
+    m_allocator.printStats();
+    m_allocator.shutdown();
     vkDestroyDevice(m_device, nullptr);
     vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
     vkDestroyInstance(m_instance, nullptr);
     
+    m_drawCapture.reset();  // An unfinished capture is dropped
+    
     m_initialized = false;
+    if (s_active == this) s_active = nullptr;
     std::cout << "[VulkanCore] Shutdown complete" << std::endl;
 }
 
@@ -187,14 +265,20 @@ bool VulkanCore::createInstance() {
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.apiVersion = VK_API_VERSION_1_0;
     
-    uint32_t glfwExtCount = 0;
-    const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
+    // Headless needs no surface extensions (and must not require glfwInit)
+    std::vector<const char*> extensions;
+    if (!m_config.headless) {
+        uint32_t glfwExtCount = 0;
+        const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
+        extensions.assign(glfwExts, glfwExts + glfwExtCount);
+    }
+    BindlessHeap::addInstanceExtensions(extensions);  // Feature queries on a 1.0 instance
     
     VkInstanceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     createInfo.pApplicationInfo = &appInfo;
-    createInfo.enabledExtensionCount = glfwExtCount;
-    createInfo.ppEnabledExtensionNames = glfwExts;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
     
     if (vkCreateInstance(&createInfo, nullptr, &m_instance) != VK_SUCCESS) {
         return false;
@@ -232,18 +316,60 @@ bool VulkanCore::selectPhysicalDevice() {
                 hasGraphics = true;
             }
             VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+            if (m_surface != VK_NULL_HANDLE) {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+            }
             if (presentSupport) {
                 m_presentFamily = i;
                 hasPresent = true;
             }
         }
         
+        // Nothing is presented headless
+        if (m_config.headless && hasGraphics) {
+            m_presentFamily = m_graphicsFamily;
+            hasPresent = true;
+        }
+        
         if (hasGraphics && hasPresent) {
+            // Prefer a transfer-only family (DMA engine), then any non-graphics
+            // family with transfer; otherwise uploads share the graphics queue
+            m_transferFamily = m_graphicsFamily;
+            int bestScore = 0;
+            for (uint32_t i = 0; i < queueFamilyCount; i++) {
+                VkQueueFlags flags = queueFamilies[i].queueFlags;
+                if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT)) continue;
+                int score = (flags & VK_QUEUE_COMPUTE_BIT) ? 1 : 2;
+                if (score > bestScore) {
+                    bestScore = score;
+                    m_transferFamily = i;
+                }
+            }
+            
+            // Async compute: a compute family without graphics, preferably
+            // not the one uploads already use
+            m_computeFamily = m_graphicsFamily;
+            bestScore = 0;
+            for (uint32_t i = 0; i < queueFamilyCount; i++) {
+                VkQueueFlags flags = queueFamilies[i].queueFlags;
+                if (!(flags & VK_QUEUE_COMPUTE_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT)) continue;
+                int score = (i == m_transferFamily) ? 1 : 2;
+                if (score > bestScore) {
+                    bestScore = score;
+                    m_computeFamily = i;
+                }
+            }
+            
             m_physicalDevice = device;
             VkPhysicalDeviceProperties props;
             vkGetPhysicalDeviceProperties(device, &props);
             std::cout << "[VulkanCore] GPU: " << props.deviceName << std::endl;
+            if (m_transferFamily != m_graphicsFamily) {
+                std::cout << "[VulkanCore] Dedicated transfer queue family: " << m_transferFamily << std::endl;
+            }
+            if (m_computeFamily != m_graphicsFamily) {
+                std::cout << "[VulkanCore] Dedicated compute queue family: " << m_computeFamily << std::endl;
+            }
             return true;
         }
     }
@@ -255,45 +381,227 @@ bool VulkanCore::selectPhysicalDevice() {
 // ============================================================================
 
 bool VulkanCore::createLogicalDevice() {
-    std::set<uint32_t> uniqueFamilies = {m_graphicsFamily, m_presentFamily};
+    bool wantCompute = m_config.asyncCompute && m_computeFamily != m_graphicsFamily;
+    if (!wantCompute) m_computeFamily = m_graphicsFamily;
+    
+    std::set<uint32_t> uniqueFamilies = {m_graphicsFamily, m_presentFamily, m_transferFamily, m_computeFamily};
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    float queuePriority = 1.0f;
+    float queuePriorities[] = {1.0f, 1.0f};
+    
+    // Compute sharing the transfer family gets a second queue of it when
+    // there is one, so batches don't serialize behind uploads
+    uint32_t computeQueueIndex = 0;
+    if (wantCompute && m_computeFamily == m_transferFamily) {
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, families.data());
+        if (families[m_computeFamily].queueCount >= 2) computeQueueIndex = 1;
+    }
     
     for (uint32_t family : uniqueFamilies) {
         VkDeviceQueueCreateInfo queueInfo{};
         queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         queueInfo.queueFamilyIndex = family;
-        queueInfo.queueCount = 1;
-        queueInfo.pQueuePriorities = &queuePriority;
+        queueInfo.queueCount = (family == m_computeFamily) ? computeQueueIndex + 1 : 1;
+        queueInfo.pQueuePriorities = queuePriorities;
         queueCreateInfos.push_back(queueInfo);
     }
     
-    const char* deviceExtensions[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    std::vector<const char*> deviceExtensions;
+    if (!m_config.headless) deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    
+    // Optional: GPU-generated draw counts (GpuScene compaction)
+    uint32_t extCount = 0;
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extCount);
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extCount, extensions.data());
+    bool hasDrawIndirectCount = false;
+    for (const auto& ext : extensions) {
+        if (strcmp(ext.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0) hasDrawIndirectCount = true;
+    }
+    if (hasDrawIndirectCount) deviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    
+    // Optional: driver-reported memory budget (eviction falls back to heap sizes)
+    bool hasMemoryBudget = MemoryBudget::addDeviceExtensions(m_physicalDevice, deviceExtensions);
+    
+    // Optional: descriptor indexing for the bindless heap
+    BindlessSupport bindless;
+    if (m_config.bindlessTextures > 0) {
+        bindless = BindlessHeap::querySupport(m_instance, m_physicalDevice, deviceExtensions);
+    }
+    
+    // Optional: timeline semaphores order the compute queue against frames
+    AsyncComputeSupport timeline;
+    if (wantCompute) {
+        timeline = AsyncCompute::querySupport(m_instance, m_physicalDevice, deviceExtensions);
+    }
+    
+    VkPhysicalDeviceFeatures supported{};
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supported);
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &props);
     
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.fillModeNonSolid = VK_TRUE;  // For wireframe
+    deviceFeatures.multiDrawIndirect = supported.multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance = supported.drawIndirectFirstInstance;
+    deviceFeatures.textureCompressionBC = supported.textureCompressionBC;  // Cooked KTX2/DDS textures
+    deviceFeatures.fragmentStoresAndAtomics = supported.fragmentStoresAndAtomics;  // Texel density feedback
+    deviceFeatures.geometryShader = m_config.pickBuffer ? supported.geometryShader : VK_FALSE;  // gl_PrimitiveID
     
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.enabledExtensionCount = 1;
-    createInfo.ppEnabledExtensionNames = deviceExtensions;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
+    if (bindless.supported) createInfo.pNext = &bindless.features;
+    if (timeline.supported) {
+        timeline.features.pNext = const_cast<void*>(createInfo.pNext);
+        createInfo.pNext = &timeline.features;
+    }
     
     if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS) {
         return false;
     }
     
+    if (bindless.supported) {
+        // Non-fatal: bindless pipelines fail to create, everything else works
+        m_bindless.init(m_device, std::min(m_config.bindlessTextures, bindless.maxTextures), m_framesInFlight);
+    } else if (m_config.bindlessTextures > 0) {
+        std::cout << "[VulkanCore] VK_EXT_descriptor_indexing unavailable - no bindless heap" << std::endl;
+    }
+    
+    m_multiDrawIndirect = supported.multiDrawIndirect == VK_TRUE;
+    m_indirectFirstInstance = supported.drawIndirectFirstInstance == VK_TRUE;
+    m_textureCompressionBC = supported.textureCompressionBC == VK_TRUE;
+    m_maxDrawIndirectCount = m_multiDrawIndirect ? std::max(props.limits.maxDrawIndirectCount, 1u) : 1u;
+    if (hasDrawIndirectCount) {
+        m_cmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            vkGetDeviceProcAddr(m_device, "vkCmdDrawIndexedIndirectCountKHR"));
+    }
+    
     vkGetDeviceQueue(m_device, m_graphicsFamily, 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, m_presentFamily, 0, &m_presentQueue);
+    vkGetDeviceQueue(m_device, m_transferFamily, 0, &m_transferQueue);
+    vkGetDeviceQueue(m_device, m_computeFamily, computeQueueIndex, &m_computeQueue);
+    
+    // Non-fatal: compute prologues run on the graphics queue instead
+    if (wantCompute && (!timeline.supported || !m_asyncCompute.init(m_device, m_computeQueue, m_computeFamily))) {
+        std::cout << "[VulkanCore] VK_KHR_timeline_semaphore unavailable - compute runs on the graphics queue"
+                  << std::endl;
+        m_computeFamily = m_graphicsFamily;
+        m_computeQueue = m_graphicsQueue;
+    }
+    
+    m_memoryBudget.init(m_instance, m_physicalDevice, hasMemoryBudget);
+    if (!m_allocator.init(m_device, m_physicalDevice)) return false;
+    
+    // Optional: mip streaming, fed by fragment shaders writing to the bindless set
+    if (m_config.textureStreaming) {
+        if (!m_bindless.isInitialized() || !supported.fragmentStoresAndAtomics) {
+            std::cout << "[VulkanCore] Texture streaming needs the bindless heap and fragmentStoresAndAtomics"
+                      << " - textures load fully resident" << std::endl;
+        } else if (m_streamer.init(m_device, m_allocator, m_bindless.getCapacity(), m_framesInFlight)) {
+            m_bindless.setTexelDensityBuffer(m_streamer.getFeedbackBuffer(), m_streamer.getFeedbackSize());
+        }
+    }
+    
+    // Optional: triangle-id subpass for editor picking
+    if (m_config.pickBuffer) initPickBuffer(supported.geometryShader == VK_TRUE);
+    
+    // Optional: offscreen scene at a GPU-time-driven scale
+    if (m_config.dynamicResolution) initDynamicResolution();
     return true;
 }
 
+void VulkanCore::initPickBuffer(bool primitiveIds) {
+    if (!primitiveIds) {
+        std::cout << "[VulkanCore] Pick buffer needs geometryShader (gl_PrimitiveID in fragment shaders)"
+                  << " - no GPU picking" << std::endl;
+        return;
+    }
+    std::vector<char> code = readShaderFile(m_config.pickShaderPath);
+    if (code.empty()) {
+        std::cerr << "[VulkanCore] Pick shader not found: " << m_config.pickShaderPath << " - no GPU picking" << std::endl;
+        return;
+    }
+    if (!m_pick.init(m_device, m_allocator, m_framesInFlight)) return;
+    m_pickShader = createShaderModule(code);
+}
+
+void VulkanCore::initDynamicResolution() {
+    if (m_pick.isEnabled()) {
+        // Ids are looked up by window pixel, in a subpass of the scene pass
+        std::cout << "[VulkanCore] Dynamic resolution is not available with the pick buffer"
+                  << " - the scene renders at window size" << std::endl;
+        return;
+    }
+    std::vector<char> vertCode = readShaderFile(m_config.upscaleVertexShaderPath);
+    std::vector<char> fragCode = readShaderFile(m_config.upscaleFragmentShaderPath);
+    if (vertCode.empty() || fragCode.empty()) {
+        std::cerr << "[VulkanCore] Upscale shaders not found: " << m_config.upscaleVertexShaderPath << ", "
+                  << m_config.upscaleFragmentShaderPath << " - the scene renders at window size" << std::endl;
+        return;
+    }
+    if (!m_config.gpuProfiling) {
+        std::cout << "[VulkanCore] Dynamic resolution without gpuProfiling has no scene timings"
+                  << " - the scale stays at dynamicResolutionMaxScale" << std::endl;
+    }
+    
+    DynamicResolution::Settings settings;
+    settings.controller.targetMs = m_config.dynamicResolutionTargetMs;
+    settings.controller.minScale = m_config.dynamicResolutionMinScale;
+    settings.controller.maxScale = m_config.dynamicResolutionMaxScale;
+    settings.controller.gainDown = m_config.dynamicResolutionGainDown;
+    settings.controller.gainUp = m_config.dynamicResolutionGainUp;
+    settings.sharpness = m_config.upscaleSharpness;
+    m_dynamicRes.init(m_device, settings, createShaderModule(vertCode), createShaderModule(fragCode));
+}
+
 // ============================================================================
 // Swapchain
 // ============================================================================
 
+VkPresentModeKHR VulkanCore::choosePresentMode() const {
+    uint32_t modeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, nullptr);
+    std::vector<VkPresentModeKHR> modes(modeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, modes.data());
+    
+    auto supported = [&](VkPresentModeKHR mode) {
+        return std::find(modes.begin(), modes.end(), mode) != modes.end();
+    };
+    
+    PresentMode requested = m_config.presentMode;
+    if (requested == PresentMode::AUTO) {
+        requested = m_config.vsync ? PresentMode::FIFO : PresentMode::IMMEDIATE;
+    }
+    
+    // Preference order per request; FIFO is guaranteed by the spec
+    std::vector<VkPresentModeKHR> chain;
+    switch (requested) {
+        case PresentMode::FIFO_RELAXED: chain = {VK_PRESENT_MODE_FIFO_RELAXED_KHR}; break;
+        case PresentMode::MAILBOX:      chain = {VK_PRESENT_MODE_MAILBOX_KHR}; break;
+        case PresentMode::IMMEDIATE:    chain = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR}; break;
+        default: break;
+    }
+    
+    VkPresentModeKHR chosen = VK_PRESENT_MODE_FIFO_KHR;
+    for (VkPresentModeKHR mode : chain) {
+        if (supported(mode)) { chosen = mode; break; }
+    }
+    
+    const char* name = chosen == VK_PRESENT_MODE_MAILBOX_KHR ? "MAILBOX" :
+                       chosen == VK_PRESENT_MODE_IMMEDIATE_KHR ? "IMMEDIATE" :
+                       chosen == VK_PRESENT_MODE_FIFO_RELAXED_KHR ? "FIFO_RELAXED" : "FIFO";
+    std::cout << "[VulkanCore] Present mode: " << name << ", " << m_framesInFlight << " frame(s) in flight"
+              << (!chain.empty() && chosen != chain.front() ? " (requested mode unsupported)" : "") << std::endl;
+    return chosen;
+}
+
 bool VulkanCore::createSwapchain() {
     VkSurfaceCapabilitiesKHR caps;
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physicalDevice, m_surface, &caps);
@@ -324,7 +632,11 @@ bool VulkanCore::createSwapchain() {
         m_swapchainExtent.height = std::clamp((uint32_t)h, caps.minImageExtent.height, caps.maxImageExtent.height);
     }
     
+    m_presentMode = choosePresentMode();
+    
+    // MAILBOX needs a spare image to replace, or it stalls like FIFO
     uint32_t imageCount = caps.minImageCount + 1;
+    if (m_presentMode == VK_PRESENT_MODE_MAILBOX_KHR) imageCount = std::max(imageCount, 3u);
     if (caps.maxImageCount > 0 && imageCount > caps.maxImageCount) {
         imageCount = caps.maxImageCount;
     }
@@ -350,7 +662,7 @@ bool VulkanCore::createSwapchain() {
     
     createInfo.preTransform = caps.currentTransform;
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    createInfo.presentMode = m_config.vsync ? VK_PRESENT_MODE_FIFO_KHR : VK_PRESENT_MODE_IMMEDIATE_KHR;
+    createInfo.presentMode = m_presentMode;
     createInfo.clipped = VK_TRUE;
     
     if (vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapchain) != VK_SUCCESS) {
@@ -380,6 +692,114 @@ bool VulkanCore::createSwapchain() {
     return true;
 }
 
+// ============================================================================
+// Headless Targets
+// ============================================================================
+
+// One color image per frame in flight stands in for the swapchain, so the
+// framebuffers, render pass and pipelines are built exactly as when windowed
+bool VulkanCore::createOffscreenTargets() {
+    m_swapchainFormat = VK_FORMAT_R8G8B8A8_SRGB;  // Readback is RGBA without a swizzle
+    m_swapchainExtent.width = static_cast<uint32_t>(std::max(m_config.width, 1));
+    m_swapchainExtent.height = static_cast<uint32_t>(std::max(m_config.height, 1));
+    
+    m_swapchainImages.assign(m_framesInFlight, VK_NULL_HANDLE);
+    m_swapchainImageViews.assign(m_framesInFlight, VK_NULL_HANDLE);
+    m_offscreenAllocs.assign(m_framesInFlight, GpuAllocation{});
+    
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {m_swapchainExtent.width, m_swapchainExtent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = m_swapchainFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
+        if (!m_allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                     m_swapchainImages[i], m_offscreenAllocs[i])) {
+            return false;
+        }
+        
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_swapchainImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = m_swapchainFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &m_swapchainImageViews[i]) != VK_SUCCESS) {
+            return false;
+        }
+    }
+    
+    if (m_config.headlessReadback) {
+        VkDeviceSize size = VkDeviceSize(m_swapchainExtent.width) * m_swapchainExtent.height * 4;
+        m_readbackBuffers.assign(m_framesInFlight, VK_NULL_HANDLE);
+        m_readbackAllocs.assign(m_framesInFlight, GpuAllocation{});
+        for (uint32_t i = 0; i < m_framesInFlight; i++) {
+            if (!m_allocator.createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                          m_readbackBuffers[i], m_readbackAllocs[i])) {
+                return false;
+            }
+        }
+    }
+    
+    m_imageIndex = 0;
+    m_lastReadbackFrame = -1;
+    return true;
+}
+
+// After the render pass: the image is already TRANSFER_SRC_OPTIMAL
+void VulkanCore::recordReadback(VkCommandBuffer cmd) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_swapchainImages[m_imageIndex];
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+    
+    VkBufferImageCopy region{};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {m_swapchainExtent.width, m_swapchainExtent.height, 1};
+    vkCmdCopyImageToBuffer(cmd, m_swapchainImages[m_imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           m_readbackBuffers[m_currentFrame], 1, &region);
+    
+    VkMemoryBarrier hostRead{};
+    hostRead.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    hostRead.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostRead.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 1, &hostRead, 0, nullptr, 0, nullptr);
+}
+
+bool VulkanCore::readFrame(std::vector<uint8_t>& rgba) {
+    if (m_readbackBuffers.empty() || m_lastReadbackFrame < 0) return false;
+    
+    uint32_t slot = static_cast<uint32_t>(m_lastReadbackFrame);
+    vkWaitForFences(m_device, 1, &m_inFlightFences[slot], VK_TRUE, UINT64_MAX);
+    
+    const GpuAllocation& alloc = m_readbackAllocs[slot];
+    rgba.resize(static_cast<size_t>(alloc.size));
+    memcpy(rgba.data(), alloc.mapped, rgba.size());
+    return true;
+}
+
 // ============================================================================
 // Depth Resources
 // ============================================================================
@@ -390,8 +810,16 @@ bool VulkanCore::createDepthResources() {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = m_swapchainExtent.width;
-    imageInfo.extent.height = m_swapchainExtent.height;
+    // Dynamic resolution: shared by the scene target (maxScale x the
+    // window) and the UI pass (the window)
+    VkExtent2D extent = m_swapchainExtent;
+    if (m_dynamicRes.isEnabled()) {
+        VkExtent2D target = m_dynamicRes.targetExtent(m_swapchainExtent);
+        extent.width = std::max(extent.width, target.width);
+        extent.height = std::max(extent.height, target.height);
+    }
+    imageInfo.extent.width = extent.width;
+    imageInfo.extent.height = extent.height;
     imageInfo.extent.depth = 1;
     imageInfo.mipLevels = 1;
     imageInfo.arrayLayers = 1;
@@ -401,18 +829,9 @@ bool VulkanCore::createDepthResources() {
     imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     
-    vkCreateImage(m_device, &imageInfo, nullptr, &m_depthImage);
-    
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(m_device, m_depthImage, &memReqs);
-    
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    
-    vkAllocateMemory(m_device, &allocInfo, nullptr, &m_depthImageMemory);
-    vkBindImageMemory(m_device, m_depthImage, m_depthImageMemory, 0);
+    if (!m_allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImage, m_depthImageAlloc)) {
+        return false;
+    }
     
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -426,6 +845,11 @@ bool VulkanCore::createDepthResources() {
     viewInfo.subresourceRange.layerCount = 1;
     
     vkCreateImageView(m_device, &viewInfo, nullptr, &m_depthImageView);
+    
+    // The id attachment shares the depth buffer's size and lifetime
+    if (m_pick.isEnabled()) {
+        return m_pick.createTarget(m_allocator, m_swapchainExtent.width, m_swapchainExtent.height);
+    }
     return true;
 }
 
@@ -442,7 +866,13 @@ bool VulkanCore::createRenderPass() {
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // Headless frames end ready for the readback copy; the layout change
+    // keeps the pass compatible, so pipelines are identical in both modes
+    colorAttachment.finalLayout = m_config.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                                                    : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    VkImageLayout presentLayout = colorAttachment.finalLayout;
+    // Dynamic resolution: the scene target is sampled by the upscale next
+    if (m_dynamicRes.isEnabled()) colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     
     VkAttachmentDescription depthAttachment{};
     depthAttachment.format = VK_FORMAT_D32_SFLOAT;
@@ -470,18 +900,71 @@ bool VulkanCore::createRenderPass() {
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
     
-    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+    std::array<VkAttachmentDescription, 3> attachments = {colorAttachment, depthAttachment};
+    std::array<VkSubpassDescription, 2> subpasses = {subpass};
+    std::array<VkSubpassDependency, 3> dependencies = {dependency};
+    uint32_t attachmentCount = 2, subpassCount = 1, dependencyCount = 1;
+    
+    // Pick buffer: subpass 1 draws triangle ids into attachment 2, testing
+    // against the depth subpass 0 wrote. Subpass 0 is unchanged, so every
+    // pipeline built against it (ImGui, external renderers) stays valid
+    VkAttachmentReference pickRef{2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    uint32_t preserved = 0;
+    if (m_pick.isEnabled()) {
+        VkAttachmentDescription& pickAttachment = attachments[attachmentCount++];
+        pickAttachment.format = PickBuffer::FORMAT;
+        pickAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        pickAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        pickAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        pickAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        pickAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        pickAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        pickAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;  // For PickBuffer::recordCopy
+        
+        VkSubpassDescription& pickSubpass = subpasses[subpassCount++];
+        pickSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        pickSubpass.colorAttachmentCount = 1;
+        pickSubpass.pColorAttachments = &pickRef;
+        pickSubpass.pDepthStencilAttachment = &depthRef;
+        pickSubpass.preserveAttachmentCount = 1;
+        pickSubpass.pPreserveAttachments = &preserved;
+        
+        VkSubpassDependency& depthToPick = dependencies[dependencyCount++];
+        depthToPick.srcSubpass = 0;
+        depthToPick.dstSubpass = 1;
+        depthToPick.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        depthToPick.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        depthToPick.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depthToPick.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        depthToPick.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+        
+        // The previous frame's readback copy is done with the id attachment
+        VkSubpassDependency& copyToPick = dependencies[dependencyCount++];
+        copyToPick.srcSubpass = VK_SUBPASS_EXTERNAL;
+        copyToPick.dstSubpass = 1;
+        copyToPick.srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        copyToPick.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        copyToPick.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    }
     
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.attachmentCount = attachmentCount;
     renderPassInfo.pAttachments = attachments.data();
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-    
-    return vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass) == VK_SUCCESS;
+    renderPassInfo.subpassCount = subpassCount;
+    renderPassInfo.pSubpasses = subpasses.data();
+    renderPassInfo.dependencyCount = dependencyCount;
+    renderPassInfo.pDependencies = dependencies.data();
+    
+    if (vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) return false;
+    if (!m_dynamicRes.isEnabled()) return true;
+    
+    // UI pass on the swapchain image: the upscale covers every pixel, so
+    // nothing is loaded. Same attachments and subpass (no pick subpass
+    // with dynamic resolution), so it is compatible with m_renderPass
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[0].finalLayout = presentLayout;
+    return vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_uiRenderPass) == VK_SUCCESS;
 }
 
 // ============================================================================
@@ -491,9 +974,9 @@ bool VulkanCore::createRenderPass() {
 bool VulkanCore::createDescriptorSetLayout() {
     std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
     
-    // Binding 0: UBO
+    // Binding 0: UBO (dynamic offset into the per-frame object ring)
     bindings[0].binding = 0;
-    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     bindings[0].descriptorCount = 1;
     bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
     
@@ -516,19 +999,8 @@ bool VulkanCore::createDescriptorSetLayout() {
 // ============================================================================
 
 bool VulkanCore::createDescriptorPool() {
-    std::array<VkDescriptorPoolSize, 2> poolSizes{};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = 100;
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = 100;
-    
-    VkDescriptorPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = 200;
-    
-    return vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) == VK_SUCCESS;
+    // Pools are created on demand and grow as sets are allocated
+    return m_descriptors.init(m_device, m_framesInFlight);
 }
 
 // ============================================================================
@@ -539,12 +1011,12 @@ bool VulkanCore::createFramebuffers() {
     m_framebuffers.resize(m_swapchainImageViews.size());
     
     for (size_t i = 0; i < m_swapchainImageViews.size(); i++) {
-        std::array<VkImageView, 2> attachments = {m_swapchainImageViews[i], m_depthImageView};
+        std::array<VkImageView, 3> attachments = {m_swapchainImageViews[i], m_depthImageView, m_pick.getView()};
         
         VkFramebufferCreateInfo fbInfo{};
         fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         fbInfo.renderPass = m_renderPass;
-        fbInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        fbInfo.attachmentCount = m_pick.isEnabled() ? 3 : 2;
         fbInfo.pAttachments = attachments.data();
         fbInfo.width = m_swapchainExtent.width;
         fbInfo.height = m_swapchainExtent.height;
@@ -554,6 +1026,13 @@ bool VulkanCore::createFramebuffers() {
             return false;
         }
     }
+    
+    // Dynamic resolution: these serve the (compatible) UI pass; the scene
+    // pass gets the offscreen target's
+    if (m_dynamicRes.isEnabled()) {
+        return m_dynamicRes.createTarget(m_allocator, m_renderPass, m_swapchainFormat, m_depthImageView,
+                                         m_swapchainExtent);
+    }
     return true;
 }
 
@@ -567,11 +1046,21 @@ bool VulkanCore::createCommandPool() {
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     poolInfo.queueFamilyIndex = m_graphicsFamily;
     
-    return vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) == VK_SUCCESS;
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+        return false;
+    }
+    
+    // Upload manager owns its own pool on the transfer family
+    if (!m_uploads.init(m_device, &m_allocator, m_transferQueue, m_transferFamily)) {
+        return false;
+    }
+    
+    // Texture uploads need the graphics queue for their mip blits
+    return m_uploadBatch.init(m_device, &m_allocator, m_graphicsQueue, m_graphicsFamily);
 }
 
 bool VulkanCore::createCommandBuffers() {
-    m_commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    m_commandBuffers.resize(m_framesInFlight);
     
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -579,7 +1068,11 @@ bool VulkanCore::createCommandBuffers() {
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     allocInfo.commandBufferCount = static_cast<uint32_t>(m_commandBuffers.size());
     
-    return vkAllocateCommandBuffers(m_device, &allocInfo, m_commandBuffers.data()) == VK_SUCCESS;
+    if (vkAllocateCommandBuffers(m_device, &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) return false;
+    if (!m_dynamicRes.isEnabled()) return true;
+    
+    m_uiCommandBuffers.resize(m_framesInFlight);
+    return vkAllocateCommandBuffers(m_device, &allocInfo, m_uiCommandBuffers.data()) == VK_SUCCESS;
 }
 
 // ============================================================================
@@ -587,9 +1080,9 @@ bool VulkanCore::createCommandBuffers() {
 // ============================================================================
 
 bool VulkanCore::createSyncObjects() {
-    m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    m_imageAvailableSemaphores.resize(m_framesInFlight);
+    m_renderFinishedSemaphores.resize(m_framesInFlight);
+    m_inFlightFences.resize(m_framesInFlight);
     
     VkSemaphoreCreateInfo semInfo{};
     semInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -598,7 +1091,7 @@ bool VulkanCore::createSyncObjects() {
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
     
-    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
         if (vkCreateSemaphore(m_device, &semInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
             vkCreateSemaphore(m_device, &semInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS ||
             vkCreateFence(m_device, &fenceInfo, nullptr, &m_inFlightFences[i]) != VK_SUCCESS) {
@@ -613,10 +1106,6 @@ bool VulkanCore::createSyncObjects() {
 // ============================================================================
 
 bool VulkanCore::createDefaultResources() {
-    // Create object UBO
-    m_objectUBO = createUniformBuffer(sizeof(StandardUBO));
-    if (m_objectUBO == INVALID_BUFFER) return false;
-    
     // Create default 1x1 white texture
     uint8_t whitePixel[4] = {255, 255, 255, 255};
     m_defaultTexture = createTexture(whitePixel, 1, 1, 4);
@@ -626,49 +1115,124 @@ bool VulkanCore::createDefaultResources() {
     }
     m_currentTexture = m_defaultTexture;
     
-    // Allocate descriptor set
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = m_descriptorPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+    // Unused and released bindless slots sample white
+    const TextureResource& defaultTex = m_textures[m_defaultTexture];
+    m_bindless.setFallback(defaultTex.view, defaultTex.sampler);
+    m_mainContext.textureIndex = getBindlessIndex(m_defaultTexture);
+    m_mainContext.texture = m_defaultTexture;
     
-    if (vkAllocateDescriptorSets(m_device, &allocInfo, &m_objectDescriptorSet) != VK_SUCCESS) {
-        return false;
+    // Create per-frame object UBO rings (+ their descriptor sets)
+    if (!createUniformRings()) return false;
+    
+    // Per-frame instance buffers for drawMeshInstanced
+    return createInstanceRings();
+}
+
+// ============================================================================
+// Per-Frame Object UBO Ring
+// ============================================================================
+
+bool VulkanCore::createUniformRings() {
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &props);
+    VkDeviceSize align = props.limits.minUniformBufferOffsetAlignment;
+    if (align == 0) align = 1;
+    m_uboSlotStride = (sizeof(StandardUBO) + align - 1) & ~(align - 1);
+    
+    VkDeviceSize ringSize = m_uboSlotStride * OBJECT_UBO_RING_SLOTS;
+    m_uniformRings.resize(m_framesInFlight);
+    
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
+        UniformRing& ring = m_uniformRings[i];
+        
+        if (!createBufferInternal(ringSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  ring.buffer, ring.alloc)) {
+            std::cerr << "[VulkanCore] Failed to create object UBO ring" << std::endl;
+            return false;
+        }
+        ring.mapped = static_cast<uint8_t*>(ring.alloc.mapped);
+        
+        ring.descriptorSet = m_descriptors.allocate(m_descriptorSetLayout);
+        if (ring.descriptorSet == VK_NULL_HANDLE) {
+            return false;
+        }
+        
+        // Range is one slot; the slot is selected per draw via dynamic offset
+        VkDescriptorBufferInfo bufInfo{};
+        bufInfo.buffer = ring.buffer;
+        bufInfo.offset = 0;
+        bufInfo.range = sizeof(StandardUBO);
+        
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = ring.descriptorSet;
+        write.dstBinding = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufInfo;
+        
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        
+        writeRingTexture(i, m_defaultTexture);
     }
     
-    // Update descriptor set with UBO and default texture
-    VkDescriptorBufferInfo bufInfo{};
-    bufInfo.buffer = m_buffers[m_objectUBO].buffer;
-    bufInfo.offset = 0;
-    bufInfo.range = sizeof(StandardUBO);
+    std::cout << "[VulkanCore] Object UBO ring: " << OBJECT_UBO_RING_SLOTS << " slots x "
+              << m_uboSlotStride << " bytes per frame" << std::endl;
+    return true;
+}
+
+void VulkanCore::destroyUniformRings() {
+    for (auto& ring : m_uniformRings) {
+        m_descriptors.free(ring.descriptorSet);
+        m_allocator.destroyBuffer(ring.buffer, ring.alloc);
+        ring.mapped = nullptr;
+    }
+    m_uniformRings.clear();
+}
+
+bool VulkanCore::createInstanceRings() {
+    VkDeviceSize ringSize = sizeof(InstanceData) * MAX_INSTANCES_PER_FRAME;
+    m_instanceRings.resize(m_framesInFlight);
+    
+    for (auto& ring : m_instanceRings) {
+        if (!createBufferInternal(ringSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  ring.buffer, ring.alloc)) {
+            std::cerr << "[VulkanCore] Failed to create instance ring" << std::endl;
+            return false;
+        }
+        ring.mapped = static_cast<InstanceData*>(ring.alloc.mapped);
+    }
+    return true;
+}
+
+void VulkanCore::destroyInstanceRings() {
+    for (auto& ring : m_instanceRings) {
+        m_allocator.destroyBuffer(ring.buffer, ring.alloc);
+        ring.mapped = nullptr;
+    }
+    m_instanceRings.clear();
+}
+
+void VulkanCore::writeRingTexture(uint32_t frameIndex, TextureHandle texture) {
+    UniformRing& ring = m_uniformRings[frameIndex];
     
     VkDescriptorImageInfo imageInfo{};
-    imageInfo.sampler = m_textures[m_defaultTexture].sampler;
-    imageInfo.imageView = m_textures[m_defaultTexture].view;
+    imageInfo.sampler = m_textures[texture].sampler;
+    imageInfo.imageView = m_textures[texture].view;
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     
-    std::array<VkWriteDescriptorSet, 2> writes{};
-    
-    // UBO write
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].dstSet = m_objectDescriptorSet;
-    writes[0].dstBinding = 0;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[0].descriptorCount = 1;
-    writes[0].pBufferInfo = &bufInfo;
-    
-    // Texture write
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = m_objectDescriptorSet;
-    writes[1].dstBinding = 1;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    writes[1].descriptorCount = 1;
-    writes[1].pImageInfo = &imageInfo;
-    
-    vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = ring.descriptorSet;
+    write.dstBinding = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
     
-    return true;
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    ring.boundTexture = texture;
 }
 
 // ============================================================================
@@ -677,15 +1241,32 @@ bool VulkanCore::createDefaultResources() {
 
 void VulkanCore::cleanupSwapchain() {
     vkDestroyImageView(m_device, m_depthImageView, nullptr);
-    vkDestroyImage(m_device, m_depthImage, nullptr);
-    vkFreeMemory(m_device, m_depthImageMemory, nullptr);
+    m_allocator.destroyImage(m_depthImage, m_depthImageAlloc);
+    m_pick.destroyTarget(m_allocator);
+    m_dynamicRes.destroyTarget(m_allocator);
     
     for (auto fb : m_framebuffers) vkDestroyFramebuffer(m_device, fb, nullptr);
     for (auto iv : m_swapchainImageViews) vkDestroyImageView(m_device, iv, nullptr);
+    
+    if (m_config.headless) {
+        // Offscreen images are ours, not the presentation engine's
+        for (size_t i = 0; i < m_swapchainImages.size(); i++) {
+            m_allocator.destroyImage(m_swapchainImages[i], m_offscreenAllocs[i]);
+        }
+        for (size_t i = 0; i < m_readbackBuffers.size(); i++) {
+            m_allocator.destroyBuffer(m_readbackBuffers[i], m_readbackAllocs[i]);
+        }
+        m_readbackBuffers.clear();
+        m_readbackAllocs.clear();
+        m_offscreenAllocs.clear();
+        return;
+    }
     vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
 }
 
 void VulkanCore::recreateSwapchain() {
+    if (m_config.headless) return;  // Offscreen targets keep the configured size
+    
     int w = 0, h = 0;
     glfwGetFramebufferSize(m_window, &w, &h);
     while (w == 0 || h == 0) {
@@ -706,74 +1287,325 @@ void VulkanCore::recreateSwapchain() {
 bool VulkanCore::beginFrame() {
     m_frameStarted = false;
     
+    using Clock = std::chrono::steady_clock;
+    auto msSince = [](Clock::time_point t) {
+        return std::chrono::duration<float, std::milli>(Clock::now() - t).count();
+    };
+    
+    Clock::time_point t0 = Clock::now();
     vkWaitForFences(m_device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
+    m_frameTimings.fenceWaitMs = msSince(t0);
     
-    VkResult result = vkAcquireNextImageKHR(m_device, m_swapchain, UINT64_MAX,
-                                             m_imageAvailableSemaphores[m_currentFrame],
-                                             VK_NULL_HANDLE, &m_imageIndex);
+    // Pick readbacks of every finished frame, not just this slot's: with
+    // several frames in flight the last one has usually signalled already
+    for (uint32_t i = 0; m_pick.isEnabled() && i < m_framesInFlight; i++) {
+        if (m_pick.isPending(i) && (i == m_currentFrame || vkGetFenceStatus(m_device, m_inFlightFences[i]) == VK_SUCCESS)) {
+            m_pick.resolve(i);
+        }
+    }
     
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_framebufferResized) {
-        m_framebufferResized = false;
-        recreateSwapchain();
-        return false;
+    // Frame pacing: start frames no closer than framePacingMs apart, so the
+    // CPU samples input right before it is needed instead of racing ahead
+    m_frameTimings.pacingSleepMs = 0.0f;
+    if (m_config.framePacingMs > 0.0f && m_lastFrameStart != Clock::time_point{}) {
+        auto target = m_lastFrameStart + std::chrono::duration_cast<Clock::duration>(
+                          std::chrono::duration<float, std::milli>(m_config.framePacingMs));
+        Clock::time_point sleepStart = Clock::now();
+        if (sleepStart < target) {
+            std::this_thread::sleep_until(target);
+            m_frameTimings.pacingSleepMs = msSince(sleepStart);
+        }
+    }
+    
+    Clock::time_point frameStart = Clock::now();
+    if (m_lastFrameStart != Clock::time_point{}) {
+        m_frameTimings.frameMs = std::chrono::duration<float, std::milli>(frameStart - m_lastFrameStart).count();
+    }
+    m_lastFrameStart = frameStart;
+    
+    if (m_config.headless) {
+        // The fence just waited on also covers this slot's offscreen image
+        m_imageIndex = m_currentFrame;
+        m_frameTimings.acquireMs = 0.0f;
+    } else {
+        Clock::time_point acquireStart = Clock::now();
+        VkResult result = vkAcquireNextImageKHR(m_device, m_swapchain, UINT64_MAX,
+                                                 m_imageAvailableSemaphores[m_currentFrame],
+                                                 VK_NULL_HANDLE, &m_imageIndex);
+        m_frameTimings.acquireMs = msSince(acquireStart);
+        
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_framebufferResized) {
+            m_framebufferResized = false;
+            recreateSwapchain();
+            return false;
+        }
     }
     
     vkResetFences(m_device, 1, &m_inFlightFences[m_currentFrame]);
     
+    // The fence just waited on retired frame (m_frameNumber - framesInFlight);
+    // resources destroyed during it or earlier are no longer referenced
+    m_frameNumber++;
+    if (m_frameNumber > m_framesInFlight) {
+        m_deletions.flush(m_frameNumber - m_framesInFlight);
+    }
+    
+    m_pick.beginFrame(m_currentFrame, m_frameNumber);
+    
+    // Geometry recorded last frame
+    m_renderStats.drawCalls = m_statDrawCalls.exchange(0, std::memory_order_relaxed);
+    m_renderStats.triangles = m_statTriangles.exchange(0, std::memory_order_relaxed);
+    m_renderStats.trianglesFullDetail = m_statTrianglesFull.exchange(0, std::memory_order_relaxed);
+    m_renderStats.objectsVisible = m_statObjectsVisible.exchange(0, std::memory_order_relaxed);
+    m_renderStats.objectsCulled = m_statObjectsCulled.exchange(0, std::memory_order_relaxed);
+    
+    // Meshes whose transfer batch landed become drawable from this frame on
+    m_uploads.poll();
+    m_uploadBatch.poll();
+    
+    // Over budget: evict idle textures/meshes; under it: bring back wanted ones
+    enforceMemoryBudget();
+    
+    // Finer mips for what this slot's last frame sampled closely, within the budget
+    updateTextureStreaming();
+    
+    // Bindless slots released framesInFlight frames ago can be reused
+    m_bindless.beginFrame();
+    
+    // Transient descriptor pools for this frame slot are reset in bulk
+    m_descriptors.beginFrame(m_currentFrame);
+    
+    // This frame's ring is no longer read by the GPU - rewind it and
+    // catch its descriptor set up with the currently bound texture
+    UniformRing& ring = m_uniformRings[m_currentFrame];
+    ring.head = 0;
+    ring.overflowWarned = false;
+    if (ring.boundTexture != m_currentTexture) {
+        writeRingTexture(m_currentFrame, m_currentTexture);
+    }
+    m_instanceRings[m_currentFrame].head = 0;
+    m_instanceRings[m_currentFrame].overflowWarned = false;
+    
     VkCommandBuffer cmd = m_commandBuffers[m_currentFrame];
     vkResetCommandBuffer(cmd, 0);
+    if (m_dynamicRes.isEnabled()) vkResetCommandBuffer(m_uiCommandBuffers[m_currentFrame], 0);
+    m_uiPassStarted = false;
+    
+    // Secondaries recorded for this frame slot last time are done too
+    for (auto& slot : m_recordSlots) {
+        vkResetCommandPool(m_device, slot.pools[m_currentFrame], 0);
+        slot.used[m_currentFrame] = 0;
+    }
+    m_frameSecondaries.clear();
     
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     vkBeginCommandBuffer(cmd, &beginInfo);
     
-    std::array<VkClearValue, 2> clearValues{};
+    // Resolves this slot's timings from framesInFlight frames ago; the
+    // "frame" scope sits outside the render pass so it is legal in both
+    // inline and secondary-contents mode
+    m_gpuProfiler.beginFrame(cmd, m_currentFrame);
+    m_frameGpuScope = m_gpuProfiler.beginScope(cmd, "frame");
+    m_occlusion.beginFrame(cmd, m_currentFrame);
+    m_mainContext.pass = DrawPass::Default;
+    
+    // Dynamic resolution: this slot's last scene time picks the scale. The
+    // "scene" scope starts at BOTTOM_OF_PIPE, once the previous frame's work
+    // is done, so it measures the scene's own cost, not queue waits
+    if (m_dynamicRes.isEnabled()) {
+        const GpuProfiler::Timing* scene = m_gpuProfiler.findTiming("scene");
+        m_dynamicRes.beginFrame(m_currentFrame, scene ? scene->ms : 0.0f);
+        m_sceneGpuScope = m_gpuProfiler.beginScope(cmd, "scene", VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+        m_dynamicRes.recordSceneBarrier(cmd);
+    }
+    
+    // Async compute: compute prologues become this frame's compute batch;
+    // otherwise they run here with the rest, in order
+    m_computeWaitValue = AsyncCompute::NO_WORK;
+    m_computeWaitStages = 0;
+    if (m_asyncCompute.isEnabled()) runComputePrologues();
+    
+    if (!m_framePrologues.empty()) {
+        uint32_t scope = m_gpuProfiler.beginScope(cmd, "prologue");
+        for (auto& prologue : m_framePrologues) {
+            if (!prologue.compute || !m_asyncCompute.isEnabled()) prologue.run(cmd);
+        }
+        m_gpuProfiler.endScope(cmd, scope);
+    }
+    
+    std::array<VkClearValue, 3> clearValues{};
     clearValues[0].color = {{m_config.clearColor[0], m_config.clearColor[1], m_config.clearColor[2], m_config.clearColor[3]}};
     clearValues[1].depthStencil = {1.0f, 0};
+    clearValues[2].color.uint32[0] = PickBuffer::NO_ID;
     
     VkRenderPassBeginInfo rpInfo{};
     rpInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     rpInfo.renderPass = m_renderPass;
-    rpInfo.framebuffer = m_framebuffers[m_imageIndex];
-    rpInfo.renderArea.extent = m_swapchainExtent;
-    rpInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    rpInfo.framebuffer = sceneFramebuffer();
+    rpInfo.renderArea.extent = sceneExtent();
+    rpInfo.clearValueCount = m_pick.isEnabled() ? 3 : 2;
     rpInfo.pClearValues = clearValues.data();
     
+    m_frameStarted = true;
+    if (m_drawCapture) m_drawCapture->frameBegin(m_viewMatrix, m_projMatrix);
+    
+    if (m_config.parallelRecording) {
+        // Everything in the pass goes through secondaries (main-thread
+        // segments + recordParallel tasks), executed in endFrame()
+        vkCmdBeginRenderPass(cmd, &rpInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        openMainSegment();
+        return true;
+    }
+    
     vkCmdBeginRenderPass(cmd, &rpInfo, VK_SUBPASS_CONTENTS_INLINE);
+    m_mainContext.cmd = cmd;
     
     // Set viewport and scissor
-    VkViewport viewport{0, 0, (float)m_swapchainExtent.width, (float)m_swapchainExtent.height, 0, 1};
-    VkRect2D scissor{{0, 0}, m_swapchainExtent};
+    VkExtent2D extent = sceneExtent();
+    VkViewport viewport{0, 0, (float)extent.width, (float)extent.height, 0, 1};
+    VkRect2D scissor{{0, 0}, extent};
     vkCmdSetViewport(cmd, 0, 1, &viewport);
     vkCmdSetScissor(cmd, 0, 1, &scissor);
     
-    m_frameStarted = true;
     return true;
 }
 
 void VulkanCore::endFrame() {
     if (!m_frameStarted) return;
     
-    VkCommandBuffer cmd = m_commandBuffers[m_currentFrame];
+    // After the last captured frame's draws; the file write lands in this frame
+    if (m_drawCapture && m_drawCapture->frameEnd()) m_drawCapture->save();
+    
+    // Dynamic resolution: the rest of the frame goes into the UI pass
+    if (m_dynamicRes.isEnabled()) beginUiPass();
+    VkCommandBuffer sceneCmd = m_commandBuffers[m_currentFrame];
+    VkCommandBuffer cmd = m_uiPassStarted ? m_uiCommandBuffers[m_currentFrame] : sceneCmd;
+    
+    if (m_config.parallelRecording && !m_uiPassStarted) {
+        closeMainSegment();
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(m_frameSecondaries.size()), m_frameSecondaries.data());
+    }
+    
+    // Pick subpass: empty unless a pick was requested, then the frame's
+    // pickable draws again with their id variants
+    if (m_pick.isEnabled()) {
+        vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+        if (m_pick.hasRequest()) {
+            VkViewport viewport{0, 0, (float)m_swapchainExtent.width, (float)m_swapchainExtent.height, 0, 1};
+            VkRect2D scissor{{0, 0}, m_swapchainExtent};
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+            m_pick.replay(cmd);
+        }
+    }
     
     vkCmdEndRenderPass(cmd);
+    m_pick.recordCopy(cmd);  // Requested rect into this slot's staging
+    m_streamer.recordResolve(cmd, m_currentFrame);  // Texel density for updateTextureStreaming()
+    if (!m_readbackBuffers.empty()) recordReadback(cmd);
+    m_gpuProfiler.endScope(cmd, m_frameGpuScope);
+    m_frameGpuScope = GpuProfiler::NO_SCOPE;
     vkEndCommandBuffer(cmd);
     
-    VkSemaphore waitSems[] = {m_imageAvailableSemaphores[m_currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    VkSemaphore signalSems[] = {m_renderFinishedSemaphores[m_currentFrame]};
+    // Async compute: slot 1 of the wait / signal arrays holds the compute
+    // timeline (waited for only at the stages reading the batch) and the
+    // graphics timeline (signalled with the frame number); binary
+    // semaphores in slot 0 take value 0, which is ignored
+    VkSemaphore waitSems[] = {m_imageAvailableSemaphores[m_currentFrame], m_asyncCompute.getComputeSemaphore()};
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, m_computeWaitStages};
+    uint64_t waitValues[] = {0, m_computeWaitValue};
+    VkSemaphore signalSems[] = {m_renderFinishedSemaphores[m_currentFrame], m_asyncCompute.getGraphicsSemaphore()};
+    uint64_t signalValues[] = {0, m_frameNumber};
+    
+    // Headless frames have no acquire to wait on and no present to signal
+    uint32_t semaphoreCount = m_config.headless ? 0 : 1;
+    bool timelines = m_asyncCompute.isEnabled();
+    uint32_t computeWaits = (timelines && m_computeWaitValue != AsyncCompute::NO_WORK) ? 1 : 0;
+    uint32_t timelineSignals = timelines ? 1 : 0;
+    
+    // Dynamic resolution: the scene goes in its own batch ahead of the UI
+    // one, so it runs without waiting for the swapchain image
+    std::array<VkSubmitInfo, 2> submits{};
+    std::array<VkTimelineSemaphoreSubmitInfoKHR, 2> timelineInfos{};
+    uint32_t submitCount = 0;
+    if (m_uiPassStarted) {
+        VkTimelineSemaphoreSubmitInfoKHR& sceneTimeline = timelineInfos[submitCount];
+        sceneTimeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        sceneTimeline.waitSemaphoreValueCount = computeWaits;
+        sceneTimeline.pWaitSemaphoreValues = waitValues + 1;
+        
+        VkSubmitInfo& sceneSubmit = submits[submitCount++];
+        sceneSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        sceneSubmit.pNext = timelines ? &sceneTimeline : nullptr;
+        sceneSubmit.waitSemaphoreCount = computeWaits;
+        sceneSubmit.pWaitSemaphores = waitSems + 1;
+        sceneSubmit.pWaitDstStageMask = waitStages + 1;
+        sceneSubmit.commandBufferCount = 1;
+        sceneSubmit.pCommandBuffers = &sceneCmd;
+        computeWaits = 0;  // Done by the scene batch
+    }
     
-    VkSubmitInfo submitInfo{};
+    uint32_t firstWait = 1 - semaphoreCount;
+    uint32_t firstSignal = 1 - semaphoreCount;
+    VkTimelineSemaphoreSubmitInfoKHR& timelineInfo = timelineInfos[submitCount];
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineInfo.waitSemaphoreValueCount = semaphoreCount + computeWaits;
+    timelineInfo.pWaitSemaphoreValues = waitValues + firstWait;
+    timelineInfo.signalSemaphoreValueCount = semaphoreCount + timelineSignals;
+    timelineInfo.pSignalSemaphoreValues = signalValues + firstSignal;
+    
+    VkSubmitInfo& submitInfo = submits[submitCount++];
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSems;
-    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.pNext = timelines ? &timelineInfo : nullptr;
+    submitInfo.waitSemaphoreCount = semaphoreCount + computeWaits;
+    submitInfo.pWaitSemaphores = waitSems + firstWait;
+    submitInfo.pWaitDstStageMask = waitStages + firstWait;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmd;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSems;
+    submitInfo.signalSemaphoreCount = semaphoreCount + timelineSignals;
+    submitInfo.pSignalSemaphores = signalSems + firstSignal;
+    
+    // Textures recorded into a still-open upload batch must be on the queue
+    // ahead of the frame that samples them
+    m_uploadBatch.flush();
+    
+    bool submitted = vkQueueSubmit(m_graphicsQueue, submitCount, submits.data(),
+                                   m_inFlightFences[m_currentFrame]) == VK_SUCCESS;
+    if (!submitted) {
+        // Nothing was queued, so nothing signals this frame's fence, its
+        // graphics timeline value (the next compute batch waits on it) or
+        // its present semaphore. Once the device is idle, signal the first
+        // two by hand - an empty batch that also consumes the acquire - and
+        // recreate the swapchain instead of presenting
+        std::cerr << "[VulkanCore] vkQueueSubmit failed - frame " << m_frameNumber << " dropped" << std::endl;
+        vkDeviceWaitIdle(m_device);
+        m_asyncCompute.signalGraphics(m_frameNumber);
+        VkSubmitInfo emptySubmit{};
+        emptySubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        emptySubmit.waitSemaphoreCount = semaphoreCount;
+        emptySubmit.pWaitSemaphores = waitSems;
+        emptySubmit.pWaitDstStageMask = waitStages;
+        if (vkQueueSubmit(m_graphicsQueue, 1, &emptySubmit, m_inFlightFences[m_currentFrame]) != VK_SUCCESS) {
+            // Can't even signal the fence: beginFrame() must not wait on it
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+            vkDestroyFence(m_device, m_inFlightFences[m_currentFrame], nullptr);
+            vkCreateFence(m_device, &fenceInfo, nullptr, &m_inFlightFences[m_currentFrame]);
+        }
+        if (!m_config.headless) m_framebufferResized = true;
+    }
+    
+    // Everything created since the last frame goes to the transfer queue as one batch
+    m_uploads.flush();
     
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_inFlightFences[m_currentFrame]);
+    if (m_config.headless || !submitted) {
+        if (!m_readbackBuffers.empty() && submitted) m_lastReadbackFrame = static_cast<int32_t>(m_currentFrame);
+        m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+        m_frameStarted = false;
+        return;
+    }
     
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -788,20 +1620,376 @@ void VulkanCore::endFrame() {
         m_framebufferResized = true;
     }
     
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
     m_frameStarted = false;
 }
 
+void VulkanCore::beginUiPass() {
+    if (!m_frameStarted || m_uiPassStarted || !m_dynamicRes.isEnabled() || isRecordingTask()) return;
+    
+    VkCommandBuffer sceneCmd = m_commandBuffers[m_currentFrame];
+    if (m_config.parallelRecording) {
+        closeMainSegment();
+        vkCmdExecuteCommands(sceneCmd, static_cast<uint32_t>(m_frameSecondaries.size()), m_frameSecondaries.data());
+    }
+    vkCmdEndRenderPass(sceneCmd);
+    m_gpuProfiler.endScope(sceneCmd, m_sceneGpuScope);
+    m_sceneGpuScope = GpuProfiler::NO_SCOPE;
+    vkEndCommandBuffer(sceneCmd);
+    
+    // The "frame" scope and the rest of endFrame() continue in here
+    VkCommandBuffer cmd = m_uiCommandBuffers[m_currentFrame];
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+    m_dynamicRes.recordSceneRead(cmd);
+    
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[1].depthStencil = {1.0f, 0};
+    
+    VkRenderPassBeginInfo rpInfo{};
+    rpInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    rpInfo.renderPass = m_uiRenderPass;
+    rpInfo.framebuffer = m_framebuffers[m_imageIndex];
+    rpInfo.renderArea.extent = m_swapchainExtent;
+    rpInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    rpInfo.pClearValues = clearValues.data();
+    vkCmdBeginRenderPass(cmd, &rpInfo, VK_SUBPASS_CONTENTS_INLINE);
+    
+    VkViewport viewport{0, 0, (float)m_swapchainExtent.width, (float)m_swapchainExtent.height, 0, 1};
+    VkRect2D scissor{{0, 0}, m_swapchainExtent};
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+    
+    uint32_t scope = m_gpuProfiler.beginScope(cmd, "upscale");
+    m_dynamicRes.recordUpscale(cmd);
+    m_gpuProfiler.endScope(cmd, scope);
+    
+    m_uiPassStarted = true;
+    m_mainContext.cmd = cmd;
+    recordPipelineBind(cmd, m_mainContext.pipeline, m_mainContext.pass);
+}
+
+// ============================================================================
+// GPU Profiling
+// ============================================================================
+
+uint32_t VulkanCore::addFramePrologue(std::function<void(VkCommandBuffer)> prologue, int order) {
+    return insertPrologue(FramePrologue{0, order, std::move(prologue)});
+}
+
+uint32_t VulkanCore::addComputePrologue(std::function<void(VkCommandBuffer)> prologue,
+                                        VkPipelineStageFlags consumerStages, bool perFrameOutputs, int order) {
+    return insertPrologue(FramePrologue{0, order, std::move(prologue), true, consumerStages, perFrameOutputs});
+}
+
+uint32_t VulkanCore::insertPrologue(FramePrologue prologue) {
+    prologue.id = m_nextPrologueId++;
+    auto at = std::upper_bound(m_framePrologues.begin(), m_framePrologues.end(), prologue.order,
+                               [](int value, const FramePrologue& entry) { return value < entry.order; });
+    return m_framePrologues.insert(at, std::move(prologue))->id;
+}
+
+// All compute prologues as one compute-queue batch the frame waits for.
+// The profiler stays out: its queries are reset by the graphics batch,
+// which is submitted after this one
+void VulkanCore::runComputePrologues() {
+    VkPipelineStageFlags consumers = 0;
+    bool any = false, perFrame = true;
+    for (const auto& prologue : m_framePrologues) {
+        if (!prologue.compute) continue;
+        any = true;
+        consumers |= prologue.consumers;
+        perFrame = perFrame && prologue.perFrame;
+    }
+    if (!any) return;
+    
+    m_gpuProfiler.setSuspended(true);
+    uint64_t value = submitCompute([this](VkCommandBuffer cmd) {
+        for (auto& prologue : m_framePrologues) {
+            if (prologue.compute) prologue.run(cmd);
+        }
+    }, perFrame ? 0 : m_frameNumber - 1);
+    m_gpuProfiler.setSuspended(false);
+    waitForCompute(value, consumers);
+}
+
+uint64_t VulkanCore::submitCompute(const std::function<void(VkCommandBuffer)>& record, uint64_t afterFrame) {
+    return m_asyncCompute.submit(record, afterFrame);
+}
+
+void VulkanCore::waitForCompute(uint64_t value, VkPipelineStageFlags stages) {
+    if (value == AsyncCompute::NO_WORK) return;
+    m_computeWaitValue = std::max(m_computeWaitValue, value);
+    m_computeWaitStages |= stages ? stages : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+}
+
+void VulkanCore::removeFramePrologue(uint32_t id) {
+    m_framePrologues.erase(std::remove_if(m_framePrologues.begin(), m_framePrologues.end(),
+                                          [id](const FramePrologue& entry) { return entry.id == id; }),
+                           m_framePrologues.end());
+}
+
+void VulkanCore::deferDestroy(std::function<void()> destroy) {
+    // Without a device there is nothing left to destroy
+    if (!destroy || !m_initialized) return;
+    m_deletions.push(m_frameNumber, std::move(destroy));
+}
+
+uint32_t VulkanCore::beginGpuScope(const char* name) {
+    if (!m_frameStarted) return GpuProfiler::NO_SCOPE;
+    return m_gpuProfiler.beginScope(getCurrentCommandBuffer(), name);
+}
+
+void VulkanCore::endGpuScope(uint32_t scope) {
+    if (!m_frameStarted) return;
+    m_gpuProfiler.endScope(getCurrentCommandBuffer(), scope);
+}
+
+// ============================================================================
+// Draw Capture
+// ============================================================================
+
+bool VulkanCore::beginCapture(const std::string& path, uint32_t frames) {
+    if (!m_drawCapture) {
+        std::cerr << "[VulkanCore] beginCapture: set CoreConfig::captureResources before init()" << std::endl;
+        return false;
+    }
+    if (!m_drawCapture->start(path, frames, m_swapchainExtent.width, m_swapchainExtent.height)) {
+        std::cerr << "[VulkanCore] beginCapture: a capture is already armed (or no frames/path)" << std::endl;
+        return false;
+    }
+    std::cout << "[VulkanCore] Capturing " << frames << " frames to " << path << std::endl;
+    return true;
+}
+
+bool VulkanCore::isCapturing() const {
+    return m_drawCapture && m_drawCapture->isArmed();
+}
+
+// ============================================================================
+// Parallel Recording
+// ============================================================================
+
+thread_local VulkanCore::RecordContext* VulkanCore::t_recordContext = nullptr;
+
+bool VulkanCore::createRecordWorkers() {
+    m_mainContext.owner = this;
+    if (!m_config.parallelRecording) return true;
+    
+    uint32_t hw = std::thread::hardware_concurrency();
+    uint32_t workerCount = std::min(MAX_RECORD_WORKERS, hw > 1 ? hw - 1 : 1u);
+    
+    m_recordSlots.resize(workerCount + 1);
+    for (auto& slot : m_recordSlots) {
+        slot.pools.resize(m_framesInFlight, VK_NULL_HANDLE);
+        slot.buffers.resize(m_framesInFlight);
+        slot.used.resize(m_framesInFlight, 0);
+        
+        for (auto& pool : slot.pools) {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = m_graphicsFamily;
+            if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+                std::cerr << "[VulkanCore] Failed to create recording command pool" << std::endl;
+                return false;
+            }
+        }
+    }
+    
+    m_workersQuit = false;
+    for (uint32_t i = 0; i < workerCount; i++) {
+        m_recordWorkers.emplace_back(&VulkanCore::workerLoop, this, i + 1);
+    }
+    
+    std::cout << "[VulkanCore] Parallel recording: " << workerCount << " worker threads" << std::endl;
+    return true;
+}
+
+void VulkanCore::destroyRecordWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(m_workMutex);
+        m_workersQuit = true;
+    }
+    m_workCv.notify_all();
+    for (auto& worker : m_recordWorkers) {
+        worker.join();
+    }
+    m_recordWorkers.clear();
+    
+    // Freeing a pool frees its command buffers
+    for (auto& slot : m_recordSlots) {
+        for (VkCommandPool pool : slot.pools) {
+            if (pool != VK_NULL_HANDLE) vkDestroyCommandPool(m_device, pool, nullptr);
+        }
+    }
+    m_recordSlots.clear();
+}
+
+VkCommandBuffer VulkanCore::acquireSecondary(uint32_t slotIndex) {
+    RecordSlot& slot = m_recordSlots[slotIndex];
+    std::vector<VkCommandBuffer>& buffers = slot.buffers[m_currentFrame];
+    uint32_t& used = slot.used[m_currentFrame];
+    
+    if (used == buffers.size()) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = slot.pools[m_currentFrame];
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+        
+        VkCommandBuffer cmd;
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &cmd) != VK_SUCCESS) {
+            return VK_NULL_HANDLE;
+        }
+        buffers.push_back(cmd);
+    }
+    return buffers[used++];
+}
+
+// Begins a secondary that continues the frame's render pass
+void VulkanCore::beginSecondary(VkCommandBuffer cmd) {
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = m_renderPass;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = sceneFramebuffer();
+    
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+    
+    // Secondaries inherit no dynamic state
+    VkExtent2D extent = sceneExtent();
+    VkViewport viewport{0, 0, (float)extent.width, (float)extent.height, 0, 1};
+    VkRect2D scissor{{0, 0}, extent};
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
+
+// Main-thread recording between recordParallel() calls
+void VulkanCore::openMainSegment() {
+    VkCommandBuffer cmd = acquireSecondary(0);
+    beginSecondary(cmd);
+    m_mainContext.cmd = cmd;
+    recordPipelineBind(cmd, m_mainContext.pipeline, m_mainContext.pass);
+}
+
+void VulkanCore::closeMainSegment() {
+    vkEndCommandBuffer(m_mainContext.cmd);
+    m_frameSecondaries.push_back(m_mainContext.cmd);
+    m_mainContext.cmd = VK_NULL_HANDLE;
+}
+
+// Pulls tasks until none are left, recording each into a secondary from
+// this thread's pool
+void VulkanCore::runRecordTasks(uint32_t slot) {
+    for (;;) {
+        uint32_t task = m_nextWorkTask.fetch_add(1);
+        if (task >= m_workTaskCount) break;
+        
+        RecordContext ctx;
+        ctx.owner = this;
+        ctx.cmd = acquireSecondary(slot);
+        ctx.pipeline = m_mainContext.pipeline;
+        ctx.textureIndex = m_mainContext.textureIndex;
+        ctx.texture = m_mainContext.texture;
+        ctx.pass = m_mainContext.pass;
+        ctx.slot = slot;
+        ctx.pickObject = m_mainContext.pickObject;
+        m_taskBuffers[task] = ctx.cmd;
+        if (ctx.cmd == VK_NULL_HANDLE) continue;
+        
+        beginSecondary(ctx.cmd);
+        recordPipelineBind(ctx.cmd, ctx.pipeline, ctx.pass);
+        
+        t_recordContext = &ctx;
+        (*m_workFn)(task);
+        t_recordContext = nullptr;
+        
+        vkEndCommandBuffer(ctx.cmd);
+    }
+}
+
+void VulkanCore::workerLoop(uint32_t slot) {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_workMutex);
+            m_workCv.wait(lock, [&] { return m_workersQuit || m_workGeneration != seenGeneration; });
+            if (m_workersQuit) return;
+            seenGeneration = m_workGeneration;
+        }
+        
+        runRecordTasks(slot);
+        
+        {
+            std::lock_guard<std::mutex> lock(m_workMutex);
+            if (--m_workersBusy == 0) m_workDoneCv.notify_one();
+        }
+    }
+}
+
+void VulkanCore::recordParallel(uint32_t taskCount, const std::function<void(uint32_t task)>& record) {
+    if (!m_frameStarted || taskCount == 0 || !record) return;
+    if (isRecordingTask()) return;  // No nesting
+    
+    // The UI pass is recorded inline
+    if (!m_config.parallelRecording || m_uiPassStarted) {
+        for (uint32_t task = 0; task < taskCount; task++) {
+            record(task);
+        }
+        return;
+    }
+    
+    closeMainSegment();
+    
+    m_taskBuffers.assign(taskCount, VK_NULL_HANDLE);
+    m_parallelActive = true;
+    {
+        std::lock_guard<std::mutex> lock(m_workMutex);
+        m_workFn = &record;
+        m_workTaskCount = taskCount;
+        m_nextWorkTask = 0;
+        m_workersBusy = static_cast<uint32_t>(m_recordWorkers.size());
+        m_workGeneration++;
+    }
+    m_workCv.notify_all();
+    
+    // The calling thread records too (slot 0 - its segment is closed)
+    runRecordTasks(0);
+    
+    {
+        std::unique_lock<std::mutex> lock(m_workMutex);
+        m_workDoneCv.wait(lock, [&] { return m_workersBusy == 0; });
+        m_workFn = nullptr;
+    }
+    m_parallelActive = false;
+    
+    for (VkCommandBuffer cmd : m_taskBuffers) {
+        if (cmd != VK_NULL_HANDLE) m_frameSecondaries.push_back(cmd);
+    }
+    
+    openMainSegment();
+}
+
 // ============================================================================
 // Pipeline Creation
 // ============================================================================
 
 PipelineHandle VulkanCore::createPipeline(const PipelineConfig& config) {
-    auto vertCode = readShaderFile(config.vertexShaderPath);
+    std::string vertexShaderPath = vertexShaderVariant(config.vertexShaderPath, config.vertexFormat);
+    auto vertCode = readShaderFile(vertexShaderPath);
     auto fragCode = readShaderFile(config.fragmentShaderPath);
     
     if (vertCode.empty() || fragCode.empty()) {
-        std::cerr << "[VulkanCore] Failed to load shaders: " << config.vertexShaderPath << ", " << config.fragmentShaderPath << std::endl;
+        std::cerr << "[VulkanCore] Failed to load shaders: " << vertexShaderPath << ", " << config.fragmentShaderPath << std::endl;
+        if (vertCode.empty() && isPackedVertexFormat(config.vertexFormat)) {
+            std::cerr << "[VulkanCore] Packed vertex formats need the -DVERTEX_PACKED build of the vertex shader" << std::endl;
+        }
         return INVALID_PIPELINE;
     }
     
@@ -818,13 +2006,17 @@ PipelineHandle VulkanCore::createPipeline(const PipelineConfig& config) {
     stages[1].module = fragModule;
     stages[1].pName = "main";
     
-    auto bindingDesc = getBindingDescription(config.vertexFormat);
+    VkVertexInputBindingDescription bindingDescs[2] = {getBindingDescription(config.vertexFormat),
+                                                       getInstanceBindingDescription()};
     auto attrDescs = getAttributeDescriptions(config.vertexFormat);
+    if (config.instanced) {
+        appendInstanceAttributes(attrDescs);
+    }
     
     VkPipelineVertexInputStateCreateInfo vertexInput{};
     vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInput.vertexBindingDescriptionCount = 1;
-    vertexInput.pVertexBindingDescriptions = &bindingDesc;
+    vertexInput.vertexBindingDescriptionCount = config.instanced ? 2 : 1;
+    vertexInput.pVertexBindingDescriptions = bindingDescs;
     vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrDescs.size());
     vertexInput.pVertexAttributeDescriptions = attrDescs.data();
     
@@ -878,10 +2070,29 @@ PipelineHandle VulkanCore::createPipeline(const PipelineConfig& config) {
     dynamicState.dynamicStateCount = 2;
     dynamicState.pDynamicStates = dynamicStates;
     
+    if (config.bindless && !m_bindless.isInitialized()) {
+        std::cerr << "[VulkanCore] Bindless pipeline requested but there is no bindless heap: "
+                  << config.vertexShaderPath << std::endl;
+        vkDestroyShaderModule(m_device, vertModule, nullptr);
+        vkDestroyShaderModule(m_device, fragModule, nullptr);
+        return INVALID_PIPELINE;
+    }
+    
+    // Bindless pipelines: heap at set BINDLESS_SET + the texture slot as a push constant.
+    // Pickable ones push their first triangle id after it (PickPushConstants)
+    bool pickable = config.pickable && m_pickShader != VK_NULL_HANDLE;
+    VkDescriptorSetLayout setLayouts[] = {m_descriptorSetLayout, m_bindless.getLayout()};
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushRange.offset = 0;
+    pushRange.size = pickable ? sizeof(PickPushConstants) : sizeof(BindlessPushConstants);
+    
     VkPipelineLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    layoutInfo.setLayoutCount = 1;
-    layoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    layoutInfo.setLayoutCount = config.bindless ? 2 : 1;
+    layoutInfo.pSetLayouts = setLayouts;
+    layoutInfo.pushConstantRangeCount = (config.bindless || pickable) ? 1 : 0;
+    layoutInfo.pPushConstantRanges = &pushRange;
     
     VkPipelineLayout pipelineLayout;
     if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
@@ -907,7 +2118,73 @@ PipelineHandle VulkanCore::createPipeline(const PipelineConfig& config) {
     pipelineInfo.subpass = 0;
     
     VkPipeline pipeline;
-    VkResult result = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    VkResult result = vkCreateGraphicsPipelines(m_device, m_pipelineCache.get(), 1, &pipelineInfo, nullptr, &pipeline);
+    
+    PipelineResource pipe;
+    pipe.pipeline = pipeline;
+    pipe.layout = pipelineLayout;
+    pipe.instanced = config.instanced;
+    pipe.bindless = config.bindless;
+    
+    // Variants share the layout and vertex stage. Without a fragment stage
+    // (and with color writes masked) a pipeline only touches depth.
+    auto createVariant = [&](bool shade, VkCompareOp compareOp, bool depthWrite) {
+        VkPipelineDepthStencilStateCreateInfo variantDepth = depthStencil;
+        variantDepth.depthCompareOp = compareOp;
+        variantDepth.depthWriteEnable = depthWrite ? VK_TRUE : VK_FALSE;
+        VkPipelineColorBlendAttachmentState variantBlend = colorBlendAttachment;
+        if (!shade) variantBlend.colorWriteMask = 0;
+        VkPipelineColorBlendStateCreateInfo variantBlending = colorBlending;
+        variantBlending.pAttachments = &variantBlend;
+        
+        VkGraphicsPipelineCreateInfo variantInfo = pipelineInfo;
+        variantInfo.stageCount = shade ? 2 : 1;
+        variantInfo.pDepthStencilState = &variantDepth;
+        variantInfo.pColorBlendState = &variantBlending;
+        
+        VkPipeline variant = VK_NULL_HANDLE;
+        if (vkCreateGraphicsPipelines(m_device, m_pipelineCache.get(), 1, &variantInfo, nullptr, &variant) != VK_SUCCESS) {
+            std::cerr << "[VulkanCore] Failed to create pipeline variant: " << config.vertexShaderPath << std::endl;
+            return VkPipeline(VK_NULL_HANDLE);
+        }
+        return variant;
+    };
+    
+    if (result == VK_SUCCESS && m_config.depthPrepass && config.depthTest && config.depthWrite && !config.alphaBlend) {
+        pipe.depthOnly = createVariant(false, VK_COMPARE_OP_LESS, true);
+        pipe.shading = createVariant(true, VK_COMPARE_OP_EQUAL, false);
+        if (pipe.depthOnly == VK_NULL_HANDLE || pipe.shading == VK_NULL_HANDLE) {
+            destroyPipelineVariants(pipe);  // Both or neither
+        }
+    }
+    if (result == VK_SUCCESS && m_config.maxOcclusionQueries > 0 && config.depthTest) {
+        pipe.occlusionProxy = createVariant(false, VK_COMPARE_OP_LESS, false);
+    }
+    if (result == VK_SUCCESS && pickable) {
+        // Pick subpass: pick_id.frag into the R32_UINT attachment, depth
+        // LESS_OR_EQUAL without writes so only what subpass 0 kept visible wins
+        VkPipelineShaderStageCreateInfo pickStages[2] = {stages[0], stages[1]};
+        pickStages[1].module = m_pickShader;
+        VkPipelineDepthStencilStateCreateInfo pickDepth = depthStencil;
+        pickDepth.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+        pickDepth.depthWriteEnable = VK_FALSE;
+        VkPipelineColorBlendAttachmentState pickBlend{};
+        pickBlend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+        VkPipelineColorBlendStateCreateInfo pickBlending = colorBlending;
+        pickBlending.pAttachments = &pickBlend;
+        
+        VkGraphicsPipelineCreateInfo pickInfo = pipelineInfo;
+        pickInfo.pStages = pickStages;
+        pickInfo.pDepthStencilState = &pickDepth;
+        pickInfo.pColorBlendState = &pickBlending;
+        pickInfo.subpass = 1;
+        if (vkCreateGraphicsPipelines(m_device, m_pipelineCache.get(), 1, &pickInfo, nullptr, &pipe.pickId) != VK_SUCCESS) {
+            std::cerr << "[VulkanCore] Failed to create pick variant: " << config.vertexShaderPath << std::endl;
+            pipe.pickId = VK_NULL_HANDLE;
+        }
+    } else if (result == VK_SUCCESS && config.pickable && m_config.pickBuffer) {
+        std::cout << "[VulkanCore] No pick buffer - not pickable: " << config.vertexShaderPath << std::endl;
+    }
     
     vkDestroyShaderModule(m_device, vertModule, nullptr);
     vkDestroyShaderModule(m_device, fragModule, nullptr);
@@ -918,24 +2195,76 @@ PipelineHandle VulkanCore::createPipeline(const PipelineConfig& config) {
     }
     
     // Store
-    PipelineHandle handle = static_cast<PipelineHandle>(m_pipelines.size());
-    m_pipelines.push_back({pipeline, pipelineLayout, true});
+    PipelineHandle handle = m_pipelines.insert(pipe);
+    if (handle == INVALID_PIPELINE) {
+        destroyPipelineVariants(pipe);
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+        vkDestroyPipelineLayout(m_device, pipelineLayout, nullptr);
+        return INVALID_PIPELINE;
+    }
     
+    if (m_drawCapture) m_drawCapture->retainPipeline(handle, config);
     std::cout << "[VulkanCore] Pipeline created: " << config.vertexShaderPath << std::endl;
     return handle;
 }
 
 void VulkanCore::bindPipeline(PipelineHandle handle) {
-    if (handle >= m_pipelines.size() || !m_pipelines[handle].valid) return;
-    m_currentPipeline = handle;
-    vkCmdBindPipeline(m_commandBuffers[m_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelines[handle].pipeline);
+    if (!m_pipelines.contains(handle)) return;
+    RecordContext& ctx = recordContext();
+    ctx.pipeline = handle;
+    recordPipelineBind(ctx.cmd, handle, ctx.pass);
+    if (m_drawCapture) m_drawCapture->bindPipeline(handle);
+}
+
+void VulkanCore::setDrawPass(DrawPass pass) {
+    RecordContext& ctx = recordContext();
+    if (ctx.pass == pass) return;
+    ctx.pass = pass;
+    if (m_frameStarted && ctx.pipeline != INVALID_PIPELINE) recordPipelineBind(ctx.cmd, ctx.pipeline, pass);
+}
+
+// Pipelines without DrawPass variants draw the same in every pass
+VkPipeline VulkanCore::passPipeline(const PipelineResource& pipe, DrawPass pass) {
+    if (pass == DrawPass::DepthOnly && pipe.depthOnly != VK_NULL_HANDLE) return pipe.depthOnly;
+    if (pass == DrawPass::Shading && pipe.shading != VK_NULL_HANDLE) return pipe.shading;
+    return pipe.pipeline;
+}
+
+void VulkanCore::recordPipelineBind(VkCommandBuffer cmd, PipelineHandle handle, DrawPass pass) {
+    if (!m_pipelines.contains(handle)) return;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, passPipeline(m_pipelines[handle], pass));
+    
+    // Set 1 stays bound across the per-draw set 0 binds (compatible layouts)
+    if (m_pipelines[handle].bindless) {
+        m_bindless.bind(cmd, m_pipelines[handle].layout, BINDLESS_SET);
+    }
+}
+
+void VulkanCore::pushBindlessIndex(VkCommandBuffer cmd, PipelineHandle pipeline, uint32_t textureIndex) {
+    if (!m_pipelines[pipeline].bindless) return;
+    BindlessPushConstants push{textureIndex};
+    vkCmdPushConstants(cmd, m_pipelines[pipeline].layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(push), &push);
 }
 
 void VulkanCore::destroyPipeline(PipelineHandle handle) {
-    if (handle >= m_pipelines.size() || !m_pipelines[handle].valid) return;
-    vkDestroyPipeline(m_device, m_pipelines[handle].pipeline, nullptr);
-    vkDestroyPipelineLayout(m_device, m_pipelines[handle].layout, nullptr);
-    m_pipelines[handle].valid = false;
+    PipelineResource pipe;
+    if (!m_pipelines.remove(handle, &pipe)) return;
+    if (recordContext().pipeline == handle) recordContext().pipeline = INVALID_PIPELINE;
+    if (m_drawCapture) m_drawCapture->releasePipeline(handle);
+    
+    m_deletions.push(m_frameNumber, [this, pipe]() mutable {
+        destroyPipelineVariants(pipe);
+        vkDestroyPipeline(m_device, pipe.pipeline, nullptr);
+        vkDestroyPipelineLayout(m_device, pipe.layout, nullptr);
+    });
+}
+
+void VulkanCore::destroyPipelineVariants(PipelineResource& pipe) {
+    for (VkPipeline* variant : {&pipe.depthOnly, &pipe.shading, &pipe.occlusionProxy, &pipe.pickId}) {
+        if (*variant != VK_NULL_HANDLE) vkDestroyPipeline(m_device, *variant, nullptr);
+        *variant = VK_NULL_HANDLE;
+    }
 }
 
 // ============================================================================
@@ -943,75 +2272,133 @@ void VulkanCore::destroyPipeline(PipelineHandle handle) {
 // ============================================================================
 
 BufferHandle VulkanCore::createVertexBuffer(const void* data, size_t size) {
+    return createDeviceLocalBuffer(data, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+}
+
+BufferHandle VulkanCore::createIndexBuffer(const uint32_t* data, size_t count) {
+    return createDeviceLocalBuffer(data, count * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
+
+BufferHandle VulkanCore::createDeviceLocalBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage) {
     VkBuffer buffer;
-    VkDeviceMemory memory;
-    
-    if (!createBufferInternal(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                              buffer, memory)) {
+    GpuAllocation alloc;
+    if (!createDeviceBuffer(size, usage, buffer, alloc)) {
         return INVALID_BUFFER;
     }
     
-    void* mapped;
-    vkMapMemory(m_device, memory, 0, size, 0, &mapped);
-    memcpy(mapped, data, size);
-    vkUnmapMemory(m_device, memory);
+    UploadManager::Ticket ticket = UploadManager::NO_UPLOAD;
+    if (data) {
+        ticket = m_uploads.uploadBuffer(buffer, data, size);
+        if (ticket == UploadManager::NO_UPLOAD) {
+            m_allocator.destroyBuffer(buffer, alloc);
+            return INVALID_BUFFER;
+        }
+    }
     
-    BufferHandle handle = static_cast<BufferHandle>(m_buffers.size());
-    m_buffers.push_back({buffer, memory, size, true});
+    BufferHandle handle = m_buffers.insert({buffer, alloc, size, ticket, usage});
+    if (handle == INVALID_BUFFER) {
+        m_uploads.wait(ticket);
+        m_allocator.destroyBuffer(buffer, alloc);
+    }
     return handle;
 }
 
-BufferHandle VulkanCore::createIndexBuffer(const uint32_t* data, size_t count) {
-    size_t size = count * sizeof(uint32_t);
-    VkBuffer buffer;
-    VkDeviceMemory memory;
+// Transfer source too, so the memory budget can move it to host memory
+bool VulkanCore::createDeviceBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, GpuAllocation& alloc) {
+    // Shared between the graphics and transfer families so the copy needs no
+    // queue ownership transfer
+    uint32_t families[] = {m_graphicsFamily, m_transferFamily};
     
-    if (!createBufferInternal(size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                              buffer, memory)) {
-        return INVALID_BUFFER;
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (m_transferFamily != m_graphicsFamily) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = families;
+    } else {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     }
+    return m_allocator.createBuffer(bufferInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, alloc);
+}
+
+bool VulkanCore::createSharedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                                    VkBuffer& buffer, GpuAllocation& alloc) {
+    uint32_t families[] = {m_graphicsFamily, m_computeFamily};
     
-    void* mapped;
-    vkMapMemory(m_device, memory, 0, size, 0, &mapped);
-    memcpy(mapped, data, size);
-    vkUnmapMemory(m_device, memory);
-    
-    BufferHandle handle = static_cast<BufferHandle>(m_buffers.size());
-    m_buffers.push_back({buffer, memory, size, true});
-    return handle;
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    if (m_computeFamily != m_graphicsFamily) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = families;
+    } else {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+    return m_allocator.createBuffer(bufferInfo, properties, buffer, alloc);
+}
+
+bool VulkanCore::createSharedImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+                                   VkImage& image, GpuAllocation& alloc) {
+    uint32_t families[] = {m_graphicsFamily, m_computeFamily};
+    
+    VkImageCreateInfo sharedInfo = imageInfo;
+    if (m_computeFamily != m_graphicsFamily) {
+        sharedInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        sharedInfo.queueFamilyIndexCount = 2;
+        sharedInfo.pQueueFamilyIndices = families;
+    }
+    return m_allocator.createImage(sharedInfo, properties, image, alloc);
+}
+
+UploadManager::Ticket VulkanCore::uploadToBuffer(BufferHandle handle, const void* data, VkDeviceSize size, VkDeviceSize dstOffset) {
+    if (!m_buffers.contains(handle)) return UploadManager::NO_UPLOAD;
+    if (dstOffset + size > m_buffers[handle].size) {
+        std::cerr << "[VulkanCore] uploadToBuffer: " << size << " bytes at " << dstOffset
+                  << " overruns buffer of " << m_buffers[handle].size << std::endl;
+        return UploadManager::NO_UPLOAD;
+    }
+    return m_uploads.uploadBuffer(m_buffers[handle].buffer, data, size, dstOffset);
+}
+
+bool VulkanCore::isBufferReady(BufferHandle handle) const {
+    if (!m_buffers.contains(handle)) return false;
+    return m_uploads.isComplete(m_buffers[handle].uploadTicket);
 }
 
 BufferHandle VulkanCore::createUniformBuffer(size_t size) {
     VkBuffer buffer;
-    VkDeviceMemory memory;
+    GpuAllocation alloc;
     
     if (!createBufferInternal(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                              buffer, memory)) {
+                              buffer, alloc)) {
         return INVALID_BUFFER;
     }
     
-    BufferHandle handle = static_cast<BufferHandle>(m_buffers.size());
-    m_buffers.push_back({buffer, memory, size, true});
+    BufferHandle handle = m_buffers.insert({buffer, alloc, size});
+    if (handle == INVALID_BUFFER) m_allocator.destroyBuffer(buffer, alloc);
     return handle;
 }
 
 void VulkanCore::updateUniformBuffer(BufferHandle handle, const void* data, size_t size) {
-    if (handle >= m_buffers.size() || !m_buffers[handle].valid) return;
+    if (!m_buffers.contains(handle)) return;
     
-    void* mapped;
-    vkMapMemory(m_device, m_buffers[handle].memory, 0, size, 0, &mapped);
-    memcpy(mapped, data, size);
-    vkUnmapMemory(m_device, m_buffers[handle].memory);
+    memcpy(m_buffers[handle].alloc.mapped, data, size);
 }
 
 void VulkanCore::destroyBuffer(BufferHandle handle) {
-    if (handle >= m_buffers.size() || !m_buffers[handle].valid) return;
-    vkDestroyBuffer(m_device, m_buffers[handle].buffer, nullptr);
-    vkFreeMemory(m_device, m_buffers[handle].memory, nullptr);
-    m_buffers[handle].valid = false;
+    BufferResource buf;
+    if (!m_buffers.remove(handle, &buf)) return;
+    
+    m_deletions.push(m_frameNumber, [this, buf]() mutable {
+        // Never free a buffer the transfer queue is still writing
+        m_uploads.wait(buf.uploadTicket);
+        m_allocator.destroyBuffer(buf.buffer, buf.alloc);
+    });
 }
 
 // ============================================================================
@@ -1019,170 +2406,376 @@ void VulkanCore::destroyBuffer(BufferHandle handle) {
 // ============================================================================
 
 TextureHandle VulkanCore::loadTexture(const std::string& path) {
-    // Load image using stb_image
-    int width, height, channels;
-    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-    if (!pixels) {
-        std::cerr << "[VulkanCore] Failed to load texture: " << path << std::endl;
-        return INVALID_TEXTURE;
+    std::string key = ResourceCache::canonicalPath(path);
+    auto cached = m_textureCache.find(key);
+    if (cached != m_textureCache.end() && m_textures.contains(cached->second.handle)) {
+        cached->second.refs++;
+        return cached->second.handle;
     }
     
-    TextureHandle handle = createTexture(pixels, width, height, 4);
-    stbi_image_free(pixels);
+    if (cached != m_textureCache.end()) m_textureCachePaths.erase(cached->second.handle);  // Destroyed elsewhere
     
+    TextureHandle handle = loadTextureFile(path);
     if (handle != INVALID_TEXTURE) {
-        std::cout << "[VulkanCore] Loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
+        m_textureCache[key] = {handle, 1, path};
+        m_textureCachePaths[handle] = key;
     }
     return handle;
 }
 
-TextureHandle VulkanCore::createTexture(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels) {
-    (void)channels; // Always convert to RGBA
+std::vector<TextureHandle> VulkanCore::loadTextures(const std::vector<std::string>& paths, uint32_t threads) {
+    std::vector<TextureHandle> handles(paths.size(), INVALID_TEXTURE);
+    
+    // Cache hits and .ktx2 files go through loadTexture(); the rest decode in
+    // parallel, once per distinct file
+    std::vector<std::string> decodePaths;
+    std::vector<std::vector<size_t>> decodeTargets;  // decodePaths[i] -> indices into paths
+    std::unordered_map<std::string, size_t> pending;
+    beginUploadBatch();
+    for (size_t i = 0; i < paths.size(); i++) {
+        std::string key = ResourceCache::canonicalPath(paths[i]);
+        auto queued = pending.find(key);
+        if (queued != pending.end()) {
+            decodeTargets[queued->second].push_back(i);
+            continue;
+        }
+        auto cached = m_textureCache.find(key);
+        std::string lower = paths[i];
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        bool isKTX2 = lower.size() >= 5 && lower.compare(lower.size() - 5, 5, ".ktx2") == 0;
+        if ((cached != m_textureCache.end() && m_textures.contains(cached->second.handle)) || isKTX2) {
+            handles[i] = loadTexture(paths[i]);
+            continue;
+        }
+        pending[key] = decodePaths.size();
+        decodePaths.push_back(paths[i]);
+        decodeTargets.push_back({i});
+    }
     
-    VkDeviceSize imageSize = width * height * 4;
+    // Uploads stage on this thread as images finish; UploadBatch is not thread-safe
+    decode_image_files(decodePaths, [&](DecodedImage& image) {
+        const std::string& path = decodePaths[image.index];
+        if (!image.pixels) {
+            std::cerr << "[VulkanCore] Failed to load texture: " << path << " (" << image.error << ")" << std::endl;
+            return;
+        }
+        TextureHandle handle = createTexture(image.pixels.get(), image.width, image.height, 4);
+        if (handle == INVALID_TEXTURE) return;
+        std::cout << "[VulkanCore] Loaded texture: " << path << " (" << image.width << "x" << image.height << ")" << std::endl;
+        
+        std::string key = ResourceCache::canonicalPath(path);
+        auto stale = m_textureCache.find(key);
+        if (stale != m_textureCache.end()) m_textureCachePaths.erase(stale->second.handle);  // Destroyed elsewhere
+        const std::vector<size_t>& targets = decodeTargets[image.index];
+        m_textureCache[key] = {handle, static_cast<uint32_t>(targets.size()), path};
+        m_textureCachePaths[handle] = key;
+        for (size_t target : targets) handles[target] = handle;
+    }, threads);
+    endUploadBatch();
+    return handles;
+}
+
+bool VulkanCore::reloadTexture(const std::string& path) {
+    auto cached = m_textureCache.find(ResourceCache::canonicalPath(path));
+    if (cached == m_textureCache.end() || !m_textures.contains(cached->second.handle)) return false;
+    cached->second.path = path;
+    return restoreTexture(cached->second.handle);
+}
+
+// Re-reads a loadTexture() texture's file into its handle at full resolution
+bool VulkanCore::restoreTexture(TextureHandle handle) {
+    auto path = m_textureCachePaths.find(handle);
+    if (path == m_textureCachePaths.end()) return false;
+    auto cached = m_textureCache.find(path->second);
+    if (cached == m_textureCache.end()) return false;
+    
+    // Load into a fresh slot, then move the new image under the old handle
+    TextureHandle fresh = loadTextureFile(cached->second.path);
+    if (fresh == INVALID_TEXTURE) return false;
+    TextureResource replacement;
+    m_textures.remove(fresh, &replacement);
+    if (replacement.bindlessIndex != BindlessHeap::INVALID_INDEX) {
+        m_bindless.remove(replacement.bindlessIndex);
+    }
+    replaceTexture(handle, replacement);
+    return true;
+}
+
+// Moves `replacement`'s image under `handle`, keeping its eviction state;
+// the old image is destroyed once the frames using it retire (and, if the
+// replacement was copied from it, once that is done). The new image takes
+// a fresh bindless slot - frames in flight still sample the old one.
+void VulkanCore::replaceTexture(TextureHandle handle, TextureResource& replacement) {
+    TextureResource& tex = m_textures[handle];
+    TextureResource old = tex;
+    replacement.lastUsed = old.lastUsed;
+    replacement.pinned = old.pinned;
+    tex = replacement;
+    if (old.bindlessIndex != BindlessHeap::INVALID_INDEX) {
+        tex.bindlessIndex = m_bindless.replace(old.bindlessIndex, tex.view, tex.sampler);
+    } else {
+        tex.bindlessIndex = m_bindless.add(tex.view, tex.sampler);
+    }
+    if (m_mainContext.texture == handle) m_mainContext.textureIndex = getBindlessIndex(handle);  // Still bound
     
-    // Create staging buffer
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
+    // Descriptor sets naming the old view are rewritten as their frames
+    // come around (beginFrame / bindTexture); frames in flight keep it
+    for (UniformRing& ring : m_uniformRings) {
+        if (ring.boundTexture == handle) ring.boundTexture = INVALID_TEXTURE;
+    }
     
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = imageSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    UploadBatch::Ticket copyTicket = tex.uploadTicket;
+    m_deletions.push(m_frameNumber, [this, old, copyTicket]() mutable {
+        m_uploadBatch.wait(std::max(old.uploadTicket, copyTicket));
+        if (old.sampler) vkDestroySampler(m_device, old.sampler, nullptr);
+        if (old.view) vkDestroyImageView(m_device, old.view, nullptr);
+        m_allocator.destroyImage(old.image, old.alloc);
+    });
+}
+
+TextureHandle VulkanCore::loadTextureFile(const std::string& path) {
+    // Cooked textures (vulkan/tools/texture_cook) upload as stored
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower.size() >= 5 && lower.compare(lower.size() - 5, 5, ".ktx2") == 0) {
+        return loadTextureKTX2(path);
+    }
     
-    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS) {
+    // Load image using stb_image (from the archive mapping or the loose file)
+    VfsFile file;
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = nullptr;
+    if (Vfs::shared().open(path, file)) {
+        pixels = stbi_load_from_memory(file.bytes(), static_cast<int>(file.size()),
+                                       &width, &height, &channels, STBI_rgb_alpha);
+    }
+    if (!pixels) {
+        std::cerr << "[VulkanCore] Failed to load texture: " << path << std::endl;
         return INVALID_TEXTURE;
     }
     
-    VkMemoryRequirements memReqs;
-    vkGetBufferMemoryRequirements(m_device, stagingBuffer, &memReqs);
-    
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memReqs.memoryTypeBits, 
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    TextureHandle handle = createTexture(pixels, width, height, 4);
+    stbi_image_free(pixels);
     
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &stagingMemory) != VK_SUCCESS) {
-        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
+    if (handle != INVALID_TEXTURE) {
+        std::cout << "[VulkanCore] Loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
+    }
+    return handle;
+}
+
+TextureHandle VulkanCore::loadTextureKTX2(const std::string& path) {
+    // Basis payloads are transcoded to the best BC format this device samples
+    KTX2Data ktx = load_ktx2(path, m_physicalDevice);
+    if (ktx.format == VK_FORMAT_UNDEFINED) {
+        std::cerr << "[VulkanCore] Failed to load texture: " << path << " (" << ktx.error << ")" << std::endl;
+        return INVALID_TEXTURE;
+    }
+    if (ktx2_block_size(ktx.format) > 0 && !m_textureCompressionBC) {
+        std::cerr << "[VulkanCore] Failed to load texture: " << path << " (device has no BC texture support)" << std::endl;
         return INVALID_TEXTURE;
     }
     
-    vkBindBufferMemory(m_device, stagingBuffer, stagingMemory, 0);
-    
-    // Copy pixel data
-    void* data;
-    vkMapMemory(m_device, stagingMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, imageSize);
-    vkUnmapMemory(m_device, stagingMemory);
+    // Streamed: only the mips from streamingBaseSize down for now
+    uint32_t baseMip = 0;
+    if (m_streamer.isInitialized()) {
+        while (baseMip + 1 < ktx.mipmapCount &&
+               std::max(ktx.width >> baseMip, ktx.height >> baseMip) > m_config.streamingBaseSize) {
+            baseMip++;
+        }
+    }
     
-    // Create image
     TextureResource tex;
-    tex.width = width;
+    if (!createTextureLevels(tex, ktx.format, ktx.width, ktx.height, ktx.mipmapCount,
+                             ktx.data.data(), ktx.data.size(), ktx.mipOffsets, baseMip)) {
+        std::cerr << "[VulkanCore] Failed to load texture: " << path << " (upload failed)" << std::endl;
+        return INVALID_TEXTURE;
+    }
+    if (m_streamer.isInitialized() && ktx.mipmapCount > 1) {
+        tex.streamLevels = ktx.mipmapCount;
+        tex.streamWidth = ktx.width;
+        tex.streamHeight = ktx.height;
+        tex.streamStartBase = baseMip;
+        tex.residentBase = baseMip;
+        tex.wantedBase = baseMip;
+        tex.wantedFrame = m_frameNumber;
+        tex.streamFullBytes = ktx.data.size();
+    }
+    TextureHandle handle = registerTexture(tex);
+    if (handle != INVALID_TEXTURE) {
+        size_t rgbaBytes = 0;
+        for (uint32_t level = 0; level < ktx.mipmapCount; level++) {
+            rgbaBytes += size_t(std::max(ktx.width >> level, 1u)) * std::max(ktx.height >> level, 1u) * 4;
+        }
+        std::cout << "[VulkanCore] Loaded texture: " << path << " (" << ktx.width << "x" << ktx.height
+                  << ", " << ktx.mipmapCount << " mips, " << ktx.data.size() / 1024 << " KB, "
+                  << (ktx.transcoded ? "transcoded, " : "")
+                  << rgbaBytes / std::max<size_t>(ktx.data.size(), 1) << "x smaller than RGBA8"
+                  << (baseMip > 0 ? ", streamed from mip " + std::to_string(baseMip) : std::string()) << ")" << std::endl;
+    }
+    return handle;
+}
+
+bool VulkanCore::createTextureLevels(TextureResource& tex, VkFormat format, uint32_t width, uint32_t height,
+                                     uint32_t mipLevels, const uint8_t* data, size_t size,
+                                     const std::vector<uint32_t>& mipOffsets, uint32_t baseMip) {
+    mipLevels = std::max(mipLevels, 1u);
+    if (baseMip >= mipLevels || baseMip >= mipOffsets.size() || mipOffsets[baseMip] > size) return false;
+    
+    tex.width = std::max(width >> baseMip, 1u);
+    tex.height = std::max(height >> baseMip, 1u);
+    tex.mipLevels = mipLevels - baseMip;
+    if (!createTextureImage(tex, format, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                         VK_IMAGE_USAGE_SAMPLED_BIT)) {
+        return false;
+    }
+    
+    // Levels are packed in order, so [baseMip, end) is one contiguous tail
+    uint32_t first = mipOffsets[baseMip];
+    std::vector<VkBufferImageCopy> regions;
+    uint32_t levelWidth = tex.width, levelHeight = tex.height;
+    for (uint32_t level = baseMip; level < mipLevels && level < mipOffsets.size(); level++) {
+        VkBufferImageCopy region{};
+        region.bufferOffset = mipOffsets[level] - first;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level - baseMip;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {levelWidth, levelHeight, 1};
+        regions.push_back(region);
+        levelWidth = std::max(levelWidth / 2, 1u);
+        levelHeight = std::max(levelHeight / 2, 1u);
+    }
+    tex.uploadTicket = m_uploadBatch.uploadImageMips(tex.image, data + first, size - first, regions.data(),
+                                                     static_cast<uint32_t>(regions.size()), tex.mipLevels);
+    if (tex.uploadTicket == UploadBatch::NO_UPLOAD) {
+        vkDestroySampler(m_device, tex.sampler, nullptr);
+        vkDestroyImageView(m_device, tex.view, nullptr);
+        m_allocator.destroyImage(tex.image, tex.alloc);
+        return false;
+    }
+    return true;
+}
+
+TextureHandle VulkanCore::createTexture(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels,
+                                        bool generateMips) {
+    (void)channels; // Always convert to RGBA
+    return createTextureInternal(pixels, width, height, VK_FORMAT_R8G8B8A8_SRGB, generateMips);
+}
+
+TextureHandle VulkanCore::createTextureLinear(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels,
+                                              bool generateMips) {
+    (void)channels; // Always convert to RGBA
+    // LINEAR format (no SRGB) - critical for DMap textures!
+    return createTextureInternal(pixels, width, height, VK_FORMAT_R8G8B8A8_UNORM, generateMips);
+}
+
+TextureHandle VulkanCore::createTextureInternal(const uint8_t* pixels, uint32_t width, uint32_t height, VkFormat format,
+                                                bool generateMips) {
+    // Full chain via blits when the format allows it, else a single level
+    uint32_t mipLevels = 1;
+    if (generateMips) {
+        if (canBlitMips(m_physicalDevice, format)) {
+            mipLevels = mipLevelsFor(width, height);
+        } else {
+            std::cerr << "[VulkanCore] Format can't be blitted - texture created without mips" << std::endl;
+        }
+    }
+    
+    VkDeviceSize imageSize = width * height * 4;
+    
+    TextureResource tex;
+    tex.width = width;
+    tex.height = height;
+    tex.mipLevels = mipLevels;
+    // Transfer source for the mip blits and for memory budget demotion
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                              VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (!createTextureImage(tex, format, usage)) return INVALID_TEXTURE;
+    
+    // Staged into the batch ring; level 0 is copied and downsampled into
+    // the other levels, every level ending shader-readable. Inside
+    // beginUploadBatch()/endUploadBatch() this only records.
+    tex.uploadTicket = m_uploadBatch.uploadImage(tex.image, pixels, imageSize, width, height, mipLevels,
+                                                 mipLevels > 1);
+    TextureHandle handle = registerTexture(tex);
+    if (m_drawCapture && handle != INVALID_TEXTURE) {
+        CapturedTexture captured;
+        captured.format = format;
+        captured.width = width;
+        captured.height = height;
+        captured.mipLevels = mipLevels;
+        captured.generateMips = generateMips;
+        captured.data.assign(pixels, pixels + imageSize);
+        m_drawCapture->retainTexture(handle, std::move(captured));
+    }
+    return handle;
+}
+
+TextureHandle VulkanCore::createCompressedTexture(VkFormat format, uint32_t width, uint32_t height, uint32_t mipLevels,
+                                                  const void* data, size_t size,
+                                                  const VkBufferImageCopy* regions, uint32_t regionCount) {
+    TextureResource tex;
+    tex.width = width;
     tex.height = height;
+    tex.mipLevels = std::max(mipLevels, 1u);
+    if (!createTextureImage(tex, format, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                         VK_IMAGE_USAGE_SAMPLED_BIT)) {
+        return INVALID_TEXTURE;
+    }
     
+    // Every stored level copied as-is; nothing to blit
+    tex.uploadTicket = m_uploadBatch.uploadImageMips(tex.image, data, size, regions, regionCount, tex.mipLevels);
+    TextureHandle handle = registerTexture(tex);
+    if (m_drawCapture && handle != INVALID_TEXTURE) {
+        CapturedTexture captured;
+        captured.compressed = true;
+        captured.format = format;
+        captured.width = width;
+        captured.height = height;
+        captured.mipLevels = tex.mipLevels;
+        captured.data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        captured.regions.assign(regions, regions + regionCount);
+        m_drawCapture->retainTexture(handle, std::move(captured));
+    }
+    return handle;
+}
+
+bool VulkanCore::createTextureImage(TextureResource& tex, VkFormat format, VkImageUsageFlags usage) {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = width;
-    imageInfo.extent.height = height;
+    imageInfo.extent.width = tex.width;
+    imageInfo.extent.height = tex.height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = tex.mipLevels;
     imageInfo.arrayLayers = 1;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    imageInfo.format = format;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.usage = usage;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     
-    if (vkCreateImage(m_device, &imageInfo, nullptr, &tex.image) != VK_SUCCESS) {
-        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-        vkFreeMemory(m_device, stagingMemory, nullptr);
-        return INVALID_TEXTURE;
-    }
-    
-    vkGetImageMemoryRequirements(m_device, tex.image, &memReqs);
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &tex.memory) != VK_SUCCESS) {
-        vkDestroyImage(m_device, tex.image, nullptr);
-        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-        vkFreeMemory(m_device, stagingMemory, nullptr);
-        return INVALID_TEXTURE;
+    if (!m_allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, tex.image, tex.alloc)) {
+        return false;
     }
-    
-    vkBindImageMemory(m_device, tex.image, tex.memory, 0);
-    
-    // Transition and copy
-    VkCommandBuffer cmd = beginSingleTimeCommands();
-    
-    // Transition to transfer dst
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = tex.image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = 0;
-    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, &barrier);
-    
-    // Copy buffer to image
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
-    
-    vkCmdCopyBufferToImage(cmd, stagingBuffer, tex.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-    
-    // Transition to shader read
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, &barrier);
-    
-    endSingleTimeCommands(cmd);
-    
-    // Cleanup staging
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingMemory, nullptr);
+    tex.format = format;
     
     // Create image view
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = tex.image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = tex.mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
     
     if (vkCreateImageView(m_device, &viewInfo, nullptr, &tex.view) != VK_SUCCESS) {
-        vkDestroyImage(m_device, tex.image, nullptr);
-        vkFreeMemory(m_device, tex.memory, nullptr);
-        return INVALID_TEXTURE;
+        m_allocator.destroyImage(tex.image, tex.alloc);
+        return false;
     }
     
     // Create sampler
@@ -1199,373 +2792,1093 @@ TextureHandle VulkanCore::createTexture(const uint8_t* pixels, uint32_t width, u
     samplerInfo.unnormalizedCoordinates = VK_FALSE;
     samplerInfo.compareEnable = VK_FALSE;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(tex.mipLevels);
     
     if (vkCreateSampler(m_device, &samplerInfo, nullptr, &tex.sampler) != VK_SUCCESS) {
         vkDestroyImageView(m_device, tex.view, nullptr);
-        vkDestroyImage(m_device, tex.image, nullptr);
-        vkFreeMemory(m_device, tex.memory, nullptr);
+        m_allocator.destroyImage(tex.image, tex.alloc);
+        return false;
+    }
+    return true;
+}
+
+// Takes ownership of tex once its upload is queued; INVALID_TEXTURE (and
+// tex destroyed) if the upload failed or the pool is full
+TextureHandle VulkanCore::registerTexture(TextureResource& tex) {
+    if (tex.uploadTicket == UploadBatch::NO_UPLOAD) {
+        vkDestroySampler(m_device, tex.sampler, nullptr);
+        vkDestroyImageView(m_device, tex.view, nullptr);
+        m_allocator.destroyImage(tex.image, tex.alloc);
         return INVALID_TEXTURE;
     }
     
-    tex.valid = true;
+    tex.bindlessIndex = m_bindless.add(tex.view, tex.sampler);
+    tex.lastUsed.touch(m_frameNumber);  // Not an eviction candidate before it had a chance to be drawn
     
-    // Find free slot or add new
-    TextureHandle handle = INVALID_TEXTURE;
-    for (size_t i = 0; i < m_textures.size(); ++i) {
-        if (!m_textures[i].valid) {
-            m_textures[i] = tex;
-            handle = static_cast<TextureHandle>(i);
-            break;
+    // Reuses a destroyed texture's slot under a new generation
+    TextureHandle handle = m_textures.insert(tex);
+    if (handle == INVALID_TEXTURE) {
+        m_bindless.remove(tex.bindlessIndex);
+        m_uploadBatch.wait(tex.uploadTicket);
+        vkDestroySampler(m_device, tex.sampler, nullptr);
+        vkDestroyImageView(m_device, tex.view, nullptr);
+        m_allocator.destroyImage(tex.image, tex.alloc);
+    }
+    return handle;
+}
+
+void VulkanCore::bindTexture(TextureHandle handle) {
+    TextureHandle texToUse = m_defaultTexture;
+    if (m_textures.contains(handle)) {
+        texToUse = handle;
+    }
+    touchTexture(texToUse);
+    
+    // Bindless pipelines only need the slot - per recording context, so
+    // recordParallel tasks can switch textures too
+    recordContext().textureIndex = getBindlessIndex(texToUse);
+    recordContext().texture = texToUse;
+    
+    // Rewrites the frame's descriptor set - not safe while tasks record
+    if (isRecordingTask()) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            std::cerr << "[VulkanCore] bindTexture() inside a recordParallel task only affects bindless pipelines" << std::endl;
         }
+        return;
     }
-    if (handle == INVALID_TEXTURE) {
-        handle = static_cast<TextureHandle>(m_textures.size());
-        m_textures.push_back(tex);
+    
+    m_currentTexture = texToUse;
+    if (m_uniformRings.empty()) return;
+    
+    // Only the current frame's set is touched; the others may still be in
+    // flight and pick the texture up in beginFrame()
+    if (m_uniformRings[m_currentFrame].boundTexture == texToUse) return;  // Already bound
+    writeRingTexture(m_currentFrame, texToUse);
+}
+
+void VulkanCore::destroyTexture(TextureHandle handle) {
+    if (handle == m_defaultTexture) return;
+    
+    // Shared through the loadTexture() cache: only the last reference destroys
+    auto path = m_textureCachePaths.find(handle);
+    if (path != m_textureCachePaths.end()) {
+        auto cached = m_textureCache.find(path->second);
+        if (cached != m_textureCache.end() && --cached->second.refs > 0) return;
+        if (cached != m_textureCache.end()) m_textureCache.erase(cached);
+        m_textureCachePaths.erase(path);
+    }
+    
+    TextureResource tex;
+    if (!m_textures.remove(handle, &tex)) return;
+    if (m_drawCapture) m_drawCapture->releaseTexture(handle);
+    if (tex.bindlessIndex != BindlessHeap::INVALID_INDEX) {
+        m_bindless.remove(tex.bindlessIndex);  // Repointed at the default texture once recycled
+    }
+    
+    // Frames still in flight keep their descriptor sets; later frames fall back
+    if (m_currentTexture == handle) m_currentTexture = m_defaultTexture;
+    
+    m_deletions.push(m_frameNumber, [this, tex]() mutable {
+        m_uploadBatch.wait(tex.uploadTicket);  // Only blocks if its batch was never submitted
+        if (tex.sampler) vkDestroySampler(m_device, tex.sampler, nullptr);
+        if (tex.view) vkDestroyImageView(m_device, tex.view, nullptr);
+        m_allocator.destroyImage(tex.image, tex.alloc);
+    });
+}
+
+// ============================================================================
+// Mesh Management
+// ============================================================================
+
+// Floats per vertex, or 0 if vertexCount doesn't describe the buffer
+static uint32_t meshStrideFloats(const MeshData& data) {
+    if (isPackedVertexFormat(data.format)) return 0;  // Positions aren't floats
+    if (data.vertexCount == 0 || data.vertices.size() % data.vertexCount != 0) return 0;
+    uint32_t stride = static_cast<uint32_t>(data.vertices.size() / data.vertexCount);
+    return stride >= 3 ? stride : 0;
+}
+
+void generateMeshLods(MeshData& data, uint32_t maxLods) {
+    uint32_t stride = meshStrideFloats(data);
+    if (stride == 0 || data.indices.empty()) return;
+    
+    // Rebuild from LOD 0 if levels were already generated
+    std::vector<uint32_t> lod0 = data.indices;
+    if (!data.lods.empty()) {
+        lod0.assign(data.indices.begin() + data.lods[0].firstIndex,
+                    data.indices.begin() + data.lods[0].firstIndex + data.lods[0].indexCount);
+    }
+    data.indices = buildLodChain(data.vertices.data(), stride, data.vertexCount, lod0, data.lods, maxLods);
+    data.indexCount = static_cast<uint32_t>(data.indices.size());
+}
+
+bool packMeshVertices(MeshData& data) {
+    uint32_t stride = meshStrideFloats(data);
+    bool uv1 = data.format == VertexFormat::POSITION_NORMAL_UV0_UV1;
+    if (!uv1 && data.format != VertexFormat::POSITION_NORMAL_UV) return false;
+    if (stride < (uv1 ? 10u : 8u)) return false;
+    
+    VertexQuantization q = computeVertexQuantization(data.vertices.data(), stride, data.vertexCount);
+    size_t packedSize = uv1 ? sizeof(PackedVertexUV1) : sizeof(PackedVertex);
+    std::vector<float> packed(size_t(data.vertexCount) * packedSize / sizeof(float));
+    if (uv1) {
+        packVertices(data.vertices.data(), stride, data.vertexCount, q, reinterpret_cast<PackedVertexUV1*>(packed.data()));
+    } else {
+        packVertices(data.vertices.data(), stride, data.vertexCount, q, reinterpret_cast<PackedVertex*>(packed.data()));
+    }
+    data.vertices.swap(packed);
+    data.format = packedVertexFormat(data.format);
+    data.quantization = q;
+    return true;
+}
+
+// Bounding sphere of packed positions, decoded: the first 8 bytes of
+// every vertex in either packed format
+static LodBounds packedMeshBounds(const MeshData& data) {
+    size_t stride = data.format == VertexFormat::PACKED_POSITION_NORMAL_UV0_UV1 ? sizeof(PackedVertexUV1)
+                                                                                 : sizeof(PackedVertex);
+    if (data.vertexCount == 0 || data.vertices.size() * sizeof(float) < data.vertexCount * stride) return LodBounds();
+    std::vector<float> positions(size_t(data.vertexCount) * 3);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.vertices.data());
+    for (uint32_t i = 0; i < data.vertexCount; i++) {
+        uint16_t position[4];
+        memcpy(position, bytes + i * stride, sizeof(position));
+        glm::vec3 p = data.quantization.decode(position);
+        positions[i * 3 + 0] = p.x;
+        positions[i * 3 + 1] = p.y;
+        positions[i * 3 + 2] = p.z;
+    }
+    return computeLodBounds(positions.data(), 3, data.vertexCount);
+}
+
+MeshHandle VulkanCore::createMesh(const MeshData& data) {
+    BufferHandle vb = createVertexBuffer(data.vertices.data(), data.vertices.size() * sizeof(float));
+    BufferHandle ib = createIndexBuffer(data.indices.data(), data.indices.size());
+    
+    if (vb == INVALID_BUFFER || ib == INVALID_BUFFER) {
+        if (vb != INVALID_BUFFER) destroyBuffer(vb);
+        if (ib != INVALID_BUFFER) destroyBuffer(ib);
+        return INVALID_MESH;
+    }
+    
+    MeshResource mesh;
+    mesh.vertexBuffer = vb;
+    mesh.indexBuffer = ib;
+    mesh.lods = data.lods;
+    if (mesh.lods.empty()) mesh.lods.push_back({0, static_cast<uint32_t>(data.indices.size()), 0.0f});
+    mesh.lods.resize(std::min<size_t>(mesh.lods.size(), MAX_MESH_LODS));
+    mesh.indexCount = mesh.lods[0].indexCount;
+    if (isPackedVertexFormat(data.format)) {
+        mesh.bounds = packedMeshBounds(data);
+        mesh.quantized = true;
+        mesh.dequantize = data.quantization.matrix();
+        if (mesh.bounds.radius <= 0.0f) mesh.lods.resize(1);
+    } else if (uint32_t stride = meshStrideFloats(data)) {
+        mesh.bounds = computeLodBounds(data.vertices.data(), stride, data.vertexCount);
+    } else {
+        mesh.lods.resize(1);  // No bounds to select with
     }
     
+    mesh.lastUsed.touch(m_frameNumber);
+    MeshHandle handle = m_meshes.insert(std::move(mesh));
+    if (handle == INVALID_MESH) {
+        destroyBuffer(vb);
+        destroyBuffer(ib);
+    } else if (m_drawCapture) {
+        m_drawCapture->retainMesh(handle, data);
+    }
     return handle;
 }
 
-TextureHandle VulkanCore::createTextureLinear(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels) {
-    (void)channels; // Always convert to RGBA
+MeshHandle VulkanCore::createCube(float size, const glm::vec3& color) {
+    // Scale and colorize cube vertices
+    std::vector<float> vertices;
+    for (int i = 0; i < 24; i++) {
+        vertices.push_back(CUBE_VERTICES[i * 6 + 0] * size);  // x
+        vertices.push_back(CUBE_VERTICES[i * 6 + 1] * size);  // y
+        vertices.push_back(CUBE_VERTICES[i * 6 + 2] * size);  // z
+        vertices.push_back(CUBE_VERTICES[i * 6 + 3] * color.r); // r
+        vertices.push_back(CUBE_VERTICES[i * 6 + 4] * color.g); // g
+        vertices.push_back(CUBE_VERTICES[i * 6 + 5] * color.b); // b
+    }
     
-    VkDeviceSize imageSize = width * height * 4;
+    MeshData data;
+    data.vertices = vertices;
+    data.indices = std::vector<uint32_t>(CUBE_INDICES, CUBE_INDICES + 36);
+    data.format = VertexFormat::POSITION_COLOR;
+    data.vertexCount = 24;
+    data.indexCount = 36;
     
-    // Create staging buffer
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
+    return createMesh(data);
+}
+
+void VulkanCore::destroyMesh(MeshHandle handle) {
+    MeshResource mesh;
+    if (!m_meshes.remove(handle, &mesh)) return;
+    if (m_drawCapture) m_drawCapture->releaseMesh(handle);
+    if (mesh.viewOf != INVALID_MESH) return;  // Buffers belong to the source and the caller
+    destroyBuffer(mesh.vertexBuffer);  // Deferred until in-flight frames retire
+    destroyBuffer(mesh.indexBuffer);
+}
+
+MeshHandle VulkanCore::createMeshView(MeshHandle source, BufferHandle vertexBuffer) {
+    const MeshResource* src = m_meshes.get(source);
+    if (!src || !m_buffers.contains(vertexBuffer)) {
+        std::cerr << "[VulkanCore] createMeshView: invalid source mesh or vertex buffer" << std::endl;
+        return INVALID_MESH;
+    }
+    if (src->viewOf != INVALID_MESH) source = src->viewOf;  // Views of views share the root
+    
+    MeshResource view;
+    view.vertexBuffer = vertexBuffer;
+    view.indexBuffer = src->indexBuffer;
+    view.indexCount = src->indexCount;
+    view.lods = src->lods;
+    view.bounds = src->bounds;
+    view.quantized = src->quantized;
+    view.dequantize = src->dequantize;
+    view.viewOf = source;
+    view.lastUsed.touch(m_frameNumber);
+    MeshHandle handle = m_meshes.insert(std::move(view));
+    if (m_drawCapture && handle != INVALID_MESH) m_drawCapture->retainMeshView(handle, source);
+    return handle;
+}
+
+void VulkanCore::setMeshBounds(MeshHandle mesh, const glm::vec3& center, float radius) {
+    MeshResource* res = m_meshes.get(mesh);
+    if (!res) return;
+    res->bounds.center = center;
+    res->bounds.radius = radius;
+}
+
+uint32_t VulkanCore::getMeshLodCount(MeshHandle handle) const {
+    const MeshResource* mesh = m_meshes.get(handle);
+    return mesh ? static_cast<uint32_t>(mesh->lods.size()) : 0;
+}
+
+bool VulkanCore::isMeshReady(MeshHandle handle) const {
+    if (!m_meshes.contains(handle)) return false;
+    return isBufferReady(m_meshes[handle].vertexBuffer) && isBufferReady(m_meshes[handle].indexBuffer);
+}
+
+void VulkanCore::waitForUploads() {
+    m_uploads.flush();
+    m_uploads.waitIdle();
+    m_uploadBatch.waitIdle();
+}
+
+void VulkanCore::beginUploadBatch() {
+    m_uploadBatch.begin();
+}
+
+UploadBatch::Ticket VulkanCore::endUploadBatch() {
+    return m_uploadBatch.end();
+}
+
+bool VulkanCore::getMeshBuffers(MeshHandle mesh, VkBuffer& vertexBuffer, VkBuffer& indexBuffer, uint32_t& indexCount) const {
+    // Not-yet-uploaded meshes report no buffers, so external renderers skip them too
+    if (!isMeshReady(mesh)) return false;
     
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = imageSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    const auto& meshRes = m_meshes[mesh];
+    meshRes.lastUsed.touch(m_frameNumber);
     
-    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS) {
-        return INVALID_TEXTURE;
+    vertexBuffer = m_buffers[meshRes.vertexBuffer].buffer;
+    indexBuffer = m_buffers[meshRes.indexBuffer].buffer;
+    indexCount = meshRes.indexCount;
+    return true;
+}
+
+bool VulkanCore::getMeshLod(MeshHandle mesh, const glm::mat4& model, uint32_t& firstIndex, uint32_t& indexCount) {
+    return getMeshLod(mesh, &model, 1, firstIndex, indexCount);
+}
+
+bool VulkanCore::getMeshLod(MeshHandle mesh, const glm::mat4* models, uint32_t count,
+                            uint32_t& firstIndex, uint32_t& indexCount) {
+    if (!models || count == 0 || !isMeshReady(mesh)) return false;
+    const MeshLod& lod = selectMeshLod(mesh, models, count);
+    firstIndex = lod.firstIndex;
+    indexCount = lod.indexCount;
+    return true;
+}
+
+bool VulkanCore::getMeshBounds(MeshHandle mesh, glm::vec3& center, float& radius) const {
+    const MeshResource* res = m_meshes.get(mesh);
+    if (!res) return false;
+    center = res->bounds.center;
+    radius = res->bounds.radius;
+    return true;
+}
+
+bool VulkanCore::isMeshInFrustum(MeshHandle mesh, const glm::mat4& transform) const {
+    const MeshResource* res = m_meshes.get(mesh);
+    if (!res) return false;
+    return m_frustum.intersectsSphere(res->bounds.center, res->bounds.radius, transform);
+}
+
+// Counts the draw as visible or culled; true if it should be skipped
+bool VulkanCore::cullDraw(MeshHandle mesh, const glm::mat4& transform) {
+    if (m_config.frustumCulling && !isMeshInFrustum(mesh, transform)) {
+        m_statObjectsCulled.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    m_statObjectsVisible.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Finest level any of the transforms needs; records the draw in the stats
+const MeshLod& VulkanCore::selectMeshLod(MeshHandle mesh, const glm::mat4* transforms, uint32_t count) {
+    MeshResource& res = m_meshes[mesh];
+    res.lastUsed.touch(m_frameNumber);
+    uint32_t lod = 0;
+    if (res.lods.size() > 1) {
+        // The reference level only changes between frames, so every draw
+        // of a frame - and the same draw in DepthOnly and Shading - agrees.
+        // Tasks only read the state; the main thread owns it.
+        bool firstDraw = res.lodFrame != m_frameNumber;
+        if (firstDraw && !m_parallelActive) res.currentLod = res.pendingLod;
+        float projectionScale = lodProjectionScale(m_projMatrix, static_cast<float>(m_swapchainExtent.height));
+        lod = static_cast<uint32_t>(res.lods.size()) - 1;
+        for (uint32_t i = 0; i < count && lod > 0; i++) {
+            lod = std::min(lod, selectLod(res.lods.data(), static_cast<uint32_t>(res.lods.size()), res.bounds,
+                                          transforms[i], m_viewMatrix, projectionScale,
+                                          m_config.lodPixelError, m_config.lodHysteresis, res.currentLod));
+        }
+        if (!m_parallelActive) {
+            res.pendingLod = firstDraw ? lod : std::min(res.pendingLod, lod);  // Finest this frame
+            res.lodFrame = m_frameNumber;
+        }
     }
     
-    VkMemoryRequirements memReqs;
-    vkGetBufferMemoryRequirements(m_device, stagingBuffer, &memReqs);
+    m_statDrawCalls.fetch_add(1, std::memory_order_relaxed);
+    m_statTriangles.fetch_add(uint64_t(res.lods[lod].indexCount / 3) * count, std::memory_order_relaxed);
+    m_statTrianglesFull.fetch_add(uint64_t(res.lods[0].indexCount / 3) * count, std::memory_order_relaxed);
+    return res.lods[lod];
+}
+
+bool VulkanCore::getTextureInfo(TextureHandle tex, VkImageView& view, VkSampler& sampler) const {
+    if (!m_textures.contains(tex)) return false;
+    
+    // The caller may keep the view in descriptor sets of its own, so it
+    // must outlive eviction
+    m_textures[tex].pinned = true;
+    view = m_textures[tex].view;
+    sampler = m_textures[tex].sampler;
+    return true;
+}
+
+uint32_t VulkanCore::getBindlessIndex(TextureHandle tex) const {
+    if (!m_textures.contains(tex)) tex = m_defaultTexture;
+    if (!m_textures.contains(tex)) return BindlessHeap::INVALID_INDEX;
+    m_textures[tex].lastUsed.touch(m_frameNumber);
+    return m_textures[tex].bindlessIndex;
+}
+
+void VulkanCore::bindBindlessHeap(VkPipelineLayout layout, uint32_t setIndex) {
+    if (!m_frameStarted) return;
+    m_bindless.bind(recordContext().cmd, layout, setIndex);
+}
+
+// ============================================================================
+// Memory Budget
+// ============================================================================
+
+// Demoted textures keep their mips from the first one no larger than this
+static constexpr uint32_t DEMOTED_TEXTURE_SIZE = 64;
+static constexpr uint32_t MAX_EVICTIONS_PER_FRAME = 16;
+static constexpr uint32_t MAX_RESTORES_PER_FRAME = 2;  // Restores re-read files: keep hitches small
+
+void VulkanCore::touchTexture(TextureHandle handle) {
+    if (const TextureResource* tex = m_textures.get(handle)) tex->lastUsed.touch(m_frameNumber);
+}
+
+void VulkanCore::enforceMemoryBudget() {
+    m_memoryBudget.update(m_allocator);
+    
+    MemoryStats& stats = m_memoryStats;
+    stats.budget = m_memoryBudget.getDeviceBudget();
+    stats.usage = m_memoryBudget.getDeviceUsage();
+    stats.target = static_cast<VkDeviceSize>(static_cast<double>(stats.budget) * m_config.memoryBudgetFraction);
+    stats.budgetExtension = m_memoryBudget.hasExtension();
+    stats.evictions = 0;
+    stats.restores = 0;
+    
+    // Resident bytes per resource, and who could go or come back
+    struct Candidate {
+        uint64_t lastUsed;
+        uint32_t handle;
+        bool texture;
+        VkDeviceSize bytes;
+    };
+    std::vector<Candidate> idle, wanted;
+    bool evicting = m_config.memoryBudgetFraction > 0.0f && stats.usage > stats.target &&
+                    m_frameNumber >= m_evictionCooldownUntil;
+    uint64_t idleBefore = m_frameNumber > m_config.evictionIdleFrames ? m_frameNumber - m_config.evictionIdleFrames : 0;
+    
+    stats.textureBytes = 0;
+    stats.texturesDemoted = 0;
+    m_textures.forEach([&](TextureHandle handle, TextureResource& tex) {
+        stats.textureBytes += tex.alloc.size;
+        uint64_t lastUsed = tex.lastUsed.get();
+        if (tex.demotedFrame != 0) {
+            stats.texturesDemoted++;
+            if (lastUsed >= tex.demotedFrame && tex.fullBytes > 0) {
+                wanted.push_back({lastUsed, handle, true, tex.fullBytes});
+            }
+        } else if (evicting && lastUsed < idleBefore && !tex.pinned && tex.mipLevels > 1 && tex.streamLevels == 0 &&
+                   handle != m_defaultTexture && m_uploadBatch.isComplete(tex.uploadTicket) &&
+                   m_textureCachePaths.count(handle) > 0) {
+            idle.push_back({lastUsed, handle, true, tex.alloc.size});
+        }
+    });
+    
+    stats.meshBytes = 0;
+    stats.meshesEvicted = 0;
+    m_meshes.forEach([&](MeshHandle, MeshResource& mesh) {
+        if (mesh.viewOf == INVALID_MESH) return;
+        if (MeshResource* source = m_meshes.get(mesh.viewOf)) {
+            uint64_t used = mesh.lastUsed.get();
+            if (used > source->lastUsed.get()) source->lastUsed.touch(used);
+        }
+    });
+    m_meshes.forEach([&](MeshHandle handle, MeshResource& mesh) {
+        if (mesh.viewOf != INVALID_MESH) return;  // Counted with, and moved by, the source
+        VkDeviceSize bytes = m_buffers[mesh.vertexBuffer].alloc.size + m_buffers[mesh.indexBuffer].alloc.size;
+        uint64_t lastUsed = mesh.lastUsed.get();
+        if (mesh.evictedFrame != 0) {
+            stats.meshesEvicted++;
+            if (lastUsed >= mesh.evictedFrame) wanted.push_back({lastUsed, handle, false, bytes});
+            return;
+        }
+        stats.meshBytes += bytes;
+        if (evicting && m_hostMeshMemory && lastUsed < idleBefore && isMeshReady(handle)) {
+            idle.push_back({lastUsed, handle, false, bytes});
+        }
+    });
+    
+    if (m_config.memoryBudgetFraction <= 0.0f) return;
     
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memReqs.memoryTypeBits, 
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (stats.usage > stats.target) {
+        if (!evicting) return;  // The last round's frees haven't landed yet
+        
+        // The application gets the first go at freeing memory
+        VkDeviceSize excess = stats.usage - stats.target;
+        if (m_memoryPressureCallback) m_memoryPressureCallback(excess);
+        
+        std::sort(idle.begin(), idle.end(), [](const Candidate& a, const Candidate& b) {
+            return a.lastUsed < b.lastUsed;
+        });
+        
+        // One submission for every copy of the round
+        VkDeviceSize freed = 0;
+        m_uploadBatch.begin();
+        for (const Candidate& candidate : idle) {
+            if (freed >= excess || stats.evictions >= MAX_EVICTIONS_PER_FRAME) break;
+            bool evicted = candidate.texture ? demoteTexture(candidate.handle)
+                                             : moveMeshBuffers(candidate.handle, true);
+            if (evicted) {
+                freed += candidate.bytes;
+                stats.evictions++;
+            }
+        }
+        m_uploadBatch.end();
+        
+        if (stats.evictions > 0) {
+            std::cout << "[VulkanCore] Memory budget: " << (stats.usage / (1024 * 1024)) << " / "
+                      << (stats.budget / (1024 * 1024)) << " MB, evicted " << stats.evictions
+                      << " resources (" << (freed / (1024 * 1024)) << " MB)" << std::endl;
+        }
+        // Frees are deferred until the frames in flight retire; don't evict
+        // again on numbers that can't have moved yet
+        m_evictionCooldownUntil = m_frameNumber + m_framesInFlight + 1;
+        stats.totalEvictions += stats.evictions;
+        return;
+    }
     
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &stagingMemory) != VK_SUCCESS) {
-        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-        return INVALID_TEXTURE;
+    // Under the target: bring back what was drawn since it was evicted,
+    // most recently used first, as long as it fits
+    if (wanted.empty()) return;
+    std::sort(wanted.begin(), wanted.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUsed > b.lastUsed;
+    });
+    VkDeviceSize headroom = stats.target - stats.usage;
+    m_uploadBatch.begin();
+    for (const Candidate& candidate : wanted) {
+        if (stats.restores >= MAX_RESTORES_PER_FRAME) break;
+        if (candidate.bytes > headroom) continue;
+        bool restored = false;
+        if (candidate.texture) {
+            restored = restoreTexture(candidate.handle);  // Full image: demotedFrame back to 0
+            if (!restored) {
+                m_textures[candidate.handle].fullBytes = 0;  // Stays low-resolution; don't retry every frame
+            }
+        } else {
+            restored = moveMeshBuffers(candidate.handle, false);
+        }
+        if (restored) {
+            headroom -= candidate.bytes;
+            stats.restores++;
+        }
+    }
+    m_uploadBatch.end();
+    stats.totalRestores += stats.restores;
+}
+
+// Replaces the texture with a copy of its mips from DEMOTED_TEXTURE_SIZE
+// down; the copy is recorded into the open upload batch
+bool VulkanCore::demoteTexture(TextureHandle handle) {
+    TextureResource& tex = m_textures[handle];
+    uint32_t baseMip = 0;
+    while (baseMip + 1 < tex.mipLevels &&
+           std::max(tex.width >> baseMip, tex.height >> baseMip) > DEMOTED_TEXTURE_SIZE) {
+        baseMip++;
     }
+    if (baseMip == 0) return false;
     
-    vkBindBufferMemory(m_device, stagingBuffer, stagingMemory, 0);
+    TextureResource low;
+    if (!copyTextureMips(tex, baseMip, low)) return false;
+    low.demotedFrame = m_frameNumber;
+    low.fullBytes = tex.alloc.size;
+    replaceTexture(handle, low);
+    return true;
+}
+
+// New image holding tex's levels from srcBaseMip down, copied on the GPU
+bool VulkanCore::copyTextureMips(const TextureResource& tex, uint32_t srcBaseMip, TextureResource& low) {
+    if (srcBaseMip == 0 || srcBaseMip >= tex.mipLevels) return false;
+    low.width = std::max(tex.width >> srcBaseMip, 1u);
+    low.height = std::max(tex.height >> srcBaseMip, 1u);
+    low.mipLevels = tex.mipLevels - srcBaseMip;
+    if (!createTextureImage(low, tex.format, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                             VK_IMAGE_USAGE_SAMPLED_BIT)) {
+        return false;
+    }
+    low.uploadTicket = m_uploadBatch.copyImageMips(tex.image, low.image, srcBaseMip, low.mipLevels,
+                                                   low.width, low.height);
+    if (low.uploadTicket == UploadBatch::NO_UPLOAD) {
+        vkDestroySampler(m_device, low.sampler, nullptr);
+        vkDestroyImageView(m_device, low.view, nullptr);
+        m_allocator.destroyImage(low.image, low.alloc);
+        return false;
+    }
+    return true;
+}
+
+// Moves a mesh's vertex and index buffers between device-local and host
+// memory under the same buffer handles. Draws keep working either way: the
+// copy is recorded into the open upload batch, which reaches the graphics
+// queue before this frame does.
+bool VulkanCore::moveMeshBuffers(MeshHandle handle, bool toHost) {
+    MeshResource& mesh = m_meshes[handle];
+    BufferHandle handles[2] = {mesh.vertexBuffer, mesh.indexBuffer};
+    BufferResource moved[2];
+    
+    for (uint32_t i = 0; i < 2; i++) {
+        const BufferResource& buf = m_buffers[handles[i]];
+        moved[i].size = buf.size;
+        moved[i].usage = buf.usage;
+        bool created;
+        if (toHost) {
+            created = m_allocator.createBuffer(buf.size, buf.usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, moved[i].buffer, moved[i].alloc,
+                                               GpuAllocKind::BUFFER, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            if (created && (m_allocator.getMemoryTypeFlags(moved[i].alloc.memoryType) &
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+                // All host-visible memory is device memory here (UMA): moving saves nothing
+                std::cout << "[VulkanCore] Memory budget: no host-only memory, meshes stay resident" << std::endl;
+                m_allocator.destroyBuffer(moved[i].buffer, moved[i].alloc);
+                m_hostMeshMemory = false;
+                created = false;
+            }
+        } else {
+            created = createDeviceBuffer(buf.size, buf.usage, moved[i].buffer, moved[i].alloc);
+        }
+        if (!created) {
+            if (i == 1) m_allocator.destroyBuffer(moved[0].buffer, moved[0].alloc);
+            return false;
+        }
+    }
     
-    // Copy pixel data
-    void* data;
-    vkMapMemory(m_device, stagingMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, imageSize);
-    vkUnmapMemory(m_device, stagingMemory);
+    UploadBatch::Ticket ticket = UploadBatch::NO_UPLOAD;
+    for (uint32_t i = 0; i < 2; i++) {
+        ticket = m_uploadBatch.copyBuffer(m_buffers[handles[i]].buffer, moved[i].buffer, moved[i].size);
+    }
+    if (ticket == UploadBatch::NO_UPLOAD) {
+        for (BufferResource& buf : moved) m_allocator.destroyBuffer(buf.buffer, buf.alloc);
+        return false;
+    }
     
-    // Create image
-    TextureResource tex;
-    tex.width = width;
-    tex.height = height;
+    for (uint32_t i = 0; i < 2; i++) {
+        BufferResource old = m_buffers[handles[i]];
+        m_buffers[handles[i]] = moved[i];
+        m_deletions.push(m_frameNumber, [this, old, ticket]() mutable {
+            m_uploads.wait(old.uploadTicket);
+            m_uploadBatch.wait(ticket);  // Still the copy's source until then
+            m_allocator.destroyBuffer(old.buffer, old.alloc);
+        });
+    }
+    mesh.evictedFrame = toHost ? m_frameNumber : 0;
+    return true;
+}
+
+// ============================================================================
+// Texture Streaming
+// ============================================================================
+
+static constexpr uint32_t STREAM_OUT_FRAMES = 300;       // Unrequested mips are kept this long
+static constexpr uint32_t FEEDBACK_GRACE_FRAMES = 30;    // Before "no shader reports" is believed
+static constexpr uint32_t MAX_STREAM_OUTS_PER_FRAME = 8;
+
+void VulkanCore::updateTextureStreaming() {
+    if (!m_streamer.isInitialized()) return;
+    
+    StreamingStats& stats = m_streamingStats;
+    stats.streamedTextures = 0;
+    stats.fullyResident = 0;
+    stats.residentBytes = 0;
+    stats.fullBytes = 0;
+    stats.pending = 0;
+    stats.inFlight = 0;
+    stats.streamedIn = 0;
+    stats.streamedOut = 0;
+    stats.bytesStreamed = 0;
+    
+    // Densities sampled in the frame this slot carried last time
+    const uint32_t* density = m_streamer.readFeedback(m_currentFrame);
+    if (density) {
+        for (uint32_t i = 0; i < m_bindless.getCapacity(); i++) {
+            if (density[i] != 0) {
+                m_lastFeedbackFrame = m_frameNumber;
+                break;
+            }
+        }
+    }
+    stats.feedback = m_lastFeedbackFrame > 0 && m_frameNumber - m_lastFeedbackFrame <= STREAM_OUT_FRAMES;
+    bool noFeedback = !stats.feedback && m_frameNumber > FEEDBACK_GRACE_FRAMES;
+    bool pressure = m_config.memoryBudgetFraction > 0.0f && m_memoryStats.usage > m_memoryStats.target;
+    uint64_t idleBefore = m_frameNumber > m_config.evictionIdleFrames ? m_frameNumber - m_config.evictionIdleFrames : 0;
+    
+    struct Request {
+        TextureHandle handle;
+        uint32_t missing;   // Levels short of what was asked for
+        uint64_t lastUsed;
+    };
+    std::vector<Request> streamIn;
+    std::vector<TextureHandle> streamOut;
+    m_textures.forEach([&](TextureHandle handle, TextureResource& tex) {
+        if (tex.streamLevels == 0) return;
+        stats.streamedTextures++;
+        stats.residentBytes += tex.alloc.size;
+        stats.fullBytes += tex.streamFullBytes;
+        if (tex.residentBase == 0) stats.fullyResident++;
+        if (tex.pinned) return;  // Someone holds its view
+        
+        // The finest level asked for is held for STREAM_OUT_FRAMES, so a
+        // texture doesn't thrash as the camera moves back and forth
+        bool asked = false;
+        uint32_t want = tex.streamStartBase;
+        if (density && tex.bindlessIndex != BindlessHeap::INVALID_INDEX && density[tex.bindlessIndex] != 0) {
+            want = std::min(TextureStreamer::desiredBaseMip(density[tex.bindlessIndex], tex.streamWidth,
+                                                            tex.streamHeight, tex.streamLevels),
+                            tex.streamStartBase);
+            asked = true;
+        } else if (noFeedback && tex.lastUsed.get() >= idleBefore) {
+            want = 0;  // Drawn by shaders that don't report: assume it is seen up close
+            asked = true;
+        }
+        bool expired = m_frameNumber - tex.wantedFrame > STREAM_OUT_FRAMES ||
+                       (pressure && m_frameNumber - tex.wantedFrame > m_config.evictionIdleFrames);
+        if (asked && want <= tex.wantedBase) {
+            tex.wantedBase = want;
+            tex.wantedFrame = m_frameNumber;
+        } else if (expired) {
+            tex.wantedBase = want;
+            tex.wantedFrame = m_frameNumber;
+        }
+        
+        if (!m_uploadBatch.isComplete(tex.uploadTicket)) {
+            stats.inFlight++;
+        } else if (tex.wantedBase < tex.residentBase) {
+            stats.pending++;
+            if (!pressure) streamIn.push_back({handle, tex.residentBase - tex.wantedBase, tex.lastUsed.get()});
+        } else if (tex.wantedBase > tex.residentBase) {
+            streamOut.push_back(handle);
+        }
+    });
+    if (streamIn.empty() && streamOut.empty()) return;
+    
+    // Furthest behind first, then most recently drawn
+    std::sort(streamIn.begin(), streamIn.end(), [](const Request& a, const Request& b) {
+        return a.missing != b.missing ? a.missing > b.missing : a.lastUsed > b.lastUsed;
+    });
+    VkDeviceSize headroom = UINT64_MAX;
+    if (m_config.memoryBudgetFraction > 0.0f) {
+        headroom = m_memoryStats.target > m_memoryStats.usage ? m_memoryStats.target - m_memoryStats.usage : 0;
+    }
     
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;  // LINEAR format (no SRGB) - critical for DMap textures!
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    // One submission for the round
+    m_uploadBatch.begin();
+    for (const Request& request : streamIn) {
+        TextureResource& tex = m_textures[request.handle];
+        auto tailBytes = [&](uint32_t from) {
+            VkDeviceSize bytes = 0;
+            for (uint32_t level = from; level < tex.streamLevels; level++) {
+                bytes += ktx2_level_size(tex.format, std::max(tex.streamWidth >> level, 1u),
+                                         std::max(tex.streamHeight >> level, 1u));
+            }
+            return bytes;
+        };
+        
+        // At least one level finer; more while this frame's upload cap allows
+        uint32_t base = tex.residentBase - 1;
+        while (base > tex.wantedBase && stats.bytesStreamed + tailBytes(base - 1) <= m_config.streamingBytesPerFrame) {
+            base--;
+        }
+        VkDeviceSize bytes = tailBytes(base);
+        if (stats.bytesStreamed > 0 && stats.bytesStreamed + bytes > m_config.streamingBytesPerFrame) break;
+        VkDeviceSize growth = bytes > tex.alloc.size ? bytes - tex.alloc.size : 0;
+        if (growth > headroom) continue;
+        if (streamTextureIn(request.handle, base)) {
+            stats.streamedIn++;
+            stats.bytesStreamed += bytes;
+            headroom -= growth;
+        }
+    }
+    for (TextureHandle handle : streamOut) {
+        if (stats.streamedOut >= MAX_STREAM_OUTS_PER_FRAME) break;
+        if (streamTextureOut(handle, m_textures[handle].wantedBase)) stats.streamedOut++;
+    }
+    m_uploadBatch.end();
+    
+    stats.totalStreamedIn += stats.streamedIn;
+    stats.totalStreamedOut += stats.streamedOut;
+    stats.totalBytesStreamed += stats.bytesStreamed;
+}
+
+// Re-reads the file and uploads its levels from baseMip down into a new
+// image under the same handle
+bool VulkanCore::streamTextureIn(TextureHandle handle, uint32_t baseMip) {
+    auto path = m_textureCachePaths.find(handle);
+    if (path == m_textureCachePaths.end()) return false;
+    auto cached = m_textureCache.find(path->second);
+    if (cached == m_textureCache.end()) return false;
+    
+    TextureResource& tex = m_textures[handle];
+    KTX2Data ktx = load_ktx2(cached->second.path, m_physicalDevice);
+    if (ktx.format != tex.format || ktx.width != tex.streamWidth || ktx.height != tex.streamHeight ||
+        ktx.mipmapCount != tex.streamLevels) {
+        // Gone or changed on disk (reloadTexture() picks changes up): stay as is
+        std::cerr << "[VulkanCore] Streaming stopped for " << cached->second.path << " (file no longer matches)" << std::endl;
+        tex.streamLevels = 0;
+        return false;
+    }
+    
+    TextureResource fresh = tex;  // Streaming state; the image is replaced below
+    if (!createTextureLevels(fresh, ktx.format, ktx.width, ktx.height, ktx.mipmapCount,
+                             ktx.data.data(), ktx.data.size(), ktx.mipOffsets, baseMip)) {
+        return false;
+    }
+    fresh.residentBase = baseMip;
+    replaceTexture(handle, fresh);
+    return true;
+}
+
+// Drops the levels finer than baseMip with a GPU copy of the rest
+bool VulkanCore::streamTextureOut(TextureHandle handle, uint32_t baseMip) {
+    TextureResource& tex = m_textures[handle];
+    if (baseMip <= tex.residentBase) return false;
+    TextureResource low = tex;  // Streaming state; the image is replaced below
+    if (!copyTextureMips(tex, baseMip - tex.residentBase, low)) return false;
+    low.residentBase = baseMip;
+    replaceTexture(handle, low);
+    return true;
+}
+
+// ============================================================================
+// Drawing
+// ============================================================================
+
+void VulkanCore::drawMesh(MeshHandle mesh, const glm::mat4& transform, const glm::vec4& color) {
+    if (!bindMeshBuffers(mesh)) return;
+    drawBoundMesh(mesh, transform, color);
+}
+
+void VulkanCore::drawMeshInstanced(MeshHandle mesh, const glm::mat4* transforms, const glm::vec4* colors, uint32_t count) {
+    if (!transforms || count == 0) return;
+    if (!bindMeshBuffers(mesh)) return;
+    drawBoundMeshInstanced(mesh, transforms, colors, count);
+}
+
+bool VulkanCore::bindMeshBuffers(MeshHandle mesh) {
+    if (!m_frameStarted) return false;
+    if (!isMeshReady(mesh)) return false;  // Still in flight on the transfer queue
+    if (recordContext().pipeline == INVALID_PIPELINE) return false;
     
-    if (vkCreateImage(m_device, &imageInfo, nullptr, &tex.image) != VK_SUCCESS) {
-        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-        vkFreeMemory(m_device, stagingMemory, nullptr);
-        return INVALID_TEXTURE;
-    }
+    VkCommandBuffer cmd = recordContext().cmd;
+    m_meshes[mesh].lastUsed.touch(m_frameNumber);
     
-    vkGetImageMemoryRequirements(m_device, tex.image, &memReqs);
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    // Bind vertex buffer
+    VkBuffer vertexBuffers[] = {m_buffers[m_meshes[mesh].vertexBuffer].buffer};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
     
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &tex.memory) != VK_SUCCESS) {
-        vkDestroyImage(m_device, tex.image, nullptr);
-        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-        vkFreeMemory(m_device, stagingMemory, nullptr);
-        return INVALID_TEXTURE;
+    // Bind index buffer
+    vkCmdBindIndexBuffer(cmd, m_buffers[m_meshes[mesh].indexBuffer].buffer, 0, VK_INDEX_TYPE_UINT32);
+    return true;
+}
+
+void VulkanCore::drawBoundMesh(MeshHandle mesh, const glm::mat4& transform, const glm::vec4& color) {
+    CaptureCall call;
+    if (m_drawCapture && m_drawCapture->isRecording() && call.outermost()) {
+        const RecordContext& ctx = recordContext();
+        m_drawCapture->drawMesh(ctx.pipeline, ctx.texture, ctx.pass, mesh, transform, color);
     }
     
-    vkBindImageMemory(m_device, tex.image, tex.memory, 0);
-    
-    // Transition and copy
-    VkCommandBuffer cmd = beginSingleTimeCommands();
-    
-    // Transition to transfer dst
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = tex.image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = 0;
-    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, &barrier);
-    
-    // Copy buffer to image
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
-    
-    vkCmdCopyBufferToImage(cmd, stagingBuffer, tex.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-    
-    // Transition to shader read
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, &barrier);
-    
-    endSingleTimeCommands(cmd);
+    if (cullDraw(mesh, transform)) return;
     
-    // Cleanup staging
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingMemory, nullptr);
+    uint32_t dynamicOffset;
+    if (!allocateObjectSlot(meshModel(mesh, transform), color, dynamicOffset)) return;
     
-    // Create image view
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = tex.image;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;  // LINEAR format to match image
-    viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-    viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-    viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-    viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
-    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
+    const RecordContext& ctx = recordContext();
+    VkCommandBuffer cmd = ctx.cmd;
     
-    if (vkCreateImageView(m_device, &viewInfo, nullptr, &tex.view) != VK_SUCCESS) {
-        vkDestroyImage(m_device, tex.image, nullptr);
-        vkFreeMemory(m_device, tex.memory, nullptr);
-        return INVALID_TEXTURE;
+    // Bind descriptor set at this draw's slot
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_pipelines[ctx.pipeline].layout,
+                            0, 1, &m_uniformRings[m_currentFrame].descriptorSet, 1, &dynamicOffset);
+    pushBindlessIndex(cmd, ctx.pipeline, ctx.textureIndex);
+    
+    // Draw the LOD this transform needs (shares the vertex buffer with LOD 0)
+    const MeshLod& lod = selectMeshLod(mesh, &transform, 1);
+    vkCmdDrawIndexed(cmd, lod.indexCount, 1, lod.firstIndex, 0, 0);
+    
+    // Kept for the pick subpass (once per draw: the depth pre-pass copy is skipped)
+    const PipelineResource& pipe = m_pipelines[ctx.pipeline];
+    if (pipe.pickId != VK_NULL_HANDLE && ctx.pass != DrawPass::DepthOnly) {
+        PickBuffer::Draw draw;
+        draw.pipeline = pipe.pickId;
+        draw.layout = pipe.layout;
+        draw.descriptorSet = m_uniformRings[m_currentFrame].descriptorSet;
+        draw.dynamicOffset = dynamicOffset;
+        draw.vertexBuffer = m_buffers[m_meshes[mesh].vertexBuffer].buffer;
+        draw.indexBuffer = m_buffers[m_meshes[mesh].indexBuffer].buffer;
+        draw.firstIndex = lod.firstIndex;
+        draw.indexCount = lod.indexCount;
+        m_pick.addDraw(draw, lod.firstIndex / 3, ctx.pickObject, mesh);
     }
-    
-    // Create sampler
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-    samplerInfo.maxAnisotropy = 1.0f;
-    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    
-    if (vkCreateSampler(m_device, &samplerInfo, nullptr, &tex.sampler) != VK_SUCCESS) {
-        vkDestroyImageView(m_device, tex.view, nullptr);
-        vkDestroyImage(m_device, tex.image, nullptr);
-        vkFreeMemory(m_device, tex.memory, nullptr);
-        return INVALID_TEXTURE;
+}
+
+void VulkanCore::drawBoundMeshInstanced(MeshHandle mesh, const glm::mat4* transforms, const glm::vec4* colors, uint32_t count) {
+    const RecordContext& ctx = recordContext();
+    CaptureCall call;
+    if (m_drawCapture && m_drawCapture->isRecording() && call.outermost()) {
+        m_drawCapture->drawMeshInstanced(ctx.pipeline, ctx.texture, ctx.pass, mesh, transforms, colors, count);
     }
     
-    tex.valid = true;
-    
-    // Find free slot or add new
-    TextureHandle handle = INVALID_TEXTURE;
-    for (size_t i = 0; i < m_textures.size(); ++i) {
-        if (!m_textures[i].valid) {
-            m_textures[i] = tex;
-            handle = static_cast<TextureHandle>(i);
-            break;
+    // Pipeline has no instance binding - draw them one at a time
+    if (!m_pipelines[ctx.pipeline].instanced) {
+        for (uint32_t i = 0; i < count; i++) {
+            drawBoundMesh(mesh, transforms[i], colors ? colors[i] : glm::vec4(1.0f));
         }
-    }
-    if (handle == INVALID_TEXTURE) {
-        handle = static_cast<TextureHandle>(m_textures.size());
-        m_textures.push_back(tex);
+        return;
     }
     
-    return handle;
-}
-
-void VulkanCore::bindTexture(TextureHandle handle) {
-    TextureHandle texToUse = m_defaultTexture;
-    if (handle < m_textures.size() && m_textures[handle].valid) {
-        texToUse = handle;
+    VkBuffer instanceBuffer;
+    VkDeviceSize instanceOffset;
+    InstanceData* instances = allocateInstances(count, instanceBuffer, instanceOffset);
+    if (!instances) return;
+    
+    // Only instances inside the frustum are copied (the tail of the
+    // allocation goes unused); their transforms also pick the LOD
+    static thread_local std::vector<glm::mat4> visibleTransforms;
+    visibleTransforms.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        if (cullDraw(mesh, transforms[i])) continue;
+        uint32_t slot = static_cast<uint32_t>(visibleTransforms.size());
+        instances[slot].model = meshModel(mesh, transforms[i]);
+        instances[slot].color = colors ? colors[i] : glm::vec4(1.0f);
+        visibleTransforms.push_back(transforms[i]);
     }
+    uint32_t visibleCount = static_cast<uint32_t>(visibleTransforms.size());
+    if (visibleCount == 0) return;
     
-    if (texToUse == m_currentTexture) return;  // Already bound
-    m_currentTexture = texToUse;
+    // One UBO slot for the whole batch (view/projection; model comes per instance)
+    uint32_t dynamicOffset;
+    if (!allocateObjectSlot(glm::mat4(1.0f), glm::vec4(1.0f), dynamicOffset)) return;
     
-    // Update descriptor set with new texture
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.sampler = m_textures[texToUse].sampler;
-    imageInfo.imageView = m_textures[texToUse].view;
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkCommandBuffer cmd = ctx.cmd;
     
-    VkWriteDescriptorSet write{};
-    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    write.dstSet = m_objectDescriptorSet;
-    write.dstBinding = 1;
-    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    write.descriptorCount = 1;
-    write.pImageInfo = &imageInfo;
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_pipelines[ctx.pipeline].layout,
+                            0, 1, &m_uniformRings[m_currentFrame].descriptorSet, 1, &dynamicOffset);
+    pushBindlessIndex(cmd, ctx.pipeline, ctx.textureIndex);
     
-    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
-}
-
-void VulkanCore::destroyTexture(TextureHandle handle) {
-    if (handle >= m_textures.size() || !m_textures[handle].valid) return;
+    // Mesh buffers are already bound at binding 0; add the instance stream
+    vkCmdBindVertexBuffers(cmd, INSTANCE_BINDING, 1, &instanceBuffer, &instanceOffset);
     
-    TextureResource& tex = m_textures[handle];
-    if (tex.sampler) vkDestroySampler(m_device, tex.sampler, nullptr);
-    if (tex.view) vkDestroyImageView(m_device, tex.view, nullptr);
-    if (tex.image) vkDestroyImage(m_device, tex.image, nullptr);
-    if (tex.memory) vkFreeMemory(m_device, tex.memory, nullptr);
-    tex.valid = false;
+    // One draw, so one LOD: the finest any instance needs
+    const MeshLod& lod = selectMeshLod(mesh, visibleTransforms.data(), visibleCount);
+    vkCmdDrawIndexed(cmd, lod.indexCount, visibleCount, lod.firstIndex, 0, 0);
 }
 
 // ============================================================================
-// Mesh Management
+// Occlusion Culling
 // ============================================================================
 
-MeshHandle VulkanCore::createMesh(const MeshData& data) {
-    BufferHandle vb = createVertexBuffer(data.vertices.data(), data.vertices.size() * sizeof(float));
-    BufferHandle ib = createIndexBuffer(data.indices.data(), data.indices.size());
+bool VulkanCore::drawMeshOcclusionCulled(MeshHandle mesh, const glm::mat4& transform, uint32_t queryId,
+                                         const glm::vec4& color) {
+    if (!m_occlusion.isEnabled()) {
+        drawMesh(mesh, transform, color);
+        return true;
+    }
+    if (!bindMeshBuffers(mesh)) return false;
     
-    if (vb == INVALID_BUFFER || ib == INVALID_BUFFER) {
-        if (vb != INVALID_BUFFER) destroyBuffer(vb);
-        if (ib != INVALID_BUFFER) destroyBuffer(ib);
-        return INVALID_MESH;
+    const RecordContext& ctx = recordContext();
+    bool visible = m_occlusion.isVisible(queryId) || !occlusionTestable(mesh, transform);
+    
+    // Depth isn't final yet - only the shading pass (or a plain frame) is tested
+    if (ctx.pass == DrawPass::DepthOnly) {
+        if (visible) drawBoundMesh(mesh, transform, color);
+        return visible;
     }
     
-    MeshHandle handle = static_cast<MeshHandle>(m_meshes.size());
-    m_meshes.push_back({vb, ib, static_cast<uint32_t>(data.indices.size()), true});
-    return handle;
+    uint32_t query = m_occlusion.begin(ctx.cmd, queryId);
+    if (visible) {
+        drawBoundMesh(mesh, transform, color);
+    } else {
+        drawOcclusionProxy(mesh, transform);
+    }
+    m_occlusion.end(ctx.cmd, query);
+    return visible;
 }
 
-MeshHandle VulkanCore::createCube(float size, const glm::vec3& color) {
-    // Scale and colorize cube vertices
-    std::vector<float> vertices;
-    for (int i = 0; i < 24; i++) {
-        vertices.push_back(CUBE_VERTICES[i * 6 + 0] * size);  // x
-        vertices.push_back(CUBE_VERTICES[i * 6 + 1] * size);  // y
-        vertices.push_back(CUBE_VERTICES[i * 6 + 2] * size);  // z
-        vertices.push_back(CUBE_VERTICES[i * 6 + 3] * color.r); // r
-        vertices.push_back(CUBE_VERTICES[i * 6 + 4] * color.g); // g
-        vertices.push_back(CUBE_VERTICES[i * 6 + 5] * color.b); // b
-    }
-    
-    MeshData data;
-    data.vertices = vertices;
-    data.indices = std::vector<uint32_t>(CUBE_INDICES, CUBE_INDICES + 36);
-    data.format = VertexFormat::POSITION_COLOR;
-    data.vertexCount = 24;
-    data.indexCount = 36;
-    
-    return createMesh(data);
+uint32_t VulkanCore::beginOcclusionQuery(uint32_t queryId) {
+    if (!m_frameStarted) return OcclusionQueries::NO_QUERY;
+    return m_occlusion.begin(recordContext().cmd, queryId);
 }
 
-void VulkanCore::destroyMesh(MeshHandle handle) {
-    if (handle >= m_meshes.size() || !m_meshes[handle].valid) return;
-    destroyBuffer(m_meshes[handle].vertexBuffer);
-    destroyBuffer(m_meshes[handle].indexBuffer);
-    m_meshes[handle].valid = false;
+void VulkanCore::endOcclusionQuery(uint32_t query) {
+    if (!m_frameStarted) return;
+    m_occlusion.end(recordContext().cmd, query);
 }
 
-bool VulkanCore::getMeshBuffers(MeshHandle mesh, VkBuffer& vertexBuffer, VkBuffer& indexBuffer, uint32_t& indexCount) const {
-    if (mesh >= m_meshes.size() || !m_meshes[mesh].valid) return false;
-    
-    const auto& meshRes = m_meshes[mesh];
-    if (meshRes.vertexBuffer >= m_buffers.size() || !m_buffers[meshRes.vertexBuffer].valid) return false;
-    if (meshRes.indexBuffer >= m_buffers.size() || !m_buffers[meshRes.indexBuffer].valid) return false;
-    
-    vertexBuffer = m_buffers[meshRes.vertexBuffer].buffer;
-    indexBuffer = m_buffers[meshRes.indexBuffer].buffer;
-    indexCount = meshRes.indexCount;
-    return true;
+// An occluded mesh is only re-tested through its proxy, which needs the
+// pipeline's proxy variant and a camera outside the bounds (from inside,
+// the proxy's faces would be clipped and read as occluded)
+bool VulkanCore::occlusionTestable(MeshHandle mesh, const glm::mat4& transform) const {
+    const RecordContext& ctx = recordContext();
+    if (ctx.pipeline == INVALID_PIPELINE || m_pipelines[ctx.pipeline].occlusionProxy == VK_NULL_HANDLE) return false;
+    
+    const LodBounds& bounds = m_meshes[mesh].bounds;
+    if (bounds.radius <= 0.0f) return false;
+    glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.center, 1.0f));
+    float scale = std::max({glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])),
+                            glm::length(glm::vec3(transform[2]))});
+    glm::vec3 eye = glm::vec3(glm::inverse(m_viewMatrix)[3]);
+    return glm::length(eye - center) > bounds.radius * scale * 1.1f;
 }
 
-bool VulkanCore::getTextureInfo(TextureHandle tex, VkImageView& view, VkSampler& sampler) const {
-    if (tex >= m_textures.size() || !m_textures[tex].valid) return false;
+// Coarsest LOD, depth-tested only: writes nothing, but its samples count
+void VulkanCore::drawOcclusionProxy(MeshHandle mesh, const glm::mat4& transform) {
+    uint32_t dynamicOffset;
+    if (!allocateObjectSlot(meshModel(mesh, transform), glm::vec4(1.0f), dynamicOffset)) return;
     
-    view = m_textures[tex].view;
-    sampler = m_textures[tex].sampler;
-    return true;
+    const RecordContext& ctx = recordContext();
+    const PipelineResource& pipe = m_pipelines[ctx.pipeline];
+    VkCommandBuffer cmd = ctx.cmd;
+    
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipe.occlusionProxy);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipe.layout,
+                            0, 1, &m_uniformRings[m_currentFrame].descriptorSet, 1, &dynamicOffset);
+    pushBindlessIndex(cmd, ctx.pipeline, ctx.textureIndex);
+    
+    const MeshLod& lod = m_meshes[mesh].lods.back();
+    vkCmdDrawIndexed(cmd, lod.indexCount, 1, lod.firstIndex, 0, 0);
+    
+    // Same layout, so the bound sets stay valid
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, passPipeline(pipe, ctx.pass));
 }
 
-// ============================================================================
-// Drawing
-// ============================================================================
-
-void VulkanCore::drawMesh(MeshHandle mesh, const glm::mat4& transform, const glm::vec4& color) {
-    if (!m_frameStarted) return;
-    if (mesh >= m_meshes.size() || !m_meshes[mesh].valid) return;
-    if (m_currentPipeline == INVALID_PIPELINE) return;
+void VulkanCore::drawIndexedIndirect(VkBuffer vertexBuffer, VkBuffer indexBuffer, VkBuffer instanceBuffer,
+                                     VkBuffer indirectBuffer, uint32_t maxDraws, VkBuffer countBuffer) {
+    if (!m_frameStarted || maxDraws == 0) return;
+    const RecordContext& ctx = recordContext();
+    if (ctx.pipeline == INVALID_PIPELINE || !m_pipelines[ctx.pipeline].instanced) {
+        static bool warned = false;
+        if (!warned) { warned = true; std::cerr << "[VulkanCore] drawIndexedIndirect needs an instanced pipeline bound" << std::endl; }
+        return;
+    }
     
-    // Update UBO
-    StandardUBO ubo;
-    ubo.model = transform;
-    ubo.view = m_viewMatrix;
-    ubo.projection = m_projMatrix;
-    ubo.color = color;
-    updateUniformBuffer(m_objectUBO, &ubo, sizeof(ubo));
+    // View/projection only; model comes per instance
+    uint32_t dynamicOffset;
+    if (!allocateObjectSlot(glm::mat4(1.0f), glm::vec4(1.0f), dynamicOffset)) return;
     
-    VkCommandBuffer cmd = m_commandBuffers[m_currentFrame];
+    VkCommandBuffer cmd = ctx.cmd;
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelines[ctx.pipeline].layout,
+                            0, 1, &m_uniformRings[m_currentFrame].descriptorSet, 1, &dynamicOffset);
+    pushBindlessIndex(cmd, ctx.pipeline, ctx.textureIndex);
     
-    // Bind descriptor set
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_pipelines[m_currentPipeline].layout,
-                            0, 1, &m_objectDescriptorSet, 0, nullptr);
+    VkDeviceSize zero = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &zero);
+    vkCmdBindVertexBuffers(cmd, INSTANCE_BINDING, 1, &instanceBuffer, &zero);
+    vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
     
-    // Bind vertex buffer
-    VkBuffer vertexBuffers[] = {m_buffers[m_meshes[mesh].vertexBuffer].buffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (countBuffer != VK_NULL_HANDLE && m_cmdDrawIndexedIndirectCount) {
+        m_cmdDrawIndexedIndirectCount(cmd, indirectBuffer, 0, countBuffer, 0, maxDraws, stride);
+        return;
+    }
     
-    // Bind index buffer
-    vkCmdBindIndexBuffer(cmd, m_buffers[m_meshes[mesh].indexBuffer].buffer, 0, VK_INDEX_TYPE_UINT32);
+    // Without multiDrawIndirect m_maxDrawIndirectCount is 1: one call per command
+    for (uint32_t first = 0; first < maxDraws; first += m_maxDrawIndirectCount) {
+        uint32_t count = std::min(m_maxDrawIndirectCount, maxDraws - first);
+        vkCmdDrawIndexedIndirect(cmd, indirectBuffer, static_cast<VkDeviceSize>(first) * stride, count, stride);
+    }
+}
+
+void VulkanCore::drawMeshInstanced(MeshHandle mesh, const std::vector<glm::mat4>& transforms,
+                                   const std::vector<glm::vec4>& colors) {
+    if (colors.empty() || colors.size() >= transforms.size()) {
+        drawMeshInstanced(mesh, transforms.data(), colors.empty() ? nullptr : colors.data(),
+                          static_cast<uint32_t>(transforms.size()));
+        return;
+    }
+    // Fewer colors than instances: the rest draw white
+    std::vector<glm::vec4> padded(colors);
+    padded.resize(transforms.size(), glm::vec4(1.0f));
+    drawMeshInstanced(mesh, transforms.data(), padded.data(), static_cast<uint32_t>(transforms.size()));
+}
+
+InstanceData* VulkanCore::allocateInstances(uint32_t count, VkBuffer& buffer, VkDeviceSize& offset) {
+    if (!m_frameStarted || m_instanceRings.empty()) return nullptr;
+    
+    std::unique_lock<std::mutex> lock(m_ringMutex, std::defer_lock);
+    if (m_parallelActive) lock.lock();
+    
+    InstanceRing& ring = m_instanceRings[m_currentFrame];
+    if (count > MAX_INSTANCES_PER_FRAME - ring.head) {
+        if (!ring.overflowWarned) {
+            std::cerr << "[VulkanCore] Instance buffer full (" << MAX_INSTANCES_PER_FRAME
+                      << " instances this frame) - dropping instanced draws" << std::endl;
+            ring.overflowWarned = true;
+        }
+        return nullptr;
+    }
     
-    // Draw
-    vkCmdDrawIndexed(cmd, m_meshes[mesh].indexCount, 1, 0, 0, 0);
+    buffer = ring.buffer;
+    offset = static_cast<VkDeviceSize>(ring.head) * sizeof(InstanceData);
+    InstanceData* instances = ring.mapped + ring.head;
+    ring.head += count;
+    return instances;
 }
 
 void VulkanCore::drawVertices(BufferHandle vertexBuffer, uint32_t vertexCount) {
-    if (!m_frameStarted || vertexBuffer >= m_buffers.size()) return;
+    if (!m_frameStarted || !isBufferReady(vertexBuffer)) return;
     
-    VkCommandBuffer cmd = m_commandBuffers[m_currentFrame];
+    VkCommandBuffer cmd = recordContext().cmd;
     VkBuffer buffers[] = {m_buffers[vertexBuffer].buffer};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(cmd, 0, 1, buffers, offsets);
@@ -1574,9 +3887,9 @@ void VulkanCore::drawVertices(BufferHandle vertexBuffer, uint32_t vertexCount) {
 
 void VulkanCore::drawIndexed(BufferHandle vertexBuffer, BufferHandle indexBuffer, uint32_t indexCount) {
     if (!m_frameStarted) return;
-    if (vertexBuffer >= m_buffers.size() || indexBuffer >= m_buffers.size()) return;
+    if (!isBufferReady(vertexBuffer) || !isBufferReady(indexBuffer)) return;
     
-    VkCommandBuffer cmd = m_commandBuffers[m_currentFrame];
+    VkCommandBuffer cmd = recordContext().cmd;
     VkBuffer buffers[] = {m_buffers[vertexBuffer].buffer};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(cmd, 0, 1, buffers, offsets);
@@ -1590,19 +3903,25 @@ void VulkanCore::drawIndexed(BufferHandle vertexBuffer, BufferHandle indexBuffer
 
 void VulkanCore::setViewMatrix(const glm::mat4& view) {
     m_viewMatrix = view;
+    updateFrustum();
+    if (m_drawCapture && m_drawCapture->isRecording()) m_drawCapture->setCamera(m_viewMatrix, m_projMatrix);
 }
 
 void VulkanCore::setProjectionMatrix(const glm::mat4& proj) {
     m_projMatrix = proj;
+    updateFrustum();
+    if (m_drawCapture && m_drawCapture->isRecording()) m_drawCapture->setCamera(m_viewMatrix, m_projMatrix);
 }
 
 void VulkanCore::setCamera(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up) {
     m_viewMatrix = glm::lookAt(position, target, up);
+    updateFrustum();
 }
 
 void VulkanCore::setPerspective(float fovDegrees, float nearPlane, float farPlane) {
     m_projMatrix = glm::perspective(glm::radians(fovDegrees), getAspectRatio(), nearPlane, farPlane);
     m_projMatrix[1][1] *= -1;  // Vulkan Y flip
+    updateFrustum();
 }
 
 // ============================================================================
@@ -1610,7 +3929,7 @@ void VulkanCore::setPerspective(float fovDegrees, float nearPlane, float farPlan
 // ============================================================================
 
 std::vector<char> VulkanCore::readShaderFile(const std::string& path) {
-    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    VfsInputStream file(path, std::ios::ate | std::ios::binary);
     if (!file.is_open()) return {};
     
     size_t size = (size_t)file.tellg();
@@ -1643,66 +3962,42 @@ uint32_t VulkanCore::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags p
     return 0;
 }
 
-VkCommandBuffer VulkanCore::beginSingleTimeCommands() {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = m_commandPool;
-    allocInfo.commandBufferCount = 1;
-    
-    VkCommandBuffer cmd;
-    vkAllocateCommandBuffers(m_device, &allocInfo, &cmd);
-    
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    
-    vkBeginCommandBuffer(cmd, &beginInfo);
-    return cmd;
+// What the shader gets as the model matrix: packed meshes also dequantize
+glm::mat4 VulkanCore::meshModel(MeshHandle mesh, const glm::mat4& transform) const {
+    const MeshResource& res = m_meshes[mesh];
+    return res.quantized ? transform * res.dequantize : transform;
 }
 
-void VulkanCore::endSingleTimeCommands(VkCommandBuffer cmd) {
-    vkEndCommandBuffer(cmd);
-    
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &cmd;
-    
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_graphicsQueue);
-    
-    vkFreeCommandBuffers(m_device, m_commandPool, 1, &cmd);
+// Bump-allocates one StandardUBO slot from this frame's object ring
+bool VulkanCore::allocateObjectSlot(const glm::mat4& model, const glm::vec4& color, uint32_t& dynamicOffset) {
+    std::unique_lock<std::mutex> lock(m_ringMutex, std::defer_lock);
+    if (m_parallelActive) lock.lock();
+    
+    UniformRing& ring = m_uniformRings[m_currentFrame];
+    if (ring.head + m_uboSlotStride > m_uboSlotStride * OBJECT_UBO_RING_SLOTS) {
+        if (!ring.overflowWarned) {
+            std::cerr << "[VulkanCore] Object UBO ring full (" << OBJECT_UBO_RING_SLOTS
+                      << " draws this frame) - dropping draws" << std::endl;
+            ring.overflowWarned = true;
+        }
+        return false;
+    }
+    dynamicOffset = static_cast<uint32_t>(ring.head);
+    ring.head += m_uboSlotStride;
+    if (lock.owns_lock()) lock.unlock();
+    
+    StandardUBO* ubo = reinterpret_cast<StandardUBO*>(ring.mapped + dynamicOffset);
+    ubo->model = model;
+    ubo->view = m_viewMatrix;
+    ubo->projection = m_projMatrix;
+    ubo->color = color;
+    return true;
 }
 
 bool VulkanCore::createBufferInternal(VkDeviceSize size, VkBufferUsageFlags usage,
                                        VkMemoryPropertyFlags properties,
-                                       VkBuffer& buffer, VkDeviceMemory& memory) {
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = size;
-    bufferInfo.usage = usage;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    
-    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
-        return false;
-    }
-    
-    VkMemoryRequirements memReqs;
-    vkGetBufferMemoryRequirements(m_device, buffer, &memReqs);
-    
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memReqs.memoryTypeBits, properties);
-    
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
-        vkDestroyBuffer(m_device, buffer, nullptr);
-        return false;
-    }
-    
-    vkBindBufferMemory(m_device, buffer, memory, 0);
-    return true;
+                                       VkBuffer& buffer, GpuAllocation& alloc) {
+    return m_allocator.createBuffer(size, usage, properties, buffer, alloc);
 }
 
 VkVertexInputBindingDescription VulkanCore::getBindingDescription(VertexFormat format) {
@@ -1723,6 +4018,12 @@ VkVertexInputBindingDescription VulkanCore::getBindingDescription(VertexFormat f
         case VertexFormat::POSITION_NORMAL_UV0_UV1:
             desc.stride = sizeof(float) * 10; // vec3 pos + vec3 normal + vec2 uv0 + vec2 uv1
             break;
+        case VertexFormat::PACKED_POSITION_NORMAL_UV:
+            desc.stride = sizeof(PackedVertex);
+            break;
+        case VertexFormat::PACKED_POSITION_NORMAL_UV0_UV1:
+            desc.stride = sizeof(PackedVertexUV1);
+            break;
         default:
             desc.stride = sizeof(float) * 6;
     }
@@ -1758,6 +4059,19 @@ std::vector<VkVertexInputAttributeDescription> VulkanCore::getAttributeDescripti
             attrs[2] = {2, 0, VK_FORMAT_R32G32_SFLOAT, sizeof(float) * 6};       // uv0 (textures)
             attrs[3] = {3, 0, VK_FORMAT_R32G32_SFLOAT, sizeof(float) * 8};       // uv1 (DMap)
             break;
+        case VertexFormat::PACKED_POSITION_NORMAL_UV:
+            attrs.resize(3);
+            attrs[0] = {0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex, position)};  // position, [0, 1]
+            attrs[1] = {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal)};          // octahedral normal
+            attrs[2] = {2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex, uv)};             // uv
+            break;
+        case VertexFormat::PACKED_POSITION_NORMAL_UV0_UV1:
+            attrs.resize(4);
+            attrs[0] = {0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertexUV1, position)};
+            attrs[1] = {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertexUV1, normal)};
+            attrs[2] = {2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertexUV1, uv)};   // uv0 (textures)
+            attrs[3] = {3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertexUV1, uv1)};  // uv1 (DMap)
+            break;
         default:
             attrs.resize(2);
             attrs[0] = {0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0};
@@ -1773,6 +4087,10 @@ std::vector<VkVertexInputAttributeDescription> VulkanCore::getAttributeDescripti
 bool VulkanCore::initImGui(GLFWwindow* window) {
 #ifdef VKCORE_ENABLE_IMGUI
     if (m_imguiInitialized) return true;
+    if (m_config.headless) {
+        std::cerr << "[VulkanCore] ImGui needs a window - not available headless" << std::endl;
+        return false;
+    }
     
     // Create descriptor pool for ImGui
     VkDescriptorPoolSize poolSizes[] = {
@@ -1868,8 +4186,105 @@ void VulkanCore::beginImGuiFrame() {
 void VulkanCore::renderImGui() {
 #ifdef VKCORE_ENABLE_IMGUI
     if (!m_imguiInitialized || !m_frameStarted) return;
+    if (m_showGpuProfiler) drawGpuProfilerWindow();
+    if (m_showMemoryBudget) drawMemoryBudgetWindow();
     ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), m_commandBuffers[m_currentFrame]);
+    beginUiPass();  // Native resolution with dynamic resolution on
+    uint32_t scope = m_gpuProfiler.beginScope(m_mainContext.cmd, "imgui");
+    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), m_mainContext.cmd);
+    m_gpuProfiler.endScope(m_mainContext.cmd, scope);
+#endif
+}
+
+void VulkanCore::drawGpuProfilerWindow() {
+#ifdef VKCORE_ENABLE_IMGUI
+    ImGui::SetNextWindowSize(ImVec2(320, 0), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("GPU Timings", &m_showGpuProfiler)) {
+        ImGui::End();
+        return;
+    }
+    
+    if (!m_gpuProfiler.isEnabled()) {
+        ImGui::TextUnformatted("Timestamps unavailable (CoreConfig::gpuProfiling or device)");
+        ImGui::End();
+        return;
+    }
+    
+    float frameMs = m_gpuProfiler.getFrameMs();
+    ImGui::Text("GPU frame: %.3f ms", frameMs);
+    ImGui::Text("CPU: fence %.2f ms, acquire %.2f ms", m_frameTimings.fenceWaitMs, m_frameTimings.acquireMs);
+    ImGui::Separator();
+    
+    ImGui::Columns(3, "gpu_timings", false);
+    ImGui::TextUnformatted("Scope"); ImGui::NextColumn();
+    ImGui::TextUnformatted("ms"); ImGui::NextColumn();
+    ImGui::TextUnformatted("count"); ImGui::NextColumn();
+    for (const auto& timing : m_gpuProfiler.getTimings()) {
+        ImGui::TextUnformatted(timing.name.c_str()); ImGui::NextColumn();
+        ImGui::Text("%.3f", timing.ms); ImGui::NextColumn();
+        ImGui::Text("%u", timing.count); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    
+    if (ImGui::Button("Export Chrome trace")) {
+        m_gpuProfiler.exportChromeTrace("gpu_trace.json");
+    }
+    ImGui::End();
+#endif
+}
+
+void VulkanCore::drawMemoryBudgetWindow() {
+#ifdef VKCORE_ENABLE_IMGUI
+    ImGui::SetNextWindowSize(ImVec2(360, 0), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("GPU Memory", &m_showMemoryBudget)) {
+        ImGui::End();
+        return;
+    }
+    
+    const MemoryStats& stats = m_memoryStats;
+    auto mb = [](VkDeviceSize bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+    ImGui::Text("Device-local: %.1f / %.1f MB%s", mb(stats.usage), mb(stats.budget),
+                stats.budgetExtension ? "" : " (estimated)");
+    ImGui::ProgressBar(stats.budget > 0 ? static_cast<float>(mb(stats.usage) / mb(stats.budget)) : 0.0f, ImVec2(-1, 0));
+    if (m_config.memoryBudgetFraction > 0.0f) {
+        ImGui::Text("Evicting above %.1f MB (%.0f%%)", mb(stats.target), m_config.memoryBudgetFraction * 100.0f);
+    } else {
+        ImGui::TextUnformatted("Eviction off (CoreConfig::memoryBudgetFraction)");
+    }
+    ImGui::Text("Textures: %.1f MB, %u demoted", mb(stats.textureBytes), stats.texturesDemoted);
+    ImGui::Text("Meshes: %.1f MB, %u in host memory", mb(stats.meshBytes), stats.meshesEvicted);
+    ImGui::Text("This frame: %u evicted, %u restored", stats.evictions, stats.restores);
+    ImGui::Text("Total: %llu evicted, %llu restored", static_cast<unsigned long long>(stats.totalEvictions),
+                static_cast<unsigned long long>(stats.totalRestores));
+    ImGui::Separator();
+    
+    ImGui::Columns(4, "memory_heaps", false);
+    ImGui::TextUnformatted("Heap"); ImGui::NextColumn();
+    ImGui::TextUnformatted("used MB"); ImGui::NextColumn();
+    ImGui::TextUnformatted("budget MB"); ImGui::NextColumn();
+    ImGui::TextUnformatted("size MB"); ImGui::NextColumn();
+    const std::vector<HeapBudget>& heaps = m_memoryBudget.getHeaps();
+    for (size_t i = 0; i < heaps.size(); i++) {
+        ImGui::Text("%zu%s", i, heaps[i].deviceLocal ? " [device]" : " [host]"); ImGui::NextColumn();
+        ImGui::Text("%.1f", mb(heaps[i].usage)); ImGui::NextColumn();
+        ImGui::Text("%.1f", mb(heaps[i].budget)); ImGui::NextColumn();
+        ImGui::Text("%.1f", mb(heaps[i].size)); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    
+    if (m_streamer.isInitialized()) {
+        const StreamingStats& streaming = m_streamingStats;
+        ImGui::Separator();
+        ImGui::Text("Streaming: %u textures, %u fully resident%s", streaming.streamedTextures, streaming.fullyResident,
+                    streaming.feedback ? "" : " (no density feedback)");
+        ImGui::Text("Resident: %.1f / %.1f MB", mb(streaming.residentBytes), mb(streaming.fullBytes));
+        ImGui::Text("Pending: %u, uploading: %u", streaming.pending, streaming.inFlight);
+        ImGui::Text("This frame: %u in, %u out, %.2f / %.1f MB", streaming.streamedIn, streaming.streamedOut,
+                    mb(streaming.bytesStreamed), mb(m_config.streamingBytesPerFrame));
+        ImGui::Text("Total: %llu in, %llu out, %.1f MB", static_cast<unsigned long long>(streaming.totalStreamedIn),
+                    static_cast<unsigned long long>(streaming.totalStreamedOut), mb(streaming.totalBytesStreamed));
+    }
+    ImGui::End();
 #endif
 }
 
@@ -1882,6 +4297,7 @@ void VulkanCore::renderImGui() {
 static vkcore::VulkanCore* g_core = nullptr;
 
 extern "C" int vkcore_init(void* glfwWindow, const char* appName, int width, int height) {
+    EDEN_PROFILE_API();
     if (g_core) return 1;  // Already initialized
     
     g_core = new vkcore::VulkanCore();
@@ -1898,7 +4314,27 @@ extern "C" int vkcore_init(void* glfwWindow, const char* appName, int width, int
     return 1;
 }
 
+extern "C" int vkcore_init_headless(const char* appName, int width, int height) {
+    EDEN_PROFILE_API();
+    if (g_core) return 1;  // Already initialized
+    
+    g_core = new vkcore::VulkanCore();
+    vkcore::CoreConfig config;
+    config.appName = appName ? appName : "VulkanCore App";
+    config.width = width;
+    config.height = height;
+    config.headless = true;
+    
+    if (!g_core->init(nullptr, config)) {
+        delete g_core;
+        g_core = nullptr;
+        return 0;
+    }
+    return 1;
+}
+
 extern "C" void vkcore_shutdown() {
+    EDEN_PROFILE_API();
     if (g_core) {
         delete g_core;
         g_core = nullptr;
@@ -1906,18 +4342,22 @@ extern "C" void vkcore_shutdown() {
 }
 
 extern "C" int vkcore_is_initialized() {
+    EDEN_PROFILE_API();
     return g_core && g_core->isInitialized() ? 1 : 0;
 }
 
 extern "C" int vkcore_begin_frame() {
+    EDEN_PROFILE_API();
     return g_core ? (g_core->beginFrame() ? 1 : 0) : 0;
 }
 
 extern "C" void vkcore_end_frame() {
+    EDEN_PROFILE_API();
     if (g_core) g_core->endFrame();
 }
 
 extern "C" unsigned int vkcore_create_pipeline(const char* vertShader, const char* fragShader, int vertexFormat) {
+    EDEN_PROFILE_API();
     if (!g_core) return vkcore::INVALID_PIPELINE;
     
     vkcore::PipelineConfig config;
@@ -1929,20 +4369,24 @@ extern "C" unsigned int vkcore_create_pipeline(const char* vertShader, const cha
 }
 
 extern "C" void vkcore_bind_pipeline(unsigned int handle) {
+    EDEN_PROFILE_API();
     if (g_core) g_core->bindPipeline(handle);
 }
 
 extern "C" void vkcore_destroy_pipeline(unsigned int handle) {
+    EDEN_PROFILE_API();
     if (g_core) g_core->destroyPipeline(handle);
 }
 
 extern "C" unsigned int vkcore_create_cube(float size, float r, float g, float b) {
+    EDEN_PROFILE_API();
     if (!g_core) return vkcore::INVALID_MESH;
     return g_core->createCube(size, glm::vec3(r, g, b));
 }
 
 extern "C" unsigned int vkcore_create_mesh(const float* vertices, int vertexCount,
                                             const unsigned int* indices, int indexCount, int vertexFormat) {
+    EDEN_PROFILE_API();
     if (!g_core) return vkcore::INVALID_MESH;
     
     vkcore::MeshData data;
@@ -1956,14 +4400,21 @@ extern "C" unsigned int vkcore_create_mesh(const float* vertices, int vertexCoun
 }
 
 extern "C" void vkcore_destroy_mesh(unsigned int handle) {
+    EDEN_PROFILE_API();
     if (g_core) g_core->destroyMesh(handle);
 }
 
+extern "C" int vkcore_is_mesh_ready(unsigned int handle) {
+    EDEN_PROFILE_API();
+    return g_core && g_core->isMeshReady(handle) ? 1 : 0;
+}
+
 extern "C" void vkcore_draw_mesh(unsigned int meshHandle,
                                   float px, float py, float pz,
                                   float rx, float ry, float rz,
                                   float sx, float sy, float sz,
                                   float r, float g, float b, float a) {
+    EDEN_PROFILE_API();
     if (!g_core) return;
     
     glm::mat4 transform = glm::mat4(1.0f);
@@ -1976,59 +4427,134 @@ extern "C" void vkcore_draw_mesh(unsigned int meshHandle,
     g_core->drawMesh(meshHandle, transform, glm::vec4(r, g, b, a));
 }
 
+// mat4s: count column-major 4x4 matrices; colors: count RGBA values (may be null)
+extern "C" void vkcore_draw_mesh_instanced(unsigned int meshHandle, const float* mat4s,
+                                           const float* colors, int count) {
+    EDEN_PROFILE_API();
+    if (!g_core || !mat4s || count <= 0) return;
+    
+    std::vector<glm::mat4> transforms(count);
+    memcpy(transforms.data(), mat4s, sizeof(glm::mat4) * count);
+    
+    std::vector<glm::vec4> tints;
+    if (colors) {
+        tints.resize(count);
+        memcpy(tints.data(), colors, sizeof(glm::vec4) * count);
+    }
+    g_core->drawMeshInstanced(meshHandle, transforms, tints);
+}
+
 extern "C" void vkcore_set_camera(float eyeX, float eyeY, float eyeZ,
                                    float targetX, float targetY, float targetZ) {
+    EDEN_PROFILE_API();
     if (g_core) {
         g_core->setCamera(glm::vec3(eyeX, eyeY, eyeZ), glm::vec3(targetX, targetY, targetZ));
     }
 }
 
 extern "C" void vkcore_set_perspective(float fovDegrees, float nearPlane, float farPlane) {
+    EDEN_PROFILE_API();
     if (g_core) g_core->setPerspective(fovDegrees, nearPlane, farPlane);
 }
 
 extern "C" void vkcore_set_view_matrix(const float* mat4) {
+    EDEN_PROFILE_API();
     if (g_core && mat4) {
         g_core->setViewMatrix(glm::make_mat4(mat4));
     }
 }
 
 extern "C" void vkcore_set_projection_matrix(const float* mat4) {
+    EDEN_PROFILE_API();
     if (g_core && mat4) {
         g_core->setProjectionMatrix(glm::make_mat4(mat4));
     }
 }
 
 extern "C" int vkcore_get_width() {
+    EDEN_PROFILE_API();
     return g_core ? g_core->getWidth() : 0;
 }
 
 extern "C" int vkcore_get_height() {
+    EDEN_PROFILE_API();
     return g_core ? g_core->getHeight() : 0;
 }
 
 extern "C" float vkcore_get_aspect_ratio() {
+    EDEN_PROFILE_API();
     return g_core ? g_core->getAspectRatio() : 1.0f;
 }
 
+extern "C" float vkcore_get_render_scale() {
+    EDEN_PROFILE_API();
+    return g_core ? g_core->getRenderScale() : 1.0f;
+}
+
+extern "C" void vkcore_get_frame_timings(float* fenceWaitMs, float* acquireMs, float* pacingSleepMs, float* frameMs) {
+    EDEN_PROFILE_API();
+    vkcore::FrameTimings t = g_core ? g_core->getFrameTimings() : vkcore::FrameTimings{};
+    if (fenceWaitMs) *fenceWaitMs = t.fenceWaitMs;
+    if (acquireMs) *acquireMs = t.acquireMs;
+    if (pacingSleepMs) *pacingSleepMs = t.pacingSleepMs;
+    if (frameMs) *frameMs = t.frameMs;
+}
+
+extern "C" void vkcore_get_render_stats(int* drawCalls, double* triangles, double* trianglesFullDetail) {
+    EDEN_PROFILE_API();
+    vkcore::RenderStats s = g_core ? g_core->getRenderStats() : vkcore::RenderStats{};
+    if (drawCalls) *drawCalls = static_cast<int>(s.drawCalls);
+    if (triangles) *triangles = static_cast<double>(s.triangles);
+    if (trianglesFullDetail) *trianglesFullDetail = static_cast<double>(s.trianglesFullDetail);
+}
+
+extern "C" void vkcore_get_cull_stats(int* visible, int* culled) {
+    EDEN_PROFILE_API();
+    vkcore::RenderStats s = g_core ? g_core->getRenderStats() : vkcore::RenderStats{};
+    if (visible) *visible = static_cast<int>(s.objectsVisible);
+    if (culled) *culled = static_cast<int>(s.objectsCulled);
+}
+
+extern "C" int vkcore_get_gpu_timings(const char** names, float* ms, int maxCount) {
+    EDEN_PROFILE_API();
+    if (!g_core) return 0;
+    const auto& timings = g_core->getGpuTimings();
+    int count = static_cast<int>(timings.size());
+    for (int i = 0; i < count && i < maxCount; i++) {
+        if (names) names[i] = timings[i].name.c_str();
+        if (ms) ms[i] = timings[i].ms;
+    }
+    return count;
+}
+
+extern "C" int vkcore_export_gpu_trace(const char* path) {
+    EDEN_PROFILE_API();
+    return g_core && path && g_core->exportGpuTrace(path) ? 1 : 0;
+}
+
 // ImGui C API
 extern "C" int vkcore_init_imgui(void* glfwWindow) {
+    EDEN_PROFILE_API();
     return g_core ? (g_core->initImGui(static_cast<GLFWwindow*>(glfwWindow)) ? 1 : 0) : 0;
 }
 
 extern "C" void vkcore_shutdown_imgui() {
+    EDEN_PROFILE_API();
     if (g_core) g_core->shutdownImGui();
 }
 
 extern "C" void vkcore_begin_imgui_frame() {
+    EDEN_PROFILE_API();
     if (g_core) g_core->beginImGuiFrame();
 }
 
 extern "C" void vkcore_render_imgui() {
+    EDEN_PROFILE_API();
     if (g_core) g_core->renderImGui();
 }
 
 extern "C" int vkcore_is_imgui_initialized() {
+    EDEN_PROFILE_API();
     return g_core ? (g_core->isImGuiInitialized() ? 1 : 0) : 0;
 }
 
@@ -29,10 +29,36 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "gpu_allocator.h"
+#include "upload_manager.h"
+#include "upload_batch.h"
+#include "pipeline_cache.h"
+#include "gpu_profiler.h"
+#include "occlusion_queries.h"
+#include "pick_buffer.h"
+#include "dynamic_resolution.h"
+#include "async_compute.h"
+#include "mip_chain.h"
+#include "bindless_heap.h"
+#include "descriptor_allocator.h"
+#include "handle_pool.h"
+#include "mesh_lod.h"
+#include "memory_budget.h"
+#include "texture_streamer.h"
+#include "frustum_culler.h"
+#include "vertex_packing.h"
+
 #include <string>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <cstddef>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
 
 namespace vkcore {
 
@@ -40,13 +66,64 @@ namespace vkcore {
 // Configuration
 // ============================================================================
 
+// Swapchain present mode. Unsupported modes fall back (MAILBOX -> FIFO,
+// IMMEDIATE -> MAILBOX -> FIFO, FIFO_RELAXED -> FIFO); FIFO always exists.
+enum class PresentMode {
+    AUTO,          // FIFO with vsync, IMMEDIATE without (CoreConfig::vsync)
+    FIFO,          // Vsync, queues frames (highest latency)
+    FIFO_RELAXED,  // Vsync, but tears instead of stalling when a frame is late
+    MAILBOX,       // No tearing, newest frame replaces the queued one (low latency)
+    IMMEDIATE      // No vsync, tears
+};
+
 struct CoreConfig {
     std::string appName = "VulkanCore App";
     int width = 1280;
     int height = 720;
     bool enableValidation = false;
     bool vsync = true;
+    PresentMode presentMode = PresentMode::AUTO;
+    uint32_t framesInFlight = 2;     // 1-3: fewer = lower latency, more = more CPU/GPU overlap
+    float framePacingMs = 0.0f;      // >0: sleep before acquiring so frames start this far apart,
+                                     // sampling input later instead of queueing frames
+    bool parallelRecording = false;  // Render pass recorded via secondary command buffers (recordParallel)
+    bool gpuProfiling = true;        // Timestamp queries for VKCORE_GPU_SCOPE (cheap; off = scopes are no-ops)
+    bool asyncCompute = true;        // Compute prologues go to a compute-only queue family when the device
+                                     // has one and VK_KHR_timeline_semaphore (async_compute.h)
+    uint32_t bindlessTextures = BindlessHeap::DEFAULT_CAPACITY;  // Bindless heap slots (clamped to the
+                                                                  // device limit; 0 = no heap)
     float clearColor[4] = {0.1f, 0.1f, 0.12f, 1.0f};
+    bool headless = false;           // No window/surface/swapchain: renders width x height into
+                                     // offscreen images (benchmarks, CI); init() takes a null window
+    bool headlessReadback = false;   // Headless: copy every frame to host memory for readFrame()
+    float lodPixelError = 1.0f;      // Mesh LODs: max projected simplification error in pixels (0 = always LOD 0)
+    float lodHysteresis = 0.2f;      // Fraction of lodPixelError a switch must clear (stops flicker at thresholds)
+    bool depthPrepass = false;       // Opaque pipelines also get DrawPass::DepthOnly / Shading variants
+    uint32_t maxOcclusionQueries = 0;  // Occlusion query ids per frame (0 = none; see drawMeshOcclusionCulled)
+    float memoryBudgetFraction = 0.9f;  // Evict idle textures/meshes past this share of the device-local
+                                        // budget (VK_EXT_memory_budget; 0 = never evict)
+    uint32_t evictionIdleFrames = 120;  // Unused for this many frames before a resource may be evicted
+    bool textureStreaming = false;      // .ktx2 loads keep only small mips resident; finer ones stream in
+                                        // as shaders report texel density (needs the bindless heap)
+    uint32_t streamingBaseSize = 128;   // Streamed textures start at their first mip no larger than this
+    VkDeviceSize streamingBytesPerFrame = 16ull * 1024 * 1024;  // Upload cap for mips streamed in per frame
+    bool pickBuffer = false;            // Editors: pickable pipelines also draw triangle ids into an R32_UINT
+                                        // attachment in a second subpass (requestPick; needs geometryShader)
+    std::string pickShaderPath = "shaders/pick_id.frag.spv";  // Fragment stage of the pick variants
+    bool frustumCulling = true;         // drawMesh* skips meshes whose bounding sphere is outside the camera
+    bool captureResources = false;      // Keep a CPU copy of every created pipeline, texture and mesh so
+                                        // beginCapture() can write them out (draw_capture.h)
+    bool dynamicResolution = false;     // Scene pass renders offscreen at a scale steered by its GPU time,
+                                        // then is upscaled to the window (dynamic_resolution.h; not with
+                                        // pickBuffer, needs gpuProfiling to adapt)
+    float dynamicResolutionTargetMs = 12.0f;  // Scene GPU time (prologues + scene pass) to aim for
+    float dynamicResolutionMinScale = 0.5f;   // Per axis, of the window size
+    float dynamicResolutionMaxScale = 1.0f;   // Above 1 supersamples when there is headroom (up to 2)
+    float dynamicResolutionGainDown = 0.6f;   // Share of the correction applied per frame over budget
+    float dynamicResolutionGainUp = 0.15f;    // ... and under it
+    float upscaleSharpness = 0.5f;            // 0-1, contrast-adaptive sharpening while below native
+    std::string upscaleVertexShaderPath = "shaders/fullscreen.vert.spv";
+    std::string upscaleFragmentShaderPath = "shaders/upscale.frag.spv";
 };
 
 // ============================================================================
@@ -58,9 +135,28 @@ enum class VertexFormat {
     POSITION_NORMAL_UV,       // vec3 pos, vec3 normal, vec2 uv (meshes)
     POSITION_NORMAL_UV_COLOR, // vec3 pos, vec3 normal, vec2 uv, vec3 color
     POSITION_NORMAL_UV0_UV1,  // vec3 pos, vec3 normal, vec2 uv0, vec2 uv1 (facial DMap)
-    CUSTOM                    // User provides attribute descriptions
+    CUSTOM,                   // User provides attribute descriptions
+    PACKED_POSITION_NORMAL_UV,       // 16 bytes: unorm16 pos, octahedral normal, half uv (vertex_packing.h)
+    PACKED_POSITION_NORMAL_UV0_UV1   // 20 bytes: the same plus half uv1
 };
 
+inline bool isPackedVertexFormat(VertexFormat format) {
+    return format == VertexFormat::PACKED_POSITION_NORMAL_UV || format == VertexFormat::PACKED_POSITION_NORMAL_UV0_UV1;
+}
+
+// The packed format holding the same attributes, or `format` if there is none
+inline VertexFormat packedVertexFormat(VertexFormat format) {
+    if (format == VertexFormat::POSITION_NORMAL_UV) return VertexFormat::PACKED_POSITION_NORMAL_UV;
+    if (format == VertexFormat::POSITION_NORMAL_UV0_UV1) return VertexFormat::PACKED_POSITION_NORMAL_UV0_UV1;
+    return format;
+}
+
+// Vertex shader a pipeline of this format loads for `path`: packed formats
+// use the -DVERTEX_PACKED build (see packedShaderPath)
+inline std::string vertexShaderVariant(const std::string& path, VertexFormat format) {
+    return isPackedVertexFormat(format) ? packedShaderPath(path) : path;
+}
+
 struct VertexAttribute {
     uint32_t location;
     VkFormat format;
@@ -77,7 +173,7 @@ struct VertexLayout {
 // ============================================================================
 
 struct PipelineConfig {
-    std::string vertexShaderPath;
+    std::string vertexShaderPath;  // Packed vertex formats load vertexShaderVariant() of it
     std::string fragmentShaderPath;
     VertexFormat vertexFormat = VertexFormat::POSITION_COLOR;
     VertexLayout customLayout;  // Only used if vertexFormat == CUSTOM
@@ -87,6 +183,22 @@ struct PipelineConfig {
     bool depthTest = true;
     bool depthWrite = true;
     bool alphaBlend = false;
+    bool instanced = false;     // Adds per-instance InstanceData at binding 1 (drawMeshInstanced)
+    bool bindless = false;      // Adds the bindless heap at set BINDLESS_SET and BindlessPushConstants
+    bool pickable = false;      // CoreConfig::pickBuffer: drawMesh also draws ids for requestPick()
+                                // (push constants become PickPushConstants)
+};
+
+// Which variant of a pipeline bindPipeline() and drawMesh*() use. With
+// CoreConfig::depthPrepass, draw the opaque scene once in DepthOnly, then
+// again in Shading: every fragment shader then runs once per pixel.
+// Pipelines without variants (blended, no depth write) stay Default. The
+// vertex shaders of those with variants need `invariant gl_Position;` so
+// EQUAL matches the DepthOnly depths.
+enum class DrawPass {
+    Default,    // Depth LESS + write, full shading
+    DepthOnly,  // No fragment shader or color writes, depth LESS + write
+    Shading     // Depth EQUAL, no depth writes - after a DepthOnly pass
 };
 
 // ============================================================================
@@ -103,6 +215,12 @@ constexpr BufferHandle INVALID_BUFFER = UINT32_MAX;
 constexpr TextureHandle INVALID_TEXTURE = UINT32_MAX;
 constexpr MeshHandle INVALID_MESH = UINT32_MAX;
 
+// addFramePrologue() orders of passes that feed each other. Compute
+// prologues are only ordered among themselves (see addComputePrologue)
+constexpr int PROLOGUE_ORDER_DEFAULT = 0;     // Uploads, DMap composite, GPU culling
+constexpr int PROLOGUE_ORDER_SKINNING = 100;  // GpuSkinning: samples the DMap composite
+constexpr int PROLOGUE_ORDER_SHADOWS = 200;   // LightingManager shadow maps: draw final vertices
+
 // ============================================================================
 // Uniform Buffer Object (standard MVP)
 // ============================================================================
@@ -114,6 +232,54 @@ struct StandardUBO {
     glm::vec4 color;  // Optional object color
 };
 
+// ============================================================================
+// Per-Instance Data (instanced pipelines)
+// ============================================================================
+// Streamed per frame into a vertex buffer at INSTANCE_BINDING. Instanced
+// shaders read the model matrix columns at locations 8-11 and the color at
+// location 12, clear of every VertexFormat's own attributes.
+
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 color;
+};
+
+constexpr uint32_t INSTANCE_BINDING = 1;
+constexpr uint32_t INSTANCE_LOCATION = 8;
+
+inline VkVertexInputBindingDescription getInstanceBindingDescription() {
+    VkVertexInputBindingDescription desc{};
+    desc.binding = INSTANCE_BINDING;
+    desc.stride = sizeof(InstanceData);
+    desc.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    return desc;
+}
+
+inline void appendInstanceAttributes(std::vector<VkVertexInputAttributeDescription>& attrs) {
+    for (uint32_t col = 0; col < 4; col++) {
+        attrs.push_back({INSTANCE_LOCATION + col, INSTANCE_BINDING, VK_FORMAT_R32G32B32A32_SFLOAT,
+                         static_cast<uint32_t>(sizeof(glm::vec4) * col)});            // model[col]
+    }
+    attrs.push_back({INSTANCE_LOCATION + 4, INSTANCE_BINDING, VK_FORMAT_R32G32B32A32_SFLOAT,
+                     static_cast<uint32_t>(offsetof(InstanceData, color))});          // color
+}
+
+// ============================================================================
+// Bindless Textures
+// ============================================================================
+// Every texture also gets a slot in VulkanCore's bindless heap
+// (bindless_heap.h). Pipelines created with PipelineConfig::bindless see the
+// heap at set BINDLESS_SET; drawMesh* pushes the bound texture's slot:
+//
+//   layout(set = 1, binding = 0) uniform sampler2D textures[];
+//   layout(push_constant) uniform Push { uint textureIndex; } push;
+
+constexpr uint32_t BINDLESS_SET = 1;
+
+struct BindlessPushConstants {
+    uint32_t textureIndex;
+};
+
 // ============================================================================
 // Mesh Resource
 // ============================================================================
@@ -121,15 +287,85 @@ struct StandardUBO {
 struct MeshData {
     std::vector<float> vertices;  // Interleaved vertex data
     std::vector<uint32_t> indices;
-    VertexFormat format;
-    uint32_t vertexCount;
-    uint32_t indexCount;
+    VertexFormat format = VertexFormat::POSITION_COLOR;
+    uint32_t vertexCount = 0;     // Also gives the stride for bounds and LODs
+    uint32_t indexCount = 0;
+    std::vector<MeshLod> lods;    // Empty = one level of all indices; else ranges into indices, LOD 0 first
+    VertexQuantization quantization;  // PACKED_* formats: fetched positions back to model space
+};
+
+// Simplified LODs appended to data.indices (position = first 3 floats of
+// each vertex). Needs vertexCount; meshes of a few dozen triangles keep a
+// single level.
+void generateMeshLods(MeshData& data, uint32_t maxLods = DEFAULT_MESH_LODS);
+
+// Rewrites POSITION_NORMAL_UV / POSITION_NORMAL_UV0_UV1 vertices in their
+// packed format (vertices then hold the raw PackedVertex words) and sets
+// data.quantization. Generate LODs first: they need float positions. False,
+// leaving data alone, for any other format or without vertexCount.
+bool packMeshVertices(MeshData& data);
+
+// ============================================================================
+// Frame Stats (CPU side, last completed beginFrame)
+// ============================================================================
+
+// Geometry recorded through drawMesh*/getMeshLod in the last completed frame
+struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint64_t triangles = 0;            // At the selected LODs
+    uint64_t trianglesFullDetail = 0;  // Had every draw used LOD 0
+    uint32_t objectsVisible = 0;       // drawMesh* objects (instances count one each) inside the frustum
+    uint32_t objectsCulled = 0;        // ... and skipped outside it (CoreConfig::frustumCulling)
+};
+
+// Device memory against its budget (see MemoryBudget), and what eviction
+// did about it. Counts are for the last beginFrame() unless marked total.
+struct MemoryStats {
+    VkDeviceSize budget = 0;          // Device-local heaps
+    VkDeviceSize usage = 0;
+    VkDeviceSize target = 0;          // budget * CoreConfig::memoryBudgetFraction
+    VkDeviceSize textureBytes = 0;    // Resident texture images
+    VkDeviceSize meshBytes = 0;       // Mesh vertex/index buffers in device-local memory
+    uint32_t texturesDemoted = 0;     // Living on a low-resolution copy right now
+    uint32_t meshesEvicted = 0;       // Living in host memory right now
+    uint32_t evictions = 0;
+    uint32_t restores = 0;
+    uint64_t totalEvictions = 0;
+    uint64_t totalRestores = 0;
+    bool budgetExtension = false;     // false: budget estimated from heap sizes
+};
+
+// Mip streaming residency (CoreConfig::textureStreaming). Counts are for
+// the last beginFrame() unless marked total.
+struct StreamingStats {
+    uint32_t streamedTextures = 0;    // Textures under streaming control
+    uint32_t fullyResident = 0;       // ... with every mip resident
+    VkDeviceSize residentBytes = 0;   // What they occupy now
+    VkDeviceSize fullBytes = 0;       // What they would occupy fully resident
+    uint32_t pending = 0;             // Want finer mips than they have
+    uint32_t inFlight = 0;            // Uploads recorded but not finished
+    uint32_t streamedIn = 0;
+    uint32_t streamedOut = 0;
+    VkDeviceSize bytesStreamed = 0;   // Uploaded this frame (<= CoreConfig::streamingBytesPerFrame)
+    uint64_t totalStreamedIn = 0;
+    uint64_t totalStreamedOut = 0;
+    uint64_t totalBytesStreamed = 0;
+    bool feedback = false;            // Some shader reported texel density recently
+};
+
+struct FrameTimings {
+    float fenceWaitMs = 0.0f;    // Blocked on the frame's in-flight fence (GPU behind)
+    float pacingSleepMs = 0.0f;  // Slept for CoreConfig::framePacingMs
+    float acquireMs = 0.0f;      // vkAcquireNextImageKHR (presentation engine behind)
+    float frameMs = 0.0f;        // beginFrame to beginFrame
 };
 
 // ============================================================================
 // VULKAN CORE CLASS
 // ============================================================================
 
+class DrawCapture;  // draw_capture.h
+
 class VulkanCore {
 public:
     VulkanCore();
@@ -146,6 +382,7 @@ public:
     bool init(GLFWwindow* window, const CoreConfig& config = CoreConfig());
     void shutdown();
     bool isInitialized() const { return m_initialized; }
+    bool isHeadless() const { return m_config.headless; }
     
     // ========================================================================
     // Frame Management
@@ -154,6 +391,10 @@ public:
     bool beginFrame();  // Returns false if should skip frame (resize, etc)
     void endFrame();
     
+    // Headless + headlessReadback: waits for the last ended frame and
+    // copies it out as tightly packed RGBA8 (sRGB-encoded), row 0 at the top
+    bool readFrame(std::vector<uint8_t>& rgba);
+    
     // ========================================================================
     // Pipeline Management
     // ========================================================================
@@ -162,12 +403,21 @@ public:
     void bindPipeline(PipelineHandle handle);
     void destroyPipeline(PipelineHandle handle);
     
+    // Switches the current pipeline to `pass`'s variant (and rebinds it).
+    // Each parallel task starts in the main thread's pass.
+    void setDrawPass(DrawPass pass);
+    DrawPass getDrawPass() const { return recordContext().pass; }
+    bool hasDepthPrepass(PipelineHandle handle) const {
+        const PipelineResource* pipe = m_pipelines.get(handle);
+        return pipe && pipe->depthOnly != VK_NULL_HANDLE;
+    }
+    
     // ========================================================================
     // Buffer Management
     // ========================================================================
     
-    BufferHandle createVertexBuffer(const void* data, size_t size);
-    BufferHandle createIndexBuffer(const uint32_t* data, size_t count);
+    BufferHandle createVertexBuffer(const void* data, size_t size);      // DEVICE_LOCAL, async upload
+    BufferHandle createIndexBuffer(const uint32_t* data, size_t count);  // DEVICE_LOCAL, async upload
     BufferHandle createUniformBuffer(size_t size);
     void updateUniformBuffer(BufferHandle handle, const void* data, size_t size);
     void destroyBuffer(BufferHandle handle);
@@ -176,35 +426,387 @@ public:
     // Texture Management
     // ========================================================================
     
+    // PNG/JPG etc. via stb_image, or a cooked .ktx2. Cached by canonical
+    // path: loading a file that is already loaded returns the same handle
+    // and takes a reference, which destroyTexture() gives back.
     TextureHandle loadTexture(const std::string& path);
-    TextureHandle createTexture(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels = 4);
-    TextureHandle createTextureLinear(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels = 4);  // Creates texture with linear format (no SRGB) - for DMap textures
+    // loadTexture() for many files at once: images decode on `threads`
+    // workers (0 = hardware concurrency) while finished ones upload, all in
+    // one upload batch. Handles match paths; INVALID_TEXTURE where a file
+    // failed.
+    std::vector<TextureHandle> loadTextures(const std::vector<std::string>& paths, uint32_t threads = 0);
+    // Re-reads a loaded file into the same handle (on a fresh bindless
+    // slot), so every holder sees the new image; the old one is destroyed once
+    // the frames using it retire. false (old image kept) if it fails.
+    bool reloadTexture(const std::string& path);
+    // generateMips: full mip chain via vkCmdBlitImage (falls back to one
+    // level if the format can't be blit-filtered)
+    TextureHandle createTexture(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels = 4,
+                                bool generateMips = true);
+    TextureHandle createTextureLinear(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels = 4,
+                                      bool generateMips = false);  // Creates texture with linear format (no SRGB) - for DMap textures
+    // Pre-encoded levels (BCn etc.) copied as-is; regions index into data.
+    // loadTexture() uses this for .ktx2 files (see supportsBCTextures())
+    TextureHandle createCompressedTexture(VkFormat format, uint32_t width, uint32_t height, uint32_t mipLevels,
+                                          const void* data, size_t size,
+                                          const VkBufferImageCopy* regions, uint32_t regionCount);
     void bindTexture(TextureHandle handle);  // Binds for next draw calls
-    void destroyTexture(TextureHandle handle);
+    void destroyTexture(TextureHandle handle);  // Cached textures: drops one reference
     TextureHandle getDefaultTexture() const { return m_defaultTexture; }
     
     // ========================================================================
     // Mesh Management (high-level)
     // ========================================================================
     
+    // Geometry lives in DEVICE_LOCAL memory and is copied on the transfer
+    // queue; the mesh is skipped by drawMesh until isMeshReady() is true
     MeshHandle createMesh(const MeshData& data);
     MeshHandle createCube(float size = 1.0f, const glm::vec3& color = glm::vec3(1.0f));
     void destroyMesh(MeshHandle handle);
+    bool isMeshReady(MeshHandle handle) const;
+    
+    // A mesh drawing `source`'s indices, LODs and quantization with another
+    // vertex buffer of the same format - per-instance output of GpuSkinning.
+    // The caller keeps ownership of vertexBuffer (destroyMesh() on the view
+    // frees nothing) and destroys views before their source. Using a view
+    // counts as using the source for eviction; views themselves never move.
+    MeshHandle createMeshView(MeshHandle source, BufferHandle vertexBuffer);
+    
+    // Replaces the culling/LOD sphere, for meshes whose vertices move (views
+    // over skinned output)
+    void setMeshBounds(MeshHandle mesh, const glm::vec3& center, float radius);
+    uint32_t getMeshLodCount(MeshHandle handle) const;
+    
+    // Uploads are flushed once per frame in endFrame(); call these to force it
+    void flushUploads() { m_uploads.flush(); }
+    void waitForUploads();
+    
+    // Textures created between these record into one command buffer and go
+    // out as a single submission in endUploadBatch() (nestable, non-blocking).
+    // Outside a batch every texture is its own submission.
+    void beginUploadBatch();
+    UploadBatch::Ticket endUploadBatch();
+    UploadBatch& getUploadBatch() { return m_uploadBatch; }
+    
+    // Raw device buffers for extensions that sub-allocate (GpuScene
+    // megabuffers). data == null leaves the buffer uninitialized (and ready);
+    // uploadToBuffer() queues a transfer-queue copy into part of it.
+    BufferHandle createDeviceLocalBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage);
+    UploadManager::Ticket uploadToBuffer(BufferHandle handle, const void* data, VkDeviceSize size, VkDeviceSize dstOffset);
+    bool isUploadComplete(UploadManager::Ticket ticket) const { return m_uploads.isComplete(ticket); }
+    bool isBufferReady(BufferHandle handle) const;  // Upload (if any) landed
+    VkBuffer getBuffer(BufferHandle handle) const {
+        const BufferResource* buf = m_buffers.get(handle);
+        return buf ? buf->buffer : VK_NULL_HANDLE;
+    }
     
     // Get mesh buffer info for external rendering (e.g., LightingManager)
     bool getMeshBuffers(MeshHandle mesh, VkBuffer& vertexBuffer, VkBuffer& indexBuffer, uint32_t& indexCount) const;
     
+    // Index range of the LOD to draw `mesh` with at `model` (current camera
+    // and viewport), counted in getRenderStats(). External renderers call
+    // this per draw instead of using getMeshBuffers()' indexCount.
+    // The instanced form picks the finest level any of the models needs.
+    bool getMeshLod(MeshHandle mesh, const glm::mat4& model, uint32_t& firstIndex, uint32_t& indexCount);
+    bool getMeshLod(MeshHandle mesh, const glm::mat4* models, uint32_t count,
+                    uint32_t& firstIndex, uint32_t& indexCount);
+    
+    // Object-space bounding sphere of the mesh's vertices (for culling)
+    bool getMeshBounds(MeshHandle mesh, glm::vec3& center, float& radius) const;
+    
+    // Packed meshes: the matrix (MeshData::quantization) their fetched
+    // positions need before the model matrix. drawMesh* apply it; external
+    // renderers draw with model * *getMeshDequantization(). Null for float
+    // vertices.
+    const glm::mat4* getMeshDequantization(MeshHandle mesh) const {
+        const MeshResource* res = m_meshes.get(mesh);
+        return res && res->quantized ? &res->dequantize : nullptr;
+    }
+    
     // Get texture info for external rendering (e.g., LightingManager)
     bool getTextureInfo(TextureHandle tex, VkImageView& view, VkSampler& sampler) const;
     
+    // Bindless heap shared by VulkanCore pipelines, LightingManager and
+    // FacialSystem. getBindlessIndex() maps invalid handles to the default
+    // texture's slot; it returns BindlessHeap::INVALID_INDEX without a heap.
+    bool hasBindlessHeap() const { return m_bindless.isInitialized(); }
+    BindlessHeap& getBindlessHeap() { return m_bindless; }
+    VkDescriptorSetLayout getBindlessSetLayout() const { return m_bindless.getLayout(); }
+    uint32_t getBindlessIndex(TextureHandle tex) const;
+    void bindBindlessHeap(VkPipelineLayout layout, uint32_t setIndex = BINDLESS_SET);  // Into the current command buffer
+    
     // ========================================================================
     // Drawing
     // ========================================================================
     
     void drawMesh(MeshHandle mesh, const glm::mat4& transform, const glm::vec4& color = glm::vec4(1.0f));
+    
+    // One vkCmdDrawIndexed for `count` copies of a mesh. Needs a pipeline
+    // created with PipelineConfig::instanced (see shaders/instanced_*.vert);
+    // other pipelines fall back to drawMesh per instance. colors may be null;
+    // instances past the end of a shorter color vector draw white.
+    void drawMeshInstanced(MeshHandle mesh, const glm::mat4* transforms, const glm::vec4* colors, uint32_t count);
+    void drawMeshInstanced(MeshHandle mesh, const std::vector<glm::mat4>& transforms,
+                           const std::vector<glm::vec4>& colors = {});
+    
+    // Bump-allocates `count` instances from this frame's instance buffer
+    // (for extensions like LightingManager). Bind `buffer` at `offset` to
+    // INSTANCE_BINDING. Returns null if the frame's buffer is full.
+    InstanceData* allocateInstances(uint32_t count, VkBuffer& buffer, VkDeviceSize& offset);
+    
+    // Indexed indirect draw for GPU-driven callers (GpuScene). Binds the
+    // current frame's view/projection UBO, vertexBuffer at binding 0,
+    // instanceBuffer at INSTANCE_BINDING and indexBuffer, then draws
+    // maxDraws VkDrawIndexedIndirectCommands from indirectBuffer - or only
+    // the first *countBuffer of them when countBuffer is set and
+    // supportsDrawIndirectCount(). Needs an instanced pipeline bound.
+    void drawIndexedIndirect(VkBuffer vertexBuffer, VkBuffer indexBuffer, VkBuffer instanceBuffer,
+                             VkBuffer indirectBuffer, uint32_t maxDraws,
+                             VkBuffer countBuffer = VK_NULL_HANDLE);
+    
+    // Split form of drawMesh for callers that track their own bind state
+    // (RenderQueue): bindMeshBuffers() once per run of draws of the same mesh,
+    // then drawBoundMesh*() per draw. Returns false if the mesh isn't ready.
+    bool bindMeshBuffers(MeshHandle mesh);
+    void drawBoundMesh(MeshHandle mesh, const glm::mat4& transform, const glm::vec4& color);
+    void drawBoundMeshInstanced(MeshHandle mesh, const glm::mat4* transforms, const glm::vec4* colors, uint32_t count);
+    bool isPipelineInstanced(PipelineHandle handle) const {
+        const PipelineResource* pipe = m_pipelines.get(handle);
+        return pipe && pipe->instanced;
+    }
+    PipelineHandle getCurrentPipeline() const { return recordContext().pipeline; }
+    TextureHandle getCurrentTexture() const { return m_currentTexture; }
+    
     void drawVertices(BufferHandle vertexBuffer, uint32_t vertexCount);
     void drawIndexed(BufferHandle vertexBuffer, BufferHandle indexBuffer, uint32_t indexCount);
     
+    // ========================================================================
+    // Occlusion Culling (CoreConfig::maxOcclusionQueries)
+    // ========================================================================
+    // queryId is the caller's stable id for an object, in
+    // [0, maxOcclusionQueries). Results are framesInFlight frames old;
+    // objects never queried count as visible.
+    //
+    // drawMeshOcclusionCulled() draws the mesh inside a query while it was
+    // visible; while occluded it only draws the mesh's coarsest LOD with the
+    // pipeline's depth-test-only variant, inside a query, to notice when it
+    // comes back. Returns whether the mesh itself was drawn. In a DepthOnly
+    // pass occluded meshes are skipped and nothing is queried.
+    bool drawMeshOcclusionCulled(MeshHandle mesh, const glm::mat4& transform, uint32_t queryId,
+                                 const glm::vec4& color = glm::vec4(1.0f));
+    bool isOccluded(uint32_t queryId) const { return !m_occlusion.isVisible(queryId); }
+    uint32_t getOccludedCount() const { return m_occlusion.getOccludedCount(); }
+    
+    // For external renderers: wrap a draw in the current command buffer.
+    // Returns OcclusionQueries::NO_QUERY if it can't be queried.
+    uint32_t beginOcclusionQuery(uint32_t queryId);
+    void endOcclusionQuery(uint32_t query);
+    
+    // ========================================================================
+    // Picking (CoreConfig::pickBuffer)
+    // ========================================================================
+    // drawMesh() with a PipelineConfig::pickable pipeline bound also records
+    // the draw for the pick subpass, where its pick variant writes one id
+    // per triangle (pick_buffer.h). requestPick() reads the ids around a
+    // pixel from the frame being recorded; getPickResult() returns it once
+    // the GPU finished that frame, normally at the next beginFrame(). No
+    // CPU copy of the meshes is involved, so GPU-side edits pick as drawn.
+    // Instanced and indirect draws are not pickable.
+    
+    bool hasPickBuffer() const { return m_pick.isEnabled(); }
+    // Following draws report objectId in PickResult (per recording context)
+    void setPickObject(uint32_t objectId) { recordContext().pickObject = objectId; }
+    // Window pixel (top-left origin); radius > 0 takes the hit nearest (x, y)
+    // within the (2 * radius + 1)-pixel square, for thin or small objects
+    void requestPick(int32_t x, int32_t y, uint32_t radius = 0) { m_pick.request(x, y, radius); }
+    // Newest pick that came back since the last call (false while none did)
+    bool getPickResult(PickResult& result) { return m_pick.takeResult(result); }
+    
+    // ========================================================================
+    // Dynamic Resolution (CoreConfig::dynamicResolution)
+    // ========================================================================
+    // beginFrame() opens the scene pass on an offscreen target at
+    // getRenderWidth() x getRenderHeight(), rescaled every frame so the
+    // scene's GPU time tracks dynamicResolutionTargetMs. beginUiPass() ends
+    // it, upscales it over the window and continues in a pass at native
+    // resolution (with a cleared depth buffer) for UI: renderImGui() calls
+    // it, other overlays call it before drawing. endFrame() calls it if
+    // nobody did. Pipelines from getRenderPass() draw in both passes.
+    // Without dynamicResolution beginUiPass() does nothing and the render
+    // size is the window size.
+    
+    bool hasDynamicResolution() const { return m_dynamicRes.isEnabled(); }
+    void beginUiPass();
+    uint32_t getRenderWidth() const { return sceneExtent().width; }
+    uint32_t getRenderHeight() const { return sceneExtent().height; }
+    float getRenderScale() const { return m_dynamicRes.isEnabled() ? m_dynamicRes.getScale() : 1.0f; }
+    
+    // ========================================================================
+    // Parallel Recording (needs CoreConfig::parallelRecording)
+    // ========================================================================
+    // Runs record(task) for every task in [0, taskCount) across the worker
+    // threads (and the calling thread), each task into its own secondary
+    // command buffer. Buffers execute in task order, after everything the
+    // main thread recorded before this call. Blocks until all tasks finish.
+    //
+    // Inside a task getCurrentCommandBuffer() returns that task's buffer, so
+    // drawMesh*, LightingManager and FacialSystem record unchanged. Each task
+    // starts with the main thread's pipeline bound. Don't create/destroy
+    // resources or call bindTexture() from a task.
+    //
+    // Without parallelRecording the tasks run serially on the calling thread.
+    void recordParallel(uint32_t taskCount, const std::function<void(uint32_t task)>& record);
+    
+    uint32_t getRecordingThreadCount() const { return static_cast<uint32_t>(m_recordWorkers.size()) + 1; }
+    
+    // Slot 0 = main thread, 1..N = worker threads. Lets extensions keep
+    // per-thread bind state (see LightingManager::bindTexture)
+    uint32_t getRecordingSlot() const { return recordContext().slot; }
+    uint32_t getRecordingSlotCount() const { return getRecordingThreadCount(); }
+    bool isRecordingTask() const { return t_recordContext != nullptr && t_recordContext->owner == this; }
+    
+    // ========================================================================
+    // GPU Profiling (CoreConfig::gpuProfiling)
+    // ========================================================================
+    // Prefer the VKCORE_GPU_SCOPE("name") macro. Scopes record into
+    // getCurrentCommandBuffer(), so they also work inside recordParallel
+    // tasks. beginFrame() opens a "frame" scope around the whole frame.
+    
+    uint32_t beginGpuScope(const char* name);  // name: string literal
+    void endGpuScope(uint32_t scope);
+    
+    // Timings resolve getFramesInFlight() frames late (no GPU stalls)
+    const std::vector<GpuProfiler::Timing>& getGpuTimings() const { return m_gpuProfiler.getTimings(); }
+    bool exportGpuTrace(const std::string& path) const { return m_gpuProfiler.exportChromeTrace(path); }
+    GpuProfiler& getGpuProfiler() { return m_gpuProfiler; }
+    
+    // GPU timings window drawn by renderImGui()
+    void setGpuProfilerVisible(bool visible) { m_showGpuProfiler = visible; }
+    
+    // ========================================================================
+    // Draw Capture (CoreConfig::captureResources)
+    // ========================================================================
+    // Records the next `frames` frames' camera, binds and drawMesh* calls,
+    // plus the commands of modules that capture themselves, and writes them
+    // with every live pipeline, texture and mesh to `path` at the end of
+    // the last one. vulkan/tools/draw_replay re-runs the file headless.
+    // false if resources aren't retained or a capture is already armed.
+    bool beginCapture(const std::string& path, uint32_t frames = 1);
+    bool isCapturing() const;
+    // Non-null while resources are retained; modules add their commands
+    // when isRecording() (see draw_capture.h)
+    DrawCapture* getDrawCapture() const { return m_drawCapture.get(); }
+    
+    // ========================================================================
+    // Memory Budget (CoreConfig::memoryBudgetFraction)
+    // ========================================================================
+    // beginFrame() compares device-local usage with the driver's budget.
+    // Over the target it first calls the pressure callback (free what you
+    // can; `excess` is how far over it is), then evicts what has not been
+    // drawn for CoreConfig::evictionIdleFrames, least recently used first:
+    //   - loadTexture() textures drop to a low-resolution copy of their
+    //     smallest mips; drawing one again re-reads its file
+    //   - meshes move to host memory, where they stay drawable (slower);
+    //     drawing one again moves it back
+    // Restores happen a few per frame while usage is under the target.
+    // Textures handed out through getTextureInfo() are never demoted.
+    
+    const MemoryStats& getMemoryStats() const { return m_memoryStats; }
+    const MemoryBudget& getMemoryBudget() const { return m_memoryBudget; }
+    void setMemoryPressureCallback(std::function<void(VkDeviceSize excess)> callback) {
+        m_memoryPressureCallback = std::move(callback);
+    }
+    // Marks a texture used this frame without binding it (e.g. one sampled
+    // through a descriptor set of your own)
+    void touchTexture(TextureHandle handle);
+    // GPU memory window drawn by renderImGui()
+    void setMemoryBudgetVisible(bool visible) { m_showMemoryBudget = visible; }
+    
+    // ========================================================================
+    // Texture Streaming (CoreConfig::textureStreaming)
+    // ========================================================================
+    // loadTexture() on a mipped .ktx2 uploads only the mips from
+    // CoreConfig::streamingBaseSize down. Shaders that sample the bindless
+    // heap report texel density (texture_streamer.h; lit_mesh.frag does),
+    // and beginFrame() streams finer mips in - re-read from the file, up to
+    // streamingBytesPerFrame - or drops them again once nothing has needed
+    // them for a while. Streamed textures are left alone by eviction; under
+    // memory pressure nothing streams in and idle ones drop to their base.
+    // With no shader reporting at all, drawn textures stream to full size.
+    
+    bool isTextureStreaming() const { return m_streamer.isInitialized(); }
+    const StreamingStats& getStreamingStats() const { return m_streamingStats; }
+    
+    // Core the VKCORE_GPU_SCOPE macro records into (the last one initialized)
+    static VulkanCore* getActive() { return s_active; }
+    
+    // ========================================================================
+    // Frame Prologue (work that must run outside the render pass)
+    // ========================================================================
+    // Callbacks run every beginFrame() on the frame's primary command buffer
+    // before the render pass begins - compute passes such as GpuScene
+    // culling. Lower `order` runs first (PROLOGUE_ORDER_*), equal orders in
+    // registration order, so a pass reading another's output needn't be
+    // registered after it. The camera set before beginFrame() is current.
+    
+    uint32_t addFramePrologue(std::function<void(VkCommandBuffer cmd)> prologue,
+                              int order = PROLOGUE_ORDER_DEFAULT);
+    
+    // A prologue that records compute dispatches only. With async compute
+    // all of them go, in order, into one batch on the compute queue, which
+    // this frame's graphics work waits for at consumerStages - the stages
+    // that read the results (e.g. DRAW_INDIRECT for culled draws). Without
+    // it they run as ordinary prologues. Barriers inside may only use
+    // compute-queue stages (compute, transfer, draw indirect), and
+    // resources the graphics queue also touches must come from
+    // createSharedBuffer / createSharedImage.
+    // perFrameOutputs: everything written is per frame in flight, so the
+    // batch may overlap the previous frame. Otherwise (state carried across
+    // frames, like particles) the batch first waits for the previous frame.
+    uint32_t addComputePrologue(std::function<void(VkCommandBuffer cmd)> prologue,
+                                VkPipelineStageFlags consumerStages, bool perFrameOutputs,
+                                int order = PROLOGUE_ORDER_DEFAULT);
+    void removeFramePrologue(uint32_t id);  // Either kind
+    
+    // Runs destroy once the frames in flight now have retired (at the
+    // latest in shutdown()) - for Vulkan objects owned outside VulkanCore
+    // that recorded frames may still use. Release them before shutdown().
+    void deferDestroy(std::function<void()> destroy);
+    
+    // ========================================================================
+    // Async Compute (CoreConfig::asyncCompute)
+    // ========================================================================
+    // Compute prologues cover per-frame work; these are for batches of
+    // your own. Without async compute submitCompute() returns NO_WORK and
+    // does nothing - record into a prologue instead.
+    
+    bool hasAsyncCompute() const { return m_asyncCompute.isEnabled(); }
+    uint32_t getComputeFamily() const { return m_computeFamily; }  // == graphics family without a dedicated one
+    VkQueue getComputeQueue() const { return m_computeQueue; }
+    
+    // Submits one batch to the compute queue, after graphics frame
+    // afterFrame finished (0 = right away). Returns its timeline value.
+    uint64_t submitCompute(const std::function<void(VkCommandBuffer cmd)>& record, uint64_t afterFrame = 0);
+    // The frame being recorded waits for value at stages (call between
+    // beginFrame and endFrame). Only waited-for batches are covered by
+    // deferDestroy() retirement.
+    void waitForCompute(uint64_t value, VkPipelineStageFlags stages);
+    bool isComputeComplete(uint64_t value) const { return m_asyncCompute.isComplete(value); }
+    
+    // Device-local buffer / image shared CONCURRENT by the graphics and
+    // compute families (EXCLUSIVE when they are the same) - for resources
+    // compute prologues write and graphics reads
+    bool createSharedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                            VkBuffer& buffer, GpuAllocation& alloc);
+    bool createSharedImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+                           VkImage& image, GpuAllocation& alloc);
+    
+    // Device capabilities for indirect drawing (enabled when present)
+    bool supportsMultiDrawIndirect() const { return m_multiDrawIndirect; }
+    bool supportsIndirectFirstInstance() const { return m_indirectFirstInstance; }
+    bool supportsDrawIndirectCount() const { return m_cmdDrawIndexedIndirectCount != nullptr; }
+    bool supportsBCTextures() const { return m_textureCompressionBC; }  // textureCompressionBC enabled
+    
     // ========================================================================
     // Camera / View
     // ========================================================================
@@ -217,6 +819,13 @@ public:
     const glm::mat4& getViewMatrix() const { return m_viewMatrix; }
     const glm::mat4& getProjectionMatrix() const { return m_projMatrix; }
     
+    // Planes of projection * view, kept current by the setters above. The
+    // drawMesh* calls test bounding spheres against it (CoreConfig::
+    // frustumCulling); Scene / GameEngine cull whole object lists with it
+    // through a CullList.
+    const Frustum& getFrustum() const { return m_frustum; }
+    bool isMeshInFrustum(MeshHandle mesh, const glm::mat4& transform) const;
+    
     // ========================================================================
     // Accessors (for advanced use / extension)
     // ========================================================================
@@ -224,10 +833,13 @@ public:
     VkDevice getDevice() const { return m_device; }
     VkPhysicalDevice getPhysicalDevice() const { return m_physicalDevice; }
     VkRenderPass getRenderPass() const { return m_renderPass; }
-    VkCommandBuffer getCurrentCommandBuffer() const { return m_commandBuffers[m_currentFrame]; }
+    VkCommandBuffer getCurrentCommandBuffer() const { return recordContext().cmd; }  // Per-thread inside recordParallel
     VkDescriptorSetLayout getDescriptorSetLayout() const { return m_descriptorSetLayout; }
-    VkDescriptorPool getDescriptorPool() const { return m_descriptorPool; }
+    DescriptorAllocator& getDescriptorAllocator() { return m_descriptors; }  // Growable pools, shared by the subsystems
+    GpuAllocator& getAllocator() { return m_allocator; }  // Shared device memory sub-allocator
+    VkPipelineCache getPipelineCache() const { return m_pipelineCache.get(); }  // Pass to every vkCreate*Pipelines
     
+    // Window (swapchain) size; the scene may render smaller (getRenderWidth)
     uint32_t getWidth() const { return m_swapchainExtent.width; }
     
     // Background color
@@ -238,11 +850,24 @@ public:
         m_config.clearColor[3] = a;
     }
     uint32_t getHeight() const { return m_swapchainExtent.height; }
+    uint32_t getFramesInFlight() const { return m_framesInFlight; }
+    uint32_t getCurrentFrame() const { return m_currentFrame; }  // Index into per-frame-in-flight resources
+    uint64_t getFrameNumber() const { return m_frameNumber; }    // Frames begun; changes once per beginFrame()
+    uint32_t getVertexStride(VertexFormat format) { return getBindingDescription(format).stride; }
+    
+    // Binding 0 and its attributes for a pipeline of this format (external
+    // pipelines, e.g. LightingManager, use these to match createPipeline)
+    VkVertexInputBindingDescription getBindingDescription(VertexFormat format);
+    std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(VertexFormat format);
+    VkPresentModeKHR getPresentMode() const { return m_presentMode; }
+    const FrameTimings& getFrameTimings() const { return m_frameTimings; }
+    const RenderStats& getRenderStats() const { return m_renderStats; }
     float getAspectRatio() const { return (float)m_swapchainExtent.width / (float)m_swapchainExtent.height; }
     
     // Queue access for extensions (ImGui, etc)
     VkQueue getGraphicsQueue() const { return m_graphicsQueue; }
     uint32_t getGraphicsFamily() const { return m_graphicsFamily; }
+    uint32_t getTransferFamily() const { return m_transferFamily; }
     VkCommandPool getCommandPool() const { return m_commandPool; }
     VkInstance getInstance() const { return m_instance; }
     uint32_t getImageCount() const { return static_cast<uint32_t>(m_swapchainImages.size()); }
@@ -278,24 +903,75 @@ private:
     bool createCommandBuffers();
     bool createSyncObjects();
     bool createDefaultResources();
+    bool createUniformRings();
+    void destroyUniformRings();
+    bool createInstanceRings();
+    void destroyInstanceRings();
+    bool createRecordWorkers();
+    void destroyRecordWorkers();
+    VkPresentModeKHR choosePresentMode() const;
     
     void cleanupSwapchain();
     void recreateSwapchain();
+    bool createOffscreenTargets();  // Headless stand-in for the swapchain images
+    void initPickBuffer(bool primitiveIds);  // Non-fatal: without it there is no pick subpass
+    void initDynamicResolution();  // Non-fatal: without it the scene renders at window size
+    void recordReadback(VkCommandBuffer cmd);
     
     // ========================================================================
     // Helpers
     // ========================================================================
     
+    struct PipelineResource;
+    struct TextureResource;
+    
     VkShaderModule createShaderModule(const std::vector<char>& code);
     std::vector<char> readShaderFile(const std::string& path);
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-    VkCommandBuffer beginSingleTimeCommands();
-    void endSingleTimeCommands(VkCommandBuffer cmd);
     bool createBufferInternal(VkDeviceSize size, VkBufferUsageFlags usage,
                               VkMemoryPropertyFlags properties,
-                              VkBuffer& buffer, VkDeviceMemory& memory);
-    VkVertexInputBindingDescription getBindingDescription(VertexFormat format);
-    std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(VertexFormat format);
+                              VkBuffer& buffer, GpuAllocation& alloc);
+    TextureHandle createTextureInternal(const uint8_t* pixels, uint32_t width, uint32_t height, VkFormat format,
+                                        bool generateMips);
+    TextureHandle loadTextureFile(const std::string& path);  // Uncached
+    TextureHandle loadTextureKTX2(const std::string& path);
+    // Image for file levels [baseMip, mipLevels) of a packed chain, uploaded
+    // as stored; mipOffsets index into data
+    bool createTextureLevels(TextureResource& tex, VkFormat format, uint32_t width, uint32_t height,
+                             uint32_t mipLevels, const uint8_t* data, size_t size,
+                             const std::vector<uint32_t>& mipOffsets, uint32_t baseMip);
+    bool copyTextureMips(const TextureResource& tex, uint32_t srcBaseMip, TextureResource& low);  // Into the open batch
+    bool createTextureImage(TextureResource& tex, VkFormat format, VkImageUsageFlags usage);  // Image, view, sampler
+    TextureHandle registerTexture(TextureResource& tex);
+    void writeRingTexture(uint32_t frameIndex, TextureHandle texture);
+    void replaceTexture(TextureHandle handle, TextureResource& replacement);  // Same handle, fresh bindless slot
+    bool createDeviceBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, GpuAllocation& alloc);
+    void enforceMemoryBudget();
+    bool demoteTexture(TextureHandle handle);
+    bool restoreTexture(TextureHandle handle);
+    bool moveMeshBuffers(MeshHandle handle, bool toHost);
+    void updateTextureStreaming();
+    bool streamTextureIn(TextureHandle handle, uint32_t baseMip);
+    bool streamTextureOut(TextureHandle handle, uint32_t baseMip);
+    void recordPipelineBind(VkCommandBuffer cmd, PipelineHandle handle, DrawPass pass);
+    static VkPipeline passPipeline(const PipelineResource& pipe, DrawPass pass);
+    void destroyPipelineVariants(PipelineResource& pipe);
+    bool occlusionTestable(MeshHandle mesh, const glm::mat4& transform) const;
+    void drawOcclusionProxy(MeshHandle mesh, const glm::mat4& transform);
+    const MeshLod& selectMeshLod(MeshHandle mesh, const glm::mat4* transforms, uint32_t count);
+    void pushBindlessIndex(VkCommandBuffer cmd, PipelineHandle pipeline, uint32_t textureIndex);
+    VkCommandBuffer acquireSecondary(uint32_t slot);
+    VkExtent2D sceneExtent() const { return m_dynamicRes.isEnabled() ? m_dynamicRes.getRenderExtent() : m_swapchainExtent; }
+    VkFramebuffer sceneFramebuffer() const {
+        return m_dynamicRes.isEnabled() ? m_dynamicRes.getFramebuffer() : m_framebuffers[m_imageIndex];
+    }
+    void beginSecondary(VkCommandBuffer cmd);
+    void openMainSegment();
+    void closeMainSegment();
+    void runRecordTasks(uint32_t slot);
+    void workerLoop(uint32_t slot);
+    bool allocateObjectSlot(const glm::mat4& model, const glm::vec4& color, uint32_t& dynamicOffset);
+    glm::mat4 meshModel(MeshHandle mesh, const glm::mat4& transform) const;
     
     // ========================================================================
     // Vulkan Objects
@@ -307,6 +983,8 @@ private:
     VkDevice m_device = VK_NULL_HANDLE;
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
+    VkQueue m_transferQueue = VK_NULL_HANDLE;  // == m_graphicsQueue without a dedicated family
+    VkQueue m_computeQueue = VK_NULL_HANDLE;   // == m_graphicsQueue without a dedicated family
     
     VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
     std::vector<VkImage> m_swapchainImages;
@@ -314,21 +992,40 @@ private:
     VkFormat m_swapchainFormat;
     VkExtent2D m_swapchainExtent;
     
+    // Headless: m_swapchainImages are these (one per frame in flight), plus
+    // optional per-frame host-visible readback buffers
+    std::vector<GpuAllocation> m_offscreenAllocs;
+    std::vector<VkBuffer> m_readbackBuffers;
+    std::vector<GpuAllocation> m_readbackAllocs;
+    int32_t m_lastReadbackFrame = -1;  // Frame slot holding the newest readback
+    
     VkRenderPass m_renderPass = VK_NULL_HANDLE;
-    std::vector<VkFramebuffer> m_framebuffers;
+    std::vector<VkFramebuffer> m_framebuffers;  // Per swapchain image (the UI pass's with dynamic resolution)
+    VkRenderPass m_uiRenderPass = VK_NULL_HANDLE;  // Dynamic resolution: compatible pass on the swapchain image
     
     VkImage m_depthImage = VK_NULL_HANDLE;
-    VkDeviceMemory m_depthImageMemory = VK_NULL_HANDLE;
+    GpuAllocation m_depthImageAlloc;
     VkImageView m_depthImageView = VK_NULL_HANDLE;
     
     VkCommandPool m_commandPool = VK_NULL_HANDLE;
     std::vector<VkCommandBuffer> m_commandBuffers;
+    std::vector<VkCommandBuffer> m_uiCommandBuffers;  // Dynamic resolution: UI pass, its own submit batch
     
     VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
-    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    DescriptorAllocator m_descriptors;
     
-    // Sync objects
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+    // Sync objects (m_framesInFlight of each, from CoreConfig::framesInFlight)
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+    uint32_t m_framesInFlight = 2;
+    VkPresentModeKHR m_presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    FrameTimings m_frameTimings;
+    RenderStats m_renderStats;
+    std::atomic<uint32_t> m_statDrawCalls{0};  // Accumulated while recording (tasks too)
+    std::atomic<uint64_t> m_statTriangles{0};
+    std::atomic<uint64_t> m_statTrianglesFull{0};
+    std::atomic<uint32_t> m_statObjectsVisible{0};
+    std::atomic<uint32_t> m_statObjectsCulled{0};
+    std::chrono::steady_clock::time_point m_lastFrameStart;
     std::vector<VkSemaphore> m_imageAvailableSemaphores;
     std::vector<VkSemaphore> m_renderFinishedSemaphores;
     std::vector<VkFence> m_inFlightFences;
@@ -337,6 +1034,82 @@ private:
     
     uint32_t m_graphicsFamily = 0;
     uint32_t m_presentFamily = 0;
+    uint32_t m_transferFamily = 0;
+    uint32_t m_computeFamily = 0;
+    
+    // All device memory goes through here (one vkAllocateMemory per block)
+    GpuAllocator m_allocator;
+    
+    // Batched staging copies into device-local buffers (transfer queue)
+    UploadManager m_uploads;
+    
+    // Texture copies + mip blits, one graphics-queue submit per batch
+    UploadBatch m_uploadBatch;
+    
+    // Driver pipeline cache, persisted per device/driver (pipeline_cache_<uuid>.bin)
+    PipelineCache m_pipelineCache;
+    
+    // Frame prologues, sorted by order, and indirect-draw capabilities
+    struct FramePrologue {
+        uint32_t id;
+        int order;
+        std::function<void(VkCommandBuffer)> run;
+        bool compute = false;                  // addComputePrologue
+        VkPipelineStageFlags consumers = 0;    // Compute: graphics stages reading the results
+        bool perFrame = true;                  // Compute: may overlap the previous frame
+    };
+    uint32_t insertPrologue(FramePrologue prologue);
+    void runComputePrologues();
+    std::vector<FramePrologue> m_framePrologues;
+    uint32_t m_nextPrologueId = 1;
+    bool m_multiDrawIndirect = false;
+    bool m_textureCompressionBC = false;
+    bool m_indirectFirstInstance = false;
+    uint32_t m_maxDrawIndirectCount = 1;
+    PFN_vkCmdDrawIndexedIndirectCountKHR m_cmdDrawIndexedIndirectCount = nullptr;
+    
+    // One descriptor array for all textures (set BINDLESS_SET)
+    BindlessHeap m_bindless;
+    
+    // Compute-queue batches; the frame being recorded waits for
+    // m_computeWaitValue at m_computeWaitStages
+    AsyncCompute m_asyncCompute;
+    uint64_t m_computeWaitValue = AsyncCompute::NO_WORK;
+    VkPipelineStageFlags m_computeWaitStages = 0;
+    
+    // Timestamp queries, one range per frame in flight
+    GpuProfiler m_gpuProfiler;
+    uint32_t m_frameGpuScope = GpuProfiler::NO_SCOPE;
+    
+    // Occlusion queries, one range per frame in flight
+    OcclusionQueries m_occlusion;
+    
+    // CoreConfig::captureResources: retained resources + the armed capture
+    std::unique_ptr<DrawCapture> m_drawCapture;
+    bool m_showGpuProfiler = false;
+    
+    // Pick subpass target, readback ring and this frame's pickable draws
+    PickBuffer m_pick;
+    VkShaderModule m_pickShader = VK_NULL_HANDLE;  // pick_id.frag, shared by the pick variants
+    
+    // Offscreen scene target, its scale controller and the upscale pass
+    DynamicResolution m_dynamicRes;
+    uint32_t m_sceneGpuScope = GpuProfiler::NO_SCOPE;
+    bool m_uiPassStarted = false;  // This frame's scene pass has ended (beginUiPass)
+    
+    // Device memory budget and LRU eviction (enforceMemoryBudget)
+    MemoryBudget m_memoryBudget;
+    MemoryStats m_memoryStats;
+    std::function<void(VkDeviceSize)> m_memoryPressureCallback;
+    uint64_t m_evictionCooldownUntil = 0;  // Frees from the last round land framesInFlight frames later
+    bool m_hostMeshMemory = true;          // false: host memory is DEVICE_LOCAL too (UMA), nothing to gain
+    bool m_showMemoryBudget = false;
+    
+    // Mip streaming from texel density feedback (updateTextureStreaming)
+    TextureStreamer m_streamer;
+    StreamingStats m_streamingStats;
+    uint64_t m_lastFeedbackFrame = 0;      // Last frame any slot reported a density
+    static VulkanCore* s_active;
     
     // ========================================================================
     // Resource Storage
@@ -345,50 +1118,172 @@ private:
     struct PipelineResource {
         VkPipeline pipeline = VK_NULL_HANDLE;
         VkPipelineLayout layout = VK_NULL_HANDLE;
-        bool valid = false;
+        bool instanced = false;
+        bool bindless = false;
+        VkPipeline depthOnly = VK_NULL_HANDLE;       // DrawPass variants (CoreConfig::depthPrepass)
+        VkPipeline shading = VK_NULL_HANDLE;
+        VkPipeline occlusionProxy = VK_NULL_HANDLE;  // Depth test only (CoreConfig::maxOcclusionQueries)
+        VkPipeline pickId = VK_NULL_HANDLE;          // Pick subpass, writes ids (PipelineConfig::pickable)
     };
     
     struct BufferResource {
         VkBuffer buffer = VK_NULL_HANDLE;
-        VkDeviceMemory memory = VK_NULL_HANDLE;
+        GpuAllocation alloc;
         VkDeviceSize size = 0;
-        bool valid = false;
+        UploadManager::Ticket uploadTicket = UploadManager::NO_UPLOAD;  // Contents valid once complete
+        VkBufferUsageFlags usage = 0;
     };
     
     struct MeshResource {
         BufferHandle vertexBuffer = INVALID_BUFFER;
         BufferHandle indexBuffer = INVALID_BUFFER;
-        uint32_t indexCount = 0;
-        bool valid = false;
+        uint32_t indexCount = 0;     // LOD 0
+        std::vector<MeshLod> lods;   // Always at least LOD 0
+        LodBounds bounds;
+        uint32_t currentLod = 0;     // Hysteresis state: last frame's level, so every draw
+        uint32_t pendingLod = 0;     // of a frame (and both prepass passes) agrees
+        uint64_t lodFrame = 0;       // Frame pendingLod was picked in
+        UseStamp lastUsed;
+        uint64_t evictedFrame = 0;   // Buffers in host memory since then (0 = device-local)
+        bool quantized = false;      // Packed format: positions need dequantize
+        glm::mat4 dequantize = glm::mat4(1.0f);
+        MeshHandle viewOf = INVALID_MESH;  // createMeshView(): buffers not owned
     };
     
     struct TextureResource {
         VkImage image = VK_NULL_HANDLE;
-        VkDeviceMemory memory = VK_NULL_HANDLE;
+        GpuAllocation alloc;
         VkImageView view = VK_NULL_HANDLE;
         VkSampler sampler = VK_NULL_HANDLE;
-        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        uint32_t bindlessIndex = BindlessHeap::INVALID_INDEX;
         uint32_t width = 0;
         uint32_t height = 0;
-        bool valid = false;
+        uint32_t mipLevels = 1;
+        UploadBatch::Ticket uploadTicket = UploadBatch::NO_UPLOAD;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        UseStamp lastUsed;
+        uint64_t demotedFrame = 0;         // Low-resolution copy since then (0 = full image)
+        VkDeviceSize fullBytes = 0;        // Demoted: size of the full image (0 = can't restore)
+        mutable bool pinned = false;       // View handed out by getTextureInfo(): never demoted
+        // Streamed (.ktx2 with CoreConfig::textureStreaming): the file has
+        // streamLevels mips from streamWidth x streamHeight, the image holds
+        // them from residentBase on
+        uint32_t streamLevels = 0;         // 0 = not streamed
+        uint32_t streamWidth = 0;
+        uint32_t streamHeight = 0;
+        uint32_t streamStartBase = 0;      // Where it started, and drops back to
+        uint32_t residentBase = 0;
+        uint32_t wantedBase = 0;           // From feedback, with hysteresis
+        uint64_t wantedFrame = 0;          // Last frame wantedBase was asked for
+        VkDeviceSize streamFullBytes = 0;  // Every level resident
     };
     
-    std::vector<PipelineResource> m_pipelines;
-    std::vector<BufferResource> m_buffers;
-    std::vector<MeshResource> m_meshes;
-    std::vector<TextureResource> m_textures;
+    // Generational handles: destroyed slots are reused and stale handles
+    // rejected. Vulkan objects are destroyed via m_deletions once the
+    // frames that may still use them have retired.
+    HandlePool<PipelineResource> m_pipelines;
+    HandlePool<BufferResource> m_buffers;
+    HandlePool<MeshResource> m_meshes;
+    HandlePool<TextureResource> m_textures;
+    DeletionQueue m_deletions;
+    uint64_t m_frameNumber = 0;  // Frames begun; tags deferred destroys
     TextureHandle m_defaultTexture = INVALID_TEXTURE;
     TextureHandle m_currentTexture = INVALID_TEXTURE;
     
-    // Current bound pipeline
-    PipelineHandle m_currentPipeline = INVALID_PIPELINE;
+    // loadTexture() cache: canonical path -> handle and reference count
+    struct CachedTexture {
+        TextureHandle handle = INVALID_TEXTURE;
+        uint32_t refs = 0;
+        std::string path;  // As passed to loadTexture() (archive lookups want it relative)
+    };
+    std::unordered_map<std::string, CachedTexture> m_textureCache;
+    std::unordered_map<TextureHandle, std::string> m_textureCachePaths;
+    
+    // Where draws are recorded right now: the frame's primary buffer, or
+    // (parallelRecording) a secondary. Worker threads point t_recordContext
+    // at their own context while running a recordParallel task.
+    struct RecordContext {
+        const VulkanCore* owner = nullptr;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        PipelineHandle pipeline = INVALID_PIPELINE;  // Current bound pipeline
+        uint32_t textureIndex = 0;                   // Bindless slot pushed by drawMesh*
+        TextureHandle texture = INVALID_TEXTURE;     // Its texture (draw captures)
+        DrawPass pass = DrawPass::Default;
+        uint32_t slot = 0;
+        uint32_t pickObject = 0;                     // setPickObject()
+    };
+    
+    RecordContext m_mainContext;
+    static thread_local RecordContext* t_recordContext;
+    
+    RecordContext& recordContext() { return isRecordingTask() ? *t_recordContext : m_mainContext; }
+    const RecordContext& recordContext() const { return isRecordingTask() ? *t_recordContext : m_mainContext; }
+    
+    // One per recording thread (slot 0 = main). Command pools are externally
+    // synchronized, so each thread allocates its secondaries from its own
+    // pool per frame in flight; pools are reset when the frame comes around.
+    struct RecordSlot {
+        std::vector<VkCommandPool> pools;                    // [frame]
+        std::vector<std::vector<VkCommandBuffer>> buffers;   // [frame] allocated secondaries
+        std::vector<uint32_t> used;                          // [frame] handed out this frame
+    };
+    
+    static constexpr uint32_t MAX_RECORD_WORKERS = 7;
+    
+    std::vector<RecordSlot> m_recordSlots;
+    std::vector<std::thread> m_recordWorkers;               // Slot i + 1
+    std::vector<VkCommandBuffer> m_frameSecondaries;       // Execution order for this frame
+    
+    // recordParallel hand-off (guarded by m_workMutex)
+    std::mutex m_workMutex;
+    std::condition_variable m_workCv;
+    std::condition_variable m_workDoneCv;
+    uint64_t m_workGeneration = 0;
+    uint32_t m_workersBusy = 0;
+    bool m_workersQuit = false;
+    const std::function<void(uint32_t)>* m_workFn = nullptr;
+    uint32_t m_workTaskCount = 0;
+    std::atomic<uint32_t> m_nextWorkTask{0};
+    std::vector<VkCommandBuffer> m_taskBuffers;
+    
+    // Guards the UBO/instance ring bumps while tasks are recording
+    std::mutex m_ringMutex;
+    bool m_parallelActive = false;
     
     // Default pipeline for simple rendering
     PipelineHandle m_defaultPipeline = INVALID_PIPELINE;
     
-    // Per-object uniform buffer and descriptor set
-    BufferHandle m_objectUBO = INVALID_BUFFER;
-    VkDescriptorSet m_objectDescriptorSet = VK_NULL_HANDLE;
+    // Per-object uniform ring (one per frame in flight)
+    // Persistently mapped; each drawMesh bump-allocates an aligned StandardUBO
+    // slot and binds it with a dynamic offset, so draws never alias.
+    static constexpr uint32_t OBJECT_UBO_RING_SLOTS = 4096;
+    
+    struct UniformRing {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        GpuAllocation alloc;
+        uint8_t* mapped = nullptr;
+        VkDeviceSize head = 0;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        TextureHandle boundTexture = INVALID_TEXTURE;
+        bool overflowWarned = false;
+    };
+    
+    std::vector<UniformRing> m_uniformRings;
+    VkDeviceSize m_uboSlotStride = 0;  // sizeof(StandardUBO) rounded up to minUniformBufferOffsetAlignment
+    
+    // Per-frame instance buffers (one per frame in flight), same lifetime
+    // rules as the UBO ring; drawMeshInstanced streams InstanceData here
+    static constexpr uint32_t MAX_INSTANCES_PER_FRAME = 65536;
+    
+    struct InstanceRing {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        GpuAllocation alloc;
+        InstanceData* mapped = nullptr;
+        uint32_t head = 0;  // In instances
+        bool overflowWarned = false;
+    };
+    
+    std::vector<InstanceRing> m_instanceRings;
     
     // ========================================================================
     // State
@@ -402,14 +1297,49 @@ private:
     
     glm::mat4 m_viewMatrix = glm::mat4(1.0f);
     glm::mat4 m_projMatrix = glm::mat4(1.0f);
+    Frustum m_frustum;  // Of m_projMatrix * m_viewMatrix; only the camera setters write it
+    
+    void updateFrustum() { m_frustum = Frustum::fromViewProjection(m_projMatrix * m_viewMatrix); }
+    bool cullDraw(MeshHandle mesh, const glm::mat4& transform);  // Frustum test + stats; true = skip
     
     // ImGui state
     bool m_imguiInitialized = false;
     VkDescriptorPool m_imguiDescriptorPool = VK_NULL_HANDLE;
+    void drawGpuProfilerWindow();
+    void drawMemoryBudgetWindow();
+};
+
+// ============================================================================
+// GPU Scope (RAII)
+// ============================================================================
+// Times everything recorded between construction and destruction:
+//   { VKCORE_GPU_SCOPE("lighting"); lighting.drawLitMesh(...); }
+// A null core (nothing initialized) makes it a no-op.
+
+class GpuScope {
+public:
+    GpuScope(VulkanCore* core, const char* name)
+        : m_core(core), m_scope(core ? core->beginGpuScope(name) : GpuProfiler::NO_SCOPE) {}
+    ~GpuScope() { if (m_core) m_core->endGpuScope(m_scope); }
+    
+    GpuScope(const GpuScope&) = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+    
+private:
+    VulkanCore* m_core;
+    uint32_t m_scope;
 };
 
 } // namespace vkcore
 
+#define VKCORE_GPU_SCOPE_CONCAT_(a, b) a##b
+#define VKCORE_GPU_SCOPE_CONCAT(a, b) VKCORE_GPU_SCOPE_CONCAT_(a, b)
+#define VKCORE_GPU_SCOPE(name) \
+    ::vkcore::GpuScope VKCORE_GPU_SCOPE_CONCAT(vkcoreGpuScope_, __LINE__)(::vkcore::VulkanCore::getActive(), name)
+// Same, on an explicit core (modules holding their own VulkanCore*)
+#define VKCORE_GPU_SCOPE_ON(core, name) \
+    ::vkcore::GpuScope VKCORE_GPU_SCOPE_CONCAT(vkcoreGpuScope_, __LINE__)(core, name)
+
 // ============================================================================
 // C API for HEIDIC
 // ============================================================================
@@ -420,6 +1350,7 @@ extern "C" {
 
 // Lifecycle
 int vkcore_init(void* glfwWindow, const char* appName, int width, int height);
+int vkcore_init_headless(const char* appName, int width, int height);  // No window (benchmarks, CI)
 void vkcore_shutdown();
 int vkcore_is_initialized();
 
@@ -437,6 +1368,7 @@ unsigned int vkcore_create_cube(float size, float r, float g, float b);
 unsigned int vkcore_create_mesh(const float* vertices, int vertexCount, 
                                  const unsigned int* indices, int indexCount, int vertexFormat);
 void vkcore_destroy_mesh(unsigned int handle);
+int vkcore_is_mesh_ready(unsigned int handle);  // 1 once its transfer-queue upload has landed
 
 // Drawing
 void vkcore_draw_mesh(unsigned int meshHandle, 
@@ -444,6 +1376,8 @@ void vkcore_draw_mesh(unsigned int meshHandle,
                       float rx, float ry, float rz,
                       float sx, float sy, float sz,
                       float r, float g, float b, float a);
+// mat4s: count * 16 floats (column-major), colors: count * 4 floats or null
+void vkcore_draw_mesh_instanced(unsigned int meshHandle, const float* mat4s, const float* colors, int count);
 
 // Camera
 void vkcore_set_camera(float eyeX, float eyeY, float eyeZ,
@@ -456,6 +1390,22 @@ void vkcore_set_projection_matrix(const float* mat4);
 int vkcore_get_width();
 int vkcore_get_height();
 float vkcore_get_aspect_ratio();
+float vkcore_get_render_scale();  // Scene resolution / window (1 without dynamic resolution)
+
+// Frame timings (ms) for the last frame; any pointer may be null
+void vkcore_get_frame_timings(float* fenceWaitMs, float* acquireMs, float* pacingSleepMs, float* frameMs);
+
+// Draw calls and triangles (at the selected LODs / at full detail) last frame
+void vkcore_get_render_stats(int* drawCalls, double* triangles, double* trianglesFullDetail);
+
+// Objects drawn / skipped by frustum culling last frame
+void vkcore_get_cull_stats(int* visible, int* culled);
+
+// GPU timings per scope name (ms), framesInFlight frames late. Fills up to
+// maxCount entries and returns how many exist. Names stay valid until the
+// next vkcore_begin_frame.
+int vkcore_get_gpu_timings(const char** names, float* ms, int maxCount);
+int vkcore_export_gpu_trace(const char* path);  // Chrome trace JSON, 1 on success
 
 // ImGui (optional - compile with VKCORE_ENABLE_IMGUI)
 int vkcore_init_imgui(void* glfwWindow);
@@ -2,6 +2,7 @@
 // Extracted from eden_vulkan_helpers.cpp for modularity
 
 #include "eden_imgui.h"
+#include "../stdlib/system_profiler.h"
 #include <iostream>
 
 // External Vulkan state (defined in eden_vulkan_helpers.cpp)
@@ -138,6 +139,14 @@ extern "C" void heidic_imgui_render_demo_overlay(float fps, float camera_x, floa
     ImGui::End();
 }
 
+// Per-system timings and last-frame flame view from code compiled with
+// `heidic_v2 compile --profile`
+extern "C" void heidic_imgui_render_profiler_overlay() {
+    if (!g_imguiInitialized) return;
+    SystemProfiler::draw_imgui();
+    SystemProfiler::draw_flame_imgui();
+}
+
 extern "C" void heidic_cleanup_imgui() {
     if (!g_imguiInitialized) return;
     
@@ -217,6 +226,7 @@ extern "C" void heidic_imgui_render(VkCommandBuffer commandBuffer) { (void)comma
 extern "C" void heidic_imgui_render_demo_overlay(float fps, float camera_x, float camera_y, float camera_z) {
     (void)fps; (void)camera_x; (void)camera_y; (void)camera_z;
 }
+extern "C" void heidic_imgui_render_profiler_overlay() {}
 extern "C" void heidic_cleanup_imgui() {}
 extern "C" int heidic_imgui_is_initialized() { return 0; }
 extern "C" int heidic_imgui_want_capture_mouse() { return 0; }
@@ -29,6 +29,10 @@ void heidic_imgui_render(VkCommandBuffer commandBuffer);
 // Render a simple demo overlay showing FPS and camera position
 void heidic_imgui_render_demo_overlay(float fps, float camera_x, float camera_y, float camera_z);
 
+// Render per-system timings (average, p99, trace capture button)
+// Needs code compiled with `heidic_v2 compile --profile`; otherwise the table is empty
+void heidic_imgui_render_profiler_overlay();
+
 // Cleanup ImGui resources
 void heidic_cleanup_imgui();
 
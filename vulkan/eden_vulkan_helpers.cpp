@@ -34,6 +34,7 @@
 #include <cctype>
 #include <sstream>
 #include <thread>
+#include <mutex>
 #include <chrono>
 #include <cmath>
 #include <algorithm>
@@ -63,6 +64,23 @@
 #include "../stdlib/texture_resource.h"
 #include "../stdlib/mesh_resource.h"
 #include "../stdlib/resource.h"
+#include "../stdlib/vfs.h"
+#include "../stdlib/json_reader.h"
+#include "../stdlib/system_profiler.h"
+#include "../stdlib/job_system.h"
+#include "core/pipeline_cache.h"
+#include "core/shader_compiler.h"
+#include "core/bindless_heap.h"
+#include "core/upload_batch.h"
+#include "core/handle_pool.h"
+#include "utils/undo_history.h"
+#include "utils/half_edge_mesh.h"
+#include "utils/mesh_bvh.h"
+#include "utils/position_hash.h"
+#include "utils/vertex_edit_region.h"
+#include "utils/object_grid.h"
+#include "utils/transform_hierarchy.h"
+#include "utils/physics_world.h"
 
 // ImGui includes (if available)
 #ifdef USE_IMGUI
@@ -107,6 +125,16 @@ static uint32_t g_graphicsQueueFamilyIndex = 0;
 static uint32_t g_currentFrame = 0;
 VkExtent2D g_swapchainExtent = {};  // Made non-static for NEUROSHELL access
 
+// Shared driver pipeline cache (persisted to pipeline_cache_<uuid>.bin) -
+// startup and heidic_reload_shader reuse previously compiled pipelines
+static VkPipelineCache edenPipelineCache() {
+    return vkcore::PipelineCache::shared(g_device, g_physicalDevice).get();
+}
+
+// Shader hot-reload runs on ShaderCompiler's worker (see SHADER HOT-RELOAD)
+static void finishShaderReloads();
+static void dropShaderReloads();
+
 // Additional state
 static std::vector<VkImage> g_swapchainImages;
 static std::vector<VkImageView> g_swapchainImageViews;
@@ -177,7 +205,7 @@ static std::vector<char> readFile(const std::string& filename) {
     };
     
     for (const auto& path : paths) {
-        std::ifstream file(path, std::ios::ate | std::ios::binary);
+        VfsInputStream file(path, std::ios::ate | std::ios::binary);
         if (file.is_open()) {
             size_t fileSize = (size_t) file.tellg();
             std::vector<char> buffer(fileSize);
@@ -475,6 +503,7 @@ extern "C" int heidic_init_renderer(GLFWwindow* window) {
     if (validationLayersAvailable) {
         extensions.push_back("VK_EXT_debug_utils");
     }
+    vkcore::BindlessHeap::addInstanceExtensions(extensions);  // Descriptor indexing feature query
     
     createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
     createInfo.ppEnabledExtensionNames = extensions.data();
@@ -559,6 +588,9 @@ extern "C" int heidic_init_renderer(GLFWwindow* window) {
     
     VkPhysicalDeviceFeatures deviceFeatures = {};
     deviceFeatures.fillModeNonSolid = VK_TRUE;  // Enable wireframe rendering mode
+    VkPhysicalDeviceFeatures supportedFeatures = {};
+    vkGetPhysicalDeviceFeatures(g_physicalDevice, &supportedFeatures);
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;  // DDS/KTX2 BCn textures
     
     VkDeviceCreateInfo deviceCreateInfo = {};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -566,9 +598,16 @@ extern "C" int heidic_init_renderer(GLFWwindow* window) {
     deviceCreateInfo.queueCreateInfoCount = 1;
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
     
-    const char* deviceExtensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
-    deviceCreateInfo.enabledExtensionCount = 1;
-    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions;
+    std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    
+    // Bindless texture heap (vkcore::BindlessHeap::shared) - used by the generated bindless code
+    vkcore::BindlessSupport bindless = vkcore::BindlessHeap::querySupport(g_instance, g_physicalDevice, deviceExtensions);
+    if (bindless.supported) {
+        deviceCreateInfo.pNext = &bindless.features;
+    }
+    
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
     
     if (vkCreateDevice(g_physicalDevice, &deviceCreateInfo, nullptr, &g_device) != VK_SUCCESS) {
         std::cerr << "[EDEN] ERROR: Failed to create logical device!" << std::endl;
@@ -579,6 +618,16 @@ extern "C" int heidic_init_renderer(GLFWwindow* window) {
     
     vkGetDeviceQueue(g_device, g_graphicsQueueFamilyIndex, 0, &g_graphicsQueue);
     
+    // Bound here so stdlib Mesh/TextureResource share one staging ring and
+    // submit their copies without vkQueueWaitIdle
+    vkcore::UploadBatch::shared(g_device, g_physicalDevice, g_graphicsQueue, g_graphicsQueueFamilyIndex);
+    
+    if (bindless.supported) {
+        vkcore::BindlessHeap::shared(g_device, std::min(vkcore::BindlessHeap::DEFAULT_CAPACITY, bindless.maxTextures));
+    } else {
+        std::cout << "[EDEN] Descriptor indexing unavailable - bindless textures disabled" << std::endl;
+    }
+    
     // 6. Create swapchain
     VkSurfaceCapabilitiesKHR capabilities;
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(g_physicalDevice, g_surface, &capabilities);
@@ -976,7 +1025,7 @@ extern "C" int heidic_init_renderer(GLFWwindow* window) {
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_pipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_pipeline) != VK_SUCCESS) {
         std::cerr << "[EDEN] ERROR: Failed to create graphics pipeline!" << std::endl;
         vkDestroyPipelineLayout(g_device, g_pipelineLayout, nullptr);
         vkDestroyShaderModule(g_device, g_fragShaderModule, nullptr);
@@ -1139,6 +1188,7 @@ extern "C" void heidic_render_frame(GLFWwindow* window) {
     // Wait for previous frame to finish
     vkWaitForFences(g_device, 1, &g_inFlightFence, VK_TRUE, UINT64_MAX);
     vkResetFences(g_device, 1, &g_inFlightFence);
+    finishShaderReloads();  // The pipelines are idle now
     
     // Acquire next image
     uint32_t imageIndex;
@@ -1274,6 +1324,7 @@ extern "C" void heidic_cleanup_renderer() {
     }
     
     vkDeviceWaitIdle(g_device);
+    dropShaderReloads();
     
     // Cleanup uniform buffers
     for (size_t i = 0; i < g_uniformBuffers.size(); i++) {
@@ -1374,6 +1425,14 @@ extern "C" void heidic_cleanup_renderer() {
     
     // Cleanup device
     if (g_device != VK_NULL_HANDLE) {
+        vkcore::BindlessHeap::shared().shutdown();
+        vkcore::UploadBatch::shared().shutdown();  // Staging ring lives in the shared allocator
+        
+        // Release the sub-allocator blocks backing stdlib Mesh/TextureResource
+        vkcore::GpuAllocator& allocator = vkcore::GpuAllocator::shared(g_device, g_physicalDevice);
+        allocator.printStats();
+        allocator.shutdown();
+        vkcore::PipelineCache::shared(g_device, g_physicalDevice).shutdown();  // Saves to disk
         vkDestroyDevice(g_device, nullptr);
     }
     
@@ -1400,6 +1459,227 @@ extern "C" int32_t f32_to_i32(float value) {
     return static_cast<int32_t>(value);
 }
 
+// ============================================================================
+// SHADER HOT-RELOAD
+// ============================================================================
+// heidic_reload_shader() only queues work: vkcore::ShaderCompiler compiles the
+// GLSL (cached by content) and builds the new pipeline through the shared
+// pipeline cache on its worker thread. The render functions call
+// finishShaderReloads() right after their fence wait - the old pipeline is
+// idle there - and swap it in. Until then, and for good if the edit does not
+// compile, the old pipeline keeps drawing.
+
+struct ShaderReload {
+    std::string path;
+    bool isCube = false;
+    bool isVertex = false;
+    VkShaderModule module = VK_NULL_HANDLE;  // The reloaded stage, made on the worker
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    std::shared_ptr<vkcore::ShaderCompiler::Job> job;
+    std::chrono::steady_clock::time_point requested;
+};
+
+// In flight, at most one per pipeline: a reload pairs its stage with the
+// other stage's current module, which only a swap replaces
+static std::vector<std::unique_ptr<ShaderReload>> g_shaderReloads;
+// Saved again while their pipeline's reload was in flight
+static std::vector<std::string> g_queuedShaderReloads;
+
+extern "C" void heidic_reload_shader(const char* shader_path);
+
+// Pipeline for the triangle or cube renderer from a vertex + fragment module.
+// Runs on the compiler's worker; everything it reads is passed in.
+static VkPipeline createHotReloadPipeline(bool isCube, bool vertexInput, VkShaderModule vertModule,
+                                          VkShaderModule fragModule, VkExtent2D extent, VkPipelineCache cache) {
+    VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragModule;
+    shaderStages[1].pName = "main";
+    
+    // Cube and custom triangle shaders take Vertex input, the default triangle shaders none
+    VkVertexInputBindingDescription bindingDescription = {};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(Vertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    
+    VkVertexInputAttributeDescription attributeDescriptions[2] = {};
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(Vertex, pos);
+    
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(Vertex, color);
+    
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    if (isCube || vertexInput) {
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+        vertexInputInfo.vertexAttributeDescriptionCount = 2;
+        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
+    }
+    
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+    
+    VkViewport viewport = {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float)extent.width;
+    viewport.height = (float)extent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    
+    VkRect2D scissor = {};
+    scissor.offset = {0, 0};
+    scissor.extent = extent;
+    
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.pViewports = &viewport;
+    viewportState.scissorCount = 1;
+    viewportState.pScissors = &scissor;
+    
+    VkPipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = isCube ? VK_CULL_MODE_BACK_BIT : VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+    
+    VkPipelineMultisampleStateCreateInfo multisampling = {};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    
+    // The cube is depth tested, the triangle is not
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = isCube ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = isCube ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = isCube ? VK_COMPARE_OP_LESS : VK_COMPARE_OP_ALWAYS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+    
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+    
+    VkPipelineColorBlendStateCreateInfo colorBlending = {};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+    
+    VkGraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.layout = g_pipelineLayout;
+    pipelineInfo.renderPass = g_renderPass;
+    pipelineInfo.subpass = 0;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(g_device, cache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+// Install finished reloads. Call right after the frame's fence wait, when
+// the GPU no longer uses the pipelines being replaced.
+static void finishShaderReloads() {
+    if (g_shaderReloads.empty()) {
+        return;
+    }
+    
+    bool landed = false;
+    for (size_t i = 0; i < g_shaderReloads.size();) {
+        ShaderReload& reload = *g_shaderReloads[i];
+        if (!reload.job->ready()) {
+            i++;
+            continue;
+        }
+        
+        if (reload.pipeline != VK_NULL_HANDLE) {
+            VkShaderModule& stageModule = reload.isCube
+                ? (reload.isVertex ? g_cubeVertShaderModule : g_cubeFragShaderModule)
+                : (reload.isVertex ? g_vertShaderModule : g_fragShaderModule);
+            VkPipeline& pipeline = reload.isCube ? g_cubePipeline : g_pipeline;
+            if (pipeline != VK_NULL_HANDLE) {
+                vkDestroyPipeline(g_device, pipeline, nullptr);
+            }
+            if (stageModule != VK_NULL_HANDLE) {
+                vkDestroyShaderModule(g_device, stageModule, nullptr);
+            }
+            stageModule = reload.module;
+            pipeline = reload.pipeline;
+            
+            double waitedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - reload.requested).count();
+            std::cout << "[Shader Hot-Reload] Successfully reloaded shader: " << reload.path << " ("
+                      << reload.job->milliseconds << " ms on the worker, swapped after " << waitedMs << " ms)" << std::endl;
+        } else {
+            if (reload.module != VK_NULL_HANDLE) {
+                vkDestroyShaderModule(g_device, reload.module, nullptr);
+            }
+            std::cerr << "[Shader Hot-Reload] Keeping the running shader, " << reload.path << " failed:\n"
+                      << reload.job->error << std::endl;
+        }
+        
+        g_shaderReloads.erase(g_shaderReloads.begin() + i);
+        landed = true;
+    }
+    
+    // Saves that arrived meanwhile go against the pipelines just installed
+    // (requests for a pipeline still reloading queue up again)
+    if (landed && !g_queuedShaderReloads.empty()) {
+        std::vector<std::string> queued;
+        queued.swap(g_queuedShaderReloads);
+        for (const std::string& path : queued) {
+            heidic_reload_shader(path.c_str());
+        }
+    }
+}
+
+// Wait for reloads in flight and discard them (renderer cleanup)
+static void dropShaderReloads() {
+    for (const auto& reload : g_shaderReloads) {
+        while (!reload->job->ready()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (reload->pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(g_device, reload->pipeline, nullptr);
+        }
+        if (reload->module != VK_NULL_HANDLE) {
+            vkDestroyShaderModule(g_device, reload->module, nullptr);
+        }
+    }
+    g_shaderReloads.clear();
+    g_queuedShaderReloads.clear();
+}
+
 // Hot-reload shader function
 extern "C" void heidic_reload_shader(const char* shader_path) {
     if (g_device == VK_NULL_HANDLE) {
@@ -1407,32 +1687,14 @@ extern "C" void heidic_reload_shader(const char* shader_path) {
         return;
     }
     
-    // Wait for device to be idle before reloading
-    vkDeviceWaitIdle(g_device);
-    
     std::string shaderPathStr(shader_path);
     
-    // Determine the .spv path from the source path (shader_path is now the original source)
     // Helper lambda for C++17-compatible ends_with check
     auto endsWith = [](const std::string& str, const std::string& suffix) -> bool {
         if (suffix.length() > str.length()) return false;
         return str.compare(str.length() - suffix.length(), suffix.length(), suffix) == 0;
     };
     
-    // Compile to .vert.spv, .frag.spv, etc. to avoid conflicts
-    std::string spv_path = shaderPathStr;
-    if (endsWith(spv_path, ".vert")) {
-        spv_path = spv_path + ".spv";  // my_shader.vert.spv
-    } else if (endsWith(spv_path, ".frag")) {
-        spv_path = spv_path + ".spv";  // my_shader.frag.spv
-    } else if (endsWith(spv_path, ".glsl")) {
-        spv_path = spv_path.substr(0, spv_path.length() - 5) + ".spv";
-    } else if (endsWith(spv_path, ".comp")) {
-        spv_path = spv_path + ".spv";  // my_shader.comp.spv
-    } else if (!endsWith(spv_path, ".spv")) {
-        spv_path = spv_path + ".spv";
-    }
-    
     // Extract just the filename for matching
     std::string filename = shaderPathStr;
     size_t lastSlash = shaderPathStr.find_last_of("/\\");
@@ -1461,368 +1723,116 @@ extern "C" void heidic_reload_shader(const char* shader_path) {
             return;
         }
     }
+    bool isCube = isCubeShader && !isTriangleShader;
     
     // Determine which shader stage we're reloading from the source file extension
     bool isVertex = (shaderPathStr.find(".vert") != std::string::npos || filename.find(".vert") != std::string::npos);
     bool isFragment = (shaderPathStr.find(".frag") != std::string::npos || filename.find(".frag") != std::string::npos);
-    
-    // Detect if this is a custom shader (my_shader pattern) that needs vertex input
-    bool isCustomShader = (shaderPathStr.find("my_shader") != std::string::npos || filename.find("my_shader") != std::string::npos);
-    if (isCustomShader) {
-        g_usingCustomShaders = true;
-    }
-    
-    VkShaderModule* targetModule = nullptr;
-    VkPipeline* targetPipeline = nullptr;
-    
-    if (isTriangleShader) {
-        if (isVertex) {
-            targetModule = &g_vertShaderModule;
-        } else if (isFragment) {
-            targetModule = &g_fragShaderModule;
-        }
-        targetPipeline = &g_pipeline;
-    } else if (isCubeShader) {
-        if (isVertex) {
-            targetModule = &g_cubeVertShaderModule;
-        } else if (isFragment) {
-            targetModule = &g_cubeFragShaderModule;
-        }
-        targetPipeline = &g_cubePipeline;
-    }
-    
-    if (targetModule == nullptr || targetPipeline == nullptr) {
+    if (!isVertex && !isFragment) {
         std::cerr << "[Shader Hot-Reload] ERROR: Could not determine shader module!" << std::endl;
         return;
     }
     
-    // Read new shader code from the .spv file
-    std::vector<char> shaderCode;
-    try {
-        shaderCode = readFile(spv_path);
-    } catch (const std::exception& e) {
-        std::cerr << "[Shader Hot-Reload] ERROR: Failed to read shader file " << spv_path << ": " << e.what() << std::endl;
-        return;
-    }
-    
-    // Destroy old shader module
-    if (*targetModule != VK_NULL_HANDLE) {
-        vkDestroyShaderModule(g_device, *targetModule, nullptr);
-        *targetModule = VK_NULL_HANDLE;
-    }
-    
-    // Create new shader module
-    VkShaderModuleCreateInfo createInfo = {};
-    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = shaderCode.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
-    
-    if (vkCreateShaderModule(g_device, &createInfo, nullptr, targetModule) != VK_SUCCESS) {
-        std::cerr << "[Shader Hot-Reload] ERROR: Failed to create new shader module!" << std::endl;
-        return;
-    }
-    
-    // Destroy old pipeline
-    if (*targetPipeline != VK_NULL_HANDLE) {
-        vkDestroyPipeline(g_device, *targetPipeline, nullptr);
-        *targetPipeline = VK_NULL_HANDLE;
-    }
-    
-    // Get the other shader module (vertex or fragment)
-    VkShaderModule otherModule = VK_NULL_HANDLE;
-    if (isTriangleShader) {
-        if (isVertex) {
-            otherModule = g_fragShaderModule;
-        } else {
-            otherModule = g_vertShaderModule;
-        }
-    } else if (isCubeShader) {
-        if (isVertex) {
-            otherModule = g_cubeFragShaderModule;
-        } else {
-            otherModule = g_cubeVertShaderModule;
+    // One reload per pipeline at a time; this one starts when it lands
+    for (const auto& reload : g_shaderReloads) {
+        if (reload->isCube == isCube) {
+            if (std::find(g_queuedShaderReloads.begin(), g_queuedShaderReloads.end(), shaderPathStr) == g_queuedShaderReloads.end()) {
+                g_queuedShaderReloads.push_back(shaderPathStr);
+            }
+            return;
         }
     }
     
+    VkShaderModule otherModule = isCube
+        ? (isVertex ? g_cubeFragShaderModule : g_cubeVertShaderModule)
+        : (isVertex ? g_fragShaderModule : g_vertShaderModule);
     if (otherModule == VK_NULL_HANDLE) {
         std::cerr << "[Shader Hot-Reload] ERROR: Other shader module not found!" << std::endl;
         return;
     }
     
-    // Create shader stage info for both shaders
-    VkPipelineShaderStageCreateInfo vertStageInfo = {};
-    vertStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertStageInfo.module = isVertex ? *targetModule : otherModule;
-    vertStageInfo.pName = "main";
-    
-    VkPipelineShaderStageCreateInfo fragStageInfo = {};
-    fragStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragStageInfo.module = isFragment ? *targetModule : otherModule;
-    fragStageInfo.pName = "main";
-    
-    VkPipelineShaderStageCreateInfo shaderStages[] = {vertStageInfo, fragStageInfo};
-    
-    // Recreate pipeline (triangle or cube)
-    if (isTriangleShader) {
-        // Triangle pipeline setup
-        // Custom shaders (my_shader) need vertex input, default shaders don't
-        VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
-        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        
-        VkVertexInputBindingDescription bindingDescription = {};
-        VkVertexInputAttributeDescription attributeDescriptions[2] = {};
-        
-        if (g_usingCustomShaders) {
-            // Set up vertex input for custom shaders
-            bindingDescription.binding = 0;
-            bindingDescription.stride = sizeof(Vertex);
-            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-            
-            attributeDescriptions[0].binding = 0;
-            attributeDescriptions[0].location = 0;
-            attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-            attributeDescriptions[0].offset = offsetof(Vertex, pos);
-            
-            attributeDescriptions[1].binding = 0;
-            attributeDescriptions[1].location = 1;
-            attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-            attributeDescriptions[1].offset = offsetof(Vertex, color);
-            
-            vertexInputInfo.vertexBindingDescriptionCount = 1;
-            vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-            vertexInputInfo.vertexAttributeDescriptionCount = 2;
-            vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
-            
-            // Create vertex buffer for triangle if it doesn't exist
-            if (g_triangleVertexBuffer == VK_NULL_HANDLE) {
-                std::vector<Vertex> triangleVertices = {
-                    {{ 0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}},  // Bottom (red)
-                    {{ 0.5f,  0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}},  // Top-right (green)
-                    {{-0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}}   // Top-left (blue)
-                };
-                
-                VkDeviceSize bufferSize = sizeof(Vertex) * triangleVertices.size();
-                createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                           g_triangleVertexBuffer, g_triangleVertexBufferMemory);
-                
-                // Copy vertex data to buffer
-                void* data;
-                vkMapMemory(g_device, g_triangleVertexBufferMemory, 0, bufferSize, 0, &data);
-                memcpy(data, triangleVertices.data(), (size_t)bufferSize);
-                vkUnmapMemory(g_device, g_triangleVertexBufferMemory);
-                
-                std::cout << "[Shader Hot-Reload] Created vertex buffer for custom shaders" << std::endl;
-            }
-        } else {
-            // Default shaders use hardcoded vertices (no vertex input)
-            vertexInputInfo.vertexBindingDescriptionCount = 0;
-            vertexInputInfo.vertexAttributeDescriptionCount = 0;
-        }
-        
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
-        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssembly.primitiveRestartEnable = VK_FALSE;
-        
-        VkViewport viewport = {};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = (float)g_swapchainExtent.width;
-        viewport.height = (float)g_swapchainExtent.height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        
-        VkRect2D scissor = {};
-        scissor.offset = {0, 0};
-        scissor.extent = g_swapchainExtent;
-        
-        VkPipelineViewportStateCreateInfo viewportState = {};
-        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportState.viewportCount = 1;
-        viewportState.pViewports = &viewport;
-        viewportState.scissorCount = 1;
-        viewportState.pScissors = &scissor;
-        
-        VkPipelineRasterizationStateCreateInfo rasterizer = {};
-        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizer.depthClampEnable = VK_FALSE;
-        rasterizer.rasterizerDiscardEnable = VK_FALSE;
-        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-        rasterizer.lineWidth = 1.0f;
-        rasterizer.cullMode = VK_CULL_MODE_NONE;
-        rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-        rasterizer.depthBiasEnable = VK_FALSE;
-        
-        VkPipelineMultisampleStateCreateInfo multisampling = {};
-        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampling.sampleShadingEnable = VK_FALSE;
-        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-        
-        VkPipelineDepthStencilStateCreateInfo depthStencil = {};
-        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-        depthStencil.depthTestEnable = VK_FALSE;
-        depthStencil.depthWriteEnable = VK_FALSE;
-        depthStencil.depthCompareOp = VK_COMPARE_OP_ALWAYS;
-        depthStencil.depthBoundsTestEnable = VK_FALSE;
-        depthStencil.stencilTestEnable = VK_FALSE;
-        
-        VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachment.blendEnable = VK_FALSE;
-        
-        VkPipelineColorBlendStateCreateInfo colorBlending = {};
-        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlending.logicOpEnable = VK_FALSE;
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
-        
-        VkGraphicsPipelineCreateInfo pipelineInfo = {};
-        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2;
-        pipelineInfo.pStages = shaderStages;
-        pipelineInfo.pVertexInputState = &vertexInputInfo;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
-        pipelineInfo.pViewportState = &viewportState;
-        pipelineInfo.pRasterizationState = &rasterizer;
-        pipelineInfo.pMultisampleState = &multisampling;
-        pipelineInfo.pDepthStencilState = &depthStencil;
-        pipelineInfo.pColorBlendState = &colorBlending;
-        pipelineInfo.layout = g_pipelineLayout;
-        pipelineInfo.renderPass = g_renderPass;
-        pipelineInfo.subpass = 0;
-        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-        
-        if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_pipeline) != VK_SUCCESS) {
-            std::cerr << "[Shader Hot-Reload] ERROR: Failed to recreate triangle pipeline!" << std::endl;
-            return;
-        }
-    } else if (isCubeShader) {
-        // Cube pipeline setup (with vertex input)
-        VkVertexInputBindingDescription bindingDescription = {};
-        bindingDescription.binding = 0;
-        bindingDescription.stride = sizeof(Vertex);
-        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        
-        VkVertexInputAttributeDescription attributeDescriptions[2] = {};
-        attributeDescriptions[0].binding = 0;
-        attributeDescriptions[0].location = 0;
-        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-        attributeDescriptions[0].offset = offsetof(Vertex, pos);
-        
-        attributeDescriptions[1].binding = 0;
-        attributeDescriptions[1].location = 1;
-        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-        attributeDescriptions[1].offset = offsetof(Vertex, color);
-        
-        VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
-        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-        vertexInputInfo.vertexAttributeDescriptionCount = 2;
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
-        
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
-        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssembly.primitiveRestartEnable = VK_FALSE;
-        
-        VkViewport viewport = {};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = (float)g_swapchainExtent.width;
-        viewport.height = (float)g_swapchainExtent.height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        
-        VkRect2D scissor = {};
-        scissor.offset = {0, 0};
-        scissor.extent = g_swapchainExtent;
+    // Detect if this is a custom shader (my_shader pattern) that needs vertex input
+    bool isCustomShader = (shaderPathStr.find("my_shader") != std::string::npos || filename.find("my_shader") != std::string::npos);
+    if (isCustomShader) {
+        g_usingCustomShaders = true;
+    }
+    
+    // Create vertex buffer for triangle if it doesn't exist
+    if (!isCube && g_usingCustomShaders && g_triangleVertexBuffer == VK_NULL_HANDLE) {
+        std::vector<Vertex> triangleVertices = {
+            {{ 0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}},  // Bottom (red)
+            {{ 0.5f,  0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}},  // Top-right (green)
+            {{-0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}}   // Top-left (blue)
+        };
         
-        VkPipelineViewportStateCreateInfo viewportState = {};
-        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportState.viewportCount = 1;
-        viewportState.pViewports = &viewport;
-        viewportState.scissorCount = 1;
-        viewportState.pScissors = &scissor;
-        
-        VkPipelineRasterizationStateCreateInfo rasterizer = {};
-        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizer.depthClampEnable = VK_FALSE;
-        rasterizer.rasterizerDiscardEnable = VK_FALSE;
-        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-        rasterizer.lineWidth = 1.0f;
-        rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-        rasterizer.depthBiasEnable = VK_FALSE;
-        
-        VkPipelineMultisampleStateCreateInfo multisampling = {};
-        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampling.sampleShadingEnable = VK_FALSE;
-        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-        
-        VkPipelineDepthStencilStateCreateInfo depthStencil = {};
-        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-        depthStencil.depthTestEnable = VK_TRUE;
-        depthStencil.depthWriteEnable = VK_TRUE;
-        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-        depthStencil.depthBoundsTestEnable = VK_FALSE;
-        depthStencil.stencilTestEnable = VK_FALSE;
-        
-        VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachment.blendEnable = VK_FALSE;
-        
-        VkPipelineColorBlendStateCreateInfo colorBlending = {};
-        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlending.logicOpEnable = VK_FALSE;
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
+        VkDeviceSize bufferSize = sizeof(Vertex) * triangleVertices.size();
+        createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                   g_triangleVertexBuffer, g_triangleVertexBufferMemory);
         
-        VkGraphicsPipelineCreateInfo pipelineInfo = {};
-        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2;
-        pipelineInfo.pStages = shaderStages;
-        pipelineInfo.pVertexInputState = &vertexInputInfo;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
-        pipelineInfo.pViewportState = &viewportState;
-        pipelineInfo.pRasterizationState = &rasterizer;
-        pipelineInfo.pMultisampleState = &multisampling;
-        pipelineInfo.pDepthStencilState = &depthStencil;
-        pipelineInfo.pColorBlendState = &colorBlending;
-        pipelineInfo.layout = g_pipelineLayout;
-        pipelineInfo.renderPass = g_renderPass;
-        pipelineInfo.subpass = 0;
-        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        // Copy vertex data to buffer
+        void* data;
+        vkMapMemory(g_device, g_triangleVertexBufferMemory, 0, bufferSize, 0, &data);
+        memcpy(data, triangleVertices.data(), (size_t)bufferSize);
+        vkUnmapMemory(g_device, g_triangleVertexBufferMemory);
         
-        if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_cubePipeline) != VK_SUCCESS) {
-            std::cerr << "[Shader Hot-Reload] ERROR: Failed to recreate cube pipeline!" << std::endl;
-            return;
-        }
+        std::cout << "[Shader Hot-Reload] Created vertex buffer for custom shaders" << std::endl;
     }
     
-    // Recreate command buffers (they reference the pipeline)
-    // Free old command buffers
-    if (g_commandPool != VK_NULL_HANDLE) {
-        vkFreeCommandBuffers(g_device, g_commandPool, static_cast<uint32_t>(g_commandBuffers.size()), g_commandBuffers.data());
+    // GLSL is compiled; a path that is already .spv is loaded as-is
+    std::vector<vkcore::ShaderSource> sources;
+    if (!endsWith(shaderPathStr, ".spv")) {
+        sources.emplace_back(shaderPathStr, isVertex ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT);
     }
     
-    // Reallocate command buffers
-    g_commandBuffers.resize(g_swapchainImageCount);
-    VkCommandBufferAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = g_commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = static_cast<uint32_t>(g_commandBuffers.size());
-    
-    if (vkAllocateCommandBuffers(g_device, &allocInfo, g_commandBuffers.data()) != VK_SUCCESS) {
-        std::cerr << "[Shader Hot-Reload] ERROR: Failed to reallocate command buffers!" << std::endl;
-        return;
-    }
+    auto reload = std::make_unique<ShaderReload>();
+    reload->path = shaderPathStr;
+    reload->isCube = isCube;
+    reload->isVertex = isVertex;
+    reload->requested = std::chrono::steady_clock::now();
     
-    std::cout << "[Shader Hot-Reload] Successfully reloaded shader: " << shader_path << std::endl;
+    // Everything the worker needs is captured now, on the render thread
+    ShaderReload* target = reload.get();
+    bool vertexInput = g_usingCustomShaders;
+    VkExtent2D extent = g_swapchainExtent;
+    VkPipelineCache cache = edenPipelineCache();
+    reload->job = vkcore::ShaderCompiler::shared().compileAsync(std::move(sources),
+        [target, otherModule, vertexInput, extent, cache](vkcore::ShaderCompiler::Job& job) {
+            std::vector<char> spvFile;
+            const void* code = nullptr;
+            size_t codeSize = 0;
+            if (job.spirv.empty()) {
+                try {
+                    spvFile = readFile(target->path);
+                } catch (const std::exception& e) {
+                    job.error = e.what();
+                    return;
+                }
+                code = spvFile.data();
+                codeSize = spvFile.size();
+            } else {
+                code = job.spirv[0].data();
+                codeSize = job.spirv[0].size() * sizeof(uint32_t);
+            }
+            
+            VkShaderModuleCreateInfo createInfo = {};
+            createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            createInfo.codeSize = codeSize;
+            createInfo.pCode = reinterpret_cast<const uint32_t*>(code);
+            if (vkCreateShaderModule(g_device, &createInfo, nullptr, &target->module) != VK_SUCCESS) {
+                job.error = "Failed to create new shader module!";
+                return;
+            }
+            
+            VkShaderModule vertModule = target->isVertex ? target->module : otherModule;
+            VkShaderModule fragModule = target->isVertex ? otherModule : target->module;
+            target->pipeline = createHotReloadPipeline(target->isCube, vertexInput, vertModule, fragModule, extent, cache);
+            if (target->pipeline == VK_NULL_HANDLE) {
+                job.error = target->isCube ? "Failed to recreate cube pipeline!" : "Failed to recreate triangle pipeline!";
+            }
+        });
+    g_shaderReloads.push_back(std::move(reload));
+    std::cout << "[Shader Hot-Reload] Compiling " << shader_path << " in the background..." << std::endl;
 }
 
 // ============================================================================
@@ -2057,7 +2067,7 @@ extern "C" int heidic_init_renderer_cube(GLFWwindow* window) {
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_cubePipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_cubePipeline) != VK_SUCCESS) {
         std::cerr << "[EDEN] ERROR: Failed to create cube graphics pipeline!" << std::endl;
         vkDestroyShaderModule(g_device, g_cubeFragShaderModule, nullptr);
         vkDestroyShaderModule(g_device, g_cubeVertShaderModule, nullptr);
@@ -2091,6 +2101,7 @@ extern "C" void heidic_render_frame_cube(GLFWwindow* window) {
     // Wait for previous frame
     vkWaitForFences(g_device, 1, &g_inFlightFence, VK_TRUE, UINT64_MAX);
     vkResetFences(g_device, 1, &g_inFlightFence);
+    finishShaderReloads();  // The pipelines are idle now
     
     // Acquire next image
     uint32_t imageIndex;
@@ -2240,16 +2251,48 @@ static VkBuffer g_fpsCubeIndexBuffer = VK_NULL_HANDLE;
 static VkDeviceMemory g_fpsCubeIndexBufferMemory = VK_NULL_HANDLE;
 static uint32_t g_fpsCubeIndexCount = 0;
 
-// Colored reference cubes (1x1x1 cubes for spatial reference)
-static VkBuffer g_coloredCubeVertexBuffers[19] = {VK_NULL_HANDLE};  // 9 big + 5 small + 1 rectangle + 1 pink block + 1 ground + 1 building
-static VkDeviceMemory g_coloredCubeVertexBufferMemory[19] = {VK_NULL_HANDLE};
+// Colored reference cubes (1x1x1 cubes for spatial reference), plus any added with heidic_add_cube
 static int g_numColoredCubes = 0;
 // Store cube sizes (1.0 for big cubes, 0.5 for small cubes, or per-axis for rectangles)
-static float g_coloredCubeSizes[19] = {0.0f};
+static std::vector<float> g_coloredCubeSizes;
 // Store per-axis sizes for non-uniform shapes (x, y, z)
-static float g_coloredCubeSizeX[19] = {0.0f};
-static float g_coloredCubeSizeY[19] = {0.0f};
-static float g_coloredCubeSizeZ[19] = {0.0f};
+static std::vector<float> g_coloredCubeSizeX;
+static std::vector<float> g_coloredCubeSizeY;
+static std::vector<float> g_coloredCubeSizeZ;
+
+// Colored cubes are one instanced draw of a shared white cube mesh; each cube
+// is an instance in a storage buffer (std430, matches cube_instanced.vert)
+struct FpsCubeInstance {
+    float position[3];
+    float yawDegrees;
+    float size[3];
+    float pad;
+    float color[4];  // Its own 16 bytes: a color change writes only this
+};
+static_assert(sizeof(FpsCubeInstance) == 48, "FpsCubeInstance must match CubeInstance in cube_instanced.vert");
+enum : uint8_t { FPS_INSTANCE_TRANSFORM = 1, FPS_INSTANCE_COLOR = 2 };
+static std::vector<FpsCubeInstance> g_fpsCubeInstances;    // CPU copy, by cube index
+static std::vector<uint8_t> g_fpsCubeInstanceDirty;        // FPS_INSTANCE_* not yet in the GPU buffer
+static std::vector<uint32_t> g_fpsCubeDirtyList;           // Cubes with dirty bits, each once
+static VkBuffer g_fpsCubeVertexBufferWhite = VK_NULL_HANDLE;  // Shared cube mesh, -0.5..0.5, white
+static VkDeviceMemory g_fpsCubeVertexBufferWhiteMemory = VK_NULL_HANDLE;
+static VkBuffer g_fpsInstanceBuffer = VK_NULL_HANDLE;
+static VkDeviceMemory g_fpsInstanceBufferMemory = VK_NULL_HANDLE;
+static FpsCubeInstance* g_fpsInstanceMapped = nullptr;
+static uint32_t g_fpsInstanceCapacity = 0;
+static VkDescriptorSetLayout g_fpsInstanceSetLayout = VK_NULL_HANDLE;
+static VkDescriptorPool g_fpsInstanceDescriptorPool = VK_NULL_HANDLE;
+static VkDescriptorSet g_fpsInstanceDescriptorSet = VK_NULL_HANDLE;
+static VkPipelineLayout g_fpsInstancedPipelineLayout = VK_NULL_HANDLE;
+static VkPipeline g_fpsInstancedPipeline = VK_NULL_HANDLE;
+static VkShaderModule g_fpsInstancedVertShaderModule = VK_NULL_HANDLE;
+
+static void markFpsCubeDirty(int i, uint8_t what) {
+    if (g_fpsCubeInstanceDirty[i] == 0) {
+        g_fpsCubeDirtyList.push_back(static_cast<uint32_t>(i));
+    }
+    g_fpsCubeInstanceDirty[i] |= what;
+}
 
 // FPS Camera matrices for raycasting (updated each frame in heidic_render_fps)
 static glm::mat4 g_fpsCurrentView = glm::mat4(1.0f);
@@ -2262,6 +2305,9 @@ struct ColoredCubePos {
 };
 static std::vector<ColoredCubePos> g_coloredCubePositions;
 
+// Cube boxes for downward raycasts, kept current wherever a cube moves
+static eden::ObjectGrid g_coloredCubeGrid;
+
 // Store original cube colors (for restoring after selection)
 struct ColoredCubeColor {
     float r, g, b;
@@ -2275,12 +2321,53 @@ static std::vector<float> g_coloredCubeRotations;
 // When a cube is attached, it moves and rotates with the vehicle
 struct AttachedCubeData {
     bool attached = false;      // Whether this cube is attached to vehicle
-    float local_x = 0.0f;       // Local X offset from vehicle center (in vehicle-local space)
-    float local_y = 0.0f;       // Local Y offset from vehicle top
-    float local_z = 0.0f;       // Local Z offset from vehicle center (in vehicle-local space)
 };
 static std::vector<AttachedCubeData> g_attachedCubes;
 
+// Cube transforms: node 0 is the vehicle's top surface that attached cubes
+// are children of, node i + 1 is cube i. Parenting (attachment,
+// heidic_set_item_parent) moves children with their parent; only moved
+// subtrees are recomputed and copied back to the cube arrays.
+static eden::TransformHierarchy g_cubeTransforms;
+static uint32_t g_vehicleFrameNode = eden::TransformHierarchy::INVALID;
+
+static uint32_t cubeNode(int cube_index) {
+    return static_cast<uint32_t>(cube_index) + 1;
+}
+
+// After a cube's position, rotation or size changed: its raycast box and instance
+static void coloredCubeMoved(int i) {
+    float sx = g_coloredCubeSizeX[i] > 0.0f ? g_coloredCubeSizeX[i] : g_coloredCubeSizes[i];
+    float sy = g_coloredCubeSizeY[i] > 0.0f ? g_coloredCubeSizeY[i] : g_coloredCubeSizes[i];
+    float sz = g_coloredCubeSizeZ[i] > 0.0f ? g_coloredCubeSizeZ[i] : g_coloredCubeSizes[i];
+    const ColoredCubePos& p = g_coloredCubePositions[i];
+    float boxMin[3] = {p.x - sx * 0.5f, p.y - sy * 0.5f, p.z - sz * 0.5f};
+    float boxMax[3] = {p.x + sx * 0.5f, p.y + sy * 0.5f, p.z + sz * 0.5f};
+    g_coloredCubeGrid.update(static_cast<uint32_t>(i), boxMin, boxMax);
+    
+    FpsCubeInstance& instance = g_fpsCubeInstances[i];
+    instance.position[0] = p.x;
+    instance.position[1] = p.y;
+    instance.position[2] = p.z;
+    instance.yawDegrees = g_coloredCubeRotations[i];
+    instance.size[0] = sx;
+    instance.size[1] = sy;
+    instance.size[2] = sz;
+    markFpsCubeDirty(i, FPS_INSTANCE_TRANSFORM);
+}
+
+static void syncCubeTransforms() {
+    g_cubeTransforms.update([](uint32_t id) {
+        if (id == g_vehicleFrameNode) return;
+        int i = static_cast<int>(id) - 1;
+        if (i >= g_numColoredCubes) return;
+        const eden::Transform& world = g_cubeTransforms.world(id);
+        g_coloredCubePositions[i] = {world.position[0], world.position[1], world.position[2]};
+        g_coloredCubeRotations[i] = world.yawDegrees;
+        coloredCubeMoved(i);
+    });
+}
+
 // Item properties system - for scavenging/trading/building gameplay
 // Each cube can have item properties that define what it is, its value, etc.
 struct ItemProperties {
@@ -2295,6 +2382,34 @@ struct ItemProperties {
 };
 static std::vector<ItemProperties> g_itemProperties;
 
+// Appends a cube to every per-cube array; returns its index
+static int addColoredCube(float x, float y, float z, float size, float sizeX, float sizeY, float sizeZ,
+                          float r, float g, float b) {
+    int i = g_numColoredCubes++;
+    g_coloredCubePositions.push_back({x, y, z});
+    g_coloredCubeOriginalColors.push_back({r, g, b});
+    g_coloredCubeRotations.push_back(0.0f);
+    g_attachedCubes.push_back({false});  // Initialize as not attached
+    g_itemProperties.push_back(ItemProperties());  // Generic block, no parent
+    g_coloredCubeSizes.push_back(size);
+    g_coloredCubeSizeX.push_back(sizeX);
+    g_coloredCubeSizeY.push_back(sizeY);
+    g_coloredCubeSizeZ.push_back(sizeZ);
+    
+    FpsCubeInstance instance = {};
+    instance.color[0] = r;
+    instance.color[1] = g;
+    instance.color[2] = b;
+    instance.color[3] = 1.0f;
+    g_fpsCubeInstances.push_back(instance);
+    g_fpsCubeInstanceDirty.push_back(0);
+    markFpsCubeDirty(i, FPS_INSTANCE_COLOR);
+    
+    g_cubeTransforms.create({{x, y, z}, 0.0f});  // Node cubeNode(i)
+    coloredCubeMoved(i);
+    return i;
+}
+
 // Floor cube vertices - EXACT COPY of spinning cube vertices, just with gray colors
 // Using -1.0 to 1.0 range like spinning cube (will scale via model matrix)
 static const std::vector<Vertex> floorCubeVertices = {
@@ -2420,97 +2535,83 @@ extern "C" int heidic_init_renderer_fps(GLFWwindow* window) {
         {500.0f, 25.0f, 0.0f, 1.0f, 1.0f, 0.0f},  // Yellow building at +500X, 25 units up (half of 50 height)
     };
     
-    g_numColoredCubes = static_cast<int>(referenceCubes.size());
-    
     // Initialize global cube positions array, store original colors, initialize rotations, attachment data, and item properties
+    g_numColoredCubes = 0;
     g_coloredCubePositions.clear();
     g_coloredCubeOriginalColors.clear();
     g_coloredCubeRotations.clear();
     g_attachedCubes.clear();
     g_itemProperties.clear();
-    for (int i = 0; i < g_numColoredCubes; i++) {
+    g_coloredCubeSizes.clear();
+    g_coloredCubeSizeX.clear();
+    g_coloredCubeSizeY.clear();
+    g_coloredCubeSizeZ.clear();
+    g_fpsCubeInstances.clear();
+    g_fpsCubeInstanceDirty.clear();
+    g_fpsCubeDirtyList.clear();
+    g_coloredCubeGrid.clear();
+    g_cubeTransforms.clear();
+    g_vehicleFrameNode = g_cubeTransforms.create();
+    
+    for (int i = 0; i < static_cast<int>(referenceCubes.size()); i++) {
         const auto& cube = referenceCubes[i];
-        g_coloredCubePositions.push_back({cube.x, cube.y, cube.z});
-        g_coloredCubeOriginalColors.push_back({cube.r, cube.g, cube.b});
-        g_coloredCubeRotations.push_back(0.0f);  // Initialize rotation to 0 degrees
-        g_attachedCubes.push_back({false, 0.0f, 0.0f, 0.0f});  // Initialize as not attached
-        
-        // Initialize item properties (all start as generic blocks)
-        ItemProperties props;
-        props.item_type_id = 0;      // 0 = generic block
-        props.item_name = "";        // Empty name by default
-        props.trade_value = 0.0f;    // Not tradeable by default
-        props.condition = 1.0f;      // Perfect condition
-        props.weight = 1.0f;         // Default weight
-        props.category = 0;          // Generic category
-        props.is_salvaged = false;   // Not salvaged
-        props.parent_index = -1;     // No parent by default
-        g_itemProperties.push_back(props);
         
         // Set sizes: first 9 are big (1.0), next 5 are small (0.5), last one is rectangle
+        float size = 1.0f, sizeX = 1.0f, sizeY = 1.0f, sizeZ = 1.0f;
         if (i < 9) {
             // Big cubes: 1x1x1
-            g_coloredCubeSizes[i] = 1.0f;
-            g_coloredCubeSizeX[i] = 1.0f;
-            g_coloredCubeSizeY[i] = 1.0f;
-            g_coloredCubeSizeZ[i] = 1.0f;
         } else if (i < 14) {
             // Small cubes: 0.5x0.5x0.5
-            g_coloredCubeSizes[i] = 0.5f;
-            g_coloredCubeSizeX[i] = 0.5f;
-            g_coloredCubeSizeY[i] = 0.5f;
-            g_coloredCubeSizeZ[i] = 0.5f;
+            size = sizeX = sizeY = sizeZ = 0.5f;
         } else if (i == 14) {
             // Blue rectangle: 4 units wide (X), 1 unit tall (Y), 10 units long (Z)
-            g_coloredCubeSizes[i] = 1.0f;  // Average size for compatibility
-            g_coloredCubeSizeX[i] = 4.0f;  // Width
-            g_coloredCubeSizeY[i] = 1.0f;  // Height
-            g_coloredCubeSizeZ[i] = 10.0f; // Length
+            size = 1.0f;   // Average size for compatibility
+            sizeX = 4.0f;  // Width
+            sizeY = 1.0f;  // Height
+            sizeZ = 10.0f; // Length
         } else if (i == 15) {
             // Pink block on vehicle: 0.5x0.5x0.5
-            g_coloredCubeSizes[i] = 0.5f;
-            g_coloredCubeSizeX[i] = 0.5f;
-            g_coloredCubeSizeY[i] = 0.5f;
-            g_coloredCubeSizeZ[i] = 0.5f;
+            size = sizeX = sizeY = sizeZ = 0.5f;
         } else if (i == 16) {
             // Ground cube: 50x1x50 (same size as starting floor cube: 50 units wide, 1 unit tall, 50 units deep)
-            g_coloredCubeSizes[i] = 1.0f;  // Average size for compatibility
-            g_coloredCubeSizeX[i] = 50.0f; // Width (same as starting floor)
-            g_coloredCubeSizeY[i] = 1.0f;  // Height (same as floor)
-            g_coloredCubeSizeZ[i] = 50.0f; // Depth (same as starting floor)
+            size = 1.0f;   // Average size for compatibility
+            sizeX = 50.0f; // Width (same as starting floor)
+            sizeY = 1.0f;  // Height (same as floor)
+            sizeZ = 50.0f; // Depth (same as starting floor)
         } else if (i == 17) {
             // Yellow building: 20x20x50 (20 units wide, 20 units deep, 50 units tall)
-            g_coloredCubeSizes[i] = 20.0f;  // Average size for compatibility
-            g_coloredCubeSizeX[i] = 20.0f;  // Width
-            g_coloredCubeSizeY[i] = 50.0f;  // Height (50 feet tall)
-            g_coloredCubeSizeZ[i] = 20.0f;  // Depth
-        }
-    }
-    
-    // Create vertex buffers for each colored cube
-    // Note: All vertices are created at size 1.0 (from -0.5 to 0.5), scaling is done in model matrix
-    for (int i = 0; i < g_numColoredCubes && i < 19; i++) {
-        // Create cube vertices with the specified color (always size 1.0, scaled in model matrix)
-        std::vector<Vertex> coloredCubeVertices = {
-            {{-0.5f, -0.5f,  0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
-            {{ 0.5f, -0.5f,  0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
-            {{ 0.5f,  0.5f,  0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
-            {{-0.5f,  0.5f,  0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
-            {{-0.5f, -0.5f, -0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
-            {{ 0.5f, -0.5f, -0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
-            {{ 0.5f,  0.5f, -0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
-            {{-0.5f,  0.5f, -0.5f}, {referenceCubes[i].r, referenceCubes[i].g, referenceCubes[i].b}},
+            size = 20.0f;   // Average size for compatibility
+            sizeX = 20.0f;  // Width
+            sizeY = 50.0f;  // Height (50 feet tall)
+            sizeZ = 20.0f;  // Depth
+        }
+        addColoredCube(cube.x, cube.y, cube.z, size, sizeX, sizeY, sizeZ, cube.r, cube.g, cube.b);
+    }
+    syncCubeTransforms();
+    
+    // Shared cube mesh for all colored cubes: white, size 1.0 (from -0.5 to 0.5); each instance
+    // scales, rotates and colors it (cube_instanced.vert)
+    if (g_fpsCubeVertexBufferWhite == VK_NULL_HANDLE) {
+        std::vector<Vertex> cubeVertices = {
+            {{-0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}},
+            {{ 0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}},
+            {{ 0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}},
+            {{-0.5f,  0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}},
+            {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}},
+            {{ 0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}},
+            {{ 0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}},
+            {{-0.5f,  0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}},
         };
         
-        VkDeviceSize vertexBufferSize = sizeof(coloredCubeVertices[0]) * coloredCubeVertices.size();
+        VkDeviceSize vertexBufferSize = sizeof(cubeVertices[0]) * cubeVertices.size();
         createBuffer(vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                     g_coloredCubeVertexBuffers[i], g_coloredCubeVertexBufferMemory[i]);
+                     g_fpsCubeVertexBufferWhite, g_fpsCubeVertexBufferWhiteMemory);
         
         void* data;
-        vkMapMemory(g_device, g_coloredCubeVertexBufferMemory[i], 0, vertexBufferSize, 0, &data);
-        memcpy(data, coloredCubeVertices.data(), (size_t)vertexBufferSize);
-        vkUnmapMemory(g_device, g_coloredCubeVertexBufferMemory[i]);
+        vkMapMemory(g_device, g_fpsCubeVertexBufferWhiteMemory, 0, vertexBufferSize, 0, &data);
+        memcpy(data, cubeVertices.data(), (size_t)vertexBufferSize);
+        vkUnmapMemory(g_device, g_fpsCubeVertexBufferWhiteMemory);
     }
     
     std::cout << "[FPS] Created " << g_numColoredCubes << " colored reference cubes" << std::endl;
@@ -2726,18 +2827,163 @@ extern "C" int heidic_init_renderer_fps(GLFWwindow* window) {
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_fpsPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_fpsPipeline) != VK_SUCCESS) {
         std::cerr << "[FPS] ERROR: Failed to create FPS graphics pipeline!" << std::endl;
         vkDestroyShaderModule(g_device, g_fpsFragShaderModule, nullptr);
         vkDestroyShaderModule(g_device, g_fpsVertShaderModule, nullptr);
         return 0;
     }
     
+    // Instanced colored cubes: same state and fragment shader, cube_instanced.vert reading the
+    // instance storage buffer (set 1) next to the shared UBO (set 0)
+    if (g_fpsInstancedPipeline == VK_NULL_HANDLE) {
+        std::vector<char> instancedVertCode;
+        try {
+            instancedVertCode = readFile("vert_cube_instanced.spv");
+        } catch (const std::exception&) {
+            std::cerr << "[FPS] WARNING: vert_cube_instanced.spv not found - colored cubes will not be drawn" << std::endl;
+        }
+        
+        if (!instancedVertCode.empty()) {
+            VkDescriptorSetLayoutBinding instanceBinding = {};
+            instanceBinding.binding = 0;
+            instanceBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            instanceBinding.descriptorCount = 1;
+            instanceBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+            
+            VkDescriptorSetLayoutCreateInfo instanceLayoutInfo = {};
+            instanceLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            instanceLayoutInfo.bindingCount = 1;
+            instanceLayoutInfo.pBindings = &instanceBinding;
+            
+            VkDescriptorPoolSize instancePoolSize = {};
+            instancePoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            instancePoolSize.descriptorCount = 1;
+            
+            VkDescriptorPoolCreateInfo instancePoolInfo = {};
+            instancePoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            instancePoolInfo.poolSizeCount = 1;
+            instancePoolInfo.pPoolSizes = &instancePoolSize;
+            instancePoolInfo.maxSets = 1;
+            
+            VkShaderModuleCreateInfo instancedVertInfo = {};
+            instancedVertInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            instancedVertInfo.codeSize = instancedVertCode.size();
+            instancedVertInfo.pCode = reinterpret_cast<const uint32_t*>(instancedVertCode.data());
+            
+            bool ok = vkCreateDescriptorSetLayout(g_device, &instanceLayoutInfo, nullptr, &g_fpsInstanceSetLayout) == VK_SUCCESS &&
+                      vkCreateDescriptorPool(g_device, &instancePoolInfo, nullptr, &g_fpsInstanceDescriptorPool) == VK_SUCCESS &&
+                      vkCreateShaderModule(g_device, &instancedVertInfo, nullptr, &g_fpsInstancedVertShaderModule) == VK_SUCCESS;
+            
+            if (ok) {
+                VkDescriptorSetAllocateInfo instanceSetInfo = {};
+                instanceSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+                instanceSetInfo.descriptorPool = g_fpsInstanceDescriptorPool;
+                instanceSetInfo.descriptorSetCount = 1;
+                instanceSetInfo.pSetLayouts = &g_fpsInstanceSetLayout;
+                
+                VkDescriptorSetLayout setLayouts[] = {g_descriptorSetLayout, g_fpsInstanceSetLayout};
+                VkPipelineLayoutCreateInfo instancedLayoutInfo = {};
+                instancedLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+                instancedLayoutInfo.setLayoutCount = 2;
+                instancedLayoutInfo.pSetLayouts = setLayouts;
+                
+                ok = vkAllocateDescriptorSets(g_device, &instanceSetInfo, &g_fpsInstanceDescriptorSet) == VK_SUCCESS &&
+                     vkCreatePipelineLayout(g_device, &instancedLayoutInfo, nullptr, &g_fpsInstancedPipelineLayout) == VK_SUCCESS;
+            }
+            
+            if (ok) {
+                shaderStages[0].module = g_fpsInstancedVertShaderModule;
+                pipelineInfo.layout = g_fpsInstancedPipelineLayout;
+                ok = vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_fpsInstancedPipeline) == VK_SUCCESS;
+                shaderStages[0].module = g_fpsVertShaderModule;
+                pipelineInfo.layout = g_pipelineLayout;
+            }
+            
+            if (ok) {
+                std::cout << "[FPS] Colored cubes use one instanced draw (vert_cube_instanced.spv)" << std::endl;
+            } else {
+                std::cerr << "[FPS] WARNING: Failed to create the instanced cube pipeline - colored cubes will not be drawn" << std::endl;
+                g_fpsInstancedPipeline = VK_NULL_HANDLE;
+            }
+        }
+    }
+    
     g_fpsInitialized = true;
     std::cout << "[FPS] FPS camera renderer initialized successfully!" << std::endl;
     return 1;
 }
 
+// Copy changed cube instances into the instance buffer. Called after the frame fence
+// wait, when the GPU is no longer reading it; grows the buffer (and rewrites
+// everything) when cubes were added past its capacity.
+static void flushFpsCubeInstances() {
+    uint32_t count = static_cast<uint32_t>(g_fpsCubeInstances.size());
+    if (g_fpsInstancedPipeline == VK_NULL_HANDLE || count == 0) {
+        return;
+    }
+    
+    if (count > g_fpsInstanceCapacity) {
+        if (g_fpsInstanceBuffer != VK_NULL_HANDLE) {
+            vkUnmapMemory(g_device, g_fpsInstanceBufferMemory);
+            vkDestroyBuffer(g_device, g_fpsInstanceBuffer, nullptr);
+            vkFreeMemory(g_device, g_fpsInstanceBufferMemory, nullptr);
+            g_fpsInstanceBuffer = VK_NULL_HANDLE;
+            g_fpsInstanceBufferMemory = VK_NULL_HANDLE;
+            g_fpsInstanceMapped = nullptr;
+        }
+        uint32_t capacity = std::max(64u, g_fpsInstanceCapacity);
+        while (capacity < count) capacity *= 2;
+        
+        VkDeviceSize bufferSize = sizeof(FpsCubeInstance) * capacity;
+        createBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     g_fpsInstanceBuffer, g_fpsInstanceBufferMemory);
+        void* mapped = nullptr;
+        if (g_fpsInstanceBuffer == VK_NULL_HANDLE ||
+            vkMapMemory(g_device, g_fpsInstanceBufferMemory, 0, bufferSize, 0, &mapped) != VK_SUCCESS) {
+            std::cerr << "[FPS] ERROR: Failed to create the cube instance buffer (" << capacity << " cubes)" << std::endl;
+            g_fpsInstanceCapacity = 0;
+            return;
+        }
+        g_fpsInstanceMapped = static_cast<FpsCubeInstance*>(mapped);
+        g_fpsInstanceCapacity = capacity;
+        
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = g_fpsInstanceBuffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = VK_WHOLE_SIZE;
+        
+        VkWriteDescriptorSet descriptorWrite = {};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = g_fpsInstanceDescriptorSet;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(g_device, 1, &descriptorWrite, 0, nullptr);
+        
+        memcpy(g_fpsInstanceMapped, g_fpsCubeInstances.data(), sizeof(FpsCubeInstance) * count);
+        std::fill(g_fpsCubeInstanceDirty.begin(), g_fpsCubeInstanceDirty.end(), 0);
+        g_fpsCubeDirtyList.clear();
+        return;
+    }
+    
+    // Transform and size are the first 32 bytes of an instance, color the last 16
+    for (uint32_t i : g_fpsCubeDirtyList) {
+        const FpsCubeInstance& instance = g_fpsCubeInstances[i];
+        FpsCubeInstance& gpu = g_fpsInstanceMapped[i];
+        if (g_fpsCubeInstanceDirty[i] & FPS_INSTANCE_TRANSFORM) {
+            memcpy(&gpu, &instance, offsetof(FpsCubeInstance, color));
+        }
+        if (g_fpsCubeInstanceDirty[i] & FPS_INSTANCE_COLOR) {
+            memcpy(gpu.color, instance.color, sizeof(instance.color));
+        }
+        g_fpsCubeInstanceDirty[i] = 0;
+    }
+    g_fpsCubeDirtyList.clear();
+}
+
 // Render FPS camera frame
 extern "C" void heidic_render_fps(GLFWwindow* window, float camera_pos_x, float camera_pos_y, float camera_pos_z, float camera_yaw, float camera_pitch) {
     if (g_device == VK_NULL_HANDLE || g_swapchain == VK_NULL_HANDLE) {
@@ -2755,6 +3001,9 @@ extern "C" void heidic_render_fps(GLFWwindow* window, float camera_pos_x, float
     vkWaitForFences(g_device, 1, &g_inFlightFence, VK_TRUE, UINT64_MAX);
     vkResetFences(g_device, 1, &g_inFlightFence);
     
+    // The previous frame is done reading cube instances
+    flushFpsCubeInstances();
+    
     // Acquire next image
     uint32_t imageIndex;
     vkAcquireNextImageKHR(g_device, g_swapchain, UINT64_MAX, g_imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
@@ -2883,44 +3132,21 @@ extern "C" void heidic_render_fps(GLFWwindow* window, float camera_pos_x, float
     // Draw floor cube using indexed drawing
     vkCmdDrawIndexed(g_commandBuffers[imageIndex], g_fpsCubeIndexCount, 1, 0, 0, 0);
     
-    // Draw multiple colored 1x1x1 cubes on top of the floor for spatial reference
-    // Use global mutable cube positions array (for pickup system)
-    
-    // Render colored cubes if they were created
-    for (int i = 0; i < g_numColoredCubes && i < static_cast<int>(g_coloredCubePositions.size()); i++) {
-        if (g_coloredCubeVertexBuffers[i] == VK_NULL_HANDLE) {
-            continue;
-        }
-        
-        // Model matrix: cube at the specified position with rotation
-        // Note: Vertices are created at size 1.0, so we need to scale them to the actual size
-        // Use per-axis sizes if available, otherwise use uniform size
-        // Transform order: translate, rotate (around Y axis), scale
-        float scaleX = g_coloredCubeSizeX[i] > 0.0f ? g_coloredCubeSizeX[i] : g_coloredCubeSizes[i];
-        float scaleY = g_coloredCubeSizeY[i] > 0.0f ? g_coloredCubeSizeY[i] : g_coloredCubeSizes[i];
-        float scaleZ = g_coloredCubeSizeZ[i] > 0.0f ? g_coloredCubeSizeZ[i] : g_coloredCubeSizes[i];
-        glm::mat4 cubeModel = glm::mat4(1.0f);
-        cubeModel = glm::translate(cubeModel, glm::vec3(g_coloredCubePositions[i].x, g_coloredCubePositions[i].y, g_coloredCubePositions[i].z));
-        // Apply rotation around Y axis (yaw) if cube has rotation set
-        if (i < static_cast<int>(g_coloredCubeRotations.size()) && g_coloredCubeRotations[i] != 0.0f) {
-            float yaw_rad = g_coloredCubeRotations[i] * 3.14159f / 180.0f;  // Convert degrees to radians
-            cubeModel = glm::rotate(cubeModel, yaw_rad, glm::vec3(0.0f, 1.0f, 0.0f));
-        }
-        cubeModel = glm::scale(cubeModel, glm::vec3(scaleX, scaleY, scaleZ));  // Scale to actual size (supports non-uniform)
+    // Draw the colored cubes on top of the floor: one instanced draw of the shared cube mesh,
+    // position/yaw/size/color per instance (see flushFpsCubeInstances)
+    uint32_t cubeCount = static_cast<uint32_t>(std::min<size_t>(g_fpsCubeInstances.size(), g_fpsInstanceCapacity));
+    if (g_fpsInstancedPipeline != VK_NULL_HANDLE && g_fpsInstanceBuffer != VK_NULL_HANDLE && cubeCount > 0) {
+        vkCmdBindPipeline(g_commandBuffers[imageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, g_fpsInstancedPipeline);
         
-        // Push model matrix as push constant (each draw gets its own matrix)
-        vkCmdPushConstants(g_commandBuffers[imageIndex], g_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &cubeModel);
-        
-        // Bind the colored cube's vertex buffer
-        VkBuffer vertexBuffers[] = {g_coloredCubeVertexBuffers[i]};
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(g_commandBuffers[imageIndex], 0, 1, vertexBuffers, offsets);
+        VkDescriptorSet cubeSets[] = {g_descriptorSets[imageIndex], g_fpsInstanceDescriptorSet};
+        vkCmdBindDescriptorSets(g_commandBuffers[imageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, g_fpsInstancedPipelineLayout, 0, 2, cubeSets, 0, nullptr);
         
-        // Rebind index buffer (same indices work for all cubes - 36 indices for a cube)
+        VkBuffer cubeVertexBuffers[] = {g_fpsCubeVertexBufferWhite};
+        vkCmdBindVertexBuffers(g_commandBuffers[imageIndex], 0, 1, cubeVertexBuffers, offsets);
         vkCmdBindIndexBuffer(g_commandBuffers[imageIndex], g_fpsCubeIndexBuffer, 0, VK_INDEX_TYPE_UINT16);
         
-        // Draw the cube (36 indices for a cube: 6 faces * 2 triangles * 3 vertices)
-        vkCmdDrawIndexed(g_commandBuffers[imageIndex], 36, 1, 0, 0, 0);
+        // 36 indices for a cube: 6 faces * 2 triangles * 3 vertices
+        vkCmdDrawIndexed(g_commandBuffers[imageIndex], 36, cubeCount, 0, 0, 0);
     }
     
     // Render Neuroshell UI (includes crosshair)
@@ -2998,19 +3224,59 @@ extern "C" void heidic_cleanup_renderer_fps() {
             g_fpsCubeVertexBufferMemory = VK_NULL_HANDLE;
         }
         
-        // Cleanup colored cube buffers
-        for (int i = 0; i < g_numColoredCubes && i < 10; i++) {
-            if (g_coloredCubeVertexBuffers[i] != VK_NULL_HANDLE) {
-                vkDestroyBuffer(g_device, g_coloredCubeVertexBuffers[i], nullptr);
-                g_coloredCubeVertexBuffers[i] = VK_NULL_HANDLE;
-            }
-            if (g_coloredCubeVertexBufferMemory[i] != VK_NULL_HANDLE) {
-                vkFreeMemory(g_device, g_coloredCubeVertexBufferMemory[i], nullptr);
-                g_coloredCubeVertexBufferMemory[i] = VK_NULL_HANDLE;
-            }
-        }
+        // Cleanup colored cube instancing
+        if (g_fpsCubeVertexBufferWhite != VK_NULL_HANDLE) {
+            vkDestroyBuffer(g_device, g_fpsCubeVertexBufferWhite, nullptr);
+            g_fpsCubeVertexBufferWhite = VK_NULL_HANDLE;
+        }
+        if (g_fpsCubeVertexBufferWhiteMemory != VK_NULL_HANDLE) {
+            vkFreeMemory(g_device, g_fpsCubeVertexBufferWhiteMemory, nullptr);
+            g_fpsCubeVertexBufferWhiteMemory = VK_NULL_HANDLE;
+        }
+        if (g_fpsInstanceBuffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(g_device, g_fpsInstanceBuffer, nullptr);
+            g_fpsInstanceBuffer = VK_NULL_HANDLE;
+        }
+        if (g_fpsInstanceBufferMemory != VK_NULL_HANDLE) {
+            vkFreeMemory(g_device, g_fpsInstanceBufferMemory, nullptr);  // Unmaps
+            g_fpsInstanceBufferMemory = VK_NULL_HANDLE;
+        }
+        g_fpsInstanceMapped = nullptr;
+        g_fpsInstanceCapacity = 0;
+        if (g_fpsInstancedPipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(g_device, g_fpsInstancedPipeline, nullptr);
+            g_fpsInstancedPipeline = VK_NULL_HANDLE;
+        }
+        if (g_fpsInstancedPipelineLayout != VK_NULL_HANDLE) {
+            vkDestroyPipelineLayout(g_device, g_fpsInstancedPipelineLayout, nullptr);
+            g_fpsInstancedPipelineLayout = VK_NULL_HANDLE;
+        }
+        if (g_fpsInstanceDescriptorPool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(g_device, g_fpsInstanceDescriptorPool, nullptr);  // Frees the set
+            g_fpsInstanceDescriptorPool = VK_NULL_HANDLE;
+            g_fpsInstanceDescriptorSet = VK_NULL_HANDLE;
+        }
+        if (g_fpsInstanceSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(g_device, g_fpsInstanceSetLayout, nullptr);
+            g_fpsInstanceSetLayout = VK_NULL_HANDLE;
+        }
+        if (g_fpsInstancedVertShaderModule != VK_NULL_HANDLE) {
+            vkDestroyShaderModule(g_device, g_fpsInstancedVertShaderModule, nullptr);
+            g_fpsInstancedVertShaderModule = VK_NULL_HANDLE;
+        }
+        g_fpsCubeInstances.clear();
+        g_fpsCubeInstanceDirty.clear();
+        g_fpsCubeDirtyList.clear();
+        g_coloredCubeSizes.clear();
+        g_coloredCubeSizeX.clear();
+        g_coloredCubeSizeY.clear();
+        g_coloredCubeSizeZ.clear();
+        g_coloredCubeOriginalColors.clear();
         g_numColoredCubes = 0;
         g_coloredCubePositions.clear();
+        g_coloredCubeGrid.clear();
+        g_cubeTransforms.clear();
+        g_vehicleFrameNode = eden::TransformHierarchy::INVALID;
         g_coloredCubeRotations.clear();
         g_attachedCubes.clear();
         g_itemProperties.clear();
@@ -3237,12 +3503,41 @@ extern "C" Vec3 heidic_get_cube_position(int cube_index) {
     }
 }
 
+// Add a cube (after heidic_init_renderer_fps) - returns its index, or -1
+extern "C" int heidic_add_cube(float x, float y, float z, float size_x, float size_y, float size_z, float r, float g, float b) {
+    if (!g_cubeTransforms.valid(g_vehicleFrameNode)) {
+        std::cerr << "[FPS] ERROR: heidic_add_cube called before heidic_init_renderer_fps" << std::endl;
+        return -1;
+    }
+    float size = (size_x + size_y + size_z) / 3.0f;  // Average size for compatibility
+    int cube_index = addColoredCube(x, y, z, size, size_x, size_y, size_z, r, g, b);
+    syncCubeTransforms();
+    return cube_index;
+}
+
+// Number of colored cubes (reference cubes plus added ones)
+extern "C" int heidic_get_cube_count() {
+    return g_numColoredCubes;
+}
+
 // Set cube position (for HEIDIC to update picked-up cube)
 extern "C" void heidic_set_cube_position(int cube_index, float x, float y, float z) {
     if (cube_index >= 0 && cube_index < static_cast<int>(g_coloredCubePositions.size())) {
         g_coloredCubePositions[cube_index].x = x;
         g_coloredCubePositions[cube_index].y = y;
         g_coloredCubePositions[cube_index].z = z;
+        coloredCubeMoved(cube_index);
+        
+        // Children follow; a child itself gets the local offset that puts it here
+        uint32_t node = cubeNode(cube_index);
+        if (g_cubeTransforms.valid(node)) {
+            eden::Transform world = g_cubeTransforms.computeWorld(node);
+            world.position[0] = x;
+            world.position[1] = y;
+            world.position[2] = z;
+            g_cubeTransforms.setWorld(node, world);
+            syncCubeTransforms();
+        }
     } else {
         std::cout << "[CUBE_POS] ERROR: Invalid cube_index " << cube_index 
                   << " (size=" << g_coloredCubePositions.size() << ")" << std::endl;
@@ -3253,6 +3548,15 @@ extern "C" void heidic_set_cube_position(int cube_index, float x, float y, float
 extern "C" void heidic_set_cube_rotation(int cube_index, float yaw_degrees) {
     if (cube_index >= 0 && cube_index < static_cast<int>(g_coloredCubeRotations.size())) {
         g_coloredCubeRotations[cube_index] = yaw_degrees;
+        coloredCubeMoved(cube_index);
+        
+        uint32_t node = cubeNode(cube_index);
+        if (g_cubeTransforms.valid(node)) {
+            eden::Transform world = g_cubeTransforms.computeWorld(node);
+            world.yawDegrees = yaw_degrees;
+            g_cubeTransforms.setWorld(node, world);
+            syncCubeTransforms();
+        }
     } else {
         std::cout << "[CUBE_ROT] ERROR: Invalid cube_index " << cube_index 
                   << " (size=" << g_coloredCubeRotations.size() << ")" << std::endl;
@@ -3261,27 +3565,13 @@ extern "C" void heidic_set_cube_rotation(int cube_index, float yaw_degrees) {
 
 // Set cube color (for visual feedback when selected/picked up)
 extern "C" void heidic_set_cube_color(int cube_index, float r, float g, float b) {
-    if (cube_index >= 0 && cube_index < g_numColoredCubes && 
-        cube_index < static_cast<int>(g_coloredCubeOriginalColors.size()) &&
-        g_coloredCubeVertexBuffers[cube_index] != VK_NULL_HANDLE) {
-        
-        // Update vertex buffer with new color
-        std::vector<Vertex> coloredCubeVertices = {
-            {{-0.5f, -0.5f,  0.5f}, {r, g, b}},
-            {{ 0.5f, -0.5f,  0.5f}, {r, g, b}},
-            {{ 0.5f,  0.5f,  0.5f}, {r, g, b}},
-            {{-0.5f,  0.5f,  0.5f}, {r, g, b}},
-            {{-0.5f, -0.5f, -0.5f}, {r, g, b}},
-            {{ 0.5f, -0.5f, -0.5f}, {r, g, b}},
-            {{ 0.5f,  0.5f, -0.5f}, {r, g, b}},
-            {{-0.5f,  0.5f, -0.5f}, {r, g, b}},
-        };
-        
-        VkDeviceSize vertexBufferSize = sizeof(coloredCubeVertices[0]) * coloredCubeVertices.size();
-        void* data;
-        vkMapMemory(g_device, g_coloredCubeVertexBufferMemory[cube_index], 0, vertexBufferSize, 0, &data);
-        memcpy(data, coloredCubeVertices.data(), (size_t)vertexBufferSize);
-        vkUnmapMemory(g_device, g_coloredCubeVertexBufferMemory[cube_index]);
+    if (cube_index >= 0 && cube_index < static_cast<int>(g_fpsCubeInstances.size())) {
+        // 16 bytes into the instance buffer on the next frame
+        float* color = g_fpsCubeInstances[cube_index].color;
+        color[0] = r;
+        color[1] = g;
+        color[2] = b;
+        markFpsCubeDirty(cube_index, FPS_INSTANCE_COLOR);
     }
 }
 
@@ -3302,9 +3592,11 @@ extern "C" void heidic_restore_cube_color(int cube_index) {
 extern "C" void heidic_attach_cube_to_vehicle(int cube_index, float local_x, float local_y, float local_z) {
     if (cube_index >= 0 && cube_index < static_cast<int>(g_attachedCubes.size())) {
         g_attachedCubes[cube_index].attached = true;
-        g_attachedCubes[cube_index].local_x = local_x;
-        g_attachedCubes[cube_index].local_y = local_y;
-        g_attachedCubes[cube_index].local_z = local_z;
+        
+        // Child of the vehicle's top surface; it moves there on the next heidic_update_attached_cubes
+        uint32_t node = cubeNode(cube_index);
+        g_cubeTransforms.setParent(node, g_vehicleFrameNode, false);
+        g_cubeTransforms.setLocal(node, {{local_x, local_y, local_z}, 0.0f});
         
         // Set parent relationship (vehicle is index 14)
         if (cube_index >= 0 && cube_index < static_cast<int>(g_itemProperties.size())) {
@@ -3321,6 +3613,7 @@ extern "C" void heidic_detach_cube_from_vehicle(int cube_index) {
     if (cube_index >= 0 && cube_index < static_cast<int>(g_attachedCubes.size())) {
         if (g_attachedCubes[cube_index].attached) {
             g_attachedCubes[cube_index].attached = false;
+            g_cubeTransforms.setParent(cubeNode(cube_index), eden::TransformHierarchy::INVALID);
             
             // Clear parent relationship (unless it's the helm, which should always be child of vehicle)
             if (cube_index >= 0 && cube_index < static_cast<int>(g_itemProperties.size()) && cube_index != 15) {
@@ -3439,8 +3732,15 @@ extern "C" const char* heidic_get_item_name(int cube_index) {
 }
 
 // Set parent cube index (for hierarchical relationships)
+// The cube stays where it is and from then on moves with its parent;
+// ignored if the parent is one of the cube's own children
 extern "C" void heidic_set_item_parent(int cube_index, int parent_index) {
     if (cube_index >= 0 && cube_index < static_cast<int>(g_itemProperties.size())) {
+        uint32_t node = cubeNode(cube_index);
+        uint32_t parent = parent_index >= 0 && parent_index < g_numColoredCubes ? cubeNode(parent_index) : eden::TransformHierarchy::INVALID;
+        if (g_cubeTransforms.valid(node) && !g_cubeTransforms.setParent(node, parent)) {
+            return;
+        }
         g_itemProperties[cube_index].parent_index = parent_index;
     }
 }
@@ -3458,35 +3758,13 @@ extern "C" int heidic_get_item_parent(int cube_index) {
 // vehicle_yaw: vehicle yaw in degrees
 // vehicle_size_y: vehicle height (to calculate top surface)
 extern "C" void heidic_update_attached_cubes(float vehicle_x, float vehicle_y, float vehicle_z, float vehicle_yaw, float vehicle_size_y) {
-    float yaw_rad = vehicle_yaw * 3.14159f / 180.0f;
-    float cos_yaw = cosf(yaw_rad);
-    float sin_yaw = sinf(yaw_rad);
+    if (!g_cubeTransforms.valid(g_vehicleFrameNode)) return;
     float vehicle_top = vehicle_y + (vehicle_size_y / 2.0f);
     
-    for (int i = 0; i < static_cast<int>(g_attachedCubes.size()); i++) {
-        if (g_attachedCubes[i].attached) {
-            // Rotate local offset by vehicle yaw to get world offset
-            // x' = local_x * cos(yaw) + local_z * sin(yaw)
-            // z' = -local_x * sin(yaw) + local_z * cos(yaw)
-            float world_offset_x = g_attachedCubes[i].local_x * cos_yaw + g_attachedCubes[i].local_z * sin_yaw;
-            float world_offset_z = -g_attachedCubes[i].local_x * sin_yaw + g_attachedCubes[i].local_z * cos_yaw;
-            
-            // Calculate world position
-            float new_x = vehicle_x + world_offset_x;
-            float new_y = vehicle_top + g_attachedCubes[i].local_y;
-            float new_z = vehicle_z + world_offset_z;
-            
-            // Update cube position
-            g_coloredCubePositions[i].x = new_x;
-            g_coloredCubePositions[i].y = new_y;
-            g_coloredCubePositions[i].z = new_z;
-            
-            // Update cube rotation to match vehicle
-            if (i < static_cast<int>(g_coloredCubeRotations.size())) {
-                g_coloredCubeRotations[i] = vehicle_yaw;
-            }
-        }
-    }
+    // Attached cubes are children of the vehicle's top surface: their local offsets turn with
+    // the vehicle yaw, and only the vehicle's subtree is recomputed and copied back
+    g_cubeTransforms.setLocal(g_vehicleFrameNode, {{vehicle_x, vehicle_top, vehicle_z}, vehicle_yaw});
+    syncCubeTransforms();
 }
 
 // Cast ray downward from position and return distance to floor (or -1 if no hit)
@@ -3520,48 +3798,19 @@ extern "C" float heidic_raycast_downward_distance(float x, float y, float z) {
 // Cast ray downward from position and return index of big cube hit (or -1 if no hit or hit small cube)
 extern "C" int heidic_raycast_downward_big_cube(float x, float y, float z) {
     // Ray origin: position
-    glm::vec3 rayOrigin(x, y, z);
+    float rayOrigin[3] = {x, y, z};
     // Ray direction: straight down (negative Y)
-    glm::vec3 rayDir(0.0f, -1.0f, 0.0f);
+    float rayDir[3] = {0.0f, -1.0f, 0.0f};
     
-    int closestHitIndex = -1;
-    float closestT = 1000.0f;  // Large initial distance
-    
-    // Test all cubes (check all cubes, not just first 9)
+    // Only the cubes in the grid cells under the position are tested
     // Skip vehicle (index 14), helm (index 15), and ground platform (index 16) as they're special
     // But include building (index 17) and all other cubes
-    for (int i = 0; i < g_numColoredCubes; i++) {
-        // Skip vehicle, helm, and ground platform (they're handled separately or shouldn't be stepped on)
-        if (i == 14 || i == 15 || i == 16) {
-            continue;
-        }
-        
-        // Check if cube has size >= 1.0 (big cube) or use per-axis sizes for rectangles
-        float cubeSize = g_coloredCubeSizes[i];
-        float sizeX = g_coloredCubeSizeX[i];
-        float sizeY = g_coloredCubeSizeY[i];
-        float sizeZ = g_coloredCubeSizeZ[i];
-        
-        // Use per-axis sizes if available (for rectangles), otherwise use uniform size
-        AABB cubeBox = createCubeAABB(
-            g_coloredCubePositions[i].x,
-            g_coloredCubePositions[i].y,
-            g_coloredCubePositions[i].z,
-            sizeX > 0.0f ? sizeX : cubeSize,
-            sizeY > 0.0f ? sizeY : cubeSize,
-            sizeZ > 0.0f ? sizeZ : cubeSize
-        );
-        
-        float tMin, tMax;
-        if (rayAABB(rayOrigin, rayDir, cubeBox, tMin, tMax)) {
-            if (tMin >= 0.0f && tMin < closestT) {
-                closestT = tMin;
-                closestHitIndex = i;
-            }
-        }
-    }
+    float closestT = 0.0f;
+    uint32_t hit = g_coloredCubeGrid.raycast(rayOrigin, rayDir, 1000.0f, closestT, [](uint32_t i) {
+        return i < static_cast<uint32_t>(g_numColoredCubes) && i != 14 && i != 15 && i != 16;
+    });
     
-    return closestHitIndex;
+    return hit == eden::ObjectGrid::INVALID ? -1 : static_cast<int>(hit);
 }
 
 // Get cube size (1.0 for big, 0.5 for small, or average for rectangles)
@@ -3642,6 +3891,7 @@ extern "C" void heidic_cleanup_renderer_cube() {
     
     if (g_device != VK_NULL_HANDLE) {
         vkDeviceWaitIdle(g_device);
+        dropShaderReloads();
         
         if (g_cubeIndexBuffer != VK_NULL_HANDLE) {
             vkDestroyBuffer(g_device, g_cubeIndexBuffer, nullptr);
@@ -3802,6 +4052,14 @@ extern "C" void heidic_imgui_render_demo_overlay(float fps, float camera_x, floa
     ImGui::End();
 }
 
+// Per-system timings and last-frame flame view from code compiled with
+// `heidic_v2 compile --profile`
+extern "C" void heidic_imgui_render_profiler_overlay() {
+    if (!g_imguiInitialized) return;
+    SystemProfiler::draw_imgui();
+    SystemProfiler::draw_flame_imgui();
+}
+
 // Cleanup ImGui
 extern "C" void heidic_cleanup_imgui() {
     if (!g_imguiInitialized) return;
@@ -3831,6 +4089,7 @@ extern "C" int heidic_init_imgui(GLFWwindow* window) {
 
 extern "C" void heidic_imgui_new_frame() {}
 extern "C" void heidic_imgui_render(VkCommandBuffer commandBuffer) {}
+extern "C" void heidic_imgui_render_profiler_overlay() {}
 extern "C" void heidic_cleanup_imgui() {}
 
 #endif // USE_IMGUI
@@ -4042,7 +4301,7 @@ extern "C" int heidic_init_renderer_balls(GLFWwindow* window) {
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_ballsPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_ballsPipeline) != VK_SUCCESS) {
         std::cerr << "[EDEN] Failed to create graphics pipeline for balls" << std::endl;
         vkDestroyPipelineLayout(g_device, g_pipelineLayout, nullptr);
         vkDestroyShaderModule(g_device, fragShaderModule, nullptr);
@@ -4445,19 +4704,11 @@ extern "C" int heidic_init_renderer_dds_quad(GLFWwindow* window, const char* dds
     vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
                          0, 0, nullptr, 0, nullptr, 1, &barrier);
 
-    // Copy buffer to image (for compressed formats, we copy raw blocks)
-    VkBufferImageCopy region = {};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {ddsData.width, ddsData.height, 1};
+    // Copy buffer to image (for compressed formats, we copy raw blocks), every mip level
+    std::vector<VkBufferImageCopy> regions = dds_copy_regions(ddsData);
 
-    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, g_ddsQuadImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, g_ddsQuadImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data());
 
     // Transition image layout to shader-readable
     barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
@@ -4806,7 +5057,7 @@ extern "C" int heidic_init_renderer_dds_quad(GLFWwindow* window, const char* dds
     pipelineInfo.renderPass = g_renderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_ddsQuadPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_ddsQuadPipeline) != VK_SUCCESS) {
         std::cerr << "[DDS] ERROR: Failed to create graphics pipeline!" << std::endl;
         vkDestroyPipelineLayout(g_device, g_ddsQuadPipelineLayout, nullptr);
         vkDestroyShaderModule(g_device, g_ddsQuadFragShaderModule, nullptr);
@@ -5492,7 +5743,7 @@ extern "C" int heidic_init_renderer_png_quad(GLFWwindow* window, const char* png
     pipelineInfo.renderPass = g_renderPass;
     pipelineInfo.subpass = 0;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_pngQuadPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_pngQuadPipeline) != VK_SUCCESS) {
         std::cerr << "[PNG] ERROR: Failed to create graphics pipeline!" << std::endl;
         vkDestroyPipelineLayout(g_device, g_pngQuadPipelineLayout, nullptr);
         vkDestroyShaderModule(g_device, g_pngQuadFragShaderModule, nullptr);
@@ -5716,9 +5967,7 @@ extern "C" int heidic_init_renderer_texture_quad(GLFWwindow* window, const char*
     bool found = false;
     for (const auto& testPath : testPaths) {
         std::cout << "  - " << testPath;
-        std::ifstream testFile(testPath, std::ios::binary);
-        if (testFile.is_open()) {
-            testFile.close();
+        if (Vfs::shared().exists(testPath)) {
             actualPath = testPath;
             found = true;
             std::cout << " [FOUND]" << std::endl;
@@ -6016,7 +6265,7 @@ extern "C" int heidic_init_renderer_texture_quad(GLFWwindow* window, const char*
     pipelineInfo.renderPass = g_renderPass;
     pipelineInfo.subpass = 0;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_textureResourceQuadPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_textureResourceQuadPipeline) != VK_SUCCESS) {
         std::cerr << "[TextureResource] ERROR: Failed to create graphics pipeline!" << std::endl;
         vkDestroyPipelineLayout(g_device, g_textureResourceQuadPipelineLayout, nullptr);
         vkDestroyShaderModule(g_device, g_textureResourceQuadFragShaderModule, nullptr);
@@ -6648,7 +6897,7 @@ extern "C" int heidic_init_renderer_obj_mesh(GLFWwindow* window, const char* obj
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_objMeshPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_objMeshPipeline) != VK_SUCCESS) {
         std::cerr << "[EDEN] ERROR: Failed to create graphics pipeline!" << std::endl;
         vkDestroyDescriptorPool(g_device, g_objMeshDescriptorPool, nullptr);
         vkDestroySampler(g_device, g_objMeshDummySampler, nullptr);
@@ -6663,7 +6912,7 @@ extern "C" int heidic_init_renderer_obj_mesh(GLFWwindow* window, const char* obj
     // Create wireframe pipeline (same as fill pipeline but with VK_POLYGON_MODE_LINE)
     rasterizer.polygonMode = VK_POLYGON_MODE_LINE;
     rasterizer.lineWidth = 1.0f;  // Wireframe line width
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_objMeshWireframePipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_objMeshWireframePipeline) != VK_SUCCESS) {
         std::cerr << "[EDEN] WARNING: Failed to create wireframe pipeline (wireframe mode will be unavailable)" << std::endl;
         // Don't fail initialization if wireframe pipeline fails
     } else {
@@ -7347,10 +7596,34 @@ static std::vector<std::array<uint32_t, 4>> g_eseReconstructedQuads;  // Reconst
 // Quad edge structure (edges that are on quad perimeters, not internal diagonals)
 struct QuadEdge {
     uint32_t v0, v1;           // Vertex indices
-    std::vector<int> quadIndices;  // Which quads contain this edge
+    uint32_t halfEdge;         // In g_eseTopology, running v0 -> v1
+    int quads[2];              // Quads on either side (-1 = none)
     int edgeInQuad;            // Edge index within the first quad (0-3)
 };
 static std::vector<QuadEdge> g_eseQuadEdges;  // All quad perimeter edges
+
+// Topology the quad/edge views are derived from; extrusion and edge loops
+// edit it in place and regenerate the index buffer from it
+static eden::HalfEdgeMesh g_eseTopology;
+static std::vector<uint32_t> g_eseQuadFaces;  // Topology face of each reconstructed quad
+static std::vector<int> g_eseFaceQuads;       // Reconstructed quad of each topology face (-1 = triangle)
+static std::vector<int> g_eseHalfEdgeQuadEdges;  // Quad edge of each topology half-edge (-1 = none)
+
+// Triangle BVH over the mesh for picking: refitted when a drag ends,
+// rebuilt after the triangles change (cleared, then ese_pick_bvh())
+static eden::MeshBVH g_eseBVH;
+static const MeshResource* g_eseBVHMesh = nullptr;  // Mesh it was built over
+static bool g_eseBVHStale = false;  // Vertices moved since the last refit
+
+// Coincident-vertex hash over the mesh positions, built once per operation
+// and shared by the topology build and the gizmo drag; marked stale
+// wherever the BVH is cleared or refitted
+static eden::PositionHash g_esePositions;
+static bool g_esePositionsStale = true;
+// Every copy of the dragged vertices with their one-ring, found when the
+// drag starts: each frame moves, renormals and uploads only that
+static eden::VertexEditRegion g_eseDragRegion;
+static bool g_eseDragVerticesReady = false;
 static size_t g_eseLastQuadEdgeIndexCount = 0;  // For detecting when to rebuild
 
 // Multi-selection support (Ctrl+click to add to selection)
@@ -7358,8 +7631,102 @@ static std::set<int> g_eseSelectedVertices;  // Multiple selected vertices
 static std::set<int> g_eseSelectedEdges;     // Multiple selected quad edges
 static std::set<int> g_eseSelectedQuads;     // Multiple selected quads
 
-// Quad reconstruction tracking (global so it can be reset by undo)
-static size_t g_eseLastQuadIndexCount = 0;
+// Quad reconstruction tracking (global so it can be reset by undo)
+static size_t g_eseLastQuadIndexCount = 0;
+
+// Rebuild the quad and quad-edge lists from g_eseTopology: one pass over
+// its faces, after it was built or edited
+static void ese_refresh_quad_views() {
+    g_eseReconstructedQuads.clear();
+    g_eseQuadFaces.clear();
+    g_eseQuadEdges.clear();
+    
+    g_eseFaceQuads.assign(g_eseTopology.faceCount(), -1);
+    g_eseHalfEdgeQuadEdges.assign(g_eseTopology.halfEdgeCount(), -1);
+    for (uint32_t face = 0; face < g_eseTopology.faceCount(); face++) {
+        if (g_eseTopology.faceSize(face) != 4) continue;
+        g_eseFaceQuads[face] = (int)g_eseReconstructedQuads.size();
+        std::array<uint32_t, 4> quad;
+        int corner = 0;
+        g_eseTopology.forEachFaceHalfEdge(face, [&](uint32_t h) { quad[corner++] = g_eseTopology.halfEdge(h).vertex; });
+        g_eseReconstructedQuads.push_back(quad);
+        g_eseQuadFaces.push_back(face);
+    }
+    
+    // Each quad perimeter edge once: from the lower half-edge when both
+    // sides are quads, else from the quad side
+    for (int qi = 0; qi < (int)g_eseQuadFaces.size(); qi++) {
+        int e = 0;
+        g_eseTopology.forEachFaceHalfEdge(g_eseQuadFaces[qi], [&](uint32_t h) {
+            const eden::HalfEdgeMesh::HalfEdge& he = g_eseTopology.halfEdge(h);
+            int other = he.twin != eden::HalfEdgeMesh::INVALID ? g_eseFaceQuads[g_eseTopology.halfEdge(he.twin).face] : -1;
+            if (other < 0 || h < he.twin) {
+                g_eseHalfEdgeQuadEdges[h] = (int)g_eseQuadEdges.size();
+                if (other >= 0) g_eseHalfEdgeQuadEdges[he.twin] = (int)g_eseQuadEdges.size();
+                QuadEdge qe;
+                qe.v0 = he.vertex;
+                qe.v1 = g_eseTopology.target(h);
+                qe.halfEdge = h;
+                qe.quads[0] = qi;
+                qe.quads[1] = other;
+                qe.edgeInQuad = e;
+                g_eseQuadEdges.push_back(qe);
+            }
+            e++;
+        });
+    }
+}
+
+// The picking BVH for the current mesh: built for a new mesh or when it no
+// longer matches the vertex and triangle counts, refitted once after
+// vertices moved
+static const eden::MeshBVH& ese_pick_bvh() {
+    const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
+    const std::vector<uint32_t>& indices = g_objMeshResource->getIndices();
+    
+    if (g_eseBVHMesh != g_objMeshResource.get() || !g_eseBVH.matches(vertices.size(), indices.size()) ||
+        g_eseBVH.empty()) {
+        g_eseBVHMesh = g_objMeshResource.get();
+        auto start = std::chrono::high_resolution_clock::now();
+        if (!g_eseBVH.build(vertices, indices)) {
+            std::cerr << "[ESE] Mesh has out-of-range indices - nothing to pick" << std::endl;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "[ESE] Picking BVH: " << g_eseBVH.nodeCount() << " nodes over " << g_eseBVH.triangleCount()
+                  << " triangles in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    } else if (g_eseBVHStale) {
+        g_eseBVH.refit(vertices, indices);
+    }
+    g_eseBVHStale = false;
+    return g_eseBVH;
+}
+
+// The position hash for the current vertices, rebuilt after they changed
+static const eden::PositionHash& ese_position_hash() {
+    const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
+    if (g_esePositionsStale || g_esePositions.vertexCount() != vertices.size()) {
+        g_esePositions.build(vertices);
+        g_esePositionsStale = false;
+    }
+    return g_esePositions;
+}
+
+// Candidate quad edges near a ray, ascending: edges of the quads whose
+// triangles the BVH finds within the pick cone. False if the topology does
+// not describe the index buffer (every edge is then a candidate).
+static bool ese_quad_edges_near_ray(const glm::vec3& origin, const glm::vec3& dir, float slope, std::vector<int>& edges) {
+    const std::vector<uint32_t>& triangleFaces = g_eseTopology.triangleFaces();
+    if (triangleFaces.size() != g_objMeshResource->getIndices().size() / 3) return false;
+    
+    ese_pick_bvh().forEachNearRay(&origin.x, &dir.x, slope, [&](uint32_t tri) {
+        g_eseTopology.forEachFaceHalfEdge(triangleFaces[tri], [&](uint32_t h) {
+            if (h < g_eseHalfEdgeQuadEdges.size() && g_eseHalfEdgeQuadEdges[h] >= 0) edges.push_back(g_eseHalfEdgeQuadEdges[h]);
+        });
+    });
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return true;
+}
 
 // Move gizmo state
 static int g_eseGizmoDragAxis = -1;        // -1=none, 0=X, 1=Y, 2=Z
@@ -7377,49 +7744,59 @@ static bool g_eseExtrudeMode = false;      // W key enables extrude for next ope
 static bool g_eseExtrudeExecuted = false;  // Has extrusion been performed this drag?
 static std::vector<uint32_t> g_eseExtrudedVertices;  // Indices of extruded vertices to move
 
-// Undo system - stores previous mesh state
+// Undo system - the newest saved state in full, older ones as sparse deltas
+// (each turns the state saved after it back into itself)
 struct MeshState {
     std::vector<MeshVertex> vertices;
     std::vector<uint32_t> indices;
     bool valid = false;
 };
-static std::vector<MeshState> g_eseUndoStack;
 static const size_t MAX_UNDO_LEVELS = 20;
+static const size_t UNDO_BUDGET_BYTES = 256 * 1024 * 1024;
+static MeshState g_eseUndoLatest;
+static eden::UndoHistory g_eseUndoHistory(MAX_UNDO_LEVELS - 1, UNDO_BUDGET_BYTES);
+
+static size_t ese_undo_count() {
+    return g_eseUndoLatest.valid ? g_eseUndoHistory.size() + 1 : 0;
+}
 
 static void ese_save_undo_state() {
     if (!g_objMeshResource) return;
     
-    MeshState state;
-    state.vertices = g_objMeshResource->getVertices();
-    state.indices = g_objMeshResource->getIndices();
-    state.valid = true;
-    
-    g_eseUndoStack.push_back(state);
+    const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
+    const std::vector<uint32_t>& indices = g_objMeshResource->getIndices();
     
-    // Limit undo stack size
-    while (g_eseUndoStack.size() > MAX_UNDO_LEVELS) {
-        g_eseUndoStack.erase(g_eseUndoStack.begin());
+    // What the last edit changed, recorded backwards
+    if (g_eseUndoLatest.valid) {
+        g_eseUndoHistory.push({eden::SparseDelta::diff(vertices, g_eseUndoLatest.vertices),
+                               eden::SparseDelta::diff(indices, g_eseUndoLatest.indices)});
     }
+    g_eseUndoLatest.vertices = vertices;
+    g_eseUndoLatest.indices = indices;
+    g_eseUndoLatest.valid = true;
     
-    std::cout << "[ESE] Saved undo state (stack size: " << g_eseUndoStack.size() << ")" << std::endl;
+    std::cout << "[ESE] Saved undo state (stack size: " << ese_undo_count()
+              << ", " << (g_eseUndoHistory.memoryUsage() / 1024) << " KB of deltas)" << std::endl;
 }
 
 static bool ese_undo() {
-    if (g_eseUndoStack.empty() || !g_objMeshResource) {
+    if (!g_eseUndoLatest.valid || !g_objMeshResource) {
         std::cout << "[ESE] Nothing to undo" << std::endl;
         return false;
     }
     
-    MeshState& state = g_eseUndoStack.back();
-    
     // Restore mesh state
     std::vector<MeshVertex>& vertices = g_objMeshResource->getVerticesMutable();
     std::vector<uint32_t>& indices = g_objMeshResource->getIndicesMutable();
     
-    vertices = state.vertices;
-    indices = state.indices;
+    vertices = g_eseUndoLatest.vertices;
+    indices = g_eseUndoLatest.indices;
     
-    g_eseUndoStack.pop_back();
+    // Step the full copy back to the state saved before it
+    std::vector<eden::SparseDelta> step;
+    bool stepped = g_eseUndoHistory.pop(step) && step.size() == 2 &&
+                   step[0].apply(g_eseUndoLatest.vertices) && step[1].apply(g_eseUndoLatest.indices);
+    if (!stepped) g_eseUndoLatest = MeshState();  // That was the oldest state
     
     // Rebuild GPU buffers
     g_objMeshResource->rebuildBuffers();
@@ -7434,9 +7811,13 @@ static bool ese_undo() {
     g_eseSelectedQuads.clear();
     // Force quad reconstruction on next frame by resetting the counter
     g_eseReconstructedQuads.clear();
+    g_eseQuadFaces.clear();
     g_eseLastQuadIndexCount = 0;  // This forces reconstruction
+    g_eseBVH.clear();
+    g_esePositionsStale = true;
+    ese_pick_bvh();
     
-    std::cout << "[ESE] Undo successful (stack size: " << g_eseUndoStack.size() << ")" << std::endl;
+    std::cout << "[ESE] Undo successful (stack size: " << ese_undo_count() << ")" << std::endl;
     return true;
 }
 
@@ -7457,6 +7838,47 @@ static glm::vec2 ese_project_to_screen(const glm::vec3& worldPos, bool* inFront)
     return glm::vec2(-1000, -1000);  // Off screen
 }
 
+// Box select: every vertex projecting inside the screen rectangle, from the
+// triangles whose bounds the BVH finds in the rectangle's frustum
+static void ese_select_vertices_in_rect(double x0, double y0, double x1, double y1, bool addToSelection) {
+    if (!g_objMeshResource) return;
+    const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
+    const std::vector<uint32_t>& indices = g_objMeshResource->getIndices();
+    
+    float minX = (float)std::min(x0, x1), maxX = (float)std::max(x0, x1);
+    float minY = (float)std::min(y0, y1), maxY = (float)std::max(y0, y1);
+    float width = (float)g_swapchainExtent.width, height = (float)g_swapchainExtent.height;
+    glm::mat4 viewProj = g_eseCurrentProjMat * g_eseCurrentViewMat;
+    float planes[5][4];
+    eden::MeshBVH::rectPlanes(&viewProj[0][0], 2.0f * minX / width - 1.0f, 2.0f * minY / height - 1.0f,
+                              2.0f * maxX / width - 1.0f, 2.0f * maxY / height - 1.0f, planes);
+    
+    std::vector<uint32_t> inside;
+    ese_pick_bvh().forEachInPlanes(planes, 5, [&](uint32_t tri) {
+        for (int c = 0; c < 3; c++) {
+            uint32_t vi = indices[size_t(tri) * 3 + c];
+            bool inFront;
+            glm::vec2 p = ese_project_to_screen(glm::vec3(vertices[vi].pos[0], vertices[vi].pos[1], vertices[vi].pos[2]), &inFront);
+            if (inFront && p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY) inside.push_back(vi);
+        }
+    });
+    std::sort(inside.begin(), inside.end());
+    inside.erase(std::unique(inside.begin(), inside.end()), inside.end());
+    
+    if (!addToSelection) g_eseSelectedVertices.clear();
+    g_eseSelectedVertices.insert(inside.begin(), inside.end());
+    if (!inside.empty()) {
+        // First one boxed is the primary selection for the gizmo
+        g_eseSelectedVertex = (int)inside.front();
+        g_eseSelectedVertexPos = glm::vec3(vertices[inside.front()].pos[0], vertices[inside.front()].pos[1],
+                                           vertices[inside.front()].pos[2]);
+    } else if (g_eseSelectedVertices.empty()) {
+        g_eseSelectedVertex = -1;
+    }
+    std::cout << "[ESE] Box selected " << inside.size() << " vertices (" << g_eseSelectedVertices.size()
+              << " selected)" << std::endl;
+}
+
 // Helper function to render OBJ mesh into an existing command buffer
 static void render_obj_mesh_to_command_buffer(VkCommandBuffer commandBuffer) {
     if (!g_objMeshInitialized || !g_objMeshResource) return;
@@ -7703,6 +8125,9 @@ static bool g_eseLeftMouseDown = false;
 static bool g_eseRightMouseDown = false;
 static double g_eseLastMouseX = 0.0;
 static double g_eseLastMouseY = 0.0;
+static bool g_eseRectSelecting = false;    // Shift+drag box select in vertex mode
+static double g_eseRectStartX = 0.0;
+static double g_eseRectStartY = 0.0;
 static GLFWwindow* g_eseWindow = nullptr;  // Store window reference for input
 static float g_eseScrollDelta = 0.0f;      // Accumulated scroll delta for zoom
 static GLFWscrollfun g_esePrevScrollCallback = nullptr;  // Store previous scroll callback to chain
@@ -7771,8 +8196,13 @@ static bool hdm_load_texture_data(const char* filepath, HDMTexture& tex) {
     }
     
     // Use stb_image to load the texture
-    int width, height, channels;
-    unsigned char* data = stbi_load(filepath, &width, &height, &channels, 4);  // Force RGBA
+    VfsFile file;
+    int width = 0, height = 0, channels = 0;
+    unsigned char* data = nullptr;
+    if (Vfs::shared().open(filepath, file)) {
+        data = stbi_load_from_memory(file.bytes(), static_cast<int>(file.size()),
+                                     &width, &height, &channels, 4);  // Force RGBA
+    }
     
     if (!data) {
         std::cerr << "[HDM] Failed to load texture: " << filepath << std::endl;
@@ -7873,7 +8303,7 @@ static bool hdm_save_binary(const char* filepath, const HDMProperties& props,
 // Load HDM binary file
 static bool hdm_load_binary(const char* filepath, HDMProperties& props, 
                             HDMGeometry& geom, HDMTexture& tex) {
-    std::ifstream file(filepath, std::ios::binary);
+    VfsInputStream file(filepath, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "[HDM] Failed to open file: " << filepath << std::endl;
         return false;
@@ -8142,143 +8572,81 @@ static bool hdm_save_ascii(const char* filepath, const HDMProperties& props,
 // Forward declaration for hdm_init_default_properties (defined later)
 static void hdm_init_default_properties(HDMProperties& props);
 
-// Helper: Find a string value in JSON by key
-static std::string json_find_string(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return "";
-    
-    pos = json.find("\"", pos + searchKey.length());
-    if (pos == std::string::npos) return "";
-    pos++; // Skip opening quote
-    
-    size_t endPos = json.find("\"", pos);
-    if (endPos == std::string::npos) return "";
-    
-    return json.substr(pos, endPos - pos);
-}
-
-// Helper: Find an integer value in JSON by key
-static int json_find_int(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return 0;
-    
-    pos += searchKey.length();
-    // Skip whitespace
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    
-    std::string numStr;
-    while (pos < json.length() && (isdigit(json[pos]) || json[pos] == '-')) {
-        numStr += json[pos++];
-    }
-    return numStr.empty() ? 0 : std::stoi(numStr);
-}
-
-// Helper: Find a float value in JSON by key
-static float json_find_float(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return 0.0f;
-    
-    pos += searchKey.length();
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    
-    std::string numStr;
-    while (pos < json.length() && (isdigit(json[pos]) || json[pos] == '-' || json[pos] == '.' || json[pos] == 'e' || json[pos] == 'E' || json[pos] == '+')) {
-        numStr += json[pos++];
-    }
-    return numStr.empty() ? 0.0f : std::stof(numStr);
-}
-
-// Helper: Find a boolean value in JSON by key
-static bool json_find_bool(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return false;
-    
-    pos += searchKey.length();
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    
-    return json.substr(pos, 4) == "true";
+// Helper: Copy a JSON string into a fixed-size field (absent values leave it)
+static void hdm_copy_json_string(JsonValue value, char* out, size_t size) {
+    if (!value.isString()) return;
+    std::string_view text = value.asString();
+    size_t length = std::min(text.size(), size - 1);
+    memcpy(out, text.data(), length);
+    out[length] = '\0';
 }
 
-// Helper: Find a float array in JSON by key (e.g., [1, 2, 3])
-static void json_find_float_array(const std::string& json, const std::string& key, float* out, int count) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return;
-    
-    pos = json.find("[", pos);
-    if (pos == std::string::npos) return;
-    pos++; // Skip '['
-    
-    for (int i = 0; i < count; i++) {
-        while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == ',')) pos++;
-        
-        std::string numStr;
-        while (pos < json.length() && (isdigit(json[pos]) || json[pos] == '-' || json[pos] == '.' || json[pos] == 'e' || json[pos] == 'E' || json[pos] == '+')) {
-            numStr += json[pos++];
-        }
-        if (!numStr.empty()) out[i] = std::stof(numStr);
+// Helper: Read properties from a parsed document. Keys are found wherever the
+// writer nested them ("item" in .hdma, "item_properties" in legacy JSON);
+// absent keys keep the value already in `props`.
+static void hdm_read_properties_json(JsonValue source, HDMProperties& props) {
+    hdm_copy_json_string(source.find("hdm_version"), props.hdm_version, sizeof(props.hdm_version));
+
+    hdm_copy_json_string(source.find("obj_path"), props.model.obj_path, sizeof(props.model.obj_path));
+    hdm_copy_json_string(source.find("texture_path"), props.model.texture_path, sizeof(props.model.texture_path));
+    source.find("scale").readFloats(props.model.scale, 3);
+    source.find("origin_offset").readFloats(props.model.origin_offset, 3);
+
+    props.item.item_type_id = source.find("item_type_id").asInt(props.item.item_type_id);
+    hdm_copy_json_string(source.find("item_name"), props.item.item_name, sizeof(props.item.item_name));
+    props.item.trade_value = source.find("trade_value").asInt(props.item.trade_value);
+    props.item.condition = source.find("condition").asFloat(props.item.condition);
+    props.item.weight = source.find("weight").asFloat(props.item.weight);
+    props.item.category = source.find("category").asInt(props.item.category);
+    props.item.is_salvaged = source.find("is_salvaged").asBool(props.item.is_salvaged);
+    props.item.mesh_class = source.find("mesh_class").asInt(props.item.mesh_class);
+
+    props.physics.collision_type = source.find("collision_type").asInt(props.physics.collision_type);
+    source.find("collision_bounds").readFloats(props.physics.collision_bounds, 3);
+    props.physics.is_static = source.find("is_static").asBool(props.physics.is_static);
+    props.physics.mass = source.find("mass").asFloat(props.physics.mass);
+
+    JsonValue points = source.find("control_points");
+    if (points.isArray()) {
+        int count = 0;
+        for (JsonValue point : points) {
+            if (count == 8) break;
+            hdm_copy_json_string(point["name"], props.control_points[count].name, sizeof(props.control_points[count].name));
+            point["position"].readFloats(props.control_points[count].position, 3);
+            count++;
+        }
+        props.num_control_points = count;
     }
 }
 
 // Load HDM ASCII format (.hdma)
 static bool hdm_load_ascii(const char* filepath, HDMProperties& props,
                           HDMGeometry& geom, HDMTexture& tex) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cerr << "[HDM] Failed to open file for reading: " << filepath << std::endl;
+    JsonDocument doc;
+    if (!doc.parseFile(filepath)) {
+        std::cerr << "[HDM] Failed to read ASCII HDM: " << doc.error() << std::endl;
         return false;
     }
-    
-    // Read entire file
-    std::string json;
-    std::string line;
-    while (std::getline(file, line)) {
-        json += line + "\n";
-    }
-    file.close();
+    JsonValue root = doc.root();
     
     std::cout << "[HDM] Parsing ASCII HDM file..." << std::endl;
     
     // Initialize with defaults
     hdm_init_default_properties(props);
     
-    // Parse model properties
-    std::string objPath = json_find_string(json, "obj_path");
-    std::string texPath = json_find_string(json, "texture_path");
-    strncpy(props.model.obj_path, objPath.c_str(), sizeof(props.model.obj_path) - 1);
-    strncpy(props.model.texture_path, texPath.c_str(), sizeof(props.model.texture_path) - 1);
-    json_find_float_array(json, "scale", props.model.scale, 3);
-    json_find_float_array(json, "origin_offset", props.model.origin_offset, 3);
-    
-    // Parse item properties
-    props.item.item_type_id = json_find_int(json, "item_type_id");
-    std::string itemName = json_find_string(json, "item_name");
-    strncpy(props.item.item_name, itemName.c_str(), sizeof(props.item.item_name) - 1);
-    props.item.trade_value = json_find_int(json, "trade_value");
-    props.item.condition = json_find_float(json, "condition");
-    props.item.weight = json_find_float(json, "weight");
-    props.item.category = json_find_int(json, "category");
-    props.item.is_salvaged = json_find_bool(json, "is_salvaged");
-    props.item.mesh_class = json_find_int(json, "mesh_class");
-    
-    // Parse physics properties
-    props.physics.collision_type = json_find_int(json, "collision_type");
-    json_find_float_array(json, "collision_bounds", props.physics.collision_bounds, 3);
-    props.physics.is_static = json_find_bool(json, "is_static");
-    props.physics.mass = json_find_float(json, "mass");
+    // Parse properties (model, item, physics, control points)
+    JsonValue properties = root["properties"];
+    hdm_read_properties_json(properties ? properties : root, props);
     
     // Parse geometry
-    int vertexCount = json_find_int(json, "vertex_count");
-    int indexCount = json_find_int(json, "index_count");
+    JsonValue geometry = root["geometry"];
+    int vertexCount = geometry["vertex_count"].asInt();
+    int indexCount = geometry["index_count"].asInt();
     
     std::cout << "[HDM] Geometry: " << vertexCount << " vertices, " << indexCount << " indices" << std::endl;
     
     if (vertexCount > 0) {
-        std::string vertB64 = json_find_string(json, "vertices_base64");
+        std::string vertB64(geometry["vertices_base64"].asString());
         if (!vertB64.empty()) {
             std::vector<unsigned char> vertData = base64_decode(vertB64);
             size_t expectedSize = vertexCount * sizeof(HDMVertex);
@@ -8293,7 +8661,7 @@ static bool hdm_load_ascii(const char* filepath, HDMProperties& props,
     }
     
     if (indexCount > 0) {
-        std::string idxB64 = json_find_string(json, "indices_base64");
+        std::string idxB64(geometry["indices_base64"].asString());
         if (!idxB64.empty()) {
             std::vector<unsigned char> idxData = base64_decode(idxB64);
             size_t expectedSize = indexCount * sizeof(uint32_t);
@@ -8308,12 +8676,13 @@ static bool hdm_load_ascii(const char* filepath, HDMProperties& props,
     }
     
     // Parse texture
-    tex.width = json_find_int(json, "width");
-    tex.height = json_find_int(json, "height");
-    tex.format = json_find_int(json, "format");
+    JsonValue texture = root["texture"];
+    tex.width = texture["width"].asInt();
+    tex.height = texture["height"].asInt();
+    tex.format = texture["format"].asInt();
     
     if (tex.width > 0 && tex.height > 0) {
-        std::string texB64 = json_find_string(json, "data_base64");
+        std::string texB64(texture["data_base64"].asString());
         if (!texB64.empty()) {
             tex.data = base64_decode(texB64);
             std::cout << "[HDM] Decoded texture: " << tex.width << "x" << tex.height << std::endl;
@@ -8415,6 +8784,9 @@ static bool ese_create_cube_mesh(GLFWwindow* window) {
         g_objMeshResource.reset();
         return false;
     }
+    g_eseLastQuadIndexCount = 0;  // New mesh: rebuild its topology
+    g_eseBVH.clear();
+    g_esePositionsStale = true;
     
     // Update paths (empty for generated mesh)
     g_eseCurrentObjPath = "(generated cube)";
@@ -8625,7 +8997,7 @@ static bool ese_init_mesh_pipeline_only(GLFWwindow* window) {
     pipelineInfo.renderPass = g_renderPass;
     pipelineInfo.subpass = 0;
     
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_objMeshPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_objMeshPipeline) != VK_SUCCESS) {
         std::cerr << "[ESE] Failed to create mesh graphics pipeline!" << std::endl;
         return false;
     }
@@ -8633,7 +9005,7 @@ static bool ese_init_mesh_pipeline_only(GLFWwindow* window) {
     // Also create wireframe pipeline
     rasterizer.polygonMode = VK_POLYGON_MODE_LINE;
     pipelineInfo.pRasterizationState = &rasterizer;
-    if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_objMeshWireframePipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_objMeshWireframePipeline) != VK_SUCCESS) {
         std::cerr << "[ESE] Warning: Failed to create wireframe pipeline" << std::endl;
         // Non-fatal, continue
     }
@@ -8865,6 +9237,9 @@ static bool hdm_create_mesh_from_packed(GLFWwindow* window, const HDMGeometry& g
         g_objMeshResource.reset();
         return false;
     }
+    g_eseLastQuadIndexCount = 0;  // New mesh: rebuild its topology
+    g_eseBVH.clear();
+    g_esePositionsStale = true;
     
     // CRITICAL: Initialize pipeline if not already initialized
     // The pipeline must exist before we can render
@@ -9129,7 +9504,7 @@ static bool hdm_create_mesh_from_packed(GLFWwindow* window, const HDMGeometry& g
         pipelineInfo.renderPass = g_renderPass;
         pipelineInfo.subpass = 0;
         
-        if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_objMeshPipeline) != VK_SUCCESS) {
+        if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_objMeshPipeline) != VK_SUCCESS) {
             std::cerr << "[HDM] ERROR: Failed to create graphics pipeline!" << std::endl;
             // Cleanup on failure
             if (g_objMeshDescriptorPool != VK_NULL_HANDLE) {
@@ -9185,7 +9560,7 @@ static bool hdm_create_mesh_from_packed(GLFWwindow* window, const HDMGeometry& g
         // Create wireframe pipeline for ESE (same settings but with VK_POLYGON_MODE_LINE)
         rasterizer.polygonMode = VK_POLYGON_MODE_LINE;
         rasterizer.lineWidth = 1.0f;
-        if (vkCreateGraphicsPipelines(g_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_objMeshWireframePipeline) != VK_SUCCESS) {
+        if (vkCreateGraphicsPipelines(g_device, edenPipelineCache(), 1, &pipelineInfo, nullptr, &g_objMeshWireframePipeline) != VK_SUCCESS) {
             std::cerr << "[HDM] WARNING: Failed to create wireframe pipeline (wireframe mode will be unavailable)" << std::endl;
         } else {
             std::cout << "[HDM] Wireframe pipeline created successfully!" << std::endl;
@@ -9372,85 +9747,17 @@ static bool hdm_save_json(const char* filepath, const HDMProperties& props) {
     return true;
 }
 
-// Simple JSON parser helper - find value after key
-static std::string json_get_string(const std::string& json, const std::string& key) {
-    size_t pos = json.find("\"" + key + "\"");
-    if (pos == std::string::npos) return "";
-    pos = json.find(":", pos);
-    if (pos == std::string::npos) return "";
-    pos = json.find("\"", pos);
-    if (pos == std::string::npos) return "";
-    size_t end = json.find("\"", pos + 1);
-    if (end == std::string::npos) return "";
-    return json.substr(pos + 1, end - pos - 1);
-}
-
-static int json_get_int(const std::string& json, const std::string& key) {
-    size_t pos = json.find("\"" + key + "\"");
-    if (pos == std::string::npos) return 0;
-    pos = json.find(":", pos);
-    if (pos == std::string::npos) return 0;
-    // Skip whitespace
-    while (pos < json.size() && (json[pos] == ':' || json[pos] == ' ' || json[pos] == '\t')) pos++;
-    return std::atoi(json.c_str() + pos);
-}
-
-static float json_get_float(const std::string& json, const std::string& key) {
-    size_t pos = json.find("\"" + key + "\"");
-    if (pos == std::string::npos) return 0.0f;
-    pos = json.find(":", pos);
-    if (pos == std::string::npos) return 0.0f;
-    // Skip whitespace
-    while (pos < json.size() && (json[pos] == ':' || json[pos] == ' ' || json[pos] == '\t')) pos++;
-    return (float)std::atof(json.c_str() + pos);
-}
-
-static bool json_get_bool(const std::string& json, const std::string& key) {
-    size_t pos = json.find("\"" + key + "\"");
-    if (pos == std::string::npos) return false;
-    pos = json.find(":", pos);
-    if (pos == std::string::npos) return false;
-    return json.find("true", pos) < json.find(",", pos);
-}
-
-static bool hdm_load_json(const char* filepath, HDMProperties& props) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cerr << "[ESE] Failed to open HDM file: " << filepath << std::endl;
+// `log` is off for batch loads, which report once for the whole batch
+static bool hdm_load_json(const char* filepath, HDMProperties& props, bool log = true) {
+    JsonDocument doc;
+    if (!doc.parseFile(filepath)) {
+        std::cerr << "[ESE] Failed to read HDM file: " << doc.error() << std::endl;
         return false;
     }
     
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string json = buffer.str();
-    file.close();
+    hdm_read_properties_json(doc.root(), props);
     
-    // Parse JSON (simple parser)
-    std::string ver = json_get_string(json, "hdm_version");
-    if (!ver.empty()) strncpy(props.hdm_version, ver.c_str(), sizeof(props.hdm_version) - 1);
-    
-    // Model properties
-    std::string obj = json_get_string(json, "obj_path");
-    if (!obj.empty()) strncpy(props.model.obj_path, obj.c_str(), sizeof(props.model.obj_path) - 1);
-    std::string tex = json_get_string(json, "texture_path");
-    if (!tex.empty()) strncpy(props.model.texture_path, tex.c_str(), sizeof(props.model.texture_path) - 1);
-    
-    // Item properties
-    props.item.item_type_id = json_get_int(json, "item_type_id");
-    std::string name = json_get_string(json, "item_name");
-    if (!name.empty()) strncpy(props.item.item_name, name.c_str(), sizeof(props.item.item_name) - 1);
-    props.item.trade_value = json_get_int(json, "trade_value");
-    props.item.condition = json_get_float(json, "condition");
-    props.item.weight = json_get_float(json, "weight");
-    props.item.category = json_get_int(json, "category");
-    props.item.is_salvaged = json_get_bool(json, "is_salvaged");
-    
-    // Physics properties
-    props.physics.collision_type = json_get_int(json, "collision_type");
-    props.physics.is_static = json_get_bool(json, "is_static");
-    props.physics.mass = json_get_float(json, "mass");
-    
-    std::cout << "[ESE] Loaded HDM file: " << filepath << std::endl;
+    if (log) std::cout << "[ESE] Loaded HDM file: " << filepath << std::endl;
     return true;
 }
 
@@ -9638,7 +9945,7 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
             g_eseQuadMode = false;
             g_eseSelectedEdges.clear();
             g_eseSelectedQuads.clear();
-            std::cout << "[ESE] Vertex mode enabled - Ctrl+click for multi-select" << std::endl;
+            std::cout << "[ESE] Vertex mode enabled - Ctrl+click for multi-select, Shift+drag to box select" << std::endl;
         } else {
             std::cout << "[ESE] Vertex mode disabled" << std::endl;
             g_eseSelectedVertex = -1;
@@ -9718,260 +10025,33 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
         
         const QuadEdge& selectedEdge = g_eseQuadEdges[g_eseSelectedEdge];
         
-        // The selected edge will be CUT by the new loop (perpendicular to it)
-        // The new edges will be PERPENDICULAR to the selected edge
-        // We follow through quads that share edges PARALLEL to the selected edge
-        
-        // Helper to get position key for edge matching
-        auto getEdgePosKey = [&vertices](uint32_t va, uint32_t vb) -> std::pair<std::string, std::string> {
-            auto posToStr = [](float x, float y, float z) {
-                char buf[64];
-                snprintf(buf, sizeof(buf), "%.4f,%.4f,%.4f", x, y, z);
-                return std::string(buf);
-            };
-            std::string posA = posToStr(vertices[va].pos[0], vertices[va].pos[1], vertices[va].pos[2]);
-            std::string posB = posToStr(vertices[vb].pos[0], vertices[vb].pos[1], vertices[vb].pos[2]);
-            if (posA < posB) return std::make_pair(posA, posB);
-            return std::make_pair(posB, posA);
-        };
-        
-        // Build edge-to-quad map
-        std::map<std::pair<std::string, std::string>, std::vector<std::pair<int, int>>> edgeToQuadInfo;
-        for (int qi = 0; qi < (int)g_eseReconstructedQuads.size(); qi++) {
-            auto& q = g_eseReconstructedQuads[qi];
-            for (int ei = 0; ei < 4; ei++) {
-                uint32_t va = q[ei];
-                uint32_t vb = q[(ei + 1) % 4];
-                auto key = getEdgePosKey(va, vb);
-                edgeToQuadInfo[key].push_back(std::make_pair(qi, ei));
-            }
-        }
-        
-        // Get the position key of the selected edge
-        auto selectedEdgeKey = getEdgePosKey(selectedEdge.v0, selectedEdge.v1);
-        
-        // Find which quads contain this edge and at what local index
-        std::map<int, std::pair<int, int>> quadToCutEdges;  // qi -> (cutEdge1, cutEdge2)
-        std::set<int> visited;
-        std::queue<std::pair<int, int>> toVisit;
-        
-        // Start with quads that contain the selected edge
-        // The selected edge is a CUT edge - the loop goes perpendicular to it
-        if (edgeToQuadInfo.count(selectedEdgeKey)) {
-            for (auto& info : edgeToQuadInfo[selectedEdgeKey]) {
-                int qi = info.first;
-                int edgeIdx = info.second;
-                // The selected edge IS a cut edge
-                // We follow through edges PARALLEL to the selected edge (the other cut edges)
-                toVisit.push(std::make_pair(qi, edgeIdx));
-            }
-        }
-        
-        while (!toVisit.empty()) {
-            auto front = toVisit.front();
-            toVisit.pop();
-            int qi = front.first;
-            int cutEdgeIdx = front.second;  // This edge will be cut (selected edge or parallel to it)
-            
-            if (visited.count(qi)) continue;
-            visited.insert(qi);
-            
-            auto& q = g_eseReconstructedQuads[qi];
-            
-            // Cut edges are at cutEdgeIdx and (cutEdgeIdx + 2) % 4 (opposite)
-            // Flow edges are at (cutEdgeIdx + 1) % 4 and (cutEdgeIdx + 3) % 4 (perpendicular)
-            int cutEdge1 = cutEdgeIdx;
-            int cutEdge2 = (cutEdgeIdx + 2) % 4;
-            int flowEdge1 = (cutEdgeIdx + 1) % 4;
-            int flowEdge2 = (cutEdgeIdx + 3) % 4;
-            
-            quadToCutEdges[qi] = std::make_pair(cutEdge1, cutEdge2);
-            
-            // Follow through CUT edges to adjacent quads (edges parallel to selected)
-            for (int ce : {cutEdge1, cutEdge2}) {
-                uint32_t va = q[ce];
-                uint32_t vb = q[(ce + 1) % 4];
-                auto cutKey = getEdgePosKey(va, vb);
-                
-                if (edgeToQuadInfo.count(cutKey)) {
-                    for (auto& info : edgeToQuadInfo[cutKey]) {
-                        int adjQi = info.first;
-                        int adjEdgeIdx = info.second;
-                        if (!visited.count(adjQi)) {
-                            toVisit.push(std::make_pair(adjQi, adjEdgeIdx));
-                        }
-                    }
-                }
-            }
-        }
-        
-        std::cout << "[ESE] Found " << quadToCutEdges.size() << " quads in edge loop" << std::endl;
-        
-        if (!quadToCutEdges.empty()) {
-            // Create midpoint vertices
-            std::map<std::pair<std::string, std::string>, uint32_t> edgePosToMidpoint;
-            std::map<std::pair<uint32_t, uint32_t>, uint32_t> edgeIdxToMidpoint;
-            
-            for (auto& entry : quadToCutEdges) {
-                int qi = entry.first;
-                auto cutPair = entry.second;
-                auto& q = g_eseReconstructedQuads[qi];
-                
-                for (int cutEdge : {cutPair.first, cutPair.second}) {
-                    uint32_t va = q[cutEdge];
-                    uint32_t vb = q[(cutEdge + 1) % 4];
-                    auto posKey = getEdgePosKey(va, vb);
-                    auto idxKey = std::make_pair(std::min(va, vb), std::max(va, vb));
-                    
-                    if (edgePosToMidpoint.count(posKey) == 0) {
-                        glm::vec3 p0(vertices[va].pos[0], vertices[va].pos[1], vertices[va].pos[2]);
-                        glm::vec3 p1(vertices[vb].pos[0], vertices[vb].pos[1], vertices[vb].pos[2]);
-                        glm::vec3 mid = (p0 + p1) * 0.5f;
-                        
-                        MeshVertex newVert;
-                        newVert.pos[0] = mid.x; newVert.pos[1] = mid.y; newVert.pos[2] = mid.z;
-                        newVert.normal[0] = (vertices[va].normal[0] + vertices[vb].normal[0]) * 0.5f;
-                        newVert.normal[1] = (vertices[va].normal[1] + vertices[vb].normal[1]) * 0.5f;
-                        newVert.normal[2] = (vertices[va].normal[2] + vertices[vb].normal[2]) * 0.5f;
-                        newVert.uv[0] = (vertices[va].uv[0] + vertices[vb].uv[0]) * 0.5f;
-                        newVert.uv[1] = (vertices[va].uv[1] + vertices[vb].uv[1]) * 0.5f;
-                        
-                        uint32_t newIdx = (uint32_t)vertices.size();
-                        vertices.push_back(newVert);
-                        edgePosToMidpoint[posKey] = newIdx;
-                    }
-                    edgeIdxToMidpoint[idxKey] = edgePosToMidpoint[posKey];
-                }
-            }
-            
-            // Find triangles to remove
-            std::set<size_t> trianglesToRemove;
-            size_t numTris = indices.size() / 3;
-            
-            for (auto& entry : quadToCutEdges) {
-                int qi = entry.first;
-                auto& q = g_eseReconstructedQuads[qi];
-                std::set<uint32_t> quadVerts;
-                quadVerts.insert(q[0]); quadVerts.insert(q[1]); quadVerts.insert(q[2]); quadVerts.insert(q[3]);
-                
-                for (size_t ti = 0; ti < numTris; ti++) {
-                    uint32_t tv0 = indices[ti * 3];
-                    uint32_t tv1 = indices[ti * 3 + 1];
-                    uint32_t tv2 = indices[ti * 3 + 2];
-                    
-                    if (quadVerts.count(tv0) && quadVerts.count(tv1) && quadVerts.count(tv2)) {
-                        trianglesToRemove.insert(ti);
-                    }
-                }
-            }
-            
-            // Build new index buffer
-            std::vector<uint32_t> newIndices;
-            for (size_t ti = 0; ti < numTris; ti++) {
-                if (trianglesToRemove.count(ti) == 0) {
-                    newIndices.push_back(indices[ti * 3]);
-                    newIndices.push_back(indices[ti * 3 + 1]);
-                    newIndices.push_back(indices[ti * 3 + 2]);
-                }
-            }
-            
-            // First, find the reference normal for each quad from its original triangles
-            std::map<int, glm::vec3> quadToNormal;
-            for (auto& entry : quadToCutEdges) {
-                int qi = entry.first;
-                auto& q = g_eseReconstructedQuads[qi];
-                std::set<uint32_t> quadVerts;
-                quadVerts.insert(q[0]); quadVerts.insert(q[1]); quadVerts.insert(q[2]); quadVerts.insert(q[3]);
-                
-                // Find a triangle from the original mesh that belongs to this quad
-                for (size_t ti = 0; ti < numTris; ti++) {
-                    uint32_t tv0 = indices[ti * 3];
-                    uint32_t tv1 = indices[ti * 3 + 1];
-                    uint32_t tv2 = indices[ti * 3 + 2];
-                    
-                    if (quadVerts.count(tv0) && quadVerts.count(tv1) && quadVerts.count(tv2)) {
-                        // This triangle belongs to the quad - use its normal
-                        glm::vec3 p0(vertices[tv0].pos[0], vertices[tv0].pos[1], vertices[tv0].pos[2]);
-                        glm::vec3 p1(vertices[tv1].pos[0], vertices[tv1].pos[1], vertices[tv1].pos[2]);
-                        glm::vec3 p2(vertices[tv2].pos[0], vertices[tv2].pos[1], vertices[tv2].pos[2]);
-                        quadToNormal[qi] = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-                        break;
-                    }
-                }
-            }
-            
-            // Add split quads - ensuring normals face same direction as original triangles
-            for (auto& entry : quadToCutEdges) {
-                int qi = entry.first;
-                auto cutPair = entry.second;
-                auto& q = g_eseReconstructedQuads[qi];
-                int cutEdge1 = cutPair.first;
-                int cutEdge2 = cutPair.second;
-                
-                auto getMidpoint = [&](int edgeIdx) -> uint32_t {
-                    uint32_t va = q[edgeIdx];
-                    uint32_t vb = q[(edgeIdx + 1) % 4];
-                    auto key = std::make_pair(std::min(va, vb), std::max(va, vb));
-                    return edgeIdxToMidpoint[key];
-                };
-                
-                uint32_t mid1 = getMidpoint(cutEdge1);
-                uint32_t mid2 = getMidpoint(cutEdge2);
-                
-                // Get reference normal from original triangle
-                glm::vec3 origNormal = quadToNormal.count(qi) ? quadToNormal[qi] : glm::vec3(0, 1, 0);
-                
-                // Helper to add a triangle with correct winding
-                auto addTriangle = [&](uint32_t v0, uint32_t v1, uint32_t v2) {
-                    glm::vec3 p0(vertices[v0].pos[0], vertices[v0].pos[1], vertices[v0].pos[2]);
-                    glm::vec3 p1(vertices[v1].pos[0], vertices[v1].pos[1], vertices[v1].pos[2]);
-                    glm::vec3 p2(vertices[v2].pos[0], vertices[v2].pos[1], vertices[v2].pos[2]);
-                    glm::vec3 triNormal = glm::cross(p1 - p0, p2 - p0);
-                    
-                    // Check if normal faces same direction as original
-                    if (glm::dot(triNormal, origNormal) >= 0.0f) {
-                        // Same direction - keep winding
-                        newIndices.push_back(v0);
-                        newIndices.push_back(v1);
-                        newIndices.push_back(v2);
-                    } else {
-                        // Opposite direction - reverse winding
-                        newIndices.push_back(v0);
-                        newIndices.push_back(v2);
-                        newIndices.push_back(v1);
-                    }
-                };
-                
-                // Quad A: q[cutEdge1], mid1, mid2, q[(cutEdge2+1)%4]
-                uint32_t qa0 = q[cutEdge1];
-                uint32_t qa1 = mid1;
-                uint32_t qa2 = mid2;
-                uint32_t qa3 = q[(cutEdge2 + 1) % 4];
-                addTriangle(qa0, qa1, qa2);
-                addTriangle(qa0, qa2, qa3);
-                
-                // Quad B: mid1, q[(cutEdge1+1)%4], q[cutEdge2], mid2
-                uint32_t qb0 = mid1;
-                uint32_t qb1 = q[(cutEdge1 + 1) % 4];
-                uint32_t qb2 = q[cutEdge2];
-                uint32_t qb3 = mid2;
-                addTriangle(qb0, qb1, qb2);
-                addTriangle(qb0, qb2, qb3);
-            }
-            
-            indices = newIndices;
+        // The selected edge will be CUT by the new loop (perpendicular to it).
+        // The topology walks quads through opposite edges from both of its
+        // sides and splits them in place.
+        uint32_t facesBefore = g_eseTopology.faceCount();
+        uint32_t vertexCountBefore = static_cast<uint32_t>(vertices.size());
+        uint32_t newVertices = g_eseTopology.insertEdgeLoop(vertices, selectedEdge.halfEdge);
+        
+        if (newVertices > 0) {
+            // Only the new vertices and the triangles from the first split face on go up
+            const std::vector<uint32_t>& triangles = g_eseTopology.triangles();
+            size_t unchanged = std::mismatch(indices.begin(), indices.end(), triangles.begin(), triangles.end()).first - indices.begin();
+            indices = triangles;
+            g_eseLastQuadIndexCount = indices.size();
             
-            std::cout << "[ESE] Edge loop inserted: " << quadToCutEdges.size() << " quads split, " 
-                      << edgePosToMidpoint.size() << " new vertices" << std::endl;
+            std::cout << "[ESE] Edge loop inserted: " << (g_eseTopology.faceCount() - facesBefore) << " quads split, " 
+                      << newVertices << " new vertices" << std::endl;
             
-            g_objMeshResource->rebuildBuffers();
+            g_objMeshResource->markVerticesDirty(vertexCountBefore, newVertices);
+            g_objMeshResource->markIndicesDirty(static_cast<uint32_t>(unchanged));
             
-            // Reset and force full reconstruction of quads and edges
+            // Edge indices shift, so the selection goes
             g_eseSelectedEdge = -1;
             g_eseSelectedEdges.clear();
-            g_eseReconstructedQuads.clear();
-            g_eseQuadEdges.clear();
-            g_eseLastQuadIndexCount = 0;
+            ese_refresh_quad_views();
+            g_eseBVH.clear();
+            g_esePositionsStale = true;
+            ese_pick_bvh();
         }
     }
     keyIWasPressed = keyIPressed;
@@ -10203,7 +10283,6 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
             
             // Collect target positions that need to be moved
             std::vector<glm::vec3> targetPositions;
-            float tolerance = 0.0001f;
             
             if (g_eseVertexMode && !g_eseSelectedVertices.empty()) {
                 // Multi-selection: collect positions from ALL selected vertices
@@ -10241,109 +10320,43 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
                     // Save undo state BEFORE modifying mesh
                     ese_save_undo_state();
                     
-                    // EXTRUDE: Create new geometry
-                    const auto& quad = g_eseReconstructedQuads[g_eseSelectedQuad];
-                    
-                    // Get original vertex positions
-                    glm::vec3 p0(vertices[quad[0]].pos[0], vertices[quad[0]].pos[1], vertices[quad[0]].pos[2]);
-                    glm::vec3 p1(vertices[quad[1]].pos[0], vertices[quad[1]].pos[1], vertices[quad[1]].pos[2]);
-                    glm::vec3 p2(vertices[quad[2]].pos[0], vertices[quad[2]].pos[1], vertices[quad[2]].pos[2]);
-                    glm::vec3 p3(vertices[quad[3]].pos[0], vertices[quad[3]].pos[1], vertices[quad[3]].pos[2]);
-                    
-                    // Calculate face normal for the new vertices
-                    glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-                    
-                    // Get mutable indices FIRST (before we modify vertices)
+                    // EXTRUDE: The quad's face moves onto 4 new vertices (same positions,
+                    // face normal) and gets a side quad on each edge back to the originals
                     std::vector<uint32_t>& mutableIndices = g_objMeshResource->getIndicesMutable();
-                    
-                    // DELETE ORIGINAL FACE: Find and remove triangles that use the quad's vertices
-                    std::set<uint32_t> quadVerts = {quad[0], quad[1], quad[2], quad[3]};
-                    std::vector<uint32_t> newIndices;
-                    newIndices.reserve(mutableIndices.size());
-                    
-                    for (size_t i = 0; i + 2 < mutableIndices.size(); i += 3) {
-                        uint32_t v0 = mutableIndices[i];
-                        uint32_t v1 = mutableIndices[i + 1];
-                        uint32_t v2 = mutableIndices[i + 2];
+                    uint32_t vertexCountBefore = static_cast<uint32_t>(vertices.size());
+                    g_eseExtrudedVertices = g_eseTopology.extrudeFace(vertices, g_eseQuadFaces[g_eseSelectedQuad]);
+                    if (!g_eseExtrudedVertices.empty()) {
+                        const std::vector<uint32_t>& triangles = g_eseTopology.triangles();
+                        size_t unchanged = std::mismatch(mutableIndices.begin(), mutableIndices.end(),
+                                                         triangles.begin(), triangles.end()).first - mutableIndices.begin();
+                        mutableIndices = triangles;
+                        g_eseLastQuadIndexCount = mutableIndices.size();
                         
-                        // Check if all 3 vertices of this triangle are in the quad
-                        int matchCount = 0;
-                        if (quadVerts.count(v0)) matchCount++;
-                        if (quadVerts.count(v1)) matchCount++;
-                        if (quadVerts.count(v2)) matchCount++;
+                        // New geometry is visible this frame: the new vertices and the
+                        // triangles from the extruded face on upload with the frame
+                        g_objMeshResource->markVerticesDirty(vertexCountBefore, static_cast<uint32_t>(vertices.size()) - vertexCountBefore);
+                        g_objMeshResource->markIndicesDirty(static_cast<uint32_t>(unchanged));
                         
-                        // Keep triangle only if it's NOT part of the original quad face
-                        if (matchCount < 3) {
-                            newIndices.push_back(v0);
-                            newIndices.push_back(v1);
-                            newIndices.push_back(v2);
-                        }
-                    }
-                    
-                    mutableIndices = newIndices;
-                    std::cout << "[ESE] Removed original face triangles" << std::endl;
-                    
-                    // Create 4 new vertices (copies of original)
-                    uint32_t newIdx0 = (uint32_t)vertices.size();
-                    for (int i = 0; i < 4; i++) {
-                        MeshVertex newVert = vertices[quad[i]];
-                        // Set normal to face outward
-                        newVert.normal[0] = normal.x;
-                        newVert.normal[1] = normal.y;
-                        newVert.normal[2] = normal.z;
-                        vertices.push_back(newVert);
+                        // The face keeps its index, so the selected quad is now the top face
+                        ese_refresh_quad_views();
+                        g_eseBVH.clear();  // Rebuilt when the drag ends
                     }
                     
-                    // Store extruded vertex indices for movement
-                    g_eseExtrudedVertices.clear();
-                    g_eseExtrudedVertices.push_back(newIdx0);
-                    g_eseExtrudedVertices.push_back(newIdx0 + 1);
-                    g_eseExtrudedVertices.push_back(newIdx0 + 2);
-                    g_eseExtrudedVertices.push_back(newIdx0 + 3);
-                    
-                    // Create 4 side quads (8 triangles) connecting original to new vertices
-                    // Side 0-1: quad[0] -> quad[1] -> newIdx0+1 -> newIdx0
-                    mutableIndices.push_back(quad[0]); mutableIndices.push_back(quad[1]); mutableIndices.push_back(newIdx0 + 1);
-                    mutableIndices.push_back(quad[0]); mutableIndices.push_back(newIdx0 + 1); mutableIndices.push_back(newIdx0);
-                    
-                    // Side 1-2: quad[1] -> quad[2] -> newIdx0+2 -> newIdx0+1
-                    mutableIndices.push_back(quad[1]); mutableIndices.push_back(quad[2]); mutableIndices.push_back(newIdx0 + 2);
-                    mutableIndices.push_back(quad[1]); mutableIndices.push_back(newIdx0 + 2); mutableIndices.push_back(newIdx0 + 1);
-                    
-                    // Side 2-3: quad[2] -> quad[3] -> newIdx0+3 -> newIdx0+2
-                    mutableIndices.push_back(quad[2]); mutableIndices.push_back(quad[3]); mutableIndices.push_back(newIdx0 + 3);
-                    mutableIndices.push_back(quad[2]); mutableIndices.push_back(newIdx0 + 3); mutableIndices.push_back(newIdx0 + 2);
-                    
-                    // Side 3-0: quad[3] -> quad[0] -> newIdx0 -> newIdx0+3
-                    mutableIndices.push_back(quad[3]); mutableIndices.push_back(quad[0]); mutableIndices.push_back(newIdx0);
-                    mutableIndices.push_back(quad[3]); mutableIndices.push_back(newIdx0); mutableIndices.push_back(newIdx0 + 3);
-                    
-                    // NEW TOP FACE: Create 2 triangles using the new vertices
-                    // This is the face that will move with the extrusion
-                    mutableIndices.push_back(newIdx0); mutableIndices.push_back(newIdx0 + 1); mutableIndices.push_back(newIdx0 + 2);
-                    mutableIndices.push_back(newIdx0); mutableIndices.push_back(newIdx0 + 2); mutableIndices.push_back(newIdx0 + 3);
-                    
-                    // Update the quad to use new vertices (top face)
-                    g_eseReconstructedQuads[g_eseSelectedQuad] = {newIdx0, newIdx0 + 1, newIdx0 + 2, newIdx0 + 3};
-                    
                     g_eseExtrudeExecuted = true;
                     std::cout << "[ESE] Extruded quad - created " << vertices.size() << " vertices, " 
                               << mutableIndices.size() << " indices" << std::endl;
-                    
-                    // IMPORTANT: Rebuild GPU buffers immediately so new geometry is visible
-                    g_objMeshResource->rebuildBuffers();
-                    std::cout << "[ESE] GPU buffers rebuilt for extrusion" << std::endl;
                 }
                 
                 // Move extruded vertices (or normal quad movement if not extruding)
                 if (g_eseExtrudeMode && g_eseExtrudeExecuted) {
                     // EXTRUDE: Move only the specific extruded vertex indices (NOT position-based)
                     // This is critical because extruded vertices start at same position as originals
-                    for (uint32_t vi : g_eseExtrudedVertices) {
-                        if (vi < vertices.size()) {
-                            vertices[vi].pos[g_eseGizmoDragAxis] += delta * 0.5f;
-                        }
+                    if (!g_eseDragVerticesReady) {
+                        g_eseDragRegion.build(vertices, indices, g_eseExtrudedVertices, ese_position_hash());
+                        g_eseDragVerticesReady = true;
                     }
+                    int axis = g_eseGizmoDragAxis;
+                    g_eseDragRegion.forEachMoved([&](uint32_t vi) { vertices[vi].pos[axis] += delta * 0.5f; });
                     // Skip the normal position-based movement below
                     g_eseGizmoDragStartMouse = (g_eseGizmoDragAxis == 1) ? mouseY : mouseX;
                     g_esePropertiesModified = true;
@@ -10361,53 +10374,67 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
             }
             
             // Find and move/scale/rotate ALL vertices at target positions (keeps mesh connected)
-            // Skip this if we already handled extrusion movement above
+            // Skip this if we already handled extrusion movement above. The set comes from
+            // the position hash on the first frame; the copies move together, so it holds
+            // until release. Chunks of it transform in parallel.
             if (!(g_eseQuadMode && g_eseExtrudeMode && g_eseExtrudeExecuted)) {
-                for (size_t vi = 0; vi < vertices.size(); vi++) {
-                    glm::vec3 vPos(vertices[vi].pos[0], vertices[vi].pos[1], vertices[vi].pos[2]);
-                    
+                if (!g_eseDragVerticesReady) {
+                    const eden::PositionHash& positions = ese_position_hash();
+                    std::vector<uint32_t> dragVertices;
                     for (const auto& targetPos : targetPositions) {
-                        if (glm::length(vPos - targetPos) < tolerance) {
-                            if (g_eseGizmoRotating) {
-                                // ROTATING: Rotate vertex around gizmo center on selected axis
-                                glm::vec3 relPos = vPos - g_eseGizmoPosition;
-                                float cosA = cosf(rotationAngle);
-                                float sinA = sinf(rotationAngle);
-                                glm::vec3 newPos;
-                                
-                                if (g_eseGizmoDragAxis == 0) {
-                                    // Rotate around X axis (affects Y and Z)
-                                    newPos.x = relPos.x;
-                                    newPos.y = relPos.y * cosA - relPos.z * sinA;
-                                    newPos.z = relPos.y * sinA + relPos.z * cosA;
-                                } else if (g_eseGizmoDragAxis == 1) {
-                                    // Rotate around Y axis (affects X and Z)
-                                    newPos.x = relPos.x * cosA + relPos.z * sinA;
-                                    newPos.y = relPos.y;
-                                    newPos.z = -relPos.x * sinA + relPos.z * cosA;
-                                } else {
-                                    // Rotate around Z axis (affects X and Y)
-                                    newPos.x = relPos.x * cosA - relPos.y * sinA;
-                                    newPos.y = relPos.x * sinA + relPos.y * cosA;
-                                    newPos.z = relPos.z;
-                                }
-                                
-                                newPos += g_eseGizmoPosition;
-                                vertices[vi].pos[0] = newPos.x;
-                                vertices[vi].pos[1] = newPos.y;
-                                vertices[vi].pos[2] = newPos.z;
-                            } else if (g_eseGizmoScaling) {
-                                // SCALING: Scale vertex position relative to gizmo center on selected axis
-                                float offset = vertices[vi].pos[g_eseGizmoDragAxis] - g_eseGizmoPosition[g_eseGizmoDragAxis];
-                                vertices[vi].pos[g_eseGizmoDragAxis] = g_eseGizmoPosition[g_eseGizmoDragAxis] + offset * scaleFactor;
-                            } else {
-                                // MOVING: Move vertex along axis
-                                vertices[vi].pos[g_eseGizmoDragAxis] += delta * 0.5f;
-                            }
-                            break;
-                        }
+                        positions.forEachNear(vertices, &targetPos.x, [&](uint32_t v) { dragVertices.push_back(v); });
                     }
+                    g_eseDragRegion.build(vertices, indices, dragVertices, positions);
+                    g_eseDragVerticesReady = true;
                 }
+                
+                int axis = g_eseGizmoDragAxis;
+                float cosA = cosf(rotationAngle);
+                float sinA = sinf(rotationAngle);
+                g_eseDragRegion.forEachMoved([&](uint32_t vi) {
+                    glm::vec3 vPos(vertices[vi].pos[0], vertices[vi].pos[1], vertices[vi].pos[2]);
+                    if (g_eseGizmoRotating) {
+                        // ROTATING: Rotate vertex around gizmo center on selected axis
+                        glm::vec3 relPos = vPos - g_eseGizmoPosition;
+                        glm::vec3 newPos;
+                        
+                        if (axis == 0) {
+                            // Rotate around X axis (affects Y and Z)
+                            newPos.x = relPos.x;
+                            newPos.y = relPos.y * cosA - relPos.z * sinA;
+                            newPos.z = relPos.y * sinA + relPos.z * cosA;
+                        } else if (axis == 1) {
+                            // Rotate around Y axis (affects X and Z)
+                            newPos.x = relPos.x * cosA + relPos.z * sinA;
+                            newPos.y = relPos.y;
+                            newPos.z = -relPos.x * sinA + relPos.z * cosA;
+                        } else {
+                            // Rotate around Z axis (affects X and Y)
+                            newPos.x = relPos.x * cosA - relPos.y * sinA;
+                            newPos.y = relPos.x * sinA + relPos.y * cosA;
+                            newPos.z = relPos.z;
+                        }
+                        
+                        newPos += g_eseGizmoPosition;
+                        vertices[vi].pos[0] = newPos.x;
+                        vertices[vi].pos[1] = newPos.y;
+                        vertices[vi].pos[2] = newPos.z;
+                    } else if (g_eseGizmoScaling) {
+                        // SCALING: Scale vertex position relative to gizmo center on selected axis
+                        float offset = vertices[vi].pos[axis] - g_eseGizmoPosition[axis];
+                        vertices[vi].pos[axis] = g_eseGizmoPosition[axis] + offset * scaleFactor;
+                    } else {
+                        // MOVING: Move vertex along axis
+                        vertices[vi].pos[axis] += delta * 0.5f;
+                    }
+                });
+            }
+            
+            // Normals of the one-ring only; the moved vertices and that ring
+            // upload after the frame fence (MeshResource::uploadDirty)
+            g_eseDragRegion.updateNormals(vertices);
+            for (const auto& range : g_eseDragRegion.dirtyRanges()) {
+                g_objMeshResource->markVerticesDirty(range.first, range.count);
             }
             
             // Update selected vertex position for display
@@ -10434,11 +10461,15 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
             g_eseGizmoDragAxis = -1;
             g_eseGizmoScaling = false;
             g_eseGizmoRotating = false;
+            g_eseDragVerticesReady = false;
+            g_eseDragRegion.clear();
             std::cout << "[ESE] Drag complete" << std::endl;
             
-            // Rebuild mesh buffers with new vertex positions
+            // The buffers followed the drag; picking catches up with the new positions
             if (g_objMeshResource) {
-                g_objMeshResource->rebuildBuffers();
+                g_eseBVHStale = true;
+                g_esePositionsStale = true;
+                ese_pick_bvh();
             }
             
             // Reset extrude mode after operation
@@ -10452,9 +10483,29 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
             }
         }
         
+        // Shift+drag in vertex mode: box select instead of orbiting
+        bool shiftPressed = (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+                             glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS);
+        if (leftDown && !g_eseLeftMouseDown && shiftPressed && g_eseVertexMode && g_eseModelLoaded &&
+            g_objMeshResource && !g_eseGizmoDragging) {
+            g_eseRectSelecting = true;
+            g_eseRectStartX = mouseX;
+            g_eseRectStartY = mouseY;
+        }
+        
+        // Released: a box unless it stayed as small as a click
+        bool rectReleased = false;
+        if (!leftDown && g_eseRectSelecting) {
+            g_eseRectSelecting = false;
+            if (fabs(mouseX - g_eseRectStartX) >= 3.0 || fabs(mouseY - g_eseRectStartY) >= 3.0) {
+                ese_select_vertices_in_rect(g_eseRectStartX, g_eseRectStartY, mouseX, mouseY, ctrlPressed);
+                rectReleased = true;
+            }
+        }
+        
         // Left-click drag: rotate camera (orbit) - only if not dragging gizmo
         // In vertex mode, single click selects vertex (no drag)
-        if (leftDown && g_eseLeftMouseDown && !g_eseGizmoDragging) {
+        if (leftDown && g_eseLeftMouseDown && !g_eseGizmoDragging && !g_eseRectSelecting) {
             float rotationSpeed = 0.3f;
             g_eseCameraYaw -= (float)deltaX * rotationSpeed;
             g_eseCameraPitch += (float)deltaY * rotationSpeed;
@@ -10465,7 +10516,7 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
         }
         
         // Vertex selection on left-click release (in vertex mode)
-        if (!leftDown && g_eseLeftMouseDown && g_eseVertexMode && g_eseModelLoaded && g_objMeshResource) {
+        if (!leftDown && g_eseLeftMouseDown && g_eseVertexMode && g_eseModelLoaded && g_objMeshResource && !rectReleased) {
             // Only select if this was a click (not a drag)
             if (fabs(deltaX) < 3.0 && fabs(deltaY) < 3.0) {
                 // Perform vertex picking
@@ -10516,7 +10567,18 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
                 
                 // Get vertex data from mesh resource
                 const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
-                for (size_t i = 0; i < vertices.size(); i++) {
+                const std::vector<uint32_t>& indices = g_objMeshResource->getIndices();
+                
+                // Candidates: corners of the triangles the BVH finds within the
+                // pick cone below, ascending so ties resolve as before
+                std::vector<uint32_t> candidates;
+                ese_pick_bvh().forEachNearRay(&cameraPos.x, &rayDir.x, 0.05f / g_eseCameraDistance, [&](uint32_t tri) {
+                    candidates.insert(candidates.end(), &indices[size_t(tri) * 3], &indices[size_t(tri) * 3] + 3);
+                });
+                std::sort(candidates.begin(), candidates.end());
+                candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+                
+                for (uint32_t i : candidates) {
                     glm::vec3 vertPos(vertices[i].pos[0], vertices[i].pos[1], vertices[i].pos[2]);
                     
                     // Calculate distance from vertex to ray
@@ -10621,7 +10683,13 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
                 float closestDist = FLT_MAX;
                 int closestEdge = -1;
                 
-                for (size_t ei = 0; ei < g_eseQuadEdges.size(); ei++) {
+                // Candidates within the pick cone below, from the BVH
+                std::vector<int> candidates;
+                if (!ese_quad_edges_near_ray(cameraPos, rayDir, 0.12f / g_eseCameraDistance, candidates)) {
+                    for (int ei = 0; ei < (int)g_eseQuadEdges.size(); ei++) candidates.push_back(ei);
+                }
+                
+                for (int ei : candidates) {
                     const QuadEdge& qe = g_eseQuadEdges[ei];
                     
                     if (qe.v0 >= vertices.size() || qe.v1 >= vertices.size()) continue;
@@ -10633,8 +10701,8 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
                     // Backface culling: check if any quad containing this edge is visible
                     bool anyVisible = false;
                     
-                    if (!qe.quadIndices.empty()) {
-                        for (int qi : qe.quadIndices) {
+                    if (qe.quads[0] >= 0 || qe.quads[1] >= 0) {
+                        for (int qi : qe.quads) {
                             if (qi >= 0 && qi < (int)g_eseReconstructedQuads.size()) {
                                 const auto& quad = g_eseReconstructedQuads[qi];
                                 glm::vec3 qp0(vertices[quad[0]].pos[0], vertices[quad[0]].pos[1], vertices[quad[0]].pos[2]);
@@ -10764,52 +10832,14 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
                 glm::vec4 rayWorld4 = invView * rayEye;
                 glm::vec3 rayDir = glm::normalize(glm::vec3(rayWorld4));
                 
-                // Find closest face (ray-triangle intersection)
+                // Find closest front-facing triangle
                 const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
                 const std::vector<uint32_t>& indices = g_objMeshResource->getIndices();
                 
-                float closestT = FLT_MAX;
+                eden::MeshBVH::Hit hit;
                 int closestFace = -1;
-                
-                size_t numFaces = indices.size() / 3;
-                for (size_t faceIdx = 0; faceIdx < numFaces; faceIdx++) {
-                    size_t triStart = faceIdx * 3;
-                    if (triStart + 2 >= indices.size()) break;
-                    
-                    glm::vec3 v0(vertices[indices[triStart]].pos[0], vertices[indices[triStart]].pos[1], vertices[indices[triStart]].pos[2]);
-                    glm::vec3 v1(vertices[indices[triStart + 1]].pos[0], vertices[indices[triStart + 1]].pos[1], vertices[indices[triStart + 1]].pos[2]);
-                    glm::vec3 v2(vertices[indices[triStart + 2]].pos[0], vertices[indices[triStart + 2]].pos[1], vertices[indices[triStart + 2]].pos[2]);
-                    
-                    // Backface culling
-                    glm::vec3 faceNormal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-                    glm::vec3 faceCenter = (v0 + v1 + v2) / 3.0f;
-                    if (glm::dot(faceNormal, glm::normalize(cameraPos - faceCenter)) <= 0.0f) continue;
-                    
-                    // Moller-Trumbore ray-triangle intersection
-                    glm::vec3 edge1 = v1 - v0;
-                    glm::vec3 edge2 = v2 - v0;
-                    glm::vec3 h = glm::cross(rayDir, edge2);
-                    float a = glm::dot(edge1, h);
-                    
-                    if (fabs(a) < 0.0001f) continue;  // Ray parallel to triangle
-                    
-                    float f = 1.0f / a;
-                    glm::vec3 s = cameraPos - v0;
-                    float u = f * glm::dot(s, h);
-                    
-                    if (u < 0.0f || u > 1.0f) continue;
-                    
-                    glm::vec3 q = glm::cross(s, edge1);
-                    float v = f * glm::dot(rayDir, q);
-                    
-                    if (v < 0.0f || u + v > 1.0f) continue;
-                    
-                    float t = f * glm::dot(edge2, q);
-                    
-                    if (t > 0.001f && t < closestT) {
-                        closestT = t;
-                        closestFace = (int)faceIdx;
-                    }
+                if (ese_pick_bvh().intersect(vertices, indices, &cameraPos.x, &rayDir.x, hit, true)) {
+                    closestFace = (int)hit.triangle;
                 }
                 
                 if (closestFace >= 0) {
@@ -10865,48 +10895,21 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
                 
                 const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
                 
-                // Find closest quad (ray-quad intersection)
-                float closestT = FLT_MAX;
+                // Find closest quad: the nearest front-facing triangle that
+                // belongs to one (leftover triangles don't block the ray)
+                const std::vector<uint32_t>& indices = g_objMeshResource->getIndices();
+                const std::vector<uint32_t>& triangleFaces = g_eseTopology.triangleFaces();
                 int closestQuad = -1;
                 
-                for (size_t qi = 0; qi < g_eseReconstructedQuads.size(); qi++) {
-                    const auto& quad = g_eseReconstructedQuads[qi];
-                    
-                    glm::vec3 p0(vertices[quad[0]].pos[0], vertices[quad[0]].pos[1], vertices[quad[0]].pos[2]);
-                    glm::vec3 p1(vertices[quad[1]].pos[0], vertices[quad[1]].pos[1], vertices[quad[1]].pos[2]);
-                    glm::vec3 p2(vertices[quad[2]].pos[0], vertices[quad[2]].pos[1], vertices[quad[2]].pos[2]);
-                    glm::vec3 p3(vertices[quad[3]].pos[0], vertices[quad[3]].pos[1], vertices[quad[3]].pos[2]);
-                    
-                    // Backface culling
-                    glm::vec3 center = (p0 + p1 + p2 + p3) * 0.25f;
-                    glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-                    if (glm::dot(normal, glm::normalize(cameraPos - center)) <= 0.0f) continue;
-                    
-                    // Test two triangles that make up the quad
-                    auto testTriangle = [&](glm::vec3 v0, glm::vec3 v1, glm::vec3 v2) -> float {
-                        glm::vec3 edge1 = v1 - v0;
-                        glm::vec3 edge2 = v2 - v0;
-                        glm::vec3 h = glm::cross(rayDir, edge2);
-                        float a = glm::dot(edge1, h);
-                        if (fabs(a) < 0.0001f) return FLT_MAX;
-                        float f = 1.0f / a;
-                        glm::vec3 s = cameraPos - v0;
-                        float u = f * glm::dot(s, h);
-                        if (u < 0.0f || u > 1.0f) return FLT_MAX;
-                        glm::vec3 q = glm::cross(s, edge1);
-                        float v = f * glm::dot(rayDir, q);
-                        if (v < 0.0f || u + v > 1.0f) return FLT_MAX;
-                        float t = f * glm::dot(edge2, q);
-                        return (t > 0.001f) ? t : FLT_MAX;
+                if (triangleFaces.size() == indices.size() / 3) {
+                    auto quadOf = [&](uint32_t tri) {
+                        uint32_t face = triangleFaces[tri];
+                        return face < g_eseFaceQuads.size() ? g_eseFaceQuads[face] : -1;
                     };
-                    
-                    float t1 = testTriangle(p0, p1, p2);
-                    float t2 = testTriangle(p0, p2, p3);
-                    float t = std::min(t1, t2);
-                    
-                    if (t < closestT) {
-                        closestT = t;
-                        closestQuad = (int)qi;
+                    eden::MeshBVH::Hit hit;
+                    if (ese_pick_bvh().intersect(vertices, indices, &cameraPos.x, &rayDir.x, hit, true,
+                                                 [&](uint32_t tri) { return quadOf(tri) >= 0; })) {
+                        closestQuad = quadOf(hit.triangle);
                     }
                 }
                 
@@ -11281,6 +11284,7 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
         if (ImGui::Begin("Vertex Info")) {
             ImGui::TextColored(ImVec4(0.2f, 1.0f, 0.2f, 1.0f), "VERTEX MODE ACTIVE");
             ImGui::Text("Click to select, Ctrl+click to multi-select");
+            ImGui::Text("Shift+drag to box select");
             ImGui::Separator();
             
             if (!g_eseSelectedVertices.empty()) {
@@ -11519,7 +11523,7 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
                 }
                 
                 ImGui::Separator();
-                ImGui::Text("In %zu quad(s)", qe.quadIndices.size());
+                ImGui::Text("In %d quad(s)", (qe.quads[0] >= 0 ? 1 : 0) + (qe.quads[1] >= 0 ? 1 : 0));
                 
                 // Calculate edge length
                 if (qe.v0 < vertices.size() && qe.v1 < vertices.size()) {
@@ -11742,6 +11746,16 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
         }
     }
     
+    // Box select rectangle
+    if (g_eseRectSelecting) {
+        ImDrawList* drawList = ImGui::GetForegroundDrawList();
+        ImVec2 from((float)g_eseRectStartX, (float)g_eseRectStartY), to((float)g_eseLastMouseX, (float)g_eseLastMouseY);
+        drawList->AddRectFilled(ImVec2(std::min(from.x, to.x), std::min(from.y, to.y)),
+                                ImVec2(std::max(from.x, to.x), std::max(from.y, to.y)), IM_COL32(80, 160, 255, 40));
+        drawList->AddRect(ImVec2(std::min(from.x, to.x), std::min(from.y, to.y)),
+                          ImVec2(std::max(from.x, to.x), std::max(from.y, to.y)), IM_COL32(80, 160, 255, 200));
+    }
+    
     // Quad mode visualization and info panel
     static glm::vec3 g_eseSelectedQuadCenter(0.0f);
     
@@ -11750,92 +11764,16 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
         const std::vector<MeshVertex>& vertices = g_objMeshResource->getVertices();
         const std::vector<uint32_t>& indices = g_objMeshResource->getIndices();
         
-        // Rebuild quads if needed (only when model changes)
-        bool shouldRebuildQuads = (indices.size() != g_eseLastQuadIndexCount) || g_eseReconstructedQuads.empty();
+        // Rebuild the topology when something other than its own edits changed
+        // the mesh (a new model, undo); extrusion and edge loops keep it current
+        bool shouldRebuildQuads = (indices.size() != g_eseLastQuadIndexCount) ||
+                                  (vertices.size() != g_eseTopology.vertexCount());
         if (shouldRebuildQuads) {
-            g_eseReconstructedQuads.clear();
             g_eseLastQuadIndexCount = indices.size();
-            
-            // Find coplanar adjacent triangles to form quads
-            size_t numFaces = indices.size() / 3;
-            std::set<size_t> usedFaces;
-            
-            for (size_t i = 0; i < numFaces && g_eseReconstructedQuads.size() < 20000; i++) {
-                if (usedFaces.count(i)) continue;
-                
-                size_t triStart1 = i * 3;
-                uint32_t a1 = indices[triStart1], b1 = indices[triStart1+1], c1 = indices[triStart1+2];
-                
-                glm::vec3 v0(vertices[a1].pos[0], vertices[a1].pos[1], vertices[a1].pos[2]);
-                glm::vec3 v1(vertices[b1].pos[0], vertices[b1].pos[1], vertices[b1].pos[2]);
-                glm::vec3 v2(vertices[c1].pos[0], vertices[c1].pos[1], vertices[c1].pos[2]);
-                glm::vec3 n1 = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-                
-                // Find adjacent triangle with same normal
-                for (size_t j = i + 1; j < numFaces; j++) {
-                    if (usedFaces.count(j)) continue;
-                    
-                    size_t triStart2 = j * 3;
-                    uint32_t a2 = indices[triStart2], b2 = indices[triStart2+1], c2 = indices[triStart2+2];
-                    
-                    // Check for shared edge
-                    std::set<uint32_t> verts1 = {a1, b1, c1};
-                    std::set<uint32_t> verts2 = {a2, b2, c2};
-                    std::vector<uint32_t> shared;
-                    for (uint32_t v : verts1) if (verts2.count(v)) shared.push_back(v);
-                    
-                    if (shared.size() == 2) {
-                        // Shared edge found, check if coplanar
-                        glm::vec3 u0(vertices[a2].pos[0], vertices[a2].pos[1], vertices[a2].pos[2]);
-                        glm::vec3 u1(vertices[b2].pos[0], vertices[b2].pos[1], vertices[b2].pos[2]);
-                        glm::vec3 u2(vertices[c2].pos[0], vertices[c2].pos[1], vertices[c2].pos[2]);
-                        glm::vec3 n2 = glm::normalize(glm::cross(u1 - u0, u2 - u0));
-                        
-                        if (glm::dot(n1, n2) > 0.95f) {  // Relaxed threshold for better quad detection
-                            // Coplanar - form a quad
-                            uint32_t unshared1 = 0, unshared2 = 0;
-                            for (uint32_t v : verts1) if (!verts2.count(v)) unshared1 = v;
-                            for (uint32_t v : verts2) if (!verts1.count(v)) unshared2 = v;
-                            
-                            g_eseReconstructedQuads.push_back({shared[0], unshared1, shared[1], unshared2});
-                            usedFaces.insert(i);
-                            usedFaces.insert(j);
-                            break;
-                        }
-                    }
-                }
-            }
-            
-            // Build quad edges DIRECTLY from reconstructed quads
-            // Each quad has 4 perimeter edges: (0-1), (1-2), (2-3), (3-0)
-            g_eseQuadEdges.clear();
-            
-            std::map<std::pair<uint32_t, uint32_t>, int> edgeToQuadEdgeIndex;
-            
-            for (int qi = 0; qi < (int)g_eseReconstructedQuads.size(); qi++) {
-                const auto& q = g_eseReconstructedQuads[qi];
-                
-                // Add all 4 perimeter edges of this quad
-                for (int e = 0; e < 4; e++) {
-                    uint32_t va = q[e];
-                    uint32_t vb = q[(e + 1) % 4];
-                    auto key = std::make_pair(std::min(va, vb), std::max(va, vb));
-                    
-                    if (edgeToQuadEdgeIndex.count(key) == 0) {
-                        // New edge
-                        QuadEdge qe;
-                        qe.v0 = va;
-                        qe.v1 = vb;
-                        qe.quadIndices.push_back(qi);
-                        qe.edgeInQuad = e;
-                        edgeToQuadEdgeIndex[key] = (int)g_eseQuadEdges.size();
-                        g_eseQuadEdges.push_back(qe);
-                    } else {
-                        // Edge already exists, add this quad to it
-                        g_eseQuadEdges[edgeToQuadEdgeIndex[key]].quadIndices.push_back(qi);
-                    }
-                }
+            if (!g_eseTopology.build(vertices, indices, ese_position_hash())) {
+                std::cerr << "[ESE] Mesh has out-of-range indices - no quads" << std::endl;
             }
+            ese_refresh_quad_views();
             
             std::cout << "[ESE] Built " << g_eseQuadEdges.size() << " edges from " 
                       << g_eseReconstructedQuads.size() << " quads" << std::endl;
@@ -12416,6 +12354,9 @@ extern "C" void heidic_render_ese(GLFWwindow* window) {
     vkWaitForFences(g_device, 1, &g_inFlightFence, VK_TRUE, UINT64_MAX);
     vkResetFences(g_device, 1, &g_inFlightFence);
     
+    // This frame's edits into the mesh buffers, now that no frame reads them
+    if (g_objMeshResource) g_objMeshResource->uploadDirty();
+    
     // Acquire swapchain image
     uint32_t imageIndex;
     VkResult result = vkAcquireNextImageKHR(g_device, g_swapchain, UINT64_MAX, 
@@ -12736,44 +12677,178 @@ extern "C" void heidic_cleanup_ese() {
 
 static HDMProperties g_loadedHdmProperties;  // Properties from last loaded HDM
 
+// Files from hdm_load_batch(); the pool itself isn't thread-safe
+static vkcore::HandlePool<HDMProperties> g_hdmHandles;
+static std::mutex g_hdmHandlesMutex;
+
+static HDMItemPropertiesC hdm_item_properties_c(const HDMProperties& props) {
+    HDMItemPropertiesC result = {};
+    result.item_type_id = props.item.item_type_id;
+    strncpy(result.item_name, props.item.item_name, sizeof(result.item_name) - 1);
+    result.trade_value = props.item.trade_value;
+    result.condition = props.item.condition;
+    result.weight = props.item.weight;
+    result.category = props.item.category;
+    result.is_salvaged = props.item.is_salvaged ? 1 : 0;
+    return result;
+}
+
+static HDMPhysicsPropertiesC hdm_physics_properties_c(const HDMProperties& props) {
+    HDMPhysicsPropertiesC result = {};
+    result.collision_type = props.physics.collision_type;
+    result.collision_bounds_x = props.physics.collision_bounds[0];
+    result.collision_bounds_y = props.physics.collision_bounds[1];
+    result.collision_bounds_z = props.physics.collision_bounds[2];
+    result.is_static = props.physics.is_static ? 1 : 0;
+    result.mass = props.physics.mass;
+    return result;
+}
+
+static HDMModelPropertiesC hdm_model_properties_c(const HDMProperties& props) {
+    HDMModelPropertiesC result = {};
+    strncpy(result.obj_path, props.model.obj_path, sizeof(result.obj_path) - 1);
+    strncpy(result.texture_path, props.model.texture_path, sizeof(result.texture_path) - 1);
+    result.scale_x = props.model.scale[0];
+    result.scale_y = props.model.scale[1];
+    result.scale_z = props.model.scale[2];
+    return result;
+}
+
+// A copy, so the lock isn't held while the caller converts it
+static HDMProperties hdm_handle_properties(HDMHandle handle) {
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    if (const HDMProperties* props = g_hdmHandles.get(handle)) return *props;
+    HDMProperties defaults;
+    hdm_init_default_properties(defaults);
+    return defaults;
+}
+
 extern "C" int hdm_load_file(const char* filepath) {
     hdm_init_default_properties(g_loadedHdmProperties);
     return hdm_load_json(filepath, g_loadedHdmProperties) ? 1 : 0;
 }
 
 extern "C" HDMItemPropertiesC hdm_get_item_properties() {
-    HDMItemPropertiesC result;
-    result.item_type_id = g_loadedHdmProperties.item.item_type_id;
-    strncpy(result.item_name, g_loadedHdmProperties.item.item_name, sizeof(result.item_name) - 1);
-    result.trade_value = g_loadedHdmProperties.item.trade_value;
-    result.condition = g_loadedHdmProperties.item.condition;
-    result.weight = g_loadedHdmProperties.item.weight;
-    result.category = g_loadedHdmProperties.item.category;
-    result.is_salvaged = g_loadedHdmProperties.item.is_salvaged ? 1 : 0;
-    return result;
+    return hdm_item_properties_c(g_loadedHdmProperties);
 }
 
 extern "C" HDMPhysicsPropertiesC hdm_get_physics_properties() {
-    HDMPhysicsPropertiesC result;
-    result.collision_type = g_loadedHdmProperties.physics.collision_type;
-    result.collision_bounds_x = g_loadedHdmProperties.physics.collision_bounds[0];
-    result.collision_bounds_y = g_loadedHdmProperties.physics.collision_bounds[1];
-    result.collision_bounds_z = g_loadedHdmProperties.physics.collision_bounds[2];
-    result.is_static = g_loadedHdmProperties.physics.is_static ? 1 : 0;
-    result.mass = g_loadedHdmProperties.physics.mass;
-    return result;
+    return hdm_physics_properties_c(g_loadedHdmProperties);
 }
 
 extern "C" HDMModelPropertiesC hdm_get_model_properties() {
-    HDMModelPropertiesC result;
-    strncpy(result.obj_path, g_loadedHdmProperties.model.obj_path, sizeof(result.obj_path) - 1);
-    strncpy(result.texture_path, g_loadedHdmProperties.model.texture_path, sizeof(result.texture_path) - 1);
-    result.scale_x = g_loadedHdmProperties.model.scale[0];
-    result.scale_y = g_loadedHdmProperties.model.scale[1];
-    result.scale_z = g_loadedHdmProperties.model.scale[2];
+    return hdm_model_properties_c(g_loadedHdmProperties);
+}
+
+extern "C" int hdm_load_batch(const char* const* paths, int count, HDMHandle* handles) {
+    if (!paths || !handles || count <= 0) return 0;
+    auto start = std::chrono::steady_clock::now();
+
+    // Files parse on the workers into a private array (one file per range,
+    // since sizes vary); only handing out handles takes the lock
+    std::vector<HDMProperties> loaded(static_cast<size_t>(count));
+    std::vector<char> ok(static_cast<size_t>(count), 0);
+    parallel_for(static_cast<size_t>(count), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (!paths[i]) continue;
+            hdm_init_default_properties(loaded[i]);
+            ok[i] = hdm_load_json(paths[i], loaded[i], false);
+        }
+    }, 1);
+
+    int loadedCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+        for (int i = 0; i < count; i++) {
+            handles[i] = ok[size_t(i)] ? g_hdmHandles.insert(loaded[size_t(i)]) : HDM_INVALID_HANDLE;
+            if (handles[i] != HDM_INVALID_HANDLE) loadedCount++;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[ESE] Loaded " << loadedCount << "/" << count << " HDM files in " << ms << " ms" << std::endl;
+    return loadedCount;
+}
+
+extern "C" int hdm_handle_valid(HDMHandle handle) {
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    return g_hdmHandles.contains(handle) ? 1 : 0;
+}
+
+extern "C" HDMItemPropertiesC hdm_handle_item_properties(HDMHandle handle) {
+    return hdm_item_properties_c(hdm_handle_properties(handle));
+}
+
+extern "C" HDMPhysicsPropertiesC hdm_handle_physics_properties(HDMHandle handle) {
+    return hdm_physics_properties_c(hdm_handle_properties(handle));
+}
+
+extern "C" HDMModelPropertiesC hdm_handle_model_properties(HDMHandle handle) {
+    return hdm_model_properties_c(hdm_handle_properties(handle));
+}
+
+extern "C" void hdm_release(HDMHandle handle) {
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    g_hdmHandles.remove(handle);
+}
+
+extern "C" void hdm_release_batch(const HDMHandle* handles, int count) {
+    if (!handles) return;
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    for (int i = 0; i < count; i++) g_hdmHandles.remove(handles[i]);
+}
+
+// Physics world for HDM collision boxes; PhysicsWorld ids fit an int (MAX_ID)
+static eden::PhysicsWorld g_physicsWorld;
+
+extern "C" int heidic_physics_add_hdm_body(HDMPhysicsPropertiesC props, float x, float y, float z) {
+    const float bounds[3] = {props.collision_bounds_x, props.collision_bounds_y, props.collision_bounds_z};
+    eden::PhysicsBodyDesc desc;
+    if (!eden::PhysicsBodyDesc::fromHDM(props.collision_type, bounds, props.is_static != 0, props.mass, desc)) {
+        return -1;
+    }
+    desc.position = glm::vec3(x, y, z);
+    uint32_t body = g_physicsWorld.addBody(desc);
+    return body == eden::PhysicsWorld::INVALID ? -1 : static_cast<int>(body);
+}
+
+extern "C" void heidic_physics_remove_body(int body) {
+    g_physicsWorld.removeBody(static_cast<uint32_t>(body));
+}
+
+extern "C" int heidic_physics_step(float dt) {
+    return static_cast<int>(g_physicsWorld.step(dt));
+}
+
+extern "C" Vec3 heidic_physics_get_position(int body) {
+    glm::vec3 p = g_physicsWorld.getInterpolatedPosition(static_cast<uint32_t>(body));
+    Vec3 result;
+    result.x = p.x;
+    result.y = p.y;
+    result.z = p.z;
     return result;
 }
 
+extern "C" void heidic_physics_set_position(int body, float x, float y, float z) {
+    g_physicsWorld.setPosition(static_cast<uint32_t>(body), glm::vec3(x, y, z));
+}
+
+extern "C" void heidic_physics_set_velocity(int body, float x, float y, float z) {
+    g_physicsWorld.setVelocity(static_cast<uint32_t>(body), glm::vec3(x, y, z));
+}
+
+extern "C" void heidic_physics_apply_impulse(int body, float x, float y, float z) {
+    g_physicsWorld.applyImpulse(static_cast<uint32_t>(body), glm::vec3(x, y, z));
+}
+
+extern "C" int heidic_physics_is_sleeping(int body) {
+    return g_physicsWorld.isSleeping(static_cast<uint32_t>(body)) ? 1 : 0;
+}
+
+extern "C" void heidic_physics_clear() {
+    g_physicsWorld.clear();
+}
+
 // NFD (Native File Dialog) functions for ESE
 // Using Windows API for file dialogs
 #ifdef _WIN32
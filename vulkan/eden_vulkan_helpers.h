@@ -81,6 +81,8 @@ void heidic_imgui_render(VkCommandBuffer commandBuffer);
 void heidic_cleanup_imgui();
 // Helper to render a simple demo overlay (FPS, camera info, etc.)
 void heidic_imgui_render_demo_overlay(float fps, float camera_x, float camera_y, float camera_z);
+// Per-system timings (average, p99) from code compiled with `heidic_v2 compile --profile`
+void heidic_imgui_render_profiler_overlay();
 
 // DDS texture quad rendering (for testing DDS loader)
 // Initialize renderer and load DDS texture from path (relative to project directory)
@@ -141,6 +143,10 @@ int heidic_raycast_cube_hit_center(GLFWwindow* window, float cubeX, float cubeY,
 Vec3 heidic_raycast_cube_hit_point_center(GLFWwindow* window, float cubeX, float cubeY, float cubeZ, float cubeSx, float cubeSy, float cubeSz);
 // Get cube position (for HEIDIC to read) - returns Vec3
 Vec3 heidic_get_cube_position(int cube_index);
+// Add a cube (after heidic_init_renderer_fps; no fixed limit) - returns its index, or -1
+int heidic_add_cube(float x, float y, float z, float size_x, float size_y, float size_z, float r, float g, float b);
+// Number of colored cubes (reference cubes plus added ones)
+int heidic_get_cube_count();
 // Set cube position (for HEIDIC to update picked-up cube)
 void heidic_set_cube_position(int cube_index, float x, float y, float z);
 // Set cube rotation (yaw in degrees, for visual rotation around Y axis)
@@ -205,6 +211,10 @@ bool ui_manager_init();
 bool ui_manager_is_enabled();
 void ui_manager_update();
 void ui_manager_render();
+void ui_manager_set_text(const char* key, const char* text);
+void ui_manager_set_float(const char* key, float value);
+void ui_manager_set_frame_rate(int fps);
+bool ui_manager_poll_message(char* buffer, int bufferSize);
 void ui_manager_shutdown();
 
 // ESE (Echo Synapse Editor) functions
@@ -247,6 +257,34 @@ HDMItemPropertiesC hdm_get_item_properties();
 HDMPhysicsPropertiesC hdm_get_physics_properties();
 HDMModelPropertiesC hdm_get_model_properties();
 
+// Many files at once, e.g. every item at level start: loaded in parallel on
+// the job system, each into its own handle (HDM_INVALID_HANDLE on failure).
+// Returns how many loaded; release each valid handle when done.
+typedef uint32_t HDMHandle;
+#define HDM_INVALID_HANDLE 0xFFFFFFFFu
+int hdm_load_batch(const char* const* paths, int count, HDMHandle* handles);
+int hdm_handle_valid(HDMHandle handle);
+HDMItemPropertiesC hdm_handle_item_properties(HDMHandle handle);
+HDMPhysicsPropertiesC hdm_handle_physics_properties(HDMHandle handle);
+HDMModelPropertiesC hdm_handle_model_properties(HDMHandle handle);
+void hdm_release(HDMHandle handle);
+void hdm_release_batch(const HDMHandle* handles, int count);
+
+// Physics world for HDM collision boxes (utils/physics_world.h): axis-aligned
+// boxes stepped at a fixed 60 Hz. add returns a body id - opaque and never
+// negative, stale once removed or cleared - or -1 when the model has no
+// collision (collision_type 0). step returns the ticks it ran; get_position
+// is interpolated between the last two for rendering.
+int heidic_physics_add_hdm_body(HDMPhysicsPropertiesC props, float x, float y, float z);
+void heidic_physics_remove_body(int body);
+int heidic_physics_step(float dt);
+Vec3 heidic_physics_get_position(int body);
+void heidic_physics_set_position(int body, float x, float y, float z);
+void heidic_physics_set_velocity(int body, float x, float y, float z);
+void heidic_physics_apply_impulse(int body, float x, float y, float z);
+int heidic_physics_is_sleeping(int body);
+void heidic_physics_clear();
+
 // NFD (Native File Dialog) functions for ESE
 // Returns file path or empty string if cancelled
 const char* nfd_open_file_dialog(const char* filterList, const char* defaultPath);
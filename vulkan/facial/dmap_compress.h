@@ -0,0 +1,265 @@
+// ============================================================================
+// DMAP COMPRESS - DMap layers for the FacialSystem texture array
+// ============================================================================
+// Part of the EDEN Engine facial animation system.
+//
+// FacialSystem keeps every DMap as one layer of two array images: XY in a
+// two-channel image and Z in a one-channel image. Uncompressed that is
+// R8G8 + R8 (3 bytes per texel instead of RGBA8's 4); with BC it is BC5 +
+// BC4 (1.5 bytes per texel, ~2.7x smaller than RGBA8). The shaders decode
+// both the same way, so only the formats change.
+//
+// The BC4 encoder (BC5 is two BC4 blocks) is a single pass per 4x4 block -
+// no iterative endpoint search - and keeps neutral grey exact: a block
+// holding any 128 texel only tries endpoint pairs with 128 as one endpoint,
+// since endpoints are the only values every decoder reproduces bit-exactly
+// (interpolated ones are only accurate to about a step). Flat neutral
+// blocks are stored as 128/128. The blend shaders' neutral threshold thus
+// sees the same zeros as with the uncompressed layer. Block rows are spread
+// over threads like dmap_padding.h's rows.
+//
+// Each plane reports the largest |decoded - source| in 8-bit steps;
+// FacialSystem compares it with the allowed error to pick the formats.
+//
+// Header-only, like dmap_padding.h.
+//
+// Usage:
+//   std::vector<uint8_t> xy, z;
+//   splitDMapPlanes(pixels, w, h, channels, layerW, layerH, xy, z);
+//   std::vector<uint8_t> bc5(bcPlaneSize(layerW, layerH, 2));
+//   uint32_t error = compressBCPlane(xy.data(), layerW, layerH, 2, bc5.data());
+// ============================================================================
+
+#ifndef FACIAL_DMAP_COMPRESS_H
+#define FACIAL_DMAP_COMPRESS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "dmap_padding.h"  // detail::forEachRow
+
+namespace facial {
+
+namespace detail {
+
+constexpr uint8_t BC_NEUTRAL_VALUE = 128;
+
+// BC4 palette for endpoints e0/e1 (e0 > e1: six interpolated values,
+// otherwise four plus 0 and 255)
+inline void bc4Palette(uint8_t e0, uint8_t e1, uint8_t palette[8]) {
+    palette[0] = e0;
+    palette[1] = e1;
+    if (e0 > e1) {
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1] = static_cast<uint8_t>(((7 - i) * e0 + i * e1 + 3) / 7);
+        }
+    } else {
+        for (int i = 1; i < 5; i++) {
+            palette[i + 1] = static_cast<uint8_t>(((5 - i) * e0 + i * e1 + 2) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+// Nearest palette entry per texel; returns the largest error and adds the
+// squared errors to `sse`
+inline uint32_t bc4Fit(const uint8_t texels[16], const uint8_t palette[8], uint8_t indices[16], uint32_t& sse) {
+    uint32_t maxError = 0;
+    sse = 0;
+    for (int t = 0; t < 16; t++) {
+        uint32_t best = 256;
+        for (uint8_t i = 0; i < 8; i++) {
+            uint32_t error = static_cast<uint32_t>(std::abs(int(texels[t]) - int(palette[i])));
+            if (error < best) {
+                best = error;
+                indices[t] = i;
+            }
+        }
+        maxError = std::max(maxError, best);
+        sse += best * best;
+    }
+    return maxError;
+}
+
+} // namespace detail
+
+// ============================================================================
+// BC4 blocks
+// ============================================================================
+
+// 16 texels (row-major 4x4) into one 8-byte BC4 UNORM block. Returns the
+// largest |decoded - source| in the block.
+inline uint32_t encodeBC4Block(const uint8_t texels[16], uint8_t out[8]) {
+    const uint8_t neutral = detail::BC_NEUTRAL_VALUE;
+    uint8_t lo = 255, hi = 0;
+    bool hasNeutral = false;
+    for (int t = 0; t < 16; t++) {
+        lo = std::min(lo, texels[t]);
+        hi = std::max(hi, texels[t]);
+        hasNeutral |= texels[t] == neutral;
+    }
+
+    // Candidate endpoint pairs; blocks touching neutral keep 128 an endpoint
+    uint8_t candidates[4][2];
+    int candidateCount = 0;
+    auto addCandidate = [&](uint8_t e0, uint8_t e1) {
+        candidates[candidateCount][0] = e0;
+        candidates[candidateCount][1] = e1;
+        candidateCount++;
+    };
+    if (lo == hi) {
+        addCandidate(lo, lo);
+    } else if (hasNeutral) {
+        if (lo < neutral) {
+            addCandidate(neutral, lo);   // Six steps down to lo
+            addCandidate(lo, neutral);   // Four steps, plus 0 / 255
+        }
+        if (hi > neutral) {
+            addCandidate(hi, neutral);
+            addCandidate(neutral, hi);
+        }
+    } else {
+        addCandidate(hi, lo);
+        addCandidate(lo, hi);
+    }
+
+    uint32_t bestMax = UINT32_MAX, bestSse = UINT32_MAX;
+    uint8_t bestE0 = lo, bestE1 = lo;
+    uint8_t bestIndices[16] = {};
+    for (int c = 0; c < candidateCount; c++) {
+        uint8_t palette[8];
+        uint8_t indices[16];
+        uint32_t sse = 0;
+        detail::bc4Palette(candidates[c][0], candidates[c][1], palette);
+        uint32_t maxError = detail::bc4Fit(texels, palette, indices, sse);
+        if (maxError < bestMax || (maxError == bestMax && sse < bestSse)) {
+            bestMax = maxError;
+            bestSse = sse;
+            bestE0 = candidates[c][0];
+            bestE1 = candidates[c][1];
+            memcpy(bestIndices, indices, sizeof(indices));
+        }
+    }
+
+    // Endpoints, then 16 3-bit indices (texel 0 in the low bits)
+    uint64_t bits = 0;
+    for (int t = 0; t < 16; t++) {
+        bits |= static_cast<uint64_t>(bestIndices[t]) << (3 * t);
+    }
+    out[0] = bestE0;
+    out[1] = bestE1;
+    for (int i = 0; i < 6; i++) {
+        out[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+    return bestMax;
+}
+
+inline void decodeBC4Block(const uint8_t in[8], uint8_t texels[16]) {
+    uint8_t palette[8];
+    detail::bc4Palette(in[0], in[1], palette);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) {
+        bits |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+    }
+    for (int t = 0; t < 16; t++) {
+        texels[t] = palette[(bits >> (3 * t)) & 7];
+    }
+}
+
+// ============================================================================
+// Planes
+// ============================================================================
+
+// Bytes of a BC4 (channels = 1) or BC5 (channels = 2) plane
+inline size_t bcPlaneSize(uint32_t width, uint32_t height, uint32_t channels) {
+    return size_t((width + 3) / 4) * ((height + 3) / 4) * 8 * channels;
+}
+
+// Interleaved 1- or 2-channel plane into BC4 / BC5 blocks (row-major; BC5
+// blocks hold the first channel's block, then the second's). Edge blocks
+// repeat the last row/column. Returns the largest error over the plane.
+inline uint32_t compressBCPlane(const uint8_t* plane, uint32_t width, uint32_t height, uint32_t channels,
+                                uint8_t* blocks, uint32_t threads = 0) {
+    if (!plane || !blocks || width == 0 || height == 0 || channels == 0) return 0;
+    const uint32_t blockRows = (height + 3) / 4;
+    const size_t rowBytes = size_t((width + 3) / 4) * 8 * channels;
+    std::vector<uint32_t> rowErrors(blockRows, 0);
+    detail::forEachRow(blockRows, threads, size_t(width) * height, [&](uint32_t row) {
+        uint8_t* out = blocks + row * rowBytes;
+        uint32_t by = row * 4;
+        uint8_t texels[16];
+        for (uint32_t bx = 0; bx < width; bx += 4) {
+            for (uint32_t c = 0; c < channels; c++) {
+                for (uint32_t t = 0; t < 16; t++) {
+                    uint32_t x = std::min(bx + (t & 3), width - 1);
+                    uint32_t y = std::min(by + (t >> 2), height - 1);
+                    texels[t] = plane[(size_t(y) * width + x) * channels + c];
+                }
+                rowErrors[row] = std::max(rowErrors[row], encodeBC4Block(texels, out));
+                out += 8;
+            }
+        }
+    });
+    return *std::max_element(rowErrors.begin(), rowErrors.end());
+}
+
+// DMap texels (RGB or RGBA; channels < 3 leave the rest neutral) into an
+// XY plane (R8G8) and a Z plane (R8) of width x height, bilinearly
+// resampled at texel centres when the sizes differ, like the blend pass
+// used to sample the smaller DMaps. Neutral areas stay exactly 128.
+inline void splitDMapPlanes(const uint8_t* pixels, uint32_t srcWidth, uint32_t srcHeight, int channels,
+                            uint32_t width, uint32_t height,
+                            std::vector<uint8_t>& xy, std::vector<uint8_t>& z) {
+    const size_t texels = size_t(width) * height;
+    xy.assign(texels * 2, detail::BC_NEUTRAL_VALUE);
+    z.assign(texels, detail::BC_NEUTRAL_VALUE);
+    if (!pixels || srcWidth == 0 || srcHeight == 0 || channels <= 0) return;
+
+    const uint32_t used = static_cast<uint32_t>(std::min(channels, 3));
+    auto store = [&](size_t i, uint32_t c, uint8_t value) {
+        if (c < 2) xy[i * 2 + c] = value;
+        else z[i] = value;
+    };
+
+    if (srcWidth == width && srcHeight == height) {
+        for (size_t i = 0; i < texels; i++) {
+            for (uint32_t c = 0; c < used; c++) store(i, c, pixels[i * channels + c]);
+        }
+        return;
+    }
+
+    const float sx = float(srcWidth) / float(width);
+    const float sy = float(srcHeight) / float(height);
+    for (uint32_t y = 0; y < height; y++) {
+        float fy = std::max((y + 0.5f) * sy - 0.5f, 0.0f);
+        uint32_t y0 = std::min(static_cast<uint32_t>(fy), srcHeight - 1);
+        uint32_t y1 = std::min(y0 + 1, srcHeight - 1);
+        float ty = fy - float(y0);
+        for (uint32_t x = 0; x < width; x++) {
+            float fx = std::max((x + 0.5f) * sx - 0.5f, 0.0f);
+            uint32_t x0 = std::min(static_cast<uint32_t>(fx), srcWidth - 1);
+            uint32_t x1 = std::min(x0 + 1, srcWidth - 1);
+            float tx = fx - float(x0);
+            const uint8_t* p00 = pixels + (size_t(y0) * srcWidth + x0) * channels;
+            const uint8_t* p10 = pixels + (size_t(y0) * srcWidth + x1) * channels;
+            const uint8_t* p01 = pixels + (size_t(y1) * srcWidth + x0) * channels;
+            const uint8_t* p11 = pixels + (size_t(y1) * srcWidth + x1) * channels;
+            size_t i = size_t(y) * width + x;
+            for (uint32_t c = 0; c < used; c++) {
+                float top = p00[c] + (p10[c] - p00[c]) * tx;
+                float bottom = p01[c] + (p11[c] - p01[c]) * tx;
+                float value = top + (bottom - top) * ty;
+                store(i, c, static_cast<uint8_t>(std::min(std::floor(value + 0.5f), 255.0f)));
+            }
+        }
+    }
+}
+
+} // namespace facial
+
+#endif // FACIAL_DMAP_COMPRESS_H
@@ -0,0 +1,314 @@
+// ============================================================================
+// DMAP PADDING - Seam padding for DMap textures, parallel and cached
+// ============================================================================
+// Part of the EDEN Engine facial animation system.
+//
+// Bleeds painted displacement into the neutral (128 grey) texels around it,
+// so bilinear fetches across UV seams don't pull vertices back toward
+// neutral and crack the mesh. Each pass, every neutral texel with painted
+// texels inside `radius` becomes a blend of them (inverse-distance
+// weighted) and neutral. Output is bit-identical to the original serial
+// loop in FacialSystem:
+//
+//   - Neutral flags are computed once per pass, 16 bytes at a time (SSE2 /
+//     NEON, scalar elsewhere), instead of once per neighbour visit.
+//   - A separable box dilation of the painted texels marks the neutral
+//     texels worth visiting; the rest (most of a DMap) have nothing in
+//     their kernel and are skipped without a neighbourhood search.
+//   - Kernel offsets and 1 / (1 + dist) weights are precomputed and visited
+//     in the original dy/dx order, so the float sums match exactly.
+//   - Rows are split across threads; each reads the pass's source copy.
+//
+// Results can be cached on disk: the file name is an FNV-1a hash of the
+// source texels and the padding parameters, so each asset is padded once.
+// The cache directory must already exist; saves into a missing one fail.
+//
+// Header-only; FacialSystem::loadDMapFromMemory() uses it.
+//
+// Usage:
+//   DMapPadSettings settings;                  // radius, blend, passes
+//   uint64_t key = hashDMapPadding(pixels, w, h, channels, settings);
+//   std::string path = paddedDMapCachePath("dmap_cache", key);
+//   if (!loadPaddedDMap(path, key, pixels, w, h, channels)) {
+//       padDMap(pixels, w, h, channels, settings);
+//       savePaddedDMap(path, key, pixels, w, h, channels);
+//   }
+// ============================================================================
+
+#ifndef FACIAL_DMAP_PADDING_H
+#define FACIAL_DMAP_PADDING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FACIAL_PAD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FACIAL_PAD_NEON 1
+#endif
+
+namespace facial {
+
+struct DMapPadSettings {
+    int radius = 3;             // Kernel radius in texels
+    float maxBlendFactor = 0.7f; // Cap on how far a padded texel moves from neutral
+    int passes = 2;             // Each pass pads outward from the last one's result
+    uint32_t threads = 0;       // 0 = hardware concurrency
+};
+
+namespace detail {
+
+constexpr uint8_t PAD_NEUTRAL_VALUE = 128;
+constexpr uint8_t PAD_NEUTRAL_THRESHOLD = 5;  // 124..132 count as neutral
+
+// out[i] = 1 where |bytes[i] - 128| < threshold
+inline void nearNeutralBytes(const uint8_t* bytes, size_t count, uint8_t* out) {
+    size_t i = 0;
+#if defined(FACIAL_PAD_SSE2)
+    const __m128i neutral = _mm_set1_epi8(static_cast<char>(PAD_NEUTRAL_VALUE));
+    const __m128i limit = _mm_set1_epi8(PAD_NEUTRAL_THRESHOLD - 1);
+    const __m128i one = _mm_set1_epi8(1);
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(v, neutral), _mm_subs_epu8(neutral, v));
+        __m128i near = _mm_cmpeq_epi8(_mm_min_epu8(diff, limit), diff);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(near, one));
+    }
+#elif defined(FACIAL_PAD_NEON)
+    const uint8x16_t neutral = vdupq_n_u8(PAD_NEUTRAL_VALUE);
+    const uint8x16_t threshold = vdupq_n_u8(PAD_NEUTRAL_THRESHOLD);
+    const uint8x16_t one = vdupq_n_u8(1);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t diff = vabdq_u8(vld1q_u8(bytes + i), neutral);
+        vst1q_u8(out + i, vandq_u8(vcltq_u8(diff, threshold), one));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = std::abs(static_cast<int>(bytes[i]) - static_cast<int>(PAD_NEUTRAL_VALUE)) < PAD_NEUTRAL_THRESHOLD;
+    }
+}
+
+// Runs fn(row) for every row, spread over `threads` threads
+template <typename Fn>
+inline void forEachRow(uint32_t height, uint32_t threads, size_t texels, Fn&& fn) {
+    uint32_t threadCount = threads != 0 ? threads : std::thread::hardware_concurrency();
+    if (texels < 256 * 256) threadCount = 1;  // Not worth the threads
+    threadCount = std::max(1u, std::min(threadCount, height));
+
+    std::atomic<uint32_t> nextRow{0};
+    auto worker = [&]() {
+        const uint32_t chunk = 16;
+        for (;;) {
+            uint32_t first = nextRow.fetch_add(chunk);
+            if (first >= height) break;
+            uint32_t last = std::min(first + chunk, height);
+            for (uint32_t y = first; y < last; ++y) fn(y);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32_t i = 1; i < threadCount; i++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool) thread.join();
+}
+
+} // namespace detail
+
+// Pads `pixels` in place (channels >= 3; only RGB is touched). Returns the
+// texels padded, summed over the passes.
+inline uint64_t padDMap(uint8_t* pixels, uint32_t width, uint32_t height, int channels,
+                        const DMapPadSettings& settings) {
+    if (!pixels || width == 0 || height == 0 || channels < 3) return 0;
+
+    const int radius = settings.radius;
+    const size_t texels = static_cast<size_t>(width) * height;
+    const size_t bytes = texels * channels;
+
+    // Kernel in the original visiting order (dy outer, dx inner)
+    struct Tap { int dx, dy; float dist, weight; };
+    std::vector<Tap> kernel;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            if (dx == 0 && dy == 0) continue;
+            float dist = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+            if (dist > radius) continue;
+            kernel.push_back({dx, dy, dist, 1.0f / (1.0f + dist)});
+        }
+    }
+    const int reach = std::max(radius, 0);
+
+    std::vector<uint8_t> source(bytes);
+    std::vector<uint8_t> nearBytes(bytes);
+    std::vector<uint8_t> painted(texels);     // 1 = non-neutral texel
+    std::vector<uint8_t> rowHit(texels);      // Painted texel within `reach` along the row
+    std::vector<uint8_t> candidate(texels);   // ... within the kernel's bounding box
+    std::vector<uint32_t> columnCount(width);
+    std::atomic<uint64_t> total{0};
+
+    for (int pass = 0; pass < settings.passes; ++pass) {
+        memcpy(source.data(), pixels, bytes);
+
+        // Painted flags (per row so the threads share the work)
+        detail::forEachRow(height, settings.threads, texels, [&](uint32_t y) {
+            size_t rowOffset = static_cast<size_t>(y) * width;
+            detail::nearNeutralBytes(&source[rowOffset * channels], static_cast<size_t>(width) * channels,
+                                     &nearBytes[rowOffset * channels]);
+            for (uint32_t x = 0; x < width; ++x) {
+                const uint8_t* n = &nearBytes[(rowOffset + x) * channels];
+                painted[rowOffset + x] = !(n[0] & n[1] & n[2]);
+            }
+
+            // Horizontal sliding count over [x - reach, x + reach]
+            int count = 0;
+            for (int x = 0; x < std::min(reach, static_cast<int>(width)); ++x) count += painted[rowOffset + x];
+            for (int x = 0; x < static_cast<int>(width); ++x) {
+                if (x + reach < static_cast<int>(width)) count += painted[rowOffset + x + reach];
+                rowHit[rowOffset + x] = count > 0;
+                if (x - reach >= 0) count -= painted[rowOffset + x - reach];
+            }
+        });
+
+        // Vertical sliding count over [y - reach, y + reach]
+        std::fill(columnCount.begin(), columnCount.end(), 0u);
+        for (int y = 0; y < std::min(reach, static_cast<int>(height)); ++y) {
+            for (uint32_t x = 0; x < width; ++x) columnCount[x] += rowHit[static_cast<size_t>(y) * width + x];
+        }
+        for (int y = 0; y < static_cast<int>(height); ++y) {
+            if (y + reach < static_cast<int>(height)) {
+                const uint8_t* add = &rowHit[static_cast<size_t>(y + reach) * width];
+                for (uint32_t x = 0; x < width; ++x) columnCount[x] += add[x];
+            }
+            uint8_t* out = &candidate[static_cast<size_t>(y) * width];
+            const uint8_t* self = &painted[static_cast<size_t>(y) * width];
+            for (uint32_t x = 0; x < width; ++x) out[x] = (columnCount[x] > 0) & !self[x];
+            if (y - reach >= 0) {
+                const uint8_t* sub = &rowHit[static_cast<size_t>(y - reach) * width];
+                for (uint32_t x = 0; x < width; ++x) columnCount[x] -= sub[x];
+            }
+        }
+
+        // Blend (same arithmetic as the original loop)
+        const float passMultiplier = 1.0f + (pass * 0.2f);
+        const float neutralValue = detail::PAD_NEUTRAL_VALUE;
+        detail::forEachRow(height, settings.threads, texels, [&](uint32_t y) {
+            uint64_t padded = 0;
+            for (uint32_t x = 0; x < width; ++x) {
+                size_t texel = static_cast<size_t>(y) * width + x;
+                if (!candidate[texel]) continue;
+
+                float totalR = 0.0f, totalG = 0.0f, totalB = 0.0f;
+                float totalWeight = 0.0f;
+                for (const Tap& tap : kernel) {
+                    int sx = static_cast<int>(x) + tap.dx;
+                    int sy = static_cast<int>(y) + tap.dy;
+                    if (sx < 0 || sx >= static_cast<int>(width) || sy < 0 || sy >= static_cast<int>(height)) continue;
+
+                    size_t neighbour = static_cast<size_t>(sy) * width + sx;
+                    if (!painted[neighbour]) continue;
+                    const uint8_t* s = &source[neighbour * channels];
+                    totalR += s[0] * tap.weight;
+                    totalG += s[1] * tap.weight;
+                    totalB += s[2] * tap.weight;
+                    totalWeight += tap.weight;
+                }
+
+                if (totalWeight > 0.001f) {
+                    float blendFactor = std::min(totalWeight / (radius * 2.0f) * passMultiplier, settings.maxBlendFactor);
+                    uint8_t* p = &pixels[texel * channels];
+                    p[0] = static_cast<uint8_t>(neutralValue * (1.0f - blendFactor) + (totalR / totalWeight) * blendFactor);
+                    p[1] = static_cast<uint8_t>(neutralValue * (1.0f - blendFactor) + (totalG / totalWeight) * blendFactor);
+                    p[2] = static_cast<uint8_t>(neutralValue * (1.0f - blendFactor) + (totalB / totalWeight) * blendFactor);
+                    padded++;
+                }
+            }
+            total += padded;
+        });
+    }
+    return total;
+}
+
+// ============================================================================
+// Disk cache
+// ============================================================================
+
+constexpr uint32_t PADDED_DMAP_MAGIC = 0x44415044;  // "DPAD"
+constexpr uint32_t PADDED_DMAP_VERSION = 1;
+
+// FNV-1a over the source texels and everything the result depends on (not
+// the thread count)
+inline uint64_t hashDMapPadding(const uint8_t* pixels, uint32_t width, uint32_t height, int channels,
+                                const DMapPadSettings& settings) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            h ^= bytes[i];
+            h *= 0x100000001b3ull;
+        }
+    };
+    uint32_t version = PADDED_DMAP_VERSION;
+    mix(&version, sizeof(version));
+    mix(&width, sizeof(width));
+    mix(&height, sizeof(height));
+    mix(&channels, sizeof(channels));
+    mix(&settings.radius, sizeof(settings.radius));
+    mix(&settings.maxBlendFactor, sizeof(settings.maxBlendFactor));
+    mix(&settings.passes, sizeof(settings.passes));
+    mix(pixels, static_cast<size_t>(width) * height * channels);
+    return h;
+}
+
+inline std::string paddedDMapCachePath(const std::string& directory, uint64_t hash) {
+    static const char* hex = "0123456789abcdef";
+    std::string name = "dmap_";
+    for (int shift = 60; shift >= 0; shift -= 4) name += hex[(hash >> shift) & 0xF];
+    return directory + "/" + name + ".pad";
+}
+
+// Replaces `pixels` with the cached result; false (pixels untouched) on a
+// missing, corrupt or mismatched file
+inline bool loadPaddedDMap(const std::string& path, uint64_t hash, uint8_t* pixels,
+                           uint32_t width, uint32_t height, int channels) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    uint32_t header[5] = {};
+    uint64_t storedHash = 0;
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&storedHash), sizeof(storedHash));
+    if (!file || header[0] != PADDED_DMAP_MAGIC || header[1] != PADDED_DMAP_VERSION || storedHash != hash ||
+        header[2] != width || header[3] != height || header[4] != static_cast<uint32_t>(channels)) {
+        return false;
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(width) * height * channels);
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    if (!file) return false;
+    memcpy(pixels, data.data(), data.size());
+    return true;
+}
+
+inline bool savePaddedDMap(const std::string& path, uint64_t hash, const uint8_t* pixels,
+                           uint32_t width, uint32_t height, int channels) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    uint32_t header[5] = {PADDED_DMAP_MAGIC, PADDED_DMAP_VERSION, width, height, static_cast<uint32_t>(channels)};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    file.write(reinterpret_cast<const char*>(pixels), static_cast<size_t>(width) * height * channels);
+    return bool(file);
+}
+
+} // namespace facial
+
+#endif // FACIAL_DMAP_PADDING_H
@@ -3,8 +3,10 @@
 // ============================================================================
 
 #include "facial_painter.h"
+#include "../../stdlib/vfs.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 
@@ -21,6 +23,7 @@ FacialPainter::FacialPainter() {
 }
 
 FacialPainter::~FacialPainter() {
+    releaseGPU();
 }
 
 // ============================================================================
@@ -35,6 +38,12 @@ bool FacialPainter::init(const std::vector<glm::vec3>& positions,
         std::cerr << "[FacialPainter] Mismatched vertex data sizes!" << std::endl;
         return false;
     }
+    for (uint32_t index : indices) {
+        if (index >= positions.size()) {
+            std::cerr << "[FacialPainter] Index " << index << " out of range!" << std::endl;
+            return false;
+        }
+    }
     
     m_paintedVertices.clear();
     m_paintedVertices.resize(positions.size());
@@ -48,6 +57,34 @@ bool FacialPainter::init(const std::vector<glm::vec3>& positions,
     }
     
     m_indices = indices;
+    m_indices.resize(m_indices.size() - m_indices.size() % 3);
+    
+    // Vertex -> triangle adjacency (counting sort into CSR)
+    size_t vertexCount = positions.size();
+    m_vertexTriangleStart.assign(vertexCount + 1, 0);
+    for (uint32_t index : m_indices) {
+        m_vertexTriangleStart[index + 1]++;
+    }
+    for (size_t i = 0; i < vertexCount; ++i) {
+        m_vertexTriangleStart[i + 1] += m_vertexTriangleStart[i];
+    }
+    m_vertexTriangles.resize(m_indices.size());
+    std::vector<uint32_t> fill(m_vertexTriangleStart.begin(), m_vertexTriangleStart.end() - 1);
+    for (size_t i = 0; i < m_indices.size(); ++i) {
+        m_vertexTriangles[fill[m_indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    m_ringStamp.assign(vertexCount, 0);
+    m_ringEpoch = 0;
+    
+    m_normals.assign(vertexCount, glm::vec3(0, 1, 0));
+    recalculateNormals();
+    
+    m_dirtyVertices.clear();
+    m_vertexDirty.assign(vertexCount, 0);
+    markAllDirty();
+    m_undoHistory.clear();
+    
+    buildSpatialGrid();
     
     // Auto-generate UV1
     generateUV1(UV1Method::REGION_ATLAS);
@@ -74,16 +111,12 @@ bool FacialPainter::paintAt(const glm::vec3& worldPos, const glm::vec3& normal,
     
     if (vertexIndices.empty()) return false;
     
-    // Store for undo
-    PaintStroke stroke;
-    stroke.vertexIndices = vertexIndices;
+    // Store for undo (old displacement of just the touched vertices)
+    eden::SparseDelta stroke = eden::SparseDelta::over<glm::vec3>(m_paintedVertices.size());
     for (size_t idx : vertexIndices) {
-        stroke.oldDisplacements.push_back(m_paintedVertices[idx].displacement);
-    }
-    m_undoStack.push_back(stroke);
-    if (m_undoStack.size() > MAX_UNDO_STEPS) {
-        m_undoStack.erase(m_undoStack.begin());
+        stroke.add(static_cast<uint32_t>(idx), m_paintedVertices[idx].displacement);
     }
+    m_undoHistory.push({stroke});
     
     // Apply displacement
     glm::vec3 displacement = brush.direction * brush.strength * 0.01f;  // Scale to reasonable units
@@ -98,10 +131,11 @@ bool FacialPainter::paintAt(const glm::vec3& worldPos, const glm::vec3& normal,
         // Apply displacement with falloff
         v.displacement += displacement * falloff;
         v.painted = true;
+        updateGridCell(idx);
     }
     
-    // Recalculate normals
-    recalculateNormals();
+    // Recalculate normals around the stroke
+    recalculateNormalsAround(vertexIndices);
     
     return true;
 }
@@ -111,30 +145,39 @@ void FacialPainter::paintVertex(size_t vertexIndex, const glm::vec3& displacemen
     
     m_paintedVertices[vertexIndex].displacement += displacement;
     m_paintedVertices[vertexIndex].painted = true;
+    updateGridCell(vertexIndex);
     
-    recalculateNormals();
+    recalculateNormalsAround({vertexIndex});
 }
 
 void FacialPainter::clearPainting() {
-    for (auto& v : m_paintedVertices) {
+    std::vector<size_t> moved;
+    for (size_t i = 0; i < m_paintedVertices.size(); ++i) {
+        auto& v = m_paintedVertices[i];
+        if (v.displacement != glm::vec3(0)) moved.push_back(i);
         v.displacement = glm::vec3(0);
         v.painted = false;
     }
-    m_undoStack.clear();
-    recalculateNormals();
+    m_undoHistory.clear();
+    buildSpatialGrid();
+    recalculateNormalsAround(moved);
 }
 
 void FacialPainter::undo() {
-    if (m_undoStack.empty()) return;
+    std::vector<eden::SparseDelta> step;
+    if (!m_undoHistory.pop(step) || step.empty()) return;
     
-    PaintStroke& stroke = m_undoStack.back();
-    for (size_t i = 0; i < stroke.vertexIndices.size(); ++i) {
-        size_t idx = stroke.vertexIndices[i];
-        m_paintedVertices[idx].displacement = stroke.oldDisplacements[i];
+    const eden::SparseDelta& stroke = step[0];
+    if (stroke.resultCount != m_paintedVertices.size() || stroke.elementSize != sizeof(glm::vec3)) return;
+    std::vector<size_t> moved;
+    moved.reserve(stroke.indices.size());
+    for (size_t i = 0; i < stroke.indices.size(); ++i) {
+        size_t idx = stroke.indices[i];
+        memcpy(&m_paintedVertices[idx].displacement, &stroke.values[i * sizeof(glm::vec3)], sizeof(glm::vec3));
+        updateGridCell(idx);
+        moved.push_back(idx);
     }
-    m_undoStack.pop_back();
-    
-    recalculateNormals();
+    recalculateNormalsAround(moved);
 }
 
 // ============================================================================
@@ -229,6 +272,7 @@ void FacialPainter::generateUV1(UV1Method method) {
         }
     }
     
+    markAllDirty();
     std::cout << "[FacialPainter] Generated UV1 coordinates using method " << static_cast<int>(method) << std::endl;
 }
 
@@ -239,11 +283,41 @@ void FacialPainter::generateUV1(UV1Method method) {
 bool FacialPainter::bakeDMap(const std::string& outputPath, int resolution) {
     if (!m_initialized || m_paintedVertices.empty()) return false;
     
+    std::vector<uint8_t> pixels;
+    int samples = rasterizeDMapCPU(pixels, resolution);
+    
+    // Save as PPM (Portable Pixmap) - simple format, can be converted to PNG later
+    // Or save as raw RGB data
+    std::string ppmPath = outputPath;
+    if (ppmPath.size() > 4 && ppmPath.substr(ppmPath.size() - 4) == ".png") {
+        ppmPath = ppmPath.substr(0, ppmPath.size() - 4) + ".ppm";
+    }
+    
+    std::ofstream file(ppmPath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[FacialPainter] Failed to open file for writing: " << ppmPath << std::endl;
+        return false;
+    }
+    
+    // Write PPM header
+    file << "P6\n" << resolution << " " << resolution << "\n255\n";
+    
+    // Write pixel data
+    file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+    file.close();
+    
+    std::cout << "[FacialPainter] Baked DMap to " << ppmPath 
+              << " (" << resolution << "x" << resolution << ", " << samples << " samples)" << std::endl;
+    std::cout << "[FacialPainter] Note: Saved as PPM format. Convert to PNG with: convert " << ppmPath << " " << outputPath << std::endl;
+    return true;
+}
+
+int FacialPainter::rasterizeDMapCPU(std::vector<uint8_t>& pixels, int resolution) const {
     // Create texture buffer (RGB)
-    std::vector<uint8_t> pixels(resolution * resolution * 3, 128);  // Initialize to neutral gray
+    pixels.assign(resolution * resolution * 3, 128);  // Initialize to neutral gray
     
     // Maximum displacement for normalization (adjust based on your model scale)
-    float maxDisplacement = 0.1f;  // 10cm max
+    const float maxDisplacement = BAKE_MAX_DISPLACEMENT;  // 10cm max
     
     // Sample each vertex and write to texture
     int samples = 0;
@@ -280,31 +354,7 @@ bool FacialPainter::bakeDMap(const std::string& outputPath, int resolution) {
         }
         samples++;
     }
-    
-    // Save as PPM (Portable Pixmap) - simple format, can be converted to PNG later
-    // Or save as raw RGB data
-    std::string ppmPath = outputPath;
-    if (ppmPath.size() > 4 && ppmPath.substr(ppmPath.size() - 4) == ".png") {
-        ppmPath = ppmPath.substr(0, ppmPath.size() - 4) + ".ppm";
-    }
-    
-    std::ofstream file(ppmPath, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "[FacialPainter] Failed to open file for writing: " << ppmPath << std::endl;
-        return false;
-    }
-    
-    // Write PPM header
-    file << "P6\n" << resolution << " " << resolution << "\n255\n";
-    
-    // Write pixel data
-    file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
-    file.close();
-    
-    std::cout << "[FacialPainter] Baked DMap to " << ppmPath 
-              << " (" << resolution << "x" << resolution << ", " << samples << " samples)" << std::endl;
-    std::cout << "[FacialPainter] Note: Saved as PPM format. Convert to PNG with: convert " << ppmPath << " " << outputPath << std::endl;
-    return true;
+    return samples;
 }
 
 bool FacialPainter::getBakedDMap(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) {
@@ -338,6 +388,507 @@ bool FacialPainter::getBakedDMap(std::vector<uint8_t>& pixels, uint32_t& width,
     return true;
 }
 
+// ============================================================================
+// GPU DMap Baking
+// ============================================================================
+
+// Must match the push blocks in dmap_bake.vert / dmap_bake_dilate.comp
+struct BakePushConstants {
+    float invMaxDisplacement;
+};
+
+struct DilatePushConstants {
+    uint32_t size;
+    int32_t radius;
+};
+
+static std::vector<char> readShaderFile(const std::string& path) {
+    VfsInputStream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[FacialPainter] Failed to open shader: " << path << std::endl;
+        return {};
+    }
+    
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<char> buffer(fileSize);
+    file.seekg(0);
+    file.read(buffer.data(), fileSize);
+    return buffer;
+}
+
+static VkShaderModule createShaderModule(VkDevice device, const std::vector<char>& code) {
+    if (code.empty()) return VK_NULL_HANDLE;
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device, &moduleInfo, nullptr, &module) != VK_SUCCESS) return VK_NULL_HANDLE;
+    return module;
+}
+
+bool FacialPainter::bakeDMapAsync(vkcore::VulkanCore* core, int resolution, BakeCallback onReady, int dilateTexels) {
+    if (!m_initialized || m_paintedVertices.empty() || resolution <= 0 || !onReady) return false;
+    if (isBakePending()) {
+        std::cerr << "[FacialPainter] A GPU bake is already pending" << std::endl;
+        return false;
+    }
+    
+    bool gpu = core != nullptr && !m_indices.empty();
+    if (gpu) {
+        attachCore(core);
+        gpu = createBakePipelines() && createBakeResources(static_cast<uint32_t>(resolution));
+        if (!gpu) destroyBakeResources();
+    }
+    if (!gpu) {
+        std::cout << "[FacialPainter] GPU bake unavailable, baking on the CPU" << std::endl;
+        std::vector<uint8_t> pixels;
+        rasterizeDMapCPU(pixels, resolution);
+        onReady(pixels, static_cast<uint32_t>(resolution), static_cast<uint32_t>(resolution));
+        return true;
+    }
+    
+    // Snapshot of the current painting; the GPU reads it in the next prologue
+    float* out = static_cast<float*>(m_bake.vertexAlloc.mapped);
+    for (const PaintedVertex& v : m_paintedVertices) {
+        float vertex[BAKE_VERTEX_FLOATS] = {v.uv1.x, v.uv1.y, v.displacement.x, v.displacement.y, v.displacement.z};
+        memcpy(out, vertex, sizeof(vertex));
+        out += BAKE_VERTEX_FLOATS;
+    }
+    memcpy(m_bake.indexAlloc.mapped, m_indices.data(), m_indices.size() * sizeof(uint32_t));
+    
+    m_bake.resolution = static_cast<uint32_t>(resolution);
+    m_bake.dilateTexels = std::max(dilateTexels, 0);
+    m_bake.indexCount = static_cast<uint32_t>(m_indices.size());
+    m_bake.onReady = std::move(onReady);
+    m_bake.state = GpuBake::State::Queued;
+    return true;
+}
+
+bool FacialPainter::createBakePipelines() {
+    if (m_bakePipeline != VK_NULL_HANDLE) return true;
+    if (m_bakePipelinesFailed) return false;
+    m_bakePipelinesFailed = true;  // Until everything below succeeds
+    
+    VkDevice device = m_core->getDevice();
+    
+    // UV1 raster: one RGBA16F colour attachment, left in GENERAL for the
+    // dilate pass's imageLoad
+    VkAttachmentDescription attachment{};
+    attachment.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+    
+    VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    
+    // Raster writes visible to the dilate pass
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = 0;
+    dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &attachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies = &dependency;
+    if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_bakeRenderPass) != VK_SUCCESS) {
+        std::cerr << "[FacialPainter] Failed to create bake render pass!" << std::endl;
+        return false;
+    }
+    
+    VkPushConstantRange bakePush{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(BakePushConstants)};
+    VkPipelineLayoutCreateInfo bakeLayoutInfo{};
+    bakeLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    bakeLayoutInfo.pushConstantRangeCount = 1;
+    bakeLayoutInfo.pPushConstantRanges = &bakePush;
+    if (vkCreatePipelineLayout(device, &bakeLayoutInfo, nullptr, &m_bakePipelineLayout) != VK_SUCCESS) {
+        std::cerr << "[FacialPainter] Failed to create bake pipeline layout!" << std::endl;
+        return false;
+    }
+    
+    // Dilate: raster (storage image) + readback buffer
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = 2;
+    setLayoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(device, &setLayoutInfo, nullptr, &m_dilateSetLayout) != VK_SUCCESS) {
+        std::cerr << "[FacialPainter] Failed to create dilate set layout!" << std::endl;
+        return false;
+    }
+    
+    VkPushConstantRange dilatePush{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(DilatePushConstants)};
+    VkPipelineLayoutCreateInfo dilateLayoutInfo{};
+    dilateLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    dilateLayoutInfo.setLayoutCount = 1;
+    dilateLayoutInfo.pSetLayouts = &m_dilateSetLayout;
+    dilateLayoutInfo.pushConstantRangeCount = 1;
+    dilateLayoutInfo.pPushConstantRanges = &dilatePush;
+    if (vkCreatePipelineLayout(device, &dilateLayoutInfo, nullptr, &m_dilatePipelineLayout) != VK_SUCCESS) {
+        std::cerr << "[FacialPainter] Failed to create dilate pipeline layout!" << std::endl;
+        return false;
+    }
+    
+    VkShaderModule vertModule = createShaderModule(device, readShaderFile("shaders/dmap_bake.vert.spv"));
+    VkShaderModule fragModule = createShaderModule(device, readShaderFile("shaders/dmap_bake.frag.spv"));
+    VkShaderModule compModule = createShaderModule(device, readShaderFile("shaders/dmap_bake_dilate.comp.spv"));
+    auto destroyModules = [&]() {
+        if (vertModule != VK_NULL_HANDLE) vkDestroyShaderModule(device, vertModule, nullptr);
+        if (fragModule != VK_NULL_HANDLE) vkDestroyShaderModule(device, fragModule, nullptr);
+        if (compModule != VK_NULL_HANDLE) vkDestroyShaderModule(device, compModule, nullptr);
+    };
+    if (vertModule == VK_NULL_HANDLE || fragModule == VK_NULL_HANDLE || compModule == VK_NULL_HANDLE) {
+        std::cerr << "[FacialPainter] Failed to load bake shaders!" << std::endl;
+        destroyModules();
+        return false;
+    }
+    
+    VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragModule;
+    shaderStages[1].pName = "main";
+    
+    // uv1 + displacement (BAKE_VERTEX_FLOATS)
+    VkVertexInputBindingDescription bindingDesc{};
+    bindingDesc.binding = 0;
+    bindingDesc.stride = sizeof(float) * BAKE_VERTEX_FLOATS;
+    bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    
+    VkVertexInputAttributeDescription attrDescs[2];
+    attrDescs[0] = {0, 0, VK_FORMAT_R32G32_SFLOAT, 0};                   // uv1
+    attrDescs[1] = {1, 0, VK_FORMAT_R32G32B32_SFLOAT, sizeof(float) * 2};  // displacement
+    
+    VkPipelineVertexInputStateCreateInfo vertexInput{};
+    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInput.vertexBindingDescriptionCount = 1;
+    vertexInput.pVertexBindingDescriptions = &bindingDesc;
+    vertexInput.vertexAttributeDescriptionCount = 2;
+    vertexInput.pVertexAttributeDescriptions = attrDescs;
+    
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+    
+    // UV islands can have either winding
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+    
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+    
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+    
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInput;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_bakePipelineLayout;
+    pipelineInfo.renderPass = m_bakeRenderPass;
+    pipelineInfo.subpass = 0;
+    
+    VkComputePipelineCreateInfo computeInfo{};
+    computeInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    computeInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    computeInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    computeInfo.stage.module = compModule;
+    computeInfo.stage.pName = "main";
+    computeInfo.layout = m_dilatePipelineLayout;
+    
+    VkResult graphics = vkCreateGraphicsPipelines(device, m_core->getPipelineCache(), 1, &pipelineInfo,
+                                                  nullptr, &m_bakePipeline);
+    VkResult compute = vkCreateComputePipelines(device, m_core->getPipelineCache(), 1, &computeInfo,
+                                                nullptr, &m_dilatePipeline);
+    destroyModules();
+    if (graphics != VK_SUCCESS || compute != VK_SUCCESS) {
+        if (graphics != VK_SUCCESS) m_bakePipeline = VK_NULL_HANDLE;
+        if (compute != VK_SUCCESS) m_dilatePipeline = VK_NULL_HANDLE;
+        std::cerr << "[FacialPainter] Failed to create bake pipelines!" << std::endl;
+        return false;
+    }
+    
+    m_bakePipelinesFailed = false;
+    std::cout << "[FacialPainter] Created GPU bake pipelines" << std::endl;
+    return true;
+}
+
+void FacialPainter::destroyBakePipelines() {
+    // Frames in flight may still be baking with them
+    vkcore::VulkanCore* core = m_core;
+    VkRenderPass renderPass = m_bakeRenderPass;
+    VkPipelineLayout bakeLayout = m_bakePipelineLayout;
+    VkPipeline bakePipeline = m_bakePipeline;
+    VkDescriptorSetLayout setLayout = m_dilateSetLayout;
+    VkPipelineLayout dilateLayout = m_dilatePipelineLayout;
+    VkPipeline dilatePipeline = m_dilatePipeline;
+    core->deferDestroy([core, renderPass, bakeLayout, bakePipeline, setLayout, dilateLayout, dilatePipeline]() {
+        VkDevice device = core->getDevice();
+        if (bakePipeline != VK_NULL_HANDLE) vkDestroyPipeline(device, bakePipeline, nullptr);
+        if (dilatePipeline != VK_NULL_HANDLE) vkDestroyPipeline(device, dilatePipeline, nullptr);
+        if (bakeLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, bakeLayout, nullptr);
+        if (dilateLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, dilateLayout, nullptr);
+        if (setLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+        if (renderPass != VK_NULL_HANDLE) vkDestroyRenderPass(device, renderPass, nullptr);
+    });
+    
+    m_bakeRenderPass = VK_NULL_HANDLE;
+    m_bakePipelineLayout = VK_NULL_HANDLE;
+    m_bakePipeline = VK_NULL_HANDLE;
+    m_dilateSetLayout = VK_NULL_HANDLE;
+    m_dilatePipelineLayout = VK_NULL_HANDLE;
+    m_dilatePipeline = VK_NULL_HANDLE;
+    m_bakePipelinesFailed = false;  // A new core may have the shaders
+}
+
+bool FacialPainter::createBakeResources(uint32_t resolution) {
+    VkDevice device = m_core->getDevice();
+    vkcore::GpuAllocator& allocator = m_core->getAllocator();
+    const VkMemoryPropertyFlags hostVisible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    
+    // One-shot inputs are read straight from host memory
+    VkDeviceSize vertexBytes = m_paintedVertices.size() * BAKE_VERTEX_FLOATS * sizeof(float);
+    VkDeviceSize indexBytes = m_indices.size() * sizeof(uint32_t);
+    VkDeviceSize readbackBytes = static_cast<VkDeviceSize>(resolution) * resolution * sizeof(uint32_t);
+    if (!allocator.createBuffer(vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, hostVisible,
+                                m_bake.vertexBuffer, m_bake.vertexAlloc) ||
+        !allocator.createBuffer(indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, hostVisible,
+                                m_bake.indexBuffer, m_bake.indexAlloc) ||
+        !allocator.createBuffer(readbackBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostVisible,
+                                m_bake.readback, m_bake.readbackAlloc)) {
+        std::cerr << "[FacialPainter] Failed to allocate bake buffers (" << (readbackBytes / (1024 * 1024))
+                  << " MB readback)" << std::endl;
+        return false;
+    }
+    
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    imageInfo.extent = {resolution, resolution, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (!allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_bake.image, m_bake.imageAlloc)) {
+        std::cerr << "[FacialPainter] Failed to create " << resolution << "x" << resolution << " bake target!" << std::endl;
+        return false;
+    }
+    
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_bake.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (vkCreateImageView(device, &viewInfo, nullptr, &m_bake.view) != VK_SUCCESS) {
+        m_bake.view = VK_NULL_HANDLE;
+        std::cerr << "[FacialPainter] Failed to create bake target view!" << std::endl;
+        return false;
+    }
+    
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = m_bakeRenderPass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments = &m_bake.view;
+    framebufferInfo.width = resolution;
+    framebufferInfo.height = resolution;
+    framebufferInfo.layers = 1;
+    if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_bake.framebuffer) != VK_SUCCESS) {
+        m_bake.framebuffer = VK_NULL_HANDLE;
+        std::cerr << "[FacialPainter] Failed to create bake framebuffer!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void FacialPainter::destroyBakeResources() {
+    if (m_core && m_bake.vertexBuffer != VK_NULL_HANDLE) {
+        // A recorded bake may still be running
+        vkcore::VulkanCore* core = m_core;
+        GpuBake bake = m_bake;
+        bake.onReady = nullptr;
+        core->deferDestroy([core, bake]() mutable {
+            VkDevice device = core->getDevice();
+            vkcore::GpuAllocator& allocator = core->getAllocator();
+            if (bake.framebuffer != VK_NULL_HANDLE) vkDestroyFramebuffer(device, bake.framebuffer, nullptr);
+            if (bake.view != VK_NULL_HANDLE) vkDestroyImageView(device, bake.view, nullptr);
+            allocator.destroyImage(bake.image, bake.imageAlloc);
+            allocator.destroyBuffer(bake.readback, bake.readbackAlloc);
+            allocator.destroyBuffer(bake.indexBuffer, bake.indexAlloc);
+            allocator.destroyBuffer(bake.vertexBuffer, bake.vertexAlloc);
+        });
+    }
+    m_bake = GpuBake();
+}
+
+void FacialPainter::recordBake(VkCommandBuffer cmd) {
+    uint32_t scope = m_core->getGpuProfiler().beginScope(cmd, "painter_bake");
+    const uint32_t size = m_bake.resolution;
+    
+    // Rasterize in UV1; alpha 0 marks texels no triangle covers
+    VkClearValue clear{};
+    clear.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+    VkRenderPassBeginInfo rpInfo{};
+    rpInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    rpInfo.renderPass = m_bakeRenderPass;
+    rpInfo.framebuffer = m_bake.framebuffer;
+    rpInfo.renderArea = {{0, 0}, {size, size}};
+    rpInfo.clearValueCount = 1;
+    rpInfo.pClearValues = &clear;
+    vkCmdBeginRenderPass(cmd, &rpInfo, VK_SUBPASS_CONTENTS_INLINE);
+    
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(size), static_cast<float>(size), 0.0f, 1.0f};
+    VkRect2D scissor{{0, 0}, {size, size}};
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+    
+    BakePushConstants bakePush{1.0f / BAKE_MAX_DISPLACEMENT};
+    VkDeviceSize offset = 0;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_bakePipeline);
+    vkCmdPushConstants(cmd, m_bakePipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(bakePush), &bakePush);
+    vkCmdBindVertexBuffers(cmd, 0, 1, &m_bake.vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(cmd, m_bake.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(cmd, m_bake.indexCount, 1, 0, 0, 0);
+    vkCmdEndRenderPass(cmd);
+    
+    // Dilate the gutters and encode into the readback buffer
+    VkDescriptorSet set = m_core->getDescriptorAllocator().allocateTransient(m_dilateSetLayout);
+    if (set != VK_NULL_HANDLE) {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageView = m_bake.view;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        VkDescriptorBufferInfo bufferInfo{m_bake.readback, 0, VK_WHOLE_SIZE};
+        
+        VkWriteDescriptorSet writes[2]{};
+        for (uint32_t i = 0; i < 2; i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = set;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+        }
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[0].pImageInfo = &imageInfo;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[1].pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(m_core->getDevice(), 2, writes, 0, nullptr);
+        
+        DilatePushConstants dilatePush{size, m_bake.dilateTexels};
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_dilatePipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_dilatePipelineLayout, 0, 1, &set, 0, nullptr);
+        vkCmdPushConstants(cmd, m_dilatePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(dilatePush), &dilatePush);
+        vkCmdDispatch(cmd, (size + 7) / 8, (size + 7) / 8, 1);
+        
+        // Visible to the host once this frame's fence signals
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = m_bake.readback;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                             0, 0, nullptr, 1, &barrier, 0, nullptr);
+    }
+    
+    m_core->getGpuProfiler().endScope(cmd, scope);
+    
+    if (set == VK_NULL_HANDLE) {
+        std::cerr << "[FacialPainter] Failed to allocate dilate descriptor set, retrying next frame" << std::endl;
+        return;  // Still queued; the raster is simply redone
+    }
+    m_bake.frameSlot = m_core->getCurrentFrame();
+    m_bake.frameNumber = m_core->getFrameNumber();
+    m_bake.state = GpuBake::State::Recorded;
+}
+
+void FacialPainter::finishBake() {
+    // Done once its frame slot comes around again (that fence was waited on)
+    if (m_core->getCurrentFrame() != m_bake.frameSlot || m_core->getFrameNumber() == m_bake.frameNumber) return;
+    
+    const uint32_t size = m_bake.resolution;
+    const uint8_t* texels = static_cast<const uint8_t*>(m_bake.readbackAlloc.mapped);
+    std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * 3);
+    for (size_t i = 0, count = static_cast<size_t>(size) * size; i < count; ++i) {
+        memcpy(&pixels[i * 3], &texels[i * 4], 3);  // Drop alpha
+    }
+    
+    BakeCallback onReady = std::move(m_bake.onReady);
+    destroyBakeResources();
+    std::cout << "[FacialPainter] GPU baked DMap (" << size << "x" << size << ")" << std::endl;
+    onReady(pixels, size, size);
+}
+
 // ============================================================================
 // Mesh Updates
 // ============================================================================
@@ -353,9 +904,10 @@ void FacialPainter::getDisplacedMesh(std::vector<glm::vec3>& positions,
     uv0.clear();
     uv1.clear();
     
-    for (const auto& v : m_paintedVertices) {
+    for (size_t i = 0; i < m_paintedVertices.size(); ++i) {
+        const auto& v = m_paintedVertices[i];
         positions.push_back(v.basePosition + v.displacement);
-        normals.push_back(glm::normalize(v.basePosition + v.displacement - v.basePosition));  // Simplified
+        normals.push_back(m_normals[i]);
         uv0.push_back(v.uv0);
         uv1.push_back(v.uv1);
     }
@@ -364,37 +916,147 @@ void FacialPainter::getDisplacedMesh(std::vector<glm::vec3>& positions,
 bool FacialPainter::updateGPUMesh(vkcore::VulkanCore* core, vkcore::MeshHandle meshHandle) {
     if (!m_initialized || !core) return false;
     
-    // Get displaced mesh data
-    std::vector<glm::vec3> positions, normals;
-    std::vector<glm::vec2> uv0, uv1;
-    getDisplacedMesh(positions, normals, uv0, uv1);
-    
-    // Create interleaved vertex data (POSITION_NORMAL_UV0_UV1 format)
-    std::vector<float> vertexData;
-    for (size_t i = 0; i < positions.size(); ++i) {
-        // Position
-        vertexData.push_back(positions[i].x);
-        vertexData.push_back(positions[i].y);
-        vertexData.push_back(positions[i].z);
-        // Normal
-        vertexData.push_back(normals[i].x);
-        vertexData.push_back(normals[i].y);
-        vertexData.push_back(normals[i].z);
-        // UV0
-        vertexData.push_back(uv0[i].x);
-        vertexData.push_back(uv0[i].y);
-        // UV1
-        vertexData.push_back(uv1[i].x);
-        vertexData.push_back(uv1[i].y);
-    }
-    
-    // TODO: Update mesh buffer in VulkanCore
-    // This requires adding an updateMesh() method to VulkanCore
-    // For now, we'll need to recreate the mesh
+    attachCore(core);
+    if (meshHandle != m_gpuMesh) {
+        m_gpuMesh = meshHandle;
+        markAllDirty();
+    }
     
+    // Copied at the start of the next frame
+    m_gpuUpdatePending = !m_dirtyVertices.empty();
     return true;
 }
 
+void FacialPainter::attachCore(vkcore::VulkanCore* core) {
+    if (core == m_core) return;
+    releaseGPU();
+    m_core = core;
+    m_stagingRing.resize(core->getFramesInFlight());
+    m_prologue = core->addFramePrologue([this](VkCommandBuffer cmd) { runFramePrologue(cmd); });
+}
+
+void FacialPainter::runFramePrologue(VkCommandBuffer cmd) {
+    if (m_bake.state == GpuBake::State::Recorded) finishBake();
+    if (m_bake.state == GpuBake::State::Queued) recordBake(cmd);
+    uploadDirtyRanges(cmd);
+}
+
+void FacialPainter::releaseGPU() {
+    if (!m_core) return;
+    
+    m_core->removeFramePrologue(m_prologue);
+    m_prologue = 0;
+    
+    if (m_bake.state != GpuBake::State::Idle) {
+        std::cout << "[FacialPainter] GPU bake cancelled" << std::endl;
+    }
+    destroyBakeResources();
+    destroyBakePipelines();
+    
+    // Frames in flight may still be copying from the ring
+    vkcore::VulkanCore* core = m_core;
+    for (StagingSlot& slot : m_stagingRing) {
+        if (slot.buffer == VK_NULL_HANDLE) continue;
+        VkBuffer buffer = slot.buffer;
+        vkcore::GpuAllocation alloc = slot.alloc;
+        core->deferDestroy([core, buffer, alloc]() mutable {
+            core->getAllocator().destroyBuffer(buffer, alloc);
+        });
+    }
+    m_stagingRing.clear();
+    
+    m_core = nullptr;
+    m_gpuMesh = vkcore::INVALID_MESH;
+    m_gpuUpdatePending = false;
+}
+
+void FacialPainter::uploadDirtyRanges(VkCommandBuffer cmd) {
+    if (!m_gpuUpdatePending || m_dirtyVertices.empty()) return;
+    
+    // Still being created on the transfer queue: our copies would race it
+    if (!m_core->isMeshReady(m_gpuMesh)) return;
+    VkBuffer vertexBuffer, indexBuffer;
+    uint32_t indexCount;
+    if (!m_core->getMeshBuffers(m_gpuMesh, vertexBuffer, indexBuffer, indexCount)) return;
+    
+    // Coalesce the dirty vertices into ranges; short clean gaps are copied
+    // too rather than starting a new region
+    std::sort(m_dirtyVertices.begin(), m_dirtyVertices.end());
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;  // [first, last]
+    for (uint32_t v : m_dirtyVertices) {
+        if (!ranges.empty() && v <= ranges.back().second + 1 + RANGE_MERGE_GAP) {
+            ranges.back().second = v;
+        } else {
+            ranges.push_back({v, v});
+        }
+    }
+    size_t vertexCount = 0;
+    for (const auto& range : ranges) vertexCount += range.second - range.first + 1;
+    
+    // This frame's slot is idle (its fence was waited on)
+    const VkDeviceSize stride = GPU_VERTEX_FLOATS * sizeof(float);
+    VkDeviceSize bytes = vertexCount * stride;
+    StagingSlot& slot = m_stagingRing[m_core->getCurrentFrame()];
+    if (slot.capacity < bytes) {
+        VkDeviceSize capacity = std::max(bytes, slot.capacity * 2);
+        m_core->getAllocator().destroyBuffer(slot.buffer, slot.alloc);
+        slot.capacity = 0;
+        if (!m_core->getAllocator().createStagingBuffer(capacity, slot.buffer, slot.alloc)) {
+            std::cerr << "[FacialPainter] Failed to allocate " << (capacity / 1024) << " KB of staging" << std::endl;
+            return;
+        }
+        slot.capacity = capacity;
+    }
+    
+    std::vector<VkBufferCopy> regions;
+    regions.reserve(ranges.size());
+    float* out = static_cast<float*>(slot.alloc.mapped);
+    VkDeviceSize srcOffset = 0;
+    for (const auto& range : ranges) {
+        VkBufferCopy region{};
+        region.srcOffset = srcOffset;
+        region.dstOffset = range.first * stride;
+        region.size = (range.second - range.first + 1) * stride;
+        regions.push_back(region);
+        srcOffset += region.size;
+        
+        for (uint32_t i = range.first; i <= range.second; ++i) {
+            const PaintedVertex& v = m_paintedVertices[i];
+            glm::vec3 position = v.basePosition + v.displacement;
+            const glm::vec3& normal = m_normals[i];
+            float vertex[GPU_VERTEX_FLOATS] = {position.x, position.y, position.z,
+                                               normal.x, normal.y, normal.z,
+                                               v.uv0.x, v.uv0.y, v.uv1.x, v.uv1.y};
+            memcpy(out, vertex, sizeof(vertex));
+            out += GPU_VERTEX_FLOATS;
+        }
+    }
+    
+    // After earlier frames' vertex fetches, before this frame's
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = vertexBuffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 1, &barrier, 0, nullptr);
+    
+    vkCmdCopyBuffer(cmd, slot.buffer, vertexBuffer, static_cast<uint32_t>(regions.size()), regions.data());
+    
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         0, 0, nullptr, 1, &barrier, 0, nullptr);
+    
+    for (uint32_t v : m_dirtyVertices) m_vertexDirty[v] = 0;
+    m_dirtyVertices.clear();
+    m_gpuUpdatePending = false;
+}
+
 // ============================================================================
 // Helpers
 // ============================================================================
@@ -402,18 +1064,97 @@ bool FacialPainter::updateGPUMesh(vkcore::VulkanCore* core, vkcore::MeshHandle m
 void FacialPainter::findVerticesInBrush(const glm::vec3& center, float radius,
                                         std::vector<size_t>& outIndices) {
     outIndices.clear();
+    if (m_gridCells.empty()) return;
     float radiusSq = radius * radius;
     
+    // Only the cells the brush sphere's bounds overlap (clamped like gridCellOf)
+    int lo[3], hi[3];
+    gridCoords(center - glm::vec3(radius), lo);
+    gridCoords(center + glm::vec3(radius), hi);
+    
+    for (int z = lo[2]; z <= hi[2]; ++z) {
+        for (int y = lo[1]; y <= hi[1]; ++y) {
+            for (int x = lo[0]; x <= hi[0]; ++x) {
+                const auto& cell = m_gridCells[(static_cast<size_t>(z) * m_gridDims[1] + y) * m_gridDims[0] + x];
+                for (uint32_t i : cell) {
+                    const auto& v = m_paintedVertices[i];
+                    glm::vec3 pos = v.basePosition + v.displacement;
+                    glm::vec3 diff = pos - center;
+                    float distSq = glm::dot(diff, diff);  // Squared distance
+                    
+                    if (distSq <= radiusSq) {
+                        outIndices.push_back(i);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void FacialPainter::buildSpatialGrid() {
+    m_gridCells.clear();
+    m_vertexCell.clear();
+    if (m_paintedVertices.empty()) return;
+    
+    glm::vec3 minPos = m_paintedVertices[0].basePosition + m_paintedVertices[0].displacement;
+    glm::vec3 maxPos = minPos;
+    for (const auto& v : m_paintedVertices) {
+        glm::vec3 pos = v.basePosition + v.displacement;
+        minPos = glm::min(minPos, pos);
+        maxPos = glm::max(maxPos, pos);
+    }
+    
+    // Cubic cells sized for GRID_TARGET_PER_CELL vertices over the bounds
+    // (flat meshes get a minimum thickness so the volume isn't zero)
+    glm::vec3 extent = maxPos - minPos;
+    float largest = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-4f));
+    glm::vec3 padded = glm::max(extent, glm::vec3(largest * 0.01f));
+    float cells = std::max(1.0f, static_cast<float>(m_paintedVertices.size()) / GRID_TARGET_PER_CELL);
+    m_gridCellSize = std::max(std::cbrt(padded.x * padded.y * padded.z / cells), largest / GRID_MAX_DIM);
+    m_gridOrigin = minPos;
+    for (int axis = 0; axis < 3; ++axis) {
+        m_gridDims[axis] = std::clamp(static_cast<int>(extent[axis] / m_gridCellSize) + 1, 1, GRID_MAX_DIM);
+    }
+    
+    m_gridCells.resize(static_cast<size_t>(m_gridDims[0]) * m_gridDims[1] * m_gridDims[2]);
+    m_vertexCell.resize(m_paintedVertices.size());
     for (size_t i = 0; i < m_paintedVertices.size(); ++i) {
         const auto& v = m_paintedVertices[i];
-        glm::vec3 pos = v.basePosition + v.displacement;
-        glm::vec3 diff = pos - center;
-        float distSq = glm::dot(diff, diff);  // Squared distance
-        
-        if (distSq <= radiusSq) {
-            outIndices.push_back(i);
-        }
+        uint32_t cell = gridCellOf(v.basePosition + v.displacement);
+        m_gridCells[cell].push_back(static_cast<uint32_t>(i));
+        m_vertexCell[i] = cell;
+    }
+}
+
+void FacialPainter::updateGridCell(size_t vertexIndex) {
+    if (vertexIndex >= m_vertexCell.size()) return;
+    
+    const auto& v = m_paintedVertices[vertexIndex];
+    uint32_t cell = gridCellOf(v.basePosition + v.displacement);
+    uint32_t old = m_vertexCell[vertexIndex];
+    if (cell == old) return;
+    
+    auto& oldCell = m_gridCells[old];
+    auto it = std::find(oldCell.begin(), oldCell.end(), static_cast<uint32_t>(vertexIndex));
+    if (it != oldCell.end()) {
+        *it = oldCell.back();
+        oldCell.pop_back();
     }
+    m_gridCells[cell].push_back(static_cast<uint32_t>(vertexIndex));
+    m_vertexCell[vertexIndex] = cell;
+}
+
+void FacialPainter::gridCoords(const glm::vec3& position, int coords[3]) const {
+    for (int axis = 0; axis < 3; ++axis) {
+        float cell = std::floor((position[axis] - m_gridOrigin[axis]) / m_gridCellSize);
+        coords[axis] = static_cast<int>(std::clamp(cell, 0.0f, static_cast<float>(m_gridDims[axis] - 1)));
+    }
+}
+
+uint32_t FacialPainter::gridCellOf(const glm::vec3& position) const {
+    int c[3];
+    gridCoords(position, c);
+    return static_cast<uint32_t>((static_cast<size_t>(c[2]) * m_gridDims[1] + c[1]) * m_gridDims[0] + c[0]);
 }
 
 float FacialPainter::calculateFalloff(float distance, float radius) {
@@ -425,40 +1166,63 @@ float FacialPainter::calculateFalloff(float distance, float radius) {
 }
 
 void FacialPainter::recalculateNormals() {
-    // Simple normal recalculation from triangles
-    // In production, you'd want more sophisticated normal calculation
-    
-    // Reset normals
-    for (auto& v : m_paintedVertices) {
-        // Normals will be recalculated from face normals
+    for (size_t i = 0; i < m_normals.size(); ++i) {
+        m_normals[i] = vertexNormal(i);
     }
+}
+
+void FacialPainter::recalculateNormalsAround(const std::vector<size_t>& moved) {
+    if (moved.empty()) return;
     
-    // Calculate face normals and accumulate
-    std::vector<glm::vec3> normals(m_paintedVertices.size(), glm::vec3(0));
-    
-    for (size_t i = 0; i < m_indices.size(); i += 3) {
-        uint32_t i0 = m_indices[i];
-        uint32_t i1 = m_indices[i + 1];
-        uint32_t i2 = m_indices[i + 2];
-        
-        glm::vec3 p0 = m_paintedVertices[i0].basePosition + m_paintedVertices[i0].displacement;
-        glm::vec3 p1 = m_paintedVertices[i1].basePosition + m_paintedVertices[i1].displacement;
-        glm::vec3 p2 = m_paintedVertices[i2].basePosition + m_paintedVertices[i2].displacement;
-        
-        glm::vec3 faceNormal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+    // Every vertex sharing a triangle with a moved one, each visited once
+    if (++m_ringEpoch == 0) {
+        std::fill(m_ringStamp.begin(), m_ringStamp.end(), 0);
+        m_ringEpoch = 1;
+    }
+    for (size_t v : moved) {
+        for (uint32_t t = m_vertexTriangleStart[v]; t < m_vertexTriangleStart[v + 1]; ++t) {
+            const uint32_t* tri = &m_indices[m_vertexTriangles[t] * 3];
+            for (int corner = 0; corner < 3; ++corner) {
+                uint32_t ring = tri[corner];
+                if (m_ringStamp[ring] == m_ringEpoch) continue;
+                m_ringStamp[ring] = m_ringEpoch;
+                m_normals[ring] = vertexNormal(ring);
+                markDirty(ring);
+            }
+        }
+        markDirty(v);  // Position changed even without triangles
+    }
+}
+
+glm::vec3 FacialPainter::vertexNormal(size_t vertexIndex) const {
+    // Sum of the adjacent face normals (degenerate faces skipped)
+    glm::vec3 sum(0);
+    for (uint32_t t = m_vertexTriangleStart[vertexIndex]; t < m_vertexTriangleStart[vertexIndex + 1]; ++t) {
+        const uint32_t* tri = &m_indices[m_vertexTriangles[t] * 3];
+        glm::vec3 p0 = m_paintedVertices[tri[0]].basePosition + m_paintedVertices[tri[0]].displacement;
+        glm::vec3 p1 = m_paintedVertices[tri[1]].basePosition + m_paintedVertices[tri[1]].displacement;
+        glm::vec3 p2 = m_paintedVertices[tri[2]].basePosition + m_paintedVertices[tri[2]].displacement;
         
-        normals[i0] += faceNormal;
-        normals[i1] += faceNormal;
-        normals[i2] += faceNormal;
+        glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(faceNormal);
+        if (length > 1e-12f) sum += faceNormal / length;
     }
     
-    // Normalize
-    for (size_t i = 0; i < normals.size(); ++i) {
-        if (glm::length(normals[i]) > 0.0001f) {
-            normals[i] = glm::normalize(normals[i]);
-        } else {
-            normals[i] = glm::vec3(0, 1, 0);  // Default up
-        }
+    if (glm::length(sum) > 0.0001f) {
+        return glm::normalize(sum);
+    }
+    return glm::vec3(0, 1, 0);  // Default up
+}
+
+void FacialPainter::markDirty(size_t vertexIndex) {
+    if (m_vertexDirty[vertexIndex]) return;
+    m_vertexDirty[vertexIndex] = 1;
+    m_dirtyVertices.push_back(static_cast<uint32_t>(vertexIndex));
+}
+
+void FacialPainter::markAllDirty() {
+    for (size_t i = 0; i < m_vertexDirty.size(); ++i) {
+        markDirty(i);
     }
 }
 
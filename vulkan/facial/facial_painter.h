@@ -3,6 +3,24 @@
 // ============================================================================
 // Allows painting displacement directly on 3D models, then bakes to DMap textures.
 // Much more intuitive than manual UV1/DMap creation in Blender!
+//
+// Brush queries go through a uniform grid over the displaced positions, so
+// a dab only tests vertices in the cells its sphere overlaps. Painting and
+// undo re-file just the vertices they move.
+//
+// Undo keeps only the touched vertices' old displacement per stroke, in a
+// bounded eden::UndoHistory.
+//
+// Stroke cost scales with the brush, not the mesh: normals are recomputed
+// for the one-ring of moved vertices only (vertex -> triangle adjacency is
+// built once in init), and updateGPUMesh() copies just the dirty vertex
+// ranges into the mesh through a per-frame staging ring, in a VulkanCore
+// frame prologue.
+//
+// bakeDMapAsync() bakes on the GPU: the mesh is rasterized in UV1 space
+// with displacement as a vertex attribute (RGBA16F target), gutters are
+// dilated by a compute pass, and the RGB8 result is read back a few frames
+// later without waiting on the device. bakeDMap() stays on the CPU.
 // ============================================================================
 
 #ifndef FACIAL_PAINTER_H
@@ -11,10 +29,12 @@
 #include "facial_types.h"
 #include "../core/vulkan_core.h"
 #include "../utils/raycast.h"
+#include "../utils/undo_history.h"
 
 #include <glm/glm.hpp>
 #include <vector>
 #include <string>
+#include <functional>
 
 namespace facial {
 
@@ -108,6 +128,19 @@ public:
     // Get the baked DMap texture data (for loading into FacialSystem)
     bool getBakedDMap(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height);
     
+    // RGB pixels, ready for FacialSystem::loadDMapFromMemory()
+    using BakeCallback = std::function<void(const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height)>;
+    
+    // Bake on the GPU: triangles are rasterized in UV1 (displacement is
+    // interpolated across them, unlike the CPU's per-vertex splats) and
+    // gutters within `dilateTexels` of an island take its nearest texel.
+    // onReady runs from a frame prologue once the readback has landed. If
+    // the GPU path is unavailable (missing shaders, no triangles), bakes on
+    // the CPU and calls onReady before returning. False if there is
+    // nothing to bake or a bake is still pending.
+    bool bakeDMapAsync(vkcore::VulkanCore* core, int resolution, BakeCallback onReady, int dilateTexels = 4);
+    bool isBakePending() const { return m_bake.state != GpuBake::State::Idle; }
+    
     // ========================================================================
     // Mesh Updates
     // ========================================================================
@@ -119,9 +152,16 @@ public:
                          std::vector<glm::vec2>& uv0,
                          std::vector<glm::vec2>& uv1) const;
     
-    // Update GPU mesh with current displacement (real-time preview)
+    // Update GPU mesh with current displacement (real-time preview). The
+    // mesh must be POSITION_NORMAL_UV0_UV1 with the painter's vertex order;
+    // vertices changed since the last update are copied at the start of the
+    // next frame (the first update, or a new mesh, copies everything).
     bool updateGPUMesh(vkcore::VulkanCore* core, vkcore::MeshHandle meshHandle);
     
+    // Stop GPU updates, cancel a pending bake and free the staging ring and
+    // bake pipelines (also done on destruction)
+    void releaseGPU();
+    
     // ========================================================================
     // Getters
     // ========================================================================
@@ -139,11 +179,43 @@ private:
     void findVerticesInBrush(const glm::vec3& center, float radius,
                              std::vector<size_t>& outIndices);
     
+    // Spatial grid: sized from the base mesh bounds; displaced vertices
+    // outside them are filed under the nearest border cell
+    void buildSpatialGrid();
+    void updateGridCell(size_t vertexIndex);  // After its displacement changed
+    uint32_t gridCellOf(const glm::vec3& position) const;
+    void gridCoords(const glm::vec3& position, int coords[3]) const;
+    
     // Calculate displacement falloff (smooth brush)
     float calculateFalloff(float distance, float radius);
     
-    // Recalculate normals after displacement
+    // Recalculate normals after displacement: all of them, or the one-ring
+    // of `moved` (also marks those vertices dirty for updateGPUMesh)
     void recalculateNormals();
+    void recalculateNormalsAround(const std::vector<size_t>& moved);
+    glm::vec3 vertexNormal(size_t vertexIndex) const;
+    
+    void markDirty(size_t vertexIndex);
+    void markAllDirty();
+    
+    // CPU bake into `pixels` (RGB); returns the vertices splatted
+    int rasterizeDMapCPU(std::vector<uint8_t>& pixels, int resolution) const;
+    
+    // Registers the frame prologue (switching cores releases the old one)
+    void attachCore(vkcore::VulkanCore* core);
+    void runFramePrologue(VkCommandBuffer cmd);
+    
+    // Frame prologue: copy the dirty ranges into m_gpuMesh
+    void uploadDirtyRanges(VkCommandBuffer cmd);
+    
+    // GPU bake: pipelines are built on first use; a bake is recorded in one
+    // prologue and finished in the prologue that reuses its frame slot
+    bool createBakePipelines();
+    void destroyBakePipelines();
+    bool createBakeResources(uint32_t resolution);
+    void destroyBakeResources();
+    void recordBake(VkCommandBuffer cmd);
+    void finishBake();
     
     // ========================================================================
     // State
@@ -152,18 +224,81 @@ private:
     bool m_initialized = false;
     std::vector<PaintedVertex> m_paintedVertices;
     std::vector<uint32_t> m_indices;
+    std::vector<glm::vec3> m_normals;
+    
+    // Vertex -> triangle adjacency (CSR: triangles of vertex v are
+    // m_vertexTriangles[m_vertexTriangleStart[v] .. m_vertexTriangleStart[v + 1]])
+    std::vector<uint32_t> m_vertexTriangleStart;
+    std::vector<uint32_t> m_vertexTriangles;
+    std::vector<uint32_t> m_ringStamp;        // recalculateNormalsAround() dedup
+    uint32_t m_ringEpoch = 0;
+    
+    // Vertices changed since the last GPU copy
+    std::vector<uint32_t> m_dirtyVertices;
+    std::vector<uint8_t> m_vertexDirty;
+    
+    // GPU preview (updateGPUMesh)
+    struct StagingSlot {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        vkcore::GpuAllocation alloc;
+        VkDeviceSize capacity = 0;
+    };
+    vkcore::VulkanCore* m_core = nullptr;
+    vkcore::MeshHandle m_gpuMesh = vkcore::INVALID_MESH;
+    std::vector<StagingSlot> m_stagingRing;   // One per frame in flight
+    uint32_t m_prologue = 0;
+    bool m_gpuUpdatePending = false;
+    static constexpr uint32_t GPU_VERTEX_FLOATS = 10;  // POSITION_NORMAL_UV0_UV1
+    static constexpr uint32_t RANGE_MERGE_GAP = 16;    // Clean vertices copied to join two ranges
+    
+    // GPU bake (bakeDMapAsync)
+    struct GpuBake {
+        enum class State { Idle, Queued, Recorded } state = State::Idle;
+        uint32_t resolution = 0;
+        int dilateTexels = 0;
+        uint32_t indexCount = 0;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;   // Host-visible: uv1 + displacement
+        vkcore::GpuAllocation vertexAlloc;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        vkcore::GpuAllocation indexAlloc;
+        VkBuffer readback = VK_NULL_HANDLE;       // Packed RGBA8, written by the dilate pass
+        vkcore::GpuAllocation readbackAlloc;
+        VkImage image = VK_NULL_HANDLE;           // RGBA16F UV1 raster
+        vkcore::GpuAllocation imageAlloc;
+        VkImageView view = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        uint32_t frameSlot = 0;                   // Where it was recorded
+        uint64_t frameNumber = 0;
+        BakeCallback onReady;
+    };
+    GpuBake m_bake;
+    VkRenderPass m_bakeRenderPass = VK_NULL_HANDLE;
+    VkPipelineLayout m_bakePipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_bakePipeline = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_dilateSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_dilatePipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_dilatePipeline = VK_NULL_HANDLE;
+    bool m_bakePipelinesFailed = false;       // Don't retry missing shaders every bake
+    static constexpr uint32_t BAKE_VERTEX_FLOATS = 5;       // uv1 + displacement
+    static constexpr float BAKE_MAX_DISPLACEMENT = 0.1f;    // Encodes as +-1 (both bake paths)
+    
+    // Spatial grid (vertex indices per cell)
+    std::vector<std::vector<uint32_t>> m_gridCells;
+    std::vector<uint32_t> m_vertexCell;       // Cell each vertex is filed under
+    glm::vec3 m_gridOrigin = glm::vec3(0);
+    float m_gridCellSize = 1.0f;
+    int m_gridDims[3] = {1, 1, 1};
+    static constexpr int GRID_TARGET_PER_CELL = 16;  // Vertices per cell if spread evenly
+    static constexpr int GRID_MAX_DIM = 128;
     
     // Brush state
     glm::vec3 m_brushPosition = glm::vec3(0);
     bool m_brushActive = false;
     
-    // Undo system
-    struct PaintStroke {
-        std::vector<size_t> vertexIndices;
-        std::vector<glm::vec3> oldDisplacements;
-    };
-    std::vector<PaintStroke> m_undoStack;
+    // Undo system: one sparse delta (old displacements) per stroke
     static constexpr size_t MAX_UNDO_STEPS = 50;
+    static constexpr size_t UNDO_BUDGET_BYTES = 64 * 1024 * 1024;
+    eden::UndoHistory m_undoHistory{MAX_UNDO_STEPS, UNDO_BUDGET_BYTES};
 };
 
 } // namespace facial
@@ -3,6 +3,10 @@
 // ============================================================================
 
 #include "facial_system.h"
+#include "dmap_padding.h"
+#include "dmap_compress.h"
+#include "../../stdlib/vfs.h"
+#include "../../stdlib/system_profiler.h"  // EDEN_PROFILE_API() on the C API
 
 #include <iostream>
 #include <fstream>
@@ -20,28 +24,59 @@
 namespace facial {
 
 // ============================================================================
-// Helper: Find memory type
+// Helper: Pack one instance's sparse DMap list
 // ============================================================================
-
-static uint32_t findMemoryType(VkPhysicalDevice physDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physDevice, &memProperties);
+// sliderScales/sliderSlots hold globalStrength * maxDisplacement and the array
+// slot of each slider's DMap (scale 0 = slider contributes nothing). Past
+// MAX_INSTANCE_DMAPS active sliders, the strongest ones are kept.
+
+static void packFaceInstance(const std::array<float, MAX_SLIDERS>& weights,
+                             const std::array<float, MAX_SLIDERS>& sliderScales,
+                             const std::array<uint32_t, MAX_SLIDERS>& sliderSlots,
+                             GpuFaceInstance& out) {
+    std::array<std::pair<float, uint32_t>, MAX_SLIDERS> active;
+    uint32_t count = 0;
+    for (int i = 0; i < MAX_SLIDERS; ++i) {
+        float scale = weights[i] * sliderScales[i];
+        if (std::fabs(scale) < 1e-6f) continue;
+        active[count++] = {scale, sliderSlots[i]};
+    }
+    if (count > static_cast<uint32_t>(MAX_INSTANCE_DMAPS)) {
+        std::partial_sort(active.begin(), active.begin() + MAX_INSTANCE_DMAPS, active.begin() + count,
+                          [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+                              return std::fabs(a.first) > std::fabs(b.first);
+                          });
+        count = MAX_INSTANCE_DMAPS;
+    }
     
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && 
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
+    out.info = glm::uvec4(count, 0u, 0u, 0u);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(MAX_INSTANCE_DMAPS); ++i) {
+        out.slots[i / 4][i % 4] = i < count ? active[i].second : 0u;
+        out.scales[i / 4][i % 4] = i < count ? active[i].first : 0.0f;
     }
-    return UINT32_MAX;
 }
 
+// ============================================================================
+// Helper: Draw capture encoding
+// ============================================================================
+
+// Commands under FacialSystem::CAPTURE_TAG
+enum class CaptureOp : uint8_t {
+    State = 1,      // See captureState()
+    Bind,
+    DrawMesh,       // u32 mesh, mat4 model, view, projection, u32 texture, vec4 color
+    DrawInstances   // u32 mesh, u32 texture, u32 count, count x (u32 instance, mat4, vec4, MAX_SLIDERS f32)
+};
+
+// remap.objects namespace for replayed instances
+static constexpr uint32_t INSTANCE_OBJECTS = vkcore::captureTag("FACI");
+
 // ============================================================================
 // Helper: Read shader file
 // ============================================================================
 
 static std::vector<char> readShaderFile(const std::string& path) {
-    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    VfsInputStream file(path, std::ios::ate | std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "[Facial] Failed to open shader: " << path << std::endl;
         return {};
@@ -58,7 +93,108 @@ static std::vector<char> readShaderFile(const std::string& path) {
 // FacialAnimationClip Implementation
 // ============================================================================
 
+// Keys [a + 1, b) lie within `tolerance` of the line from key a to key b
+static bool keysFitLine(const std::vector<FacialKeyframe>& keyframes, int slider,
+                        size_t a, size_t b, float tolerance) {
+    float t0 = keyframes[a].time;
+    float t1 = keyframes[b].time;
+    float v0 = keyframes[a].weights[slider];
+    float v1 = keyframes[b].weights[slider];
+    if (t1 - t0 <= 0.0001f) return false;  // Keep steps
+    for (size_t k = a + 1; k < b; ++k) {
+        float blend = (keyframes[k].time - t0) / (t1 - t0);
+        if (std::fabs(v0 + (v1 - v0) * blend - keyframes[k].weights[slider]) > tolerance) return false;
+    }
+    return true;
+}
+
+// Segment i spans keys[i]..keys[i + 1]; `segment` is the caller's hint
+static float evaluateCurve(const FacialCurveKey* keys, uint32_t count, float t, uint32_t& segment) {
+    if (count == 1 || t <= keys[0].time) {
+        segment = 0;
+        return keys[0].value;
+    }
+    if (t >= keys[count - 1].time) {
+        segment = count - 2;
+        return keys[count - 1].value;
+    }
+    
+    // Sequential playback: same segment or the next one
+    if (segment + 1 >= count || t < keys[segment].time || t >= keys[segment + 1].time) {
+        uint32_t next = segment + 1;
+        if (next + 1 < count && t >= keys[next].time && t < keys[next + 1].time) {
+            segment = next;
+        } else {
+            const FacialCurveKey* it = std::upper_bound(keys + 1, keys + count, t,
+                [](float value, const FacialCurveKey& key) { return value < key.time; });
+            segment = static_cast<uint32_t>(it - keys) - 1;
+        }
+    }
+    
+    const FacialCurveKey& a = keys[segment];
+    const FacialCurveKey& b = keys[segment + 1];
+    float range = b.time - a.time;
+    float blend = (range > 0.0001f) ? (t - a.time) / range : 0.0f;
+    return a.value + (b.value - a.value) * std::clamp(blend, 0.0f, 1.0f);
+}
+
+void FacialAnimationClip::compile(float tolerance) {
+    curves.clear();
+    curveKeys.clear();
+    
+    size_t n = keyframes.size();
+    for (int slider = 0; slider < MAX_SLIDERS && n > 0; ++slider) {
+        bool used = false;
+        for (const FacialKeyframe& key : keyframes) {
+            if (key.weights[slider] != 0.0f) {
+                used = true;
+                break;
+            }
+        }
+        if (!used) continue;  // Always neutral: no curve
+        
+        FacialCurve curve;
+        curve.slider = slider;
+        curve.firstKey = static_cast<uint32_t>(curveKeys.size());
+        curveKeys.push_back({keyframes[0].time, keyframes[0].weights[slider]});
+        
+        // From each kept key, skip ahead as far as the skipped keys stay on the line
+        size_t anchor = 0;
+        while (anchor + 1 < n) {
+            size_t end = anchor + 1;
+            while (end + 1 < n && keysFitLine(keyframes, slider, anchor, end + 1, tolerance)) end++;
+            curveKeys.push_back({keyframes[end].time, keyframes[end].weights[slider]});
+            anchor = end;
+        }
+        curve.keyCount = static_cast<uint32_t>(curveKeys.size()) - curve.firstKey;
+        
+        // Flat curve: one constant key
+        if (curve.keyCount == 2 && std::fabs(curveKeys[curve.firstKey].value - curveKeys.back().value) <= tolerance) {
+            curveKeys.pop_back();
+            curve.keyCount = 1;
+        }
+        curves.push_back(curve);
+    }
+    
+    curveKeys.shrink_to_fit();
+    keyframes.clear();
+    keyframes.shrink_to_fit();
+    compiled = true;
+}
+
+size_t FacialAnimationClip::getMemoryUsage() const {
+    return keyframes.capacity() * sizeof(FacialKeyframe) +
+           curves.capacity() * sizeof(FacialCurve) +
+           curveKeys.capacity() * sizeof(FacialCurveKey);
+}
+
 void FacialAnimationClip::getWeightsAtTime(float time, std::array<float, MAX_SLIDERS>& outWeights) const {
+    if (compiled) {
+        FacialClipCursor cursor;
+        getWeightsAtTime(time, outWeights, cursor);
+        return;
+    }
+    
     if (keyframes.empty()) {
         outWeights.fill(0.0f);
         return;
@@ -75,21 +211,11 @@ void FacialAnimationClip::getWeightsAtTime(float time, std::array<float, MAX_SLI
         t = fmod(time, duration);
     }
     
-    // Find surrounding keyframes
-    const FacialKeyframe* prev = &keyframes[0];
-    const FacialKeyframe* next = &keyframes[0];
-    
-    for (size_t i = 0; i < keyframes.size() - 1; ++i) {
-        if (keyframes[i].time <= t && keyframes[i + 1].time >= t) {
-            prev = &keyframes[i];
-            next = &keyframes[i + 1];
-            break;
-        }
-        if (i == keyframes.size() - 2) {
-            prev = &keyframes[i + 1];
-            next = &keyframes[i + 1];
-        }
-    }
+    // Find surrounding keyframes (clamped to the first/last)
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), t,
+        [](float value, const FacialKeyframe& key) { return value < key.time; });
+    const FacialKeyframe* prev = (it == keyframes.begin()) ? &keyframes.front() : &*(it - 1);
+    const FacialKeyframe* next = (it == keyframes.end()) ? &keyframes.back() : &*it;
     
     // Interpolate
     float range = next->time - prev->time;
@@ -101,6 +227,26 @@ void FacialAnimationClip::getWeightsAtTime(float time, std::array<float, MAX_SLI
     }
 }
 
+void FacialAnimationClip::getWeightsAtTime(float time, std::array<float, MAX_SLIDERS>& outWeights,
+                                           FacialClipCursor& cursor) const {
+    if (!compiled) {
+        getWeightsAtTime(time, outWeights);
+        return;
+    }
+    
+    float t = time;
+    if (loop && duration > 0.0f) {
+        t = fmod(time, duration);
+    }
+    
+    // Only animated sliders are evaluated; the rest stay neutral
+    outWeights.fill(0.0f);
+    for (size_t c = 0; c < curves.size(); ++c) {
+        const FacialCurve& curve = curves[c];
+        outWeights[curve.slider] = evaluateCurve(&curveKeys[curve.firstKey], curve.keyCount, t, cursor.segments[c]);
+    }
+}
+
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
@@ -135,6 +281,12 @@ bool FacialSystem::init(vkcore::VulkanCore* core) {
         return false;
     }
     
+    // DMaps and base textures are read from the VulkanCore bindless heap
+    if (!core->hasBindlessHeap()) {
+        std::cerr << "[Facial] Bindless texture heap unavailable!" << std::endl;
+        return false;
+    }
+    
     m_core = core;
     
     std::cout << "[Facial] Initializing facial animation system..." << std::endl;
@@ -144,11 +296,38 @@ bool FacialSystem::init(vkcore::VulkanCore* core) {
         return false;
     }
     
+    // A neutral layer until DMaps arrive, so the array sets are always valid
+    if (!ensureDMapArray()) {
+        std::cerr << "[Facial] Failed to create the DMap array!" << std::endl;
+        return false;
+    }
+    
     if (!createDMapPipeline()) {
         std::cerr << "[Facial] Failed to create DMap pipeline!" << std::endl;
         return false;
     }
     
+    // Compositing is optional - without the compute shader meshes are drawn
+    // undisplaced
+    if (createBlendPipeline()) {
+        // The composite is kept across frames: with async compute a blend
+        // waits for the previous frame, and draws and skinning wait for it
+        m_blendPrologue = m_core->addComputePrologue([this](VkCommandBuffer cmd) { blendDMaps(cmd); },
+                                                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                                     false);
+    } else {
+        std::cerr << "[Facial] DMap blend pipeline unavailable (dmap_blend.comp.spv) - "
+                  << "rendering without GPU displacement" << std::endl;
+    }
+    
+    // Instanced crowds are optional too - drawInstances() falls back to
+    // one drawMesh() per instance
+    if (!createInstancedPipeline()) {
+        std::cerr << "[Facial] Instanced DMap pipeline unavailable (dmap_mesh_instanced.vert.spv) - "
+                  << "drawing instances one at a time" << std::endl;
+    }
+    
     m_initialized = true;
     std::cout << "[Facial] Initialized successfully" << std::endl;
     
@@ -165,6 +344,66 @@ void FacialSystem::shutdown() {
     VkDevice device = m_core->getDevice();
     vkDeviceWaitIdle(device);
     
+    if (m_blendPrologue != 0) {
+        m_core->removeFramePrologue(m_blendPrologue);
+        m_blendPrologue = 0;
+    }
+    
+    // The skinning pass would keep calling back into this object
+    for (auto& attached : m_skinnedMeshes) {
+        attached.second.skinning->setInstanceDisplacement(attached.second.instance, nullptr);
+    }
+    m_skinnedMeshes.clear();
+    
+    // Compositing (device is idle, so nothing goes through deferDestroy())
+    destroyComposite();
+    if (m_blendPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, m_blendPipeline, nullptr);
+        m_blendPipeline = VK_NULL_HANDLE;
+    }
+    if (m_blendPipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, m_blendPipelineLayout, nullptr);
+        m_blendPipelineLayout = VK_NULL_HANDLE;
+    }
+    for (BlendFrame& frame : m_blendFrames) {
+        if (frame.set != VK_NULL_HANDLE) {
+            m_core->getDescriptorAllocator().free(frame.set);
+        }
+        m_core->getAllocator().destroyBuffer(frame.ubo, frame.uboAlloc);
+    }
+    m_blendFrames.clear();
+    if (m_blendSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, m_blendSetLayout, nullptr);
+        m_blendSetLayout = VK_NULL_HANDLE;
+    }
+    if (m_compositeSampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, m_compositeSampler, nullptr);
+        m_compositeSampler = VK_NULL_HANDLE;
+    }
+    m_blendList = DMapBlendUBO();
+    m_compositeValid = false;
+    m_compositeActive = false;
+    
+    // Instances
+    if (m_instancedPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, m_instancedPipeline, nullptr);
+        m_instancedPipeline = VK_NULL_HANDLE;
+    }
+    if (m_instancedPipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, m_instancedPipelineLayout, nullptr);
+        m_instancedPipelineLayout = VK_NULL_HANDLE;
+    }
+    if (m_instanceSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, m_instanceSetLayout, nullptr);
+        m_instanceSetLayout = VK_NULL_HANDLE;
+    }
+    for (InstanceFrame& frame : m_instanceFrames) {
+        m_core->getAllocator().destroyBuffer(frame.buffer, frame.alloc);
+    }
+    m_instanceFrames.clear();
+    m_instances.clear();
+    m_instanceHead = 0;
+    
     // Destroy pipeline
     if (m_pipeline != VK_NULL_HANDLE) {
         vkDestroyPipeline(device, m_pipeline, nullptr);
@@ -176,9 +415,10 @@ void FacialSystem::shutdown() {
         m_pipelineLayout = VK_NULL_HANDLE;
     }
     
-    if (m_descriptorPool != VK_NULL_HANDLE) {
-        vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
-        m_descriptorPool = VK_NULL_HANDLE;
+    // Back to the shared VulkanCore pools
+    if (m_descriptorSet != VK_NULL_HANDLE) {
+        m_core->getDescriptorAllocator().free(m_descriptorSet);
+        m_descriptorSet = VK_NULL_HANDLE;
     }
     
     if (m_descriptorSetLayout != VK_NULL_HANDLE) {
@@ -186,15 +426,7 @@ void FacialSystem::shutdown() {
         m_descriptorSetLayout = VK_NULL_HANDLE;
     }
     
-    if (m_uboBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(device, m_uboBuffer, nullptr);
-        m_uboBuffer = VK_NULL_HANDLE;
-    }
-    
-    if (m_uboMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, m_uboMemory, nullptr);
-        m_uboMemory = VK_NULL_HANDLE;
-    }
+    m_core->getAllocator().destroyBuffer(m_uboBuffer, m_uboAlloc);
     
     // Destroy neutral DMap texture
     if (m_neutralDMapTexture != vkcore::INVALID_TEXTURE) {
@@ -202,14 +434,15 @@ void FacialSystem::shutdown() {
         m_neutralDMapTexture = vkcore::INVALID_TEXTURE;
     }
     
-    // Destroy DMap textures
-    for (auto handle : m_dmapHandles) {
-        if (handle != vkcore::INVALID_TEXTURE) {
-            m_core->destroyTexture(handle);
-        }
+    // DMap array
+    destroyDMapArray();
+    if (m_dmapArraySampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, m_dmapArraySampler, nullptr);
+        m_dmapArraySampler = VK_NULL_HANDLE;
     }
-    m_dmapHandles.clear();
+    m_dmapLayerBlocks.clear();
     m_dmaps.clear();
+    m_dmapArrayDirty = true;
     
     m_core = nullptr;
     m_initialized = false;
@@ -225,8 +458,12 @@ int FacialSystem::loadDMap(const std::string& path, const std::string& name, int
     if (!m_initialized) return -1;
     
     // Load image with stb_image
-    int w, h, channels;
-    stbi_uc* pixels = stbi_load(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+    VfsFile file;
+    int w = 0, h = 0, channels = 0;
+    stbi_uc* pixels = nullptr;
+    if (Vfs::shared().open(path, file)) {
+        pixels = stbi_load_from_memory(file.bytes(), static_cast<int>(file.size()), &w, &h, &channels, STBI_rgb_alpha);
+    }
     if (!pixels) {
         std::cerr << "[Facial] Failed to load DMap: " << path << std::endl;
         return -1;
@@ -256,100 +493,13 @@ void FacialSystem::padDMapSeams(uint8_t* pixels, uint32_t width, uint32_t height
     std::cout << "[DMap] Padding seams: radius=" << paddingRadius 
               << ", blend=" << maxBlendFactor << ", passes=" << passes << "..." << std::flush;
     
-    // Neutral grey threshold (128 ± tolerance)
-    const uint8_t neutralThreshold = 5;  // Consider 123-133 as "neutral"
-    const uint8_t neutralValue = 128;
-    
-    int totalPaddedPixels = 0;
+    DMapPadSettings settings;
+    settings.radius = paddingRadius;
+    settings.maxBlendFactor = maxBlendFactor;
+    settings.passes = passes;
     
-    // Multiple passes for better coverage
-    for (int pass = 0; pass < passes; ++pass) {
-        // Create a copy for reading (we'll write to original)
-        size_t pixelCount = width * height;
-        std::vector<uint8_t> source(pixelCount * channels);
-        memcpy(source.data(), pixels, source.size());
-        
-        int paddedPixels = 0;
-        
-        // For each pixel
-        for (uint32_t y = 0; y < height; ++y) {
-            for (uint32_t x = 0; x < width; ++x) {
-                    size_t idx = (y * width + x) * channels;
-                
-                // Check if this pixel is neutral (or very close to neutral)
-                uint8_t r = source[idx + 0];
-                uint8_t g = source[idx + 1];
-                uint8_t b = source[idx + 2];
-                
-                bool isNeutral = (std::abs(static_cast<int>(r) - static_cast<int>(neutralValue)) < neutralThreshold &&
-                                 std::abs(static_cast<int>(g) - static_cast<int>(neutralValue)) < neutralThreshold &&
-                                 std::abs(static_cast<int>(b) - static_cast<int>(neutralValue)) < neutralThreshold);
-                
-                // If neutral, try to find nearby non-neutral pixels and blend them
-                if (isNeutral) {
-                    float totalR = 0.0f, totalG = 0.0f, totalB = 0.0f;
-                    float totalWeight = 0.0f;
-                    
-                    // Sample nearby pixels in a circular pattern
-                    for (int dy = -paddingRadius; dy <= paddingRadius; ++dy) {
-                        for (int dx = -paddingRadius; dx <= paddingRadius; ++dx) {
-                            // Skip center pixel (we're trying to fill it)
-                            if (dx == 0 && dy == 0) continue;
-                            
-                            // Circular distance check
-                            float dist = std::sqrt(static_cast<float>(dx * dx + dy * dy));
-                            if (dist > paddingRadius) continue;
-                            
-                            int sx = static_cast<int>(x) + dx;
-                            int sy = static_cast<int>(y) + dy;
-                            
-                            // Bounds check
-                            if (sx < 0 || sx >= static_cast<int>(width) ||
-                                sy < 0 || sy >= static_cast<int>(height)) {
-                                continue;
-                            }
-                            
-                            size_t srcIdx = (sy * width + sx) * channels;
-                            uint8_t sr = source[srcIdx + 0];
-                            uint8_t sg = source[srcIdx + 1];
-                            uint8_t sb = source[srcIdx + 2];
-                            
-                            // Check if this neighbor is non-neutral
-                            bool neighborIsNeutral = (std::abs(static_cast<int>(sr) - static_cast<int>(neutralValue)) < neutralThreshold &&
-                                                      std::abs(static_cast<int>(sg) - static_cast<int>(neutralValue)) < neutralThreshold &&
-                                                      std::abs(static_cast<int>(sb) - static_cast<int>(neutralValue)) < neutralThreshold);
-                            
-                            if (!neighborIsNeutral) {
-                                // Weight by inverse distance (closer = stronger influence)
-                                float weight = 1.0f / (1.0f + dist);
-                                totalR += sr * weight;
-                                totalG += sg * weight;
-                                totalB += sb * weight;
-                                totalWeight += weight;
-                            }
-                        }
-                    }
-                    
-                    // If we found non-neutral neighbors, blend them in
-                    if (totalWeight > 0.001f) {
-                        // Blend: mix original neutral with nearby values
-                        // Use a falloff so padding is subtle near seams
-                        // Increase blend factor for later passes (more aggressive)
-                        float passMultiplier = 1.0f + (pass * 0.2f);  // Each pass gets slightly more aggressive
-                        float blendFactor = std::min(totalWeight / (paddingRadius * 2.0f) * passMultiplier, maxBlendFactor);
-                        
-                        pixels[idx + 0] = static_cast<uint8_t>(neutralValue * (1.0f - blendFactor) + (totalR / totalWeight) * blendFactor);
-                        pixels[idx + 1] = static_cast<uint8_t>(neutralValue * (1.0f - blendFactor) + (totalG / totalWeight) * blendFactor);
-                        pixels[idx + 2] = static_cast<uint8_t>(neutralValue * (1.0f - blendFactor) + (totalB / totalWeight) * blendFactor);
-                        
-                        paddedPixels++;
-                    }
-                }
-            }
-        }
-        
-        totalPaddedPixels += paddedPixels;
-    }
+    // Serial loop's result, row-parallel (dmap_padding.h)
+    uint64_t totalPaddedPixels = padDMap(pixels, width, height, channels, settings);
     
     std::cout << " done (" << totalPaddedPixels << " pixels padded over " << passes << " passes)" << std::endl;
 }
@@ -376,19 +526,28 @@ int FacialSystem::loadDMapFromMemory(const uint8_t* pixels, uint32_t width, uint
     memcpy(pixelCopy.data(), pixels, pixelDataSize);
     
     // Pad seams if requested (extends displacement values across UV seams to prevent cracking)
-    if (padSeams) {
-        padDMapSeams(pixelCopy.data(), width, height, channels, paddingRadius, maxBlendFactor, 2);  // 2 passes
-    }
-    
-    std::cout << "[Facial] Calling createTextureLinear (for DMap - no SRGB conversion)..." << std::endl;
-    // Create texture in VulkanCore with LINEAR format (no SRGB conversion)
-    // CRITICAL: DMap textures must use linear format, not SRGB!
-    // SRGB would convert neutral grey (128,128,128) to a different value when sampled
-    vkcore::TextureHandle texHandle = m_core->createTextureLinear(pixelCopy.data(), width, height, channels);
-    std::cout << "[Facial] createTextureLinear returned handle: " << texHandle << std::endl;
-    if (texHandle == vkcore::INVALID_TEXTURE) {
-        std::cerr << "[Facial] Failed to create DMap texture" << std::endl;
-        return -1;
+    // Padded results are cached by content, so each asset is padded once
+    if (padSeams && width > 0 && height > 0 && channels >= 3) {
+        DMapPadSettings settings;
+        settings.radius = paddingRadius;
+        settings.maxBlendFactor = maxBlendFactor;
+        settings.passes = 2;
+        
+        std::string cachePath;
+        uint64_t key = 0;
+        if (!m_dmapCacheDirectory.empty()) {
+            key = hashDMapPadding(pixelCopy.data(), width, height, channels, settings);
+            cachePath = paddedDMapCachePath(m_dmapCacheDirectory, key);
+        }
+        
+        if (!cachePath.empty() && loadPaddedDMap(cachePath, key, pixelCopy.data(), width, height, channels)) {
+            std::cout << "[DMap] Padded seams loaded from " << cachePath << std::endl;
+        } else {
+            padDMapSeams(pixelCopy.data(), width, height, channels, paddingRadius, maxBlendFactor, settings.passes);
+            if (!cachePath.empty() && !savePaddedDMap(cachePath, key, pixelCopy.data(), width, height, channels)) {
+                std::cerr << "[DMap] Could not write padding cache " << cachePath << std::endl;
+            }
+        }
     }
     
     // Store DMap info
@@ -404,47 +563,37 @@ int FacialSystem::loadDMapFromMemory(const uint8_t* pixels, uint32_t width, uint
     
     int index = static_cast<int>(m_dmaps.size());
     m_dmaps.push_back(std::move(dmap));
-    m_dmapHandles.push_back(texHandle);
     
     // Link slider to this DMap
     m_sliders[sliderIndex].name = name;
     m_sliders[sliderIndex].dmapIndex = index;
     
-    // Update descriptor set with DMap texture (binding 1)
-    // Use the first loaded DMap as the active one (can be extended to support multiple)
-    if (index == 0) {
-        VkDevice device = m_core->getDevice();
-        
-        // Get texture info from VulkanCore
-        VkImageView view;
-        VkSampler sampler;
-        if (m_core->getTextureInfo(texHandle, view, sampler)) {
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = view;
-            imageInfo.sampler = sampler;
-            
-            VkWriteDescriptorSet write{};
-            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            write.dstSet = m_descriptorSet;
-            write.dstBinding = 1;  // DMap texture binding
-            write.dstArrayElement = 0;
-            write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            write.descriptorCount = 1;
-            write.pImageInfo = &imageInfo;
-            
-            // CRITICAL: Wait for GPU to be idle before updating descriptor sets
-            // This ensures the texture is fully created before we bind it
-            vkDeviceWaitIdle(device);
-            
-            vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
-            std::cout << "[Facial] DMap texture bound to descriptor set (binding 1)" << std::endl;
-            std::cout << "[Facial] Texture handle: " << texHandle << ", view: " << (void*)view << ", sampler: " << (void*)sampler << std::endl;
+    // The GPU copy is a layer of the DMap array (UNORM, so neutral grey
+    // samples exactly), rebuilt once per frame however many DMaps were
+    // loaded. Every slider's DMap is summed into the composite
+    // (blendDMaps()); it grows to the largest DMap, and the next prologue
+    // rebuilds it.
+    m_dmapArrayDirty = true;
+    if (m_blendPipeline != VK_NULL_HANDLE) {
+        if (ensureComposite(width, height)) {
+            std::cout << "[Facial] DMap " << index << " joins the composite (array layer "
+                      << index << ")" << std::endl;
         } else {
-            std::cerr << "[Facial] Failed to get texture info for DMap!" << std::endl;
+            std::cerr << "[Facial] Composite DMap unavailable - rendering without GPU displacement" << std::endl;
         }
-    } else {
-        std::cout << "[Facial] DMap loaded but not binding (index=" << index << ", only index 0 is bound)" << std::endl;
+    }
+    
+    // Kept as loaded (padding already applied) for draw captures
+    if (vkcore::DrawCapture* capture = m_core->getDrawCapture()) {
+        std::vector<uint8_t> payload;
+        vkcore::CaptureWriter out(payload);
+        out.str(name);
+        out.u32(static_cast<uint32_t>(sliderIndex));
+        out.u32(width);
+        out.u32(height);
+        out.u32(static_cast<uint32_t>(channels));
+        out.array(pixelCopy);
+        capture->retainResource(CAPTURE_TAG, std::move(payload));
     }
     
     // CRITICAL: Update the GPU buffer to set hasDMap flag!
@@ -462,6 +611,12 @@ const DMapTexture* FacialSystem::getDMap(int index) const {
     return nullptr;
 }
 
+void FacialSystem::setDMapCompression(float maxError) {
+    if (maxError == m_dmapMaxError) return;
+    m_dmapMaxError = maxError;
+    m_dmapArrayDirty = true;
+}
+
 // ============================================================================
 // Slider Control
 // ============================================================================
@@ -544,12 +699,23 @@ void FacialSystem::blendToPreset(const std::string& name, float blendFactor) {
 int FacialSystem::loadAnimation(const FacialAnimationClip& clip) {
     int index = static_cast<int>(m_animationClips.size());
     m_animationClips.push_back(clip);
+    
+    FacialAnimationClip& stored = m_animationClips.back();
+    if (!stored.compiled) {
+        size_t keyframeCount = stored.keyframes.size();
+        size_t before = stored.getMemoryUsage();
+        stored.compile();
+        std::cout << "[Facial] Clip '" << stored.name << "': " << keyframeCount << " keyframes -> "
+                  << stored.curveKeys.size() << " keys on " << stored.curves.size() << " curves ("
+                  << before << " -> " << stored.getMemoryUsage() << " bytes)" << std::endl;
+    }
     return index;
 }
 
 void FacialSystem::playAnimation(int clipIndex, bool loop) {
     if (clipIndex >= 0 && clipIndex < static_cast<int>(m_animationClips.size())) {
         m_currentClipIndex = clipIndex;
+        m_animationCursor = {};
         m_animationTime = 0.0f;
         m_animationPlaying = true;
         m_animationLoop = loop;
@@ -562,25 +728,123 @@ void FacialSystem::stopAnimation() {
 }
 
 void FacialSystem::updateAnimation(float deltaTime) {
-    if (!m_animationPlaying || m_currentClipIndex < 0) return;
-    
-    const FacialAnimationClip& clip = m_animationClips[m_currentClipIndex];
-    
-    m_animationTime += deltaTime;
+    std::array<float, MAX_SLIDERS> weights;
     
-    // Check if animation ended
-    if (!m_animationLoop && m_animationTime >= clip.duration) {
-        m_animationTime = clip.duration;
-        m_animationPlaying = false;
+    if (m_animationPlaying && m_currentClipIndex >= 0) {
+        const FacialAnimationClip& clip = m_animationClips[m_currentClipIndex];
+        
+        m_animationTime += deltaTime;
+        
+        // Check if animation ended
+        if (!m_animationLoop && m_animationTime >= clip.duration) {
+            m_animationTime = clip.duration;
+            m_animationPlaying = false;
+        }
+        
+        // Get interpolated weights
+        clip.getWeightsAtTime(m_animationTime, weights, m_animationCursor);
+        
+        // Apply to sliders
+        for (int i = 0; i < MAX_SLIDERS; ++i) {
+            setSliderWeight(i, weights[i]);
+        }
     }
     
-    // Get interpolated weights
-    std::array<float, MAX_SLIDERS> weights;
-    clip.getWeightsAtTime(m_animationTime, weights);
+    // Every playing instance in the same pass
+    m_instances.forEach([&](FacialInstanceHandle, FacialInstance& instance) {
+        if (!instance.playing) return;
+        const FacialAnimationClip& clip = m_animationClips[instance.clipIndex];
+        
+        instance.time += deltaTime;
+        if (!instance.loop && instance.time >= clip.duration) {
+            instance.time = clip.duration;
+            instance.playing = false;
+        }
+        
+        clip.getWeightsAtTime(instance.time, weights, instance.cursor);
+        for (int i = 0; i < MAX_SLIDERS; ++i) {
+            instance.weights[i] = std::clamp(weights[i], m_sliders[i].minWeight, m_sliders[i].maxWeight);
+        }
+    });
+}
+
+// ============================================================================
+// Instances
+// ============================================================================
+
+FacialInstanceHandle FacialSystem::createInstance(const glm::mat4& model, const glm::vec4& color) {
+    FacialInstance instance;
+    instance.model = model;
+    instance.color = color;
     
-    // Apply to sliders
-    for (int i = 0; i < MAX_SLIDERS; ++i) {
-        setSliderWeight(i, weights[i]);
+    FacialInstanceHandle handle = m_instances.insert(instance);
+    if (handle == vkcore::HandlePool<FacialInstance>::INVALID_HANDLE) {
+        std::cerr << "[Facial] Instance pool full!" << std::endl;
+        return INVALID_FACIAL_INSTANCE;
+    }
+    return handle;
+}
+
+void FacialSystem::destroyInstance(FacialInstanceHandle instance) {
+    m_instances.remove(instance);
+}
+
+void FacialSystem::setInstanceTransform(FacialInstanceHandle instance, const glm::mat4& model) {
+    if (FacialInstance* face = m_instances.get(instance)) {
+        face->model = model;
+    }
+}
+
+void FacialSystem::setInstanceColor(FacialInstanceHandle instance, const glm::vec4& color) {
+    if (FacialInstance* face = m_instances.get(instance)) {
+        face->color = color;
+    }
+}
+
+void FacialSystem::setInstanceSliderWeight(FacialInstanceHandle instance, int index, float weight) {
+    FacialInstance* face = m_instances.get(instance);
+    if (face && index >= 0 && index < MAX_SLIDERS) {
+        face->weights[index] = std::clamp(weight, m_sliders[index].minWeight, m_sliders[index].maxWeight);
+    }
+}
+
+float FacialSystem::getInstanceSliderWeight(FacialInstanceHandle instance, int index) const {
+    const FacialInstance* face = m_instances.get(instance);
+    if (face && index >= 0 && index < MAX_SLIDERS) {
+        return face->weights[index];
+    }
+    return 0.0f;
+}
+
+void FacialSystem::setInstanceSliderWeights(FacialInstanceHandle instance, const float* weights, int count) {
+    int limit = std::min(count, MAX_SLIDERS);
+    for (int i = 0; i < limit; ++i) {
+        setInstanceSliderWeight(instance, i, weights[i]);
+    }
+}
+
+void FacialSystem::applyPresetToInstance(FacialInstanceHandle instance, const std::string& name) {
+    auto it = m_presets.find(name);
+    if (it != m_presets.end()) {
+        setInstanceSliderWeights(instance, it->second.weights.data(), MAX_SLIDERS);
+    }
+}
+
+void FacialSystem::playInstanceAnimation(FacialInstanceHandle instance, int clipIndex, bool loop) {
+    FacialInstance* face = m_instances.get(instance);
+    if (face && clipIndex >= 0 && clipIndex < static_cast<int>(m_animationClips.size())) {
+        face->clipIndex = clipIndex;
+        face->cursor = {};
+        face->time = 0.0f;
+        face->playing = true;
+        face->loop = loop;
+    }
+}
+
+void FacialSystem::stopInstanceAnimation(FacialInstanceHandle instance) {
+    if (FacialInstance* face = m_instances.get(instance)) {
+        face->playing = false;
+        face->clipIndex = -1;
     }
 }
 
@@ -602,30 +866,11 @@ void FacialSystem::setGlobalStrength(float strength) {
 }
 
 void FacialSystem::setBaseTexture(vkcore::TextureHandle texture) {
-    if (!m_initialized || !m_core || m_descriptorSet == VK_NULL_HANDLE) return;
-    
-    // Use provided texture or default if invalid
-    vkcore::TextureHandle texToUse = (texture != vkcore::INVALID_TEXTURE) ? texture : m_core->getDefaultTexture();
+    if (!m_initialized || !m_core) return;
     
-    VkImageView view;
-    VkSampler sampler;
-    if (m_core->getTextureInfo(texToUse, view, sampler)) {
-        VkDescriptorImageInfo imageInfo{};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = view;
-        imageInfo.sampler = sampler;
-        
-        VkWriteDescriptorSet write{};
-        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.dstSet = m_descriptorSet;
-        write.dstBinding = 2;  // Base texture binding
-        write.dstArrayElement = 0;
-        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        write.descriptorCount = 1;
-        write.pImageInfo = &imageInfo;
-        
-        vkUpdateDescriptorSets(m_core->getDevice(), 1, &write, 0, nullptr);
-    }
+    // Resolved to a heap slot per draw (the slot changes when the texture is
+    // reloaded or streamed); invalid handles map to the default texture
+    m_baseTexture = texture;
 }
 
 void FacialSystem::bind() {
@@ -633,17 +878,31 @@ void FacialSystem::bind() {
         return;
     }
     
-    // Update UBO with current slider weights
-    updateGPUBuffer();
+    if (vkcore::DrawCapture* capture = recordingCapture()) {
+        if (!m_core->isRecordingTask()) captureState(*capture);
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        payload.push_back(uint8_t(CaptureOp::Bind));
+        capture->extension(CAPTURE_TAG, payload);
+    }
+    
+    // Update UBO with current slider weights (main thread only - inside a
+    // VulkanCore::recordParallel task the shared UBO is already current)
+    if (!m_core->isRecordingTask()) {
+        updateGPUBuffer();
+    }
     
     VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
     
     // Bind pipeline
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
     
-    // Bind descriptor set
+    // Set 0: facial UBO, set 1: bindless texture heap
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
                             m_pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+    m_core->bindBindlessHeap(m_pipelineLayout, vkcore::BINDLESS_SET);
+    
+    // The slot is cached, so VulkanCore never sees the texture drawn otherwise
+    m_core->touchTexture(m_baseTexture);
 }
 
 void FacialSystem::drawMesh(vkcore::MeshHandle mesh, const glm::mat4& model,
@@ -651,39 +910,245 @@ void FacialSystem::drawMesh(vkcore::MeshHandle mesh, const glm::mat4& model,
                             vkcore::TextureHandle baseTexture, const glm::vec4& color) {
     if (!m_initialized || !m_core) return;
     
+    vkcore::CaptureCall call;
+    vkcore::DrawCapture* capture = recordingCapture();
+    if (capture && call.outermost()) {
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        vkcore::CaptureWriter out(payload);
+        out.u8(uint8_t(CaptureOp::DrawMesh));
+        out.u32(capture->meshId(mesh));
+        out.mat4(model);
+        out.mat4(view);
+        out.mat4(projection);
+        out.u32(baseTexture);
+        out.vec4(color);
+        capture->extension(CAPTURE_TAG, payload);
+    }
+    
     // Get mesh buffers
     VkBuffer vertexBuffer, indexBuffer;
     uint32_t indexCount;
     if (!m_core->getMeshBuffers(mesh, vertexBuffer, indexBuffer, indexCount)) {
         return;
     }
-    
-    // NOTE: Base texture should be bound before rendering (not during command recording)
-    // The default texture is already bound during initialization
+    uint32_t firstIndex = 0;
+    m_core->getMeshLod(mesh, model, firstIndex, indexCount);
     
     VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
     
-    // Push constants: model, view, projection, color
-    struct PushConstants {
-        glm::mat4 model;
-        glm::mat4 view;
-        glm::mat4 projection;
-        glm::vec4 color;
-    } pushConstants;
-    
+    FacialPushConstants pushConstants{};
     pushConstants.model = model;
     pushConstants.view = view;
     pushConstants.projection = projection;
     pushConstants.color = color;
+    // Skinned meshes were displaced before skinning
+    bool displace = m_gpuDisplacement && m_compositeValid && m_compositeActive &&
+                    m_skinnedMeshes.find(mesh) == m_skinnedMeshes.end();
+    pushConstants.dmapIndex = displace ? m_compositeIndex : m_core->getBindlessIndex(m_neutralDMapTexture);
+    pushConstants.displace = displace ? 1u : 0u;
+    pushConstants.baseIndex = m_core->getBindlessIndex(
+        (baseTexture != vkcore::INVALID_TEXTURE) ? baseTexture : m_baseTexture);
     
     vkCmdPushConstants(cmd, m_pipelineLayout, 
                        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                       0, sizeof(PushConstants), &pushConstants);
+                       0, sizeof(FacialPushConstants), &pushConstants);
+    
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, offsets);
+    vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(cmd, indexCount, 1, firstIndex, 0, 0);
+}
+
+void FacialSystem::attachSkinnedMesh(vkcore::GpuSkinning& skinning, vkcore::SkinInstanceHandle instance) {
+    vkcore::MeshHandle mesh = skinning.getMesh(instance);
+    if (!m_initialized || mesh == vkcore::INVALID_MESH) return;
+    skinning.setInstanceDisplacement(instance, [this]() { return getCompositeDisplacement(); });
+    m_skinnedMeshes[mesh] = {&skinning, instance};
+}
+
+void FacialSystem::detachSkinnedMesh(vkcore::GpuSkinning& skinning, vkcore::SkinInstanceHandle instance) {
+    auto it = m_skinnedMeshes.find(skinning.getMesh(instance));
+    if (it == m_skinnedMeshes.end() || it->second.skinning != &skinning) return;
+    skinning.setInstanceDisplacement(instance, nullptr);
+    m_skinnedMeshes.erase(it);
+}
+
+vkcore::SkinDisplacement FacialSystem::getCompositeDisplacement() const {
+    vkcore::SkinDisplacement displacement;
+    displacement.version = m_compositeUpdates;
+    if (!m_gpuDisplacement || !m_compositeValid || !m_compositeActive) return displacement;
+    displacement.heapIndex = m_compositeIndex;
+    
+    // Each channel is at most the sum of the active scales
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < m_blendList.info.x; ++i) {
+        sum += std::fabs(m_blendList.scales[i / 4][i % 4]);
+    }
+    displacement.maxOffset = sum * std::sqrt(3.0f);
+    return displacement;
+}
+
+void FacialSystem::drawInstances(vkcore::MeshHandle mesh, const FacialInstanceHandle* instances, uint32_t count,
+                                 vkcore::TextureHandle baseTexture) {
+    if (!m_initialized || !m_core || !instances || count == 0) return;
+    
+    vkcore::CaptureCall call;
+    vkcore::DrawCapture* capture = recordingCapture();
+    if (capture && call.outermost()) {
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        vkcore::CaptureWriter out(payload);
+        out.u8(uint8_t(CaptureOp::DrawInstances));
+        out.u32(capture->meshId(mesh));
+        out.u32(baseTexture);
+        size_t countAt = payload.size();
+        out.u32(0);
+        uint32_t written = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            const FacialInstance* face = m_instances.get(instances[i]);
+            if (!face) continue;
+            out.u32(instances[i]);
+            out.mat4(face->model);
+            out.vec4(face->color);
+            out.bytes(face->weights.data(), sizeof(float) * MAX_SLIDERS);
+            written++;
+        }
+        std::memcpy(payload.data() + countAt, &written, sizeof(written));
+        capture->extension(CAPTURE_TAG, payload);
+    }
+    
+    // The instance SSBO is written from the main thread only
+    if (m_instancedPipeline == VK_NULL_HANDLE || m_core->isRecordingTask() || !ensureDMapArray()) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (const FacialInstance* face = m_instances.get(instances[i])) {
+                drawMesh(mesh, face->model, m_viewMatrix, m_projMatrix, baseTexture, face->color);
+            }
+        }
+        return;
+    }
+    
+    if (!m_core->isMeshReady(mesh)) return;
+    
+    VkBuffer vertexBuffer, indexBuffer;
+    uint32_t indexCount;
+    if (!m_core->getMeshBuffers(mesh, vertexBuffer, indexBuffer, indexCount)) return;
+    if (!reserveInstances(count)) return;
+    
+    // Per-slider part of every instance's scales, resolved once per call
+    std::array<float, MAX_SLIDERS> sliderScales{};
+    std::array<uint32_t, MAX_SLIDERS> sliderSlots{};
+    for (int i = 0; i < MAX_SLIDERS; ++i) {
+        const FacialSlider& slider = m_sliders[i];
+        if (!slider.enabled || slider.dmapIndex < 0 || slider.dmapIndex >= static_cast<int>(m_dmaps.size())) continue;
+        const DMapTexture& dmap = m_dmaps[slider.dmapIndex];
+        if (!dmap.valid) continue;
+        sliderScales[i] = m_globalStrength * dmap.maxDisplacement;
+        sliderSlots[i] = static_cast<uint32_t>(slider.dmapIndex);
+    }
+    
+    InstanceFrame& frame = m_instanceFrames[m_core->getCurrentFrame()];
+    GpuFaceInstance* records = static_cast<GpuFaceInstance*>(frame.alloc.mapped) + m_instanceHead;
+    m_instanceModels.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        const FacialInstance* face = m_instances.get(instances[i]);
+        if (!face) continue;
+        
+        GpuFaceInstance record;
+        record.model = face->model;
+        record.color = face->color;
+        packFaceInstance(face->weights, sliderScales, sliderSlots, record);
+        records[m_instanceModels.size()] = record;
+        m_instanceModels.push_back(face->model);
+    }
+    uint32_t written = static_cast<uint32_t>(m_instanceModels.size());
+    if (written == 0) return;
+    
+    uint32_t firstIndex = 0;
+    m_core->getMeshLod(mesh, m_instanceModels.data(), written, firstIndex, indexCount);
+    
+    // Set 2 covers the whole buffer (firstInstance picks this call's
+    // slice) and the DMap array planes
+    VkDescriptorSet set = m_core->getDescriptorAllocator().allocateTransient(m_instanceSetLayout);
+    if (set == VK_NULL_HANDLE) return;
+    VkDescriptorBufferInfo bufferInfo{frame.buffer, 0, VK_WHOLE_SIZE};
+    VkDescriptorImageInfo planeInfos[2]{};
+    planeInfos[0] = {m_dmapArraySampler, m_dmapArrayXY.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    planeInfos[1] = {m_dmapArraySampler, m_dmapArrayZ.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    VkWriteDescriptorSet writes[3]{};
+    for (uint32_t i = 0; i < 3; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    }
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writes[0].pBufferInfo = &bufferInfo;
+    writes[1].pImageInfo = &planeInfos[0];
+    writes[2].pImageInfo = &planeInfos[1];
+    vkUpdateDescriptorSets(m_core->getDevice(), 3, writes, 0, nullptr);
+    
+    VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
+    
+    // Sets 0/1 from bind() are compatible with the instanced layout
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_instancedPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_instancedPipelineLayout, 2, 1, &set, 0, nullptr);
+    
+    // Transform and color come from the SSBO
+    FacialPushConstants pushConstants{};
+    pushConstants.model = glm::mat4(1.0f);
+    pushConstants.view = m_viewMatrix;
+    pushConstants.projection = m_projMatrix;
+    pushConstants.color = glm::vec4(1.0f);
+    pushConstants.dmapIndex = m_core->getBindlessIndex(m_neutralDMapTexture);
+    pushConstants.baseIndex = m_core->getBindlessIndex(
+        (baseTexture != vkcore::INVALID_TEXTURE) ? baseTexture : m_baseTexture);
+    vkCmdPushConstants(cmd, m_instancedPipelineLayout,
+                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(FacialPushConstants), &pushConstants);
     
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, offsets);
     vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(cmd, indexCount, 1, 0, 0, 0);
+    
+    // gl_InstanceIndex starts at firstInstance: this call's records
+    vkCmdDrawIndexed(cmd, indexCount, written, firstIndex, 0, m_instanceHead);
+    m_instanceHead += written;
+    
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+}
+
+bool FacialSystem::reserveInstances(uint32_t count) {
+    if (m_core->getFrameNumber() != m_instanceFrameNumber) {
+        m_instanceFrameNumber = m_core->getFrameNumber();
+        m_instanceHead = 0;
+    }
+    
+    InstanceFrame& frame = m_instanceFrames[m_core->getCurrentFrame()];
+    if (m_instanceHead + count <= frame.capacity) return true;
+    
+    uint32_t capacity = std::max({frame.capacity * 2, count, 64u});
+    VkBuffer buffer = VK_NULL_HANDLE;
+    vkcore::GpuAllocation alloc;
+    if (!m_core->getAllocator().createBuffer(capacity * sizeof(GpuFaceInstance), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, alloc)) {
+        std::cerr << "[Facial] Failed to create instance buffer!" << std::endl;
+        return false;
+    }
+    
+    // Draws already recorded this frame still read the old buffer
+    if (frame.buffer != VK_NULL_HANDLE) {
+        vkcore::VulkanCore* core = m_core;
+        VkBuffer oldBuffer = frame.buffer;
+        vkcore::GpuAllocation oldAlloc = frame.alloc;
+        m_core->deferDestroy([core, oldBuffer, oldAlloc]() mutable {
+            core->getAllocator().destroyBuffer(oldBuffer, oldAlloc);
+        });
+    }
+    frame.buffer = buffer;
+    frame.alloc = alloc;
+    frame.capacity = capacity;
+    m_instanceHead = 0;
+    return true;
 }
 
 void FacialSystem::setDebugMode(bool enabled) {
@@ -693,7 +1158,7 @@ void FacialSystem::setDebugMode(bool enabled) {
 }
 
 void FacialSystem::updateGPUBuffer() {
-    if (!m_initialized || m_uboMemory == VK_NULL_HANDLE) return;
+    if (!m_initialized || !m_uboAlloc.isValid()) return;
     
     // Update hasDMap flag (settings.z) - 1.0 if any valid DMap is loaded, 0.0 otherwise
     bool hasValidDMap = false;
@@ -708,10 +1173,9 @@ void FacialSystem::updateGPUBuffer() {
     // Update debug mode (settings.w)
     m_uboData.settings.w = m_debugMode ? 1.0f : 0.0f;
     
-    void* data;
-    vkMapMemory(m_core->getDevice(), m_uboMemory, 0, sizeof(FacialUBO), 0, &data);
-    memcpy(data, &m_uboData, sizeof(FacialUBO));
-    vkUnmapMemory(m_core->getDevice(), m_uboMemory);
+    if (m_uboAlloc.mapped) {
+        memcpy(m_uboAlloc.mapped, &m_uboData, sizeof(FacialUBO));
+    }
 }
 
 // ============================================================================
@@ -720,102 +1184,37 @@ void FacialSystem::updateGPUBuffer() {
 
 bool FacialSystem::createFacialResources() {
     VkDevice device = m_core->getDevice();
-    VkPhysicalDevice physDevice = m_core->getPhysicalDevice();
-    
-    // Create UBO buffer
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = sizeof(FacialUBO);
-    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     
-    if (vkCreateBuffer(device, &bufferInfo, nullptr, &m_uboBuffer) != VK_SUCCESS) {
+    // Create UBO buffer (persistently mapped sub-allocation)
+    if (!m_core->getAllocator().createBuffer(sizeof(FacialUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_uboBuffer, m_uboAlloc)) {
         std::cerr << "[Facial] Failed to create UBO buffer!" << std::endl;
         return false;
     }
     
-    VkMemoryRequirements memReq;
-    vkGetBufferMemoryRequirements(device, m_uboBuffer, &memReq);
-    
-    uint32_t memTypeIndex = findMemoryType(physDevice, memReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    
-    if (memTypeIndex == UINT32_MAX) {
-        std::cerr << "[Facial] Failed to find suitable memory type!" << std::endl;
-        return false;
-    }
-    
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReq.size;
-    allocInfo.memoryTypeIndex = memTypeIndex;
-    
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &m_uboMemory) != VK_SUCCESS) {
-        std::cerr << "[Facial] Failed to allocate UBO memory!" << std::endl;
-        return false;
-    }
-    
-    vkBindBufferMemory(device, m_uboBuffer, m_uboMemory, 0);
-    
-    // Create descriptor set layout
-    std::vector<VkDescriptorSetLayoutBinding> bindings(3);
-    
+    // Create descriptor set layout (textures come from the bindless heap at set 1)
     // Binding 0: Facial UBO (slider weights) - used in both vertex and fragment shaders
-    bindings[0].binding = 0;
-    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    bindings[0].descriptorCount = 1;
-    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;  // Both stages!
-    bindings[0].pImmutableSamplers = nullptr;
-    
-    // Binding 1: DMap texture sampler (vertex shader)
-    bindings[1].binding = 1;
-    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    bindings[1].descriptorCount = 1;
-    bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;  // Sampled in vertex shader!
-    bindings[1].pImmutableSamplers = nullptr;
-    
-    // Binding 2: Base color texture sampler (fragment shader)
-    bindings[2].binding = 2;
-    bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    bindings[2].descriptorCount = 1;
-    bindings[2].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    bindings[2].pImmutableSamplers = nullptr;
+    VkDescriptorSetLayoutBinding uboBinding{};
+    uboBinding.binding = 0;
+    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboBinding.descriptorCount = 1;
+    uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;  // Both stages!
+    uboBinding.pImmutableSamplers = nullptr;
     
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &uboBinding;
     
     if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
         std::cerr << "[Facial] Failed to create descriptor set layout!" << std::endl;
         return false;
     }
     
-    // Create descriptor pool
-    std::vector<VkDescriptorPoolSize> poolSizes = {
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1},
-        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_DMAP_TEXTURES + 1}  // +1 for base texture
-    };
-    
-    VkDescriptorPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = MAX_DMAP_TEXTURES;
-    
-    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
-        std::cerr << "[Facial] Failed to create descriptor pool!" << std::endl;
-        return false;
-    }
-    
-    // Allocate descriptor set
-    VkDescriptorSetAllocateInfo descAllocInfo{};
-    descAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    descAllocInfo.descriptorPool = m_descriptorPool;
-    descAllocInfo.descriptorSetCount = 1;
-    descAllocInfo.pSetLayouts = &m_descriptorSetLayout;
-    
-    if (vkAllocateDescriptorSets(device, &descAllocInfo, &m_descriptorSet) != VK_SUCCESS) {
+    // Allocate descriptor set from the shared VulkanCore pools
+    m_descriptorSet = m_core->getDescriptorAllocator().allocate(m_descriptorSetLayout);
+    if (m_descriptorSet == VK_NULL_HANDLE) {
         std::cerr << "[Facial] Failed to allocate descriptor set!" << std::endl;
         return false;
     }
@@ -849,64 +1248,117 @@ bool FacialSystem::createFacialResources() {
     }
     std::cout << "[Facial] Created neutral grey DMap texture (128,128,128) for default binding" << std::endl;
     
-    // Get neutral DMap texture info
-    VkImageView neutralView;
-    VkSampler neutralSampler;
-    if (!m_core->getTextureInfo(m_neutralDMapTexture, neutralView, neutralSampler)) {
-        std::cerr << "[Facial] Failed to get neutral DMap texture info!" << std::endl;
+    // DMap array sampler: bilinear, clamped at the edges, single level
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 0.0f;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_dmapArraySampler) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create DMap array sampler!" << std::endl;
         return false;
     }
     
-    // Bind default textures
-    VkImageView defaultView;
-    VkSampler defaultSampler;
-    if (m_core->getTextureInfo(m_core->getDefaultTexture(), defaultView, defaultSampler)) {
-        // Binding 1: Neutral grey DMap (128,128,128 = no displacement)
-        VkDescriptorImageInfo neutralImageInfo{};
-        neutralImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        neutralImageInfo.imageView = neutralView;
-        neutralImageInfo.sampler = neutralSampler;
-        
-        VkWriteDescriptorSet dmapWrite{};
-        dmapWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        dmapWrite.dstSet = m_descriptorSet;
-        dmapWrite.dstBinding = 1;
-        dmapWrite.dstArrayElement = 0;
-        dmapWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        dmapWrite.descriptorCount = 1;
-        dmapWrite.pImageInfo = &neutralImageInfo;
-        
-        // Binding 2: Default base texture (white)
-        VkDescriptorImageInfo defaultImageInfo{};
-        defaultImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        defaultImageInfo.imageView = defaultView;
-        defaultImageInfo.sampler = defaultSampler;
-        
-        VkWriteDescriptorSet baseWrite{};
-        baseWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        baseWrite.dstSet = m_descriptorSet;
-        baseWrite.dstBinding = 2;
-        baseWrite.dstArrayElement = 0;
-        baseWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        baseWrite.descriptorCount = 1;
-        baseWrite.pImageInfo = &defaultImageInfo;
-        
-        std::array<VkWriteDescriptorSet, 2> writes = {dmapWrite, baseWrite};
-        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    return true;
+}
+
+bool FacialSystem::createDMapPipeline() {
+    VkDevice device = m_core->getDevice();
+    
+    // Push constant range: model, view, projection, color + heap indices (224 bytes)
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(FacialPushConstants);
+    
+    // Pipeline layout: set 0 = facial UBO, set 1 = bindless texture heap
+    VkDescriptorSetLayout setLayouts[] = {m_descriptorSetLayout, m_core->getBindlessSetLayout()};
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 2;
+    pipelineLayoutInfo.pSetLayouts = setLayouts;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create pipeline layout!" << std::endl;
+        return false;
     }
     
+    if (!createDMapPipelineVariant("shaders/dmap_mesh.vert.spv", m_pipelineLayout, m_pipeline)) {
+        return false;
+    }
+    
+    std::cout << "[Facial] Created DMap pipeline" << std::endl;
     return true;
 }
 
-bool FacialSystem::createDMapPipeline() {
+bool FacialSystem::createInstancedPipeline() {
+    VkDevice device = m_core->getDevice();
+    
+    // Set 2: this frame's instance SSBO and the DMap array planes (vertex stage)
+    VkDescriptorSetLayoutBinding instanceBindings[3]{};
+    for (uint32_t i = 0; i < 3; i++) {
+        instanceBindings[i].binding = i;
+        instanceBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        instanceBindings[i].descriptorCount = 1;
+        instanceBindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    }
+    instanceBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 3;
+    layoutInfo.pBindings = instanceBindings;
+    
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_instanceSetLayout) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create instance set layout!" << std::endl;
+        return false;
+    }
+    
+    // Sets 0/1 and the push constant range match m_pipelineLayout, so the
+    // sets bound by bind() stay valid across the switch
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(FacialPushConstants);
+    
+    VkDescriptorSetLayout setLayouts[] = {m_descriptorSetLayout, m_core->getBindlessSetLayout(), m_instanceSetLayout};
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 3;
+    pipelineLayoutInfo.pSetLayouts = setLayouts;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_instancedPipelineLayout) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create instanced pipeline layout!" << std::endl;
+        return false;
+    }
+    
+    if (!createDMapPipelineVariant("shaders/dmap_mesh_instanced.vert.spv", m_instancedPipelineLayout,
+                                   m_instancedPipeline)) {
+        return false;
+    }
+    
+    m_instanceFrames.resize(m_core->getFramesInFlight());
+    std::cout << "[Facial] Created instanced DMap pipeline" << std::endl;
+    return true;
+}
+
+bool FacialSystem::createDMapPipelineVariant(const char* vertPath, VkPipelineLayout layout, VkPipeline& outPipeline) {
     VkDevice device = m_core->getDevice();
     
     // Load shaders
-    auto vertCode = readShaderFile("shaders/dmap_mesh.vert.spv");
+    auto vertCode = readShaderFile(vertPath);
     auto fragCode = readShaderFile("shaders/dmap_mesh.frag.spv");
     
     if (vertCode.empty() || fragCode.empty()) {
-        std::cerr << "[Facial] Failed to load shaders!" << std::endl;
+        std::cerr << "[Facial] Failed to load shaders (" << vertPath << ")!" << std::endl;
         return false;
     }
     
@@ -1018,28 +1470,6 @@ bool FacialSystem::createDMapPipeline() {
     dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
     dynamicState.pDynamicStates = dynamicStates.data();
     
-    // Push constant range: model (mat4), view (mat4), projection (mat4), color (vec4)
-    // Total: 3 * 16 floats + 4 floats = 52 floats = 208 bytes
-    VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-    pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(glm::mat4) * 3 + sizeof(glm::vec4);  // model + view + proj + color
-    
-    // Pipeline layout
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-    
-    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-        vkDestroyShaderModule(device, vertModule, nullptr);
-        vkDestroyShaderModule(device, fragModule, nullptr);
-        std::cerr << "[Facial] Failed to create pipeline layout!" << std::endl;
-        return false;
-    }
-    
     // Create graphics pipeline
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -1053,11 +1483,11 @@ bool FacialSystem::createDMapPipeline() {
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;
-    pipelineInfo.layout = m_pipelineLayout;
+    pipelineInfo.layout = layout;
     pipelineInfo.renderPass = m_core->getRenderPass();
     pipelineInfo.subpass = 0;
     
-    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(device, m_core->getPipelineCache(), 1, &pipelineInfo, nullptr, &outPipeline) != VK_SUCCESS) {
         vkDestroyShaderModule(device, vertModule, nullptr);
         vkDestroyShaderModule(device, fragModule, nullptr);
         std::cerr << "[Facial] Failed to create graphics pipeline!" << std::endl;
@@ -1068,10 +1498,602 @@ bool FacialSystem::createDMapPipeline() {
     vkDestroyShaderModule(device, vertModule, nullptr);
     vkDestroyShaderModule(device, fragModule, nullptr);
     
-    std::cout << "[Facial] Created DMap pipeline" << std::endl;
     return true;
 }
 
+// ============================================================================
+// DMap Compositing
+// ============================================================================
+
+bool FacialSystem::createBlendPipeline() {
+    VkDevice device = m_core->getDevice();
+    vkcore::GpuAllocator& allocator = m_core->getAllocator();
+    
+    auto compCode = readShaderFile("shaders/dmap_blend.comp.spv");
+    if (compCode.empty()) return false;
+    
+    // Composite sampler for the vertex fetch: bilinear, clamped at the edges
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 0.0f;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_compositeSampler) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create composite sampler!" << std::endl;
+        return false;
+    }
+    
+    // Set 0: composite (storage image), blend list and the DMap array planes
+    VkDescriptorSetLayoutBinding bindings[4]{};
+    for (uint32_t i = 0; i < 4; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 4;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_blendSetLayout) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create blend set layout!" << std::endl;
+        return false;
+    }
+    
+    // Written in the prologue while this frame slot is idle; the storage
+    // image is filled in once a composite exists
+    m_blendFrames.resize(m_core->getFramesInFlight());
+    for (BlendFrame& frame : m_blendFrames) {
+        if (!allocator.createBuffer(sizeof(DMapBlendUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                frame.ubo, frame.uboAlloc)) {
+            std::cerr << "[Facial] Failed to create blend list buffer!" << std::endl;
+            return false;
+        }
+        frame.set = m_core->getDescriptorAllocator().allocate(m_blendSetLayout);
+        if (frame.set == VK_NULL_HANDLE) {
+            std::cerr << "[Facial] Failed to allocate blend descriptor set!" << std::endl;
+            return false;
+        }
+    }
+    
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_blendSetLayout;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_blendPipelineLayout) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create blend pipeline layout!" << std::endl;
+        return false;
+    }
+    
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = compCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(compCode.data());
+    
+    VkShaderModule compModule;
+    if (vkCreateShaderModule(device, &moduleInfo, nullptr, &compModule) != VK_SUCCESS) {
+        std::cerr << "[Facial] Failed to create blend shader module!" << std::endl;
+        return false;
+    }
+    
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = compModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_blendPipelineLayout;
+    
+    VkResult result = vkCreateComputePipelines(device, m_core->getPipelineCache(), 1, &pipelineInfo,
+                                               nullptr, &m_blendPipeline);
+    vkDestroyShaderModule(device, compModule, nullptr);
+    if (result != VK_SUCCESS) {
+        m_blendPipeline = VK_NULL_HANDLE;
+        std::cerr << "[Facial] Failed to create blend pipeline!" << std::endl;
+        return false;
+    }
+    
+    std::cout << "[Facial] Created DMap blend pipeline" << std::endl;
+    return true;
+}
+
+bool FacialSystem::ensureComposite(uint32_t width, uint32_t height) {
+    if (m_compositeView != VK_NULL_HANDLE && width <= m_compositeWidth && height <= m_compositeHeight) {
+        return true;
+    }
+    width = std::max(width, m_compositeWidth);
+    height = std::max(height, m_compositeHeight);
+    
+    VkDevice device = m_core->getDevice();
+    vkcore::GpuAllocator& allocator = m_core->getAllocator();
+    
+    // Signed offsets in object units: RGBA16F (storage support is required)
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    imageInfo.extent = {width, height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    
+    // Written on the compute queue with async compute, sampled on graphics
+    VkImage image = VK_NULL_HANDLE;
+    vkcore::GpuAllocation alloc;
+    if (!m_core->createSharedImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, alloc)) {
+        std::cerr << "[Facial] Failed to create " << width << "x" << height << " composite DMap!" << std::endl;
+        return false;
+    }
+    
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    
+    VkImageView view = VK_NULL_HANDLE;
+    uint32_t index = vkcore::BindlessHeap::INVALID_INDEX;
+    if (vkCreateImageView(device, &viewInfo, nullptr, &view) == VK_SUCCESS) {
+        index = m_core->getBindlessHeap().add(view, m_compositeSampler);
+    }
+    if (index == vkcore::BindlessHeap::INVALID_INDEX) {
+        std::cerr << "[Facial] Failed to register the composite DMap!" << std::endl;
+        if (view != VK_NULL_HANDLE) vkDestroyImageView(device, view, nullptr);
+        allocator.destroyImage(image, alloc);
+        return false;
+    }
+    
+    // Frames in flight may still sample the old composite
+    if (m_compositeImage != VK_NULL_HANDLE) {
+        m_core->getBindlessHeap().remove(m_compositeIndex);
+        vkcore::VulkanCore* core = m_core;
+        VkImage oldImage = m_compositeImage;
+        vkcore::GpuAllocation oldAlloc = m_compositeAlloc;
+        VkImageView oldView = m_compositeView;
+        m_core->deferDestroy([core, oldImage, oldAlloc, oldView]() mutable {
+            vkDestroyImageView(core->getDevice(), oldView, nullptr);
+            core->getAllocator().destroyImage(oldImage, oldAlloc);
+        });
+    }
+    
+    m_compositeImage = image;
+    m_compositeAlloc = alloc;
+    m_compositeView = view;
+    m_compositeIndex = index;
+    m_compositeWidth = width;
+    m_compositeHeight = height;
+    m_compositeValid = false;
+    for (BlendFrame& frame : m_blendFrames) frame.setStale = true;
+    
+    std::cout << "[Facial] Composite DMap " << width << "x" << height << " (heap index " << index << ")" << std::endl;
+    return true;
+}
+
+void FacialSystem::destroyComposite() {
+    if (m_compositeIndex != vkcore::BindlessHeap::INVALID_INDEX) {
+        m_core->getBindlessHeap().remove(m_compositeIndex);
+        m_compositeIndex = vkcore::BindlessHeap::INVALID_INDEX;
+    }
+    if (m_compositeView != VK_NULL_HANDLE) {
+        vkDestroyImageView(m_core->getDevice(), m_compositeView, nullptr);
+        m_compositeView = VK_NULL_HANDLE;
+    }
+    m_core->getAllocator().destroyImage(m_compositeImage, m_compositeAlloc);
+    m_compositeWidth = 0;
+    m_compositeHeight = 0;
+}
+
+bool FacialSystem::createDMapArrayImage(VkFormat format, uint32_t layers, DMapArrayImage& out) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = format;
+    imageInfo.extent = {m_dmapArrayWidth, m_dmapArrayHeight, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = layers;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // Uploaded on the graphics queue, read by blends on either
+    if (!m_core->createSharedImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, out.image, out.alloc)) {
+        return false;
+    }
+    
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = out.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layers};
+    if (vkCreateImageView(m_core->getDevice(), &viewInfo, nullptr, &out.view) != VK_SUCCESS) {
+        out.view = VK_NULL_HANDLE;
+        m_core->getAllocator().destroyImage(out.image, out.alloc);
+        return false;
+    }
+    return true;
+}
+
+bool FacialSystem::ensureDMapArray() {
+    if (!m_dmapArrayDirty) return m_dmapArrayXY.view != VK_NULL_HANDLE;
+    m_dmapArrayDirty = false;
+    m_dmapArrayFrame = m_core->getFrameNumber();
+    
+    // Every layer at the largest DMap's size; one neutral 4x4 layer before any load
+    uint32_t width = 0, height = 0;
+    for (const DMapTexture& dmap : m_dmaps) {
+        width = std::max(width, dmap.width);
+        height = std::max(height, dmap.height);
+    }
+    if (m_dmaps.empty() || width == 0 || height == 0) {
+        width = 4;
+        height = 4;
+    }
+    uint32_t layers = std::max(static_cast<uint32_t>(m_dmaps.size()), 1u);
+    
+    // BC5 + BC4 when every layer stays within the allowed error. Encodings
+    // are kept per DMap, so only new (or resized) layers are encoded.
+    std::vector<uint8_t> xy, z;
+    bool compress = !m_dmaps.empty() && m_dmapMaxError >= 0.0f && m_core->supportsBCTextures();
+    if (compress) {
+        m_dmapLayerBlocks.resize(m_dmaps.size());
+        uint32_t worstError = 0;
+        for (size_t i = 0; i < m_dmaps.size(); i++) {
+            const DMapTexture& dmap = m_dmaps[i];
+            DMapLayerBlocks& blocks = m_dmapLayerBlocks[i];
+            if (blocks.width != width || blocks.height != height) {
+                size_t texels = size_t(dmap.width) * dmap.height;
+                int channels = texels > 0 ? static_cast<int>(dmap.pixels.size() / texels) : 0;
+                splitDMapPlanes(dmap.pixels.data(), dmap.width, dmap.height, channels, width, height, xy, z);
+                blocks.xy.resize(bcPlaneSize(width, height, 2));
+                blocks.z.resize(bcPlaneSize(width, height, 1));
+                blocks.maxError = std::max(compressBCPlane(xy.data(), width, height, 2, blocks.xy.data()),
+                                           compressBCPlane(z.data(), width, height, 1, blocks.z.data()));
+                blocks.width = width;
+                blocks.height = height;
+            }
+            worstError = std::max(worstError, blocks.maxError);
+        }
+        if (static_cast<float>(worstError) > m_dmapMaxError) {
+            std::cout << "[Facial] DMap BC error " << worstError << " exceeds " << m_dmapMaxError
+                      << " - DMap array stays uncompressed" << std::endl;
+            compress = false;
+        }
+    }
+    
+    uint32_t oldWidth = m_dmapArrayWidth, oldHeight = m_dmapArrayHeight;
+    m_dmapArrayWidth = width;
+    m_dmapArrayHeight = height;
+    DMapArrayImage arrayXY, arrayZ;
+    bool created = createDMapArrayImage(compress ? VK_FORMAT_BC5_UNORM_BLOCK : VK_FORMAT_R8G8_UNORM, layers, arrayXY) &&
+                   createDMapArrayImage(compress ? VK_FORMAT_BC4_UNORM_BLOCK : VK_FORMAT_R8_UNORM, layers, arrayZ);
+    
+    // One submission for every layer of both planes
+    bool uploaded = created;
+    if (created) {
+        vkcore::UploadBatch& uploads = m_core->getUploadBatch();
+        m_core->beginUploadBatch();
+        for (uint32_t layer = 0; layer < layers && uploaded; layer++) {
+            const uint8_t* xyData = nullptr;
+            const uint8_t* zData = nullptr;
+            size_t xyBytes = 0, zBytes = 0;
+            if (compress) {
+                const DMapLayerBlocks& blocks = m_dmapLayerBlocks[layer];
+                xyData = blocks.xy.data();
+                zData = blocks.z.data();
+                xyBytes = blocks.xy.size();
+                zBytes = blocks.z.size();
+            } else {
+                if (layer < m_dmaps.size()) {
+                    const DMapTexture& dmap = m_dmaps[layer];
+                    size_t texels = size_t(dmap.width) * dmap.height;
+                    int channels = texels > 0 ? static_cast<int>(dmap.pixels.size() / texels) : 0;
+                    splitDMapPlanes(dmap.pixels.data(), dmap.width, dmap.height, channels, width, height, xy, z);
+                } else {
+                    splitDMapPlanes(nullptr, 0, 0, 0, width, height, xy, z);  // Neutral
+                }
+                xyData = xy.data();
+                zData = z.data();
+                xyBytes = xy.size();
+                zBytes = z.size();
+            }
+            uploaded = uploads.uploadImageLayer(arrayXY.image, xyData, xyBytes, width, height, layer) != vkcore::UploadBatch::NO_UPLOAD &&
+                       uploads.uploadImageLayer(arrayZ.image, zData, zBytes, width, height, layer) != vkcore::UploadBatch::NO_UPLOAD;
+        }
+        m_core->endUploadBatch();
+    }
+    
+    // Frames in flight may still sample the old images (and copies already
+    // recorded may target the new ones if this build failed part way)
+    auto retire = [this](DMapArrayImage& array) {
+        if (array.image == VK_NULL_HANDLE) return;
+        vkcore::VulkanCore* core = m_core;
+        DMapArrayImage old = array;
+        m_core->deferDestroy([core, old]() mutable {
+            if (old.view != VK_NULL_HANDLE) vkDestroyImageView(core->getDevice(), old.view, nullptr);
+            core->getAllocator().destroyImage(old.image, old.alloc);
+        });
+        array = DMapArrayImage();
+    };
+    if (!uploaded) {
+        retire(arrayXY);
+        retire(arrayZ);
+        m_dmapArrayWidth = oldWidth;
+        m_dmapArrayHeight = oldHeight;
+        std::cerr << "[Facial] Failed to build the " << layers << "-layer DMap array" << std::endl;
+        return m_dmapArrayXY.view != VK_NULL_HANDLE;
+    }
+    retire(m_dmapArrayXY);
+    retire(m_dmapArrayZ);
+    m_dmapArrayXY = arrayXY;
+    m_dmapArrayZ = arrayZ;
+    m_dmapArrayCompressed = compress;
+    m_dmapArrayBytes = compress ? layers * (bcPlaneSize(width, height, 2) + bcPlaneSize(width, height, 1))
+                                : size_t(layers) * width * height * 3;
+    
+    // New layers: blend sets point at the new views and the composite is re-blended
+    for (BlendFrame& frame : m_blendFrames) frame.setStale = true;
+    m_compositeValid = false;
+    
+    std::cout << "[Facial] DMap array: " << layers << " layer(s) " << width << "x" << height << ", "
+              << (compress ? "BC5 + BC4" : "R8G8 + R8") << ", " << m_dmapArrayBytes / 1024 << " KB" << std::endl;
+    return true;
+}
+
+void FacialSystem::destroyDMapArray() {
+    for (DMapArrayImage* array : {&m_dmapArrayXY, &m_dmapArrayZ}) {
+        if (array->view != VK_NULL_HANDLE) {
+            vkDestroyImageView(m_core->getDevice(), array->view, nullptr);
+        }
+        m_core->getAllocator().destroyImage(array->image, array->alloc);
+        *array = DMapArrayImage();
+    }
+    m_dmapArrayWidth = 0;
+    m_dmapArrayHeight = 0;
+    m_dmapArrayBytes = 0;
+    m_dmapArrayCompressed = false;
+}
+
+void FacialSystem::blendDMaps(VkCommandBuffer cmd) {
+    if (m_blendPipeline == VK_NULL_HANDLE || m_compositeView == VK_NULL_HANDLE) return;
+    if (!ensureDMapArray()) return;
+    
+    // Async compute: a rebuilt array is uploaded on the graphics queue at the
+    // end of the frame it was built in (or of the next one when built between
+    // frames), after that frame's compute batch - blend once a batch waited for it
+    const bool async = m_core->hasAsyncCompute();
+    if (async && m_core->getFrameNumber() <= m_dmapArrayFrame + 1) return;
+    if (!m_gpuDisplacement) {
+        m_compositeValid = false;  // Rebuilt when turned back on
+        return;
+    }
+    
+    // Sparse list: only sliders that actually move something
+    DMapBlendUBO list;
+    list.info.y = m_compositeWidth;
+    list.info.z = m_compositeHeight;
+    for (const FacialSlider& slider : m_sliders) {
+        if (!slider.enabled || slider.dmapIndex < 0 || slider.dmapIndex >= static_cast<int>(m_dmaps.size())) continue;
+        const DMapTexture& dmap = m_dmaps[slider.dmapIndex];
+        float scale = slider.weight * m_globalStrength * dmap.maxDisplacement;
+        if (!dmap.valid || std::fabs(scale) < 1e-6f) continue;
+        list.add(static_cast<uint32_t>(slider.dmapIndex), scale);
+    }
+    
+    // Same weights as the composite holds: no GPU work this frame
+    if (m_compositeValid && memcmp(&list, &m_blendList, sizeof(DMapBlendUBO)) == 0) return;
+    m_blendList = list;
+    m_compositeValid = true;
+    m_compositeActive = list.info.x > 0;
+    if (!m_compositeActive) return;  // Draws skip the fetch
+    
+    uint32_t scope = m_core->getGpuProfiler().beginScope(cmd, "facial_blend");
+    
+    // This frame slot is idle (its fence was waited on)
+    BlendFrame& frame = m_blendFrames[m_core->getCurrentFrame()];
+    memcpy(frame.uboAlloc.mapped, &list, sizeof(DMapBlendUBO));
+    if (frame.setStale) {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageView = m_compositeView;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        VkDescriptorBufferInfo bufferInfo{frame.ubo, 0, sizeof(DMapBlendUBO)};
+        VkDescriptorImageInfo planeInfos[2]{};
+        planeInfos[0] = {m_dmapArraySampler, m_dmapArrayXY.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        planeInfos[1] = {m_dmapArraySampler, m_dmapArrayZ.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        
+        VkWriteDescriptorSet writes[4]{};
+        for (uint32_t i = 0; i < 4; i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = frame.set;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        }
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[0].pImageInfo = &imageInfo;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writes[1].pBufferInfo = &bufferInfo;
+        writes[2].pImageInfo = &planeInfos[0];
+        writes[3].pImageInfo = &planeInfos[1];
+        vkUpdateDescriptorSets(m_core->getDevice(), 4, writes, 0, nullptr);
+        frame.setStale = false;
+    }
+    
+    // After earlier frames' vertex fetches and skinning reads; the old
+    // contents are discarded
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_compositeImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    // (on the compute queue the batch already waited for them)
+    vkCmdPipelineBarrier(cmd, async ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                                    : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_blendPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_blendPipelineLayout, 0, 1,
+                            &frame.set, 0, nullptr);
+    vkCmdDispatch(cmd, (m_compositeWidth + 7) / 8, (m_compositeHeight + 7) / 8, 1);
+    
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    // Read by draws and by the skinning pass later in the prologue; on the
+    // compute queue the frame's semaphore wait covers the graphics stages
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         async ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                               : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+    
+    m_core->getGpuProfiler().endScope(cmd, scope);
+    m_compositeUpdates++;
+}
+
+// ============================================================================
+// Draw Capture
+// ============================================================================
+
+vkcore::DrawCapture* FacialSystem::recordingCapture() const {
+    vkcore::DrawCapture* capture = m_core ? m_core->getDrawCapture() : nullptr;
+    return capture && capture->isRecording() ? capture : nullptr;
+}
+
+// Everything bind() uploads, plus what drawMesh() reads
+void FacialSystem::captureState(vkcore::DrawCapture& capture) {
+    std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+    vkcore::CaptureWriter out(payload);
+    out.u8(uint8_t(CaptureOp::State));
+    out.mat4(m_viewMatrix);
+    out.mat4(m_projMatrix);
+    out.f32(m_globalStrength);
+    out.u8(m_debugMode ? 1 : 0);
+    out.u8(m_gpuDisplacement ? 1 : 0);
+    out.f32(m_dmapMaxError);
+    out.u32(m_baseTexture);
+    for (const FacialSlider& slider : m_sliders) {
+        out.f32(slider.weight);
+        out.f32(slider.minWeight);
+        out.f32(slider.maxWeight);
+        out.u8(slider.enabled ? 1 : 0);
+    }
+    capture.extension(CAPTURE_TAG, payload);
+}
+
+void FacialSystem::replayState(vkcore::CaptureReader& in, vkcore::CaptureRemap& remap) {
+    setViewMatrix(in.mat4());
+    setProjectionMatrix(in.mat4());
+    float strength = in.f32();
+    if (strength != m_globalStrength) setGlobalStrength(strength);
+    bool debugMode = in.u8() != 0;
+    if (debugMode != m_debugMode) setDebugMode(debugMode);
+    setGpuDisplacement(in.u8() != 0);
+    setDMapCompression(in.f32());
+    vkcore::TextureHandle texture = remap.texture(in.u32());
+    if (texture != m_baseTexture) setBaseTexture(texture);
+    for (int i = 0; i < MAX_SLIDERS; ++i) {
+        float weight = in.f32();
+        float minWeight = in.f32();
+        float maxWeight = in.f32();
+        bool enabled = in.u8() != 0;
+        setSliderRange(i, minWeight, maxWeight);
+        setSliderEnabled(i, enabled);
+        setSliderWeight(i, weight);
+    }
+}
+
+bool FacialSystem::replayCaptureResource(vkcore::CaptureReader& in) {
+    std::string name = in.str();
+    int sliderIndex = static_cast<int>(in.u32());
+    uint32_t width = in.u32();
+    uint32_t height = in.u32();
+    int channels = static_cast<int>(in.u32());
+    std::vector<uint8_t> pixels;
+    if (!in.array(pixels) || pixels.size() != size_t(width) * height * channels) return false;
+    return loadDMapFromMemory(pixels.data(), width, height, name, sliderIndex, channels, false) >= 0;
+}
+
+bool FacialSystem::replayCapture(vkcore::CaptureReader& in, vkcore::CaptureRemap& remap) {
+    if (!m_initialized) return false;
+    
+    switch (CaptureOp(in.u8())) {
+    case CaptureOp::State:
+        replayState(in, remap);
+        break;
+    case CaptureOp::Bind:
+        bind();
+        break;
+    case CaptureOp::DrawMesh: {
+        vkcore::MeshHandle mesh = remap.mesh(in.u32());
+        glm::mat4 model = in.mat4();
+        glm::mat4 view = in.mat4();
+        glm::mat4 projection = in.mat4();
+        vkcore::TextureHandle texture = remap.texture(in.u32());
+        glm::vec4 color = in.vec4();
+        if (in.ok()) drawMesh(mesh, model, view, projection, texture, color);
+        break;
+    }
+    case CaptureOp::DrawInstances: {
+        // Captured instances become replay instances on first use and
+        // take the captured expression every draw
+        static std::vector<FacialInstanceHandle> handles;
+        vkcore::MeshHandle mesh = remap.mesh(in.u32());
+        vkcore::TextureHandle texture = remap.texture(in.u32());
+        uint32_t count = in.u32();
+        handles.clear();
+        for (uint32_t i = 0; i < count && in.ok(); i++) {
+            uint64_t key = vkcore::CaptureRemap::objectKey(INSTANCE_OBJECTS, in.u32());
+            glm::mat4 model = in.mat4();
+            glm::vec4 color = in.vec4();
+            std::array<float, MAX_SLIDERS> weights;
+            in.bytes(weights.data(), sizeof(float) * MAX_SLIDERS);
+            
+            auto replayed = remap.objects.find(key);
+            FacialInstanceHandle instance = INVALID_FACIAL_INSTANCE;
+            if (replayed != remap.objects.end() && isValidInstance(replayed->second)) {
+                instance = replayed->second;
+                setInstanceTransform(instance, model);
+                setInstanceColor(instance, color);
+            } else {
+                instance = createInstance(model, color);
+                if (instance == INVALID_FACIAL_INSTANCE) continue;
+                remap.objects[key] = instance;
+            }
+            setInstanceSliderWeights(instance, weights.data(), MAX_SLIDERS);
+            handles.push_back(instance);
+        }
+        if (in.ok() && !handles.empty()) {
+            drawInstances(mesh, handles.data(), static_cast<uint32_t>(handles.size()), texture);
+        }
+        break;
+    }
+    default:
+        std::cerr << "[Facial] Unknown capture command" << std::endl;
+        return false;
+    }
+    return in.ok();
+}
+
 } // namespace facial
 
 // ============================================================================
@@ -1083,12 +2105,14 @@ static facial::FacialSystem* g_facialSystem = nullptr;
 extern "C" {
 
 int facial_init(void* vulkanCore) {
+    EDEN_PROFILE_API();
     if (g_facialSystem) return 0;
     g_facialSystem = new facial::FacialSystem();
     return g_facialSystem->init(static_cast<vkcore::VulkanCore*>(vulkanCore)) ? 1 : 0;
 }
 
 void facial_shutdown() {
+    EDEN_PROFILE_API();
     if (g_facialSystem) {
         g_facialSystem->shutdown();
         delete g_facialSystem;
@@ -1097,47 +2121,58 @@ void facial_shutdown() {
 }
 
 int facial_is_initialized() {
+    EDEN_PROFILE_API();
     return (g_facialSystem && g_facialSystem->isInitialized()) ? 1 : 0;
 }
 
 int facial_load_dmap(const char* path, const char* name, int sliderIndex) {
+    EDEN_PROFILE_API();
     if (!g_facialSystem) return -1;
     return g_facialSystem->loadDMap(path, name, sliderIndex);
 }
 
 void facial_set_slider(int index, float weight) {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->setSliderWeight(index, weight);
 }
 
 float facial_get_slider(int index) {
+    EDEN_PROFILE_API();
     return g_facialSystem ? g_facialSystem->getSliderWeight(index) : 0.0f;
 }
 
 void facial_reset_sliders() {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->resetSliders();
 }
 
 void facial_apply_preset(const char* name) {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->applyPreset(name);
 }
 
 void facial_play_animation(int clipIndex, int loop) {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->playAnimation(clipIndex, loop != 0);
 }
 
 void facial_stop_animation() {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->stopAnimation();
 }
 
 void facial_update(float deltaTime) {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->updateAnimation(deltaTime);
 }
 
 void facial_bind() {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->bind();
 }
 
 void facial_set_view_matrix(const float* mat4) {
+    EDEN_PROFILE_API();
     if (g_facialSystem && mat4) {
         glm::mat4 view;
         memcpy(&view, mat4, sizeof(glm::mat4));
@@ -1146,6 +2181,7 @@ void facial_set_view_matrix(const float* mat4) {
 }
 
 void facial_set_projection_matrix(const float* mat4) {
+    EDEN_PROFILE_API();
     if (g_facialSystem && mat4) {
         glm::mat4 proj;
         memcpy(&proj, mat4, sizeof(glm::mat4));
@@ -1154,6 +2190,7 @@ void facial_set_projection_matrix(const float* mat4) {
 }
 
 void facial_set_global_strength(float strength) {
+    EDEN_PROFILE_API();
     if (g_facialSystem) g_facialSystem->setGlobalStrength(strength);
 }
 
@@ -1163,6 +2200,7 @@ void facial_draw_mesh(unsigned int meshHandle,
                       float sx, float sy, float sz,
                       unsigned int baseTexture,
                       float r, float g, float b, float a) {
+    EDEN_PROFILE_API();
     if (!g_facialSystem) return;
     
     glm::mat4 model = glm::mat4(1.0f);
@@ -1183,5 +2221,43 @@ void facial_draw_mesh(unsigned int meshHandle,
                              glm::vec4(r, g, b, a));
 }
 
+unsigned int facial_create_instance() {
+    EDEN_PROFILE_API();
+    if (!g_facialSystem) return facial::INVALID_FACIAL_INSTANCE;
+    return g_facialSystem->createInstance();
+}
+
+void facial_destroy_instance(unsigned int instance) {
+    EDEN_PROFILE_API();
+    if (g_facialSystem) g_facialSystem->destroyInstance(instance);
+}
+
+void facial_set_instance_slider(unsigned int instance, int index, float weight) {
+    EDEN_PROFILE_API();
+    if (g_facialSystem) g_facialSystem->setInstanceSliderWeight(instance, index, weight);
+}
+
+void facial_set_instance_transform(unsigned int instance, const float* mat4) {
+    EDEN_PROFILE_API();
+    if (g_facialSystem && mat4) {
+        glm::mat4 model;
+        memcpy(&model, mat4, sizeof(glm::mat4));
+        g_facialSystem->setInstanceTransform(instance, model);
+    }
+}
+
+void facial_play_instance_animation(unsigned int instance, int clipIndex, int loop) {
+    EDEN_PROFILE_API();
+    if (g_facialSystem) g_facialSystem->playInstanceAnimation(instance, clipIndex, loop != 0);
+}
+
+void facial_draw_instances(unsigned int meshHandle, const unsigned int* instances, unsigned int count,
+                           unsigned int baseTexture) {
+    EDEN_PROFILE_API();
+    if (!g_facialSystem) return;
+    g_facialSystem->drawInstances(static_cast<vkcore::MeshHandle>(meshHandle), instances, count,
+                                  static_cast<vkcore::TextureHandle>(baseTexture));
+}
+
 } // extern "C"
 
@@ -3,6 +3,24 @@
 // ============================================================================
 // Manages DMap textures, slider weights, and shader binding for facial animation.
 // Works with VulkanCore to provide GPU-accelerated vertex displacement.
+//
+// Whenever the effective slider weights change, a compute pass in a
+// VulkanCore compute prologue (shaders/dmap_blend.comp, on the async
+// compute queue when there is one) sums the active
+// sliders' DMaps into one composite displacement map, so the vertex shader
+// does one fetch however many sliders are in use. Unchanged weights cost
+// no GPU work at all.
+//
+// Crowds: createInstance() gives each face its own slider weights, clip and
+// transform on top of the shared DMaps and slider setup. drawInstances()
+// draws every face that shares a mesh in one instanced draw - their sparse
+// DMap lists go into a per-frame SSBO and dmap_mesh_instanced.vert blends
+// them straight from the DMap array - and updateAnimation() advances all
+// playing instances in the same pass as the main state.
+//
+// DMaps live on the GPU as layers of one texture array (XY and Z planes,
+// BC5 + BC4 when the error allows it; see dmap_compress.h), rebuilt from
+// the CPU copies on the frame after DMaps are loaded.
 // ============================================================================
 
 #ifndef FACIAL_SYSTEM_H
@@ -10,6 +28,9 @@
 
 #include "facial_types.h"
 #include "../core/vulkan_core.h"
+#include "../core/handle_pool.h"
+#include "../core/gpu_skinning.h"
+#include "../core/draw_capture.h"
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
@@ -58,6 +79,18 @@ public:
     const DMapTexture* getDMap(int index) const;
     int getDMapCount() const { return static_cast<int>(m_dmaps.size()); }
     
+    // Where loadDMapFromMemory() caches padded DMaps (must exist; "" = off)
+    void setDMapCacheDirectory(const std::string& directory) { m_dmapCacheDirectory = directory; }
+    const std::string& getDMapCacheDirectory() const { return m_dmapCacheDirectory; }
+    
+    // Compress the DMap array (BC5 + BC4) if the device supports BC and no
+    // layer's error exceeds `maxError` 8-bit steps; otherwise it is R8G8 +
+    // R8. Negative = never compress. Applies from the next frame.
+    void setDMapCompression(float maxError);
+    float getDMapCompression() const { return m_dmapMaxError; }
+    bool isDMapArrayCompressed() const { return m_dmapArrayCompressed; }
+    size_t getDMapArrayBytes() const { return m_dmapArrayBytes; }  // Both planes, all layers
+    
     // ========================================================================
     // Slider Control
     // ========================================================================
@@ -93,7 +126,7 @@ public:
     // Animation
     // ========================================================================
     
-    // Load an animation clip
+    // Load an animation clip (compiled into per-slider curves on load)
     int loadAnimation(const FacialAnimationClip& clip);
     
     // Play an animation
@@ -106,6 +139,29 @@ public:
     // Check if animation is playing
     bool isAnimationPlaying() const { return m_animationPlaying; }
     
+    // ========================================================================
+    // Instances (crowds)
+    // ========================================================================
+    
+    // Independent expression state; weights are clamped to the shared
+    // slider ranges. Returns INVALID_FACIAL_INSTANCE when the pool is full.
+    FacialInstanceHandle createInstance(const glm::mat4& model = glm::mat4(1.0f),
+                                        const glm::vec4& color = glm::vec4(1.0f));
+    void destroyInstance(FacialInstanceHandle instance);
+    bool isValidInstance(FacialInstanceHandle instance) const { return m_instances.get(instance) != nullptr; }
+    uint32_t getInstanceCount() const { return m_instances.size(); }
+    
+    void setInstanceTransform(FacialInstanceHandle instance, const glm::mat4& model);
+    void setInstanceColor(FacialInstanceHandle instance, const glm::vec4& color);
+    void setInstanceSliderWeight(FacialInstanceHandle instance, int index, float weight);
+    float getInstanceSliderWeight(FacialInstanceHandle instance, int index) const;
+    void setInstanceSliderWeights(FacialInstanceHandle instance, const float* weights, int count);
+    void applyPresetToInstance(FacialInstanceHandle instance, const std::string& name);
+    
+    // Per-instance clips, advanced by updateAnimation()
+    void playInstanceAnimation(FacialInstanceHandle instance, int clipIndex, bool loop = false);
+    void stopInstanceAnimation(FacialInstanceHandle instance);
+    
     // ========================================================================
     // Rendering
     // ========================================================================
@@ -129,7 +185,29 @@ public:
     void setDebugMode(bool enabled);
     bool getDebugMode() const { return m_debugMode; }
     
-    // Set base texture (call before bind() to update descriptor set)
+    // Displace vertices on the GPU from the composite DMap (default on).
+    // Turn off for meshes that are already displaced on the CPU.
+    void setGpuDisplacement(bool enabled) { m_gpuDisplacement = enabled; }
+    bool getGpuDisplacement() const { return m_gpuDisplacement; }
+    
+    // Composite rebuilds so far - one per change of the active weights,
+    // not one per frame
+    uint32_t getCompositeUpdateCount() const { return m_compositeUpdates; }
+    
+    // Skinned characters: GpuSkinning adds the composite to the instance's
+    // bind pose before skinning (where the DMaps were authored), and
+    // drawMesh() skips its own fetch for skinning.getMesh(instance). Shared
+    // weights only - drawInstances() expressions don't reach the skinning
+    // pass. Detach before destroying the instance or shutting the
+    // GpuSkinning down; shutdown() detaches whatever is left.
+    void attachSkinnedMesh(vkcore::GpuSkinning& skinning, vkcore::SkinInstanceHandle instance);
+    void detachSkinnedMesh(vkcore::GpuSkinning& skinning, vkcore::SkinInstanceHandle instance);
+    
+    // The composite as a displacement source (no texture while no slider
+    // contributes); version follows getCompositeUpdateCount()
+    vkcore::SkinDisplacement getCompositeDisplacement() const;
+    
+    // Set the base texture used when drawMesh() gets no texture (INVALID = default)
     void setBaseTexture(vkcore::TextureHandle texture);
     
     // Draw a mesh with DMap displacement
@@ -139,9 +217,39 @@ public:
                   vkcore::TextureHandle baseTexture = vkcore::INVALID_TEXTURE,
                   const glm::vec4& color = glm::vec4(1.0f));
     
+    // Draw `count` instances of one mesh in a single instanced draw, each
+    // with its own transform, color and expression (call after bind(); the
+    // view/projection come from setViewMatrix/setProjectionMatrix). Stale
+    // handles are skipped. Main thread only: inside a recordParallel task,
+    // or without dmap_mesh_instanced.vert.spv, each instance is drawn with
+    // drawMesh() and the shared weights instead.
+    void drawInstances(vkcore::MeshHandle mesh, const FacialInstanceHandle* instances, uint32_t count,
+                       vkcore::TextureHandle baseTexture = vkcore::INVALID_TEXTURE);
+    
+    // ========================================================================
+    // Draw Capture (VulkanCore::beginCapture)
+    // ========================================================================
+    // With CoreConfig::captureResources every loaded DMap (padded) is kept
+    // as a capture resource. While a capture records, bind() adds the
+    // slider setup and weights, strength, base texture and matrices, and
+    // drawMesh/drawInstances add their calls with each instance's
+    // transform, color and weights. Animation clips and presets aren't
+    // captured: their result, the weights, is.
+    
+    static constexpr uint32_t CAPTURE_TAG = vkcore::captureTag("FACE");
+    
+    // Loads a CAPTURE_TAG resource as a DMap (after init(); in capture
+    // order, so DMap indices match)
+    bool replayCaptureResource(vkcore::CaptureReader& resource);
+    // Runs one CAPTURE_TAG command; the instances it creates are tracked
+    // in remap.objects
+    bool replayCapture(vkcore::CaptureReader& command, vkcore::CaptureRemap& remap);
+    
 private:
-    // Create shader pipeline
+    // Create shader pipelines (the instanced one is optional)
     bool createDMapPipeline();
+    bool createInstancedPipeline();
+    bool createDMapPipelineVariant(const char* vertPath, VkPipelineLayout layout, VkPipeline& outPipeline);
     
     // Create UBO for slider weights
     bool createFacialResources();
@@ -149,6 +257,27 @@ private:
     // Upload UBO data to GPU
     void updateGPUBuffer();
     
+    // DMap compositing (optional - without dmap_blend.comp.spv meshes
+    // are drawn undisplaced, as before)
+    bool createBlendPipeline();
+    bool ensureComposite(uint32_t width, uint32_t height);
+    void destroyComposite();
+    
+    // Compute prologue: rebuild the composite if the blend list changed
+    void blendDMaps(VkCommandBuffer cmd);
+    
+    // (Re)build the DMap array after loads or a compression change; the
+    // old images are retired through deferDestroy()
+    struct DMapArrayImage;
+    bool ensureDMapArray();
+    void destroyDMapArray();
+    bool createDMapArrayImage(VkFormat format, uint32_t layers, DMapArrayImage& out);
+    
+    // Room for `count` more faces in this frame's instance SSBO (a full
+    // buffer is replaced by a bigger one; draws already recorded keep
+    // reading the old one until the frame retires)
+    bool reserveInstances(uint32_t count);
+    
     // DMap preprocessing
     void padDMapSeams(uint8_t* pixels, uint32_t width, uint32_t height, int channels, 
                      int paddingRadius = 3, float maxBlendFactor = 0.7f, int passes = 2);
@@ -162,9 +291,39 @@ private:
     
     // DMap textures
     std::vector<DMapTexture> m_dmaps;
-    std::vector<vkcore::TextureHandle> m_dmapHandles;  // GPU texture handles
+    std::string m_dmapCacheDirectory;  // Padded DMap cache (off by default)
     vkcore::TextureHandle m_neutralDMapTexture = vkcore::INVALID_TEXTURE;  // Neutral grey (128,128,128) for default binding
     
+    // DMap array: layer i = m_dmaps[i]; blend lists and instance records
+    // hold layer indices. Cached BC blocks spare re-encoding unchanged
+    // layers when the array grows.
+    struct DMapArrayImage {
+        VkImage image = VK_NULL_HANDLE;
+        vkcore::GpuAllocation alloc;
+        VkImageView view = VK_NULL_HANDLE;
+    };
+    struct DMapLayerBlocks {
+        uint32_t width = 0;               // Layer size the blocks were encoded at
+        uint32_t height = 0;
+        std::vector<uint8_t> xy;          // BC5
+        std::vector<uint8_t> z;           // BC4
+        uint32_t maxError = 0;            // 8-bit steps
+    };
+    DMapArrayImage m_dmapArrayXY;         // BC5 or R8G8
+    DMapArrayImage m_dmapArrayZ;          // BC4 or R8
+    VkSampler m_dmapArraySampler = VK_NULL_HANDLE;
+    std::vector<DMapLayerBlocks> m_dmapLayerBlocks;
+    uint32_t m_dmapArrayWidth = 0;
+    uint32_t m_dmapArrayHeight = 0;
+    size_t m_dmapArrayBytes = 0;
+    float m_dmapMaxError = DEFAULT_DMAP_MAX_ERROR;
+    bool m_dmapArrayCompressed = false;
+    bool m_dmapArrayDirty = true;         // m_dmaps changed since the last build
+    uint64_t m_dmapArrayFrame = 0;        // VulkanCore frame number of the last build
+    
+    // Base texture whose heap slot is pushed with every draw
+    vkcore::TextureHandle m_baseTexture = vkcore::INVALID_TEXTURE;  // Touched per bind() (memory budget LRU)
+    
     // Sliders
     std::array<FacialSlider, MAX_SLIDERS> m_sliders;
     float m_globalStrength = 1.0f;
@@ -176,6 +335,7 @@ private:
     // Animation
     std::vector<FacialAnimationClip> m_animationClips;
     int m_currentClipIndex = -1;
+    FacialClipCursor m_animationCursor;
     float m_animationTime = 0.0f;
     bool m_animationPlaying = false;
     bool m_animationLoop = false;
@@ -188,16 +348,80 @@ private:
     VkPipeline m_pipeline = VK_NULL_HANDLE;
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
     VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
-    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
     VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
     VkBuffer m_uboBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory m_uboMemory = VK_NULL_HANDLE;
+    vkcore::GpuAllocation m_uboAlloc;
     
     // Pipeline handle (for compatibility)
     vkcore::PipelineHandle m_dmapPipeline = vkcore::INVALID_PIPELINE;
     
+    // Composite DMap (RGBA16F, object-space offsets) and the compute pass
+    // that writes it; one blend list UBO + set per frame in flight
+    struct BlendFrame {
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkBuffer ubo = VK_NULL_HANDLE;
+        vkcore::GpuAllocation uboAlloc;
+        bool setStale = true;  // Composite replaced since the set was written
+    };
+    std::vector<BlendFrame> m_blendFrames;
+    VkPipeline m_blendPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout m_blendPipelineLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_blendSetLayout = VK_NULL_HANDLE;
+    uint32_t m_blendPrologue = 0;
+    
+    VkImage m_compositeImage = VK_NULL_HANDLE;
+    vkcore::GpuAllocation m_compositeAlloc;
+    VkImageView m_compositeView = VK_NULL_HANDLE;
+    VkSampler m_compositeSampler = VK_NULL_HANDLE;
+    uint32_t m_compositeWidth = 0;
+    uint32_t m_compositeHeight = 0;
+    uint32_t m_compositeIndex = vkcore::BindlessHeap::INVALID_INDEX;  // Bindless heap slot
+    
+    DMapBlendUBO m_blendList;         // What the composite currently holds
+    bool m_compositeValid = false;    // m_blendList matches the image
+    bool m_compositeActive = false;   // Some slider contributes
+    bool m_gpuDisplacement = true;
+    uint32_t m_compositeUpdates = 0;
+    
+    // attachSkinnedMesh(): displaced in the skinning pass, not by drawMesh()
+    struct SkinnedAttachment {
+        vkcore::GpuSkinning* skinning = nullptr;
+        vkcore::SkinInstanceHandle instance = vkcore::INVALID_SKIN_INSTANCE;
+    };
+    std::unordered_map<vkcore::MeshHandle, SkinnedAttachment> m_skinnedMeshes;
+    
+    // Instances and the per-frame SSBO drawInstances() appends them to
+    struct FacialInstance {
+        std::array<float, MAX_SLIDERS> weights = {};
+        glm::mat4 model = glm::mat4(1.0f);
+        glm::vec4 color = glm::vec4(1.0f);
+        int clipIndex = -1;
+        FacialClipCursor cursor;
+        float time = 0.0f;
+        bool playing = false;
+        bool loop = false;
+    };
+    struct InstanceFrame {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        vkcore::GpuAllocation alloc;
+        uint32_t capacity = 0;  // In GpuFaceInstance records
+    };
+    vkcore::HandlePool<FacialInstance> m_instances;
+    std::vector<InstanceFrame> m_instanceFrames;
+    uint32_t m_instanceHead = 0;           // Records used this frame
+    uint64_t m_instanceFrameNumber = 0;    // Frame m_instanceHead belongs to
+    VkPipeline m_instancedPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout m_instancedPipelineLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_instanceSetLayout = VK_NULL_HANDLE;
+    std::vector<glm::mat4> m_instanceModels;  // drawInstances() scratch for LOD selection
+    
     // UBO data
     FacialUBO m_uboData;
+    
+    // Draw capture
+    vkcore::DrawCapture* recordingCapture() const;
+    void captureState(vkcore::DrawCapture& capture);
+    void replayState(vkcore::CaptureReader& in, vkcore::CaptureRemap& remap);
 };
 
 } // namespace facial
@@ -243,6 +467,15 @@ void facial_draw_mesh(unsigned int meshHandle,
                       unsigned int baseTexture,
                       float r, float g, float b, float a);
 
+// Instances
+unsigned int facial_create_instance();
+void facial_destroy_instance(unsigned int instance);
+void facial_set_instance_slider(unsigned int instance, int index, float weight);
+void facial_set_instance_transform(unsigned int instance, const float* mat4);
+void facial_play_instance_animation(unsigned int instance, int clipIndex, int loop);
+void facial_draw_instances(unsigned int meshHandle, const unsigned int* instances, unsigned int count,
+                           unsigned int baseTexture);
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <cstdint>
 
 namespace facial {
 
@@ -22,6 +23,7 @@ namespace facial {
 constexpr int MAX_SLIDERS = 32;           // Maximum number of active facial sliders
 constexpr int MAX_DMAP_TEXTURES = 16;     // Maximum DMap textures in atlas
 constexpr float DEFAULT_DISP_STRENGTH = 0.05f;  // Default displacement strength (5cm max)
+constexpr float DEFAULT_DMAP_MAX_ERROR = 4.0f;  // BC-compressed DMap error allowed, in 8-bit steps
 
 // ============================================================================
 // DMap Texture (Displacement Map)
@@ -108,6 +110,83 @@ struct FacialUBO {
 // Actually: 8 vec4s for 32 weights + 1 vec4 settings = 9 * 16 = 144 bytes
 static_assert(sizeof(FacialUBO) == 144, "FacialUBO size mismatch - check alignment");
 
+// ============================================================================
+// DMap Mesh Push Constants
+// ============================================================================
+// Must match the push block in dmap_mesh.vert / dmap_mesh.frag. Textures are
+// slots in the VulkanCore bindless heap (VulkanCore::getBindlessIndex).
+
+struct FacialPushConstants {
+    glm::mat4 model;
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 color;
+    uint32_t dmapIndex;     // Composite DMap (or neutral grey until one is loaded)
+    uint32_t baseIndex;     // Base color texture
+    uint32_t displace;      // 1 = offset vertices by the composite at UV1
+    uint32_t padding;
+};
+
+static_assert(sizeof(FacialPushConstants) == 224, "FacialPushConstants size mismatch - check alignment");
+
+// ============================================================================
+// DMap Blend List (GPU-side)
+// ============================================================================
+// Uniform buffer for dmap_blend.comp: the DMaps of the active sliders, each
+// with its final scale, summed into one composite displacement map. Packed
+// like FacialUBO (entry i = slots[i / 4][i % 4]); unused entries stay zero
+// so two lists compare equal with memcmp.
+
+struct DMapBlendUBO {
+    glm::uvec4 info;                        // x = active DMaps, y/z = composite size
+    glm::uvec4 slots[MAX_SLIDERS / 4];      // DMap array layer per active DMap
+    glm::vec4 scales[MAX_SLIDERS / 4];      // weight * globalStrength * maxDisplacement
+    
+    DMapBlendUBO() {
+        info = glm::uvec4(0);
+        for (int i = 0; i < MAX_SLIDERS / 4; ++i) {
+            slots[i] = glm::uvec4(0);
+            scales[i] = glm::vec4(0.0f);
+        }
+    }
+    
+    void add(uint32_t slot, float scale) {
+        uint32_t i = info.x;
+        if (i >= static_cast<uint32_t>(MAX_SLIDERS)) return;
+        slots[i / 4][i % 4] = slot;
+        scales[i / 4][i % 4] = scale;
+        info.x++;
+    }
+};
+
+static_assert(sizeof(DMapBlendUBO) == 272, "DMapBlendUBO size mismatch - check alignment");
+
+// ============================================================================
+// Facial Instances (crowds)
+// ============================================================================
+// Independent expression states that share one FacialSystem's DMaps and
+// slider setup. Handles come from FacialSystem::createInstance(); stale
+// handles simply stop resolving.
+
+using FacialInstanceHandle = uint32_t;
+constexpr FacialInstanceHandle INVALID_FACIAL_INSTANCE = UINT32_MAX;
+
+// DMaps blended per face by dmap_mesh_instanced.vert; if more sliders are
+// active, the strongest ones are kept
+constexpr int MAX_INSTANCE_DMAPS = 8;
+
+// One face in the instance SSBO (std430), indexed by gl_InstanceIndex.
+// Must match FaceInstance in dmap_mesh_instanced.vert.
+struct GpuFaceInstance {
+    glm::mat4 model;
+    glm::vec4 color;
+    glm::uvec4 info;                                // x = active DMaps
+    glm::uvec4 slots[MAX_INSTANCE_DMAPS / 4];       // DMap array layer of entry i in slots[i / 4][i % 4]
+    glm::vec4 scales[MAX_INSTANCE_DMAPS / 4];       // weight * globalStrength * maxDisplacement
+};
+
+static_assert(sizeof(GpuFaceInstance) == 160, "GpuFaceInstance size mismatch - check alignment");
+
 // ============================================================================
 // Facial Animation Keyframe
 // ============================================================================
@@ -118,10 +197,37 @@ struct FacialKeyframe {
     std::array<float, MAX_SLIDERS> weights = {};  // Slider weights at this keyframe
 };
 
+// ============================================================================
+// Facial Animation Curves
+// ============================================================================
+// Compact clip storage built by FacialAnimationClip::compile(): one curve per
+// slider that is ever non-zero, holding only the keys a straight line between
+// its neighbours can't reproduce. All curves share one key array.
+
+struct FacialCurveKey {
+    float time = 0.0f;
+    float value = 0.0f;
+};
+
+struct FacialCurve {
+    int slider = -1;
+    uint32_t firstKey = 0;            // Into FacialAnimationClip::curveKeys
+    uint32_t keyCount = 0;            // 1 = constant
+};
+
+// Per-player lookup hint: the segment each curve was last evaluated in.
+// Sequential playback finds its segment in O(1); jumps fall back to a
+// binary search. Reset it (= {}) when a player switches clips.
+struct FacialClipCursor {
+    std::array<uint32_t, MAX_SLIDERS> segments = {};  // Indexed like FacialAnimationClip::curves
+};
+
 // ============================================================================
 // Facial Animation Clip
 // ============================================================================
-// Sequence of keyframes for animating facial expressions
+// Sequence of keyframes for animating facial expressions. Author with
+// `keyframes`; FacialSystem::loadAnimation() compiles them into curves and
+// drops them. Both forms evaluate in O(log n).
 
 struct FacialAnimationClip {
     std::string name;
@@ -129,8 +235,24 @@ struct FacialAnimationClip {
     float duration = 0.0f;            // Total duration in seconds
     bool loop = false;                // Whether to loop the animation
     
+    // Compiled form (valid when `compiled`)
+    std::vector<FacialCurve> curves;
+    std::vector<FacialCurveKey> curveKeys;
+    bool compiled = false;
+    
+    // Build the curves from `keyframes` (sorted by time) and release them.
+    // Keys within `tolerance` of the line through their kept neighbours
+    // are dropped.
+    void compile(float tolerance = 1e-4f);
+    
+    // Bytes held by keyframes and curves
+    size_t getMemoryUsage() const;
+    
     // Get interpolated weights at a given time
     void getWeightsAtTime(float time, std::array<float, MAX_SLIDERS>& outWeights) const;
+    
+    // Same, reusing and updating `cursor` (compiled clips; others ignore it)
+    void getWeightsAtTime(float time, std::array<float, MAX_SLIDERS>& outWeights, FacialClipCursor& cursor) const;
 };
 
 // ============================================================================
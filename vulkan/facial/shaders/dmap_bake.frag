@@ -0,0 +1,19 @@
+#version 450
+
+// ============================================================================
+// DMAP BAKE FRAGMENT SHADER
+// ============================================================================
+// Writes the interpolated displacement (-1..1) with alpha = 1 as coverage;
+// texels no triangle touches keep the clear alpha of 0 and are filled by
+// dmap_bake_dilate.comp.
+//
+// Compile: glslc dmap_bake.frag -o dmap_bake.frag.spv
+// ============================================================================
+
+layout(location = 0) in vec3 fragDisplacement;
+
+layout(location = 0) out vec4 outDisplacement;  // RGBA16F bake target
+
+void main() {
+    outDisplacement = vec4(fragDisplacement, 1.0);
+}
@@ -0,0 +1,28 @@
+#version 450
+
+// ============================================================================
+// DMAP BAKE VERTEX SHADER - Painted displacement rasterized in UV1 space
+// ============================================================================
+// For FacialPainter::bakeDMapAsync(). Each vertex is placed at its UV1
+// coordinate, so the rasterizer interpolates painted displacement across
+// every triangle of the DMap. V is flipped to match the CPU bake (row 0 of
+// the image is v = 1).
+//
+// Compile: glslc dmap_bake.vert -o dmap_bake.vert.spv
+// ============================================================================
+
+layout(location = 0) in vec2 inUV1;
+layout(location = 1) in vec3 inDisplacement;  // World units
+
+layout(location = 0) out vec3 fragDisplacement;  // -1..1
+
+// Must match BakePushConstants in facial_painter.cpp
+layout(push_constant) uniform BakePush {
+    float invMaxDisplacement;
+} push;
+
+void main() {
+    vec2 uv = vec2(inUV1.x, 1.0 - inUV1.y);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+    fragDisplacement = clamp(inDisplacement * push.invMaxDisplacement, -1.0, 1.0);
+}
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // ============================================================================
 // DMAP MESH FRAGMENT SHADER - Basic Lit Rendering
@@ -12,12 +13,13 @@ layout(location = 0) in vec3 fragWorldPos;
 layout(location = 1) in vec3 fragNormal;
 layout(location = 2) in vec2 fragTexCoord;  // UV0
 layout(location = 3) in vec2 fragTexCoord1; // UV1 - for debug visualization
+layout(location = 4) in vec4 fragColor;     // Object color (per instance in dmap_mesh_instanced.vert)
 
 // Output color
 layout(location = 0) out vec4 outColor;
 
-// Base color texture (sampled with UV0)
-layout(binding = 2) uniform sampler2D baseTexture;
+// VulkanCore bindless texture heap - base color sampled with UV0
+layout(set = 1, binding = 0) uniform sampler2D textures[];
 
 // Facial UBO - for debug mode
 layout(binding = 0) uniform FacialUBO {
@@ -30,7 +32,9 @@ layout(push_constant) uniform PushConstants {
     mat4 model;
     mat4 view;
     mat4 projection;
-    vec4 objectColor;
+    vec4 objectColor;  // Passed on by the vertex shader as fragColor
+    uint dmapIndex;    // Heap slot of the composite DMap
+    uint baseIndex;    // Heap slot of the base color texture
 } push;
 
 // Simple directional light (hardcoded for now)
@@ -63,8 +67,8 @@ void main() {
     
     // Normal rendering mode
     // Sample base texture
-    vec4 texColor = texture(baseTexture, fragTexCoord);
-    vec3 baseColor = texColor.rgb * push.objectColor.rgb;
+    vec4 texColor = texture(textures[push.baseIndex], fragTexCoord);
+    vec3 baseColor = texColor.rgb * fragColor.rgb;
     
     // Normalize inputs
     vec3 N = normalize(fragNormal);
@@ -86,6 +90,6 @@ void main() {
     // Final color
     vec3 result = ambient + diffuse + specular;
     
-    outColor = vec4(result, texColor.a * push.objectColor.a);
+    outColor = vec4(result, texColor.a * fragColor.a);
 }
 
@@ -1,11 +1,13 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // ============================================================================
 // DMAP MESH VERTEX SHADER - Facial Animation with UV1 Displacement
 // ============================================================================
-// Samples a DMap texture using UV1 coordinates to displace vertices.
-// RGB channels of DMap encode XYZ displacement deltas (-1 to 1 range).
-// Slider weights control the strength of each displacement.
+// Samples the composite DMap using UV1 coordinates to displace vertices.
+// dmap_blend.comp has already decoded, weighted and summed every active
+// slider's DMap into it (RGB = object-space XYZ offset), so this is one
+// fetch regardless of how many sliders are active.
 // ============================================================================
 
 // Vertex inputs (POSITION_NORMAL_UV0_UV1 format)
@@ -19,6 +21,7 @@ layout(location = 0) out vec3 fragWorldPos;
 layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec2 fragTexCoord;  // UV0
 layout(location = 3) out vec2 fragTexCoord1; // UV1 - for debug visualization
+layout(location = 4) out vec4 fragColor;     // Object color
 
 // Maximum sliders (must match C++ MAX_SLIDERS / 4)
 #define MAX_SLIDER_VECS 8
@@ -29,8 +32,8 @@ layout(binding = 0) uniform FacialUBO {
     vec4 settings;                   // x = globalStrength, y = mirrorThreshold, z = hasDMap (1.0 if loaded)
 } facial;
 
-// DMap texture (sampled in vertex shader!)
-layout(binding = 1) uniform sampler2D dmapTexture;
+// VulkanCore bindless texture heap - DMap is sampled in the vertex shader!
+layout(set = 1, binding = 0) uniform sampler2D textures[];
 
 // Push constants for per-object data
 layout(push_constant) uniform PushConstants {
@@ -38,88 +41,33 @@ layout(push_constant) uniform PushConstants {
     mat4 view;
     mat4 projection;
     vec4 objectColor;
+    uint dmapIndex;    // Heap slot of the composite DMap
+    uint baseIndex;    // Heap slot of the base color texture
+    uint displace;     // 1 = the composite is current (some slider active)
 } push;
 
-// Helper to get slider weight by index
-float getSliderWeight(int index) {
-    int vecIndex = index / 4;
-    int component = index % 4;
-    return facial.weights[vecIndex][component];
-}
-
 void main() {
     // Start with base position
     vec3 position = inPosition;
     vec3 normal = inNormal;
     
-    // Get slider weights
-    float slider0 = getSliderWeight(0);  // Jaw Open - for now, primary test slider
-    
-    float globalStrength = facial.settings.x;
-    float hasDMap = facial.settings.z;  // 1.0 if DMap is loaded, 0.0 otherwise
-    float maxDisplacement = 0.03;  // 3cm max displacement - balanced: visible but prevents separation
-    
     vec3 displacement = vec3(0.0);
     
-    // DMap MODE: Sample displacement from texture using UV1 coordinates
-    // DISABLED: Using CPU-side vertex welding instead
-    // Shader-side displacement causes cracking at UV seams
-    // CPU-side approach samples once per unique position and applies to all welded vertices
-    if (false && hasDMap > 0.5 && globalStrength > 0.001 && slider0 > 0.001) {
-        // Get UV1 coordinates for DMap sampling
+    // Composite MODE: the weighted sum of every active DMap, sampled at UV1.
+    // Seams stay closed as long as the DMaps were padded at load
+    // (FacialSystem::padDMapSeams); callers that weld on the CPU instead
+    // turn this off (setGpuDisplacement(false)).
+    if (push.displace != 0u && facial.settings.z > 0.5) {
         vec2 dmapUV = inTexCoord1;
         
-        // Safety check: If UV1 is invalid (all zeros or NaN), skip displacement entirely
-        // This prevents uniform displacement when UV1 data is missing or invalid
-        if (dmapUV.x == 0.0 && dmapUV.y == 0.0) {
-            // Invalid UV1 - no displacement
-            displacement = vec3(0.0);
-        } else if (isnan(dmapUV.x) || isnan(dmapUV.y) || isinf(dmapUV.x) || isinf(dmapUV.y)) {
-            // Invalid UV1 - no displacement
-            displacement = vec3(0.0);
-        } else {
-            // Valid UV1 - proceed with sampling
-            // Clamp UV to valid range (but allow full 0-1 range, just avoid edge artifacts)
-            dmapUV = clamp(dmapUV, vec2(0.0), vec2(1.0));
-            
-            // Sample displacement from DMap texture
-            // RGB encodes XYZ displacement: 0.5 = no displacement, 0 = -1, 1 = +1
-            vec4 dmapSample = texture(dmapTexture, dmapUV);
-            
-            // Convert from [0,1] to [-1,1] range
-            // RGB encodes XYZ displacement: 0.5 = no displacement, 0 = -1, 1 = +1
-            vec3 dmapDisplacement = dmapSample.rgb * 2.0 - 1.0;
-            
-            // Check if displacement is significant (at least one component > 0.08)
-            // Neutral grey (128,128,128) = 0.502 → (0.004) after conversion, well below 0.08
-            // Our test regions use 0.1-0.15, which convert to ~0.1-0.15, above 0.08
-            float absX = abs(dmapDisplacement.x);
-            float absY = abs(dmapDisplacement.y);
-            float absZ = abs(dmapDisplacement.z);
-            
-            // Only apply if at least one component is significant
-            // Threshold 0.08 allows our 0.1+ values while filtering neutral grey (~0.004)
-            if (absX > 0.08 || absY > 0.08 || absZ > 0.08) {
-                // Apply displacement along the sampled direction
-                // Scale by slider weight and global strength
-                displacement = dmapDisplacement * slider0 * globalStrength * maxDisplacement;
-            } else {
-                // Neutral grey or too small - no displacement
-                displacement = vec3(0.0);
-            }
+        // Missing UV1 (all zeros) or garbage: no displacement
+        bool validUV = !(dmapUV.x == 0.0 && dmapUV.y == 0.0) &&
+                       !any(isnan(dmapUV)) && !any(isinf(dmapUV));
+        if (validUV) {
+            displacement = textureLod(textures[push.dmapIndex], clamp(dmapUV, vec2(0.0), vec2(1.0)), 0.0).rgb;
         }
-    } else {
-        // No DMap loaded or slider inactive - no displacement
-        displacement = vec3(0.0);
     }
     
-    // FALLBACK: If no DMap loaded, use simple normal-based inflation (for testing)
-    // DISABLED - we don't want uniform displacement
-    // if (hasDMap < 0.5 && globalStrength > 0.001 && slider0 > 0.001) {
-    //     // Simple inflation along normals (visible feedback without DMap)
-    //     displacement = normal * slider0 * globalStrength * 0.05;
-    // }
-    
     // Apply displacement
     position += displacement;
     
@@ -143,6 +91,8 @@ void main() {
     // Pass through UV1 for debug visualization
     fragTexCoord1 = inTexCoord1;
     
+    fragColor = push.objectColor;
+    
     // Final clip-space position
     gl_Position = push.projection * push.view * worldPos;
     
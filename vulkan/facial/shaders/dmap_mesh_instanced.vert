@@ -0,0 +1,117 @@
+#version 450
+
+// ============================================================================
+// DMAP MESH INSTANCED VERTEX SHADER - Crowds of independently animated faces
+// ============================================================================
+// For FacialSystem::drawInstances(). Each instance reads its transform,
+// color and sparse DMap list from the instance SSBO (gl_InstanceIndex
+// already includes the draw's firstInstance) and blends up to
+// MAX_INSTANCE_DMAPS DMaps straight from the DMap array at UV1, decoded
+// and thresholded exactly like dmap_blend.comp. Pairs with dmap_mesh.frag.
+//
+// Compile: glslc dmap_mesh_instanced.vert -o dmap_mesh_instanced.vert.spv
+// ============================================================================
+
+// Vertex inputs (POSITION_NORMAL_UV0_UV1 format)
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord0;  // UV0 - standard texture coordinates
+layout(location = 3) in vec2 inTexCoord1;  // UV1 - DMap sampling coordinates
+
+// Outputs to fragment shader
+layout(location = 0) out vec3 fragWorldPos;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;  // UV0
+layout(location = 3) out vec2 fragTexCoord1; // UV1 - for debug visualization
+layout(location = 4) out vec4 fragColor;     // Instance color
+
+// Maximum sliders (must match C++ MAX_SLIDERS / 4) and DMaps per face
+// (MAX_INSTANCE_DMAPS / 4)
+#define MAX_SLIDER_VECS 8
+#define MAX_INSTANCE_VECS 2
+
+// Facial UBO - settings only (weights are per instance)
+layout(binding = 0) uniform FacialUBO {
+    vec4 weights[MAX_SLIDER_VECS];
+    vec4 settings;                   // x = globalStrength, y = mirrorThreshold, z = hasDMap (1.0 if loaded)
+} facial;
+
+// Must match facial::GpuFaceInstance (160 bytes)
+struct FaceInstance {
+    mat4 model;
+    vec4 color;
+    uvec4 info;                        // x = active DMaps
+    uvec4 slots[MAX_INSTANCE_VECS];    // DMap array layer of entry i in slots[i / 4][i % 4]
+    vec4 scales[MAX_INSTANCE_VECS];    // weight * globalStrength * maxDisplacement
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer FaceInstances {
+    FaceInstance faces[];
+};
+
+// Source DMaps, one layer each: XY and Z planes (BC5 + BC4 or RG8 + R8)
+layout(set = 2, binding = 1) uniform sampler2DArray dmapXY;
+layout(set = 2, binding = 2) uniform sampler2DArray dmapZ;
+
+// Same block as dmap_mesh.vert; only view, projection and baseIndex are used
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+    vec4 objectColor;
+    uint dmapIndex;
+    uint baseIndex;
+    uint displace;
+} push;
+
+// Neutral grey (128) decodes to ~0.004; painted regions start around 0.1
+const float NEUTRAL_THRESHOLD = 0.08;
+
+void main() {
+    FaceInstance face = faces[gl_InstanceIndex];
+    
+    vec3 position = inPosition;
+    vec3 displacement = vec3(0.0);
+    
+    if (facial.settings.z > 0.5) {
+        vec2 dmapUV = inTexCoord1;
+        
+        // Missing UV1 (all zeros) or garbage: no displacement
+        bool validUV = !(dmapUV.x == 0.0 && dmapUV.y == 0.0) &&
+                       !any(isnan(dmapUV)) && !any(isinf(dmapUV));
+        if (validUV) {
+            dmapUV = clamp(dmapUV, vec2(0.0), vec2(1.0));
+            for (uint i = 0; i < face.info.x; i++) {
+                vec3 coord = vec3(dmapUV, float(face.slots[i / 4][i % 4]));
+                vec3 d = vec3(textureLod(dmapXY, coord, 0.0).rg, textureLod(dmapZ, coord, 0.0).r) * 2.0 - 1.0;
+                if (any(greaterThan(abs(d), vec3(NEUTRAL_THRESHOLD)))) {
+                    displacement += d * face.scales[i / 4][i % 4];
+                }
+            }
+        }
+    }
+    
+    position += displacement;
+    
+    // Safety check: ensure position is valid (not NaN/Inf)
+    if (any(isnan(position)) || any(isinf(position))) {
+        position = inPosition;
+    }
+    
+    vec4 worldPos = face.model * vec4(position, 1.0);
+    fragWorldPos = worldPos.xyz;
+    
+    mat3 normalMatrix = transpose(inverse(mat3(face.model)));
+    fragNormal = normalize(normalMatrix * inNormal);
+    
+    fragTexCoord = inTexCoord0;
+    fragTexCoord1 = inTexCoord1;
+    fragColor = face.color;
+    
+    gl_Position = push.projection * push.view * worldPos;
+    
+    // Safety check: ensure clip position is valid
+    if (any(isnan(gl_Position))) {
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+    }
+}
@@ -2,13 +2,23 @@
 // Extracted from eden_vulkan_helpers.cpp for modularity
 
 #include "hdm_format.h"
+#include "../../stdlib/vfs.h"
+#include "../../stdlib/json_reader.h"
+#include "../../stdlib/job_system.h"
+#include "../core/handle_pool.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cstring>
+#include <mutex>
+
+#ifdef EDEN_USE_MESHOPT
+#include <meshoptimizer.h>
+#endif
 
 namespace eden {
 namespace hdm {
@@ -54,7 +64,7 @@ std::string base64Encode(const unsigned char* data, size_t len) {
     return ret;
 }
 
-std::vector<unsigned char> base64Decode(const std::string& encoded) {
+std::vector<unsigned char> base64Decode(std::string_view encoded) {
     int in_len = encoded.size();
     int i = 0;
     int j = 0;
@@ -96,81 +106,82 @@ std::vector<unsigned char> base64Decode(const std::string& encoded) {
 // JSON Parsing Utilities
 // ============================================================================
 
+// One-off lookups of `key` anywhere in `json`, first match in document
+// order. Each call parses the whole text: to read several keys, parse once
+// with JsonDocument (readPropertiesJson() below).
+static JsonValue jsonFindValue(JsonDocument& doc, const std::string& json, const std::string& key) {
+    return doc.parseView(json) ? doc.root().find(key) : JsonValue();
+}
+
 std::string jsonFindString(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return "";
-    
-    pos = json.find("\"", pos + searchKey.length());
-    if (pos == std::string::npos) return "";
-    pos++;
-    
-    size_t endPos = json.find("\"", pos);
-    if (endPos == std::string::npos) return "";
-    
-    return json.substr(pos, endPos - pos);
+    JsonDocument doc;
+    return std::string(jsonFindValue(doc, json, key).asString());
 }
 
 int jsonFindInt(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return 0;
-    
-    pos += searchKey.length();
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    
-    std::string numStr;
-    while (pos < json.length() && (isdigit(json[pos]) || json[pos] == '-')) {
-        numStr += json[pos++];
-    }
-    return numStr.empty() ? 0 : std::stoi(numStr);
+    JsonDocument doc;
+    return jsonFindValue(doc, json, key).asInt();
 }
 
 float jsonFindFloat(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return 0.0f;
-    
-    pos += searchKey.length();
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    
-    std::string numStr;
-    while (pos < json.length() && (isdigit(json[pos]) || json[pos] == '-' || 
-           json[pos] == '.' || json[pos] == 'e' || json[pos] == 'E' || json[pos] == '+')) {
-        numStr += json[pos++];
-    }
-    return numStr.empty() ? 0.0f : std::stof(numStr);
+    JsonDocument doc;
+    return jsonFindValue(doc, json, key).asFloat();
 }
 
 bool jsonFindBool(const std::string& json, const std::string& key) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return false;
-    
-    pos += searchKey.length();
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    
-    return json.substr(pos, 4) == "true";
+    JsonDocument doc;
+    return jsonFindValue(doc, json, key).asBool();
 }
 
 void jsonFindFloatArray(const std::string& json, const std::string& key, float* out, int count) {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return;
-    
-    pos = json.find("[", pos);
-    if (pos == std::string::npos) return;
-    pos++;
-    
-    for (int i = 0; i < count; i++) {
-        while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == ',')) pos++;
-        
-        std::string numStr;
-        while (pos < json.length() && (isdigit(json[pos]) || json[pos] == '-' || 
-               json[pos] == '.' || json[pos] == 'e' || json[pos] == 'E' || json[pos] == '+')) {
-            numStr += json[pos++];
+    JsonDocument doc;
+    jsonFindValue(doc, json, key).readFloats(out, static_cast<size_t>(std::max(count, 0)));
+}
+
+// Copy a string value into a fixed-size field; absent values leave it be
+static void jsonCopyString(JsonValue value, char* out, size_t size) {
+    if (!value.isString()) return;
+    std::string_view text = value.asString();
+    size_t length = std::min(text.size(), size - 1);
+    memcpy(out, text.data(), length);
+    out[length] = '\0';
+}
+
+// Properties from the object holding them ("properties" in .hdma files, the
+// root of properties-only files). Keys are found however the writer grouped
+// them ("item" or "item_properties"); absent keys keep their defaults.
+static void readPropertiesJson(JsonValue source, HDMProperties& props) {
+    jsonCopyString(source.find("hdm_version"), props.hdm_version, sizeof(props.hdm_version));
+
+    jsonCopyString(source.find("obj_path"), props.model.obj_path, sizeof(props.model.obj_path));
+    jsonCopyString(source.find("texture_path"), props.model.texture_path, sizeof(props.model.texture_path));
+    source.find("scale").readFloats(props.model.scale, 3);
+    source.find("origin_offset").readFloats(props.model.origin_offset, 3);
+
+    props.item.item_type_id = source.find("item_type_id").asInt(props.item.item_type_id);
+    jsonCopyString(source.find("item_name"), props.item.item_name, sizeof(props.item.item_name));
+    props.item.trade_value = source.find("trade_value").asInt(props.item.trade_value);
+    props.item.condition = source.find("condition").asFloat(props.item.condition);
+    props.item.weight = source.find("weight").asFloat(props.item.weight);
+    props.item.category = source.find("category").asInt(props.item.category);
+    props.item.is_salvaged = source.find("is_salvaged").asBool(props.item.is_salvaged);
+    props.item.mesh_class = source.find("mesh_class").asInt(props.item.mesh_class);
+
+    props.physics.collision_type = source.find("collision_type").asInt(props.physics.collision_type);
+    source.find("collision_bounds").readFloats(props.physics.collision_bounds, 3);
+    props.physics.is_static = source.find("is_static").asBool(props.physics.is_static);
+    props.physics.mass = source.find("mass").asFloat(props.physics.mass);
+
+    JsonValue points = source.find("control_points");
+    if (points.isArray()) {
+        int count = 0;
+        for (JsonValue point : points) {
+            if (count == 8) break;
+            jsonCopyString(point["name"], props.control_points[count].name, sizeof(props.control_points[count].name));
+            point["position"].readFloats(props.control_points[count].position, 3);
+            count++;
         }
-        if (!numStr.empty()) out[i] = std::stof(numStr);
+        props.num_control_points = count;
     }
 }
 
@@ -193,12 +204,430 @@ void initDefaultProperties(HDMProperties& props) {
     props.num_control_points = 0;
 }
 
+// ============================================================================
+// Geometry Encoding
+// ============================================================================
+
+// Round-to-nearest-even float -> IEEE half; out-of-range values become inf
+static uint16_t floatToHalf(float value) {
+    const uint32_t f32Infinity = 255u << 23;
+    const uint32_t f16Limit = (127u + 16u) << 23;
+    const uint32_t denormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+    uint16_t half;
+    if (bits >= f16Limit) {
+        half = bits > f32Infinity ? 0x7e00 : 0x7c00;
+    } else if (bits < (113u << 23)) {
+        float f, magic;
+        memcpy(&f, &bits, sizeof(f));
+        memcpy(&magic, &denormMagic, sizeof(magic));
+        f += magic;
+        memcpy(&bits, &f, sizeof(bits));
+        half = static_cast<uint16_t>(bits - denormMagic);
+    } else {
+        uint32_t mantissaOdd = (bits >> 13) & 1u;
+        bits += (uint32_t(15 - 127) << 23) + 0xfffu + mantissaOdd;
+        half = static_cast<uint16_t>(bits >> 13);
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+// Branch-free so the unpack loop doesn't stall on texcoord values
+static inline float halfToFloat(uint16_t half) {
+    const uint32_t shiftedExponent = 0x7c00u << 13;
+    const uint32_t magicBits = 113u << 23;
+    uint32_t bits = (half & 0x7fffu) << 13;
+    uint32_t exponent = bits & shiftedExponent;
+    bits += (127u - 15u) << 23;
+    bits += exponent == shiftedExponent ? (128u - 16u) << 23 : 0u;  // Inf / NaN
+    bool denormal = exponent == 0;
+    bits += denormal ? 1u << 23 : 0u;                               // Renormalized below
+    float value, magic;
+    memcpy(&value, &bits, sizeof(value));
+    memcpy(&magic, &magicBits, sizeof(magic));
+    value -= denormal ? magic : 0.0f;
+    uint32_t result;
+    memcpy(&result, &value, sizeof(result));
+    result |= uint32_t(half & 0x8000u) << 16;
+    memcpy(&value, &result, sizeof(value));
+    return value;
+}
+
+static int16_t toSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::max(-1.0f, std::min(1.0f, value)) * 32767.0f));
+}
+
+static void encodeOctahedral(const float normal[3], int16_t out[2]) {
+    float l1 = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    if (!(l1 > 0.0f)) {
+        out[0] = out[1] = 0;                 // Degenerate: decodes as +Z
+        return;
+    }
+    float x = normal[0] / l1, y = normal[1] / l1;
+    if (normal[2] < 0.0f) {
+        float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+    out[0] = toSnorm16(x);
+    out[1] = toSnorm16(y);
+}
+
+static inline void decodeOctahedral(const int16_t in[2], float normal[3]) {
+    float x = in[0] * (1.0f / 32767.0f), y = in[1] * (1.0f / 32767.0f);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    float scale = 1.0f / std::sqrt(x * x + y * y + z * z);
+    normal[0] = x * scale;
+    normal[1] = y * scale;
+    normal[2] = z * scale;
+}
+
+static HDMQuantization computeQuantization(const std::vector<HDMVertex>& vertices) {
+    HDMQuantization quant = {};
+    if (vertices.empty()) return quant;
+    for (int axis = 0; axis < 3; axis++) {
+        float lo = vertices[0].position[axis], hi = lo;
+        for (const HDMVertex& v : vertices) {
+            lo = std::min(lo, v.position[axis]);
+            hi = std::max(hi, v.position[axis]);
+        }
+        quant.position_min[axis] = lo;
+        quant.position_scale[axis] = (hi - lo) / 65535.0f;
+    }
+    return quant;
+}
+
+static HDMPackedVertex packVertex(const HDMVertex& v, const HDMQuantization& quant) {
+    HDMPackedVertex packed = {};
+    for (int axis = 0; axis < 3; axis++) {
+        float scale = quant.position_scale[axis];
+        float q = scale > 0.0f ? (v.position[axis] - quant.position_min[axis]) / scale : 0.0f;
+        packed.position[axis] = static_cast<uint16_t>(std::lround(std::max(0.0f, std::min(65535.0f, q))));
+    }
+    encodeOctahedral(v.normal, packed.normal);
+    packed.texcoord[0] = floatToHalf(v.texcoord[0]);
+    packed.texcoord[1] = floatToHalf(v.texcoord[1]);
+    return packed;
+}
+
+// Expand `count` packed vertices at `src` to `dst`. Reads go through
+// memcpy, and vertex i is read before it is written, so `src` may be the
+// upper half of `dst` (the in-place meshopt decode below relies on that).
+static void unpackVertices(const unsigned char* src, size_t count, const HDMQuantization& quant,
+                           unsigned char* dst) {
+    for (size_t i = 0; i < count; i++) {
+        HDMPackedVertex packed;
+        memcpy(&packed, src + i * sizeof(HDMPackedVertex), sizeof(packed));
+        HDMVertex v;
+        for (int axis = 0; axis < 3; axis++) {
+            v.position[axis] = quant.position_min[axis] + packed.position[axis] * quant.position_scale[axis];
+        }
+        decodeOctahedral(packed.normal, v.normal);
+        v.texcoord[0] = halfToFloat(packed.texcoord[0]);
+        v.texcoord[1] = halfToFloat(packed.texcoord[1]);
+        memcpy(dst + i * sizeof(HDMVertex), &v, sizeof(v));
+    }
+}
+
+// Widen 16-bit indices; as above, `src` may be the upper half of `dst`
+static void widenIndices(const unsigned char* src, size_t count, uint32_t* dst) {
+    for (size_t i = 0; i < count; i++) {
+        uint16_t index;
+        memcpy(&index, src + i * sizeof(uint16_t), sizeof(index));
+        dst[i] = index;
+    }
+}
+
+// The encoded vertices / indices sections for `requested`; returns the
+// encoding actually used
+static HDMGeometryEncoding encodeGeometry(const HDMGeometry& geom, HDMGeometryEncoding requested,
+                                          uint32_t& indexSize, std::vector<unsigned char>& vertexBytes,
+                                          std::vector<unsigned char>& indexBytes) {
+    HDMGeometryEncoding encoding = requested;
+#ifndef EDEN_USE_MESHOPT
+    if (encoding == HDM_GEOMETRY_MESHOPT) {
+        std::cerr << "[HDM] Built without meshoptimizer; saving quantized geometry instead" << std::endl;
+        encoding = HDM_GEOMETRY_QUANTIZED;
+    }
+#endif
+    if (encoding == HDM_GEOMETRY_MESHOPT && geom.indices.size() % 3 != 0) {
+        encoding = HDM_GEOMETRY_QUANTIZED;   // The index codec takes triangle lists only
+    }
+
+    HDMQuantization quant = computeQuantization(geom.vertices);
+    std::vector<HDMPackedVertex> packed(geom.vertices.size());
+    for (size_t i = 0; i < packed.size(); i++) {
+        packed[i] = packVertex(geom.vertices[i], quant);
+    }
+    uint32_t maxIndex = 0;
+    for (uint32_t index : geom.indices) {
+        maxIndex = std::max(maxIndex, index);
+    }
+    indexSize = maxIndex <= 0xffffu ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    vertexBytes.assign(reinterpret_cast<const unsigned char*>(&quant),
+                       reinterpret_cast<const unsigned char*>(&quant) + sizeof(quant));
+#ifdef EDEN_USE_MESHOPT
+    if (encoding == HDM_GEOMETRY_MESHOPT) {
+        vertexBytes.resize(sizeof(quant) + meshopt_encodeVertexBufferBound(packed.size(), sizeof(HDMPackedVertex)));
+        vertexBytes.resize(sizeof(quant) + meshopt_encodeVertexBuffer(vertexBytes.data() + sizeof(quant),
+                                                                     vertexBytes.size() - sizeof(quant), packed.data(),
+                                                                     packed.size(), sizeof(HDMPackedVertex)));
+        indexBytes.resize(meshopt_encodeIndexBufferBound(geom.indices.size(), geom.vertices.size()));
+        indexBytes.resize(meshopt_encodeIndexBuffer(indexBytes.data(), indexBytes.size(), geom.indices.data(),
+                                                    geom.indices.size()));
+        return encoding;
+    }
+#endif
+    const unsigned char* packedBytes = reinterpret_cast<const unsigned char*>(packed.data());
+    vertexBytes.insert(vertexBytes.end(), packedBytes, packedBytes + packed.size() * sizeof(HDMPackedVertex));
+    indexBytes.resize(geom.indices.size() * indexSize);
+    for (size_t i = 0; i < geom.indices.size(); i++) {
+        if (indexSize == sizeof(uint16_t)) {
+            uint16_t index = static_cast<uint16_t>(geom.indices[i]);
+            memcpy(indexBytes.data() + i * sizeof(index), &index, sizeof(index));
+        } else {
+            memcpy(indexBytes.data() + i * sizeof(uint32_t), &geom.indices[i], sizeof(uint32_t));
+        }
+    }
+    return encoding;
+}
+
+// vertex_count / index_count of a validated v3 file into `vertices` / `indices`
+static bool decodeGeometryV3(const unsigned char* base, const HDMHeaderV3& header,
+                             HDMVertex* vertices, uint32_t* indices) {
+    const unsigned char* vertexData = base + header.vertices.offset;
+    const unsigned char* indexData = base + header.indices.offset;
+    size_t vertexCount = header.vertex_count, indexCount = header.index_count;
+    if (header.geometry_encoding == HDM_GEOMETRY_RAW) {
+        if (vertexCount) memcpy(vertices, vertexData, vertexCount * sizeof(HDMVertex));
+        if (indexCount) memcpy(indices, indexData, indexCount * sizeof(uint32_t));
+        return true;
+    }
+
+    HDMQuantization quant;
+    memcpy(&quant, vertexData, sizeof(quant));
+    const unsigned char* packed = vertexData + sizeof(quant);
+    const unsigned char* narrowIndices = indexData;
+    unsigned char* vertexOut = reinterpret_cast<unsigned char*>(vertices);
+#ifdef EDEN_USE_MESHOPT
+    if (header.geometry_encoding == HDM_GEOMETRY_MESHOPT) {
+        // Decode into the upper half of the outputs, then expand in place
+        unsigned char* packedOut = vertexOut + vertexCount * (sizeof(HDMVertex) - sizeof(HDMPackedVertex));
+        if (meshopt_decodeVertexBuffer(packedOut, vertexCount, sizeof(HDMPackedVertex), packed,
+                                       static_cast<size_t>(header.vertices.size) - sizeof(quant)) != 0) {
+            std::cerr << "[HDM] Corrupt compressed vertices" << std::endl;
+            return false;
+        }
+        unsigned char* indexOut = reinterpret_cast<unsigned char*>(indices) +
+                                  indexCount * (sizeof(uint32_t) - header.index_size);
+        if (meshopt_decodeIndexBuffer(indexOut, indexCount, header.index_size, indexData,
+                                      static_cast<size_t>(header.indices.size)) != 0) {
+            std::cerr << "[HDM] Corrupt compressed indices" << std::endl;
+            return false;
+        }
+        packed = packedOut;
+        narrowIndices = indexOut;
+    }
+#endif
+    unpackVertices(packed, vertexCount, quant, vertexOut);
+    if (header.index_size == sizeof(uint16_t)) {
+        widenIndices(narrowIndices, indexCount, indices);
+    } else if (indexCount && narrowIndices != reinterpret_cast<const unsigned char*>(indices)) {
+        memcpy(indices, narrowIndices, indexCount * sizeof(uint32_t));
+    }
+    return true;
+}
+
+// ============================================================================
+// Texture Encoding
+// ============================================================================
+
+static bool textureBCFormat(uint32_t format, BCFormat& out) {
+    switch (format) {
+        case HDM_TEXTURE_BC1: out = BCFormat::BC1; return true;
+        case HDM_TEXTURE_BC3: out = BCFormat::BC3; return true;
+        case HDM_TEXTURE_BC7: out = BCFormat::BC7; return true;
+        default: return false;
+    }
+}
+
+static const char* textureFormatName(uint32_t format) {
+    switch (format) {
+        case HDM_TEXTURE_RGBA8: return "RGBA8";
+        case HDM_TEXTURE_BC1: return "BC1";
+        case HDM_TEXTURE_BC3: return "BC3";
+        case HDM_TEXTURE_BC7: return "BC7";
+        default: return "unknown";
+    }
+}
+
+size_t textureLevelSize(uint32_t format, uint32_t width, uint32_t height) {
+    BCFormat bc;
+    if (format == HDM_TEXTURE_RGBA8) return size_t(width) * height * 4;
+    if (textureBCFormat(format, bc)) return bc_level_size(bc, width, height);
+    return 0;
+}
+
+size_t textureLevelOffset(uint32_t format, uint32_t width, uint32_t height, uint32_t level) {
+    size_t offset = 0;
+    for (uint32_t l = 0; l < level; l++) {
+        offset += textureLevelSize(format, width, height);
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    return offset;
+}
+
+bool encodeTexture(HDMTexture& tex, const HDMTextureEncoding& encoding) {
+    if (tex.format != HDM_TEXTURE_RGBA8 || tex.mip_count > 1) {
+        std::cerr << "[HDM] Texture is already encoded (" << textureFormatName(tex.format) << ", "
+                  << tex.mip_count << " mips)" << std::endl;
+        return false;
+    }
+    if (tex.width == 0 || tex.height == 0 || tex.data.size() != size_t(tex.width) * tex.height * 4) {
+        std::cerr << "[HDM] Texture data does not match " << tex.width << "x" << tex.height << " RGBA8" << std::endl;
+        return false;
+    }
+    BCFormat bc = BCFormat::BC1;
+    if (encoding.format != HDM_TEXTURE_RGBA8 && !textureBCFormat(encoding.format, bc)) {
+        std::cerr << "[HDM] Unknown texture format " << encoding.format << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t mipCount = encoding.mips ? bc_mip_count(tex.width, tex.height) : 1;
+    if (encoding.format == HDM_TEXTURE_RGBA8) {
+        // Uncompressed chain: append each box-filtered level
+        std::vector<unsigned char> level;
+        uint32_t width = tex.width, height = tex.height;
+        tex.data.reserve(tex.data.size() * 4 / 3 + 4);
+        for (uint32_t l = 1; l < mipCount; l++) {
+            size_t offset = textureLevelOffset(HDM_TEXTURE_RGBA8, tex.width, tex.height, l - 1);
+            level = bc_downsample(tex.data.data() + offset, width, height, encoding.srgb, width, height);
+            tex.data.insert(tex.data.end(), level.begin(), level.end());
+        }
+    } else {
+        tex.data = bc_encode_mips(tex.data.data(), tex.width, tex.height, bc, encoding.quality, encoding.srgb, mipCount);
+    }
+    tex.format = encoding.format;
+    tex.mip_count = mipCount;
+
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "[HDM] Encoded " << tex.width << "x" << tex.height << " texture as "
+              << textureFormatName(tex.format) << " (" << mipCount << " mips) in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    return true;
+}
+
 // ============================================================================
 // Binary Format
 // ============================================================================
 
+static HDMProperties sanitizeProperties(const HDMProperties& props) {
+    HDMProperties sanitized = props;
+    if (sanitized.num_control_points < 0 || sanitized.num_control_points > 8) {
+        sanitized.num_control_points = 0;
+    }
+    return sanitized;
+}
+
+static uint64_t alignSection(uint64_t offset) {
+    return (offset + HDM_SECTION_ALIGNMENT - 1) & ~uint64_t(HDM_SECTION_ALIGNMENT - 1);
+}
+
+static bool hostIsLittleEndian() {
+    const uint32_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
 bool saveBinary(const char* filepath, const HDMProperties& props,
-                const HDMGeometry& geom, const HDMTexture& tex) {
+                const HDMGeometry& geom, const HDMTexture& tex,
+                HDMGeometryEncoding encoding) {
+    if (!hostIsLittleEndian()) {
+        std::cerr << "[HDM] Binary HDM is little-endian; this host is not: " << filepath << std::endl;
+        return false;
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[HDM] Failed to open file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    HDMProperties sanitizedProps = sanitizeProperties(props);
+
+    HDMHeaderV3 header;
+    const void* vertexData = geom.vertices.data();
+    const void* indexData = geom.indices.data();
+    uint64_t vertexSize = geom.vertices.size() * sizeof(HDMVertex);
+    uint64_t indexSize = geom.indices.size() * sizeof(uint32_t);
+    std::vector<unsigned char> encodedVertices, encodedIndices;
+    if (encoding != HDM_GEOMETRY_RAW) {
+        header.geometry_encoding = encodeGeometry(geom, encoding, header.index_size, encodedVertices, encodedIndices);
+        header.vertex_stride = sizeof(HDMPackedVertex);
+        vertexData = encodedVertices.data();
+        indexData = encodedIndices.data();
+        vertexSize = encodedVertices.size();
+        indexSize = encodedIndices.size();
+    }
+
+    // Lay the sections out back to back, each on a 64-byte boundary
+    header.vertex_count = static_cast<uint32_t>(geom.vertices.size());
+    header.index_count = static_cast<uint32_t>(geom.indices.size());
+    header.texture_width = tex.width;
+    header.texture_height = tex.height;
+    header.texture_format = tex.format;
+    header.texture_mip_count = std::max(tex.mip_count, 1u);
+    header.properties = {alignSection(sizeof(HDMHeaderV3)), sizeof(HDMProperties)};
+    header.vertices = {alignSection(header.properties.offset + header.properties.size), vertexSize};
+    header.indices = {alignSection(header.vertices.offset + header.vertices.size), indexSize};
+    header.texture = {alignSection(header.indices.offset + header.indices.size), tex.data.size()};
+    header.file_size = header.texture.offset + header.texture.size;
+
+    // Write each section after zero padding up to its offset
+    static const char padding[HDM_SECTION_ALIGNMENT] = {0};
+    uint64_t written = 0;
+    auto writeSection = [&](const HDMSection& section, const void* data) {
+        file.write(padding, static_cast<std::streamsize>(section.offset - written));
+        if (section.size > 0) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(section.size));
+        }
+        written = section.offset + section.size;
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    written = sizeof(header);
+    writeSection(header.properties, &sanitizedProps);
+    writeSection(header.vertices, vertexData);
+    writeSection(header.indices, indexData);
+    writeSection(header.texture, tex.data.data());
+
+    if (!file.good()) {
+        std::cerr << "[HDM] Failed to write binary HDM: " << filepath << std::endl;
+        return false;
+    }
+    file.close();
+    std::cout << "[HDM] Saved binary HDM: " << filepath << std::endl;
+    return true;
+}
+
+bool saveBinaryV2(const char* filepath, const HDMProperties& props,
+                  const HDMGeometry& geom, const HDMTexture& tex) {
+    if (tex.format != HDM_TEXTURE_RGBA8 || tex.mip_count > 1) {
+        std::cerr << "[HDM] v2 HDM holds single-level RGBA8 textures only: " << filepath << std::endl;
+        return false;
+    }
+
     std::ofstream file(filepath, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "[HDM] Failed to open file for writing: " << filepath << std::endl;
@@ -206,10 +635,7 @@ bool saveBinary(const char* filepath, const HDMProperties& props,
     }
     
     // Sanitize properties
-    HDMProperties sanitizedProps = props;
-    if (sanitizedProps.num_control_points < 0 || sanitizedProps.num_control_points > 8) {
-        sanitizedProps.num_control_points = 0;
-    }
+    HDMProperties sanitizedProps = sanitizeProperties(props);
     
     // Calculate sizes
     size_t propsSize = sizeof(HDMProperties);
@@ -264,33 +690,136 @@ bool saveBinary(const char* filepath, const HDMProperties& props,
     }
     
     file.close();
-    std::cout << "[HDM] Saved binary HDM: " << filepath << std::endl;
+    std::cout << "[HDM] Saved binary HDM (v2): " << filepath << std::endl;
     return true;
 }
 
-bool loadBinary(const char* filepath, HDMProperties& props,
-                HDMGeometry& geom, HDMTexture& tex) {
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
+// The v3 header of `data`, or null (with the reason logged) if the file's
+// sections don't all lie inside it, aligned and sized to match the counts
+static const HDMHeaderV3* validateV3(const unsigned char* data, size_t size, const char* filepath) {
+    if (size < sizeof(HDMHeaderV3)) {
+        std::cerr << "[HDM] Truncated HDM header: " << filepath << std::endl;
+        return nullptr;
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(HDMHeaderV3) != 0) {
+        std::cerr << "[HDM] HDM data is not aligned for a mapped read: " << filepath << std::endl;
+        return nullptr;
+    }
+    const HDMHeaderV3* header = reinterpret_cast<const HDMHeaderV3*>(data);
+    if (header->magic[0] != 'H' || header->magic[1] != 'D' || header->magic[2] != 'M') {
+        std::cerr << "[HDM] Invalid HDM file (bad magic): " << filepath << std::endl;
+        return nullptr;
+    }
+    if (header->version != HDM_VERSION_V3 || header->header_size != sizeof(HDMHeaderV3)) {
+        std::cerr << "[HDM] Unsupported HDM layout (v" << header->version << "): " << filepath << std::endl;
+        return nullptr;
+    }
+    if (!hostIsLittleEndian()) {
+        std::cerr << "[HDM] Binary HDM is little-endian; this host is not: " << filepath << std::endl;
+        return nullptr;
+    }
+    if (header->file_size > size) {
+        std::cerr << "[HDM] Truncated HDM file (" << size << " of " << header->file_size
+                  << " bytes): " << filepath << std::endl;
+        return nullptr;
+    }
+
+    // Encoded geometry: the codec's own sizes, checked again when decoding
+    uint32_t encoding = header->geometry_encoding;
+    uint64_t vertexSize = uint64_t(header->vertex_count) * sizeof(HDMVertex);
+    uint64_t indexSize = uint64_t(header->index_count) * sizeof(uint32_t);
+    uint32_t stride = sizeof(HDMVertex);
+    if (encoding == HDM_GEOMETRY_QUANTIZED || encoding == HDM_GEOMETRY_MESHOPT) {
+        bool compressed = encoding == HDM_GEOMETRY_MESHOPT;
+        stride = sizeof(HDMPackedVertex);
+        vertexSize = compressed ? header->vertices.size
+                                : sizeof(HDMQuantization) + uint64_t(header->vertex_count) * sizeof(HDMPackedVertex);
+        indexSize = compressed ? header->indices.size : uint64_t(header->index_count) * header->index_size;
+        if ((header->index_size != 2 && header->index_size != 4) || header->vertices.size < sizeof(HDMQuantization) ||
+            (compressed && header->index_count % 3 != 0)) {
+            std::cerr << "[HDM] Corrupt HDM geometry encoding: " << filepath << std::endl;
+            return nullptr;
+        }
+#ifndef EDEN_USE_MESHOPT
+        if (compressed) {
+            std::cerr << "[HDM] Built without meshoptimizer support: " << filepath << std::endl;
+            return nullptr;
+        }
+#endif
+    } else if (encoding != HDM_GEOMETRY_RAW) {
+        std::cerr << "[HDM] Unknown HDM geometry encoding " << encoding << ": " << filepath << std::endl;
+        return nullptr;
+    }
+    if (header->vertex_stride != stride) {
+        std::cerr << "[HDM] Unsupported HDM vertex stride " << header->vertex_stride << ": " << filepath << std::endl;
+        return nullptr;
+    }
+
+    auto sectionOk = [&](const HDMSection& section, uint64_t expectedSize) {
+        return section.offset % HDM_SECTION_ALIGNMENT == 0 && section.offset >= sizeof(HDMHeaderV3) &&
+               section.size == expectedSize && section.offset <= header->file_size &&
+               section.size <= header->file_size - section.offset;
+    };
+    if (!sectionOk(header->properties, sizeof(HDMProperties)) ||
+        !sectionOk(header->vertices, vertexSize) ||
+        !sectionOk(header->indices, indexSize) ||
+        !sectionOk(header->texture, header->texture.size)) {
+        std::cerr << "[HDM] Corrupt HDM section table: " << filepath << std::endl;
+        return nullptr;
+    }
+    uint32_t mipCount = header->texture_mip_count ? header->texture_mip_count : 1;
+    if (header->texture.size != 0 &&
+        (textureLevelSize(header->texture_format, 1, 1) == 0 ||
+         mipCount > bc_mip_count(header->texture_width, header->texture_height) ||
+         header->texture.size != textureLevelOffset(header->texture_format, header->texture_width,
+                                                    header->texture_height, mipCount))) {
+        std::cerr << "[HDM] HDM texture size does not match " << header->texture_width << "x"
+                  << header->texture_height << " " << textureFormatName(header->texture_format) << " with "
+                  << mipCount << " mips: " << filepath << std::endl;
+        return nullptr;
+    }
+
+    const HDMProperties* props = reinterpret_cast<const HDMProperties*>(data + header->properties.offset);
+    if (props->num_control_points < 0 || props->num_control_points > 8) {
+        std::cerr << "[HDM] Corrupt HDM control points: " << filepath << std::endl;
+        return nullptr;
+    }
+    return header;
+}
+
+bool HDMView::open(const char* filepath) {
+    close();
+    if (!Vfs::shared().open(filepath, m_file)) {
         std::cerr << "[HDM] Failed to open file: " << filepath << std::endl;
         return false;
     }
-    
+    m_header = validateV3(m_file.bytes(), m_file.size(), filepath);
+    if (!m_header) {
+        m_file.reset();
+        return false;
+    }
+    return true;
+}
+
+void HDMView::close() {
+    m_header = nullptr;
+    m_file.reset();
+}
+
+bool HDMView::decodeGeometry(HDMVertex* vertices, uint32_t* indices) const {
+    return m_header && decodeGeometryV3(m_file.bytes(), *m_header, vertices, indices);
+}
+
+// v2: variable-length sections read through a stream
+static bool loadBinaryV2(std::istream& file, const char* filepath, HDMProperties& props,
+                         HDMGeometry& geom, HDMTexture& tex) {
     // Read header
     HDMHeader header;
     file.read(reinterpret_cast<char*>(&header), sizeof(header));
     
-    // Verify magic
-    if (header.magic[0] != 'H' || header.magic[1] != 'D' || header.magic[2] != 'M') {
-        std::cerr << "[HDM] Invalid HDM file (bad magic): " << filepath << std::endl;
-        file.close();
-        return false;
-    }
-    
     // Check version
     if (header.version < 2) {
         std::cerr << "[HDM] Old HDM format (v" << header.version << ")" << std::endl;
-        file.close();
         return false;
     }
     
@@ -324,6 +853,7 @@ bool loadBinary(const char* filepath, HDMProperties& props,
     file.read(reinterpret_cast<char*>(&tex.width), sizeof(tex.width));
     file.read(reinterpret_cast<char*>(&tex.height), sizeof(tex.height));
     file.read(reinterpret_cast<char*>(&tex.format), sizeof(tex.format));
+    tex.mip_count = 1;
     
     size_t texDataSize = tex.width * tex.height * 4;
     if (texDataSize > 0) {
@@ -331,7 +861,49 @@ bool loadBinary(const char* filepath, HDMProperties& props,
         file.read(reinterpret_cast<char*>(tex.data.data()), texDataSize);
     }
     
-    file.close();
+    std::cout << "[HDM] Loaded binary HDM (v2): " << filepath << std::endl;
+    return true;
+}
+
+bool loadBinary(const char* filepath, HDMProperties& props,
+                HDMGeometry& geom, HDMTexture& tex) {
+    VfsFile data;
+    if (!Vfs::shared().open(filepath, data)) {
+        std::cerr << "[HDM] Failed to open file: " << filepath << std::endl;
+        return false;
+    }
+    
+    // Verify magic; the version follows it in both layouts
+    uint32_t version = 0;
+    if (data.size() < 8 || data.data()[0] != 'H' || data.data()[1] != 'D' || data.data()[2] != 'M') {
+        std::cerr << "[HDM] Invalid HDM file (bad magic): " << filepath << std::endl;
+        return false;
+    }
+    memcpy(&version, data.data() + 4, sizeof(version));
+    if (version < HDM_VERSION_V3) {
+        VfsStreamBuf buffer(std::move(data));
+        std::istream file(&buffer);
+        return loadBinaryV2(file, filepath, props, geom, tex);
+    }
+    
+    const HDMHeaderV3* header = validateV3(data.bytes(), data.size(), filepath);
+    if (!header) {
+        return false;
+    }
+    const unsigned char* base = data.bytes();
+    memcpy(&props, base + header->properties.offset, sizeof(props));
+    geom.vertices.resize(header->vertex_count);
+    geom.indices.resize(header->index_count);
+    if (!decodeGeometryV3(base, *header, geom.vertices.data(), geom.indices.data())) {
+        std::cerr << "[HDM] Failed to decode geometry: " << filepath << std::endl;
+        return false;
+    }
+    tex.width = header->texture_width;
+    tex.height = header->texture_height;
+    tex.format = header->texture_format;
+    tex.mip_count = header->texture_mip_count ? header->texture_mip_count : 1;
+    tex.data.assign(base + header->texture.offset, base + header->texture.offset + header->texture.size);
+    
     std::cout << "[HDM] Loaded binary HDM: " << filepath << std::endl;
     return true;
 }
@@ -355,15 +927,15 @@ bool saveAscii(const char* filepath, const HDMProperties& props,
     // Properties
     file << "  \"properties\": {\n";
     file << "    \"model\": {\n";
-    file << "      \"obj_path\": \"" << props.model.obj_path << "\",\n";
-    file << "      \"texture_path\": \"" << props.model.texture_path << "\",\n";
+    file << "      \"obj_path\": " << json_quote(props.model.obj_path) << ",\n";
+    file << "      \"texture_path\": " << json_quote(props.model.texture_path) << ",\n";
     file << "      \"scale\": [" << props.model.scale[0] << ", " << props.model.scale[1] << ", " << props.model.scale[2] << "],\n";
     file << "      \"origin_offset\": [" << props.model.origin_offset[0] << ", " << props.model.origin_offset[1] << ", " << props.model.origin_offset[2] << "]\n";
     file << "    },\n";
     
     file << "    \"item\": {\n";
     file << "      \"item_type_id\": " << props.item.item_type_id << ",\n";
-    file << "      \"item_name\": \"" << props.item.item_name << "\",\n";
+    file << "      \"item_name\": " << json_quote(props.item.item_name) << ",\n";
     file << "      \"trade_value\": " << props.item.trade_value << ",\n";
     file << "      \"condition\": " << props.item.condition << ",\n";
     file << "      \"weight\": " << props.item.weight << ",\n";
@@ -402,7 +974,7 @@ bool saveAscii(const char* filepath, const HDMProperties& props,
     file << "    \"control_points\": [\n";
     int numPoints = std::min(std::max(props.num_control_points, 0), 8);
     for (int i = 0; i < numPoints; i++) {
-        file << "      {\"name\": \"" << props.control_points[i].name << "\", \"position\": [" 
+        file << "      {\"name\": " << json_quote(props.control_points[i].name) << ", \"position\": [" 
              << props.control_points[i].position[0] << ", " 
              << props.control_points[i].position[1] << ", " 
              << props.control_points[i].position[2] << "]}";
@@ -433,6 +1005,7 @@ bool saveAscii(const char* filepath, const HDMProperties& props,
     file << "    \"width\": " << tex.width << ",\n";
     file << "    \"height\": " << tex.height << ",\n";
     file << "    \"format\": " << tex.format << ",\n";
+    file << "    \"mip_count\": " << tex.mip_count << ",\n";
     if (!tex.data.empty()) {
         std::string texData = base64Encode(tex.data.data(), tex.data.size());
         file << "    \"data_base64\": \"" << texData << "\"\n";
@@ -447,51 +1020,26 @@ bool saveAscii(const char* filepath, const HDMProperties& props,
 
 bool loadAscii(const char* filepath, HDMProperties& props,
                HDMGeometry& geom, HDMTexture& tex) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cerr << "[HDM] Failed to open file: " << filepath << std::endl;
+    JsonDocument doc;
+    if (!doc.parseFile(filepath)) {
+        std::cerr << "[HDM] Failed to load ASCII HDM: " << doc.error() << std::endl;
         return false;
     }
-    
-    std::string json;
-    std::string line;
-    while (std::getline(file, line)) {
-        json += line + "\n";
-    }
-    file.close();
-    
+    JsonValue root = doc.root();
+
     initDefaultProperties(props);
-    
-    // Parse model properties
-    std::string objPath = jsonFindString(json, "obj_path");
-    std::string texPath = jsonFindString(json, "texture_path");
-    strncpy(props.model.obj_path, objPath.c_str(), sizeof(props.model.obj_path) - 1);
-    strncpy(props.model.texture_path, texPath.c_str(), sizeof(props.model.texture_path) - 1);
-    jsonFindFloatArray(json, "scale", props.model.scale, 3);
-    jsonFindFloatArray(json, "origin_offset", props.model.origin_offset, 3);
-    
-    // Parse item properties
-    props.item.item_type_id = jsonFindInt(json, "item_type_id");
-    std::string itemName = jsonFindString(json, "item_name");
-    strncpy(props.item.item_name, itemName.c_str(), sizeof(props.item.item_name) - 1);
-    props.item.trade_value = jsonFindInt(json, "trade_value");
-    props.item.condition = jsonFindFloat(json, "condition");
-    props.item.weight = jsonFindFloat(json, "weight");
-    props.item.category = jsonFindInt(json, "category");
-    props.item.is_salvaged = jsonFindBool(json, "is_salvaged");
-    
-    // Parse physics properties
-    props.physics.collision_type = jsonFindInt(json, "collision_type");
-    jsonFindFloatArray(json, "collision_bounds", props.physics.collision_bounds, 3);
-    props.physics.is_static = jsonFindBool(json, "is_static");
-    props.physics.mass = jsonFindFloat(json, "mass");
-    
+    JsonValue properties = root["properties"];
+    readPropertiesJson(properties ? properties : root, props);
+
     // Parse geometry
-    int vertexCount = jsonFindInt(json, "vertex_count");
-    int indexCount = jsonFindInt(json, "index_count");
-    
+    JsonValue geometry = root["geometry"];
+    int vertexCount = geometry["vertex_count"].asInt();
+    int indexCount = geometry["index_count"].asInt();
+
+    geom.vertices.clear();
+    geom.indices.clear();
     if (vertexCount > 0) {
-        std::string vertB64 = jsonFindString(json, "vertices_base64");
+        std::string_view vertB64 = geometry["vertices_base64"].asString();
         if (!vertB64.empty()) {
             std::vector<unsigned char> vertData = base64Decode(vertB64);
             size_t expectedSize = vertexCount * sizeof(HDMVertex);
@@ -501,9 +1049,9 @@ bool loadAscii(const char* filepath, HDMProperties& props,
             }
         }
     }
-    
+
     if (indexCount > 0) {
-        std::string idxB64 = jsonFindString(json, "indices_base64");
+        std::string_view idxB64 = geometry["indices_base64"].asString();
         if (!idxB64.empty()) {
             std::vector<unsigned char> idxData = base64Decode(idxB64);
             size_t expectedSize = indexCount * sizeof(uint32_t);
@@ -513,19 +1061,22 @@ bool loadAscii(const char* filepath, HDMProperties& props,
             }
         }
     }
-    
+
     // Parse texture
-    tex.width = jsonFindInt(json, "width");
-    tex.height = jsonFindInt(json, "height");
-    tex.format = jsonFindInt(json, "format");
-    
+    JsonValue texture = root["texture"];
+    tex.width = static_cast<uint32_t>(texture["width"].asInt());
+    tex.height = static_cast<uint32_t>(texture["height"].asInt());
+    tex.format = static_cast<uint32_t>(texture["format"].asInt());
+    tex.mip_count = static_cast<uint32_t>(std::max(texture["mip_count"].asInt(), 1));
+
+    tex.data.clear();
     if (tex.width > 0 && tex.height > 0) {
-        std::string texB64 = jsonFindString(json, "data_base64");
+        std::string_view texB64 = texture["data_base64"].asString();
         if (!texB64.empty()) {
             tex.data = base64Decode(texB64);
         }
     }
-    
+
     std::cout << "[HDM] Loaded ASCII HDM: " << filepath << std::endl;
     return true;
 }
@@ -539,15 +1090,15 @@ bool savePropertiesJson(const char* filepath, const HDMProperties& props) {
     if (!file.is_open()) return false;
     
     file << "{\n";
-    file << "  \"hdm_version\": \"" << props.hdm_version << "\",\n\n";
+    file << "  \"hdm_version\": " << json_quote(props.hdm_version) << ",\n\n";
     file << "  \"model\": {\n";
-    file << "    \"obj_path\": \"" << props.model.obj_path << "\",\n";
-    file << "    \"texture_path\": \"" << props.model.texture_path << "\",\n";
+    file << "    \"obj_path\": " << json_quote(props.model.obj_path) << ",\n";
+    file << "    \"texture_path\": " << json_quote(props.model.texture_path) << ",\n";
     file << "    \"scale\": [" << props.model.scale[0] << ", " << props.model.scale[1] << ", " << props.model.scale[2] << "]\n";
     file << "  },\n\n";
     file << "  \"item_properties\": {\n";
     file << "    \"item_type_id\": " << props.item.item_type_id << ",\n";
-    file << "    \"item_name\": \"" << props.item.item_name << "\",\n";
+    file << "    \"item_name\": " << json_quote(props.item.item_name) << ",\n";
     file << "    \"trade_value\": " << props.item.trade_value << ",\n";
     file << "    \"condition\": " << props.item.condition << ",\n";
     file << "    \"weight\": " << props.item.weight << ",\n";
@@ -567,38 +1118,14 @@ bool savePropertiesJson(const char* filepath, const HDMProperties& props) {
 }
 
 bool loadPropertiesJson(const char* filepath, HDMProperties& props) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) return false;
-    
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string json = buffer.str();
-    file.close();
-    
+    JsonDocument doc;
+    if (!doc.parseFile(filepath)) {
+        std::cerr << "[HDM] Failed to load HDM properties: " << doc.error() << std::endl;
+        return false;
+    }
+
     initDefaultProperties(props);
-    
-    std::string ver = jsonFindString(json, "hdm_version");
-    if (!ver.empty()) strncpy(props.hdm_version, ver.c_str(), sizeof(props.hdm_version) - 1);
-    
-    std::string obj = jsonFindString(json, "obj_path");
-    if (!obj.empty()) strncpy(props.model.obj_path, obj.c_str(), sizeof(props.model.obj_path) - 1);
-    
-    std::string tex = jsonFindString(json, "texture_path");
-    if (!tex.empty()) strncpy(props.model.texture_path, tex.c_str(), sizeof(props.model.texture_path) - 1);
-    
-    props.item.item_type_id = jsonFindInt(json, "item_type_id");
-    std::string name = jsonFindString(json, "item_name");
-    if (!name.empty()) strncpy(props.item.item_name, name.c_str(), sizeof(props.item.item_name) - 1);
-    props.item.trade_value = jsonFindInt(json, "trade_value");
-    props.item.condition = jsonFindFloat(json, "condition");
-    props.item.weight = jsonFindFloat(json, "weight");
-    props.item.category = jsonFindInt(json, "category");
-    props.item.is_salvaged = jsonFindBool(json, "is_salvaged");
-    
-    props.physics.collision_type = jsonFindInt(json, "collision_type");
-    props.physics.is_static = jsonFindBool(json, "is_static");
-    props.physics.mass = jsonFindFloat(json, "mass");
-    
+    readPropertiesJson(doc.root(), props);
     return true;
 }
 
@@ -638,50 +1165,131 @@ bool save(const char* filepath, const HDMProperties& props,
 } // namespace eden
 
 // ============================================================================
-// C-Style API (global state for loaded properties)
+// C-Style API
 // ============================================================================
 
+// Properties from the last hdm_load_file()
 static HDMProperties g_loadedHdmProperties;
 
+// Files from hdm_load_batch(); the pool itself isn't thread-safe
+static vkcore::HandlePool<HDMProperties> g_hdmHandles;
+static std::mutex g_hdmHandlesMutex;
+
+static HDMItemPropertiesC itemPropertiesC(const HDMProperties& props) {
+    HDMItemPropertiesC result = {};
+    result.item_type_id = props.item.item_type_id;
+    strncpy(result.item_name, props.item.item_name, sizeof(result.item_name) - 1);
+    result.trade_value = props.item.trade_value;
+    result.condition = props.item.condition;
+    result.weight = props.item.weight;
+    result.category = props.item.category;
+    result.is_salvaged = props.item.is_salvaged ? 1 : 0;
+    return result;
+}
+
+static HDMPhysicsPropertiesC physicsPropertiesC(const HDMProperties& props) {
+    HDMPhysicsPropertiesC result = {};
+    result.collision_type = props.physics.collision_type;
+    result.collision_bounds_x = props.physics.collision_bounds[0];
+    result.collision_bounds_y = props.physics.collision_bounds[1];
+    result.collision_bounds_z = props.physics.collision_bounds[2];
+    result.is_static = props.physics.is_static ? 1 : 0;
+    result.mass = props.physics.mass;
+    return result;
+}
+
+static HDMModelPropertiesC modelPropertiesC(const HDMProperties& props) {
+    HDMModelPropertiesC result = {};
+    strncpy(result.obj_path, props.model.obj_path, sizeof(result.obj_path) - 1);
+    strncpy(result.texture_path, props.model.texture_path, sizeof(result.texture_path) - 1);
+    result.scale_x = props.model.scale[0];
+    result.scale_y = props.model.scale[1];
+    result.scale_z = props.model.scale[2];
+    return result;
+}
+
+// A copy, so the lock isn't held while the caller converts it
+static HDMProperties handleProperties(HDMHandle handle) {
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    if (const HDMProperties* props = g_hdmHandles.get(handle)) return *props;
+    HDMProperties defaults;
+    eden::hdm::initDefaultProperties(defaults);
+    return defaults;
+}
+
 extern "C" int hdm_load_file(const char* filepath) {
     eden::hdm::initDefaultProperties(g_loadedHdmProperties);
     return eden::hdm::loadPropertiesJson(filepath, g_loadedHdmProperties) ? 1 : 0;
 }
 
 extern "C" HDMItemPropertiesC hdm_get_item_properties() {
-    HDMItemPropertiesC result;
-    result.item_type_id = g_loadedHdmProperties.item.item_type_id;
-    strncpy(result.item_name, g_loadedHdmProperties.item.item_name, sizeof(result.item_name) - 1);
-    result.trade_value = g_loadedHdmProperties.item.trade_value;
-    result.condition = g_loadedHdmProperties.item.condition;
-    result.weight = g_loadedHdmProperties.item.weight;
-    result.category = g_loadedHdmProperties.item.category;
-    result.is_salvaged = g_loadedHdmProperties.item.is_salvaged ? 1 : 0;
-    return result;
+    return itemPropertiesC(g_loadedHdmProperties);
 }
 
 extern "C" HDMPhysicsPropertiesC hdm_get_physics_properties() {
-    HDMPhysicsPropertiesC result;
-    result.collision_type = g_loadedHdmProperties.physics.collision_type;
-    result.collision_bounds_x = g_loadedHdmProperties.physics.collision_bounds[0];
-    result.collision_bounds_y = g_loadedHdmProperties.physics.collision_bounds[1];
-    result.collision_bounds_z = g_loadedHdmProperties.physics.collision_bounds[2];
-    result.is_static = g_loadedHdmProperties.physics.is_static ? 1 : 0;
-    result.mass = g_loadedHdmProperties.physics.mass;
-    return result;
+    return physicsPropertiesC(g_loadedHdmProperties);
 }
 
 extern "C" HDMModelPropertiesC hdm_get_model_properties() {
-    HDMModelPropertiesC result;
-    strncpy(result.obj_path, g_loadedHdmProperties.model.obj_path, sizeof(result.obj_path) - 1);
-    strncpy(result.texture_path, g_loadedHdmProperties.model.texture_path, sizeof(result.texture_path) - 1);
-    result.scale_x = g_loadedHdmProperties.model.scale[0];
-    result.scale_y = g_loadedHdmProperties.model.scale[1];
-    result.scale_z = g_loadedHdmProperties.model.scale[2];
-    return result;
+    return modelPropertiesC(g_loadedHdmProperties);
 }
 
 extern "C" int hdm_save_file(const char* filepath) {
     return eden::hdm::savePropertiesJson(filepath, g_loadedHdmProperties) ? 1 : 0;
 }
 
+extern "C" int hdm_load_batch(const char* const* paths, int count, HDMHandle* handles) {
+    if (!paths || !handles || count <= 0) return 0;
+    auto start = std::chrono::steady_clock::now();
+
+    // Files parse on the workers into a private array (one file per range,
+    // since sizes vary); only handing out handles takes the lock
+    std::vector<HDMProperties> loaded(static_cast<size_t>(count));
+    std::vector<char> ok(static_cast<size_t>(count), 0);
+    parallel_for(size_t(count), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            ok[i] = paths[i] && eden::hdm::loadPropertiesJson(paths[i], loaded[i]);
+        }
+    }, 1);
+
+    int loadedCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+        for (int i = 0; i < count; i++) {
+            handles[i] = ok[size_t(i)] ? g_hdmHandles.insert(loaded[size_t(i)]) : HDM_INVALID_HANDLE;
+            if (handles[i] != HDM_INVALID_HANDLE) loadedCount++;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[HDM] Loaded " << loadedCount << "/" << count << " files in " << ms << " ms" << std::endl;
+    return loadedCount;
+}
+
+extern "C" int hdm_handle_valid(HDMHandle handle) {
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    return g_hdmHandles.contains(handle) ? 1 : 0;
+}
+
+extern "C" HDMItemPropertiesC hdm_handle_item_properties(HDMHandle handle) {
+    return itemPropertiesC(handleProperties(handle));
+}
+
+extern "C" HDMPhysicsPropertiesC hdm_handle_physics_properties(HDMHandle handle) {
+    return physicsPropertiesC(handleProperties(handle));
+}
+
+extern "C" HDMModelPropertiesC hdm_handle_model_properties(HDMHandle handle) {
+    return modelPropertiesC(handleProperties(handle));
+}
+
+extern "C" void hdm_release(HDMHandle handle) {
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    g_hdmHandles.remove(handle);
+}
+
+extern "C" void hdm_release_batch(const HDMHandle* handles, int count) {
+    if (!handles) return;
+    std::lock_guard<std::mutex> lock(g_hdmHandlesMutex);
+    for (int i = 0; i < count; i++) g_hdmHandles.remove(handles[i]);
+}
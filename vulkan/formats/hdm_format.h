@@ -7,14 +7,18 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <cstring>
 
+#include "../../stdlib/vfs.h"
+#include "../../stdlib/bc_encoder.h"
+
 // ============================================================================
 // HDM Data Structures
 // ============================================================================
 
-// HDM File Header (binary format)
+// HDM v2 File Header (binary format); still read, written by saveBinaryV2
 struct HDMHeader {
     char magic[4] = {'H', 'D', 'M', '\0'};  // File identifier
     uint32_t version = 2;                    // Format version
@@ -83,14 +87,110 @@ struct HDMGeometry {
     std::vector<uint32_t> indices;
 };
 
+// HDM texture formats. Block-compressed data uploads as stored; 1 was the
+// monolith editor's DDS and is not written.
+enum HDMTextureFormat : uint32_t {
+    HDM_TEXTURE_RGBA8 = 0,
+    HDM_TEXTURE_BC1 = 2,
+    HDM_TEXTURE_BC3 = 3,
+    HDM_TEXTURE_BC7 = 4
+};
+
 // HDM Texture data (embedded)
 struct HDMTexture {
     uint32_t width = 0;
     uint32_t height = 0;
-    uint32_t format = 0;                    // 0 = RGBA8
+    uint32_t format = 0;                    // HDMTextureFormat
+    uint32_t mip_count = 1;                 // Levels in data, level 0 first, back to back
     std::vector<unsigned char> data;
 };
 
+static_assert(sizeof(HDMProperties) == 1024, "HDM properties section layout changed");
+static_assert(sizeof(HDMVertex) == 32, "HDM vertex layout changed");
+
+// ============================================================================
+// HDM v3 Binary Layout (memory-mappable)
+// ============================================================================
+//
+// Little-endian throughout. Each section starts on a multiple of
+// section_alignment (64) and the gaps are zero, so a reader can map the file
+// (or an .edenpak entry, which is 64-byte aligned too) and copy sections
+// straight into a staging buffer without parsing anything:
+//
+//   HDMHeaderV3      128 bytes
+//   properties       HDMProperties
+//   vertices         vertex_count x HDMVertex
+//   indices          index_count x uint32_t
+//   texture          texture.size bytes: texture_mip_count levels of
+//                    texture_format, level 0 first (textureLevelOffset())
+//
+// Encoded geometry (geometry_encoding != HDM_GEOMETRY_RAW) shrinks the two
+// geometry sections; the vertices section then starts with HDMQuantization:
+//
+//   QUANTIZED   vertices: HDMQuantization + vertex_count x HDMPackedVertex
+//               indices:  index_count x index_size (2 when vertex_count
+//                         fits in 16 bits, else 4)
+//   MESHOPT     the same, with the packed vertices and the triangle list
+//               run through meshoptimizer's vertex / index codecs
+//               (build with EDEN_USE_MESHOPT and link meshoptimizer)
+
+constexpr uint32_t HDM_VERSION_V3 = 3;
+constexpr uint32_t HDM_SECTION_ALIGNMENT = 64;
+
+enum HDMGeometryEncoding : uint32_t {
+    HDM_GEOMETRY_RAW = 0,                    // HDMVertex / uint32_t, as in memory
+    HDM_GEOMETRY_QUANTIZED = 1,              // HDMPackedVertex, 16-bit indices where possible
+    HDM_GEOMETRY_MESHOPT = 2                 // QUANTIZED, then meshopt-compressed
+};
+
+// 16 bytes per vertex: positions as unorm16 inside the mesh bounds,
+// octahedral snorm16 normals, half-float texcoords. Shaders can read this
+// directly; HDMView::decodeGeometry() expands it back to HDMVertex.
+struct HDMPackedVertex {
+    uint16_t position[3];                    // position = min + q * scale
+    uint16_t padding;
+    int16_t normal[2];                       // Octahedral
+    uint16_t texcoord[2];                    // IEEE half
+};
+
+struct HDMQuantization {
+    float position_min[3];
+    float position_scale[3];                 // Bounds extent / 65535
+    uint32_t reserved[2];
+};
+
+static_assert(sizeof(HDMPackedVertex) == 16, "HDM packed vertex layout changed");
+static_assert(sizeof(HDMQuantization) == 32, "HDM quantization layout changed");
+
+struct HDMSection {
+    uint64_t offset = 0;                     // From the start of the file
+    uint64_t size = 0;                       // Bytes, without padding
+};
+
+struct HDMHeaderV3 {
+    char magic[4] = {'H', 'D', 'M', '\0'};
+    uint32_t version = HDM_VERSION_V3;
+    uint32_t header_size = 128;              // sizeof(HDMHeaderV3)
+    uint32_t section_alignment = HDM_SECTION_ALIGNMENT;
+    uint64_t file_size = 0;
+    uint32_t vertex_count = 0;
+    uint32_t index_count = 0;
+    uint32_t vertex_stride = sizeof(HDMVertex);
+    uint32_t texture_width = 0;
+    uint32_t texture_height = 0;
+    uint32_t texture_format = 0;             // As HDMTexture::format
+    HDMSection properties;
+    HDMSection vertices;
+    HDMSection indices;
+    HDMSection texture;
+    uint32_t geometry_encoding = HDM_GEOMETRY_RAW;
+    uint32_t index_size = sizeof(uint32_t);  // Encoded indices; raw are always 4
+    uint32_t texture_mip_count = 1;          // 0 in early v3 files: read as 1
+    uint8_t reserved[4] = {0};
+};
+
+static_assert(sizeof(HDMHeaderV3) == 128, "HDM v3 header layout changed");
+
 // ============================================================================
 // C-Style API Structures (for HEIDIC interop)
 // ============================================================================
@@ -122,6 +222,10 @@ struct HDMModelPropertiesC {
     float scale_z;
 };
 
+// One loaded HDM file in the C API; stale once released
+typedef uint32_t HDMHandle;
+#define HDM_INVALID_HANDLE 0xFFFFFFFFu
+
 // ============================================================================
 // HDM Format Functions
 // ============================================================================
@@ -132,14 +236,104 @@ namespace hdm {
 // Initialize properties with default values
 void initDefaultProperties(HDMProperties& props);
 
-// Save HDM to binary format (.hdm)
+// Bytes of one mip level / of levels [0, level) (0 for unknown formats)
+size_t textureLevelSize(uint32_t format, uint32_t width, uint32_t height);
+size_t textureLevelOffset(uint32_t format, uint32_t width, uint32_t height, uint32_t level);
+
+// How encodeTexture() compresses an RGBA8 texture
+struct HDMTextureEncoding {
+    uint32_t format = HDM_TEXTURE_BC7;       // HDMTextureFormat; RGBA8 only adds mips
+    BCQuality quality = BCQuality::Normal;   // Fast for previews, High for final cooks
+    bool mips = true;                        // Full chain down to 1x1
+    bool srgb = true;                        // Color data: mips filtered in linear light
+};
+
+// Replace a single-level RGBA8 texture with the encoded chain; blocks are
+// compressed on the job system's workers (bc_encoder.h). Editors should
+// encode a copy on a background task, then saveBinary() it.
+bool encodeTexture(HDMTexture& tex, const HDMTextureEncoding& encoding);
+
+// Save HDM to binary format (.hdm, v3). MESHOPT falls back to QUANTIZED in
+// builds without EDEN_USE_MESHOPT, or when the indices aren't a triangle list.
 bool saveBinary(const char* filepath, const HDMProperties& props,
-                const HDMGeometry& geom, const HDMTexture& tex);
+                const HDMGeometry& geom, const HDMTexture& tex,
+                HDMGeometryEncoding encoding = HDM_GEOMETRY_RAW);
 
-// Load HDM from binary format (.hdm)
+// Save HDM in the v2 layout, for tools that don't read v3 yet. Fails for
+// compressed or mipped textures, which v2 can't describe.
+bool saveBinaryV2(const char* filepath, const HDMProperties& props,
+                  const HDMGeometry& geom, const HDMTexture& tex);
+
+// Load HDM from binary format (.hdm, v2 or v3) into owned copies.
+// For v3 files, HDMView avoids the copies.
 bool loadBinary(const char* filepath, HDMProperties& props,
                 HDMGeometry& geom, HDMTexture& tex);
 
+/**
+ * Zero-copy view of an HDM v3 file, opened through the VFS (a memory-mapped
+ * loose file or a stored archive entry). The pointers stay valid until
+ * close(); pass them straight to UploadBatch::uploadBuffer / uploadImage.
+ * open() checks every section against the file size, so a truncated or
+ * corrupt file fails there rather than at first use.
+ *
+ * vertices() and indices() are null for encoded geometry; decodeGeometry()
+ * writes HDMVertex / uint32_t for either kind, e.g. into a mapped staging
+ * buffer. Textures upload one copy region per mip (hdm_texture_upload.h).
+ *
+ * Usage:
+ *   eden::hdm::HDMView model;
+ *   if (model.open("items/wrench.hdm")) {
+ *       uploads.uploadBuffer(vertexBuffer, model.vertices(), model.vertexBytes());
+ *       uploads.uploadBuffer(indexBuffer, model.indices(), model.indexBytes());
+ *   }
+ */
+class HDMView {
+public:
+    bool open(const char* filepath);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    const HDMHeaderV3& header() const { return *m_header; }
+    const HDMProperties& properties() const { return *section<HDMProperties>(m_header->properties); }
+
+    HDMGeometryEncoding geometryEncoding() const { return HDMGeometryEncoding(m_header->geometry_encoding); }
+    bool encoded() const { return m_header->geometry_encoding != HDM_GEOMETRY_RAW; }
+
+    const HDMVertex* vertices() const { return encoded() ? nullptr : section<HDMVertex>(m_header->vertices); }
+    uint32_t vertexCount() const { return m_header->vertex_count; }
+    size_t vertexBytes() const { return static_cast<size_t>(m_header->vertices.size); }
+
+    const uint32_t* indices() const { return encoded() ? nullptr : section<uint32_t>(m_header->indices); }
+    uint32_t indexCount() const { return m_header->index_count; }
+    size_t indexBytes() const { return static_cast<size_t>(m_header->indices.size); }
+
+    // vertexCount() vertices and indexCount() indices, whatever the encoding
+    bool decodeGeometry(HDMVertex* vertices, uint32_t* indices) const;
+
+    const unsigned char* textureData() const { return section<unsigned char>(m_header->texture); }
+    size_t textureBytes() const { return static_cast<size_t>(m_header->texture.size); }
+    uint32_t textureWidth() const { return m_header->texture_width; }
+    uint32_t textureHeight() const { return m_header->texture_height; }
+    uint32_t textureFormat() const { return m_header->texture_format; }
+    uint32_t textureMipCount() const { return m_header->texture_mip_count ? m_header->texture_mip_count : 1; }
+    size_t textureLevelOffset(uint32_t level) const {
+        return hdm::textureLevelOffset(textureFormat(), textureWidth(), textureHeight(), level);
+    }
+
+    // The file's bytes, e.g. to copy the whole thing into one staging buffer
+    const unsigned char* data() const { return m_file.bytes(); }
+    size_t size() const { return m_file.size(); }
+
+private:
+    template <typename T>
+    const T* section(const HDMSection& s) const {
+        return s.size ? reinterpret_cast<const T*>(m_file.bytes() + s.offset) : nullptr;
+    }
+
+    VfsFile m_file;
+    const HDMHeaderV3* m_header = nullptr;
+};
+
 // Save HDM to ASCII/JSON format (.hdma)
 bool saveAscii(const char* filepath, const HDMProperties& props,
                const HDMGeometry& geom, const HDMTexture& tex);
@@ -164,7 +358,7 @@ bool save(const char* filepath, const HDMProperties& props,
 
 // Base64 utilities
 std::string base64Encode(const unsigned char* data, size_t len);
-std::vector<unsigned char> base64Decode(const std::string& encoded);
+std::vector<unsigned char> base64Decode(std::string_view encoded);
 
 // JSON parsing utilities
 std::string jsonFindString(const std::string& json, const std::string& key);
@@ -195,6 +389,22 @@ HDMModelPropertiesC hdm_get_model_properties();
 // Save HDM file
 int hdm_save_file(const char* filepath);
 
+// Load `count` files in parallel on the job system's workers. handles[i]
+// gets paths[i]'s handle, or HDM_INVALID_HANDLE if it failed to load.
+// Returns how many loaded; release each valid handle when done.
+int hdm_load_batch(const char* const* paths, int count, HDMHandle* handles);
+
+// 1 while `handle` refers to a loaded file
+int hdm_handle_valid(HDMHandle handle);
+
+// Properties of one loaded file (defaults for a stale handle)
+HDMItemPropertiesC hdm_handle_item_properties(HDMHandle handle);
+HDMPhysicsPropertiesC hdm_handle_physics_properties(HDMHandle handle);
+HDMModelPropertiesC hdm_handle_model_properties(HDMHandle handle);
+
+void hdm_release(HDMHandle handle);
+void hdm_release_batch(const HDMHandle* handles, int count);
+
 #ifdef __cplusplus
 }
 #endif
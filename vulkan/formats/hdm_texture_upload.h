@@ -0,0 +1,80 @@
+// EDEN ENGINE - HDM Texture Upload
+// Block-compressed, mipped HDM textures onto the GPU as stored
+//
+// An HDM texture section holds texture_mip_count levels back to back,
+// level 0 first (encodeTexture() writes them). Each level becomes one
+// VkBufferImageCopy into its own mip, so nothing is decoded or blitted at
+// load time - the staging copy is the HDMView's mapped bytes.
+
+#ifndef EDEN_HDM_TEXTURE_UPLOAD_H
+#define EDEN_HDM_TEXTURE_UPLOAD_H
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+#include "hdm_format.h"
+#include "../core/upload_batch.h"
+
+namespace eden {
+namespace hdm {
+
+// Image format for an HDM texture; `srgb` for color textures (UNORM keeps
+// the bytes as the monolith editor samples them). UNDEFINED if unknown.
+inline VkFormat textureVkFormat(uint32_t format, bool srgb) {
+    switch (format) {
+        case HDM_TEXTURE_RGBA8: return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        case HDM_TEXTURE_BC1: return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case HDM_TEXTURE_BC3: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        case HDM_TEXTURE_BC7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        default: return VK_FORMAT_UNDEFINED;
+    }
+}
+
+// One VkBufferImageCopy per mip level, offsets relative to the texture data
+inline std::vector<VkBufferImageCopy> textureCopyRegions(uint32_t format, uint32_t width, uint32_t height,
+                                                         uint32_t mipCount) {
+    std::vector<VkBufferImageCopy> regions;
+    VkDeviceSize offset = 0;
+
+    for (uint32_t level = 0; level < mipCount; level++) {
+        VkBufferImageCopy region = {};
+        region.bufferOffset = offset;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {width, height, 1};
+        regions.push_back(region);
+
+        offset += textureLevelSize(format, width, height);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return regions;
+}
+
+/**
+ * Queue every mip of an open HDMView's texture into `image`, created with
+ * textureVkFormat() and textureMipCount() levels. Copies straight from the
+ * mapped file into the staging ring; the image ends SHADER_READ_ONLY_OPTIMAL.
+ *
+ * Usage:
+ *   eden::hdm::HDMView model;
+ *   if (model.open("items/wrench.hdm") && model.textureBytes() > 0) {
+ *       VkFormat format = eden::hdm::textureVkFormat(model.textureFormat(), true);
+ *       // ... create `image` with model.textureMipCount() levels ...
+ *       eden::hdm::uploadTexture(uploads, image, model);
+ *   }
+ */
+inline vkcore::UploadBatch::Ticket uploadTexture(vkcore::UploadBatch& uploads, VkImage image, const HDMView& view) {
+    std::vector<VkBufferImageCopy> regions =
+        textureCopyRegions(view.textureFormat(), view.textureWidth(), view.textureHeight(), view.textureMipCount());
+    return uploads.uploadImageMips(image, view.textureData(), view.textureBytes(), regions.data(),
+                                   static_cast<uint32_t>(regions.size()), view.textureMipCount());
+}
+
+} // namespace hdm
+} // namespace eden
+
+#endif // EDEN_HDM_TEXTURE_UPLOAD_H
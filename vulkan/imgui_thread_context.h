@@ -0,0 +1,18 @@
+// EDEN ENGINE - Per-thread ImGui context
+// ImGui user config (IMGUI_USER_CONFIG) that makes the current context a
+// thread_local. ui_window_manager.cpp drives the UI window's context on its
+// own thread while the game's overlay (eden_imgui) uses another one on the
+// main thread; with the stock global GImGui they would switch each other's
+// context mid-frame. ELECTROSCRIBE passes this header when UI windows are
+// enabled; the variable is defined in ui_window_manager.cpp.
+
+#ifndef IMGUI_THREAD_CONTEXT_H
+#define IMGUI_THREAD_CONTEXT_H
+
+#define EDEN_IMGUI_THREAD_CONTEXT
+
+struct ImGuiContext;
+extern thread_local ImGuiContext* EdenImGuiContext;
+#define GImGui EdenImGuiContext
+
+#endif // IMGUI_THREAD_CONTEXT_H
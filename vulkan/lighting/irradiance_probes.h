@@ -0,0 +1,500 @@
+// ============================================================================
+// IRRADIANCE PROBES - Baked ambient light for static scenes
+// ============================================================================
+// Part of the EDEN Engine modular lighting system.
+//
+// A regular grid of probes over a scene's static geometry, each holding
+// the light arriving from every direction as L1 spherical harmonics (4 RGB
+// coefficients). LightingManager uploads the grid as a 3D texture and the
+// lit shader uses the trilinearly blended irradiance for the fragment's
+// normal in place of the constant ambient colour, so corners darken and
+// coloured walls bleed onto their neighbours without fill lights.
+//
+// The bake is offline or at load time, on the CPU:
+//   - ProbeBakeInput collects world-space triangles (with a flat albedo per
+//     mesh), the sky colour, the sun and the point lights.
+//   - Every probe shoots samplesPerProbe rays (a fixed Fibonacci sphere)
+//     through a BVH. A miss sees the sky; a hit sees the surface lit by the
+//     sky, the sun and the point lights - each with a shadow ray - times
+//     its albedo: one bounce. Back faces count as black, so probes buried
+//     in geometry don't leak light out of it.
+//   - Probes are split over worker threads; the result is deterministic,
+//     independent of the thread count.
+//   - bakeIrradianceProbes() writes the grid to a cache file tagged with
+//     ProbeBakeInput::hash(); the next load of an unchanged scene reads it
+//     back instead of baking.
+//
+// Radiance follows the lit shader's units (a surface showing `albedo *
+// (N.L * light)`), and coefficients are stored pre-divided by pi, so a
+// uniform sky of colour C reads back as exactly C.
+//
+// Header-only. Tracing uses rayTriangle() from utils/raycast.h, so code
+// that bakes must link utils/raycast.cpp.
+//
+// Usage:
+//   lighting::ProbeBakeInput input;
+//   input.addMesh(positions, vertexCount, indices, indexCount, model, albedo);
+//   input.setSky(ambientColor);
+//   input.setSun(sunDir, sunColor, sunIntensity);
+//   lighting::IrradianceProbeGrid grid;
+//   lighting::bakeIrradianceProbes(input, {}, grid, "scene.probes");
+//   lightingManager.setIrradianceProbes(grid);
+// ============================================================================
+
+#ifndef IRRADIANCE_PROBES_H
+#define IRRADIANCE_PROBES_H
+
+#include "../utils/raycast.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace lighting {
+
+constexpr uint32_t PROBE_SH_COEFFS = 4;  // L1: L00, L1-1 (y), L10 (z), L11 (x)
+
+// ============================================================================
+// Baked grid
+// ============================================================================
+
+struct IrradianceProbeGrid {
+    static constexpr uint32_t FILE_MAGIC = 0x42525045;  // "EPRB"
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    glm::vec3 origin = glm::vec3(0.0f);   // World position of probe (0, 0, 0)
+    glm::vec3 spacing = glm::vec3(1.0f);  // Between neighbouring probes, per axis
+    glm::uvec3 dims = glm::uvec3(0);      // Probes per axis
+    uint64_t sceneHash = 0;               // ProbeBakeInput::hash() it was baked from
+
+    // PROBE_SH_COEFFS RGB coefficients per probe, probes x-fastest
+    std::vector<glm::vec3> coeffs;
+
+    uint32_t probeCount() const { return dims.x * dims.y * dims.z; }
+    bool empty() const { return probeCount() == 0 || coeffs.size() != size_t(probeCount()) * PROBE_SH_COEFFS; }
+
+    bool save(const std::string& path) const {
+        if (empty()) return false;
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "[Lighting] Can't write probe cache " << path << std::endl;
+            return false;
+        }
+        uint32_t header[2] = {FILE_MAGIC, FILE_VERSION};
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&sceneHash), sizeof(sceneHash));
+        file.write(reinterpret_cast<const char*>(&origin), sizeof(origin));
+        file.write(reinterpret_cast<const char*>(&spacing), sizeof(spacing));
+        file.write(reinterpret_cast<const char*>(&dims), sizeof(dims));
+        file.write(reinterpret_cast<const char*>(coeffs.data()), coeffs.size() * sizeof(glm::vec3));
+        return bool(file);
+    }
+
+    // expectedHash 0 accepts any scene; false (grid untouched) on a missing,
+    // corrupt or stale file
+    bool load(const std::string& path, uint64_t expectedHash = 0) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+
+        uint32_t header[2] = {0, 0};
+        IrradianceProbeGrid loaded;
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        file.read(reinterpret_cast<char*>(&loaded.sceneHash), sizeof(loaded.sceneHash));
+        file.read(reinterpret_cast<char*>(&loaded.origin), sizeof(loaded.origin));
+        file.read(reinterpret_cast<char*>(&loaded.spacing), sizeof(loaded.spacing));
+        file.read(reinterpret_cast<char*>(&loaded.dims), sizeof(loaded.dims));
+        if (!file || header[0] != FILE_MAGIC || header[1] != FILE_VERSION) return false;
+        if (expectedHash != 0 && loaded.sceneHash != expectedHash) return false;
+        if (loaded.dims.x == 0 || loaded.dims.y == 0 || loaded.dims.z == 0 ||
+            loaded.dims.x > 1024 || loaded.dims.y > 1024 || loaded.dims.z > 1024) {
+            return false;
+        }
+
+        loaded.coeffs.resize(size_t(loaded.probeCount()) * PROBE_SH_COEFFS);
+        file.read(reinterpret_cast<char*>(loaded.coeffs.data()), loaded.coeffs.size() * sizeof(glm::vec3));
+        if (!file) return false;
+
+        *this = std::move(loaded);
+        return true;
+    }
+};
+
+struct ProbeBakeSettings {
+    float spacing = 2.0f;            // World units between probes (before clamping)
+    uint32_t maxProbesPerAxis = 64;  // Caps the grid on huge scenes (spacing grows)
+    uint32_t samplesPerProbe = 256;  // Rays per probe
+    float boundsPadding = 1.0f;      // Grid extends this far past the geometry
+    uint32_t threads = 0;            // 0 = one per hardware thread
+};
+
+// ============================================================================
+// Bake input
+// ============================================================================
+
+class ProbeBakeInput {
+public:
+    struct Triangle {
+        glm::vec3 v0, v1, v2;  // World space
+        uint32_t material;     // Index into albedos
+    };
+
+    struct PointLight {
+        glm::vec3 position;
+        glm::vec3 color;
+        float intensity;
+        float range;
+    };
+
+    // `positions` are read `stride` bytes apart (0 = tightly packed vec3s)
+    void addMesh(const void* positions, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount,
+                 const glm::mat4& model, const glm::vec3& albedo, uint32_t stride = 0) {
+        if (!positions || !indices || vertexCount == 0) return;
+        if (stride == 0) stride = sizeof(glm::vec3);
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(positions);
+        auto world = [&](uint32_t index) {
+            glm::vec3 p;
+            memcpy(&p, bytes + size_t(index) * stride, sizeof(glm::vec3));
+            return glm::vec3(model * glm::vec4(p, 1.0f));
+        };
+
+        uint32_t material = static_cast<uint32_t>(m_albedos.size());
+        m_albedos.push_back(albedo);
+        for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+            if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount) continue;
+            Triangle tri{world(indices[i]), world(indices[i + 1]), world(indices[i + 2]), material};
+            m_boundsMin = glm::min(m_boundsMin, glm::min(tri.v0, glm::min(tri.v1, tri.v2)));
+            m_boundsMax = glm::max(m_boundsMax, glm::max(tri.v0, glm::max(tri.v1, tri.v2)));
+            m_triangles.push_back(tri);
+        }
+    }
+
+    // Radiance of rays that escape the scene (the constant ambient colour)
+    void setSky(const glm::vec3& color) { m_sky = color; }
+
+    void setSun(const glm::vec3& direction, const glm::vec3& color, float intensity = 1.0f) {
+        m_sunDir = glm::length(direction) > 0.0f ? glm::normalize(direction) : glm::vec3(0.0f, -1.0f, 0.0f);
+        m_sunColor = color * intensity;
+    }
+
+    void addPointLight(const glm::vec3& position, const glm::vec3& color, float intensity, float range) {
+        m_pointLights.push_back({position, color, intensity, range});
+    }
+
+    void clear() { *this = ProbeBakeInput(); }
+
+    // FNV-1a over everything the result depends on (not the thread count)
+    uint64_t hash(const ProbeBakeSettings& settings) const {
+        uint64_t h = 0xcbf29ce484222325ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; i++) {
+                h ^= bytes[i];
+                h *= 0x100000001b3ull;
+            }
+        };
+        uint32_t version = IrradianceProbeGrid::FILE_VERSION;
+        mix(&version, sizeof(version));
+        mix(m_triangles.data(), m_triangles.size() * sizeof(Triangle));
+        mix(m_albedos.data(), m_albedos.size() * sizeof(glm::vec3));
+        mix(m_pointLights.data(), m_pointLights.size() * sizeof(PointLight));
+        mix(&m_sky, sizeof(m_sky));
+        mix(&m_sunDir, sizeof(m_sunDir));
+        mix(&m_sunColor, sizeof(m_sunColor));
+        mix(&settings.spacing, sizeof(settings.spacing));
+        mix(&settings.maxProbesPerAxis, sizeof(settings.maxProbesPerAxis));
+        mix(&settings.samplesPerProbe, sizeof(settings.samplesPerProbe));
+        mix(&settings.boundsPadding, sizeof(settings.boundsPadding));
+        return h != 0 ? h : 1;  // 0 means "any" to IrradianceProbeGrid::load()
+    }
+
+    const std::vector<Triangle>& getTriangles() const { return m_triangles; }
+    const std::vector<glm::vec3>& getAlbedos() const { return m_albedos; }
+    const std::vector<PointLight>& getPointLights() const { return m_pointLights; }
+    const glm::vec3& getSky() const { return m_sky; }
+    const glm::vec3& getSunDirection() const { return m_sunDir; }
+    const glm::vec3& getSunRadiance() const { return m_sunColor; }
+    bool empty() const { return m_triangles.empty(); }
+    glm::vec3 getBoundsMin() const { return m_boundsMin; }
+    glm::vec3 getBoundsMax() const { return m_boundsMax; }
+
+private:
+    std::vector<Triangle> m_triangles;
+    std::vector<glm::vec3> m_albedos;
+    std::vector<PointLight> m_pointLights;
+    glm::vec3 m_sky = glm::vec3(0.2f);
+    glm::vec3 m_sunDir = glm::vec3(0.0f, -1.0f, 0.0f);
+    glm::vec3 m_sunColor = glm::vec3(0.0f);
+    glm::vec3 m_boundsMin = glm::vec3(1e30f);
+    glm::vec3 m_boundsMax = glm::vec3(-1e30f);
+};
+
+// ============================================================================
+// BVH over the bake triangles
+// ============================================================================
+
+class ProbeBvh {
+public:
+    static constexpr uint32_t LEAF_SIZE = 4;
+
+    explicit ProbeBvh(const std::vector<ProbeBakeInput::Triangle>& triangles) : m_triangles(triangles) {
+        if (triangles.empty()) return;
+        m_order.resize(triangles.size());
+        m_centroids.resize(triangles.size());
+        for (uint32_t i = 0; i < triangles.size(); i++) {
+            m_order[i] = i;
+            m_centroids[i] = (triangles[i].v0 + triangles[i].v1 + triangles[i].v2) / 3.0f;
+        }
+        m_nodes.reserve(triangles.size() * 2 / LEAF_SIZE + 1);
+        build(0, static_cast<uint32_t>(triangles.size()));
+        m_centroids.clear();
+        m_centroids.shrink_to_fit();
+    }
+
+    // Closest hit within (0, maxT); returns the triangle index or UINT32_MAX
+    uint32_t closestHit(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& hitT) const {
+        uint32_t hit = UINT32_MAX;
+        hitT = maxT;
+        traverse(origin, dir, [&](uint32_t tri, float t) {
+            if (t < hitT) {
+                hitT = t;
+                hit = tri;
+            }
+            return false;
+        }, hitT);
+        return hit;
+    }
+
+    // Anything within (0, maxT) - shadow rays
+    bool occluded(const glm::vec3& origin, const glm::vec3& dir, float maxT) const {
+        bool blocked = false;
+        float limit = maxT;
+        traverse(origin, dir, [&](uint32_t, float t) {
+            blocked = t < maxT;
+            return blocked;
+        }, limit);
+        return blocked;
+    }
+
+private:
+    struct Node {
+        AABB box;
+        uint32_t first = 0;  // Leaf: first index into m_order; inner: right child
+        uint32_t count = 0;  // Leaf triangle count; 0 for inner nodes (left child follows)
+    };
+
+    uint32_t build(uint32_t begin, uint32_t end) {
+        uint32_t index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+
+        AABB box(glm::vec3(1e30f), glm::vec3(-1e30f));
+        AABB centroidBox = box;
+        for (uint32_t i = begin; i < end; i++) {
+            const ProbeBakeInput::Triangle& tri = m_triangles[m_order[i]];
+            box.min = glm::min(box.min, glm::min(tri.v0, glm::min(tri.v1, tri.v2)));
+            box.max = glm::max(box.max, glm::max(tri.v0, glm::max(tri.v1, tri.v2)));
+            centroidBox.min = glm::min(centroidBox.min, m_centroids[m_order[i]]);
+            centroidBox.max = glm::max(centroidBox.max, m_centroids[m_order[i]]);
+        }
+        m_nodes[index].box = box;
+
+        glm::vec3 extent = centroidBox.max - centroidBox.min;
+        if (end - begin <= LEAF_SIZE || std::max(extent.x, std::max(extent.y, extent.z)) <= 0.0f) {
+            m_nodes[index].first = begin;
+            m_nodes[index].count = end - begin;
+            return index;
+        }
+
+        // Median split along the widest centroid axis
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        uint32_t mid = begin + (end - begin) / 2;
+        std::nth_element(m_order.begin() + begin, m_order.begin() + mid, m_order.begin() + end,
+                         [&](uint32_t a, uint32_t b) { return m_centroids[a][axis] < m_centroids[b][axis]; });
+
+        build(begin, mid);
+        m_nodes[index].first = build(mid, end);
+        return index;
+    }
+
+    static bool hitBox(const AABB& box, const glm::vec3& origin, const glm::vec3& invDir, float maxT) {
+        glm::vec3 t0 = (box.min - origin) * invDir;
+        glm::vec3 t1 = (box.max - origin) * invDir;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxT));
+        return enter <= exit;
+    }
+
+    // fn(triangle, t) returns true to stop; `limit` shrinks as closer hits land
+    template <typename Fn>
+    void traverse(const glm::vec3& origin, const glm::vec3& dir, Fn&& fn, float& limit) const {
+        if (m_nodes.empty()) return;
+        glm::vec3 invDir(1.0f / (dir.x != 0.0f ? dir.x : 1e-30f), 1.0f / (dir.y != 0.0f ? dir.y : 1e-30f),
+                         1.0f / (dir.z != 0.0f ? dir.z : 1e-30f));
+
+        uint32_t stack[64];
+        uint32_t depth = 0;
+        stack[depth++] = 0;
+        while (depth > 0) {
+            const Node& node = m_nodes[stack[--depth]];
+            if (!hitBox(node.box, origin, invDir, limit)) continue;
+
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                    const ProbeBakeInput::Triangle& tri = m_triangles[m_order[i]];
+                    float t, u, v;
+                    if (rayTriangle(origin, dir, tri.v0, tri.v1, tri.v2, t, u, v) && fn(m_order[i], t)) return;
+                }
+            } else if (depth + 2 <= 64) {
+                stack[depth++] = node.first;                                         // Right
+                stack[depth++] = static_cast<uint32_t>(&node - m_nodes.data()) + 1;  // Left
+            }
+        }
+    }
+
+    const std::vector<ProbeBakeInput::Triangle>& m_triangles;
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_order;
+    std::vector<glm::vec3> m_centroids;  // Build only
+};
+
+// ============================================================================
+// Bake
+// ============================================================================
+
+// Fills `grid` from `cachePath` if it holds this exact bake, else bakes and
+// (with a path) writes the cache. False only when there is nothing to bake.
+inline bool bakeIrradianceProbes(const ProbeBakeInput& input, const ProbeBakeSettings& settings,
+                                 IrradianceProbeGrid& grid, const std::string& cachePath = "") {
+    if (input.empty()) {
+        std::cerr << "[Lighting] Probe bake: no static geometry" << std::endl;
+        return false;
+    }
+
+    uint64_t hash = input.hash(settings);
+    if (!cachePath.empty() && grid.load(cachePath, hash)) {
+        std::cout << "[Lighting] Irradiance probes loaded from " << cachePath << std::endl;
+        return true;
+    }
+
+    // Grid over the padded bounds, spacing stretched to hit them exactly
+    glm::vec3 lo = input.getBoundsMin() - glm::vec3(settings.boundsPadding);
+    glm::vec3 hi = input.getBoundsMax() + glm::vec3(settings.boundsPadding);
+    glm::vec3 extent = hi - lo;
+    uint32_t maxPerAxis = std::max(settings.maxProbesPerAxis, 1u);
+    float spacing = std::max(settings.spacing, 1e-3f);
+    for (int axis = 0; axis < 3; axis++) {
+        uint32_t count = static_cast<uint32_t>(std::ceil(extent[axis] / spacing)) + 1;
+        grid.dims[axis] = std::min(std::max(count, 1u), maxPerAxis);
+        grid.spacing[axis] = grid.dims[axis] > 1 ? extent[axis] / float(grid.dims[axis] - 1) : 1.0f;
+        grid.origin[axis] = grid.dims[axis] > 1 ? lo[axis] : (lo[axis] + hi[axis]) * 0.5f;
+    }
+    grid.sceneHash = hash;
+    grid.coeffs.assign(size_t(grid.probeCount()) * PROBE_SH_COEFFS, glm::vec3(0.0f));
+
+    // Fibonacci sphere, shared by every probe
+    uint32_t sampleCount = std::max(settings.samplesPerProbe, 16u);
+    std::vector<glm::vec3> directions(sampleCount);
+    const float golden = 2.39996323f;  // pi * (3 - sqrt(5))
+    for (uint32_t i = 0; i < sampleCount; i++) {
+        float y = 1.0f - 2.0f * (float(i) + 0.5f) / float(sampleCount);
+        float r = std::sqrt(std::max(0.0f, 1.0f - y * y));
+        float phi = golden * float(i);
+        directions[i] = glm::vec3(std::cos(phi) * r, y, std::sin(phi) * r);
+    }
+
+    ProbeBvh bvh(input.getTriangles());
+    const std::vector<ProbeBakeInput::Triangle>& triangles = input.getTriangles();
+    const std::vector<glm::vec3>& albedos = input.getAlbedos();
+    const float rayLength = glm::length(extent) * 2.0f;
+    const float epsilon = 1e-3f * std::max(glm::length(extent), 1.0f);
+
+    // One-bounce radiance arriving at a probe along `dir`
+    auto radiance = [&](const glm::vec3& origin, const glm::vec3& dir) {
+        float t;
+        uint32_t hit = bvh.closestHit(origin, dir, rayLength, t);
+        if (hit == UINT32_MAX) return input.getSky();
+
+        const ProbeBakeInput::Triangle& tri = triangles[hit];
+        glm::vec3 normal = glm::cross(tri.v1 - tri.v0, tri.v2 - tri.v0);
+        float area = glm::length(normal);
+        if (area <= 0.0f || glm::dot(normal, dir) > 0.0f) return glm::vec3(0.0f);  // Back face
+        normal /= area;
+
+        glm::vec3 point = origin + dir * t + normal * epsilon;
+        glm::vec3 light = input.getSky();
+
+        glm::vec3 toSun = -input.getSunDirection();
+        float sunN = glm::dot(normal, toSun);
+        if (sunN > 0.0f && glm::length(input.getSunRadiance()) > 0.0f && !bvh.occluded(point, toSun, rayLength)) {
+            light += input.getSunRadiance() * sunN;
+        }
+
+        // Same falloff as calcPointLight() in lit_mesh.frag
+        for (const ProbeBakeInput::PointLight& pl : input.getPointLights()) {
+            glm::vec3 toLight = pl.position - point;
+            float distance = glm::length(toLight);
+            if (distance >= pl.range || distance <= 0.0f || pl.intensity <= 0.0f) continue;
+            glm::vec3 L = toLight / distance;
+            float ln = glm::dot(normal, L);
+            if (ln <= 0.0f || bvh.occluded(point, L, distance)) continue;
+            float x = glm::clamp(distance / pl.range, 0.0f, 1.0f);
+            float attenuation = 1.0f - x * x * (3.0f - 2.0f * x);
+            light += pl.color * pl.intensity * attenuation * attenuation * ln;
+        }
+        return albedos[tri.material] * light;
+    };
+
+    // Probes handed out in order; each thread writes only its own probes
+    std::atomic<uint32_t> nextProbe{0};
+    auto worker = [&]() {
+        const float weight = 4.0f * 3.14159265f / float(sampleCount);
+        for (uint32_t probe = nextProbe++; probe < grid.probeCount(); probe = nextProbe++) {
+            glm::uvec3 cell(probe % grid.dims.x, (probe / grid.dims.x) % grid.dims.y, probe / (grid.dims.x * grid.dims.y));
+            glm::vec3 origin = grid.origin + glm::vec3(cell) * grid.spacing;
+
+            glm::vec3 sh[PROBE_SH_COEFFS] = {glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f)};
+            for (const glm::vec3& dir : directions) {
+                glm::vec3 L = radiance(origin, dir) * weight;
+                sh[0] += L * 0.282095f;
+                sh[1] += L * (0.488603f * dir.y);
+                sh[2] += L * (0.488603f * dir.z);
+                sh[3] += L * (0.488603f * dir.x);
+            }
+
+            // Convolve with the cosine lobe (pi, 2pi/3) and divide by pi:
+            // the shader then only evaluates the basis for its normal
+            glm::vec3* out = &grid.coeffs[size_t(probe) * PROBE_SH_COEFFS];
+            out[0] = sh[0] * 0.282095f;
+            for (uint32_t c = 1; c < PROBE_SH_COEFFS; c++) out[c] = sh[c] * (0.488603f * 2.0f / 3.0f);
+        }
+    };
+
+    uint32_t threadCount = settings.threads != 0 ? settings.threads : std::thread::hardware_concurrency();
+    threadCount = std::max(1u, std::min(threadCount, grid.probeCount()));
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < threadCount; i++) threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads) thread.join();
+
+    std::cout << "[Lighting] Baked " << grid.probeCount() << " irradiance probes (" << grid.dims.x << "x"
+              << grid.dims.y << "x" << grid.dims.z << ", " << sampleCount << " rays each) on " << threadCount
+              << " threads" << std::endl;
+
+    if (!cachePath.empty()) grid.save(cachePath);
+    return true;
+}
+
+} // namespace lighting
+
+#endif // IRRADIANCE_PROBES_H
@@ -0,0 +1,220 @@
+// ============================================================================
+// LIGHT CLUSTERS - Froxel binning of point lights for the lit shader
+// ============================================================================
+// Part of the EDEN Engine modular lighting system.
+//
+// The view frustum is cut into CLUSTER_X x CLUSTER_Y screen tiles and
+// CLUSTER_Z depth slices (exponential in view depth, so near slices are
+// thin). build() assigns every point light to the clusters its sphere
+// overlaps; lit_mesh.frag finds its fragment's cluster and loops over that
+// cluster's lights only, so shading cost follows the lights that actually
+// reach a pixel rather than the total light count.
+//
+// Binning runs on the CPU each frame: per light, the sphere's view-space
+// bounds give a slice range and its projected box a tile range, then two
+// passes (count, prefix sum, fill) write the compact index list. That is
+// O(lights x covered clusters), a fraction of a millisecond for hundreds
+// of lights. With clustering off, one cluster holds every light - the
+// same shader path, without culling.
+//
+// Header-only; LightingManager owns one and uploads its output. Not
+// thread-safe.
+//
+// Usage:
+//   LightClusters clusters;
+//   clusters.setDepthRange(0.1f, 1000.0f);          // match the projection
+//   clusters.build(lights, view, proj, width, height);
+//   memcpy(ssbo, clusters.getRanges().data(), ...);  // see LightingManager
+// ============================================================================
+
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#include "lighting_types.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace lighting {
+
+class LightClusters {
+public:
+    struct Stats {
+        uint32_t lights = 0;           // Lights given to build()
+        uint32_t lightsBinned = 0;     // In at least one cluster (rest are off-screen)
+        uint32_t indexCount = 0;       // Cluster/light pairs
+        uint32_t maxPerCluster = 0;    // Worst-case loop length in the shader
+    };
+
+    // Depth range the slices cover; lights beyond far are dropped
+    void setDepthRange(float nearPlane, float farPlane) {
+        m_near = std::max(nearPlane, 1e-4f);
+        m_far = std::max(farPlane, m_near * 1.01f);
+    }
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+    void build(const std::vector<GpuPointLight>& lights, const glm::mat4& view, const glm::mat4& proj,
+               uint32_t width, uint32_t height) {
+        m_stats = Stats{};
+        m_stats.lights = static_cast<uint32_t>(lights.size());
+        std::fill(m_ranges.begin(), m_ranges.end(), glm::uvec2(0));
+        m_indices.clear();
+
+        // Clustering off: cluster 0 holds every light
+        if (!m_enabled) {
+            m_ranges[0] = glm::uvec2(0, static_cast<uint32_t>(lights.size()));
+            for (uint32_t i = 0; i < lights.size(); i++) m_indices.push_back(i);
+            m_stats.lightsBinned = m_stats.indexCount = m_stats.maxPerCluster = m_stats.lights;
+            m_width = width;
+            m_height = height;
+            return;
+        }
+
+        // Pass 1: cluster box per light, and per-cluster counts
+        m_boxes.clear();
+        m_boxes.reserve(lights.size());
+        for (uint32_t i = 0; i < lights.size(); i++) {
+            Box box;
+            if (!clusterBox(lights[i], view, proj, box)) continue;
+            box.light = i;
+            m_boxes.push_back(box);
+            forEachCluster(box, [&](uint32_t cluster) { m_ranges[cluster].y++; });
+        }
+
+        // Prefix sum, then pass 2 fills each cluster's slice of the list
+        uint32_t offset = 0;
+        for (glm::uvec2& range : m_ranges) {
+            range.x = offset;
+            offset += range.y;
+            m_stats.maxPerCluster = std::max(m_stats.maxPerCluster, range.y);
+            range.y = 0;
+        }
+        m_indices.resize(offset);
+        for (const Box& box : m_boxes) {
+            forEachCluster(box, [&](uint32_t cluster) {
+                glm::uvec2& range = m_ranges[cluster];
+                m_indices[range.x + range.y++] = box.light;
+            });
+        }
+
+        m_stats.lightsBinned = static_cast<uint32_t>(m_boxes.size());
+        m_stats.indexCount = offset;
+        m_width = width;
+        m_height = height;
+    }
+
+    // Pixel size the tiles are divided over (screenParams); binning is in
+    // NDC, so a resize needs no rebuild
+    void setScreenSize(uint32_t width, uint32_t height) {
+        m_width = width;
+        m_height = height;
+    }
+
+    // (offset, count) into getIndices(), CLUSTER_COUNT entries
+    const std::vector<glm::uvec2>& getRanges() const { return m_ranges; }
+    const std::vector<uint32_t>& getIndices() const { return m_indices; }
+    const Stats& getStats() const { return m_stats; }
+
+    // What the shader needs to find a fragment's cluster (LightingUBO)
+    glm::vec4 gridParams(uint32_t lightCount) const {
+        if (!m_enabled) return glm::vec4(1.0f, 1.0f, 1.0f, float(lightCount));
+        return glm::vec4(float(CLUSTER_X), float(CLUSTER_Y), float(CLUSTER_Z), float(lightCount));
+    }
+    glm::vec4 depthParams() const {
+        return glm::vec4(m_near, m_far, sliceScale(), 0.0f);
+    }
+    glm::vec4 screenParams() const {
+        uint32_t tilesX = m_enabled ? CLUSTER_X : 1;
+        uint32_t tilesY = m_enabled ? CLUSTER_Y : 1;
+        return glm::vec4(std::max(1.0f, float(m_width) / tilesX), std::max(1.0f, float(m_height) / tilesY),
+                         0.0f, 0.0f);
+    }
+
+private:
+    struct Box {
+        uint32_t light;
+        uint32_t x0, x1, y0, y1, z0, z1;  // Inclusive
+    };
+
+    float sliceScale() const { return float(CLUSTER_Z) / std::log(m_far / m_near); }
+
+    uint32_t sliceOf(float viewDepth) const {
+        if (viewDepth <= m_near) return 0;
+        float slice = std::log(viewDepth / m_near) * sliceScale();
+        return std::min(static_cast<uint32_t>(slice), CLUSTER_Z - 1);
+    }
+
+    // Conservative cluster range of a light's sphere; false if it can't
+    // reach anything on screen
+    bool clusterBox(const GpuPointLight& light, const glm::mat4& view, const glm::mat4& proj, Box& box) const {
+        float range = light.positionRange.w;
+        if (range <= 0.0f || light.colorIntensity.w <= 0.0f) return false;
+
+        glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(light.positionRange), 1.0f));
+        float depth = -center.z;  // View space looks down -Z
+        if (depth + range < m_near || depth - range > m_far) return false;
+
+        box.z0 = sliceOf(depth - range);
+        box.z1 = sliceOf(depth + range);
+
+        // Screen box from the projected corners of the sphere's view-space
+        // box; a sphere reaching the near plane may cover anything
+        box.x0 = box.y0 = 0;
+        box.x1 = CLUSTER_X - 1;
+        box.y1 = CLUSTER_Y - 1;
+        if (depth - range > m_near) {
+            glm::vec2 lo(1.0f), hi(-1.0f);
+            for (int corner = 0; corner < 8; corner++) {
+                glm::vec3 p = center + glm::vec3((corner & 1) ? range : -range, (corner & 2) ? range : -range,
+                                                 (corner & 4) ? range : -range);
+                glm::vec4 clip = proj * glm::vec4(p, 1.0f);
+                glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                lo = glm::min(lo, ndc);
+                hi = glm::max(hi, ndc);
+            }
+            if (hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f) return false;
+            box.x0 = tileOf(lo.x, CLUSTER_X);
+            box.x1 = tileOf(hi.x, CLUSTER_X);
+            box.y0 = tileOf(lo.y, CLUSTER_Y);
+            box.y1 = tileOf(hi.y, CLUSTER_Y);
+        }
+        return true;
+    }
+
+    // NDC [-1, 1] to tile; the shader maps gl_FragCoord the same way
+    static uint32_t tileOf(float ndc, uint32_t tiles) {
+        float t = (glm::clamp(ndc, -1.0f, 1.0f) * 0.5f + 0.5f) * float(tiles);
+        return std::min(static_cast<uint32_t>(t), tiles - 1);
+    }
+
+    template <typename Fn>
+    static void forEachCluster(const Box& box, Fn&& fn) {
+        for (uint32_t z = box.z0; z <= box.z1; z++) {
+            for (uint32_t y = box.y0; y <= box.y1; y++) {
+                for (uint32_t x = box.x0; x <= box.x1; x++) {
+                    fn((z * CLUSTER_Y + y) * CLUSTER_X + x);
+                }
+            }
+        }
+    }
+
+    bool m_enabled = true;
+    float m_near = 0.1f;  // VulkanCore's default perspective
+    float m_far = 1000.0f;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+
+    std::vector<glm::uvec2> m_ranges = std::vector<glm::uvec2>(CLUSTER_COUNT, glm::uvec2(0));
+    std::vector<uint32_t> m_indices;
+    std::vector<Box> m_boxes;
+    Stats m_stats;
+};
+
+} // namespace lighting
+
+#endif // LIGHT_CLUSTERS_H
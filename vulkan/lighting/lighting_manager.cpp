@@ -3,6 +3,8 @@
 // ============================================================================
 
 #include "lighting_manager.h"
+#include "../../stdlib/vfs.h"
+#include "../../stdlib/system_profiler.h"  // EDEN_PROFILE_API() on the C API
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -10,7 +12,8 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <set>
+#include <algorithm>
+#include <cstring>
 
 namespace lighting {
 
@@ -19,7 +22,7 @@ namespace lighting {
 // ============================================================================
 
 static std::vector<char> readShaderFile(const std::string& path) {
-    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    VfsInputStream file(path, std::ios::ate | std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "[Lighting] Failed to open shader: " << path << std::endl;
         return {};
@@ -32,6 +35,52 @@ static std::vector<char> readShaderFile(const std::string& path) {
     return buffer;
 }
 
+// ============================================================================
+// Helper: Draw capture encoding
+// ============================================================================
+
+// Commands under LightingManager::CAPTURE_TAG
+enum class CaptureOp : uint8_t {
+    State = 1,          // See captureState()
+    Bind,
+    BindTexture,        // u32 texture
+    DrawLitMesh,        // u32 mesh, mat4 model, vec4 color
+    DrawLitInstanced,   // u32 mesh, u32 count, u8 hasColors, count mat4 [, count vec4]
+    DrawLitBatch        // u32 texture, then as DrawLitInstanced
+};
+
+// remap.objects namespaces for replayed point lights and shadow casters
+static constexpr uint32_t LIGHT_OBJECTS = vkcore::captureTag("LITL");
+static constexpr uint32_t CASTER_OBJECTS = vkcore::captureTag("LITS");
+
+static void writeInstances(vkcore::CaptureWriter& out, const glm::mat4* models, const glm::vec4* colors, uint32_t count) {
+    out.u32(count);
+    out.u8(colors ? 1 : 0);
+    out.bytes(models, sizeof(glm::mat4) * count);
+    if (colors) out.bytes(colors, sizeof(glm::vec4) * count);
+}
+
+// Copied out of the stream: its bytes carry no alignment
+static bool readInstances(vkcore::CaptureReader& in, std::vector<glm::mat4>& models, std::vector<glm::vec4>& colors) {
+    uint32_t count = in.u32();
+    bool hasColors = in.u8() != 0;
+    if (!in.ok() || count > in.remaining() / sizeof(glm::mat4)) return false;
+    models.resize(count);
+    in.bytes(models.data(), sizeof(glm::mat4) * count);
+    colors.resize(hasColors ? count : 0);
+    if (hasColors) in.bytes(colors.data(), sizeof(glm::vec4) * count);
+    return in.ok() && count > 0;
+}
+
+static bool sameShadowConfig(const ShadowConfig& a, const ShadowConfig& b) {
+    return a.cascadeCount == b.cascadeCount && a.resolution == b.resolution && a.maxDistance == b.maxDistance &&
+           a.splitLambda == b.splitLambda && a.cachedCascades == b.cachedCascades &&
+           a.cachedUpdatesPerFrame == b.cachedUpdatesPerFrame && a.cacheMoveThreshold == b.cacheMoveThreshold &&
+           a.casterPullback == b.casterPullback && a.pcfRadius == b.pcfRadius &&
+           a.depthBiasConstant == b.depthBiasConstant && a.depthBiasSlope == b.depthBiasSlope &&
+           a.normalOffset == b.normalOffset;
+}
+
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
@@ -50,6 +99,18 @@ LightingManager::~LightingManager() {
 // Lifecycle
 // ============================================================================
 
+bool LightingManager::setVertexFormat(vkcore::VertexFormat format) {
+    if (m_initialized) {
+        std::cerr << "[Lighting] setVertexFormat must be called before init()" << std::endl;
+        return false;
+    }
+    if (format != vkcore::VertexFormat::POSITION_NORMAL_UV && format != vkcore::VertexFormat::PACKED_POSITION_NORMAL_UV) {
+        return false;
+    }
+    m_vertexFormat = format;
+    return true;
+}
+
 bool LightingManager::init(vkcore::VulkanCore* core) {
     if (m_initialized) {
         std::cerr << "[Lighting] Already initialized!" << std::endl;
@@ -61,6 +122,12 @@ bool LightingManager::init(vkcore::VulkanCore* core) {
         return false;
     }
     
+    // Textures are sampled from VulkanCore's bindless heap
+    if (!core->hasBindlessHeap()) {
+        std::cerr << "[Lighting] VulkanCore has no bindless heap (VK_EXT_descriptor_indexing)!" << std::endl;
+        return false;
+    }
+    
     m_core = core;
     
     std::cout << "[Lighting] Initializing..." << std::endl;
@@ -76,8 +143,22 @@ bool LightingManager::init(vkcore::VulkanCore* core) {
         return false;
     }
     
-    // Initialize UBO with default values
-    updateGPUBuffer();
+    // Shadows are optional - without the depth shader the map stays cleared
+    // and the lit shader skips the lookup
+    if (!createShadowPipeline()) {
+        std::cerr << "[Lighting] Shadow pipeline unavailable (shadow_depth.vert.spv) - "
+                  << "rendering without shadows" << std::endl;
+    }
+    
+    // Probe uploads and shadow maps go before the main render pass begins,
+    // after passes that write vertices (skinning)
+    m_prologue = m_core->addFramePrologue([this](VkCommandBuffer cmd) {
+        uploadProbes(cmd);
+        renderShadows(cmd);
+    }, vkcore::PROLOGUE_ORDER_SHADOWS);
+    
+    // One bound texture per recording thread (VulkanCore::recordParallel)
+    m_currentTextures.assign(m_core->getRecordingSlotCount(), vkcore::INVALID_TEXTURE);
     
     m_initialized = true;
     std::cout << "[Lighting] Initialized successfully" << std::endl;
@@ -95,73 +176,81 @@ void LightingManager::shutdown() {
     VkDevice device = m_core->getDevice();
     vkDeviceWaitIdle(device);
     
-    // Destroy pipeline
+    m_core->removeFramePrologue(m_prologue);
+    m_prologue = 0;
+    
+    // Destroy pipelines
     if (m_pipeline != VK_NULL_HANDLE) {
         vkDestroyPipeline(device, m_pipeline, nullptr);
         m_pipeline = VK_NULL_HANDLE;
     }
     
+    if (m_instancedPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, m_instancedPipeline, nullptr);
+        m_instancedPipeline = VK_NULL_HANDLE;
+    }
+    
+    if (m_batchPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, m_batchPipeline, nullptr);
+        m_batchPipeline = VK_NULL_HANDLE;
+    }
+    
     if (m_pipelineLayout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
         m_pipelineLayout = VK_NULL_HANDLE;
     }
     
-    // Free all descriptor sets before destroying the pool
-    if (m_descriptorPool != VK_NULL_HANDLE) {
-        // Free all allocated descriptor sets
-        std::vector<VkDescriptorSet> setsToFree;
-        for (const auto& pair : m_textureDescriptorSets) {
-            setsToFree.push_back(pair.second);
-        }
-        if (!setsToFree.empty()) {
-            vkFreeDescriptorSets(device, m_descriptorPool, static_cast<uint32_t>(setsToFree.size()), setsToFree.data());
-        }
-        m_textureDescriptorSets.clear();
-        m_currentDescriptorSet = VK_NULL_HANDLE;
-        
-        vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
-        m_descriptorPool = VK_NULL_HANDLE;
+    if (m_shadowPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, m_shadowPipeline, nullptr);
+        m_shadowPipeline = VK_NULL_HANDLE;
     }
     
-    if (m_descriptorSetLayout != VK_NULL_HANDLE) {
-        vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
-        m_descriptorSetLayout = VK_NULL_HANDLE;
+    if (m_shadowPipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, m_shadowPipelineLayout, nullptr);
+        m_shadowPipelineLayout = VK_NULL_HANDLE;
     }
     
-    if (m_uboBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(device, m_uboBuffer, nullptr);
-        m_uboBuffer = VK_NULL_HANDLE;
-    }
+    // Device is idle, so the map goes now rather than through deferDestroy()
+    destroyShadowMap(m_shadowMap);
     
-    if (m_uboMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, m_uboMemory, nullptr);
-        m_uboMemory = VK_NULL_HANDLE;
+    if (m_shadowRenderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(device, m_shadowRenderPass, nullptr);
+        m_shadowRenderPass = VK_NULL_HANDLE;
     }
     
-    // Cleanup default texture
-    if (m_defaultSampler != VK_NULL_HANDLE) {
-        vkDestroySampler(device, m_defaultSampler, nullptr);
-        m_defaultSampler = VK_NULL_HANDLE;
+    if (m_shadowSampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, m_shadowSampler, nullptr);
+        m_shadowSampler = VK_NULL_HANDLE;
     }
     
-    if (m_defaultTexView != VK_NULL_HANDLE) {
-        vkDestroyImageView(device, m_defaultTexView, nullptr);
-        m_defaultTexView = VK_NULL_HANDLE;
+    destroyProbeVolume(m_probeVolume);
+    destroyProbeVolume(m_pendingProbes);
+    
+    if (m_probeSampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, m_probeSampler, nullptr);
+        m_probeSampler = VK_NULL_HANDLE;
     }
     
-    if (m_defaultTexImage != VK_NULL_HANDLE) {
-        vkDestroyImage(device, m_defaultTexImage, nullptr);
-        m_defaultTexImage = VK_NULL_HANDLE;
+    // Back to the shared VulkanCore pools
+    for (FrameLights& frame : m_frames) {
+        if (frame.set != VK_NULL_HANDLE) {
+            m_core->getDescriptorAllocator().free(frame.set);
+        }
+        for (int i = 0; i < 4; i++) {
+            m_core->getAllocator().destroyBuffer(frame.buffers[i], frame.allocs[i]);
+        }
+        m_core->getAllocator().destroyBuffer(frame.ubo, frame.uboAlloc);
     }
+    m_frames.clear();
     
-    if (m_defaultTexMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, m_defaultTexMemory, nullptr);
-        m_defaultTexMemory = VK_NULL_HANDLE;
+    if (m_descriptorSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
+        m_descriptorSetLayout = VK_NULL_HANDLE;
     }
     
     m_core = nullptr;
     m_initialized = false;
-    m_currentDescriptorSet = VK_NULL_HANDLE;
+    m_currentTextures.clear();
     m_litPipeline = vkcore::INVALID_PIPELINE;
     
     std::cout << "[Lighting] Shutdown complete" << std::endl;
@@ -175,214 +264,255 @@ void LightingManager::setDirectionalLight(const glm::vec3& direction, const glm:
     m_directionalLight.direction = glm::normalize(direction);
     m_directionalLight.color = color;
     m_directionalLight.intensity = intensity;
+    markUboDirty();
 }
 
 void LightingManager::setDirectionalLight(const DirectionalLight& light) {
     m_directionalLight = light;
     m_directionalLight.direction = glm::normalize(m_directionalLight.direction);
+    markUboDirty();
 }
 
 void LightingManager::setAmbientLight(const glm::vec3& color) {
     m_ambientLight.color = color;
+    markUboDirty();
 }
 
 void LightingManager::setAmbientLight(const AmbientLight& light) {
     m_ambientLight = light;
+    markUboDirty();
 }
 
 void LightingManager::setCameraPosition(const glm::vec3& position) {
+    // Usually re-set every frame; a still camera shouldn't cost an upload
+    if (position == m_cameraPos) return;
     m_cameraPos = position;
+    markUboDirty();
 }
 
 void LightingManager::setShininess(float shininess) {
     m_shininess = glm::clamp(shininess, 1.0f, 256.0f);
+    markUboDirty();
 }
 
 void LightingManager::setSpecularStrength(float strength) {
     m_specularStrength = glm::clamp(strength, 0.0f, 1.0f);
+    markUboDirty();
 }
 
 void LightingManager::setDebugMode(int mode) {
     m_debugMode = mode;
+    markUboDirty();
 }
 
 // ============================================================================
 // Point Lights
 // ============================================================================
 
-bool LightingManager::setPointLight(int index, const glm::vec3& position, const glm::vec3& color,
+PointLightHandle LightingManager::addPointLight(const glm::vec3& position, const glm::vec3& color,
+                                                float intensity, float range) {
+    return addPointLight(PointLight(position, color, intensity, range));
+}
+
+PointLightHandle LightingManager::addPointLight(const PointLight& light) {
+    uint32_t handle = m_pointLights.insert(light);
+    if (handle == vkcore::HandlePool<PointLight>::INVALID_HANDLE) {
+        std::cerr << "[Lighting] Point light pool exhausted" << std::endl;
+        return INVALID_POINT_LIGHT;
+    }
+    markLightsDirty();
+    return handle;
+}
+
+void LightingManager::removePointLight(PointLightHandle light) {
+    if (m_pointLights.remove(light)) markLightsDirty();
+}
+
+bool LightingManager::setPointLight(PointLightHandle light, const glm::vec3& position, const glm::vec3& color,
                                      float intensity, float range) {
-    if (index < 0 || index >= MAX_POINT_LIGHTS) return false;
-    
-    m_pointLights[index].position = position;
-    m_pointLights[index].color = color;
-    m_pointLights[index].intensity = intensity;
-    m_pointLights[index].range = range;
-    m_pointLights[index].enabled = true;
+    PointLight* data = m_pointLights.get(light);
+    if (!data) return false;
+    
+    data->position = position;
+    data->color = color;
+    data->intensity = intensity;
+    data->range = range;
+    data->enabled = true;
+    markLightsDirty();
     return true;
 }
 
-bool LightingManager::setPointLight(int index, const PointLight& light) {
-    if (index < 0 || index >= MAX_POINT_LIGHTS) return false;
-    m_pointLights[index] = light;
+bool LightingManager::setPointLight(PointLightHandle light, const PointLight& data) {
+    PointLight* existing = m_pointLights.get(light);
+    if (!existing) return false;
+    *existing = data;
+    markLightsDirty();
     return true;
 }
 
-void LightingManager::enablePointLight(int index, bool enabled) {
-    if (index >= 0 && index < MAX_POINT_LIGHTS) {
-        m_pointLights[index].enabled = enabled;
+void LightingManager::enablePointLight(PointLightHandle light, bool enabled) {
+    if (PointLight* data = m_pointLights.get(light)) {
+        data->enabled = enabled;
+        markLightsDirty();
     }
 }
 
-static PointLight s_defaultPointLight;  // Default for invalid index
+static PointLight s_defaultPointLight;  // Default for stale handles
 
-const PointLight& LightingManager::getPointLight(int index) const {
-    if (index >= 0 && index < MAX_POINT_LIGHTS) {
-        return m_pointLights[index];
-    }
-    return s_defaultPointLight;
+const PointLight& LightingManager::getPointLight(PointLightHandle light) const {
+    const PointLight* data = m_pointLights.get(light);
+    return data ? *data : s_defaultPointLight;
 }
 
 void LightingManager::clearPointLights() {
-    for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
-        m_pointLights[i] = PointLight();
-    }
+    m_pointLights.clear();
+    markLightsDirty();
 }
 
 int LightingManager::getActivePointLightCount() const {
     int count = 0;
-    for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
-        if (m_pointLights[i].enabled && m_pointLights[i].intensity > 0.0f) {
-            count++;
-        }
-    }
+    m_pointLights.forEach([&](uint32_t, const PointLight& light) {
+        if (light.enabled && light.intensity > 0.0f) count++;
+    });
     return count;
 }
 
 // ============================================================================
-// Texture Support
+// Shadows
 // ============================================================================
 
-// Helper: Get or create a descriptor set for a given texture
-// Each texture gets its own descriptor set, preventing texture sharing
-VkDescriptorSet LightingManager::getOrCreateDescriptorSet(vkcore::TextureHandle texture) {
-    if (!m_initialized || !m_core) return VK_NULL_HANDLE;
-    
-    // Use special handle for default texture
-    vkcore::TextureHandle lookupHandle = (texture == vkcore::INVALID_TEXTURE) ? m_defaultTextureHandle : texture;
-    
-    // Check if we already have a descriptor set for this texture
-    auto it = m_textureDescriptorSets.find(lookupHandle);
-    if (it != m_textureDescriptorSets.end()) {
-        return it->second;
-    }
-    
-    // Need to create a new descriptor set for this texture
-    VkDevice device = m_core->getDevice();
-    
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = m_descriptorPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+ShadowCasterHandle LightingManager::addShadowCaster(vkcore::MeshHandle mesh, const glm::mat4& model, bool isStatic) {
+    ShadowCaster caster;
+    caster.mesh = mesh;
+    caster.model = model;
+    caster.isStatic = isStatic;
     
-    VkDescriptorSet newSet = VK_NULL_HANDLE;
-    if (vkAllocateDescriptorSets(device, &allocInfo, &newSet) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to allocate descriptor set for texture!" << std::endl;
-        return VK_NULL_HANDLE;
+    uint32_t handle = m_shadowCasters.insert(caster);
+    if (handle == vkcore::HandlePool<ShadowCaster>::INVALID_HANDLE) {
+        std::cerr << "[Lighting] Shadow caster pool exhausted" << std::endl;
+        return INVALID_SHADOW_CASTER;
     }
+    if (isStatic) m_cascades.invalidate();
+    return handle;
+}
+
+bool LightingManager::setShadowCasterTransform(ShadowCasterHandle caster, const glm::mat4& model) {
+    ShadowCaster* data = m_shadowCasters.get(caster);
+    if (!data) return false;
     
-    // Get texture info from VulkanCore, or use default
-    VkImageView view = m_defaultTexView;
-    VkSampler sampler = m_defaultSampler;
-    bool usingLoadedTex = false;
-    
-    if (texture != vkcore::INVALID_TEXTURE) {
-        if (m_core->getTextureInfo(texture, view, sampler)) {
-            usingLoadedTex = true;
-        } else {
-            // Texture not valid, use default
-            std::cerr << "[Lighting] getTextureInfo failed for texture " << texture << ", using default" << std::endl;
-            view = m_defaultTexView;
-            sampler = m_defaultSampler;
+    // Dynamic casters are redrawn every frame anyway; only moving static
+    // ones costs a cached cascade re-render
+    if (data->isStatic && data->model != model) m_cascades.invalidate();
+    data->model = model;
+    return true;
+}
+
+void LightingManager::removeShadowCaster(ShadowCasterHandle caster) {
+    const ShadowCaster* data = m_shadowCasters.get(caster);
+    if (!data) return;
+    if (data->isStatic) m_cascades.invalidate();
+    m_shadowCasters.remove(caster);
+}
+
+void LightingManager::clearShadowCasters() {
+    m_shadowCasters.clear();
+    m_cascades.invalidate();
+}
+
+void LightingManager::setShadowConfig(const ShadowConfig& config) {
+    m_cascades.setConfig(config);
+    markUboDirty();
+    if (!m_initialized) return;  // init() sizes the map from the config
+    
+    // Layers and resolution fix the image; everything else is per frame
+    const ShadowConfig& applied = m_cascades.getConfig();
+    uint32_t layers = std::max(applied.cascadeCount, 1u);
+    uint32_t resolution = applied.cascadeCount > 0 ? applied.resolution : 1u;
+    if (layers != m_shadowMap.layers || resolution != m_shadowMap.resolution) {
+        if (!createShadowMap(resolution, layers)) {
+            std::cerr << "[Lighting] Failed to reallocate the shadow map - keeping the old one" << std::endl;
+            ShadowConfig fallback = applied;
+            fallback.cascadeCount = std::min(applied.cascadeCount, m_shadowMap.layers);
+            fallback.resolution = m_shadowMap.resolution;
+            m_cascades.setConfig(fallback);
         }
     }
-    
-    std::cout << "[Lighting] Creating descriptor set for texture " << texture 
-              << " (using " << (usingLoadedTex ? "loaded" : "default") << " texture)"
-              << ", view: " << (view != VK_NULL_HANDLE ? "valid" : "NULL")
-              << ", sampler: " << (sampler != VK_NULL_HANDLE ? "valid" : "NULL") << std::endl;
-    
-    // Update the new descriptor set with UBO and texture
-    VkDescriptorBufferInfo bufferInfo{};
-    bufferInfo.buffer = m_uboBuffer;
-    bufferInfo.offset = 0;
-    bufferInfo.range = sizeof(LightingUBO);
-    
-    // Debug: Verify UBO buffer is valid
-    if (m_uboBuffer == VK_NULL_HANDLE) {
-        std::cerr << "[Lighting] ERROR: UBO buffer is NULL when creating descriptor set!" << std::endl;
-        return VK_NULL_HANDLE;
+}
+
+// ============================================================================
+// Irradiance Probes
+// ============================================================================
+
+bool LightingManager::setIrradianceProbes(const IrradianceProbeGrid& grid) {
+    if (!m_initialized) {
+        std::cerr << "[Lighting] setIrradianceProbes() before init()" << std::endl;
+        return false;
+    }
+    if (grid.empty()) {
+        std::cerr << "[Lighting] Empty probe grid - keeping the current ambient" << std::endl;
+        return false;
     }
     
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = view;
-    imageInfo.sampler = sampler;
-    
-    std::vector<VkWriteDescriptorSet> writes(2);
-    
-    // UBO binding
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].dstSet = newSet;
-    writes[0].dstBinding = 0;
-    writes[0].dstArrayElement = 0;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[0].descriptorCount = 1;
-    writes[0].pBufferInfo = &bufferInfo;
-    
-    // Texture binding
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = newSet;
-    writes[1].dstBinding = 1;
-    writes[1].dstArrayElement = 0;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    writes[1].descriptorCount = 1;
-    writes[1].pImageInfo = &imageInfo;
-    
-    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    ProbeVolume volume;
+    if (!createProbeVolume(&grid, volume)) return false;
     
-    // Store the new descriptor set
-    m_textureDescriptorSets[lookupHandle] = newSet;
+    // A replacement that never reached the GPU can go straight away
+    destroyProbeVolume(m_pendingProbes);
+    m_pendingProbes = volume;
+    std::cout << "[Lighting] Probe grid " << grid.dims.x << "x" << grid.dims.y << "x" << grid.dims.z
+              << " queued for upload" << std::endl;
+    return true;
+}
+
+void LightingManager::clearIrradianceProbes() {
+    if (!m_initialized || (!m_probeVolume.enabled && !m_pendingProbes.enabled)) return;
     
-    return newSet;
+    ProbeVolume volume;
+    if (!createProbeVolume(nullptr, volume)) return;
+    destroyProbeVolume(m_pendingProbes);
+    m_pendingProbes = volume;
+}
+
+void LightingManager::setProbeIntensity(float intensity) {
+    m_probeIntensity = std::max(intensity, 0.0f);
+    markUboDirty();
 }
 
+// ============================================================================
+// Texture Support
+// ============================================================================
+
 void LightingManager::bindTexture(vkcore::TextureHandle texture) {
     if (!m_initialized || !m_core) return;
     
-    // Get or create descriptor set for this texture
-    m_currentDescriptorSet = getOrCreateDescriptorSet(texture);
-    
-    // Debug: Print first time a texture is bound
-    static std::set<vkcore::TextureHandle> debuggedTextures;
-    if (debuggedTextures.find(texture) == debuggedTextures.end()) {
-        debuggedTextures.insert(texture);
-        std::cout << "[Lighting] Bound texture " << texture 
-                  << ", descriptorSet: " << (m_currentDescriptorSet != VK_NULL_HANDLE ? "valid" : "NULL!") << std::endl;
+    if (vkcore::DrawCapture* capture = recordingCapture()) {
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        vkcore::CaptureWriter out(payload);
+        out.u8(uint8_t(CaptureOp::BindTexture));
+        out.u32(texture);
+        capture->extension(CAPTURE_TAG, payload);
     }
+    
+    // drawLitMesh() pushes its heap slot with the per-object constants
+    // (invalid handles map to VulkanCore's white texture)
+    currentTexture() = texture;
 }
 
 // ============================================================================
 // Matrices
 // ============================================================================
 
+// Both feed the cluster build, so only an actual change re-bins the lights
 void LightingManager::setViewMatrix(const glm::mat4& view) {
+    if (view == m_viewMatrix) return;
     m_viewMatrix = view;
+    markLightsDirty();
 }
 
 void LightingManager::setProjectionMatrix(const glm::mat4& proj) {
+    if (proj == m_projMatrix) return;
     m_projMatrix = proj;
+    markLightsDirty();
 }
 
 // ============================================================================
@@ -396,41 +526,103 @@ void LightingManager::bind() {
         return;
     }
     
-    // Debug: Print once per session
-    static bool debugPrinted = false;
-    if (!debugPrinted) {
-        debugPrinted = true;
-        std::cout << "[Lighting] bind() called - pipeline: " << (m_pipeline != VK_NULL_HANDLE ? "valid" : "NULL")
-                  << ", descriptorSet: " << (m_currentDescriptorSet != VK_NULL_HANDLE ? "valid" : "NULL") << std::endl;
+    // Captures take the state with the frame's first bind() and after changes
+    if (vkcore::DrawCapture* capture = recordingCapture()) {
+        if (!m_core->isRecordingTask() &&
+            (m_captureFrame != m_core->getFrameNumber() || m_captureUboVersion != m_uboVersion ||
+             m_captureLightsVersion != m_lightsVersion)) {
+            captureState(*capture);
+        }
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        payload.push_back(uint8_t(CaptureOp::Bind));
+        capture->extension(CAPTURE_TAG, payload);
+    }
+    
+    // Inside a VulkanCore::recordParallel task: the UBO is shared, so only
+    // bind the pipeline and sets into this task's command buffer. Call bind()
+    // on the main thread first to upload the frame's lighting data.
+    if (m_core->isRecordingTask()) {
+        bindPipelineAndSets(m_core->getCurrentCommandBuffer());
+        return;
+    }
+    
+    // The cluster tiles follow the scene's render size (the swapchain size
+    // without dynamic resolution). Tiles are fractions of the screen, so a
+    // new size only changes the tile size in the UBO, not the binning
+    if (m_core->getRenderWidth() != m_clusterWidth || m_core->getRenderHeight() != m_clusterHeight) {
+        m_clusterWidth = m_core->getRenderWidth();
+        m_clusterHeight = m_core->getRenderHeight();
+        m_clusters.setScreenSize(m_clusterWidth, m_clusterHeight);
+        markUboDirty();
+    }
+    
+    // Each frame slot keeps the versions its buffers were written with:
+    // an unchanged frame, and every bind() after the first, uploads nothing
+    uint32_t frame = m_core->getCurrentFrame() % m_frames.size();
+    FrameLights& slot = m_frames[frame];
+    if (slot.lightsVersion != m_lightsVersion) {
+        updateLightBuffers(frame);
+    }
+    
+    // First bind() of a frame: restart the batch SSBO, grown first if last
+    // frames asked for more than it holds (the set isn't bound yet)
+    if (m_batchFrame != m_core->getFrameNumber()) {
+        m_batchFrame = m_core->getFrameNumber();
+        m_batchPeak = std::max(m_batchPeak, m_batchRequested);
+        m_batchHead = 0;
+        m_batchRequested = 0;
+        VkBuffer oldBatch = slot.buffers[3];
+        if (ensureStorage(frame, 3, VkDeviceSize(m_batchPeak) * sizeof(vkcore::InstanceData)) &&
+            slot.buffers[3] != oldBatch) {
+            slot.setStale = true;
+        }
+    }
+    if (slot.setStale) {
+        writeFrameSet(frame);
+    }
+    if (slot.uboVersion != m_uboVersion) {
+        packUBO();
+        updateGPUBuffer(frame);
     }
     
-    // Update UBO with per-frame data (view, projection, lights)
-    // Per-object data (model, color) is handled via push constants in drawLitMesh
+    bindPipelineAndSets(m_core->getCurrentCommandBuffer());
+}
+
+// Per-frame constants for the lit shaders; per-object data (model, color)
+// goes through push constants in drawLitMesh
+void LightingManager::packUBO() {
     m_uboData.view = m_viewMatrix;
     m_uboData.projection = m_projMatrix;
     m_uboData.lightDir = glm::vec4(m_directionalLight.direction, m_directionalLight.intensity);
     m_uboData.lightColor = glm::vec4(m_directionalLight.color, 1.0f);
     m_uboData.ambientColor = glm::vec4(m_ambientLight.color, 1.0f);
     m_uboData.cameraPos = glm::vec4(m_cameraPos, 1.0f);
-    
-    // Count active point lights and pack data
-    int numPointLights = 0;
-    for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
-        if (m_pointLights[i].enabled && m_pointLights[i].intensity > 0.0f) {
-            m_uboData.pointLightPosInt[numPointLights] = glm::vec4(
-                m_pointLights[i].position, m_pointLights[i].intensity);
-            m_uboData.pointLightColorRange[numPointLights] = glm::vec4(
-                m_pointLights[i].color, m_pointLights[i].range);
-            numPointLights++;
-        }
-    }
-    // Zero out remaining slots
-    for (int i = numPointLights; i < MAX_POINT_LIGHTS; ++i) {
-        m_uboData.pointLightPosInt[i] = glm::vec4(0.0f);
-        m_uboData.pointLightColorRange[i] = glm::vec4(0.0f);
-    }
-    
-    m_uboData.material = glm::vec4(m_shininess, m_specularStrength, float(numPointLights), float(m_debugMode));
+    m_uboData.material = glm::vec4(m_shininess, m_specularStrength, 0.0f, float(m_debugMode));
+    m_uboData.clusterGrid = m_clusters.gridParams(static_cast<uint32_t>(m_gpuLights.size()));
+    m_uboData.clusterDepth = m_clusters.depthParams();
+    m_uboData.clusterScreen = m_clusters.screenParams();
+    
+    // Cascades as rendered by this frame's prologue (cached ones may be
+    // older - they are sampled with the matrix they were rendered with)
+    uint32_t cascadeCount = m_shadowPipeline != VK_NULL_HANDLE ? m_cascades.getCascadeCount() : 0;
+    for (uint32_t c = 0; c < MAX_CASCADES; c++) {
+        const ShadowCascades::Cascade& cascade = m_cascades.get(c);
+        m_uboData.cascadeViewProj[c] = cascade.viewProj;
+        m_uboData.cascadeSplits[c] = c < cascadeCount ? cascade.splitFar : 0.0f;
+        m_uboData.cascadeTexelSize[c] = cascade.texelSize;
+    }
+    const ShadowConfig& shadows = m_cascades.getConfig();
+    m_uboData.shadowParams = glm::vec4(float(cascadeCount), float(shadows.pcfRadius),
+                                       1.0f / float(std::max(m_shadowMap.resolution, 1u)), shadows.normalOffset);
+    
+    // Probe grid as uploaded; the lookup is pushed a quarter cell off the
+    // surface so it doesn't blend in probes behind (inside) it
+    const ProbeVolume& probes = m_probeVolume;
+    glm::vec3 spacing = glm::max(probes.spacing, glm::vec3(1e-4f));
+    m_uboData.probeOrigin = glm::vec4(probes.origin, probes.enabled ? 1.0f : 0.0f);
+    m_uboData.probeInvSpacing = glm::vec4(1.0f / spacing, 0.25f * std::min(spacing.x, std::min(spacing.y, spacing.z)));
+    m_uboData.probeDims = glm::vec4(float(probes.extent.width), float(probes.extent.height), float(probes.extent.depth),
+                                    m_probeIntensity);
     
     // Debug: Print UBO data once
     static bool uboDebugPrinted = false;
@@ -441,19 +633,20 @@ void LightingManager::bind() {
         std::cout << "  Light color: (" << m_uboData.lightColor.x << ", " << m_uboData.lightColor.y << ", " << m_uboData.lightColor.z << ")" << std::endl;
         std::cout << "  Ambient: (" << m_uboData.ambientColor.x << ", " << m_uboData.ambientColor.y << ", " << m_uboData.ambientColor.z << ")" << std::endl;
         std::cout << "  Camera pos: (" << m_uboData.cameraPos.x << ", " << m_uboData.cameraPos.y << ", " << m_uboData.cameraPos.z << ")" << std::endl;
-        std::cout << "  Material: shininess=" << m_uboData.material.x << ", specular=" << m_uboData.material.y << ", numLights=" << m_uboData.material.z << std::endl;
+        std::cout << "  Material: shininess=" << m_uboData.material.x << ", specular=" << m_uboData.material.y << ", numLights=" << m_uboData.clusterGrid.w << std::endl;
         glm::vec3 projScale = glm::vec3(m_uboData.projection[0][0], m_uboData.projection[1][1], m_uboData.projection[2][2]);
         std::cout << "  Projection scale: (" << projScale.x << ", " << projScale.y << ", " << projScale.z << ")" << std::endl;
     }
-    
-    // Upload per-frame data to GPU
-    updateGPUBuffer();
-    
-    VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
-    
-    // Bind our pipeline
-    // Note: Descriptor set binding happens in drawLitMesh() after bindTexture() is called
+}
+
+// Set 0 (UBO + this frame's lights) and set 1 (bindless heap) stay bound
+// for every draw after this; textures change through push constants only
+void LightingManager::bindPipelineAndSets(VkCommandBuffer cmd) {
+    VkDescriptorSet set = currentSet();
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_pipelineLayout, 0, 1, &set, 0, nullptr);
+    m_core->getBindlessHeap().bind(cmd, m_pipelineLayout, vkcore::BINDLESS_SET);
 }
 
 void LightingManager::drawLitMesh(vkcore::MeshHandle mesh, 
@@ -465,6 +658,21 @@ void LightingManager::drawLitMesh(vkcore::MeshHandle mesh,
         return;
     }
     
+    vkcore::CaptureCall call;
+    vkcore::DrawCapture* capture = recordingCapture();
+    if (capture && call.outermost()) {
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        vkcore::CaptureWriter out(payload);
+        out.u8(uint8_t(CaptureOp::DrawLitMesh));
+        out.u32(capture->meshId(mesh));
+        out.mat4(model);
+        out.vec4(color);
+        capture->extension(CAPTURE_TAG, payload);
+    }
+    
+    // Still in flight on the transfer queue - skip silently
+    if (!m_core->isMeshReady(mesh)) return;
+    
     // Get mesh buffers from VulkanCore
     VkBuffer vertexBuffer, indexBuffer;
     uint32_t indexCount;
@@ -473,27 +681,20 @@ void LightingManager::drawLitMesh(vkcore::MeshHandle mesh,
         if (!warnedOnce) { warnedOnce = true; std::cerr << "[Lighting] drawLitMesh: getMeshBuffers failed for mesh " << mesh << std::endl; }
         return;
     }
+    uint32_t firstIndex = 0;
+    m_core->getMeshLod(mesh, model, firstIndex, indexCount);
     
     VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
     
-    // Bind the descriptor set for the current texture (set by bindTexture())
-    // Each texture has its own descriptor set, preventing texture sharing
-    if (m_currentDescriptorSet != VK_NULL_HANDLE) {
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                m_pipelineLayout, 0, 1, &m_currentDescriptorSet, 0, nullptr);
-    } else {
-        static bool warnedOnce = false;
-        if (!warnedOnce) { warnedOnce = true; std::cerr << "[Lighting] drawLitMesh: No descriptor set bound! Call bindTexture first." << std::endl; }
-        return;  // Can't render without a descriptor set
-    }
-    
-    // Use push constants for per-object data (model matrix and color)
-    // This allows multiple objects to be drawn without UBO synchronization issues
+    // Use push constants for per-object data (model matrix, color and the
+    // bindless slot of the texture set by bindTexture()). Sets were bound in bind().
     PushConstants pushData;
-    pushData.model = model;
+    const glm::mat4* dequantize = m_core->getMeshDequantization(mesh);
+    pushData.model = dequantize ? model * *dequantize : model;
     pushData.objectColor = color;
+    pushData.textureIndex = m_core->getBindlessIndex(currentTexture());
     
-    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 
+    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
                        0, sizeof(PushConstants), &pushData);
     
     VkDeviceSize offsets[] = {0};
@@ -509,269 +710,162 @@ void LightingManager::drawLitMesh(vkcore::MeshHandle mesh,
                   << ", indexBuffer=" << (indexBuffer != VK_NULL_HANDLE ? "valid" : "NULL") << std::endl;
     }
     
-    vkCmdDrawIndexed(cmd, indexCount, 1, 0, 0, 0);
+    vkCmdDrawIndexed(cmd, indexCount, 1, firstIndex, 0, 0);
 }
 
-// ============================================================================
-// Private: Create Resources
-// ============================================================================
-
-// Helper: find memory type
-static uint32_t findMemoryType(VkPhysicalDevice physDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(physDevice, &memProps);
-    
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && 
-            (memProps.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
+void LightingManager::drawLitMeshInstanced(vkcore::MeshHandle mesh,
+                                            const glm::mat4* models,
+                                            const glm::vec4* colors,
+                                            uint32_t count) {
+    if (!m_initialized || !m_core || !models || count == 0) return;
+    
+    vkcore::CaptureCall call;
+    vkcore::DrawCapture* capture = recordingCapture();
+    if (capture && call.outermost()) {
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        vkcore::CaptureWriter out(payload);
+        out.u8(uint8_t(CaptureOp::DrawLitInstanced));
+        out.u32(capture->meshId(mesh));
+        writeInstances(out, models, colors, count);
+        capture->extension(CAPTURE_TAG, payload);
+    }
+    
+    // No instanced shader - issue the draws one at a time
+    if (m_instancedPipeline == VK_NULL_HANDLE) {
+        for (uint32_t i = 0; i < count; i++) {
+            drawLitMesh(mesh, models[i], colors ? colors[i] : glm::vec4(1.0f));
         }
+        return;
     }
-    return UINT32_MAX;
-}
-
-bool LightingManager::createLightingResources() {
-    VkDevice device = m_core->getDevice();
-    VkPhysicalDevice physDevice = m_core->getPhysicalDevice();
     
-    // ========================================================================
-    // Create UBO Buffer
-    // ========================================================================
+    if (!m_core->isMeshReady(mesh)) return;
+    
+    VkBuffer vertexBuffer, indexBuffer;
+    uint32_t indexCount;
+    if (!m_core->getMeshBuffers(mesh, vertexBuffer, indexBuffer, indexCount)) return;
+    uint32_t firstIndex = 0;
+    m_core->getMeshLod(mesh, models, count, firstIndex, indexCount);
     
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = sizeof(LightingUBO);
-    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkBuffer instanceBuffer;
+    VkDeviceSize instanceOffset;
+    vkcore::InstanceData* instances = m_core->allocateInstances(count, instanceBuffer, instanceOffset);
+    if (!instances) return;
     
-    if (vkCreateBuffer(device, &bufferInfo, nullptr, &m_uboBuffer) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to create UBO buffer!" << std::endl;
-        return false;
+    const glm::mat4* dequantize = m_core->getMeshDequantization(mesh);
+    for (uint32_t i = 0; i < count; i++) {
+        instances[i].model = dequantize ? models[i] * *dequantize : models[i];
+        instances[i].color = colors ? colors[i] : glm::vec4(1.0f);
     }
     
-    VkMemoryRequirements memReq;
-    vkGetBufferMemoryRequirements(device, m_uboBuffer, &memReq);
+    VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
     
-    uint32_t memTypeIndex = findMemoryType(physDevice, memReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // Same layout as the regular pipeline, so the sets from bind() stay bound
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_instancedPipeline);
     
-    if (memTypeIndex == UINT32_MAX) {
-        std::cerr << "[Lighting] Failed to find suitable memory type!" << std::endl;
-        return false;
-    }
+    // Model/color come per instance; only the texture slot is read here
+    PushConstants pushData;
+    pushData.textureIndex = m_core->getBindlessIndex(currentTexture());
+    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(PushConstants), &pushData);
     
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReq.size;
-    allocInfo.memoryTypeIndex = memTypeIndex;
+    VkBuffer vertexBuffers[] = {vertexBuffer, instanceBuffer};
+    VkDeviceSize offsets[] = {0, instanceOffset};
+    vkCmdBindVertexBuffers(cmd, 0, 2, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
     
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &m_uboMemory) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to allocate UBO memory!" << std::endl;
-        return false;
-    }
+    vkCmdDrawIndexed(cmd, indexCount, count, firstIndex, 0, 0);
     
-    vkBindBufferMemory(device, m_uboBuffer, m_uboMemory, 0);
+    // Restore the regular lit pipeline for subsequent drawLitMesh() calls
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+}
+
+void LightingManager::drawLitMeshBatch(vkcore::MeshHandle mesh, vkcore::TextureHandle texture,
+                                        const glm::mat4* models, const glm::vec4* colors, uint32_t count) {
+    if (!m_initialized || !m_core || !models || count == 0) return;
+    
+    vkcore::CaptureCall call;
+    vkcore::DrawCapture* capture = recordingCapture();
+    if (capture && call.outermost()) {
+        std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+        vkcore::CaptureWriter out(payload);
+        out.u8(uint8_t(CaptureOp::DrawLitBatch));
+        out.u32(texture);
+        out.u32(capture->meshId(mesh));
+        writeInstances(out, models, colors, count);
+        capture->extension(CAPTURE_TAG, payload);
+    }
+    
+    // The SSBO is written from the main thread only; it also can't grow
+    // mid-frame, since the set holding it is already bound
+    m_batchRequested += count;
+    bool fits = m_batchHead + count <= m_frames[m_core->getCurrentFrame() % m_frames.size()].capacity[3] /
+                                         sizeof(vkcore::InstanceData);
+    if (m_batchPipeline == VK_NULL_HANDLE || m_core->isRecordingTask() || !fits) {
+        vkcore::TextureHandle& bound = currentTexture();
+        vkcore::TextureHandle previous = bound;
+        bound = texture;
+        drawLitMeshInstanced(mesh, models, colors, count);
+        bound = previous;
+        return;
+    }
     
-    // ========================================================================
-    // Create Default White Texture (1x1 pixel)
-    // ========================================================================
+    if (!m_core->isMeshReady(mesh)) return;
     
-    // Create image
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = 1;
-    imageInfo.extent.height = 1;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    VkBuffer vertexBuffer, indexBuffer;
+    uint32_t indexCount;
+    if (!m_core->getMeshBuffers(mesh, vertexBuffer, indexBuffer, indexCount)) return;
+    uint32_t firstIndex = 0;
+    m_core->getMeshLod(mesh, models, count, firstIndex, indexCount);
     
-    if (vkCreateImage(device, &imageInfo, nullptr, &m_defaultTexImage) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to create default texture image!" << std::endl;
-        return false;
+    FrameLights& slot = m_frames[m_core->getCurrentFrame() % m_frames.size()];
+    vkcore::InstanceData* instances = static_cast<vkcore::InstanceData*>(slot.allocs[3].mapped) + m_batchHead;
+    const glm::mat4* dequantize = m_core->getMeshDequantization(mesh);
+    for (uint32_t i = 0; i < count; i++) {
+        instances[i].model = dequantize ? models[i] * *dequantize : models[i];
+        instances[i].color = colors ? colors[i] : glm::vec4(1.0f);
     }
+    uint32_t firstInstance = m_batchHead;
+    m_batchHead += count;
     
-    VkMemoryRequirements imgMemReq;
-    vkGetImageMemoryRequirements(device, m_defaultTexImage, &imgMemReq);
+    VkCommandBuffer cmd = m_core->getCurrentCommandBuffer();
     
-    uint32_t imgMemType = findMemoryType(physDevice, imgMemReq.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    if (imgMemType == UINT32_MAX) {
-        std::cerr << "[Lighting] Failed to find image memory type!" << std::endl;
-        return false;
-    }
+    // Same layout as the regular pipeline, so the sets from bind() stay bound
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_batchPipeline);
     
-    VkMemoryAllocateInfo imgAllocInfo{};
-    imgAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    imgAllocInfo.allocationSize = imgMemReq.size;
-    imgAllocInfo.memoryTypeIndex = imgMemType;
+    PushConstants pushData;
+    pushData.textureIndex = m_core->getBindlessIndex(texture);
+    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(PushConstants), &pushData);
     
-    if (vkAllocateMemory(device, &imgAllocInfo, nullptr, &m_defaultTexMemory) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to allocate texture memory!" << std::endl;
-        return false;
-    }
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
     
-    vkBindImageMemory(device, m_defaultTexImage, m_defaultTexMemory, 0);
+    // gl_InstanceIndex starts at firstInstance: this batch's slice of the SSBO
+    vkCmdDrawIndexed(cmd, indexCount, count, firstIndex, 0, firstInstance);
     
-    // Upload white pixel data to the texture
-    {
-        // Create staging buffer with white pixel
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingMemory;
-        const uint32_t whitePixel = 0xFFFFFFFF;  // RGBA white
-        
-        VkBufferCreateInfo bufferInfo{};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = 4;  // 4 bytes for RGBA
-        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        
-        if (vkCreateBuffer(device, &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS) {
-            std::cerr << "[Lighting] Failed to create staging buffer!" << std::endl;
-            return false;
-        }
-        
-        VkMemoryRequirements stagingMemReq;
-        vkGetBufferMemoryRequirements(device, stagingBuffer, &stagingMemReq);
-        
-        uint32_t stagingMemType = findMemoryType(physDevice, stagingMemReq.memoryTypeBits,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-        
-        VkMemoryAllocateInfo stagingAllocInfo{};
-        stagingAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        stagingAllocInfo.allocationSize = stagingMemReq.size;
-        stagingAllocInfo.memoryTypeIndex = stagingMemType;
-        
-        vkAllocateMemory(device, &stagingAllocInfo, nullptr, &stagingMemory);
-        vkBindBufferMemory(device, stagingBuffer, stagingMemory, 0);
-        
-        // Copy white pixel to staging buffer
-        void* data;
-        vkMapMemory(device, stagingMemory, 0, 4, 0, &data);
-        memcpy(data, &whitePixel, 4);
-        vkUnmapMemory(device, stagingMemory);
-        
-        // Use single-time command buffer
-        VkCommandBufferAllocateInfo cmdAllocInfo{};
-        cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        cmdAllocInfo.commandPool = m_core->getCommandPool();
-        cmdAllocInfo.commandBufferCount = 1;
-        
-        VkCommandBuffer cmd;
-        vkAllocateCommandBuffers(device, &cmdAllocInfo, &cmd);
-        
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-        vkBeginCommandBuffer(cmd, &beginInfo);
-        
-        // Transition to transfer destination
-        VkImageMemoryBarrier barrier1{};
-        barrier1.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier1.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        barrier1.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier1.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier1.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier1.image = m_defaultTexImage;
-        barrier1.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier1.subresourceRange.baseMipLevel = 0;
-        barrier1.subresourceRange.levelCount = 1;
-        barrier1.subresourceRange.baseArrayLayer = 0;
-        barrier1.subresourceRange.layerCount = 1;
-        barrier1.srcAccessMask = 0;
-        barrier1.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        
-        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-            0, 0, nullptr, 0, nullptr, 1, &barrier1);
-        
-        // Copy staging buffer to image
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {1, 1, 1};
-        
-        vkCmdCopyBufferToImage(cmd, stagingBuffer, m_defaultTexImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-        
-        // Transition to shader read
-        VkImageMemoryBarrier barrier2{};
-        barrier2.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier2.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier2.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier2.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier2.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier2.image = m_defaultTexImage;
-        barrier2.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier2.subresourceRange.baseMipLevel = 0;
-        barrier2.subresourceRange.levelCount = 1;
-        barrier2.subresourceRange.baseArrayLayer = 0;
-        barrier2.subresourceRange.layerCount = 1;
-        barrier2.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier2.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        
-        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            0, 0, nullptr, 0, nullptr, 1, &barrier2);
-        
-        vkEndCommandBuffer(cmd);
-        
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &cmd;
-        vkQueueSubmit(m_core->getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(m_core->getGraphicsQueue());
-        
-        // Cleanup staging resources
-        vkFreeCommandBuffers(device, m_core->getCommandPool(), 1, &cmd);
-        vkDestroyBuffer(device, stagingBuffer, nullptr);
-        vkFreeMemory(device, stagingMemory, nullptr);
-    }
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+}
+
+// ============================================================================
+// Private: Create Resources
+// ============================================================================
+
+bool LightingManager::createLightingResources() {
+    VkDevice device = m_core->getDevice();
+    vkcore::GpuAllocator& allocator = m_core->getAllocator();
     
-    // Create image view
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = m_defaultTexImage;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
-    
-    if (vkCreateImageView(device, &viewInfo, nullptr, &m_defaultTexView) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to create texture view!" << std::endl;
+    // ========================================================================
+    // Shadow map and probe volume (the sets below reference them)
+    // ========================================================================
+    
+    if (!createShadowResources()) {
+        std::cerr << "[Lighting] Failed to create shadow map!" << std::endl;
         return false;
     }
     
-    // Create sampler
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-    samplerInfo.maxAnisotropy = 1.0f;
-    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_WHITE;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    
-    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_defaultSampler) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to create sampler!" << std::endl;
+    if (!createProbeResources()) {
+        std::cerr << "[Lighting] Failed to create probe volume!" << std::endl;
         return false;
     }
     
@@ -779,26 +873,38 @@ bool LightingManager::createLightingResources() {
     // Create Descriptor Set Layout
     // ========================================================================
     
-    // UBO binding (binding 0)
-    VkDescriptorSetLayoutBinding uboBinding{};
-    uboBinding.binding = 0;
-    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    uboBinding.descriptorCount = 1;
-    uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-    
-    // Texture sampler binding (binding 1) - for future texture support
-    VkDescriptorSetLayoutBinding samplerBinding{};
-    samplerBinding.binding = 1;
-    samplerBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerBinding.descriptorCount = 1;
-    samplerBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    
-    std::vector<VkDescriptorSetLayoutBinding> bindings = {uboBinding, samplerBinding};
+    // UBO (binding 0), point lights and clusters (bindings 1-2, fragment
+    // only), shadow map (binding 3), batch instances (binding 4, vertex
+    // only), probe volume (binding 5); textures come from the bindless
+    // heap (set 1)
+    VkDescriptorSetLayoutBinding bindings[6]{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    for (uint32_t i = 1; i < 3; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    bindings[3].binding = 3;
+    bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[3].descriptorCount = 1;
+    bindings[3].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindings[4].binding = 4;
+    bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[4].descriptorCount = 1;
+    bindings[4].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    bindings[5].binding = 5;
+    bindings[5].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[5].descriptorCount = 1;
+    bindings[5].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
     
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
+    layoutInfo.bindingCount = 6;
+    layoutInfo.pBindings = bindings;
     
     if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
         std::cerr << "[Lighting] Failed to create descriptor set layout!" << std::endl;
@@ -806,51 +912,50 @@ bool LightingManager::createLightingResources() {
     }
     
     // ========================================================================
-    // Create Descriptor Pool
+    // Allocate a set per frame in flight (from the shared VulkanCore pools)
     // ========================================================================
     
-    // Create descriptor pool with capacity for many descriptor sets (one per texture)
-    // This allows each texture to have its own descriptor set, preventing texture sharing
-    const uint32_t MAX_DESCRIPTOR_SETS = 64;  // Support up to 64 unique textures
-    
-    std::vector<VkDescriptorPoolSize> poolSizes = {
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_DESCRIPTOR_SETS},  // One UBO per set
-        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_DESCRIPTOR_SETS}  // One texture per set
-    };
-    
-    VkDescriptorPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = MAX_DESCRIPTOR_SETS;
-    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;  // Allow freeing individual sets
-    
-    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
-        std::cerr << "[Lighting] Failed to create descriptor pool!" << std::endl;
-        return false;
+    // A UBO per frame, persistently mapped, so bind() never writes one the
+    // GPU may still be reading. Start with room for 64 lights and 256
+    // batched instances; ensureStorage() grows on demand.
+    m_frames.resize(m_core->getFramesInFlight());
+    for (uint32_t frame = 0; frame < m_frames.size(); frame++) {
+        if (!allocator.createBuffer(sizeof(LightingUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                m_frames[frame].ubo, m_frames[frame].uboAlloc)) {
+            std::cerr << "[Lighting] Failed to create UBO buffer!" << std::endl;
+            return false;
+        }
+        m_frames[frame].set = m_core->getDescriptorAllocator().allocate(m_descriptorSetLayout);
+        if (m_frames[frame].set == VK_NULL_HANDLE) {
+            std::cerr << "[Lighting] Failed to allocate descriptor set!" << std::endl;
+            return false;
+        }
+        if (!ensureStorage(frame, 0, 64 * sizeof(GpuPointLight)) ||
+            !ensureStorage(frame, 1, CLUSTER_COUNT * sizeof(glm::uvec2) + 1024 * sizeof(uint32_t)) ||
+            !ensureStorage(frame, 3, 256 * sizeof(vkcore::InstanceData))) {
+            return false;
+        }
+        writeFrameSet(frame);
     }
     
-    // Initialize default texture handle (special value for default white texture)
-    // This is used as a key in the descriptor set map when INVALID_TEXTURE is passed
-    m_defaultTextureHandle = vkcore::INVALID_TEXTURE - 1;  // Use a value that won't conflict with real textures
-    
-    // Create descriptor set for default texture (will be created on first use)
-    // We don't allocate it here - it will be created when bindTexture(INVALID_TEXTURE) is called
-    
     // ========================================================================
     // Create Pipeline Layout (with push constants for per-object data)
     // ========================================================================
     
-    // Push constant range for model matrix and object color
+    // Push constant range for model matrix, object color and texture slot
     VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
     pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(PushConstants);  // 80 bytes (mat4 + vec4)
+    pushConstantRange.size = sizeof(PushConstants);  // 96 bytes (mat4 + vec4 + uint, padded)
+    
+    // Set 0 = lighting UBO, set 1 = VulkanCore's bindless heap
+    VkDescriptorSetLayout setLayouts[] = {m_descriptorSetLayout, m_core->getBindlessSetLayout()};
     
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.setLayoutCount = 2;
+    pipelineLayoutInfo.pSetLayouts = setLayouts;
     pipelineLayoutInfo.pushConstantRangeCount = 1;
     pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
     
@@ -863,11 +968,44 @@ bool LightingManager::createLightingResources() {
 }
 
 bool LightingManager::createLitPipeline() {
+    if (!createLitPipelineVariant("shaders/lit_mesh.vert.spv", false, m_pipeline)) {
+        return false;
+    }
+    
+    // Instanced variant is optional - drawLitMeshInstanced() falls back to
+    // one drawLitMesh() per instance without it
+    if (!createLitPipelineVariant("shaders/lit_mesh_instanced.vert.spv", true, m_instancedPipeline)) {
+        std::cerr << "[Lighting] Instanced pipeline unavailable (lit_mesh_instanced.vert.spv) - "
+                  << "instanced draws will be issued one by one" << std::endl;
+    }
+    
+    // Batch variant is optional too - drawLitMeshBatch() falls back to
+    // drawLitMeshInstanced()
+    if (!createLitPipelineVariant("shaders/lit_mesh_batch.vert.spv", false, m_batchPipeline)) {
+        std::cerr << "[Lighting] Batch pipeline unavailable (lit_mesh_batch.vert.spv) - "
+                  << "batches will use the instance vertex stream" << std::endl;
+    }
+    
+    std::cout << "[Lighting] Lit pipeline created" << std::endl;
+    return true;
+}
+
+bool LightingManager::createLitPipelineVariant(const char* vertPath, bool instanced, VkPipeline& outPipeline) {
     VkDevice device = m_core->getDevice();
     
-    // Load shaders
-    auto vertCode = readShaderFile("shaders/lit_mesh.vert.spv");
-    auto fragCode = readShaderFile("shaders/lit_mesh.frag.spv");
+    // Load shaders (packed formats use the -DVERTEX_PACKED build). Only the
+    // -DTEXEL_DENSITY fragment build writes a storage buffer, which needs
+    // fragmentStoresAndAtomics - VulkanCore only streams textures with it
+    auto vertCode = readShaderFile(vkcore::vertexShaderVariant(vertPath, m_vertexFormat));
+    std::vector<char> fragCode;
+    if (m_core->isTextureStreaming()) {
+        fragCode = readShaderFile("shaders/lit_mesh.density.frag.spv");
+        if (fragCode.empty()) {
+            std::cerr << "[Lighting] lit_mesh.density.frag.spv not found - no texel density feedback,"
+                      << " drawn textures stream to full size" << std::endl;
+        }
+    }
+    if (fragCode.empty()) fragCode = readShaderFile("shaders/lit_mesh.frag.spv");
     
     if (vertCode.empty() || fragCode.empty()) {
         std::cerr << "[Lighting] Failed to load shaders!" << std::endl;
@@ -916,32 +1054,20 @@ bool LightingManager::createLitPipeline() {
     
     VkPipelineShaderStageCreateInfo stages[] = {vertStage, fragStage};
     
-    // Vertex input: position (vec3) + normal (vec3) + uv (vec2)
-    VkVertexInputBindingDescription binding{};
-    binding.binding = 0;
-    binding.stride = sizeof(float) * 8;  // pos(3) + normal(3) + uv(2)
-    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-    
-    std::vector<VkVertexInputAttributeDescription> attrs(3);
-    attrs[0].binding = 0;
-    attrs[0].location = 0;
-    attrs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attrs[0].offset = 0;  // position
+    // Vertex input: position + normal + uv, as VulkanCore lays out m_vertexFormat
+    VkVertexInputBindingDescription binding = m_core->getBindingDescription(m_vertexFormat);
+    std::vector<VkVertexInputAttributeDescription> attrs = m_core->getAttributeDescriptions(m_vertexFormat);
     
-    attrs[1].binding = 0;
-    attrs[1].location = 1;
-    attrs[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attrs[1].offset = sizeof(float) * 3;  // normal
-    
-    attrs[2].binding = 0;
-    attrs[2].location = 2;
-    attrs[2].format = VK_FORMAT_R32G32_SFLOAT;
-    attrs[2].offset = sizeof(float) * 6;  // uv
+    // Instanced variant: model matrix + color per instance at binding 1
+    VkVertexInputBindingDescription bindings[2] = {binding, vkcore::getInstanceBindingDescription()};
+    if (instanced) {
+        vkcore::appendInstanceAttributes(attrs);
+    }
     
     VkPipelineVertexInputStateCreateInfo vertexInput{};
     vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInput.vertexBindingDescriptionCount = 1;
-    vertexInput.pVertexBindingDescriptions = &binding;
+    vertexInput.vertexBindingDescriptionCount = instanced ? 2 : 1;
+    vertexInput.pVertexBindingDescriptions = bindings;
     vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrs.size());
     vertexInput.pVertexAttributeDescriptions = attrs.data();
     
@@ -1037,7 +1163,7 @@ bool LightingManager::createLitPipeline() {
     pipelineInfo.renderPass = m_core->getRenderPass();
     pipelineInfo.subpass = 0;
     
-    VkResult result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+    VkResult result = vkCreateGraphicsPipelines(device, m_core->getPipelineCache(), 1, &pipelineInfo, nullptr, &outPipeline);
     
     // Cleanup shader modules
     vkDestroyShaderModule(device, vertModule, nullptr);
@@ -1048,20 +1174,999 @@ bool LightingManager::createLitPipeline() {
         return false;
     }
     
-    std::cout << "[Lighting] Pipeline created successfully, handle: " << m_pipeline << std::endl;
-    
-    std::cout << "[Lighting] Lit pipeline created" << std::endl;
+    std::cout << "[Lighting] Pipeline created successfully (" << vertPath << "), handle: " << outPipeline << std::endl;
     return true;
 }
 
-void LightingManager::updateGPUBuffer() {
-    if (!m_initialized || m_uboMemory == VK_NULL_HANDLE) return;
-    
-    void* data;
-    vkMapMemory(m_core->getDevice(), m_uboMemory, 0, sizeof(LightingUBO), 0, &data);
-    memcpy(data, &m_uboData, sizeof(LightingUBO));
-    vkUnmapMemory(m_core->getDevice(), m_uboMemory);
-}
+// ============================================================================
+// Private: Shadows
+// ============================================================================
+
+bool LightingManager::createShadowResources() {
+    VkDevice device = m_core->getDevice();
+    
+    // D32 when it can be depth-rendered and filtered (hardware 2x2 PCF),
+    // else D16, which Vulkan guarantees both for
+    const VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                  VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(m_core->getPhysicalDevice(), VK_FORMAT_D32_SFLOAT, &props);
+    m_shadowFormat = (props.optimalTilingFeatures & needed) == needed ? VK_FORMAT_D32_SFLOAT : VK_FORMAT_D16_UNORM;
+    
+    // Each pass clears one layer and leaves it ready for sampling; the
+    // dependencies order it after last frame's reads and before this frame's
+    VkAttachmentDescription depth{};
+    depth.format = m_shadowFormat;
+    depth.samples = VK_SAMPLE_COUNT_1_BIT;
+    depth.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depth.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depth.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    
+    VkAttachmentReference depthRef{0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+    
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.pDepthStencilAttachment = &depthRef;
+    
+    VkSubpassDependency dependencies[2]{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    
+    VkRenderPassCreateInfo passInfo{};
+    passInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    passInfo.attachmentCount = 1;
+    passInfo.pAttachments = &depth;
+    passInfo.subpassCount = 1;
+    passInfo.pSubpasses = &subpass;
+    passInfo.dependencyCount = 2;
+    passInfo.pDependencies = dependencies;
+    
+    if (vkCreateRenderPass(device, &passInfo, nullptr, &m_shadowRenderPass) != VK_SUCCESS) {
+        std::cerr << "[Lighting] Failed to create shadow render pass!" << std::endl;
+        return false;
+    }
+    
+    // Comparison sampler: linear filtering gives 2x2 PCF per tap; outside
+    // the map counts as lit
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    samplerInfo.compareEnable = VK_TRUE;
+    samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    samplerInfo.maxLod = 0.0f;
+    
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_shadowSampler) != VK_SUCCESS) {
+        std::cerr << "[Lighting] Failed to create shadow sampler!" << std::endl;
+        return false;
+    }
+    
+    // Shadows off still binds a (1x1) map, so the set layout never changes
+    const ShadowConfig& config = m_cascades.getConfig();
+    return createShadowMap(config.cascadeCount > 0 ? config.resolution : 1u, std::max(config.cascadeCount, 1u));
+}
+
+bool LightingManager::createShadowMap(uint32_t resolution, uint32_t layers) {
+    VkDevice device = m_core->getDevice();
+    vkcore::GpuAllocator& allocator = m_core->getAllocator();
+    
+    ShadowMap map;
+    map.resolution = resolution;
+    map.layers = layers;
+    
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = m_shadowFormat;
+    imageInfo.extent = {resolution, resolution, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = layers;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    
+    if (!allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, map.image, map.alloc)) {
+        std::cerr << "[Lighting] Failed to create " << resolution << "x" << resolution << "x" << layers
+                  << " shadow map!" << std::endl;
+        return false;
+    }
+    
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = map.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = m_shadowFormat;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, layers};
+    bool ok = vkCreateImageView(device, &viewInfo, nullptr, &map.arrayView) == VK_SUCCESS;
+    
+    // One view and framebuffer per cascade to render into
+    map.layerViews.assign(layers, VK_NULL_HANDLE);
+    map.framebuffers.assign(layers, VK_NULL_HANDLE);
+    for (uint32_t layer = 0; layer < layers && ok; layer++) {
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, layer, 1};
+        ok = vkCreateImageView(device, &viewInfo, nullptr, &map.layerViews[layer]) == VK_SUCCESS;
+        if (!ok) break;
+        
+        VkFramebufferCreateInfo fbInfo{};
+        fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        fbInfo.renderPass = m_shadowRenderPass;
+        fbInfo.attachmentCount = 1;
+        fbInfo.pAttachments = &map.layerViews[layer];
+        fbInfo.width = resolution;
+        fbInfo.height = resolution;
+        fbInfo.layers = 1;
+        ok = vkCreateFramebuffer(device, &fbInfo, nullptr, &map.framebuffers[layer]) == VK_SUCCESS;
+    }
+    
+    if (!ok) {
+        std::cerr << "[Lighting] Failed to create shadow map views!" << std::endl;
+        destroyShadowMap(map);
+        return false;
+    }
+    
+    // Frames in flight may still sample the old map
+    if (m_shadowMap.image != VK_NULL_HANDLE) {
+        ShadowMap old = std::move(m_shadowMap);
+        vkcore::VulkanCore* core = m_core;
+        m_core->deferDestroy([core, old]() mutable {
+            VkDevice device = core->getDevice();
+            for (VkFramebuffer fb : old.framebuffers) vkDestroyFramebuffer(device, fb, nullptr);
+            for (VkImageView view : old.layerViews) vkDestroyImageView(device, view, nullptr);
+            vkDestroyImageView(device, old.arrayView, nullptr);
+            core->getAllocator().destroyImage(old.image, old.alloc);
+        });
+    }
+    m_shadowMap = std::move(map);
+    
+    // Sets pick the new map up as their frame slot comes round in bind()
+    for (FrameLights& frame : m_frames) frame.setStale = true;
+    return true;
+}
+
+void LightingManager::destroyShadowMap(ShadowMap& map) {
+    VkDevice device = m_core->getDevice();
+    for (VkFramebuffer fb : map.framebuffers) {
+        if (fb != VK_NULL_HANDLE) vkDestroyFramebuffer(device, fb, nullptr);
+    }
+    for (VkImageView view : map.layerViews) {
+        if (view != VK_NULL_HANDLE) vkDestroyImageView(device, view, nullptr);
+    }
+    if (map.arrayView != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, map.arrayView, nullptr);
+    }
+    m_core->getAllocator().destroyImage(map.image, map.alloc);
+    map = ShadowMap{};
+}
+
+bool LightingManager::createShadowPipeline() {
+    VkDevice device = m_core->getDevice();
+    
+    auto vertCode = readShaderFile("shaders/shadow_depth.vert.spv");
+    if (vertCode.empty()) return false;
+    
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = vertCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(vertCode.data());
+    
+    VkShaderModule vertModule;
+    if (vkCreateShaderModule(device, &moduleInfo, nullptr, &vertModule) != VK_SUCCESS) {
+        std::cerr << "[Lighting] Failed to create shadow shader module!" << std::endl;
+        return false;
+    }
+    
+    // Cascade's light view-projection; models come per instance
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(glm::mat4);
+    
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+    
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_shadowPipelineLayout) != VK_SUCCESS) {
+        vkDestroyShaderModule(device, vertModule, nullptr);
+        std::cerr << "[Lighting] Failed to create shadow pipeline layout!" << std::endl;
+        return false;
+    }
+    
+    // Depth only: no fragment stage
+    VkPipelineShaderStageCreateInfo vertStage{};
+    vertStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertStage.module = vertModule;
+    vertStage.pName = "main";
+    
+    // Position from the mesh (same vertices as the lit pipeline; a packed
+    // position reads as vec3 too), model matrix from the instance stream
+    VkVertexInputBindingDescription bindings[2] = {m_core->getBindingDescription(m_vertexFormat),
+                                                   vkcore::getInstanceBindingDescription()};
+    
+    std::vector<VkVertexInputAttributeDescription> attrs(1, m_core->getAttributeDescriptions(m_vertexFormat)[0]);
+    vkcore::appendInstanceAttributes(attrs);
+    
+    VkPipelineVertexInputStateCreateInfo vertexInput{};
+    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInput.vertexBindingDescriptionCount = 2;
+    vertexInput.pVertexBindingDescriptions = bindings;
+    vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrs.size());
+    vertexInput.pVertexAttributeDescriptions = attrs.data();
+    
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+    
+    // No culling (as the lit pipeline); slope-scaled bias set per cascade
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_TRUE;
+    
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_DEPTH_BIAS};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 3;
+    dynamicState.pDynamicStates = dynamicStates;
+    
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 1;
+    pipelineInfo.pStages = &vertStage;
+    pipelineInfo.pVertexInputState = &vertexInput;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_shadowPipelineLayout;
+    pipelineInfo.renderPass = m_shadowRenderPass;
+    pipelineInfo.subpass = 0;
+    
+    VkResult result = vkCreateGraphicsPipelines(device, m_core->getPipelineCache(), 1, &pipelineInfo, nullptr, &m_shadowPipeline);
+    vkDestroyShaderModule(device, vertModule, nullptr);
+    
+    if (result != VK_SUCCESS) {
+        std::cerr << "[Lighting] Failed to create shadow pipeline! Error code: " << result << std::endl;
+        m_shadowPipeline = VK_NULL_HANDLE;
+        return false;
+    }
+    
+    std::cout << "[Lighting] Shadow pipeline created (" << (m_shadowFormat == VK_FORMAT_D32_SFLOAT ? "D32" : "D16") << ")" << std::endl;
+    return true;
+}
+
+// Conservative sphere vs the cascade's ortho box, in its clip space
+static bool sphereInCascade(const glm::mat4& viewProj, const glm::vec3& center, float radius) {
+    glm::vec4 clip = viewProj * glm::vec4(center, 1.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        float scale = glm::length(glm::vec3(viewProj[0][axis], viewProj[1][axis], viewProj[2][axis]));
+        float reach = radius * scale;
+        float lo = axis == 2 ? 0.0f : -1.0f;  // Depth is 0..1
+        if (clip[axis] + reach < lo || clip[axis] - reach > 1.0f) return false;
+    }
+    return true;
+}
+
+void LightingManager::renderShadows(VkCommandBuffer cmd) {
+    m_shadowStats = ShadowStats{};
+    if (m_shadowMap.image == VK_NULL_HANDLE || m_frames.empty()) return;
+    
+    // The camera set before beginFrame(); near plane as given to the clusters
+    uint32_t mask = 0;
+    if (m_shadowPipeline != VK_NULL_HANDLE && m_directionalLight.intensity > 0.0f) {
+        mask = m_cascades.update(m_core->getViewMatrix(), m_core->getProjectionMatrix(),
+                                 m_clusters.depthParams().x, m_directionalLight.direction);
+    }
+    
+    // Refitted cascades change what the lit shader samples with; a still
+    // camera refits to the same matrices and uploads nothing
+    for (uint32_t c = 0; c < MAX_CASCADES; c++) {
+        if ((mask & (1u << c)) && m_cascades.get(c).viewProj != m_uboData.cascadeViewProj[c]) {
+            markUboDirty();
+            break;
+        }
+    }
+    
+    // A new map's layers are all cleared once so every one can be sampled
+    uint32_t layerMask = mask;
+    if (!m_shadowMap.cleared) {
+        layerMask |= (1u << m_shadowMap.layers) - 1u;
+        m_shadowMap.cleared = true;
+    }
+    if (layerMask == 0) return;  // Every cascade cached and up to date
+    
+    // Visible casters per cascade, grouped by mesh into instanced draws
+    m_shadowModels.clear();
+    m_shadowDraws.clear();
+    for (uint32_t c = 0; c < m_shadowMap.layers; c++) {
+        if (!(mask & (1u << c))) continue;
+        const ShadowCascades::Cascade& cascade = m_cascades.get(c);
+        
+        m_shadowVisible.clear();
+        m_shadowCasters.forEach([&](uint32_t, const ShadowCaster& caster) {
+            if (cascade.cached && !caster.isStatic) return;  // Cached cascades hold static geometry only
+            glm::vec3 center;
+            float radius;
+            if (m_core->getMeshBounds(caster.mesh, center, radius) && radius > 0.0f) {
+                float scale = std::max({glm::length(glm::vec3(caster.model[0])), glm::length(glm::vec3(caster.model[1])),
+                                        glm::length(glm::vec3(caster.model[2]))});
+                center = glm::vec3(caster.model * glm::vec4(center, 1.0f));
+                if (!sphereInCascade(cascade.viewProj, center, radius * scale)) return;
+            }
+            m_shadowVisible.emplace_back(caster.mesh, &caster);
+        });
+        std::sort(m_shadowVisible.begin(), m_shadowVisible.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        
+        for (const auto& visible : m_shadowVisible) {
+            if (m_shadowDraws.empty() || m_shadowDraws.back().cascade != c || m_shadowDraws.back().mesh != visible.first) {
+                m_shadowDraws.push_back({c, visible.first, static_cast<uint32_t>(m_shadowModels.size()), 0});
+            }
+            m_shadowModels.push_back(visible.second->model);
+            m_shadowDraws.back().instanceCount++;
+        }
+    }
+    
+    // This frame slot's casters buffer is free (its fence has signalled)
+    uint32_t frame = m_core->getCurrentFrame() % m_frames.size();
+    FrameLights& lights = m_frames[frame];
+    if (!m_shadowModels.empty()) {
+        if (ensureStorage(frame, 2, m_shadowModels.size() * sizeof(vkcore::InstanceData))) {
+            vkcore::InstanceData* instances = static_cast<vkcore::InstanceData*>(lights.allocs[2].mapped);
+            for (size_t i = 0; i < m_shadowModels.size(); i++) {
+                instances[i].model = m_shadowModels[i];
+                instances[i].color = glm::vec4(1.0f);
+            }
+            // m_shadowModels stay as given: they also pick each draw's LOD
+            for (const ShadowDraw& draw : m_shadowDraws) {
+                const glm::mat4* dequantize = m_core->getMeshDequantization(draw.mesh);
+                if (!dequantize) continue;
+                for (uint32_t i = draw.firstInstance; i < draw.firstInstance + draw.instanceCount; i++) {
+                    instances[i].model = m_shadowModels[i] * *dequantize;
+                }
+            }
+        } else {
+            m_shadowDraws.clear();  // Clear the cascades rather than overrun the buffer
+        }
+    }
+    
+    // Prologues run before the frame counts as started, so the scope goes
+    // straight to the profiler (VKCORE_GPU_SCOPE would record nothing)
+    uint32_t scope = m_core->getGpuProfiler().beginScope(cmd, "shadows");
+    
+    const ShadowConfig& config = m_cascades.getConfig();
+    size_t drawIndex = 0;
+    for (uint32_t c = 0; c < m_shadowMap.layers; c++) {
+        if (!(layerMask & (1u << c))) continue;
+        
+        VkClearValue clear{};
+        clear.depthStencil = {1.0f, 0};
+        
+        VkRenderPassBeginInfo passInfo{};
+        passInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        passInfo.renderPass = m_shadowRenderPass;
+        passInfo.framebuffer = m_shadowMap.framebuffers[c];
+        passInfo.renderArea.extent = {m_shadowMap.resolution, m_shadowMap.resolution};
+        passInfo.clearValueCount = 1;
+        passInfo.pClearValues = &clear;
+        vkCmdBeginRenderPass(cmd, &passInfo, VK_SUBPASS_CONTENTS_INLINE);
+        
+        if (mask & (1u << c)) {
+            m_shadowStats.cascadesRendered++;
+            
+            VkViewport viewport{0.0f, 0.0f, float(m_shadowMap.resolution), float(m_shadowMap.resolution), 0.0f, 1.0f};
+            VkRect2D scissor{{0, 0}, {m_shadowMap.resolution, m_shadowMap.resolution}};
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadowPipeline);
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+            vkCmdSetDepthBias(cmd, config.depthBiasConstant, 0.0f, config.depthBiasSlope);
+            
+            const glm::mat4& viewProj = m_cascades.get(c).viewProj;
+            vkCmdPushConstants(cmd, m_shadowPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &viewProj);
+            
+            for (; drawIndex < m_shadowDraws.size() && m_shadowDraws[drawIndex].cascade == c; drawIndex++) {
+                const ShadowDraw& draw = m_shadowDraws[drawIndex];
+                VkBuffer vertexBuffer, indexBuffer;
+                uint32_t indexCount, firstIndex = 0;
+                if (!m_core->getMeshBuffers(draw.mesh, vertexBuffer, indexBuffer, indexCount)) continue;
+                m_core->getMeshLod(draw.mesh, &m_shadowModels[draw.firstInstance], draw.instanceCount, firstIndex, indexCount);
+                
+                VkBuffer vertexBuffers[] = {vertexBuffer, lights.buffers[2]};
+                VkDeviceSize offsets[] = {0, draw.firstInstance * sizeof(vkcore::InstanceData)};
+                vkCmdBindVertexBuffers(cmd, 0, 2, vertexBuffers, offsets);
+                vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdDrawIndexed(cmd, indexCount, draw.instanceCount, firstIndex, 0, 0);
+                
+                m_shadowStats.drawCalls++;
+                m_shadowStats.instances += draw.instanceCount;
+            }
+        }
+        
+        vkCmdEndRenderPass(cmd);
+    }
+    
+    m_core->getGpuProfiler().endScope(cmd, scope);
+}
+
+// ============================================================================
+// Private: Irradiance Probes
+// ============================================================================
+
+// IEEE half (truncating the mantissa; values past the half range become
+// infinity, tiny ones zero) - plenty for irradiance
+static uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    
+    if (((bits >> 23) & 0xFFu) == 0xFFu) {
+        return sign | 0x7C00u | (mantissa ? 0x200u : 0u);  // Inf / NaN
+    }
+    if (exponent >= 31) return sign | 0x7C00u;
+    if (exponent <= 0) {
+        if (exponent < -10) return sign;
+        mantissa |= 0x800000u;  // Subnormal: shift the implicit bit in
+        return sign | static_cast<uint16_t>(mantissa >> (14 - exponent));
+    }
+    return sign | static_cast<uint16_t>(exponent << 10) | static_cast<uint16_t>(mantissa >> 13);
+}
+
+bool LightingManager::createProbeResources() {
+    // Trilinear between probes; the shader keeps coordinates inside each
+    // coefficient's slab, so clamping only matters at the grid's edge
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 0.0f;
+    
+    if (vkCreateSampler(m_core->getDevice(), &samplerInfo, nullptr, &m_probeSampler) != VK_SUCCESS) {
+        std::cerr << "[Lighting] Failed to create probe sampler!" << std::endl;
+        return false;
+    }
+    
+    // Probes off still binds a (black, 1x1x4) volume, so the set layout
+    // never changes; the first prologue uploads it before any draw
+    return createProbeVolume(nullptr, m_probeVolume);
+}
+
+bool LightingManager::createProbeVolume(const IrradianceProbeGrid* grid, ProbeVolume& out) {
+    VkDevice device = m_core->getDevice();
+    vkcore::GpuAllocator& allocator = m_core->getAllocator();
+    
+    ProbeVolume volume;
+    if (grid) {
+        volume.extent = {grid->dims.x, grid->dims.y, grid->dims.z};
+        volume.origin = grid->origin;
+        volume.spacing = grid->spacing;
+        volume.enabled = true;
+    }
+    
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(m_core->getPhysicalDevice(), &props);
+    uint32_t maxDim = props.limits.maxImageDimension3D;
+    if (volume.extent.width > maxDim || volume.extent.height > maxDim ||
+        volume.extent.depth * PROBE_SH_COEFFS > maxDim) {
+        std::cerr << "[Lighting] Probe grid " << volume.extent.width << "x" << volume.extent.height << "x"
+                  << volume.extent.depth << " exceeds the device's 3D image limit (" << maxDim << ")" << std::endl;
+        return false;
+    }
+    
+    // The grid stacked PROBE_SH_COEFFS times along z: coefficient k of
+    // probe (x, y, z) is texel (x, y, k * dims.z + z)
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_3D;
+    imageInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    imageInfo.extent = {volume.extent.width, volume.extent.height, volume.extent.depth * PROBE_SH_COEFFS};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    
+    if (!allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, volume.image, volume.alloc)) {
+        std::cerr << "[Lighting] Failed to create probe volume!" << std::endl;
+        return false;
+    }
+    
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = volume.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    
+    size_t probeCount = size_t(volume.extent.width) * volume.extent.height * volume.extent.depth;
+    VkDeviceSize bytes = probeCount * PROBE_SH_COEFFS * 4 * sizeof(uint16_t);
+    if (vkCreateImageView(device, &viewInfo, nullptr, &volume.view) != VK_SUCCESS ||
+        !allocator.createStagingBuffer(bytes, volume.staging, volume.stagingAlloc)) {
+        std::cerr << "[Lighting] Failed to create probe volume view / staging!" << std::endl;
+        destroyProbeVolume(volume);
+        return false;
+    }
+    
+    uint16_t* texels = static_cast<uint16_t*>(volume.stagingAlloc.mapped);
+    std::memset(texels, 0, size_t(bytes));
+    if (grid) {
+        for (size_t probe = 0; probe < probeCount; probe++) {
+            for (uint32_t k = 0; k < PROBE_SH_COEFFS; k++) {
+                const glm::vec3& c = grid->coeffs[probe * PROBE_SH_COEFFS + k];
+                uint16_t* texel = texels + (k * probeCount + probe) * 4;
+                texel[0] = floatToHalf(c.r);
+                texel[1] = floatToHalf(c.g);
+                texel[2] = floatToHalf(c.b);
+            }
+        }
+    }
+    
+    out = volume;
+    return true;
+}
+
+void LightingManager::destroyProbeVolume(ProbeVolume& volume) {
+    vkcore::GpuAllocator& allocator = m_core->getAllocator();
+    if (volume.view != VK_NULL_HANDLE) {
+        vkDestroyImageView(m_core->getDevice(), volume.view, nullptr);
+    }
+    allocator.destroyImage(volume.image, volume.alloc);
+    allocator.destroyBuffer(volume.staging, volume.stagingAlloc);
+    volume = ProbeVolume{};
+}
+
+void LightingManager::uploadProbes(VkCommandBuffer cmd) {
+    // A queued replacement takes over once its copy is recorded; sets and
+    // UBO switch to it together in this frame's bind()
+    bool swap = m_pendingProbes.image != VK_NULL_HANDLE;
+    ProbeVolume& volume = swap ? m_pendingProbes : m_probeVolume;
+    if (volume.staging == VK_NULL_HANDLE) return;
+    
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = volume.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+    
+    VkBufferImageCopy region{};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {volume.extent.width, volume.extent.height, volume.extent.depth * PROBE_SH_COEFFS};
+    vkCmdCopyBufferToImage(cmd, volume.staging, volume.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+    
+    // The copy is in flight until this frame retires
+    vkcore::VulkanCore* core = m_core;
+    VkBuffer staging = volume.staging;
+    vkcore::GpuAllocation stagingAlloc = volume.stagingAlloc;
+    m_core->deferDestroy([core, staging, stagingAlloc]() mutable {
+        core->getAllocator().destroyBuffer(staging, stagingAlloc);
+    });
+    volume.staging = VK_NULL_HANDLE;
+    volume.stagingAlloc = vkcore::GpuAllocation{};
+    
+    if (!swap) return;
+    
+    // Frames in flight may still sample the old volume
+    ProbeVolume old = m_probeVolume;
+    m_core->deferDestroy([core, old]() mutable {
+        vkDestroyImageView(core->getDevice(), old.view, nullptr);
+        core->getAllocator().destroyImage(old.image, old.alloc);
+        core->getAllocator().destroyBuffer(old.staging, old.stagingAlloc);  // Replaced before its upload
+    });
+    m_probeVolume = m_pendingProbes;
+    m_pendingProbes = ProbeVolume{};
+    
+    for (FrameLights& frame : m_frames) frame.setStale = true;
+    markUboDirty();
+}
+
+bool LightingManager::ensureStorage(uint32_t frame, uint32_t binding, VkDeviceSize bytes) {
+    FrameLights& lights = m_frames[frame];
+    if (bytes <= lights.capacity[binding]) return true;
+    
+    // Grow by half again so steadily added lights don't reallocate each frame
+    VkDeviceSize capacity = std::max(bytes, lights.capacity[binding] + lights.capacity[binding] / 2);
+    
+    // Lights, clusters and batches are read by the shaders, casters are
+    // instance data
+    VkBufferUsageFlags usage = binding == 2 ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    
+    VkBuffer buffer = VK_NULL_HANDLE;
+    vkcore::GpuAllocation alloc;
+    if (!m_core->getAllocator().createBuffer(capacity, usage,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            buffer, alloc)) {
+        std::cerr << "[Lighting] Failed to create " << capacity << " byte light buffer!" << std::endl;
+        return false;  // The old buffer stays usable
+    }
+    
+    // Frames still in flight may read the old buffer
+    if (lights.buffers[binding] != VK_NULL_HANDLE) {
+        VkBuffer oldBuffer = lights.buffers[binding];
+        vkcore::GpuAllocation oldAlloc = lights.allocs[binding];
+        vkcore::VulkanCore* core = m_core;
+        m_core->deferDestroy([core, oldBuffer, oldAlloc]() mutable {
+            core->getAllocator().destroyBuffer(oldBuffer, oldAlloc);
+        });
+    }
+    lights.buffers[binding] = buffer;
+    lights.allocs[binding] = alloc;
+    lights.capacity[binding] = capacity;
+    return true;
+}
+
+void LightingManager::writeFrameSet(uint32_t frame) {
+    FrameLights& lights = m_frames[frame];
+    
+    VkDescriptorBufferInfo bufferInfos[5]{};
+    bufferInfos[0].buffer = lights.ubo;
+    bufferInfos[0].range = sizeof(LightingUBO);
+    for (int i = 0; i < 2; i++) {
+        bufferInfos[i + 1].buffer = lights.buffers[i];
+        bufferInfos[i + 1].range = VK_WHOLE_SIZE;
+    }
+    bufferInfos[4].buffer = lights.buffers[3];
+    bufferInfos[4].range = VK_WHOLE_SIZE;
+    
+    VkDescriptorImageInfo shadowInfo{};
+    shadowInfo.sampler = m_shadowSampler;
+    shadowInfo.imageView = m_shadowMap.arrayView;
+    shadowInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    
+    VkDescriptorImageInfo probeInfo{};
+    probeInfo.sampler = m_probeSampler;
+    probeInfo.imageView = m_probeVolume.view;
+    probeInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    
+    VkWriteDescriptorSet writes[6]{};
+    for (uint32_t i = 0; i < 6; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = lights.set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        if (i == 3 || i == 5) {
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writes[i].pImageInfo = i == 3 ? &shadowInfo : &probeInfo;
+        } else {
+            writes[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+    }
+    vkUpdateDescriptorSets(m_core->getDevice(), 6, writes, 0, nullptr);
+    lights.setStale = false;
+}
+
+void LightingManager::updateLightBuffers(uint32_t frame) {
+    // Re-bin only when the lights or the camera changed; a slot that missed
+    // the change just gets the current lists copied in
+    if (m_clustersVersion != m_lightsVersion) {
+        m_gpuLights.clear();
+        m_pointLights.forEach([&](uint32_t, const PointLight& light) {
+            if (!light.enabled || light.intensity <= 0.0f) return;
+            GpuPointLight gpu;
+            gpu.positionRange = glm::vec4(light.position, light.range);
+            gpu.colorIntensity = glm::vec4(light.color, light.intensity);
+            m_gpuLights.push_back(gpu);
+        });
+        m_clusters.build(m_gpuLights, m_viewMatrix, m_projMatrix, m_clusterWidth, m_clusterHeight);
+        m_clustersVersion = m_lightsVersion;
+    }
+    
+    // This frame slot's fence has signalled, so its buffers (and set) are free
+    FrameLights& lights = m_frames[frame];
+    const std::vector<glm::uvec2>& ranges = m_clusters.getRanges();
+    const std::vector<uint32_t>& indices = m_clusters.getIndices();
+    VkDeviceSize rangeBytes = ranges.size() * sizeof(glm::uvec2);
+    
+    VkBuffer oldLights = lights.buffers[0];
+    VkBuffer oldClusters = lights.buffers[1];
+    if (!ensureStorage(frame, 0, m_gpuLights.size() * sizeof(GpuPointLight)) ||
+        !ensureStorage(frame, 1, rangeBytes + indices.size() * sizeof(uint32_t))) {
+        // Shade without point lights rather than overrun the buffers; the
+        // next bind() retries the full list
+        m_gpuLights.clear();
+        m_clusters.build(m_gpuLights, m_viewMatrix, m_projMatrix, m_clusterWidth, m_clusterHeight);
+        m_clustersVersion = 0;
+        markUboDirty();
+    } else {
+        lights.lightsVersion = m_lightsVersion;
+    }
+    if (lights.buffers[0] != oldLights || lights.buffers[1] != oldClusters) {
+        writeFrameSet(frame);
+    }
+    
+    if (!m_gpuLights.empty()) {
+        memcpy(lights.allocs[0].mapped, m_gpuLights.data(), m_gpuLights.size() * sizeof(GpuPointLight));
+    }
+    char* clusterData = static_cast<char*>(lights.allocs[1].mapped);
+    memcpy(clusterData, ranges.data(), rangeBytes);
+    if (!indices.empty()) {
+        memcpy(clusterData + rangeBytes, indices.data(), indices.size() * sizeof(uint32_t));
+    }
+}
+
+void LightingManager::updateGPUBuffer(uint32_t frame) {
+    FrameLights& slot = m_frames[frame];
+    if (!slot.uboAlloc.mapped) return;
+    
+    memcpy(slot.uboAlloc.mapped, &m_uboData, sizeof(LightingUBO));
+    slot.uboVersion = m_uboVersion;
+}
+
+// ============================================================================
+// Draw Capture
+// ============================================================================
+
+vkcore::DrawCapture* LightingManager::recordingCapture() const {
+    vkcore::DrawCapture* capture = m_core ? m_core->getDrawCapture() : nullptr;
+    return capture && capture->isRecording() ? capture : nullptr;
+}
+
+// Everything bind() uploads that a replay can't derive (cluster bins and
+// shadow cascades are rebuilt from it)
+void LightingManager::captureState(vkcore::DrawCapture& capture) {
+    std::vector<uint8_t>& payload = vkcore::DrawCapture::scratch();
+    vkcore::CaptureWriter out(payload);
+    out.u8(uint8_t(CaptureOp::State));
+    out.mat4(m_viewMatrix);
+    out.mat4(m_projMatrix);
+    out.vec3(m_directionalLight.direction);
+    out.vec3(m_directionalLight.color);
+    out.f32(m_directionalLight.intensity);
+    out.vec3(m_ambientLight.color);
+    out.vec3(m_cameraPos);
+    out.f32(m_shininess);
+    out.f32(m_specularStrength);
+    out.u32(static_cast<uint32_t>(m_debugMode));
+    out.u8(m_clusters.isEnabled() ? 1 : 0);
+    out.f32(m_probeIntensity);
+    
+    const ShadowConfig& shadows = m_cascades.getConfig();
+    out.u32(shadows.cascadeCount);
+    out.u32(shadows.resolution);
+    out.f32(shadows.maxDistance);
+    out.f32(shadows.splitLambda);
+    out.u32(shadows.cachedCascades);
+    out.u32(shadows.cachedUpdatesPerFrame);
+    out.f32(shadows.cacheMoveThreshold);
+    out.f32(shadows.casterPullback);
+    out.u32(shadows.pcfRadius);
+    out.f32(shadows.depthBiasConstant);
+    out.f32(shadows.depthBiasSlope);
+    out.f32(shadows.normalOffset);
+    
+    out.u32(m_pointLights.size());
+    m_pointLights.forEach([&](PointLightHandle handle, const PointLight& light) {
+        out.u32(handle);
+        out.vec3(light.position);
+        out.vec3(light.color);
+        out.f32(light.intensity);
+        out.f32(light.range);
+        out.u8(light.enabled ? 1 : 0);
+    });
+    out.u32(m_shadowCasters.size());
+    m_shadowCasters.forEach([&](ShadowCasterHandle handle, const ShadowCaster& caster) {
+        out.u32(handle);
+        out.u32(capture.meshId(caster.mesh));
+        out.mat4(caster.model);
+        out.u8(caster.isStatic ? 1 : 0);
+    });
+    capture.extension(CAPTURE_TAG, payload);
+    
+    m_captureFrame = m_core->getFrameNumber();
+    m_captureUboVersion = m_uboVersion;
+    m_captureLightsVersion = m_lightsVersion;
+}
+
+// Setters only run for what differs, so an unchanged replayed frame
+// uploads as little as the captured one did
+void LightingManager::replayState(vkcore::CaptureReader& in, vkcore::CaptureRemap& remap) {
+    setViewMatrix(in.mat4());
+    setProjectionMatrix(in.mat4());
+    DirectionalLight sun;
+    sun.direction = in.vec3();
+    sun.color = in.vec3();
+    sun.intensity = in.f32();
+    if (sun.direction != m_directionalLight.direction || sun.color != m_directionalLight.color ||
+        sun.intensity != m_directionalLight.intensity) {
+        setDirectionalLight(sun);
+    }
+    glm::vec3 ambient = in.vec3();
+    if (ambient != m_ambientLight.color) setAmbientLight(ambient);
+    glm::vec3 cameraPos = in.vec3();
+    if (cameraPos != m_cameraPos) setCameraPosition(cameraPos);
+    float shininess = in.f32();
+    if (shininess != m_shininess) setShininess(shininess);
+    float specular = in.f32();
+    if (specular != m_specularStrength) setSpecularStrength(specular);
+    int debugMode = static_cast<int>(in.u32());
+    if (debugMode != m_debugMode) setDebugMode(debugMode);
+    bool clustered = in.u8() != 0;
+    if (clustered != m_clusters.isEnabled()) setClusteredLighting(clustered);
+    float probeIntensity = in.f32();
+    if (probeIntensity != m_probeIntensity) setProbeIntensity(probeIntensity);
+    
+    ShadowConfig shadows;
+    shadows.cascadeCount = in.u32();
+    shadows.resolution = in.u32();
+    shadows.maxDistance = in.f32();
+    shadows.splitLambda = in.f32();
+    shadows.cachedCascades = in.u32();
+    shadows.cachedUpdatesPerFrame = in.u32();
+    shadows.cacheMoveThreshold = in.f32();
+    shadows.casterPullback = in.f32();
+    shadows.pcfRadius = in.u32();
+    shadows.depthBiasConstant = in.f32();
+    shadows.depthBiasSlope = in.f32();
+    shadows.normalOffset = in.f32();
+    if (!sameShadowConfig(shadows, m_cascades.getConfig())) setShadowConfig(shadows);
+    
+    // Lights and casters keep their replayed handles across snapshots;
+    // ones missing from this snapshot were removed
+    std::unordered_map<uint64_t, bool> seen;
+    for (uint32_t i = 0, n = in.u32(); i < n && in.ok(); i++) {
+        uint64_t key = vkcore::CaptureRemap::objectKey(LIGHT_OBJECTS, in.u32());
+        PointLight light;
+        light.position = in.vec3();
+        light.color = in.vec3();
+        light.intensity = in.f32();
+        light.range = in.f32();
+        light.enabled = in.u8() != 0;
+        seen[key] = true;
+        
+        auto replayed = remap.objects.find(key);
+        if (replayed != remap.objects.end()) {
+            const PointLight* current = m_pointLights.get(replayed->second);
+            if (current && current->position == light.position && current->color == light.color &&
+                current->intensity == light.intensity && current->range == light.range &&
+                current->enabled == light.enabled) {
+                continue;
+            }
+            if (setPointLight(replayed->second, light)) continue;
+        }
+        PointLightHandle handle = addPointLight(light);
+        if (handle != INVALID_POINT_LIGHT) remap.objects[key] = handle;
+    }
+    for (uint32_t i = 0, n = in.u32(); i < n && in.ok(); i++) {
+        uint64_t key = vkcore::CaptureRemap::objectKey(CASTER_OBJECTS, in.u32());
+        vkcore::MeshHandle mesh = remap.mesh(in.u32());
+        glm::mat4 model = in.mat4();
+        bool isStatic = in.u8() != 0;
+        seen[key] = true;
+        
+        auto replayed = remap.objects.find(key);
+        if (replayed != remap.objects.end()) {
+            const ShadowCaster* current = m_shadowCasters.get(replayed->second);
+            if (current && current->mesh == mesh && current->isStatic == isStatic) {
+                setShadowCasterTransform(replayed->second, model);
+                continue;
+            }
+            removeShadowCaster(replayed->second);
+        }
+        ShadowCasterHandle handle = addShadowCaster(mesh, model, isStatic);
+        if (handle != INVALID_SHADOW_CASTER) remap.objects[key] = handle;
+    }
+    
+    for (auto it = remap.objects.begin(); it != remap.objects.end();) {
+        uint32_t tag = static_cast<uint32_t>(it->first >> 32);
+        if ((tag != LIGHT_OBJECTS && tag != CASTER_OBJECTS) || seen.count(it->first)) { ++it; continue; }
+        if (tag == LIGHT_OBJECTS) removePointLight(it->second);
+        else removeShadowCaster(it->second);
+        it = remap.objects.erase(it);
+    }
+}
+
+bool LightingManager::replayCapture(vkcore::CaptureReader& in, vkcore::CaptureRemap& remap) {
+    if (!m_initialized) return false;
+    
+    static std::vector<glm::mat4> models;
+    static std::vector<glm::vec4> colors;
+    switch (CaptureOp(in.u8())) {
+    case CaptureOp::State:
+        replayState(in, remap);
+        break;
+    case CaptureOp::Bind:
+        bind();
+        break;
+    case CaptureOp::BindTexture:
+        bindTexture(remap.texture(in.u32()));
+        break;
+    case CaptureOp::DrawLitMesh: {
+        vkcore::MeshHandle mesh = remap.mesh(in.u32());
+        glm::mat4 model = in.mat4();
+        glm::vec4 color = in.vec4();
+        if (in.ok()) drawLitMesh(mesh, model, color);
+        break;
+    }
+    case CaptureOp::DrawLitInstanced: {
+        vkcore::MeshHandle mesh = remap.mesh(in.u32());
+        if (readInstances(in, models, colors)) {
+            drawLitMeshInstanced(mesh, models.data(), colors.empty() ? nullptr : colors.data(),
+                                 static_cast<uint32_t>(models.size()));
+        }
+        break;
+    }
+    case CaptureOp::DrawLitBatch: {
+        vkcore::TextureHandle texture = remap.texture(in.u32());
+        vkcore::MeshHandle mesh = remap.mesh(in.u32());
+        if (readInstances(in, models, colors)) {
+            drawLitMeshBatch(mesh, texture, models.data(), colors.empty() ? nullptr : colors.data(),
+                             static_cast<uint32_t>(models.size()));
+        }
+        break;
+    }
+    default:
+        std::cerr << "[Lighting] Unknown capture command" << std::endl;
+        return false;
+    }
+    return in.ok();
+}
 
 } // namespace lighting
 
@@ -1074,6 +2179,7 @@ static lighting::LightingManager* g_lightingManager = nullptr;
 extern "C" {
 
 int lighting_init(void* vulkanCore) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         return 0;  // Already initialized
     }
@@ -1091,6 +2197,7 @@ int lighting_init(void* vulkanCore) {
 }
 
 void lighting_shutdown() {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->shutdown();
         delete g_lightingManager;
@@ -1099,11 +2206,13 @@ void lighting_shutdown() {
 }
 
 int lighting_is_initialized() {
+    EDEN_PROFILE_API();
     return (g_lightingManager && g_lightingManager->isInitialized()) ? 1 : 0;
 }
 
 void lighting_set_directional(float dx, float dy, float dz, 
                                float r, float g, float b, float intensity) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->setDirectionalLight(
             glm::vec3(dx, dy, dz),
@@ -1114,77 +2223,167 @@ void lighting_set_directional(float dx, float dy, float dz,
 }
 
 void lighting_set_ambient(float r, float g, float b) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->setAmbientLight(glm::vec3(r, g, b));
     }
 }
 
 void lighting_set_camera_pos(float x, float y, float z) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->setCameraPosition(glm::vec3(x, y, z));
     }
 }
 
 void lighting_set_shininess(float shininess) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->setShininess(shininess);
     }
 }
 
 void lighting_set_specular_strength(float strength) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->setSpecularStrength(strength);
     }
 }
 
-int lighting_set_point_light(int index, float px, float py, float pz,
+unsigned int lighting_add_point_light(float px, float py, float pz,
+                                      float r, float g, float b,
+                                      float intensity, float range) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager) {
+        return g_lightingManager->addPointLight(glm::vec3(px, py, pz), glm::vec3(r, g, b), intensity, range);
+    }
+    return lighting::INVALID_POINT_LIGHT;
+}
+
+int lighting_set_point_light(unsigned int light, float px, float py, float pz,
                               float r, float g, float b, 
                               float intensity, float range) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
-        return g_lightingManager->setPointLight(index, 
+        return g_lightingManager->setPointLight(light, 
             glm::vec3(px, py, pz), glm::vec3(r, g, b), intensity, range) ? 1 : 0;
     }
     return 0;
 }
 
-void lighting_enable_point_light(int index, int enabled) {
+void lighting_remove_point_light(unsigned int light) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
-        g_lightingManager->enablePointLight(index, enabled != 0);
+        g_lightingManager->removePointLight(light);
+    }
+}
+
+void lighting_enable_point_light(unsigned int light, int enabled) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager) {
+        g_lightingManager->enablePointLight(light, enabled != 0);
     }
 }
 
 void lighting_clear_point_lights() {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->clearPointLights();
     }
 }
 
 int lighting_get_active_point_light_count() {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         return g_lightingManager->getActivePointLightCount();
     }
     return 0;
 }
 
+void lighting_set_clustered(int enabled) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager) {
+        g_lightingManager->setClusteredLighting(enabled != 0);
+    }
+}
+
+void lighting_set_shadow_quality(int quality) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager) {
+        g_lightingManager->setShadowQuality(static_cast<lighting::ShadowQuality>(glm::clamp(quality, 0, 3)));
+    }
+}
+
+unsigned int lighting_add_shadow_caster(unsigned int meshHandle, const float* model, int isStatic) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager && model) {
+        return g_lightingManager->addShadowCaster(static_cast<vkcore::MeshHandle>(meshHandle),
+                                                  glm::make_mat4(model), isStatic != 0);
+    }
+    return lighting::INVALID_SHADOW_CASTER;
+}
+
+int lighting_set_shadow_caster_transform(unsigned int caster, const float* model) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager && model) {
+        return g_lightingManager->setShadowCasterTransform(caster, glm::make_mat4(model)) ? 1 : 0;
+    }
+    return 0;
+}
+
+void lighting_remove_shadow_caster(unsigned int caster) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager) {
+        g_lightingManager->removeShadowCaster(caster);
+    }
+}
+
+// The cache's own hash isn't checked: it is whatever the caller baked
+int lighting_load_irradiance_probes(const char* path) {
+    EDEN_PROFILE_API();
+    if (!g_lightingManager || !path) return 0;
+    lighting::IrradianceProbeGrid grid;
+    if (!grid.load(path)) return 0;
+    return g_lightingManager->setIrradianceProbes(grid) ? 1 : 0;
+}
+
+void lighting_clear_irradiance_probes() {
+    EDEN_PROFILE_API();
+    if (g_lightingManager) {
+        g_lightingManager->clearIrradianceProbes();
+    }
+}
+
+void lighting_set_probe_intensity(float intensity) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager) {
+        g_lightingManager->setProbeIntensity(intensity);
+    }
+}
+
 void lighting_set_view_matrix(const float* mat4) {
+    EDEN_PROFILE_API();
     if (g_lightingManager && mat4) {
         g_lightingManager->setViewMatrix(glm::make_mat4(mat4));
     }
 }
 
 void lighting_set_projection_matrix(const float* mat4) {
+    EDEN_PROFILE_API();
     if (g_lightingManager && mat4) {
         g_lightingManager->setProjectionMatrix(glm::make_mat4(mat4));
     }
 }
 
 void lighting_bind_texture(unsigned int textureHandle) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->bindTexture(static_cast<vkcore::TextureHandle>(textureHandle));
     }
 }
 
 void lighting_bind() {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         g_lightingManager->bind();
     }
@@ -1195,6 +2394,7 @@ void lighting_draw_mesh(unsigned int meshHandle,
                         float rx, float ry, float rz,
                         float sx, float sy, float sz,
                         float r, float g, float b, float a) {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(px, py, pz));
@@ -1211,7 +2411,37 @@ void lighting_draw_mesh(unsigned int meshHandle,
     }
 }
 
+// models: count column-major 4x4 matrices; colors: count RGBA values (may be null)
+void lighting_draw_mesh_instanced(unsigned int meshHandle, const float* models,
+                                  const float* colors, int count) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager && models && count > 0) {
+        g_lightingManager->drawLitMeshInstanced(
+            static_cast<vkcore::MeshHandle>(meshHandle),
+            reinterpret_cast<const glm::mat4*>(models),
+            reinterpret_cast<const glm::vec4*>(colors),
+            static_cast<uint32_t>(count)
+        );
+    }
+}
+
+// models: count column-major 4x4 matrices; colors: count RGBA values (may be null)
+void lighting_draw_mesh_batch(unsigned int meshHandle, unsigned int textureHandle,
+                              const float* models, const float* colors, int count) {
+    EDEN_PROFILE_API();
+    if (g_lightingManager && models && count > 0) {
+        g_lightingManager->drawLitMeshBatch(
+            static_cast<vkcore::MeshHandle>(meshHandle),
+            static_cast<vkcore::TextureHandle>(textureHandle),
+            reinterpret_cast<const glm::mat4*>(models),
+            reinterpret_cast<const glm::vec4*>(colors),
+            static_cast<uint32_t>(count)
+        );
+    }
+}
+
 unsigned int lighting_get_pipeline() {
+    EDEN_PROFILE_API();
     if (g_lightingManager) {
         return g_lightingManager->getLitPipeline();
     }
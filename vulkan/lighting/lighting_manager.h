@@ -2,12 +2,18 @@
 // LIGHTING MANAGER - Modular Lighting System for EDEN Engine
 // ============================================================================
 // A clean, reusable lighting module that works with VulkanCore.
-// Provides Blinn-Phong directional lighting with ambient.
+// Provides Blinn-Phong directional lighting with ambient, plus any number
+// of point lights culled per froxel cluster (light_clusters.h). The
+// directional light casts cascaded shadows (shadow_cascades.h) from the
+// meshes registered with addShadowCaster(). A baked irradiance probe grid
+// (irradiance_probes.h) can replace the constant ambient.
 //
 // Usage (C++):
 //   lighting::LightingManager lights;
 //   lights.init(&vulkanCore);
 //   lights.setDirectionalLight({1, -1, 1}, {1, 1, 1});
+//   lights.addShadowCaster(groundMesh, groundModel);         // static
+//   auto hero = lights.addShadowCaster(heroMesh, heroModel, false);
 //   // In render loop:
 //   lights.bind(commandBuffer);
 //   lights.updateUBO(model, view, proj, color);
@@ -24,11 +30,16 @@
 #define LIGHTING_MANAGER_H
 
 #include "lighting_types.h"
+#include "light_clusters.h"
+#include "shadow_cascades.h"
+#include "irradiance_probes.h"
 #include "../core/vulkan_core.h"
+#include "../core/draw_capture.h"
+#include "../core/handle_pool.h"
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
-#include <unordered_map>
+#include <vector>
 
 namespace lighting {
 
@@ -51,6 +62,13 @@ public:
     void shutdown();
     bool isInitialized() const { return m_initialized; }
     
+    // Vertex format of every lit mesh: POSITION_NORMAL_UV (default) or
+    // PACKED_POSITION_NORMAL_UV (vkcore::packMeshVertices; loads the
+    // .packed.vert.spv shader variants). Call before init(); false for
+    // anything else.
+    bool setVertexFormat(vkcore::VertexFormat format);
+    vkcore::VertexFormat getVertexFormat() const { return m_vertexFormat; }
+    
     // ========================================================================
     // Light Control
     // ========================================================================
@@ -78,24 +96,91 @@ public:
     // Point Lights
     // ========================================================================
     
-    // Set a point light (index 0-3)
-    // Returns false if index out of range
-    bool setPointLight(int index, const glm::vec3& position, const glm::vec3& color, 
+    // Point lights are unbounded: the lit shader only loops over the lights
+    // binned into its fragment's cluster (see light_clusters.h)
+    PointLightHandle addPointLight(const glm::vec3& position, const glm::vec3& color,
+                                   float intensity = 1.0f, float range = 10.0f);
+    PointLightHandle addPointLight(const PointLight& light);
+    void removePointLight(PointLightHandle light);
+    
+    // Update an existing light; returns false for a stale handle
+    bool setPointLight(PointLightHandle light, const glm::vec3& position, const glm::vec3& color,
                        float intensity = 1.0f, float range = 10.0f);
-    bool setPointLight(int index, const PointLight& light);
+    bool setPointLight(PointLightHandle light, const PointLight& data);
     
     // Enable/disable a point light
-    void enablePointLight(int index, bool enabled);
+    void enablePointLight(PointLightHandle light, bool enabled);
     
-    // Get point light (returns default if index invalid)
-    const PointLight& getPointLight(int index) const;
+    // Get point light (returns default if handle is stale)
+    const PointLight& getPointLight(PointLightHandle light) const;
     
-    // Clear all point lights
+    // Remove all point lights
     void clearPointLights();
     
     // Get number of active point lights
     int getActivePointLightCount() const;
     
+    // Froxel culling (on by default). Off: every fragment loops over every
+    // light, as with the old fixed array - for comparing cost and output.
+    void setClusteredLighting(bool enabled) { m_clusters.setEnabled(enabled); markLightsDirty(); }
+    bool isClusteredLighting() const { return m_clusters.isEnabled(); }
+    
+    // View depth range the clusters' slices span; match the projection
+    void setClusterDepthRange(float nearPlane, float farPlane) {
+        m_clusters.setDepthRange(nearPlane, farPlane);
+        markLightsDirty();
+    }
+    
+    // From the last bind(): lights binned, list size, longest cluster
+    const LightClusters::Stats& getClusterStats() const { return m_clusters.getStats(); }
+    
+    // ========================================================================
+    // Shadows (directional light)
+    // ========================================================================
+    
+    // Casters are drawn depth-only and instanced (one draw per mesh per
+    // cascade) in a VulkanCore frame prologue, fitted to VulkanCore's
+    // camera. Static casters also go into the cached far cascades, which
+    // only re-render when the light, a static caster or the camera's
+    // position (past the cache slack) changes.
+    ShadowCasterHandle addShadowCaster(vkcore::MeshHandle mesh, const glm::mat4& model, bool isStatic = true);
+    bool setShadowCasterTransform(ShadowCasterHandle caster, const glm::mat4& model);
+    void removeShadowCaster(ShadowCasterHandle caster);
+    void clearShadowCasters();
+    
+    // Re-render the cached cascades (e.g. after editing a static mesh)
+    void invalidateShadowCache() { m_cascades.invalidate(); }
+    
+    // Cascades, resolution, caching budget and PCF taps per tier; may be
+    // called before or after init() (reallocates the shadow map if needed)
+    void setShadowQuality(ShadowQuality quality) { setShadowConfig(ShadowConfig::forQuality(quality)); }
+    void setShadowConfig(const ShadowConfig& config);
+    const ShadowConfig& getShadowConfig() const { return m_cascades.getConfig(); }
+    
+    struct ShadowStats {
+        uint32_t cascadesRendered = 0;  // This frame; cached cascades mostly skip
+        uint32_t drawCalls = 0;
+        uint32_t instances = 0;         // Caster copies drawn, over all cascades
+    };
+    const ShadowStats& getShadowStats() const { return m_shadowStats; }
+    
+    // ========================================================================
+    // Baked ambient (irradiance probes)
+    // ========================================================================
+    
+    // Inside the grid's bounds (clamped to its edge outside them) ambient
+    // becomes the grid's irradiance for the fragment's normal instead of
+    // the ambient colour. The grid is uploaded in the next frame prologue
+    // and takes over from then on; call after init(). Bake or load one with
+    // bakeIrradianceProbes() / IrradianceProbeGrid::load().
+    bool setIrradianceProbes(const IrradianceProbeGrid& grid);
+    void clearIrradianceProbes();
+    bool hasIrradianceProbes() const { return m_probeVolume.enabled; }
+    
+    // Scales the baked irradiance (1 = as baked)
+    void setProbeIntensity(float intensity);
+    float getProbeIntensity() const { return m_probeIntensity; }
+    
     // ========================================================================
     // Getters
     // ========================================================================
@@ -114,15 +199,17 @@ public:
     // ========================================================================
     
     // Bind a texture for lit rendering (call before drawLitMesh)
-    // Pass INVALID_TEXTURE to use the default white texture
+    // Pass INVALID_TEXTURE to use the default white texture. Textures are
+    // read from VulkanCore's bindless heap, so this binds no descriptors.
     void bindTexture(vkcore::TextureHandle texture);
     
     // ========================================================================
     // Rendering
     // ========================================================================
     
-    // Bind the lit pipeline and descriptor set for rendering
-    // Call this before drawing lit meshes
+    // Bind the lit pipeline, lighting UBO and bindless heap for rendering
+    // Call this before drawing lit meshes. Uploads only what changed since
+    // this frame slot was last written; further calls in a frame just rebind.
     void bind();
     
     // Update the UBO with current transforms and draw a mesh
@@ -131,23 +218,83 @@ public:
                      const glm::mat4& model,
                      const glm::vec4& color = glm::vec4(1.0f));
     
+    // Draw `count` copies of a mesh in one draw call (colors may be null = white).
+    // Call after bind() + bindTexture(); falls back to per-instance drawLitMesh()
+    // if lit_mesh_instanced.vert.spv was not found at init.
+    void drawLitMeshInstanced(vkcore::MeshHandle mesh,
+                              const glm::mat4* models,
+                              const glm::vec4* colors,
+                              uint32_t count);
+    
+    // Draw `count` copies of a mesh with `texture` (INVALID_TEXTURE = white)
+    // in one draw: models and colors (may be null = white) are copied into
+    // this frame's instance SSBO and lit_mesh_batch.vert reads them by
+    // gl_InstanceIndex, so nothing is pushed or bound per object. Call after
+    // bind(); the bindTexture() texture is left as it was. Falls back to
+    // drawLitMeshInstanced() without lit_mesh_batch.vert.spv, inside
+    // recordParallel tasks, or when the SSBO is full - it grows to the
+    // frame's demand at the next bind().
+    void drawLitMeshBatch(vkcore::MeshHandle mesh, vkcore::TextureHandle texture,
+                          const glm::mat4* models, const glm::vec4* colors, uint32_t count);
+    
     // Update matrices (call once per frame before drawing)
     void setViewMatrix(const glm::mat4& view);
     void setProjectionMatrix(const glm::mat4& proj);
     
+    // ========================================================================
+    // Draw Capture (VulkanCore::beginCapture)
+    // ========================================================================
+    // While a capture records, bind() adds the lighting state - matrices,
+    // lights, material, shadow config and casters - whenever it changed,
+    // and bind/bindTexture/drawLitMesh* add their calls. Irradiance probe
+    // grids are not captured (replays light with the constant ambient).
+    
+    static constexpr uint32_t CAPTURE_TAG = vkcore::captureTag("LITE");
+    
+    // Runs one CAPTURE_TAG command on this manager (after init()); point
+    // lights and shadow casters it creates are tracked in remap.objects
+    bool replayCapture(vkcore::CaptureReader& command, vkcore::CaptureRemap& remap);
+    
 private:
     // Create the lit shader pipeline
     bool createLitPipeline();
+    bool createLitPipelineVariant(const char* vertPath, bool instanced, VkPipeline& outPipeline);
     
-    // Create UBO and descriptor set for lighting
+    // Create UBO and descriptor sets for lighting
     bool createLightingResources();
     
-    // Update the GPU UBO
-    void updateGPUBuffer();
+    // Fill m_uboData from the current state and copy it to frame's UBO
+    void packUBO();
+    void updateGPUBuffer(uint32_t frame);
+    
+    // Bin the enabled point lights and write them to this frame's SSBOs
+    void updateLightBuffers(uint32_t frame);
+    
+    // Grow frame's buffer to hold `bytes` (old one destroyed once retired)
+    bool ensureStorage(uint32_t frame, uint32_t binding, VkDeviceSize bytes);
+    void writeFrameSet(uint32_t frame);
+    
+    // Lit pipeline + set 0 (UBO) + set 1 (bindless heap) into `cmd`
+    void bindPipelineAndSets(VkCommandBuffer cmd);
+    
+    // Shadow map array, its render pass and the depth-only pipeline
+    struct ShadowMap;
+    bool createShadowResources();
+    bool createShadowMap(uint32_t resolution, uint32_t layers);
+    bool createShadowPipeline();
+    void destroyShadowMap(ShadowMap& map);
     
-    // Get or create a descriptor set for a given texture
-    // Each texture gets its own descriptor set to prevent sharing
-    VkDescriptorSet getOrCreateDescriptorSet(vkcore::TextureHandle texture);
+    // Frame prologue: refit the cascades and render the ones due
+    void renderShadows(VkCommandBuffer cmd);
+    
+    // Probe volume (null grid = one black probe, bound while probes are off)
+    struct ProbeVolume;
+    bool createProbeResources();
+    bool createProbeVolume(const IrradianceProbeGrid* grid, ProbeVolume& out);
+    void destroyProbeVolume(ProbeVolume& volume);
+    
+    // Frame prologue: copy pending probe data in and swap the new volume in
+    void uploadProbes(VkCommandBuffer cmd);
     
     // ========================================================================
     // State
@@ -155,11 +302,14 @@ private:
     
     vkcore::VulkanCore* m_core = nullptr;
     bool m_initialized = false;
+    vkcore::VertexFormat m_vertexFormat = vkcore::VertexFormat::POSITION_NORMAL_UV;
     
     // Lighting state
     DirectionalLight m_directionalLight;
     AmbientLight m_ambientLight;
-    PointLight m_pointLights[MAX_POINT_LIGHTS];
+    vkcore::HandlePool<PointLight> m_pointLights;
+    LightClusters m_clusters;
+    std::vector<GpuPointLight> m_gpuLights;  // Enabled lights, packed each bind()
     glm::vec3 m_cameraPos = glm::vec3(0.0f, 0.0f, 5.0f);
     float m_shininess = 32.0f;
     float m_specularStrength = 0.5f;
@@ -171,31 +321,139 @@ private:
     
     // Vulkan resources (managed independently for modularity)
     VkPipeline m_pipeline = VK_NULL_HANDLE;
+    VkPipeline m_instancedPipeline = VK_NULL_HANDLE;  // Optional (drawLitMeshInstanced)
+    VkPipeline m_batchPipeline = VK_NULL_HANDLE;      // Optional (drawLitMeshBatch)
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
     VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
-    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
-    VkBuffer m_uboBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory m_uboMemory = VK_NULL_HANDLE;
-    
-    // Default white texture (for when no texture is bound)
-    VkImage m_defaultTexImage = VK_NULL_HANDLE;
-    VkDeviceMemory m_defaultTexMemory = VK_NULL_HANDLE;
-    VkImageView m_defaultTexView = VK_NULL_HANDLE;
-    VkSampler m_defaultSampler = VK_NULL_HANDLE;
-    
-    // Per-texture descriptor sets (one set per unique texture)
-    // This prevents texture sharing by giving each texture its own descriptor set
-    std::unordered_map<vkcore::TextureHandle, VkDescriptorSet> m_textureDescriptorSets;
-    vkcore::TextureHandle m_defaultTextureHandle = vkcore::INVALID_TEXTURE; // Special handle for default texture
     
-    // Currently bound descriptor set (for drawing)
-    VkDescriptorSet m_currentDescriptorSet = VK_NULL_HANDLE;
+    // Set 0 per frame in flight: that frame's UBO (binding 0), point
+    // lights (binding 1), cluster ranges + light indices (binding 2), the
+    // shadow map (binding 3) and drawLitMeshBatch() instances (binding 4,
+    // buffers[3]). Host-visible and persistently mapped, rewritten by
+    // bind() once the frame's fence signalled - and only where the
+    // versions below show the slot is behind. buffers[2] holds the shadow
+    // casters' instance data (vertex buffer, not in the set).
+    struct FrameLights {
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkBuffer ubo = VK_NULL_HANDLE;
+        vkcore::GpuAllocation uboAlloc;
+        VkBuffer buffers[4] = {VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE};  // Lights, clusters, casters, batches
+        vkcore::GpuAllocation allocs[4];
+        VkDeviceSize capacity[4] = {0, 0, 0, 0};
+        uint64_t uboVersion = 0;      // m_uboVersion last copied into `ubo`
+        uint64_t lightsVersion = 0;   // m_lightsVersion last copied into buffers[0..1]
+        bool setStale = false;        // Shadow map or batch SSBO replaced since the set was written
+    };
+    std::vector<FrameLights> m_frames;
+    
+    // Dirty tracking: setters bump these, and a frame slot is rewritten
+    // when it holds an older version. Anything that re-bins the lights also
+    // changes the UBO (light count, cluster grid).
+    uint64_t m_uboVersion = 1;       // Anything packed into LightingUBO
+    uint64_t m_lightsVersion = 1;    // Point lights, matrices, viewport, cluster settings
+    uint64_t m_clustersVersion = 0;  // m_lightsVersion that m_gpuLights/m_clusters were built for
+    uint32_t m_clusterWidth = 0;     // Render size the cluster tiles are sized for
+    uint32_t m_clusterHeight = 0;
+    
+    void markUboDirty() { m_uboVersion++; }
+    void markLightsDirty() { m_lightsVersion++; m_uboVersion++; }
+    
+    // drawLitMeshBatch() instances placed in this frame's SSBO, and asked
+    // for (overflow included); the peak demand sizes every slot's SSBO
+    uint64_t m_batchFrame = UINT64_MAX;  // VulkanCore frame number m_batchHead belongs to
+    uint32_t m_batchHead = 0;
+    uint32_t m_batchRequested = 0;
+    uint32_t m_batchPeak = 0;
+    
+    VkDescriptorSet currentSet() const {
+        return m_frames.empty() ? VK_NULL_HANDLE : m_frames[m_core->getCurrentFrame() % m_frames.size()].set;
+    }
+    
+    // Bound texture, one per recording slot so recordParallel tasks can bind
+    // different textures. Kept as handles: a texture's bindless slot changes
+    // when it is reloaded or streamed, so draws look it up when they push
+    std::vector<vkcore::TextureHandle> m_currentTextures;
+    vkcore::TextureHandle m_noTexture = vkcore::INVALID_TEXTURE;  // Returned before init
+    
+    vkcore::TextureHandle& currentTexture() {
+        uint32_t slot = m_core ? m_core->getRecordingSlot() : 0;
+        return slot < m_currentTextures.size() ? m_currentTextures[slot] : m_noTexture;
+    }
+    
+    // Shadows
+    struct ShadowCaster {
+        vkcore::MeshHandle mesh = vkcore::INVALID_MESH;
+        glm::mat4 model = glm::mat4(1.0f);
+        bool isStatic = true;
+    };
+    
+    // Depth array, one layer (view + framebuffer) per cascade
+    struct ShadowMap {
+        VkImage image = VK_NULL_HANDLE;
+        vkcore::GpuAllocation alloc;
+        VkImageView arrayView = VK_NULL_HANDLE;  // Sampled by lit_mesh.frag
+        std::vector<VkImageView> layerViews;
+        std::vector<VkFramebuffer> framebuffers;
+        uint32_t resolution = 0;
+        uint32_t layers = 0;
+        bool cleared = false;  // Every layer written once (laid out for sampling)
+    };
+    
+    // Instanced draw of one mesh's visible casters into one cascade
+    struct ShadowDraw {
+        uint32_t cascade;
+        vkcore::MeshHandle mesh;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+    };
+    
+    ShadowCascades m_cascades;
+    vkcore::HandlePool<ShadowCaster> m_shadowCasters;
+    ShadowMap m_shadowMap;
+    ShadowStats m_shadowStats;
+    VkFormat m_shadowFormat = VK_FORMAT_UNDEFINED;
+    VkRenderPass m_shadowRenderPass = VK_NULL_HANDLE;
+    VkPipeline m_shadowPipeline = VK_NULL_HANDLE;  // Optional (shadow_depth.vert.spv)
+    VkPipelineLayout m_shadowPipelineLayout = VK_NULL_HANDLE;
+    VkSampler m_shadowSampler = VK_NULL_HANDLE;
+    uint32_t m_prologue = 0;  // uploadProbes() + renderShadows()
+    
+    // Scratch for renderShadows(), kept to avoid per-frame allocation
+    std::vector<std::pair<vkcore::MeshHandle, const ShadowCaster*>> m_shadowVisible;
+    std::vector<glm::mat4> m_shadowModels;
+    std::vector<ShadowDraw> m_shadowDraws;
+    
+    // Irradiance probes: the volume the sets reference, and a replacement
+    // waiting for the prologue to upload it
+    struct ProbeVolume {
+        VkImage image = VK_NULL_HANDLE;
+        vkcore::GpuAllocation alloc;
+        VkImageView view = VK_NULL_HANDLE;
+        VkBuffer staging = VK_NULL_HANDLE;  // Texels not yet copied in
+        vkcore::GpuAllocation stagingAlloc;
+        VkExtent3D extent = {1, 1, 1};      // Probes per axis (z x PROBE_SH_COEFFS in the image)
+        glm::vec3 origin = glm::vec3(0.0f);
+        glm::vec3 spacing = glm::vec3(1.0f);
+        bool enabled = false;
+    };
+    ProbeVolume m_probeVolume;
+    ProbeVolume m_pendingProbes;
+    VkSampler m_probeSampler = VK_NULL_HANDLE;
+    float m_probeIntensity = 1.0f;
     
     // Legacy handle (for compatibility)
     vkcore::PipelineHandle m_litPipeline = vkcore::INVALID_PIPELINE;
     
-    // The actual UBO data
+    // CPU copy of the UBO, packed when a frame slot is behind
     LightingUBO m_uboData;
+    
+    // Draw capture: the frame and versions the last captured state had
+    uint64_t m_captureFrame = 0;
+    uint64_t m_captureUboVersion = 0;
+    uint64_t m_captureLightsVersion = 0;
+    vkcore::DrawCapture* recordingCapture() const;
+    void captureState(vkcore::DrawCapture& capture);
+    void replayState(vkcore::CaptureReader& in, vkcore::CaptureRemap& remap);
 };
 
 } // namespace lighting
@@ -228,13 +486,31 @@ void lighting_set_projection_matrix(const float* mat4);
 // Texture
 void lighting_bind_texture(unsigned int textureHandle);
 
-// Point lights
-int lighting_set_point_light(int index, float px, float py, float pz,
+// Point lights (handles; 0xFFFFFFFF = failed)
+unsigned int lighting_add_point_light(float px, float py, float pz,
+                                      float r, float g, float b,
+                                      float intensity, float range);
+int lighting_set_point_light(unsigned int light, float px, float py, float pz,
                               float r, float g, float b, 
                               float intensity, float range);
-void lighting_enable_point_light(int index, int enabled);
+void lighting_remove_point_light(unsigned int light);
+void lighting_enable_point_light(unsigned int light, int enabled);
 void lighting_clear_point_lights();
 int lighting_get_active_point_light_count();
+void lighting_set_clustered(int enabled);
+
+// Shadows (quality: 0 = off, 1 = low, 2 = medium, 3 = high; model is a
+// column-major 4x4 matrix; casters return 0xFFFFFFFF on failure)
+void lighting_set_shadow_quality(int quality);
+unsigned int lighting_add_shadow_caster(unsigned int meshHandle, const float* model, int isStatic);
+int lighting_set_shadow_caster_transform(unsigned int caster, const float* model);
+void lighting_remove_shadow_caster(unsigned int caster);
+
+// Baked ambient: loads a probe cache written by bakeIrradianceProbes()
+// (1 = loaded); clear returns to the constant ambient colour
+int lighting_load_irradiance_probes(const char* path);
+void lighting_clear_irradiance_probes();
+void lighting_set_probe_intensity(float intensity);
 
 // Rendering
 void lighting_bind();
@@ -243,6 +519,10 @@ void lighting_draw_mesh(unsigned int meshHandle,
                         float rx, float ry, float rz,
                         float sx, float sy, float sz,
                         float r, float g, float b, float a);
+void lighting_draw_mesh_instanced(unsigned int meshHandle, const float* models,
+                                  const float* colors, int count);
+void lighting_draw_mesh_batch(unsigned int meshHandle, unsigned int textureHandle,
+                              const float* models, const float* colors, int count);
 
 // Get pipeline handle (for manual binding)
 unsigned int lighting_get_pipeline();
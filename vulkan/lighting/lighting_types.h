@@ -9,6 +9,7 @@
 #define LIGHTING_TYPES_H
 
 #include <glm/glm.hpp>
+#include <cstdint>
 
 namespace lighting {
 
@@ -45,25 +46,53 @@ struct PointLight {
         : position(pos), color(col), intensity(i), range(r), enabled(true) {}
 };
 
-// Maximum number of point lights supported
-constexpr int MAX_POINT_LIGHTS = 4;
+// Handle from LightingManager::addPointLight(); there is no fixed light cap
+using PointLightHandle = uint32_t;
+constexpr PointLightHandle INVALID_POINT_LIGHT = UINT32_MAX;
+
+// Handle from LightingManager::addShadowCaster()
+using ShadowCasterHandle = uint32_t;
+constexpr ShadowCasterHandle INVALID_SHADOW_CASTER = UINT32_MAX;
+
+// ============================================================================
+// Light Clusters (froxel grid the lit shader looks lights up in)
+// ============================================================================
+// Must match the defines in lit_mesh.frag. 16x9 tiles suit 16:9 screens;
+// slices are exponential in view depth (see light_clusters.h).
+// ============================================================================
+
+constexpr uint32_t CLUSTER_X = 16;
+constexpr uint32_t CLUSTER_Y = 9;
+constexpr uint32_t CLUSTER_Z = 24;
+constexpr uint32_t CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+// One enabled point light in the light SSBO (set 0, binding 1)
+struct GpuPointLight {
+    glm::vec4 positionRange;   // xyz = world position, w = range
+    glm::vec4 colorIntensity;  // rgb = color, w = intensity
+};
+
+static_assert(sizeof(GpuPointLight) == 32, "GpuPointLight size mismatch");
 
 // ============================================================================
 // Push Constants (per-object data, sent via vkCmdPushConstants)
 // ============================================================================
-// This changes per draw call - model matrix and object color.
-// Max push constant size is typically 128-256 bytes.
-// Our struct is 80 bytes (mat4 = 64, vec4 = 16).
+// This changes per draw call - model matrix, object color and the bindless
+// heap slot of the bound texture.
+// Max push constant size is at least 128 bytes.
+// Our struct is 96 bytes (mat4 = 64, vec4 = 16, uint + padding = 16).
 // ============================================================================
 
 struct PushConstants {
     glm::mat4 model;          // 64 bytes - model transform matrix
     glm::vec4 objectColor;    // 16 bytes - object tint color (rgba)
+    uint32_t textureIndex;    // 4 bytes - VulkanCore bindless heap slot
+    uint32_t padding[3];      // 12 bytes - keep 16-byte size
     
-    PushConstants() : model(1.0f), objectColor(1.0f) {}
+    PushConstants() : model(1.0f), objectColor(1.0f), textureIndex(0), padding{0, 0, 0} {}
 };
 
-static_assert(sizeof(PushConstants) == 80, "PushConstants size mismatch");
+static_assert(sizeof(PushConstants) == 96, "PushConstants size mismatch");
 
 // ============================================================================
 // Lighting UBO (GPU-side, shader-compatible, per-frame data)
@@ -89,11 +118,23 @@ struct LightingUBO {
     glm::vec4 cameraPos;      // xyz = world-space camera position, w = unused
     
     // Material properties (16 bytes)
-    glm::vec4 material;       // x = shininess, y = specularStrength, z = numPointLights, w = debugMode (1=normals)
+    glm::vec4 material;       // x = shininess, y = specularStrength, z = unused, w = debugMode (1=normals)
+    
+    // Light clusters (16 bytes each = 48 bytes); point lights live in SSBOs
+    glm::vec4 clusterGrid;    // xyz = clusters per axis (1,1,1 = unclustered), w = numPointLights
+    glm::vec4 clusterDepth;   // x = near, y = far, z = slices / log(far / near), w = unused
+    glm::vec4 clusterScreen;  // xy = tile size in pixels, zw = unused
+    
+    // Directional shadows (64 * 4 + 16 * 3 = 304 bytes), see shadow_cascades.h
+    glm::mat4 cascadeViewProj[4];  // World to shadow map clip, per cascade (MAX_CASCADES)
+    glm::vec4 cascadeSplits;       // View depth each cascade ends at
+    glm::vec4 cascadeTexelSize;    // World units per shadow texel, per cascade
+    glm::vec4 shadowParams;        // x = cascade count (0 = off), y = PCF radius, z = 1 / resolution, w = normal offset
     
-    // Point lights (32 bytes each = 128 bytes for 4 lights)
-    glm::vec4 pointLightPosInt[MAX_POINT_LIGHTS];    // xyz = position, w = intensity
-    glm::vec4 pointLightColorRange[MAX_POINT_LIGHTS]; // xyz = color, w = range
+    // Baked ambient (16 bytes each = 48 bytes), see irradiance_probes.h
+    glm::vec4 probeOrigin;      // xyz = world position of the first probe, w = 1 when a grid is bound
+    glm::vec4 probeInvSpacing;  // xyz = 1 / probe spacing, w = lookup offset along the normal (world units)
+    glm::vec4 probeDims;        // xyz = probes per axis, w = intensity
     
     // Initialize with sensible defaults
     LightingUBO() {
@@ -103,19 +144,24 @@ struct LightingUBO {
         lightColor = glm::vec4(1.0f, 0.98f, 0.95f, 1.0f);
         ambientColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
         cameraPos = glm::vec4(0.0f, 0.0f, 5.0f, 1.0f);
-        material = glm::vec4(32.0f, 0.5f, 0.0f, 0.0f);  // shininess=32, specular=0.5, numLights=0
-        
-        // Initialize point lights to disabled (intensity = 0)
-        for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
-            pointLightPosInt[i] = glm::vec4(0.0f);
-            pointLightColorRange[i] = glm::vec4(1.0f, 1.0f, 1.0f, 10.0f);
-        }
+        material = glm::vec4(32.0f, 0.5f, 0.0f, 0.0f);  // shininess=32, specular=0.5
+        clusterGrid = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+        clusterDepth = glm::vec4(0.1f, 1000.0f, 1.0f, 0.0f);
+        clusterScreen = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+        for (glm::mat4& cascade : cascadeViewProj) cascade = glm::mat4(1.0f);
+        cascadeSplits = glm::vec4(0.0f);
+        cascadeTexelSize = glm::vec4(0.0f);
+        shadowParams = glm::vec4(0.0f);
+        probeOrigin = glm::vec4(0.0f);
+        probeInvSpacing = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+        probeDims = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
     }
 };
 
 // Verify UBO size at compile time
-// 128 (matrices) + 32 (dir light) + 16 (ambient) + 16 (camera) + 16 (material) + 128 (point lights) = 336 bytes
-static_assert(sizeof(LightingUBO) == 336, "LightingUBO size mismatch - check alignment");
+// 128 (matrices) + 32 (dir light) + 16 (ambient) + 16 (camera) + 16 (material) + 48 (clusters)
+// + 304 (shadows) + 48 (probes) = 608 bytes
+static_assert(sizeof(LightingUBO) == 608, "LightingUBO size mismatch - check alignment");
 
 } // namespace lighting
 
@@ -1,11 +1,22 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // ============================================================================
 // LIT MESH FRAGMENT SHADER - Blinn-Phong Lighting
 // ============================================================================
 // Part of the EDEN Engine modular lighting system.
-// Supports directional light + up to 4 point lights.
-// Per-object data comes from vertex shader (via push constants).
+// Supports directional light + any number of point lights: each fragment
+// only loops over the lights binned into its froxel cluster
+// (lighting::LightClusters, rebuilt every LightingManager::bind()).
+// The directional light is shadowed by up to 4 cascades
+// (lighting::ShadowCascades) with PCF. With a baked probe grid
+// (lighting::IrradianceProbeGrid) ambient comes from its L1 irradiance
+// instead of the constant ambient colour.
+// Per-object data comes from vertex shader (via push constants); the texture
+// is VulkanCore's bindless heap slot push.textureIndex.
+// Built twice: with -DTEXEL_DENSITY (lit_mesh.density.frag.spv) it also
+// reports texel density for texture streaming. That build writes a storage
+// buffer, so only devices with fragmentStoresAndAtomics load it.
 // ============================================================================
 
 // Inputs from vertex shader
@@ -17,8 +28,11 @@ layout(location = 3) in vec4 fragObjectColor;
 // Output color
 layout(location = 0) out vec4 outColor;
 
-// Maximum point lights (must match C++ MAX_POINT_LIGHTS)
-#define MAX_POINT_LIGHTS 4
+// Cluster grid (must match lighting::CLUSTER_X/Y/Z)
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define CLUSTER_COUNT (CLUSTER_X * CLUSTER_Y * CLUSTER_Z)
 
 // Uniform buffer for per-frame data (constant during frame)
 layout(binding = 0) uniform LightingUBO {
@@ -28,22 +42,74 @@ layout(binding = 0) uniform LightingUBO {
     vec4 lightColor;     // rgb = color
     vec4 ambientColor;   // rgb = ambient
     vec4 cameraPos;      // xyz = camera position
-    vec4 material;       // x = shininess, y = specularStrength, z = numPointLights, w = debugMode (1=normals)
-    
-    // Point lights
-    vec4 pointLightPosInt[MAX_POINT_LIGHTS];    // xyz = position, w = intensity
-    vec4 pointLightColorRange[MAX_POINT_LIGHTS]; // xyz = color, w = range
+    vec4 material;       // x = shininess, y = specularStrength, w = debugMode (1=normals)
+    vec4 clusterGrid;    // xyz = clusters per axis (1,1,1 = unclustered), w = numPointLights
+    vec4 clusterDepth;   // x = near, y = far, z = slices / log(far / near)
+    vec4 clusterScreen;  // xy = tile size in pixels
+    mat4 cascadeViewProj[4];  // World to shadow map clip (0..1 depth)
+    vec4 cascadeSplits;       // View depth each cascade ends at
+    vec4 cascadeTexelSize;    // World units per shadow texel
+    vec4 shadowParams;        // x = cascades (0 = off), y = PCF radius, z = 1 / resolution, w = normal offset
+    vec4 probeOrigin;         // xyz = first probe, w = 1 when a probe grid is bound
+    vec4 probeInvSpacing;     // xyz = 1 / probe spacing, w = normal offset (world units)
+    vec4 probeDims;           // xyz = probes per axis, w = intensity
 } ubo;
 
-// Texture sampler
-layout(binding = 1) uniform sampler2D texSampler;
+// Must match lighting::GpuPointLight
+struct PointLight {
+    vec4 positionRange;   // xyz = position, w = range
+    vec4 colorIntensity;  // rgb = color, w = intensity
+};
+
+layout(std430, binding = 1) readonly buffer PointLights { PointLight pointLights[]; };
+
+// Per cluster (offset, count) into lightIndices
+layout(std430, binding = 2) readonly buffer Clusters {
+    uvec2 clusterRanges[CLUSTER_COUNT];
+    uint lightIndices[];
+};
+
+// One layer per cascade; compare sampler, so each tap is 2x2 filtered
+layout(binding = 3) uniform sampler2DArrayShadow shadowMap;
+
+// L1 SH per probe, one RGBA16F texel per coefficient: the volume is the
+// probe grid stacked 4 times along z (coefficient k in slab k)
+layout(binding = 5) uniform sampler3D probeVolume;
+
+// Per-object push constants (must match lighting::PushConstants)
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 objectColor;
+    uint textureIndex;
+} push;
+
+// VulkanCore bindless heap (set 1, vkcore::BINDLESS_SET)
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+#ifdef TEXEL_DENSITY
+// Texture streaming feedback, one uint per heap slot (vkcore::TextureStreamer)
+layout(std430, set = 1, binding = 1) buffer TexelDensity { uint texelDensity[]; };
+
+// Finest screen-space texel density the slot is sampled at, in the
+// encoding TextureStreamer::desiredBaseMip() reads. One fragment in 16
+// reports; the maximum survives, so little is lost.
+void reportTexelDensity(uint index, vec2 uv) {
+    vec2 dx = dFdx(uv);  // Before the branch: derivatives need the whole quad
+    vec2 dy = dFdy(uv);
+    if (((uint(gl_FragCoord.x) | uint(gl_FragCoord.y)) & 3u) != 0u) return;
+    float density = -0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-12));
+    atomicMax(texelDensity[index], uint(clamp(density, 0.0, 15.9) * 16.0) + 1u);
+}
+#else
+void reportTexelDensity(uint index, vec2 uv) {}
+#endif
 
 // Calculate point light contribution
-vec3 calcPointLight(int index, vec3 N, vec3 V, vec3 baseColor, float shininess, float specularStrength) {
-    vec3 lightPos = ubo.pointLightPosInt[index].xyz;
-    float intensity = ubo.pointLightPosInt[index].w;
-    vec3 lightCol = ubo.pointLightColorRange[index].xyz;
-    float range = ubo.pointLightColorRange[index].w;
+vec3 calcPointLight(uint index, vec3 N, vec3 V, vec3 baseColor, float shininess, float specularStrength) {
+    vec3 lightPos = pointLights[index].positionRange.xyz;
+    float range = pointLights[index].positionRange.w;
+    vec3 lightCol = pointLights[index].colorIntensity.rgb;
+    float intensity = pointLights[index].colorIntensity.w;
     
     // Skip disabled lights (intensity <= 0)
     if (intensity <= 0.0) return vec3(0.0);
@@ -71,9 +137,67 @@ vec3 calcPointLight(int index, vec3 N, vec3 V, vec3 baseColor, float shininess,
     return diffuse + specular;
 }
 
+// Index of this fragment's froxel (same mapping as LightClusters::build)
+uint clusterIndex() {
+    uvec3 grid = uvec3(ubo.clusterGrid.xyz);
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / ubo.clusterScreen.xy), grid.xy - 1u);
+    
+    float viewDepth = -(ubo.view * vec4(fragWorldPos, 1.0)).z;
+    float slice = log(max(viewDepth, ubo.clusterDepth.x) / ubo.clusterDepth.x) * ubo.clusterDepth.z;
+    uint z = grid.z > 1u ? min(uint(slice), grid.z - 1u) : 0u;
+    
+    return (z * grid.y + tile.y) * grid.x + tile.x;
+}
+
+// Fraction of the directional light reaching this fragment
+float shadowFactor(vec3 N, vec3 L) {
+    int count = int(ubo.shadowParams.x);
+    if (count == 0) return 1.0;
+    
+    float viewDepth = -(ubo.view * vec4(fragWorldPos, 1.0)).z;
+    if (viewDepth > ubo.cascadeSplits[count - 1]) return 1.0;  // Past the shadow distance
+    int cascade = 0;
+    while (cascade < count - 1 && viewDepth > ubo.cascadeSplits[cascade]) cascade++;
+    
+    // Push the lookup off the surface along the normal, more at grazing
+    // angles where depth bias alone leaves acne
+    float offset = ubo.shadowParams.w * ubo.cascadeTexelSize[cascade] * (1.0 - max(dot(N, L), 0.0));
+    vec4 clip = ubo.cascadeViewProj[cascade] * vec4(fragWorldPos + N * offset, 1.0);
+    vec3 coord = clip.xyz / clip.w;
+    if (coord.z >= 1.0) return 1.0;
+    vec2 uv = coord.xy * 0.5 + 0.5;
+    
+    int radius = int(ubo.shadowParams.y);
+    float texel = ubo.shadowParams.z;
+    float lit = 0.0;
+    for (int y = -radius; y <= radius; y++) {
+        for (int x = -radius; x <= radius; x++) {
+            lit += texture(shadowMap, vec4(uv + vec2(x, y) * texel, float(cascade), coord.z));
+        }
+    }
+    float taps = float(2 * radius + 1);
+    return lit / (taps * taps);
+}
+
+// Baked irradiance (divided by pi) arriving at this fragment around N
+vec3 probeIrradiance(vec3 N) {
+    vec3 dims = ubo.probeDims.xyz;
+    vec3 cell = (fragWorldPos + N * ubo.probeInvSpacing.w - ubo.probeOrigin.xyz) * ubo.probeInvSpacing.xyz;
+    
+    // Between the outer probes' centres, so filtering never crosses a slab
+    vec3 uvw = (clamp(cell, vec3(0.0), dims - 1.0) + 0.5) / vec3(dims.xy, dims.z * 4.0);
+    float slab = 1.0 / 4.0;
+    vec3 c0 = texture(probeVolume, uvw).rgb;
+    vec3 c1 = texture(probeVolume, uvw + vec3(0.0, 0.0, slab)).rgb;
+    vec3 c2 = texture(probeVolume, uvw + vec3(0.0, 0.0, 2.0 * slab)).rgb;
+    vec3 c3 = texture(probeVolume, uvw + vec3(0.0, 0.0, 3.0 * slab)).rgb;
+    return max(c0 + c1 * N.y + c2 * N.z + c3 * N.x, vec3(0.0)) * ubo.probeDims.w;
+}
+
 void main() {
     // Sample texture
-    vec4 texColor = texture(texSampler, fragTexCoord);
+    vec4 texColor = texture(textures[push.textureIndex], fragTexCoord);
+    reportTexelDensity(push.textureIndex, fragTexCoord);
     vec3 baseColor = texColor.rgb * fragObjectColor.rgb;
     
     // Normalize inputs - handle zero-length normals
@@ -86,7 +210,6 @@ void main() {
     // Material properties
     float shininess = ubo.material.x;
     float specularStrength = ubo.material.y;
-    int numPointLights = int(ubo.material.z);
     int debugMode = int(ubo.material.w);
     
     // ========================================================================
@@ -154,7 +277,7 @@ void main() {
     
     // Debug Mode 9: Sample texture at fixed center UV (0.5, 0.5) - tests if texture regions differ
     if (debugMode == 9) {
-        vec4 centerTex = texture(texSampler, vec2(0.5, 0.5));
+        vec4 centerTex = texture(textures[push.textureIndex], vec2(0.5, 0.5));
         outColor = vec4(centerTex.rgb, 1.0);
         return;
     }
@@ -175,7 +298,7 @@ void main() {
     // ========================================================================
     // Ambient
     // ========================================================================
-    vec3 ambient = ubo.ambientColor.rgb * baseColor;
+    vec3 ambient = (ubo.probeOrigin.w > 0.0 ? probeIrradiance(N) : ubo.ambientColor.rgb) * baseColor;
     
     // ========================================================================
     // Directional Light
@@ -194,16 +317,18 @@ void main() {
         float spec = pow(max(dot(N, H), 0.0), shininess);
         vec3 specular = spec * specularStrength * ubo.lightColor.rgb * dirIntensity;
         
-        dirResult = diffuse + specular;
+        dirResult = (diffuse + specular) * shadowFactor(N, L);
     }
     
     // ========================================================================
     // Point Lights
     // ========================================================================
     vec3 pointResult = vec3(0.0);
-    for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
-        if (i >= numPointLights) break;
-        pointResult += calcPointLight(i, N, V, baseColor, shininess, specularStrength);
+    if (ubo.clusterGrid.w > 0.0) {
+        uvec2 range = clusterRanges[clusterIndex()];
+        for (uint i = 0u; i < range.y; ++i) {
+            pointResult += calcPointLight(lightIndices[range.x + i], N, V, baseColor, shininess, specularStrength);
+        }
     }
     
     // ========================================================================
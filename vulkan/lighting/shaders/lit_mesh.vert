@@ -9,7 +9,22 @@
 
 // Vertex inputs (matches POSITION_NORMAL_UV format)
 layout(location = 0) in vec3 inPosition;
+#ifdef VERTEX_PACKED
+// PACKED_POSITION_NORMAL_UV (glslc -DVERTEX_PACKED, vertex_packing.h): the
+// position arrives in [0, 1] and the model matrix dequantizes it; the
+// normal is octahedral
+layout(location = 1) in vec2 inNormalOct;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+#define inNormal octDecode(inNormalOct)
+#else
 layout(location = 1) in vec3 inNormal;
+#endif
 layout(location = 2) in vec2 inTexCoord;
 
 // Outputs to fragment shader
@@ -18,13 +33,11 @@ layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec2 fragTexCoord;
 layout(location = 3) out vec4 fragObjectColor;
 
-// Maximum point lights (must match fragment shader)
-#define MAX_POINT_LIGHTS 4
-
 // Push constants for per-object data (changes every draw call)
 layout(push_constant) uniform PushConstants {
     mat4 model;
     vec4 objectColor;
+    uint textureIndex;   // Read by the fragment shader
 } push;
 
 // Uniform buffer for per-frame data (constant during frame)
@@ -36,8 +49,16 @@ layout(binding = 0) uniform LightingUBO {
     vec4 ambientColor;
     vec4 cameraPos;
     vec4 material;
-    vec4 pointLightPosInt[MAX_POINT_LIGHTS];
-    vec4 pointLightColorRange[MAX_POINT_LIGHTS];
+    vec4 clusterGrid;
+    vec4 clusterDepth;
+    vec4 clusterScreen;
+    mat4 cascadeViewProj[4];
+    vec4 cascadeSplits;
+    vec4 cascadeTexelSize;
+    vec4 shadowParams;
+    vec4 probeOrigin;
+    vec4 probeInvSpacing;
+    vec4 probeDims;
 } ubo;
 
 void main() {
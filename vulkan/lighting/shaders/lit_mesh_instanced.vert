@@ -0,0 +1,80 @@
+#version 450
+
+// ============================================================================
+// LIT MESH VERTEX SHADER (INSTANCED)
+// ============================================================================
+// Part of the EDEN Engine modular lighting system.
+// Instanced variant of lit_mesh.vert: model matrix and color come from the
+// per-instance vertex stream (vkcore::InstanceData, binding 1) instead of
+// push constants. Used by LightingManager::drawLitMeshInstanced().
+// ============================================================================
+
+// Vertex inputs (matches POSITION_NORMAL_UV format)
+layout(location = 0) in vec3 inPosition;
+#ifdef VERTEX_PACKED
+// PACKED_POSITION_NORMAL_UV (glslc -DVERTEX_PACKED, vertex_packing.h): the
+// position arrives in [0, 1] and the model matrix dequantizes it; the
+// normal is octahedral
+layout(location = 1) in vec2 inNormalOct;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+#define inNormal octDecode(inNormalOct)
+#else
+layout(location = 1) in vec3 inNormal;
+#endif
+layout(location = 2) in vec2 inTexCoord;
+
+// Per-instance inputs (must match vkcore::INSTANCE_LOCATION)
+layout(location = 8) in mat4 inInstanceModel;   // Uses locations 8-11
+layout(location = 12) in vec4 inInstanceColor;
+
+// Outputs to fragment shader
+layout(location = 0) out vec3 fragWorldPos;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;
+layout(location = 3) out vec4 fragObjectColor;
+
+// Uniform buffer for per-frame data (constant during frame)
+layout(binding = 0) uniform LightingUBO {
+    mat4 view;
+    mat4 projection;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 ambientColor;
+    vec4 cameraPos;
+    vec4 material;
+    vec4 clusterGrid;
+    vec4 clusterDepth;
+    vec4 clusterScreen;
+    mat4 cascadeViewProj[4];
+    vec4 cascadeSplits;
+    vec4 cascadeTexelSize;
+    vec4 shadowParams;
+    vec4 probeOrigin;
+    vec4 probeInvSpacing;
+    vec4 probeDims;
+} ubo;
+
+void main() {
+    // World-space position
+    vec4 worldPos = inInstanceModel * vec4(inPosition, 1.0);
+    fragWorldPos = worldPos.xyz;
+    
+    // World-space normal (using normal matrix for non-uniform scaling)
+    mat3 normalMatrix = transpose(inverse(mat3(inInstanceModel)));
+    fragNormal = normalize(normalMatrix * inNormal);
+    
+    // Pass through texture coordinates
+    fragTexCoord = inTexCoord;
+    
+    // Pass object color to fragment shader
+    fragObjectColor = inInstanceColor;
+    
+    // Final clip-space position
+    gl_Position = ubo.projection * ubo.view * worldPos;
+}
@@ -0,0 +1,24 @@
+#version 450
+
+// ============================================================================
+// SHADOW DEPTH VERTEX SHADER
+// ============================================================================
+// Part of the EDEN Engine modular lighting system.
+// Depth-only, instanced: LightingManager draws each mesh's shadow casters
+// into one cascade layer per draw. There is no fragment stage.
+// ============================================================================
+
+// Vertex inputs (matches POSITION_NORMAL_UV format; only position is read)
+layout(location = 0) in vec3 inPosition;
+
+// Per-instance model matrix (must match vkcore::INSTANCE_LOCATION)
+layout(location = 8) in mat4 inInstanceModel;   // Uses locations 8-11
+
+// The cascade's light view-projection (ShadowCascades::Cascade::viewProj)
+layout(push_constant) uniform ShadowPush {
+    mat4 viewProj;
+} push;
+
+void main() {
+    gl_Position = push.viewProj * inInstanceModel * vec4(inPosition, 1.0);
+}
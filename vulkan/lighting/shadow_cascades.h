@@ -0,0 +1,238 @@
+// ============================================================================
+// SHADOW CASCADES - Cascade fitting and caching for directional shadows
+// ============================================================================
+// Part of the EDEN Engine modular lighting system.
+//
+// The view frustum up to ShadowConfig::maxDistance is split into up to
+// MAX_CASCADES slices (blend of uniform and logarithmic splits). Each gets an
+// orthographic light matrix rendering into one layer of LightingManager's
+// shadow map array. The farthest `cachedCascades` are CACHED:
+//
+//   - Centred on the camera (not the slice) with a radius that covers the
+//     slice in every view direction, plus cacheMoveThreshold of slack, so
+//     turning the camera never invalidates them and walking only does once
+//     the camera leaves the slack.
+//   - They hold static casters only and are re-rendered when the light
+//     direction or static geometry changes (invalidate()), or the camera
+//     left the slack - at most cachedUpdatesPerFrame of them per frame,
+//     nearest first. A cascade waiting for its turn keeps the matrix it was
+//     rendered with, so it stays correct, just stale.
+//
+// The near cascades are refitted and re-rendered every frame, with static
+// and dynamic casters. Centres are snapped to whole shadow texels in light
+// space and radii are rounded, so edges don't shimmer as the camera moves.
+//
+// Header-only; LightingManager owns one. Not thread-safe.
+//
+// Usage:
+//   ShadowCascades cascades;
+//   cascades.setConfig(ShadowConfig::forQuality(ShadowQuality::Medium));
+//   uint32_t renderMask = cascades.update(view, proj, nearPlane, lightDir);
+//   for each bit c in renderMask: render casters with cascades.get(c).viewProj
+// ============================================================================
+
+#ifndef SHADOW_CASCADES_H
+#define SHADOW_CASCADES_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace lighting {
+
+constexpr uint32_t MAX_CASCADES = 4;
+
+// Performance tiers for setShadowQuality()
+enum class ShadowQuality {
+    Off,     // No shadow rendering or sampling
+    Low,     // 2 cascades at 1024, single hardware-filtered tap
+    Medium,  // 3 cascades at 2048, 3x3 PCF
+    High     // 4 cascades at 2048, 5x5 PCF
+};
+
+struct ShadowConfig {
+    uint32_t cascadeCount = 3;        // 0 = shadows off, up to MAX_CASCADES
+    uint32_t resolution = 2048;       // Per cascade layer
+    float maxDistance = 150.0f;       // View depth where shadows end
+    float splitLambda = 0.75f;        // 0 = uniform splits, 1 = logarithmic
+    uint32_t cachedCascades = 1;      // Farthest N cascades are cached (static casters only)
+    uint32_t cachedUpdatesPerFrame = 1;  // Cached cascade re-renders allowed per frame
+    float cacheMoveThreshold = 0.15f; // Slack, as a fraction of the cascade radius
+    float casterPullback = 50.0f;     // Depth behind each cascade that still casts into it
+    uint32_t pcfRadius = 1;           // Taps = (2 * radius + 1)^2, each hardware 2x2 filtered
+    float depthBiasConstant = 1.25f;  // vkCmdSetDepthBias while rendering casters
+    float depthBiasSlope = 1.75f;
+    float normalOffset = 1.5f;        // Receiver offset along the normal, in texels
+
+    static ShadowConfig forQuality(ShadowQuality quality) {
+        ShadowConfig config;
+        switch (quality) {
+            case ShadowQuality::Off:
+                config.cascadeCount = 0;
+                break;
+            case ShadowQuality::Low:
+                config.cascadeCount = 2;
+                config.resolution = 1024;
+                config.pcfRadius = 0;
+                config.maxDistance = 80.0f;
+                break;
+            case ShadowQuality::Medium:
+                break;
+            case ShadowQuality::High:
+                config.cascadeCount = 4;
+                config.cachedCascades = 2;
+                config.pcfRadius = 2;
+                config.maxDistance = 250.0f;
+                break;
+        }
+        return config;
+    }
+};
+
+class ShadowCascades {
+public:
+    struct Cascade {
+        glm::mat4 viewProj = glm::mat4(1.0f);  // World to shadow clip (Vulkan 0..1 depth)
+        float splitFar = 0.0f;      // View depth this cascade covers up to
+        float texelSize = 0.0f;     // World units per shadow texel
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+        bool cached = false;
+        bool valid = false;         // Rendered at least once with this config
+        bool dirty = true;          // Cached: contents out of date
+    };
+
+    void setConfig(const ShadowConfig& config) {
+        m_config = config;
+        m_config.cascadeCount = std::min(m_config.cascadeCount, MAX_CASCADES);
+        m_config.cachedCascades = std::min(m_config.cachedCascades, m_config.cascadeCount);
+        m_config.resolution = std::max(m_config.resolution, 16u);
+        for (Cascade& cascade : m_cascades) cascade = Cascade{};
+    }
+    const ShadowConfig& getConfig() const { return m_config; }
+
+    // Static casters or the light changed: cached cascades re-render as
+    // the budget allows
+    void invalidate() {
+        for (Cascade& cascade : m_cascades) cascade.dirty = true;
+    }
+
+    // Refits the cascades for this frame; returns the mask of cascades to
+    // render now. Cascades never rendered are always included, so every
+    // layer is initialized before it is sampled.
+    uint32_t update(const glm::mat4& view, const glm::mat4& proj, float nearPlane, const glm::vec3& lightDir) {
+        uint32_t count = m_config.cascadeCount;
+        if (count == 0) return 0;
+
+        glm::vec3 dir = glm::normalize(lightDir);
+        if (dir != m_lightDir) {
+            m_lightDir = dir;
+            invalidate();
+        }
+
+        glm::mat4 invView = glm::inverse(view);
+        glm::vec3 cameraPos = glm::vec3(invView[3]);
+        float tanX = 1.0f / std::fabs(proj[0][0]);
+        float tanY = 1.0f / std::fabs(proj[1][1]);
+        float cornerScale = std::sqrt(1.0f + tanX * tanX + tanY * tanY);  // Corner distance per unit depth
+
+        float nearDepth = std::max(nearPlane, 1e-3f);
+        float farDepth = std::max(m_config.maxDistance, nearDepth * 2.0f);
+        uint32_t firstCached = count - m_config.cachedCascades;
+
+        uint32_t mask = 0;
+        uint32_t budget = m_config.cachedUpdatesPerFrame;
+        float sliceNear = nearDepth;
+        for (uint32_t c = 0; c < count; c++) {
+            // Practical split: lerp between uniform and logarithmic
+            float t = float(c + 1) / float(count);
+            float uniform = nearDepth + (farDepth - nearDepth) * t;
+            float logarithmic = nearDepth * std::pow(farDepth / nearDepth, t);
+            float sliceFar = uniform + (logarithmic - uniform) * m_config.splitLambda;
+
+            Cascade& cascade = m_cascades[c];
+            cascade.splitFar = sliceFar;
+
+            if (c < firstCached) {
+                // Sphere around the slice's frustum corners
+                glm::vec3 corners[8];
+                glm::vec3 center(0.0f);
+                for (int i = 0; i < 8; i++) {
+                    float d = (i & 4) ? sliceFar : sliceNear;
+                    glm::vec4 viewPos((i & 1 ? 1.0f : -1.0f) * d * tanX, (i & 2 ? 1.0f : -1.0f) * d * tanY, -d, 1.0f);
+                    corners[i] = glm::vec3(invView * viewPos);
+                    center += corners[i] / 8.0f;
+                }
+                float radius = 0.0f;
+                for (const glm::vec3& corner : corners) radius = std::max(radius, glm::length(corner - center));
+                fit(cascade, center, std::ceil(radius * 16.0f) / 16.0f);
+                cascade.cached = false;
+                mask |= 1u << c;
+            } else {
+                // Around the camera: valid for any view direction
+                float radius = sliceFar * cornerScale;
+                bool moved = glm::length(cameraPos - cascade.center) > m_config.cacheMoveThreshold * radius;
+                bool resized = std::fabs(cascade.radius - radius * (1.0f + m_config.cacheMoveThreshold)) > 1e-3f * radius;
+                if (!cascade.valid || moved || resized) cascade.dirty = true;
+
+                bool render = !cascade.valid || (cascade.dirty && budget > 0);
+                if (render) {
+                    if (cascade.valid) budget--;
+                    fit(cascade, cameraPos, radius * (1.0f + m_config.cacheMoveThreshold));
+                    cascade.cached = true;
+                    cascade.dirty = false;
+                    mask |= 1u << c;
+                }
+            }
+            cascade.valid = cascade.valid || (mask & (1u << c)) != 0;
+            sliceNear = sliceFar;
+        }
+        return mask;
+    }
+
+    const Cascade& get(uint32_t cascade) const { return m_cascades[std::min(cascade, MAX_CASCADES - 1)]; }
+    uint32_t getCascadeCount() const { return m_config.cascadeCount; }
+
+private:
+    // Light-space ortho box of `radius` around `center`, snapped to texels
+    void fit(Cascade& cascade, const glm::vec3& center, float radius) {
+        glm::vec3 up = std::fabs(m_lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), m_lightDir, up);
+
+        float texel = 2.0f * radius / float(m_config.resolution);
+        glm::vec3 ls = glm::vec3(lightView * glm::vec4(center, 1.0f));
+        ls.x = std::floor(ls.x / texel) * texel;
+        ls.y = std::floor(ls.y / texel) * texel;
+
+        // Looks down -Z: the box spans depths [-ls.z - radius - pullback, -ls.z + radius]
+        float nearZ = -ls.z - radius - m_config.casterPullback;
+        float farZ = -ls.z + radius;
+        cascade.viewProj = orthoZO(ls.x - radius, ls.x + radius, ls.y - radius, ls.y + radius, nearZ, farZ) * lightView;
+        cascade.center = center;
+        cascade.radius = radius;
+        cascade.texelSize = texel;
+    }
+
+    // Right-handed orthographic projection to Vulkan's 0..1 clip depth
+    static glm::mat4 orthoZO(float left, float right, float bottom, float top, float zNear, float zFar) {
+        glm::mat4 m(1.0f);
+        m[0][0] = 2.0f / (right - left);
+        m[1][1] = 2.0f / (top - bottom);
+        m[2][2] = -1.0f / (zFar - zNear);
+        m[3][0] = -(right + left) / (right - left);
+        m[3][1] = -(top + bottom) / (top - bottom);
+        m[3][2] = -zNear / (zFar - zNear);
+        return m;
+    }
+
+    ShadowConfig m_config;
+    Cascade m_cascades[MAX_CASCADES];
+    glm::vec3 m_lightDir = glm::vec3(0.0f);
+};
+
+} // namespace lighting
+
+#endif // SHADOW_CASCADES_H
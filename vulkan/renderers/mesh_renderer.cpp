@@ -4,12 +4,16 @@
 #include "mesh_renderer.h"
 #include "../../stdlib/mesh_resource.h"
 #include "../../stdlib/texture_resource.h"
+#include "../core/pipeline_cache.h"
+#include "../../stdlib/vfs.h"
 
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <array>
 #include <chrono>
+#include <thread>
+#include <algorithm>
 #include <cstring>
 
 #ifdef _WIN32
@@ -24,7 +28,7 @@ namespace eden {
 // ============================================================================
 
 static std::vector<char> readShaderFile(const std::string& filename) {
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    VfsInputStream file(filename, std::ios::ate | std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open shader file: " + filename);
     }
@@ -38,6 +42,41 @@ static std::vector<char> readShaderFile(const std::string& filename) {
     return buffer;
 }
 
+// Calls to checkHotReload a replaced pipeline is kept alive for, so frames
+// still in flight never reference a destroyed one
+static const int kShaderRetireFrames = 3;
+
+static std::time_t fileModified(const std::string& path) {
+    struct stat fileStat;
+    return stat(path.c_str(), &fileStat) == 0 ? fileStat.st_mtime : 0;
+}
+
+// The GLSL source behind a .spv: the configured one, or the path without
+// ".spv" when that file exists
+static std::string shaderSourceFor(const std::string& configured, const std::string& spvPath) {
+    if (!configured.empty()) return configured;
+    const std::string ext = ".spv";
+    if (spvPath.size() > ext.size() &&
+        spvPath.compare(spvPath.size() - ext.size(), ext.size(), ext) == 0) {
+        std::string source = spvPath.substr(0, spvPath.size() - ext.size());
+        if (fileModified(source) != 0) return source;
+    }
+    return "";
+}
+
+static VkShaderModule createShaderModule(VkDevice device, const std::vector<uint32_t>& code) {
+    VkShaderModuleCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size() * sizeof(uint32_t);
+    createInfo.pCode = code.data();
+    
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device, &createInfo, nullptr, &module) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    return module;
+}
+
 // ============================================================================
 // MeshRenderer Implementation
 // ============================================================================
@@ -131,6 +170,10 @@ bool MeshRenderer::init(VkDevice device, VkPhysicalDevice physicalDevice,
     // Update descriptor set with dummy texture
     updateDescriptorSet();
     
+    if (m_config.enableHotReload) {
+        initShaderSources();
+    }
+    
     m_initialized = true;
     std::cout << "[MeshRenderer] Initialized successfully!" << std::endl;
     return true;
@@ -141,6 +184,13 @@ void MeshRenderer::cleanup() {
     
     vkDeviceWaitIdle(m_device);
     
+    // Cleanup shader hot-reload (the worker may still be building)
+    waitForShaderJob();
+    for (const ShaderSet& set : m_retiredShaders) {
+        destroyShaderSet(set);
+    }
+    m_retiredShaders.clear();
+    
     // Cleanup mesh and texture
     m_mesh.reset();
     m_ownedTexture.reset();
@@ -325,7 +375,13 @@ void MeshRenderer::setWireframe(bool enabled) {
 }
 
 void MeshRenderer::checkHotReload() {
-    if (!m_config.enableHotReload || m_texturePath.empty() || !m_ownedTexture) {
+    if (!m_config.enableHotReload) {
+        return;
+    }
+    
+    checkShaderReload();
+    
+    if (m_texturePath.empty() || !m_ownedTexture) {
         return;
     }
     
@@ -349,10 +405,120 @@ void MeshRenderer::checkHotReload() {
     }
 }
 
+void MeshRenderer::checkShaderReload() {
+    // Destroy replaced shaders once no frame can still use them
+    for (size_t i = 0; i < m_retiredShaders.size();) {
+        if (--m_retiredShaders[i].framesLeft <= 0) {
+            destroyShaderSet(m_retiredShaders[i]);
+            m_retiredShaders.erase(m_retiredShaders.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    
+    // Swap in a finished reload
+    if (m_shaderJob) {
+        if (!m_shaderJob->ready()) return;
+        
+        if (m_shaderJob->ok && m_shaderJob->error.empty()) {
+            ShaderSet current;
+            current.vert = m_vertShaderModule;
+            current.frag = m_fragShaderModule;
+            current.pipeline = m_pipeline;
+            current.wireframePipeline = m_wireframePipeline;
+            current.framesLeft = kShaderRetireFrames;
+            m_retiredShaders.push_back(current);
+            
+            m_vertShaderModule = m_pendingShaders.vert;
+            m_fragShaderModule = m_pendingShaders.frag;
+            m_pipeline = m_pendingShaders.pipeline;
+            m_wireframePipeline = m_pendingShaders.wireframePipeline;
+            std::cout << "[MeshRenderer] Shaders reloaded in " << m_shaderJob->milliseconds << " ms" << std::endl;
+        } else {
+            // Keep drawing with the old pipeline
+            destroyShaderSet(m_pendingShaders);
+            std::cerr << "[MeshRenderer] Shader reload failed: " << m_shaderJob->error << std::endl;
+        }
+        m_pendingShaders = ShaderSet();
+        m_shaderJob.reset();
+    }
+    
+    if (m_vertSourcePath.empty()) return;
+    
+    std::time_t modified = std::max(fileModified(m_vertSourcePath), fileModified(m_fragSourcePath));
+    if (modified <= m_shaderSourcesModified) return;
+    m_shaderSourcesModified = modified;
+    
+    std::cout << "[MeshRenderer] Shader source changed, compiling in the background..." << std::endl;
+    
+    VkPipelineCache cache = vkcore::PipelineCache::shared(m_device, m_physicalDevice).get();
+    bool wireframe = m_wireframePipeline != VK_NULL_HANDLE;
+    m_shaderJob = vkcore::ShaderCompiler::shared().compileAsync(
+        {vkcore::ShaderSource(m_vertSourcePath), vkcore::ShaderSource(m_fragSourcePath)},
+        [this, cache, wireframe](vkcore::ShaderCompiler::Job& job) {
+            ShaderSet& set = m_pendingShaders;
+            set.vert = createShaderModule(m_device, job.spirv[0]);
+            set.frag = createShaderModule(m_device, job.spirv[1]);
+            if (set.vert == VK_NULL_HANDLE || set.frag == VK_NULL_HANDLE) {
+                job.error = "Failed to create shader modules";
+                return;
+            }
+            if (!createPipeline(set.vert, set.frag, false, cache, set.pipeline)) {
+                job.error = "Failed to create filled pipeline";
+                return;
+            }
+            if (wireframe && !createPipeline(set.vert, set.frag, true, cache, set.wireframePipeline)) {
+                job.error = "Failed to create wireframe pipeline";
+            }
+        });
+}
+
 // ============================================================================
 // Internal Helpers
 // ============================================================================
 
+void MeshRenderer::initShaderSources() {
+    m_vertSourcePath = shaderSourceFor(m_config.vertexShaderSource, m_config.vertexShaderPath);
+    m_fragSourcePath = shaderSourceFor(m_config.fragmentShaderSource, m_config.fragmentShaderPath);
+    
+    // Both stages are rebuilt together, so watch only when both sources exist
+    if (m_vertSourcePath.empty() || m_fragSourcePath.empty()) {
+        m_vertSourcePath.clear();
+        m_fragSourcePath.clear();
+        return;
+    }
+    
+    m_shaderSourcesModified = std::max(fileModified(m_vertSourcePath), fileModified(m_fragSourcePath));
+    std::cout << "[MeshRenderer] Watching shader sources: " << m_vertSourcePath
+              << ", " << m_fragSourcePath << std::endl;
+}
+
+void MeshRenderer::waitForShaderJob() {
+    if (!m_shaderJob) return;
+    
+    while (!m_shaderJob->ready()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    destroyShaderSet(m_pendingShaders);
+    m_pendingShaders = ShaderSet();
+    m_shaderJob.reset();
+}
+
+void MeshRenderer::destroyShaderSet(const ShaderSet& set) {
+    if (set.pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, set.pipeline, nullptr);
+    }
+    if (set.wireframePipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, set.wireframePipeline, nullptr);
+    }
+    if (set.vert != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(m_device, set.vert, nullptr);
+    }
+    if (set.frag != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(m_device, set.frag, nullptr);
+    }
+}
+
 bool MeshRenderer::createShaderModules() {
     std::vector<char> vertCode, fragCode;
     
@@ -427,17 +593,25 @@ bool MeshRenderer::createPipelineLayout() {
 }
 
 bool MeshRenderer::createPipeline(bool wireframe) {
+    VkPipeline* target = wireframe ? &m_wireframePipeline : &m_pipeline;
+    return createPipeline(m_vertShaderModule, m_fragShaderModule, wireframe,
+                          vkcore::PipelineCache::shared(m_device, m_physicalDevice).get(), *target);
+}
+
+// Only reads renderer state, so the shader hot-reload worker builds with it too
+bool MeshRenderer::createPipeline(VkShaderModule vert, VkShaderModule frag, bool wireframe,
+                                  VkPipelineCache cache, VkPipeline& pipeline) const {
     // Shader stages
     VkPipelineShaderStageCreateInfo vertStage = {};
     vertStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertStage.module = m_vertShaderModule;
+    vertStage.module = vert;
     vertStage.pName = "main";
     
     VkPipelineShaderStageCreateInfo fragStage = {};
     fragStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragStage.module = m_fragShaderModule;
+    fragStage.module = frag;
     fragStage.pName = "main";
     
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertStage, fragStage};
@@ -545,8 +719,7 @@ bool MeshRenderer::createPipeline(bool wireframe) {
     pipelineInfo.renderPass = m_renderPass;
     pipelineInfo.subpass = 0;
     
-    VkPipeline* target = wireframe ? &m_wireframePipeline : &m_pipeline;
-    return vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, target) == VK_SUCCESS;
+    return vkCreateGraphicsPipelines(m_device, cache, 1, &pipelineInfo, nullptr, &pipeline) == VK_SUCCESS;
 }
 
 bool MeshRenderer::createUniformBuffer() {
@@ -9,8 +9,11 @@
 #include <memory>
 #include <string>
 #include <ctime>
+#include <vector>
 #include <glm/glm.hpp>
 
+#include "../core/shader_compiler.h"
+
 // Forward declarations
 struct GLFWwindow;
 class MeshResource;
@@ -38,6 +41,10 @@ struct MeshRendererConfig {
     bool enableWireframe = false;
     bool enableHotReload = true;
     float hotReloadCheckInterval = 0.1f;  // seconds
+    // GLSL sources recompiled on change. Empty = the .spv path without
+    // ".spv" if that file exists (shaders/mesh.vert.spv -> shaders/mesh.vert)
+    std::string vertexShaderSource;
+    std::string fragmentShaderSource;
 };
 
 // ============================================================================
@@ -142,7 +149,9 @@ public:
     void setWireframe(bool enabled);
     bool isWireframe() const { return m_wireframeEnabled; }
     
-    // Check for texture hot-reload (call each frame)
+    // Check for texture and shader hot-reload (call each frame)
+    // Shaders compile and pipelines build on the ShaderCompiler worker;
+    // the new ones are swapped in by a later call once ready
     void checkHotReload();
     
     // Get Vulkan pipeline (for external use)
@@ -189,6 +198,21 @@ private:
     std::time_t m_textureLastModified = 0;
     float m_hotReloadTimer = 0.0f;
     
+    // Shader hot-reload state
+    struct ShaderSet {
+        VkShaderModule vert = VK_NULL_HANDLE;
+        VkShaderModule frag = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipeline wireframePipeline = VK_NULL_HANDLE;
+        int framesLeft = 0;  // Calls to checkHotReload before a retired set is destroyed
+    };
+    std::string m_vertSourcePath;
+    std::string m_fragSourcePath;
+    std::time_t m_shaderSourcesModified = 0;
+    std::shared_ptr<vkcore::ShaderCompiler::Job> m_shaderJob;
+    ShaderSet m_pendingShaders;                // Written by the worker
+    std::vector<ShaderSet> m_retiredShaders;   // May still be in use by the GPU
+    
     // State
     bool m_initialized = false;
     bool m_wireframeEnabled = false;
@@ -199,6 +223,12 @@ private:
     bool createDescriptorSetLayout();
     bool createPipelineLayout();
     bool createPipeline(bool wireframe);
+    bool createPipeline(VkShaderModule vert, VkShaderModule frag, bool wireframe,
+                        VkPipelineCache cache, VkPipeline& pipeline) const;
+    void initShaderSources();
+    void checkShaderReload();
+    void waitForShaderJob();
+    void destroyShaderSet(const ShaderSet& set);
     bool createUniformBuffer();
     bool createDescriptorPool();
     bool allocateDescriptorSet();
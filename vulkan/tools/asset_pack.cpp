@@ -0,0 +1,277 @@
+// ============================================================================
+// ASSET PACK - Offline packer for the .edenpak archives stdlib/vfs.h mounts
+// ============================================================================
+// Walks files and directories into one archive the runtime maps at startup
+// instead of opening thousands of loose files:
+//
+//   - Entry names are paths relative to --root (default: the current
+//     directory), normalized the way loaders look them up, so run this from
+//     where the game runs and the same strings find the same files
+//   - Each entry starts on an --align boundary (default 64) so GPU uploads
+//     and SIMD parsers can read straight out of the mapping
+//   - --lz4 / --zstd compress entries that shrink by at least 10%; formats
+//     that are already compressed (PNG, OGG, video, KTX2) are stored as-is.
+//     The runtime must be built with the matching EDEN_USE_LZ4 / EDEN_USE_ZSTD
+//
+// Build:
+//   g++ -std=c++17 -O2 vulkan/tools/asset_pack.cpp -o asset_pack
+//   (add -DEDEN_USE_LZ4 -llz4 and/or -DEDEN_USE_ZSTD -lzstd for compression)
+//
+// Usage:
+//   asset_pack output.edenpak <file|dir>... [--root dir] [--align n] [--lz4|--zstd] [--level n]
+//   asset_pack --list archive.edenpak
+// ============================================================================
+
+#include "../../stdlib/vfs.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace vfs_detail;
+
+struct Input {
+    std::string source;     // Path on disk
+    std::string name;       // Normalized archive path
+    uint64_t hash = 0;
+};
+
+bool alreadyCompressed(const std::string& name) {
+    static const char* extensions[] = {".png", ".jpg", ".jpeg", ".ogg", ".mp3", ".mp4", ".webm",
+                                       ".mkv", ".mov", ".ktx2", ".zip", ".edenpak"};
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    for (const char* ext : extensions) {
+        size_t length = std::strlen(ext);
+        if (lower.size() >= length && lower.compare(lower.size() - length, length, ext) == 0) return true;
+    }
+    return false;
+}
+
+bool readFile(const std::string& path, std::vector<char>& out) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    out.assign(file.data(), file.data() + file.size());
+    return true;
+}
+
+// Compressed bytes, or empty when compression is off, unavailable or not worth it
+std::vector<char> compress(uint32_t compression, int level, const std::vector<char>& raw) {
+    std::vector<char> packed;
+    if (raw.empty()) return packed;
+    switch (compression) {
+#ifdef EDEN_USE_LZ4
+        case PAK_LZ4: {
+            if (raw.size() > size_t(LZ4_MAX_INPUT_SIZE)) break;
+            packed.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(raw.size()))));
+            int written = LZ4_compress_default(raw.data(), packed.data(), static_cast<int>(raw.size()),
+                                               static_cast<int>(packed.size()));
+            packed.resize(written > 0 ? static_cast<size_t>(written) : 0);
+            break;
+        }
+#endif
+#ifdef EDEN_USE_ZSTD
+        case PAK_ZSTD: {
+            packed.resize(ZSTD_compressBound(raw.size()));
+            size_t written = ZSTD_compress(packed.data(), packed.size(), raw.data(), raw.size(), level);
+            packed.resize(ZSTD_isError(written) ? 0 : written);
+            break;
+        }
+#endif
+        default:
+            (void)level;
+            break;
+    }
+    if (packed.size() >= raw.size() - raw.size() / 10) packed.clear();
+    return packed;
+}
+
+bool writeAt(FILE* out, uint64_t offset, const void* data, size_t size) {
+#ifdef _WIN32
+    int seeked = _fseeki64(out, static_cast<long long>(offset), SEEK_SET);
+#else
+    int seeked = fseeko(out, static_cast<off_t>(offset), SEEK_SET);
+#endif
+    return seeked == 0 &&
+           (size == 0 || fwrite(data, 1, size, out) == size);
+}
+
+int list(const std::string& path) {
+    Archive archive;
+    if (!archive.open(path)) {
+        fprintf(stderr, "[AssetPack] %s is not a valid archive\n", path.c_str());
+        return 1;
+    }
+    static const char* methods[] = {"stored", "lz4", "zstd"};
+    uint64_t raw = 0, stored = 0;
+    for (const PakEntry& entry : archive.entries()) {
+        printf("%10llu %10llu  %-6s  %.*s\n", (unsigned long long)entry.size, (unsigned long long)entry.storedSize,
+               entry.compression <= PAK_ZSTD ? methods[entry.compression] : "?",
+               (int)entry.nameLength, archive.name(entry));
+        raw += entry.size;
+        stored += entry.storedSize;
+    }
+    printf("%zu entries, %llu bytes (%llu stored)\n", archive.entries().size(),
+           (unsigned long long)raw, (unsigned long long)stored);
+    return 0;
+}
+
+int usage() {
+    fprintf(stderr,
+            "Usage: asset_pack output.edenpak <file|dir>... [--root dir] [--align n] [--lz4|--zstd] [--level n]\n"
+            "       asset_pack --list archive.edenpak\n");
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::string(argv[1]) == "--list") return list(argv[2]);
+    if (argc < 3) return usage();
+
+    std::string output = argv[1];
+    std::vector<std::string> sources;
+    fs::path root = fs::current_path();
+    uint32_t alignment = PAK_DEFAULT_ALIGNMENT;
+    uint32_t compression = PAK_STORED;
+    int level = 9;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--root" && i + 1 < argc) {
+            root = fs::absolute(argv[++i]);
+        } else if (arg == "--align" && i + 1 < argc) {
+            alignment = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--level" && i + 1 < argc) {
+            level = std::atoi(argv[++i]);
+        } else if (arg == "--lz4") {
+            compression = PAK_LZ4;
+        } else if (arg == "--zstd") {
+            compression = PAK_ZSTD;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return usage();
+        } else {
+            sources.push_back(arg);
+        }
+    }
+    if (sources.empty() || alignment == 0 || (alignment & (alignment - 1)) != 0) return usage();
+    if (!compressionSupported(compression)) {
+        fprintf(stderr, "[AssetPack] Built without %s support (define EDEN_USE_%s and link the library)\n",
+                compression == PAK_LZ4 ? "LZ4" : "Zstd", compression == PAK_LZ4 ? "LZ4" : "ZSTD");
+        return 1;
+    }
+
+    // Collect files
+    std::vector<Input> inputs;
+    auto add = [&](const fs::path& file) {
+        Input input;
+        input.source = file.string();
+        input.name = normalizePath(fs::absolute(file).lexically_relative(root).generic_string());
+        if (input.name.empty() || input.name.compare(0, 2, "..") == 0) {
+            fprintf(stderr, "[AssetPack] %s is outside --root %s\n", input.source.c_str(), root.string().c_str());
+            return false;
+        }
+        input.hash = fnv1a(input.name.data(), input.name.size());
+        inputs.push_back(std::move(input));
+        return true;
+    };
+    for (const std::string& source : sources) {
+        std::error_code error;
+        if (fs::is_directory(source, error)) {
+            for (const auto& item : fs::recursive_directory_iterator(source, error)) {
+                if (item.is_regular_file() && !add(item.path())) return 1;
+            }
+        } else if (fs::is_regular_file(source, error)) {
+            if (!add(source)) return 1;
+        } else {
+            fprintf(stderr, "[AssetPack] No such file or directory: %s\n", source.c_str());
+            return 1;
+        }
+    }
+
+    std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+    });
+    for (size_t i = 1; i < inputs.size(); i++) {
+        if (inputs[i].name == inputs[i - 1].name) {
+            fprintf(stderr, "[AssetPack] %s added twice (%s, %s)\n", inputs[i].name.c_str(),
+                    inputs[i - 1].source.c_str(), inputs[i].source.c_str());
+            return 1;
+        }
+    }
+
+    FILE* out = fopen(output.c_str(), "wb");
+    if (!out) {
+        fprintf(stderr, "[AssetPack] Cannot write %s\n", output.c_str());
+        return 1;
+    }
+
+    // Entry data, each aligned; names and TOC are filled in along the way
+    std::vector<PakEntry> toc(inputs.size());
+    std::string names;
+    uint64_t offset = sizeof(PakHeader);
+    uint64_t rawBytes = 0, storedBytes = 0;
+    std::vector<char> raw;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (!readFile(inputs[i].source, raw)) {
+            fprintf(stderr, "[AssetPack] Cannot read %s\n", inputs[i].source.c_str());
+            fclose(out);
+            return 1;
+        }
+        std::vector<char> packed;
+        if (compression != PAK_STORED && !alreadyCompressed(inputs[i].name)) {
+            packed = compress(compression, level, raw);
+        }
+        const std::vector<char>& bytes = packed.empty() ? raw : packed;
+
+        offset = (offset + alignment - 1) & ~uint64_t(alignment - 1);
+        PakEntry& entry = toc[i];
+        entry.hash = inputs[i].hash;
+        entry.offset = offset;
+        entry.storedSize = bytes.size();
+        entry.size = raw.size();
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(inputs[i].name.size());
+        entry.compression = packed.empty() ? PAK_STORED : compression;
+        entry.reserved = 0;
+        names += inputs[i].name;
+
+        if (!writeAt(out, offset, bytes.data(), bytes.size())) {
+            fprintf(stderr, "[AssetPack] Write failed: %s\n", output.c_str());
+            fclose(out);
+            return 1;
+        }
+        offset += bytes.size();
+        rawBytes += raw.size();
+        storedBytes += bytes.size();
+    }
+
+    PakHeader header = {};
+    std::memcpy(header.magic, PAK_MAGIC, sizeof(PAK_MAGIC));
+    header.version = PAK_VERSION;
+    header.alignment = alignment;
+    header.entryCount = toc.size();
+    header.tocOffset = (offset + 7) & ~uint64_t(7);
+    header.namesOffset = header.tocOffset + toc.size() * sizeof(PakEntry);
+    header.namesSize = names.size();
+
+    bool ok = writeAt(out, header.tocOffset, toc.data(), toc.size() * sizeof(PakEntry)) &&
+              writeAt(out, header.namesOffset, names.data(), names.size()) &&
+              writeAt(out, 0, &header, sizeof(header));
+    ok = fclose(out) == 0 && ok;
+    if (!ok) {
+        fprintf(stderr, "[AssetPack] Write failed: %s\n", output.c_str());
+        return 1;
+    }
+
+    printf("[AssetPack] %s: %zu files, %llu bytes -> %llu stored\n", output.c_str(), inputs.size(),
+           (unsigned long long)rawBytes, (unsigned long long)storedBytes);
+    return 0;
+}
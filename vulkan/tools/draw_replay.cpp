@@ -0,0 +1,360 @@
+// ============================================================================
+// DRAW REPLAY - Re-run a VulkanCore draw capture headless, for A/B timing
+// ============================================================================
+// Loads a file written by VulkanCore::beginCapture() (draw_capture.h),
+// re-creates its pipelines, textures, meshes and module resources in a
+// headless VulkanCore at the captured size, then draws the captured frames
+// in a loop and reports:
+//
+//   submit   CPU time of a frame minus beginFrame()'s waits (fence, acquire,
+//            pacing): recording every captured call plus the queue submit
+//   frame    beginFrame to beginFrame (includes waiting on the GPU)
+//   gpu      VKCORE_GPU_SCOPE timings per scope, averaged per frame
+//
+// The same file replayed by two builds is the same work, so the numbers
+// compare a renderer change without the noise of a live app. Shaders are
+// loaded from the captured paths: run from a directory containing the
+// build's shaders/. LightingManager and FacialSystem are created when the
+// capture holds their commands.
+//
+// Build (Vulkan SDK + GLFW):
+//   g++ -std=c++17 -O2 -pthread -Ivulkan vulkan/tools/draw_replay.cpp vulkan/core/vulkan_core.cpp \
+//       vulkan/lighting/lighting_manager.cpp vulkan/facial/facial_system.cpp -lvulkan -lglfw -o draw_replay
+//
+// Usage:
+//   draw_replay capture.vkdc [--loops N] [--warmup N] [--packed-lighting] [--trace out.json]
+//     --loops N          measured passes over the captured frames (default 20)
+//     --warmup N         unmeasured passes first (default 2)
+//     --packed-lighting  the app lit PACKED_POSITION_NORMAL_UV meshes
+//     --trace out.json   chrome://tracing export of the last frames' GPU scopes
+// ============================================================================
+
+#include "../core/draw_capture.h"
+#include "../lighting/lighting_manager.h"
+#include "../facial/facial_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace vkcore;
+
+namespace {
+
+int usage() {
+    fprintf(stderr, "usage: draw_replay capture.vkdc [--loops N] [--warmup N] [--packed-lighting] "
+                    "[--trace out.json]\n");
+    return 1;
+}
+
+float percentile(const std::vector<float>& sorted, float p) {
+    if (sorted.empty()) return 0.0f;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void printStats(const char* name, std::vector<float> ms) {
+    if (ms.empty()) return;
+    std::sort(ms.begin(), ms.end());
+    float total = 0.0f;
+    for (float value : ms) total += value;
+    printf("[Replay] %-7s avg %7.3f ms  p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f\n", name,
+           total / ms.size(), percentile(ms, 0.50f), percentile(ms, 0.90f), percentile(ms, 0.99f), ms.back());
+}
+
+struct Replayer {
+    VulkanCore& core;
+    CaptureRemap& remap;
+    lighting::LightingManager* lighting = nullptr;
+    facial::FacialSystem* facial = nullptr;
+    std::vector<glm::mat4> transforms;
+    std::vector<glm::vec4> colors;
+    uint32_t unknownTags = 0;
+
+    // One captured frame, from its FrameBegin through its FrameEnd.
+    // Returns false if the stream is damaged; `drawn` is false when
+    // beginFrame() skipped the frame.
+    bool frame(CaptureReader& in, bool& drawn) {
+        drawn = false;
+        while (!in.atEnd()) {
+            CaptureOp op = CaptureOp(in.u8());
+            switch (op) {
+            case CaptureOp::FrameBegin: {
+                glm::mat4 view = in.mat4();
+                glm::mat4 projection = in.mat4();
+                core.setViewMatrix(view);
+                core.setProjectionMatrix(projection);
+                drawn = core.beginFrame();
+                break;
+            }
+            case CaptureOp::FrameEnd:
+                if (drawn) core.endFrame();
+                return in.ok();
+            case CaptureOp::SetCamera: {
+                glm::mat4 view = in.mat4();
+                glm::mat4 projection = in.mat4();
+                core.setViewMatrix(view);
+                core.setProjectionMatrix(projection);
+                break;
+            }
+            case CaptureOp::BindPipeline: {
+                PipelineHandle pipeline = remap.pipeline(in.u32());
+                if (drawn) core.bindPipeline(pipeline);
+                break;
+            }
+            case CaptureOp::BindTexture: {
+                TextureHandle texture = remap.texture(in.u32());
+                if (drawn) core.bindTexture(texture);
+                break;
+            }
+            case CaptureOp::SetDrawPass: {
+                DrawPass pass = DrawPass(in.u8());
+                if (drawn) core.setDrawPass(pass);
+                break;
+            }
+            case CaptureOp::DrawMesh: {
+                MeshHandle mesh = remap.mesh(in.u32());
+                glm::mat4 transform = in.mat4();
+                glm::vec4 color = in.vec4();
+                if (drawn && in.ok()) core.drawMesh(mesh, transform, color);
+                break;
+            }
+            case CaptureOp::DrawMeshInstanced: {
+                MeshHandle mesh = remap.mesh(in.u32());
+                uint32_t count = in.u32();
+                bool hasColors = in.u8() != 0;
+                if (!in.ok() || count > in.remaining() / sizeof(glm::mat4)) return false;
+                transforms.resize(count);
+                in.bytes(transforms.data(), sizeof(glm::mat4) * count);
+                colors.resize(hasColors ? count : 0);
+                if (hasColors) in.bytes(colors.data(), sizeof(glm::vec4) * count);
+                if (drawn && in.ok()) {
+                    core.drawMeshInstanced(mesh, transforms.data(), hasColors ? colors.data() : nullptr, count);
+                }
+                break;
+            }
+            case CaptureOp::Extension: {
+                uint32_t tag = in.u32();
+                uint32_t size = in.u32();
+                const uint8_t* payload = in.view(size);
+                if (!payload) return false;
+                // Modules capture their state again in the next frame
+                if (!drawn) break;
+                CaptureReader command(payload, size);
+                if (tag == lighting::LightingManager::CAPTURE_TAG && lighting) {
+                    lighting->replayCapture(command, remap);
+                } else if (tag == facial::FacialSystem::CAPTURE_TAG && facial) {
+                    facial->replayCapture(command, remap);
+                } else {
+                    unknownTags++;
+                }
+                break;
+            }
+            default:
+                return false;
+            }
+            if (!in.ok()) return false;
+        }
+        return false;
+    }
+};
+
+// Offsets of every FrameBegin, so each pass can start anywhere
+std::vector<size_t> frameOffsets(const std::vector<uint8_t>& stream, bool& usesLighting, bool& usesFacial) {
+    std::vector<size_t> offsets;
+    CaptureReader in(stream);
+    while (!in.atEnd() && in.ok()) {
+        size_t at = stream.size() - in.remaining();
+        switch (CaptureOp(in.u8())) {
+        case CaptureOp::FrameBegin: offsets.push_back(at); in.view(sizeof(glm::mat4) * 2); break;
+        case CaptureOp::FrameEnd: break;
+        case CaptureOp::SetCamera: in.view(sizeof(glm::mat4) * 2); break;
+        case CaptureOp::BindPipeline:
+        case CaptureOp::BindTexture: in.u32(); break;
+        case CaptureOp::SetDrawPass: in.u8(); break;
+        case CaptureOp::DrawMesh: in.view(sizeof(uint32_t) + sizeof(glm::mat4) + sizeof(glm::vec4)); break;
+        case CaptureOp::DrawMeshInstanced: {
+            in.u32();
+            uint32_t count = in.u32();
+            bool hasColors = in.u8() != 0;
+            in.view(size_t(count) * (sizeof(glm::mat4) + (hasColors ? sizeof(glm::vec4) : 0)));
+            break;
+        }
+        case CaptureOp::Extension: {
+            uint32_t tag = in.u32();
+            in.view(in.u32());
+            usesLighting |= tag == lighting::LightingManager::CAPTURE_TAG;
+            usesFacial |= tag == facial::FacialSystem::CAPTURE_TAG;
+            break;
+        }
+        default:
+            std::cerr << "[Replay] Unknown command in stream at byte " << at << std::endl;
+            return offsets;
+        }
+    }
+    return offsets;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    std::string path = argv[1];
+    int loops = 20;
+    int warmup = 2;
+    bool packedLighting = false;
+    std::string tracePath;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--loops" && i + 1 < argc) {
+            loops = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--packed-lighting") {
+            packedLighting = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+
+    DrawCapture capture;
+    if (!capture.load(path)) return 1;
+
+    bool usesLighting = false, usesFacial = false;
+    std::vector<size_t> frames = frameOffsets(capture.getStream(), usesLighting, usesFacial);
+    capture.forEachResource([&](uint32_t, const CapturedResource& resource) {
+        usesFacial |= resource.tag == facial::FacialSystem::CAPTURE_TAG;
+    });
+    if (frames.empty()) {
+        std::cerr << "[Replay] " << path << " holds no frames" << std::endl;
+        return 1;
+    }
+
+    CoreConfig config;
+    config.appName = "Draw Replay";
+    config.width = static_cast<int>(capture.getWidth());
+    config.height = static_cast<int>(capture.getHeight());
+    config.headless = true;
+    config.gpuProfiling = true;
+
+    VulkanCore core;
+    if (!core.init(nullptr, config)) {
+        std::cerr << "[Replay] VulkanCore headless init failed" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<lighting::LightingManager> lights;
+    std::unique_ptr<facial::FacialSystem> faces;
+    if (usesLighting) {
+        lights = std::make_unique<lighting::LightingManager>();
+        if (packedLighting) lights->setVertexFormat(VertexFormat::PACKED_POSITION_NORMAL_UV);
+        if (!lights->init(&core)) {
+            std::cerr << "[Replay] LightingManager init failed - lit draws are skipped" << std::endl;
+            lights.reset();
+        }
+    }
+    if (usesFacial) {
+        faces = std::make_unique<facial::FacialSystem>();
+        if (!faces->init(&core)) {
+            std::cerr << "[Replay] FacialSystem init failed - facial draws are skipped" << std::endl;
+            faces.reset();
+        }
+    }
+
+    // Resources, in the order the app created them
+    CaptureRemap remap;
+    uint32_t failed = 0;
+    capture.forEachPipeline([&](uint32_t id, const PipelineConfig& pipeline) {
+        PipelineHandle handle = core.createPipeline(pipeline);
+        if (handle == INVALID_PIPELINE) failed++;
+        else remap.pipelines[id] = handle;
+    });
+    capture.forEachTexture([&](uint32_t id, const CapturedTexture& texture) {
+        TextureHandle handle = INVALID_TEXTURE;
+        if (texture.compressed) {
+            handle = core.createCompressedTexture(texture.format, texture.width, texture.height, texture.mipLevels,
+                                                  texture.data.data(), texture.data.size(), texture.regions.data(),
+                                                  static_cast<uint32_t>(texture.regions.size()));
+        } else if (texture.data.size() >= size_t(texture.width) * texture.height * 4) {
+            handle = texture.format == VK_FORMAT_R8G8B8A8_UNORM
+                ? core.createTextureLinear(texture.data.data(), texture.width, texture.height, 4, texture.generateMips)
+                : core.createTexture(texture.data.data(), texture.width, texture.height, 4, texture.generateMips);
+        }
+        if (handle == INVALID_TEXTURE) failed++;
+        else remap.textures[id] = handle;
+    });
+    capture.forEachMesh([&](uint32_t id, const MeshData& data) {
+        MeshHandle handle = core.createMesh(data);
+        if (handle == INVALID_MESH) failed++;
+        else remap.meshes[id] = handle;
+    });
+    capture.forEachResource([&](uint32_t, const CapturedResource& resource) {
+        CaptureReader in(resource.data);
+        if (resource.tag == facial::FacialSystem::CAPTURE_TAG && faces && !faces->replayCaptureResource(in)) failed++;
+    });
+    core.waitForUploads();
+    if (failed > 0) std::cerr << "[Replay] " << failed << " resources failed to re-create" << std::endl;
+
+    printf("[Replay] %s: %ux%u, %zu frames, %zu pipelines, %zu textures, %zu meshes%s%s\n", path.c_str(),
+           capture.getWidth(), capture.getHeight(), frames.size(), remap.pipelines.size(), remap.textures.size(),
+           remap.meshes.size(), lights ? ", lighting" : "", faces ? ", facial" : "");
+
+    Replayer replayer{core, remap, lights.get(), faces.get()};
+    const std::vector<uint8_t>& stream = capture.getStream();
+    std::vector<float> submitMs, frameMs;
+    std::map<std::string, float> gpuMs;
+    uint32_t gpuFrames = 0;
+
+    using Clock = std::chrono::steady_clock;
+    for (int pass = 0; pass < warmup + loops; pass++) {
+        bool measured = pass >= warmup;
+        for (size_t frame = 0; frame < frames.size(); frame++) {
+            CaptureReader in(stream.data() + frames[frame], stream.size() - frames[frame]);
+            // Timed around the whole frame, minus what beginFrame() waited for
+            Clock::time_point start = Clock::now();
+            bool drawn = false;
+            if (!replayer.frame(in, drawn)) {
+                std::cerr << "[Replay] Damaged stream in frame " << frame << std::endl;
+                core.shutdown();
+                return 1;
+            }
+            if (!drawn || !measured) continue;
+
+            const FrameTimings& timings = core.getFrameTimings();
+            float total = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+            submitMs.push_back(std::max(0.0f, total - timings.fenceWaitMs - timings.acquireMs - timings.pacingSleepMs));
+            frameMs.push_back(timings.frameMs);
+            // Resolved framesInFlight frames late; the delay is the same in every pass
+            for (const GpuProfiler::Timing& timing : core.getGpuTimings()) gpuMs[timing.name] += timing.ms;
+            gpuFrames++;
+        }
+    }
+    vkDeviceWaitIdle(core.getDevice());
+
+    printf("[Replay] %d loops x %zu frames (%d warmup loops)\n", loops, frames.size(), warmup);
+    printStats("submit", submitMs);
+    printStats("frame", frameMs);
+    for (const auto& scope : gpuMs) {
+        printf("[Replay] gpu %-16s %7.3f ms/frame\n", scope.first.c_str(), gpuFrames ? scope.second / gpuFrames : 0.0f);
+    }
+    if (replayer.unknownTags > 0) {
+        std::cerr << "[Replay] " << replayer.unknownTags << " commands of unknown modules skipped" << std::endl;
+    }
+    if (!tracePath.empty() && !core.exportGpuTrace(tracePath)) {
+        std::cerr << "[Replay] Failed to write " << tracePath << std::endl;
+    }
+
+    if (faces) faces->shutdown();
+    if (lights) lights->shutdown();
+    core.shutdown();
+    return 0;
+}
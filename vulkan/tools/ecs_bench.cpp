@@ -0,0 +1,446 @@
+// ============================================================================
+// ECS BENCH - EntityStorage and generated-query micro-benchmarks
+// ============================================================================
+// Fixed-seed workloads over stdlib/entity_storage.h, each reported as ns per
+// entity (best of --runs) and, where perf counters are available (Linux
+// perf_event_open), last-level cache misses per entity:
+//
+//   churn                create, destroy a random half, recreate
+//   iterate1/2/4         for_each over 1, 2 and 4 components
+//   query2               cached owning query over Position + Velocity
+//   random_get           get_component on shuffled handles
+//   integrate_aos/soa    the loops codegen emits for AoS and component_soa
+//                        (hoisted EDEN_RESTRICT columns) integrate bodies
+//   migrate              a generated hot-reload migration pass
+//
+// Iteration cases run in both storage modes. Each run appends one JSON line
+// to --history and is compared with the previous line there: cases more than
+// --threshold percent slower are flagged, and --fail-on-regression makes
+// them an exit code.
+//
+// Build (no dependencies):
+//   g++ -std=c++17 -O3 -march=native -pthread vulkan/tools/ecs_bench.cpp -o ecs_bench
+// (-O3 as for generated programs: GCC only vectorizes these loops there)
+//
+// Usage:
+//   ecs_bench [--sizes 10000,100000,1000000] [--runs N] [--seed N]
+//             [--history ecs_bench_history.jsonl] [--threshold 10] [--fail-on-regression]
+// ============================================================================
+
+#include "../../stdlib/entity_storage.h"
+#include "../../stdlib/soa_storage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Position { float x, y, z; };
+struct Velocity { float x, y, z; };
+struct Rotation { float x, y, z, w; };
+struct Health { int32_t value; int32_t max; };
+
+struct SoAPosition { SoAColumn<float> x, y, z; };
+struct SoAVelocity { SoAColumn<float> x, y, z; };
+
+volatile float g_sink;  // Keeps results alive
+
+// ----------------------------------------------------------------------------
+// Cache-miss counter
+// ----------------------------------------------------------------------------
+
+class CacheMisses {
+public:
+    CacheMisses() {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMisses() {
+#if defined(__linux__)
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    uint64_t stop() {
+        uint64_t count = 0;
+#if defined(__linux__)
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+// ----------------------------------------------------------------------------
+// Timing and results
+// ----------------------------------------------------------------------------
+
+struct Result {
+    std::string name;
+    size_t entities;
+    double ns_per_entity;
+    double misses_per_entity;  // < 0: no counter
+};
+
+struct Bench {
+    int runs = 3;
+    uint32_t seed = 12345;
+    CacheMisses misses;
+    std::vector<Result> results;
+
+    // Best of `runs` calls of body(); setup() before each, untimed
+    template <typename Setup, typename Body>
+    void run(const std::string& name, size_t entities, Setup&& setup, Body&& body) {
+        double best_ns = 1e300;
+        uint64_t best_misses = 0;
+        for (int i = 0; i < runs; i++) {
+            setup();
+            misses.start();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            uint64_t missed = misses.stop();
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            if (ns < best_ns) {
+                best_ns = ns;
+                best_misses = missed;
+            }
+        }
+        Result result{name, entities, best_ns / entities,
+                      misses.available() ? double(best_misses) / entities : -1.0};
+        if (result.misses_per_entity >= 0.0) {
+            std::printf("  %-26s %9zu %10.2f ns/entity %8.3f misses/entity\n", name.c_str(), entities,
+                        result.ns_per_entity, result.misses_per_entity);
+        } else {
+            std::printf("  %-26s %9zu %10.2f ns/entity\n", name.c_str(), entities, result.ns_per_entity);
+        }
+        results.push_back(result);
+    }
+
+    template <typename Body>
+    void run(const std::string& name, size_t entities, Body&& body) {
+        run(name, entities, [] {}, body);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Workloads
+// ----------------------------------------------------------------------------
+
+const char* mode_name(StorageMode mode) { return mode == StorageMode::SparseSet ? "sparse" : "archetype"; }
+
+// Every entity has all four components
+void populate(EntityStorage& world, size_t count, std::vector<EntityId>& ids, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    ids.clear();
+    ids.reserve(count);
+    world.reserve_entities(count);
+    for (size_t i = 0; i < count; i++) {
+        EntityId e = world.create_entity();
+        world.add_component(e, Position{unit(rng), unit(rng), unit(rng)});
+        world.add_component(e, Velocity{unit(rng), unit(rng), unit(rng)});
+        world.add_component(e, Rotation{0.0f, 0.0f, 0.0f, 1.0f});
+        world.add_component(e, Health{100, 100});
+        ids.push_back(e);
+    }
+}
+
+void bench_churn(Bench& bench, size_t count, StorageMode mode) {
+    std::mt19937 rng(bench.seed);
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    // Per entity: create + add two components; half destroyed and recreated
+    bench.run(std::string("churn/") + mode_name(mode), count, [&] {
+        EntityStorage world(mode);
+        std::vector<EntityId> ids(count);
+        for (size_t i = 0; i < count; i++) {
+            ids[i] = world.create_entity();
+            world.add_component(ids[i], Position{1.0f, 2.0f, 3.0f});
+            world.add_component(ids[i], Health{100, 100});
+        }
+        for (size_t i = 0; i < count / 2; i++) world.destroy_entity(ids[order[i]]);
+        for (size_t i = 0; i < count / 2; i++) {
+            EntityId e = world.create_entity();
+            world.add_component(e, Position{1.0f, 2.0f, 3.0f});
+        }
+        g_sink = float(world.is_alive(ids[order[0]]));
+    });
+}
+
+void bench_iterate(Bench& bench, size_t count, StorageMode mode) {
+    std::mt19937 rng(bench.seed);
+    EntityStorage world(mode);
+    std::vector<EntityId> ids;
+    populate(world, count, ids, rng);
+    const float dt = 0.016f;
+
+    bench.run(std::string("iterate1/") + mode_name(mode), count, [&] {
+        world.for_each<Position>([&](EntityId, Position& p) { p.y -= 9.8f * dt; });
+    });
+    bench.run(std::string("iterate2/") + mode_name(mode), count, [&] {
+        world.for_each<Position, Velocity>([&](EntityId, Position& p, Velocity& v) {
+            p.x += v.x * dt;
+            p.y += v.y * dt;
+            p.z += v.z * dt;
+        });
+    });
+    bench.run(std::string("iterate4/") + mode_name(mode), count, [&] {
+        world.for_each<Position, Velocity, Rotation, Health>([&](EntityId, Position& p, Velocity& v, Rotation& r, Health& h) {
+            p.x += v.x * dt * r.w;
+            if (p.y < -100.0f) h.value--;
+        });
+    });
+    if (mode == StorageMode::SparseSet) {
+        auto& moving = world.query<Position, Velocity>();
+        bench.run("query2/sparse", count, [&] {
+            moving.for_each([&](EntityId, Position& p, Velocity& v) {
+                p.x += v.x * dt;
+                p.y += v.y * dt;
+                p.z += v.z * dt;
+            });
+        });
+    }
+
+    std::vector<EntityId> shuffled = ids;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+    bench.run(std::string("random_get/") + mode_name(mode), count, [&] {
+        float sum = 0.0f;
+        for (EntityId e : shuffled) sum += world.get_component<Position>(e)->x;
+        g_sink = sum;
+    });
+
+    // What migrate_<component>() emits when one field is new
+    bench.run(std::string("migrate/") + mode_name(mode), count, [&] {
+        size_t migrated_count = 0;
+        world.for_each<Rotation>([&](EntityId, Rotation& comp) {
+            comp.w = 1.0f;  // New field, use default
+            migrated_count++;
+        });
+        g_sink = float(migrated_count);
+    });
+}
+
+// The loop bodies generate_query_loop emits for
+//   entity.Position.x = entity.Position.x + entity.Velocity.x * dt
+// with both components AoS, and with both component_soa
+void bench_integrate(Bench& bench, size_t count) {
+    std::mt19937 rng(bench.seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const float delta_time = 0.016f;
+
+    struct AoSQuery {
+        std::vector<Position> positions;
+        std::vector<Velocity> velocities;
+        size_t size() const { return positions.size(); }
+    } aos;
+    struct SoAQuery {
+        SoAPosition positions;
+        SoAVelocity velocities;
+        size_t size() const { return positions.x.size(); }
+    } soa;
+    for (size_t i = 0; i < count; i++) {
+        Position p{unit(rng), unit(rng), unit(rng)};
+        Velocity v{unit(rng), unit(rng), unit(rng)};
+        aos.positions.push_back(p);
+        aos.velocities.push_back(v);
+        soa.positions.x.push_back(p.x);
+        soa.positions.y.push_back(p.y);
+        soa.positions.z.push_back(p.z);
+        soa.velocities.x.push_back(v.x);
+        soa.velocities.y.push_back(v.y);
+        soa.velocities.z.push_back(v.z);
+    }
+
+    bench.run("integrate_aos", count, [&] {
+        AoSQuery& q = aos;
+        for (size_t entity_index = 0; entity_index < q.size(); ++entity_index) {
+            q.positions[entity_index].x = (q.positions[entity_index].x + (q.velocities[entity_index].x * delta_time));
+            q.positions[entity_index].y = (q.positions[entity_index].y + (q.velocities[entity_index].y * delta_time));
+            q.positions[entity_index].z = (q.positions[entity_index].z + (q.velocities[entity_index].z * delta_time));
+        }
+    });
+    bench.run("integrate_soa", count, [&] {
+        SoAQuery& q = soa;
+        auto* EDEN_RESTRICT entity_positions_x = q.positions.x.data();
+        auto* EDEN_RESTRICT entity_velocities_x = q.velocities.x.data();
+        auto* EDEN_RESTRICT entity_positions_y = q.positions.y.data();
+        auto* EDEN_RESTRICT entity_velocities_y = q.velocities.y.data();
+        auto* EDEN_RESTRICT entity_positions_z = q.positions.z.data();
+        auto* EDEN_RESTRICT entity_velocities_z = q.velocities.z.data();
+        EDEN_VECTORIZE
+        for (size_t entity_index = 0; entity_index < q.size(); ++entity_index) {
+            entity_positions_x[entity_index] = (entity_positions_x[entity_index] + (entity_velocities_x[entity_index] * delta_time));
+            entity_positions_y[entity_index] = (entity_positions_y[entity_index] + (entity_velocities_y[entity_index] * delta_time));
+            entity_positions_z[entity_index] = (entity_positions_z[entity_index] + (entity_velocities_z[entity_index] * delta_time));
+        }
+    });
+    bench.run("integrate_soa_kernel", count, [&] {
+        soa_integrate_vec3(soa.positions.x.data(), soa.positions.y.data(), soa.positions.z.data(), soa.velocities.x.data(),
+                           soa.velocities.y.data(), soa.velocities.z.data(), delta_time, soa.size());
+    });
+    g_sink = aos.positions[0].x + soa.positions.x[0];
+}
+
+// ----------------------------------------------------------------------------
+// History (one JSON object per line)
+// ----------------------------------------------------------------------------
+
+std::string to_json(const std::vector<Result>& results, uint32_t seed) {
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    std::string json = std::string("{\"time\":\"") + stamp + "\",\"seed\":" + std::to_string(seed) + ",\"results\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        char entry[256];
+        std::snprintf(entry, sizeof(entry), "%s{\"name\":\"%s\",\"entities\":%zu,\"ns_per_entity\":%.4f,\"misses_per_entity\":%.4f}",
+                      i ? "," : "", results[i].name.c_str(), results[i].entities, results[i].ns_per_entity,
+                      results[i].misses_per_entity);
+        json += entry;
+    }
+    return json + "]}";
+}
+
+// Reads back what to_json wrote (not a general JSON parser)
+std::vector<Result> from_json(const std::string& line) {
+    std::vector<Result> results;
+    size_t at = 0;
+    while ((at = line.find("{\"name\":\"", at)) != std::string::npos) {
+        at += 9;
+        size_t end = line.find('"', at);
+        if (end == std::string::npos) break;
+        Result result{line.substr(at, end - at), 0, 0.0, -1.0};
+        if (std::sscanf(line.c_str() + end, "\",\"entities\":%zu,\"ns_per_entity\":%lf,\"misses_per_entity\":%lf",
+                        &result.entities, &result.ns_per_entity, &result.misses_per_entity) == 3) {
+            results.push_back(result);
+        }
+        at = end;
+    }
+    return results;
+}
+
+// Compares with the file's last line, then appends this run. Returns the
+// number of regressions.
+int record(const std::string& path, const std::vector<Result>& results, uint32_t seed, double threshold) {
+    std::string last, line;
+    {
+        std::ifstream in(path);
+        while (std::getline(in, line)) {
+            if (!line.empty()) last = line;
+        }
+    }
+    int regressions = 0;
+    if (!last.empty()) {
+        std::vector<Result> previous = from_json(last);
+        std::printf("\nAgainst the previous run in %s:\n", path.c_str());
+        for (const Result& result : results) {
+            for (const Result& before : previous) {
+                if (before.name != result.name || before.entities != result.entities || before.ns_per_entity <= 0.0) continue;
+                double change = (result.ns_per_entity / before.ns_per_entity - 1.0) * 100.0;
+                bool regressed = change > threshold;
+                if (regressed || change < -threshold) {
+                    std::printf("  %-26s %9zu %+7.1f%%%s\n", result.name.c_str(), result.entities, change,
+                                regressed ? "  REGRESSION" : "");
+                }
+                regressions += regressed;
+            }
+        }
+        if (regressions == 0) std::printf("  no case more than %.0f%% slower\n", threshold);
+    }
+    FILE* out = std::fopen(path.c_str(), "ab");
+    if (!out) {
+        std::fprintf(stderr, "Cannot append to %s\n", path.c_str());
+        return regressions;
+    }
+    std::fprintf(out, "%s\n", to_json(results, seed).c_str());
+    std::fclose(out);
+    return regressions;
+}
+
+std::vector<size_t> parse_sizes(const char* text) {
+    std::vector<size_t> sizes;
+    for (const char* at = text; *at;) {
+        char* end;
+        unsigned long long value = std::strtoull(at, &end, 10);
+        if (end == at) break;
+        if (value > 0) sizes.push_back(static_cast<size_t>(value));
+        at = *end == ',' ? end + 1 : end;
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench bench;
+    std::vector<size_t> sizes = {10000, 100000, 1000000};
+    std::string history = "ecs_bench_history.jsonl";
+    double threshold = 10.0;
+    bool fail_on_regression = false;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--sizes") && i + 1 < argc) sizes = parse_sizes(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) bench.runs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) bench.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--history") && i + 1 < argc) history = argv[++i];
+        else if (!std::strcmp(argv[i], "--threshold") && i + 1 < argc) threshold = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--fail-on-regression")) fail_on_regression = true;
+        else {
+            std::fprintf(stderr, "Unknown argument %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::printf("ECS bench: best of %d, seed %u, cache misses %s\n", bench.runs, bench.seed,
+                bench.misses.available() ? "from perf counters" : "unavailable");
+    for (size_t count : sizes) {
+        std::printf("\n%zu entities\n", count);
+        for (StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+            bench_churn(bench, count, mode);
+            bench_iterate(bench, count, mode);
+        }
+        bench_integrate(bench, count);
+    }
+
+    int regressions = record(history, bench.results, bench.seed, threshold);
+    return fail_on_regression && regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,270 @@
+// ============================================================================
+// HDM BENCH - v2 stream loading against v3 mapped views
+// ============================================================================
+// Writes every item given (.hdm / .hdma files, or directories of them - the
+// item library) back out as v2, v3 and v3 with encoded geometry under
+// hdm_bench_out/, then times getting each item's vertices, indices and
+// texture into a staging buffer, the way UploadBatch::uploadBuffer does:
+//
+//   v2 loadBinary      stream reads into vectors, then memcpy to staging
+//   v3 loadBinary      mapped file copied into vectors, then memcpy to staging
+//   v3 HDMView         mapped file, sections memcpy'd straight to staging
+//   packed HDMView     mapped file, geometry decoded straight to staging
+//                      (meshopt with EDEN_USE_MESHOPT, else quantized only)
+//
+// Files are read through the page cache, so this measures parsing and
+// copying rather than the disk. Without inputs (or with --synthetic N) a
+// generated N x N vertex grid with a 1024x1024 texture is used.
+//
+// Build:
+//   g++ -std=c++17 -O2 -I. vulkan/tools/hdm_bench.cpp vulkan/formats/hdm_format.cpp -o hdm_bench
+//   (add -DEDEN_USE_MESHOPT -lmeshoptimizer for the meshopt codecs)
+//
+// Usage:
+//   hdm_bench [items... | item_dir...] [--synthetic N] [--runs N]
+// ============================================================================
+
+#include "../formats/hdm_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace eden::hdm;
+
+namespace {
+
+struct Item {
+    std::string name;
+    std::string v2Path;
+    std::string v3Path;
+    std::string packedPath;
+    size_t payload = 0;  // Vertex + index + texture bytes
+};
+
+bool isHdmFile(const fs::path& path) {
+    std::string ext = path.extension().string();
+    return ext == ".hdm" || ext == ".hdma";
+}
+
+void collectInputs(const std::string& arg, std::vector<fs::path>& out) {
+    std::error_code ec;
+    if (fs::is_directory(arg, ec)) {
+        for (const auto& entry : fs::recursive_directory_iterator(arg, ec)) {
+            if (entry.is_regular_file() && isHdmFile(entry.path())) out.push_back(entry.path());
+        }
+    } else {
+        out.push_back(arg);
+    }
+}
+
+// An n x n vertex grid with a matching RGBA8 texture
+void makeSynthetic(int n, HDMProperties& props, HDMGeometry& geom, HDMTexture& tex) {
+    initDefaultProperties(props);
+    geom.vertices.resize(size_t(n) * n);
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            HDMVertex& v = geom.vertices[size_t(y) * n + x];
+            v.position[0] = float(x);
+            v.position[1] = 0.0f;
+            v.position[2] = float(y);
+            v.normal[0] = v.normal[2] = 0.0f;
+            v.normal[1] = 1.0f;
+            v.texcoord[0] = float(x) / n;
+            v.texcoord[1] = float(y) / n;
+        }
+    }
+    geom.indices.clear();
+    for (int y = 0; y + 1 < n; y++) {
+        for (int x = 0; x + 1 < n; x++) {
+            uint32_t i = uint32_t(y * n + x);
+            geom.indices.insert(geom.indices.end(), {i, i + 1, i + uint32_t(n), i + 1, i + uint32_t(n) + 1, i + uint32_t(n)});
+        }
+    }
+    tex.width = tex.height = 1024;
+    tex.format = 0;
+    tex.data.resize(size_t(tex.width) * tex.height * 4);
+    for (size_t i = 0; i < tex.data.size(); i++) tex.data[i] = static_cast<unsigned char>(i * 31);
+}
+
+bool addItem(const std::string& name, const HDMProperties& props, const HDMGeometry& geom,
+             const HDMTexture& tex, std::vector<Item>& items) {
+    Item item;
+    item.name = name;
+    std::string stem = "hdm_bench_out/" + std::to_string(items.size()) + "_" + fs::path(name).stem().string();
+    item.v2Path = stem + ".v2.hdm";
+    item.v3Path = stem + ".v3.hdm";
+    item.packedPath = stem + ".packed.hdm";
+    item.payload = geom.vertices.size() * sizeof(HDMVertex) + geom.indices.size() * sizeof(uint32_t) + tex.data.size();
+    if (!saveBinaryV2(item.v2Path.c_str(), props, geom, tex) || !saveBinary(item.v3Path.c_str(), props, geom, tex) ||
+        !saveBinary(item.packedPath.c_str(), props, geom, tex, HDM_GEOMETRY_MESHOPT)) {
+        return false;
+    }
+    items.push_back(item);
+    return true;
+}
+
+// Copy a loaded item into staging, as the upload path would
+size_t stage(const HDMGeometry& geom, const HDMTexture& tex, unsigned char* staging) {
+    size_t at = 0;
+    auto copy = [&](const void* src, size_t bytes) {
+        if (bytes) std::memcpy(staging + at, src, bytes);
+        at += bytes;
+    };
+    copy(geom.vertices.data(), geom.vertices.size() * sizeof(HDMVertex));
+    copy(geom.indices.data(), geom.indices.size() * sizeof(uint32_t));
+    copy(tex.data.data(), tex.data.size());
+    return at;
+}
+
+size_t loadAndStage(const std::string& path, unsigned char* staging) {
+    HDMProperties props;
+    HDMGeometry geom;
+    HDMTexture tex;
+    if (!loadBinary(path.c_str(), props, geom, tex)) return 0;
+    return stage(geom, tex, staging);
+}
+
+size_t viewAndStage(const std::string& path, unsigned char* staging) {
+    HDMView view;
+    if (!view.open(path.c_str())) return 0;
+    size_t at = 0;
+    auto copy = [&](const void* src, size_t bytes) {
+        if (bytes) std::memcpy(staging + at, src, bytes);
+        at += bytes;
+    };
+    if (view.encoded()) {
+        size_t vertexBytes = view.vertexCount() * sizeof(HDMVertex);
+        if (!view.decodeGeometry(reinterpret_cast<HDMVertex*>(staging),
+                                 reinterpret_cast<uint32_t*>(staging + vertexBytes))) {
+            return 0;
+        }
+        at = vertexBytes + view.indexCount() * sizeof(uint32_t);
+    } else {
+        copy(view.vertices(), view.vertexBytes());
+        copy(view.indices(), view.indexBytes());
+    }
+    copy(view.textureData(), view.textureBytes());
+    return at;
+}
+
+// Best of `runs` over the whole library, in milliseconds; `staged` is the
+// byte count of the last run so paths can be checked against each other
+double timeBest(int runs, const std::function<size_t()>& pass, size_t& staged) {
+    double best = 1e30;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        staged = pass();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+void report(const char* name, double ms, size_t staged) {
+    std::printf("%-18s %9.2f ms %9.1f MB/s   %10zu bytes staged\n", name, ms,
+                staged / (1024.0 * 1024.0) / (ms / 1000.0), staged);
+}
+
+// Swallows the loaders' per-file logging
+struct NullBuffer : std::streambuf {
+    int overflow(int c) override { return c; }
+};
+
+size_t fileSize(const std::string& path) {
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    return ec ? 0 : static_cast<size_t>(size);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<fs::path> inputs;
+    int synthetic = 0, runs = 5;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--synthetic") && i + 1 < argc) synthetic = std::max(2, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else collectInputs(argv[i], inputs);
+    }
+    if (inputs.empty() && synthetic == 0) synthetic = 1024;
+
+    std::error_code ec;
+    fs::create_directories("hdm_bench_out", ec);
+
+    // The loaders log every file; keep that out of the timings
+    NullBuffer sink;
+    std::streambuf* console = std::cout.rdbuf(&sink);
+
+    std::vector<Item> items;
+    for (const fs::path& input : inputs) {
+        HDMProperties props;
+        HDMGeometry geom;
+        HDMTexture tex;
+        if (!load(input.string().c_str(), props, geom, tex) || !addItem(input.string(), props, geom, tex, items)) {
+            std::fprintf(stderr, "Skipping %s\n", input.string().c_str());
+        }
+    }
+    if (synthetic > 0) {
+        HDMProperties props;
+        HDMGeometry geom;
+        HDMTexture tex;
+        makeSynthetic(synthetic, props, geom, tex);
+        addItem("synthetic_grid", props, geom, tex, items);
+    }
+    if (items.empty()) {
+        std::cout.rdbuf(console);
+        std::fprintf(stderr, "No items to load\n");
+        return 1;
+    }
+
+    size_t largest = 0, payload = 0, v2Bytes = 0, v3Bytes = 0, packedBytes = 0;
+    for (const Item& item : items) {
+        largest = std::max(largest, item.payload);
+        payload += item.payload;
+        v2Bytes += fileSize(item.v2Path);
+        v3Bytes += fileSize(item.v3Path);
+        packedBytes += fileSize(item.packedPath);
+    }
+    std::vector<unsigned char> staging(std::max<size_t>(largest, 1));
+
+    auto pass = [&](std::string Item::*path, bool view) {
+        return [&, path, view]() {
+            size_t staged = 0;
+            for (const Item& item : items) {
+                staged += view ? viewAndStage(item.*path, staging.data()) : loadAndStage(item.*path, staging.data());
+            }
+            return staged;
+        };
+    };
+    size_t v2Staged = 0, v3Staged = 0, viewStaged = 0, packedLoadStaged = 0, packedViewStaged = 0;
+    double v2Ms = timeBest(runs, pass(&Item::v2Path, false), v2Staged);
+    double v3Ms = timeBest(runs, pass(&Item::v3Path, false), v3Staged);
+    double viewMs = timeBest(runs, pass(&Item::v3Path, true), viewStaged);
+    double packedLoadMs = timeBest(runs, pass(&Item::packedPath, false), packedLoadStaged);
+    double packedViewMs = timeBest(runs, pass(&Item::packedPath, true), packedViewStaged);
+    std::cout.rdbuf(console);
+
+    std::printf("%zu items, %.1f MB payload (files: v2 %.1f MB, v3 %.1f MB, packed %.1f MB), best of %d\n",
+                items.size(), payload / (1024.0 * 1024.0), v2Bytes / (1024.0 * 1024.0), v3Bytes / (1024.0 * 1024.0),
+                packedBytes / (1024.0 * 1024.0), runs);
+    report("v2 loadBinary", v2Ms, v2Staged);
+    report("v3 loadBinary", v3Ms, v3Staged);
+    report("v3 HDMView", viewMs, viewStaged);
+    report("packed loadBinary", packedLoadMs, packedLoadStaged);
+    report("packed HDMView", packedViewMs, packedViewStaged);
+    if (v2Staged != payload || v3Staged != payload || viewStaged != payload || packedLoadStaged != payload ||
+        packedViewStaged != payload) {
+        std::fprintf(stderr, "Staged byte counts differ from the payload - a loader failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+// ============================================================================
+// JSON BENCH - per-key text scans against one JsonDocument pass
+// ============================================================================
+// Times reading every key the loaders read, two ways:
+//
+//   per-key scan    the old jsonFind* pattern: a find() over the whole text
+//                   for each key, so a document costs keys x size
+//   JsonDocument    one pass into nodes (stdlib/json_reader.h), then lookups
+//
+// on a generated .hdma (properties plus a base64 grid of --vertices N
+// vertices, keys read after the geometry pay for it) and a generated scene
+// of --entities N entities, each with a transform, mesh, material and a
+// few components. Scene keys are scanned from each entity's start, since a
+// plain find() can't tell entities apart. Any files given are also parsed,
+// to report MB/s on real documents.
+//
+// Build:
+//   g++ -std=c++17 -O2 -pthread -I. vulkan/tools/json_bench.cpp vulkan/formats/hdm_format.cpp -o json_bench
+//
+// Usage:
+//   json_bench [files...] [--entities N] [--vertices N] [--runs N]
+// ============================================================================
+
+#include "../formats/hdm_format.h"
+#include "../../stdlib/json_reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace eden::hdm;
+
+namespace {
+
+// The old lookup: first "key": after `from`, value read in place
+size_t scanKey(const std::string& json, const char* key, size_t from = 0) {
+    std::string searchKey = std::string("\"") + key + "\":";
+    size_t pos = json.find(searchKey, from);
+    if (pos == std::string::npos) return std::string::npos;
+    pos += searchKey.length();
+    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
+    return pos;
+}
+
+double scanNumber(const std::string& json, const char* key, size_t from = 0) {
+    size_t pos = scanKey(json, key, from);
+    return pos == std::string::npos ? 0.0 : std::atof(json.c_str() + pos);
+}
+
+size_t scanString(const std::string& json, const char* key, size_t from = 0) {
+    size_t pos = scanKey(json, key, from);
+    if (pos == std::string::npos || json[pos] != '"') return 0;
+    size_t end = json.find('"', pos + 1);
+    return end == std::string::npos ? 0 : end - pos - 1;
+}
+
+const char* HDM_NUMBER_KEYS[] = {
+    "item_type_id", "trade_value", "condition", "weight", "category", "collision_type", "mass",
+    "vertex_count", "index_count", "width", "height", "mip_count",
+};
+const char* HDM_STRING_KEYS[] = {
+    "obj_path", "texture_path", "item_name", "vertices_base64", "indices_base64", "data_base64",
+};
+const char* ENTITY_NUMBER_KEYS[] = {"id", "parent", "layer", "health", "speed", "radius"};
+const char* ENTITY_STRING_KEYS[] = {"name", "mesh", "material", "script"};
+
+// Sums what was read so neither path can be optimized away
+double readHdmScan(const std::string& json) {
+    double sum = 0.0;
+    for (const char* key : HDM_NUMBER_KEYS) sum += scanNumber(json, key);
+    for (const char* key : HDM_STRING_KEYS) sum += double(scanString(json, key));
+    return sum;
+}
+
+double readHdmDocument(const std::string& json) {
+    JsonDocument doc;
+    if (!doc.parseView(json)) return -1.0;
+    JsonValue root = doc.root();
+    JsonValue properties = root["properties"], geometry = root["geometry"], texture = root["texture"];
+    double sum = 0.0;
+    for (const char* key : {"item_type_id", "trade_value", "condition", "weight", "category", "collision_type", "mass"}) {
+        sum += properties.find(key).asDouble();
+    }
+    sum += geometry["vertex_count"].asDouble() + geometry["index_count"].asDouble();
+    sum += texture["width"].asDouble() + texture["height"].asDouble() + texture["mip_count"].asDouble();
+    for (const char* key : {"obj_path", "texture_path", "item_name"}) sum += double(properties.find(key).asString().size());
+    sum += double(geometry["vertices_base64"].asString().size() + geometry["indices_base64"].asString().size());
+    sum += double(texture["data_base64"].asString().size());
+    return sum;
+}
+
+double readSceneScan(const std::string& json) {
+    double sum = 0.0;
+    for (size_t at = json.find("{\"id\":"); at != std::string::npos; at = json.find("{\"id\":", at + 1)) {
+        for (const char* key : ENTITY_NUMBER_KEYS) sum += scanNumber(json, key, at);
+        for (const char* key : ENTITY_STRING_KEYS) sum += double(scanString(json, key, at));
+        size_t position = scanKey(json, "position", at);
+        if (position != std::string::npos) sum += std::atof(json.c_str() + position + 1);
+    }
+    return sum;
+}
+
+double readSceneDocument(const std::string& json) {
+    JsonDocument doc;
+    if (!doc.parseView(json)) return -1.0;
+    double sum = 0.0;
+    for (JsonValue entity : doc.root()["entities"]) {
+        JsonValue components = entity["components"];
+        for (const char* key : {"id", "parent", "layer"}) sum += entity[key].asDouble();
+        for (const char* key : {"health", "speed", "radius"}) sum += components.find(key).asDouble();
+        for (const char* key : {"name", "mesh", "material"}) sum += double(entity[key].asString().size());
+        sum += double(components.find("script").asString().size());
+        sum += entity["transform"]["position"][size_t(0)].asDouble();
+    }
+    return sum;
+}
+
+std::string makeHdma(int vertices) {
+    HDMProperties props;
+    HDMGeometry geom;
+    HDMTexture tex;
+    initDefaultProperties(props);
+    std::strcpy(props.item.item_name, "Bench Crate");
+    geom.vertices.resize(size_t(vertices));
+    for (int i = 0; i < vertices; i++) geom.vertices[size_t(i)].position[0] = float(i);
+    for (int i = 0; i + 2 < vertices; i++) geom.indices.insert(geom.indices.end(), {uint32_t(i), uint32_t(i + 1), uint32_t(i + 2)});
+    tex.width = tex.height = 256;
+    tex.data.assign(size_t(tex.width) * tex.height * 4, 128);
+
+    const char* path = "json_bench.hdma";
+    if (!saveAscii(path, props, geom, tex)) return std::string();
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+std::string makeScene(int entities) {
+    std::string json = "{\n  \"name\": \"bench_scene\",\n  \"entities\": [\n";
+    char line[512];
+    for (int i = 0; i < entities; i++) {
+        std::snprintf(line, sizeof(line),
+                      "    {\"id\": %d, \"name\": \"entity_%d\", \"parent\": %d, \"layer\": %d, "
+                      "\"transform\": {\"position\": [%d.5, 0, %d.25], \"rotation\": [0, 0, 0, 1], \"scale\": [1, 1, 1]}, "
+                      "\"mesh\": \"meshes/crate_%d.hdm\", \"material\": \"materials/wood.mat\", "
+                      "\"components\": {\"vitals\": {\"health\": 100}, \"mover\": {\"speed\": 2.5, \"radius\": 0.75}, "
+                      "\"script\": \"scripts/crate.hd\"}}%s\n",
+                      i, i, i / 2, i % 4, i, -i, i % 16, i + 1 < entities ? "," : "");
+        json += line;
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+double timeBest(int runs, const std::function<double()>& pass, double& result) {
+    double best = 1e30;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        result = pass();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+void report(const char* name, double ms, size_t bytes) {
+    std::printf("  %-14s %10.3f ms %9.1f MB/s\n", name, ms, bytes / (1024.0 * 1024.0) / (ms / 1000.0));
+}
+
+// Both ways over one document; false if they disagree
+bool compare(const char* title, const std::string& json, int runs, double (*scan)(const std::string&),
+             double (*document)(const std::string&)) {
+    double scanned = 0.0, parsed = 0.0;
+    double scanMs = timeBest(runs, [&]() { return scan(json); }, scanned);
+    double docMs = timeBest(runs, [&]() { return document(json); }, parsed);
+    std::printf("%s (%.2f MB)\n", title, json.size() / (1024.0 * 1024.0));
+    report("per-key scan", scanMs, json.size());
+    report("JsonDocument", docMs, json.size());
+    std::printf("  %.1fx faster\n", scanMs / docMs);
+    if (scanned != parsed) {
+        std::fprintf(stderr, "%s: read %.3f by scanning but %.3f from the document\n", title, scanned, parsed);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    int entities = 5000, vertices = 100000, runs = 5;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--entities") && i + 1 < argc) entities = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--vertices") && i + 1 < argc) vertices = std::max(3, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else files.push_back(argv[i]);
+    }
+
+    // saveAscii logs; keep that out of the report
+    std::streambuf* console = std::cout.rdbuf(nullptr);
+    std::string hdma = makeHdma(vertices);
+    std::cout.rdbuf(console);
+    if (hdma.empty()) {
+        std::fprintf(stderr, "Could not write json_bench.hdma\n");
+        return 1;
+    }
+
+    std::printf("best of %d\n", runs);
+    bool ok = compare("hdma", hdma, runs, readHdmScan, readHdmDocument);
+    ok = compare("scene", makeScene(entities), runs, readSceneScan, readSceneDocument) && ok;
+
+    for (const std::string& path : files) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream text;
+        text << file.rdbuf();
+        std::string json = text.str();
+        JsonDocument doc;
+        double nodes = 0.0;
+        double ms = timeBest(runs, [&]() { return doc.parseView(json) ? double(doc.nodeCount()) : -1.0; }, nodes);
+        if (nodes < 0.0) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), doc.error().c_str());
+            ok = false;
+            continue;
+        }
+        std::printf("%s (%.2f MB, %.0f values)\n", path.c_str(), json.size() / (1024.0 * 1024.0), nodes);
+        report("JsonDocument", ms, json.size());
+    }
+    return ok ? 0 : 1;
+}
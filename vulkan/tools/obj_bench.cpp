@@ -0,0 +1,217 @@
+// ============================================================================
+// OBJ BENCH - load_obj throughput against the previous line-based parser
+// ============================================================================
+// Times stdlib/obj_loader.h's load_obj (mapped file, from_chars, vertex
+// dedup, fan triangulation, parallel scan) against the getline/istringstream
+// loader it replaced, kept below as legacyLoadObj. LODs are not built, so
+// only parsing is measured.
+//
+// Without an input file a grid of quads with UVs and normals is written to
+// obj_bench_grid.obj first (--grid N quads per side, default 1500 - about
+// 150 MB).
+//
+// Build (needs only the glm headers):
+//   g++ -std=c++17 -O2 -pthread -I<glm> vulkan/tools/obj_bench.cpp -o obj_bench
+//
+// Usage:
+//   obj_bench [input.obj] [--grid N] [--runs N] [--threads N] [--no-legacy]
+// ============================================================================
+
+#include "../../stdlib/obj_loader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Previous loader (one vertex per face corner, first four corners only)
+// ----------------------------------------------------------------------------
+
+bool legacyParseCorner(const std::string& token, int32_t& pos, int32_t& tex, int32_t& norm) {
+    pos = tex = norm = -1;
+    try {
+        size_t slash1 = token.find('/');
+        if (slash1 == std::string::npos) {
+            pos = std::stoi(token) - 1;
+            return true;
+        }
+        pos = std::stoi(token.substr(0, slash1)) - 1;
+        size_t slash2 = token.find('/', slash1 + 1);
+        if (slash2 == std::string::npos) {
+            std::string texStr = token.substr(slash1 + 1);
+            if (!texStr.empty()) tex = std::stoi(texStr) - 1;
+        } else {
+            std::string texStr = token.substr(slash1 + 1, slash2 - slash1 - 1);
+            if (!texStr.empty()) tex = std::stoi(texStr) - 1;
+            std::string normStr = token.substr(slash2 + 1);
+            if (!normStr.empty()) norm = std::stoi(normStr) - 1;
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+MeshData legacyLoadObj(const std::string& filepath) {
+    MeshData result;
+    std::ifstream file(filepath);
+    if (!file.is_open()) throw std::runtime_error("Failed to open OBJ file: " + filepath);
+
+    std::vector<float> positions, normals, texcoords;
+    auto emit = [&](int32_t pos, int32_t tex, int32_t norm) {
+        result.positions.insert(result.positions.end(), positions.begin() + pos * 3, positions.begin() + pos * 3 + 3);
+        if (norm >= 0 && norm < int32_t(normals.size() / 3)) {
+            result.normals.insert(result.normals.end(), normals.begin() + norm * 3, normals.begin() + norm * 3 + 3);
+        } else {
+            result.normals.insert(result.normals.end(), {0.0f, 0.0f, 1.0f});
+        }
+        if (tex >= 0 && tex < int32_t(texcoords.size() / 2)) {
+            result.texcoords.insert(result.texcoords.end(), texcoords.begin() + tex * 2, texcoords.begin() + tex * 2 + 2);
+        } else {
+            result.texcoords.insert(result.texcoords.end(), {0.0f, 0.0f});
+        }
+    };
+
+    std::string line;
+    while (std::getline(file, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r\n"));
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string type;
+        iss >> type;
+        float x, y, z;
+        if (type == "v") {
+            if (iss >> x >> y >> z) positions.insert(positions.end(), {x, y, z});
+        } else if (type == "vn") {
+            if (iss >> x >> y >> z) normals.insert(normals.end(), {x, y, z});
+        } else if (type == "vt") {
+            if (iss >> x >> y) texcoords.insert(texcoords.end(), {x, 1.0f - y});
+        } else if (type == "f") {
+            std::vector<std::string> tokens;
+            std::string token;
+            while (iss >> token) tokens.push_back(token);
+            if (tokens.size() < 3) continue;
+            int32_t p[4], t[4], n[4];
+            size_t corners = std::min<size_t>(tokens.size(), 4);
+            bool valid = true;
+            for (size_t i = 0; i < corners && valid; i++) {
+                valid = legacyParseCorner(tokens[i], p[i], t[i], n[i]) &&
+                        p[i] >= 0 && p[i] < int32_t(positions.size() / 3);
+            }
+            if (!valid) continue;
+            uint32_t base = static_cast<uint32_t>(result.positions.size() / 3);
+            for (size_t i = 0; i < corners; i++) emit(p[i], t[i], n[i]);
+            result.indices.insert(result.indices.end(), {base, base + 1, base + 2});
+            if (corners == 4) result.indices.insert(result.indices.end(), {base, base + 2, base + 3});
+        }
+    }
+    result.vertexCount = static_cast<uint32_t>(result.positions.size() / 3);
+    result.indexCount = static_cast<uint32_t>(result.indices.size());
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+// Input and timing
+// ----------------------------------------------------------------------------
+
+bool writeGrid(const std::string& path, int quads) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const int side = quads + 1;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            std::fprintf(file, "v %.6f %.6f %.6f\n", x / float(quads), 0.05f * std::sin(x * 0.1f + y * 0.07f),
+                         y / float(quads));
+        }
+    }
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) std::fprintf(file, "vt %.6f %.6f\n", x / float(quads), y / float(quads));
+    }
+    std::fprintf(file, "vn 0.000000 1.000000 0.000000\n");
+    for (int y = 0; y < quads; y++) {
+        for (int x = 0; x < quads; x++) {
+            int a = y * side + x + 1, b = a + 1, c = a + side + 1, d = a + side;
+            std::fprintf(file, "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, b, b, c, c, d, d);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+// Best of `runs`, in milliseconds
+double timeBest(int runs, const std::function<MeshData()>& load, MeshData& mesh) {
+    double best = 1e30;
+    for (int i = 0; i < runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        mesh = load();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+void report(const char* name, double ms, size_t bytes, const MeshData& mesh) {
+    std::printf("%-22s %9.1f ms %8.1f MB/s   %10u vertices %10u indices\n", name, ms,
+                bytes / (1024.0 * 1024.0) / (ms / 1000.0), mesh.vertexCount, mesh.indexCount);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string input;
+    int grid = 1500, runs = 3;
+    uint32_t threads = 0;
+    bool legacy = true;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--grid") && i + 1 < argc) grid = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--no-legacy")) legacy = false;
+        else input = argv[i];
+    }
+    if (input.empty()) {
+        input = "obj_bench_grid.obj";
+        std::printf("Writing %dx%d quad grid to %s\n", grid, grid, input.c_str());
+        if (!writeGrid(input, grid)) {
+            std::fprintf(stderr, "Cannot write %s\n", input.c_str());
+            return 1;
+        }
+    }
+
+    std::ifstream probe(input, std::ios::binary | std::ios::ate);
+    if (!probe.is_open()) {
+        std::fprintf(stderr, "Cannot open %s\n", input.c_str());
+        return 1;
+    }
+    size_t bytes = static_cast<size_t>(probe.tellg());
+    std::printf("%s: %.1f MB, best of %d\n", input.c_str(), bytes / (1024.0 * 1024.0), runs);
+
+    try {
+        MeshData mesh;
+        if (legacy) {
+            report("legacy (getline)", timeBest(runs, [&]() { return legacyLoadObj(input); }, mesh), bytes, mesh);
+        }
+        report("load_obj, 1 thread", timeBest(runs, [&]() { return load_obj(input, false, 1); }, mesh), bytes, mesh);
+        uint32_t parallel = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        if (parallel > 1) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "load_obj, %u threads", parallel);
+            report(name, timeBest(runs, [&]() { return load_obj(input, false, parallel); }, mesh), bytes, mesh);
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+// ============================================================================
+// RAYCAST BENCH - batched ray queries against the one-at-a-time functions
+// ============================================================================
+// Fixed-seed workloads over vulkan/utils/raycast.h, each reported as ns per
+// ray-primitive test (best of --runs) with the batched form's speedup:
+//
+//   aabb     one ray against --boxes boxes: a rayAABB() loop keeping the
+//            closest entry vs rayAABBsClosest() over an AABBArray
+//   packet   --rays rays in coherent bundles (a brush footprint, a probe's
+//            hemisphere) against a --tris triangle list: rayTriangle() per
+//            ray and triangle vs rayTrianglesPacket()
+//
+// Both forms must agree; a mismatch is reported and is the exit code.
+//
+// Build (needs only the glm headers):
+//   g++ -std=c++17 -O2 -march=native -I<glm> vulkan/tools/raycast_bench.cpp
+//       vulkan/utils/raycast.cpp -o raycast_bench
+// (without -march=native the SSE2 path runs; with AVX, 8 lanes)
+//
+// Usage:
+//   raycast_bench [--boxes N] [--tris N] [--rays N] [--runs N] [--seed N]
+// ============================================================================
+
+#include "../utils/raycast.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Options {
+    size_t boxes = 100000;
+    size_t tris = 2000;
+    size_t rays = 1024;
+    int runs = 5;
+    uint32_t seed = 1;
+};
+
+// Best wall time of `runs` calls, in ns
+template <typename Fn>
+double bestOf(int runs, Fn&& fn) {
+    double best = 1e300;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    return best;
+}
+
+// Keeps results observable so the loops aren't optimized away
+volatile float g_sink = 0.0f;
+
+int benchAABB(const Options& opt, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(0.5f, 8.0f);
+    std::vector<AABB> boxes(opt.boxes);
+    AABBArray array;
+    for (AABB& box : boxes) {
+        box = createCubeAABB(pos(rng), pos(rng), pos(rng), size(rng), size(rng), size(rng));
+        array.add(box);
+    }
+
+    const int QUERIES = 16;
+    std::vector<glm::vec3> origins(QUERIES), dirs(QUERIES);
+    for (int q = 0; q < QUERIES; q++) {
+        origins[q] = glm::vec3(pos(rng), pos(rng), pos(rng));
+        dirs[q] = glm::normalize(glm::vec3(pos(rng), pos(rng), pos(rng)));
+    }
+
+    std::vector<int> scalarHits(QUERIES), batchHits(QUERIES);
+    double scalarNs = bestOf(opt.runs, [&] {
+        for (int q = 0; q < QUERIES; q++) {
+            int best = -1;
+            float bestT = 1e30f;
+            for (size_t i = 0; i < boxes.size(); i++) {
+                float tMin, tMax;
+                if (rayAABB(origins[q], dirs[q], boxes[i], tMin, tMax) && tMin >= 0.0f && tMin < bestT) {
+                    bestT = tMin;
+                    best = static_cast<int>(i);
+                }
+            }
+            scalarHits[q] = best;
+            g_sink = g_sink + bestT;
+        }
+    });
+    double batchNs = bestOf(opt.runs, [&] {
+        for (int q = 0; q < QUERIES; q++) {
+            float t = 0.0f;
+            batchHits[q] = rayAABBsClosest(origins[q], dirs[q], array, t);
+            g_sink = g_sink + t;
+        }
+    });
+
+    int mismatches = 0;
+    for (int q = 0; q < QUERIES; q++) mismatches += scalarHits[q] != batchHits[q];
+
+    double tests = double(QUERIES) * double(boxes.size());
+    std::printf("aabb    %8zu boxes   scalar %7.3f ns/test   batched %7.3f ns/test   %5.2fx%s\n",
+                boxes.size(), scalarNs / tests, batchNs / tests, scalarNs / batchNs,
+                mismatches ? "   MISMATCH" : "");
+    return mismatches;
+}
+
+int benchPacket(const Options& opt, std::mt19937& rng) {
+    // A bumpy grid patch, like a painted surface or a probe's surroundings
+    size_t side = std::max<size_t>(2, size_t(std::sqrt(double(opt.tris) / 2.0)) + 1);
+    std::uniform_real_distribution<float> bump(-0.3f, 0.3f);
+    std::vector<glm::vec3> positions;
+    for (size_t z = 0; z < side; z++) {
+        for (size_t x = 0; x < side; x++) positions.emplace_back(float(x), bump(rng), float(z));
+    }
+    std::vector<uint32_t> indices;
+    for (size_t z = 0; z + 1 < side; z++) {
+        for (size_t x = 0; x + 1 < side; x++) {
+            uint32_t i = uint32_t(z * side + x);
+            uint32_t row = uint32_t(side);
+            indices.insert(indices.end(), {i, i + row, i + 1, i + 1, i + row, i + row + 1});
+        }
+    }
+    size_t triangles = indices.size() / 3;
+
+    // Bundles of 8 rays from one point toward neighbouring spots
+    std::uniform_real_distribution<float> spot(0.0f, float(side - 1));
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    std::vector<glm::vec3> origins(opt.rays), dirs(opt.rays);
+    for (size_t r = 0; r < opt.rays; r += 8) {
+        glm::vec3 eye(spot(rng), 5.0f, spot(rng));
+        glm::vec3 target(spot(rng), 0.0f, spot(rng));
+        for (size_t k = r; k < std::min(opt.rays, r + 8); k++) {
+            origins[k] = eye;
+            dirs[k] = glm::normalize(target + glm::vec3(jitter(rng), 0.0f, jitter(rng)) - eye);
+        }
+    }
+
+    std::vector<RayHit> scalarHits(opt.rays), packetHits(opt.rays);
+    double scalarNs = bestOf(opt.runs, [&] {
+        for (size_t r = 0; r < opt.rays; r++) {
+            RayHit best;
+            for (size_t tri = 0; tri < triangles; tri++) {
+                float t, u, v;
+                if (rayTriangle(origins[r], dirs[r], positions[indices[tri * 3]], positions[indices[tri * 3 + 1]],
+                                positions[indices[tri * 3 + 2]], t, u, v) &&
+                    (best.triangle < 0 || t < best.t)) {
+                    best.t = t;
+                    best.u = u;
+                    best.v = v;
+                    best.triangle = static_cast<int>(tri);
+                }
+            }
+            scalarHits[r] = best;
+        }
+        g_sink = g_sink + scalarHits[0].t;
+    });
+    double packetNs = bestOf(opt.runs, [&] {
+        for (size_t r = 0; r < opt.rays; r += 8) {
+            size_t count = std::min<size_t>(8, opt.rays - r);
+            rayTrianglesPacket(&origins[r], &dirs[r], count, positions.data(), indices.data(), triangles,
+                               &packetHits[r]);
+        }
+        g_sink = g_sink + packetHits[0].t;
+    });
+
+    // Same triangle; t within rounding (FMA contraction may differ)
+    int mismatches = 0;
+    for (size_t r = 0; r < opt.rays; r++) {
+        const RayHit& a = scalarHits[r];
+        const RayHit& b = packetHits[r];
+        if (a.triangle != b.triangle || (a.triangle >= 0 && std::fabs(a.t - b.t) > 1e-4f * std::max(1.0f, a.t))) {
+            mismatches++;
+        }
+    }
+
+    double tests = double(opt.rays) * double(triangles);
+    std::printf("packet  %8zu tris    scalar %7.3f ns/test   batched %7.3f ns/test   %5.2fx%s\n",
+                triangles, scalarNs / tests, packetNs / tests, scalarNs / packetNs,
+                mismatches ? "   MISMATCH" : "");
+    return mismatches;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (!std::strcmp(argv[i], "--boxes") && (value = next())) opt.boxes = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(argv[i], "--tris") && (value = next())) opt.tris = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(argv[i], "--rays") && (value = next())) opt.rays = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(argv[i], "--runs") && (value = next())) opt.runs = std::max(1, std::atoi(value));
+        else if (!std::strcmp(argv[i], "--seed") && (value = next())) opt.seed = uint32_t(std::strtoul(value, nullptr, 10));
+        else {
+            std::fprintf(stderr, "usage: raycast_bench [--boxes N] [--tris N] [--rays N] [--runs N] [--seed N]\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    std::printf("raycast_bench: %d-lane SIMD, best of %d runs\n", raycastSimdWidth(), opt.runs);
+    std::mt19937 rng(opt.seed);
+    int mismatches = benchAABB(opt, rng);
+    mismatches += benchPacket(opt, rng);
+    return mismatches ? 1 : 0;
+}
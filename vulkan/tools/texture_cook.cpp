@@ -0,0 +1,120 @@
+// ============================================================================
+// TEXTURE COOK - Offline PNG -> block-compressed, mipped KTX2
+// ============================================================================
+// Cooks source images into containers that VulkanCore::loadTexture() and the
+// stdlib TextureResource upload directly (no decode, no mip blits at load):
+//
+//   - Full mip chain, box-filtered in linear light for sRGB textures
+//   - BC1 for opaque images, BC3 when any texel has alpha < 255
+//     (--format bc1|bc3|bc7|rgba to force one)
+//   - --quality fast|normal|high trades encode time for error (bc_encoder.h);
+//     blocks are encoded on every core
+//   - --linear for data textures (normal maps, DMaps): UNORM instead of SRGB
+//
+// For Basis Universal output use the basisu / toktx tools instead; the
+// loader transcodes those at load time (ktx2_loader.h, EDEN_USE_BASISU).
+//
+// Build (needs only the Vulkan headers):
+//   g++ -std=c++17 -O2 -pthread -I$VULKAN_SDK/include vulkan/tools/texture_cook.cpp -o texture_cook
+//
+// Usage:
+//   texture_cook input.png output.ktx2 [--format bc1|bc3|bc7|rgba] [--quality fast|normal|high]
+//                [--linear] [--no-mips]
+// ============================================================================
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../stdlib/stb_image.h"
+#include "../../stdlib/ktx2_loader.h"
+#include "../../stdlib/bc_encoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+int usage() {
+    fprintf(stderr, "usage: texture_cook input.png output.ktx2 [--format bc1|bc3|bc7|rgba] "
+                    "[--quality fast|normal|high] [--linear] [--no-mips]\n");
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+    std::string input = argv[1];
+    std::string output = argv[2];
+    std::string format = "auto";
+    std::string quality = "normal";
+    bool linear = false;
+    bool mips = true;
+
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "--quality" && i + 1 < argc) {
+            quality = argv[++i];
+        } else if (arg == "--linear") {
+            linear = true;
+        } else if (arg == "--no-mips") {
+            mips = false;
+        } else {
+            return usage();
+        }
+    }
+    if (format != "auto" && format != "bc1" && format != "bc3" && format != "bc7" && format != "rgba") return usage();
+    if (quality != "fast" && quality != "normal" && quality != "high") return usage();
+    BCQuality bcQuality = quality == "fast" ? BCQuality::Fast : quality == "high" ? BCQuality::High : BCQuality::Normal;
+
+    int w, h, channels;
+    unsigned char* pixels = stbi_load(input.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        fprintf(stderr, "[TextureCook] Failed to load %s: %s\n", input.c_str(), stbi_failure_reason());
+        return 1;
+    }
+    uint32_t width = static_cast<uint32_t>(w);
+    uint32_t height = static_cast<uint32_t>(h);
+    std::vector<uint8_t> rgba(pixels, pixels + size_t(width) * height * 4);
+    stbi_image_free(pixels);
+
+    if (format == "auto") {
+        bool hasAlpha = false;
+        for (size_t i = 3; i < rgba.size() && !hasAlpha; i += 4) hasAlpha = rgba[i] < 255;
+        format = hasAlpha ? "bc3" : "bc1";
+    }
+
+    VkFormat vkFormat;
+    if (format == "bc1") vkFormat = linear ? VK_FORMAT_BC1_RGB_UNORM_BLOCK : VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+    else if (format == "bc3") vkFormat = linear ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC3_SRGB_BLOCK;
+    else if (format == "bc7") vkFormat = linear ? VK_FORMAT_BC7_UNORM_BLOCK : VK_FORMAT_BC7_SRGB_BLOCK;
+    else vkFormat = linear ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB;
+
+    BCFormat bcFormat = format == "bc7" ? BCFormat::BC7 : format == "bc3" ? BCFormat::BC3 : BCFormat::BC1;
+    std::vector<std::vector<uint8_t>> levels;
+    std::vector<uint8_t> level = rgba;
+    uint32_t levelWidth = width, levelHeight = height;
+    size_t totalBytes = 0;
+    while (true) {
+        if (format == "rgba") levels.push_back(level);
+        else levels.push_back(bc_encode_image(level.data(), levelWidth, levelHeight, bcFormat, bcQuality));
+        totalBytes += levels.back().size();
+        if (!mips || (levelWidth == 1 && levelHeight == 1)) break;
+        level = bc_downsample(level.data(), levelWidth, levelHeight, !linear, levelWidth, levelHeight);
+    }
+
+    if (!write_ktx2(output, vkFormat, width, height, levels)) {
+        fprintf(stderr, "[TextureCook] Failed to write %s\n", output.c_str());
+        return 1;
+    }
+
+    // Versus the RGBA8 + runtime mip chain loadTexture() would otherwise build
+    double rgbaBytes = width * height * 4.0 * (mips ? 4.0 / 3.0 : 1.0);
+    printf("[TextureCook] %s -> %s (%ux%u, %s, %zu mips, %.1f KB, %.1fx smaller than RGBA8)\n",
+           input.c_str(), output.c_str(), width, height, format.c_str(), levels.size(),
+           totalBytes / 1024.0, rgbaBytes / std::max<size_t>(totalBytes, 1));
+    return 0;
+}
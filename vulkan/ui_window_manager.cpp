@@ -1,11 +1,29 @@
 // UI Window Manager Implementation
 // Creates separate SDL3 windows with ImGui for game interfaces (HUD, menus, inventory, etc.)
+//
+// The window runs on its own thread with its own event pump and frame rate
+// cap, so tool and inventory windows cost the game loop nothing. State goes
+// through a double-buffered snapshot: the game sets values between frames,
+// ui_manager_update() publishes a copy under one lock, and the UI thread
+// picks up the newest copy when it starts its next frame. The UI thread
+// answers through a message queue (ui_manager_poll_message()).
+//
+// macOS only allows windows on the main thread, and without a per-thread
+// ImGui context (imgui_thread_context.h) the two threads would switch each
+// other's context, so those builds pump and draw inline in update()/render().
 
 #include "../stdlib/ui_window_manager.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <cstring>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <chrono>
 
 // Check if UI windows are enabled via compile-time flag or runtime config
 #ifdef ENABLE_UI_WINDOWS
@@ -33,22 +51,61 @@
     #endif
 #endif
 
+// Run the window on its own thread where SDL and ImGui allow it
+#if !defined(__APPLE__) && (!defined(USE_IMGUI) || defined(EDEN_IMGUI_THREAD_CONTEXT))
+    #define UI_WINDOW_THREADED 1
+#else
+    #define UI_WINDOW_THREADED 0
+#endif
+
+#if defined(USE_IMGUI) && defined(EDEN_IMGUI_THREAD_CONTEXT)
+// Each thread's current ImGui context (see imgui_thread_context.h)
+thread_local ImGuiContext* EdenImGuiContext = nullptr;
+#endif
+
 // Global state
 static bool g_uiManagerEnabled = UI_WINDOWS_ENABLED_BY_DEFAULT;
 static bool g_uiManagerInitialized = false;
 
-#ifdef USE_SDL3_UI
+#if defined(USE_SDL3_UI) || defined(USE_SDL2_UI)
+// Owned by the UI thread (the main thread in inline builds)
 static SDL_Window* g_uiWindow = nullptr;
 static SDL_Renderer* g_uiRenderer = nullptr;
 #ifdef USE_IMGUI
 static ImGuiContext* g_uiImGuiContext = nullptr;
 #endif
-#elif defined(USE_SDL2_UI)
-static SDL_Window* g_uiWindow = nullptr;
-static SDL_Renderer* g_uiRenderer = nullptr;
-#ifdef USE_IMGUI
-static ImGuiContext* g_uiImGuiContext = nullptr;
 #endif
+
+// One value the game shows in the UI window
+struct UiValue {
+    std::string key;
+    std::string text;
+    float number = 0.0f;
+    bool isText = false;
+};
+
+// Everything the UI window reads from the game
+struct UiSnapshot {
+    std::vector<UiValue> values;
+    uint64_t gameFrame = 0;
+    float gameFrameMs = 0.0f;
+};
+
+static UiSnapshot g_gameSnapshot;         // Game thread: edited by ui_manager_set_*()
+static UiSnapshot g_uiSnapshot;           // UI thread: what the window draws
+static std::chrono::steady_clock::time_point g_lastGameUpdate;
+
+// Shared between the game and UI threads, guarded by g_uiMutex
+static std::mutex g_uiMutex;
+static UiSnapshot g_publishedSnapshot;
+static uint64_t g_publishedVersion = 0;
+static std::deque<std::string> g_uiMessages;
+
+static std::atomic<int> g_uiFrameRateCap{30};
+#if UI_WINDOW_THREADED
+static std::thread g_uiThread;
+static std::atomic<bool> g_uiThreadStop{false};
+static uint64_t g_uiSnapshotVersion = 0;  // UI thread
 #endif
 
 // Helper function to convert string to lowercase
@@ -73,7 +130,7 @@ static bool readProjectConfig() {
             return UI_WINDOWS_ENABLED_BY_DEFAULT;
         }
     }
-    
+
     std::string line;
     while (std::getline(configFile, line)) {
         // Parse "enable_ui_windows=true" or "enable_ui_windows=False" (case-insensitive)
@@ -87,94 +144,56 @@ static bool readProjectConfig() {
             }
         }
     }
-    
+
     return UI_WINDOWS_ENABLED_BY_DEFAULT;
 }
 
-extern "C" bool ui_manager_is_enabled() {
-    // Read config on first call if not yet initialized
-    static bool configRead = false;
-    if (!configRead) {
-        g_uiManagerEnabled = readProjectConfig();
-        configRead = true;
-        std::cout << "[UI Manager] Config read: UI windows " << (g_uiManagerEnabled ? "enabled" : "disabled") << std::endl;
+// Find or add the game-side value for a key
+static UiValue& gameValue(const char* key) {
+    for (UiValue& value : g_gameSnapshot.values) {
+        if (value.key == key) {
+            return value;
+        }
     }
-    return g_uiManagerEnabled;
+    g_gameSnapshot.values.push_back(UiValue());
+    g_gameSnapshot.values.back().key = key;
+    return g_gameSnapshot.values.back();
 }
 
-extern "C" bool ui_manager_init() {
-    if (g_uiManagerInitialized) {
-        std::cout << "[UI Manager] Already initialized" << std::endl;
-        return true;
-    }
-    
-    // Check if UI windows are enabled (this will read config on first call)
-    if (!ui_manager_is_enabled()) {
-        std::cout << "[UI Manager] UI windows disabled in project config" << std::endl;
-        return false;
+// Queue a message for the game (called from the UI thread)
+static void postUiMessage(const char* message) {
+    std::lock_guard<std::mutex> lock(g_uiMutex);
+    // Drop the oldest if the game never polls
+    if (g_uiMessages.size() >= 256) {
+        g_uiMessages.pop_front();
     }
-    
+    g_uiMessages.push_back(message);
+}
+
+#if defined(USE_SDL3_UI) || defined(USE_SDL2_UI)
+
+// Create the SDL window, renderer and ImGui context on the calling thread
+static bool createUiWindow() {
 #ifdef USE_SDL3_UI
     std::cout << "[UI Manager] Initializing SDL3 UI windows..." << std::endl;
-    
-    // Initialize SDL3
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+
+    // Initialize only SDL3 video, so shutdown leaves audio running
+    if (!SDL_InitSubSystem(SDL_INIT_VIDEO)) {
         std::cerr << "[UI Manager] ERROR: Failed to initialize SDL3: " << SDL_GetError() << std::endl;
         return false;
     }
-    
+
     // Create SDL3 window for UI
     g_uiWindow = SDL_CreateWindow("EDEN UI Window", 400, 600, SDL_WINDOW_RESIZABLE);
-    
-    if (!g_uiWindow) {
-        std::cerr << "[UI Manager] ERROR: Failed to create SDL3 window: " << SDL_GetError() << std::endl;
-        SDL_Quit();
-        return false;
-    }
-    
-    // Position UI window next to the main Vulkan window (800px wide, so position at x=800)
-    SDL_SetWindowPosition(g_uiWindow, 800, 0);
-    
-    // Create SDL3 renderer (SDL3 API: window, driver name (nullptr = default))
-    g_uiRenderer = SDL_CreateRenderer(g_uiWindow, nullptr);
-    if (!g_uiRenderer) {
-        std::cerr << "[UI Manager] ERROR: Failed to create SDL3 renderer: " << SDL_GetError() << std::endl;
-        SDL_DestroyWindow(g_uiWindow);
-        SDL_Quit();
-        return false;
-    }
-    
-#ifdef USE_IMGUI
-    // Setup ImGui context for UI window
-    IMGUI_CHECKVERSION();
-    g_uiImGuiContext = ImGui::CreateContext();
-    ImGui::SetCurrentContext(g_uiImGuiContext);
-    
-    ImGuiIO& io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-    
-    // Setup ImGui style
-    ImGui::StyleColorsDark();
-    
-    // Setup Platform/Renderer backends for SDL3
-    ImGui_ImplSDL3_InitForSDLRenderer(g_uiWindow, g_uiRenderer);
-    ImGui_ImplSDLRenderer3_Init(g_uiRenderer);
-    
-    std::cout << "[UI Manager] ImGui initialized for SDL3 window" << std::endl;
-#endif
-    
-    g_uiManagerInitialized = true;
-    std::cout << "[UI Manager] Initialized successfully!" << std::endl;
-    return true;
-#elif defined(USE_SDL2_UI)
+#else
     std::cout << "[UI Manager] Initializing SDL2 UI windows..." << std::endl;
-    
-    // Initialize SDL2
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+
+    // Initialize only SDL2 video, so shutdown leaves audio running
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
         std::cerr << "[UI Manager] ERROR: Failed to initialize SDL2: " << SDL_GetError() << std::endl;
         return false;
     }
-    
+
     // Create SDL2 window for UI
     g_uiWindow = SDL_CreateWindow(
         "EDEN UI Window",
@@ -183,220 +202,364 @@ extern "C" bool ui_manager_init() {
         400, 600,
         SDL_WINDOW_RESIZABLE
     );
-    
+#endif
+
     if (!g_uiWindow) {
-        std::cerr << "[UI Manager] ERROR: Failed to create SDL2 window: " << SDL_GetError() << std::endl;
-        SDL_Quit();
+        std::cerr << "[UI Manager] ERROR: Failed to create SDL window: " << SDL_GetError() << std::endl;
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
         return false;
     }
-    
+
     // Position UI window next to the main Vulkan window (800px wide, so position at x=800)
     SDL_SetWindowPosition(g_uiWindow, 800, 0);
-    
+
+#ifdef USE_SDL3_UI
+    // Create SDL3 renderer (SDL3 API: window, driver name (nullptr = default))
+    g_uiRenderer = SDL_CreateRenderer(g_uiWindow, nullptr);
+#else
     // Create SDL2 renderer
     g_uiRenderer = SDL_CreateRenderer(g_uiWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+#endif
     if (!g_uiRenderer) {
-        std::cerr << "[UI Manager] ERROR: Failed to create SDL2 renderer: " << SDL_GetError() << std::endl;
+        std::cerr << "[UI Manager] ERROR: Failed to create SDL renderer: " << SDL_GetError() << std::endl;
         SDL_DestroyWindow(g_uiWindow);
-        SDL_Quit();
+        g_uiWindow = nullptr;
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
         return false;
     }
-    
+
 #ifdef USE_IMGUI
-    // Setup ImGui context for UI window
+    // Setup ImGui context for UI window (current only on this thread)
     IMGUI_CHECKVERSION();
     g_uiImGuiContext = ImGui::CreateContext();
     ImGui::SetCurrentContext(g_uiImGuiContext);
-    
+
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-    
+
     // Setup ImGui style
     ImGui::StyleColorsDark();
-    
-    // Setup Platform/Renderer backends for SDL2
+
+#ifdef USE_SDL3_UI
+    ImGui_ImplSDL3_InitForSDLRenderer(g_uiWindow, g_uiRenderer);
+    ImGui_ImplSDLRenderer3_Init(g_uiRenderer);
+#else
     ImGui_ImplSDL2_InitForSDLRenderer(g_uiWindow, g_uiRenderer);
     ImGui_ImplSDLRenderer2_Init(g_uiRenderer);
-    
-    std::cout << "[UI Manager] ImGui initialized for SDL2 window" << std::endl;
 #endif
-    
-    g_uiManagerInitialized = true;
-    std::cout << "[UI Manager] Initialized successfully!" << std::endl;
-    return true;
-#else
-    std::cout << "[UI Manager] WARNING: SDL3/SDL2 UI support not compiled in (USE_SDL3_UI or USE_SDL2_UI not defined)" << std::endl;
-    std::cout << "[UI Manager] UI windows disabled" << std::endl;
-    g_uiManagerEnabled = false;
-    return false;
+
+    std::cout << "[UI Manager] ImGui initialized for SDL window" << std::endl;
 #endif
+    return true;
 }
 
-extern "C" void ui_manager_update() {
-    if (!g_uiManagerInitialized || !g_uiManagerEnabled) {
-        return;
-    }
-    
-#ifdef USE_SDL3_UI
-    // Process SDL3 events
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
+// Destroy what createUiWindow() made, on the same thread
+static void destroyUiWindow() {
 #ifdef USE_IMGUI
-        ImGui_ImplSDL3_ProcessEvent(&event);
+    if (g_uiImGuiContext) {
+        ImGui::SetCurrentContext(g_uiImGuiContext);
+#ifdef USE_SDL3_UI
+        ImGui_ImplSDLRenderer3_Shutdown();
+        ImGui_ImplSDL3_Shutdown();
+#else
+        ImGui_ImplSDLRenderer2_Shutdown();
+        ImGui_ImplSDL2_Shutdown();
 #endif
-        // SDL3 uses different event types - check for window close events
-        if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
-            // Window close requested - could signal shutdown or just hide window
-            // For now, we'll just continue (window stays open)
-        }
-    }
-    
-#ifdef USE_IMGUI
-    // Start new ImGui frame
-    ImGui_ImplSDLRenderer3_NewFrame();
-    ImGui_ImplSDL3_NewFrame();
-    ImGui::NewFrame();
-    
-    // Example UI window (can be customized by game code)
-    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
-    ImGui::SetNextWindowSize(ImVec2(380, 580), ImGuiCond_FirstUseEver);
-    
-    if (ImGui::Begin("EDEN UI Window", nullptr, ImGuiWindowFlags_None)) {
-        ImGui::Text("UI Window Manager");
-        ImGui::Separator();
-        ImGui::Text("This is a separate UI window!");
-        ImGui::Text("You can add HUD, menus, inventory, etc. here.");
-        ImGui::Separator();
-        ImGui::Text("Application average %.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
+        ImGui::DestroyContext(g_uiImGuiContext);
+        g_uiImGuiContext = nullptr;
     }
-    ImGui::End();
 #endif
-#elif defined(USE_SDL2_UI)
-    // Process SDL2 events
+
+    if (g_uiRenderer) {
+        SDL_DestroyRenderer(g_uiRenderer);
+        g_uiRenderer = nullptr;
+    }
+
+    if (g_uiWindow) {
+        SDL_DestroyWindow(g_uiWindow);
+        g_uiWindow = nullptr;
+    }
+
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+// Process window events; a close request becomes a "close" message
+static void pumpUiEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
 #ifdef USE_IMGUI
+#ifdef USE_SDL3_UI
+        ImGui_ImplSDL3_ProcessEvent(&event);
+#else
         ImGui_ImplSDL2_ProcessEvent(&event);
 #endif
-        if (event.type == SDL_QUIT) {
-            // Window closed - could signal shutdown or just hide window
-            // For now, we'll just continue (window stays open)
+#endif
+#ifdef USE_SDL3_UI
+        bool closeRequested = event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED;
+#else
+        bool closeRequested = event.type == SDL_QUIT ||
+            (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE);
+#endif
+        if (closeRequested) {
+            // The window stays open; the game decides what closing means
+            postUiMessage("close");
         }
     }
-    
+}
+
+// Build this frame's ImGui windows from g_uiSnapshot
+static void buildUiFrame() {
 #ifdef USE_IMGUI
+    ImGui::SetCurrentContext(g_uiImGuiContext);
+
     // Start new ImGui frame
+#ifdef USE_SDL3_UI
+    ImGui_ImplSDLRenderer3_NewFrame();
+    ImGui_ImplSDL3_NewFrame();
+#else
     ImGui_ImplSDLRenderer2_NewFrame();
     ImGui_ImplSDL2_NewFrame();
+#endif
     ImGui::NewFrame();
-    
+
     // Example UI window (can be customized by game code)
     ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowSize(ImVec2(380, 580), ImGuiCond_FirstUseEver);
-    
+
     if (ImGui::Begin("EDEN UI Window", nullptr, ImGuiWindowFlags_None)) {
         ImGui::Text("UI Window Manager");
         ImGui::Separator();
-        ImGui::Text("This is a separate UI window!");
-        ImGui::Text("You can add HUD, menus, inventory, etc. here.");
-        ImGui::Separator();
-        ImGui::Text("Application average %.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
+        ImGui::Text("Game frame %llu, %.3f ms/frame", (unsigned long long)g_uiSnapshot.gameFrame,
+                    g_uiSnapshot.gameFrameMs);
+        ImGui::Text("UI window %.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
+        if (!g_uiSnapshot.values.empty()) {
+            ImGui::Separator();
+        }
+        for (const UiValue& value : g_uiSnapshot.values) {
+            if (value.isText) {
+                ImGui::Text("%s: %s", value.key.c_str(), value.text.c_str());
+            } else {
+                ImGui::Text("%s: %.3f", value.key.c_str(), value.number);
+            }
+        }
     }
     ImGui::End();
 #endif
-#endif
 }
 
-extern "C" void ui_manager_render() {
-    if (!g_uiManagerInitialized || !g_uiManagerEnabled) {
-        return;
-    }
-    
-#ifdef USE_SDL3_UI
+// Render and present the frame built by buildUiFrame()
+static void presentUiFrame() {
 #ifdef USE_IMGUI
     // Render ImGui
     ImGui::Render();
-    
+
     // Clear renderer
     SDL_SetRenderDrawColor(g_uiRenderer, 30, 30, 40, 255);
     SDL_RenderClear(g_uiRenderer);
-    
+
     // Render ImGui draw data
+#ifdef USE_SDL3_UI
     ImGui_ImplSDLRenderer3_RenderDrawData(ImGui::GetDrawData(), g_uiRenderer);
-    
-    // Present
-    SDL_RenderPresent(g_uiRenderer);
-#endif
-#elif defined(USE_SDL2_UI)
-#ifdef USE_IMGUI
-    // Render ImGui
-    ImGui::Render();
-    
-    // Clear renderer
-    SDL_SetRenderDrawColor(g_uiRenderer, 30, 30, 40, 255);
-    SDL_RenderClear(g_uiRenderer);
-    
-    // Render ImGui draw data
+#else
     ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData());
-    
+#endif
+
     // Present
     SDL_RenderPresent(g_uiRenderer);
 #endif
-#endif
 }
 
-extern "C" void ui_manager_shutdown() {
-    if (!g_uiManagerInitialized) {
+#if UI_WINDOW_THREADED
+// UI thread: owns the window from creation to destruction and draws at
+// its own rate, independent of the game loop
+static void uiThreadMain(std::promise<bool> ready) {
+    bool created = createUiWindow();
+    ready.set_value(created);
+    if (!created) {
         return;
     }
-    
-#ifdef USE_SDL3_UI
-#ifdef USE_IMGUI
-    if (g_uiImGuiContext) {
-        ImGui::SetCurrentContext(g_uiImGuiContext);
-        ImGui_ImplSDLRenderer3_Shutdown();
-        ImGui_ImplSDL3_Shutdown();
-        ImGui::DestroyContext(g_uiImGuiContext);
-        g_uiImGuiContext = nullptr;
+
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (!g_uiThreadStop.load()) {
+        pumpUiEvents();
+
+        // Pick up the newest published snapshot, if any
+        {
+            std::lock_guard<std::mutex> lock(g_uiMutex);
+            if (g_uiSnapshotVersion != g_publishedVersion) {
+                g_uiSnapshot = g_publishedSnapshot;
+                g_uiSnapshotVersion = g_publishedVersion;
+            }
+        }
+
+        buildUiFrame();
+        presentUiFrame();
+
+        // Frame rate cap (0 = uncapped; a late frame doesn't make the next ones hurry)
+        int cap = g_uiFrameRateCap.load();
+        if (cap > 0) {
+            nextFrame += std::chrono::microseconds(1000000 / cap);
+            auto now = std::chrono::steady_clock::now();
+            if (nextFrame < now) {
+                nextFrame = now;
+            } else {
+                std::this_thread::sleep_until(nextFrame);
+            }
+        }
     }
+
+    destroyUiWindow();
+}
 #endif
-    
-    if (g_uiRenderer) {
-        SDL_DestroyRenderer(g_uiRenderer);
-        g_uiRenderer = nullptr;
+
+#endif // USE_SDL3_UI || USE_SDL2_UI
+
+extern "C" bool ui_manager_is_enabled() {
+    // Read config on first call if not yet initialized
+    static bool configRead = false;
+    if (!configRead) {
+        g_uiManagerEnabled = readProjectConfig();
+        configRead = true;
+        std::cout << "[UI Manager] Config read: UI windows " << (g_uiManagerEnabled ? "enabled" : "disabled") << std::endl;
     }
-    
-    if (g_uiWindow) {
-        SDL_DestroyWindow(g_uiWindow);
-        g_uiWindow = nullptr;
+    return g_uiManagerEnabled;
+}
+
+extern "C" bool ui_manager_init() {
+    if (g_uiManagerInitialized) {
+        std::cout << "[UI Manager] Already initialized" << std::endl;
+        return true;
     }
-    
-    SDL_Quit();
-#elif defined(USE_SDL2_UI)
-#ifdef USE_IMGUI
-    if (g_uiImGuiContext) {
-        ImGui::SetCurrentContext(g_uiImGuiContext);
-        ImGui_ImplSDLRenderer2_Shutdown();
-        ImGui_ImplSDL2_Shutdown();
-        ImGui::DestroyContext(g_uiImGuiContext);
-        g_uiImGuiContext = nullptr;
+
+    // Check if UI windows are enabled (this will read config on first call)
+    if (!ui_manager_is_enabled()) {
+        std::cout << "[UI Manager] UI windows disabled in project config" << std::endl;
+        return false;
+    }
+
+#if defined(USE_SDL3_UI) || defined(USE_SDL2_UI)
+#if UI_WINDOW_THREADED
+    // The window is created on the thread that will pump and draw it
+    std::promise<bool> ready;
+    std::future<bool> created = ready.get_future();
+    g_uiThreadStop = false;
+    g_uiThread = std::thread(uiThreadMain, std::move(ready));
+    if (!created.get()) {
+        g_uiThread.join();
+        return false;
+    }
+    std::cout << "[UI Manager] UI window running on its own thread (" << g_uiFrameRateCap.load() << " fps cap)" << std::endl;
+#else
+    if (!createUiWindow()) {
+        return false;
     }
 #endif
-    
-    if (g_uiRenderer) {
-        SDL_DestroyRenderer(g_uiRenderer);
-        g_uiRenderer = nullptr;
+
+    g_lastGameUpdate = std::chrono::steady_clock::now();
+    g_uiManagerInitialized = true;
+    std::cout << "[UI Manager] Initialized successfully!" << std::endl;
+    return true;
+#else
+    std::cout << "[UI Manager] WARNING: SDL3/SDL2 UI support not compiled in (USE_SDL3_UI or USE_SDL2_UI not defined)" << std::endl;
+    std::cout << "[UI Manager] UI windows disabled" << std::endl;
+    g_uiManagerEnabled = false;
+    return false;
+#endif
+}
+
+extern "C" void ui_manager_update() {
+    if (!g_uiManagerInitialized || !g_uiManagerEnabled) {
+        return;
     }
-    
-    if (g_uiWindow) {
-        SDL_DestroyWindow(g_uiWindow);
-        g_uiWindow = nullptr;
+
+    auto now = std::chrono::steady_clock::now();
+    g_gameSnapshot.gameFrameMs = std::chrono::duration<float, std::milli>(now - g_lastGameUpdate).count();
+    g_gameSnapshot.gameFrame++;
+    g_lastGameUpdate = now;
+
+#if UI_WINDOW_THREADED
+    // Publish this frame's values; the UI thread copies them when it next draws
+    {
+        std::lock_guard<std::mutex> lock(g_uiMutex);
+        g_publishedSnapshot = g_gameSnapshot;
+        g_publishedVersion++;
+    }
+#elif defined(USE_SDL3_UI) || defined(USE_SDL2_UI)
+    pumpUiEvents();
+    g_uiSnapshot = g_gameSnapshot;
+    buildUiFrame();
+#endif
+}
+
+extern "C" void ui_manager_render() {
+    if (!g_uiManagerInitialized || !g_uiManagerEnabled) {
+        return;
     }
-    
-    SDL_Quit();
+
+    // The UI thread presents on its own; inline builds present here
+#if !UI_WINDOW_THREADED && (defined(USE_SDL3_UI) || defined(USE_SDL2_UI))
+    presentUiFrame();
 #endif
-    
+}
+
+extern "C" void ui_manager_set_text(const char* key, const char* text) {
+    if (!key) {
+        return;
+    }
+    UiValue& value = gameValue(key);
+    value.text = text ? text : "";
+    value.isText = true;
+}
+
+extern "C" void ui_manager_set_float(const char* key, float number) {
+    if (!key) {
+        return;
+    }
+    UiValue& value = gameValue(key);
+    value.number = number;
+    value.isText = false;
+}
+
+extern "C" void ui_manager_set_frame_rate(int fps) {
+    g_uiFrameRateCap = fps > 0 ? fps : 0;
+}
+
+extern "C" bool ui_manager_poll_message(char* buffer, int bufferSize) {
+    if (!buffer || bufferSize <= 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(g_uiMutex);
+    if (g_uiMessages.empty()) {
+        return false;
+    }
+    strncpy(buffer, g_uiMessages.front().c_str(), bufferSize - 1);
+    buffer[bufferSize - 1] = '\0';
+    g_uiMessages.pop_front();
+    return true;
+}
+
+extern "C" void ui_manager_shutdown() {
+    if (!g_uiManagerInitialized) {
+        return;
+    }
+
+#if defined(USE_SDL3_UI) || defined(USE_SDL2_UI)
+#if UI_WINDOW_THREADED
+    // The UI thread destroys its window on the way out
+    g_uiThreadStop = true;
+    if (g_uiThread.joinable()) {
+        g_uiThread.join();
+    }
+#else
+    destroyUiWindow();
+#endif
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(g_uiMutex);
+        g_uiMessages.clear();
+    }
+
     g_uiManagerInitialized = false;
     std::cout << "[UI Manager] Shutdown complete" << std::endl;
 }
-
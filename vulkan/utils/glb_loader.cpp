@@ -3,11 +3,19 @@
 // ============================================================================
 
 #include "glb_loader.h"
+#include "mesh_cache.h"
+#include "../../stdlib/vfs.h"
+#include "../../stdlib/job_system.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 
 // stb_image for decoding embedded textures (already defined in vulkan_core.cpp)
 #include "../../stdlib/stb_image.h"
+#include "../../stdlib/image_decode.h"
 
 // Check if cgltf is available
 #if __has_include("../../third_party/cgltf/cgltf.h")
@@ -18,6 +26,10 @@
 #define HAS_CGLTF 0
 #endif
 
+#ifdef EDEN_USE_MESHOPT
+#include <meshoptimizer.h>
+#endif
+
 namespace eden {
 
 // ============================================================================
@@ -44,6 +56,8 @@ void GLBModel::clear() {
     name.clear();
     meshes.clear();
     textures.clear();
+    skeleton = vkcore::Skeleton();
+    animations.clear();
 }
 
 // ============================================================================
@@ -58,19 +72,714 @@ bool isGLBSupported() {
 #endif
 }
 
+// ============================================================================
+// Mesh cache
+// ============================================================================
+// A cache entry holds the finished GLBModel (decoded textures included), so
+// a hit skips cgltf, stb_image and LOD building. Only self-contained .glb
+// files are cached: the key hashes the one file, and a .gltf's external
+// buffers could change under it.
+
+// Bump when GLBVertex, the import or the section layout changes
+static constexpr uint64_t GLB_CACHE_VERSION = 3;
+
+// Builds with and without meshoptimizer order vertices differently
+#ifdef EDEN_USE_MESHOPT
+static constexpr uint64_t GLB_CACHE_MESHOPT = 1;
+#else
+static constexpr uint64_t GLB_CACHE_MESHOPT = 0;
+#endif
+
+struct GLBCacheModelMeta {
+    uint32_t vertexStride;
+    uint32_t meshCount;
+    uint32_t textureCount;
+};
+
+// Sections per texture: meta, name, pixels
+struct GLBCacheTextureMeta {
+    uint32_t width;
+    uint32_t height;
+    uint32_t valid;
+};
+
+// Sections per mesh: meta, name, vertices, indices, lodIndices, lods, skinWeights
+struct GLBCacheMeshMeta {
+    int32_t textureIndex;
+    uint32_t hasNormals;
+    uint32_t hasUV1;
+    int32_t skin;
+};
+
+// Then the skeleton and clips, GLB_CACHE_SKELETON_SECTIONS of them: nodes,
+// node names, skin joint counts, skin names, joints, inverse binds, clips,
+// clip names, channels, key times, key values. Names are '\0'-joined and
+// the variable-length arrays concatenated in order.
+static constexpr uint32_t GLB_CACHE_SKELETON_SECTIONS = 11;
+
+struct GLBCacheNode {
+    int32_t parent;
+    float translation[3];
+    float rotation[4];
+    float scale[3];
+};
+
+struct GLBCacheClip {
+    uint32_t channelCount;
+    float duration;
+};
+
+struct GLBCacheChannel {
+    uint32_t node;
+    uint32_t path;
+    uint32_t step;
+    uint32_t keyCount;
+};
+
+static std::string joinNames(const std::vector<const std::string*>& names) {
+    std::string joined;
+    for (const std::string* name : names) {
+        joined += *name;
+        joined += '\0';
+    }
+    return joined;
+}
+
+static bool splitNames(const std::string& joined, size_t count, std::vector<std::string>& names) {
+    names.clear();
+    size_t start = 0;
+    while (names.size() < count) {
+        size_t end = joined.find('\0', start);
+        if (end == std::string::npos) return false;
+        names.push_back(joined.substr(start, end - start));
+        start = end + 1;
+    }
+    return start == joined.size();
+}
+
+static void writeSkeletonSections(MeshCacheWriter& writer, const GLBModel& model) {
+    const vkcore::Skeleton& skeleton = model.skeleton;
+    std::vector<GLBCacheNode> nodes;
+    std::vector<const std::string*> nodeNames;
+    for (const vkcore::SkeletonNode& node : skeleton.nodes) {
+        GLBCacheNode entry = {node.parent,
+                              {node.translation.x, node.translation.y, node.translation.z},
+                              {node.rotation.x, node.rotation.y, node.rotation.z, node.rotation.w},
+                              {node.scale.x, node.scale.y, node.scale.z}};
+        nodes.push_back(entry);
+        nodeNames.push_back(&node.name);
+    }
+    std::vector<uint32_t> jointCounts, joints;
+    std::vector<const std::string*> skinNames;
+    std::vector<glm::mat4> inverseBinds;
+    for (const vkcore::Skin& skin : skeleton.skins) {
+        jointCounts.push_back(static_cast<uint32_t>(skin.joints.size()));
+        skinNames.push_back(&skin.name);
+        joints.insert(joints.end(), skin.joints.begin(), skin.joints.end());
+        for (size_t j = 0; j < skin.joints.size(); ++j) {
+            inverseBinds.push_back(j < skin.inverseBind.size() ? skin.inverseBind[j] : glm::mat4(1.0f));
+        }
+    }
+    std::vector<GLBCacheClip> clips;
+    std::vector<const std::string*> clipNames;
+    std::vector<GLBCacheChannel> channels;
+    std::vector<float> times;
+    std::vector<glm::vec4> values;
+    for (const vkcore::AnimationClip& clip : model.animations) {
+        clips.push_back({static_cast<uint32_t>(clip.channels.size()), clip.duration});
+        clipNames.push_back(&clip.name);
+        for (const vkcore::AnimationChannel& channel : clip.channels) {
+            channels.push_back({channel.node, static_cast<uint32_t>(channel.path), channel.step ? 1u : 0u,
+                                static_cast<uint32_t>(channel.times.size())});
+            times.insert(times.end(), channel.times.begin(), channel.times.end());
+            values.insert(values.end(), channel.values.begin(), channel.values.begin() + channel.times.size());
+        }
+    }
+    writer.add(nodes);
+    writer.add(joinNames(nodeNames));
+    writer.add(jointCounts);
+    writer.add(joinNames(skinNames));
+    writer.add(joints);
+    writer.add(inverseBinds);
+    writer.add(clips);
+    writer.add(joinNames(clipNames));
+    writer.add(channels);
+    writer.add(times);
+    writer.add(values);
+}
+
+static bool readSkeletonSections(const MeshCacheReader& reader, uint32_t section, GLBModel& model) {
+    std::vector<GLBCacheNode> nodes;
+    std::vector<uint32_t> jointCounts, joints;
+    std::vector<glm::mat4> inverseBinds;
+    std::vector<GLBCacheClip> clips;
+    std::vector<GLBCacheChannel> channels;
+    std::vector<float> times;
+    std::vector<glm::vec4> values;
+    std::string nodeNames, skinNames, clipNames;
+    if (!reader.read(section, nodes) || !reader.read(section + 1, nodeNames) ||
+        !reader.read(section + 2, jointCounts) || !reader.read(section + 3, skinNames) ||
+        !reader.read(section + 4, joints) || !reader.read(section + 5, inverseBinds) ||
+        !reader.read(section + 6, clips) || !reader.read(section + 7, clipNames) ||
+        !reader.read(section + 8, channels) || !reader.read(section + 9, times) ||
+        !reader.read(section + 10, values) || joints.size() != inverseBinds.size() ||
+        times.size() != values.size()) {
+        return false;
+    }
+    std::vector<std::string> names;
+    
+    vkcore::Skeleton& skeleton = model.skeleton;
+    if (!splitNames(nodeNames, nodes.size(), names)) return false;
+    skeleton.nodes.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const GLBCacheNode& entry = nodes[i];
+        vkcore::SkeletonNode& node = skeleton.nodes[i];
+        if (entry.parent >= static_cast<int32_t>(i)) return false;
+        node.name = std::move(names[i]);
+        node.parent = entry.parent;
+        node.translation = glm::vec3(entry.translation[0], entry.translation[1], entry.translation[2]);
+        node.rotation = glm::vec4(entry.rotation[0], entry.rotation[1], entry.rotation[2], entry.rotation[3]);
+        node.scale = glm::vec3(entry.scale[0], entry.scale[1], entry.scale[2]);
+    }
+    
+    if (!splitNames(skinNames, jointCounts.size(), names)) return false;
+    size_t joint = 0;
+    skeleton.skins.resize(jointCounts.size());
+    for (size_t i = 0; i < jointCounts.size(); ++i) {
+        vkcore::Skin& skin = skeleton.skins[i];
+        if (joint + jointCounts[i] > joints.size()) return false;
+        skin.name = std::move(names[i]);
+        skin.joints.assign(joints.begin() + joint, joints.begin() + joint + jointCounts[i]);
+        skin.inverseBind.assign(inverseBinds.begin() + joint, inverseBinds.begin() + joint + jointCounts[i]);
+        joint += jointCounts[i];
+    }
+    
+    if (!splitNames(clipNames, clips.size(), names)) return false;
+    size_t channel = 0, key = 0;
+    model.animations.resize(clips.size());
+    for (size_t i = 0; i < clips.size(); ++i) {
+        vkcore::AnimationClip& clip = model.animations[i];
+        if (channel + clips[i].channelCount > channels.size()) return false;
+        clip.name = std::move(names[i]);
+        clip.duration = clips[i].duration;
+        clip.channels.resize(clips[i].channelCount);
+        for (vkcore::AnimationChannel& out : clip.channels) {
+            const GLBCacheChannel& entry = channels[channel++];
+            if (key + entry.keyCount > times.size()) return false;
+            out.node = entry.node;
+            out.path = static_cast<vkcore::AnimationPath>(entry.path);
+            out.step = entry.step != 0;
+            out.times.assign(times.begin() + key, times.begin() + key + entry.keyCount);
+            out.values.assign(values.begin() + key, values.begin() + key + entry.keyCount);
+            key += entry.keyCount;
+        }
+    }
+    return true;
+}
+
+static bool isSelfContainedGLB(const std::string& path) {
+    if (path.size() < 4) return false;
+    std::string ext = path.substr(path.size() - 4);
+    for (char& c : ext) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return ext == ".glb";
+}
+
+static bool readGLBCache(const std::string& cachePath, uint64_t key, GLBModel& model) {
+    MeshCacheReader reader;
+    GLBCacheModelMeta meta = {};
+    if (!reader.open(cachePath, key, MESH_CACHE_KIND_GLB) || !reader.read(0, meta) ||
+        meta.vertexStride != sizeof(GLBVertex) ||
+        reader.sectionCount() != 1 + meta.textureCount * 3 + meta.meshCount * 7 + GLB_CACHE_SKELETON_SECTIONS) {
+        return false;
+    }
+    uint32_t section = 1;
+    model.textures.resize(meta.textureCount);
+    for (GLBTexture& tex : model.textures) {
+        GLBCacheTextureMeta texMeta = {};
+        if (!reader.read(section++, texMeta) || !reader.read(section++, tex.name) ||
+            !reader.read(section++, tex.pixels)) {
+            return false;
+        }
+        tex.width = texMeta.width;
+        tex.height = texMeta.height;
+        tex.valid = texMeta.valid != 0;
+    }
+    model.meshes.resize(meta.meshCount);
+    for (GLBMesh& mesh : model.meshes) {
+        GLBCacheMeshMeta meshMeta = {};
+        if (!reader.read(section++, meshMeta) || !reader.read(section++, mesh.name) ||
+            !reader.read(section++, mesh.vertices) || !reader.read(section++, mesh.indices) ||
+            !reader.read(section++, mesh.lodIndices) || !reader.read(section++, mesh.lods) ||
+            !reader.read(section++, mesh.skinWeights)) {
+            return false;
+        }
+        mesh.textureIndex = meshMeta.textureIndex;
+        mesh.hasNormals = meshMeta.hasNormals != 0;
+        mesh.hasUV1 = meshMeta.hasUV1 != 0;
+        mesh.skin = meshMeta.skin;
+    }
+    return !model.meshes.empty() && readSkeletonSections(reader, section, model);
+}
+
+static void writeGLBCache(const std::string& cachePath, uint64_t key, const GLBModel& model) {
+    MeshCacheWriter writer;
+    GLBCacheModelMeta meta = {sizeof(GLBVertex), static_cast<uint32_t>(model.meshes.size()),
+                              static_cast<uint32_t>(model.textures.size())};
+    writer.add(&meta, sizeof(meta));
+    for (const GLBTexture& tex : model.textures) {
+        GLBCacheTextureMeta texMeta = {tex.width, tex.height, tex.valid};
+        writer.add(&texMeta, sizeof(texMeta));
+        writer.add(tex.name);
+        writer.add(tex.pixels);
+    }
+    for (const GLBMesh& mesh : model.meshes) {
+        GLBCacheMeshMeta meshMeta = {mesh.textureIndex, mesh.hasNormals, mesh.hasUV1, mesh.skin};
+        writer.add(&meshMeta, sizeof(meshMeta));
+        writer.add(mesh.name);
+        writer.add(mesh.vertices);
+        writer.add(mesh.indices);
+        writer.add(mesh.lodIndices);
+        writer.add(mesh.lods);
+        writer.add(mesh.skinWeights);
+    }
+    writeSkeletonSections(writer, model);
+    if (!writer.write(cachePath, key, MESH_CACHE_KIND_GLB)) {
+        std::cerr << "[GLB] Could not write mesh cache: " << cachePath << std::endl;
+    }
+}
+
+// Model name from the file name (not cached: identical files share an entry)
+static std::string modelNameFromPath(const std::string& path) {
+    size_t lastSlash = path.find_last_of("/\\");
+    size_t lastDot = path.find_last_of('.');
+    if (lastSlash == std::string::npos) lastSlash = 0; else lastSlash++;
+    if (lastDot == std::string::npos || lastDot < lastSlash) lastDot = path.length();
+    return path.substr(lastSlash, lastDot - lastSlash);
+}
+
+static bool importGLB(const std::string& path, GLBModel& model, bool generateLods);
+
+bool loadGLB(const std::string& path, GLBModel& model, bool generateLods) {
+    model.clear();
+    
+    uint64_t key = 0;
+    std::string cachePath;
+    uint64_t settings = (GLB_CACHE_VERSION << 32) | (GLB_CACHE_MESHOPT << 16) | (sizeof(GLBVertex) << 1) |
+                        (generateLods ? 1 : 0);
+    if (isSelfContainedGLB(path) && meshCacheKey(path, settings, key)) {
+        cachePath = meshCachePath(key, "glb");
+        if (readGLBCache(cachePath, key, model)) {
+            model.name = modelNameFromPath(path);
+            std::cout << "[GLB] Loaded from cache: " << path << " (" << model.meshes.size() << " meshes, "
+                      << model.totalVertices() << " verts, " << model.totalTriangles() << " tris)" << std::endl;
+            return true;
+        }
+        model.clear();
+    }
+    
+    if (!importGLB(path, model, generateLods)) return false;
+    if (!cachePath.empty()) writeGLBCache(cachePath, key, model);
+    return true;
+}
+
 // ============================================================================
 // GLB Loading
 // ============================================================================
 
 #if HAS_CGLTF
 
-bool loadGLB(const std::string& path, GLBModel& model) {
-    model.clear();
+// Positions are the first 3 floats of GLBVertex, so it can be read in place
+static void buildMeshLods(GLBMesh& mesh) {
+    uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    std::vector<uint32_t> all = vkcore::buildLodChain(&mesh.vertices[0].position.x,
+                                                      sizeof(GLBVertex) / sizeof(float), vertexCount,
+                                                      mesh.indices, mesh.lods);
+    mesh.lodIndices.assign(all.begin() + mesh.indices.size(), all.end());
+}
+
+// ============================================================================
+// Accessor reads
+// ============================================================================
+// Attributes go straight into their GLBVertex member, `components` floats at
+// sizeof(GLBVertex) apart. Plain float accessors (nearly every position,
+// normal and UV) are copied from the buffer with their own stride; anything
+// else (normalized integers, sparse) is unpacked by cgltf in one call and
+// then scattered. Components the accessor lacks keep their default.
+
+static void readAttribute(const cgltf_accessor* accessor, std::vector<GLBVertex>& vertices,
+                          size_t memberOffset, size_t components) {
+    size_t count = std::min<size_t>(accessor->count, vertices.size());
+    size_t available = cgltf_num_components(accessor->type);
+    size_t copy = std::min(components, available) * sizeof(float);
+    if (count == 0 || copy == 0) return;
+    uint8_t* out = reinterpret_cast<uint8_t*>(vertices.data()) + memberOffset;
+
+    const cgltf_buffer_view* view = accessor->buffer_view;
+    const uint8_t* src = view ? cgltf_buffer_view_data(view) : nullptr;
+    if (src && !accessor->is_sparse && accessor->component_type == cgltf_component_type_r_32f &&
+        accessor->offset + accessor->stride * (count - 1) + available * sizeof(float) <= view->size) {
+        src += accessor->offset;
+        for (size_t i = 0; i < count; ++i) {
+            memcpy(out + i * sizeof(GLBVertex), src + i * accessor->stride, copy);
+        }
+        return;
+    }
+
+    std::vector<float> unpacked(accessor->count * available);
+    if (cgltf_accessor_unpack_floats(accessor, unpacked.data(), unpacked.size()) == 0) return;
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(out + i * sizeof(GLBVertex), &unpacked[i * available], copy);
+    }
+}
+
+static void readIndices(const cgltf_accessor* accessor, std::vector<uint32_t>& indices) {
+    indices.resize(accessor->count);
+    if (cgltf_accessor_unpack_indices(accessor, indices.data(), sizeof(uint32_t), indices.size()) ==
+        indices.size()) {
+        return;
+    }
+    // Sparse or otherwise unusual index data
+    for (size_t ii = 0; ii < indices.size(); ++ii) {
+        indices[ii] = static_cast<uint32_t>(cgltf_accessor_read_index(accessor, ii));
+    }
+}
+
+// ============================================================================
+// Index and vertex order
+// ============================================================================
+// Before LODs are built: vertex cache, then overdraw (allowing 5% more
+// cache misses), then vertex fetch, which renumbers the vertices in
+// first-use order and drops unused ones. The LOD levels built afterwards
+// get their own vertex cache pass. Without meshoptimizer only the fetch
+// order is fixed.
+
+// Index buffers that reference missing vertices are left alone
+static bool canReorder(const GLBMesh& mesh) {
+    if (mesh.indices.empty() || mesh.indices.size() % 3 != 0) return false;
+    size_t vertexCount = mesh.vertices.size();
+    for (uint32_t index : mesh.indices) {
+        if (index >= vertexCount) return false;
+    }
+    return true;
+}
+
+// Skin weights follow their vertices
+static void optimizeMesh(GLBMesh& mesh) {
+    bool skinned = mesh.skinWeights.size() == mesh.vertices.size();
+#ifdef EDEN_USE_MESHOPT
+    size_t indexCount = mesh.indices.size();
+    size_t vertexCount = mesh.vertices.size();
+    meshopt_optimizeVertexCache(mesh.indices.data(), mesh.indices.data(), indexCount, vertexCount);
+    meshopt_optimizeOverdraw(mesh.indices.data(), mesh.indices.data(), indexCount, &mesh.vertices[0].position.x,
+                             vertexCount, sizeof(GLBVertex), 1.05f);
+    if (!skinned) {
+        mesh.vertices.resize(meshopt_optimizeVertexFetch(mesh.vertices.data(), mesh.indices.data(), indexCount,
+                                                         mesh.vertices.data(), vertexCount, sizeof(GLBVertex)));
+        return;
+    }
+    std::vector<uint32_t> remap(vertexCount);
+    size_t used = meshopt_optimizeVertexFetchRemap(remap.data(), mesh.indices.data(), indexCount, vertexCount);
+    meshopt_remapIndexBuffer(mesh.indices.data(), mesh.indices.data(), indexCount, remap.data());
+    meshopt_remapVertexBuffer(mesh.vertices.data(), mesh.vertices.data(), vertexCount, sizeof(GLBVertex), remap.data());
+    meshopt_remapVertexBuffer(mesh.skinWeights.data(), mesh.skinWeights.data(), vertexCount,
+                              sizeof(vkcore::SkinWeights), remap.data());
+    mesh.vertices.resize(used);
+    mesh.skinWeights.resize(used);
+#else
+    std::vector<uint32_t> remap(mesh.vertices.size(), UINT32_MAX);
+    std::vector<GLBVertex> ordered;
+    std::vector<vkcore::SkinWeights> orderedWeights;
+    ordered.reserve(mesh.vertices.size());
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = static_cast<uint32_t>(ordered.size());
+            ordered.push_back(mesh.vertices[index]);
+            if (skinned) orderedWeights.push_back(mesh.skinWeights[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices.swap(ordered);
+    if (skinned) mesh.skinWeights.swap(orderedWeights);
+#endif
+}
+
+static void optimizeLodLevels(GLBMesh& mesh) {
+#ifdef EDEN_USE_MESHOPT
+    size_t base = mesh.indices.size();
+    for (size_t level = 1; level < mesh.lods.size(); ++level) {
+        uint32_t* first = mesh.lodIndices.data() + (mesh.lods[level].firstIndex - base);
+        meshopt_optimizeVertexCache(first, first, mesh.lods[level].indexCount, mesh.vertices.size());
+    }
+#else
+    (void)mesh;
+#endif
+}
+
+// cgltf file callbacks: the .glb/.gltf and any external .bin buffers are
+// read through the VFS, so they can live in an archive
+static cgltf_result vfsFileRead(const cgltf_memory_options*, const cgltf_file_options*,
+                                const char* path, cgltf_size* size, void** data) {
+    VfsFile file;
+    if (!Vfs::shared().open(path, file)) return cgltf_result_file_not_found;
+    void* copy = malloc(file.size() > 0 ? file.size() : 1);
+    if (!copy) return cgltf_result_out_of_memory;
+    memcpy(copy, file.data(), file.size());
+    *size = file.size();
+    *data = copy;
+    return cgltf_result_success;
+}
+
+static void vfsFileRelease(const cgltf_memory_options*, const cgltf_file_options*, void* data, cgltf_size) {
+    free(data);
+}
+
+// JOINTS_0 / WEIGHTS_0, normalized; no weights = all on the first joint
+static void readSkinWeights(const cgltf_accessor* joints, const cgltf_accessor* weights, GLBMesh& mesh) {
+    mesh.skinWeights.assign(mesh.vertices.size(), vkcore::SkinWeights());
+    size_t count = std::min<size_t>(joints->count, mesh.skinWeights.size());
+    for (size_t i = 0; i < count; ++i) {
+        vkcore::SkinWeights& out = mesh.skinWeights[i];
+        cgltf_uint ids[4] = {0, 0, 0, 0};
+        cgltf_accessor_read_uint(joints, i, ids, 4);
+        for (int k = 0; k < 4; ++k) out.joints[k] = static_cast<uint16_t>(std::min<cgltf_uint>(ids[k], UINT16_MAX));
+        if (weights && i < weights->count) {
+            cgltf_accessor_read_float(weights, i, out.weights, 4);
+        }
+        vkcore::normalizeSkinWeights(out);
+    }
+}
+
+// One triangle primitive into `mesh`; messages go to `log` so primitives
+// extracted in parallel still report in file order
+static bool extractPrimitive(const cgltf_data* data, const cgltf_mesh& gltfMesh, size_t mi,
+                             const cgltf_primitive& prim, bool generateLods, GLBMesh& mesh, std::string& log) {
+    mesh.name = gltfMesh.name ? gltfMesh.name : ("mesh_" + std::to_string(mi));
+    mesh.textureIndex = -1;
+    mesh.hasNormals = false;  // Will be set true if normal accessor found
+    
+    // Get texture from material
+    if (prim.material) {
+        const cgltf_material* mat = prim.material;
+        // Check PBR base color texture
+        if (mat->has_pbr_metallic_roughness && 
+            mat->pbr_metallic_roughness.base_color_texture.texture) {
+            const cgltf_texture* tex = mat->pbr_metallic_roughness.base_color_texture.texture;
+            if (tex->image) {
+                mesh.textureIndex = static_cast<int>(tex->image - data->images);
+            }
+        }
+    }
+    
+    // Find attributes
+    const cgltf_accessor* posAccessor = nullptr;
+    const cgltf_accessor* normAccessor = nullptr;
+    const cgltf_accessor* uvAccessor = nullptr;   // TEXCOORD_0
+    const cgltf_accessor* uv1Accessor = nullptr;  // TEXCOORD_1 (for DMap facial animation)
+    const cgltf_accessor* colorAccessor = nullptr;
+    const cgltf_accessor* jointsAccessor = nullptr;   // JOINTS_0
+    const cgltf_accessor* weightsAccessor = nullptr;  // WEIGHTS_0
+    
+    for (size_t ai = 0; ai < prim.attributes_count; ++ai) {
+        const cgltf_attribute& attr = prim.attributes[ai];
+        if (attr.type == cgltf_attribute_type_position) posAccessor = attr.data;
+        else if (attr.type == cgltf_attribute_type_normal) normAccessor = attr.data;
+        else if (attr.type == cgltf_attribute_type_texcoord) {
+            // TEXCOORD_0 or TEXCOORD_1 based on index
+            if (attr.index == 0) uvAccessor = attr.data;
+            else if (attr.index == 1) uv1Accessor = attr.data;
+        }
+        else if (attr.type == cgltf_attribute_type_color) colorAccessor = attr.data;
+        else if (attr.type == cgltf_attribute_type_joints && attr.index == 0) jointsAccessor = attr.data;
+        else if (attr.type == cgltf_attribute_type_weights && attr.index == 0) weightsAccessor = attr.data;
+    }
+    
+    if (!posAccessor) {
+        log += "[GLB] Mesh has no position data, skipping\n";
+        return false;
+    }
+    
+    // Track if we have actual normal data
+    mesh.hasNormals = (normAccessor != nullptr);
+    if (!mesh.hasNormals) {
+        log += "[GLB] Mesh '" + mesh.name + "' has no normal data - will need generation\n";
+    }
+    
+    // Track if we have UV1 (for DMap facial animation)
+    mesh.hasUV1 = (uv1Accessor != nullptr);
+    if (mesh.hasUV1) {
+        log += "[GLB] Mesh '" + mesh.name + "' has TEXCOORD_1 (UV1 for DMap)\n";
+    }
+    
+    // Defaults for missing attributes, then one strided pass per attribute
+    size_t vertexCount = posAccessor->count;
+    GLBVertex defaults;
+    defaults.position = glm::vec3(0.0f);
+    defaults.normal = glm::vec3(0, 1, 0);
+    defaults.texCoord = glm::vec2(0);
+    defaults.texCoord1 = glm::vec2(0);
+    defaults.color = glm::vec4(1.0f);  // Default white
+    mesh.vertices.assign(vertexCount, defaults);
     
+    readAttribute(posAccessor, mesh.vertices, offsetof(GLBVertex, position), 3);
+    if (normAccessor) readAttribute(normAccessor, mesh.vertices, offsetof(GLBVertex, normal), 3);
+    if (uvAccessor) readAttribute(uvAccessor, mesh.vertices, offsetof(GLBVertex, texCoord), 2);
+    if (uv1Accessor) readAttribute(uv1Accessor, mesh.vertices, offsetof(GLBVertex, texCoord1), 2);
+    if (colorAccessor) readAttribute(colorAccessor, mesh.vertices, offsetof(GLBVertex, color), 4);
+    if (mesh.skin >= 0 && jointsAccessor) {
+        readSkinWeights(jointsAccessor, weightsAccessor, mesh);
+    } else {
+        mesh.skin = -1;  // Instanced by a skinned node but has no joints
+    }
+    
+    // Read indices
+    if (prim.indices) {
+        readIndices(prim.indices, mesh.indices);
+    } else {
+        // No indices - generate sequential
+        mesh.indices.resize(vertexCount);
+        for (size_t ii = 0; ii < vertexCount; ++ii) {
+            mesh.indices[ii] = static_cast<uint32_t>(ii);
+        }
+    }
+    
+    bool reorder = canReorder(mesh);
+    if (reorder) {
+        optimizeMesh(mesh);
+    } else if (!mesh.indices.empty()) {
+        log += "[GLB] Mesh '" + mesh.name + "' index buffer isn't a valid triangle list; order not optimized\n";
+    }
+    
+    if (generateLods && !mesh.vertices.empty()) {
+        buildMeshLods(mesh);
+        if (reorder) optimizeLodLevels(mesh);
+        if (mesh.lods.size() > 1) {
+            log += "[GLB] Mesh '" + mesh.name + "' LODs:";
+            for (const vkcore::MeshLod& lod : mesh.lods) log += " " + std::to_string(lod.indexCount / 3);
+            log += " tris\n";
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Skeleton and animations
+// ============================================================================
+// Every node goes into the skeleton, parents before children (depth first
+// from the roots), so joints and animated nodes are indexed the same way.
+// Returns the cgltf node index -> skeleton index map.
+
+static std::vector<uint32_t> importSkeleton(const cgltf_data* data, vkcore::Skeleton& skeleton) {
+    std::vector<uint32_t> remap(data->nodes_count, UINT32_MAX);
+    std::vector<const cgltf_node*> stack;
+    for (size_t ni = data->nodes_count; ni-- > 0;) {
+        if (!data->nodes[ni].parent) stack.push_back(&data->nodes[ni]);
+    }
+    while (!stack.empty()) {
+        const cgltf_node* gltfNode = stack.back();
+        stack.pop_back();
+        size_t index = static_cast<size_t>(gltfNode - data->nodes);
+        if (remap[index] != UINT32_MAX) continue;  // Malformed: reachable twice
+        remap[index] = static_cast<uint32_t>(skeleton.nodes.size());
+        
+        vkcore::SkeletonNode node;
+        node.name = gltfNode->name ? gltfNode->name : ("node_" + std::to_string(index));
+        node.parent = gltfNode->parent ? static_cast<int32_t>(remap[gltfNode->parent - data->nodes]) : -1;
+        if (gltfNode->has_matrix) {
+            glm::mat4 m;
+            memcpy(&m[0].x, gltfNode->matrix, sizeof(float) * 16);
+            vkcore::decomposeTransform(m, node.translation, node.rotation, node.scale);
+        } else {
+            const float* t = gltfNode->translation;
+            const float* r = gltfNode->rotation;
+            const float* sc = gltfNode->scale;
+            if (gltfNode->has_translation) node.translation = glm::vec3(t[0], t[1], t[2]);
+            if (gltfNode->has_rotation) node.rotation = glm::vec4(r[0], r[1], r[2], r[3]);
+            if (gltfNode->has_scale) node.scale = glm::vec3(sc[0], sc[1], sc[2]);
+        }
+        skeleton.nodes.push_back(node);
+        for (size_t ci = gltfNode->children_count; ci-- > 0;) stack.push_back(gltfNode->children[ci]);
+    }
+    
+    for (size_t si = 0; si < data->skins_count; ++si) {
+        const cgltf_skin& gltfSkin = data->skins[si];
+        vkcore::Skin skin;
+        skin.name = gltfSkin.name ? gltfSkin.name : ("skin_" + std::to_string(si));
+        skin.inverseBind.assign(gltfSkin.joints_count, glm::mat4(1.0f));  // Identity when the file has none
+        if (gltfSkin.inverse_bind_matrices && gltfSkin.inverse_bind_matrices->type == cgltf_type_mat4) {
+            std::vector<float> floats(gltfSkin.inverse_bind_matrices->count * 16);
+            cgltf_accessor_unpack_floats(gltfSkin.inverse_bind_matrices, floats.data(), floats.size());
+            size_t count = std::min<size_t>(gltfSkin.joints_count, gltfSkin.inverse_bind_matrices->count);
+            for (size_t j = 0; j < count; ++j) memcpy(&skin.inverseBind[j][0].x, &floats[j * 16], sizeof(float) * 16);
+        }
+        for (size_t j = 0; j < gltfSkin.joints_count; ++j) {
+            uint32_t node = remap[gltfSkin.joints[j] - data->nodes];
+            skin.joints.push_back(node == UINT32_MAX ? 0 : node);
+        }
+        skeleton.skins.push_back(std::move(skin));
+    }
+    return remap;
+}
+
+// Translation / rotation / scale channels; linear and step as they are,
+// cubic-spline keys by their values (tangents dropped)
+static void importAnimations(const cgltf_data* data, const std::vector<uint32_t>& nodeRemap,
+                             std::vector<vkcore::AnimationClip>& clips) {
+    for (size_t ai = 0; ai < data->animations_count; ++ai) {
+        const cgltf_animation& anim = data->animations[ai];
+        vkcore::AnimationClip clip;
+        clip.name = anim.name ? anim.name : ("animation_" + std::to_string(ai));
+        for (size_t ci = 0; ci < anim.channels_count; ++ci) {
+            const cgltf_animation_channel& gltfChannel = anim.channels[ci];
+            const cgltf_animation_sampler* sampler = gltfChannel.sampler;
+            if (!gltfChannel.target_node || !sampler || !sampler->input || !sampler->output) continue;
+            
+            vkcore::AnimationChannel channel;
+            size_t components;
+            if (gltfChannel.target_path == cgltf_animation_path_type_translation) {
+                channel.path = vkcore::AnimationPath::TRANSLATION;
+                components = 3;
+            } else if (gltfChannel.target_path == cgltf_animation_path_type_rotation) {
+                channel.path = vkcore::AnimationPath::ROTATION;
+                components = 4;
+            } else if (gltfChannel.target_path == cgltf_animation_path_type_scale) {
+                channel.path = vkcore::AnimationPath::SCALE;
+                components = 3;
+            } else {
+                continue;  // Morph target weights
+            }
+            channel.node = nodeRemap[gltfChannel.target_node - data->nodes];
+            channel.step = sampler->interpolation == cgltf_interpolation_type_step;
+            
+            size_t keys = sampler->input->count;
+            bool cubic = sampler->interpolation == cgltf_interpolation_type_cubic_spline;
+            size_t perKey = cubic ? 3 : 1;  // In-tangent, value, out-tangent
+            if (keys == 0 || sampler->output->count < keys * perKey ||
+                cgltf_num_components(sampler->output->type) != components) {
+                continue;
+            }
+            channel.times.resize(keys);
+            cgltf_accessor_unpack_floats(sampler->input, channel.times.data(), keys);
+            std::vector<float> output(sampler->output->count * components);
+            cgltf_accessor_unpack_floats(sampler->output, output.data(), output.size());
+            channel.values.resize(keys, glm::vec4(0.0f));
+            for (size_t k = 0; k < keys; ++k) {
+                const float* value = &output[(k * perKey + (cubic ? 1 : 0)) * components];
+                for (size_t c = 0; c < components; ++c) channel.values[k][c] = value[c];
+            }
+            clip.duration = std::max(clip.duration, channel.times.back());
+            clip.channels.push_back(std::move(channel));
+        }
+        if (!clip.channels.empty()) clips.push_back(std::move(clip));
+    }
+}
+
+static bool importGLB(const std::string& path, GLBModel& model, bool generateLods) {
     std::cout << "[GLB] Loading: " << path << std::endl;
     
     // Parse the file
     cgltf_options options = {};
+    options.file.read = &vfsFileRead;
+    options.file.release = &vfsFileRelease;
     cgltf_data* data = nullptr;
     
     cgltf_result result = cgltf_parse_file(&options, path.c_str(), &data);
@@ -88,177 +797,92 @@ bool loadGLB(const std::string& path, GLBModel& model) {
     }
     
     // Extract model name from filename
-    size_t lastSlash = path.find_last_of("/\\");
-    size_t lastDot = path.find_last_of('.');
-    if (lastSlash == std::string::npos) lastSlash = 0; else lastSlash++;
-    if (lastDot == std::string::npos || lastDot < lastSlash) lastDot = path.length();
-    model.name = path.substr(lastSlash, lastDot - lastSlash);
+    model.name = modelNameFromPath(path);
     
     // Extract textures
     std::cout << "[GLB] Found " << data->images_count << " images, " 
               << data->textures_count << " textures" << std::endl;
     
+    // Embedded images decode in parallel; external ones stay invalid to preserve indices
+    model.textures.resize(data->images_count);
+    std::vector<EncodedImage> encoded;
+    std::vector<size_t> encodedTexture;  // encoded[i] -> model.textures index
     for (size_t ti = 0; ti < data->images_count; ++ti) {
         cgltf_image& img = data->images[ti];
-        GLBTexture tex;
+        GLBTexture& tex = model.textures[ti];
         tex.name = img.name ? img.name : ("texture_" + std::to_string(ti));
         
-        const uint8_t* imageData = nullptr;
-        size_t imageSize = 0;
-        
         if (img.buffer_view) {
             // Embedded in buffer
-            imageData = static_cast<const uint8_t*>(img.buffer_view->buffer->data) + img.buffer_view->offset;
-            imageSize = img.buffer_view->size;
+            EncodedImage image;
+            image.data = static_cast<const uint8_t*>(img.buffer_view->buffer->data) + img.buffer_view->offset;
+            image.size = img.buffer_view->size;
+            encoded.push_back(image);
+            encodedTexture.push_back(ti);
         } else if (img.uri) {
-            // External file or data URI - push invalid texture to preserve indices
+            // External file or data URI
             std::cout << "[GLB] External image (not supported): " << img.uri << std::endl;
-            tex.valid = false;
-            model.textures.push_back(std::move(tex));
-            continue;
         }
-        
-        if (imageData && imageSize > 0) {
-            // Decode with stb_image
-            int w, h, channels;
-            stbi_uc* pixels = stbi_load_from_memory(imageData, static_cast<int>(imageSize), &w, &h, &channels, STBI_rgb_alpha);
-            if (pixels) {
-                tex.width = static_cast<uint32_t>(w);
-                tex.height = static_cast<uint32_t>(h);
-                tex.pixels.resize(w * h * 4);
-                memcpy(tex.pixels.data(), pixels, tex.pixels.size());
-                tex.valid = true;
-                stbi_image_free(pixels);
-                std::cout << "[GLB] Loaded texture: " << tex.name << " (" << w << "x" << h << ")" << std::endl;
-            } else {
-                std::cerr << "[GLB] Failed to decode texture: " << tex.name << std::endl;
-            }
-        }
-        
-        model.textures.push_back(std::move(tex));
     }
     
-    // Process all meshes
+    // Triangle primitives, in file order; each becomes one GLBMesh
+    struct PrimitiveJob {
+        size_t mesh;
+        const cgltf_primitive* primitive;
+    };
+    std::vector<PrimitiveJob> jobs;
     for (size_t mi = 0; mi < data->meshes_count; ++mi) {
-        cgltf_mesh& gltfMesh = data->meshes[mi];
-        
-        for (size_t pi = 0; pi < gltfMesh.primitives_count; ++pi) {
-            cgltf_primitive& prim = gltfMesh.primitives[pi];
-            
+        for (size_t pi = 0; pi < data->meshes[mi].primitives_count; ++pi) {
+            const cgltf_primitive& prim = data->meshes[mi].primitives[pi];
             // Only handle triangles
-            if (prim.type != cgltf_primitive_type_triangles) {
-                continue;
-            }
-            
-            GLBMesh mesh;
-            mesh.name = gltfMesh.name ? gltfMesh.name : ("mesh_" + std::to_string(mi));
-            mesh.textureIndex = -1;
-            mesh.hasNormals = false;  // Will be set true if normal accessor found
-            
-            // Get texture from material
-            if (prim.material) {
-                cgltf_material* mat = prim.material;
-                // Check PBR base color texture
-                if (mat->has_pbr_metallic_roughness && 
-                    mat->pbr_metallic_roughness.base_color_texture.texture) {
-                    cgltf_texture* tex = mat->pbr_metallic_roughness.base_color_texture.texture;
-                    if (tex->image) {
-                        mesh.textureIndex = static_cast<int>(tex->image - data->images);
-                    }
-                }
-            }
-            
-            // Find attributes
-            cgltf_accessor* posAccessor = nullptr;
-            cgltf_accessor* normAccessor = nullptr;
-            cgltf_accessor* uvAccessor = nullptr;   // TEXCOORD_0
-            cgltf_accessor* uv1Accessor = nullptr;  // TEXCOORD_1 (for DMap facial animation)
-            cgltf_accessor* colorAccessor = nullptr;
-            
-            for (size_t ai = 0; ai < prim.attributes_count; ++ai) {
-                cgltf_attribute& attr = prim.attributes[ai];
-                if (attr.type == cgltf_attribute_type_position) posAccessor = attr.data;
-                else if (attr.type == cgltf_attribute_type_normal) normAccessor = attr.data;
-                else if (attr.type == cgltf_attribute_type_texcoord) {
-                    // TEXCOORD_0 or TEXCOORD_1 based on index
-                    if (attr.index == 0) uvAccessor = attr.data;
-                    else if (attr.index == 1) uv1Accessor = attr.data;
-                }
-                else if (attr.type == cgltf_attribute_type_color) colorAccessor = attr.data;
-            }
-            
-            if (!posAccessor) {
-                std::cerr << "[GLB] Mesh has no position data, skipping" << std::endl;
-                continue;
-            }
-            
-            // Track if we have actual normal data
-            mesh.hasNormals = (normAccessor != nullptr);
-            if (!mesh.hasNormals) {
-                std::cout << "[GLB] Mesh '" << mesh.name << "' has no normal data - will need generation" << std::endl;
-            }
-            
-            // Track if we have UV1 (for DMap facial animation)
-            mesh.hasUV1 = (uv1Accessor != nullptr);
-            if (mesh.hasUV1) {
-                std::cout << "[GLB] Mesh '" << mesh.name << "' has TEXCOORD_1 (UV1 for DMap)" << std::endl;
-            }
-            
-            // Read vertices
-            size_t vertexCount = posAccessor->count;
-            mesh.vertices.resize(vertexCount);
-            
-            for (size_t vi = 0; vi < vertexCount; ++vi) {
-                GLBVertex& v = mesh.vertices[vi];
-                
-                // Position (required)
-                cgltf_accessor_read_float(posAccessor, vi, &v.position.x, 3);
-                
-                // Normal (optional)
-                if (normAccessor) {
-                    cgltf_accessor_read_float(normAccessor, vi, &v.normal.x, 3);
-                } else {
-                    v.normal = glm::vec3(0, 1, 0);
-                }
-                
-                // UV0 (optional)
-                if (uvAccessor) {
-                    cgltf_accessor_read_float(uvAccessor, vi, &v.texCoord.x, 2);
-                } else {
-                    v.texCoord = glm::vec2(0);
-                }
-                
-                // UV1 - DMap coordinates (optional)
-                if (uv1Accessor) {
-                    cgltf_accessor_read_float(uv1Accessor, vi, &v.texCoord1.x, 2);
-                } else {
-                    v.texCoord1 = glm::vec2(0);
-                }
-                
-                // Vertex color (optional)
-                if (colorAccessor) {
-                    cgltf_accessor_read_float(colorAccessor, vi, &v.color.x, 4);
-                } else {
-                    v.color = glm::vec4(1.0f);  // Default white
-                }
-            }
-            
-            // Read indices
-            if (prim.indices) {
-                mesh.indices.resize(prim.indices->count);
-                for (size_t ii = 0; ii < prim.indices->count; ++ii) {
-                    mesh.indices[ii] = static_cast<uint32_t>(cgltf_accessor_read_index(prim.indices, ii));
-                }
-            } else {
-                // No indices - generate sequential
-                mesh.indices.resize(vertexCount);
-                for (size_t ii = 0; ii < vertexCount; ++ii) {
-                    mesh.indices[ii] = static_cast<uint32_t>(ii);
-                }
+            if (prim.type == cgltf_primitive_type_triangles) jobs.push_back({mi, &prim});
+        }
+    }
+    // Skins are per node; a mesh takes the first skinned node's that instances it
+    std::vector<uint32_t> nodeRemap = importSkeleton(data, model.skeleton);
+    importAnimations(data, nodeRemap, model.animations);
+    std::vector<int> meshSkins(data->meshes_count, -1);
+    for (size_t ni = 0; ni < data->nodes_count; ++ni) {
+        const cgltf_node& node = data->nodes[ni];
+        if (node.mesh && node.skin && meshSkins[node.mesh - data->meshes] < 0) {
+            meshSkins[node.mesh - data->meshes] = static_cast<int>(node.skin - data->skins);
+        }
+    }
+    
+    std::vector<GLBMesh> meshes(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) meshes[i].skin = meshSkins[jobs[i].mesh];
+    std::vector<std::string> logs(jobs.size());
+    std::vector<uint8_t> extracted(jobs.size(), 0);
+    
+    // Primitives are extracted on the job system while this thread decodes
+    // images (and keeps their log lines and pixel copies on one thread)
+    TaskGroup extraction;
+    extraction.run([&]() {
+        parallel_for(jobs.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                extracted[i] = extractPrimitive(data, data->meshes[jobs[i].mesh], jobs[i].mesh,
+                                                *jobs[i].primitive, generateLods, meshes[i], logs[i]);
             }
-            
-            model.meshes.push_back(std::move(mesh));
+        }, 1);
+    });
+    
+    decode_images(encoded, [&](DecodedImage& image) {
+        GLBTexture& tex = model.textures[encodedTexture[image.index]];
+        if (!image.pixels) {
+            std::cerr << "[GLB] Failed to decode texture: " << tex.name << std::endl;
+            return;
         }
+        tex.width = image.width;
+        tex.height = image.height;
+        tex.pixels.assign(image.pixels.get(), image.pixels.get() + image.byteSize());
+        tex.valid = true;
+        std::cout << "[GLB] Loaded texture: " << tex.name << " (" << tex.width << "x" << tex.height << ")" << std::endl;
+    });
+    
+    extraction.wait();
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        std::cout << logs[i];
+        if (extracted[i]) model.meshes.push_back(std::move(meshes[i]));
     }
     
     cgltf_free(data);
@@ -266,15 +890,20 @@ bool loadGLB(const std::string& path, GLBModel& model) {
     std::cout << "[GLB] Loaded: " << model.meshes.size() << " meshes, " 
               << model.totalVertices() << " verts, " 
               << model.totalTriangles() << " tris" << std::endl;
+    if (!model.skeleton.skins.empty() || !model.animations.empty()) {
+        std::cout << "[GLB] Skeleton: " << model.skeleton.nodes.size() << " nodes, " << model.skeleton.skins.size()
+                  << " skins, " << model.animations.size() << " animations" << std::endl;
+    }
     
     return !model.meshes.empty();
 }
 
 #else
 
-// Stub when cgltf is not available
-bool loadGLB(const std::string& path, GLBModel& model) {
+// Stub when cgltf is not available (cached models still load)
+static bool importGLB(const std::string& path, GLBModel& model, bool generateLods) {
     (void)path;
+    (void)generateLods;
     model.clear();
     std::cerr << "[GLB] GLB loading not available - cgltf library not found" << std::endl;
     std::cerr << "[GLB] Download cgltf.h from https://github.com/jkuhlmann/cgltf" << std::endl;
@@ -12,6 +12,9 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+#include "../core/mesh_lod.h"
+#include "../core/skeleton.h"
+
 namespace eden {
 
 // ============================================================================
@@ -41,16 +44,22 @@ struct GLBVertex {
 struct GLBMesh {
     std::string name;
     std::vector<GLBVertex> vertices;
-    std::vector<uint32_t> indices;
+    std::vector<uint32_t> indices;      // LOD 0 (full detail)
+    std::vector<uint32_t> lodIndices;   // Simplified levels, to append after indices
+    std::vector<vkcore::MeshLod> lods;  // Ranges into indices + lodIndices; lods[0] is LOD 0
     int textureIndex = -1;  // Index into GLBModel::textures, or -1 if none
     bool hasNormals = false;  // True if GLB file contained normal data
     bool hasUV1 = false;      // True if GLB file contained TEXCOORD_1 (UV1 for DMap)
+    int skin = -1;            // Index into GLBModel::skeleton.skins, or -1 if not skinned
+    std::vector<vkcore::SkinWeights> skinWeights;  // JOINTS_0 / WEIGHTS_0 per vertex (skinned meshes)
 };
 
 struct GLBModel {
     std::string name;
     std::vector<GLBMesh> meshes;
     std::vector<GLBTexture> textures;  // Embedded textures
+    vkcore::Skeleton skeleton;         // Every node (parents first) and skin
+    std::vector<vkcore::AnimationClip> animations;  // Node TRS channels of skeleton.nodes
     
     // Stats
     size_t totalVertices() const;
@@ -64,8 +73,17 @@ struct GLBModel {
 // ============================================================================
 
 // Load a GLB or GLTF file
-// Returns true on success, fills 'model' with mesh data
-bool loadGLB(const std::string& path, GLBModel& model);
+// Returns true on success, fills 'model' with mesh data. With generateLods,
+// each mesh also gets a quadric-simplified LOD chain (see mesh_lod.h).
+// Primitives are extracted in parallel. Vertices are renumbered in first-use
+// order (so they need not match the file) and, with EDEN_USE_MESHOPT, the
+// indices are first reordered for vertex cache and overdraw.
+// Skins and animations come along for GpuSkinning: a mesh's skin is the one
+// of the first node instancing it; morph-target weight channels are
+// dropped and cubic-spline keys keep their values (sampled linearly).
+// .glb imports are kept in the binary mesh cache (mesh_cache.h), so an
+// unchanged file is read back instead of parsed and decoded again.
+bool loadGLB(const std::string& path, GLBModel& model, bool generateLods = true);
 
 // Check if cgltf library is available
 bool isGLBSupported();
@@ -0,0 +1,556 @@
+// ============================================================================
+// HALF-EDGE MESH - Persistent topology for the ESE mesh editor
+// ============================================================================
+// ESE edits triangle meshes as quads. Instead of re-deriving quads and their
+// edges from the index buffer after every edit, the editor keeps this
+// structure and edits it in place:
+//
+//   - Every face (a quad reconstructed from two coplanar triangles, or a
+//     leftover triangle) is a loop of half-edges {vertex, next, twin, face},
+//     all in flat arrays. The vertex is an index into the caller's vertex
+//     array, so UV and normal seams stay distinct.
+//   - Twins are paired by welded position ("points", vertices closer than
+//     PositionHash's epsilon), not vertex index, so an edge across an OBJ's
+//     duplicated seam vertices is still one edge.
+//     The vertices of a point form a ring (forEachCoincident) for
+//     selections that move every copy. Extruded copies get points of their
+//     own, so they can leave the originals even while coincident.
+//   - extrudeFace() and insertEdgeLoop() append vertices and half-edges and
+//     relink the ones they touch; nothing is rebuilt or searched.
+//   - triangles() fans every face into the triangle index buffer, lazily,
+//     only after the topology changed. Faces that came from two triangles
+//     keep their original diagonal.
+//
+// Vertex types need float pos[3], normal[3] and uv[2] (MeshVertex).
+//
+// Header-only, like core/handle_pool.h.
+//
+// Usage:
+//   eden::HalfEdgeMesh topology;
+//   topology.build(mesh.getVertices(), mesh.getIndices());
+//   std::vector<uint32_t> moved = topology.extrudeFace(mesh.getVerticesMutable(), face);
+//   topology.insertEdgeLoop(mesh.getVerticesMutable(), halfEdge);
+//   mesh.getIndicesMutable() = topology.triangles();
+//   mesh.rebuildBuffers();
+// ============================================================================
+
+#ifndef EDEN_HALF_EDGE_MESH_H
+#define EDEN_HALF_EDGE_MESH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "position_hash.h"
+
+namespace eden {
+
+class HalfEdgeMesh {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+
+    struct HalfEdge {
+        uint32_t vertex = INVALID;  // Origin, an index into the vertex array
+        uint32_t next = INVALID;    // Next half-edge around the face
+        uint32_t twin = INVALID;    // Opposite half-edge; INVALID on a boundary
+        uint32_t face = INVALID;
+    };
+
+    /**
+     * Rebuild from a triangle list. Adjacent triangles sharing two vertex
+     * indices whose normals agree within coplanarDot become one quad face,
+     * greedily in index-buffer order. False (and empty) if an index is out
+     * of range.
+     */
+    template <typename Vertex>
+    bool build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+               float coplanarDot = 0.95f) {
+        PositionHash positions;
+        positions.build(vertices);
+        return build(vertices, indices, positions, coplanarDot);
+    }
+
+    // As above, welding with a caller's PositionHash built over `vertices`
+    // (false if it wasn't), so one hash serves every pass of an operation
+    template <typename Vertex>
+    bool build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+               const PositionHash& positions, float coplanarDot = 0.95f) {
+        clear();
+        uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        if (positions.vertexCount() != vertexCount) return false;
+        for (size_t i = 0; i < size_t(triangleCount) * 3; i++) {
+            if (indices[i] >= vertexCount) return false;
+        }
+
+        weld(vertices, positions);
+
+        // Each undirected edge (by vertex index) with the triangle using it,
+        // sorted so a triangle's neighbours are one lower_bound away
+        struct EdgeEntry {
+            uint64_t key;
+            uint32_t triangle;
+            bool operator<(const EdgeEntry& o) const { return key != o.key ? key < o.key : triangle < o.triangle; }
+        };
+        std::vector<EdgeEntry> edges;
+        edges.reserve(size_t(triangleCount) * 3);
+        std::vector<float> normals(size_t(triangleCount) * 3);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            const uint32_t* tri = &indices[size_t(t) * 3];
+            triangleNormal(vertices[tri[0]], vertices[tri[1]], vertices[tri[2]], &normals[size_t(t) * 3]);
+            for (int e = 0; e < 3; e++) {
+                uint32_t a = tri[e], b = tri[(e + 1) % 3];
+                if (a != b) edges.push_back({undirectedKey(a, b), t});
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<char> used(triangleCount, 0);
+        m_triangleFaces.assign(triangleCount, INVALID);
+        for (uint32_t i = 0; i < triangleCount; i++) {
+            if (used[i]) continue;
+            used[i] = 1;
+            const uint32_t* tri = &indices[size_t(i) * 3];
+            const float* n1 = &normals[size_t(i) * 3];
+
+            // The lowest-numbered free coplanar neighbour
+            uint32_t partner = INVALID;
+            int sharedEdge = -1;
+            for (int e = 0; e < 3; e++) {
+                uint32_t a = tri[e], b = tri[(e + 1) % 3];
+                if (a == b) continue;
+                uint64_t key = undirectedKey(a, b);
+                auto it = std::lower_bound(edges.begin(), edges.end(), EdgeEntry{key, i + 1});
+                for (; it != edges.end() && it->key == key && it->triangle < partner; ++it) {
+                    uint32_t j = it->triangle;
+                    if (used[j] || thirdVertex(&indices[size_t(j) * 3], a, b) == INVALID) continue;
+                    const float* n2 = &normals[size_t(j) * 3];
+                    if (n1[0] * n2[0] + n1[1] * n2[1] + n1[2] * n2[2] > coplanarDot) {
+                        partner = j;
+                        sharedEdge = e;
+                        break;
+                    }
+                }
+            }
+
+            m_triangleFaces[i] = faceCount();
+            if (partner == INVALID) {
+                addFace(tri, 3);
+                continue;
+            }
+            used[partner] = 1;
+            m_triangleFaces[partner] = faceCount();
+
+            // Shared edge s0-s1 replaced by s0 -> u2 -> s1; starting at s0
+            // keeps it the diagonal when the quad is fanned again
+            uint32_t s0 = tri[sharedEdge], s1 = tri[(sharedEdge + 1) % 3], u1 = tri[(sharedEdge + 2) % 3];
+            uint32_t u2 = thirdVertex(&indices[size_t(partner) * 3], s0, s1);
+            uint32_t quad[4] = {s0, u2, s1, u1};
+            addFace(quad, 4);
+        }
+
+        pairTwins();
+        m_triangleFacesBuilt = true;
+        return true;
+    }
+
+    void clear() {
+        m_halfEdges.clear();
+        m_faces.clear();
+        m_vertexPoint.clear();
+        m_vertexRing.clear();
+        m_pointCount = 0;
+        m_triangles.clear();
+        m_triangleFaces.clear();
+        m_trianglesDirty = true;
+        m_triangleFacesBuilt = false;
+    }
+
+    // ------------------------------------------------------------------------
+    // Queries
+    // ------------------------------------------------------------------------
+
+    // Vertices the topology knows about; differs from the vertex array once
+    // something else edited the mesh, which then needs build() again
+    uint32_t vertexCount() const { return static_cast<uint32_t>(m_vertexPoint.size()); }
+    uint32_t pointCount() const { return m_pointCount; }
+    uint32_t faceCount() const { return static_cast<uint32_t>(m_faces.size()); }
+    uint32_t halfEdgeCount() const { return static_cast<uint32_t>(m_halfEdges.size()); }
+
+    const HalfEdge& halfEdge(uint32_t h) const { return m_halfEdges[h]; }
+    uint32_t faceHalfEdge(uint32_t face) const { return m_faces[face]; }
+    uint32_t pointOf(uint32_t vertex) const { return m_vertexPoint[vertex]; }
+
+    // Where a half-edge ends
+    uint32_t target(uint32_t h) const { return m_halfEdges[m_halfEdges[h].next].vertex; }
+
+    uint32_t faceSize(uint32_t face) const {
+        uint32_t count = 0;
+        uint32_t h = m_faces[face];
+        do {
+            count++;
+            h = m_halfEdges[h].next;
+        } while (h != m_faces[face]);
+        return count;
+    }
+
+    // fn(halfEdge) around a face, from faceHalfEdge()
+    template <typename Fn>
+    void forEachFaceHalfEdge(uint32_t face, Fn&& fn) const {
+        uint32_t h = m_faces[face];
+        do {
+            fn(h);
+            h = m_halfEdges[h].next;
+        } while (h != m_faces[face]);
+    }
+
+    // fn(vertex) for every vertex on the same point, itself included
+    template <typename Fn>
+    void forEachCoincident(uint32_t vertex, Fn&& fn) const {
+        uint32_t v = vertex;
+        do {
+            fn(v);
+            v = m_vertexRing[v];
+        } while (v != vertex);
+    }
+
+    // Index buffer for rendering, refanned only after an edit
+    const std::vector<uint32_t>& triangles() const {
+        if (m_trianglesDirty) {
+            m_triangles.clear();
+            m_triangles.reserve(m_halfEdges.size() * 3);
+            m_triangleFaces.clear();
+            for (uint32_t first : m_faces) {
+                uint32_t h = m_halfEdges[first].next;
+                while (m_halfEdges[h].next != first) {
+                    m_triangleFaces.push_back(m_halfEdges[first].face);
+                    m_triangles.push_back(m_halfEdges[first].vertex);
+                    m_triangles.push_back(m_halfEdges[h].vertex);
+                    h = m_halfEdges[h].next;
+                    m_triangles.push_back(m_halfEdges[h].vertex);
+                }
+            }
+            m_trianglesDirty = false;
+            m_triangleFacesBuilt = false;
+        }
+        return m_triangles;
+    }
+
+    // Face of each triangle in the index buffer: the one build() read,
+    // until an edit, then triangles()
+    const std::vector<uint32_t>& triangleFaces() const {
+        if (!m_triangleFacesBuilt) triangles();
+        return m_triangleFaces;
+    }
+
+    // ------------------------------------------------------------------------
+    // Edits
+    // ------------------------------------------------------------------------
+
+    /**
+     * Extrude a face: the face moves onto copies of its vertices (normals
+     * set to the face normal, positions unchanged) and each of its edges
+     * gets a side quad back to the originals. Returns the new vertices in
+     * face order, to be moved by the caller; empty for a bad face.
+     */
+    template <typename Vertex>
+    std::vector<uint32_t> extrudeFace(std::vector<Vertex>& vertices, uint32_t face) {
+        std::vector<uint32_t> created;
+        if (face >= m_faces.size() || vertices.size() != m_vertexPoint.size()) return created;
+
+        std::vector<uint32_t> loop;
+        forEachFaceHalfEdge(face, [&](uint32_t h) { loop.push_back(h); });
+        uint32_t count = static_cast<uint32_t>(loop.size());
+        if (count < 3) return created;
+
+        float normal[3];
+        triangleNormal(vertices[m_halfEdges[loop[0]].vertex], vertices[m_halfEdges[loop[1]].vertex],
+                       vertices[m_halfEdges[loop[2]].vertex], normal);
+
+        std::vector<uint32_t> bottom(count);
+        for (uint32_t i = 0; i < count; i++) {
+            bottom[i] = m_halfEdges[loop[i]].vertex;
+            Vertex top = vertices[bottom[i]];
+            for (int k = 0; k < 3; k++) top.normal[k] = normal[k];
+            created.push_back(addVertex(vertices, top, INVALID));
+        }
+
+        // Side i: bottom[i] -> bottom[i+1] -> created[i+1] -> created[i],
+        // taking over the outside twin of the face's edge i
+        uint32_t firstSide = static_cast<uint32_t>(m_halfEdges.size());
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t j = (i + 1) % count;
+            uint32_t sideFace = static_cast<uint32_t>(m_faces.size());
+            uint32_t base = static_cast<uint32_t>(m_halfEdges.size());
+            m_faces.push_back(base);
+            uint32_t sideVertices[4] = {bottom[i], bottom[j], created[j], created[i]};
+            for (uint32_t k = 0; k < 4; k++) {
+                HalfEdge he;
+                he.vertex = sideVertices[k];
+                he.next = base + (k + 1) % 4;
+                he.face = sideFace;
+                m_halfEdges.push_back(he);
+            }
+
+            uint32_t outside = m_halfEdges[loop[i]].twin;
+            m_halfEdges[base].twin = outside;
+            if (outside != INVALID) m_halfEdges[outside].twin = base;
+            link(base + 2, loop[i]);
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t side = firstSide + i * 4;
+            uint32_t nextSide = firstSide + ((i + 1) % count) * 4;
+            link(side + 1, nextSide + 3);
+            m_halfEdges[loop[i]].vertex = created[i];
+        }
+
+        m_trianglesDirty = true;
+        m_triangleFacesBuilt = false;
+        return created;
+    }
+
+    /**
+     * Insert an edge loop across `halfEdge`: walk quads through opposite
+     * edges in both directions (stopping at non-quads, boundaries or where
+     * the loop closes), split every crossed edge at its midpoint and each
+     * quad in two. A neighbour face beyond the loop's ends keeps the
+     * midpoint as an extra corner, so no T-junction opens. Returns the
+     * number of vertices created.
+     */
+    template <typename Vertex>
+    uint32_t insertEdgeLoop(std::vector<Vertex>& vertices, uint32_t halfEdge) {
+        if (halfEdge >= m_halfEdges.size() || vertices.size() != m_vertexPoint.size()) return 0;
+
+        // (entering edge, opposite edge) of every quad on the loop
+        std::vector<std::pair<uint32_t, uint32_t>> loop;
+        std::vector<char> visited(m_faces.size(), 0);
+        auto walk = [&](uint32_t h) {
+            while (h != INVALID) {
+                uint32_t face = m_halfEdges[h].face;
+                if (visited[face] || faceSize(face) != 4) break;
+                visited[face] = 1;
+                uint32_t opposite = m_halfEdges[m_halfEdges[h].next].next;
+                loop.push_back({h, opposite});
+                h = m_halfEdges[opposite].twin;
+            }
+        };
+        walk(halfEdge);
+        walk(m_halfEdges[halfEdge].twin);
+        if (loop.empty()) return 0;
+
+        uint32_t before = vertexCount();
+        std::vector<char> split(m_halfEdges.size(), 0);
+        for (const auto& entry : loop) {
+            for (uint32_t h : {entry.first, entry.second}) {
+                if (split[h]) continue;
+                split[h] = 1;
+                if (m_halfEdges[h].twin != INVALID) split[m_halfEdges[h].twin] = 1;
+                splitEdge(vertices, h);
+            }
+        }
+
+        // v0 -> m1 -> v1 -> v2 -> m2 -> v3: the face keeps v0 m1 m2 v3,
+        // a new one takes m1 v1 v2 m2
+        for (const auto& entry : loop) {
+            uint32_t enter = entry.first, opposite = entry.second;
+            uint32_t enterRest = m_halfEdges[enter].next;
+            uint32_t oppositeRest = m_halfEdges[opposite].next;
+            uint32_t face = m_halfEdges[enter].face;
+            uint32_t newFace = static_cast<uint32_t>(m_faces.size());
+
+            uint32_t across = static_cast<uint32_t>(m_halfEdges.size());
+            HalfEdge a, b;
+            a.vertex = m_halfEdges[enterRest].vertex;
+            a.next = oppositeRest;
+            a.face = face;
+            b.vertex = m_halfEdges[oppositeRest].vertex;
+            b.next = enterRest;
+            b.face = newFace;
+            m_halfEdges.push_back(a);
+            m_halfEdges.push_back(b);
+            link(across, across + 1);
+            m_halfEdges[enter].next = across;
+            m_halfEdges[opposite].next = across + 1;
+
+            for (uint32_t h = enterRest; h != across + 1; h = m_halfEdges[h].next) m_halfEdges[h].face = newFace;
+            m_faces[face] = enter;
+            m_faces.push_back(enterRest);
+        }
+
+        m_trianglesDirty = true;
+        m_triangleFacesBuilt = false;
+        return vertexCount() - before;
+    }
+
+private:
+    static uint64_t undirectedKey(uint32_t a, uint32_t b) {
+        return (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+    }
+
+    static uint64_t directedKey(uint32_t from, uint32_t to) { return (uint64_t(from) << 32) | to; }
+
+    // The corner that isn't a or b; INVALID unless the triangle has exactly
+    // those two plus one more
+    static uint32_t thirdVertex(const uint32_t* tri, uint32_t a, uint32_t b) {
+        uint32_t third = INVALID;
+        int shared = 0;
+        for (int k = 0; k < 3; k++) {
+            if (tri[k] == a || tri[k] == b) shared++;
+            else third = tri[k];
+        }
+        return shared == 2 ? third : INVALID;
+    }
+
+    // Unit normal, zero for a degenerate triangle
+    template <typename Vertex>
+    static void triangleNormal(const Vertex& a, const Vertex& b, const Vertex& c, float* out) {
+        float e1[3] = {b.pos[0] - a.pos[0], b.pos[1] - a.pos[1], b.pos[2] - a.pos[2]};
+        float e2[3] = {c.pos[0] - a.pos[0], c.pos[1] - a.pos[1], c.pos[2] - a.pos[2]};
+        out[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        out[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        out[2] = e1[0] * e2[1] - e1[1] * e2[0];
+        float length = std::sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2]);
+        float scale = length > 0.0f ? 1.0f / length : 0.0f;
+        for (int k = 0; k < 3; k++) out[k] *= scale;
+    }
+
+    // Each vertex joins the point of the lowest-numbered vertex near it
+    template <typename Vertex>
+    void weld(const std::vector<Vertex>& vertices, const PositionHash& positions) {
+        uint32_t count = static_cast<uint32_t>(vertices.size());
+        m_vertexPoint.resize(count);
+        m_vertexRing.resize(count);
+        for (uint32_t v = 0; v < count; v++) {
+            uint32_t first = positions.firstNear(vertices, vertices[v].pos);
+            if (first >= v) {
+                m_vertexPoint[v] = m_pointCount++;
+                m_vertexRing[v] = v;
+            } else {
+                m_vertexPoint[v] = m_vertexPoint[first];
+                m_vertexRing[v] = m_vertexRing[first];
+                m_vertexRing[first] = v;
+            }
+        }
+    }
+
+    // A new vertex on sharesWith's point, or on a fresh point if INVALID
+    template <typename Vertex>
+    uint32_t addVertex(std::vector<Vertex>& vertices, const Vertex& value, uint32_t sharesWith) {
+        uint32_t v = static_cast<uint32_t>(vertices.size());
+        vertices.push_back(value);
+        if (sharesWith == INVALID) {
+            m_vertexPoint.push_back(m_pointCount++);
+            m_vertexRing.push_back(v);
+        } else {
+            m_vertexPoint.push_back(m_vertexPoint[sharesWith]);
+            m_vertexRing.push_back(m_vertexRing[sharesWith]);
+            m_vertexRing[sharesWith] = v;
+        }
+        return v;
+    }
+
+    void addFace(const uint32_t* corners, uint32_t count) {
+        uint32_t face = static_cast<uint32_t>(m_faces.size());
+        uint32_t base = static_cast<uint32_t>(m_halfEdges.size());
+        m_faces.push_back(base);
+        for (uint32_t k = 0; k < count; k++) {
+            HalfEdge he;
+            he.vertex = corners[k];
+            he.next = base + (k + 1) % count;
+            he.face = face;
+            m_halfEdges.push_back(he);
+        }
+        m_trianglesDirty = true;
+        m_triangleFacesBuilt = false;
+    }
+
+    // Twins by welded point, from half-edges sorted by directed edge; past
+    // the second face on an edge, the rest stay boundaries
+    void pairTwins() {
+        struct Directed {
+            uint64_t key;
+            uint32_t halfEdge;
+            bool operator<(const Directed& o) const { return key != o.key ? key < o.key : halfEdge < o.halfEdge; }
+        };
+        std::vector<Directed> byEdge;
+        byEdge.reserve(m_halfEdges.size());
+        for (uint32_t h = 0; h < m_halfEdges.size(); h++) {
+            uint32_t from = m_vertexPoint[m_halfEdges[h].vertex], to = m_vertexPoint[target(h)];
+            if (from != to) byEdge.push_back({directedKey(from, to), h});
+        }
+        std::sort(byEdge.begin(), byEdge.end());
+        for (const Directed& d : byEdge) {
+            uint32_t h = d.halfEdge;
+            if (m_halfEdges[h].twin != INVALID) continue;
+            uint64_t reverse = (d.key << 32) | (d.key >> 32);
+            auto it = std::lower_bound(byEdge.begin(), byEdge.end(), Directed{reverse, 0});
+            for (; it != byEdge.end() && it->key == reverse; ++it) {
+                if (m_halfEdges[it->halfEdge].twin == INVALID) {
+                    link(h, it->halfEdge);
+                    break;
+                }
+            }
+        }
+    }
+
+    void link(uint32_t a, uint32_t b) {
+        m_halfEdges[a].twin = b;
+        m_halfEdges[b].twin = a;
+    }
+
+    template <typename Vertex>
+    static Vertex midpoint(const Vertex& a, const Vertex& b) {
+        Vertex m = a;
+        for (int k = 0; k < 3; k++) m.pos[k] = (a.pos[k] + b.pos[k]) * 0.5f;
+        for (int k = 0; k < 3; k++) m.normal[k] = (a.normal[k] + b.normal[k]) * 0.5f;
+        for (int k = 0; k < 2; k++) m.uv[k] = (a.uv[k] + b.uv[k]) * 0.5f;
+        return m;
+    }
+
+    // a -> b becomes a -> m -> b, and the twin b -> a becomes b -> m -> a;
+    // the twin side gets its own midpoint vertex across a seam
+    template <typename Vertex>
+    void splitEdge(std::vector<Vertex>& vertices, uint32_t h) {
+        uint32_t a = m_halfEdges[h].vertex, b = target(h);
+        uint32_t mid = addVertex(vertices, midpoint(vertices[a], vertices[b]), INVALID);
+
+        uint32_t rest = static_cast<uint32_t>(m_halfEdges.size());
+        HalfEdge he;
+        he.vertex = mid;
+        he.next = m_halfEdges[h].next;
+        he.face = m_halfEdges[h].face;
+        m_halfEdges.push_back(he);
+        m_halfEdges[h].next = rest;
+
+        uint32_t t = m_halfEdges[h].twin;
+        if (t == INVALID) return;
+        uint32_t ta = m_halfEdges[t].vertex, tb = target(t);
+        uint32_t twinMid = (ta == b && tb == a) ? mid : addVertex(vertices, midpoint(vertices[ta], vertices[tb]), mid);
+
+        uint32_t twinRest = static_cast<uint32_t>(m_halfEdges.size());
+        he.vertex = twinMid;
+        he.next = m_halfEdges[t].next;
+        he.face = m_halfEdges[t].face;
+        m_halfEdges.push_back(he);
+        m_halfEdges[t].next = twinRest;
+
+        link(h, twinRest);
+        link(rest, t);
+    }
+
+    std::vector<HalfEdge> m_halfEdges;
+    std::vector<uint32_t> m_faces;        // One half-edge per face
+    std::vector<uint32_t> m_vertexPoint;  // Welded position of each vertex
+    std::vector<uint32_t> m_vertexRing;   // Next vertex at the same point
+    uint32_t m_pointCount = 0;
+
+    mutable std::vector<uint32_t> m_triangles;
+    mutable std::vector<uint32_t> m_triangleFaces;
+    mutable bool m_trianglesDirty = true;
+    mutable bool m_triangleFacesBuilt = false;  // m_triangleFaces still in build() order
+};
+
+} // namespace eden
+
+#endif // EDEN_HALF_EDGE_MESH_H
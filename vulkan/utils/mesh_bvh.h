@@ -0,0 +1,498 @@
+// ============================================================================
+// MESH BVH - Triangle bounding volume hierarchy for editor picking
+// ============================================================================
+// ESE picked by testing every vertex or triangle of the mesh on each click.
+// This keeps a BVH over the triangles of an index buffer instead:
+//
+//   - build() splits with a binned surface area heuristic (SAH_BINS bins per
+//     axis), leaves of up to MAX_LEAF triangles. Nodes are 32 bytes in one
+//     array, siblings adjacent, every child after its parent.
+//   - refit() recomputes the bounds bottom-up after vertices moved (a gizmo
+//     drag) without changing the tree; build() again only when the
+//     triangles themselves changed (extrusion, edge loops, a new mesh).
+//   - intersect() is the closest ray hit (Moller-Trumbore, as the pickers
+//     did, with a scale-relative parallel test), optionally back-face
+//     culled and filtered per triangle.
+//   - forEachNearRay() visits triangles within a cone around a ray, for
+//     vertex and edge picks whose tolerance grows with distance.
+//   - forEachInPlanes() visits triangles that may lie inside a convex
+//     volume, e.g. the frustum of a screen rectangle (rectPlanes()).
+//
+// Triangle numbers are positions in the index buffer / 3, as the editor's
+// face selection uses them. Vertex types need float pos[3] (MeshVertex);
+// the vertex and index arrays are passed to every call that reads them.
+//
+// Header-only, like core/handle_pool.h.
+//
+// Usage:
+//   eden::MeshBVH bvh;
+//   bvh.build(mesh.getVertices(), mesh.getIndices());
+//   eden::MeshBVH::Hit hit;
+//   if (bvh.intersect(mesh.getVertices(), mesh.getIndices(), origin, dir, hit, true)) {
+//       selectFace(hit.triangle);
+//   }
+//   // ... after dragging vertices:
+//   bvh.refit(mesh.getVertices(), mesh.getIndices());
+// ============================================================================
+
+#ifndef EDEN_MESH_BVH_H
+#define EDEN_MESH_BVH_H
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace eden {
+
+class MeshBVH {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+    static constexpr int SAH_BINS = 12;
+    static constexpr uint32_t MAX_LEAF = 4;
+
+    struct Node {
+        float boundsMin[3];
+        uint32_t first;  // Leaf: first entry in the triangle order; else the left child
+        float boundsMax[3];
+        uint32_t count;  // Triangles in a leaf; 0 for an interior node (right child = first + 1)
+    };
+
+    struct Hit {
+        uint32_t triangle = INVALID;
+        float t = FLT_MAX;  // Distance along the ray (dir need not be normalized)
+        float u = 0.0f, v = 0.0f;  // Barycentrics of corners 1 and 2
+    };
+
+    /**
+     * Rebuild over every triangle of `indices`. False (and empty) if an
+     * index is out of range.
+     */
+    template <typename Vertex>
+    bool build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        clear();
+        uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        for (size_t i = 0; i < size_t(triangleCount) * 3; i++) {
+            if (indices[i] >= vertices.size()) return false;
+        }
+        m_vertexCount = vertices.size();
+        if (triangleCount == 0) return true;
+
+        // Bounds and centroid of each triangle, partitioned in place as
+        // nodes split so every node's triangles stay contiguous
+        std::vector<BuildRef> refs(triangleCount);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            refs[t].bounds = triangleBounds(vertices, &indices[size_t(t) * 3]);
+            for (int a = 0; a < 3; a++) refs[t].centroid[a] = 0.5f * (refs[t].bounds.min[a] + refs[t].bounds.max[a]);
+            refs[t].triangle = t;
+        }
+
+        m_nodes.reserve(size_t(triangleCount) * 2 / MAX_LEAF + 1);
+        m_nodes.push_back(Node{});
+        m_nodes[0].first = 0;
+        m_nodes[0].count = triangleCount;
+
+        std::vector<uint32_t> pending(1, 0);
+        while (!pending.empty()) {
+            uint32_t index = pending.back();
+            pending.pop_back();
+
+            uint32_t first = m_nodes[index].first, count = m_nodes[index].count;
+            Bounds bounds, centroidBounds;
+            for (uint32_t i = first; i < first + count; i++) {
+                bounds.grow(refs[i].bounds);
+                centroidBounds.grow(refs[i].centroid);
+            }
+            store(m_nodes[index], bounds);
+            if (count <= MAX_LEAF) continue;
+
+            int axis = -1;
+            float splitPos = 0.0f;
+            float bestCost = findSplit(&refs[first], count, centroidBounds, axis, splitPos);
+            // A split pays one more node visit (costed as a triangle test)
+            if (axis < 0 || bestCost + bounds.area() >= float(count) * bounds.area()) continue;
+
+            BuildRef* begin = &refs[first];
+            BuildRef* mid = std::partition(begin, begin + count,
+                                           [&](const BuildRef& ref) { return ref.centroid[axis] < splitPos; });
+            uint32_t leftCount = static_cast<uint32_t>(mid - begin);
+            if (leftCount == 0 || leftCount == count) continue;
+
+            uint32_t left = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.push_back(Node{});
+            m_nodes.push_back(Node{});
+            m_nodes[left].first = first;
+            m_nodes[left].count = leftCount;
+            m_nodes[left + 1].first = first + leftCount;
+            m_nodes[left + 1].count = count - leftCount;
+            m_nodes[index].first = left;
+            m_nodes[index].count = 0;
+            pending.push_back(left + 1);
+            pending.push_back(left);
+        }
+
+        m_order.resize(triangleCount);
+        for (uint32_t i = 0; i < triangleCount; i++) m_order[i] = refs[i].triangle;
+        return true;
+    }
+
+    /**
+     * Recompute every node's bounds from moved vertices; the same triangles
+     * must still be in the index buffer. False if they aren't (build()).
+     */
+    template <typename Vertex>
+    bool refit(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        if (indices.size() / 3 != m_order.size() || vertices.size() != m_vertexCount) return false;
+        for (size_t i = m_nodes.size(); i-- > 0;) {
+            Node& node = m_nodes[i];
+            Bounds bounds;
+            if (node.count > 0) {
+                for (uint32_t k = node.first; k < node.first + node.count; k++) {
+                    bounds.grow(triangleBounds(vertices, &indices[size_t(m_order[k]) * 3]));
+                }
+            } else {
+                bounds.grow(m_nodes[node.first]);
+                bounds.grow(m_nodes[node.first + 1]);
+            }
+            store(node, bounds);
+        }
+        return true;
+    }
+
+    void clear() {
+        m_nodes.clear();
+        m_order.clear();
+        m_vertexCount = 0;
+    }
+
+    // ------------------------------------------------------------------------
+    // Queries
+    // ------------------------------------------------------------------------
+
+    bool empty() const { return m_nodes.empty(); }
+    uint32_t triangleCount() const { return static_cast<uint32_t>(m_order.size()); }
+    uint32_t nodeCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+    const Node& node(uint32_t index) const { return m_nodes[index]; }
+
+    // Whether this tree still matches the mesh's vertex and triangle counts
+    bool matches(size_t vertexCount, size_t indexCount) const {
+        return vertexCount == m_vertexCount && indexCount / 3 == m_order.size();
+    }
+
+    /**
+     * Closest triangle hit by origin + t * dir, t in (0.001, hit.t) as the
+     * pickers tested it. cullBackFaces skips triangles facing away from
+     * the ray; accept(triangle) can skip others. True if `hit` was updated.
+     */
+    template <typename Vertex, typename Accept>
+    bool intersect(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                   const float origin[3], const float dir[3], Hit& hit, bool cullBackFaces, Accept&& accept) const {
+        if (m_nodes.empty()) return false;
+        float invDir[3];
+        inverse(dir, invDir);
+
+        bool found = false;
+        std::vector<uint32_t> stack(1, 0);
+        while (!stack.empty()) {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            if (node.count > 0) {
+                for (uint32_t k = node.first; k < node.first + node.count; k++) {
+                    uint32_t t = m_order[k];
+                    if (!accept(t)) continue;
+                    float dist, u, v;
+                    if (rayTriangle(vertices, &indices[size_t(t) * 3], origin, dir, cullBackFaces, dist, u, v) &&
+                        dist < hit.t) {
+                        hit.triangle = t;
+                        hit.t = dist;
+                        hit.u = u;
+                        hit.v = v;
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            // Nearer child last, so it's popped first and shrinks hit.t
+            float nearL, nearR;
+            bool hitL = raySlab(m_nodes[node.first], origin, invDir, 0.0f, hit.t, nearL);
+            bool hitR = raySlab(m_nodes[node.first + 1], origin, invDir, 0.0f, hit.t, nearR);
+            if (hitL && hitR) {
+                bool leftFirst = nearL <= nearR;
+                stack.push_back(leftFirst ? node.first + 1 : node.first);
+                stack.push_back(leftFirst ? node.first : node.first + 1);
+            } else if (hitL) {
+                stack.push_back(node.first);
+            } else if (hitR) {
+                stack.push_back(node.first + 1);
+            }
+        }
+        return found;
+    }
+
+    template <typename Vertex>
+    bool intersect(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                   const float origin[3], const float dir[3], Hit& hit, bool cullBackFaces) const {
+        return intersect(vertices, indices, origin, dir, hit, cullBackFaces, [](uint32_t) { return true; });
+    }
+
+    /**
+     * fn(triangle) for every triangle whose bounds come within
+     * slope * t of the ray at distance t (dir normalized), in front of the
+     * origin: candidates for a pick tolerance that grows with distance.
+     */
+    template <typename Fn>
+    void forEachNearRay(const float origin[3], const float dir[3], float slope, Fn&& fn) const {
+        if (m_nodes.empty()) return;
+        std::vector<uint32_t> stack(1, 0);
+        while (!stack.empty()) {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+
+            // Furthest the box reaches along the ray bounds the tolerance
+            float far = 0.0f;
+            for (int a = 0; a < 3; a++) {
+                float center = 0.5f * (node.boundsMin[a] + node.boundsMax[a]);
+                float half = 0.5f * (node.boundsMax[a] - node.boundsMin[a]);
+                far += (center - origin[a]) * dir[a] + half * std::fabs(dir[a]);
+            }
+            if (far < 0.0f) continue;
+            float pad = slope * far;
+            if (!nearRay(node, origin, dir, pad)) continue;
+
+            if (node.count > 0) {
+                for (uint32_t k = node.first; k < node.first + node.count; k++) fn(m_order[k]);
+            } else {
+                stack.push_back(node.first + 1);
+                stack.push_back(node.first);
+            }
+        }
+    }
+
+    /**
+     * fn(triangle) for every triangle whose bounds are not wholly outside
+     * one of the planes (a, b, c, d: inside where ax + by + cz + d >= 0).
+     * Candidates only; the caller tests what it selects.
+     */
+    template <typename Fn>
+    void forEachInPlanes(const float (*planes)[4], int planeCount, Fn&& fn) const {
+        if (m_nodes.empty()) return;
+        std::vector<uint32_t> stack(1, 0);
+        while (!stack.empty()) {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            bool outside = false;
+            for (int p = 0; p < planeCount && !outside; p++) {
+                // The box corner furthest along the plane normal
+                const float* plane = planes[p];
+                float d = plane[3];
+                for (int a = 0; a < 3; a++) d += plane[a] * (plane[a] >= 0.0f ? node.boundsMax[a] : node.boundsMin[a]);
+                outside = d < 0.0f;
+            }
+            if (outside) continue;
+
+            if (node.count > 0) {
+                for (uint32_t k = node.first; k < node.first + node.count; k++) fn(m_order[k]);
+            } else {
+                stack.push_back(node.first + 1);
+                stack.push_back(node.first);
+            }
+        }
+    }
+
+    /**
+     * The five planes (left, right, bottom, top, near) bounding the part of
+     * a view-projection's frustum behind the NDC rectangle x0..x1, y0..y1.
+     * viewProj is column-major (glm::value_ptr), clip w > 0 in front.
+     */
+    static void rectPlanes(const float viewProj[16], float x0, float y0, float x1, float y1, float planes[5][4]) {
+        // Row r of the matrix, so clip[r] = row . (x, y, z, 1)
+        auto row = [&](int r, int c) { return viewProj[c * 4 + r]; };
+        const float bounds[4][2] = {{x0, 1.0f}, {x1, -1.0f}, {y0, 1.0f}, {y1, -1.0f}};
+        for (int p = 0; p < 4; p++) {
+            int r = p < 2 ? 0 : 1;
+            // sign * (clip[r] - bound * w) >= 0
+            for (int c = 0; c < 4; c++) {
+                planes[p][c] = bounds[p][1] * (row(r, c) - bounds[p][0] * row(3, c));
+            }
+        }
+        for (int c = 0; c < 4; c++) planes[4][c] = row(3, c);  // w >= 0
+    }
+
+private:
+    struct Bounds {
+        float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+        float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+        void grow(const float p[3]) {
+            for (int a = 0; a < 3; a++) {
+                min[a] = std::min(min[a], p[a]);
+                max[a] = std::max(max[a], p[a]);
+            }
+        }
+        void grow(const Bounds& b) {
+            for (int a = 0; a < 3; a++) {
+                min[a] = std::min(min[a], b.min[a]);
+                max[a] = std::max(max[a], b.max[a]);
+            }
+        }
+        void grow(const Node& n) {
+            for (int a = 0; a < 3; a++) {
+                min[a] = std::min(min[a], n.boundsMin[a]);
+                max[a] = std::max(max[a], n.boundsMax[a]);
+            }
+        }
+        float area() const {
+            if (min[0] > max[0]) return 0.0f;
+            float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+            return dx * dy + dy * dz + dz * dx;
+        }
+    };
+
+    static void store(Node& node, const Bounds& bounds) {
+        for (int a = 0; a < 3; a++) {
+            node.boundsMin[a] = bounds.min[a];
+            node.boundsMax[a] = bounds.max[a];
+        }
+    }
+
+    template <typename Vertex>
+    static Bounds triangleBounds(const std::vector<Vertex>& vertices, const uint32_t* tri) {
+        Bounds bounds;
+        for (int c = 0; c < 3; c++) bounds.grow(vertices[tri[c]].pos);
+        return bounds;
+    }
+
+    struct BuildRef {
+        Bounds bounds;
+        float centroid[3];
+        uint32_t triangle;
+    };
+
+    // Cheapest binned split of a node's triangles (SAH cost, unscaled by the
+    // node's area), all three axes binned in one pass; axis -1 if the
+    // centroids all coincide
+    static float findSplit(const BuildRef* refs, uint32_t count, const Bounds& centroidBounds, int& axis,
+                           float& splitPos) {
+        Bounds bins[3][SAH_BINS];
+        uint32_t binCounts[3][SAH_BINS] = {};
+        float scale[3];
+        for (int a = 0; a < 3; a++) {
+            float extent = centroidBounds.max[a] - centroidBounds.min[a];
+            scale[a] = extent > 0.0f ? float(SAH_BINS) / extent : 0.0f;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            for (int a = 0; a < 3; a++) {
+                int b = std::min(SAH_BINS - 1, int((refs[i].centroid[a] - centroidBounds.min[a]) * scale[a]));
+                bins[a][b].grow(refs[i].bounds);
+                binCounts[a][b]++;
+            }
+        }
+
+        float bestCost = FLT_MAX;
+        for (int a = 0; a < 3; a++) {
+            if (scale[a] == 0.0f) continue;
+
+            // Sweep from the right, then from the left pricing each plane
+            float rightArea[SAH_BINS - 1];
+            uint32_t rightCount[SAH_BINS - 1];
+            Bounds sweep;
+            uint32_t sum = 0;
+            for (int b = SAH_BINS - 1; b > 0; b--) {
+                sweep.grow(bins[a][b]);
+                sum += binCounts[a][b];
+                rightArea[b - 1] = sweep.area();
+                rightCount[b - 1] = sum;
+            }
+            sweep = Bounds();
+            sum = 0;
+            for (int b = 0; b < SAH_BINS - 1; b++) {
+                sweep.grow(bins[a][b]);
+                sum += binCounts[a][b];
+                float cost = float(sum) * sweep.area() + float(rightCount[b]) * rightArea[b];
+                if (sum > 0 && rightCount[b] > 0 && cost < bestCost) {
+                    bestCost = cost;
+                    axis = a;
+                    splitPos = centroidBounds.min[a] + float(b + 1) / scale[a];
+                }
+            }
+        }
+        return bestCost;
+    }
+
+    static void inverse(const float dir[3], float invDir[3]) {
+        for (int a = 0; a < 3; a++) {
+            invDir[a] = std::fabs(dir[a]) > 1e-12f ? 1.0f / dir[a] : (dir[a] >= 0.0f ? FLT_MAX : -FLT_MAX);
+        }
+    }
+
+    // Slab test against [tMin, tMax]; `entry` is where the ray enters
+    static bool raySlab(const Node& node, const float origin[3], const float invDir[3], float tMin, float tMax,
+                        float& entry) {
+        for (int a = 0; a < 3; a++) {
+            float t0 = (node.boundsMin[a] - origin[a]) * invDir[a];
+            float t1 = (node.boundsMax[a] - origin[a]) * invDir[a];
+            if (t0 > t1) std::swap(t0, t1);
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if (tMin > tMax) return false;
+        }
+        entry = tMin;
+        return true;
+    }
+
+    // Whether the ray passes within `pad` of the box (the box grown by pad)
+    static bool nearRay(const Node& node, const float origin[3], const float dir[3], float pad) {
+        float tMin = 0.0f, tMax = FLT_MAX;
+        for (int a = 0; a < 3; a++) {
+            float lo = node.boundsMin[a] - pad, hi = node.boundsMax[a] + pad;
+            if (std::fabs(dir[a]) < 1e-12f) {
+                if (origin[a] < lo || origin[a] > hi) return false;
+                continue;
+            }
+            float t0 = (lo - origin[a]) / dir[a], t1 = (hi - origin[a]) / dir[a];
+            if (t0 > t1) std::swap(t0, t1);
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if (tMin > tMax) return false;
+        }
+        return true;
+    }
+
+    template <typename Vertex>
+    static bool rayTriangle(const std::vector<Vertex>& vertices, const uint32_t* tri, const float origin[3],
+                            const float dir[3], bool cullBackFaces, float& t, float& u, float& v) {
+        const float* p0 = vertices[tri[0]].pos;
+        const float* p1 = vertices[tri[1]].pos;
+        const float* p2 = vertices[tri[2]].pos;
+        float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        float h[3] = {dir[1] * e2[2] - dir[2] * e2[1], dir[2] * e2[0] - dir[0] * e2[2], dir[0] * e2[1] - dir[1] * e2[0]};
+        float a = e1[0] * h[0] + e1[1] * h[1] + e1[2] * h[2];
+        // a > 0 when the triangle faces the ray's origin. "Parallel" is
+        // relative to the edge lengths: the pickers' fixed 0.0001 rejected
+        // every triangle of a fine sculpt.
+        float e1Sq = e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2];
+        float e2Sq = e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2];
+        if ((cullBackFaces && a <= 0.0f) || a * a <= 1e-12f * e1Sq * e2Sq) return false;
+
+        float f = 1.0f / a;
+        float s[3] = {origin[0] - p0[0], origin[1] - p0[1], origin[2] - p0[2]};
+        u = f * (s[0] * h[0] + s[1] * h[1] + s[2] * h[2]);
+        if (u < 0.0f || u > 1.0f) return false;
+        float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+        v = f * (dir[0] * q[0] + dir[1] * q[1] + dir[2] * q[2]);
+        if (v < 0.0f || u + v > 1.0f) return false;
+        t = f * (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]);
+        return t > 0.001f;
+    }
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_order;  // Triangles, leaf by leaf
+    size_t m_vertexCount = 0;
+};
+
+} // namespace eden
+
+#endif // EDEN_MESH_BVH_H
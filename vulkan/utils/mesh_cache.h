@@ -0,0 +1,380 @@
+// ============================================================================
+// MESH CACHE - Content-hashed binary cache for imported meshes
+// ============================================================================
+// OBJ text parsing (stdlib MeshResource) and GLB import (loadGLB) - plus the
+// LOD chains built on top - run once per asset version instead of on every
+// start. The importer writes its finished, GPU-layout arrays (interleaved
+// vertices, indices, LOD ranges, ...) as 16-byte aligned sections of one
+// file; the next start maps that file and copies the sections straight into
+// the arrays it uploads.
+//
+//   - Key: a 64-bit hash of the source file's bytes, mixed with the
+//     importer's settings (vertex stride, LODs on/off, format version). A
+//     changed asset or importer gets a new file; nothing is ever stale,
+//     and identical assets share an entry.
+//   - Location: <directory>/<key>.<kind>.emc, directory ".eden_cache"
+//     (relative to the working directory) unless setMeshCacheDirectory()
+//     or the EDEN_MESH_CACHE environment variable says otherwise; "" or
+//     "off" disables the cache. Delete the directory to clear it.
+//   - Writes go to a temporary file renamed into place, so a crash or a
+//     second process never leaves a half-written entry. The reader checks
+//     magic, version, kind, key and every section's bounds, and any
+//     mismatch is a miss (the importer runs and rewrites the entry).
+//
+// Header-only, like undo_history.h.
+//
+// Usage:
+//   uint64_t key;
+//   if (eden::meshCacheKey(path, settings, key)) {
+//       std::string file = eden::meshCachePath(key, "obj");
+//       eden::MeshCacheReader reader;
+//       if (reader.open(file, key, eden::MESH_CACHE_KIND_OBJ) && reader.read(0, vertices)) ...
+//       eden::MeshCacheWriter writer;
+//       writer.add(vertices);
+//       writer.write(file, key, eden::MESH_CACHE_KIND_OBJ);
+//   }
+// ============================================================================
+
+#ifndef EDEN_MESH_CACHE_H
+#define EDEN_MESH_CACHE_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EDEN_MESH_CACHE_MMAP 1
+#elif defined(_WIN32)
+#include <direct.h>
+#endif
+
+namespace eden {
+
+constexpr uint32_t MESH_CACHE_VERSION = 1;
+
+// Kinds (FourCC) - one per importer layout
+constexpr uint32_t MESH_CACHE_KIND_OBJ = 0x4D4A424F;  // "OBJM"
+constexpr uint32_t MESH_CACHE_KIND_GLB = 0x4D424C47;  // "GLBM"
+
+namespace mesh_cache_detail {
+
+constexpr char MAGIC[4] = {'E', 'D', 'M', 'C'};
+constexpr size_t SECTION_ALIGN = 16;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t kind;
+    uint32_t sectionCount;
+    uint64_t key;
+    uint64_t fileSize;
+};
+
+struct Section {
+    uint64_t offset;
+    uint64_t size;
+};
+
+inline uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Word-at-a-time hash for cache keys (not cryptographic)
+inline uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t seed = 0) {
+    uint64_t h = seed ^ (size * 0x9E3779B97F4A7C15ull);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ mix(word)) * 0x9E3779B97F4A7C15ull;
+        h = (h << 31) | (h >> 33);
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, size - i);
+    return mix(h ^ mix(tail ^ (size - i)));
+}
+
+// Whole file, read-only: mapped where possible, else one buffered read
+class FileBytes {
+public:
+    FileBytes() = default;
+    FileBytes(const FileBytes&) = delete;
+    FileBytes& operator=(const FileBytes&) = delete;
+
+    ~FileBytes() {
+#ifdef EDEN_MESH_CACHE_MMAP
+        if (m_mapped) munmap(m_mapped, m_size);
+#endif
+    }
+
+    bool open(const std::string& path) {
+#ifdef EDEN_MESH_CACHE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        bool ok = fstat(fd, &info) == 0;
+        m_size = ok ? static_cast<size_t>(info.st_size) : 0;
+        if (ok && m_size > 0) {
+            void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                m_mapped = mapped;
+                m_data = static_cast<const uint8_t*>(mapped);
+            }
+        }
+        ::close(fd);
+        if (!ok) return false;
+        if (m_mapped || m_size == 0) return true;
+#endif
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        m_buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!m_buffer.empty() && !file.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size())) return false;
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+        return true;
+    }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_mapped = nullptr;
+    std::vector<uint8_t> m_buffer;
+};
+
+struct Settings {
+    std::mutex mutex;
+    std::string directory;
+    bool initialized = false;
+};
+
+inline Settings& settings() {
+    static Settings instance;
+    return instance;
+}
+
+inline bool makeDirectory(const std::string& path) {
+#if defined(_WIN32)
+    return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+} // namespace mesh_cache_detail
+
+/**
+ * Where cache entries go ("" disables the cache). Any thread.
+ */
+inline void setMeshCacheDirectory(const std::string& directory) {
+    mesh_cache_detail::Settings& s = mesh_cache_detail::settings();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.directory = directory;
+    s.initialized = true;
+}
+
+inline std::string getMeshCacheDirectory() {
+    mesh_cache_detail::Settings& s = mesh_cache_detail::settings();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.initialized) {
+        const char* env = std::getenv("EDEN_MESH_CACHE");
+        s.directory = env ? env : ".eden_cache";
+        if (s.directory == "off" || s.directory == "0") s.directory.clear();
+        s.initialized = true;
+    }
+    return s.directory;
+}
+
+/**
+ * Cache key for `sourcePath` as imported with `settings` (any value that
+ * changes the importer's output: stride, flags, importer version)
+ * @return false if the cache is disabled or the source can't be read
+ */
+inline bool meshCacheKey(const std::string& sourcePath, uint64_t settings, uint64_t& key) {
+    if (getMeshCacheDirectory().empty()) return false;
+    mesh_cache_detail::FileBytes source;
+    if (!source.open(sourcePath) || source.size() == 0) return false;
+    key = mesh_cache_detail::hashBytes(source.data(), source.size(), mesh_cache_detail::mix(settings));
+    return true;
+}
+
+inline std::string meshCachePath(uint64_t key, const char* kind) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "/%016llx.%s.emc", static_cast<unsigned long long>(key), kind);
+    return getMeshCacheDirectory() + name;
+}
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+class MeshCacheWriter {
+public:
+    // Append a section; returns its index
+    uint32_t add(const void* data, size_t size) {
+        size_t offset = (m_blob.size() + mesh_cache_detail::SECTION_ALIGN - 1) & ~(mesh_cache_detail::SECTION_ALIGN - 1);
+        m_blob.resize(offset + size);
+        if (size > 0) memcpy(m_blob.data() + offset, data, size);
+        m_sections.push_back({offset, size});
+        return static_cast<uint32_t>(m_sections.size() - 1);
+    }
+
+    template <typename T>
+    uint32_t add(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Cache sections hold trivially copyable elements");
+        return add(values.data(), values.size() * sizeof(T));
+    }
+
+    uint32_t add(const std::string& text) {
+        return add(text.data(), text.size());
+    }
+
+    /**
+     * Write all sections to `path` (via a temporary file renamed into place)
+     */
+    bool write(const std::string& path, uint64_t key, uint32_t kind) const {
+        using namespace mesh_cache_detail;
+        size_t slash = path.find_last_of("/\\");
+        if (slash != std::string::npos && slash > 0) makeDirectory(path.substr(0, slash));
+
+        const size_t tableBytes = sizeof(Header) + m_sections.size() * sizeof(Section);
+        const size_t dataStart = (tableBytes + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1);
+        Header header = {};
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = MESH_CACHE_VERSION;
+        header.kind = kind;
+        header.sectionCount = static_cast<uint32_t>(m_sections.size());
+        header.key = key;
+        header.fileSize = dataStart + m_blob.size();
+        std::vector<Section> table = m_sections;
+        for (Section& section : table) section.offset += dataStart;
+
+        std::string temp = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        FILE* file = std::fopen(temp.c_str(), "wb");
+        if (!file) return false;
+        static const uint8_t padding[SECTION_ALIGN] = {};
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  (table.empty() || std::fwrite(table.data(), sizeof(Section), table.size(), file) == table.size()) &&
+                  std::fwrite(padding, 1, dataStart - tableBytes, file) == dataStart - tableBytes &&
+                  (m_blob.empty() || std::fwrite(m_blob.data(), 1, m_blob.size(), file) == m_blob.size());
+        ok = std::fclose(file) == 0 && ok;
+#if defined(_WIN32)
+        if (ok) std::remove(path.c_str());  // rename() doesn't replace on Windows
+#endif
+        if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> m_blob;                       // Section data, offsets relative to its start
+    std::vector<mesh_cache_detail::Section> m_sections;
+};
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+class MeshCacheReader {
+public:
+    /**
+     * Map `path` and validate it against `key` and `kind`
+     * @return false on a miss (absent, foreign or damaged entry)
+     */
+    bool open(const std::string& path, uint64_t key, uint32_t kind) {
+        using namespace mesh_cache_detail;
+        m_sections = nullptr;
+        m_sectionCount = 0;
+        if (!m_file.open(path) || m_file.size() < sizeof(Header)) return false;
+
+        Header header;
+        memcpy(&header, m_file.data(), sizeof(header));
+        if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != MESH_CACHE_VERSION ||
+            header.kind != kind || header.key != key || header.fileSize != m_file.size()) {
+            return false;
+        }
+        size_t tableEnd = sizeof(Header) + size_t(header.sectionCount) * sizeof(Section);
+        if (tableEnd > m_file.size()) return false;
+        const Section* sections = reinterpret_cast<const Section*>(m_file.data() + sizeof(Header));
+        for (uint32_t i = 0; i < header.sectionCount; i++) {
+            if (sections[i].offset > m_file.size() || sections[i].size > m_file.size() - sections[i].offset) {
+                return false;
+            }
+        }
+        m_sections = sections;
+        m_sectionCount = header.sectionCount;
+        return true;
+    }
+
+    uint32_t sectionCount() const { return m_sectionCount; }
+
+    // Section bytes (nullptr if out of range); valid while the reader lives
+    const uint8_t* section(uint32_t index, size_t& size) const {
+        if (index >= m_sectionCount) return nullptr;
+        size = static_cast<size_t>(m_sections[index].size);
+        return m_file.data() + m_sections[index].offset;
+    }
+
+    // Section as an array of T; false if absent or not a whole number of T
+    template <typename T>
+    bool read(uint32_t index, std::vector<T>& out) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Cache sections hold trivially copyable elements");
+        size_t size = 0;
+        const uint8_t* data = section(index, size);
+        if (!data || size % sizeof(T) != 0) return false;
+        out.resize(size / sizeof(T));
+        if (size > 0) memcpy(out.data(), data, size);
+        return true;
+    }
+
+    // Section as one T (e.g. an importer's metadata struct)
+    template <typename T>
+    bool read(uint32_t index, T& out) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Cache sections hold trivially copyable elements");
+        size_t size = 0;
+        const uint8_t* data = section(index, size);
+        if (!data || size != sizeof(T)) return false;
+        memcpy(&out, data, sizeof(T));
+        return true;
+    }
+
+    bool read(uint32_t index, std::string& out) const {
+        size_t size = 0;
+        const uint8_t* data = section(index, size);
+        if (!data) return false;
+        out.assign(reinterpret_cast<const char*>(data), size);
+        return true;
+    }
+
+private:
+    mesh_cache_detail::FileBytes m_file;
+    const mesh_cache_detail::Section* m_sections = nullptr;
+    uint32_t m_sectionCount = 0;
+};
+
+} // namespace eden
+
+#endif // EDEN_MESH_CACHE_H
@@ -0,0 +1,351 @@
+// ============================================================================
+// OBJECT GRID - Uniform-grid broadphase for world object queries
+// ============================================================================
+// Crosshair picking, vehicle grounding and block snapping cast a ray against
+// the world's boxes every frame. Testing every object is fine for a test
+// room and not for a scrapyard with tens of thousands of blocks, so objects
+// live in a sparse uniform grid kept current as they move:
+//
+//   - Each object is an axis-aligned box, listed in every cell it overlaps.
+//     update() on a move only touches the grid when the box crosses into
+//     different cells; moving within its cells just stores the new bounds.
+//   - Boxes covering more than MAX_OBJECT_CELLS cells (floors, buildings)
+//     skip the grid and are tested on every query - there are few of them.
+//   - raycast() walks the cells along the ray (3D DDA, Amanatides & Woo),
+//     clipped to the occupied part of the grid, and stops at the first cell
+//     that ends beyond the closest hit so far. Objects in several cells are
+//     tested once per query.
+//   - Cells are a hash map from packed cell coordinates; empty cells are
+//     dropped, so the grid's size follows the objects, not the world.
+//
+// Hits use the same slab test as rayAABB(): the closest box entered at
+// t >= 0, so a box around the origin doesn't count. `dir` should be
+// normalized, which makes t a distance. Queries reuse internal visit marks:
+// one query at a time.
+//
+// Header-only, like position_hash.h.
+//
+// Usage:
+//   eden::ObjectGrid grid;                      // 4-unit cells
+//   grid.update(id, boxMin, boxMax);           // on create and every move
+//   uint32_t hit = grid.raycast(origin, dir, 1000.0f, t,
+//                               [&](uint32_t id) { return id != vehicle; });
+//   grid.remove(id);
+// ============================================================================
+
+#ifndef EDEN_OBJECT_GRID_H
+#define EDEN_OBJECT_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace eden {
+
+class ObjectGrid {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+    static constexpr float DEFAULT_CELL_SIZE = 4.0f;   // A few blocks; a vehicle spans a handful of cells
+    static constexpr uint32_t MAX_OBJECT_CELLS = 64;   // Bigger boxes are tested on every query
+
+    explicit ObjectGrid(float cellSize = DEFAULT_CELL_SIZE) { setCellSize(cellSize); }
+
+    // Empties the grid; objects need update() again
+    void setCellSize(float cellSize) {
+        clear();
+        m_cellSize = cellSize > 0.0f ? cellSize : DEFAULT_CELL_SIZE;
+        m_invCell = 1.0f / m_cellSize;
+    }
+
+    void clear() {
+        m_objects.clear();
+        m_visit.clear();
+        m_cells.clear();
+        m_large.clear();
+        m_stamp = 0;
+        m_gridded = 0;
+        resetOccupied();
+    }
+
+    float cellSize() const { return m_cellSize; }
+    uint32_t objectCount() const { return m_gridded + static_cast<uint32_t>(m_large.size()); }
+    uint32_t cellCount() const { return static_cast<uint32_t>(m_cells.size()); }
+
+    // Adds `id` or moves it to the box [boxMin, boxMax]
+    void update(uint32_t id, const float boxMin[3], const float boxMax[3]) {
+        if (id == INVALID) return;
+        if (id >= m_objects.size()) {
+            m_objects.resize(size_t(id) + 1);
+            m_visit.resize(size_t(id) + 1, 0);
+        }
+        Object& object = m_objects[id];
+
+        int32_t lo[3], hi[3];
+        cellOf(boxMin, lo);
+        cellOf(boxMax, hi);
+        uint64_t cells = 1;
+        for (int a = 0; a < 3; a++) cells *= uint64_t(int64_t(hi[a]) - lo[a] + 1);
+        State state = cells > MAX_OBJECT_CELLS ? State::Large : State::Gridded;
+
+        bool sameCells = object.state == state && state == State::Gridded &&
+                         std::equal(lo, lo + 3, object.lo) && std::equal(hi, hi + 3, object.hi);
+        if (!sameCells && !(object.state == State::Large && state == State::Large)) {
+            unlink(id);
+            object.state = state;
+            std::copy(lo, lo + 3, object.lo);
+            std::copy(hi, hi + 3, object.hi);
+            if (state == State::Large) {
+                object.largeSlot = static_cast<uint32_t>(m_large.size());
+                m_large.push_back(id);
+            } else {
+                forEachCell(object, [&](uint64_t key) { m_cells[key].push_back(id); });
+                m_gridded++;
+                for (int a = 0; a < 3; a++) {
+                    m_occupiedLo[a] = std::min(m_occupiedLo[a], lo[a]);
+                    m_occupiedHi[a] = std::max(m_occupiedHi[a], hi[a]);
+                }
+            }
+        }
+        std::copy(boxMin, boxMin + 3, object.min);
+        std::copy(boxMax, boxMax + 3, object.max);
+    }
+
+    void remove(uint32_t id) {
+        if (id >= m_objects.size()) return;
+        unlink(id);
+        m_objects[id].state = State::Absent;
+    }
+
+    bool contains(uint32_t id) const { return id < m_objects.size() && m_objects[id].state != State::Absent; }
+
+    /**
+     * Closest object whose box the ray enters at 0 <= t < maxT and that
+     * accept(id) lets through; INVALID if none. tHit is set on a hit.
+     */
+    template <typename Accept>
+    uint32_t raycast(const float origin[3], const float dir[3], float maxT, float& tHit, Accept&& accept) {
+        uint32_t stamp = nextStamp();
+        float inv[3];
+        for (int a = 0; a < 3; a++) {
+            inv[a] = std::fabs(dir[a]) < 1e-6f ? (dir[a] >= 0.0f ? 1e6f : -1e6f) : 1.0f / dir[a];
+        }
+
+        uint32_t best = INVALID;
+        float bestT = maxT;
+        auto test = [&](uint32_t id) {
+            if (m_visit[id] == stamp) return;
+            m_visit[id] = stamp;
+            const Object& object = m_objects[id];
+            float tMin, tMax;
+            slab(origin, inv, object.min, object.max, tMin, tMax);
+            if (tMax >= tMin && tMin >= 0.0f && tMin < bestT && accept(id)) {
+                bestT = tMin;
+                best = id;
+            }
+        };
+        for (uint32_t id : m_large) test(id);
+
+        if (m_gridded > 0) {
+            // Clip to the occupied cells
+            float occupiedMin[3], occupiedMax[3];
+            for (int a = 0; a < 3; a++) {
+                occupiedMin[a] = float(m_occupiedLo[a]) * m_cellSize;
+                occupiedMax[a] = float(int64_t(m_occupiedHi[a]) + 1) * m_cellSize;
+            }
+            float tEnter, tExit;
+            slab(origin, inv, occupiedMin, occupiedMax, tEnter, tExit);
+            tEnter = std::max(tEnter, 0.0f);
+            tExit = std::min(tExit, bestT);
+            if (tEnter <= tExit) walk(origin, dir, inv, tEnter, tExit, bestT, test);
+        }
+
+        if (best != INVALID) tHit = bestT;
+        return best;
+    }
+
+    uint32_t raycast(const float origin[3], const float dir[3], float maxT, float& tHit) {
+        return raycast(origin, dir, maxT, tHit, [](uint32_t) { return true; });
+    }
+
+    // fn(id) once for every object whose box overlaps [boxMin, boxMax]
+    template <typename Fn>
+    void forEachOverlapping(const float boxMin[3], const float boxMax[3], Fn&& fn) {
+        uint32_t stamp = nextStamp();
+        auto test = [&](uint32_t id) {
+            if (m_visit[id] == stamp) return;
+            m_visit[id] = stamp;
+            const Object& object = m_objects[id];
+            for (int a = 0; a < 3; a++) {
+                if (object.max[a] < boxMin[a] || object.min[a] > boxMax[a]) return;
+            }
+            fn(id);
+        };
+        for (uint32_t id : m_large) test(id);
+        if (m_gridded == 0) return;
+
+        Object range;
+        cellOf(boxMin, range.lo);
+        cellOf(boxMax, range.hi);
+        for (int a = 0; a < 3; a++) {
+            range.lo[a] = std::max(range.lo[a], m_occupiedLo[a]);
+            range.hi[a] = std::min(range.hi[a], m_occupiedHi[a]);
+            if (range.lo[a] > range.hi[a]) return;
+        }
+        forEachCell(range, [&](uint64_t key) {
+            auto it = m_cells.find(key);
+            if (it == m_cells.end()) return;
+            for (uint32_t id : it->second) test(id);
+        });
+    }
+
+private:
+    enum class State : uint8_t { Absent, Gridded, Large };
+
+    struct Object {
+        float min[3] = {0.0f, 0.0f, 0.0f};
+        float max[3] = {0.0f, 0.0f, 0.0f};
+        int32_t lo[3] = {0, 0, 0};  // Cells covered, inclusive
+        int32_t hi[3] = {0, 0, 0};
+        State state = State::Absent;
+        uint32_t largeSlot = INVALID;  // Into m_large
+    };
+
+    // Cell coordinates pack into 21 bits per axis: +-1M cells
+    static constexpr int32_t CELL_LIMIT = (1 << 20) - 1;
+
+    void cellOf(const float p[3], int32_t out[3]) const {
+        for (int a = 0; a < 3; a++) {
+            double c = std::floor(double(p[a]) * m_invCell);
+            out[a] = int32_t(std::max(-double(CELL_LIMIT), std::min(double(CELL_LIMIT), c)));
+        }
+    }
+
+    static uint64_t keyOf(int32_t x, int32_t y, int32_t z) {
+        const uint64_t mask = (1u << 21) - 1;
+        return (uint64_t(uint32_t(x)) & mask) | (uint64_t(uint32_t(y)) & mask) << 21 |
+               (uint64_t(uint32_t(z)) & mask) << 42;
+    }
+
+    template <typename Fn>
+    static void forEachCell(const Object& object, Fn&& fn) {
+        for (int32_t x = object.lo[0]; x <= object.hi[0]; x++) {
+            for (int32_t y = object.lo[1]; y <= object.hi[1]; y++) {
+                for (int32_t z = object.lo[2]; z <= object.hi[2]; z++) fn(keyOf(x, y, z));
+            }
+        }
+    }
+
+    // Takes `id` out of whatever lists it is in
+    void unlink(uint32_t id) {
+        Object& object = m_objects[id];
+        if (object.state == State::Large) {
+            uint32_t moved = m_large.back();
+            m_large[object.largeSlot] = moved;
+            m_objects[moved].largeSlot = object.largeSlot;
+            m_large.pop_back();
+            object.largeSlot = INVALID;
+        } else if (object.state == State::Gridded) {
+            forEachCell(object, [&](uint64_t key) {
+                auto it = m_cells.find(key);
+                if (it == m_cells.end()) return;
+                std::vector<uint32_t>& ids = it->second;
+                auto found = std::find(ids.begin(), ids.end(), id);
+                if (found != ids.end()) {
+                    *found = ids.back();
+                    ids.pop_back();
+                }
+                if (ids.empty()) m_cells.erase(it);
+            });
+            if (--m_gridded == 0) resetOccupied();
+        }
+        object.state = State::Absent;
+    }
+
+    // The occupied bounds only grow until the grid empties; queries clip to
+    // them, so stale growth costs a few empty cells, not correctness
+    void resetOccupied() {
+        for (int a = 0; a < 3; a++) {
+            m_occupiedLo[a] = CELL_LIMIT;
+            m_occupiedHi[a] = -CELL_LIMIT;
+        }
+    }
+
+    uint32_t nextStamp() {
+        if (++m_stamp == 0) {
+            std::fill(m_visit.begin(), m_visit.end(), 0);
+            m_stamp = 1;
+        }
+        return m_stamp;
+    }
+
+    // rayAABB()'s slab test, with the reciprocal direction precomputed
+    static void slab(const float origin[3], const float inv[3], const float boxMin[3], const float boxMax[3],
+                     float& tMin, float& tMax) {
+        tMin = -INFINITY;
+        tMax = INFINITY;
+        for (int a = 0; a < 3; a++) {
+            float t0 = (boxMin[a] - origin[a]) * inv[a];
+            float t1 = (boxMax[a] - origin[a]) * inv[a];
+            tMin = std::max(tMin, std::min(t0, t1));
+            tMax = std::min(tMax, std::max(t0, t1));
+        }
+    }
+
+    // Cells along the ray from tEnter to tExit, nearest first
+    template <typename Test>
+    void walk(const float origin[3], const float dir[3], const float inv[3], float tEnter, float tExit,
+              const float& bestT, Test&& test) {
+        int32_t cell[3], step[3];
+        float tNext[3], tDelta[3];
+        for (int a = 0; a < 3; a++) {
+            float p = origin[a] + dir[a] * tEnter;
+            double c = std::floor(double(p) * m_invCell);
+            cell[a] = int32_t(std::max(double(m_occupiedLo[a]), std::min(double(m_occupiedHi[a]), c)));
+            if (dir[a] > 0.0f) {
+                step[a] = 1;
+                tNext[a] = (float(int64_t(cell[a]) + 1) * m_cellSize - origin[a]) * inv[a];
+                tDelta[a] = m_cellSize * inv[a];
+            } else if (dir[a] < 0.0f) {
+                step[a] = -1;
+                tNext[a] = (float(cell[a]) * m_cellSize - origin[a]) * inv[a];
+                tDelta[a] = -m_cellSize * inv[a];
+            } else {
+                step[a] = 0;
+                tNext[a] = INFINITY;
+                tDelta[a] = INFINITY;
+            }
+        }
+
+        while (true) {
+            auto it = m_cells.find(keyOf(cell[0], cell[1], cell[2]));
+            if (it != m_cells.end()) {
+                for (uint32_t id : it->second) test(id);
+            }
+
+            int axis = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+            float tCellExit = tNext[axis];
+            // Anything in later cells is entered after this one ends
+            if (tCellExit >= bestT || tCellExit > tExit) return;
+            cell[axis] += step[axis];
+            if (cell[axis] < m_occupiedLo[axis] || cell[axis] > m_occupiedHi[axis]) return;
+            tNext[axis] += tDelta[axis];
+        }
+    }
+
+    std::vector<Object> m_objects;  // By id
+    std::vector<uint32_t> m_visit;  // Per id: stamp of the last query that tested it
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+    std::vector<uint32_t> m_large;  // Ids too big for the grid
+    uint32_t m_stamp = 0;
+    uint32_t m_gridded = 0;
+    int32_t m_occupiedLo[3];
+    int32_t m_occupiedHi[3];
+    float m_cellSize = DEFAULT_CELL_SIZE;
+    float m_invCell = 1.0f / DEFAULT_CELL_SIZE;
+};
+
+} // namespace eden
+
+#endif // EDEN_OBJECT_GRID_H
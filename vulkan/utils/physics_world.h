@@ -0,0 +1,758 @@
+// ============================================================================
+// PHYSICS WORLD - Box rigid bodies with a sweep-and-prune broadphase
+// ============================================================================
+// Salvage piles are thousands of blocks that fall, stack and get knocked
+// over, stepped at a fixed 60 Hz. Bodies are axis-aligned boxes - blocks
+// stay grid-aligned, so there is no rotation and contacts are a few
+// compares - and each is either static (floors, walls, wrecks) or dynamic:
+//
+//   - Broadphase: incremental sweep-and-prune on x. Dynamic bodies stay
+//     sorted by min x through an insertion sort each tick - bodies move
+//     little between ticks, so it is close to linear - and their bounds are
+//     copied in that order into structure-of-arrays the sweep walks front to
+//     back. Each awake body scans its x neighbours there; statics live apart,
+//     never pair with each other, and find the dynamics their x range
+//     reaches by binary search.
+//   - Narrowphase: box against box, normal along the axis of least overlap.
+//     Contacts start contactMargin before the boxes touch (speculative), so
+//     a falling block stops on the surface instead of sinking into it.
+//   - Solver: sequential impulses with Coulomb friction, warm-started from
+//     the same pair's impulses of the previous tick.
+//   - Islands: dynamic bodies joined by contacts form an island, solved on
+//     its own - islands run in parallel on the shared JobSystem. An island
+//     whose bodies all stayed below sleepSpeed for sleepTime sleeps: its
+//     bodies stop scanning, its contacts are kept as they were, and it costs
+//     next to nothing until an awake body touches it, or it is moved, pushed
+//     or loses a support - then it wakes as a whole.
+//   - step(dt) runs whole fixed ticks from an accumulator;
+//     getInterpolatedPosition() blends the last two ticks for rendering.
+//
+// PhysicsBodyDesc::fromHDM() turns an HDM physics block
+// (hdm_get_physics_properties) into a body. HDM collision type 2 (mesh) uses
+// its collision box - there is no mesh collider.
+//
+// Body ids are generational - stale after removeBody() or clear(), never
+// reused for another body soon after - and stay below 2^31.
+//
+// Header-only, like object_grid.h. Not thread-safe: step() and the setters
+// belong to one thread; step() fans out to the job system internally.
+//
+// Usage:
+//   eden::PhysicsWorld world;
+//   eden::PhysicsBodyDesc desc;
+//   if (eden::PhysicsBodyDesc::fromHDM(phys.collision_type, bounds,
+//                                      phys.is_static != 0, phys.mass, desc)) {
+//       desc.position = spawn;
+//       uint32_t body = world.addBody(desc);
+//   }
+//   world.step(frameDt);                        // 0..maxTicksPerStep ticks
+//   glm::vec3 p = world.getInterpolatedPosition(body);
+//   world.removeBody(body);
+// ============================================================================
+
+#ifndef EDEN_PHYSICS_WORLD_H
+#define EDEN_PHYSICS_WORLD_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "../../stdlib/job_system.h"
+#include "../core/handle_pool.h"
+
+namespace eden {
+
+struct PhysicsBodyDesc {
+    glm::vec3 position = glm::vec3(0.0f);     // Box center
+    glm::vec3 halfExtents = glm::vec3(0.5f);
+    glm::vec3 velocity = glm::vec3(0.0f);     // Dynamic only
+    float mass = 1.0f;                        // <= 0 makes the body static
+    bool isStatic = false;
+    float friction = 0.5f;                    // A pair uses the geometric mean
+    float restitution = 0.0f;                 // A pair uses the larger
+
+    // From an HDM physics block: collision type 0 = none (returns false),
+    // 1 = box, 2 = mesh (its box). Bounds are the full box size.
+    static bool fromHDM(int collisionType, const float bounds[3], bool isStatic, float mass,
+                        PhysicsBodyDesc& out, const glm::vec3& scale = glm::vec3(1.0f)) {
+        if (collisionType <= 0) return false;
+        glm::vec3 size(bounds[0], bounds[1], bounds[2]);
+        out.halfExtents = glm::max(glm::abs(size * scale) * 0.5f, glm::vec3(0.001f));
+        out.isStatic = isStatic || mass <= 0.0f;
+        out.mass = mass;
+        return true;
+    }
+};
+
+struct PhysicsSettings {
+    float tickHz = 60.0f;
+    uint32_t maxTicksPerStep = 4;     // Beyond this step() drops time rather than fall further behind
+    glm::vec3 gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+    uint32_t iterations = 8;          // Solver passes per tick
+    float contactMargin = 0.02f;      // Speculative contact distance
+    float penetrationSlop = 0.005f;   // Overlap left alone, so resting boxes don't jitter
+    float correction = 0.2f;          // Share of the remaining overlap pushed out per tick
+    float bounceSpeed = 1.0f;         // Closing speed below which restitution is ignored
+    float sleepSpeed = 0.05f;
+    float sleepTime = 0.5f;           // Seconds below sleepSpeed before an island sleeps
+};
+
+struct PhysicsContact {
+    uint32_t a, b;          // Body ids; a is dynamic
+    glm::vec3 normal;       // From a towards b
+    float depth;            // Overlap (negative: speculative gap)
+    float impulse;          // Normal impulse of the last tick
+};
+
+struct PhysicsStats {
+    uint32_t staticBodies = 0;
+    uint32_t dynamicBodies = 0;
+    uint32_t awakeBodies = 0;
+    uint32_t pairs = 0;          // Broadphase pairs
+    uint32_t contacts = 0;       // Pairs within the contact margin, sleeping ones included
+    uint32_t islands = 0;
+    uint32_t awakeIslands = 0;
+    float tickMs = 0.0f;         // CPU time of the last tick
+};
+
+class PhysicsWorld {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;   // Same as HandlePool::INVALID_HANDLE
+    static constexpr uint32_t MAX_ID = 0x7FFFFFFFu;   // Ids stay at or below this, so they fit an int
+
+    explicit PhysicsWorld(const PhysicsSettings& settings = PhysicsSettings()) : m_settings(settings) {}
+
+    void setSettings(const PhysicsSettings& settings) { m_settings = settings; }
+    const PhysicsSettings& getSettings() const { return m_settings; }
+
+    void clear() {
+        m_ids.removeAll();   // Keeps generations, so ids from before clear() stay stale
+        m_dynamic.clear();
+        m_static.clear();
+        m_dynamicOrder.clear();
+        m_unsortedAdds = 0;
+        m_contacts.clear();
+        m_sleepingContacts.clear();
+        m_cache.clear();
+        m_reported.clear();
+        m_accumulator = 0.0f;
+        m_stats = PhysicsStats();
+    }
+
+    // INVALID when the id space is exhausted
+    uint32_t addBody(const PhysicsBodyDesc& desc) {
+        bool isStatic = desc.isStatic || desc.mass <= 0.0f;
+        Bodies& bodies = isStatic ? m_static : m_dynamic;
+        uint32_t id = m_ids.insert(BodyRef{isStatic, static_cast<uint32_t>(bodies.size())});
+        if (id == INVALID) return INVALID;
+
+        uint32_t i = bodies.push(id, desc.position, glm::max(glm::abs(desc.halfExtents), glm::vec3(0.001f)));
+        bodies.friction[i] = std::max(desc.friction, 0.0f);
+        bodies.restitution[i] = glm::clamp(desc.restitution, 0.0f, 1.0f);
+        if (isStatic) {
+            wakeTouching(bodies, i);
+        } else {
+            bodies.velocity[i] = desc.velocity;
+            bodies.invMass[i] = 1.0f / desc.mass;
+            m_dynamicOrder.push_back(i);   // The next tick's sort places it
+            m_unsortedAdds++;
+        }
+        return id;
+    }
+
+    // Bodies resting on it wake up and fall
+    void removeBody(uint32_t id) {
+        const BodyRef* found = m_ids.get(id);
+        if (!found) return;
+        BodyRef ref = *found;
+        m_ids.remove(id);
+
+        Bodies& bodies = ref.isStatic ? m_static : m_dynamic;
+        wakeTouching(bodies, ref.index);
+        uint32_t last = static_cast<uint32_t>(bodies.size()) - 1;
+        if (ref.index != last) m_ids[bodies.id[last]].index = ref.index;
+        bodies.swapRemove(ref.index);
+
+        if (!ref.isStatic) {
+            size_t kept = 0;
+            for (uint32_t index : m_dynamicOrder) {
+                if (index == ref.index) continue;
+                m_dynamicOrder[kept++] = index == last ? ref.index : index;
+            }
+            m_dynamicOrder.resize(kept);
+        }
+    }
+
+    bool isValid(uint32_t id) const { return m_ids.contains(id); }
+
+    // Teleports; the body (and whatever it now touches) wakes up
+    void setPosition(uint32_t id, const glm::vec3& position) {
+        const BodyRef* ref = m_ids.get(id);
+        if (!ref) return;
+        Bodies& bodies = ref->isStatic ? m_static : m_dynamic;
+        wakeTouching(bodies, ref->index);
+        bodies.position[ref->index] = position;
+        bodies.previous[ref->index] = position;
+        bodies.updateBounds(ref->index);
+        wakeTouching(bodies, ref->index);
+        if (!ref->isStatic) m_dynamic.wake(ref->index);
+    }
+
+    void setVelocity(uint32_t id, const glm::vec3& velocity) {
+        const BodyRef* ref = m_ids.get(id);
+        if (!ref || ref->isStatic) return;
+        m_dynamic.velocity[ref->index] = velocity;
+        m_dynamic.wake(ref->index);
+    }
+
+    void applyImpulse(uint32_t id, const glm::vec3& impulse) {
+        const BodyRef* ref = m_ids.get(id);
+        if (!ref || ref->isStatic) return;
+        m_dynamic.velocity[ref->index] += impulse * m_dynamic.invMass[ref->index];
+        m_dynamic.wake(ref->index);
+    }
+
+    glm::vec3 getPosition(uint32_t id) const {
+        const BodyRef* ref = m_ids.get(id);
+        if (!ref) return glm::vec3(0.0f);
+        return (ref->isStatic ? m_static : m_dynamic).position[ref->index];
+    }
+
+    // Between the last two ticks by getAlpha() - what rendering should use
+    glm::vec3 getInterpolatedPosition(uint32_t id) const {
+        const BodyRef* ref = m_ids.get(id);
+        if (!ref) return glm::vec3(0.0f);
+        const Bodies& bodies = ref->isStatic ? m_static : m_dynamic;
+        return glm::mix(bodies.previous[ref->index], bodies.position[ref->index], getAlpha());
+    }
+
+    glm::vec3 getVelocity(uint32_t id) const {
+        const BodyRef* ref = m_ids.get(id);
+        if (!ref || ref->isStatic) return glm::vec3(0.0f);
+        return m_dynamic.velocity[ref->index];
+    }
+
+    bool isStatic(uint32_t id) const {
+        const BodyRef* ref = m_ids.get(id);
+        return ref && ref->isStatic;
+    }
+
+    // Statics count as sleeping
+    bool isSleeping(uint32_t id) const {
+        const BodyRef* ref = m_ids.get(id);
+        return !ref || ref->isStatic || !m_dynamic.awake[ref->index];
+    }
+
+    // Runs whole ticks for the time accumulated so far; returns how many
+    uint32_t step(float dt) {
+        const float h = 1.0f / m_settings.tickHz;
+        m_accumulator += std::max(dt, 0.0f);
+        uint32_t ticks = 0;
+        while (m_accumulator >= h && ticks < m_settings.maxTicksPerStep) {
+            tick(h);
+            m_accumulator -= h;
+            ticks++;
+        }
+        if (m_accumulator >= h) m_accumulator = std::fmod(m_accumulator, h);   // Too slow: drop the backlog
+        return ticks;
+    }
+
+    // Share of a tick accumulated but not yet run, in [0, 1)
+    float getAlpha() const { return m_accumulator * m_settings.tickHz; }
+
+    // One tick of h seconds, bypassing the accumulator (replays, tests)
+    void tick(float h) {
+        auto start = std::chrono::steady_clock::now();
+        sortDynamics();
+        findPairs();
+        buildContacts(h);
+        buildIslands();
+        parallel_for(m_awakeIslands.size(), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++) solveIsland(m_awakeIslands[k], h);
+        }, ISLAND_GRAIN);
+        storeContacts();
+
+        m_stats.staticBodies = static_cast<uint32_t>(m_static.size());
+        m_stats.dynamicBodies = static_cast<uint32_t>(m_dynamic.size());
+        m_stats.awakeBodies = 0;
+        for (uint32_t k : m_awakeIslands) m_stats.awakeBodies += m_islandBodyStart[k + 1] - m_islandBodyStart[k];
+        m_stats.pairs = static_cast<uint32_t>(m_pairs.size());
+        m_stats.contacts = static_cast<uint32_t>(m_contacts.size());
+        m_stats.islands = static_cast<uint32_t>(m_islandBodyStart.size()) - 1;
+        m_stats.awakeIslands = static_cast<uint32_t>(m_awakeIslands.size());
+        m_stats.tickMs = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Touching contacts of the awake islands in the last tick
+    const std::vector<PhysicsContact>& getContacts() const { return m_reported; }
+    const PhysicsStats& getStats() const { return m_stats; }
+    uint32_t size() const { return m_ids.size(); }
+
+private:
+    static constexpr size_t ISLAND_GRAIN = 16;   // Islands per job; most are a block or two
+
+    struct BodyRef {
+        bool isStatic = false;
+        uint32_t index = 0;   // Into m_static or m_dynamic
+    };
+
+    // Structure-of-arrays; statics leave the dynamic-only fields at rest
+    struct Bodies {
+        std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+        std::vector<glm::vec3> position, previous, velocity, halfExtents;
+        std::vector<float> invMass, friction, restitution, stillTime;
+        std::vector<uint8_t> awake;   // Bytes, not vector<bool>: islands write them in parallel
+        std::vector<uint32_t> id;
+
+        size_t size() const { return id.size(); }
+
+        uint32_t push(uint32_t bodyId, const glm::vec3& center, const glm::vec3& half) {
+            for (auto* v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ, &invMass, &friction, &restitution, &stillTime}) {
+                v->push_back(0.0f);
+            }
+            position.push_back(center);
+            previous.push_back(center);
+            velocity.push_back(glm::vec3(0.0f));
+            halfExtents.push_back(half);
+            awake.push_back(1);
+            id.push_back(bodyId);
+            uint32_t i = static_cast<uint32_t>(id.size()) - 1;
+            updateBounds(i);
+            return i;
+        }
+
+        // Moves the last body into slot i
+        void swapRemove(uint32_t i) {
+            for (auto* v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ, &invMass, &friction, &restitution, &stillTime}) {
+                (*v)[i] = v->back();
+                v->pop_back();
+            }
+            for (auto* v : {&position, &previous, &velocity, &halfExtents}) {
+                (*v)[i] = v->back();
+                v->pop_back();
+            }
+            awake[i] = awake.back();
+            awake.pop_back();
+            id[i] = id.back();
+            id.pop_back();
+        }
+
+        void clear() {
+            for (auto* v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ, &invMass, &friction, &restitution, &stillTime}) {
+                v->clear();
+            }
+            for (auto* v : {&position, &previous, &velocity, &halfExtents}) v->clear();
+            awake.clear();
+            id.clear();
+        }
+
+        void updateBounds(uint32_t i) {
+            glm::vec3 lo = position[i] - halfExtents[i];
+            glm::vec3 hi = position[i] + halfExtents[i];
+            minX[i] = lo.x; minY[i] = lo.y; minZ[i] = lo.z;
+            maxX[i] = hi.x; maxY[i] = hi.y; maxZ[i] = hi.z;
+        }
+
+        void wake(uint32_t i) {
+            awake[i] = 1;
+            stillTime[i] = 0.0f;
+        }
+    };
+
+    // Dynamic bounds in sweep order
+    struct Sweep {
+        std::vector<float> minX, maxX, minY, maxY, minZ, maxZ;
+        std::vector<uint8_t> awake;
+        std::vector<uint32_t> index;   // Into m_dynamic
+    };
+
+    struct Pair {
+        uint32_t a, b;   // a dynamic; b into m_static when bStatic, else m_dynamic
+        bool bStatic;
+    };
+
+    struct Contact {
+        uint32_t a, b;
+        bool bStatic;
+        glm::vec3 normal;
+        float depth;
+        float normalMass;        // 1 / (invMassA + invMassB)
+        float friction;
+        float bounce;            // Separating speed restitution asks for
+        float normalImpulse;     // Accumulated this tick
+        glm::vec3 tangentImpulse;
+        uint64_t key;            // Id pair, for warm starting
+    };
+
+    struct CachedImpulse {
+        uint64_t key;
+        glm::vec3 normal;
+        float normalImpulse;
+        glm::vec3 tangentImpulse;
+        bool operator<(const CachedImpulse& o) const { return key < o.key; }
+    };
+
+    static bool overlapYZ(const Bodies& A, uint32_t a, const Bodies& B, uint32_t b, float margin) {
+        return A.minY[a] <= B.maxY[b] + margin && B.minY[b] <= A.maxY[a] + margin &&
+               A.minZ[a] <= B.maxZ[b] + margin && B.minZ[b] <= A.maxZ[a] + margin;
+    }
+
+    // Wakes dynamic bodies within the contact margin of bodies[i]
+    void wakeTouching(const Bodies& bodies, uint32_t i) {
+        const float margin = m_settings.contactMargin;
+        for (uint32_t d = 0; d < m_dynamic.size(); d++) {
+            if (m_dynamic.awake[d]) continue;
+            if (m_dynamic.minX[d] <= bodies.maxX[i] + margin && bodies.minX[i] <= m_dynamic.maxX[d] + margin &&
+                overlapYZ(m_dynamic, d, bodies, i, margin)) {
+                m_dynamic.wake(d);
+            }
+        }
+    }
+
+    // Insertion sort: last tick's order is nearly right, so this is close to
+    // linear - unless many bodies were added since, as when a level loads
+    void sortDynamics() {
+        const float* minX = m_dynamic.minX.data();
+        if (m_unsortedAdds * 8 > m_dynamicOrder.size()) {
+            std::sort(m_dynamicOrder.begin(), m_dynamicOrder.end(),
+                      [minX](uint32_t a, uint32_t b) { return minX[a] < minX[b]; });
+            m_unsortedAdds = 0;
+            return;
+        }
+        m_unsortedAdds = 0;
+        for (size_t i = 1; i < m_dynamicOrder.size(); i++) {
+            uint32_t index = m_dynamicOrder[i];
+            float key = minX[index];
+            size_t j = i;
+            for (; j > 0 && minX[m_dynamicOrder[j - 1]] > key; j--) m_dynamicOrder[j] = m_dynamicOrder[j - 1];
+            m_dynamicOrder[j] = index;
+        }
+    }
+
+    // The sweep's copy of the bounds, in m_dynamicOrder; maxima include the
+    // contact margin, so overlap tests are plain compares
+    void fillSweep() {
+        const float margin = m_settings.contactMargin;
+        const size_t n = m_dynamicOrder.size();
+        for (auto* v : {&m_sweep.minX, &m_sweep.maxX, &m_sweep.minY, &m_sweep.maxY, &m_sweep.minZ, &m_sweep.maxZ}) {
+            v->resize(n);
+        }
+        m_sweep.awake.resize(n);
+        m_sweep.index.resize(n);
+        m_awakeSlots.clear();
+        m_maxWidth = 0.0f;
+        for (uint32_t k = 0; k < n; k++) {
+            uint32_t i = m_dynamicOrder[k];
+            m_sweep.minX[k] = m_dynamic.minX[i];
+            m_sweep.maxX[k] = m_dynamic.maxX[i] + margin;
+            m_sweep.minY[k] = m_dynamic.minY[i];
+            m_sweep.maxY[k] = m_dynamic.maxY[i] + margin;
+            m_sweep.minZ[k] = m_dynamic.minZ[i];
+            m_sweep.maxZ[k] = m_dynamic.maxZ[i] + margin;
+            m_sweep.awake[k] = m_dynamic.awake[i];
+            m_sweep.index[k] = i;
+            m_maxWidth = std::max(m_maxWidth, m_sweep.maxX[k] - m_sweep.minX[k]);
+            if (m_dynamic.awake[i]) m_awakeSlots.push_back(k);
+        }
+    }
+
+    // Pairs with at least one awake body - pairs of sleeping bodies are their
+    // kept contacts. With few bodies awake only those scan, ahead and behind;
+    // otherwise everything scans ahead, which visits each x overlap once.
+    void findPairs() {
+        const float margin = m_settings.contactMargin;
+        fillSweep();
+        m_pairs.clear();
+        if (m_awakeSlots.empty()) return;
+
+        // Raw pointers: pushing pairs can't alias them, so they stay in registers
+        const size_t n = m_sweep.index.size();
+        const float *minX = m_sweep.minX.data(), *maxX = m_sweep.maxX.data();
+        const float *minY = m_sweep.minY.data(), *maxY = m_sweep.maxY.data();
+        const float *minZ = m_sweep.minZ.data(), *maxZ = m_sweep.maxZ.data();
+        const uint8_t* awake = m_sweep.awake.data();
+        const uint32_t* index = m_sweep.index.data();
+        auto overlapsYZ = [=](size_t a, size_t b) {
+            return (minY[a] <= maxY[b]) & (minY[b] <= maxY[a]) & (minZ[a] <= maxZ[b]) & (minZ[b] <= maxZ[a]);
+        };
+        if (m_awakeSlots.size() * 2 >= n) {
+            for (size_t k = 0; k < n; k++) {
+                for (size_t j = k + 1; j < n && minX[j] <= maxX[k]; j++) {
+                    if ((awake[k] | awake[j]) && overlapsYZ(k, j)) m_pairs.push_back({index[k], index[j], false});
+                }
+            }
+        } else {
+            for (uint32_t k : m_awakeSlots) {
+                for (size_t j = k + 1; j < n && minX[j] <= maxX[k]; j++) {
+                    if (overlapsYZ(k, j)) m_pairs.push_back({index[k], index[j], false});
+                }
+                // Behind: sleeping bodies that started earlier and reach this
+                // one (awake ones found it scanning ahead)
+                const float reach = minX[k] - m_maxWidth;
+                for (size_t j = k; j-- > 0 && minX[j] >= reach;) {
+                    if (!awake[j] && maxX[j] >= minX[k] && overlapsYZ(k, j)) {
+                        m_pairs.push_back({index[k], index[j], false});
+                    }
+                }
+            }
+        }
+
+        // Statics never pair with each other; each finds the awake dynamics
+        // its x range reaches
+        for (uint32_t st = 0; st < m_static.size(); st++) {
+            const float sMinX = m_static.minX[st], sMaxX = m_static.maxX[st] + margin;
+            const float sMinY = m_static.minY[st], sMaxY = m_static.maxY[st] + margin;
+            const float sMinZ = m_static.minZ[st], sMaxZ = m_static.maxZ[st] + margin;
+            size_t j = std::lower_bound(minX, minX + n, sMinX - m_maxWidth) - minX;
+            for (; j < n && minX[j] <= sMaxX; j++) {
+                if (awake[j] & (maxX[j] >= sMinX) & (minY[j] <= sMaxY) & (sMinY <= maxY[j]) &
+                    (minZ[j] <= sMaxZ) & (sMinZ <= maxZ[j])) {
+                    m_pairs.push_back({index[j], st, true});
+                }
+            }
+        }
+    }
+
+    void buildContacts(float h) {
+        const float margin = m_settings.contactMargin;
+        m_contacts.clear();
+
+        // Sleeping contacts whose bodies still sleep carry over as they were;
+        // the others leave their impulses to the pairs the sweep found
+        bool cacheChanged = false;
+        for (Contact& c : m_sleepingContacts) {
+            const BodyRef* a = m_ids.get(static_cast<uint32_t>(c.key >> 32));
+            const BodyRef* b = m_ids.get(static_cast<uint32_t>(c.key));
+            if (!a || !b) continue;
+            if (!m_dynamic.awake[a->index] && (b->isStatic || !m_dynamic.awake[b->index])) {
+                c.a = a->index;
+                c.b = b->index;
+                m_contacts.push_back(c);
+            } else {
+                m_cache.push_back({c.key, c.normal, c.normalImpulse, c.tangentImpulse});
+                cacheChanged = true;
+            }
+        }
+        m_sleepingContacts.clear();
+        if (cacheChanged) std::sort(m_cache.begin(), m_cache.end());
+
+        for (const Pair& pair : m_pairs) {
+            uint32_t a = pair.a, b = pair.b;
+            // Dynamic pairs in id order, so the cache key and normal sign hold from tick to tick
+            if (!pair.bStatic && m_dynamic.id[a] > m_dynamic.id[b]) std::swap(a, b);
+            const Bodies& B = pair.bStatic ? m_static : m_dynamic;
+
+            glm::vec3 offset = B.position[b] - m_dynamic.position[a];
+            glm::vec3 overlap = m_dynamic.halfExtents[a] + B.halfExtents[b] - glm::abs(offset);
+            int axis = overlap.x < overlap.y ? (overlap.x < overlap.z ? 0 : 2) : (overlap.y < overlap.z ? 1 : 2);
+            if (overlap[axis] < -margin) continue;
+
+            Contact c;
+            c.a = a;
+            c.b = b;
+            c.bStatic = pair.bStatic;
+            c.normal = glm::vec3(0.0f);
+            c.normal[axis] = offset[axis] >= 0.0f ? 1.0f : -1.0f;
+            c.depth = overlap[axis];
+            float invMassB = pair.bStatic ? 0.0f : m_dynamic.invMass[b];
+            c.normalMass = 1.0f / (m_dynamic.invMass[a] + invMassB);
+            c.friction = std::sqrt(m_dynamic.friction[a] * B.friction[b]);
+
+            float closing = glm::dot(B.velocity[b] - m_dynamic.velocity[a], c.normal);
+            float restitution = std::max(m_dynamic.restitution[a], B.restitution[b]);
+            bool hits = c.depth >= 0.0f || closing * h < c.depth;   // Speculative: closes the gap this tick
+            c.bounce = hits && closing < -m_settings.bounceSpeed ? -restitution * closing : 0.0f;
+
+            c.key = (uint64_t(m_dynamic.id[a]) << 32) | B.id[b];
+            c.normalImpulse = 0.0f;
+            c.tangentImpulse = glm::vec3(0.0f);
+            auto cached = std::lower_bound(m_cache.begin(), m_cache.end(), CachedImpulse{c.key, {}, 0.0f, {}});
+            if (cached != m_cache.end() && cached->key == c.key && glm::dot(cached->normal, c.normal) > 0.5f) {
+                c.normalImpulse = cached->normalImpulse;
+                c.tangentImpulse = cached->tangentImpulse;
+            }
+            m_contacts.push_back(c);
+        }
+    }
+
+    uint32_t findRoot(uint32_t i) {
+        while (m_parent[i] != i) {
+            m_parent[i] = m_parent[m_parent[i]];
+            i = m_parent[i];
+        }
+        return i;
+    }
+
+    // Union-find over dynamic-dynamic contacts, then bodies and contacts
+    // bucketed per island (counting sort) so islands solve independently
+    void buildIslands() {
+        const uint32_t n = static_cast<uint32_t>(m_dynamic.size());
+        m_parent.resize(n);
+        std::iota(m_parent.begin(), m_parent.end(), 0u);
+        for (const Contact& c : m_contacts) {
+            if (c.bStatic) continue;
+            uint32_t ra = findRoot(c.a), rb = findRoot(c.b);
+            if (ra != rb) m_parent[ra] = rb;
+        }
+
+        m_rootIsland.assign(n, INVALID);
+        m_bodyIsland.resize(n);
+        uint32_t islands = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t root = findRoot(i);
+            if (m_rootIsland[root] == INVALID) m_rootIsland[root] = islands++;
+            m_bodyIsland[i] = m_rootIsland[root];
+        }
+
+        bucket(islands, n, m_islandBodyStart, m_islandBodies, [&](uint32_t i) { return m_bodyIsland[i]; });
+        bucket(islands, static_cast<uint32_t>(m_contacts.size()), m_islandContactStart, m_islandContacts,
+               [&](uint32_t k) { return m_bodyIsland[m_contacts[k].a]; });
+
+        // An island is awake if any member is: one awake block wakes the pile it touches
+        m_awakeIslands.clear();
+        for (uint32_t k = 0; k < islands; k++) {
+            for (uint32_t i = m_islandBodyStart[k]; i < m_islandBodyStart[k + 1]; i++) {
+                if (m_dynamic.awake[m_islandBodies[i]]) {
+                    m_awakeIslands.push_back(k);
+                    break;
+                }
+            }
+        }
+    }
+
+    template <typename IslandOf>
+    void bucket(uint32_t islands, uint32_t count, std::vector<uint32_t>& start,
+                std::vector<uint32_t>& items, IslandOf islandOf) {
+        start.assign(islands + 1, 0);
+        for (uint32_t i = 0; i < count; i++) start[islandOf(i) + 1]++;
+        for (uint32_t k = 0; k < islands; k++) start[k + 1] += start[k];
+        items.resize(count);
+        m_bucketCursor.assign(start.begin(), start.end() - 1);
+        for (uint32_t i = 0; i < count; i++) items[m_bucketCursor[islandOf(i)]++] = i;
+    }
+
+    void applyContactImpulse(const Contact& c, const glm::vec3& impulse) {
+        m_dynamic.velocity[c.a] -= impulse * m_dynamic.invMass[c.a];
+        if (!c.bStatic) m_dynamic.velocity[c.b] += impulse * m_dynamic.invMass[c.b];
+    }
+
+    glm::vec3 relativeVelocity(const Contact& c) const {
+        glm::vec3 vb = c.bStatic ? glm::vec3(0.0f) : m_dynamic.velocity[c.b];
+        return vb - m_dynamic.velocity[c.a];
+    }
+
+    void solveContact(Contact& c, float h) {
+        // Normal: a gap may close this tick; overlap beyond the slop is pushed out gradually
+        float target = c.depth < 0.0f
+            ? c.depth / h
+            : m_settings.correction * std::max(c.depth - m_settings.penetrationSlop, 0.0f) / h;
+        target = std::max(target, c.bounce);
+        float lambda = (target - glm::dot(relativeVelocity(c), c.normal)) * c.normalMass;
+        float accumulated = std::max(c.normalImpulse + lambda, 0.0f);
+        applyContactImpulse(c, c.normal * (accumulated - c.normalImpulse));
+        c.normalImpulse = accumulated;
+
+        // Friction: stop the sliding, within the cone of the normal impulse
+        glm::vec3 rel = relativeVelocity(c);
+        glm::vec3 sliding = rel - c.normal * glm::dot(rel, c.normal);
+        glm::vec3 tangent = c.tangentImpulse - sliding * c.normalMass;
+        float maxFriction = c.friction * c.normalImpulse;
+        float length2 = glm::dot(tangent, tangent);
+        if (length2 > maxFriction * maxFriction) tangent *= maxFriction / std::sqrt(length2);
+        applyContactImpulse(c, tangent - c.tangentImpulse);
+        c.tangentImpulse = tangent;
+    }
+
+    // Touches only the island's bodies and contacts, so islands run in parallel
+    void solveIsland(uint32_t k, float h) {
+        const uint32_t* bodies = m_islandBodies.data() + m_islandBodyStart[k];
+        const uint32_t bodyCount = m_islandBodyStart[k + 1] - m_islandBodyStart[k];
+        const uint32_t* contacts = m_islandContacts.data() + m_islandContactStart[k];
+        const uint32_t contactCount = m_islandContactStart[k + 1] - m_islandContactStart[k];
+
+        for (uint32_t i = 0; i < bodyCount; i++) m_dynamic.velocity[bodies[i]] += m_settings.gravity * h;
+        for (uint32_t i = 0; i < contactCount; i++) {
+            Contact& c = m_contacts[contacts[i]];
+            applyContactImpulse(c, c.normal * c.normalImpulse + c.tangentImpulse);
+        }
+        for (uint32_t iteration = 0; iteration < m_settings.iterations; iteration++) {
+            for (uint32_t i = 0; i < contactCount; i++) solveContact(m_contacts[contacts[i]], h);
+        }
+
+        const float sleepSpeed2 = m_settings.sleepSpeed * m_settings.sleepSpeed;
+        float stillTime = m_settings.sleepTime;
+        for (uint32_t i = 0; i < bodyCount; i++) {
+            uint32_t b = bodies[i];
+            m_dynamic.previous[b] = m_dynamic.position[b];
+            m_dynamic.position[b] += m_dynamic.velocity[b] * h;
+            m_dynamic.updateBounds(b);
+            const glm::vec3& v = m_dynamic.velocity[b];
+            m_dynamic.stillTime[b] = glm::dot(v, v) < sleepSpeed2 ? m_dynamic.stillTime[b] + h : 0.0f;
+            stillTime = std::min(stillTime, m_dynamic.stillTime[b]);
+        }
+
+        bool sleep = stillTime >= m_settings.sleepTime;
+        for (uint32_t i = 0; i < bodyCount; i++) {
+            uint32_t b = bodies[i];
+            m_dynamic.awake[b] = sleep ? 0 : 1;
+            if (sleep) {
+                m_dynamic.velocity[b] = glm::vec3(0.0f);
+                m_dynamic.previous[b] = m_dynamic.position[b];
+            }
+        }
+    }
+
+    // Sleeping islands keep their contacts whole, so they wake with their
+    // resting forces; the rest go to the warm-start cache and are reported
+    void storeContacts() {
+        m_cache.clear();
+        m_reported.clear();
+        for (const Contact& c : m_contacts) {
+            if (!m_dynamic.awake[c.a] && (c.bStatic || !m_dynamic.awake[c.b])) {
+                m_sleepingContacts.push_back(c);
+                continue;
+            }
+            m_cache.push_back({c.key, c.normal, c.normalImpulse, c.tangentImpulse});
+            if (c.depth >= 0.0f) {
+                const Bodies& B = c.bStatic ? m_static : m_dynamic;
+                m_reported.push_back({m_dynamic.id[c.a], B.id[c.b], c.normal, c.depth, c.normalImpulse});
+            }
+        }
+        std::sort(m_cache.begin(), m_cache.end());
+    }
+
+    PhysicsSettings m_settings;
+    vkcore::HandlePool<BodyRef, 11> m_ids;   // 11 generation bits: ids below 2^31
+    Bodies m_dynamic;
+    Bodies m_static;
+    std::vector<uint32_t> m_dynamicOrder;    // Dynamic indices by min x
+    size_t m_unsortedAdds = 0;               // Appended to m_dynamicOrder since the last sort
+    std::vector<Contact> m_sleepingContacts; // Between sleeping bodies (and statics), by id
+    std::vector<CachedImpulse> m_cache;      // Last tick's awake impulses, sorted by key
+    float m_accumulator = 0.0f;
+
+    // Per-tick scratch, kept to reuse allocations
+    Sweep m_sweep;
+    std::vector<uint32_t> m_awakeSlots;      // Awake bodies' positions in m_sweep
+    float m_maxWidth = 0.0f;                 // Widest dynamic body on x, bounds the scan behind
+    std::vector<Pair> m_pairs;
+    std::vector<Contact> m_contacts;
+    std::vector<uint32_t> m_parent, m_rootIsland, m_bodyIsland;
+    std::vector<uint32_t> m_islandBodyStart, m_islandBodies;
+    std::vector<uint32_t> m_islandContactStart, m_islandContacts;
+    std::vector<uint32_t> m_bucketCursor;
+    std::vector<uint32_t> m_awakeIslands;
+
+    std::vector<PhysicsContact> m_reported;
+    PhysicsStats m_stats;
+};
+
+} // namespace eden
+
+#endif // EDEN_PHYSICS_WORLD_H
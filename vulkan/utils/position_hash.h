@@ -0,0 +1,180 @@
+// ============================================================================
+// POSITION HASH - Coincident-vertex lookup for the ESE mesh editor
+// ============================================================================
+// OBJ meshes duplicate vertices along UV and normal seams, so the editor
+// keeps asking "which vertices sit at this position?". This answers it from
+// a spatial hash built once per operation and shared by the passes that
+// need it (HalfEdgeMesh::build, moving every copy of a selected vertex):
+//
+//   - Positions quantize to integer cells four epsilons wide; a lookup
+//     visits only the cells the epsilon box around the query overlaps (1-8,
+//     about 3.4 on average) and compares real distances, so points either
+//     side of a cell boundary still match. Coincident means closer than
+//     epsilon.
+//   - Cells live in one open-addressed table (linear probing, power-of-two
+//     size, at most half full); the vertices of a cell are a chain through
+//     one next-array, lowest index first. Lookups allocate nothing.
+//   - The hash stores vertex indices, not positions: queries take the same
+//     vertex array it was built from, and it's rebuilt after vertices move.
+//
+// Cell coordinates clamp to +-2^30 - headroom so lookups can step past the
+// last cell without overflowing - so with the default epsilon positions past
+// about 430000 units share boundary cells: still correct, just slower.
+// Non-finite positions are left out of the hash and match nothing.
+//
+// Vertex types need float pos[3] (MeshVertex).
+//
+// Header-only, like core/handle_pool.h.
+//
+// Usage:
+//   eden::PositionHash positions;
+//   positions.build(mesh.getVertices());
+//   positions.forEachNear(mesh.getVertices(), vertex.pos, [&](uint32_t v) { moved.push_back(v); });
+//   topology.build(mesh.getVertices(), mesh.getIndices(), positions);
+// ============================================================================
+
+#ifndef EDEN_POSITION_HASH_H
+#define EDEN_POSITION_HASH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace eden {
+
+class PositionHash {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+    static constexpr float DEFAULT_EPSILON = 1e-4f;  // The editor's coincidence tolerance
+    static constexpr float CELL_EPSILONS = 4.0f;     // Cell width, in epsilons
+    static constexpr int32_t MAX_CELL = 1 << 30;     // Cell coordinate clamp
+
+    template <typename Vertex>
+    void build(const std::vector<Vertex>& vertices, float epsilon = DEFAULT_EPSILON) {
+        uint32_t count = static_cast<uint32_t>(vertices.size());
+        m_epsilon = epsilon;
+        m_invCell = 1.0f / (epsilon * CELL_EPSILONS);
+
+        uint32_t capacity = 16;
+        while (capacity < count * 2u && capacity < (1u << 31)) capacity <<= 1;
+        m_slots.assign(capacity, Slot{});
+        m_mask = capacity - 1;
+        m_next.assign(count, INVALID);
+
+        // Descending, each pushed onto the front of its chain
+        for (uint32_t v = count; v-- > 0;) {
+            if (!isFinite(vertices[v].pos)) continue;
+            int32_t cell[3];
+            cellOf(vertices[v].pos, cell);
+            Slot& slot = findSlot(cell);
+            if (slot.head == INVALID) {
+                slot.cell[0] = cell[0];
+                slot.cell[1] = cell[1];
+                slot.cell[2] = cell[2];
+            }
+            m_next[v] = slot.head;
+            slot.head = v;
+        }
+    }
+
+    void clear() {
+        m_slots.clear();
+        m_next.clear();
+        m_mask = 0;
+    }
+
+    // Vertices it was built over; differs from the vertex array once
+    // vertices were added, which then needs build() again
+    uint32_t vertexCount() const { return static_cast<uint32_t>(m_next.size()); }
+    float epsilon() const { return m_epsilon; }
+
+    /**
+     * fn(vertex) for every vertex closer than epsilon to `position`, cell by
+     * cell (ascending within a cell). `vertices` is the array build() read.
+     */
+    template <typename Vertex, typename Fn>
+    void forEachNear(const std::vector<Vertex>& vertices, const float position[3], Fn&& fn) const {
+        if (m_slots.empty() || !isFinite(position)) return;
+        int32_t lo[3], hi[3];
+        float low[3] = {position[0] - m_epsilon, position[1] - m_epsilon, position[2] - m_epsilon};
+        float high[3] = {position[0] + m_epsilon, position[1] + m_epsilon, position[2] + m_epsilon};
+        cellOf(low, lo);
+        cellOf(high, hi);
+        float limit = m_epsilon * m_epsilon;
+
+        int32_t cell[3];
+        for (cell[0] = lo[0]; cell[0] <= hi[0]; cell[0]++) {
+            for (cell[1] = lo[1]; cell[1] <= hi[1]; cell[1]++) {
+                for (cell[2] = lo[2]; cell[2] <= hi[2]; cell[2]++) {
+                    for (uint32_t v = findSlotConst(cell).head; v != INVALID; v = m_next[v]) {
+                        const float* p = vertices[v].pos;
+                        float dx = p[0] - position[0], dy = p[1] - position[1], dz = p[2] - position[2];
+                        if (dx * dx + dy * dy + dz * dz < limit) fn(v);
+                    }
+                }
+            }
+        }
+    }
+
+    // Lowest-numbered vertex closer than epsilon to `position`, INVALID if none
+    template <typename Vertex>
+    uint32_t firstNear(const std::vector<Vertex>& vertices, const float position[3]) const {
+        uint32_t first = INVALID;
+        forEachNear(vertices, position, [&](uint32_t v) { first = std::min(first, v); });
+        return first;
+    }
+
+private:
+    struct Slot {
+        int32_t cell[3] = {0, 0, 0};
+        uint32_t head = INVALID;  // First vertex in the cell; INVALID = empty slot
+    };
+
+    static bool isFinite(const float p[3]) {
+        return std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2]);
+    }
+
+    // p must be finite
+    void cellOf(const float p[3], int32_t out[3]) const {
+        for (int a = 0; a < 3; a++) {
+            double c = std::floor(double(p[a]) * m_invCell);
+            out[a] = int32_t(std::max(double(-MAX_CELL), std::min(double(MAX_CELL), c)));
+        }
+    }
+
+    uint32_t hashOf(const int32_t cell[3]) const {
+        uint32_t h = uint32_t(cell[0]) * 73856093u ^ uint32_t(cell[1]) * 19349663u ^ uint32_t(cell[2]) * 83492791u;
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        return h & m_mask;
+    }
+
+    static bool sameCell(const Slot& slot, const int32_t cell[3]) {
+        return slot.cell[0] == cell[0] && slot.cell[1] == cell[1] && slot.cell[2] == cell[2];
+    }
+
+    // The cell's slot, or the empty one it would take
+    Slot& findSlot(const int32_t cell[3]) {
+        uint32_t i = hashOf(cell);
+        while (m_slots[i].head != INVALID && !sameCell(m_slots[i], cell)) i = (i + 1) & m_mask;
+        return m_slots[i];
+    }
+
+    const Slot& findSlotConst(const int32_t cell[3]) const {
+        uint32_t i = hashOf(cell);
+        while (m_slots[i].head != INVALID && !sameCell(m_slots[i], cell)) i = (i + 1) & m_mask;
+        return m_slots[i];
+    }
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_next;  // Next vertex in the same cell
+    uint32_t m_mask = 0;
+    float m_epsilon = DEFAULT_EPSILON;
+    float m_invCell = 1.0f / (DEFAULT_EPSILON * CELL_EPSILONS);
+};
+
+} // namespace eden
+
+#endif // EDEN_POSITION_HASH_H
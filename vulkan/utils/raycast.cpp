@@ -3,8 +3,20 @@
 
 #include "raycast.h"
 #include <cmath>
+#include <cfloat>
 #include <algorithm>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define EDEN_RAYCAST_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EDEN_RAYCAST_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EDEN_RAYCAST_NEON 1
+#endif
+
 glm::vec2 screenToNDC(float screenX, float screenY, int width, int height) {
     float ndcX = (2.0f * screenX / width) - 1.0f;
     // Map screen Y=0 (top) to NDC Y=-1 (top), screen Y=height (bottom) to NDC Y=1 (bottom)
@@ -169,3 +181,299 @@ glm::vec2 projectToScreen(const glm::vec3& worldPos,
     return glm::vec2(screenX, screenY);
 }
 
+
+// ============================================================================
+// Batched queries
+// ============================================================================
+
+namespace {
+
+// rayAABB()'s reciprocal: near-zero components become +-1e6
+glm::vec3 slabInverse(const glm::vec3& rayDir) {
+    glm::vec3 dir = glm::normalize(rayDir);
+    const float epsilon = 1e-6f;
+    glm::vec3 invDir;
+    invDir.x = (fabsf(dir.x) < epsilon) ? (dir.x >= 0.0f ? 1e6f : -1e6f) : (1.0f / dir.x);
+    invDir.y = (fabsf(dir.y) < epsilon) ? (dir.y >= 0.0f ? 1e6f : -1e6f) : (1.0f / dir.y);
+    invDir.z = (fabsf(dir.z) < epsilon) ? (dir.z >= 0.0f ? 1e6f : -1e6f) : (1.0f / dir.z);
+    return invDir;
+}
+
+bool slab(const glm::vec3& origin, const glm::vec3& invDir, const AABBArray& boxes, size_t i,
+          float& tMin, float& tMax) {
+    glm::vec3 t0 = (glm::vec3(boxes.minX[i], boxes.minY[i], boxes.minZ[i]) - origin) * invDir;
+    glm::vec3 t1 = (glm::vec3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]) - origin) * invDir;
+    glm::vec3 tMinVec = glm::min(t0, t1);
+    glm::vec3 tMaxVec = glm::max(t0, t1);
+    tMin = glm::max(glm::max(tMinVec.x, tMinVec.y), tMinVec.z);
+    tMax = glm::min(glm::min(tMaxVec.x, tMaxVec.y), tMaxVec.z);
+    return (tMax >= tMin) && (tMax >= 0.0f);
+}
+
+// One SIMD register of floats; comparisons return all-ones lanes as masks.
+// Only what the kernels below need, written once per instruction set.
+#if defined(EDEN_RAYCAST_AVX)
+struct Lanes {
+    static constexpr int N = 8;
+    __m256 v;
+    static Lanes load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static Lanes set1(float f) { return {_mm256_set1_ps(f)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+inline Lanes operator+(Lanes a, Lanes b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Lanes operator-(Lanes a, Lanes b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Lanes operator*(Lanes a, Lanes b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Lanes operator/(Lanes a, Lanes b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline Lanes operator&(Lanes a, Lanes b) { return {_mm256_and_ps(a.v, b.v)}; }
+inline Lanes operator|(Lanes a, Lanes b) { return {_mm256_or_ps(a.v, b.v)}; }
+inline Lanes lanesMin(Lanes a, Lanes b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline Lanes lanesMax(Lanes a, Lanes b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline Lanes operator<(Lanes a, Lanes b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline Lanes operator<=(Lanes a, Lanes b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+inline Lanes operator>(Lanes a, Lanes b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+inline Lanes operator>=(Lanes a, Lanes b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+inline int maskBits(Lanes m) { return _mm256_movemask_ps(m.v); }
+#elif defined(EDEN_RAYCAST_SSE2)
+struct Lanes {
+    static constexpr int N = 4;
+    __m128 v;
+    static Lanes load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static Lanes set1(float f) { return {_mm_set1_ps(f)}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+};
+inline Lanes operator+(Lanes a, Lanes b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Lanes operator-(Lanes a, Lanes b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Lanes operator*(Lanes a, Lanes b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Lanes operator/(Lanes a, Lanes b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Lanes operator&(Lanes a, Lanes b) { return {_mm_and_ps(a.v, b.v)}; }
+inline Lanes operator|(Lanes a, Lanes b) { return {_mm_or_ps(a.v, b.v)}; }
+inline Lanes lanesMin(Lanes a, Lanes b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Lanes lanesMax(Lanes a, Lanes b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Lanes operator<(Lanes a, Lanes b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+inline Lanes operator<=(Lanes a, Lanes b) { return {_mm_cmple_ps(a.v, b.v)}; }
+inline Lanes operator>(Lanes a, Lanes b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+inline Lanes operator>=(Lanes a, Lanes b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+inline int maskBits(Lanes m) { return _mm_movemask_ps(m.v); }
+#elif defined(EDEN_RAYCAST_NEON)
+struct Lanes {
+    static constexpr int N = 4;
+    float32x4_t v;
+    static Lanes load(const float* p) { return {vld1q_f32(p)}; }
+    static Lanes set1(float f) { return {vdupq_n_f32(f)}; }
+    void store(float* p) const { vst1q_f32(p, v); }
+};
+inline Lanes fromMask(uint32x4_t m) { return {vreinterpretq_f32_u32(m)}; }
+inline uint32x4_t toMask(Lanes a) { return vreinterpretq_u32_f32(a.v); }
+inline Lanes operator+(Lanes a, Lanes b) { return {vaddq_f32(a.v, b.v)}; }
+inline Lanes operator-(Lanes a, Lanes b) { return {vsubq_f32(a.v, b.v)}; }
+inline Lanes operator*(Lanes a, Lanes b) { return {vmulq_f32(a.v, b.v)}; }
+inline Lanes operator/(Lanes a, Lanes b) {
+    // No vector divide on ARMv7: divide per lane so results match rayTriangle()
+    float x[4], y[4];
+    vst1q_f32(x, a.v);
+    vst1q_f32(y, b.v);
+    for (int i = 0; i < 4; i++) x[i] /= y[i];
+    return {vld1q_f32(x)};
+}
+inline Lanes operator&(Lanes a, Lanes b) { return fromMask(vandq_u32(toMask(a), toMask(b))); }
+inline Lanes operator|(Lanes a, Lanes b) { return fromMask(vorrq_u32(toMask(a), toMask(b))); }
+inline Lanes lanesMin(Lanes a, Lanes b) { return {vminq_f32(a.v, b.v)}; }
+inline Lanes lanesMax(Lanes a, Lanes b) { return {vmaxq_f32(a.v, b.v)}; }
+inline Lanes operator<(Lanes a, Lanes b) { return fromMask(vcltq_f32(a.v, b.v)); }
+inline Lanes operator<=(Lanes a, Lanes b) { return fromMask(vcleq_f32(a.v, b.v)); }
+inline Lanes operator>(Lanes a, Lanes b) { return fromMask(vcgtq_f32(a.v, b.v)); }
+inline Lanes operator>=(Lanes a, Lanes b) { return fromMask(vcgeq_f32(a.v, b.v)); }
+inline int maskBits(Lanes m) {
+    uint32_t lanes[4];
+    vst1q_u32(lanes, toMask(m));
+    return int((lanes[0] >> 31) | ((lanes[1] >> 31) << 1) | ((lanes[2] >> 31) << 2) | ((lanes[3] >> 31) << 3));
+}
+#endif
+
+#if defined(EDEN_RAYCAST_AVX) || defined(EDEN_RAYCAST_SSE2) || defined(EDEN_RAYCAST_NEON)
+#define EDEN_RAYCAST_SIMD 1
+
+// Slab test of boxes [i, i + N): returns the hit mask, entry/exit in near/far
+inline int slabLanes(const Lanes& ox, const Lanes& oy, const Lanes& oz,
+                     const Lanes& ix, const Lanes& iy, const Lanes& iz,
+                     const AABBArray& boxes, size_t i, Lanes& nearT, Lanes& farT) {
+    Lanes t0x = (Lanes::load(&boxes.minX[i]) - ox) * ix, t1x = (Lanes::load(&boxes.maxX[i]) - ox) * ix;
+    Lanes t0y = (Lanes::load(&boxes.minY[i]) - oy) * iy, t1y = (Lanes::load(&boxes.maxY[i]) - oy) * iy;
+    Lanes t0z = (Lanes::load(&boxes.minZ[i]) - oz) * iz, t1z = (Lanes::load(&boxes.maxZ[i]) - oz) * iz;
+    nearT = lanesMax(lanesMax(lanesMin(t0x, t1x), lanesMin(t0y, t1y)), lanesMin(t0z, t1z));
+    farT = lanesMin(lanesMin(lanesMax(t0x, t1x), lanesMax(t0y, t1y)), lanesMax(t0z, t1z));
+    return maskBits((farT >= nearT) & (farT >= Lanes::set1(0.0f)));
+}
+
+// Rays [first, first + N) of a packet (short packets repeat the last ray;
+// its extra lanes are ignored) against every triangle
+void trianglesLanes(const glm::vec3* rayOrigins, const glm::vec3* rayDirs, size_t first, size_t rayCount,
+                    const glm::vec3* positions, const uint32_t* indices, size_t triangleCount,
+                    RayHit* hits, size_t vertexStride) {
+    const int N = Lanes::N;
+    float buf[6][Lanes::N];
+    for (int k = 0; k < N; k++) {
+        size_t r = std::min(first + size_t(k), rayCount - 1);
+        buf[0][k] = rayOrigins[r].x; buf[1][k] = rayOrigins[r].y; buf[2][k] = rayOrigins[r].z;
+        buf[3][k] = rayDirs[r].x; buf[4][k] = rayDirs[r].y; buf[5][k] = rayDirs[r].z;
+    }
+    Lanes ox = Lanes::load(buf[0]), oy = Lanes::load(buf[1]), oz = Lanes::load(buf[2]);
+    Lanes dx = Lanes::load(buf[3]), dy = Lanes::load(buf[4]), dz = Lanes::load(buf[5]);
+    int active = (1 << int(std::min(size_t(N), rayCount - first))) - 1;
+
+    const float EPSILON = 1e-6f;
+    const Lanes eps = Lanes::set1(EPSILON), negEps = Lanes::set1(-EPSILON);
+    const Lanes zero = Lanes::set1(0.0f), one = Lanes::set1(1.0f);
+    Lanes bestT = Lanes::set1(FLT_MAX);
+    float bestTLanes[Lanes::N];
+    bestT.store(bestTLanes);
+    const char* base = reinterpret_cast<const char*>(positions);
+
+    for (size_t tri = 0; tri < triangleCount; tri++) {
+        const glm::vec3& v0 = *reinterpret_cast<const glm::vec3*>(base + indices[tri * 3] * vertexStride);
+        const glm::vec3& v1 = *reinterpret_cast<const glm::vec3*>(base + indices[tri * 3 + 1] * vertexStride);
+        const glm::vec3& v2 = *reinterpret_cast<const glm::vec3*>(base + indices[tri * 3 + 2] * vertexStride);
+        glm::vec3 edge1 = v1 - v0;
+        glm::vec3 edge2 = v2 - v0;
+        Lanes e1x = Lanes::set1(edge1.x), e1y = Lanes::set1(edge1.y), e1z = Lanes::set1(edge1.z);
+        Lanes e2x = Lanes::set1(edge2.x), e2y = Lanes::set1(edge2.y), e2z = Lanes::set1(edge2.z);
+
+        // Same operation order as rayTriangle(), lane by lane
+        Lanes hx = dy * e2z - e2y * dz, hy = dz * e2x - e2z * dx, hz = dx * e2y - e2x * dy;
+        Lanes a = e1x * hx + e1y * hy + e1z * hz;
+        Lanes f = one / a;
+        Lanes sx = ox - Lanes::set1(v0.x), sy = oy - Lanes::set1(v0.y), sz = oz - Lanes::set1(v0.z);
+        Lanes u = f * (sx * hx + sy * hy + sz * hz);
+        Lanes qx = sy * e1z - e1y * sz, qy = sz * e1x - e1z * sx, qz = sx * e1y - e1x * sy;
+        Lanes v = f * (dx * qx + dy * qy + dz * qz);
+        Lanes t = f * (e2x * qx + e2y * qy + e2z * qz);
+
+        Lanes valid = ((a <= negEps) | (a >= eps)) & (u >= zero) & (u <= one) &
+                      (v >= zero) & (u + v <= one) & (t > eps) & (t < bestT);
+        int bits = maskBits(valid) & active;
+        if (bits == 0) continue;
+
+        // Closer hits are rare next to misses: record them lane by lane
+        float tl[Lanes::N], ul[Lanes::N], vl[Lanes::N];
+        t.store(tl);
+        u.store(ul);
+        v.store(vl);
+        for (int k = 0; k < N; k++) {
+            if (!(bits & (1 << k))) continue;
+            RayHit& hit = hits[first + k];
+            hit.t = tl[k];
+            hit.u = ul[k];
+            hit.v = vl[k];
+            hit.triangle = static_cast<int>(tri);
+            bestTLanes[k] = tl[k];
+        }
+        bestT = Lanes::load(bestTLanes);
+    }
+}
+#endif
+
+} // namespace
+
+int raycastSimdWidth() {
+#if defined(EDEN_RAYCAST_SIMD)
+    return Lanes::N;
+#else
+    return 1;
+#endif
+}
+
+size_t rayAABBs(const glm::vec3& rayOrigin, const glm::vec3& rayDir, const AABBArray& boxes,
+                float* tMin, float* tMax, uint8_t* hit) {
+    glm::vec3 invDir = slabInverse(rayDir);
+    size_t count = boxes.size();
+    size_t hits = 0;
+    size_t i = 0;
+#if defined(EDEN_RAYCAST_SIMD)
+    Lanes ox = Lanes::set1(rayOrigin.x), oy = Lanes::set1(rayOrigin.y), oz = Lanes::set1(rayOrigin.z);
+    Lanes ix = Lanes::set1(invDir.x), iy = Lanes::set1(invDir.y), iz = Lanes::set1(invDir.z);
+    for (; i + Lanes::N <= count; i += Lanes::N) {
+        Lanes nearT, farT;
+        int bits = slabLanes(ox, oy, oz, ix, iy, iz, boxes, i, nearT, farT);
+        if (tMin) nearT.store(tMin + i);
+        if (tMax) farT.store(tMax + i);
+        for (int k = 0; k < Lanes::N; k++) {
+            uint8_t h = uint8_t((bits >> k) & 1);
+            if (hit) hit[i + k] = h;
+            hits += h;
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        float t0, t1;
+        bool h = slab(rayOrigin, invDir, boxes, i, t0, t1);
+        if (tMin) tMin[i] = t0;
+        if (tMax) tMax[i] = t1;
+        if (hit) hit[i] = uint8_t(h);
+        hits += h;
+    }
+    return hits;
+}
+
+int rayAABBsClosest(const glm::vec3& rayOrigin, const glm::vec3& rayDir, const AABBArray& boxes, float& t) {
+    glm::vec3 invDir = slabInverse(rayDir);
+    size_t count = boxes.size();
+    int best = -1;
+    float bestT = FLT_MAX;
+    size_t i = 0;
+#if defined(EDEN_RAYCAST_SIMD)
+    Lanes ox = Lanes::set1(rayOrigin.x), oy = Lanes::set1(rayOrigin.y), oz = Lanes::set1(rayOrigin.z);
+    Lanes ix = Lanes::set1(invDir.x), iy = Lanes::set1(invDir.y), iz = Lanes::set1(invDir.z);
+    for (; i + Lanes::N <= count; i += Lanes::N) {
+        Lanes nearT, farT;
+        int bits = slabLanes(ox, oy, oz, ix, iy, iz, boxes, i, nearT, farT);
+        bits &= maskBits((nearT >= Lanes::set1(0.0f)) & (nearT < Lanes::set1(bestT)));
+        if (bits == 0) continue;
+        float nl[Lanes::N];
+        nearT.store(nl);
+        for (int k = 0; k < Lanes::N; k++) {
+            if ((bits & (1 << k)) && nl[k] < bestT) {
+                bestT = nl[k];
+                best = static_cast<int>(i + k);
+            }
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        float t0, t1;
+        if (slab(rayOrigin, invDir, boxes, i, t0, t1) && t0 >= 0.0f && t0 < bestT) {
+            bestT = t0;
+            best = static_cast<int>(i);
+        }
+    }
+    if (best >= 0) t = bestT;
+    return best;
+}
+
+void rayTrianglesPacket(const glm::vec3* rayOrigins, const glm::vec3* rayDirs, size_t rayCount,
+                        const glm::vec3* positions, const uint32_t* indices, size_t triangleCount,
+                        RayHit* hits, size_t vertexStride) {
+    for (size_t r = 0; r < rayCount; r++) hits[r] = RayHit();
+    if (rayCount == 0 || triangleCount == 0) return;
+#if defined(EDEN_RAYCAST_SIMD)
+    for (size_t first = 0; first < rayCount; first += Lanes::N) {
+        trianglesLanes(rayOrigins, rayDirs, first, rayCount, positions, indices, triangleCount, hits, vertexStride);
+    }
+#else
+    const char* base = reinterpret_cast<const char*>(positions);
+    for (size_t r = 0; r < rayCount; r++) {
+        for (size_t tri = 0; tri < triangleCount; tri++) {
+            const glm::vec3& v0 = *reinterpret_cast<const glm::vec3*>(base + indices[tri * 3] * vertexStride);
+            const glm::vec3& v1 = *reinterpret_cast<const glm::vec3*>(base + indices[tri * 3 + 1] * vertexStride);
+            const glm::vec3& v2 = *reinterpret_cast<const glm::vec3*>(base + indices[tri * 3 + 2] * vertexStride);
+            float t, u, v;
+            if (rayTriangle(rayOrigins[r], rayDirs[r], v0, v1, v2, t, u, v) &&
+                (hits[r].triangle < 0 || t < hits[r].t)) {
+                hits[r].t = t;
+                hits[r].u = u;
+                hits[r].v = v;
+                hits[r].triangle = static_cast<int>(tri);
+            }
+        }
+    }
+#endif
+}
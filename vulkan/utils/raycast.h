@@ -7,6 +7,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
 // AABB structure for ray-AABB intersection
 struct AABB {
     glm::vec3 min;
@@ -43,6 +47,65 @@ bool rayTriangle(const glm::vec3& rayOrigin, const glm::vec3& rayDir,
                  const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
                  float& t, float& u, float& v);
 
+// ============================================================================
+// Batched queries (SIMD: 8 lanes with AVX, 4 with SSE2 / NEON, else scalar)
+// ============================================================================
+
+// Boxes as one column per bound, for rayAABBs()
+struct AABBArray {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+    
+    size_t size() const { return minX.size(); }
+    void clear() { resize(0); }
+    void resize(size_t count) {
+        minX.resize(count); minY.resize(count); minZ.resize(count);
+        maxX.resize(count); maxY.resize(count); maxZ.resize(count);
+    }
+    void add(const AABB& box) {
+        resize(size() + 1);
+        set(size() - 1, box);
+    }
+    void set(size_t i, const AABB& box) {
+        minX[i] = box.min.x; minY[i] = box.min.y; minZ[i] = box.min.z;
+        maxX[i] = box.max.x; maxY[i] = box.max.y; maxZ[i] = box.max.z;
+    }
+    AABB get(size_t i) const {
+        return AABB(glm::vec3(minX[i], minY[i], minZ[i]), glm::vec3(maxX[i], maxY[i], maxZ[i]));
+    }
+};
+
+// rayAABB() against every box, several boxes per instruction. Per box:
+// hit[i] (1/0), tMin[i], tMax[i]; any output may be null. Returns the
+// number of boxes hit.
+size_t rayAABBs(const glm::vec3& rayOrigin, const glm::vec3& rayDir, const AABBArray& boxes,
+                float* tMin, float* tMax, uint8_t* hit);
+
+// Closest box the ray enters at t >= 0 (a box around the origin doesn't
+// count, as in ObjectGrid::raycast); -1 if none. t is its entry distance.
+int rayAABBsClosest(const glm::vec3& rayOrigin, const glm::vec3& rayDir, const AABBArray& boxes, float& t);
+
+// Closest triangle hit of one ray of a packet (triangle -1: none)
+struct RayHit {
+    float t = 0.0f;
+    float u = 0.0f;
+    float v = 0.0f;
+    int triangle = -1;
+};
+
+// rayTriangle() for a packet of rays against an indexed triangle list: the
+// rays share each triangle's edge setup and run one per lane (4 or 8 at a
+// time), so coherent rays - a brush footprint, a probe's hemisphere - pay
+// for the vertex loads once. Any rayCount works; hits[i] is ray i's closest
+// hit (by t, then lowest triangle index). Positions are read every
+// vertexStride bytes, so interleaved vertex arrays don't need copying.
+void rayTrianglesPacket(const glm::vec3* rayOrigins, const glm::vec3* rayDirs, size_t rayCount,
+                        const glm::vec3* positions, const uint32_t* indices, size_t triangleCount,
+                        RayHit* hits, size_t vertexStride = sizeof(glm::vec3));
+
+// Lanes per SIMD pass in this build (1 = scalar)
+int raycastSimdWidth();
+
 // Ray-Plane intersection
 // Returns true if ray hits plane, t is distance along ray to hit point
 bool rayPlane(const glm::vec3& rayOrigin, const glm::vec3& rayDir,
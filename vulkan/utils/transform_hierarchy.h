@@ -0,0 +1,324 @@
+// ============================================================================
+// TRANSFORM HIERARCHY - Parent/child transforms for attached objects
+// ============================================================================
+// Blocks riding a vehicle, and blocks stacked on those blocks, should follow
+// their parent without the game re-deriving every world position from an
+// offset each frame. Nodes here have a local transform relative to their
+// parent, and update() turns them into world transforms:
+//
+//   - Nodes are stored breadth-first in contiguous arrays (roots, then their
+//     children, then grandchildren), so a parent is always computed before
+//     its children and siblings sit next to each other. The order is
+//     rebuilt lazily, in the next update(), after create/destroy/setParent.
+//   - setLocal() marks a node dirty; update() recomputes dirty nodes and
+//     everything under them, from the first dirty slot on, and reports each
+//     node it recomputed. A still vehicle costs nothing; a moving one costs
+//     its own subtree.
+//   - Transforms are what the game's objects have: a position and a yaw
+//     around +Y, in degrees (the same rotation as the cube renderer's).
+//
+// Node ids are stable across reordering; destroyed ids are reused.
+//
+// Header-only, like object_grid.h.
+//
+// Usage:
+//   eden::TransformHierarchy nodes;
+//   uint32_t vehicle = nodes.create();
+//   uint32_t block = nodes.create({{0.0f, 0.5f, 2.0f}, 0.0f}, vehicle);
+//   nodes.setLocal(vehicle, {{x, y, z}, yaw});                       // every frame it moves
+//   nodes.update([&](uint32_t id) { copyToObject(id, nodes.world(id)); });
+// ============================================================================
+
+#ifndef EDEN_TRANSFORM_HIERARCHY_H
+#define EDEN_TRANSFORM_HIERARCHY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace eden {
+
+struct Transform {
+    float position[3] = {0.0f, 0.0f, 0.0f};
+    float yawDegrees = 0.0f;
+};
+
+class TransformHierarchy {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+
+    void clear() {
+        m_slotOf.clear();
+        m_parentOf.clear();
+        m_freeIds.clear();
+        m_idOf.clear();
+        m_parentSlot.clear();
+        m_local.clear();
+        m_world.clear();
+        m_rotation.clear();
+        m_dirty.clear();
+        m_moved.clear();
+        m_updateStamp = 0;
+        m_firstDirty = 0;
+        m_orderDirty = false;
+    }
+
+    // Nodes alive
+    uint32_t size() const { return static_cast<uint32_t>(m_slotOf.size() - m_freeIds.size()); }
+    bool valid(uint32_t id) const { return id < m_slotOf.size() && m_slotOf[id] != INVALID; }
+
+    // A new node under `parent` (INVALID = a root); its world transform is
+    // current after the next update()
+    uint32_t create(const Transform& local = Transform{}, uint32_t parent = INVALID) {
+        uint32_t id;
+        if (!m_freeIds.empty()) {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        } else {
+            id = static_cast<uint32_t>(m_slotOf.size());
+            m_slotOf.push_back(INVALID);
+            m_parentOf.push_back(INVALID);
+        }
+
+        // Appended; update() moves it into breadth-first order
+        uint32_t slot = static_cast<uint32_t>(m_idOf.size());
+        m_slotOf[id] = slot;
+        m_parentOf[id] = valid(parent) ? parent : INVALID;
+        m_idOf.push_back(id);
+        m_parentSlot.push_back(INVALID);
+        m_local.push_back(local);
+        m_world.push_back(local);
+        m_rotation.push_back({1.0f, 0.0f});
+        m_dirty.push_back(1);
+        m_moved.push_back(0);
+        m_firstDirty = std::min(m_firstDirty, slot);
+        m_orderDirty = true;
+        return id;
+    }
+
+    // Children become roots where they are
+    void destroy(uint32_t id) {
+        if (!valid(id)) return;
+        for (uint32_t child = 0; child < m_parentOf.size(); child++) {
+            if (m_parentOf[child] == id && valid(child)) setParent(child, INVALID);
+        }
+        m_idOf[m_slotOf[id]] = INVALID;  // Dropped in the next rebuild
+        m_slotOf[id] = INVALID;
+        m_parentOf[id] = INVALID;
+        m_freeIds.push_back(id);
+        m_orderDirty = true;
+    }
+
+    /**
+     * Moves `id` under `parent` (INVALID = make it a root). With keepWorld it
+     * stays where it is and its local transform changes; without, it keeps
+     * its local transform and moves with the new parent. False if that
+     * would make a node its own ancestor.
+     */
+    bool setParent(uint32_t id, uint32_t parent, bool keepWorld = true) {
+        if (!valid(id)) return false;
+        if (!valid(parent)) parent = INVALID;
+        for (uint32_t p = parent; p != INVALID; p = m_parentOf[p]) {
+            if (p == id) return false;
+        }
+        if (m_parentOf[id] == parent) return true;
+
+        if (keepWorld) {
+            Transform world = computeWorld(id);
+            m_local[m_slotOf[id]] = parent == INVALID ? world : relativeTo(computeWorld(parent), world);
+        }
+        m_parentOf[id] = parent;
+        markDirty(m_slotOf[id]);
+        m_orderDirty = true;
+        return true;
+    }
+
+    uint32_t parent(uint32_t id) const { return valid(id) ? m_parentOf[id] : INVALID; }
+
+    void setLocal(uint32_t id, const Transform& local) {
+        if (!valid(id)) return;
+        m_local[m_slotOf[id]] = local;
+        markDirty(m_slotOf[id]);
+    }
+
+    // Sets the local transform that puts `id` at `world` under its parent
+    void setWorld(uint32_t id, const Transform& world) {
+        if (!valid(id)) return;
+        uint32_t p = m_parentOf[id];
+        setLocal(id, p == INVALID ? world : relativeTo(computeWorld(p), world));
+    }
+
+    const Transform& local(uint32_t id) const { return m_local[m_slotOf[id]]; }
+
+    // As of the last update()
+    const Transform& world(uint32_t id) const { return m_world[m_slotOf[id]]; }
+
+    // Now, from the locals up the chain; for nodes that may be dirty
+    Transform computeWorld(uint32_t id) const {
+        Transform world = m_local[m_slotOf[id]];
+        for (uint32_t p = m_parentOf[id]; p != INVALID; p = m_parentOf[p]) {
+            world = compose(m_local[m_slotOf[p]], world);
+        }
+        return world;
+    }
+
+    /**
+     * Recomputes the world transform of every dirty node and everything
+     * under them, calling changed(id) for each, parents first. Returns how
+     * many changed.
+     */
+    template <typename Fn>
+    uint32_t update(Fn&& changed) {
+        if (m_orderDirty) rebuildOrder();
+        if (++m_updateStamp == 0) {
+            std::fill(m_moved.begin(), m_moved.end(), 0);
+            m_updateStamp = 1;
+        }
+        uint32_t count = static_cast<uint32_t>(m_idOf.size());
+        uint32_t updated = 0;
+        for (uint32_t s = m_firstDirty; s < count; s++) {
+            uint32_t p = m_parentSlot[s];
+            if (!m_dirty[s] && (p == INVALID || m_moved[p] != m_updateStamp)) continue;
+            m_dirty[s] = 0;
+            m_moved[s] = m_updateStamp;
+
+            const Transform& local = m_local[s];
+            Transform& world = m_world[s];
+            if (p == INVALID) {
+                world = local;
+            } else {
+                const Transform& up = m_world[p];
+                const float* r = m_rotation[p].cs;
+                world.position[0] = up.position[0] + local.position[0] * r[0] + local.position[2] * r[1];
+                world.position[1] = up.position[1] + local.position[1];
+                world.position[2] = up.position[2] - local.position[0] * r[1] + local.position[2] * r[0];
+                world.yawDegrees = up.yawDegrees + local.yawDegrees;
+            }
+            float yaw = world.yawDegrees * DEG_TO_RAD;
+            m_rotation[s] = {std::cos(yaw), std::sin(yaw)};
+            changed(m_idOf[s]);
+            updated++;
+        }
+        m_firstDirty = count;
+        return updated;
+    }
+
+    uint32_t update() {
+        return update([](uint32_t) {});
+    }
+
+private:
+    static constexpr float DEG_TO_RAD = 0.0174532925f;
+
+    struct Rotation {
+        float cs[2];  // cos, sin of the world yaw
+    };
+
+    // parent * child: the child's position turns with the parent's yaw
+    static Transform compose(const Transform& parent, const Transform& child) {
+        float yaw = parent.yawDegrees * DEG_TO_RAD;
+        float c = std::cos(yaw), s = std::sin(yaw);
+        Transform out;
+        out.position[0] = parent.position[0] + child.position[0] * c + child.position[2] * s;
+        out.position[1] = parent.position[1] + child.position[1];
+        out.position[2] = parent.position[2] - child.position[0] * s + child.position[2] * c;
+        out.yawDegrees = parent.yawDegrees + child.yawDegrees;
+        return out;
+    }
+
+    // The local transform that puts a child of `parent` at `world`
+    static Transform relativeTo(const Transform& parent, const Transform& world) {
+        float yaw = parent.yawDegrees * DEG_TO_RAD;
+        float c = std::cos(yaw), s = std::sin(yaw);
+        float d[3] = {world.position[0] - parent.position[0], world.position[1] - parent.position[1],
+                      world.position[2] - parent.position[2]};
+        Transform out;
+        out.position[0] = d[0] * c - d[2] * s;
+        out.position[1] = d[1];
+        out.position[2] = d[0] * s + d[2] * c;
+        out.yawDegrees = world.yawDegrees - parent.yawDegrees;
+        return out;
+    }
+
+    void markDirty(uint32_t slot) {
+        m_dirty[slot] = 1;
+        m_firstDirty = std::min(m_firstDirty, slot);
+    }
+
+    // Breadth-first from the roots (in their current order), dropping
+    // destroyed slots
+    void rebuildOrder() {
+        uint32_t idCount = static_cast<uint32_t>(m_slotOf.size());
+        std::vector<uint32_t> childStart(size_t(idCount) + 1, 0);
+        std::vector<uint32_t> order;
+        order.reserve(size());
+        for (uint32_t id : m_idOf) {
+            if (id == INVALID) continue;
+            if (m_parentOf[id] == INVALID) {
+                order.push_back(id);
+            } else {
+                childStart[m_parentOf[id] + 1]++;
+            }
+        }
+        for (uint32_t i = 0; i < idCount; i++) childStart[i + 1] += childStart[i];
+        std::vector<uint32_t> children(childStart[idCount]);
+        std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+        for (uint32_t id : m_idOf) {
+            if (id != INVALID && m_parentOf[id] != INVALID) children[fill[m_parentOf[id]]++] = id;
+        }
+        for (size_t i = 0; i < order.size(); i++) {
+            uint32_t id = order[i];
+            order.insert(order.end(), children.begin() + childStart[id], children.begin() + childStart[id + 1]);
+        }
+
+        uint32_t count = static_cast<uint32_t>(order.size());
+        std::vector<Transform> local(count), world(count);
+        std::vector<Rotation> rotation(count);
+        std::vector<uint8_t> dirty(count);
+        m_firstDirty = count;
+        for (uint32_t s = 0; s < count; s++) {
+            uint32_t old = m_slotOf[order[s]];
+            local[s] = m_local[old];
+            world[s] = m_world[old];
+            rotation[s] = m_rotation[old];
+            dirty[s] = m_dirty[old];
+            if (dirty[s]) m_firstDirty = std::min(m_firstDirty, s);
+        }
+        for (uint32_t s = 0; s < count; s++) m_slotOf[order[s]] = s;
+
+        m_parentSlot.resize(count);
+        for (uint32_t s = 0; s < count; s++) {
+            uint32_t p = m_parentOf[order[s]];
+            m_parentSlot[s] = p == INVALID ? INVALID : m_slotOf[p];
+        }
+        m_idOf = std::move(order);
+        m_local = std::move(local);
+        m_world = std::move(world);
+        m_rotation = std::move(rotation);
+        m_dirty = std::move(dirty);
+        m_moved.assign(count, 0);
+        m_orderDirty = false;
+    }
+
+    // By id
+    std::vector<uint32_t> m_slotOf;    // INVALID = free id
+    std::vector<uint32_t> m_parentOf;  // Parent id
+    std::vector<uint32_t> m_freeIds;
+
+    // By slot, breadth-first once the order is rebuilt
+    std::vector<uint32_t> m_idOf;        // INVALID = destroyed, awaiting the rebuild
+    std::vector<uint32_t> m_parentSlot;  // Always lower than the node's slot
+    std::vector<Transform> m_local;
+    std::vector<Transform> m_world;
+    std::vector<Rotation> m_rotation;    // Of m_world, for the children
+    std::vector<uint8_t> m_dirty;        // Local changed since the last update()
+    std::vector<uint32_t> m_moved;       // Stamp of the last update() that recomputed it
+    uint32_t m_updateStamp = 0;
+    uint32_t m_firstDirty = 0;
+    bool m_orderDirty = false;
+};
+
+} // namespace eden
+
+#endif // EDEN_TRANSFORM_HIERARCHY_H
@@ -0,0 +1,432 @@
+// ============================================================================
+// UNDO HISTORY - Bounded undo stack of sparse array deltas
+// ============================================================================
+// Shared by FacialPainter and the ESE mesh editor. An undo step is a list of
+// SparseDeltas: for each edited array, the indices that changed and their
+// values before the edit (plus the array's old length), never a full copy.
+//
+//   - Steps live in a fixed-capacity ring: pushing past the capacity or
+//     the byte budget drops the oldest steps in O(1), not by shifting.
+//   - The newest HOT_STEPS steps stay as plain bytes so undo is a memcpy.
+//     Older ones are packed on a background thread: indices as zigzag
+//     varint gaps, values XOR'd with the previous element (neighbouring
+//     vertices share high bytes) and zero-run-length encoded. Popping a step
+//     that is still being packed just takes the plain bytes.
+//
+// Header-only, like core/handle_pool.h.
+//
+// Usage:
+//   eden::UndoHistory history(50, 64 * 1024 * 1024);
+//   eden::SparseDelta delta = eden::SparseDelta::diff(after, before);  // Turns after into before
+//   history.push({delta});
+//   std::vector<eden::SparseDelta> step;
+//   if (history.pop(step)) step[0].apply(array);
+// ============================================================================
+
+#ifndef EDEN_UNDO_HISTORY_H
+#define EDEN_UNDO_HISTORY_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace eden {
+
+// ============================================================================
+// Sparse Delta
+// ============================================================================
+// Writes values at indices into an array of trivially copyable elements,
+// after resizing it to resultCount.
+
+struct SparseDelta {
+    uint32_t elementSize = 0;
+    uint32_t resultCount = 0;         // Array length after apply()
+    std::vector<uint32_t> indices;
+    std::vector<uint8_t> values;      // indices.size() * elementSize bytes
+
+    // Delta that turns `from` into `to` (elements compared bytewise)
+    template <typename T>
+    static SparseDelta diff(const std::vector<T>& from, const std::vector<T>& to) {
+        static_assert(std::is_trivially_copyable<T>::value, "SparseDelta needs trivially copyable elements");
+        SparseDelta delta;
+        delta.elementSize = sizeof(T);
+        delta.resultCount = static_cast<uint32_t>(to.size());
+        size_t common = std::min(from.size(), to.size());
+        for (size_t i = 0; i < common; ++i) {
+            if (memcmp(&from[i], &to[i], sizeof(T)) != 0) delta.add(static_cast<uint32_t>(i), to[i]);
+        }
+        for (size_t i = common; i < to.size(); ++i) delta.add(static_cast<uint32_t>(i), to[i]);
+        return delta;
+    }
+
+    // Empty delta over an array that keeps `count` elements
+    template <typename T>
+    static SparseDelta over(size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "SparseDelta needs trivially copyable elements");
+        SparseDelta delta;
+        delta.elementSize = sizeof(T);
+        delta.resultCount = static_cast<uint32_t>(count);
+        return delta;
+    }
+
+    template <typename T>
+    void add(uint32_t index, const T& value) {
+        indices.push_back(index);
+        size_t offset = values.size();
+        values.resize(offset + sizeof(T));
+        memcpy(&values[offset], &value, sizeof(T));
+    }
+
+    // False (array untouched) if T doesn't match the recorded element size
+    template <typename T>
+    bool apply(std::vector<T>& array) const {
+        if (elementSize != sizeof(T)) return false;
+        array.resize(resultCount);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (indices[i] < resultCount) memcpy(&array[indices[i]], &values[i * sizeof(T)], sizeof(T));
+        }
+        return true;
+    }
+
+    bool empty() const { return indices.empty(); }
+};
+
+// ============================================================================
+// Step Encoding
+// ============================================================================
+
+namespace undo_detail {
+
+inline void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    uint8_t bytes[4];
+    memcpy(bytes, &value, 4);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+inline bool getU32(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+    if (end - p < 4) return false;
+    memcpy(&value, p, 4);
+    p += 4;
+    return true;
+}
+
+inline void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) return false;
+        uint8_t byte = *p++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Plain: [deltas] then per delta [elementSize][resultCount][n][indices][values]
+inline std::vector<uint8_t> encodePlain(const std::vector<SparseDelta>& deltas) {
+    size_t bytes = 4;
+    for (const SparseDelta& d : deltas) bytes += 12 + d.indices.size() * 4 + d.values.size();
+    std::vector<uint8_t> out;
+    out.reserve(bytes);
+    putU32(out, static_cast<uint32_t>(deltas.size()));
+    for (const SparseDelta& d : deltas) {
+        putU32(out, d.elementSize);
+        putU32(out, d.resultCount);
+        putU32(out, static_cast<uint32_t>(d.indices.size()));
+        const uint8_t* indexBytes = reinterpret_cast<const uint8_t*>(d.indices.data());
+        out.insert(out.end(), indexBytes, indexBytes + d.indices.size() * 4);
+        out.insert(out.end(), d.values.begin(), d.values.end());
+    }
+    return out;
+}
+
+inline bool decodePlain(const std::vector<uint8_t>& in, std::vector<SparseDelta>& deltas) {
+    const uint8_t* p = in.data();
+    const uint8_t* end = p + in.size();
+    uint32_t count;
+    if (!getU32(p, end, count)) return false;
+    deltas.assign(count, SparseDelta());
+    for (SparseDelta& d : deltas) {
+        uint32_t n;
+        if (!getU32(p, end, d.elementSize) || !getU32(p, end, d.resultCount) || !getU32(p, end, n)) return false;
+        size_t indexBytes = static_cast<size_t>(n) * 4;
+        size_t valueBytes = static_cast<size_t>(n) * d.elementSize;
+        if (static_cast<size_t>(end - p) < indexBytes + valueBytes) return false;
+        d.indices.resize(n);
+        if (n > 0) memcpy(d.indices.data(), p, indexBytes);
+        p += indexBytes;
+        d.values.assign(p, p + valueBytes);
+        p += valueBytes;
+    }
+    return true;
+}
+
+// Packed: varints, zigzag index gaps, XOR'd values with zero runs as (0, run - 1)
+inline std::vector<uint8_t> pack(const std::vector<SparseDelta>& deltas) {
+    std::vector<uint8_t> out;
+    putVarint(out, static_cast<uint32_t>(deltas.size()));
+    for (const SparseDelta& d : deltas) {
+        putVarint(out, d.elementSize);
+        putVarint(out, d.resultCount);
+        putVarint(out, static_cast<uint32_t>(d.indices.size()));
+
+        uint32_t previous = 0;
+        for (uint32_t index : d.indices) {
+            int64_t gap = static_cast<int64_t>(index) - static_cast<int64_t>(previous);
+            putVarint(out, static_cast<uint32_t>((static_cast<uint64_t>(gap) << 1) ^ static_cast<uint64_t>(gap >> 63)));
+            previous = index;
+        }
+
+        size_t run = 0;
+        auto flushRun = [&]() {
+            if (run == 0) return;
+            out.push_back(0);
+            putVarint(out, static_cast<uint32_t>(run - 1));
+            run = 0;
+        };
+        for (size_t i = 0; i < d.values.size(); ++i) {
+            uint8_t byte = i >= d.elementSize ? d.values[i] ^ d.values[i - d.elementSize] : d.values[i];
+            if (byte == 0) {
+                run++;
+            } else {
+                flushRun();
+                out.push_back(byte);
+            }
+        }
+        flushRun();
+    }
+    return out;
+}
+
+inline bool unpack(const std::vector<uint8_t>& in, std::vector<SparseDelta>& deltas) {
+    const uint8_t* p = in.data();
+    const uint8_t* end = p + in.size();
+    uint32_t count;
+    if (!getVarint(p, end, count)) return false;
+    deltas.assign(count, SparseDelta());
+    for (SparseDelta& d : deltas) {
+        uint32_t n;
+        if (!getVarint(p, end, d.elementSize) || !getVarint(p, end, d.resultCount) || !getVarint(p, end, n)) {
+            return false;
+        }
+
+        d.indices.resize(n);
+        uint32_t previous = 0;
+        for (uint32_t& index : d.indices) {
+            uint32_t zigzag;
+            if (!getVarint(p, end, zigzag)) return false;
+            int64_t gap = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            index = static_cast<uint32_t>(static_cast<int64_t>(previous) + gap);
+            previous = index;
+        }
+
+        d.values.resize(static_cast<size_t>(n) * d.elementSize);
+        size_t i = 0;
+        while (i < d.values.size()) {
+            if (p == end) return false;
+            uint8_t byte = *p++;
+            if (byte != 0) {
+                d.values[i++] = byte;
+                continue;
+            }
+            uint32_t run;
+            if (!getVarint(p, end, run) || run >= d.values.size() - i) return false;
+            std::fill(d.values.begin() + i, d.values.begin() + i + run + 1, 0);
+            i += run + 1;
+        }
+        for (size_t j = d.elementSize; j < d.values.size(); ++j) d.values[j] ^= d.values[j - d.elementSize];
+    }
+    return true;
+}
+
+} // namespace undo_detail
+
+// ============================================================================
+// Undo History
+// ============================================================================
+
+class UndoHistory {
+public:
+    static constexpr size_t HOT_STEPS = 4;  // Newest steps kept unpacked
+
+    UndoHistory(size_t capacity, size_t budgetBytes)
+        : m_slots(std::max<size_t>(capacity, 1)), m_budget(budgetBytes) {}
+
+    ~UndoHistory() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable()) m_worker.join();
+    }
+
+    UndoHistory(const UndoHistory&) = delete;
+    UndoHistory& operator=(const UndoHistory&) = delete;
+
+    // Newest step; the oldest ones go when the ring or the budget is full
+    // (the newest step is always kept, even alone over budget)
+    void push(const std::vector<SparseDelta>& deltas) {
+        auto plain = std::make_shared<const std::vector<uint8_t>>(undo_detail::encodePlain(deltas));
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count == m_slots.size()) dropOldest();
+            Slot& slot = m_slots[(m_head + m_count) % m_slots.size()];
+            slot = Slot();
+            slot.id = ++m_nextId;
+            slot.plain = std::move(plain);
+            m_bytes += slot.plain->size();
+            m_count++;
+
+            // The step leaving the hot window gets packed
+            if (m_count > HOT_STEPS) {
+                m_packQueue.push_back(at(m_count - 1 - HOT_STEPS).id);
+                if (!m_worker.joinable()) m_worker = std::thread([this]() { packLoop(); });
+            }
+            enforceBudget();
+        }
+        m_wake.notify_one();
+    }
+
+    // Newest step into `deltas`; false if there is none
+    bool pop(std::vector<SparseDelta>& deltas) {
+        std::shared_ptr<const std::vector<uint8_t>> plain;
+        std::vector<uint8_t> packed;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count == 0) return false;
+            Slot& slot = at(m_count - 1);
+            plain = std::move(slot.plain);
+            packed = std::move(slot.packed);
+            m_bytes -= slot.bytes();
+            slot = Slot();
+            m_count--;
+        }
+        return plain ? undo_detail::decodePlain(*plain, deltas) : undo_detail::unpack(packed, deltas);
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Slot& slot : m_slots) slot = Slot();
+        m_head = 0;
+        m_count = 0;
+        m_bytes = 0;
+        m_packQueue.clear();
+    }
+
+    // Drops the oldest steps until both limits hold
+    void setLimits(size_t capacity, size_t budgetBytes) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        capacity = std::max<size_t>(capacity, 1);
+        while (m_count > capacity) dropOldest();
+        std::vector<Slot> slots(capacity);
+        for (size_t i = 0; i < m_count; ++i) slots[i] = std::move(at(i));
+        m_slots = std::move(slots);
+        m_head = 0;
+        m_budget = budgetBytes;
+        enforceBudget();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Bytes held by the steps (plain or packed)
+    size_t memoryUsage() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bytes;
+    }
+
+private:
+    struct Slot {
+        uint64_t id = 0;
+        std::shared_ptr<const std::vector<uint8_t>> plain;  // Shared with the packer while it works
+        std::vector<uint8_t> packed;
+        size_t bytes() const { return plain ? plain->size() : packed.size(); }
+    };
+
+    // i = 0 is the oldest step (caller holds m_mutex)
+    Slot& at(size_t i) { return m_slots[(m_head + i) % m_slots.size()]; }
+
+    Slot* find(uint64_t id) {
+        for (size_t i = 0; i < m_count; ++i) {
+            if (at(i).id == id) return &at(i);
+        }
+        return nullptr;
+    }
+
+    void dropOldest() {
+        Slot& slot = at(0);
+        m_bytes -= slot.bytes();
+        slot = Slot();
+        m_head = (m_head + 1) % m_slots.size();
+        m_count--;
+    }
+
+    void enforceBudget() {
+        while (m_count > 1 && m_bytes > m_budget) dropOldest();
+    }
+
+    void packLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this]() { return m_stopping || !m_packQueue.empty(); });
+            if (m_stopping) return;
+
+            uint64_t id = m_packQueue.front();
+            m_packQueue.pop_front();
+            Slot* slot = find(id);
+            if (!slot || !slot->plain) continue;
+            std::shared_ptr<const std::vector<uint8_t>> plain = slot->plain;
+
+            lock.unlock();
+            std::vector<SparseDelta> deltas;
+            std::vector<uint8_t> packed;
+            bool ok = undo_detail::decodePlain(*plain, deltas);
+            if (ok) packed = undo_detail::pack(deltas);
+            lock.lock();
+
+            // Popped or dropped meanwhile, or not worth it
+            slot = find(id);
+            if (!ok || !slot || slot->plain != plain || packed.size() >= plain->size()) continue;
+            m_bytes -= plain->size();
+            slot->plain.reset();
+            slot->packed = std::move(packed);
+            m_bytes += slot->packed.size();
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::thread m_worker;                 // Started by the first step to leave the hot window
+    std::deque<uint64_t> m_packQueue;     // Step ids, oldest first
+    bool m_stopping = false;
+
+    std::vector<Slot> m_slots;            // Ring
+    size_t m_head = 0;                    // Oldest step
+    size_t m_count = 0;
+    size_t m_bytes = 0;
+    size_t m_budget = 0;
+    uint64_t m_nextId = 0;
+};
+
+} // namespace eden
+
+#endif // EDEN_UNDO_HISTORY_H
@@ -0,0 +1,245 @@
+// ============================================================================
+// VERTEX EDIT REGION - What a gizmo drag touches, and nothing else
+// ============================================================================
+// Moving, scaling or rotating a selection used to loop over every vertex,
+// rework normals mesh-wide and reupload the whole vertex buffer. A drag
+// moves the same vertices every frame, so this works out once, when it
+// starts, what they affect:
+//
+//   - The triangles using a moved vertex, and the vertices of those
+//     triangles (the one-ring) - the only normals that change.
+//   - Each ring vertex's normal is a sum over its triangles. The triangles
+//     outside the region don't change during the drag, so their part of the
+//     sum is taken once; every frame only re-adds the region's own.
+//   - Seam copies (coincident vertices, through PositionHash) share one
+//     normal when theirs agreed within seamDot at the start and both moved
+//     or both stayed; hard edges (a cube's faces) keep their own.
+//   - The vertices written, as coalesced index ranges for a partial
+//     upload (MeshResource::markVerticesDirty()).
+//
+// forEachMoved() and updateNormals() run in parallel chunks on the shared
+// JobSystem; per frame they cost the region's size, not the mesh's.
+// Normals are area-weighted. build() again when the selection or the
+// triangles change.
+//
+// Vertex types need float pos[3] and normal[3] (MeshVertex).
+//
+// Header-only, like position_hash.h.
+//
+// Usage:
+//   eden::VertexEditRegion region;
+//   region.build(vertices, indices, selectedCopies, positions);  // drag starts
+//   region.forEachMoved([&](uint32_t v) { vertices[v].pos[axis] += delta; });
+//   region.updateNormals(vertices);
+//   for (const auto& r : region.dirtyRanges()) mesh.markVerticesDirty(r.first, r.count);
+// ============================================================================
+
+#ifndef EDEN_VERTEX_EDIT_REGION_H
+#define EDEN_VERTEX_EDIT_REGION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "position_hash.h"
+#include "../../stdlib/job_system.h"
+
+namespace eden {
+
+class VertexEditRegion {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+    static constexpr float DEFAULT_SEAM_DOT = 0.99f;  // Seam copies closer than ~8 degrees share a normal
+    static constexpr uint32_t RANGE_GAP = 64;       // Untouched vertices a dirty range may span
+
+    struct Range {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    /**
+     * Region of `moved` (any order, duplicates allowed) in the mesh
+     * `vertices` / `indices`. `positions` was built over `vertices`; without
+     * it (vertex count differs) seam copies keep separate normals.
+     */
+    template <typename Vertex>
+    void build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+               const std::vector<uint32_t>& moved, const PositionHash& positions,
+               float seamDot = DEFAULT_SEAM_DOT) {
+        clear();
+        uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        bool welded = positions.vertexCount() == vertexCount;
+
+        for (uint32_t v : moved) {
+            if (v < vertexCount) m_moved.push_back(v);
+        }
+        std::sort(m_moved.begin(), m_moved.end());
+        m_moved.erase(std::unique(m_moved.begin(), m_moved.end()), m_moved.end());
+        if (m_moved.empty()) return;
+
+        std::vector<char> isMoved(vertexCount, 0);
+        for (uint32_t v : m_moved) isMoved[v] = 1;
+
+        // Triangles using a moved vertex
+        auto touched = [&](const uint32_t* tri) {
+            return tri[0] < vertexCount && tri[1] < vertexCount && tri[2] < vertexCount &&
+                   (isMoved[tri[0]] || isMoved[tri[1]] || isMoved[tri[2]]);
+        };
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            const uint32_t* tri = &indices[size_t(t) * 3];
+            if (touched(tri)) m_triangles.insert(m_triangles.end(), tri, tri + 3);
+        }
+
+        // Normal groups: each ring vertex, with the seam copies that agree
+        std::vector<uint32_t> groupOf(vertexCount, INVALID);
+        std::vector<uint32_t> members;
+        for (uint32_t corner : m_triangles) {
+            if (groupOf[corner] != INVALID) continue;
+            uint32_t group = static_cast<uint32_t>(m_groupStart.size());
+            m_groupStart.push_back(static_cast<uint32_t>(m_groupVertices.size()));
+            groupOf[corner] = group;
+            m_groupVertices.push_back(corner);
+            if (!welded) continue;
+
+            const float* n = vertices[corner].normal;
+            positions.forEachNear(vertices, vertices[corner].pos, [&](uint32_t copy) {
+                const float* m = vertices[copy].normal;
+                if (groupOf[copy] == INVALID && isMoved[copy] == isMoved[corner] &&
+                    n[0] * m[0] + n[1] * m[1] + n[2] * m[2] > seamDot) {
+                    groupOf[copy] = group;
+                    m_groupVertices.push_back(copy);
+                }
+            });
+        }
+        uint32_t groupCount = static_cast<uint32_t>(m_groupStart.size());
+        m_groupStart.push_back(static_cast<uint32_t>(m_groupVertices.size()));
+
+        // The fixed part of each group's sum: its triangles outside the region
+        m_staticSums.assign(size_t(groupCount) * 3, 0.0f);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            const uint32_t* tri = &indices[size_t(t) * 3];
+            if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount || touched(tri)) continue;
+            if (groupOf[tri[0]] == INVALID && groupOf[tri[1]] == INVALID && groupOf[tri[2]] == INVALID) continue;
+            float n[3];
+            faceNormal(vertices[tri[0]], vertices[tri[1]], vertices[tri[2]], n);
+            for (int k = 0; k < 3; k++) {
+                uint32_t group = groupOf[tri[k]];
+                if (group == INVALID) continue;
+                for (int a = 0; a < 3; a++) m_staticSums[size_t(group) * 3 + a] += n[a];
+            }
+        }
+
+        // Region triangles of each group (counting sort by group)
+        uint32_t regionTriangles = static_cast<uint32_t>(m_triangles.size() / 3);
+        m_groupTriangleStart.assign(size_t(groupCount) + 1, 0);
+        for (uint32_t corner : m_triangles) m_groupTriangleStart[groupOf[corner] + 1]++;
+        for (uint32_t g = 0; g < groupCount; g++) m_groupTriangleStart[g + 1] += m_groupTriangleStart[g];
+        m_groupTriangles.resize(m_triangles.size());
+        std::vector<uint32_t> fill(m_groupTriangleStart.begin(), m_groupTriangleStart.end() - 1);
+        for (uint32_t t = 0; t < regionTriangles; t++) {
+            for (int k = 0; k < 3; k++) m_groupTriangles[fill[groupOf[m_triangles[size_t(t) * 3 + k]]]++] = t;
+        }
+        m_faceNormals.assign(size_t(regionTriangles) * 3, 0.0f);
+
+        // Everything written, as ranges
+        std::vector<uint32_t> written(m_moved);
+        written.insert(written.end(), m_groupVertices.begin(), m_groupVertices.end());
+        std::sort(written.begin(), written.end());
+        written.erase(std::unique(written.begin(), written.end()), written.end());
+        for (uint32_t v : written) {
+            if (!m_ranges.empty() && v - (m_ranges.back().first + m_ranges.back().count) <= RANGE_GAP) {
+                m_ranges.back().count = v - m_ranges.back().first + 1;
+            } else {
+                m_ranges.push_back({v, 1});
+            }
+        }
+    }
+
+    void clear() {
+        m_moved.clear();
+        m_triangles.clear();
+        m_groupStart.clear();
+        m_groupVertices.clear();
+        m_staticSums.clear();
+        m_groupTriangleStart.clear();
+        m_groupTriangles.clear();
+        m_faceNormals.clear();
+        m_ranges.clear();
+    }
+
+    bool empty() const { return m_moved.empty(); }
+
+    // Sorted, unique
+    const std::vector<uint32_t>& movedVertices() const { return m_moved; }
+    uint32_t ringVertexCount() const { return static_cast<uint32_t>(m_groupVertices.size()); }
+    uint32_t triangleCount() const { return static_cast<uint32_t>(m_triangles.size() / 3); }
+
+    // Ascending, non-overlapping; may span up to RANGE_GAP untouched vertices
+    const std::vector<Range>& dirtyRanges() const { return m_ranges; }
+
+    // fn(vertex) for every moved vertex, in parallel chunks: fn may only
+    // write the vertex it was given
+    template <typename Fn>
+    void forEachMoved(Fn&& fn) const {
+        parallel_for(m_moved.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) fn(m_moved[i]);
+        });
+    }
+
+    // Normals of the one-ring, after the moved vertices moved
+    template <typename Vertex>
+    void updateNormals(std::vector<Vertex>& vertices) {
+        parallel_for(m_faceNormals.size() / 3, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                const uint32_t* tri = &m_triangles[t * 3];
+                faceNormal(vertices[tri[0]], vertices[tri[1]], vertices[tri[2]], &m_faceNormals[t * 3]);
+            }
+        });
+
+        uint32_t groupCount = static_cast<uint32_t>(m_groupTriangleStart.size()) - 1;
+        parallel_for(m_groupTriangleStart.empty() ? 0 : groupCount, [&](size_t begin, size_t end) {
+            for (size_t g = begin; g < end; g++) {
+                float n[3] = {m_staticSums[g * 3], m_staticSums[g * 3 + 1], m_staticSums[g * 3 + 2]};
+                for (uint32_t i = m_groupTriangleStart[g]; i < m_groupTriangleStart[g + 1]; i++) {
+                    const float* f = &m_faceNormals[size_t(m_groupTriangles[i]) * 3];
+                    n[0] += f[0];
+                    n[1] += f[1];
+                    n[2] += f[2];
+                }
+                float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (length <= 0.0f) continue;  // Collapsed: keep the last normal
+                for (uint32_t i = m_groupStart[g]; i < m_groupStart[g + 1]; i++) {
+                    float* out = vertices[m_groupVertices[i]].normal;
+                    for (int a = 0; a < 3; a++) out[a] = n[a] / length;
+                }
+            }
+        });
+    }
+
+private:
+    // Twice the area along the normal, so sums weight triangles by area
+    template <typename Vertex>
+    static void faceNormal(const Vertex& a, const Vertex& b, const Vertex& c, float* out) {
+        float e1[3] = {b.pos[0] - a.pos[0], b.pos[1] - a.pos[1], b.pos[2] - a.pos[2]};
+        float e2[3] = {c.pos[0] - a.pos[0], c.pos[1] - a.pos[1], c.pos[2] - a.pos[2]};
+        out[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        out[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        out[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+
+    std::vector<uint32_t> m_moved;
+    std::vector<uint32_t> m_triangles;           // Region triangles, three corners each
+    std::vector<uint32_t> m_groupStart;          // Into m_groupVertices, one past the last group too
+    std::vector<uint32_t> m_groupVertices;       // Vertices sharing each group's normal
+    std::vector<float> m_staticSums;             // Per group: normals of its triangles outside the region
+    std::vector<uint32_t> m_groupTriangleStart;  // Into m_groupTriangles
+    std::vector<uint32_t> m_groupTriangles;      // Region triangles of each group
+    std::vector<float> m_faceNormals;            // Per region triangle, this frame
+    std::vector<Range> m_ranges;
+};
+
+} // namespace eden
+
+#endif // EDEN_VERTEX_EDIT_REGION_H
@@ -0,0 +1,421 @@
+// ============================================================================
+// WORLD STREAMER - Chunked world around the camera, with a floating origin
+// ============================================================================
+// Large maps don't fit in one vector of float positions: everything loads up
+// front, and 20 km from the origin a float only resolves a couple of
+// millimetres. This splits the world into square chunks on the XZ plane and
+// keeps only the ones near the camera, in coordinates near zero:
+//
+//   - Chunk (x, z) is the HDM file <directory>/chunk_<x>_<z>.hdm (read
+//     through the VFS), its geometry relative to the chunk's corner. A
+//     missing file is an empty chunk, not an error.
+//   - update() asks for the chunks within loadRadius of the camera's,
+//     nearest first; loader threads read and decode them. Finished chunks
+//     are handed to the upload callback on the calling thread (a few per
+//     frame), and chunks past unloadRadius go back through release - the
+//     gap between the two radii keeps a camera on a border from thrashing.
+//   - Positions the game works with are local: world = origin + local, the
+//     origin kept in doubles. When the camera gets rebaseDistance from it,
+//     update() moves the origin to the camera's chunk corner and returns
+//     the shift; the caller subtracts it from everything it positions. The
+//     origin is always a whole number of chunks, so chunk offsets stay
+//     exact.
+//
+// The callbacks own the GPU side (VulkanCore::createMesh / destroyMesh,
+// which copy through the upload manager), so this knows nothing of Vulkan.
+// Call everything but the loader threads from one thread.
+//
+// Header-only, like undo_history.h.
+//
+// Usage:
+//   eden::WorldStreamer world;
+//   world.start(config,
+//       [&](eden::ChunkCoord, eden::ChunkGeometry& g) { return core.createMesh(toMeshData(g)); },
+//       [&](eden::ChunkCoord, uint32_t mesh) { core.destroyMesh(mesh); });
+//   float shift[3];
+//   if (world.update(&camera.position.x, shift)) rebaseEverything(shift);
+//   world.forEachResident([&](eden::ChunkCoord, uint32_t mesh, const float offset[3]) { draw(mesh, offset); });
+// ============================================================================
+
+#ifndef EDEN_WORLD_STREAMER_H
+#define EDEN_WORLD_STREAMER_H
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../formats/hdm_format.h"
+#include "../../stdlib/vfs.h"
+
+namespace eden {
+
+struct ChunkCoord {
+    int32_t x = 0;
+    int32_t z = 0;
+    bool operator==(const ChunkCoord& other) const { return x == other.x && z == other.z; }
+    bool operator!=(const ChunkCoord& other) const { return !(*this == other); }
+};
+
+// One chunk's file, decoded on a loader thread. Vertices are HDMVertex
+// (POSITION_NORMAL_UV), relative to the chunk's corner.
+struct ChunkGeometry {
+    std::vector<HDMVertex> vertices;
+    std::vector<uint32_t> indices;
+    HDMProperties properties;
+};
+
+class WorldStreamer {
+public:
+    static constexpr uint32_t NO_RESOURCE = UINT32_MAX;  // Empty chunk, or upload failed
+
+    struct Config {
+        std::string directory = "world";    // chunk_<x>_<z>.hdm
+        float chunkSize = 256.0f;           // World units along X and Z
+        int loadRadius = 3;                 // Chunks (square) kept around the camera's
+        int unloadRadius = 5;               // Released past this; at least loadRadius
+        float rebaseDistance = 4096.0f;     // Camera distance from the origin that rebases it
+        uint32_t loaderThreads = 2;
+        uint32_t maxUploadsPerFrame = 2;    // Finished chunks handed to upload() per update()
+    };
+
+    // Returns the chunk's resource (NO_RESOURCE if it couldn't be created)
+    using UploadFn = std::function<uint32_t(ChunkCoord, ChunkGeometry&)>;
+    using ReleaseFn = std::function<void(ChunkCoord, uint32_t)>;
+
+    struct Stats {
+        uint32_t resident = 0;      // Uploaded (or known empty)
+        uint32_t pending = 0;       // Queued, loading, or loaded and waiting to upload
+        uint32_t uploaded = 0;      // In the last update()
+        uint32_t released = 0;      // In the last update()
+        uint64_t rebases = 0;
+    };
+
+    WorldStreamer() = default;
+    ~WorldStreamer() { stop(); }
+
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    // Starts the loader threads; the origin is reset to zero
+    void start(const Config& config, UploadFn upload, ReleaseFn release) {
+        stop();
+        m_config = config;
+        m_config.chunkSize = std::max(m_config.chunkSize, 1.0f);
+        m_config.loadRadius = std::max(m_config.loadRadius, 0);
+        m_config.unloadRadius = std::max(m_config.unloadRadius, m_config.loadRadius);
+        m_config.loaderThreads = std::max(m_config.loaderThreads, 1u);
+        m_config.maxUploadsPerFrame = std::max(m_config.maxUploadsPerFrame, 1u);
+        m_upload = std::move(upload);
+        m_release = std::move(release);
+        m_origin[0] = m_origin[1] = m_origin[2] = 0.0;
+        m_stats = Stats();
+        m_lastCenter = {INT32_MIN, INT32_MIN};
+
+        m_stopping = false;
+        for (uint32_t i = 0; i < m_config.loaderThreads; i++) {
+            m_workers.emplace_back([this]() { loadLoop(); });
+        }
+    }
+
+    // Joins the loaders and releases every resident chunk
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_requests.clear();
+            m_results.clear();
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) worker.join();
+        m_workers.clear();
+
+        for (auto& entry : m_chunks) {
+            if (entry.second.state == Resident && entry.second.resource != NO_RESOURCE && m_release) {
+                m_release(entry.second.coord, entry.second.resource);
+            }
+        }
+        m_chunks.clear();
+    }
+
+    bool running() const { return !m_workers.empty(); }
+    const Config& config() const { return m_config; }
+    const Stats& stats() const { return m_stats; }
+
+    /**
+     * Once a frame, with the camera in local coordinates. Rebases first:
+     * returns true and the shift (local units, to subtract from every
+     * local position, the camera's included) if the origin moved;
+     * cameraLocal itself is not changed. Then streams around the camera.
+     */
+    bool update(const float cameraLocal[3], float shift[3]) {
+        shift[0] = shift[1] = shift[2] = 0.0f;
+        if (!running()) return false;
+
+        float camera[3] = {cameraLocal[0], cameraLocal[1], cameraLocal[2]};
+        bool rebased = false;
+        if (std::max(std::fabs(camera[0]), std::fabs(camera[2])) > m_config.rebaseDistance) {
+            ChunkCoord at = chunkAt(camera);
+            double newOrigin[3] = {double(at.x) * m_config.chunkSize, m_origin[1], double(at.z) * m_config.chunkSize};
+            for (int a = 0; a < 3; a++) {
+                shift[a] = static_cast<float>(newOrigin[a] - m_origin[a]);
+                camera[a] -= shift[a];
+                m_origin[a] = newOrigin[a];
+            }
+            m_stats.rebases++;
+            rebased = true;
+        }
+
+        ChunkCoord center = chunkAt(camera);
+        m_stats.uploaded = 0;
+        m_stats.released = 0;
+        releaseFar(center);
+        requestNear(center);
+        uploadFinished();
+
+        m_stats.resident = 0;
+        m_stats.pending = 0;
+        for (const auto& entry : m_chunks) {
+            if (entry.second.state == Resident) m_stats.resident++;
+            else m_stats.pending++;
+        }
+        return rebased;
+    }
+
+    // fn(coord, resource, offset) for every uploaded, non-empty chunk;
+    // offset is the chunk corner in local coordinates (its model translation)
+    template <typename Fn>
+    void forEachResident(Fn&& fn) const {
+        for (const auto& entry : m_chunks) {
+            const Chunk& chunk = entry.second;
+            if (chunk.state != Resident || chunk.resource == NO_RESOURCE) continue;
+            float offset[3];
+            chunkOffset(chunk.coord, offset);
+            fn(chunk.coord, chunk.resource, static_cast<const float*>(offset));
+        }
+    }
+
+    // Resource of an uploaded chunk, NO_RESOURCE otherwise
+    uint32_t resource(ChunkCoord coord) const {
+        auto it = m_chunks.find(keyOf(coord));
+        return it != m_chunks.end() && it->second.state == Resident ? it->second.resource : NO_RESOURCE;
+    }
+
+    // ========================================================================
+    // Coordinates
+    // ========================================================================
+
+    const double* origin() const { return m_origin; }
+
+    void localToWorld(const float local[3], double world[3]) const {
+        for (int a = 0; a < 3; a++) world[a] = m_origin[a] + local[a];
+    }
+
+    void worldToLocal(const double world[3], float local[3]) const {
+        for (int a = 0; a < 3; a++) local[a] = static_cast<float>(world[a] - m_origin[a]);
+    }
+
+    // Chunk containing a local position
+    ChunkCoord chunkAt(const float local[3]) const {
+        ChunkCoord coord;
+        coord.x = static_cast<int32_t>(std::floor((m_origin[0] + local[0]) / m_config.chunkSize));
+        coord.z = static_cast<int32_t>(std::floor((m_origin[2] + local[2]) / m_config.chunkSize));
+        return coord;
+    }
+
+    // Corner of a chunk in local coordinates
+    void chunkOffset(ChunkCoord coord, float offset[3]) const {
+        offset[0] = static_cast<float>(double(coord.x) * m_config.chunkSize - m_origin[0]);
+        offset[1] = static_cast<float>(-m_origin[1]);
+        offset[2] = static_cast<float>(double(coord.z) * m_config.chunkSize - m_origin[2]);
+    }
+
+    std::string chunkPath(ChunkCoord coord) const {
+        return m_config.directory + "/chunk_" + std::to_string(coord.x) + "_" + std::to_string(coord.z) + ".hdm";
+    }
+
+private:
+    enum State {
+        Requested,  // Queued, loading, or loaded and waiting for an upload slot
+        Resident
+    };
+
+    struct Chunk {
+        ChunkCoord coord;
+        State state = Requested;
+        uint32_t resource = NO_RESOURCE;
+        uint64_t request = 0;  // Matches results to this request, not an earlier one
+    };
+
+    struct Request {
+        ChunkCoord coord;
+        uint64_t id = 0;
+        std::string path;
+        int distance = 0;      // Chebyshev, from the camera's chunk when queued
+    };
+
+    struct Result {
+        ChunkCoord coord;
+        uint64_t id = 0;
+        bool empty = true;
+        ChunkGeometry geometry;
+    };
+
+    static uint64_t keyOf(ChunkCoord coord) {
+        return (uint64_t(uint32_t(coord.x)) << 32) | uint32_t(coord.z);
+    }
+
+    static int distance(ChunkCoord a, ChunkCoord b) {
+        return std::max(std::abs(a.x - b.x), std::abs(a.z - b.z));
+    }
+
+    void releaseFar(ChunkCoord center) {
+        std::vector<uint64_t> cancelled;
+        for (auto it = m_chunks.begin(); it != m_chunks.end();) {
+            Chunk& chunk = it->second;
+            if (distance(chunk.coord, center) <= m_config.unloadRadius) {
+                ++it;
+                continue;
+            }
+            if (chunk.state == Resident && chunk.resource != NO_RESOURCE) {
+                m_release(chunk.coord, chunk.resource);
+                m_stats.released++;
+            } else if (chunk.state == Requested) {
+                cancelled.push_back(chunk.request);
+            }
+            it = m_chunks.erase(it);
+        }
+        if (cancelled.empty()) return;
+
+        // Queued ones never load; ones already loading are dropped in uploadFinished()
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto gone = [&](uint64_t id) { return std::find(cancelled.begin(), cancelled.end(), id) != cancelled.end(); };
+        m_requests.erase(std::remove_if(m_requests.begin(), m_requests.end(),
+                                        [&](const Request& r) { return gone(r.id); }),
+                         m_requests.end());
+        m_results.erase(std::remove_if(m_results.begin(), m_results.end(),
+                                       [&](const Result& r) { return gone(r.id); }),
+                        m_results.end());
+    }
+
+    void requestNear(ChunkCoord center) {
+        std::vector<Request> added;
+        int r = m_config.loadRadius;
+        for (int dz = -r; dz <= r; dz++) {
+            for (int dx = -r; dx <= r; dx++) {
+                ChunkCoord coord{center.x + dx, center.z + dz};
+                uint64_t key = keyOf(coord);
+                if (m_chunks.count(key)) continue;
+                Chunk& chunk = m_chunks[key];
+                chunk.coord = coord;
+                chunk.request = ++m_nextRequest;
+                added.push_back({coord, chunk.request, chunkPath(coord), 0});
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.insert(m_requests.end(), std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+        if (added.empty() && center == m_lastCenter) return;
+
+        // Nearest (to where the camera is now) first
+        for (Request& request : m_requests) request.distance = distance(request.coord, center);
+        std::stable_sort(m_requests.begin(), m_requests.end(),
+                         [](const Request& a, const Request& b) { return a.distance < b.distance; });
+        m_lastCenter = center;
+        if (!added.empty()) m_wake.notify_all();
+    }
+
+    void uploadFinished() {
+        std::vector<Result> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_t count = std::min<size_t>(m_results.size(), m_config.maxUploadsPerFrame);
+            ready.insert(ready.end(), std::make_move_iterator(m_results.begin()),
+                         std::make_move_iterator(m_results.begin() + count));
+            m_results.erase(m_results.begin(), m_results.begin() + count);
+        }
+
+        for (Result& result : ready) {
+            auto it = m_chunks.find(keyOf(result.coord));
+            if (it == m_chunks.end() || it->second.request != result.id) continue;  // Released meanwhile
+            Chunk& chunk = it->second;
+            chunk.state = Resident;
+            if (!result.empty) {
+                chunk.resource = m_upload(chunk.coord, result.geometry);
+                m_stats.uploaded++;
+            }
+        }
+    }
+
+    void loadLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+            if (m_stopping) return;
+
+            Request request = std::move(m_requests.front());
+            m_requests.pop_front();
+
+            lock.unlock();
+            Result result;
+            result.coord = request.coord;
+            result.id = request.id;
+            result.empty = !loadChunk(request.path, result.geometry);
+            lock.lock();
+
+            if (!m_stopping) m_results.push_back(std::move(result));
+        }
+    }
+
+    static bool loadChunk(const std::string& path, ChunkGeometry& out) {
+        if (!Vfs::shared().exists(path)) return false;
+
+        hdm::HDMView view;
+        if (view.open(path.c_str())) {
+            out.properties = view.properties();
+            out.vertices.resize(view.vertexCount());
+            out.indices.resize(view.indexCount());
+            if (view.decodeGeometry(out.vertices.data(), out.indices.data())) return !out.indices.empty();
+        } else {
+            // v2 files
+            HDMGeometry geometry;
+            HDMTexture texture;
+            if (hdm::loadBinary(path.c_str(), out.properties, geometry, texture)) {
+                out.vertices = std::move(geometry.vertices);
+                out.indices = std::move(geometry.indices);
+                return !out.indices.empty();
+            }
+        }
+        std::cerr << "[WorldStreamer] Failed to load chunk " << path << " - left empty" << std::endl;
+        return false;
+    }
+
+    Config m_config;
+    UploadFn m_upload;
+    ReleaseFn m_release;
+    double m_origin[3] = {0.0, 0.0, 0.0};  // World position of local zero
+    std::unordered_map<uint64_t, Chunk> m_chunks;  // Wanted or resident, by keyOf()
+    uint64_t m_nextRequest = 0;
+    ChunkCoord m_lastCenter{INT32_MIN, INT32_MIN};
+    Stats m_stats;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<std::thread> m_workers;
+    std::deque<Request> m_requests;        // Nearest first
+    std::deque<Result> m_results;          // Loaded, oldest first
+    bool m_stopping = false;
+};
+
+} // namespace eden
+
+#endif // EDEN_WORLD_STREAMER_H